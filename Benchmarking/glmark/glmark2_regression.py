@@ -0,0 +1,137 @@
+#!/usr/bin/env python3
+# Runs the glmark2 scenes supported by GLOVE, appends the FPS and frame time
+# of each scene to a JSON history, and compares them against a baseline run
+# of that history. Exits with 1 when a scene regressed beyond the threshold,
+# so that it can run as a CTest test.
+
+import argparse
+import datetime
+import json
+import os
+import re
+import subprocess
+import sys
+
+HISTORY_FORMAT = 1
+SCENE_LINE     = re.compile(r'^\[(?P<scene>[^\]]+)\]\s*(?P<options>.*?):\s*FPS:\s*(?P<fps>[0-9.]+)\s+FrameTime:\s*(?P<frame_time>[0-9.]+)\s*ms')
+SCORE_LINE     = re.compile(r'glmark2 Score:\s*(?P<score>[0-9]+)')
+
+
+def parse_output(output):
+    scenes = {}
+    score  = None
+    for line in output.splitlines():
+        match = SCENE_LINE.match(line.strip())
+        if match:
+            name = match.group('scene')
+            if match.group('options') and match.group('options') != '<default>':
+                name += ':' + match.group('options')
+            scenes[name] = {'fps': float(match.group('fps')), 'frame_time': float(match.group('frame_time'))}
+            continue
+        match = SCORE_LINE.search(line)
+        if match:
+            score = int(match.group('score'))
+    return scenes, score
+
+
+def glove_revision():
+    root = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..')
+    try:
+        return subprocess.check_output(['git', 'describe', '--always', '--dirty'], cwd=root,
+                                       stderr=subprocess.DEVNULL).decode().strip()
+    except (OSError, subprocess.CalledProcessError):
+        return 'unknown'
+
+
+def load_history(path):
+    if not os.path.exists(path):
+        return {'format': HISTORY_FORMAT, 'runs': []}
+    with open(path) as file:
+        history = json.load(file)
+    if history.get('format') != HISTORY_FORMAT:
+        sys.exit('Unsupported history format %s in %s' % (history.get('format'), path))
+    return history
+
+
+def find_baseline(history, label):
+    for run in reversed(history['runs']):
+        if label is None or run['label'] == label:
+            return run
+    return None
+
+
+def compare(baseline, run, threshold):
+    regressions = []
+    for name, scene in sorted(run['scenes'].items()):
+        base = baseline['scenes'].get(name)
+        if not base or not base['fps']:
+            continue
+        change = (scene['fps'] - base['fps']) * 100.0 / base['fps']
+        flag   = change < -threshold
+        if flag:
+            regressions.append(name)
+        print('%-4s %-60s %9.1f -> %9.1f FPS (%+6.1f%%)' % ('FAIL' if flag else 'ok', name, base['fps'], scene['fps'], change))
+    missing = sorted(set(baseline['scenes']) - set(run['scenes']))
+    for name in missing:
+        print('MISS %s' % name)
+    return regressions + missing
+
+
+def main():
+    here   = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description='glmark2 regression run of GLOVE')
+    parser.add_argument('--glmark2',   default='glmark2-es2', help='glmark2 executable')
+    parser.add_argument('--options',   default=os.path.join(here, 'glmark2_benchmarks_options'), help='list of scenes to run')
+    parser.add_argument('--history',   default='glmark2_history.json', help='JSON history the run is appended to')
+    parser.add_argument('--label',     default=None, help='label of the run, the GLOVE revision by default')
+    parser.add_argument('--baseline',  default=None, help='label of the run to compare against, the latest run by default')
+    parser.add_argument('--threshold', default=5.0, type=float, help='FPS drop in percent flagged as a regression')
+    parser.add_argument('--no-save',   action='store_true', help='compare without appending the run to the history')
+    args = parser.parse_args()
+
+    command = [args.glmark2, '--reuse-context', '-f', args.options]
+    try:
+        result = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    except OSError as error:
+        sys.exit('Cannot run %s: %s' % (args.glmark2, error))
+    output = result.stdout.decode(errors='replace')
+
+    scenes, score = parse_output(output)
+    if not scenes:
+        sys.stdout.write(output)
+        sys.exit('No scene results in the output of %s' % args.glmark2)
+
+    revision = glove_revision()
+    run = {
+        'label':    args.label or revision,
+        'revision': revision,
+        'date':     datetime.datetime.now().isoformat(timespec='seconds'),
+        'score':    score,
+        'scenes':   scenes,
+    }
+
+    history  = load_history(args.history)
+    baseline = find_baseline(history, args.baseline)
+    regressions = []
+    if baseline:
+        print('Comparing %s against %s (threshold %.1f%%)' % (run['label'], baseline['label'], args.threshold))
+        regressions = compare(baseline, run, args.threshold)
+    elif args.baseline:
+        sys.exit('No run labelled %s in %s' % (args.baseline, args.history))
+    else:
+        print('No baseline in %s, %d scenes recorded' % (args.history, len(scenes)))
+
+    if not args.no_save:
+        history['runs'].append(run)
+        with open(args.history, 'w') as file:
+            json.dump(history, file, indent=2, sort_keys=True)
+            file.write('\n')
+
+    if regressions:
+        print('%d of %d scenes regressed' % (len(regressions), len(scenes)))
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
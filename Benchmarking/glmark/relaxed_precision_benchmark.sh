@@ -0,0 +1,33 @@
+#!/usr/bin/env bash
+# Runs the fragment-bound scenes of glmark2 with the ESSL precision qualifiers
+# dropped and kept as RelaxedPrecision, and reports the score and the frame
+# time of every scene for both.
+
+GLMARK2=${1:-glmark2-es2}
+SCENES=(
+    "effect2d:kernel=0,1,0;1,-4,1;0,1,0"
+    "desktop:windows=4:effect=blur"
+    "shading:shading=phong"
+    "shading:shading=cel:num-lights=5"
+    "bump:bump-render=normals"
+    "function:fragment-steps=5:fragment-complexity=medium"
+    "conditionals:vertex-steps=1:fragment-steps=5:fragment-conditionals=true"
+    "pulsar:quads=5:random=true:texture=true:light=true"
+)
+
+OPTIONS=$(mktemp)
+printf "%s\n" "${SCENES[@]}" > $OPTIONS
+
+for RELAXED in false true; do
+    LOG=$(mktemp)
+
+    # the programs are linked again rather than taken from the cache of a previous run
+    GLOVE_RELAXED_PRECISION=$RELAXED GLOVE_PROGRAM_CACHE_PATH= GLOVE_PIPELINE_CACHE_PATH= \
+        $GLMARK2 --reuse-context -f $OPTIONS > $LOG 2>&1
+
+    echo "GLOVE_RELAXED_PRECISION=$RELAXED: score $(grep "glmark2 Score" $LOG | awk '{print $NF}')"
+    grep -o "^\[[a-z0-9]*\] .*FrameTime: [0-9.]* ms" $LOG | sed "s/^/    /"
+    rm -f $LOG
+done
+
+rm -f $OPTIONS
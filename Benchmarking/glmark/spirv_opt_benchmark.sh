@@ -0,0 +1,22 @@
+#!/usr/bin/env bash
+# Runs glmark2 with every SPIR-V optimizer recipe of a GLOVE built with
+# SPIRV_OPT, and reports the score, the mean frame time and, when GLOVE
+# dumps its pipeline statistics, the time spent creating pipelines.
+
+GLMARK2=${1:-glmark2-es2}
+OPTIONS=$(dirname "$0")/glmark2_benchmarks_options
+
+for RECIPE in none size performance; do
+    LOG=$(mktemp)
+
+    # programs and pipelines are not taken from the caches of a previous run
+    GLOVE_SPIRV_OPT=$RECIPE GLOVE_PROGRAM_CACHE_PATH= GLOVE_PIPELINE_CACHE_PATH= \
+        $GLMARK2 --reuse-context -f $OPTIONS > $LOG 2>&1
+
+    SCORE=$(grep "glmark2 Score" $LOG | awk '{print $NF}')
+    FRAME_TIME=$(grep -o "FrameTime: [0-9.]*" $LOG | awk '{sum += $2; n++} END {if(n) printf "%.3f ms", sum / n; else print "n/a"}')
+    CREATE_TIME=$(grep -o "create time: [0-9]*" $LOG | awk '{sum += $3; n++} END {if(n) printf "%d us", sum; else print "n/a"}')
+
+    echo "$RECIPE: score ${SCORE:-n/a}, mean frame time $FRAME_TIME, pipeline create time $CREATE_TIME"
+    rm -f $LOG
+done
@@ -0,0 +1,25 @@
+#version 100
+
+#ifdef GL_ES
+  precision mediump float;
+#endif
+
+#define TAPS 9
+
+uniform sampler2D Texture0;
+uniform vec2      Direction;
+uniform float     Weights[TAPS];
+
+varying vec2 v_texCoord_out;
+
+void main()
+{
+    vec4 color = texture2D(Texture0, v_texCoord_out) * Weights[0];
+    for(int i = 1; i < TAPS; ++i) {
+        vec2 offset = Direction * float(i);
+        color += texture2D(Texture0, v_texCoord_out + offset) * Weights[i];
+        color += texture2D(Texture0, v_texCoord_out - offset) * Weights[i];
+    }
+
+    gl_FragColor = color;
+}
@@ -0,0 +1,32 @@
+#version 100
+
+#ifdef GL_ES
+  precision mediump float;
+#endif
+
+uniform sampler2D DiffuseMap;
+uniform sampler2D HeightMap;
+uniform vec2      TexelSize;
+uniform float     BumpScale;
+
+varying vec2 TextureCoord;
+varying vec3 LightDirection;
+varying vec3 EyeDirection;
+
+void main()
+{
+    // normal from the central differences of the height map
+    float left   = texture2D(HeightMap, TextureCoord - vec2(TexelSize.x, 0.0)).r;
+    float right  = texture2D(HeightMap, TextureCoord + vec2(TexelSize.x, 0.0)).r;
+    float bottom = texture2D(HeightMap, TextureCoord - vec2(0.0, TexelSize.y)).r;
+    float top    = texture2D(HeightMap, TextureCoord + vec2(0.0, TexelSize.y)).r;
+    vec3  N      = normalize(vec3(BumpScale * (left - right), BumpScale * (bottom - top), 1.0));
+
+    // parallax offset along the eye direction
+    float height = texture2D(HeightMap, TextureCoord).r;
+    vec3  E      = normalize(EyeDirection);
+    vec2  coord  = TextureCoord + E.xy * (height * 0.04 - 0.02);
+
+    vec4 albedo  = texture2D(DiffuseMap, coord);
+    gl_FragColor = vec4(albedo.rgb * max(dot(N, normalize(LightDirection)), 0.0), albedo.a);
+}
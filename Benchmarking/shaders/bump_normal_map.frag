@@ -0,0 +1,27 @@
+#version 100
+
+#ifdef GL_ES
+  precision mediump float;
+#endif
+
+uniform sampler2D DiffuseMap;
+uniform sampler2D NormalMap;
+uniform vec4      LightSourceSpecular;
+uniform float     MaterialShininess;
+
+varying vec2 TextureCoord;
+varying vec3 LightDirection;
+varying vec3 EyeDirection;
+
+void main()
+{
+    vec3 N = normalize(texture2D(NormalMap, TextureCoord).xyz * 2.0 - 1.0);
+    vec3 L = normalize(LightDirection);
+    vec3 H = normalize(L + normalize(EyeDirection));
+
+    vec4 albedo   = texture2D(DiffuseMap, TextureCoord);
+    vec4 diffuse  = albedo * max(dot(N, L), 0.0);
+    vec4 specular = LightSourceSpecular * pow(max(dot(N, H), 0.0), MaterialShininess);
+
+    gl_FragColor = vec4(diffuse.rgb + specular.rgb, albedo.a);
+}
@@ -0,0 +1,33 @@
+#version 100
+
+attribute vec3 position;
+attribute vec3 normal;
+attribute vec3 tangent;
+attribute vec2 texcoord;
+
+uniform mat4 ModelViewProjectionMatrix;
+uniform mat4 ModelViewMatrix;
+uniform mat4 NormalMatrix;
+uniform vec4 LightSourcePosition;
+
+varying vec2 TextureCoord;
+varying vec3 LightDirection;
+varying vec3 EyeDirection;
+
+void main()
+{
+    // light and eye directions in tangent space
+    vec3 N = normalize(vec3(NormalMatrix * vec4(normal , 1.0)));
+    vec3 T = normalize(vec3(NormalMatrix * vec4(tangent, 1.0)));
+    vec3 B = cross(N, T);
+    mat3 TBN = mat3(T.x, B.x, N.x,
+                    T.y, B.y, N.y,
+                    T.z, B.z, N.z);
+
+    vec4 P = ModelViewMatrix * vec4(position, 1.0);
+
+    TextureCoord   = texcoord;
+    LightDirection = TBN * normalize(LightSourcePosition.xyz - P.xyz);
+    EyeDirection   = TBN * normalize(-P.xyz);
+    gl_Position    = ModelViewProjectionMatrix * vec4(position, 1.0);
+}
@@ -0,0 +1,25 @@
+#version 100
+
+#ifdef GL_ES
+  precision mediump float;
+#endif
+
+uniform sampler2D Texture0;
+uniform vec2      TexelSize;
+uniform float     Kernel[25];
+
+varying vec2 v_texCoord_out;
+
+void main()
+{
+    // 5x5 convolution, unrolled by the loop bounds being constant
+    vec4 sum = vec4(0.0);
+    for(int y = -2; y <= 2; ++y) {
+        for(int x = -2; x <= 2; ++x) {
+            vec2 offset = vec2(float(x), float(y)) * TexelSize;
+            sum += Kernel[(y + 2) * 5 + (x + 2)] * texture2D(Texture0, v_texCoord_out + offset);
+        }
+    }
+
+    gl_FragColor = sum;
+}
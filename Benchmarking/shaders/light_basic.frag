@@ -0,0 +1,12 @@
+#version 100
+
+#ifdef GL_ES
+  precision mediump float;
+#endif
+
+varying vec4 Color;
+
+void main()
+{
+    gl_FragColor = Color;
+}
@@ -0,0 +1,22 @@
+#version 100
+
+attribute vec3 position;
+attribute vec3 normal;
+
+uniform mat4 ModelViewProjectionMatrix;
+uniform mat4 NormalMatrix;
+uniform vec4 LightSourcePosition;
+uniform vec3 MaterialDiffuse;
+
+varying vec4 Color;
+
+void main()
+{
+    // diffuse lighting of a directional light, per vertex
+    vec3 N = normalize(vec3(NormalMatrix * vec4(normal, 1.0)));
+    vec3 L = normalize(LightSourcePosition.xyz);
+    float diffuse = max(dot(N, L), 0.0);
+
+    Color       = vec4(diffuse * MaterialDiffuse, 1.0);
+    gl_Position = ModelViewProjectionMatrix * vec4(position, 1.0);
+}
@@ -0,0 +1,16 @@
+#version 100
+
+#ifdef GL_ES
+  precision mediump float;
+#endif
+
+uniform sampler2D MaterialTexture0;
+
+varying vec4 Color;
+varying vec2 TextureCoord;
+
+void main()
+{
+    vec4 texel   = texture2D(MaterialTexture0, TextureCoord);
+    gl_FragColor = texel * Color;
+}
@@ -0,0 +1,40 @@
+#version 100
+
+#ifdef GL_ES
+  precision mediump float;
+#endif
+
+uniform vec4 LightSourcePosition;
+uniform vec4 MaterialDiffuse;
+uniform vec4 OutlineColor;
+
+varying vec3 Normal;
+varying vec4 Position;
+
+void main()
+{
+    vec3 N = normalize(Normal);
+    vec3 L = normalize(LightSourcePosition.xyz);
+    vec3 E = normalize(-Position.xyz);
+
+    // silhouette edges
+    if(abs(dot(N, E)) < 0.2) {
+        gl_FragColor = OutlineColor;
+        return;
+    }
+
+    // diffuse intensity quantized in bands
+    float intensity = max(dot(N, L), 0.0);
+    float band;
+    if(intensity > 0.95) {
+        band = 1.0;
+    } else if(intensity > 0.5) {
+        band = 0.6;
+    } else if(intensity > 0.25) {
+        band = 0.4;
+    } else {
+        band = 0.2;
+    }
+
+    gl_FragColor = vec4(band * MaterialDiffuse.rgb, MaterialDiffuse.a);
+}
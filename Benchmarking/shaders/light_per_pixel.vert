@@ -0,0 +1,18 @@
+#version 100
+
+attribute vec3 position;
+attribute vec3 normal;
+
+uniform mat4 ModelViewProjectionMatrix;
+uniform mat4 ModelViewMatrix;
+uniform mat4 NormalMatrix;
+
+varying vec3 Normal;
+varying vec4 Position;
+
+void main()
+{
+    Normal      = normalize(vec3(NormalMatrix * vec4(normal, 1.0)));
+    Position    = ModelViewMatrix * vec4(position, 1.0);
+    gl_Position = ModelViewProjectionMatrix * vec4(position, 1.0);
+}
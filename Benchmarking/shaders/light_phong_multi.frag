@@ -0,0 +1,43 @@
+#version 100
+
+#ifdef GL_ES
+  precision mediump float;
+#endif
+
+#define NUM_LIGHTS 4
+
+uniform vec4  LightSourcePosition[NUM_LIGHTS];
+uniform vec3  LightColor[NUM_LIGHTS];
+uniform float LightAttenuation[NUM_LIGHTS];
+uniform vec4  MaterialDiffuse;
+uniform vec4  MaterialSpecular;
+uniform float MaterialShininess;
+
+varying vec3 Normal;
+varying vec4 Position;
+
+vec3 PointLight(vec3 position, vec3 color, float attenuation, vec3 N, vec3 E)
+{
+    vec3  D = position - Position.xyz;
+    float d = length(D);
+    vec3  L = D / d;
+    vec3  R = reflect(-L, N);
+
+    vec3  diffuse  = MaterialDiffuse.rgb  * max(dot(N, L), 0.0);
+    vec3  specular = MaterialSpecular.rgb * pow(max(dot(R, E), 0.0), MaterialShininess);
+    return color * (diffuse + specular) / (1.0 + attenuation * d * d);
+}
+
+void main()
+{
+    vec3 N = normalize(Normal);
+    vec3 E = normalize(-Position.xyz);
+
+    vec3 color = vec3(0.0);
+    for(int i = 0; i < NUM_LIGHTS; ++i) {
+        // fragment shaders may only index uniform arrays with the loop index
+        color += PointLight(LightSourcePosition[i].xyz, LightColor[i], LightAttenuation[i], N, E);
+    }
+
+    gl_FragColor = vec4(color, MaterialDiffuse.a);
+}
@@ -0,0 +1,21 @@
+#version 100
+
+#ifdef GL_ES
+  precision mediump float;
+#endif
+
+uniform sampler2D Texture0;
+uniform bool      UseTexture;
+
+varying vec4 Color;
+varying vec2 TextureCoord;
+
+void main()
+{
+    vec4 color = Color;
+    if(UseTexture) {
+        color *= texture2D(Texture0, TextureCoord);
+    }
+
+    gl_FragColor = color;
+}
@@ -0,0 +1,23 @@
+#version 100
+
+attribute vec3 position;
+attribute vec4 vtxcolor;
+attribute vec2 texcoord;
+
+uniform mat4  ModelViewProjectionMatrix;
+uniform float Time;
+uniform float Amplitude;
+
+varying vec4 Color;
+varying vec2 TextureCoord;
+
+void main()
+{
+    // the quads pulse outwards, each with its own phase
+    float phase = Time + position.x * 3.0 + position.y * 5.0;
+    vec3  P     = position * (1.0 + Amplitude * sin(phase));
+
+    Color        = vtxcolor;
+    TextureCoord = texcoord;
+    gl_Position  = ModelViewProjectionMatrix * vec4(P, 1.0);
+}
@@ -0,0 +1,39 @@
+#version 100
+
+#ifdef GL_ES
+  precision mediump float;
+#endif
+
+uniform sampler2D DistanceMap;
+uniform sampler2D NormalMap;
+uniform sampler2D ImageMap;
+uniform vec4      LightSourcePosition;
+uniform float     RefractiveIndex;
+
+varying vec3 Normal;
+varying vec4 Position;
+
+void main()
+{
+    vec3 N = normalize(Normal);
+    vec3 E = normalize(Position.xyz);
+
+    // the ray refracted at the front face is traced to the back face through the distance map
+    vec3  T        = refract(E, N, 1.0 / RefractiveIndex);
+    vec2  coord    = Position.xy / Position.w * 0.5 + 0.5;
+    float depth    = texture2D(DistanceMap, coord).r;
+    vec2  back     = coord + T.xy * depth;
+
+    vec3 backNormal = texture2D(NormalMap, back).xyz * 2.0 - 1.0;
+    vec3 T2         = refract(T, -backNormal, RefractiveIndex);
+    if(dot(T2, T2) == 0.0) {
+        T2 = reflect(T, -backNormal);
+    }
+
+    vec4  color   = texture2D(ImageMap, back + T2.xy * 0.1);
+    vec3  L       = normalize(LightSourcePosition.xyz);
+    float fresnel = pow(1.0 - max(dot(-E, N), 0.0), 5.0);
+    float glint   = pow(max(dot(reflect(-L, N), -E), 0.0), 64.0);
+
+    gl_FragColor = vec4(mix(color.rgb, vec3(1.0), fresnel) + glint, 1.0);
+}
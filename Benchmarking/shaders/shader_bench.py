@@ -0,0 +1,120 @@
+#!/usr/bin/env python3
+# Compiles and links the ESSL 100 corpus of programs.txt with glove_shaderbench,
+# once with empty program and pipeline caches (cold) and once with the caches
+# the first run wrote (warm), and reports the wall time of every program and
+# the time GLOVE spent in each stage of compiling and linking them, as
+# written by GLOVE_SHADER_STATS. Each mode is run --runs times in a fresh
+# process and the median of the runs is reported.
+
+import argparse
+import json
+import os
+import shutil
+import statistics
+import subprocess
+import sys
+import tempfile
+
+MODES = ['cold', 'warm']
+
+
+def run_tool(args, workdir, run):
+    """Runs glove_shaderbench in a fresh process, returns its times and the stage times of GLOVE."""
+    times = os.path.join(workdir, 'times-%d.json' % run)
+    stats = os.path.join(workdir, 'stats-%d.json' % run)
+    env   = dict(os.environ,
+                 GLOVE_PROGRAM_CACHE_PATH=os.path.join(workdir, 'program_cache.bin'),
+                 GLOVE_PIPELINE_CACHE_PATH=os.path.join(workdir, 'pipeline_cache.bin'),
+                 GLOVE_SHADER_STATS=stats)
+    command = [args.tool, '-o', times] + (['-f', args.filter] if args.filter else []) + [args.manifest]
+    result  = subprocess.run(command, env=env, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    # the tool exits with 1 when a program fails to link, which the report lists
+    if result.returncode != 0:
+        sys.stderr.write(result.stdout.decode(errors='replace'))
+    if not os.path.exists(times):
+        sys.exit('%s exited with %d' % (args.tool, result.returncode))
+    if not os.path.exists(stats):
+        sys.exit('No stage times were written, is the GLOVE of this build in the library path?')
+
+    with open(times) as file:
+        tool = json.load(file)
+    with open(stats) as file:
+        glove = json.load(file)
+    return tool, glove
+
+
+def median_of(runs):
+    """The median of every time over the runs of a mode, with the layout of a single run."""
+    tool, glove = runs[0]
+    programs = []
+    for i, program in enumerate(tool['programs']):
+        programs.append({
+            'name':       program['name'],
+            'linked':     all(run[0]['programs'][i]['linked'] for run in runs),
+            'compile_ms': statistics.median(run[0]['programs'][i]['compile_ms'] for run in runs),
+            'link_ms':    statistics.median(run[0]['programs'][i]['link_ms'] for run in runs),
+        })
+    stages = {}
+    for stage, values in glove['stages'].items():
+        stages[stage] = {
+            'calls':    values['calls'],
+            'total_ms': statistics.median(run[1]['stages'][stage]['total_ms'] for run in runs),
+        }
+    return {
+        'programs':      programs,
+        'compile_ms':    statistics.median(run[0]['compile_ms'] for run in runs),
+        'link_ms':       statistics.median(run[0]['link_ms'] for run in runs),
+        'stages':        stages,
+        'program_cache': glove['program_cache'],
+    }
+
+
+def print_report(report):
+    cold, warm = report['cold'], report['warm']
+    print('%-24s %12s %12s' % ('stage', 'cold ms', 'warm ms'))
+    for stage in cold['stages']:
+        print('%-24s %12.3f %12.3f' % (stage, cold['stages'][stage]['total_ms'], warm['stages'][stage]['total_ms']))
+    print('%-24s %12.3f %12.3f' % ('glCompileShader (wall)', cold['compile_ms'], warm['compile_ms']))
+    print('%-24s %12.3f %12.3f' % ('glLinkProgram (wall)', cold['link_ms'], warm['link_ms']))
+    print('program cache hits: cold %d of %d, warm %d of %d' % (
+        cold['program_cache']['hits'], cold['program_cache']['hits'] + cold['program_cache']['misses'],
+        warm['program_cache']['hits'], warm['program_cache']['hits'] + warm['program_cache']['misses']))
+
+
+def main():
+    here   = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description='shader compile and link benchmark of GLOVE')
+    parser.add_argument('--tool',     required=True, help='path to glove_shaderbench')
+    parser.add_argument('--manifest', default=os.path.join(here, 'programs.txt'), help='programs of the corpus')
+    parser.add_argument('--filter',   help='only the programs whose name contains this')
+    parser.add_argument('--runs',     default=5, type=int, help='runs of each mode, the median is reported')
+    parser.add_argument('--output',   help='JSON file the report is written to')
+    args = parser.parse_args()
+
+    report = {}
+    for mode in MODES:
+        runs = []
+        for run in range(max(args.runs, 1)):
+            workdir = tempfile.mkdtemp(prefix='glove_shader_bench_')
+            try:
+                # the warm runs find the caches that a cold run of their own directory wrote
+                if mode == 'warm':
+                    run_tool(args, workdir, -1)
+                runs.append(run_tool(args, workdir, run))
+            finally:
+                shutil.rmtree(workdir)
+        report[mode] = median_of(runs)
+
+    print_report(report)
+    if args.output:
+        with open(args.output, 'w') as file:
+            json.dump(report, file, indent=2)
+
+    failed = [program['name'] for program in report['cold']['programs'] if not program['linked']]
+    if failed:
+        print('failed to link: %s' % ' '.join(failed))
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,16 @@
+#version 100
+
+#ifdef GL_ES
+  precision highp float;
+#endif
+
+varying float Depth;
+
+void main()
+{
+    // depth packed into RGBA8, there being no depth textures in ES 2.0
+    const vec4 shift = vec4(256.0 * 256.0 * 256.0, 256.0 * 256.0, 256.0, 1.0);
+    const vec4 mask  = vec4(0.0, 1.0 / 256.0, 1.0 / 256.0, 1.0 / 256.0);
+    vec4 packed = fract(Depth * shift);
+    gl_FragColor = packed - packed.xxyz * mask;
+}
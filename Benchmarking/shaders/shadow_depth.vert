@@ -0,0 +1,14 @@
+#version 100
+
+attribute vec3 position;
+
+uniform mat4 LightViewProjectionMatrix;
+uniform mat4 ModelMatrix;
+
+varying float Depth;
+
+void main()
+{
+    gl_Position = LightViewProjectionMatrix * ModelMatrix * vec4(position, 1.0);
+    Depth       = gl_Position.z / gl_Position.w * 0.5 + 0.5;
+}
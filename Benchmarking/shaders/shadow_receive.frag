@@ -0,0 +1,40 @@
+#version 100
+
+#ifdef GL_ES
+  precision highp float;
+#endif
+
+uniform sampler2D ShadowMap;
+uniform vec2      ShadowTexelSize;
+uniform vec3      LightDirection;
+uniform vec4      MaterialDiffuse;
+
+varying vec4 ShadowCoord;
+varying vec3 Normal;
+
+float UnpackDepth(vec4 rgba)
+{
+    const vec4 shift = vec4(1.0 / (256.0 * 256.0 * 256.0), 1.0 / (256.0 * 256.0), 1.0 / 256.0, 1.0);
+    return dot(rgba, shift);
+}
+
+float Shadow(vec3 coord)
+{
+    // 3x3 percentage closer filtering
+    float lit = 0.0;
+    for(int y = -1; y <= 1; ++y) {
+        for(int x = -1; x <= 1; ++x) {
+            vec2 offset = vec2(float(x), float(y)) * ShadowTexelSize;
+            lit += coord.z - 0.005 > UnpackDepth(texture2D(ShadowMap, coord.xy + offset)) ? 0.0 : 1.0;
+        }
+    }
+    return lit / 9.0;
+}
+
+void main()
+{
+    vec3  coord   = ShadowCoord.xyz / ShadowCoord.w;
+    float diffuse = max(dot(normalize(Normal), -LightDirection), 0.0);
+
+    gl_FragColor = vec4(MaterialDiffuse.rgb * (0.2 + 0.8 * diffuse * Shadow(coord)), MaterialDiffuse.a);
+}
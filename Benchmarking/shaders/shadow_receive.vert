@@ -0,0 +1,24 @@
+#version 100
+
+attribute vec3 position;
+attribute vec3 normal;
+
+uniform mat4 ModelViewProjectionMatrix;
+uniform mat4 LightViewProjectionMatrix;
+uniform mat4 ModelMatrix;
+uniform mat4 NormalMatrix;
+
+varying vec4 ShadowCoord;
+varying vec3 Normal;
+
+void main()
+{
+    const mat4 bias = mat4(0.5, 0.0, 0.0, 0.0,
+                           0.0, 0.5, 0.0, 0.0,
+                           0.0, 0.0, 0.5, 0.0,
+                           0.5, 0.5, 0.5, 1.0);
+
+    ShadowCoord = bias * LightViewProjectionMatrix * ModelMatrix * vec4(position, 1.0);
+    Normal      = vec3(NormalMatrix * vec4(normal, 0.0));
+    gl_Position = ModelViewProjectionMatrix * vec4(position, 1.0);
+}
@@ -0,0 +1,26 @@
+#version 100
+
+#ifdef GL_ES
+  precision mediump float;
+#endif
+
+struct Material {
+    vec4  tint;
+    float alphaCutoff;
+};
+
+uniform sampler2D Texture0;
+uniform Material  Surface;
+
+varying vec2 TextureCoord;
+varying vec3 Lighting;
+
+void main()
+{
+    vec4 albedo = texture2D(Texture0, TextureCoord) * Surface.tint;
+    if(albedo.a < Surface.alphaCutoff) {
+        discard;
+    }
+
+    gl_FragColor = vec4(albedo.rgb * Lighting, albedo.a);
+}
@@ -0,0 +1,41 @@
+#version 100
+
+#define MAX_BONES 24
+
+attribute vec3 position;
+attribute vec3 normal;
+attribute vec2 texcoord;
+attribute vec4 boneIndices;
+attribute vec4 boneWeights;
+
+struct Light {
+    vec3  position;
+    vec3  color;
+    float range;
+};
+
+uniform mat4  ModelViewProjectionMatrix;
+uniform mat4  ModelViewMatrix;
+uniform mat4  Bones[MAX_BONES];
+uniform Light KeyLight;
+
+varying vec2 TextureCoord;
+varying vec3 Lighting;
+
+void main()
+{
+    mat4 skin = Bones[int(boneIndices.x)] * boneWeights.x +
+                Bones[int(boneIndices.y)] * boneWeights.y +
+                Bones[int(boneIndices.z)] * boneWeights.z +
+                Bones[int(boneIndices.w)] * boneWeights.w;
+
+    vec4 P = ModelViewMatrix * skin * vec4(position, 1.0);
+    vec3 N = normalize(vec3(ModelViewMatrix * skin * vec4(normal, 0.0)));
+
+    vec3  D = KeyLight.position - P.xyz;
+    float d = length(D);
+    Lighting = vec3(0.1) + KeyLight.color * max(dot(N, D / d), 0.0) * clamp(1.0 - d / KeyLight.range, 0.0, 1.0);
+
+    TextureCoord = texcoord;
+    gl_Position  = ModelViewProjectionMatrix * skin * vec4(position, 1.0);
+}
@@ -0,0 +1,44 @@
+#version 100
+
+#ifdef GL_ES
+  precision mediump float;
+#endif
+
+uniform sampler2D NormalMap;
+uniform sampler2D GrassMap;
+uniform sampler2D RockMap;
+uniform sampler2D SnowMap;
+uniform vec3      LightDirection;
+uniform vec3      FogColor;
+uniform float     FogDensity;
+uniform vec2      DetailScale;
+
+varying vec2  TextureCoord;
+varying vec3  ViewPosition;
+varying float Height;
+
+vec3 Layer(vec2 coord, float height, float slope)
+{
+    vec3 grass = texture2D(GrassMap, coord).rgb;
+    vec3 rock  = texture2D(RockMap , coord).rgb;
+    vec3 snow  = texture2D(SnowMap , coord).rgb;
+
+    vec3 color = mix(grass, rock, smoothstep(0.3, 0.6, slope));
+    return mix(color, snow, smoothstep(0.7, 0.85, height) * (1.0 - slope));
+}
+
+void main()
+{
+    vec3  N     = normalize(texture2D(NormalMap, TextureCoord).xzy * 2.0 - 1.0);
+    float slope = 1.0 - N.y;
+    vec2  coord = TextureCoord * DetailScale;
+
+    vec3  color   = Layer(coord, Height, slope);
+    float diffuse = max(dot(N, -LightDirection), 0.0);
+    color *= 0.3 + 0.7 * diffuse;
+
+    float distance = length(ViewPosition);
+    float fog      = clamp(exp(-FogDensity * FogDensity * distance * distance), 0.0, 1.0);
+
+    gl_FragColor = vec4(mix(FogColor, color, fog), 1.0);
+}
@@ -0,0 +1,24 @@
+#version 100
+
+attribute vec2 position;
+
+uniform sampler2D HeightMap;
+uniform mat4      ModelViewProjectionMatrix;
+uniform mat4      ModelViewMatrix;
+uniform vec2      GridScale;
+uniform float     HeightScale;
+
+varying vec2  TextureCoord;
+varying vec3  ViewPosition;
+varying float Height;
+
+void main()
+{
+    // vertex texture fetch of the height, a GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS of at least 1 is required
+    TextureCoord = position * GridScale;
+    Height       = texture2DLod(HeightMap, TextureCoord, 0.0).r;
+
+    vec4 P       = vec4(position.x, Height * HeightScale, position.y, 1.0);
+    ViewPosition = vec3(ModelViewMatrix * P);
+    gl_Position  = ModelViewProjectionMatrix * P;
+}
@@ -0,0 +1,331 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+// Draws a grid of N small cubes with one draw call each, sweeping N over
+// stress_objects for every mode, and prints the CPU time spent issuing each
+// draw. The modes change one thing per draw over the uniforms only baseline,
+// so that the cost of program, texture and client array changes in the
+// driver can be told apart from the cost of the draw itself.
+
+#include "draw_calls_stress.h"
+
+static  openGL_mesh_t      mesh_cube;
+static  openGL_program_t   programs[STRESS_PROGRAMS];
+static  Texture            textures[STRESS_TEXTURES];
+static  openGL_viewport_t  viewport;
+static  openGL_rendering_t rendering;
+static  const char        *win_name;
+
+static  mat4x4            *mvps;
+static  stress_mode_t      mode;
+static  stress_mode_t      last_mode  = STRESS_MODES - 1;
+static  int                step;
+static  int                last_step  = STRESS_STEPS - 1;
+static  int                objects_override;
+static  int                frame;
+static  double             draw_time;
+
+static int StressObjects(void)
+{
+    return objects_override > 0 ? objects_override : stress_objects[step];
+}
+
+// Lays the objects out in a square grid that fills the screen
+static void LayoutObjects(int objects)
+{
+    int   columns = (int)ceilf(sqrtf((float)objects));
+    float cell    = 2.0f / columns;
+
+    for(int i = 0; i < objects; ++i) {
+        mat4x4 translation, model;
+        mat4x4_translate  (translation, -1.0f + cell * (i % columns + 0.5f), 1.0f - cell * (i / columns + 0.5f), 0.0f);
+        mat4x4_scale_aniso(model, translation, 0.35f * cell, 0.35f * cell, 0.35f * cell);
+        mat4x4_rotate_Y   (mvps[i], model, 0.01f * i);
+    }
+}
+
+static bool InitStressProgram(openGL_program_t *program, GLuint vertexShader, GLuint fragmentShader)
+{
+    InitProgram(program);
+    program->mVertexShader   = vertexShader;
+    program->mFragmentShader = fragmentShader;
+    if(!LoadProgram(vertexShader, fragmentShader, &program->mID))
+        return false;
+
+    glUseProgram(program->mID);
+    program->mLocationPos    = glGetAttribLocation (program->mID, "v_posCoord_in");
+    program->mLocationUV     = glGetAttribLocation (program->mID, "v_textCoord_in");
+    program->mLocationColor  = glGetAttribLocation (program->mID, "v_colorCoord_in");
+    program->mLocationMVP    = glGetUniformLocation(program->mID, "uniform_mvp");
+    glUniform1i(glGetUniformLocation(program->mID, "uniform_texture0"), 0);
+    glUniform1i(glGetUniformLocation(program->mID, "uniform_texture1"), 1);
+    glUniform1f(glGetUniformLocation(program->mID, "uniform_mix_value"), 0.5f);
+
+    return true;
+}
+
+// Small textures of a single color each, which take the place of the first diffuse texture
+static void InitStressTextures(void)
+{
+    GLubyte texels[STRESS_TEXTURE_SIZE * STRESS_TEXTURE_SIZE * 4];
+
+    for(int i = 0; i < STRESS_TEXTURES; ++i) {
+        for(int j = 0; j < STRESS_TEXTURE_SIZE * STRESS_TEXTURE_SIZE; ++j) {
+            texels[4 * j + 0] = (GLubyte)(i * 37);
+            texels[4 * j + 1] = (GLubyte)(i * 91);
+            texels[4 * j + 2] = (GLubyte)(i * 53);
+            texels[4 * j + 3] = 255;
+        }
+
+        textures[i].width  = STRESS_TEXTURE_SIZE;
+        textures[i].height = STRESS_TEXTURE_SIZE;
+        textures[i].type   = GL_RGBA;
+        glGenTextures  (1, &textures[i].texID);
+        glBindTexture  (GL_TEXTURE_2D, textures[i].texID);
+        glTexImage2D   (GL_TEXTURE_2D, 0, GL_RGBA, STRESS_TEXTURE_SIZE, STRESS_TEXTURE_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    }
+}
+
+bool InitGL()
+{
+  // Print GPU specifications
+    GpuViewer();
+
+// Initialize Shader Programs, all linked from the same shaders
+    GLuint vertexShader, fragmentShader;
+    if(!LoadShader(VERTEX_SHADER_NAME, &vertexShader, GL_VERTEX_SHADER))
+        return false;
+    if(!LoadShader(FRAGMENT_SHADER_NAME, &fragmentShader, GL_FRAGMENT_SHADER))
+        return false;
+    for(int i = 0; i < STRESS_PROGRAMS; ++i) {
+        if(!InitStressProgram(&programs[i], vertexShader, fragmentShader))
+            return false;
+    }
+
+// Free Shader Compiler Resources
+    glReleaseShaderCompiler();
+
+// Initialize Mesh
+    InitMesh      (&mesh_cube, 3, 12, cube_vertex_buffer_data, sizeof(cube_vertex_buffer_data)                             ,
+                                      cube_uv_buffer_data    , sizeof(cube_uv_buffer_data)                                 ,
+                                      cube_color_buffer_data , sizeof(cube_color_buffer_data)                              ,
+                                      cube_index_buffer_data , cube_index_buffer_data ? sizeof(cube_index_buffer_data) : 0 ,
+                                      diffuse_textures, 2);
+
+// Initialize Textures
+    InitStressTextures();
+
+// Initialize Object Transformations, for the largest step of the sweep
+    int max_objects = objects_override > 0 ? objects_override : stress_objects[STRESS_STEPS - 1];
+    mvps = (mat4x4 *)malloc(max_objects * sizeof(mat4x4));
+    if(!mvps)
+        return false;
+    LayoutObjects(StressObjects());
+
+// Basic Rendering Setup, (a) Init Depth & (b) Init Background Color
+    InitRendering (&rendering, COLOR_BLACK);
+
+// Culling Setup
+    glEnable      (GL_CULL_FACE);
+    glCullFace    (GL_BACK);
+    glFrontFace   (GL_CW);
+
+// Depth Testing Setup
+    glEnable      (GL_DEPTH_TEST);
+    glDepthFunc   (GL_LEQUAL);
+    glClearDepthf (rendering.mDepth);
+
+// Set Clear Color
+    glClearColor  (rendering.mBackgroundColor[0], rendering.mBackgroundColor[1], rendering.mBackgroundColor[2], rendering.mBackgroundColor[3]);
+
+#ifdef INFO_DISPLAY
+    printf("[Draw Calls] [Programs] [%d] [Textures] [%d] [Frames per step] [%d]\n", STRESS_PROGRAMS, STRESS_TEXTURES, STRESS_MEASURED_FRAMES);
+#endif
+
+// Check for opengGL-relate Errors
+    ASSERT_NO_GL_ERROR();
+
+    return true;
+}
+
+void DrawGL(void)
+{
+    int     objects  = StressObjects();
+    Texture *diffuse = mesh_cube.mTexture[0];
+
+// Start the CPU time of the frame
+    CpuTimerStart();
+
+// Set Viewport
+    glViewport(0, 0, viewport.mWidth, viewport.mHeight);
+
+// Clear Depth & Color of Screen Buffer
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+// Draw Scene, one draw call per object
+    double start = ProfilerNow();
+    for(int i = 0; i < objects; ++i) {
+        openGL_program_t *program = &programs[mode == STRESS_UNIQUE_PROGRAMS ? i % STRESS_PROGRAMS : 0];
+
+        if(mode == STRESS_UNIQUE_TEXTURES)
+            mesh_cube.mTexture[0] = &textures[i % STRESS_TEXTURES];
+
+        glUseProgram(program->mID);
+        glUniformMatrix4fv(program->mLocationMVP, 1, GL_FALSE, (const float *)&mvps[i][0][0]);
+
+        if(mode == STRESS_CLIENT_ARRAYS)
+            DrawMeshClientArrays(program, &mesh_cube);
+        else
+            DrawMesh(program, &mesh_cube);
+    }
+    draw_time += ProfilerNow() - start;
+
+    mesh_cube.mTexture[0] = diffuse;
+
+// Check for opengGL-relate Errors
+    ASSERT_NO_GL_ERROR();
+
+// Stop the CPU time of the frame
+    CpuTimerStop();
+}
+
+void IdleGL(void)
+{
+    GpuTimer(win_name);
+
+    if(++frame == STRESS_WARMUP_FRAMES)
+        draw_time = 0.0;
+
+    if(frame == STRESS_WARMUP_FRAMES + STRESS_MEASURED_FRAMES) {
+        int objects = StressObjects();
+        printf("[Draw Calls] [%s] [%d objects] [%.3f us per draw]\n", mode_titles[mode], objects,
+               1e6 * draw_time / ((double)objects * STRESS_MEASURED_FRAMES));
+        fflush(stdout);
+
+// Move on to the next step of the sweep, and to the next mode after the last one
+        frame = 0;
+        if(step == last_step) {
+            if(mode == last_mode)
+                KeyboardGL(ESC_KEY);
+            mode = (stress_mode_t)(mode + 1);
+            step = objects_override > 0 ? last_step : 0;
+        } else {
+            ++step;
+        }
+        LayoutObjects(StressObjects());
+    }
+
+    eglutPostRedisplay();
+}
+
+void DestroyGL(void)
+{
+// Delete Programs, which share their shaders
+    for(int i = 0; i < STRESS_PROGRAMS; ++i)
+        glDeleteProgram(programs[i].mID);
+    glDeleteShader(programs[0].mVertexShader);
+    glDeleteShader(programs[0].mFragmentShader);
+// Delete Textures
+    for(int i = 0; i < STRESS_TEXTURES; ++i)
+        glDeleteTextures(1, &textures[i].texID);
+// Delete Mesh
+    DeleteMesh    (&mesh_cube);
+
+    free(mvps);
+    mvps = NULL;
+}
+
+void ReshapeGL(int width, int height)
+{
+// Set viewport
+    SetViewport(&viewport, 0, 0, width, height);
+}
+
+void KeyboardGL(unsigned char key)
+{
+   if (key == ESC_KEY) // escape key
+   {
+// Close app
+     DestroyGL();
+     if (_eglut->current)
+        eglutDestroyWindow(_eglut->current->index);
+     _eglutFini();
+
+      exit(0);
+   }
+}
+
+// --mode NAME runs the sweep of a single mode, and --objects N a single step of N objects
+static void ParseStressArgs(int argc, char **argv)
+{
+    for(int i = 1; i + 1 < argc; ++i) {
+        if(!strcmp(argv[i], "--mode")) {
+            for(int m = 0; m < STRESS_MODES; ++m) {
+                if(!strcmp(argv[i + 1], mode_titles[m]))
+                    mode = last_mode = (stress_mode_t)m;
+            }
+            ++i;
+        }
+        else if(!strcmp(argv[i], "--objects")) {
+            objects_override = atoi(argv[++i]);
+        }
+    }
+
+    if(objects_override > 0)
+        step = last_step;
+}
+
+#ifdef VK_USE_PLATFORM_MACOS_MVK
+int macos_main(int argc, char **argv)
+#else
+int main(int argc, char **argv)
+#endif
+{
+    win_name = EXECUTABLE_NAME(argv[0]);
+    ProfilerInit        (argc, argv);
+    ParseStressArgs     (argc, argv);
+
+    eglutInitWindowSize (WIDTH, HEIGHT);
+    eglutInitAPIMask    (EGLUT_OPENGL_ES2_BIT);
+    eglutInit           (argc, (const char **)argv);
+
+    int win = eglutCreateWindow(win_name);
+
+    eglutIdleFunc       (IdleGL);
+    eglutDisplayFunc    (DrawGL);
+    eglutReshapeFunc    (ReshapeGL);
+    eglutKeyboardFunc   (KeyboardGL);
+
+    if(!InitGL()) {
+        return 1;
+    }
+
+    if(SmokeTestsRunning()) {
+        ReshapeGL(WIDTH, HEIGHT);
+        char *fileName = EXECUTABLE_NAME(argv[0]);
+        TakeScreenshot(fileName, DrawGL, WIDTH, HEIGHT);
+        DestroyGL();
+        eglutDestroyWindow(win);
+        _eglutFini();
+
+    } else {
+        eglutMainLoop();
+#ifndef VK_USE_PLATFORM_MACOS_MVK
+        DestroyGL();
+#endif
+    }
+
+    return 0;
+}
@@ -0,0 +1,53 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+#ifndef __DRAW_CALLS_STRESS_H_
+#define __DRAW_CALLS_STRESS_H_
+
+#include "../engine/glcore/common.h"
+#include "../assets/geometry/cube.h"
+
+#define VERTEX_SHADER_NAME          SOURCES_PATH SHADERS_PATH "geometry3d_textures.vert"
+#define FRAGMENT_SHADER_NAME        SOURCES_PATH SHADERS_PATH "geometry3d_textures.frag"
+
+#ifdef VK_USE_PLATFORM_MACOS_MVK
+static const char* diffuse_textures [] = { "assets/textures/tsi_256x256.tga", "assets/textures/vulkan_512x512.tga"};
+#else
+static const char* diffuse_textures [] = { "../assets/textures/tsi_256x256.tga", "../assets/textures/vulkan_512x512.tga"};
+#endif
+
+// Objects drawn per frame at each step of the sweep
+static const int   stress_objects   [] = { 100, 500, 1000, 5000, 10000, 50000 };
+#define STRESS_STEPS                (int)(sizeof(stress_objects) / sizeof(stress_objects[0]))
+
+// Frames drawn before and while measuring each step
+#define STRESS_WARMUP_FRAMES        10
+#define STRESS_MEASURED_FRAMES      30
+
+// Distinct programs and textures the objects cycle through in the modes that vary them
+#define STRESS_PROGRAMS             64
+#define STRESS_TEXTURES             1024
+#define STRESS_TEXTURE_SIZE         4
+
+// Each mode changes one thing per draw over the baseline of shared objects
+typedef enum {
+    STRESS_UNIFORMS_ONLY = 0,
+    STRESS_UNIQUE_PROGRAMS,
+    STRESS_CLIENT_ARRAYS,
+    STRESS_UNIQUE_TEXTURES,
+    STRESS_MODES
+} stress_mode_t;
+
+static const char* mode_titles      [] = { "UNIFORMS_ONLY", "UNIQUE_PROGRAMS", "CLIENT_ARRAYS", "UNIQUE_TEXTURES" };
+
+#endif // __DRAW_CALLS_STRESS_H_
@@ -138,6 +138,9 @@ bool InitGL()
 
 void DrawGL(void)
 {
+// Start the CPU time of the frame
+    CpuTimerStart();
+
 // Set Viewport
     glViewport(0, 0, viewport.mWidth, viewport.mHeight);
 
@@ -161,6 +164,9 @@ void DrawGL(void)
 
 // Check for opengGL-relate Errors
     ASSERT_NO_GL_ERROR();
+
+// Stop the CPU time of the frame
+    CpuTimerStop();
 }
 
 void IdleGL(void)
@@ -171,7 +177,7 @@ void IdleGL(void)
     double timePerFrame = GpuTimer(win_name);
 
     totalTimeScript    += timePerFrame;
-    if(totalTimeScript >= (float)KILL_APP_PERIOD)
+    if(ProfilerFinished(totalTimeScript))
         KeyboardGL(ESC_KEY);
 
     eglutPostRedisplay();
@@ -230,6 +236,7 @@ int main(int argc, char **argv)
 #endif
 {
     win_name = EXECUTABLE_NAME(argv[0]);
+    ProfilerInit        (argc, argv);
 
     eglutInitWindowSize (WIDTH, HEIGHT);
     eglutInitAPIMask    (EGLUT_OPENGL_ES2_BIT);
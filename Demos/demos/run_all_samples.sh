@@ -15,6 +15,8 @@ function printUsage() {
     echo " --debug      # Save OpenGL ES API Debug output in a file per demo"
     echo " --profile    # Save OpenGL ES API Profile output in a file per demo"
     echo " --smoke      # Run GLOVE Smoke Tests"
+    echo " --frames N   # Run each demo for N frames and print its frame time percentiles"
+    echo " --warmup M   # Skip the first M frames of each demo in --frames mode"
 }
 
 function setupDemos() {
@@ -54,7 +56,7 @@ function runDemos() {
         echo "SAMPLE:  ./$BNAME"
 
         # run the built sample;
-        RNAME=./${BNAME}
+        RNAME="./${BNAME} ${BENCHMARK_ARGS}"
 
         if   [ $DEBUG == "true" ] && [ $PROFILE == "true" ]; then
             $RNAME >${BNAME}_gl_profile.log 2>${BNAME}_gl_error.log
@@ -99,9 +101,11 @@ function evaluateSmokeResults() {
 DEBUG=false
 PROFILE=false
 SMOKE_TESTS=false
+BENCHMARK_ARGS=""
 
-for option in "$@"
+while [ $# -gt 0 ]
 do
+    option=$1
     case $option in
         --help)
             printUsage
@@ -119,6 +123,15 @@ do
             SMOKE_TESTS=true
             echo "Run Smoke Tests ($option)"
             ;;
+        --frames|--warmup)
+            if [ -z "$2" ]; then
+                printUsage
+                exit 1
+            fi
+            BENCHMARK_ARGS="$BENCHMARK_ARGS $option $2"
+            echo "Frame Benchmark ($option $2)"
+            shift
+            ;;
         *)
             printUsage
             exit 1
@@ -0,0 +1,120 @@
+#!/usr/bin/env python3
+# Renders every demo headless to a pbuffer in GLOVE_CI mode, in parallel
+# processes, and compares the frame each one saves against its image in
+# Demos/ref. A pixel differs when one of its channels is further than the
+# fuzz from the reference; a demo fails when more pixels than allowed differ.
+# Exits with 1 when a demo fails, so that it can gate changes as a CTest test.
+
+import argparse
+import concurrent.futures
+import math
+import os
+import subprocess
+import sys
+
+DEMOS = [
+    'triangle2d_one_color',
+    'triangle2d_split_colors',
+    'circle2d_sdf',
+    'texture2d_color',
+    'cube3d_vertexcolors',
+    'cube3d_textures',
+    'render_to_texture_filter_gamma',
+    'render_to_texture_filter_invert',
+    'render_to_texture_filter_grayscale',
+    'render_to_texture_filter_sobel',
+    'render_to_texture_filter_boxblur',
+]
+
+
+def compare(image, reference, width, fuzz):
+    """Returns the differing pixels, the RMSE over all channels and a diff image."""
+    if image == reference:
+        return 0, 0.0, None
+    differing = 0
+    squares   = 0
+    diff      = bytearray(len(image) // 4 * 3)
+    for pixel in range(len(image) // 4):
+        i = pixel * 4
+        deltas = [abs(image[i + c] - reference[i + c]) for c in range(4)]
+        squares += sum(d * d for d in deltas)
+        o = pixel * 3
+        if max(deltas) > fuzz:
+            differing += 1
+            diff[o] = 255
+        else:
+            # the reference dimmed, so that the differing pixels stand out
+            diff[o] = diff[o + 1] = diff[o + 2] = (reference[i] + reference[i + 1] + reference[i + 2]) // 12
+    rmse = math.sqrt(squares / float(len(image)))
+    # the frames are read bottom-up, the diff is written top-down
+    rows = [diff[row * width * 3:(row + 1) * width * 3] for row in range(len(diff) // (width * 3))]
+    return differing, rmse, b''.join(reversed(rows))
+
+
+def run_demo(name, args):
+    output = os.path.join(args.demos_dir, name + '.rgba')
+    if os.path.exists(output):
+        os.remove(output)
+
+    env = dict(os.environ, GLOVE_DEMOS_MODE='GLOVE_CI')
+    command = [os.path.join(args.demos_dir, name)] + ([] if args.windowed else ['-pbuffer'])
+    try:
+        result = subprocess.run(command, cwd=args.demos_dir, env=env, timeout=args.timeout,
+                                stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    except subprocess.TimeoutExpired:
+        return name, 'FAIL', 'timed out after %d s' % args.timeout
+    except OSError as error:
+        return name, 'FAIL', 'cannot run: %s' % error
+    if result.returncode != 0 or not os.path.exists(output):
+        log = result.stdout.decode(errors='replace').strip().splitlines()
+        return name, 'FAIL', 'exited with %d%s' % (result.returncode, (': ' + log[-1]) if log else '')
+
+    reference = os.path.join(args.ref_dir, name + '.rgba')
+    if not os.path.exists(reference):
+        return name, 'MISS', 'reference image is missing'
+
+    with open(output, 'rb') as file:
+        image = file.read()
+    with open(reference, 'rb') as file:
+        expected = file.read()
+    if len(image) != len(expected) or len(image) != args.width * args.height * 4:
+        return name, 'FAIL', 'size is %d bytes, %d expected' % (len(image), len(expected))
+
+    differing, rmse, diff = compare(image, expected, args.width, args.fuzz)
+    if diff is not None:
+        with open(os.path.join(args.demos_dir, name + '-diff.ppm'), 'wb') as file:
+            file.write(b'P6\n%d %d\n255\n' % (args.width, args.height))
+            file.write(diff)
+    summary = '%d differing pixels, RMSE %.2f' % (differing, rmse)
+    return name, 'PASS' if differing <= args.max_pixels else 'FAIL', summary
+
+
+def main():
+    here   = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description='reference image tests of the GLOVE demos')
+    parser.add_argument('demos',        nargs='*', default=DEMOS, help='demos to run, all by default')
+    parser.add_argument('--demos-dir',  default=here, help='directory of the built demos')
+    parser.add_argument('--ref-dir',    default=os.path.join(here, '..', '..', '..', 'Demos', 'ref'), help='directory of the reference images')
+    parser.add_argument('--jobs',       default=os.cpu_count() or 1, type=int, help='demos run in parallel')
+    parser.add_argument('--fuzz',       default=8, type=int, help='channel difference a pixel may have and still match')
+    parser.add_argument('--max-pixels', default=0, type=int, help='differing pixels a demo may have and still pass')
+    parser.add_argument('--width',      default=600, type=int, help='width the demos were built with')
+    parser.add_argument('--height',     default=600, type=int, help='height the demos were built with')
+    parser.add_argument('--timeout',    default=60, type=int, help='seconds a demo may run')
+    parser.add_argument('--windowed',   action='store_true', help='render to a window rather than a pbuffer')
+    args = parser.parse_args()
+
+    with concurrent.futures.ProcessPoolExecutor(max_workers=max(args.jobs, 1)) as executor:
+        results = list(executor.map(run_demo, args.demos, [args] * len(args.demos)))
+
+    failures = 0
+    for name, status, summary in results:
+        print('%-4s %-40s %s' % (status, name, summary))
+        failures += status != 'PASS'
+
+    print('%d of %d demos passed' % (len(results) - failures, len(results)))
+    return 1 if failures else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
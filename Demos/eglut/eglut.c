@@ -28,6 +28,8 @@
 
 #include "eglutint.h"
 
+#include <math.h>
+
 static struct eglut_state _eglut_state = {
    .api_mask = EGLUT_OPENGL_ES2_BIT,
    .window_width = 600,
@@ -73,13 +75,30 @@ _eglutNow(void)
 #endif
 }
 
+/* return a monotonic time in milliseconds, finer than _eglutNow */
+static double
+_eglutNowPrecise(void)
+{
+#ifdef WIN32
+   LARGE_INTEGER frequency, counter;
+   QueryPerformanceFrequency(&frequency);
+   QueryPerformanceCounter(&counter);
+   return (double)counter.QuadPart * 1000.0 / (double)frequency.QuadPart;
+#else
+   struct timeval tv;
+   (void) gettimeofday(&tv, NULL);
+   return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+#endif
+}
+
 static void
 _eglutDestroyWindow(struct eglut_window *win)
 {
    if (_eglut->surface_type != EGL_PBUFFER_BIT)
       eglDestroySurface(_eglut->dpy, win->surface);
 
-   _eglutNativeFiniWindow(win);
+   if (!_eglut->headless)
+      _eglutNativeFiniWindow(win);
 
    eglDestroyContext(_eglut->dpy, win->context);
 }
@@ -179,6 +198,8 @@ _eglutCreateWindow(const char *title, int x, int y, int w, int h)
                        EGL_HEIGHT, h,
                        EGL_NONE};
       win->surface = eglCreatePbufferSurface(_eglut->dpy, win->config, attr);
+      win->native.width = w;
+      win->native.height = h;
       } break;
    default:
       break;
@@ -213,9 +234,24 @@ eglutInit(int argc, const char **argv)
       else if (strcmp(argv[i], "-info") == 0) {
          _eglut->verbose = 1;
       }
+      else if (strcmp(argv[i], "-pbuffer") == 0)
+         _eglut->headless = 1;
+      else if (strcmp(argv[i], "-continuous") == 0)
+         _eglut->continuous = 1;
+      else if (strcmp(argv[i], "-steady") == 0)
+         _eglut->continuous = _eglut->steady = 1;
+      else if (strcmp(argv[i], "-maxframes") == 0 && i + 1 < argc) {
+         _eglut->continuous = 1;
+         _eglut->max_frames = atoi(argv[++i]);
+      }
    }
 
-   _eglutNativeInitDisplay();
+   if (_eglut->headless) {
+      _eglut->native_dpy = EGL_DEFAULT_DISPLAY;
+      _eglut->surface_type = EGL_PBUFFER_BIT;
+   }
+   else
+      _eglutNativeInitDisplay();
    _eglut->dpy = eglGetDisplay(_eglut->native_dpy);
 
    if (!eglInitialize(_eglut->dpy, &_eglut->major, &_eglut->minor))
@@ -271,7 +307,8 @@ void
 _eglutFini(void)
 {
    eglTerminate(_eglut->dpy);
-   _eglutNativeFiniDisplay();
+   if (!_eglut->headless)
+      _eglutNativeFiniDisplay();
 }
 
 void
@@ -288,6 +325,106 @@ eglutDestroyWindow(int win)
    free(window);
 }
 
+static void
+_eglutBenchmarkReport(const char *reason)
+{
+   double mean = _eglut->bench.means[(_eglut->bench.windows - 1) % EGLUT_STEADY_WINDOWS];
+
+   if (!_eglut->bench.windows) {
+      printf("[eglut] %s after %d frames, too few for a window of %d\n",
+             reason, _eglut->bench.frames, EGLUT_STEADY_WINDOW_FRAMES);
+      return;
+   }
+
+   printf("[eglut] %s after %d frames, %.1f s: sustained %.1f fps (%.3f ms), first window %.1f fps (%.3f ms)\n",
+          reason, _eglut->bench.frames, (_eglutNow() - _eglut->init_time) / 1000.0,
+          1000.0 / mean, mean,
+          1000.0 / _eglut->bench.first_window_mean, _eglut->bench.first_window_mean);
+}
+
+static int
+_eglutBenchmarkIsSteady(void)
+{
+   double sum = 0.0, low, high;
+   int i;
+
+   if (_eglut->bench.windows < EGLUT_STEADY_WINDOWS)
+      return 0;
+
+   low = high = _eglut->bench.means[0];
+   for (i = 0; i < EGLUT_STEADY_WINDOWS; i++) {
+      sum += _eglut->bench.means[i];
+      if (_eglut->bench.means[i] < low)
+         low = _eglut->bench.means[i];
+      if (_eglut->bench.means[i] > high)
+         high = _eglut->bench.means[i];
+   }
+
+   /* throttling shows as a drift of the mean, which settles once the board is thermally steady */
+   return (high - low) <= EGLUT_STEADY_TOLERANCE * sum / EGLUT_STEADY_WINDOWS;
+}
+
+static void
+_eglutBenchmarkEnd(const char *reason)
+{
+   _eglutBenchmarkReport(reason);
+
+   if (_eglut->current)
+      eglutDestroyWindow(_eglut->current->index);
+   _eglutFini();
+
+   exit(0);
+}
+
+void
+_eglutSwapBuffers(struct eglut_window *win)
+{
+   double now, frame, mean, variance;
+
+   eglSwapBuffers(_eglut->dpy, win->surface);
+
+   if (!_eglut->continuous)
+      return;
+
+   /* the next frame is drawn without waiting for an event */
+   _eglut->redisplay = 1;
+
+   now = _eglutNowPrecise();
+   if (_eglut->bench.last_swap == 0.0) {
+      _eglut->bench.last_swap = now;
+      return;
+   }
+
+   frame = now - _eglut->bench.last_swap;
+   _eglut->bench.last_swap = now;
+   _eglut->bench.frames++;
+   _eglut->bench.window_sum += frame;
+   _eglut->bench.window_sum_sq += frame * frame;
+
+   if (++_eglut->bench.window_frames == EGLUT_STEADY_WINDOW_FRAMES) {
+      mean = _eglut->bench.window_sum / EGLUT_STEADY_WINDOW_FRAMES;
+      variance = _eglut->bench.window_sum_sq / EGLUT_STEADY_WINDOW_FRAMES - mean * mean;
+
+      if (!_eglut->bench.windows)
+         _eglut->bench.first_window_mean = mean;
+      _eglut->bench.means[_eglut->bench.windows % EGLUT_STEADY_WINDOWS] = mean;
+      _eglut->bench.windows++;
+
+      printf("[eglut] window %d: %.1f fps, %.3f ms mean, %.3f ms stddev\n",
+             _eglut->bench.windows, 1000.0 / mean, mean, variance > 0.0 ? sqrt(variance) : 0.0);
+
+      _eglut->bench.window_sum = 0.0;
+      _eglut->bench.window_sum_sq = 0.0;
+      _eglut->bench.window_frames = 0;
+
+      if (_eglut->steady && _eglutBenchmarkIsSteady())
+         _eglutBenchmarkEnd("steady");
+   }
+
+   if (_eglut->max_frames && _eglut->bench.frames >= _eglut->max_frames)
+      _eglutBenchmarkEnd(_eglut->steady ? "not steady" : "done");
+}
+
 static void
 _eglutDefaultKeyboard(unsigned char key)
 {
@@ -318,6 +455,10 @@ eglutCreateWindow(const char *title)
       _eglutFatal("failed to make window current");
    _eglut->current = win;
 
+   /* mailbox, or immediate, presentation on a window */
+   if (_eglut->continuous)
+      eglSwapInterval(_eglut->dpy, 0);
+
    return win->index;
 }
 
@@ -90,6 +90,6 @@ macos_draw_cb(void)
         if(win->display_cb) {
             win->display_cb();
         }
-        eglSwapBuffers(_eglut->dpy, win->surface);
+        _eglutSwapBuffers(win);
     }
 }
@@ -259,7 +259,7 @@ _eglutNativeEventLoop(void)
 
           if (win->display_cb)
               win->display_cb();
-          eglSwapBuffers(_eglut->dpy, win->surface);
+          _eglutSwapBuffers(win);
 
           wl_display_roundtrip(_eglut->native_dpy);
       }
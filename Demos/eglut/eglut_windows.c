@@ -165,7 +165,7 @@ static LRESULT CALLBACK WindowProc(HWND hWnd, UINT message, WPARAM wParam, LPARA
 
                 if(win->display_cb)
                     win->display_cb();
-                 eglSwapBuffers(_eglut->dpy, win->surface);
+                 _eglutSwapBuffers(win);
              }
         }
         _eglut->redisplay = 1;
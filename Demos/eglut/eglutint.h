@@ -40,6 +40,21 @@
 
 #define __VMS
 
+/* -continuous: frames per window of the frame time statistics */
+#ifndef EGLUT_STEADY_WINDOW_FRAMES
+#define EGLUT_STEADY_WINDOW_FRAMES 300
+#endif
+
+/* -continuous: the throughput is steady once the mean frame time of this many
+   consecutive windows stays within EGLUT_STEADY_TOLERANCE of their average */
+#ifndef EGLUT_STEADY_WINDOWS
+#define EGLUT_STEADY_WINDOWS 3
+#endif
+
+#ifndef EGLUT_STEADY_TOLERANCE
+#define EGLUT_STEADY_TOLERANCE 0.02
+#endif
+
 struct eglut_window {
    EGLConfig config;
    EGLContext context;
@@ -69,8 +84,24 @@ struct eglut_state {
    int window_width, window_height;
    const char *display_name;
    int verbose;
+   int headless; /* -pbuffer, renders to a pbuffer without a native display */
    int init_time;
 
+   /* -continuous, draws back to back with a swap interval of 0 */
+   int continuous;
+   int steady;     /* -steady, ends once the throughput is steady */
+   int max_frames; /* -maxframes N, ends after N frames, 0 for no limit */
+   struct {
+      int frames;
+      double last_swap;          /* ms */
+      double window_sum;         /* ms */
+      double window_sum_sq;      /* ms^2 */
+      int window_frames;
+      int windows;
+      double first_window_mean;  /* ms */
+      double means[EGLUT_STEADY_WINDOWS];
+   } bench;
+
    EGLUTidleCB idle_cb;
 
    int num_windows;
@@ -98,6 +129,9 @@ _eglutNow(void);
 void
 _eglutFini(void);
 
+void
+_eglutSwapBuffers(struct eglut_window *win);
+
 void
 _eglutStoreName(const char *title);
 
@@ -37,6 +37,11 @@ void InitMesh(struct openGL_mesh_t *mesh, const int vertex_components_num, const
     mesh->mSpinAngle = 1.0f;
     mat4x4_identity(mesh->mModelMatrix);
 
+    mesh->mVertexData = vertex_buffer_data;
+    mesh->mUVData     = uv_buffer_data_size    > 0 ? uv_buffer_data    : NULL;
+    mesh->mColorData  = color_buffer_data_size > 0 ? color_buffer_data : NULL;
+    mesh->mIndexData  = index_buffer_data_size > 0 ? index_buffer_data : NULL;
+
     glGenBuffers(1, &mesh->mVerticesVbo);
     assert(mesh->mVerticesVbo);
     glBindBuffer(GL_ARRAY_BUFFER, mesh->mVerticesVbo);
@@ -134,6 +139,50 @@ void DrawMesh(struct openGL_program_t *program, struct openGL_mesh_t *mesh)
     ASSERT_NO_GL_ERROR();
 }
 
+void DrawMeshClientArrays(struct openGL_program_t *program, struct openGL_mesh_t *mesh)
+{
+    glUseProgram(program->mID);
+
+    // Load Textures
+    for (size_t i = 0; i < (size_t)mesh->mTexturesNum; i++) {
+        glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_2D, mesh->mTexture[i]->texID);
+    }
+
+    // Read the attributes from the host arrays, with no buffer bound
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    assert(program->mLocationPos > -1);
+    glEnableVertexAttribArray (program->mLocationPos);
+    glVertexAttribPointer (program->mLocationPos, mesh->mVertexComponentsNum, GL_FLOAT, GL_FALSE, mesh->mVertexComponentsNum * sizeof(float), mesh->mVertexData);
+
+    if(mesh->mUVData && program->mLocationUV > -1) {
+        glEnableVertexAttribArray(program->mLocationUV);
+        glVertexAttribPointer    (program->mLocationUV, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), mesh->mUVData);
+    }
+
+    if(mesh->mColorData && program->mLocationColor > -1) {
+        glEnableVertexAttribArray(program->mLocationColor);
+        glVertexAttribPointer(program->mLocationColor, mesh->mVertexComponentsNum, GL_FLOAT, GL_FALSE, mesh->mVertexComponentsNum * sizeof(float), mesh->mColorData);
+    }
+
+    if(mesh->mIndexData) {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        glDrawElements(GL_TRIANGLES, mesh->mVerticesNum, GL_UNSIGNED_INT, mesh->mIndexData);
+    }
+    else {
+        glDrawArrays(GL_TRIANGLES, 0, mesh->mVerticesNum);
+    }
+
+    glDisableVertexAttribArray(program->mLocationPos);
+    if(mesh->mUVData && program->mLocationUV > -1) {
+        glDisableVertexAttribArray(program->mLocationUV);
+    }
+    if(mesh->mColorData && program->mLocationColor > -1) {
+        glDisableVertexAttribArray(program->mLocationColor);
+    }
+    ASSERT_NO_GL_ERROR();
+}
+
 void DeleteMesh(struct openGL_mesh_t *mesh)
 {
     glDeleteBuffers(1, &mesh->mVerticesVbo);
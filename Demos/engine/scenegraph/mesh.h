@@ -30,6 +30,12 @@ typedef struct openGL_mesh_t
     GLuint     mColorsVbo;
     GLuint     mIndicesIbo;
 
+    // the data the buffers were created with, for drawing from client arrays
+    const GLfloat *mVertexData;
+    const GLfloat *mUVData;
+    const GLfloat *mColorData;
+    const GLuint  *mIndexData;
+
     mat4x4     mModelMatrix;
     GLfloat    mSpinAngle;
     Texture   *mTexture[2];
@@ -39,6 +45,7 @@ typedef struct openGL_mesh_t
 void DeleteMesh(struct openGL_mesh_t *mesh);
 void RotateMesh(struct openGL_mesh_t *mesh, const vec3 axis);
 void DrawMesh(struct openGL_program_t *program, struct openGL_mesh_t *mesh);
+void DrawMeshClientArrays(struct openGL_program_t *program, struct openGL_mesh_t *mesh);
 void TransformMesh(struct openGL_program_t *program, struct openGL_mesh_t *mesh, struct openGL_camera_t *camera);
 void InitMesh(struct openGL_mesh_t *mesh, const int vertex_components_num, const int primitives_num,
               const GLfloat vertex_buffer_data[], const int vertex_buffer_data_size,
@@ -11,8 +11,137 @@
  * Lesser General Public License for more details.
  */
 
+// clock_gettime is POSIX, beyond the C99 the demos are built with
+#ifndef WIN32
+#define _POSIX_C_SOURCE 200809L
+#include <time.h>
+#endif
+
 #include "profiler.h"
 
+typedef struct {
+    int     frames;
+    int     warmup;
+    int     count;
+    int     seen;
+    double  cpuStart;
+    double  cpuTime;
+    double *wallTimes;
+    double *cpuTimes;
+    const char *title;
+} frame_profiler_t;
+
+static frame_profiler_t profiler = { 0, 0, 0, 0, 0.0, 0.0, NULL, NULL, NULL };
+
+// Monotonic time in seconds, unaffected by changes of the system clock
+static double Now(void)
+{
+#ifdef WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + (ts.tv_nsec / 1000000000.0);
+#endif
+}
+
+double ProfilerNow(void)
+{
+    return Now();
+}
+
+static int CompareTimes(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of sorted times
+static double Percentile(const double *times, int count, double percent)
+{
+    int rank = (int)(percent / 100.0 * count + 0.999999);
+    if(rank < 1)
+        rank = 1;
+    return times[rank - 1];
+}
+
+static void PrintFrameTimes(const char *name, double *times, int count)
+{
+    qsort(times, count, sizeof(double), CompareTimes);
+    printf("[%-4s Frame Time] [p50 %8.3f ms] [p95 %8.3f ms] [p99 %8.3f ms] [max %8.3f ms]\n", name,
+           Percentile(times, count, 50.0) * 1000.0, Percentile(times, count, 95.0) * 1000.0,
+           Percentile(times, count, 99.0) * 1000.0, times[count - 1] * 1000.0);
+}
+
+void ProfilerInit(int argc, char **argv)
+{
+    for(int i = 1; i + 1 < argc; ++i) {
+        if(!strcmp(argv[i], "--frames"))
+            profiler.frames = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--warmup"))
+            profiler.warmup = atoi(argv[++i]);
+    }
+
+    if(profiler.frames <= 0) {
+        profiler.frames = 0;
+        return;
+    }
+    if(profiler.warmup < 0)
+        profiler.warmup = 0;
+
+    profiler.wallTimes = (double *)malloc(profiler.frames * sizeof(double));
+    profiler.cpuTimes  = (double *)malloc(profiler.frames * sizeof(double));
+}
+
+void CpuTimerStart(void)
+{
+    profiler.cpuStart = Now();
+}
+
+void CpuTimerStop(void)
+{
+    profiler.cpuTime  = Now() - profiler.cpuStart;
+}
+
+// Records the frame that just ended, once GpuTimer has its wall time
+static void RecordFrame(double wallTime)
+{
+    if(!profiler.frames || profiler.count >= profiler.frames)
+        return;
+
+    if(profiler.seen++ < profiler.warmup)
+        return;
+
+    profiler.wallTimes[profiler.count] = wallTime;
+    profiler.cpuTimes [profiler.count] = profiler.cpuTime;
+    ++profiler.count;
+}
+
+bool ProfilerFinished(double totalTime)
+{
+    if(!profiler.frames)
+        return totalTime >= (float)KILL_APP_PERIOD;
+
+    if(profiler.count < profiler.frames)
+        return false;
+
+    printf("[Frame Benchmark] [%s] [%d frames] [%d warmup]\n", profiler.title ? profiler.title : "", profiler.frames, profiler.warmup);
+    PrintFrameTimes("Wall", profiler.wallTimes, profiler.count);
+    PrintFrameTimes("CPU" , profiler.cpuTimes , profiler.count);
+
+    free(profiler.wallTimes);
+    free(profiler.cpuTimes);
+    profiler.wallTimes = NULL;
+    profiler.cpuTimes  = NULL;
+    profiler.frames    = 0;
+
+    return true;
+}
+
 void GpuViewer()
 {
 #ifdef INFO_DISPLAY
@@ -36,11 +165,6 @@ void GpuViewer()
 
 double GpuTimer(const char *title)
 {
-#ifdef WIN32
-    SYSTEMTIME tim;
-#else
-    struct timeval tim;
-#endif
     static double t0                = 0.0;
     static double totalTimeFPS      = 0.0;
     static int    frames            = 0;
@@ -51,28 +175,20 @@ double GpuTimer(const char *title)
 
     char  str[256];
 
+    profiler.title     = title;
+
+    // Get time; the first call only starts the first frame
+    t1                 = Now();
     if(t0 == 0.0) {
-#ifdef WIN32
-        GetLocalTime(&tim);
-        t0 = tim.wSecond + (tim.wMilliseconds / 1000.0);
-#else
-        gettimeofday(&tim, NULL);
-        t0 = tim.tv_sec + (tim.tv_usec / 1000000.0);
-#endif
+        t0 = t1;
+        return 0.0;
     }
-
-    // Get time
-#ifdef WIN32
-    GetLocalTime(&tim);
-    t1 = tim.wSecond + (tim.wMilliseconds / 1000.0);
-#else
-    gettimeofday(&tim, NULL);
-    t1                 = tim.tv_sec + (tim.tv_usec / 1000000.0);
-#endif
     timePerFrame       = t1 - t0;
     totalTimeFPS      += timePerFrame;
     t0                 = t1;
 
+    RecordFrame(timePerFrame);
+
     // Count fps (ms)
     ++frames;
     totalTimePerFrame += timePerFrame*1000;
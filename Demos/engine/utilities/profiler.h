@@ -24,4 +24,16 @@
 double GpuTimer(const char *title);
 void GpuViewer(void);
 
+// Frame benchmark mode, '--frames N [--warmup M]' on the command line of a demo:
+// the wall time of the next N frames after the first M is recorded by GpuTimer,
+// their CPU time between CpuTimerStart and CpuTimerStop, and the p50/p95/p99/max
+// of both are printed once the N frames are done.
+void ProfilerInit(int argc, char **argv);
+void CpuTimerStart(void);
+void CpuTimerStop(void);
+// true once the benchmark frames are done, or else after KILL_APP_PERIOD seconds
+bool ProfilerFinished(double totalTime);
+// Monotonic time in seconds, for the demos that time parts of a frame on their own
+double ProfilerNow(void);
+
 #endif // __PROFILER_H_
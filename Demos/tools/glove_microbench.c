@@ -0,0 +1,639 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ * Micro-benchmarks of the hot paths of GLOVE, rendering to a pbuffer so that
+ * no window system is needed. Each case times a fixed number of GL calls,
+ * finishing the work it queued, and the results are printed as JSON so that
+ * they can be compared release over release.
+ */
+
+// clock_gettime and getopt are POSIX, beyond the C99 the demos are built with
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <ctype.h>
+
+#include <EGL/egl.h>
+#include <GLES2/gl2.h>
+
+#define MAX_RESULTS         64
+#define TEXTURE_SIZE        512
+
+typedef struct {
+    char    name[64];
+    double  value;
+    char    unit[16];
+    long    iterations;
+    double  seconds;
+} result_t;
+
+static result_t    results[MAX_RESULTS];
+static int         result_count = 0;
+
+static EGLDisplay  display = EGL_NO_DISPLAY;
+static EGLSurface  surface = EGL_NO_SURFACE;
+static EGLContext  context = EGL_NO_CONTEXT;
+
+static int         width   = 256;
+static int         height  = 256;
+static long        scale   = 1;
+static char       *filter  = NULL;
+static char       *out_file = NULL;
+
+static GLuint      programs[2];
+static GLuint      vbo;
+static GLint       color_locations[2];
+static GLint       matrix_locations[2];
+
+static const GLfloat identity[] = {
+    1.0f, 0.0f, 0.0f, 0.0f,
+    0.0f, 1.0f, 0.0f, 0.0f,
+    0.0f, 0.0f, 1.0f, 0.0f,
+    0.0f, 0.0f, 0.0f, 1.0f
+};
+
+static const GLfloat triangle[] = {
+    -0.5f, -0.5f,
+     0.5f, -0.5f,
+     0.0f,  0.5f
+};
+
+static const char *vs_source =
+    "attribute vec2 a_position;\n"
+    "uniform mat4 u_matrix;\n"
+    "void main() {\n"
+    "    gl_Position = u_matrix * vec4(a_position, 0.0, 1.0);\n"
+    "}\n";
+
+static const char *fs_sources[2] = {
+    "precision mediump float;\n"
+    "uniform vec4 u_color;\n"
+    "void main() {\n"
+    "    gl_FragColor = u_color;\n"
+    "}\n",
+    "precision mediump float;\n"
+    "uniform vec4 u_color;\n"
+    "void main() {\n"
+    "    gl_FragColor = u_color.bgra;\n"
+    "}\n"
+};
+
+static double
+Now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static bool
+Selected(const char *name)
+{
+    return !filter || strstr(name, filter);
+}
+
+static void
+AddResult(const char *name, double value, const char *unit, long iterations, double seconds)
+{
+    if(result_count >= MAX_RESULTS) {
+        return;
+    }
+
+    result_t *result = &results[result_count++];
+    snprintf(result->name, sizeof(result->name), "%s", name);
+    snprintf(result->unit, sizeof(result->unit), "%s", unit);
+    result->value      = value;
+    result->iterations = iterations;
+    result->seconds    = seconds;
+}
+
+static void
+PrintUsage(void)
+{
+    printf("Correct Usage: ./glove_microbench [-w <width>] [-h <height>] [-s <scale>] [-f <case_filter>] [-o <output_file>]\n");
+    printf("\n");
+    printf("The iterations of every case are multiplied by '<scale>', and only the cases whose name\n");
+    printf("contains '<case_filter>' are run. The results are written as JSON to '<output_file>', or stdout.\n");
+}
+
+static bool
+ReadArguments(int argc, char *argv[])
+{
+    signed char c;
+
+    while ((c = getopt(argc, argv, "w:h:s:f:o:")) != -1) {
+        switch (c) {
+        case 'w':
+            width = atoi(optarg);
+            break;
+        case 'h':
+            height = atoi(optarg);
+            break;
+        case 's':
+            scale = atol(optarg);
+            break;
+        case 'f':
+            filter = optarg;
+            break;
+        case 'o':
+            out_file = optarg;
+            break;
+        case '?':
+            if (optopt == 'w' || optopt == 'h' || optopt == 's' || optopt == 'f' || optopt == 'o')
+                printf ("Option -%c requires an argument.\n", optopt);
+            else if (isprint (optopt))
+                printf ("Unknown option `-%c'.\n", optopt);
+            else
+                printf ("Unknown option character `\\x%x'.\n", optopt);
+            PrintUsage();
+
+            return false;
+        default:
+            abort ();
+        }
+    }
+
+    if(width <= 0 || height <= 0 || scale <= 0) {
+        PrintUsage();
+        return false;
+    }
+
+    return true;
+}
+
+static bool
+InitEGL(void)
+{
+    static const EGLint config_attribs[] = {
+        EGL_SURFACE_TYPE,    EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+        EGL_RED_SIZE,        8,
+        EGL_GREEN_SIZE,      8,
+        EGL_BLUE_SIZE,       8,
+        EGL_ALPHA_SIZE,      8,
+        EGL_NONE
+    };
+    static const EGLint context_attribs[] = {
+        EGL_CONTEXT_CLIENT_VERSION, 2,
+        EGL_NONE
+    };
+    const EGLint surface_attribs[] = {
+        EGL_WIDTH,  width,
+        EGL_HEIGHT, height,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint    configs = 0;
+
+    display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if(display == EGL_NO_DISPLAY || !eglInitialize(display, NULL, NULL)) {
+        fprintf(stderr, "Cannot initialize the EGL display\n");
+        return false;
+    }
+
+    if(!eglChooseConfig(display, config_attribs, &config, 1, &configs) || !configs) {
+        fprintf(stderr, "No EGL config renders to a pbuffer\n");
+        return false;
+    }
+
+    surface = eglCreatePbufferSurface(display, config, surface_attribs);
+    context = eglCreateContext(display, config, EGL_NO_CONTEXT, context_attribs);
+    if(surface == EGL_NO_SURFACE || context == EGL_NO_CONTEXT ||
+       !eglMakeCurrent(display, surface, surface, context)) {
+        fprintf(stderr, "Cannot create a %dx%d pbuffer context\n", width, height);
+        return false;
+    }
+
+    return true;
+}
+
+static void
+TerminateEGL(void)
+{
+    if(display == EGL_NO_DISPLAY) {
+        return;
+    }
+
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if(context != EGL_NO_CONTEXT) {
+        eglDestroyContext(display, context);
+    }
+    if(surface != EGL_NO_SURFACE) {
+        eglDestroySurface(display, surface);
+    }
+    eglTerminate(display);
+}
+
+static GLuint
+CompileShader(GLenum type, const char *source)
+{
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, NULL);
+    glCompileShader(shader);
+
+    return shader;
+}
+
+static GLuint
+LinkProgram(const char *vs, const char *fs)
+{
+    GLuint program = glCreateProgram();
+    GLuint shaders[2] = { CompileShader(GL_VERTEX_SHADER, vs), CompileShader(GL_FRAGMENT_SHADER, fs) };
+    GLint  status = GL_FALSE;
+
+    glAttachShader(program, shaders[0]);
+    glAttachShader(program, shaders[1]);
+    glBindAttribLocation(program, 0, "a_position");
+    glLinkProgram(program);
+    glDeleteShader(shaders[0]);
+    glDeleteShader(shaders[1]);
+
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    if(status == GL_FALSE) {
+        fprintf(stderr, "Linking a benchmark program failed\n");
+        glDeleteProgram(program);
+        return 0;
+    }
+
+    return program;
+}
+
+static bool
+InitGL(void)
+{
+    programs[0] = LinkProgram(vs_source, fs_sources[0]);
+    programs[1] = LinkProgram(vs_source, fs_sources[1]);
+    if(!programs[0] || !programs[1]) {
+        return false;
+    }
+    for(int i = 0; i < 2; ++i) {
+        color_locations[i]  = glGetUniformLocation(programs[i], "u_color");
+        matrix_locations[i] = glGetUniformLocation(programs[i], "u_matrix");
+        glUseProgram(programs[i]);
+        glUniform4f(color_locations[i], 1.0f, 0.5f, 0.25f, 0.5f);
+        glUniformMatrix4fv(matrix_locations[i], 1, GL_FALSE, identity);
+    }
+
+    glGenBuffers(1, &vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(triangle), triangle, GL_STATIC_DRAW);
+
+    glViewport(0, 0, width, height);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    return glGetError() == GL_NO_ERROR;
+}
+
+static void
+DestroyGL(void)
+{
+    glDeleteBuffers(1, &vbo);
+    glDeleteProgram(programs[0]);
+    glDeleteProgram(programs[1]);
+}
+
+/// binds the triangle from the VBO, or from client memory
+static void
+BindTriangle(bool client)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, client ? 0 : vbo);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, client ? (const void *)triangle : NULL);
+    glEnableVertexAttribArray(0);
+}
+
+typedef enum {
+    DRAW_NO_STATE_CHANGE,
+    DRAW_BLEND_TOGGLE,
+    DRAW_PROGRAM_SWITCH,
+    DRAW_CLIENT_ARRAY,
+    DRAW_VBO
+} draw_case_e;
+
+static void
+RunDraws(const char *name, draw_case_e draw_case)
+{
+    if(!Selected(name)) {
+        return;
+    }
+
+    const long draws = 20000 * scale;
+
+    glUseProgram(programs[0]);
+    BindTriangle(draw_case == DRAW_CLIENT_ARRAY);
+    glDisable(GL_BLEND);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glFinish();
+
+    double start = Now();
+    for(long i = 0; i < draws; ++i) {
+        switch(draw_case) {
+        case DRAW_BLEND_TOGGLE:
+            if(i & 1) {
+                glEnable(GL_BLEND);
+            } else {
+                glDisable(GL_BLEND);
+            }
+            break;
+        case DRAW_PROGRAM_SWITCH:
+            glUseProgram(programs[i & 1]);
+            break;
+        case DRAW_CLIENT_ARRAY:
+        case DRAW_VBO:
+            // the attribute is respecified for every draw, as applications streaming their geometry do
+            BindTriangle(draw_case == DRAW_CLIENT_ARRAY);
+            break;
+        default:
+            break;
+        }
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+    }
+    glFinish();
+    double seconds = Now() - start;
+
+    AddResult(name, draws / seconds, "draws/s", draws, seconds);
+}
+
+static void
+RunUniforms(const char *name, bool matrix)
+{
+    if(!Selected(name)) {
+        return;
+    }
+
+    const long calls = 200000 * scale;
+    GLfloat    values[16];
+
+    memcpy(values, identity, sizeof(values));
+
+    glUseProgram(programs[0]);
+    BindTriangle(false);
+    glDisable(GL_BLEND);
+    glFinish();
+
+    // the uniforms are sent to the GPU with the draws, one per 64 updates
+    double start = Now();
+    for(long i = 0; i < calls; ++i) {
+        values[0] = (GLfloat)(i & 0xFF) / 255.0f;
+        if(matrix) {
+            glUniformMatrix4fv(matrix_locations[0], 1, GL_FALSE, values);
+        } else {
+            glUniform4fv(color_locations[0], 1, values);
+        }
+        if((i & 63) == 63) {
+            glDrawArrays(GL_TRIANGLES, 0, 3);
+        }
+    }
+    glFinish();
+    double seconds = Now() - start;
+
+    glUniformMatrix4fv(matrix_locations[0], 1, GL_FALSE, identity);
+    glUniform4f(color_locations[0], 1.0f, 0.5f, 0.25f, 0.5f);
+
+    AddResult(name, calls / seconds, "calls/s", calls, seconds);
+}
+
+typedef struct {
+    const char *name;
+    GLenum      format;
+    GLenum      type;
+    int         bytes;
+} upload_format_t;
+
+static void
+RunTexSubImage(void)
+{
+    static const upload_format_t formats[] = {
+        { "tex_sub_image_rgba8",      GL_RGBA,      GL_UNSIGNED_BYTE,          4 },
+        { "tex_sub_image_rgb8",       GL_RGB,       GL_UNSIGNED_BYTE,          3 },
+        { "tex_sub_image_rgb565",     GL_RGB,       GL_UNSIGNED_SHORT_5_6_5,   2 },
+        { "tex_sub_image_rgba4444",   GL_RGBA,      GL_UNSIGNED_SHORT_4_4_4_4, 2 },
+        { "tex_sub_image_luminance8", GL_LUMINANCE, GL_UNSIGNED_BYTE,          1 }
+    };
+    const long uploads = 50 * scale;
+
+    unsigned char *pixels = (unsigned char *)malloc(TEXTURE_SIZE * TEXTURE_SIZE * 4);
+    for(int i = 0; i < TEXTURE_SIZE * TEXTURE_SIZE * 4; ++i) {
+        pixels[i] = (unsigned char)i;
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    for(size_t f = 0; f < sizeof(formats) / sizeof(formats[0]); ++f) {
+        const upload_format_t *format = &formats[f];
+        if(!Selected(format->name)) {
+            continue;
+        }
+
+        GLuint texture;
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, format->format, TEXTURE_SIZE, TEXTURE_SIZE, 0, format->format, format->type, NULL);
+        glFinish();
+
+        double start = Now();
+        for(long i = 0; i < uploads; ++i) {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, TEXTURE_SIZE, TEXTURE_SIZE, format->format, format->type, pixels);
+        }
+        glFinish();
+        double seconds = Now() - start;
+
+        double megabytes = (double)uploads * TEXTURE_SIZE * TEXTURE_SIZE * format->bytes / (1024.0 * 1024.0);
+        AddResult(format->name, megabytes / seconds, "MB/s", uploads, seconds);
+
+        glDeleteTextures(1, &texture);
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    free(pixels);
+}
+
+static void
+RunReadPixels(const char *name)
+{
+    if(!Selected(name)) {
+        return;
+    }
+
+    const long reads = 50 * scale;
+    unsigned char *pixels = (unsigned char *)malloc((size_t)width * height * 4);
+
+    glFinish();
+
+    // each read waits for the clear before it, as an application reading its frames back does
+    double start = Now();
+    for(long i = 0; i < reads; ++i) {
+        glClearColor((GLfloat)(i & 1), 0.0f, 0.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    }
+    double seconds = Now() - start;
+
+    double megabytes = (double)reads * width * height * 4 / (1024.0 * 1024.0);
+    AddResult(name, megabytes / seconds, "MB/s", reads, seconds);
+
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    free(pixels);
+}
+
+/// a fragment shader of 'statements' dependent statements, made unique by 'seed' so that no program cache hits
+static char *
+GenerateShader(int statements, long seed)
+{
+    size_t length = 256 + (size_t)statements * 64;
+    char  *source = (char *)malloc(length);
+    size_t offset = 0;
+
+    offset += snprintf(source + offset, length - offset,
+                       "precision mediump float;\n"
+                       "uniform vec4 u_color;\n"
+                       "void main() {\n"
+                       "    vec4 c = u_color * %ld.0;\n", seed);
+    for(int i = 0; i < statements; ++i) {
+        offset += snprintf(source + offset, length - offset,
+                           "    c = c * 0.5 + vec4(%d.0) * c.yzwx;\n", i + 1);
+    }
+    snprintf(source + offset, length - offset,
+             "    gl_FragColor = c;\n"
+             "}\n");
+
+    return source;
+}
+
+static void
+RunLinkTime(void)
+{
+    static const int sizes[] = { 16, 128, 512 };
+    const long links = 10 * scale;
+    static long seed = 0;
+
+    for(size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+        char name[64];
+        snprintf(name, sizeof(name), "link_time_%d_statements", sizes[s]);
+        if(!Selected(name)) {
+            continue;
+        }
+
+        double seconds = 0.0;
+        for(long i = 0; i < links; ++i) {
+            char *fs = GenerateShader(sizes[s], ++seed);
+
+            // the time until the link status is known, since GLOVE may link on its compiler threads
+            double start = Now();
+            GLuint program = LinkProgram(vs_source, fs);
+            seconds += Now() - start;
+
+            glDeleteProgram(program);
+            free(fs);
+        }
+
+        AddResult(name, seconds * 1000.0 / links, "ms/link", links, seconds);
+    }
+}
+
+static void
+RunSwap(const char *name)
+{
+    if(!Selected(name)) {
+        return;
+    }
+
+    const long swaps = 1000 * scale;
+
+    glFinish();
+
+    // a pbuffer has no presentation, so this is the cost of ending a frame in EGL and GLOVE
+    double start = Now();
+    for(long i = 0; i < swaps; ++i) {
+        glClear(GL_COLOR_BUFFER_BIT);
+        eglSwapBuffers(display, surface);
+    }
+    glFinish();
+    double seconds = Now() - start;
+
+    AddResult(name, seconds * 1000000.0 / swaps, "us/swap", swaps, seconds);
+}
+
+static void
+WriteResults(FILE *file)
+{
+    fprintf(file, "{\n");
+    fprintf(file, "  \"vendor\": \"%s\",\n",   (const char *)glGetString(GL_VENDOR));
+    fprintf(file, "  \"renderer\": \"%s\",\n", (const char *)glGetString(GL_RENDERER));
+    fprintf(file, "  \"version\": \"%s\",\n",  (const char *)glGetString(GL_VERSION));
+    fprintf(file, "  \"width\": %d,\n",  width);
+    fprintf(file, "  \"height\": %d,\n", height);
+    fprintf(file, "  \"scale\": %ld,\n", scale);
+    fprintf(file, "  \"results\": [\n");
+    for(int i = 0; i < result_count; ++i) {
+        const result_t *result = &results[i];
+        fprintf(file, "    { \"name\": \"%s\", \"value\": %.3f, \"unit\": \"%s\", \"iterations\": %ld, \"seconds\": %.6f }%s\n",
+                result->name, result->value, result->unit, result->iterations, result->seconds,
+                i + 1 < result_count ? "," : "");
+    }
+    fprintf(file, "  ]\n");
+    fprintf(file, "}\n");
+}
+
+int
+main(int argc, char **argv)
+{
+    int status = EXIT_FAILURE;
+
+    if(!ReadArguments(argc, argv)) {
+        return EXIT_FAILURE;
+    }
+
+    if(!InitEGL() || !InitGL()) {
+        TerminateEGL();
+        return EXIT_FAILURE;
+    }
+
+    RunDraws   ("draw_no_state_change", DRAW_NO_STATE_CHANGE);
+    RunDraws   ("draw_blend_toggle",    DRAW_BLEND_TOGGLE);
+    RunDraws   ("draw_program_switch",  DRAW_PROGRAM_SWITCH);
+    RunDraws   ("draw_client_array",    DRAW_CLIENT_ARRAY);
+    RunDraws   ("draw_vbo",             DRAW_VBO);
+    RunUniforms("uniform_4fv",          false);
+    RunUniforms("uniform_matrix4fv",    true);
+    RunTexSubImage();
+    RunReadPixels("read_pixels_rgba8");
+    RunLinkTime();
+    RunSwap    ("swap_overhead");
+
+    if(glGetError() != GL_NO_ERROR) {
+        fprintf(stderr, "A benchmark case raised a GL error\n");
+    }
+
+    FILE *file = out_file ? fopen(out_file, "w") : stdout;
+    if(file) {
+        WriteResults(file);
+        if(file != stdout) {
+            fclose(file);
+        }
+        status = EXIT_SUCCESS;
+    } else {
+        fprintf(stderr, "Cannot open output file '%s'\n", out_file);
+    }
+
+    DestroyGL();
+    TerminateEGL();
+
+    return status;
+}
@@ -0,0 +1,554 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ * Replays a GL command stream recorded by a CAPTURE_BUILD of GLOVE as fast as
+ * possible, rendering to a pbuffer so that no window system is needed. The
+ * capture is loaded into memory before the replay starts, so that the client
+ * memory of the calls is read in place, and the frame times are printed as
+ * JSON so that captures can be compared release over release.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <ctype.h>
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <EGL/egl.h>
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+#include <GLES2/gl2ext_glove.h>
+
+#include "../../GLES/source/api/glCaptureFormat.h"
+
+static EGLDisplay  display = EGL_NO_DISPLAY;
+static EGLSurface  surface = EGL_NO_SURFACE;
+static EGLContext  context = EGL_NO_CONTEXT;
+
+static int         width     = 0;
+static int         height    = 0;
+static int         warmup    = 0;
+static char       *out_file  = NULL;
+static char       *in_file   = NULL;
+
+static double
+Now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/// decodes the payload of a record into the arguments of its call, see glCaptureFormat.h
+class Decoder {
+public:
+    Decoder(const uint8_t *payload, uint32_t size)
+    : mCur(payload), mEnd(payload + size), mFailed(false), mHasFirst(false), mFirst(0), mString(NULL) { }
+
+    bool                Failed(void) const { return mFailed; }
+    /// replaces the first scalar of the payload, the uniform locations are remapped so
+    void                OverrideFirst(int64_t value) { mHasFirst = true; mFirst = value; }
+
+    uint64_t Raw(void)
+    {
+        if(mEnd - mCur < 8) {
+            mFailed = true;
+            return 0;
+        }
+
+        uint64_t value;
+        memcpy(&value, mCur, sizeof(value));
+        mCur += sizeof(value);
+
+        if(mHasFirst) {
+            mHasFirst = false;
+            value     = static_cast<uint64_t>(mFirst);
+        }
+        return value;
+    }
+
+    const void *Pointer(void)
+    {
+        switch(Raw()) {
+        case GLOVE_CAPTURE_POINTER_NULL:
+            return NULL;
+        case GLOVE_CAPTURE_POINTER_DATA: {
+            uint64_t size   = Raw();
+            uint64_t padded = (size + 7) & ~static_cast<uint64_t>(7);
+            if(static_cast<uint64_t>(mEnd - mCur) < padded) {
+                mFailed = true;
+                return NULL;
+            }
+            const uint8_t *data = mCur;
+            mCur += padded;
+            return data;
+        }
+        case GLOVE_CAPTURE_POINTER_OFFSET:
+            return reinterpret_cast<const void *>(static_cast<uintptr_t>(Raw()));
+        case GLOVE_CAPTURE_POINTER_OUTPUT: {
+            static std::vector<uint8_t> output;
+            output.resize(std::max<uint64_t>(Raw(), 64));
+            return output.data();
+        }
+        default:
+            mFailed = true;
+            return NULL;
+        }
+    }
+
+    /// the string array of glShaderSource is recorded as its single joined string
+    const GLchar *const *Strings(void)
+    {
+        mString = static_cast<const GLchar *>(Pointer());
+        return &mString;
+    }
+
+private:
+    const uint8_t      *mCur;
+    const uint8_t      *mEnd;
+    bool                mFailed;
+    bool                mHasFirst;
+    int64_t             mFirst;
+    const GLchar       *mString;
+};
+
+template<typename T, typename Enable = void>
+struct Argument {
+    static T Get(Decoder &decoder) { return static_cast<T>(static_cast<int64_t>(decoder.Raw())); }
+};
+
+template<typename T>
+struct Argument<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+    static T Get(Decoder &decoder)
+    {
+        uint32_t bits = static_cast<uint32_t>(decoder.Raw());
+        GLfloat value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+};
+
+template<typename T>
+struct Argument<T *> {
+    static T *Get(Decoder &decoder) { return (T *)decoder.Pointer(); }
+};
+
+template<>
+struct Argument<const GLchar *const *> {
+    static const GLchar *const *Get(Decoder &decoder) { return decoder.Strings(); }
+};
+
+template<size_t... I> struct Indices { };
+template<size_t N, size_t... I> struct MakeIndices : MakeIndices<N - 1, N - 1, I...> { };
+template<size_t... I> struct MakeIndices<0, I...> { typedef Indices<I...> type; };
+
+template<typename R, typename... A, size_t... I>
+static R
+Apply(R (GL_APIENTRY *function)(A...), std::tuple<A...> &args, Indices<I...>)
+{
+    return function(std::get<I>(args)...);
+}
+
+/// calls a GL function with the arguments decoded for its parameter types
+template<typename R, typename... A>
+static R
+Invoke(R (GL_APIENTRY *function)(A...), Decoder &decoder)
+{
+    // the braced initializer decodes the arguments in order
+    std::tuple<A...> args { Argument<A>::Get(decoder)... };
+    if(decoder.Failed()) {
+        return R();
+    }
+    return Apply(function, args, typename MakeIndices<sizeof...(A)>::type());
+}
+
+typedef struct {
+    uint64_t             records;
+    uint64_t             skipped;
+    std::vector<double>  frame_times;
+    double               seconds;
+} replay_t;
+
+static replay_t replay;
+
+/// the uniform locations of the capture, per program, mapped to the ones of the replay
+static std::map<std::pair<GLuint, GLint>, GLint> locations;
+static GLuint current_program = 0;
+
+static bool
+IsUniformCall(uint32_t id)
+{
+    return (id >= GLOVE_CAPTURE_glUniform1f && id <= GLOVE_CAPTURE_glUniformMatrix4fv);
+}
+
+static void
+Execute(uint32_t id, const uint8_t *payload, uint32_t size)
+{
+    Decoder decoder(payload, size);
+
+    if(IsUniformCall(id) && size >= 8) {
+        int64_t location;
+        memcpy(&location, payload, sizeof(location));
+        auto it = locations.find(std::make_pair(current_program, static_cast<GLint>(location)));
+        if(it != locations.end()) {
+            decoder.OverrideFirst(it->second);
+        }
+    }
+
+    if(id == GLOVE_CAPTURE_glGetUniformLocation) {
+        GLuint        program  = Argument<GLuint>::Get(decoder);
+        const GLchar *name     = Argument<const GLchar *>::Get(decoder);
+        GLint         captured = Argument<GLint>::Get(decoder);
+        if(decoder.Failed()) {
+            ++replay.skipped;
+        } else {
+            locations[std::make_pair(program, captured)] = glGetUniformLocation(program, name);
+        }
+        return;
+    }
+
+    if(id == GLOVE_CAPTURE_glUseProgram) {
+        Decoder peek(decoder);
+        current_program = Argument<GLuint>::Get(peek);
+    }
+
+    switch(id) {
+#define GLOVE_REPLAY_CASE(__call__)                                                                         \
+    case GLOVE_CAPTURE_##__call__:                                                                          \
+        Invoke(&__call__, decoder);                                                                         \
+        break;
+    GLOVE_CAPTURE_CALLS(GLOVE_REPLAY_CASE)
+#undef GLOVE_REPLAY_CASE
+    default:
+        ++replay.skipped;
+        return;
+    }
+
+    if(decoder.Failed()) {
+        ++replay.skipped;
+    }
+}
+
+static void
+PrintUsage(void)
+{
+    printf("Correct Usage: ./glove_replay [-w <width>] [-h <height>] [-s <warmup_frames>] [-o <output_file>] <capture_file>\n");
+    printf("\n");
+    printf("The pbuffer takes the size of the surface of the capture, or '<width>'x'<height>' when given.\n");
+    printf("The first '<warmup_frames>' frames are left out of the frame times, which are written as\n");
+    printf("JSON to '<output_file>', or stdout.\n");
+}
+
+static bool
+ReadArguments(int argc, char *argv[])
+{
+    signed char c;
+
+    while ((c = getopt(argc, argv, "w:h:s:o:")) != -1) {
+        switch (c) {
+        case 'w':
+            width = atoi(optarg);
+            break;
+        case 'h':
+            height = atoi(optarg);
+            break;
+        case 's':
+            warmup = atoi(optarg);
+            break;
+        case 'o':
+            out_file = optarg;
+            break;
+        case '?':
+            if (optopt == 'w' || optopt == 'h' || optopt == 's' || optopt == 'o')
+                printf ("Option -%c requires an argument.\n", optopt);
+            else if (isprint (optopt))
+                printf ("Unknown option `-%c'.\n", optopt);
+            else
+                printf ("Unknown option character `\\x%x'.\n", optopt);
+            PrintUsage();
+
+            return false;
+        default:
+            abort ();
+        }
+    }
+
+    if(optind != argc - 1 || width < 0 || height < 0 || warmup < 0) {
+        PrintUsage();
+        return false;
+    }
+
+    in_file = argv[optind];
+    return true;
+}
+
+static bool
+LoadCapture(std::vector<uint8_t> &capture)
+{
+    FILE *file = fopen(in_file, "rb");
+    if(!file) {
+        fprintf(stderr, "Cannot open capture file '%s'\n", in_file);
+        return false;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    capture.resize(size > 0 ? size : 0);
+    bool read = size > 0 && fread(capture.data(), 1, capture.size(), file) == capture.size();
+    fclose(file);
+
+    gloveCaptureHeader_t header;
+    if(!read || capture.size() < sizeof(header)) {
+        fprintf(stderr, "Cannot read capture file '%s'\n", in_file);
+        return false;
+    }
+
+    memcpy(&header, capture.data(), sizeof(header));
+    if(header.magic != GLOVE_CAPTURE_MAGIC || header.version != GLOVE_CAPTURE_VERSION) {
+        fprintf(stderr, "'%s' is not a capture of version %d\n", in_file, GLOVE_CAPTURE_VERSION);
+        return false;
+    }
+
+    return true;
+}
+
+static void
+CaptureSize(const std::vector<uint8_t> &capture)
+{
+    const uint8_t *cur = capture.data() + sizeof(gloveCaptureHeader_t);
+    const uint8_t *end = capture.data() + capture.size();
+
+    // the surface is made current before the first call, so it leads the capture
+    gloveCaptureRecord_t record;
+    if(end - cur >= static_cast<ptrdiff_t>(sizeof(record) + 16)) {
+        memcpy(&record, cur, sizeof(record));
+        if(record.id == GLOVE_CAPTURE_SURFACE) {
+            uint64_t size[2];
+            memcpy(size, cur + sizeof(record), sizeof(size));
+            width  = width  ? width  : static_cast<int>(size[0]);
+            height = height ? height : static_cast<int>(size[1]);
+        }
+    }
+
+    width  = width  ? width  : 256;
+    height = height ? height : 256;
+}
+
+static bool
+InitEGL(void)
+{
+    static const EGLint config_attribs[] = {
+        EGL_SURFACE_TYPE,    EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+        EGL_RED_SIZE,        8,
+        EGL_GREEN_SIZE,      8,
+        EGL_BLUE_SIZE,       8,
+        EGL_ALPHA_SIZE,      8,
+        EGL_DEPTH_SIZE,      24,
+        EGL_STENCIL_SIZE,    8,
+        EGL_NONE
+    };
+    static const EGLint context_attribs[] = {
+        EGL_CONTEXT_CLIENT_VERSION, 2,
+        EGL_NONE
+    };
+    const EGLint surface_attribs[] = {
+        EGL_WIDTH,  width,
+        EGL_HEIGHT, height,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint    configs = 0;
+
+    display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if(display == EGL_NO_DISPLAY || !eglInitialize(display, NULL, NULL)) {
+        fprintf(stderr, "Cannot initialize the EGL display\n");
+        return false;
+    }
+
+    if(!eglChooseConfig(display, config_attribs, &config, 1, &configs) || !configs) {
+        fprintf(stderr, "No EGL config renders to a pbuffer\n");
+        return false;
+    }
+
+    surface = eglCreatePbufferSurface(display, config, surface_attribs);
+    context = eglCreateContext(display, config, EGL_NO_CONTEXT, context_attribs);
+    if(surface == EGL_NO_SURFACE || context == EGL_NO_CONTEXT ||
+       !eglMakeCurrent(display, surface, surface, context)) {
+        fprintf(stderr, "Cannot create a %dx%d pbuffer context\n", width, height);
+        return false;
+    }
+
+    eglSwapInterval(display, 0);
+
+    return true;
+}
+
+static void
+TerminateEGL(void)
+{
+    if(display == EGL_NO_DISPLAY) {
+        return;
+    }
+
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if(context != EGL_NO_CONTEXT) {
+        eglDestroyContext(display, context);
+    }
+    if(surface != EGL_NO_SURFACE) {
+        eglDestroySurface(display, surface);
+    }
+    eglTerminate(display);
+}
+
+static bool
+Replay(const std::vector<uint8_t> &capture)
+{
+    const uint8_t *cur = capture.data() + sizeof(gloveCaptureHeader_t);
+    const uint8_t *end = capture.data() + capture.size();
+
+    double start = Now();
+    double frame = start;
+    int    frames = 0;
+
+    while(end - cur >= static_cast<ptrdiff_t>(sizeof(gloveCaptureRecord_t))) {
+        gloveCaptureRecord_t record;
+        memcpy(&record, cur, sizeof(record));
+        cur += sizeof(record);
+
+        if(static_cast<uint64_t>(end - cur) < record.size) {
+            fprintf(stderr, "The capture is truncated after %lu records\n", (unsigned long)replay.records);
+            break;
+        }
+
+        if(record.id == GLOVE_CAPTURE_FRAME) {
+            eglSwapBuffers(display, surface);
+
+            double now = Now();
+            if(frames++ >= warmup) {
+                replay.frame_times.push_back((now - frame) * 1000.0);
+            } else {
+                start = now;
+            }
+            frame = now;
+        } else if(record.id != GLOVE_CAPTURE_SURFACE) {
+            Execute(record.id, cur, record.size);
+        }
+
+        cur += record.size;
+        ++replay.records;
+    }
+
+    // the calls after the last frame are still timed
+    glFinish();
+    replay.seconds = Now() - start;
+
+    return frames > 0 || replay.records > 0;
+}
+
+static double
+Percentile(const std::vector<double> &sorted, double percentile)
+{
+    if(sorted.empty()) {
+        return 0.0;
+    }
+
+    size_t index = static_cast<size_t>(percentile / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+static void
+WriteResults(FILE *file)
+{
+    std::vector<double> sorted(replay.frame_times);
+    std::sort(sorted.begin(), sorted.end());
+
+    double total = 0.0;
+    for(double time : sorted) {
+        total += time;
+    }
+    double mean = sorted.empty() ? 0.0 : total / sorted.size();
+
+    fprintf(file, "{\n");
+    fprintf(file, "  \"capture\": \"%s\",\n",  in_file);
+    fprintf(file, "  \"vendor\": \"%s\",\n",   (const char *)glGetString(GL_VENDOR));
+    fprintf(file, "  \"renderer\": \"%s\",\n", (const char *)glGetString(GL_RENDERER));
+    fprintf(file, "  \"version\": \"%s\",\n",  (const char *)glGetString(GL_VERSION));
+    fprintf(file, "  \"width\": %d,\n",  width);
+    fprintf(file, "  \"height\": %d,\n", height);
+    fprintf(file, "  \"records\": %lu,\n", (unsigned long)replay.records);
+    fprintf(file, "  \"skipped_records\": %lu,\n", (unsigned long)replay.skipped);
+    fprintf(file, "  \"warmup_frames\": %d,\n", warmup);
+    fprintf(file, "  \"frames\": %lu,\n", (unsigned long)sorted.size());
+    fprintf(file, "  \"seconds\": %.6f,\n", replay.seconds);
+    fprintf(file, "  \"fps\": %.3f,\n", replay.seconds > 0.0 ? sorted.size() / replay.seconds : 0.0);
+    fprintf(file, "  \"frame_time_ms\": { \"mean\": %.3f, \"p50\": %.3f, \"p95\": %.3f, \"p99\": %.3f, \"max\": %.3f }\n",
+            mean, Percentile(sorted, 50.0), Percentile(sorted, 95.0), Percentile(sorted, 99.0),
+            sorted.empty() ? 0.0 : sorted.back());
+    fprintf(file, "}\n");
+}
+
+int
+main(int argc, char **argv)
+{
+    int status = EXIT_FAILURE;
+    std::vector<uint8_t> capture;
+
+    if(!ReadArguments(argc, argv) || !LoadCapture(capture)) {
+        return EXIT_FAILURE;
+    }
+
+    CaptureSize(capture);
+
+    if(!InitEGL()) {
+        TerminateEGL();
+        return EXIT_FAILURE;
+    }
+
+    if(!Replay(capture)) {
+        fprintf(stderr, "The capture holds no records\n");
+        TerminateEGL();
+        return EXIT_FAILURE;
+    }
+
+    if(replay.skipped) {
+        fprintf(stderr, "%lu records could not be replayed\n", (unsigned long)replay.skipped);
+    }
+
+    FILE *file = out_file ? fopen(out_file, "w") : stdout;
+    if(file) {
+        WriteResults(file);
+        if(file != stdout) {
+            fclose(file);
+        }
+        status = EXIT_SUCCESS;
+    } else {
+        fprintf(stderr, "Cannot open output file '%s'\n", out_file);
+    }
+
+    TerminateEGL();
+
+    return status;
+}
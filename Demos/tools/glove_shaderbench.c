@@ -0,0 +1,357 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ * Compile and link time of a corpus of ESSL 100 programs, on a pbuffer so
+ * that no window system is needed. The programs are listed in a manifest,
+ * one per line as '<name> <vertex shader> <fragment shader>' with the paths
+ * relative to the manifest, and the wall time of compiling both shaders and
+ * of linking each program is printed as JSON. The time of each stage inside
+ * GLOVE is written on exit to the file named by GLOVE_SHADER_STATS, see
+ * Benchmarking/shaders/shader_bench.py, which runs this with an empty and
+ * with a filled program cache.
+ */
+
+// clock_gettime and getopt are POSIX, beyond the C99 the demos are built with
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <ctype.h>
+
+#include <EGL/egl.h>
+#include <GLES2/gl2.h>
+
+#define MAX_PROGRAMS        256
+#define MAX_PATH_LENGTH     1024
+
+typedef struct {
+    char    name[64];
+    char    paths[2][MAX_PATH_LENGTH];
+    double  compile_ms;
+    double  link_ms;
+    bool    linked;
+} program_t;
+
+static program_t   programs[MAX_PROGRAMS];
+static int         program_count = 0;
+
+static EGLDisplay  display = EGL_NO_DISPLAY;
+static EGLSurface  surface = EGL_NO_SURFACE;
+static EGLContext  context = EGL_NO_CONTEXT;
+
+static long        repeats  = 1;
+static char       *filter   = NULL;
+static char       *out_file = NULL;
+static char       *manifest = NULL;
+
+static double
+Now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void
+PrintUsage(void)
+{
+    printf("Correct Usage: ./glove_shaderbench [-r <repeats>] [-f <program_filter>] [-o <output_file>] <manifest>\n");
+    printf("\n");
+    printf("Every program of '<manifest>' whose name contains '<program_filter>' is compiled and linked\n");
+    printf("'<repeats>' times, the later times finding it in the program cache. The mean times are\n");
+    printf("written as JSON to '<output_file>', or stdout.\n");
+}
+
+static bool
+ReadArguments(int argc, char *argv[])
+{
+    signed char c;
+
+    while ((c = getopt(argc, argv, "r:f:o:")) != -1) {
+        switch (c) {
+        case 'r':
+            repeats = atol(optarg);
+            break;
+        case 'f':
+            filter = optarg;
+            break;
+        case 'o':
+            out_file = optarg;
+            break;
+        case '?':
+            if (optopt == 'r' || optopt == 'f' || optopt == 'o')
+                printf ("Option -%c requires an argument.\n", optopt);
+            else if (isprint (optopt))
+                printf ("Unknown option `-%c'.\n", optopt);
+            else
+                printf ("Unknown option character `\\x%x'.\n", optopt);
+            PrintUsage();
+
+            return false;
+        default:
+            abort ();
+        }
+    }
+
+    if(optind != argc - 1 || repeats <= 0) {
+        PrintUsage();
+        return false;
+    }
+    manifest = argv[optind];
+
+    return true;
+}
+
+static bool
+ReadManifest(void)
+{
+    FILE *file = fopen(manifest, "r");
+    if(!file) {
+        fprintf(stderr, "Cannot open manifest '%s'\n", manifest);
+        return false;
+    }
+
+    // the shader paths are relative to the directory of the manifest
+    char        directory[MAX_PATH_LENGTH];
+    const char *slash = strrchr(manifest, '/');
+    snprintf(directory, sizeof(directory), "%.*s", slash ? (int)(slash - manifest + 1) : 0, manifest);
+
+    char line[3 * MAX_PATH_LENGTH];
+    while(fgets(line, sizeof(line), file)) {
+        char name[64], vs[MAX_PATH_LENGTH], fs[MAX_PATH_LENGTH];
+        if(line[0] == '#' || sscanf(line, "%63s %1023s %1023s", name, vs, fs) != 3) {
+            continue;
+        }
+        if((filter && !strstr(name, filter)) || program_count >= MAX_PROGRAMS) {
+            continue;
+        }
+
+        program_t *program = &programs[program_count++];
+        memset(program, 0, sizeof(*program));
+        snprintf(program->name    , sizeof(program->name)    , "%s", name);
+        snprintf(program->paths[0], sizeof(program->paths[0]), "%s%s", vs[0] == '/' ? "" : directory, vs);
+        snprintf(program->paths[1], sizeof(program->paths[1]), "%s%s", fs[0] == '/' ? "" : directory, fs);
+    }
+
+    fclose(file);
+    return program_count > 0;
+}
+
+static char *
+ReadSource(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if(!file) {
+        fprintf(stderr, "Cannot open shader '%s'\n", path);
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char *source = size >= 0 ? malloc(size + 1) : NULL;
+    if(source) {
+        size_t read = fread(source, 1, size, file);
+        source[read] = '\0';
+    }
+
+    fclose(file);
+    return source;
+}
+
+static bool
+InitEGL(void)
+{
+    static const EGLint config_attribs[] = {
+        EGL_SURFACE_TYPE,    EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+        EGL_NONE
+    };
+    static const EGLint context_attribs[] = {
+        EGL_CONTEXT_CLIENT_VERSION, 2,
+        EGL_NONE
+    };
+    static const EGLint surface_attribs[] = {
+        EGL_WIDTH,  16,
+        EGL_HEIGHT, 16,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint    configs = 0;
+
+    display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if(display == EGL_NO_DISPLAY || !eglInitialize(display, NULL, NULL)) {
+        fprintf(stderr, "Cannot initialize the EGL display\n");
+        return false;
+    }
+
+    if(!eglChooseConfig(display, config_attribs, &config, 1, &configs) || !configs) {
+        fprintf(stderr, "No EGL config renders to a pbuffer\n");
+        return false;
+    }
+
+    surface = eglCreatePbufferSurface(display, config, surface_attribs);
+    context = eglCreateContext(display, config, EGL_NO_CONTEXT, context_attribs);
+    if(surface == EGL_NO_SURFACE || context == EGL_NO_CONTEXT ||
+       !eglMakeCurrent(display, surface, surface, context)) {
+        fprintf(stderr, "Cannot create a pbuffer context\n");
+        return false;
+    }
+
+    return true;
+}
+
+static void
+TerminateEGL(void)
+{
+    if(display == EGL_NO_DISPLAY) {
+        return;
+    }
+
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if(context != EGL_NO_CONTEXT) {
+        eglDestroyContext(display, context);
+    }
+    if(surface != EGL_NO_SURFACE) {
+        eglDestroySurface(display, surface);
+    }
+    // eglTerminate writes the program cache and the stage times
+    eglTerminate(display);
+}
+
+static void
+PrintLog(const char *name, GLuint object, bool program)
+{
+    char log[1024] = "";
+    if(program) {
+        glGetProgramInfoLog(object, sizeof(log), NULL, log);
+    } else {
+        glGetShaderInfoLog(object, sizeof(log), NULL, log);
+    }
+    fprintf(stderr, "%s: %s failed\n%s\n", name, program ? "link" : "compile", log);
+}
+
+static void
+RunProgram(program_t *program, char *sources[2])
+{
+    static const GLenum types[2] = { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER };
+    GLuint shaders[2];
+    GLint  status = GL_FALSE;
+
+    // the times until the compile and link status are known, since GLOVE may work on its compiler threads
+    double start = Now();
+    for(int i = 0; i < 2; ++i) {
+        shaders[i] = glCreateShader(types[i]);
+        glShaderSource(shaders[i], 1, (const GLchar * const *)&sources[i], NULL);
+        glCompileShader(shaders[i]);
+    }
+    for(int i = 0; i < 2; ++i) {
+        glGetShaderiv(shaders[i], GL_COMPILE_STATUS, &status);
+        if(status == GL_FALSE) {
+            PrintLog(program->name, shaders[i], false);
+        }
+    }
+    double compiled = Now();
+
+    GLuint object = glCreateProgram();
+    glAttachShader(object, shaders[0]);
+    glAttachShader(object, shaders[1]);
+    glLinkProgram(object);
+    glGetProgramiv(object, GL_LINK_STATUS, &status);
+    double linked = Now();
+
+    program->compile_ms += (compiled - start ) * 1000.0 / repeats;
+    program->link_ms    += (linked - compiled) * 1000.0 / repeats;
+    program->linked      = status == GL_TRUE;
+    if(!program->linked) {
+        PrintLog(program->name, object, true);
+    }
+
+    glDeleteShader(shaders[0]);
+    glDeleteShader(shaders[1]);
+    glDeleteProgram(object);
+}
+
+static void
+WriteResults(FILE *file)
+{
+    double compile_ms = 0.0;
+    double link_ms    = 0.0;
+
+    fprintf(file, "{\n");
+    fprintf(file, "  \"renderer\": \"%s\",\n", (const char *)glGetString(GL_RENDERER));
+    fprintf(file, "  \"repeats\": %ld,\n", repeats);
+    fprintf(file, "  \"programs\": [\n");
+    for(int i = 0; i < program_count; ++i) {
+        const program_t *program = &programs[i];
+        fprintf(file, "    { \"name\": \"%s\", \"linked\": %s, \"compile_ms\": %.3f, \"link_ms\": %.3f }%s\n",
+                program->name, program->linked ? "true" : "false", program->compile_ms, program->link_ms,
+                i + 1 < program_count ? "," : "");
+        compile_ms += program->compile_ms;
+        link_ms    += program->link_ms;
+    }
+    fprintf(file, "  ],\n");
+    fprintf(file, "  \"compile_ms\": %.3f,\n", compile_ms);
+    fprintf(file, "  \"link_ms\": %.3f\n", link_ms);
+    fprintf(file, "}\n");
+}
+
+int
+main(int argc, char **argv)
+{
+    int status = EXIT_FAILURE;
+
+    if(!ReadArguments(argc, argv) || !ReadManifest()) {
+        return EXIT_FAILURE;
+    }
+
+    if(!InitEGL()) {
+        TerminateEGL();
+        return EXIT_FAILURE;
+    }
+
+    bool linked = true;
+    for(int i = 0; i < program_count; ++i) {
+        char *sources[2] = { ReadSource(programs[i].paths[0]), ReadSource(programs[i].paths[1]) };
+        if(sources[0] && sources[1]) {
+            for(long r = 0; r < repeats; ++r) {
+                RunProgram(&programs[i], sources);
+            }
+        }
+        linked = linked && programs[i].linked;
+        free(sources[0]);
+        free(sources[1]);
+    }
+
+    FILE *file = out_file ? fopen(out_file, "w") : stdout;
+    if(file) {
+        WriteResults(file);
+        if(file != stdout) {
+            fclose(file);
+        }
+        status = linked ? EXIT_SUCCESS : EXIT_FAILURE;
+    } else {
+        fprintf(stderr, "Cannot open output file '%s'\n", out_file);
+    }
+
+    TerminateEGL();
+
+    return status;
+}
@@ -14,38 +14,149 @@
 #include <unistd.h>
 #include <getopt.h>
 #include <ctype.h>
+#include <dirent.h>
 
 #include "../engine/glcore/common.h"
 
-#define ARGS_NUM 7
+#define MAX_PATH_LENGTH 1024
 
-static openGL_program_t  program;
+typedef struct {
+    char    vs_source[MAX_PATH_LENGTH];
+    char    fs_source[MAX_PATH_LENGTH];
+    char    out_file [MAX_PATH_LENGTH];
+    GLuint  vs;
+    GLuint  fs;
+    GLuint  prog;
+} shader_pair_t;
 
-static char *vs_source = NULL;
-static char *fs_source = NULL;
-static char *out_file  = NULL;
+static shader_pair_t *pairs      = NULL;
+static int            pair_count = 0;
+
+static char *vs_source  = NULL;
+static char *fs_source  = NULL;
+static char *out_file   = NULL;
+static char *manifest   = NULL;
+static char *shader_dir = NULL;
+static char *cache_file = NULL;
 
 static void PrintUsage    ();
-static void CompileShaders();
+static bool AddPair       (const char *vs, const char *fs, const char *out);
+static bool ReadManifest  (const char *filename);
+static bool ReadDirectory (const char *dirname, const char *outdir);
+static bool SubmitShader  (const char *filename, GLuint *shader, GLenum shaderType);
+static void PrintProgramLog(const shader_pair_t *pair);
+static int  CompileShaders();
 static bool ReadArguments (int argc, char *argv[]);
 
 static void
 PrintUsage()
 {
     printf("Correct Usage: ./offline_shader_compiler -v <vertex_shader_source> -f <fragment_shader_source> -o <output_file>\n");
+    printf("               ./offline_shader_compiler -m <manifest> [-c <program_cache>]\n");
+    printf("               ./offline_shader_compiler -d <shader_directory> [-o <output_directory>] [-c <program_cache>]\n");
+    printf("\n");
+    printf("Each line of a manifest holds '<vertex_shader_source> <fragment_shader_source> [<output_file>]'.\n");
+    printf("A directory is searched for '<name>.vert' and '<name>.frag' pairs, written to '<output_directory>/<name>.bin'.\n");
+    printf("Every linked program is stored in the GLOVE program cache, '<program_cache>' when given,\n");
+    printf("which GLOVE loads at startup through the GLOVE_PROGRAM_CACHE_PATH environment variable.\n");
 }
 
 static bool
-ReadArguments(int argc, char *argv[])
+AddPair(const char *vs, const char *fs, const char *out)
 {
-    signed char c;
+    if(strlen(vs) >= MAX_PATH_LENGTH || strlen(fs) >= MAX_PATH_LENGTH || (out && strlen(out) >= MAX_PATH_LENGTH)) {
+        printf("Path too long: '%s'\n", strlen(vs) >= MAX_PATH_LENGTH ? vs : strlen(fs) >= MAX_PATH_LENGTH ? fs : out);
+        return false;
+    }
 
-    if(argc != ARGS_NUM) {
-        PrintUsage();
+    shader_pair_t *grown = (shader_pair_t *)realloc(pairs, (pair_count + 1) * sizeof(shader_pair_t));
+    if(!grown) {
+        return false;
+    }
+    pairs = grown;
+
+    shader_pair_t *pair = &pairs[pair_count++];
+    memset(pair, 0, sizeof(shader_pair_t));
+    strcpy(pair->vs_source, vs);
+    strcpy(pair->fs_source, fs);
+    if(out) {
+        strcpy(pair->out_file, out);
+    }
+
+    return true;
+}
+
+static bool
+ReadManifest(const char *filename)
+{
+    FILE *file = fopen(filename, "r");
+    if(!file) {
+        printf("Cannot open manifest '%s'\n", filename);
         return false;
     }
 
-    while ((c = getopt(argc, argv, "v:f:o:")) != -1) {
+    char line[3 * MAX_PATH_LENGTH];
+    char vs[MAX_PATH_LENGTH], fs[MAX_PATH_LENGTH], out[MAX_PATH_LENGTH];
+    bool result = true;
+    while(result && fgets(line, sizeof(line), file)) {
+        // empty lines and comments
+        int fields = sscanf(line, "%1023s %1023s %1023s", vs, fs, out);
+        if(fields <= 0 || vs[0] == '#') {
+            continue;
+        }
+        if(fields == 1) {
+            printf("Manifest line without a fragment shader: %s", line);
+            result = false;
+            break;
+        }
+        result = AddPair(vs, fs, fields == 3 ? out : NULL);
+    }
+    fclose(file);
+
+    return result;
+}
+
+static bool
+ReadDirectory(const char *dirname, const char *outdir)
+{
+    DIR *dir = opendir(dirname);
+    if(!dir) {
+        printf("Cannot open directory '%s'\n", dirname);
+        return false;
+    }
+
+    char vs[MAX_PATH_LENGTH], fs[MAX_PATH_LENGTH], out[MAX_PATH_LENGTH];
+    struct dirent *entry;
+    bool result = true;
+    while(result && (entry = readdir(dir)) != NULL) {
+        size_t length = strlen(entry->d_name);
+        if(length <= 5 || strcmp(entry->d_name + length - 5, ".vert")) {
+            continue;
+        }
+
+        // a vertex shader without a fragment shader of the same name is skipped
+        int name = (int)(length - 5);
+        snprintf(vs, sizeof(vs), "%s/%s", dirname, entry->d_name);
+        snprintf(fs, sizeof(fs), "%s/%.*s.frag", dirname, name, entry->d_name);
+        if(access(fs, R_OK)) {
+            continue;
+        }
+        if(outdir) {
+            snprintf(out, sizeof(out), "%s/%.*s.bin", outdir, name, entry->d_name);
+        }
+        result = AddPair(vs, fs, outdir ? out : NULL);
+    }
+    closedir(dir);
+
+    return result;
+}
+
+static bool
+ReadArguments(int argc, char *argv[])
+{
+    signed char c;
+
+    while ((c = getopt(argc, argv, "v:f:o:m:d:c:")) != -1) {
         switch (c) {
         case 'v':
             vs_source = optarg;
@@ -56,12 +167,17 @@ ReadArguments(int argc, char *argv[])
         case 'o':
             out_file = optarg;
             break;
+        case 'm':
+            manifest = optarg;
+            break;
+        case 'd':
+            shader_dir = optarg;
+            break;
+        case 'c':
+            cache_file = optarg;
+            break;
         case '?':
-            if (optopt == 'v')
-                printf ("Option -%c requires an argument.\n", optopt);
-            else if (optopt == 'f')
-                printf ("Option -%c requires an argument.\n", optopt);
-            else if (optopt == 'o')
+            if (optopt == 'v' || optopt == 'f' || optopt == 'o' || optopt == 'm' || optopt == 'd' || optopt == 'c')
                 printf ("Option -%c requires an argument.\n", optopt);
             else if (isprint (optopt))
                 printf ("Unknown option `-%c'.\n", optopt);
@@ -75,57 +191,152 @@ ReadArguments(int argc, char *argv[])
         }
     }
 
+    bool result = false;
+    if(manifest && !shader_dir && !vs_source && !fs_source && !out_file) {
+        result = ReadManifest(manifest);
+    } else if(shader_dir && !manifest && !vs_source && !fs_source) {
+        result = ReadDirectory(shader_dir, out_file);
+    } else if(vs_source && fs_source && out_file && !manifest && !shader_dir) {
+        result = AddPair(vs_source, fs_source, out_file);
+    } else {
+        PrintUsage();
+        return false;
+    }
+
+    if(result && !pair_count) {
+        printf("No shader pairs to compile\n");
+        result = false;
+    }
+
+    return result;
+}
+
+static bool
+SubmitShader(const char *filename, GLuint *shader, GLenum shaderType)
+{
+    int   length = 0;
+    char *source = NULL;
+
+    if(!LoadSource(filename, &source, &length)) {
+        printf("Cannot open shader source '%s'\n", filename);
+        return false;
+    }
+
+    *shader = glCreateShader(shaderType);
+    glShaderSource(*shader, 1, (const char **) &source, NULL);
+    glCompileShader(*shader);
+    free(source);
+
     return true;
 }
 
 static void
+PrintProgramLog(const shader_pair_t *pair)
+{
+    GLint length = 0;
+
+    glGetProgramiv(pair->prog, GL_INFO_LOG_LENGTH, &length);
+    char *info = (char *)malloc(length + 1);
+    info[0] = '\0';
+    glGetProgramInfoLog(pair->prog, length + 1, NULL, info);
+    printf("Linking '%s' with '%s' failed:\n%s\n", pair->vs_source, pair->fs_source, info);
+    free(info);
+}
+
+static int
 CompileShaders(void)
 {
-// Load Vertex Shader
-    if(!LoadShader(vs_source, &program.mVertexShader  , GL_VERTEX_SHADER))
-        return;
-// Load Fragment Shader
-    if(!LoadShader(fs_source, &program.mFragmentShader, GL_FRAGMENT_SHADER))
-        return;
-// Load Program
-    if(!LoadProgram(program.mVertexShader, program.mFragmentShader, &program.mID))
-        return;
-// Load Binary Program
-    SaveProgramBinary(&program.mID, out_file);
-
-    printf ("Generation of Binary Shader Program '%s' Completed Successfully\n", out_file);
+    int failures = 0;
+
+// Compile and link on the compiler threads of GLOVE, so that all programs are in flight at once
+    glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+
+    for(int i = 0; i < pair_count; ++i) {
+        shader_pair_t *pair = &pairs[i];
+        if(!SubmitShader(pair->vs_source, &pair->vs, GL_VERTEX_SHADER) ||
+           !SubmitShader(pair->fs_source, &pair->fs, GL_FRAGMENT_SHADER)) {
+            continue;
+        }
+
+        pair->prog = glCreateProgram();
+        glAttachShader(pair->prog, pair->vs);
+        glAttachShader(pair->prog, pair->fs);
+        glLinkProgram(pair->prog);
+    }
+
+// Collect the results, waiting for each program in submission order
+    for(int i = 0; i < pair_count; ++i) {
+        shader_pair_t *pair = &pairs[i];
+        GLint status = GL_FALSE;
+
+        if(pair->prog) {
+            glGetProgramiv(pair->prog, GL_LINK_STATUS, &status);
+        }
+        if(status == GL_FALSE) {
+            if(pair->prog) {
+                PrintProgramLog(pair);
+            }
+            ++failures;
+            continue;
+        }
+
+        if(pair->out_file[0]) {
+            SaveProgramBinary(&pair->prog, pair->out_file);
+            printf ("Generation of Binary Shader Program '%s' Completed Successfully\n", pair->out_file);
+        }
+    }
+
+    printf("%d of %d shader programs compiled successfully\n", pair_count - failures, pair_count);
+
+    return failures;
 }
 
 void
 DestroyGL(void)
 {
+    for(int i = 0; i < pair_count; ++i) {
 // Detach Shaders
-    DetachShader(program.mID, program.mVertexShader);
-    DetachShader(program.mID, program.mFragmentShader);
+        if(pairs[i].prog) {
+            DetachShader(pairs[i].prog, pairs[i].vs);
+            DetachShader(pairs[i].prog, pairs[i].fs);
+        }
 
 // Delete Shaders
-    DeleteShader  (program.mVertexShader);
-    DeleteShader  (program.mFragmentShader);
+        DeleteShader  (pairs[i].vs);
+        DeleteShader  (pairs[i].fs);
 
 // Delete Program
-    DeleteProgram (program.mID);
+        DeleteProgram (pairs[i].prog);
+    }
+
+    free(pairs);
+    pairs      = NULL;
+    pair_count = 0;
 }
 
 int
 main(int argc, char **argv)
 {
-    if(!ReadArguments(argc, argv))
-      return 0;
+    if(!ReadArguments(argc, argv)) {
+        free(pairs);
+        return EXIT_FAILURE;
+    }
+
+    // GLOVE reads the program cache location when the first program is linked
+    // and writes the cache back when the context is destroyed
+    if(cache_file) {
+        setenv("GLOVE_PROGRAM_CACHE_PATH", cache_file, 1);
+    }
 
     eglutInit(argc, (const char **)argv);
     int win = eglutCreateWindow("");
 
-    CompileShaders();
+    int failures = CompileShaders();
 
     DestroyGL();
 
     eglutDestroyWindow(win);
     _eglutFini();
 
-    return 1;
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
 }
@@ -35,6 +35,9 @@ extern "C" {
 #include "EGL/egl.h"
 #include "vulkan/vulkan.h"
 
+/// acquires the next image of a surface whose images are acquired at their first use rather than on eglSwapBuffers
+typedef void (*acquire_image_cb_t)(void *acquireImageData, void *surface);
+
 typedef struct EGLSurfaceInterface_t {
     void    *surface;
     void    *images;
@@ -43,28 +46,95 @@ typedef struct EGLSurfaceInterface_t {
     uint32_t imageCount;
     uint32_t nextImageIndex;
     uint32_t surfaceColorFormat;
+    /// VkImageUsageFlags the images of a window surface are created with, 0 for the other surfaces
+    uint32_t imageUsage;
     uint32_t type;
     uint32_t width;
     uint32_t height;
+    /// VkSurfaceTransformFlagBitsKHR the images of a window surface are presented with, rendered rotated to it;
+    /// width and height stay those of the surface, which the rotations by a quarter turn swap in the images
+    uint32_t preTransform;
     uint32_t depthSize;
     uint32_t stencilSize;
+    uint32_t samples;
+    uint32_t imageAcquired;
+    acquire_image_cb_t acquireImageCb;
+    void    *acquireImageData;
+    /// bounding box of the damage region of the frame (EGL_KHR_partial_update), with a bottom-left origin;
+    /// the rest of the surface keeps the contents of its image and is not rendered to
+    uint32_t hasDamageRegion;
+    int32_t  damageX;
+    int32_t  damageY;
+    int32_t  damageWidth;
+    int32_t  damageHeight;
+    /// age of the image returned for the frame (EGL_EXT_buffer_age), 0 until the application asks for it;
+    /// the application redraws only what has changed since, so the contents of the image are kept
+    uint32_t bufferAge;
 } EGLSurfaceInterface;
 
 typedef void * api_state_t;
 typedef void * api_context_t;
+typedef void * api_sync_t;
 typedef void (*GLPROC)(void);
 
 typedef api_state_t (*init_API_cb_t)();
 typedef void (*terminate_API_cb_t)();
-typedef api_context_t (*create_context_cb_t)();
+/// priority of the work of a context against the one of the others (EGL_IMG_context_priority)
+typedef enum {
+    API_CONTEXT_PRIORITY_LOW = 0,
+    API_CONTEXT_PRIORITY_MEDIUM,
+    API_CONTEXT_PRIORITY_HIGH
+} api_context_priority_t;
+
+/// share_context is the context whose objects the new one shares, or null, and
+/// a no_error context skips the validation of the calls (EGL_KHR_create_context_no_error).
+/// priority is the one asked for, and is replaced by the one granted
+typedef api_context_t (*create_context_cb_t)(api_context_t share_context, uint32_t no_error, api_context_priority_t *priority);
 typedef void (*set_read_write_surface_cb_t)(api_context_t api_context, EGLSurfaceInterface *eglReadSurfaceInterface, EGLSurfaceInterface *eglWriteSurfaceInterface);
 typedef void (*delete_shared_surface_data_cb_t)(EGLSurfaceInterface *eglSurfaceInterface);
 typedef void (*delete_context_cb_t)(api_context_t api_context);
 typedef void (*release_system_fbo_cb_t)(api_context_t api_context);
+typedef void (*retire_system_fbo_cb_t)(api_context_t api_context);
 typedef GLPROC (*get_proc_addr_cb_t)(const char* procname);
 typedef void (*flush_cb_t)(api_context_t api_context);
 typedef void (*finish_cb_t)(api_context_t api_context);
 typedef void (*bind_to_texture_cb_t)(api_context_t api_context, uint32_t bind);
+typedef void (*prepare_swap_buffers_cb_t)(api_context_t api_context);
+
+typedef enum {
+    API_SYNC_SIGNALED = 0,
+    API_SYNC_TIMEOUT_EXPIRED,
+    API_SYNC_ERROR
+} api_sync_status_t;
+
+typedef api_sync_t (*create_sync_cb_t)(api_context_t api_context);
+typedef void (*destroy_sync_cb_t)(api_sync_t api_sync);
+typedef api_sync_status_t (*client_wait_sync_cb_t)(api_sync_t api_sync, uint64_t timeout);
+/// the commands issued to api_context from now on execute after the sync object signals
+typedef void (*wait_sync_cb_t)(api_context_t api_context, api_sync_t api_sync);
+/// eglInitialize began and ended at these nanoseconds of the steady clock, for the startup profile of the API
+typedef void (*egl_initialized_cb_t)(uint64_t begin_ns, uint64_t end_ns);
+
+/// single plane dma-buf of an EGLImage (EGL_EXT_image_dma_buf_import), bound to textures with glEGLImageTargetTexture2DOES
+#define API_DMA_BUF_IMAGE_MAGIC                 0x46554244 // "DBUF"
+#define API_DMA_BUF_FOURCC(a, b, c, d)          ((uint32_t)(a) | ((uint32_t)(b) << 8) | ((uint32_t)(c) << 16) | ((uint32_t)(d) << 24))
+#define API_DMA_BUF_FORMAT_ABGR8888             API_DMA_BUF_FOURCC('A', 'B', '2', '4')
+#define API_DMA_BUF_FORMAT_XBGR8888             API_DMA_BUF_FOURCC('X', 'B', '2', '4')
+#define API_DMA_BUF_FORMAT_ARGB8888             API_DMA_BUF_FOURCC('A', 'R', '2', '4')
+#define API_DMA_BUF_FORMAT_XRGB8888             API_DMA_BUF_FOURCC('X', 'R', '2', '4')
+#define API_DMA_BUF_FORMAT_RGB565               API_DMA_BUF_FOURCC('R', 'G', '1', '6')
+#define API_DMA_BUF_MODIFIER_LINEAR             0ull
+
+typedef struct api_dma_buf_image {
+    uint32_t magic;
+    int32_t  fd;
+    uint32_t width;
+    uint32_t height;
+    uint32_t fourcc;
+    uint32_t offset;
+    uint32_t pitch;
+    uint64_t modifier;
+} api_dma_buf_image_t;
 
 typedef struct rendering_api_interface {
     api_state_t state;
@@ -75,10 +145,17 @@ typedef struct rendering_api_interface {
     delete_shared_surface_data_cb_t delete_shared_surface_data_cb;
     delete_context_cb_t delete_context_cb;
     release_system_fbo_cb_t release_system_fbo_cb;
+    retire_system_fbo_cb_t retire_system_fbo_cb;
     get_proc_addr_cb_t get_proc_addr_cb;
     flush_cb_t flush_cb;
     finish_cb_t finish_cb;
     bind_to_texture_cb_t bind_to_texture_cb;
+    prepare_swap_buffers_cb_t prepare_swap_buffers_cb;
+    create_sync_cb_t create_sync_cb;
+    destroy_sync_cb_t destroy_sync_cb;
+    client_wait_sync_cb_t client_wait_sync_cb;
+    wait_sync_cb_t wait_sync_cb;
+    egl_initialized_cb_t egl_initialized_cb;
 } rendering_api_interface_t;
 
 extern rendering_api_interface_t GLES2Interface;
@@ -100,6 +177,10 @@ typedef struct vkSyncItems_t {
     bool                                drawSemaphoreFlag;
 } vkSyncItems_t;
 
+/// submissions and presentation on the shared queue, serialized with the ones of the rendering API
+typedef VkResult (*queue_submit_cb_t)(VkQueue queue, uint32_t submitCount, const VkSubmitInfo *submits, VkFence fence);
+typedef VkResult (*queue_present_cb_t)(VkQueue queue, const VkPresentInfoKHR *presentInfo, PFN_vkQueuePresentKHR queuePresent);
+
 typedef struct vkInterface {
     VkInstance                          vkInstance;
     VkPhysicalDevice                    *vkGpus;
@@ -108,6 +189,15 @@ typedef struct vkInterface {
     VkDevice                            vkDevice;
     VkPhysicalDeviceMemoryProperties    vkDeviceMemoryProperties;
     vkSyncItems_t                       *vkSyncItems;
+    bool                                presentWaitSupported;
+    /// VK_KHR_incremental_present is enabled, so presents may carry their damaged regions
+    bool                                incrementalPresentSupported;
+    /// VK_EXT_image_compression_control_swapchain is enabled, and the swapchain images are to be compressed at a fixed rate
+    bool                                fixedRateCompressionSupported;
+    /// the instance and device were created without the WSI extensions
+    bool                                headless;
+    queue_submit_cb_t                   queueSubmitCb;
+    queue_present_cb_t                  queuePresentCb;
 } vkInterface_t;
 
 #endif // __RENDERING_API_INTERFACE_H__
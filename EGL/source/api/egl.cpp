@@ -34,7 +34,7 @@
 #endif // DEBUG_DEPTH
 #define DEBUG_DEPTH                          EGL_LOG_INFO
 
-RenderingThread currentThread;
+thread_local RenderingThread currentThread;
 EGLGlobalResourceManager eglGlobalResourceManager;
 
 #define THREAD_EXEC_RETURN(func)             FUN_ENTRY(DEBUG_DEPTH);                                                      \
@@ -131,7 +131,9 @@ eglCreateContext(EGLDisplay dpy, EGLConfig config, EGLContext share_context, con
     CHECK_UNINITIALIZED_DISPLAY(eglDriver, eglDisplay, EGL_NO_CONTEXT)
     CHECK_BAD_CONFIG(eglDriver, eglConfig, config, EGL_NO_CONTEXT)
     EGLContext_t* eglShareContext = static_cast<EGLContext_t*>(share_context);
-    // TODO::check for valid context
+    if(eglShareContext != nullptr && eglDriver->CheckBadContext(eglShareContext) == EGL_FALSE) {
+        return EGL_NO_CONTEXT;
+    }
     THREAD_EXEC_RETURN(CreateContext(eglDriver, eglConfig, eglShareContext, attrib_list));
 }
 
@@ -423,13 +425,7 @@ eglGetProcAddress(const char *procname)
     EGLenum enumAPI = currentThread.QueryAPI();
     if(enumAPI == EGL_OPENGL_ES_API) {
         // Assuming only GLES2 for now
-        rendering_api_interface_t* api = nullptr;
-        rendering_api_return_e ret = RENDERING_API_load_api(EGL_OPENGL_ES_API, EGL_GL_VERSION_2, &api);
-        if(ret == RENDERING_API_LOAD_SUCCESS) {
-            fp = api->get_proc_addr_cb(procname);
-        }
-        // remove the refCounter for this call
-        RENDERING_API_terminate_gles2_api();
+        fp = RENDERING_API_get_proc_addr(EGL_OPENGL_ES_API, EGL_GL_VERSION_2, procname);
     } else {
         NOT_IMPLEMENTED();
     }
@@ -458,7 +454,6 @@ eglDestroyImageKHR(EGLDisplay dpy, EGLImageKHR image)
     return eglDriver->DestroyImageKHR(image);
 }
 
-//TODO: Implement the KHR_fence_sync extension
 EGLSyncKHR EGLAPIENTRY
 eglCreateSyncKHR(EGLDisplay dpy, EGLenum type, const EGLint *attrib_list)
 {
@@ -488,3 +483,63 @@ eglClientWaitSyncKHR(EGLDisplay dpy, EGLSyncKHR sync, EGLint flags, EGLTimeKHR t
     CHECK_UNINITIALIZED_DISPLAY(eglDriver, eglDisplay, EGL_FALSE)
     return eglDriver->ClientWaitSyncKHR(sync, flags, timeout);
 }
+
+EGLint EGLAPIENTRY
+eglWaitSyncKHR(EGLDisplay dpy, EGLSyncKHR sync, EGLint flags)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    CHECK_BAD_DISPLAY(eglDisplay, dpy, EGL_FALSE)
+    CHECK_UNINITIALIZED_DISPLAY(eglDriver, eglDisplay, EGL_FALSE)
+    return eglDriver->WaitSyncKHR(sync, flags);
+}
+
+EGLBoolean EGLAPIENTRY
+eglQueryDmaBufFormatsEXT(EGLDisplay dpy, EGLint max_formats, EGLint *formats, EGLint *num_formats)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    CHECK_BAD_DISPLAY(eglDisplay, dpy, EGL_FALSE)
+    CHECK_UNINITIALIZED_DISPLAY(eglDriver, eglDisplay, EGL_FALSE)
+    return eglDriver->QueryDmaBufFormatsEXT(max_formats, formats, num_formats);
+}
+
+EGLBoolean EGLAPIENTRY
+eglQueryDmaBufModifiersEXT(EGLDisplay dpy, EGLint format, EGLint max_modifiers, EGLuint64KHR *modifiers, EGLBoolean *external_only, EGLint *num_modifiers)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    CHECK_BAD_DISPLAY(eglDisplay, dpy, EGL_FALSE)
+    CHECK_UNINITIALIZED_DISPLAY(eglDriver, eglDisplay, EGL_FALSE)
+    return eglDriver->QueryDmaBufModifiersEXT(format, max_modifiers, modifiers, external_only, num_modifiers);
+}
+
+EGLBoolean EGLAPIENTRY
+eglSwapBuffersWithDamageKHR(EGLDisplay dpy, EGLSurface surface, EGLint *rects, EGLint n_rects)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    CHECK_BAD_DISPLAY(eglDisplay, dpy, EGL_FALSE)
+    CHECK_UNINITIALIZED_DISPLAY(eglDriver, eglDisplay, EGL_FALSE)
+    CHECK_BAD_SURFACE(eglDriver, eglSurface, surface, EGL_FALSE)
+    return eglDriver->SwapBuffers(eglSurface, rects, n_rects);
+}
+
+EGLBoolean EGLAPIENTRY
+eglSwapBuffersWithDamageEXT(EGLDisplay dpy, EGLSurface surface, EGLint *rects, EGLint n_rects)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    return eglSwapBuffersWithDamageKHR(dpy, surface, rects, n_rects);
+}
+
+EGLBoolean EGLAPIENTRY
+eglSetDamageRegionKHR(EGLDisplay dpy, EGLSurface surface, EGLint *rects, EGLint n_rects)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    CHECK_BAD_DISPLAY(eglDisplay, dpy, EGL_FALSE)
+    CHECK_UNINITIALIZED_DISPLAY(eglDriver, eglDisplay, EGL_FALSE)
+    CHECK_BAD_SURFACE(eglDriver, eglSurface, surface, EGL_FALSE)
+    return eglDriver->SetDamageRegion(eglSurface, rects, n_rects);
+}
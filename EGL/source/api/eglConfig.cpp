@@ -628,56 +628,18 @@ struct EGLConfigComparator: public std::binary_function<EGLConfig_t, EGLConfig_t
 /**
  * Returns a list of sorted configs that match the given criteria
  */
-EGLBoolean
-FilterConfigArray(EGLConfig_t **configs, EGLint config_size, EGLint *num_config, const EGLConfig_t *criteria)
+void
+FilterConfigArray(const EGLConfig_t *criteria, std::vector<EGLConfig_t *> *matchedConfigs)
 {
     FUN_ENTRY(DEBUG_DEPTH);
 
-    if(num_config == nullptr) {
-        currentThread.RecordError(EGL_BAD_PARAMETER);
-        return EGL_FALSE;
-    }
-    int count = 0;
-
+    matchedConfigs->clear();
     for(int i = 0; i < ARRAY_SIZE(EglConfigs); ++i) {
         if(MatchConfig(&EglConfigs[i], criteria)) {
-            ++count;
-        }
-    }
-
-    if(num_config) {
-        *num_config = count;
-    }
-
-    if(configs == nullptr) {
-        return EGL_TRUE;
-    }
-
-    count = count > config_size ? config_size : count;
-    if(count <= 0) {
-        return EGL_TRUE;
-    }
-
-    std::vector<const EGLConfig_t*> matchedConfigs;
-    matchedConfigs.reserve(count);
-
-    int i = 0;
-    int j = 0;
-    while(j < count) {
-        if(MatchConfig(&EglConfigs[i], criteria)) {
-            matchedConfigs.push_back(&EglConfigs[i]);
-            ++j;
+            matchedConfigs->push_back(const_cast<EGLConfig_t *>(&EglConfigs[i]));
         }
-        ++i;
     }
 
-    // sort configs
-    std::sort(matchedConfigs.begin(), matchedConfigs.end(), EGLConfigComparator(criteria));
-
-    // copy to configs if no error has occured
-    for(size_t i = 0; i < matchedConfigs.size(); ++i) {
-        configs[i] = const_cast<EGLConfig_t*>(matchedConfigs[i]);
-    }
-
-    return EGL_TRUE;
+    // all the matches are sorted, before the caller keeps the first ones it has room for
+    std::sort(matchedConfigs->begin(), matchedConfigs->end(), EGLConfigComparator(criteria));
 }
@@ -25,6 +25,7 @@
 #define __EGL_CONFIG_H__
 
 #include <stddef.h>
+#include <vector>
 #include "EGL/egl.h"
 #include "EGL/eglext.h"
 #include "utils/egl_defs.h"
@@ -202,19 +203,16 @@ EGLBoolean MatchConfig(const EGLConfig_t *conf, const EGLConfig_t *criteria);
 EGLint CompareConfigs(const EGLConfig_t *conf1, const EGLConfig_t *conf2, const EGLConfig_t *criteria, EGLBoolean compare_id);
 
 /**
- * A helper function for implementing eglChooseConfig.  See SortConfigs
- * for the meanings of match and compare.
+ * A helper function for implementing eglChooseConfig. It returns all
+ * the configs that match the criteria, sorted as CompareConfigs orders them.
  */
-//FilterConfigArray(EGLConfig_t *configs, EGLint config_size, EGLint *num_configs,
-//                  EGLBoolean (*match)(const EGLConfig_t *, void *),
-//                  EGLint (*compare)(const EGLConfig_t *, const EGLConfig_t *, void *),
-//                  void *filter_data);
-EGLBoolean FilterConfigArray(EGLConfig_t **configs, EGLint config_size, EGLint *num_config, const EGLConfig_t *criteria);
+void FilterConfigArray(const EGLConfig_t *criteria, std::vector<EGLConfig_t *> *matchedConfigs);
 
 #ifdef VK_USE_PLATFORM_ANDROID_KHR
-extern const EGLConfig_t EglConfigs[4];
+#   define EGL_CONFIG_COUNT                             (5 + (EGL_RGB565_CONFIG ? 1 : 0))
 #else
-extern const EGLConfig_t EglConfigs[1];
+#   define EGL_CONFIG_COUNT                             (2 + (EGL_RGB565_CONFIG ? 1 : 0))
 #endif
+extern const EGLConfig_t EglConfigs[EGL_CONFIG_COUNT];
 
 #endif // __EGL_CONFIG_H__
@@ -29,7 +29,7 @@
 
 //TODO: Ideally configs should be build after quering vulkan driver for relevant supported features
 
-const EGLConfig_t EglConfigs[1] = {
+const EGLConfig_t EglConfigs[EGL_CONFIG_COUNT] = {
                                    { 0,   // Display
                                     32,   // BufferSize
                                      8,   // AlphaSize
@@ -61,9 +61,85 @@ const EGLConfig_t EglConfigs[1] = {
                                      0,   // LuminanceSize
                                      0,   // AlphaMaskSize
                         EGL_RGB_BUFFER,   // ColorBufferType
+                    EGL_OPENGL_ES2_BIT,   // RenderableType
+                              EGL_NONE,   // MatchNativePixmap
+                                   0x4,   // Conformant
+                             EGL_FALSE,   // RecordableAndroid
+                             EGL_FALSE},  // FramebufferTargetAndroid
+
+                                   { 0,   // Display
+                                    32,   // BufferSize
+                                     8,   // AlphaSize
+                                     8,   // BlueSize
+                                     8,   // GreenSize
+                                     8,   // RedSize
+                                    24,   // DepthSize
+                                     8,   // StencilSize
+                              EGL_NONE,   // ConfigCaveat
+                                     2,   // ConfigID
+                                     0,   // Level
+                                  1080,   // MaxPbufferHeight
+                           1920 * 1080,   // MaxPbufferPixels
+                                  1920,   // MaxPbufferWidth
+                             EGL_FALSE,   // NativeRenderable
+                                  0x21,   // NativeVisualID
+                              EGL_NONE,   // NativeVisualType
+                                     4,   // Samples
+                                     1,   // SampleBuffers
+                        EGL_WINDOW_BIT,   // SurfaceType
+                              EGL_NONE,   // TransparentType
+                                     0,   // TransparentBlueValue
+                                     0,   // TransparentGreenValue
+                                     0,   // TransparentRedValue
+                             EGL_FALSE,   // BindToTextureRGB
+                              EGL_TRUE,   // BindToTextureRGBA
+                                     0,   // MinSwapInterval
+                                     1,   // MaxSwapInterval
+                                     0,   // LuminanceSize
+                                     0,   // AlphaMaskSize
+                        EGL_RGB_BUFFER,   // ColorBufferType
+                    EGL_OPENGL_ES2_BIT,   // RenderableType
+                              EGL_NONE,   // MatchNativePixmap
+                                   0x4,   // Conformant
+                             EGL_FALSE,   // RecordableAndroid
+                             EGL_FALSE},  // FramebufferTargetAndroid
+
+#if EGL_RGB565_CONFIG
+                                   { 0,   // Display
+                                    16,   // BufferSize
+                                     0,   // AlphaSize
+                                     5,   // BlueSize
+                                     6,   // GreenSize
+                                     5,   // RedSize
+                                    24,   // DepthSize
+                                     8,   // StencilSize
+                              EGL_NONE,   // ConfigCaveat
+                                     3,   // ConfigID
+                                     0,   // Level
+                                  1080,   // MaxPbufferHeight
+                           1920 * 1080,   // MaxPbufferPixels
+                                  1920,   // MaxPbufferWidth
+                             EGL_FALSE,   // NativeRenderable
+                                  0x21,   // NativeVisualID
+                              EGL_NONE,   // NativeVisualType
+                                     0,   // Samples
+                                     0,   // SampleBuffers
+                        EGL_WINDOW_BIT,   // SurfaceType
+                              EGL_NONE,   // TransparentType
+                                     0,   // TransparentBlueValue
+                                     0,   // TransparentGreenValue
+                                     0,   // TransparentRedValue
+                             EGL_FALSE,   // BindToTextureRGB
+                             EGL_FALSE,   // BindToTextureRGBA
+                                     0,   // MinSwapInterval
+                                     1,   // MaxSwapInterval
+                                     0,   // LuminanceSize
+                                     0,   // AlphaMaskSize
+                        EGL_RGB_BUFFER,   // ColorBufferType
                     EGL_OPENGL_ES2_BIT,   // RenderableType
                               EGL_NONE,   // MatchNativePixmap
                                    0x4,   // Conformant
                              EGL_FALSE,   // RecordableAndroid
                              EGL_FALSE}   // FramebufferTargetAndroid
+#endif // EGL_RGB565_CONFIG
 };
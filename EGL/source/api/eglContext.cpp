@@ -28,12 +28,12 @@
 #include "thread/renderingThread.h"
 #include <algorithm>
 
-EGLContext_t::EGLContext_t(EGLDisplay_t* display, EGLenum rendering_api, EGLConfig_t *config, const EGLint *attribList):
+EGLContext_t::EGLContext_t(EGLDisplay_t* display, EGLenum rendering_api, EGLConfig_t *config, EGLContext_t *shareContext, const EGLint *attribList):
 EGLRefObject(),
-mAPIContext(nullptr), mRenderingAPI(rendering_api), mAPIInterface(nullptr),
+mAPIContext(nullptr), mShareContext(shareContext), mRenderingAPI(rendering_api), mAPIInterface(nullptr),
 mDisplay(display), mReadSurface(nullptr), mDrawSurface(nullptr),
 mConfig(config), mAttribList(attribList), mClientVersion(1),
-mIsCurrent(false)
+mNoError(EGL_FALSE), mPriority(EGL_CONTEXT_PRIORITY_MEDIUM_IMG), mIsCurrent(false)
 {
     FUN_ENTRY(EGL_LOG_TRACE);
 
@@ -53,6 +53,14 @@ EGLContext_t::ReleaseSurfaceResources()
     mAPIInterface->release_system_fbo_cb(mAPIContext);
 }
 
+void
+EGLContext_t::RetireSurfaceResources()
+{
+    FUN_ENTRY(EGL_LOG_TRACE);
+
+    mAPIInterface->retire_system_fbo_cb(mAPIContext);
+}
+
 EGLint
 EGLContext_t::GetRenderBuffer() const
 {
@@ -100,7 +108,13 @@ EGLContext_t::Validate()
         return EGL_FALSE;
     }
 
-    // TODO:: generate EGL_BAD_MATCH for incompatible share_contets
+    // objects can only be shared with a context of the same client API and version
+    if(mShareContext != nullptr &&
+       (mShareContext->GetRenderingAPI() != mRenderingAPI || mShareContext->GetClientVersion() != mClientVersion ||
+        mShareContext->GetNoError() != mNoError)) {
+        currentThread.RecordError(EGL_BAD_MATCH);
+        return EGL_FALSE;
+    }
 
     return EGL_TRUE;
 }
@@ -122,7 +136,14 @@ EGLContext_t::Create()
         return EGL_FALSE;
     }
 
-    mAPIContext = mAPIInterface->create_context_cb();
+    api_context_priority_t priority = mPriority == EGL_CONTEXT_PRIORITY_HIGH_IMG ? API_CONTEXT_PRIORITY_HIGH :
+                                      mPriority == EGL_CONTEXT_PRIORITY_LOW_IMG  ? API_CONTEXT_PRIORITY_LOW  :
+                                                                                   API_CONTEXT_PRIORITY_MEDIUM;
+    mAPIContext = mAPIInterface->create_context_cb(mShareContext ? mShareContext->GetAPIContext() : nullptr, mNoError, &priority);
+    mPriority   = priority == API_CONTEXT_PRIORITY_HIGH ? EGL_CONTEXT_PRIORITY_HIGH_IMG :
+                  priority == API_CONTEXT_PRIORITY_LOW  ? EGL_CONTEXT_PRIORITY_LOW_IMG  :
+                                                          EGL_CONTEXT_PRIORITY_MEDIUM_IMG;
+    mShareContext = nullptr;
 
     return mAPIContext != nullptr ? EGL_TRUE : EGL_FALSE;
 }
@@ -189,6 +210,14 @@ EGLContext_t::Finish()
     mAPIInterface->finish_cb(mAPIContext);
 }
 
+void
+EGLContext_t::PrepareSwapBuffers()
+{
+    FUN_ENTRY(EGL_LOG_DEBUG);
+
+    mAPIInterface->prepare_swap_buffers_cb(mAPIContext);
+}
+
 void
 EGLContext_t::BindToTexture(EGLint bind)
 {
@@ -197,6 +226,14 @@ EGLContext_t::BindToTexture(EGLint bind)
     mAPIInterface->bind_to_texture_cb(mAPIContext, bind);
 }
 
+api_sync_t
+EGLContext_t::CreateSync()
+{
+    FUN_ENTRY(EGL_LOG_DEBUG);
+
+    return mAPIInterface->create_sync_cb(mAPIContext);
+}
+
 EGLBoolean
 EGLContext_t::ParseAttributeList(const EGLint* attrib_list)
 {
@@ -210,8 +247,9 @@ EGLContext_t::ParseAttributeList(const EGLint* attrib_list)
         return EGL_FALSE;
     }
 
-    // EGL_BAD_ATTRIBUTE is also generated if
-    // attribute is not EGL_CONTEXT_CLIENT_VERSION  with values 1 or 2
+    // EGL_BAD_ATTRIBUTE is also generated if attribute is not EGL_CONTEXT_CLIENT_VERSION
+    // with values 1 or 2, EGL_CONTEXT_OPENGL_NO_ERROR_KHR with a boolean value, or
+    // EGL_CONTEXT_PRIORITY_LEVEL_IMG with one of the priority levels
     for(int i = 0; attrib_list[i] != EGL_NONE; i++) {
         EGLint attr = attrib_list[i++];
         EGLint val = attrib_list[i];
@@ -220,6 +258,11 @@ EGLContext_t::ParseAttributeList(const EGLint* attrib_list)
            mClientVersion = EGL_GL_VERSION_1;
         } else if(attr == EGL_CONTEXT_CLIENT_VERSION && val == 2) {
             mClientVersion = EGL_GL_VERSION_2;
+        } else if(attr == EGL_CONTEXT_OPENGL_NO_ERROR_KHR && (val == EGL_TRUE || val == EGL_FALSE)) {
+            mNoError = val;
+        } else if(attr == EGL_CONTEXT_PRIORITY_LEVEL_IMG &&
+                  (val == EGL_CONTEXT_PRIORITY_HIGH_IMG || val == EGL_CONTEXT_PRIORITY_MEDIUM_IMG || val == EGL_CONTEXT_PRIORITY_LOW_IMG)) {
+            mPriority = val;
         } else {
             currentThread.RecordError(EGL_BAD_ATTRIBUTE);
             return EGL_FALSE;
@@ -34,6 +34,8 @@
 class EGLContext_t : public EGLRefObject {
 private:
     api_context_t                mAPIContext;
+    /// context whose objects are shared, only read while the context is created
+    EGLContext_t                *mShareContext;
     EGLenum                      mRenderingAPI;
     EGLint                       mRenderableAPIbit;
     rendering_api_interface_t   *mAPIInterface;
@@ -43,6 +45,9 @@ private:
     struct EGLConfig_t          *mConfig;
     const EGLint                *mAttribList;
     EGLenum                      mClientVersion;
+    EGLBoolean                   mNoError;
+    /// EGL_IMG_context_priority, the one asked for until the context is created, then the one granted
+    EGLint                       mPriority;
     bool                         mIsCurrent;
 
     EGLBoolean                   GetAPIRenderableType();
@@ -50,7 +55,7 @@ private:
     EGLBoolean                   Validate();
 
 public:
-    EGLContext_t(struct EGLDisplay_t * display, EGLenum rendering_api, EGLConfig_t* config, const EGLint *attribList);
+    EGLContext_t(struct EGLDisplay_t * display, EGLenum rendering_api, EGLConfig_t* config, EGLContext_t *shareContext, const EGLint *attribList);
     ~EGLContext_t();
 
     EGLBoolean                   Create();
@@ -59,17 +64,24 @@ public:
     //void                         SetNextImageIndex(uint32_t index);
     void                         Flush();
     void                         Finish();
+    void                         PrepareSwapBuffers();
     void                         BindToTexture(EGLint bind);
+    api_sync_t                   CreateSync();
     void                         ReleaseSurfaceResources();
+    void                         RetireSurfaceResources();
 
     inline void                  SetNotCurrent()                                { FUN_ENTRY(EGL_LOG_TRACE); mIsCurrent = false; }
 
     inline EGLenum               GetRenderingAPI()                        const { FUN_ENTRY(EGL_LOG_TRACE); return mRenderingAPI; }
+    inline rendering_api_interface_t *GetAPIInterface()                   const { FUN_ENTRY(EGL_LOG_TRACE); return mAPIInterface; }
+    inline api_context_t         GetAPIContext()                          const { FUN_ENTRY(EGL_LOG_TRACE); return mAPIContext; }
     inline EGLDisplay_t         *GetDisplay()                             const { FUN_ENTRY(EGL_LOG_TRACE); return mDisplay; }
     inline EGLSurface_t         *GetReadSurface()                         const { FUN_ENTRY(EGL_LOG_TRACE); return mReadSurface; }
     inline EGLSurface_t         *GetDrawSurface()                         const { FUN_ENTRY(EGL_LOG_TRACE); return mDrawSurface; }
     inline EGLint                GetConfigID()                            const { FUN_ENTRY(EGL_LOG_TRACE); return GetConfigKey(mConfig, EGL_CONFIG_ID); }
     inline EGLint                GetClientVersion()                       const { FUN_ENTRY(EGL_LOG_TRACE); return mClientVersion; }
+    inline EGLBoolean            GetNoError()                             const { FUN_ENTRY(EGL_LOG_TRACE); return mNoError; }
+    inline EGLint                GetPriority()                            const { FUN_ENTRY(EGL_LOG_TRACE); return mPriority; }
            EGLint                GetRenderBuffer()                        const;
     inline bool                  IsCurrent()                              const  { FUN_ENTRY(EGL_LOG_TRACE); return mIsCurrent; }
 
@@ -26,9 +26,17 @@
 #endif //  EGL_FUNC_PTR
 
 #include "EGL/egl.h"
-#include <string>
-#include <unordered_map>
-static const std::unordered_map<std::string, __eglMustCastToProperFunctionPointerType> eglFPMap = {
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+typedef struct eglFunction_t {
+    const char *name;
+    __eglMustCastToProperFunctionPointerType proc;
+} eglFunction_t;
+
+static const eglFunction_t eglFunctions[] = {
 #ifdef EGL_VERSION_1_0
 EGL_FUNC_PTR(eglChooseConfig),
 EGL_FUNC_PTR(eglCopyBuffers),
@@ -78,10 +86,19 @@ EGL_FUNC_PTR(eglGetCurrentContext)
 
 __eglMustCastToProperFunctionPointerType GetEGLProcAddr(const char *procname)
 {
+    // the entries are sorted by name once, and looked up without allocating from then on
+    static const std::vector<eglFunction_t> sortedFunctions = [] {
+        std::vector<eglFunction_t> functions(std::begin(eglFunctions), std::end(eglFunctions));
+        std::sort(functions.begin(), functions.end(),
+                  [](const eglFunction_t &a, const eglFunction_t &b) { return strcmp(a.name, b.name) < 0; });
+        return functions;
+    }();
+
     if(strncmp(procname, "egl", 3) == 0) {
-        const auto& it = eglFPMap.find(procname);
-        if(it != eglFPMap.end()) {
-            return it->second;
+        const auto it = std::lower_bound(sortedFunctions.begin(), sortedFunctions.end(), procname,
+                                         [](const eglFunction_t &entry, const char *name) { return strcmp(entry.name, name) < 0; });
+        if(it != sortedFunctions.end() && strcmp(it->name, procname) == 0) {
+            return it->proc;
         }
     }
     return nullptr;
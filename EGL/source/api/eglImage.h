@@ -0,0 +1,63 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       eglImage.h
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      EGLImage of a Linux dma-buf (EGL_EXT_image_dma_buf_import). It holds a duplicate
+ *              of the descriptor given by the application, which may close its own one, and is
+ *              handed as such to the rendering API, which imports the dma-buf without a copy.
+ *
+ */
+
+#ifndef __EGL_IMAGE_H__
+#define __EGL_IMAGE_H__
+
+#include "EGL/egl.h"
+#include "EGL/eglext.h"
+#include "rendering_api_interface.h"
+#include "utils/eglLogger.h"
+
+#ifdef __linux__
+#include <unistd.h>
+
+class EGLImage_t : public api_dma_buf_image_t {
+public:
+    explicit EGLImage_t(const api_dma_buf_image_t &dmaBuf)
+    : api_dma_buf_image_t(dmaBuf)
+    {
+        FUN_ENTRY(EGL_LOG_TRACE);
+
+        magic = API_DMA_BUF_IMAGE_MAGIC;
+        fd    = dup(dmaBuf.fd);
+    }
+
+    ~EGLImage_t()
+    {
+        FUN_ENTRY(EGL_LOG_TRACE);
+
+        if(fd >= 0) {
+            close(fd);
+        }
+    }
+
+    inline bool                  IsValid(void)                            const { FUN_ENTRY(EGL_LOG_TRACE); return fd >= 0; }
+    /// the description of the dma-buf is what the rendering API receives as the image
+    inline EGLImageKHR           GetHandle(void)                                { FUN_ENTRY(EGL_LOG_TRACE); return static_cast<EGLImageKHR>(static_cast<api_dma_buf_image_t *>(this)); }
+};
+#endif // __linux__
+
+#endif // __EGL_IMAGE_H__
@@ -29,12 +29,13 @@
 EGLSurface_t::EGLSurface_t():
 EGLRefObject (),
 Config(nullptr), Type(0), Width(0), Height(0),
-DepthSize(0), StencilSize(0), RedSize(0), GreenSize(0), BlueSize(0), AlphaSize(0),
+DepthSize(0), StencilSize(0), Samples(0), RedSize(0), GreenSize(0), BlueSize(0), AlphaSize(0),
 TextureFormat(0), TextureTarget(0), MipmapTexture(EGL_FALSE),
 LargestPbuffer(EGL_FALSE), RenderBuffer(0), VGAlphaFormat(0), VGColorspace(0),
 MipmapLevel(0), MultisampleResolve(0), SwapBehavior(0), HorizontalResolution(0),
 VerticalResolution(0), AspectRatio(0), SwapInterval(1), BindToTexture(EGL_FALSE), PostSubBufferSupportedNV(0),
-CurrentImageIndex(0), mPlatformResources(nullptr)
+CurrentImageIndex(0), FrameCount(0), BufferAgeQueried(EGL_FALSE), DamageRegionSet(EGL_FALSE),
+mPlatformResources(nullptr)
 {
     FUN_ENTRY(EGL_LOG_TRACE);
 
@@ -242,6 +243,7 @@ EGLSurface_t::InitSurface(EGLint type, EGLConfig_t *conf, const EGLint *attrib_l
     AlphaSize         = GetConfigKey(conf, EGL_ALPHA_SIZE);
     DepthSize         = GetConfigKey(conf, EGL_DEPTH_SIZE);
     StencilSize       = GetConfigKey(conf, EGL_STENCIL_SIZE);
+    Samples           = GetConfigKey(conf, EGL_SAMPLES);
     BindToTextureRGB  = GetConfigKey(conf, EGL_BIND_TO_TEXTURE_RGB);
     BindToTextureRGBA = GetConfigKey(conf, EGL_BIND_TO_TEXTURE_RGBA);
 
@@ -374,6 +376,76 @@ EGLSurface_t::ClampSwapInterval(EGLint interval)
     SwapInterval           = clampedInterval;
 }
 
+EGLint
+EGLSurface_t::GetBufferAge()
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    BufferAgeQueried = EGL_TRUE;
+
+    // 0 for an image never presented, whose contents are undefined
+    uint32_t imageIndex = SurfaceInterface.nextImageIndex;
+    if(imageIndex >= ImagePresentFrames.size() || !ImagePresentFrames[imageIndex]) {
+        SurfaceInterface.bufferAge = 0;
+        return 0;
+    }
+
+    SurfaceInterface.bufferAge = FrameCount + 1 - ImagePresentFrames[imageIndex];
+    return static_cast<EGLint>(SurfaceInterface.bufferAge);
+}
+
+void
+EGLSurface_t::SetDamageRegion(const EGLint *rects, EGLint rectCount)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    DamageRegionSet = EGL_TRUE;
+
+    // the rendering is bounded by the box of the rectangles, no rectangles stand for the whole surface
+    EGLint x0 = Width, y0 = Height, x1 = 0, y1 = 0;
+    for(EGLint i = 0; i < rectCount; ++i) {
+        const EGLint *rect = &rects[4 * i];
+        x0 = std::min(x0, rect[0]);
+        y0 = std::min(y0, rect[1]);
+        x1 = std::max(x1, rect[0] + rect[2]);
+        y1 = std::max(y1, rect[1] + rect[3]);
+    }
+
+    SurfaceInterface.hasDamageRegion = rectCount > 0;
+    SurfaceInterface.damageX         = std::max(x0, 0);
+    SurfaceInterface.damageY         = std::max(y0, 0);
+    SurfaceInterface.damageWidth     = std::max(std::min(x1, Width)  - SurfaceInterface.damageX, 0);
+    SurfaceInterface.damageHeight    = std::max(std::min(y1, Height) - SurfaceInterface.damageY, 0);
+}
+
+void
+EGLSurface_t::EndFrame()
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    // the frames are counted from 1, so that 0 marks images never presented
+    uint32_t imageIndex = SurfaceInterface.nextImageIndex;
+    if(imageIndex >= ImagePresentFrames.size()) {
+        ImagePresentFrames.resize(imageIndex + 1, 0);
+    }
+    ImagePresentFrames[imageIndex] = ++FrameCount;
+
+    BufferAgeQueried                 = EGL_FALSE;
+    DamageRegionSet                  = EGL_FALSE;
+    SurfaceInterface.hasDamageRegion = 0;
+    SurfaceInterface.bufferAge       = 0;
+}
+
+void
+EGLSurface_t::ResetBufferAge()
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    // the images of a recreated swapchain have undefined contents
+    ImagePresentFrames.clear();
+    SurfaceInterface.bufferAge = 0;
+}
+
 void
 EGLSurface_t::UpdateRef(bool increaseRef)
 {
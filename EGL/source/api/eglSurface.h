@@ -27,6 +27,7 @@
 #include "EGL/egl.h"
 #include <cmath>
 #include <algorithm>
+#include <vector>
 #include "eglRefObject.h"
 #include "eglContext.h"
 #include "eglConfig.h"
@@ -50,6 +51,7 @@ private:
     /* attributes set by attribute list */
     EGLint                           Width, Height;
     EGLint                           DepthSize, StencilSize;
+    EGLint                           Samples;
     EGLint                           RedSize, GreenSize, BlueSize, AlphaSize;
     EGLenum                          TextureFormat;
     EGLenum                          TextureTarget;
@@ -79,6 +81,13 @@ private:
     EGLint                           ColorFormat;
     EGLSurfaceInterface_t            SurfaceInterface;
 
+    /* frames presented so far, and the frame each image was last presented in, for EGL_BUFFER_AGE_KHR */
+    uint64_t                         FrameCount;
+    std::vector<uint64_t>            ImagePresentFrames;
+    /* EGL_KHR_partial_update, reset at each frame boundary */
+    EGLBoolean                       BufferAgeQueried;
+    EGLBoolean                       DamageRegionSet;
+
     PlatformResources               *mPlatformResources;
 
 public:
@@ -108,6 +117,9 @@ public:
     inline void                      SetSwapBehavior(EGLint swapBehavior)                       { FUN_ENTRY(EGL_LOG_TRACE); SwapBehavior = swapBehavior; }
     inline void                      SetBindToTexture(EGLint bindToTexture)                     { FUN_ENTRY(EGL_LOG_TRACE); BindToTexture = bindToTexture; }
            void                      ClampSwapInterval(EGLint swapInterval);
+           void                      SetDamageRegion(const EGLint *rects, EGLint rectCount);
+           void                      EndFrame();
+           void                      ResetBufferAge();
            void                      UpdateRef(bool increaseRef) override;
 
     inline EGLint                    GetType()                                            const { FUN_ENTRY(EGL_LOG_TRACE); return Type; }
@@ -115,6 +127,8 @@ public:
     inline EGLint                    GetHeight()                                          const { FUN_ENTRY(EGL_LOG_TRACE); return Height; }
     inline EGLint                    GetDepthSize()                                       const { FUN_ENTRY(EGL_LOG_TRACE); return DepthSize; }
     inline EGLint                    GetStencilSize()                                     const { FUN_ENTRY(EGL_LOG_TRACE); return StencilSize; }
+    inline EGLint                    GetSamples()                                         const { FUN_ENTRY(EGL_LOG_TRACE); return Samples; }
+    inline EGLBoolean                IsRGB565()                                           const { FUN_ENTRY(EGL_LOG_TRACE); return RedSize == 5 && GreenSize == 6 && BlueSize == 5 && AlphaSize == 0; }
     inline EGLint                    GetCurrentImageIndex()                               const { FUN_ENTRY(EGL_LOG_TRACE); return CurrentImageIndex; }
     inline EGLint                    GetColorFormat()                                     const { FUN_ENTRY(EGL_LOG_TRACE); return ColorFormat; }
     inline EGLSurfaceInterface_t    *GetEGLSurfaceInterface()                                   { FUN_ENTRY(EGL_LOG_TRACE); return &SurfaceInterface; }
@@ -122,12 +136,18 @@ public:
     inline PlatformResources        *GetPlatformResources()                                     { FUN_ENTRY(EGL_LOG_TRACE); return mPlatformResources; }
     inline uint32_t                  GetPlatformSurfaceImageCount()                             { FUN_ENTRY(EGL_LOG_TRACE); return mPlatformResources->GetSwapchainImageCount(); }
     inline void                     *GetPlatformSurfaceImages()                                 { FUN_ENTRY(EGL_LOG_TRACE); return mPlatformResources->GetSwapchainImages(); }
+    inline uint32_t                  GetPlatformSurfaceImageUsage()                             { FUN_ENTRY(EGL_LOG_TRACE); return mPlatformResources->GetSwapchainImageUsage(); }
+    inline uint32_t                  GetPlatformSurfacePreTransform()                           { FUN_ENTRY(EGL_LOG_TRACE); return mPlatformResources->GetSwapchainPreTransform(); }
 
     inline EGLint                    GetBindToTextureRGB()                                const { FUN_ENTRY(EGL_LOG_TRACE); return BindToTextureRGB; }
     inline EGLint                    GetBindToTextureRGBA()                               const { FUN_ENTRY(EGL_LOG_TRACE); return BindToTextureRGBA; }
     inline EGLint                    GetSwapInterval()                                    const { FUN_ENTRY(EGL_LOG_TRACE); return SwapInterval; }
     inline EGLBoolean                GetBindToTexture()                                   const { FUN_ENTRY(EGL_LOG_TRACE); return BindToTexture; }
     inline EGLenum                   GetRenderBuffer()                                    const { FUN_ENTRY(EGL_LOG_TRACE); return RenderBuffer; }
+    inline EGLenum                   GetSwapBehavior()                                    const { FUN_ENTRY(EGL_LOG_TRACE); return SwapBehavior; }
+           EGLint                    GetBufferAge();
+    inline EGLBoolean                IsBufferAgeQueried()                                 const { FUN_ENTRY(EGL_LOG_TRACE); return BufferAgeQueried; }
+    inline EGLBoolean                IsDamageRegionSet()                                  const { FUN_ENTRY(EGL_LOG_TRACE); return DamageRegionSet; }
 };
 
 #endif // __EGL_SURFACE_H__
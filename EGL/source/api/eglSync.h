@@ -0,0 +1,47 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       eglSync.h
+ *  @author     Think Silicon
+ *  @date       14/10/2026
+ *  @version    1.0
+ *
+ *  @brief      EGL fence sync object. It wraps the sync object created by the rendering API,
+ *              which is signaled once the commands issued before its creation have completed.
+ *
+ */
+
+#ifndef __EGL_SYNC_H__
+#define __EGL_SYNC_H__
+
+#include "EGL/egl.h"
+#include "EGL/eglext.h"
+#include "rendering_api_interface.h"
+#include "utils/eglLogger.h"
+
+class EGLSync_t {
+private:
+    rendering_api_interface_t   *mAPIInterface;
+    api_sync_t                   mAPISync;
+
+public:
+    EGLSync_t(rendering_api_interface_t *apiInterface, api_sync_t apiSync)
+    : mAPIInterface(apiInterface), mAPISync(apiSync)                            { FUN_ENTRY(EGL_LOG_TRACE); }
+    ~EGLSync_t()                                                                { FUN_ENTRY(EGL_LOG_TRACE); mAPIInterface->destroy_sync_cb(mAPISync); }
+
+    inline api_sync_status_t     ClientWait(EGLTimeKHR timeout)                 { FUN_ENTRY(EGL_LOG_TRACE); return mAPIInterface->client_wait_sync_cb(mAPISync, static_cast<uint64_t>(timeout)); }
+    inline void                  ServerWait(api_context_t apiContext)           { FUN_ENTRY(EGL_LOG_TRACE); mAPIInterface->wait_sync_cb(apiContext, mAPISync); }
+};
+
+#endif // __EGL_SYNC_H__
@@ -30,14 +30,16 @@
 #include "utils/egl_defs.h"
 #include "utils/eglUtils.h"
 #include "platform/platformFactory.h"
+#include "rendering_api/rendering_api.h"
+#include "glProfiler.h"
 #include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iterator>
 
 #ifdef VK_USE_PLATFORM_ANDROID_KHR
 #include "system/window.h"
 #endif
-RenderingThread *callingThread = nullptr;
-
-void setCallingThread(RenderingThread *thread) { callingThread = thread; }
 
 DisplayDriver::DisplayDriver(EGLDisplay_t* eglDisplay)
 : mEGLDisplay(eglDisplay),
@@ -45,6 +47,8 @@ DisplayDriver::DisplayDriver(EGLDisplay_t* eglDisplay)
   mInitialized(false)
 {
     FUN_ENTRY(EGL_LOG_TRACE);
+
+    GLOVE_PROFILE_INIT();
 }
 
 DisplayDriver::~DisplayDriver(void)
@@ -113,6 +117,9 @@ DisplayDriver::Initialize(EGLint *major, EGLint *minor)
         return EGL_TRUE;
     }
 
+    GLOVE_PROFILE_ZONE("DisplayDriver::Initialize");
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+
     PlatformFactory::ChoosePlatform();
     mWindowInterface = PlatformFactory::GetWindowInterface();
     if(mWindowInterface->Initialize() == EGL_FALSE) {
@@ -122,6 +129,15 @@ DisplayDriver::Initialize(EGLint *major, EGLint *minor)
 
     setEGLVersion(major, minor);
 
+    InitConfigs();
+
+    // the client API was loaded by the window interface, and reports the phase in its startup profile
+    rendering_api_interface_t *api = RENDERING_API_get_interface(EGL_OPENGL_ES_API, EGL_GL_VERSION_2);
+    if(api && api->egl_initialized_cb) {
+        api->egl_initialized_cb(std::chrono::duration_cast<std::chrono::nanoseconds>(begin.time_since_epoch()).count(),
+                                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
     mInitialized = true;
     return EGL_TRUE;
 }
@@ -148,11 +164,11 @@ DisplayDriver::Terminate()
 }
 
 EGLContext
-DisplayDriver::CreateContext(EGLenum rendering_api, EGLConfig_t* config, const EGLint* attribList)
+DisplayDriver::CreateContext(EGLenum rendering_api, EGLConfig_t* config, EGLContext_t* shareContext, const EGLint* attribList)
 {
     FUN_ENTRY(DEBUG_DEPTH);
 
-    EGLContext_t *eglContext = mDisplayDriverResourceManager.AddEGLContext(mEGLDisplay, rendering_api, config, attribList);
+    EGLContext_t *eglContext = mDisplayDriverResourceManager.AddEGLContext(mEGLDisplay, rendering_api, config, shareContext, attribList);
     return static_cast<EGLContext>(eglContext);
 }
 
@@ -172,35 +188,42 @@ DisplayDriver::CleanMarkedResources()
     mDisplayDriverResourceManager.CleanMarkedResources(mWindowInterface);
 }
 
+void
+DisplayDriver::InitConfigs(void)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    if(!mConfigs.empty()) {
+        return;
+    }
+
+    // every config of the display is a valid handle from now on, whether it has been returned yet or not
+    mConfigs.reserve(ARRAY_SIZE(EglConfigs));
+    for(int32_t i = 0; i < ARRAY_SIZE(EglConfigs); ++i) {
+        mConfigs.push_back(const_cast<EGLConfig_t *>(&EglConfigs[i]));
+        mDisplayDriverResourceManager.AddEGLConfig(mConfigs.back());
+    }
+}
+
 EGLBoolean
 DisplayDriver::GetConfigs(EGLConfig *configs, EGLint config_size, EGLint *num_config)
 {
     FUN_ENTRY(DEBUG_DEPTH);
 
-    int32_t count = 0;
-
     if(!num_config) {
         currentThread.RecordError(EGL_BAD_PARAMETER);
         return EGL_FALSE;
     }
 
     if(!configs) {
-        *num_config = ARRAY_SIZE(EglConfigs);
+        *num_config = static_cast<EGLint>(mConfigs.size());
         return EGL_TRUE;
     }
 
-    if(config_size > count) {
-        count = config_size < ARRAY_SIZE(EglConfigs) ? config_size : ARRAY_SIZE(EglConfigs);
-    }
-
+    const EGLint count = std::max(0, std::min(config_size, static_cast<EGLint>(mConfigs.size())));
+    std::copy(mConfigs.begin(), mConfigs.begin() + count, configs);
     *num_config = count;
 
-    // set configs and update the config list
-    for(int32_t i = 0; i < count; ++i) {
-        configs[i] = (EGLConfig)&EglConfigs[i];
-        mDisplayDriverResourceManager.AddEGLConfig((EGLConfig_t*)&EglConfigs[i]);
-    }
-
     return EGL_TRUE;
 }
 
@@ -209,25 +232,42 @@ DisplayDriver::ChooseConfig(const EGLint *attrib_list, EGLConfig *configs, EGLin
 {
     FUN_ENTRY(DEBUG_DEPTH);
 
-    EGLConfig_t criteria;
-    if(ParseConfigAttribList(&criteria, mEGLDisplay, attrib_list) == EGL_FALSE) {
-        currentThread.RecordError(EGL_BAD_ATTRIBUTE);
-        return EGL_FALSE;
+    // launchers choose the config of every window they open with the same attributes
+    std::vector<EGLint> attribs;
+    for(int32_t i = 0; attrib_list && attrib_list[i] != EGL_NONE; i += 2) {
+        attribs.push_back(attrib_list[i]);
+        attribs.push_back(attrib_list[i + 1]);
     }
 
-    if(FilterConfigArray(reinterpret_cast<EGLConfig_t **>(configs), config_size, num_config, &criteria) == EGL_FALSE) {
+    std::lock_guard<std::mutex> lock(mChosenConfigsMutex);
+
+    auto chosenConfigs = mChosenConfigs.find(attribs);
+    if(chosenConfigs == mChosenConfigs.end()) {
+        EGLConfig_t criteria;
+        if(ParseConfigAttribList(&criteria, mEGLDisplay, attrib_list) == EGL_FALSE) {
+            currentThread.RecordError(EGL_BAD_ATTRIBUTE);
+            return EGL_FALSE;
+        }
+
+        std::vector<EGLConfig_t *> matchedConfigs;
+        FilterConfigArray(&criteria, &matchedConfigs);
+        chosenConfigs = mChosenConfigs.insert(std::make_pair(attribs, matchedConfigs)).first;
+    }
+
+    if(!num_config) {
+        currentThread.RecordError(EGL_BAD_PARAMETER);
         return EGL_FALSE;
     }
 
-    if(configs == nullptr) {
+    const std::vector<EGLConfig_t *> &matchedConfigs = chosenConfigs->second;
+    if(!configs) {
+        *num_config = static_cast<EGLint>(matchedConfigs.size());
         return EGL_TRUE;
     }
 
-    // update the config list
-    EGLConfig_t** matchedConfigs = reinterpret_cast<EGLConfig_t **>(configs);
-    for (int i = 0; i < *num_config; ++i) {
-        mDisplayDriverResourceManager.AddEGLConfig(matchedConfigs[i]);
-    }
+    const EGLint count = std::max(0, std::min(config_size, static_cast<EGLint>(matchedConfigs.size())));
+    std::copy(matchedConfigs.begin(), matchedConfigs.begin() + count, configs);
+    *num_config = count;
 
     return EGL_TRUE;
 }
@@ -269,14 +309,18 @@ DisplayDriver::CreateWindowSurface(EGLConfig_t* eglConfig, EGLNativeWindowType w
     eglSurface->SetPlatformResources(platformResources);
 
     if(mWindowInterface->CreateSurface(mEGLDisplay, win, eglSurface) == EGL_FALSE) {
+        currentThread.RecordError(EGL_BAD_NATIVE_WINDOW);
         delete eglSurface;
         return EGL_NO_SURFACE;
     }
 
     mWindowInterface->AllocateSurfaceImages(eglSurface);
 
-    uint32_t imageNext = 0;
-    mWindowInterface->AcquireNextImage(eglSurface, &imageNext);
+    // with lazy acquisition, the first image is acquired on its first use too
+    if(!IsImageAcquireLazy()) {
+        uint32_t imageNext = 0;
+        mWindowInterface->AcquireNextImage(eglSurface, &imageNext);
+    }
 
     CreateEGLSurfaceInterface(eglSurface);
 
@@ -336,6 +380,8 @@ DisplayDriver::CreateEGLSurfaceInterface(EGLSurface_t *eglSurface)
     if(eglSurface->GetType() == EGL_WINDOW_BIT) {
         surfaceInterface->images            = eglSurface->GetPlatformSurfaceImages();
         surfaceInterface->imageCount        = eglSurface->GetPlatformSurfaceImageCount();
+        surfaceInterface->imageUsage        = eglSurface->GetPlatformSurfaceImageUsage();
+        surfaceInterface->preTransform      = eglSurface->GetPlatformSurfacePreTransform();
         surfaceInterface->depthBuffer       = 0;
         surfaceInterface->contextRef        = 0;
     }
@@ -344,8 +390,13 @@ DisplayDriver::CreateEGLSurfaceInterface(EGLSurface_t *eglSurface)
     surfaceInterface->height                = eglSurface->GetHeight();
     surfaceInterface->depthSize             = eglSurface->GetDepthSize();
     surfaceInterface->stencilSize           = eglSurface->GetStencilSize();
+    surfaceInterface->samples               = eglSurface->GetSamples();
     surfaceInterface->surfaceColorFormat    = eglSurface->GetColorFormat();
     surfaceInterface->nextImageIndex        = eglSurface->GetCurrentImageIndex();
+    if(IsImageAcquireLazy() && eglSurface->GetType() == EGL_WINDOW_BIT) {
+        surfaceInterface->acquireImageCb    = AcquireSurfaceImageCallback;
+        surfaceInterface->acquireImageData  = reinterpret_cast<void *>(this);
+    }
 }
 
 EGLBoolean
@@ -367,6 +418,22 @@ DisplayDriver::QuerySurface(EGLSurface_t* eglSurface, EGLint attribute, EGLint *
 {
     FUN_ENTRY(DEBUG_DEPTH);
 
+    // the age of the image the frame renders to, which is acquired for it if need be
+    if(attribute == EGL_BUFFER_AGE_KHR) {
+        if(currentThread.GetCurrentContext() == nullptr || mActiveContext->GetDrawSurface() != eglSurface) {
+            currentThread.RecordError(EGL_BAD_SURFACE);
+            return EGL_FALSE;
+        }
+
+        if(eglSurface->GetType() == EGL_WINDOW_BIT && eglSurface->GetEGLSurfaceInterface()->acquireImageCb &&
+           !eglSurface->GetEGLSurfaceInterface()->imageAcquired) {
+            AcquireSurfaceImage(eglSurface);
+        }
+
+        *value = eglSurface->GetType() == EGL_WINDOW_BIT ? eglSurface->GetBufferAge() : 0;
+        return EGL_TRUE;
+    }
+
     if(eglSurface->QuerySurface(attribute, value) == EGL_FALSE) {
         currentThread.RecordError(EGL_BAD_ATTRIBUTE);
         return EGL_FALSE;
@@ -449,9 +516,9 @@ DisplayDriver::BindTexImage(EGLSurface_t* eglSurface, EGLint buffer)
 
     //TODO: We are assuming that the BindTexImage refers to the surface that is currently active for GLOVE.
     //If we have multiple surfaces for GLES, additional information may need to be passed to GLOVE.
+    //If display and surface are the display and surface for the calling thread's current context, eglBindTexImage performs an implicit glFlush,
+    //which the binding submits along with the transition of the image to be sampled, without waiting for the rendering to complete
     mActiveContext->BindToTexture(EGL_TRUE);
-    //If display and surface are the display and surface for the calling thread's current context, eglBindTexImage performs an implicit glFlush
-    mActiveContext->Finish();
 
     return EGL_TRUE;
 }
@@ -503,9 +570,15 @@ DisplayDriver::SwapInterval(EGLint interval)
 
 
 EGLBoolean
-DisplayDriver::SwapBuffers(EGLSurface_t* eglSurface)
+DisplayDriver::SwapBuffers(EGLSurface_t* eglSurface, const EGLint *rects, EGLint rectCount)
 {
     FUN_ENTRY(DEBUG_DEPTH);
+    GLOVE_PROFILE_ZONE("DisplayDriver::SwapBuffers");
+
+    if(rectCount < 0 || (rectCount > 0 && rects == nullptr)) {
+        currentThread.RecordError(EGL_BAD_PARAMETER);
+        return EGL_FALSE;
+    }
 
     if(eglSurface->GetType() != EGL_WINDOW_BIT) {
         return EGL_TRUE;
@@ -515,20 +588,85 @@ DisplayDriver::SwapBuffers(EGLSurface_t* eglSurface)
         return EGL_TRUE;
     }
 
-    mActiveContext->Finish();
+    // submits the frame without waiting for the GPU to complete it
+    mActiveContext->PrepareSwapBuffers();
+
+    // nothing may have been rendered to a lazily acquired surface, yet an image has to be presented
+    if(eglSurface->GetEGLSurfaceInterface()->acquireImageCb && !eglSurface->GetEGLSurfaceInterface()->imageAcquired) {
+        AcquireSurfaceImage(eglSurface);
+    }
 
-    if(mWindowInterface->PresentImage(eglSurface) == EGL_FALSE) {
+    // a present thread acquires the next image as well, which is then collected at its first use
+    EGLBoolean presented = mWindowInterface->QueuePresentImage(eglSurface, rects, rectCount);
+    eglSurface->EndFrame();
+    if(presented == EGL_FALSE) {
         UpdateSurface(eglSurface);
     }
 
+    if(IsImageAcquireLazy()) {
+        eglSurface->GetEGLSurfaceInterface()->imageAcquired = 0;
+    } else {
+        AcquireSurfaceImage(eglSurface);
+    }
+
+    GLOVE_PROFILE_FRAME();
+
+    return EGL_TRUE;
+}
+
+EGLBoolean
+DisplayDriver::SetDamageRegion(EGLSurface_t* eglSurface, const EGLint *rects, EGLint rectCount)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    if(currentThread.GetCurrentContext() == nullptr || mActiveContext->GetDrawSurface() != eglSurface) {
+        currentThread.RecordError(EGL_BAD_SURFACE);
+        return EGL_FALSE;
+    }
+
+    // the rest of a preserved surface would have to be copied from the previous frame
+    if(eglSurface->GetType() != EGL_WINDOW_BIT || eglSurface->GetSwapBehavior() == EGL_BUFFER_PRESERVED) {
+        currentThread.RecordError(EGL_BAD_MATCH);
+        return EGL_FALSE;
+    }
+
+    // once per frame, after the age of the buffer has told the application what to redraw
+    if(eglSurface->IsDamageRegionSet() || !eglSurface->IsBufferAgeQueried()) {
+        currentThread.RecordError(EGL_BAD_ACCESS);
+        return EGL_FALSE;
+    }
+
+    if(rectCount < 0 || (rectCount > 0 && rects == nullptr)) {
+        currentThread.RecordError(EGL_BAD_PARAMETER);
+        return EGL_FALSE;
+    }
+
+    eglSurface->SetDamageRegion(rects, rectCount);
+
+    return EGL_TRUE;
+}
+
+void
+DisplayDriver::AcquireSurfaceImage(EGLSurface_t* eglSurface)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
     uint32_t imageIndex;
     while(mWindowInterface->AcquireNextImage(eglSurface, &imageIndex) == EGL_FALSE) {
         UpdateSurface(eglSurface);
     }
 
     eglSurface->GetEGLSurfaceInterface()->nextImageIndex = imageIndex;
+    eglSurface->GetEGLSurfaceInterface()->imageAcquired  = 1;
+}
 
-    return EGL_TRUE;
+void
+DisplayDriver::AcquireSurfaceImageCallback(void *acquireImageData, void *surface)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    DisplayDriver *displayDriver = reinterpret_cast<DisplayDriver *>(acquireImageData);
+    displayDriver->AcquireSurfaceImage(reinterpret_cast<EGLSurface_t *>(surface));
 }
 
 void
@@ -539,10 +677,11 @@ DisplayDriver::UpdateSurface(EGLSurface_t* eglSurface)
     assert(mActiveContext != nullptr);
     assert(mWindowInterface != nullptr);
 
-    mActiveContext->ReleaseSurfaceResources();
-    mWindowInterface->DestroySurfaceImages(eglSurface);
-    mWindowInterface->AllocateSurfaceImages(eglSurface);
+    // the old surface images are released once the frames in flight have completed, without stalling the device
+    mActiveContext->RetireSurfaceResources();
+    mWindowInterface->RecreateSurfaceImages(eglSurface);
     CreateEGLSurfaceInterface(eglSurface);
+    eglSurface->ResetBufferAge();
     mActiveContext->MakeCurrent(mEGLDisplay, eglSurface, eglSurface);
 }
 
@@ -604,6 +743,96 @@ DisplayDriver::CreateImageNativeBufferAndroid(EGLContext ctx, EGLenum target, EG
 #endif
 }
 
+/// the single plane formats the rendering API imports, sampled as RGBA, RGB or 565
+static const EGLint dmaBufFormats[] = { API_DMA_BUF_FORMAT_ABGR8888, API_DMA_BUF_FORMAT_XBGR8888,
+                                        API_DMA_BUF_FORMAT_ARGB8888, API_DMA_BUF_FORMAT_XRGB8888,
+                                        API_DMA_BUF_FORMAT_RGB565 };
+
+EGLImageKHR
+DisplayDriver::CreateImageDmaBuf(EGLContext ctx, EGLClientBuffer buffer, const EGLint *attrib_list)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+#ifdef __linux__
+    if(ctx != EGL_NO_CONTEXT || buffer != nullptr || attrib_list == nullptr) {
+        currentThread.RecordError(EGL_BAD_PARAMETER);
+        return EGL_NO_IMAGE_KHR;
+    }
+
+    api_dma_buf_image_t dmaBuf;
+    memset(static_cast<void *>(&dmaBuf), 0, sizeof(dmaBuf));
+    dmaBuf.fd       = -1;
+    dmaBuf.modifier = API_DMA_BUF_MODIFIER_LINEAR;
+
+    EGLint width = -1, height = -1, offset = -1, pitch = -1;
+    bool hasFourcc = false, hasModifierLo = false, hasModifierHi = false;
+    uint32_t modifierLo = 0, modifierHi = 0;
+    for(const EGLint *attrib = attrib_list; attrib[0] != EGL_NONE; attrib += 2) {
+        switch(attrib[0]) {
+        case EGL_WIDTH:                          width  = attrib[1]; break;
+        case EGL_HEIGHT:                         height = attrib[1]; break;
+        case EGL_LINUX_DRM_FOURCC_EXT:           dmaBuf.fourcc = static_cast<uint32_t>(attrib[1]); hasFourcc = true; break;
+        case EGL_DMA_BUF_PLANE0_FD_EXT:          dmaBuf.fd = attrib[1]; break;
+        case EGL_DMA_BUF_PLANE0_OFFSET_EXT:      offset = attrib[1]; break;
+        case EGL_DMA_BUF_PLANE0_PITCH_EXT:       pitch  = attrib[1]; break;
+        case EGL_DMA_BUF_PLANE0_MODIFIER_LO_EXT: modifierLo = static_cast<uint32_t>(attrib[1]); hasModifierLo = true; break;
+        case EGL_DMA_BUF_PLANE0_MODIFIER_HI_EXT: modifierHi = static_cast<uint32_t>(attrib[1]); hasModifierHi = true; break;
+        // the hints only concern YUV formats
+        case EGL_YUV_COLOR_SPACE_HINT_EXT:
+        case EGL_SAMPLE_RANGE_HINT_EXT:
+        case EGL_YUV_CHROMA_HORIZONTAL_SITING_HINT_EXT:
+        case EGL_YUV_CHROMA_VERTICAL_SITING_HINT_EXT:
+            break;
+        // the formats have a single plane
+        case EGL_DMA_BUF_PLANE1_FD_EXT:          case EGL_DMA_BUF_PLANE1_OFFSET_EXT:      case EGL_DMA_BUF_PLANE1_PITCH_EXT:
+        case EGL_DMA_BUF_PLANE2_FD_EXT:          case EGL_DMA_BUF_PLANE2_OFFSET_EXT:      case EGL_DMA_BUF_PLANE2_PITCH_EXT:
+        case EGL_DMA_BUF_PLANE3_FD_EXT:          case EGL_DMA_BUF_PLANE3_OFFSET_EXT:      case EGL_DMA_BUF_PLANE3_PITCH_EXT:
+        case EGL_DMA_BUF_PLANE1_MODIFIER_LO_EXT: case EGL_DMA_BUF_PLANE1_MODIFIER_HI_EXT:
+        case EGL_DMA_BUF_PLANE2_MODIFIER_LO_EXT: case EGL_DMA_BUF_PLANE2_MODIFIER_HI_EXT:
+        case EGL_DMA_BUF_PLANE3_MODIFIER_LO_EXT: case EGL_DMA_BUF_PLANE3_MODIFIER_HI_EXT:
+            currentThread.RecordError(EGL_BAD_ATTRIBUTE);
+            return EGL_NO_IMAGE_KHR;
+        default:
+            currentThread.RecordError(EGL_BAD_PARAMETER);
+            return EGL_NO_IMAGE_KHR;
+        }
+    }
+
+    if(width <= 0 || height <= 0 || offset < 0 || pitch <= 0 || dmaBuf.fd < 0 || !hasFourcc || hasModifierLo != hasModifierHi) {
+        currentThread.RecordError(EGL_BAD_PARAMETER);
+        return EGL_NO_IMAGE_KHR;
+    }
+
+    if(std::find(std::begin(dmaBufFormats), std::end(dmaBufFormats), static_cast<EGLint>(dmaBuf.fourcc)) == std::end(dmaBufFormats)) {
+        currentThread.RecordError(EGL_BAD_MATCH);
+        return EGL_NO_IMAGE_KHR;
+    }
+
+    dmaBuf.width  = static_cast<uint32_t>(width);
+    dmaBuf.height = static_cast<uint32_t>(height);
+    dmaBuf.offset = static_cast<uint32_t>(offset);
+    dmaBuf.pitch  = static_cast<uint32_t>(pitch);
+    if(hasModifierLo) {
+        dmaBuf.modifier = (static_cast<uint64_t>(modifierHi) << 32) | modifierLo;
+    }
+
+    EGLImage_t *eglImage = mDisplayDriverResourceManager.AddEGLImage(dmaBuf);
+    if(eglImage == nullptr) {
+        currentThread.RecordError(EGL_BAD_ALLOC);
+        return EGL_NO_IMAGE_KHR;
+    }
+
+    return eglImage->GetHandle();
+#else
+    (void)ctx;
+    (void)buffer;
+    (void)attrib_list;
+
+    currentThread.RecordError(EGL_BAD_PARAMETER);
+    return EGL_NO_IMAGE_KHR;
+#endif // __linux__
+}
+
 EGLImageKHR
 DisplayDriver::CreateImageKHR(EGLContext ctx, EGLenum target, EGLClientBuffer buffer, const EGLint *attrib_list)
 {
@@ -612,6 +841,8 @@ DisplayDriver::CreateImageKHR(EGLContext ctx, EGLenum target, EGLClientBuffer bu
     switch(target) {
         case EGL_NATIVE_BUFFER_ANDROID:
             return CreateImageNativeBufferAndroid(ctx, target, buffer, attrib_list);
+        case EGL_LINUX_DMA_BUF_EXT:
+            return CreateImageDmaBuf(ctx, buffer, attrib_list);
         case EGL_GL_TEXTURE_2D_KHR:
         case EGL_GL_TEXTURE_CUBE_MAP_POSITIVE_X_KHR:
         case EGL_GL_TEXTURE_CUBE_MAP_NEGATIVE_X_KHR:
@@ -635,6 +866,12 @@ DisplayDriver::DestroyImageKHR(EGLImageKHR image)
 {
     FUN_ENTRY(DEBUG_DEPTH);
 
+#ifdef __linux__
+    if(mDisplayDriverResourceManager.RemoveEGLImage(image) == EGL_TRUE) {
+        return EGL_TRUE;
+    }
+#endif // __linux__
+
 #ifdef VK_USE_PLATFORM_ANDROID_KHR
     if(dpy == EGL_NO_DISPLAY) {
         currentThread.RecordError(EGL_BAD_DISPLAY);
@@ -660,8 +897,26 @@ EGLSyncKHR
 DisplayDriver::CreateSyncKHR(EGLenum type, const EGLint *attrib_list)
 {
     FUN_ENTRY(EGL_LOG_TRACE);
-    uintptr_t sync = 0xFE4CE000;
-    return ((EGLSyncKHR)sync);
+
+    if(type != EGL_SYNC_FENCE_KHR || (attrib_list != nullptr && attrib_list[0] != EGL_NONE)) {
+        currentThread.RecordError(EGL_BAD_ATTRIBUTE);
+        return EGL_NO_SYNC_KHR;
+    }
+
+    EGLContext_t *eglContext = currentThread.GetCurrentContext();
+    if(eglContext == nullptr || eglContext->GetRenderingAPI() != EGL_OPENGL_ES_API || eglContext->GetDisplay() != mEGLDisplay) {
+        currentThread.RecordError(EGL_BAD_MATCH);
+        return EGL_NO_SYNC_KHR;
+    }
+
+    // the commands issued so far are flushed when the fence is inserted
+    EGLSync_t *eglSync = mDisplayDriverResourceManager.AddEGLSync(eglContext);
+    if(eglSync == nullptr) {
+        currentThread.RecordError(EGL_BAD_ALLOC);
+        return EGL_NO_SYNC_KHR;
+    }
+
+    return static_cast<EGLSyncKHR>(eglSync);
 }
 
 EGLBoolean
@@ -669,6 +924,11 @@ DisplayDriver::DestroySyncKHR(EGLSyncKHR sync)
 {
     FUN_ENTRY(EGL_LOG_TRACE);
 
+    if(mDisplayDriverResourceManager.RemoveEGLSync(static_cast<EGLSync_t *>(sync)) == EGL_FALSE) {
+        currentThread.RecordError(EGL_BAD_PARAMETER);
+        return EGL_FALSE;
+    }
+
     return EGL_TRUE;
 }
 
@@ -677,12 +937,100 @@ DisplayDriver::ClientWaitSyncKHR(EGLSyncKHR sync, EGLint flags, EGLTimeKHR timeo
 {
     FUN_ENTRY(EGL_LOG_TRACE);
 
-    return EGL_CONDITION_SATISFIED_KHR;
+    (void)flags;
+
+    EGLSync_t *eglSync = mDisplayDriverResourceManager.FindEGLSync(sync);
+    if(eglSync == nullptr) {
+        currentThread.RecordError(EGL_BAD_PARAMETER);
+        return EGL_FALSE;
+    }
+
+    switch(eglSync->ClientWait(timeout)) {
+        case API_SYNC_SIGNALED:         return EGL_CONDITION_SATISFIED_KHR;
+        case API_SYNC_TIMEOUT_EXPIRED:  return EGL_TIMEOUT_EXPIRED_KHR;
+        default:                        return EGL_FALSE;
+    }
+}
+
+EGLint
+DisplayDriver::WaitSyncKHR(EGLSyncKHR sync, EGLint flags)
+{
+    FUN_ENTRY(EGL_LOG_TRACE);
+
+    EGLSync_t *eglSync = mDisplayDriverResourceManager.FindEGLSync(sync);
+    if(eglSync == nullptr || flags != 0) {
+        currentThread.RecordError(EGL_BAD_PARAMETER);
+        return EGL_FALSE;
+    }
+
+    EGLContext_t *eglContext = currentThread.GetCurrentContext();
+    if(eglContext == nullptr || eglContext->GetRenderingAPI() != EGL_OPENGL_ES_API || eglContext->GetDisplay() != mEGLDisplay) {
+        currentThread.RecordError(EGL_BAD_MATCH);
+        return EGL_FALSE;
+    }
+
+    // the current context waits on the device, e.g., for the uploads of a loader context of its share group
+    eglSync->ServerWait(eglContext->GetAPIContext());
+
+    return EGL_TRUE;
+}
+
+EGLBoolean
+DisplayDriver::QueryDmaBufFormatsEXT(EGLint max_formats, EGLint *formats, EGLint *num_formats)
+{
+    FUN_ENTRY(EGL_LOG_TRACE);
+
+    const EGLint count = static_cast<EGLint>(sizeof(dmaBufFormats) / sizeof(dmaBufFormats[0]));
+    if(num_formats == nullptr || max_formats < 0 || (max_formats > 0 && formats == nullptr)) {
+        currentThread.RecordError(EGL_BAD_PARAMETER);
+        return EGL_FALSE;
+    }
+
+    *num_formats = max_formats ? std::min(max_formats, count) : count;
+    for(EGLint i = 0; i < max_formats && i < count; ++i) {
+        formats[i] = dmaBufFormats[i];
+    }
+
+    return EGL_TRUE;
+}
+
+EGLBoolean
+DisplayDriver::QueryDmaBufModifiersEXT(EGLint format, EGLint max_modifiers, EGLuint64KHR *modifiers, EGLBoolean *external_only, EGLint *num_modifiers)
+{
+    FUN_ENTRY(EGL_LOG_TRACE);
+
+    if(num_modifiers == nullptr || max_modifiers < 0 || (max_modifiers > 0 && modifiers == nullptr)) {
+        currentThread.RecordError(EGL_BAD_PARAMETER);
+        return EGL_FALSE;
+    }
+
+    if(std::find(std::begin(dmaBufFormats), std::end(dmaBufFormats), format) == std::end(dmaBufFormats)) {
+        currentThread.RecordError(EGL_BAD_PARAMETER);
+        return EGL_FALSE;
+    }
+
+    // other modifiers are imported as given, the linear layout is the one every device takes
+    *num_modifiers = 1;
+    if(max_modifiers > 0) {
+        modifiers[0] = API_DMA_BUF_MODIFIER_LINEAR;
+        if(external_only != nullptr) {
+            external_only[0] = EGL_FALSE;
+        }
+    }
+
+    return EGL_TRUE;
 }
 
 const char *DisplayDriver::GetExtensions()
 {
-    return "";
+#ifdef __linux__
+    return "EGL_KHR_fence_sync EGL_KHR_wait_sync EGL_KHR_surfaceless_context EGL_KHR_create_context_no_error EGL_IMG_context_priority "
+           "EGL_EXT_buffer_age EGL_KHR_partial_update EGL_KHR_swap_buffers_with_damage EGL_EXT_swap_buffers_with_damage "
+           "EGL_KHR_image_base EGL_EXT_image_dma_buf_import EGL_EXT_image_dma_buf_import_modifiers";
+#else
+    return "EGL_KHR_fence_sync EGL_KHR_wait_sync EGL_KHR_surfaceless_context EGL_KHR_create_context_no_error EGL_IMG_context_priority "
+           "EGL_EXT_buffer_age EGL_KHR_partial_update EGL_KHR_swap_buffers_with_damage EGL_EXT_swap_buffers_with_damage";
+#endif // __linux__
 }
 
 EGLBoolean
@@ -34,6 +34,8 @@
 #include "platform/platformWindowInterface.h"
 #include "api/eglDisplay.h"
 #include "displayDriverResourceManager.h"
+#include <map>
+#include <mutex>
 #include <vector>
 
 #ifdef DEBUG_DEPTH
@@ -41,8 +43,6 @@
 #endif // DEBUG_DEPTH
 #define DEBUG_DEPTH                                 EGL_LOG_DEBUG
 
-void setCallingThread(RenderingThread *thread);
-
 class DisplayDriver {
 private:
     EGLDisplay_t                *mEGLDisplay;
@@ -50,10 +50,21 @@ private:
     PlatformWindowInterface     *mWindowInterface;
     DisplayDriverResourceManager mDisplayDriverResourceManager;
     bool                         mInitialized;
+    /// configs of the display, set up once by eglInitialize
+    std::vector<EGLConfig_t *>   mConfigs;
+    /// sorted configs matching each attribute list eglChooseConfig has been called with
+    std::map<std::vector<EGLint>, std::vector<EGLConfig_t *>> mChosenConfigs;
+    std::mutex                   mChosenConfigsMutex;
+
+    void                         InitConfigs(void);
 
     EGLImageKHR                  CreateImageNativeBufferAndroid(EGLContext ctx, EGLenum target, EGLClientBuffer buffer, const EGLint *attrib_list);
+    EGLImageKHR                  CreateImageDmaBuf(EGLContext ctx, EGLClientBuffer buffer, const EGLint *attrib_list);
     void                         CreateEGLSurfaceInterface(EGLSurface_t *eglSurface);
     void                         UpdateSurface(EGLSurface_t *eglSurface);
+    void                         AcquireSurfaceImage(EGLSurface_t *eglSurface);
+    static void                  AcquireSurfaceImageCallback(void *acquireImageData, void *surface);
+    inline bool                  IsImageAcquireLazy(void)                 const { FUN_ENTRY(EGL_LOG_TRACE); return EGL_LAZY_IMAGE_ACQUIRE || mWindowInterface->IsPresentAsync() == EGL_TRUE; }
 
 public:
 
@@ -73,7 +84,7 @@ public:
     /// EGL API core functions
     EGLBoolean                   Initialize(EGLint *major, EGLint *minor);
     EGLBoolean                   Terminate(void);
-    EGLContext                   CreateContext(EGLenum rendering_api, EGLConfig_t *config, const EGLint *attribList);
+    EGLContext                   CreateContext(EGLenum rendering_api, EGLConfig_t *config, EGLContext_t *shareContext, const EGLint *attribList);
     EGLBoolean                   DestroyContext(EGLContext_t *eglContext);
     EGLBoolean                   GetConfigs(EGLConfig *configs, EGLint config_size, EGLint *num_config);
     EGLBoolean                   ChooseConfig(const EGLint *attrib_list, EGLConfig *configs, EGLint config_size, EGLint *num_config);
@@ -88,7 +99,8 @@ public:
     EGLBoolean                   BindTexImage(EGLSurface_t* eglSurface, EGLint buffer);
     EGLBoolean                   ReleaseTexImage(EGLSurface_t* eglSurface, EGLint buffer);
     EGLBoolean                   SwapInterval(EGLint interval);
-    EGLBoolean                   SwapBuffers(EGLSurface_t* eglSurface);
+    EGLBoolean                   SwapBuffers(EGLSurface_t* eglSurface, const EGLint *rects = nullptr, EGLint rectCount = 0);
+    EGLBoolean                   SetDamageRegion(EGLSurface_t* eglSurface, const EGLint *rects, EGLint rectCount);
     EGLBoolean                   CopyBuffers(EGLSurface_t* eglSurface, EGLNativePixmapType target);
     const char*                  GetExtensions();
 
@@ -98,6 +110,9 @@ public:
     EGLSyncKHR                   CreateSyncKHR(EGLenum type, const EGLint *attrib_list);
     EGLBoolean                   DestroySyncKHR(EGLSyncKHR sync);
     EGLint                       ClientWaitSyncKHR(EGLSyncKHR sync, EGLint flags, EGLTimeKHR timeout);
+    EGLint                       WaitSyncKHR(EGLSyncKHR sync, EGLint flags);
+    EGLBoolean                   QueryDmaBufFormatsEXT(EGLint max_formats, EGLint *formats, EGLint *num_formats);
+    EGLBoolean                   QueryDmaBufModifiersEXT(EGLint format, EGLint max_modifiers, EGLuint64KHR *modifiers, EGLBoolean *external_only, EGLint *num_modifiers);
 };
 
 #endif // __DISPLAY_DRIVER_H__
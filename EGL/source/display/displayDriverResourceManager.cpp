@@ -129,11 +129,11 @@ DisplayDriverResourceManager::FindEGLContext(const EGLContext_t* eglContext) con
 }
 
 EGLContext_t*
-DisplayDriverResourceManager::CreateEGLContext(EGLDisplay_t *display, EGLenum rendering_api, EGLConfig_t *config, const EGLint *attribList)
+DisplayDriverResourceManager::CreateEGLContext(EGLDisplay_t *display, EGLenum rendering_api, EGLConfig_t *config, EGLContext_t *shareContext, const EGLint *attribList)
 {
     FUN_ENTRY(DEBUG_DEPTH);
 
-    EGLContext_t * eglContext = new EGLContext_t(display, rendering_api, config, attribList);
+    EGLContext_t * eglContext = new EGLContext_t(display, rendering_api, config, shareContext, attribList);
 
     if(eglContext->Create() == EGL_FALSE) {
         delete eglContext;
@@ -156,11 +156,11 @@ DisplayDriverResourceManager::DeleteEGLContext(EGLContext_t* eglContext)
 }
 
 EGLContext_t*
-DisplayDriverResourceManager::AddEGLContext(EGLDisplay_t *display, EGLenum rendering_api, EGLConfig_t *config, const EGLint *attribList)
+DisplayDriverResourceManager::AddEGLContext(EGLDisplay_t *display, EGLenum rendering_api, EGLConfig_t *config, EGLContext_t *shareContext, const EGLint *attribList)
 {
     FUN_ENTRY(DEBUG_DEPTH);
 
-    EGLContext_t *eglContext = CreateEGLContext(display, rendering_api, config, attribList);
+    EGLContext_t *eglContext = CreateEGLContext(display, rendering_api, config, shareContext, attribList);
 
     if(eglContext) {
         mContextList.push_back(eglContext);
@@ -182,6 +182,81 @@ DisplayDriverResourceManager::RemoveEGLContext(EGLContext_t* eglContext)
     return EGL_FALSE;
 }
 
+EGLSync_t*
+DisplayDriverResourceManager::AddEGLSync(EGLContext_t *eglContext)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    api_sync_t apiSync = eglContext->CreateSync();
+    if(apiSync == nullptr) {
+        return nullptr;
+    }
+
+    EGLSync_t *eglSync = new EGLSync_t(eglContext->GetAPIInterface(), apiSync);
+    mSyncList.push_back(eglSync);
+
+    return eglSync;
+}
+
+EGLBoolean
+DisplayDriverResourceManager::RemoveEGLSync(EGLSync_t* eglSync)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    const auto iter = std::find(mSyncList.begin(), mSyncList.end(), eglSync);
+    if(iter != mSyncList.end()) {
+        mSyncList.erase(iter);
+        delete eglSync;
+        return EGL_TRUE;
+    }
+    return EGL_FALSE;
+}
+
+EGLSync_t*
+DisplayDriverResourceManager::FindEGLSync(EGLSyncKHR sync) const
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    const auto iter = std::find(mSyncList.begin(), mSyncList.end(), static_cast<EGLSync_t*>(sync));
+    if(iter == mSyncList.end()) {
+        return nullptr;
+    }
+    return *iter;
+}
+
+#ifdef __linux__
+EGLImage_t*
+DisplayDriverResourceManager::AddEGLImage(const api_dma_buf_image_t &dmaBuf)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    EGLImage_t *eglImage = new EGLImage_t(dmaBuf);
+    if(!eglImage->IsValid()) {
+        delete eglImage;
+        return nullptr;
+    }
+
+    mImageList.push_back(eglImage);
+
+    return eglImage;
+}
+
+EGLBoolean
+DisplayDriverResourceManager::RemoveEGLImage(EGLImageKHR image)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    const auto iter = std::find_if(mImageList.begin(), mImageList.end(),
+                                   [image](EGLImage_t *eglImage) { return eglImage->GetHandle() == image; });
+    if(iter != mImageList.end()) {
+        delete *iter;
+        mImageList.erase(iter);
+        return EGL_TRUE;
+    }
+    return EGL_FALSE;
+}
+#endif // __linux__
+
 void
 DisplayDriverResourceManager::CleanMarkedResources(PlatformWindowInterface *windowInterface)
 {
@@ -223,6 +298,20 @@ DisplayDriverResourceManager::CleanResources(PlatformWindowInterface *windowInte
     }
     mSurfaceList.clear();
 
+    // clear sync objects
+    for (auto syncIter : mSyncList) {
+        delete syncIter;
+    }
+    mSyncList.clear();
+
+#ifdef __linux__
+    // clear images, the textures they are bound to hold their own import
+    for (auto imageIter : mImageList) {
+        delete imageIter;
+    }
+    mImageList.clear();
+#endif // __linux__
+
     // clear surfaces
     for (auto contextIter : mContextList) {
         DeleteEGLContext(contextIter);
@@ -29,6 +29,8 @@
 #include "api/eglContext.h"
 #include "api/eglConfig.h"
 #include "api/eglSurface.h"
+#include "api/eglSync.h"
+#include "api/eglImage.h"
 #include "vector"
 
 class DisplayDriverResourceManager
@@ -38,9 +40,13 @@ protected:
     std::vector<EGLSurface_t*>   mSurfaceList;
     std::vector<EGLConfig_t*>    mConfigList;
     std::vector<EGLContext_t*>   mContextList;
+    std::vector<EGLSync_t*>      mSyncList;
+#ifdef __linux__
+    std::vector<EGLImage_t*>     mImageList;
+#endif // __linux__
 
     // EGLContext resources
-    EGLContext_t                *CreateEGLContext(EGLDisplay_t *display, EGLenum rendering_api, EGLConfig_t *config, const EGLint *attribList);
+    EGLContext_t                *CreateEGLContext(EGLDisplay_t *display, EGLenum rendering_api, EGLConfig_t *config, EGLContext_t *shareContext, const EGLint *attribList);
     EGLBoolean                   DeleteEGLContext(EGLContext_t* eglContext);
 
     // EGLSurface resources
@@ -61,10 +67,21 @@ public:
     EGLBoolean                   FindEGLSurface(const EGLSurface_t* eglSurface) const;
 
     // EGLContext resources
-    EGLContext_t                *AddEGLContext(EGLDisplay_t *display, EGLenum rendering_api, EGLConfig_t *config, const EGLint *attribList);
+    EGLContext_t                *AddEGLContext(EGLDisplay_t *display, EGLenum rendering_api, EGLConfig_t *config, EGLContext_t *shareContext, const EGLint *attribList);
     EGLBoolean                   RemoveEGLContext(EGLContext_t* eglContext);
     EGLBoolean                   FindEGLContext(const EGLContext_t* eglContext) const;
 
+    // EGLSync resources
+    EGLSync_t                   *AddEGLSync(EGLContext_t *eglContext);
+    EGLBoolean                   RemoveEGLSync(EGLSync_t* eglSync);
+    EGLSync_t                   *FindEGLSync(EGLSyncKHR sync) const;
+
+#ifdef __linux__
+    // EGLImage resources
+    EGLImage_t                  *AddEGLImage(const api_dma_buf_image_t &dmaBuf);
+    EGLBoolean                   RemoveEGLImage(EGLImageKHR image);
+#endif // __linux__
+
     void                         CleanResources(class PlatformWindowInterface *windowInterface);
     void                         CleanMarkedResources(class PlatformWindowInterface *windowInterface);
 
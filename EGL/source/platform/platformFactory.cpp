@@ -44,6 +44,8 @@
 #include "platform/vulkan/WSIWindows.h"
 #endif // VK_USE_PLATFORM_WIN32_KHR
 
+#include <cstdlib>
+
 PlatformFactory *PlatformFactory::mInstance = nullptr;
 
 PlatformFactory::PlatformFactory()
@@ -87,6 +89,12 @@ PlatformFactory::ChoosePlatform()
 
     PlatformFactory *platformFactory = PlatformFactory::GetInstance();
 
+    // fullscreen on a display plane, bypassing the compositor of the windowing system
+    if(getenv(EGL_DIRECT_DISPLAY_ENV)) {
+        platformFactory->SetPlatformType(PlatformFactory::WSI_PLANE_DISPLAY);
+        return;
+    }
+
 #ifdef VK_USE_PLATFORM_XCB_KHR
     platformFactory->SetPlatformType(PlatformFactory::WSI_XCB);
     return;
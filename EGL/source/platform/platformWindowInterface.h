@@ -41,9 +41,14 @@ public:
     virtual EGLBoolean           CreateSurface(EGLDisplay_t* dpy, EGLNativeWindowType win, EGLSurface_t *surface) = 0;
     virtual void                 AllocateSurfaceImages(EGLSurface_t *surface) = 0;
     virtual void                 DestroySurfaceImages(EGLSurface_t *eglSurface) = 0;
+    virtual void                 RecreateSurfaceImages(EGLSurface_t *eglSurface) = 0;
     virtual void                 DestroySurface(EGLSurface_t *eglSurface) = 0;
     virtual EGLBoolean           AcquireNextImage(EGLSurface_t *surface, uint32_t *imageIndex) = 0;
-    virtual EGLBoolean           PresentImage(EGLSurface_t *eglSurface) = 0;
+    /// rects are the damaged regions of the frame (EGL_KHR_swap_buffers_with_damage), with a bottom-left origin
+    virtual EGLBoolean           PresentImage(EGLSurface_t *eglSurface, const EGLint *rects, EGLint rectCount) = 0;
+    /// presents on a thread of the platform when IsPresentAsync, which also acquires the next image for AcquireNextImage to collect
+    virtual EGLBoolean           QueuePresentImage(EGLSurface_t *eglSurface, const EGLint *rects, EGLint rectCount) { return PresentImage(eglSurface, rects, rectCount); }
+    virtual EGLBoolean           IsPresentAsync(void) const { return EGL_FALSE; }
 };
 
 #endif // __PLATFORM_WINDOW_INTERFACE_H__
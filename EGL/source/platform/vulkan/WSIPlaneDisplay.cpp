@@ -19,10 +19,30 @@
  *
  *  @brief      WSI Plane Display module. It gets Plane Display VkSurface.
  *
+ *  @section
+ *
+ *  Surfaces are shown fullscreen on a display plane, without a compositor.
+ *  The display, its mode and the plane are picked through the
+ *  GLOVE_DISPLAY_INDEX, GLOVE_DISPLAY_MODE ("WxH" or "WxH@Hz") and
+ *  GLOVE_DISPLAY_PLANE environment variables. By default the first display
+ *  is used, in the mode of its native resolution with the highest refresh
+ *  rate, on the first plane that can show it and is not in use by another
+ *  display.
+ *
  */
 
 #include "WSIPlaneDisplay.h"
 #include "vulkanResources.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+static uint32_t
+GetEnvIndex(const char *name, uint32_t defaultIndex)
+{
+    const char *value = getenv(name);
+    return value ? static_cast<uint32_t>(strtoul(value, nullptr, 10)) : defaultIndex;
+}
 
 EGLBoolean
 WSIPlaneDisplay::Initialize()
@@ -52,10 +72,139 @@ WSIPlaneDisplay::SetPlatformCallbacks(void)
     // VK_KHR_display functions
     GET_WSI_FUNCTION_PTR(mWsiPlaneDisplayCallbacks, CreateDisplayPlaneSurfaceKHR);
     GET_WSI_FUNCTION_PTR(mWsiPlaneDisplayCallbacks, GetPhysicalDeviceDisplayPropertiesKHR);
+    GET_WSI_FUNCTION_PTR(mWsiPlaneDisplayCallbacks, GetPhysicalDeviceDisplayPlanePropertiesKHR);
+    GET_WSI_FUNCTION_PTR(mWsiPlaneDisplayCallbacks, GetDisplayPlaneSupportedDisplaysKHR);
+    GET_WSI_FUNCTION_PTR(mWsiPlaneDisplayCallbacks, GetDisplayModePropertiesKHR);
+    GET_WSI_FUNCTION_PTR(mWsiPlaneDisplayCallbacks, GetDisplayPlaneCapabilitiesKHR);
+
+    return EGL_TRUE;
+}
+
+EGLBoolean
+WSIPlaneDisplay::ChooseDisplayMode(const VkDisplayPropertiesKHR &displayProperties)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    VkPhysicalDevice gpu = mVkInterface->vkGpus[0];
+    uint32_t modeCount = 0;
+    if(mWsiPlaneDisplayCallbacks.fpGetDisplayModePropertiesKHR(gpu, displayProperties.display, &modeCount, nullptr) != VK_SUCCESS || !modeCount) {
+        return EGL_FALSE;
+    }
+
+    std::vector<VkDisplayModePropertiesKHR> modes(modeCount);
+    if(mWsiPlaneDisplayCallbacks.fpGetDisplayModePropertiesKHR(gpu, displayProperties.display, &modeCount, modes.data()) != VK_SUCCESS) {
+        return EGL_FALSE;
+    }
+    modes.resize(modeCount);
+
+    // refresh rates are in millihertz
+    uint32_t width   = displayProperties.physicalResolution.width;
+    uint32_t height  = displayProperties.physicalResolution.height;
+    uint32_t refresh = 0;
+    const char *modeString = getenv(EGL_DISPLAY_MODE_ENV);
+    if(modeString) {
+        unsigned int w = 0, h = 0, hz = 0;
+        if(sscanf(modeString, "%ux%u@%u", &w, &h, &hz) >= 2) {
+            width   = w;
+            height  = h;
+            refresh = hz * 1000;
+        }
+    }
+
+    // the closest refresh rate to the one requested, otherwise the highest one
+    const VkDisplayModePropertiesKHR *chosenMode = nullptr;
+    uint32_t chosenScore = UINT32_MAX;
+    for(const auto &mode : modes) {
+        const VkDisplayModeParametersKHR &parameters = mode.parameters;
+        if(parameters.visibleRegion.width != width || parameters.visibleRegion.height != height) {
+            continue;
+        }
+
+        uint32_t score = refresh ? static_cast<uint32_t>(std::abs(static_cast<int64_t>(parameters.refreshRate) - refresh))
+                                 : UINT32_MAX - parameters.refreshRate;
+        if(score < chosenScore || !chosenMode) {
+            chosenMode  = &mode;
+            chosenScore = score;
+        }
+    }
+
+    if(!chosenMode) {
+        if(modeString) {
+            printf("GLOVE: display mode %s is not available, using %ux%u@%u\n", modeString,
+                   modes[0].parameters.visibleRegion.width, modes[0].parameters.visibleRegion.height,
+                   modes[0].parameters.refreshRate / 1000);
+        }
+        chosenMode = &modes[0];
+    }
+
+    mDisplayMode       = chosenMode->displayMode;
+    mDisplayModeExtent = chosenMode->parameters.visibleRegion;
 
     return EGL_TRUE;
 }
 
+EGLBoolean
+WSIPlaneDisplay::ChooseDisplayPlane(VkDisplayKHR display)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    VkPhysicalDevice gpu = mVkInterface->vkGpus[0];
+    uint32_t planeCount = 0;
+    if(mWsiPlaneDisplayCallbacks.fpGetPhysicalDeviceDisplayPlanePropertiesKHR(gpu, &planeCount, nullptr) != VK_SUCCESS || !planeCount) {
+        return EGL_FALSE;
+    }
+
+    std::vector<VkDisplayPlanePropertiesKHR> planes(planeCount);
+    if(mWsiPlaneDisplayCallbacks.fpGetPhysicalDeviceDisplayPlanePropertiesKHR(gpu, &planeCount, planes.data()) != VK_SUCCESS) {
+        return EGL_FALSE;
+    }
+
+    const uint32_t requestedPlane = GetEnvIndex(EGL_DISPLAY_PLANE_ENV, UINT32_MAX);
+    for(uint32_t i = 0; i < planeCount; ++i) {
+        if(requestedPlane != UINT32_MAX && i != requestedPlane) {
+            continue;
+        }
+
+        // a plane shown on another display is left alone, unless it has been asked for
+        if(requestedPlane == UINT32_MAX && planes[i].currentDisplay != VK_NULL_HANDLE && planes[i].currentDisplay != display) {
+            continue;
+        }
+
+        uint32_t displayCount = 0;
+        if(mWsiPlaneDisplayCallbacks.fpGetDisplayPlaneSupportedDisplaysKHR(gpu, i, &displayCount, nullptr) != VK_SUCCESS || !displayCount) {
+            continue;
+        }
+        std::vector<VkDisplayKHR> displays(displayCount);
+        if(mWsiPlaneDisplayCallbacks.fpGetDisplayPlaneSupportedDisplaysKHR(gpu, i, &displayCount, displays.data()) != VK_SUCCESS ||
+           std::find(displays.begin(), displays.begin() + displayCount, display) == displays.begin() + displayCount) {
+            continue;
+        }
+
+        VkDisplayPlaneCapabilitiesKHR capabilities;
+        if(mWsiPlaneDisplayCallbacks.fpGetDisplayPlaneCapabilitiesKHR(gpu, mDisplayMode, i, &capabilities) != VK_SUCCESS) {
+            continue;
+        }
+
+        // the surface covers the whole mode, so the plane is opaque whenever it can be
+        mPlaneAlphaMode = VK_DISPLAY_PLANE_ALPHA_OPAQUE_BIT_KHR;
+        if(!(capabilities.supportedAlpha & VK_DISPLAY_PLANE_ALPHA_OPAQUE_BIT_KHR)) {
+            for(uint32_t bit = VK_DISPLAY_PLANE_ALPHA_GLOBAL_BIT_KHR; bit <= VK_DISPLAY_PLANE_ALPHA_PER_PIXEL_PREMULTIPLIED_BIT_KHR; bit <<= 1) {
+                if(capabilities.supportedAlpha & bit) {
+                    mPlaneAlphaMode = static_cast<VkDisplayPlaneAlphaFlagBitsKHR>(bit);
+                    break;
+                }
+            }
+        }
+
+        mPlaneIndex      = i;
+        mPlaneStackIndex = planes[i].currentStackIndex;
+
+        return EGL_TRUE;
+    }
+
+    return EGL_FALSE;
+}
+
 VkSurfaceKHR
 WSIPlaneDisplay::CreateSurface(EGLDisplay_t* dpy, EGLNativeWindowType win, EGLSurface_t *surface)
 {
@@ -65,19 +214,33 @@ WSIPlaneDisplay::CreateSurface(EGLDisplay_t* dpy, EGLNativeWindowType win, EGLSu
         return VK_NULL_HANDLE;
     }
 
-    assert(mDisplayPropertiesList.size() > 0);
+    const uint32_t displayIndex = GetEnvIndex(EGL_DISPLAY_INDEX_ENV, 0);
+    if(displayIndex >= mDisplayPropertiesList.size()) {
+        return VK_NULL_HANDLE;
+    }
+
+    const VkDisplayPropertiesKHR &displayProperties = mDisplayPropertiesList[displayIndex];
+    if(ChooseDisplayMode(displayProperties) == EGL_FALSE || ChooseDisplayPlane(displayProperties.display) == EGL_FALSE) {
+        return VK_NULL_HANDLE;
+    }
 
-    surface->SetWidth(mDisplayPropertiesList[0].physicalResolution.width);
-    surface->SetHeight(mDisplayPropertiesList[0].physicalResolution.height);
+    surface->SetWidth(mDisplayModeExtent.width);
+    surface->SetHeight(mDisplayModeExtent.height);
 
     /// Create a vk surface
     VkSurfaceKHR vkSurface;
     VkDisplaySurfaceCreateInfoKHR surfaceCreateInfo;
     memset(static_cast<void *>(&surfaceCreateInfo), 0 ,sizeof(surfaceCreateInfo));
-    surfaceCreateInfo.sType = VK_STRUCTURE_TYPE_DISPLAY_SURFACE_CREATE_INFO_KHR;
-    surfaceCreateInfo.pNext = nullptr;
-    surfaceCreateInfo.imageExtent.width = static_cast<uint32_t>(surface->GetWidth());
-    surfaceCreateInfo.imageExtent.height = static_cast<uint32_t>(surface->GetHeight());
+    surfaceCreateInfo.sType           = VK_STRUCTURE_TYPE_DISPLAY_SURFACE_CREATE_INFO_KHR;
+    surfaceCreateInfo.pNext           = nullptr;
+    surfaceCreateInfo.flags           = 0;
+    surfaceCreateInfo.displayMode     = mDisplayMode;
+    surfaceCreateInfo.planeIndex      = mPlaneIndex;
+    surfaceCreateInfo.planeStackIndex = mPlaneStackIndex;
+    surfaceCreateInfo.transform       = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+    surfaceCreateInfo.globalAlpha     = 1.0f;
+    surfaceCreateInfo.alphaMode       = mPlaneAlphaMode;
+    surfaceCreateInfo.imageExtent     = mDisplayModeExtent;
 
     if(VK_SUCCESS != mWsiPlaneDisplayCallbacks.fpCreateDisplayPlaneSurfaceKHR(mVkInterface->vkInstance, &surfaceCreateInfo, nullptr, &vkSurface)) {
         return VK_NULL_HANDLE;
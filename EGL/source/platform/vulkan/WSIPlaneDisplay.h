@@ -34,25 +34,37 @@ protected:
         // VK_KHR_display functions
         PFN_vkCreateDisplayPlaneSurfaceKHR              fpCreateDisplayPlaneSurfaceKHR;
         PFN_vkGetPhysicalDeviceDisplayPropertiesKHR     fpGetPhysicalDeviceDisplayPropertiesKHR;
+        PFN_vkGetPhysicalDeviceDisplayPlanePropertiesKHR fpGetPhysicalDeviceDisplayPlanePropertiesKHR;
+        PFN_vkGetDisplayPlaneSupportedDisplaysKHR       fpGetDisplayPlaneSupportedDisplaysKHR;
+        PFN_vkGetDisplayModePropertiesKHR               fpGetDisplayModePropertiesKHR;
+        PFN_vkGetDisplayPlaneCapabilitiesKHR            fpGetDisplayPlaneCapabilitiesKHR;
     } wsiPlaneDisplayCallbacks_t;
 
     wsiPlaneDisplayCallbacks_t                          mWsiPlaneDisplayCallbacks;
     std::vector<VkDisplayPropertiesKHR>                 mDisplayPropertiesList;
 
+    /// the mode and plane the surfaces are shown with
+    VkDisplayModeKHR                                    mDisplayMode;
+    VkExtent2D                                          mDisplayModeExtent;
+    uint32_t                                            mPlaneIndex;
+    uint32_t                                            mPlaneStackIndex;
+    VkDisplayPlaneAlphaFlagBitsKHR                      mPlaneAlphaMode;
+
     void               SetPhysicalDeviceDisplayProperties();
+    EGLBoolean         ChooseDisplayMode(const VkDisplayPropertiesKHR &displayProperties);
+    EGLBoolean         ChooseDisplayPlane(VkDisplayKHR display);
     EGLBoolean         SetPlatformCallbacks() override;
 
 public:
-    WSIPlaneDisplay() {}
+    WSIPlaneDisplay()
+    : mDisplayMode(VK_NULL_HANDLE), mDisplayModeExtent({0, 0}), mPlaneIndex(0), mPlaneStackIndex(0),
+      mPlaneAlphaMode(VK_DISPLAY_PLANE_ALPHA_OPAQUE_BIT_KHR) {}
     ~WSIPlaneDisplay() override {}
 
     EGLBoolean         Initialize() override;
     VkSurfaceKHR       CreateSurface(EGLDisplay_t* dpy,
                                      EGLNativeWindowType win,
                                      EGLSurface_t *surface) override;
-
-
-
 };
 
 #endif // __WSI_PLANE_DISPLAY_H__
@@ -19,12 +19,143 @@
  *
  *  @brief      WSI WAYLAND module. It gets VkSurface for WAYLAND Window platform.
  *
+ *  @section
+ *
+ *  eglSwapBuffers requests a frame callback, and a wp_presentation feedback
+ *  when the compositor has it, on the wl_surface right before the present,
+ *  so that they are committed along with the frame. It then waits for the
+ *  callback of that frame, so that no frames are rendered that the compositor
+ *  would drop. With the feedback, the refresh cycle of the output is known and
+ *  the next frame is held back until it can just be rendered in time for the
+ *  refresh that follows, which lets the application sample its input later.
+ *
  */
 
 #ifdef VK_USE_PLATFORM_WAYLAND_KHR
 #include "WSIWayland.h"
 #include "wayland-egl-backend.h"
 #include "api/eglDisplay.h"
+#include <algorithm>
+#include <cstring>
+#include <poll.h>
+
+static uint64_t
+GetTime(clockid_t clockId)
+{
+    struct timespec ts;
+    clock_gettime(clockId, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+/// dispatches the events of the queue, waiting at most timeout for them to arrive
+static bool
+DispatchQueue(wl_display *display, wl_event_queue *queue, uint64_t timeout)
+{
+    if(wl_display_prepare_read_queue(display, queue) != 0) {
+        return wl_display_dispatch_queue_pending(display, queue) >= 0;
+    }
+
+    wl_display_flush(display);
+
+    struct pollfd pfd = { wl_display_get_fd(display), POLLIN, 0 };
+    if(poll(&pfd, 1, static_cast<int>((timeout + 999999) / 1000000)) <= 0) {
+        wl_display_cancel_read(display);
+        return false;
+    }
+
+    if(wl_display_read_events(display) < 0) {
+        return false;
+    }
+
+    return wl_display_dispatch_queue_pending(display, queue) >= 0;
+}
+
+static void
+FrameDone(void *data, wl_callback *callback, uint32_t time)
+{
+    WSIWayland::waylandFrameState_t *state = static_cast<WSIWayland::waylandFrameState_t *>(data);
+
+    wl_callback_destroy(callback);
+    state->frameCallback = nullptr;
+}
+
+static const wl_callback_listener frameListener = {
+    FrameDone
+};
+
+#ifdef GLOVE_WAYLAND_PRESENTATION_TIME
+static void
+RemoveFeedback(WSIWayland::waylandFrameState_t *state, struct wp_presentation_feedback *feedback)
+{
+    state->feedbacks.erase(std::remove(state->feedbacks.begin(), state->feedbacks.end(), feedback), state->feedbacks.end());
+    wp_presentation_feedback_destroy(feedback);
+}
+
+static void
+FeedbackSyncOutput(void *data, struct wp_presentation_feedback *feedback, wl_output *output)
+{
+}
+
+static void
+FeedbackPresented(void *data, struct wp_presentation_feedback *feedback, uint32_t tv_sec_hi, uint32_t tv_sec_lo,
+                  uint32_t tv_nsec, uint32_t refresh, uint32_t seq_hi, uint32_t seq_lo, uint32_t flags)
+{
+    WSIWayland::waylandFrameState_t *state = static_cast<WSIWayland::waylandFrameState_t *>(data);
+
+    state->presentedTime = ((static_cast<uint64_t>(tv_sec_hi) << 32) | tv_sec_lo) * 1000000000ull + tv_nsec;
+    state->refreshTime   = refresh;
+    RemoveFeedback(state, feedback);
+}
+
+static void
+FeedbackDiscarded(void *data, struct wp_presentation_feedback *feedback)
+{
+    WSIWayland::waylandFrameState_t *state = static_cast<WSIWayland::waylandFrameState_t *>(data);
+
+    // the frame missed its refresh, so the next ones start earlier
+    state->renderTime += EGL_WAYLAND_FRAME_MARGIN;
+    RemoveFeedback(state, feedback);
+}
+
+static const wp_presentation_feedback_listener feedbackListener = {
+    FeedbackSyncOutput,
+    FeedbackPresented,
+    FeedbackDiscarded
+};
+
+static void
+PresentationClockId(void *data, wp_presentation *presentation, uint32_t clockId)
+{
+    WSIWayland::waylandFrameState_t *state = static_cast<WSIWayland::waylandFrameState_t *>(data);
+
+    state->clockId = static_cast<clockid_t>(clockId);
+}
+
+static const wp_presentation_listener presentationListener = {
+    PresentationClockId
+};
+
+static void
+RegistryGlobal(void *data, wl_registry *registry, uint32_t name, const char *interface, uint32_t version)
+{
+    WSIWayland::waylandFrameState_t *state = static_cast<WSIWayland::waylandFrameState_t *>(data);
+
+    if(!strcmp(interface, wp_presentation_interface.name) && !state->presentation) {
+        state->presentation = static_cast<wp_presentation *>(wl_registry_bind(registry, name, &wp_presentation_interface, 1));
+        wp_presentation_add_listener(state->presentation, &presentationListener, state);
+    }
+}
+
+static void
+RegistryGlobalRemove(void *data, wl_registry *registry, uint32_t name)
+{
+}
+
+static const wl_registry_listener registryListener = {
+    RegistryGlobal,
+    RegistryGlobalRemove
+};
+#endif // GLOVE_WAYLAND_PRESENTATION_TIME
 
 EGLBoolean
 WSIWayland::Initialize()
@@ -81,6 +212,171 @@ WSIWayland::CreateSurface(EGLDisplay_t* dpy, EGLNativeWindowType win, EGLSurface
         return VK_NULL_HANDLE;
     }
 
+    if(EGL_WAYLAND_FRAME_SCHEDULING) {
+        DestroySurface(surface);
+
+        std::lock_guard<std::mutex> lock(mFrameStatesMutex);
+        mFrameStates[surface] = CreateFrameState(dpy->display_id, win->surface);
+    }
+
     return vkSurface;
 }
+
+void
+WSIWayland::DestroySurface(EGLSurface_t *surface)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    std::lock_guard<std::mutex> lock(mFrameStatesMutex);
+
+    auto it = mFrameStates.find(surface);
+    if(it != mFrameStates.end()) {
+        DestroyFrameState(it->second);
+        mFrameStates.erase(it);
+    }
+}
+
+WSIWayland::waylandFrameState_t *
+WSIWayland::CreateFrameState(wl_display *display, wl_surface *surface)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    waylandFrameState_t *state = new waylandFrameState_t();
+    state->display        = display;
+    state->queue          = wl_display_create_queue(display);
+    state->surfaceWrapper = static_cast<wl_surface *>(wl_proxy_create_wrapper(surface));
+    state->frameCallback  = nullptr;
+    state->clockId        = CLOCK_MONOTONIC;
+    state->frameStartTime = 0;
+    state->renderTime     = 0;
+    wl_proxy_set_queue(reinterpret_cast<wl_proxy *>(state->surfaceWrapper), state->queue);
+
+#ifdef GLOVE_WAYLAND_PRESENTATION_TIME
+    state->presentation   = nullptr;
+    state->presentedTime  = 0;
+    state->refreshTime    = 0;
+
+    wl_display *displayWrapper = static_cast<wl_display *>(wl_proxy_create_wrapper(display));
+    wl_proxy_set_queue(reinterpret_cast<wl_proxy *>(displayWrapper), state->queue);
+    state->registry = wl_display_get_registry(displayWrapper);
+    wl_proxy_wrapper_destroy(displayWrapper);
+
+    // the globals, then the clock of the presentation global
+    wl_registry_add_listener(state->registry, &registryListener, state);
+    wl_display_roundtrip_queue(display, state->queue);
+    if(state->presentation) {
+        wl_display_roundtrip_queue(display, state->queue);
+    }
+#endif // GLOVE_WAYLAND_PRESENTATION_TIME
+
+    return state;
+}
+
+void
+WSIWayland::DestroyFrameState(waylandFrameState_t *state)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    if(state->frameCallback) {
+        wl_callback_destroy(state->frameCallback);
+    }
+
+#ifdef GLOVE_WAYLAND_PRESENTATION_TIME
+    for(auto feedback : state->feedbacks) {
+        wp_presentation_feedback_destroy(feedback);
+    }
+    if(state->presentation) {
+        wp_presentation_destroy(state->presentation);
+    }
+    wl_registry_destroy(state->registry);
+#endif // GLOVE_WAYLAND_PRESENTATION_TIME
+
+    wl_proxy_wrapper_destroy(state->surfaceWrapper);
+    wl_event_queue_destroy(state->queue);
+    delete state;
+}
+
+WSIWayland::waylandFrameState_t *
+WSIWayland::GetFrameState(EGLSurface_t *surface)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    std::lock_guard<std::mutex> lock(mFrameStatesMutex);
+
+    auto it = mFrameStates.find(surface);
+    return it != mFrameStates.end() ? it->second : nullptr;
+}
+
+void
+WSIWayland::BeginPresent(EGLSurface_t *surface)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    waylandFrameState_t *state = GetFrameState(surface);
+    if(!state) {
+        return;
+    }
+
+    // the cpu time of the frame, rising at once and decaying slowly
+    if(state->frameStartTime) {
+        uint64_t frameTime = GetTime(state->clockId) - state->frameStartTime;
+        state->renderTime = std::max(frameTime, state->renderTime - state->renderTime / 16);
+    }
+
+    // committed by the present along with the frame
+    if(!state->frameCallback) {
+        state->frameCallback = wl_surface_frame(state->surfaceWrapper);
+        wl_callback_add_listener(state->frameCallback, &frameListener, state);
+    }
+
+#ifdef GLOVE_WAYLAND_PRESENTATION_TIME
+    if(state->presentation) {
+        struct wp_presentation_feedback *feedback = wp_presentation_feedback(state->presentation, state->surfaceWrapper);
+        wp_presentation_feedback_add_listener(feedback, &feedbackListener, state);
+        state->feedbacks.push_back(feedback);
+    }
+#endif // GLOVE_WAYLAND_PRESENTATION_TIME
+}
+
+void
+WSIWayland::ScheduleNextFrame(EGLSurface_t *surface)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    waylandFrameState_t *state = GetFrameState(surface);
+    if(!state) {
+        return;
+    }
+
+    // a hidden surface gets no frame callbacks, so the wait is bounded
+    uint64_t now = GetTime(CLOCK_MONOTONIC);
+    const uint64_t deadline = now + EGL_PRESENT_WAIT_TIMEOUT;
+    while(state->frameCallback && now < deadline) {
+        if(!DispatchQueue(state->display, state->queue, deadline - now)) {
+            break;
+        }
+        now = GetTime(CLOCK_MONOTONIC);
+    }
+
+#ifdef GLOVE_WAYLAND_PRESENTATION_TIME
+    // holds the frame back until it can just be rendered before the next refresh
+    wl_display_dispatch_queue_pending(state->display, state->queue);
+    if(EGL_WAYLAND_FRAME_MARGIN && state->presentedTime && state->refreshTime) {
+        now = GetTime(state->clockId);
+        const uint64_t lead = state->renderTime + EGL_WAYLAND_FRAME_MARGIN;
+        if(lead < state->refreshTime && now > state->presentedTime) {
+            const uint64_t refreshes = (now + lead - state->presentedTime) / state->refreshTime + 1;
+            const uint64_t start = state->presentedTime + refreshes * state->refreshTime - lead;
+            if(start > now) {
+                struct timespec ts;
+                ts.tv_sec  = static_cast<time_t>(start / 1000000000ull);
+                ts.tv_nsec = static_cast<long>(start % 1000000000ull);
+                clock_nanosleep(state->clockId, TIMER_ABSTIME, &ts, nullptr);
+            }
+        }
+    }
+#endif // GLOVE_WAYLAND_PRESENTATION_TIME
+
+    state->frameStartTime = GetTime(state->clockId);
+}
 #endif // VK_USE_PLATFORM_WAYLAND_KHR
@@ -26,9 +26,37 @@
 
 #include <wayland-client.h>
 #include "vulkanWSI.h"
+#include <map>
+#include <mutex>
+#include <vector>
+#include <time.h>
+
+#ifdef GLOVE_WAYLAND_PRESENTATION_TIME
+#include "presentation-time-client-protocol.h"
+#endif // GLOVE_WAYLAND_PRESENTATION_TIME
 
 class WSIWayland : public VulkanWSI
 {
+public:
+    /// the frame callbacks and presentation feedback of a surface, dispatched on a queue of its own
+    /// so that the events of the application are left alone
+    typedef struct waylandFrameState {
+        wl_display                                      *display;
+        wl_event_queue                                  *queue;
+        wl_surface                                      *surfaceWrapper;
+        wl_callback                                     *frameCallback;
+        clockid_t                                        clockId;
+        uint64_t                                         frameStartTime;
+        uint64_t                                         renderTime;
+#ifdef GLOVE_WAYLAND_PRESENTATION_TIME
+        wl_registry                                     *registry;
+        wp_presentation                                 *presentation;
+        std::vector<struct wp_presentation_feedback *>   feedbacks;
+        uint64_t                                         presentedTime;
+        uint64_t                                         refreshTime;
+#endif // GLOVE_WAYLAND_PRESENTATION_TIME
+    } waylandFrameState_t;
+
 protected:
     typedef struct wsiWaylandCallbacks {
         // VK_KHR_WAYLAND_surface functions
@@ -37,8 +65,15 @@ protected:
 
     wsiWaylandCallbacks_t                                mWsiWaylandCallbacks;
 
+    std::mutex                                           mFrameStatesMutex;
+    std::map<EGLSurface_t *, waylandFrameState_t *>      mFrameStates;
+
     EGLBoolean         SetPlatformCallbacks() override;
 
+    waylandFrameState_t *CreateFrameState(wl_display *display, wl_surface *surface);
+    void               DestroyFrameState(waylandFrameState_t *state);
+    waylandFrameState_t *GetFrameState(EGLSurface_t *surface);
+
 public:
     WSIWayland()  {}
     ~WSIWayland() override {}
@@ -47,6 +82,9 @@ public:
     VkSurfaceKHR       CreateSurface(EGLDisplay_t* dpy,
                                     EGLNativeWindowType win,
                                     EGLSurface_t *surface) override;
+    void               DestroySurface(EGLSurface_t *surface) override;
+    void               BeginPresent(EGLSurface_t *surface) override;
+    void               ScheduleNextFrame(EGLSurface_t *surface) override;
 };
 
 #endif // __WSIWAYLAND_H__
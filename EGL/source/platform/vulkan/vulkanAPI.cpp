@@ -53,18 +53,12 @@ VulkanAPI::CreateSwapchain(const VulkanResources *vkResources,
                                     VkExtent2D swapChainExtent,
                                     VkPresentModeKHR swapchainPresentMode,
                                     VkFormat surfaceColorFormat,
+                                    VkImageUsageFlags imageUsage,
+                                    VkSurfaceTransformFlagBitsKHR preTransform,
                                     VkSwapchainKHR oldSwapchain)
 {
     FUN_ENTRY(DEBUG_DEPTH);
 
-    VkSurfaceTransformFlagBitsKHR preTransform;
-    if (surfCapabilities.supportedTransforms & VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR) {
-        preTransform = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
-    }
-    else {
-        preTransform = surfCapabilities.currentTransform;
-    }
-
     // Find a supported composite alpha mode - one of these is guaranteed to be set
     const VkCompositeAlphaFlagBitsKHR compositeAlphaFlagBits[4] = {
         VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR,
@@ -97,11 +91,24 @@ VulkanAPI::CreateSwapchain(const VulkanResources *vkResources,
     swapChainCreateInfo.oldSwapchain          = oldSwapchain;
     swapChainCreateInfo.clipped               = true;
     swapChainCreateInfo.imageColorSpace       = VK_COLORSPACE_SRGB_NONLINEAR_KHR;
-    swapChainCreateInfo.imageUsage            = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    swapChainCreateInfo.imageUsage            = imageUsage;
     swapChainCreateInfo.imageSharingMode      = VK_SHARING_MODE_EXCLUSIVE;
     swapChainCreateInfo.queueFamilyIndexCount = 0;
     swapChainCreateInfo.pQueueFamilyIndices   = nullptr;
 
+#ifdef VK_EXT_image_compression_control_swapchain
+    VkImageCompressionControlEXT compressionControl;
+    compressionControl.sType                        = VK_STRUCTURE_TYPE_IMAGE_COMPRESSION_CONTROL_EXT;
+    compressionControl.pNext                        = nullptr;
+    compressionControl.flags                        = VK_IMAGE_COMPRESSION_FIXED_RATE_DEFAULT_EXT;
+    compressionControl.compressionControlPlaneCount = 0;
+    compressionControl.pFixedRateFlags              = nullptr;
+
+    if(mVkInterface->fixedRateCompressionSupported) {
+        swapChainCreateInfo.pNext = &compressionControl;
+    }
+#endif // VK_EXT_image_compression_control_swapchain
+
     VkSwapchainKHR vkSwapchain;
     VkResult res = mWsiCallbacks->fpCreateSwapchainKHR(mVkInterface->vkDevice, &swapChainCreateInfo, nullptr, &vkSwapchain);
 
@@ -197,10 +204,18 @@ VulkanAPI::AcquireNextImage(const VulkanResources *vkResources, uint32_t *imageI
 {
     FUN_ENTRY(DEBUG_DEPTH);
 
+    return AcquireNextImage(vkResources, imageIndex, mVkInterface->vkSyncItems->vkAcquireSemaphore);
+}
+
+VkResult
+VulkanAPI::AcquireNextImage(const VulkanResources *vkResources, uint32_t *imageIndex, VkSemaphore semaphore)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
     VkResult res = mWsiCallbacks->fpAcquireNextImageKHR(mVkInterface->vkDevice,
                                                         vkResources->GetSwapchain(),
                                                         UINT64_MAX,
-                                                        mVkInterface->vkSyncItems->vkAcquireSemaphore,
+                                                        semaphore,
                                                         VK_NULL_HANDLE,
                                                         imageIndex);
 
@@ -210,7 +225,8 @@ VulkanAPI::AcquireNextImage(const VulkanResources *vkResources, uint32_t *imageI
 }
 
 VkResult
-VulkanAPI::PresentImage(const VulkanResources *vkResources, uint32_t imageIndex, std::vector<VkSemaphore> &vkSemaphores)
+VulkanAPI::PresentImage(const VulkanResources *vkResources, uint32_t imageIndex, std::vector<VkSemaphore> &vkSemaphores, uint64_t presentId,
+                        const std::vector<VkRectLayerKHR> *regions)
 {
     FUN_ENTRY(DEBUG_DEPTH);
 
@@ -218,6 +234,31 @@ VulkanAPI::PresentImage(const VulkanResources *vkResources, uint32_t imageIndex,
     VkSwapchainKHR swapchain        = vkResources->GetSwapchain();
     presentInfo.sType               = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
     presentInfo.pNext               = nullptr;
+#ifdef VK_KHR_present_id
+    // identifies the present to be waited upon through vkWaitForPresentKHR
+    VkPresentIdKHR presentIdInfo;
+    presentIdInfo.sType             = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+    presentIdInfo.pNext             = nullptr;
+    presentIdInfo.swapchainCount    = 1;
+    presentIdInfo.pPresentIds       = &presentId;
+    if(presentId) {
+        presentInfo.pNext           = &presentIdInfo;
+    }
+#endif // VK_KHR_present_id
+#ifdef VK_KHR_incremental_present
+    // without regions the whole image is presented
+    VkPresentRegionKHR presentRegion;
+    VkPresentRegionsKHR presentRegionsInfo;
+    if(regions && !regions->empty()) {
+        presentRegion.rectangleCount      = static_cast<uint32_t>(regions->size());
+        presentRegion.pRectangles         = regions->data();
+        presentRegionsInfo.sType          = VK_STRUCTURE_TYPE_PRESENT_REGIONS_KHR;
+        presentRegionsInfo.pNext          = presentInfo.pNext;
+        presentRegionsInfo.swapchainCount = 1;
+        presentRegionsInfo.pRegions       = &presentRegion;
+        presentInfo.pNext                 = &presentRegionsInfo;
+    }
+#endif // VK_KHR_incremental_present
     presentInfo.waitSemaphoreCount  = static_cast<uint32_t>(vkSemaphores.size());
     presentInfo.pWaitSemaphores     = vkSemaphores.data();
     presentInfo.swapchainCount      = 1;
@@ -225,17 +266,154 @@ VulkanAPI::PresentImage(const VulkanResources *vkResources, uint32_t imageIndex,
     presentInfo.pImageIndices       = &imageIndex;
     presentInfo.pResults            = nullptr;
 
-    VkResult res = mWsiCallbacks->fpQueuePresentKHR(mVkInterface->vkQueue, &presentInfo);
+    // the queue is shared with the contexts rendering on other threads
+    VkResult res = mVkInterface->queuePresentCb(mVkInterface->vkQueue, &presentInfo, mWsiCallbacks->fpQueuePresentKHR);
 
     return res;
 }
 
+VkResult
+VulkanAPI::WaitForPresent(const VulkanResources *vkResources, uint64_t presentId, uint64_t timeout)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+#ifdef VK_KHR_present_wait
+    if(mWsiCallbacks->fpWaitForPresentKHR) {
+        return mWsiCallbacks->fpWaitForPresentKHR(mVkInterface->vkDevice, vkResources->GetSwapchain(), presentId, timeout);
+    }
+#endif // VK_KHR_present_wait
+
+    return VK_ERROR_EXTENSION_NOT_PRESENT;
+}
+
+EGLBoolean
+VulkanAPI::IsPresentWaitSupported(void) const
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+#ifdef VK_KHR_present_wait
+    return mWsiCallbacks->fpWaitForPresentKHR ? EGL_TRUE : EGL_FALSE;
+#else
+    return EGL_FALSE;
+#endif // VK_KHR_present_wait
+}
+
+VkFence
+VulkanAPI::SubmitFence(void)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    VkFenceCreateInfo fenceInfo;
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    fenceInfo.pNext = nullptr;
+    fenceInfo.flags = 0;
+
+    VkFence fence;
+    if(vkCreateFence(mVkInterface->vkDevice, &fenceInfo, nullptr, &fence) != VK_SUCCESS) {
+        return VK_NULL_HANDLE;
+    }
+
+    // an empty submission signals the fence once all the work submitted to the queue so far has completed
+    if(mVkInterface->queueSubmitCb(mVkInterface->vkQueue, 0, nullptr, fence) != VK_SUCCESS) {
+        vkDestroyFence(mVkInterface->vkDevice, fence, nullptr);
+        return VK_NULL_HANDLE;
+    }
+
+    return fence;
+}
+
+EGLBoolean
+VulkanAPI::IsFenceSignaled(VkFence fence)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    return (fence == VK_NULL_HANDLE || vkGetFenceStatus(mVkInterface->vkDevice, fence) == VK_SUCCESS) ? EGL_TRUE : EGL_FALSE;
+}
+
+void
+VulkanAPI::WaitFence(VkFence fence)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    if(fence != VK_NULL_HANDLE) {
+        vkWaitForFences(mVkInterface->vkDevice, 1, &fence, VK_TRUE, UINT64_MAX);
+    }
+}
+
+void
+VulkanAPI::DestroyFence(VkFence fence)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    if(fence != VK_NULL_HANDLE) {
+        vkDestroyFence(mVkInterface->vkDevice, fence, nullptr);
+    }
+}
+
+VkSemaphore
+VulkanAPI::CreateVkSemaphore(void)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    VkSemaphoreCreateInfo semaphoreInfo;
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreInfo.pNext = nullptr;
+    semaphoreInfo.flags = 0;
+
+    VkSemaphore semaphore;
+    if(vkCreateSemaphore(mVkInterface->vkDevice, &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS) {
+        return VK_NULL_HANDLE;
+    }
+
+    return semaphore;
+}
+
+void
+VulkanAPI::DestroyVkSemaphore(VkSemaphore semaphore)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    if(semaphore != VK_NULL_HANDLE) {
+        vkDestroySemaphore(mVkInterface->vkDevice, semaphore, nullptr);
+    }
+}
+
+EGLBoolean
+VulkanAPI::ConsumeVkSemaphore(VkSemaphore semaphore)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    // an empty batch waiting upon it is the only way to unsignal a binary semaphore
+    VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+    VkSubmitInfo submitInfo;
+    submitInfo.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext                = nullptr;
+    submitInfo.waitSemaphoreCount   = 1;
+    submitInfo.pWaitSemaphores      = &semaphore;
+    submitInfo.pWaitDstStageMask    = &waitStage;
+    submitInfo.commandBufferCount   = 0;
+    submitInfo.pCommandBuffers      = nullptr;
+    submitInfo.signalSemaphoreCount = 0;
+    submitInfo.pSignalSemaphores    = nullptr;
+
+    return mVkInterface->queueSubmitCb(mVkInterface->vkQueue, 1, &submitInfo, VK_NULL_HANDLE) == VK_SUCCESS ? EGL_TRUE : EGL_FALSE;
+}
+
 void
 VulkanAPI::DestroySwapchain(const VulkanResources *vkResources)
 {
     FUN_ENTRY(DEBUG_DEPTH);
 
-    vkDestroySwapchainKHR(mVkInterface->vkDevice, vkResources->GetSwapchain(), nullptr);
+    DestroySwapchain(vkResources->GetSwapchain());
+}
+
+void
+VulkanAPI::DestroySwapchain(VkSwapchainKHR swapchain)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    vkDestroySwapchainKHR(mVkInterface->vkDevice, swapchain, nullptr);
 }
 
 void
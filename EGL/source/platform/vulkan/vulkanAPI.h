@@ -51,6 +51,8 @@ public:
                                                  VkExtent2D swapChainExtent,
                                                  VkPresentModeKHR swapchainPresentMode,
                                                  VkFormat surfaceColorFormat,
+                                                 VkImageUsageFlags imageUsage,
+                                                 VkSurfaceTransformFlagBitsKHR preTransform,
                                                  VkSwapchainKHR oldSwapchain);
 
     EGLBoolean                   GetSwapChainImages(const VulkanResources *vkResources, uint32_t imageCount, VkImage *images);
@@ -62,9 +64,24 @@ public:
     uint32_t                     GetPhysicalDevPresentModesCount(const VulkanResources *vkResources);
     EGLBoolean                   GetPhysicalDevSurfaceCapabilities(const VulkanResources *vkResources, VkSurfaceCapabilitiesKHR *surfCapabilities);
     VkResult                     AcquireNextImage(const VulkanResources *vkResources, uint32_t *imageIndex);
-    VkResult                     PresentImage(const VulkanResources *vkResources, uint32_t imageIndex, std::vector<VkSemaphore> &vkSemaphores);
+    VkResult                     AcquireNextImage(const VulkanResources *vkResources, uint32_t *imageIndex, VkSemaphore semaphore);
+    VkResult                     PresentImage(const VulkanResources *vkResources, uint32_t imageIndex, std::vector<VkSemaphore> &vkSemaphores, uint64_t presentId = 0,
+                                              const std::vector<VkRectLayerKHR> *regions = nullptr);
+    VkResult                     WaitForPresent(const VulkanResources *vkResources, uint64_t presentId, uint64_t timeout);
+    EGLBoolean                   IsPresentWaitSupported(void) const;
+
+    VkFence                      SubmitFence(void);
+    EGLBoolean                   IsFenceSignaled(VkFence fence);
+    void                         WaitFence(VkFence fence);
+    void                         DestroyFence(VkFence fence);
+
+    VkSemaphore                  CreateVkSemaphore(void);
+    void                         DestroyVkSemaphore(VkSemaphore semaphore);
+    /// unsignals a semaphore that nothing else is going to wait upon
+    EGLBoolean                   ConsumeVkSemaphore(VkSemaphore semaphore);
 
     void                         DestroySwapchain(const VulkanResources *vkResources);
+    void                         DestroySwapchain(VkSwapchainKHR swapchain);
     void                         DestroyPlatformSurface(const VulkanResources *vkResources);
 
     void                         SetWSICallbacks(const VulkanWSI::wsiCallbacks_t *wsiCallbacks) { mWsiCallbacks = wsiCallbacks; }
@@ -0,0 +1,132 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+
+/**
+ *  @file       vulkanPresentThread.cpp
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Thread that presents the frames of window surfaces and acquires their next images
+ *
+ *  @section
+ *
+ *  vkQueuePresentKHR, the pacing of the presents and vkAcquireNextImageKHR
+ *  may all block until the display has caught up. eglSwapBuffers queues the
+ *  frame it has submitted to this thread instead, which presents it and
+ *  acquires the next image of the surface, while the application starts on
+ *  the CPU work of the next frame. The next image is collected at its first
+ *  use in that frame, through the lazy acquisition of the surface.
+ *
+ *  The frames go through a ring of a single producer and a single consumer,
+ *  whose counts are atomic, and each side sleeps on a counting signal until
+ *  the other hands a frame over.
+ *
+ */
+
+#include "vulkanPresentThread.h"
+
+void
+VulkanPresentThread::Signal::Post(void)
+{
+    FUN_ENTRY(EGL_LOG_TRACE);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    ++mCount;
+    mCondition.notify_one();
+}
+
+void
+VulkanPresentThread::Signal::Wait(void)
+{
+    FUN_ENTRY(EGL_LOG_TRACE);
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mCondition.wait(lock, [this] { return mCount > 0; });
+    --mCount;
+}
+
+VulkanPresentThread::VulkanPresentThread(present_frame_cb_t presentFrameCb, void *presentFrameData)
+: mPresentFrameCb(presentFrameCb), mPresentFrameData(presentFrameData),
+  mQueued(0), mPresented(0), mCollected(0), mRunning(true)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    mThread = std::thread(&VulkanPresentThread::Run, this);
+}
+
+VulkanPresentThread::~VulkanPresentThread(void)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    // the queued frames are presented before the thread exits
+    mRunning.store(false);
+    mFrameQueued.Post();
+    mThread.join();
+}
+
+void
+VulkanPresentThread::Run(void)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    while(true) {
+        mFrameQueued.Wait();
+
+        uint32_t presented = mPresented.load(std::memory_order_relaxed);
+        if(presented == mQueued.load(std::memory_order_acquire)) {
+            if(!mRunning.load()) {
+                break;
+            }
+            continue;
+        }
+
+        mPresentFrameCb(mPresentFrameData, &mFrames[presented % EGL_PRESENT_QUEUE_DEPTH]);
+
+        mPresented.store(presented + 1, std::memory_order_release);
+        mFramePresented.Post();
+    }
+}
+
+VulkanPresentThread::frame_t *
+VulkanPresentThread::GetNextFrame(void)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    uint32_t queued = mQueued.load(std::memory_order_relaxed);
+    assert(queued - mCollected < EGL_PRESENT_QUEUE_DEPTH);
+
+    return &mFrames[queued % EGL_PRESENT_QUEUE_DEPTH];
+}
+
+void
+VulkanPresentThread::QueueFrame(void)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    mQueued.fetch_add(1, std::memory_order_release);
+    mFrameQueued.Post();
+}
+
+const VulkanPresentThread::frame_t *
+VulkanPresentThread::CollectFrame(void)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    assert(IsPending());
+
+    mFramePresented.Wait();
+
+    return &mFrames[mCollected++ % EGL_PRESENT_QUEUE_DEPTH];
+}
@@ -0,0 +1,106 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+
+/**
+ *  @file       vulkanPresentThread.h
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Thread that presents the frames of window surfaces and acquires their next images
+ *
+ */
+
+#ifndef __VULKAN_PRESENT_THREAD_H__
+#define __VULKAN_PRESENT_THREAD_H__
+
+#include "api/eglSurface.h"
+#include "utils/egl_defs.h"
+#include "utils/eglLogger.h"
+#include "vulkan/vulkan.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef DEBUG_DEPTH
+#   undef DEBUG_DEPTH
+#endif // DEBUG_DEPTH
+#define DEBUG_DEPTH                     EGL_LOG_DEBUG
+
+/// frames that may be queued to the present thread, a frame is collected before the next one is queued
+#define EGL_PRESENT_QUEUE_DEPTH         2
+
+class VulkanPresentThread
+{
+public:
+    typedef struct frame_t {
+        EGLSurface_t                   *surface;
+        uint32_t                        imageIndex;
+        std::vector<EGLint>             rects;
+        /// the present waits upon the first, the next image is acquired with the second
+        VkSemaphore                     waitSemaphore;
+        VkSemaphore                     acquireSemaphore;
+        /// set by the present thread, false when the swapchain has to be recreated
+        EGLBoolean                      acquired;
+        uint32_t                        nextImageIndex;
+    } frame_t;
+
+    typedef void (*present_frame_cb_t)(void *presentFrameData, frame_t *frame);
+
+private:
+    /// counts the frames handed over, for the side that waits for them to sleep on
+    class Signal {
+    private:
+        std::mutex                      mMutex;
+        std::condition_variable         mCondition;
+        uint32_t                        mCount;
+
+    public:
+        Signal() : mCount(0) { }
+        void                            Post(void);
+        void                            Wait(void);
+    };
+
+    present_frame_cb_t                  mPresentFrameCb;
+    void                               *mPresentFrameData;
+
+    /// a single producer and a single consumer ring, indexed by the running counts of the frames
+    frame_t                             mFrames[EGL_PRESENT_QUEUE_DEPTH];
+    std::atomic<uint32_t>               mQueued;
+    std::atomic<uint32_t>               mPresented;
+    uint32_t                            mCollected;
+    Signal                              mFrameQueued;
+    Signal                              mFramePresented;
+
+    std::atomic<bool>                   mRunning;
+    std::thread                         mThread;
+
+    void                                Run(void);
+
+public:
+    VulkanPresentThread(present_frame_cb_t presentFrameCb, void *presentFrameData);
+    ~VulkanPresentThread(void);
+
+    /// the frame to fill in on the calling thread before it is queued
+    frame_t                            *GetNextFrame(void);
+    void                                QueueFrame(void);
+    /// waits for the oldest queued frame to be presented and its next image acquired
+    const frame_t                      *CollectFrame(void);
+
+    inline bool                         IsPending(void)                   const { FUN_ENTRY(EGL_LOG_TRACE); return mCollected != mQueued.load(std::memory_order_relaxed); }
+};
+
+#endif // __VULKAN_PRESENT_THREAD_H__
@@ -22,10 +22,15 @@
  */
 
 #include "vulkanResources.h"
+#include <algorithm>
+#include <cstdio>
 
 VulkanResources::VulkanResources()
     : mSurface(VK_NULL_HANDLE), mSwapchain(VK_NULL_HANDLE),
-      mSwapChainImageCount(0), mSwapChainImages(nullptr)
+      mSwapChainImageCount(0), mSwapChainImages(nullptr), mSwapchainImageUsage(0),
+      mSwapchainPreTransform(VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR), mSwapchainSuboptimal(false),
+      mPresentId(0), mPresentIntervalSum(0), mPresentIntervalMin(UINT64_MAX),
+      mPresentIntervalMax(0), mPresentIntervalCount(0)
 {
     FUN_ENTRY(DEBUG_DEPTH);
 }
@@ -48,3 +53,31 @@ VulkanResources::Release(void)
         mSwapChainImageCount = 0;
    } 
 }
+
+void
+VulkanResources::RecordPresentTime(uint32_t reportFrames)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if(mLastPresentTime.time_since_epoch().count()) {
+        uint64_t interval = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - mLastPresentTime).count());
+        mPresentIntervalSum += interval;
+        mPresentIntervalMin  = std::min(mPresentIntervalMin, interval);
+        mPresentIntervalMax  = std::max(mPresentIntervalMax, interval);
+        ++mPresentIntervalCount;
+    }
+    mLastPresentTime = now;
+
+    if(mPresentIntervalCount >= reportFrames) {
+        printf("GLOVE present timing: %u frames, interval mean %.3f ms, min %.3f ms, max %.3f ms\n",
+               mPresentIntervalCount,
+               mPresentIntervalSum / 1e6 / mPresentIntervalCount,
+               mPresentIntervalMin / 1e6, mPresentIntervalMax / 1e6);
+
+        mPresentIntervalSum   = 0;
+        mPresentIntervalMin   = UINT64_MAX;
+        mPresentIntervalMax   = 0;
+        mPresentIntervalCount = 0;
+    }
+}
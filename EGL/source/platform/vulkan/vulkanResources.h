@@ -26,32 +26,66 @@
 
 #include "platform/platformResources.h"
 #include <vulkan/vulkan.h>
+#include <vector>
+#include <chrono>
 
 class VulkanResources : public PlatformResources
 {
+public:
+    /// a swapchain replaced by a recreation, destroyed once the fence submitted after its last frame has signaled
+    typedef struct RetiredSwapchain {
+        VkSwapchainKHR               swapchain;
+        VkImage                     *images;
+        VkFence                      fence;
+    } RetiredSwapchain;
+
 private:
     VkSurfaceKHR                     mSurface;
     VkSwapchainKHR                   mSwapchain;
     uint32_t                         mSwapChainImageCount;
     VkImage                         *mSwapChainImages;
+    VkImageUsageFlags                mSwapchainImageUsage;
+    VkSurfaceTransformFlagBitsKHR    mSwapchainPreTransform;
+    bool                             mSwapchainSuboptimal;
+    uint64_t                         mPresentId;
+    std::vector<RetiredSwapchain>    mRetiredSwapchains;
+
+    /// intervals between the presents since the last timing report, in nanoseconds
+    std::chrono::steady_clock::time_point mLastPresentTime;
+    uint64_t                         mPresentIntervalSum;
+    uint64_t                         mPresentIntervalMin;
+    uint64_t                         mPresentIntervalMax;
+    uint32_t                         mPresentIntervalCount;
 
 public:
     VulkanResources();
     ~VulkanResources() override;
 
            void                      Release();
+           void                      RecordPresentTime(uint32_t reportFrames);
 
     // Get Functions
     inline VkSurfaceKHR              GetSurface()                                   const { return mSurface; }
     inline VkSwapchainKHR            GetSwapchain()                                 const { return mSwapchain; }
     inline uint32_t                  GetSwapchainImageCount()                    override { return mSwapChainImageCount; }
     inline void *                    GetSwapchainImages()                        override { return reinterpret_cast<void *>(mSwapChainImages); }
+    inline uint32_t                  GetSwapchainImageUsage()                    override { return static_cast<uint32_t>(mSwapchainImageUsage); }
+    inline uint32_t                  GetSwapchainPreTransform()                  override { return static_cast<uint32_t>(mSwapchainPreTransform); }
+    inline std::vector<RetiredSwapchain> *GetRetiredSwapchains()                          { return &mRetiredSwapchains; }
+    inline uint64_t                  GetPresentId()                                 const { return mPresentId; }
+
+    // Is Functions
+    inline bool                      IsSwapchainSuboptimal()                        const { return mSwapchainSuboptimal; }
 
     // Set Functions
     inline void                      SetSurface(VkSurfaceKHR surface)                     { mSurface              = surface; }
     inline void                      SetSwapchain(VkSwapchainKHR swapchain)               { mSwapchain            = swapchain; }
     inline void                      SetSwapChainImageCount(uint32_t swapChainImageCount) { mSwapChainImageCount  = swapChainImageCount; }
     inline void                      SetSwapChainImages(VkImage *swapChainImages)         { mSwapChainImages      = swapChainImages; }
+    inline void                      SetSwapchainImageUsage(VkImageUsageFlags usage)      { mSwapchainImageUsage  = usage; }
+    inline void                      SetSwapchainPreTransform(VkSurfaceTransformFlagBitsKHR transform) { mSwapchainPreTransform = transform; }
+    inline void                      SetSwapchainSuboptimal(bool suboptimal)              { mSwapchainSuboptimal  = suboptimal; }
+    inline void                      SetPresentId(uint64_t presentId)                     { mPresentId            = presentId; }
 };
 
 #endif // #define __VULKAN_RESOURCES_H__
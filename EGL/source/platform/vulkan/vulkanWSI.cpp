@@ -57,5 +57,12 @@ VulkanWSI::SetWSICallbacks()
     GET_WSI_FUNCTION_PTR(mWsiCallbacks, AcquireNextImageKHR);
     GET_WSI_FUNCTION_PTR(mWsiCallbacks, QueuePresentKHR);
 
+#ifdef VK_KHR_present_wait
+    // VK_KHR_present_wait functions
+    if(mVkInterface->presentWaitSupported) {
+        mWsiCallbacks.fpWaitForPresentKHR = (PFN_vkWaitForPresentKHR) vkGetDeviceProcAddr(mVkInterface->vkDevice, "vkWaitForPresentKHR");
+    }
+#endif // VK_KHR_present_wait
+
     return EGL_TRUE;
 }
@@ -53,6 +53,10 @@ typedef struct wsiCallbacks {
     PFN_vkGetSwapchainImagesKHR                     fpGetSwapchainImagesKHR;
     PFN_vkAcquireNextImageKHR                       fpAcquireNextImageKHR;
     PFN_vkQueuePresentKHR                           fpQueuePresentKHR;
+#ifdef VK_KHR_present_wait
+    // VK_KHR_present_wait functions, if enabled on the device
+    PFN_vkWaitForPresentKHR                         fpWaitForPresentKHR;
+#endif // VK_KHR_present_wait
 } wsiCallbacks_t;
 
 protected:
@@ -69,6 +73,11 @@ public:
 
     virtual EGLBoolean                             Initialize();
     virtual VkSurfaceKHR                           CreateSurface(EGLDisplay_t* dpy, EGLNativeWindowType win, EGLSurface_t *surface) = 0;
+    virtual void                                   DestroySurface(EGLSurface_t *surface)            { }
+
+    /// frame scheduling around the presents, for the platforms whose compositor reports them
+    virtual void                                   BeginPresent(EGLSurface_t *surface)              { }
+    virtual void                                   ScheduleNextFrame(EGLSurface_t *surface)         { }
 
     inline void                                    SetVkInterface(const vkInterface_t* vkInterface) { mVkInterface = vkInterface; }
     const wsiCallbacks_t                           *GetWsiCallbacks() { return &mWsiCallbacks; }
@@ -22,11 +22,32 @@
  */
 
 #include "vulkanWindowInterface.h"
+#include <algorithm>
+#include <cstdlib>
+
+/// semaphores the frames queued to the present thread and their acquisitions rotate through
+#define EGL_PRESENT_SEMAPHORE_COUNT                     16
+
+static uint32_t
+GetEnvValue(const char *name, uint32_t defaultValue)
+{
+    const char *value = getenv(name);
+    return value ? static_cast<uint32_t>(strtoul(value, nullptr, 10)) : defaultValue;
+}
 
 VulkanWindowInterface::VulkanWindowInterface(void)
 : mVkInitialized(false), mGLES2Interface(nullptr), mVkAPI(nullptr), mVkWSI(nullptr)
 {
     FUN_ENTRY(DEBUG_DEPTH);
+
+    mSwapchainImageCount = GetEnvValue(EGL_SWAPCHAIN_IMAGES_ENV, EGL_SWAPCHAIN_IMAGE_COUNT);
+    mPresentTimingFrames = GetEnvValue(EGL_PRESENT_TIMING_ENV, EGL_PRESENT_TIMING_REPORT);
+    mPresentThreadEnabled = GetEnvValue(EGL_PRESENT_THREAD_ENV, EGL_PRESENT_THREAD) ? EGL_TRUE : EGL_FALSE;
+    mPreRotationEnabled   = GetEnvValue(EGL_PRE_ROTATION_ENV, EGL_PRE_ROTATION) ? EGL_TRUE : EGL_FALSE;
+    mPresentThread        = nullptr;
+    mNextSemaphore        = 0;
+    mApiAcquireSemaphore  = VK_NULL_HANDLE;
+    mApiDrawSemaphore     = VK_NULL_HANDLE;
 }
 
 VulkanWindowInterface::~VulkanWindowInterface(void)
@@ -53,11 +74,14 @@ VulkanWindowInterface::InitializeVulkanAPI()
 
         mVkWSI->SetVkInterface(mVkInterface);
 
-        if(mVkWSI->Initialize() == EGL_FALSE) {
-            return EGL_FALSE;
-        }
+        // without WSI only surfaceless contexts render, so there is nothing to present with
+        if(!mVkInterface->headless) {
+            if(mVkWSI->Initialize() == EGL_FALSE) {
+                return EGL_FALSE;
+            }
 
-        mVkAPI->SetWSICallbacks(mVkWSI->GetWsiCallbacks());
+            mVkAPI->SetWSICallbacks(mVkWSI->GetWsiCallbacks());
+        }
 
         mVkInitialized = true;
     }
@@ -71,6 +95,8 @@ VulkanWindowInterface::TerminateVulkanAPI()
     FUN_ENTRY(DEBUG_DEPTH);
 
     if(mVkAPI) {
+        // the rendering API destroys its own semaphores
+        StopPresentThread();
         RENDERING_API_terminate_gles2_api();
         delete mVkAPI;
     }
@@ -107,6 +133,26 @@ VulkanWindowInterface::SetSwapchainExtent(EGLSurface_t* surface, VkSurfaceCapabi
     return swapChainExtent;
 }
 
+VkSurfaceTransformFlagBitsKHR
+VulkanWindowInterface::SetSwapchainPreTransform(const VkSurfaceCapabilitiesKHR &surfCapabilities)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    // the rotations of the display are rendered by GLES, the other transforms are left to the presentation engine
+    const VkSurfaceTransformFlagBitsKHR currentTransform = surfCapabilities.currentTransform;
+    if(mPreRotationEnabled && (surfCapabilities.supportedTransforms & currentTransform) &&
+       (currentTransform == VK_SURFACE_TRANSFORM_ROTATE_90_BIT_KHR  ||
+        currentTransform == VK_SURFACE_TRANSFORM_ROTATE_180_BIT_KHR ||
+        currentTransform == VK_SURFACE_TRANSFORM_ROTATE_270_BIT_KHR)) {
+        return currentTransform;
+    }
+
+    if(surfCapabilities.supportedTransforms & VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR) {
+        return VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+    }
+    return currentTransform;
+}
+
 VkPresentModeKHR
 VulkanWindowInterface::SetSwapchainPresentMode(EGLSurface_t* surface)
 {
@@ -128,7 +174,17 @@ VulkanWindowInterface::SetSwapchainPresentMode(EGLSurface_t* surface)
 
     VkPresentModeKHR swapchainPresentMode = VK_PRESENT_MODE_FIFO_KHR;
     //Select the appropriate present mode
-    if(surface->GetSwapInterval() == 0) {
+    if(surface->GetSwapInterval() == 1 && EGL_PREFER_MAILBOX_PRESENT_MODE &&
+       EGL_MAX_PENDING_PRESENTS && mVkAPI->IsPresentWaitSupported()) {
+        // the latest frame replaces the queued one, which shortens the latency, while
+        // waiting upon the previous presents keeps eglSwapBuffers paced to the display
+        for(size_t i = 0; i < presentModeCount; i++) {
+            if(presentModes[i] == VK_PRESENT_MODE_MAILBOX_KHR) {
+                swapchainPresentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+                break;
+            }
+        }
+    } else if(surface->GetSwapInterval() == 0) {
         for(size_t i = 0; i < presentModeCount; i++) {
             //VK_PRESENT_MODE_MAILBOX_KHR, if supported, is prefered to VK_PRESENT_MODE_IMMEDIATE_KHR
             if(presentModes[i] == VK_PRESENT_MODE_MAILBOX_KHR) {
@@ -164,12 +220,22 @@ VulkanWindowInterface::SetSurfaceColorFormat(EGLSurface_t *surface)
     res = mVkAPI->GetPhysicalDevFormats(vkResources, formatCount, surfFormats);
     assert(res == EGL_TRUE);
 
+    // the configs of 16 bits render to 565 images where the surface takes them, which halves the bandwidth of the
+    // presented images; the others, and these where it does not, render to 8888 ones
+    const bool rgb565 = surface->IsRGB565() == EGL_TRUE;
+
     VkFormat format = VK_FORMAT_UNDEFINED;
     if(formatCount == 1 && surfFormats[0].format == VK_FORMAT_UNDEFINED) {
-        format = mVkDefaultFormat;
+        format = rgb565 ? VK_FORMAT_R5G6B5_UNORM_PACK16 : mVkDefaultFormat;
     } else {
         assert(formatCount >= 1);
-        for(uint32_t i = 0; i < formatCount; ++i) {
+        for(uint32_t i = 0; rgb565 && i < formatCount; ++i) {
+            if(surfFormats[i].format == VK_FORMAT_R5G6B5_UNORM_PACK16 && surfFormats[i].colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR) {
+                format = surfFormats[i].format;
+                break;
+            }
+        }
+        for(uint32_t i = 0; format == VK_FORMAT_UNDEFINED && i < formatCount; ++i) {
 #ifdef VK_USE_PLATFORM_ANDROID_KHR
             if (surfFormats[i].format == VK_FORMAT_R8G8B8A8_SRGB && surfFormats[i].colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR) {
                 format = surfFormats[i].format;
@@ -209,24 +275,55 @@ VulkanWindowInterface::CreateVkSwapchain(EGLSurface_t* surface,
 {
     FUN_ENTRY(DEBUG_DEPTH);
 
-    EGLBoolean ASSERT_ONLY wsiSuccess;
     /// Determine number of buffers
     assert(surfCapabilities.minImageCount >= 1);
-    uint32_t desiredNumberOfSwapChainImages = 2;
+    uint32_t desiredNumberOfSwapChainImages = mSwapchainImageCount;
+    if(desiredNumberOfSwapChainImages == 0) {
+        // MAILBOX needs a spare image to render to while one is queued and another is displayed
+        desiredNumberOfSwapChainImages = swapchainPresentMode == VK_PRESENT_MODE_MAILBOX_KHR ? 3 : 2;
+    }
+    desiredNumberOfSwapChainImages = std::max(desiredNumberOfSwapChainImages, surfCapabilities.minImageCount);
+    if(surfCapabilities.maxImageCount) {
+        desiredNumberOfSwapChainImages = std::min(desiredNumberOfSwapChainImages, surfCapabilities.maxImageCount);
+    }
 
     VulkanResources *vkResources = dynamic_cast<VulkanResources *>(surface->GetPlatformResources());
     assert(vkResources);
 
+    // the framebuffer fetch of GLES reads the color attachment as an input attachment and the
+    // framebuffer blits write to it as a transfer destination, where the surface allows them
+    VkImageUsageFlags imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                                   (surfCapabilities.supportedUsageFlags & (VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT));
+
+    // the extent of the surface is that of the display in its native orientation, the one of its images, which
+    // a rotation by a quarter turn swaps for the one the surface is seen with, unless the surface left it to the swapchain
+    VkSurfaceTransformFlagBitsKHR preTransform = SetSwapchainPreTransform(surfCapabilities);
+    if(preTransform == VK_SURFACE_TRANSFORM_ROTATE_90_BIT_KHR || preTransform == VK_SURFACE_TRANSFORM_ROTATE_270_BIT_KHR) {
+        if(surfCapabilities.currentExtent.width == (uint32_t)-1) {
+            std::swap(swapChainExtent.width, swapChainExtent.height);
+        } else {
+            surface->SetWidth(swapChainExtent.height);
+            surface->SetHeight(swapChainExtent.width);
+        }
+    }
+
+    // when recreated, the current swapchain is handed over to the new one and gets retired by it
     VkSwapchainKHR vkSwapchain = mVkAPI->CreateSwapchain(vkResources,
                                                          desiredNumberOfSwapChainImages,
                                                          surfCapabilities,
                                                          swapChainExtent,
                                                          swapchainPresentMode,
                                                          static_cast<VkFormat>(surface->GetColorFormat()),
-                                                         VK_NULL_HANDLE);
+                                                         imageUsage,
+                                                         preTransform,
+                                                         vkResources->GetSwapchain());
     assert(vkSwapchain != VK_NULL_HANDLE);
 
     vkResources->SetSwapchain(vkSwapchain);
+    vkResources->SetSwapchainImageUsage(imageUsage);
+    vkResources->SetSwapchainPreTransform(preTransform);
+    vkResources->SetSwapchainSuboptimal(false);
+    vkResources->SetPresentId(0);
 }
 
 EGLBoolean
@@ -234,6 +331,10 @@ VulkanWindowInterface::CreateSurface(EGLDisplay_t* dpy, EGLNativeWindowType win,
 {
     FUN_ENTRY(DEBUG_DEPTH);
 
+    if(mVkInterface->headless) {
+        return EGL_FALSE;
+    }
+
     VkSurfaceKHR newSurface = mVkWSI->CreateSurface(dpy, win, surface);
 
     if(VK_NULL_HANDLE == newSurface) {
@@ -297,18 +398,43 @@ VulkanWindowInterface::AcquireNextImage(EGLSurface_t *surface, uint32_t *imageIn
 {
     FUN_ENTRY(DEBUG_DEPTH);
 
-    const VulkanResources *vkResources = dynamic_cast<const VulkanResources *>(surface->GetPlatformResources());
+    VulkanResources *vkResources = dynamic_cast<VulkanResources *>(surface->GetPlatformResources());
     if(vkResources == nullptr) {
         return EGL_FALSE;
     }
 
-    VkResult res = mVkAPI->AcquireNextImage(vkResources, imageIndex);
-    if(res == VK_ERROR_OUT_OF_DATE_KHR || res == VK_SUBOPTIMAL_KHR) {
-        mVkAPI->DeviceWaitIdle();
+    // the present thread has acquired the image along with the present of the previous frame
+    if(mPresentThread && mPresentThread->IsPending()) {
+        EGLSurface_t *presentedSurface;
+        EGLBoolean acquired = CollectPresentedFrame(&presentedSurface);
+        if(presentedSurface == surface) {
+            *imageIndex = surface->GetCurrentImageIndex();
+            return acquired;
+        }
+    }
 
+    // an image acquired for another surface and never rendered to leaves its semaphore signaled
+    if(mPresentThread) {
+        if(mVkInterface->vkSyncItems->acquireSemaphoreFlag) {
+            mVkAPI->ConsumeVkSemaphore(mVkInterface->vkSyncItems->vkAcquireSemaphore);
+        }
+        mVkInterface->vkSyncItems->vkAcquireSemaphore = GetNextSemaphore();
+    }
+
+    VkResult res = mVkAPI->AcquireNextImage(vkResources, imageIndex);
+    if(res == VK_ERROR_OUT_OF_DATE_KHR) {
         return EGL_FALSE;
     }
 
+    // a suboptimal image can still be presented, so the frame is rendered to it
+    // and the swapchain is recreated once it has been presented
+    if(res == VK_SUBOPTIMAL_KHR) {
+        vkResources->SetSwapchainSuboptimal(true);
+    }
+
+    // the submission of the frame has to wait for the image to be released by the presentation engine
+    mVkInterface->vkSyncItems->acquireSemaphoreFlag = true;
+
     surface->SetCurrentImageIndex(*imageIndex);
 
     return EGL_TRUE;
@@ -319,7 +445,13 @@ VulkanWindowInterface::DestroySwapchain(EGLSurface_t *surface)
 {
     FUN_ENTRY(DEBUG_DEPTH);
 
+    FlushPresentThread();
+
     VulkanResources *vkResources = dynamic_cast<VulkanResources *>(surface->GetPlatformResources());
+    if(vkResources) {
+        ReleaseRetiredSwapchains(vkResources, true);
+    }
+
     if(vkResources && vkResources->GetSwapchain() != VK_NULL_HANDLE) {
         mVkAPI->DestroySwapchain(vkResources);
         vkResources->SetSwapchain(VK_NULL_HANDLE);
@@ -330,17 +462,42 @@ VulkanWindowInterface::DestroySwapchain(EGLSurface_t *surface)
     }
 }
 
+void
+VulkanWindowInterface::ReleaseRetiredSwapchains(VulkanResources *vkResources, bool wait)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    std::vector<VulkanResources::RetiredSwapchain> *retiredSwapchains = vkResources->GetRetiredSwapchains();
+    for(auto it = retiredSwapchains->begin(); it != retiredSwapchains->end();) {
+        if(wait) {
+            mVkAPI->WaitFence(it->fence);
+        } else if(mVkAPI->IsFenceSignaled(it->fence) == EGL_FALSE) {
+            ++it;
+            continue;
+        }
+
+        mVkAPI->DestroyFence(it->fence);
+        mVkAPI->DestroySwapchain(it->swapchain);
+        delete[] it->images;
+        it = retiredSwapchains->erase(it);
+    }
+}
+
 void
 VulkanWindowInterface::DestroySurface(EGLSurface_t *surface)
 {
     FUN_ENTRY(DEBUG_DEPTH);
 
+    FlushPresentThread();
+
     VulkanResources *vkResources = dynamic_cast<VulkanResources *>(surface->GetPlatformResources());
     if(vkResources && vkResources->GetSurface() != VK_NULL_HANDLE) {
         mVkAPI->DestroyPlatformSurface(vkResources);
         vkResources->SetSurface(VK_NULL_HANDLE);
         mGLES2Interface->delete_shared_surface_data_cb(surface->GetEGLSurfaceInterface());
     }
+
+    mVkWSI->DestroySurface(surface);
 }
 
 void
@@ -351,8 +508,43 @@ VulkanWindowInterface::DestroySurfaceImages(EGLSurface_t *surface)
     DestroySwapchain(surface);
 }
 
+void
+VulkanWindowInterface::RecreateSurfaceImages(EGLSurface_t *surface)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    FlushPresentThread();
+
+    VulkanResources *vkResources = dynamic_cast<VulkanResources *>(surface->GetPlatformResources());
+    assert(vkResources);
+
+    ReleaseRetiredSwapchains(vkResources, false);
+
+    // the frames in flight may still be rendering to the old images, so rather than waiting for the
+    // device, the old swapchain is kept along with a fence that signals once they have completed
+    VulkanResources::RetiredSwapchain retired;
+    retired.swapchain = vkResources->GetSwapchain();
+    retired.images    = static_cast<VkImage *>(vkResources->GetSwapchainImages());
+    retired.fence     = mVkAPI->SubmitFence();
+    if(retired.fence == VK_NULL_HANDLE) {
+        mVkAPI->DeviceWaitIdle();
+    }
+
+    vkResources->SetSwapChainImages(nullptr);
+    vkResources->SetSwapChainImageCount(0);
+
+    AllocateSurfaceImages(surface);
+
+    if(retired.swapchain != VK_NULL_HANDLE) {
+        vkResources->GetRetiredSwapchains()->push_back(retired);
+    } else {
+        mVkAPI->DestroyFence(retired.fence);
+        delete[] retired.images;
+    }
+}
+
 EGLBoolean
-VulkanWindowInterface::PresentImage(EGLSurface_t *surface)
+VulkanWindowInterface::PresentImage(EGLSurface_t *surface, const EGLint *rects, EGLint rectCount)
 {
     FUN_ENTRY(DEBUG_DEPTH);
 
@@ -363,20 +555,243 @@ VulkanWindowInterface::PresentImage(EGLSurface_t *surface)
         pSems.push_back(mVkInterface->vkSyncItems->vkAcquireSemaphore);
     }
 
-    mVkInterface->vkSyncItems->acquireSemaphoreFlag = true;
+    // the semaphores are consumed by the present, the acquire semaphore is
+    // signaled again once the next image has been acquired
+    mVkInterface->vkSyncItems->acquireSemaphoreFlag = false;
     mVkInterface->vkSyncItems->drawSemaphoreFlag = false;
 
-    uint32_t imageIndex = surface->GetCurrentImageIndex();
-    VkResult res = mVkAPI->PresentImage(dynamic_cast<const VulkanResources *>(surface->GetPlatformResources()), imageIndex, pSems);
-    if(res == VK_ERROR_OUT_OF_DATE_KHR || res == VK_SUBOPTIMAL_KHR) {
-        mVkAPI->DeviceWaitIdle();
+    return PresentSurfaceImage(surface, surface->GetCurrentImageIndex(), pSems, rects, rectCount);
+}
+
+EGLBoolean
+VulkanWindowInterface::PresentSurfaceImage(EGLSurface_t *surface, uint32_t imageIndex, std::vector<VkSemaphore> &pSems,
+                                           const EGLint *rects, EGLint rectCount)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    VulkanResources *vkResources = dynamic_cast<VulkanResources *>(surface->GetPlatformResources());
 
+    // presents are identified when eglSwapBuffers is paced with VK_KHR_present_wait
+    bool paced = EGL_MAX_PENDING_PRESENTS && surface->GetSwapInterval() > 0 && mVkAPI->IsPresentWaitSupported();
+    uint64_t presentId = paced ? vkResources->GetPresentId() + 1 : 0;
+
+    // a swap interval of 0 renders as fast as possible, not in step with the compositor
+    bool scheduled = surface->GetSwapInterval() > 0;
+    if(scheduled) {
+        mVkWSI->BeginPresent(surface);
+    }
+
+    // the damaged regions let the compositor or display update only the parts of the image that changed
+    std::vector<VkRectLayerKHR> regions;
+    if(mVkInterface->incrementalPresentSupported) {
+        const EGLint width  = surface->GetWidth();
+        const EGLint height = surface->GetHeight();
+        for(EGLint i = 0; i < rectCount; ++i) {
+            const EGLint *rect = &rects[4 * i];
+            const EGLint x0 = std::max(rect[0], 0);
+            const EGLint y0 = std::max(rect[1], 0);
+            const EGLint x1 = std::min(rect[0] + rect[2], width);
+            const EGLint y1 = std::min(rect[1] + rect[3], height);
+            if(x1 <= x0 || y1 <= y0) {
+                continue;
+            }
+
+            VkRectLayerKHR region;
+            region.offset.x      = x0;
+            region.offset.y      = height - y1;
+            region.extent.width  = static_cast<uint32_t>(x1 - x0);
+            region.extent.height = static_cast<uint32_t>(y1 - y0);
+            region.layer         = 0;
+            regions.push_back(region);
+        }
+    }
+
+    VkResult res = mVkAPI->PresentImage(vkResources, imageIndex, pSems, presentId, &regions);
+    if(res == VK_SUBOPTIMAL_KHR) {
+        vkResources->SetSwapchainSuboptimal(true);
+    }
+
+    if(paced && (res == VK_SUCCESS || res == VK_SUBOPTIMAL_KHR)) {
+        vkResources->SetPresentId(presentId);
+
+        // bounds the input-to-photon latency by returning only once the earlier presents have reached
+        // the display; the timeout keeps the application running when the window is not visible
+        if(presentId > EGL_MAX_PENDING_PRESENTS) {
+            mVkAPI->WaitForPresent(vkResources, presentId - EGL_MAX_PENDING_PRESENTS, EGL_PRESENT_WAIT_TIMEOUT);
+        }
+    }
+
+    if(mPresentTimingFrames && (res == VK_SUCCESS || res == VK_SUBOPTIMAL_KHR)) {
+        vkResources->RecordPresentTime(mPresentTimingFrames);
+    }
+
+    if(scheduled && (res == VK_SUCCESS || res == VK_SUBOPTIMAL_KHR)) {
+        mVkWSI->ScheduleNextFrame(surface);
+    }
+
+    ReleaseRetiredSwapchains(vkResources, false);
+
+    // a swapchain that has become suboptimal, also when the image of this frame was acquired,
+    // is recreated now that its frame has been presented
+    if(res == VK_ERROR_OUT_OF_DATE_KHR || vkResources->IsSwapchainSuboptimal()) {
+        return EGL_FALSE;
+    }
+
+    return EGL_TRUE;
+}
+
+EGLBoolean
+VulkanWindowInterface::QueuePresentImage(EGLSurface_t *surface, const EGLint *rects, EGLint rectCount)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    if(!mPresentThreadEnabled) {
+        return PresentImage(surface, rects, rectCount);
+    }
+
+    if(mPresentThread == nullptr) {
+        StartPresentThread();
+    }
+
+    // the image of the previous frame has been collected at its first use, or on this thread
+    // at the latest by eglSwapBuffers, so a single frame is ever queued
+    FlushPresentThread();
+
+    VulkanPresentThread::frame_t *frame = mPresentThread->GetNextFrame();
+    frame->surface    = surface;
+    frame->imageIndex = surface->GetCurrentImageIndex();
+    frame->rects.assign(rects, rects + 4 * rectCount);
+
+    // the semaphore the present waits upon belongs to the present thread from now on, so the
+    // submissions of the next frame chain with another one, as does its acquisition
+    vkSyncItems_t *syncItems = mVkInterface->vkSyncItems;
+    if(syncItems->drawSemaphoreFlag) {
+        frame->waitSemaphore        = syncItems->vkDrawSemaphore;
+        syncItems->vkDrawSemaphore  = GetNextSemaphore();
+    } else {
+        frame->waitSemaphore          = syncItems->vkAcquireSemaphore;
+        syncItems->vkAcquireSemaphore = GetNextSemaphore();
+    }
+    frame->acquireSemaphore         = GetNextSemaphore();
+    syncItems->acquireSemaphoreFlag = false;
+    syncItems->drawSemaphoreFlag    = false;
+
+    mPresentThread->QueueFrame();
+
+    // a failed present or acquisition is reported when the next image is collected
+    return EGL_TRUE;
+}
+
+void
+VulkanWindowInterface::PresentFrameCallback(void *presentFrameData, VulkanPresentThread::frame_t *frame)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    VulkanWindowInterface *windowInterface = reinterpret_cast<VulkanWindowInterface *>(presentFrameData);
+    VulkanResources *vkResources = dynamic_cast<VulkanResources *>(frame->surface->GetPlatformResources());
+
+    std::vector<VkSemaphore> pSems(1, frame->waitSemaphore);
+    frame->acquired = EGL_FALSE;
+    if(windowInterface->PresentSurfaceImage(frame->surface, frame->imageIndex, pSems, frame->rects.data(),
+                                            static_cast<EGLint>(frame->rects.size() / 4)) == EGL_FALSE) {
+        return;
+    }
+
+    VkResult res = windowInterface->mVkAPI->AcquireNextImage(vkResources, &frame->nextImageIndex, frame->acquireSemaphore);
+    if(res == VK_SUBOPTIMAL_KHR) {
+        vkResources->SetSwapchainSuboptimal(true);
+    }
+    frame->acquired = (res == VK_SUCCESS || res == VK_SUBOPTIMAL_KHR) ? EGL_TRUE : EGL_FALSE;
+}
+
+EGLBoolean
+VulkanWindowInterface::CollectPresentedFrame(EGLSurface_t **surface)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    const VulkanPresentThread::frame_t *frame = mPresentThread->CollectFrame();
+    *surface = frame->surface;
+    if(frame->acquired == EGL_FALSE) {
         return EGL_FALSE;
     }
 
+    // as if the image had been acquired at the end of eglSwapBuffers, also when another surface is current by now
+    mVkInterface->vkSyncItems->vkAcquireSemaphore   = frame->acquireSemaphore;
+    mVkInterface->vkSyncItems->acquireSemaphoreFlag = true;
+    frame->surface->SetCurrentImageIndex(frame->nextImageIndex);
+    frame->surface->GetEGLSurfaceInterface()->nextImageIndex = frame->nextImageIndex;
+    frame->surface->GetEGLSurfaceInterface()->imageAcquired  = 1;
+
     return EGL_TRUE;
 }
 
+void
+VulkanWindowInterface::FlushPresentThread(void)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    EGLSurface_t *surface;
+    while(mPresentThread && mPresentThread->IsPending()) {
+        CollectPresentedFrame(&surface);
+    }
+}
+
+void
+VulkanWindowInterface::StartPresentThread(void)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    mApiAcquireSemaphore = mVkInterface->vkSyncItems->vkAcquireSemaphore;
+    mApiDrawSemaphore    = mVkInterface->vkSyncItems->vkDrawSemaphore;
+
+    // a semaphore is reused once the frames in flight and the ones of the swapchain images
+    // before it have long completed, which keeps the present thread free of fences
+    mSemaphoreRing.resize(EGL_PRESENT_SEMAPHORE_COUNT);
+    for(VkSemaphore &semaphore : mSemaphoreRing) {
+        semaphore = mVkAPI->CreateVkSemaphore();
+    }
+    mNextSemaphore = 0;
+
+    mPresentThread = new VulkanPresentThread(PresentFrameCallback, reinterpret_cast<void *>(this));
+}
+
+void
+VulkanWindowInterface::StopPresentThread(void)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    if(mPresentThread == nullptr) {
+        return;
+    }
+
+    FlushPresentThread();
+    delete mPresentThread;
+    mPresentThread = nullptr;
+
+    mVkAPI->DeviceWaitIdle();
+
+    mVkInterface->vkSyncItems->vkAcquireSemaphore   = mApiAcquireSemaphore;
+    mVkInterface->vkSyncItems->vkDrawSemaphore      = mApiDrawSemaphore;
+    mVkInterface->vkSyncItems->acquireSemaphoreFlag = false;
+    mVkInterface->vkSyncItems->drawSemaphoreFlag    = false;
+
+    for(VkSemaphore semaphore : mSemaphoreRing) {
+        mVkAPI->DestroyVkSemaphore(semaphore);
+    }
+    mSemaphoreRing.clear();
+}
+
+VkSemaphore
+VulkanWindowInterface::GetNextSemaphore(void)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    VkSemaphore semaphore = mSemaphoreRing[mNextSemaphore];
+    mNextSemaphore = (mNextSemaphore + 1) % static_cast<uint32_t>(mSemaphoreRing.size());
+
+    return semaphore;
+}
+
 EGLBoolean
 VulkanWindowInterface::Initialize()
 {
@@ -26,6 +26,7 @@
 
 #include "platform/platformWindowInterface.h"
 #include "vulkanAPI.h"
+#include "vulkanPresentThread.h"
 
 #ifdef DEBUG_DEPTH
 #   undef DEBUG_DEPTH
@@ -44,6 +45,22 @@ private:
 
     const VkFormat               mVkDefaultFormat = VK_FORMAT_B8G8R8A8_UNORM;
 
+    /// EGL_SWAPCHAIN_IMAGE_COUNT and EGL_PRESENT_TIMING_REPORT, overridable through the environment
+    uint32_t                     mSwapchainImageCount;
+    uint32_t                     mPresentTimingFrames;
+
+    /// EGL_PRESENT_THREAD, overridable through the environment. The thread starts at the first present
+    EGLBoolean                   mPresentThreadEnabled;
+    /// EGL_PRE_ROTATION, overridable through the environment
+    EGLBoolean                   mPreRotationEnabled;
+    VulkanPresentThread         *mPresentThread;
+    /// the present of a queued frame and the acquisition of the next image take semaphores of their own
+    /// from this ring, in place of the ones of the rendering API, which are restored on termination
+    std::vector<VkSemaphore>     mSemaphoreRing;
+    uint32_t                     mNextSemaphore;
+    VkSemaphore                  mApiAcquireSemaphore;
+    VkSemaphore                  mApiDrawSemaphore;
+
     EGLBoolean                   InitializeVulkanAPI();
     void                         TerminateVulkanAPI();
     EGLBoolean                   InitSwapchainExtension(const EGLSurface_t *surface);
@@ -51,10 +68,22 @@ private:
 
     void                         CreateSwapchain(EGLSurface_t *surface);
     void                         DestroySwapchain(EGLSurface_t *surface);
+    void                         ReleaseRetiredSwapchains(VulkanResources *vkResources, bool wait);
 
     VkPresentModeKHR             SetSwapchainPresentMode(EGLSurface_t* surface);
+    VkSurfaceTransformFlagBitsKHR SetSwapchainPreTransform(const VkSurfaceCapabilitiesKHR &surfCapabilities);
     void                         SetSurfaceColorFormat(EGLSurface_t *surface);
 
+    EGLBoolean                   PresentSurfaceImage(EGLSurface_t *surface, uint32_t imageIndex, std::vector<VkSemaphore> &waitSemaphores,
+                                                     const EGLint *rects, EGLint rectCount);
+
+    void                         StartPresentThread(void);
+    void                         StopPresentThread(void);
+    VkSemaphore                  GetNextSemaphore(void);
+    EGLBoolean                   CollectPresentedFrame(EGLSurface_t **surface);
+    void                         FlushPresentThread(void);
+    static void                  PresentFrameCallback(void *presentFrameData, VulkanPresentThread::frame_t *frame);
+
     void                         CreateVkSwapchain(EGLSurface_t* surface,
                                                    VkPresentModeKHR swapchainPresentMode,
                                                    VkExtent2D swapChainExtent,
@@ -69,9 +98,12 @@ public:
     EGLBoolean                   CreateSurface(EGLDisplay_t* dpy, EGLNativeWindowType win, EGLSurface_t *surface) override;
     void                         AllocateSurfaceImages(EGLSurface_t *surface) override;
     void                         DestroySurfaceImages(EGLSurface_t *surface) override;
+    void                         RecreateSurfaceImages(EGLSurface_t *surface) override;
     void                         DestroySurface(EGLSurface_t *surface) override;
     EGLBoolean                   AcquireNextImage(EGLSurface_t *surface, uint32_t *imageIndex) override;
-    EGLBoolean                   PresentImage(EGLSurface_t *surface) override;
+    EGLBoolean                   PresentImage(EGLSurface_t *surface, const EGLint *rects, EGLint rectCount) override;
+    EGLBoolean                   QueuePresentImage(EGLSurface_t *surface, const EGLint *rects, EGLint rectCount) override;
+    inline EGLBoolean            IsPresentAsync(void)                     const override { return mPresentThreadEnabled; }
 
     /// Set Functions
     inline void                  SetWSI(VulkanWSI *vkWSI)                       { mVkWSI = vkWSI; }
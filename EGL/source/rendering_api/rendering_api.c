@@ -49,16 +49,24 @@ system's GLESv2.
     #define GLESv2_INTERFACE_NAME "GLES2Interface"
 #endif //VK_USE_PLATFORM_ANDROID_KHR
 
+/* the symbols of the library are bound as they are first called, so that loading it
+   does not resolve the hundreds of entry points an application may never call */
+#ifndef WIN32
+#define RENDERING_API_DLOPEN_FLAGS RTLD_LAZY
+#endif
+
 typedef struct rendering_api_library_info {
     bool initialized;
     bool loaded;
     void *handle;
     int refCount;
+    /* the library stays resident once loaded, and so does its entry point lookup */
+    get_proc_addr_cb_t get_proc_addr;
 } rendering_api_library_info_t;
 
-static rendering_api_library_info_t gles1_library_info = { false, false, NULL, 0 };
-static rendering_api_library_info_t gles2_library_info = { false, false, NULL, 0 };
-static rendering_api_library_info_t vg_library_info    = { false, false, NULL, 0 };
+static rendering_api_library_info_t gles1_library_info = { false, false, NULL, 0, NULL };
+static rendering_api_library_info_t gles2_library_info = { false, false, NULL, 0, NULL };
+static rendering_api_library_info_t vg_library_info    = { false, false, NULL, 0, NULL };
 
 static rendering_api_interface_t *gles1_interface = NULL;
 static rendering_api_interface_t *gles2_interface = NULL;
@@ -106,10 +114,13 @@ static rendering_api_return_e rendering_api_get_api_interface(const char *librar
     }
 
 #ifndef WIN32
-    library_info->handle = dlopen(library_name, RTLD_NOW);
+    /* a library terminated earlier is still resident, see rendering_terminate_api */
     if(!library_info->handle) {
-        fprintf(stderr, "%s\n", dlerror());
-        return RENDERING_API_NOT_FOUND;
+        library_info->handle = dlopen(library_name, RENDERING_API_DLOPEN_FLAGS);
+        if(!library_info->handle) {
+            fprintf(stderr, "%s\n", dlerror());
+            return RENDERING_API_NOT_FOUND;
+        }
     }
 
     dlerror();
@@ -118,6 +129,7 @@ static rendering_api_return_e rendering_api_get_api_interface(const char *librar
 
     if(!api_interface || !api_interface->init_API_cb) {
         dlclose(library_info->handle);
+        library_info->handle = NULL;
         char* error = dlerror();
         if(error)  {
             fprintf(stderr, "%s\n", error);
@@ -137,7 +149,9 @@ static rendering_api_return_e rendering_api_get_api_interface(const char *librar
     GetModuleFileName((HINSTANCE)& __ImageBase, DllPath, _countof(DllPath));
     char* r = strrchr(DllPath, '\\');
     strcpy(r + 1, library_name);
-    library_info->handle = LoadLibrary(DllPath);
+    if (!library_info->handle) {
+        library_info->handle = LoadLibrary(DllPath);
+    }
     if (!library_info->handle) {
         library_info->handle = LoadLibrary(library_name);
         if (!library_info->handle) {
@@ -152,6 +166,7 @@ static rendering_api_return_e rendering_api_get_api_interface(const char *librar
     api_interface = get_api_interface();
 #endif
 
+    library_info->get_proc_addr = api_interface->get_proc_addr_cb;
     library_info->loaded = true;
     *api_interface_ret = api_interface;
 
@@ -280,24 +295,41 @@ static bool rendering_terminate_api(rendering_api_interface_t *api_interface, re
         api_interface->terminate_API_cb();
     }
 
-#ifndef WIN32
-    dlclose(library_info->handle);
-    char* error = dlerror();
-    if(error)  {
-        fprintf(stderr, "%s\n", error);
-        return false;
-    }
-#else
-	FreeLibrary(library_info->handle);
-#endif
-
+    /* the library is not unloaded, as it may keep its device and caches alive
+       for the next eglInitialize of the process, and is reused by it */
     library_info->loaded = false;
     library_info->initialized = false;
-    library_info->handle = NULL;
     return true;
 }
 
 
+GLPROC RENDERING_API_get_proc_addr(EGLenum api, uint32_t client_version, const char *procname)
+{
+    rendering_api_interface_t *api_interface = NULL;
+    rendering_api_library_info_t *library_info = NULL;
+    const char *api_library_name = NULL;
+    const char *api_interface_name = NULL;
+
+    if(RENDERING_API_get_api_properties(api, client_version, &api_interface,
+                                        &library_info, &api_library_name, &api_interface_name) == RENDERING_API_INPUT_ERROR) {
+        return NULL;
+    }
+
+    /* the library is loaded for the first lookup only, without keeping the reference taken */
+    if(!library_info->get_proc_addr) {
+        if(rendering_api_get_api_interface(api_library_name, api_interface_name, &api_interface, library_info) != RENDERING_API_LOAD_SUCCESS) {
+            return NULL;
+        }
+        rendering_api_cache_interface(api_interface, client_version, api);
+
+        if(rendering_terminate_api(api_interface, library_info)) {
+            rendering_api_cache_interface(NULL, client_version, api);
+        }
+    }
+
+    return library_info->get_proc_addr ? library_info->get_proc_addr(procname) : NULL;
+}
+
 rendering_api_interface_t *RENDERING_API_get_gles1_interface()
 {
     return gles1_interface;
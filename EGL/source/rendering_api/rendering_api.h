@@ -48,6 +48,8 @@ rendering_api_interface_t *RENDERING_API_get_gles2_interface();
 rendering_api_interface_t *RENDERING_API_get_vg_interface();
 rendering_api_return_e     RENDERING_API_init_api(EGLenum api, uint32_t client_version, rendering_api_interface_t **api_interface_ret);
 rendering_api_return_e     RENDERING_API_load_api(EGLenum api, uint32_t client_version, rendering_api_interface_t **api_interface_ret);
+/* entry point of the client API, whose library is loaded for the first lookup only */
+GLPROC                     RENDERING_API_get_proc_addr(EGLenum api, uint32_t client_version, const char *procname);
 void                       RENDERING_API_terminate_gles1_api();
 void                       RENDERING_API_terminate_gles2_api();
 void                       RENDERING_API_terminate_vg_api();
@@ -202,7 +202,7 @@ RenderingThread::CreateContext(DisplayDriver* eglDriver, EGLConfig_t* eglConfig,
         return EGL_NO_CONTEXT;
     }
 
-    return eglDriver->CreateContext(mCurrentAPI, eglConfig, attrib_list);
+    return eglDriver->CreateContext(mCurrentAPI, eglConfig, eglShareContext, attrib_list);
 }
 
 EGLBoolean
@@ -247,6 +247,9 @@ RenderingThread::QueryContext(DisplayDriver* eglDriver, EGLContext_t* eglContext
         case EGL_RENDER_BUFFER:
             *value = eglContext->GetRenderBuffer();
             break;
+        case EGL_CONTEXT_PRIORITY_LEVEL_IMG:
+            *value = eglContext->GetPriority();
+            break;
         default:
             currentThread.RecordError(EGL_BAD_ATTRIBUTE);
             return EGL_FALSE;
@@ -258,9 +261,10 @@ RenderingThread::QueryContext(DisplayDriver* eglDriver, EGLContext_t* eglContext
 EGLBoolean
 RenderingThread::ValidateCurrentContext(DisplayDriver* eglDriver, EGLSurface_t* drawSurface, EGLSurface_t* readSurface, EGLContext_t* eglContext)
 {
-    // generate EGL_BAD_MATCH if EGL_NO_CONTEXT and EGL_NO_SURFACE are not specified together
+    // generate EGL_BAD_MATCH if EGL_NO_CONTEXT and EGL_NO_SURFACE are not specified together,
+    // a context is made current without surfaces only if both are EGL_NO_SURFACE (EGL_KHR_surfaceless_context)
     if((eglContext == EGL_NO_CONTEXT && (drawSurface != EGL_NO_SURFACE || readSurface != EGL_NO_SURFACE)) ||
-       (eglContext != EGL_NO_CONTEXT && (drawSurface == EGL_NO_SURFACE || readSurface == EGL_NO_SURFACE))) {
+       (eglContext != EGL_NO_CONTEXT && (drawSurface == EGL_NO_SURFACE) != (readSurface == EGL_NO_SURFACE))) {
         currentThread.RecordError(EGL_BAD_MATCH);
         return EGL_FALSE;
     }
@@ -284,13 +288,6 @@ RenderingThread::ValidateCurrentContext(DisplayDriver* eglDriver, EGLSurface_t*
         currentThread.RecordError(EGL_BAD_MATCH);
     }
 
-    // generate EGL_BAD_MATCH if EGL_NO_CONTEXT and EGL_NO_SURFACE are not specified together
-    if((eglContext == EGL_NO_CONTEXT && (drawSurface != EGL_NO_SURFACE || readSurface != EGL_NO_SURFACE)) ||
-       (eglContext != EGL_NO_CONTEXT && drawSurface == EGL_NO_SURFACE && readSurface == EGL_NO_SURFACE)) {
-        currentThread.RecordError(EGL_BAD_MATCH);
-        return EGL_FALSE;
-    }
-
     // TODO:: If ctx is current to some other thread, or if either draw or read are bound to
     // contexts in another thread, an EGL_BAD_ACCESS error is generated.
 
@@ -325,10 +322,12 @@ RenderingThread::MakeCurrent(DisplayDriver* eglDriver, EGLDisplay_t* dpy, EGLSur
         return EGL_FALSE;
     }
 
-    // Flush commands when changing contexts of the same client API type
+    // Flush commands when changing contexts of the same client API type. Waiting for
+    // them is not needed, as the objects they use are released once their submission
+    // is retired and the contexts and surfaces wait for the device when destroyed
     EGLContext_t* currentContext = GetCurrentContext();
     if(currentContext && currentContext != eglContext) {
-        currentContext->Finish();
+        currentContext->Flush();
     }
 
    UpdateCurrentContextResourcesRef(currentContext, false);
@@ -64,6 +64,6 @@ public:
     EGLBoolean              WaitNative(EGLint engine);
 };
 
-extern RenderingThread currentThread;
+extern thread_local RenderingThread currentThread;
 
 #endif // __RENDERINGTHREAD_H__
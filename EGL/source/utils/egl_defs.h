@@ -37,6 +37,70 @@
 
 #define EGL_FENCE_WAIT_TIMEOUT                         UINT64_MAX
 
+/// swapchain images of window surfaces; 0 picks three for MAILBOX and two otherwise
+#ifndef EGL_SWAPCHAIN_IMAGE_COUNT
+#   define EGL_SWAPCHAIN_IMAGE_COUNT                    0
+#endif // EGL_SWAPCHAIN_IMAGE_COUNT
+
+/// prefer MAILBOX to FIFO for a swap interval of 1, when presents can be paced with VK_KHR_present_wait
+#ifndef EGL_PREFER_MAILBOX_PRESENT_MODE
+#   define EGL_PREFER_MAILBOX_PRESENT_MODE              false
+#endif // EGL_PREFER_MAILBOX_PRESENT_MODE
+
+/// presents eglSwapBuffers may run ahead of the display when paced with VK_KHR_present_wait, 0 disables the pacing
+#ifndef EGL_MAX_PENDING_PRESENTS
+#   define EGL_MAX_PENDING_PRESENTS                     1
+#endif // EGL_MAX_PENDING_PRESENTS
+
+#define EGL_PRESENT_WAIT_TIMEOUT                       100000000ull // 100ms
+
+/// acquire the next image of window surfaces at its first use in the frame rather than at the end of eglSwapBuffers
+#ifndef EGL_LAZY_IMAGE_ACQUIRE
+#   define EGL_LAZY_IMAGE_ACQUIRE                       false
+#endif // EGL_LAZY_IMAGE_ACQUIRE
+
+/// eglSwapBuffers hands the present of window surfaces and the acquisition of their next image to a thread
+/// of its own, so that the next frame starts right away and waits for its image only at its first use
+#ifndef EGL_PRESENT_THREAD
+#   define EGL_PRESENT_THREAD                           false
+#endif // EGL_PRESENT_THREAD
+
+/// eglSwapBuffers on Wayland surfaces waits for the frame callback of the previous frame, and with wp_presentation
+/// starts the next frame just in time to be presented at the next refresh, this margin ahead; 0 disables the delay
+#ifndef EGL_WAYLAND_FRAME_SCHEDULING
+#   define EGL_WAYLAND_FRAME_SCHEDULING                 true
+#endif // EGL_WAYLAND_FRAME_SCHEDULING
+#ifndef EGL_WAYLAND_FRAME_MARGIN
+#   define EGL_WAYLAND_FRAME_MARGIN                     2000000ull // 2ms
+#endif // EGL_WAYLAND_FRAME_MARGIN
+
+/// window surfaces are rendered in the orientation of the display, as the surface reports it, and presented with
+/// that transform, so that the presentation engine does not have to rotate each frame (VK_SUBOPTIMAL_KHR on Android)
+#ifndef EGL_PRE_ROTATION
+#   define EGL_PRE_ROTATION                             true
+#endif // EGL_PRE_ROTATION
+
+/// report the mean, min and max interval between the presents of window surfaces every this many frames, 0 disables it
+#ifndef EGL_PRESENT_TIMING_REPORT
+#   define EGL_PRESENT_TIMING_REPORT                    0
+#endif // EGL_PRESENT_TIMING_REPORT
+
+/// environment overrides of the above and of the display plane path
+#define EGL_SWAPCHAIN_IMAGES_ENV                        "GLOVE_SWAPCHAIN_IMAGES"
+#define EGL_PRESENT_TIMING_ENV                          "GLOVE_PRESENT_TIMING"
+#define EGL_PRESENT_THREAD_ENV                          "GLOVE_PRESENT_THREAD"
+#define EGL_PRE_ROTATION_ENV                            "GLOVE_PRE_ROTATION"
+#define EGL_DIRECT_DISPLAY_ENV                          "GLOVE_DIRECT_DISPLAY"
+#define EGL_DISPLAY_INDEX_ENV                           "GLOVE_DISPLAY_INDEX"
+#define EGL_DISPLAY_MODE_ENV                            "GLOVE_DISPLAY_MODE"
+#define EGL_DISPLAY_PLANE_ENV                           "GLOVE_DISPLAY_PLANE"
+
+/// a window config of 16 bits, which renders to 565 images where the surface takes them; following the sorting of
+/// eglChooseConfig, it comes ahead of the 8888 ones for applications that ask for no color sizes
+#ifndef EGL_RGB565_CONFIG
+#   define EGL_RGB565_CONFIG                            true
+#endif // EGL_RGB565_CONFIG
+
 #ifndef EGL_SUPPORT_ONLY_PBUFFER_SURFACE
 #   define EGL_SUPPORT_ONLY_PBUFFER_SURFACE            0
 #else
@@ -0,0 +1,99 @@
+#ifndef __gl2ext_glove_h_
+#define __gl2ext_glove_h_ 1
+
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/*
+ * Extensions specific to GLOVE, in the layout of gl2ext.h.
+ */
+
+#include <GLES2/gl2.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * GL_GLOVE_memory_report
+ *
+ * Writes a JSON report of the device memory held per GL object category and
+ * per heap, with its peak since the peaks were last reset, and of the host
+ * memory held for buffers and programs. <length> returns the length of the
+ * whole report without its terminator, so that a call with a <bufSize> of 0
+ * sizes the buffer; at most <bufSize> - 1 characters are written to
+ * <report>, followed by a terminator. The peaks restart from the current
+ * usage once the report is taken when <resetPeaks> is GL_TRUE, which the
+ * sizing call should therefore leave GL_FALSE.
+ */
+#ifndef GL_GLOVE_memory_report
+#define GL_GLOVE_memory_report 1
+typedef void (GL_APIENTRYP PFNGLGETMEMORYREPORTGLOVEPROC) (GLboolean resetPeaks, GLsizei bufSize, GLsizei *length, GLchar *report);
+#ifdef GL_GLEXT_PROTOTYPES
+GL_APICALL void GL_APIENTRY glGetMemoryReportGLOVE (GLboolean resetPeaks, GLsizei bufSize, GLsizei *length, GLchar *report);
+#endif
+#endif /* GL_GLOVE_memory_report */
+
+/*
+ * GL_GLOVE_draw_range_elements
+ *
+ * glDrawRangeElements of OpenGL ES 3.0, ahead of it. <start> and <end> are
+ * the lowest and highest index that the indices of the draw hold, so that
+ * the client arrays are copied for these vertices only and the indices are
+ * never read back to find them. Indices out of the range give undefined
+ * results, and an <end> lower than <start> generates GL_INVALID_VALUE.
+ */
+#ifndef GL_GLOVE_draw_range_elements
+#define GL_GLOVE_draw_range_elements 1
+typedef void (GL_APIENTRYP PFNGLDRAWRANGEELEMENTSGLOVEPROC) (GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, const void *indices);
+#ifdef GL_GLEXT_PROTOTYPES
+GL_APICALL void GL_APIENTRY glDrawRangeElements (GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, const void *indices);
+#endif
+#endif /* GL_GLOVE_draw_range_elements */
+
+/*
+ * GL_GLOVE_command_bundle
+ *
+ * Records the draws issued between glBeginCommandBundleGLOVE and
+ * glEndCommandBundleGLOVE into <bundle> instead of executing them, with the
+ * state, the uniform values and the client arrays they are issued with, so
+ * that glCallCommandBundleGLOVE executes them again at a fraction of their
+ * cost. Only draws are recorded; the other calls take effect as usual. The
+ * framebuffer bound when a bundle is called must have the formats, samples,
+ * size and orientation of the one it was begun with, and a bundle stops
+ * being callable once the storage of any buffer, texture or program it drew
+ * with is respecified, both of which generate GL_INVALID_OPERATION until it
+ * is recorded again. Samples drawn by a bundle are not counted by occlusion
+ * queries, which then report them as passed.
+ */
+#ifndef GL_GLOVE_command_bundle
+#define GL_GLOVE_command_bundle 1
+typedef void (GL_APIENTRYP PFNGLGENCOMMANDBUNDLESGLOVEPROC) (GLsizei n, GLuint *bundles);
+typedef void (GL_APIENTRYP PFNGLDELETECOMMANDBUNDLESGLOVEPROC) (GLsizei n, const GLuint *bundles);
+typedef void (GL_APIENTRYP PFNGLBEGINCOMMANDBUNDLEGLOVEPROC) (GLuint bundle);
+typedef void (GL_APIENTRYP PFNGLENDCOMMANDBUNDLEGLOVEPROC) (void);
+typedef void (GL_APIENTRYP PFNGLCALLCOMMANDBUNDLEGLOVEPROC) (GLuint bundle);
+#ifdef GL_GLEXT_PROTOTYPES
+GL_APICALL void GL_APIENTRY glGenCommandBundlesGLOVE (GLsizei n, GLuint *bundles);
+GL_APICALL void GL_APIENTRY glDeleteCommandBundlesGLOVE (GLsizei n, const GLuint *bundles);
+GL_APICALL void GL_APIENTRY glBeginCommandBundleGLOVE (GLuint bundle);
+GL_APICALL void GL_APIENTRY glEndCommandBundleGLOVE (void);
+GL_APICALL void GL_APIENTRY glCallCommandBundleGLOVE (GLuint bundle);
+#endif
+#endif /* GL_GLOVE_command_bundle */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __gl2ext_glove_h_ */
@@ -24,21 +24,35 @@
 #include "rendering_api_interface.h"
 #include "context/context.h"
 #include "glFunctions.h"
+#include "utils/programCache.h"
+#include "utils/jobSystem.h"
+#include "utils/shaderStats.h"
+#include "utils/startupProfile.h"
+#ifdef CAPTURE_BUILD
+#include "glCapture.h"
+#endif // CAPTURE_BUILD
 
 static vkInterface_t  vkInterface;
 static api_state_t    gles2_state = nullptr;
 
 api_state_t           init_API();
           void        terminate_API();
-api_context_t         create_context();
+api_context_t         create_context(api_context_t share_context, uint32_t no_error, api_context_priority_t *priority);
 void                  set_read_write_surface(api_context_t api_context, EGLSurfaceInterface *eglReadSurfaceInterface, EGLSurfaceInterface *eglWriteSurfaceInterface);
 void                  delete_shared_surface_data(EGLSurfaceInterface *eglSurfaceInterface);
 void                  delete_context(api_context_t api_context);
 void                  release_system_fbo(api_context_t api_context);
+void                  retire_system_fbo(api_context_t api_context);
 GLPROC                get_proc_addr(const char* procname);
 void                  flush(api_context_t api_context);
 void                  finish(api_context_t api_context);
 void                  bind_to_texture(api_context_t api_context, uint32_t bind);
+void                  prepare_swap_buffers(api_context_t api_context);
+api_sync_t            create_sync(api_context_t api_context);
+void                  destroy_sync(api_sync_t api_sync);
+api_sync_status_t     client_wait_sync(api_sync_t api_sync, uint64_t timeout);
+void                  wait_sync(api_context_t api_context, api_sync_t api_sync);
+void                  egl_initialized(uint64_t begin_ns, uint64_t end_ns);
 
 static void           FillInVkInterface(vulkanAPI::vkContext_t* vkContext);
 
@@ -51,10 +65,17 @@ rendering_api_interface_t GLES2Interface = {
     delete_shared_surface_data,
     delete_context,
     release_system_fbo,
+    retire_system_fbo,
     get_proc_addr,
     flush,
     finish,
-    bind_to_texture
+    bind_to_texture,
+    prepare_swap_buffers,
+    create_sync,
+    destroy_sync,
+    client_wait_sync,
+    wait_sync,
+    egl_initialized
 };
 
 #ifdef WIN32
@@ -64,6 +85,34 @@ rendering_api_interface_t* EGLAPIENTRY GetGLES2Interface(void)
 }
 #endif
 
+static VkResult queue_submit(VkQueue queue, uint32_t submitCount, const VkSubmitInfo *submits, VkFence fence)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the work of the surfaces, e.g., the fence of the frames rendering to a retired swapchain,
+    // is ordered along with the one of the current context, which may submit to a queue of its own priority
+    Context *ctx = GetCurrentContext();
+    if(ctx && queue == vulkanAPI::GetContext()->vkQueue) {
+        queue = ctx->GetVkCommandBufferManager()->GetVkQueue();
+    }
+
+    return vulkanAPI::GetContext()->vkSubmissionQueue->Submit(queue, submitCount, submits, fence);
+}
+
+static VkResult queue_present(VkQueue queue, const VkPresentInfoKHR *presentInfo, PFN_vkQueuePresentKHR queuePresent)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    VkResult result;
+    {
+        GLOVE_STARTUP_PHASE(STARTUP_PHASE_FIRST_PRESENT);
+        result = vulkanAPI::GetContext()->vkSubmissionQueue->Present(queue, presentInfo, queuePresent);
+    }
+    StartupProfile::Save();
+
+    return result;
+}
+
 static void FillInVkInterface(vulkanAPI::vkContext_t* vkContext)
 {
     vkInterface.vkInstance = vkContext->vkInstance;
@@ -73,13 +122,22 @@ static void FillInVkInterface(vulkanAPI::vkContext_t* vkContext)
     vkInterface.vkDeviceMemoryProperties = vkContext->vkDeviceMemoryProperties;
     vkInterface.vkDevice = vkContext->vkDevice;
     vkInterface.vkSyncItems = vkContext->vkSyncItems;
+    vkInterface.presentWaitSupported = vkContext->mIsPresentWaitSupported;
+    vkInterface.incrementalPresentSupported = vkContext->mIsIncrementalPresentSupported;
+    vkInterface.fixedRateCompressionSupported = vkContext->mIsImageCompressionControlSwapchainSupported;
+    vkInterface.headless = vkContext->mIsHeadless;
+    vkInterface.queueSubmitCb = queue_submit;
+    vkInterface.queuePresentCb = queue_present;
 }
 
 api_state_t init_API()
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    vulkanAPI::InitContext();
+    {
+        GLOVE_STARTUP_PHASE(STARTUP_PHASE_VULKAN_INIT);
+        vulkanAPI::InitContext();
+    }
 
     FillInVkInterface(vulkanAPI::GetContext());
 
@@ -91,14 +149,24 @@ void terminate_API()
     FUN_ENTRY(GL_LOG_DEBUG);
 
     vulkanAPI::TerminateContext();
+    JobSystem::Terminate();
+    ShaderStats::Save();
+    StartupProfile::Save();
+#ifdef CAPTURE_BUILD
+    GLCapture::Shutdown();
+#endif // CAPTURE_BUILD
     GLLogger::Shutdown();
 }
 
-api_context_t create_context()
+api_context_t create_context(api_context_t share_context, uint32_t no_error, api_context_priority_t *priority)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    Context *ctx = new Context();
+    GLOVE_STARTUP_PHASE(STARTUP_PHASE_CONTEXT_CREATE);
+    // the priorities are enumerated in the same order
+    Context *ctx = new Context(reinterpret_cast<Context *>(share_context), no_error != 0,
+                               static_cast<vulkanAPI::queuePriority_t>(*priority));
+    *priority = static_cast<api_context_priority_t>(ctx->GetPriority());
     return ctx;
 }
 
@@ -107,14 +175,26 @@ void set_read_write_surface(api_context_t api_context, EGLSurfaceInterface *eglR
     FUN_ENTRY(GL_LOG_DEBUG);
 
     Context *ctx = reinterpret_cast<Context *>(api_context);
+    ctx->SyncGLThread();
     SetCurrentContext(ctx);
     ctx->SetReadWriteSurfaces(eglReadSurfaceInterface, eglWriteSurfaceInterface);
+
+#ifdef CAPTURE_BUILD
+    if(eglWriteSurfaceInterface) {
+        GLCapture::Surface(eglWriteSurfaceInterface->width, eglWriteSurfaceInterface->height);
+    }
+#endif // CAPTURE_BUILD
 }
 
 void delete_shared_surface_data(EGLSurfaceInterface *eglSurfaceInterface)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    // the calls recorded for the current context may still draw to the surface
+    if(GetCurrentContext()) {
+        GetCurrentContext()->SyncGLThread();
+    }
+
     vulkanAPI::vkContext_t *vkContext = vulkanAPI::GetContext();
     Context::DestroyAPISurfaceData(vkContext, eglSurfaceInterface);
 }
@@ -125,6 +205,10 @@ void delete_context(api_context_t api_context)
 
     Context *ctx = reinterpret_cast<Context *>(api_context);
     delete ctx;
+
+    // keep what the context has compiled in case the application exits without eglTerminate
+    vulkanAPI::SaveVkPipelineCache();
+    ProgramCache::Save();
 }
 
 void release_system_fbo(api_context_t api_context)
@@ -132,9 +216,19 @@ void release_system_fbo(api_context_t api_context)
     FUN_ENTRY(GL_LOG_DEBUG);
 
     Context *ctx = reinterpret_cast<Context *>(api_context);
+    ctx->SyncGLThread();
     ctx->ReleaseSystemFBO();
 }
 
+void retire_system_fbo(api_context_t api_context)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    Context *ctx = reinterpret_cast<Context *>(api_context);
+    ctx->SyncGLThread();
+    ctx->RetireSystemFBO();
+}
+
 GLPROC get_proc_addr(const char* procname)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
@@ -147,6 +241,7 @@ void flush(api_context_t api_context)
     FUN_ENTRY(GL_LOG_DEBUG);
 
     Context *ctx = reinterpret_cast<Context *>(api_context);
+    ctx->SyncGLThread();
     ctx->Flush();
 }
 
@@ -155,6 +250,7 @@ void finish(api_context_t api_context)
     FUN_ENTRY(GL_LOG_DEBUG);
 
     Context *ctx = reinterpret_cast<Context *>(api_context);
+    ctx->SyncGLThread();
     ctx->Finish();
 }
 
@@ -163,5 +259,66 @@ void bind_to_texture(api_context_t api_context, uint32_t bind)
     FUN_ENTRY(GL_LOG_DEBUG);
 
     Context *ctx = reinterpret_cast<Context *>(api_context);
+    ctx->SyncGLThread();
     ctx->BindToTexture(bind);
 }
+
+void prepare_swap_buffers(api_context_t api_context)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    Context *ctx = reinterpret_cast<Context *>(api_context);
+    ctx->SyncGLThread();
+    ctx->PrepareSwapBuffers();
+
+#ifdef CAPTURE_BUILD
+    GLCapture::Frame();
+#endif // CAPTURE_BUILD
+}
+
+api_sync_t create_sync(api_context_t api_context)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    Context *ctx = reinterpret_cast<Context *>(api_context);
+    ctx->SyncGLThread();
+    return reinterpret_cast<api_sync_t>(ctx->CreateSync());
+}
+
+void destroy_sync(api_sync_t api_sync)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    vulkanAPI::Fence *fence = reinterpret_cast<vulkanAPI::Fence *>(api_sync);
+    delete fence;
+}
+
+api_sync_status_t client_wait_sync(api_sync_t api_sync, uint64_t timeout)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    vulkanAPI::Fence *fence = reinterpret_cast<vulkanAPI::Fence *>(api_sync);
+
+    switch(fence->WaitFor(timeout)) {
+    case VK_SUCCESS:    return API_SYNC_SIGNALED;
+    case VK_TIMEOUT:    return API_SYNC_TIMEOUT_EXPIRED;
+    default:            return API_SYNC_ERROR;
+    }
+}
+
+void wait_sync(api_context_t api_context, api_sync_t api_sync)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    Context *ctx = reinterpret_cast<Context *>(api_context);
+    ctx->SyncGLThread();
+    ctx->WaitSync(reinterpret_cast<vulkanAPI::Fence *>(api_sync));
+}
+
+void egl_initialized(uint64_t begin_ns, uint64_t end_ns)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    StartupProfile::Record(STARTUP_PHASE_EGL_INIT, std::chrono::steady_clock::time_point(std::chrono::nanoseconds(begin_ns)),
+                                                   std::chrono::steady_clock::time_point(std::chrono::nanoseconds(end_ns)));
+}
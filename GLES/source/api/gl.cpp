@@ -23,92 +23,179 @@
 
 #include "context/context.h"
 
+// a current context is the common case, calls without one are only a guard against misuse
+#if defined(__GNUC__) || defined(__clang__)
+#define GLOVE_LIKELY(x)             __builtin_expect(!!(x), 1)
+#else
+#define GLOVE_LIKELY(x)             (x)
+#endif
+
+// with a GL thread, the calls run on the calling thread once it has run what was recorded, see glThread.h
+static inline Context *
+GetSyncedContext(void)
+{
+    Context *context = GetCurrentContext();
+    if(GLOVE_LIKELY(context)) {
+        context->SyncGLThread();
+    }
+    return context;
+}
+
 #define CONTEXT_EXEC(func)          FUN_ENTRY(GL_LOG_INFO);                      \
-                                    Context * context = GetCurrentContext();     \
-                                    if (context) {                               \
+                                    Context * context = GetSyncedContext();      \
+                                    if (GLOVE_LIKELY(context)) {                 \
                                         context->func;                           \
                                     }
 
 #define CONTEXT_EXEC_RETURN(func)   FUN_ENTRY(GL_LOG_INFO);                      \
-                                    Context * context = GetCurrentContext();     \
-                                    return context ? context->func : 0;
+                                    Context * context = GetSyncedContext();      \
+                                    return GLOVE_LIKELY(context) ? context->func : 0;
+
+// the calls that return nothing are recorded for the GL thread when marshal holds, and run in place otherwise
+#define CONTEXT_EXEC_MARSHAL(marshal, arguments, func)                                                          \
+                                    FUN_ENTRY(GL_LOG_INFO);                                                     \
+                                    Context * context = GetCurrentContext();                                    \
+                                    if (GLOVE_LIKELY(context)) {                                                \
+                                        GLThread *glThread = context->GetGLThread();                            \
+                                        if (!glThread) {                                                        \
+                                            context->func;                                                      \
+                                        } else if (marshal) {                                                   \
+                                            glThread->Enqueue arguments;                                        \
+                                        } else {                                                                \
+                                            glThread->Sync();                                                   \
+                                            context->func;                                                      \
+                                        }                                                                       \
+                                    }
+
+/// calls that read no client memory past their return
+#define CONTEXT_EXEC_ASYNC(func)                CONTEXT_EXEC_MARSHAL(true,                                      \
+                                                    ([=](Context *context, const void *) { context->func; }), func)
+
+/// as above, when the state the GL thread follows allows it
+#define CONTEXT_EXEC_ASYNC_IF(marshal, func)    CONTEXT_EXEC_MARSHAL(glThread->marshal,                         \
+                                                    ([=](Context *context, const void *) { context->func; }), func)
+
+/// calls that read size bytes of client memory from pointer, which the worker reads from a copy
+#define CONTEXT_EXEC_ASYNC_DATA(type, pointer, size, func)                                                      \
+                                                CONTEXT_EXEC_MARSHAL(GLThread::FitsPayload(size),               \
+                                                    ([=](Context *context, const void *payload) {               \
+                                                        type pointer = static_cast<type>(payload);              \
+                                                        context->func;                                          \
+                                                    }, pointer, (size)), func)
+
+/// keeps the state the GL thread follows in step with the calls
+#define GLOVE_GLTHREAD_TRACK(func)              if (context && context->GetGLThread()) { context->GetGLThread()->func; }
+
+// the calls are recorded after they executed, see glCapture.h
+#ifdef CAPTURE_BUILD
+#include "glCapture.h"
+
+#define GLOVE_CAPTURE_CALL(__call__, ...)       if(context) { GLCapture::Call(GLOVE_CAPTURE_##__call__, ##__VA_ARGS__); }
+#define GLOVE_CAPTURE_EXEC(__func__)            if(context) { GLCapture::__func__; }
+#define GLOVE_CAPTURE_BEFORE(__func__)          { Context * context = GetCurrentContext(); GLOVE_CAPTURE_EXEC(__func__); }
+
+#define CONTEXT_EXEC_RETURN_CAPTURE(func, ...)  FUN_ENTRY(GL_LOG_INFO);                                  \
+                                                Context * context = GetSyncedContext();                  \
+                                                auto result = GLOVE_LIKELY(context) ? context->func : 0; \
+                                                __VA_ARGS__;                                             \
+                                                return result;
+#else
+#define GLOVE_CAPTURE_CALL(__call__, ...)
+#define GLOVE_CAPTURE_EXEC(__func__)
+#define GLOVE_CAPTURE_BEFORE(__func__)
+#define CONTEXT_EXEC_RETURN_CAPTURE(func, ...)  CONTEXT_EXEC_RETURN(func)
+#endif // CAPTURE_BUILD
 
 void GL_APIENTRY
 glActiveTexture(GLenum texture)
 {
-    CONTEXT_EXEC(ActiveTexture(texture));
+    CONTEXT_EXEC_ASYNC(ActiveTexture(texture));
+    GLOVE_CAPTURE_CALL(glActiveTexture, texture);
 }
 
 void GL_APIENTRY
 glAttachShader(GLuint program, GLuint shader)
 {
-    CONTEXT_EXEC(AttachShader(program, shader));
+    CONTEXT_EXEC_ASYNC(AttachShader(program, shader));
+    GLOVE_CAPTURE_CALL(glAttachShader, program, shader);
 }
 
 void GL_APIENTRY
 glBindAttribLocation(GLuint program, GLuint index, const char* name)
 {
     CONTEXT_EXEC(BindAttribLocation(program, index, name));
+    GLOVE_CAPTURE_CALL(glBindAttribLocation, program, index, GLCapture::String(name));
 }
 
 void GL_APIENTRY
 glBindBuffer(GLenum target, GLuint buffer)
 {
-    CONTEXT_EXEC(BindBuffer(target, buffer));
+    CONTEXT_EXEC_ASYNC(BindBuffer(target, buffer));
+    GLOVE_GLTHREAD_TRACK(BindBuffer(target, buffer));
+    GLOVE_CAPTURE_CALL(glBindBuffer, target, buffer);
 }
 
 void GL_APIENTRY
 glBindFramebuffer(GLenum target, GLuint framebuffer)
 {
-    CONTEXT_EXEC(BindFramebuffer(target, framebuffer));
+    CONTEXT_EXEC_ASYNC(BindFramebuffer(target, framebuffer));
+    GLOVE_CAPTURE_CALL(glBindFramebuffer, target, framebuffer);
 }
 
 void GL_APIENTRY
 glBindRenderbuffer(GLenum target, GLuint renderbuffer)
 {
-    CONTEXT_EXEC(BindRenderbuffer(target, renderbuffer));
+    CONTEXT_EXEC_ASYNC(BindRenderbuffer(target, renderbuffer));
+    GLOVE_CAPTURE_CALL(glBindRenderbuffer, target, renderbuffer);
 }
 
 void GL_APIENTRY
 glBlendColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha)
 {
-    CONTEXT_EXEC(BlendColor(red, green, blue, alpha));
+    CONTEXT_EXEC_ASYNC(BlendColor(red, green, blue, alpha));
+    GLOVE_CAPTURE_CALL(glBlendColor, red, green, blue, alpha);
 }
 
 void GL_APIENTRY
 glBlendEquation(GLenum mode)
 {
-    CONTEXT_EXEC(BlendEquation(mode));
+    CONTEXT_EXEC_ASYNC(BlendEquation(mode));
+    GLOVE_CAPTURE_CALL(glBlendEquation, mode);
 }
 
 void GL_APIENTRY
 glBlendEquationSeparate(GLenum modeRGB, GLenum modeAlpha)
 {
-    CONTEXT_EXEC(BlendEquationSeparate(modeRGB, modeAlpha));
+    CONTEXT_EXEC_ASYNC(BlendEquationSeparate(modeRGB, modeAlpha));
+    GLOVE_CAPTURE_CALL(glBlendEquationSeparate, modeRGB, modeAlpha);
 }
 
 void GL_APIENTRY
 glBlendFunc(GLenum sfactor, GLenum dfactor)
 {
-    CONTEXT_EXEC(BlendFunc(sfactor, dfactor));
+    CONTEXT_EXEC_ASYNC(BlendFunc(sfactor, dfactor));
+    GLOVE_CAPTURE_CALL(glBlendFunc, sfactor, dfactor);
 }
 
 void GL_APIENTRY
 glBlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha)
 {
-    CONTEXT_EXEC(BlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha));
+    CONTEXT_EXEC_ASYNC(BlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha));
+    GLOVE_CAPTURE_CALL(glBlendFuncSeparate, srcRGB, dstRGB, srcAlpha, dstAlpha);
 }
 
 void GL_APIENTRY
 glBufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage)
 {
-    CONTEXT_EXEC(BufferData(target, size, data, usage));
+    CONTEXT_EXEC_ASYNC_DATA(const void *, data, size > 0 ? size : 0, BufferData(target, size, data, usage));
+    GLOVE_CAPTURE_CALL(glBufferData, target, size, GLCapture::Data(data, size > 0 ? size : 0), usage);
 }
 
 void GL_APIENTRY
 glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
 {
-    CONTEXT_EXEC(BufferSubData(target, offset, size, data));
+    CONTEXT_EXEC_ASYNC_DATA(const void *, data, size > 0 ? size : 0, BufferSubData(target, offset, size, data));
+    GLOVE_CAPTURE_CALL(glBufferSubData, target, offset, size, GLCapture::Data(data, size > 0 ? size : 0));
 }
 
 GLenum GL_APIENTRY
@@ -120,241 +207,284 @@ glCheckFramebufferStatus(GLenum target)
 void GL_APIENTRY
 glClear(GLbitfield mask)
 {
-    CONTEXT_EXEC(Clear(mask));
+    CONTEXT_EXEC_ASYNC(Clear(mask));
+    GLOVE_CAPTURE_CALL(glClear, mask);
 }
 
 void GL_APIENTRY
 glClearColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha)
 {
-    CONTEXT_EXEC(ClearColor(red, green, blue, alpha));
+    CONTEXT_EXEC_ASYNC(ClearColor(red, green, blue, alpha));
+    GLOVE_CAPTURE_CALL(glClearColor, red, green, blue, alpha);
 }
 
 void GL_APIENTRY
 glClearDepthf(GLclampf depth)
 {
-    CONTEXT_EXEC(ClearDepthf(depth));
+    CONTEXT_EXEC_ASYNC(ClearDepthf(depth));
+    GLOVE_CAPTURE_CALL(glClearDepthf, depth);
 }
 
 void GL_APIENTRY
 glClearStencil(GLint s)
 {
-    CONTEXT_EXEC(ClearStencil(s));
+    CONTEXT_EXEC_ASYNC(ClearStencil(s));
+    GLOVE_CAPTURE_CALL(glClearStencil, s);
 }
 
 void GL_APIENTRY
 glColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha)
 {
-    CONTEXT_EXEC(ColorMask(red, green, blue, alpha));
+    CONTEXT_EXEC_ASYNC(ColorMask(red, green, blue, alpha));
+    GLOVE_CAPTURE_CALL(glColorMask, red, green, blue, alpha);
 }
 
 void GL_APIENTRY
 glCompileShader(GLuint shader)
 {
-    CONTEXT_EXEC(CompileShader(shader));
+    CONTEXT_EXEC_ASYNC(CompileShader(shader));
+    GLOVE_CAPTURE_CALL(glCompileShader, shader);
 }
 
 void GL_APIENTRY
 glCompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const void* data)
 {
     CONTEXT_EXEC(CompressedTexImage2D(target, level, internalformat, width, height, border, imageSize, data));
+    GLOVE_CAPTURE_CALL(glCompressedTexImage2D, target, level, internalformat, width, height, border, imageSize, GLCapture::Data(data, imageSize > 0 ? imageSize : 0));
 }
 
 void GL_APIENTRY
 glCompressedTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLsizei imageSize, const void* data)
 {
     CONTEXT_EXEC(CompressedTexSubImage2D(target, level, xoffset, yoffset, width, height, format, imageSize, data));
+    GLOVE_CAPTURE_CALL(glCompressedTexSubImage2D, target, level, xoffset, yoffset, width, height, format, imageSize, GLCapture::Data(data, imageSize > 0 ? imageSize : 0));
 }
 
 void GL_APIENTRY
 glCopyTexImage2D(GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLsizei height, GLint border)
 {
     CONTEXT_EXEC(CopyTexImage2D(target, level, internalformat, x, y, width, height, border));
+    GLOVE_CAPTURE_CALL(glCopyTexImage2D, target, level, internalformat, x, y, width, height, border);
 }
 
 void GL_APIENTRY
 glCopyTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint x, GLint y, GLsizei width, GLsizei height)
 {
     CONTEXT_EXEC(CopyTexSubImage2D(target, level, xoffset, yoffset, x, y, width, height));
+    GLOVE_CAPTURE_CALL(glCopyTexSubImage2D, target, level, xoffset, yoffset, x, y, width, height);
 }
 
 GLuint GL_APIENTRY
 glCreateProgram(void)
 {
-    CONTEXT_EXEC_RETURN(CreateProgram());
+    CONTEXT_EXEC_RETURN_CAPTURE(CreateProgram(), GLOVE_CAPTURE_CALL(glCreateProgram));
 }
 
 GLuint GL_APIENTRY
 glCreateShader(GLenum type)
 {
-    CONTEXT_EXEC_RETURN(CreateShader(type));
+    CONTEXT_EXEC_RETURN_CAPTURE(CreateShader(type), GLOVE_CAPTURE_CALL(glCreateShader, type));
 }
 
 void GL_APIENTRY
 glCullFace(GLenum mode)
 {
-    CONTEXT_EXEC(CullFace(mode));
+    CONTEXT_EXEC_ASYNC(CullFace(mode));
+    GLOVE_CAPTURE_CALL(glCullFace, mode);
 }
 
 void GL_APIENTRY
 glDeleteBuffers(GLsizei n, const GLuint* buffers)
 {
-    CONTEXT_EXEC(DeleteBuffers(n, buffers));
+    CONTEXT_EXEC_ASYNC_DATA(const GLuint *, buffers, n > 0 ? n * sizeof(GLuint) : 0, DeleteBuffers(n, buffers));
+    GLOVE_GLTHREAD_TRACK(DeleteBuffers(n, buffers));
+    GLOVE_CAPTURE_CALL(glDeleteBuffers, n, GLCapture::Data(buffers, n > 0 ? n * sizeof(GLuint) : 0));
 }
 
 void GL_APIENTRY
 glDeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
 {
-    CONTEXT_EXEC(DeleteFramebuffers(n, framebuffers));
+    CONTEXT_EXEC_ASYNC_DATA(const GLuint *, framebuffers, n > 0 ? n * sizeof(GLuint) : 0, DeleteFramebuffers(n, framebuffers));
+    GLOVE_CAPTURE_CALL(glDeleteFramebuffers, n, GLCapture::Data(framebuffers, n > 0 ? n * sizeof(GLuint) : 0));
 }
 
 void GL_APIENTRY
 glDeleteProgram(GLuint program)
 {
-    CONTEXT_EXEC(DeleteProgram(program));
+    CONTEXT_EXEC_ASYNC(DeleteProgram(program));
+    GLOVE_CAPTURE_CALL(glDeleteProgram, program);
 }
 
 void GL_APIENTRY
 glDeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers)
 {
-    CONTEXT_EXEC(DeleteRenderbuffers(n, renderbuffers));
+    CONTEXT_EXEC_ASYNC_DATA(const GLuint *, renderbuffers, n > 0 ? n * sizeof(GLuint) : 0, DeleteRenderbuffers(n, renderbuffers));
+    GLOVE_CAPTURE_CALL(glDeleteRenderbuffers, n, GLCapture::Data(renderbuffers, n > 0 ? n * sizeof(GLuint) : 0));
 }
 
 void GL_APIENTRY
 glDeleteShader(GLuint shader)
 {
-    CONTEXT_EXEC(DeleteShader(shader));
+    CONTEXT_EXEC_ASYNC(DeleteShader(shader));
+    GLOVE_CAPTURE_CALL(glDeleteShader, shader);
 }
 
 void GL_APIENTRY
 glDeleteTextures(GLsizei n, const GLuint* textures)
 {
-    CONTEXT_EXEC(DeleteTextures(n, textures));
+    CONTEXT_EXEC_ASYNC_DATA(const GLuint *, textures, n > 0 ? n * sizeof(GLuint) : 0, DeleteTextures(n, textures));
+    GLOVE_CAPTURE_CALL(glDeleteTextures, n, GLCapture::Data(textures, n > 0 ? n * sizeof(GLuint) : 0));
 }
 
 void GL_APIENTRY
 glDepthFunc(GLenum func)
 {
-    CONTEXT_EXEC(DepthFunc(func));
+    CONTEXT_EXEC_ASYNC(DepthFunc(func));
+    GLOVE_CAPTURE_CALL(glDepthFunc, func);
 }
 
 void GL_APIENTRY
 glDepthMask(GLboolean flag)
 {
-    CONTEXT_EXEC(DepthMask(flag));
+    CONTEXT_EXEC_ASYNC(DepthMask(flag));
+    GLOVE_CAPTURE_CALL(glDepthMask, flag);
 }
 
 void GL_APIENTRY
 glDepthRangef(GLclampf zNear, GLclampf zFar)
 {
-    CONTEXT_EXEC(DepthRangef(zNear, zFar));
+    CONTEXT_EXEC_ASYNC(DepthRangef(zNear, zFar));
+    GLOVE_CAPTURE_CALL(glDepthRangef, zNear, zFar);
 }
 
 void GL_APIENTRY
 glDetachShader(GLuint program, GLuint shader)
 {
-    CONTEXT_EXEC(DetachShader(program, shader));
+    CONTEXT_EXEC_ASYNC(DetachShader(program, shader));
+    GLOVE_CAPTURE_CALL(glDetachShader, program, shader);
 }
 
 void GL_APIENTRY
 glDisable(GLenum cap)
 {
-    CONTEXT_EXEC(Disable(cap));
+    CONTEXT_EXEC_ASYNC(Disable(cap));
+    GLOVE_CAPTURE_CALL(glDisable, cap);
 }
 
 void GL_APIENTRY
 glDisableVertexAttribArray(GLuint index)
 {
-    CONTEXT_EXEC(DisableVertexAttribArray(index));
+    CONTEXT_EXEC_ASYNC(DisableVertexAttribArray(index));
+    GLOVE_GLTHREAD_TRACK(EnableVertexAttribArray(index, false));
+    GLOVE_CAPTURE_EXEC(EnableVertexAttribArray(index, false));
 }
 
 void GL_APIENTRY
 glDrawArrays(GLenum mode, GLint first, GLsizei count)
 {
-    CONTEXT_EXEC(DrawArrays(mode, first, count));
+    CONTEXT_EXEC_ASYNC_IF(DrawsFromBuffers(false), DrawArrays(mode, first, count));
+    GLOVE_CAPTURE_EXEC(ClientArrays(context, first, count, 1));
+    GLOVE_CAPTURE_CALL(glDrawArrays, mode, first, count);
 }
 
 void GL_APIENTRY
 glDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
 {
-    CONTEXT_EXEC(DrawElements(mode, count, type, indices));
+    CONTEXT_EXEC_ASYNC_IF(DrawsFromBuffers(true), DrawElements(mode, count, type, indices));
+    GLOVE_CAPTURE_EXEC(ClientArrays(context, count, type, indices, 1));
+    GLOVE_CAPTURE_CALL(glDrawElements, mode, count, type, GLCapture::Indices(context, count, type, indices));
 }
 
 void GL_APIENTRY
 glEnable(GLenum cap)
 {
-    CONTEXT_EXEC(Enable(cap));
+    CONTEXT_EXEC_ASYNC(Enable(cap));
+    GLOVE_CAPTURE_CALL(glEnable, cap);
 }
 
 void GL_APIENTRY
 glEnableVertexAttribArray(GLuint index)
 {
-    CONTEXT_EXEC(EnableVertexAttribArray(index));
+    CONTEXT_EXEC_ASYNC(EnableVertexAttribArray(index));
+    GLOVE_GLTHREAD_TRACK(EnableVertexAttribArray(index, true));
+    GLOVE_CAPTURE_EXEC(EnableVertexAttribArray(index, true));
 }
 
 void GL_APIENTRY
 glFinish(void)
 {
     CONTEXT_EXEC(Finish());
+    GLOVE_CAPTURE_CALL(glFinish);
 }
 
 void GL_APIENTRY
 glFlush(void)
 {
-    CONTEXT_EXEC(Flush());
+    CONTEXT_EXEC_ASYNC(Flush());
+    GLOVE_CAPTURE_CALL(glFlush);
 }
 
 void GL_APIENTRY
 glFramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer)
 {
-    CONTEXT_EXEC(FramebufferRenderbuffer(target, attachment, renderbuffertarget, renderbuffer));
+    CONTEXT_EXEC_ASYNC(FramebufferRenderbuffer(target, attachment, renderbuffertarget, renderbuffer));
+    GLOVE_CAPTURE_CALL(glFramebufferRenderbuffer, target, attachment, renderbuffertarget, renderbuffer);
 }
 
 void GL_APIENTRY
 glFramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level)
 {
-    CONTEXT_EXEC(FramebufferTexture2D(target, attachment, textarget, texture, level));
+    CONTEXT_EXEC_ASYNC(FramebufferTexture2D(target, attachment, textarget, texture, level));
+    GLOVE_CAPTURE_CALL(glFramebufferTexture2D, target, attachment, textarget, texture, level);
 }
 
 void GL_APIENTRY
 glFrontFace(GLenum mode)
 {
-    CONTEXT_EXEC(FrontFace(mode));
+    CONTEXT_EXEC_ASYNC(FrontFace(mode));
+    GLOVE_CAPTURE_CALL(glFrontFace, mode);
 }
 
 void GL_APIENTRY
 glGenBuffers(GLsizei n, GLuint* buffers)
 {
     CONTEXT_EXEC(GenBuffers(n, buffers));
+    GLOVE_CAPTURE_CALL(glGenBuffers, n, GLCapture::Output(n > 0 ? n * sizeof(GLuint) : 0));
 }
 
 void GL_APIENTRY
 glGenerateMipmap(GLenum target)
 {
-    CONTEXT_EXEC(GenerateMipmap(target));
+    CONTEXT_EXEC_ASYNC(GenerateMipmap(target));
+    GLOVE_CAPTURE_CALL(glGenerateMipmap, target);
 }
 
 void GL_APIENTRY
 glGenFramebuffers(GLsizei n, GLuint* framebuffers)
 {
     CONTEXT_EXEC(GenFramebuffers(n, framebuffers));
+    GLOVE_CAPTURE_CALL(glGenFramebuffers, n, GLCapture::Output(n > 0 ? n * sizeof(GLuint) : 0));
 }
 
 void GL_APIENTRY
 glGenRenderbuffers(GLsizei n, GLuint* renderbuffers)
 {
     CONTEXT_EXEC(GenRenderbuffers(n, renderbuffers));
+    GLOVE_CAPTURE_CALL(glGenRenderbuffers, n, GLCapture::Output(n > 0 ? n * sizeof(GLuint) : 0));
 }
 
 void GL_APIENTRY
 glBindTexture(GLenum target, GLuint texture)
 {
-    CONTEXT_EXEC(BindTexture(target, texture));
+    CONTEXT_EXEC_ASYNC(BindTexture(target, texture));
+    GLOVE_CAPTURE_CALL(glBindTexture, target, texture);
 }
 
 void GL_APIENTRY
 glGenTextures(GLsizei n, GLuint* textures)
 {
     CONTEXT_EXEC(GenTextures(n, textures));
+    GLOVE_CAPTURE_CALL(glGenTextures, n, GLCapture::Output(n > 0 ? n * sizeof(GLuint) : 0));
 }
 
 void GL_APIENTRY
@@ -378,7 +508,7 @@ glGetAttachedShaders(GLuint program, GLsizei maxcount, GLsizei* count, GLuint* s
 int  GL_APIENTRY
 glGetAttribLocation(GLuint program, const char* name)
 {
-    CONTEXT_EXEC_RETURN(GetAttribLocation(program, name));
+    CONTEXT_EXEC_RETURN_CAPTURE(GetAttribLocation(program, name), GLOVE_CAPTURE_CALL(glGetAttribLocation, program, GLCapture::String(name)));
 }
 
 void GL_APIENTRY
@@ -421,6 +551,7 @@ void GL_APIENTRY
 glGetProgramiv(GLuint program, GLenum pname, GLint* params)
 {
     CONTEXT_EXEC(GetProgramiv(program, pname, params));
+    GLOVE_CAPTURE_CALL(glGetProgramiv, program, pname, GLCapture::Output(sizeof(GLint)));
 }
 
 void GL_APIENTRY
@@ -439,6 +570,7 @@ void GL_APIENTRY
 glGetShaderiv(GLuint shader, GLenum pname, GLint* params)
 {
     CONTEXT_EXEC(GetShaderiv(shader, pname, params));
+    GLOVE_CAPTURE_CALL(glGetShaderiv, shader, pname, GLCapture::Output(sizeof(GLint)));
 }
 
 void GL_APIENTRY
@@ -492,7 +624,7 @@ glGetUniformiv(GLuint program, GLint location, GLint* params)
 int  GL_APIENTRY
 glGetUniformLocation(GLuint program, const char* name)
 {
-    CONTEXT_EXEC_RETURN(GetUniformLocation(program, name));
+    CONTEXT_EXEC_RETURN_CAPTURE(GetUniformLocation(program, name), GLOVE_CAPTURE_CALL(glGetUniformLocation, program, GLCapture::String(name), result));
 }
 
 void GL_APIENTRY
@@ -516,7 +648,8 @@ glGetVertexAttribPointerv(GLuint index, GLenum pname, void** pointer)
 void GL_APIENTRY
 glHint(GLenum target, GLenum mode)
 {
-    CONTEXT_EXEC(Hint(target, mode));
+    CONTEXT_EXEC_ASYNC(Hint(target, mode));
+    GLOVE_CAPTURE_CALL(glHint, target, mode);
 }
 
 GLboolean GL_APIENTRY
@@ -564,325 +697,380 @@ glIsTexture(GLuint texture)
 void GL_APIENTRY
 glLineWidth(GLfloat width)
 {
-    CONTEXT_EXEC(LineWidth(width));
+    CONTEXT_EXEC_ASYNC(LineWidth(width));
+    GLOVE_CAPTURE_CALL(glLineWidth, width);
 }
 
 void GL_APIENTRY
 glLinkProgram(GLuint program)
 {
-    CONTEXT_EXEC(LinkProgram(program));
+    CONTEXT_EXEC_ASYNC(LinkProgram(program));
+    GLOVE_CAPTURE_CALL(glLinkProgram, program);
 }
 
 void GL_APIENTRY
 glPixelStorei(GLenum pname, GLint param)
 {
-    CONTEXT_EXEC(PixelStorei(pname, param));
+    CONTEXT_EXEC_ASYNC(PixelStorei(pname, param));
+    GLOVE_CAPTURE_CALL(glPixelStorei, pname, param);
 }
 
 void GL_APIENTRY
 glPolygonOffset(GLfloat factor, GLfloat units)
 {
-    CONTEXT_EXEC(PolygonOffset(factor, units));
+    CONTEXT_EXEC_ASYNC(PolygonOffset(factor, units));
+    GLOVE_CAPTURE_CALL(glPolygonOffset, factor, units);
 }
 
 void GL_APIENTRY
 glReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void* pixels)
 {
     CONTEXT_EXEC(ReadPixels(x, y, width, height, format, type, pixels));
+    GLOVE_CAPTURE_CALL(glReadPixels, x, y, width, height, format, type, GLCapture::ReadPixels(context, width, height, format, type));
 }
 
 void GL_APIENTRY
 glReleaseShaderCompiler(void)
 {
     CONTEXT_EXEC(ReleaseShaderCompiler());
+    GLOVE_CAPTURE_CALL(glReleaseShaderCompiler);
 }
 
 void GL_APIENTRY
 glRenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height)
 {
-    CONTEXT_EXEC(RenderbufferStorage(target, internalformat, width, height));
+    CONTEXT_EXEC_ASYNC(RenderbufferStorage(target, internalformat, width, height));
+    GLOVE_CAPTURE_CALL(glRenderbufferStorage, target, internalformat, width, height);
 }
 
 void GL_APIENTRY
 glSampleCoverage(GLclampf value, GLboolean invert)
 {
-    CONTEXT_EXEC(SampleCoverage(value, invert));
+    CONTEXT_EXEC_ASYNC(SampleCoverage(value, invert));
+    GLOVE_CAPTURE_CALL(glSampleCoverage, value, invert);
 }
 
 void GL_APIENTRY
 glScissor(GLint x, GLint y, GLsizei width, GLsizei height)
 {
-    CONTEXT_EXEC(Scissor(x, y, width, height));
+    CONTEXT_EXEC_ASYNC(Scissor(x, y, width, height));
+    GLOVE_CAPTURE_CALL(glScissor, x, y, width, height);
 }
 
 void GL_APIENTRY
 glShaderBinary(GLsizei n, const GLuint* shaders, GLenum binaryformat, const void* binary, GLsizei length)
 {
     CONTEXT_EXEC(ShaderBinary(n, shaders, binaryformat, binary, length));
+    GLOVE_CAPTURE_CALL(glShaderBinary, n, GLCapture::Data(shaders, n > 0 ? n * sizeof(GLuint) : 0), binaryformat, GLCapture::Data(binary, length > 0 ? length : 0), length);
 }
 
 void GL_APIENTRY
 glShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length)
 {
     CONTEXT_EXEC(ShaderSource(shader, count, string, length));
+    GLOVE_CAPTURE_CALL(glShaderSource, shader, 1, GLCapture::Strings(count, string, length), GLCapture::Data(nullptr, 0));
 }
 
 void GL_APIENTRY
 glStencilFunc(GLenum func, GLint ref, GLuint mask)
 {
-    CONTEXT_EXEC(StencilFunc(func, ref, mask));
+    CONTEXT_EXEC_ASYNC(StencilFunc(func, ref, mask));
+    GLOVE_CAPTURE_CALL(glStencilFunc, func, ref, mask);
 }
 
 void GL_APIENTRY
 glStencilFuncSeparate(GLenum face, GLenum func, GLint ref, GLuint mask)
 {
-    CONTEXT_EXEC(StencilFuncSeparate(face, func, ref, mask));
+    CONTEXT_EXEC_ASYNC(StencilFuncSeparate(face, func, ref, mask));
+    GLOVE_CAPTURE_CALL(glStencilFuncSeparate, face, func, ref, mask);
 }
 
 void GL_APIENTRY
 glStencilMask(GLuint mask)
 {
-    CONTEXT_EXEC(StencilMask(mask));
+    CONTEXT_EXEC_ASYNC(StencilMask(mask));
+    GLOVE_CAPTURE_CALL(glStencilMask, mask);
 }
 
 void GL_APIENTRY
 glStencilMaskSeparate(GLenum face, GLuint mask)
 {
-    CONTEXT_EXEC(StencilMaskSeparate(face, mask));
+    CONTEXT_EXEC_ASYNC(StencilMaskSeparate(face, mask));
+    GLOVE_CAPTURE_CALL(glStencilMaskSeparate, face, mask);
 }
 
 void GL_APIENTRY
 glStencilOp(GLenum fail, GLenum zfail, GLenum zpass)
 {
-    CONTEXT_EXEC(StencilOp(fail, zfail, zpass));
+    CONTEXT_EXEC_ASYNC(StencilOp(fail, zfail, zpass));
+    GLOVE_CAPTURE_CALL(glStencilOp, fail, zfail, zpass);
 }
 
 void GL_APIENTRY
 glStencilOpSeparate(GLenum face, GLenum fail, GLenum zfail, GLenum zpass)
 {
-    CONTEXT_EXEC(StencilOpSeparate(face, fail, zfail, zpass));
+    CONTEXT_EXEC_ASYNC(StencilOpSeparate(face, fail, zfail, zpass));
+    GLOVE_CAPTURE_CALL(glStencilOpSeparate, face, fail, zfail, zpass);
 }
 
 void GL_APIENTRY
 glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels)
 {
     CONTEXT_EXEC(TexImage2D(target, level, internalformat, width, height, border, format, type, pixels));
+    GLOVE_CAPTURE_CALL(glTexImage2D, target, level, internalformat, width, height, border, format, type, GLCapture::Pixels(context, width, height, format, type, pixels));
 }
 
 void GL_APIENTRY
 glTexParameterf(GLenum target, GLenum pname, GLfloat param)
 {
-    CONTEXT_EXEC(TexParameterf(target, pname, param));
+    CONTEXT_EXEC_ASYNC(TexParameterf(target, pname, param));
+    GLOVE_CAPTURE_CALL(glTexParameterf, target, pname, param);
 }
 
 void GL_APIENTRY
 glTexParameterfv(GLenum target, GLenum pname, const GLfloat* params)
 {
-    CONTEXT_EXEC(TexParameterfv(target, pname, params));
+    CONTEXT_EXEC_ASYNC_DATA(const GLfloat *, params, sizeof(GLfloat), TexParameterfv(target, pname, params));
+    GLOVE_CAPTURE_CALL(glTexParameterfv, target, pname, GLCapture::Data(params, sizeof(GLfloat)));
 }
 
 void GL_APIENTRY
 glTexParameteri(GLenum target, GLenum pname, GLint param)
 {
-    CONTEXT_EXEC(TexParameteri(target, pname, param));
+    CONTEXT_EXEC_ASYNC(TexParameteri(target, pname, param));
+    GLOVE_CAPTURE_CALL(glTexParameteri, target, pname, param);
 }
 
 void GL_APIENTRY
 glTexParameteriv(GLenum target, GLenum pname, const GLint* params)
 {
-    CONTEXT_EXEC(TexParameteriv(target, pname, params));
+    CONTEXT_EXEC_ASYNC_DATA(const GLint *, params, sizeof(GLint), TexParameteriv(target, pname, params));
+    GLOVE_CAPTURE_CALL(glTexParameteriv, target, pname, GLCapture::Data(params, sizeof(GLint)));
 }
 
 void GL_APIENTRY
 glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels)
 {
     CONTEXT_EXEC(TexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, pixels));
+    GLOVE_CAPTURE_CALL(glTexSubImage2D, target, level, xoffset, yoffset, width, height, format, type, GLCapture::Pixels(context, width, height, format, type, pixels));
 }
 
 void GL_APIENTRY
 glUniform1f(GLint location, GLfloat x)
 {
-    CONTEXT_EXEC(Uniform1f(location, x));
+    CONTEXT_EXEC_ASYNC(Uniform1f(location, x));
+    GLOVE_CAPTURE_CALL(glUniform1f, location, x);
 }
 
 void GL_APIENTRY
 glUniform1fv(GLint location, GLsizei count, const GLfloat* v)
 {
-    CONTEXT_EXEC(Uniform1fv(location, count, v));
+    CONTEXT_EXEC_ASYNC_DATA(const GLfloat *, v, count > 0 ? count * sizeof(GLfloat) : 0, Uniform1fv(location, count, v));
+    GLOVE_CAPTURE_CALL(glUniform1fv, location, count, GLCapture::Data(v, count > 0 ? count * sizeof(GLfloat) : 0));
 }
 
 void GL_APIENTRY
 glUniform1i(GLint location, GLint x)
 {
-    CONTEXT_EXEC(Uniform1i(location, x));
+    CONTEXT_EXEC_ASYNC(Uniform1i(location, x));
+    GLOVE_CAPTURE_CALL(glUniform1i, location, x);
 }
 
 void GL_APIENTRY
 glUniform1iv(GLint location, GLsizei count, const GLint* v)
 {
-    CONTEXT_EXEC(Uniform1iv(location, count, v));
+    CONTEXT_EXEC_ASYNC_DATA(const GLint *, v, count > 0 ? count * sizeof(GLint) : 0, Uniform1iv(location, count, v));
+    GLOVE_CAPTURE_CALL(glUniform1iv, location, count, GLCapture::Data(v, count > 0 ? count * sizeof(GLint) : 0));
 }
 
 void GL_APIENTRY
 glUniform2f(GLint location, GLfloat x, GLfloat y)
 {
-    CONTEXT_EXEC(Uniform2f(location, x, y));
+    CONTEXT_EXEC_ASYNC(Uniform2f(location, x, y));
+    GLOVE_CAPTURE_CALL(glUniform2f, location, x, y);
 }
 
 void GL_APIENTRY
 glUniform2fv(GLint location, GLsizei count, const GLfloat* v)
 {
-    CONTEXT_EXEC(Uniform2fv(location, count, v));
+    CONTEXT_EXEC_ASYNC_DATA(const GLfloat *, v, count > 0 ? count * 2 * sizeof(GLfloat) : 0, Uniform2fv(location, count, v));
+    GLOVE_CAPTURE_CALL(glUniform2fv, location, count, GLCapture::Data(v, count > 0 ? count * 2 * sizeof(GLfloat) : 0));
 }
 
 void GL_APIENTRY
 glUniform2i(GLint location, GLint x, GLint y)
 {
-    CONTEXT_EXEC(Uniform2i(location, x, y));
+    CONTEXT_EXEC_ASYNC(Uniform2i(location, x, y));
+    GLOVE_CAPTURE_CALL(glUniform2i, location, x, y);
 }
 
 void GL_APIENTRY
 glUniform2iv(GLint location, GLsizei count, const GLint* v)
 {
-    CONTEXT_EXEC(Uniform2iv(location, count, v));
+    CONTEXT_EXEC_ASYNC_DATA(const GLint *, v, count > 0 ? count * 2 * sizeof(GLint) : 0, Uniform2iv(location, count, v));
+    GLOVE_CAPTURE_CALL(glUniform2iv, location, count, GLCapture::Data(v, count > 0 ? count * 2 * sizeof(GLint) : 0));
 }
 
 void GL_APIENTRY
 glUniform3f(GLint location, GLfloat x, GLfloat y, GLfloat z)
 {
-    CONTEXT_EXEC(Uniform3f(location, x, y, z));
+    CONTEXT_EXEC_ASYNC(Uniform3f(location, x, y, z));
+    GLOVE_CAPTURE_CALL(glUniform3f, location, x, y, z);
 }
 
 void GL_APIENTRY
 glUniform3fv(GLint location, GLsizei count, const GLfloat* v)
 {
-    CONTEXT_EXEC(Uniform3fv(location, count, v));
+    CONTEXT_EXEC_ASYNC_DATA(const GLfloat *, v, count > 0 ? count * 3 * sizeof(GLfloat) : 0, Uniform3fv(location, count, v));
+    GLOVE_CAPTURE_CALL(glUniform3fv, location, count, GLCapture::Data(v, count > 0 ? count * 3 * sizeof(GLfloat) : 0));
 }
 
 void GL_APIENTRY
 glUniform3i(GLint location, GLint x, GLint y, GLint z)
 {
-    CONTEXT_EXEC(Uniform3i(location, x, y, z));
+    CONTEXT_EXEC_ASYNC(Uniform3i(location, x, y, z));
+    GLOVE_CAPTURE_CALL(glUniform3i, location, x, y, z);
 }
 
 void GL_APIENTRY
 glUniform3iv(GLint location, GLsizei count, const GLint* v)
 {
-    CONTEXT_EXEC(Uniform3iv(location, count, v));
+    CONTEXT_EXEC_ASYNC_DATA(const GLint *, v, count > 0 ? count * 3 * sizeof(GLint) : 0, Uniform3iv(location, count, v));
+    GLOVE_CAPTURE_CALL(glUniform3iv, location, count, GLCapture::Data(v, count > 0 ? count * 3 * sizeof(GLint) : 0));
 }
 
 void GL_APIENTRY
 glUniform4f(GLint location, GLfloat x, GLfloat y, GLfloat z, GLfloat w)
 {
-    CONTEXT_EXEC(Uniform4f(location, x, y, z, w));
+    CONTEXT_EXEC_ASYNC(Uniform4f(location, x, y, z, w));
+    GLOVE_CAPTURE_CALL(glUniform4f, location, x, y, z, w);
 }
 
 void GL_APIENTRY
 glUniform4fv(GLint location, GLsizei count, const GLfloat* v)
 {
-    CONTEXT_EXEC(Uniform4fv(location, count, v));
+    CONTEXT_EXEC_ASYNC_DATA(const GLfloat *, v, count > 0 ? count * 4 * sizeof(GLfloat) : 0, Uniform4fv(location, count, v));
+    GLOVE_CAPTURE_CALL(glUniform4fv, location, count, GLCapture::Data(v, count > 0 ? count * 4 * sizeof(GLfloat) : 0));
 }
 
 void GL_APIENTRY
 glUniform4i(GLint location, GLint x, GLint y, GLint z, GLint w)
 {
-    CONTEXT_EXEC(Uniform4i(location, x, y, z, w));
+    CONTEXT_EXEC_ASYNC(Uniform4i(location, x, y, z, w));
+    GLOVE_CAPTURE_CALL(glUniform4i, location, x, y, z, w);
 }
 
 void GL_APIENTRY
 glUniform4iv(GLint location, GLsizei count, const GLint* v)
 {
-    CONTEXT_EXEC(Uniform4iv(location, count, v));
+    CONTEXT_EXEC_ASYNC_DATA(const GLint *, v, count > 0 ? count * 4 * sizeof(GLint) : 0, Uniform4iv(location, count, v));
+    GLOVE_CAPTURE_CALL(glUniform4iv, location, count, GLCapture::Data(v, count > 0 ? count * 4 * sizeof(GLint) : 0));
 }
 
 void GL_APIENTRY
 glUniformMatrix2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
 {
-    CONTEXT_EXEC(UniformMatrix2fv(location, count, transpose, value));
+    CONTEXT_EXEC_ASYNC_DATA(const GLfloat *, value, count > 0 ? count * 4 * sizeof(GLfloat) : 0, UniformMatrix2fv(location, count, transpose, value));
+    GLOVE_CAPTURE_CALL(glUniformMatrix2fv, location, count, transpose, GLCapture::Data(value, count > 0 ? count * 4 * sizeof(GLfloat) : 0));
 }
 
 void GL_APIENTRY
 glUniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
 {
-    CONTEXT_EXEC(UniformMatrix3fv(location, count, transpose, value));
+    CONTEXT_EXEC_ASYNC_DATA(const GLfloat *, value, count > 0 ? count * 9 * sizeof(GLfloat) : 0, UniformMatrix3fv(location, count, transpose, value));
+    GLOVE_CAPTURE_CALL(glUniformMatrix3fv, location, count, transpose, GLCapture::Data(value, count > 0 ? count * 9 * sizeof(GLfloat) : 0));
 }
 
 void GL_APIENTRY
 glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
 {
-    CONTEXT_EXEC(UniformMatrix4fv(location, count, transpose, value));
+    CONTEXT_EXEC_ASYNC_DATA(const GLfloat *, value, count > 0 ? count * 16 * sizeof(GLfloat) : 0, UniformMatrix4fv(location, count, transpose, value));
+    GLOVE_CAPTURE_CALL(glUniformMatrix4fv, location, count, transpose, GLCapture::Data(value, count > 0 ? count * 16 * sizeof(GLfloat) : 0));
 }
 
 void GL_APIENTRY
 glUseProgram(GLuint program)
 {
-    CONTEXT_EXEC(UseProgram(program));
+    CONTEXT_EXEC_ASYNC(UseProgram(program));
+    GLOVE_CAPTURE_CALL(glUseProgram, program);
 }
 
 void GL_APIENTRY
 glValidateProgram(GLuint program)
 {
-    CONTEXT_EXEC(ValidateProgram(program));
+    CONTEXT_EXEC_ASYNC(ValidateProgram(program));
+    GLOVE_CAPTURE_CALL(glValidateProgram, program);
 }
 
 void GL_APIENTRY
 glVertexAttrib1f(GLuint indx, GLfloat x)
 {
-    CONTEXT_EXEC(VertexAttrib1f(indx, x));
+    CONTEXT_EXEC_ASYNC(VertexAttrib1f(indx, x));
+    GLOVE_CAPTURE_CALL(glVertexAttrib1f, indx, x);
 }
 
 void GL_APIENTRY
 glVertexAttrib1fv(GLuint indx, const GLfloat* values)
 {
-    CONTEXT_EXEC(VertexAttrib1fv(indx, values));
+    CONTEXT_EXEC_ASYNC_DATA(const GLfloat *, values, sizeof(GLfloat), VertexAttrib1fv(indx, values));
+    GLOVE_CAPTURE_CALL(glVertexAttrib1fv, indx, GLCapture::Data(values, sizeof(GLfloat)));
 }
 
 void GL_APIENTRY
 glVertexAttrib2f(GLuint indx, GLfloat x, GLfloat y)
 {
-    CONTEXT_EXEC(VertexAttrib2f(indx, x, y));
+    CONTEXT_EXEC_ASYNC(VertexAttrib2f(indx, x, y));
+    GLOVE_CAPTURE_CALL(glVertexAttrib2f, indx, x, y);
 }
 
 void GL_APIENTRY
 glVertexAttrib2fv(GLuint indx, const GLfloat* values)
 {
-    CONTEXT_EXEC(VertexAttrib2fv(indx, values));
+    CONTEXT_EXEC_ASYNC_DATA(const GLfloat *, values, 2 * sizeof(GLfloat), VertexAttrib2fv(indx, values));
+    GLOVE_CAPTURE_CALL(glVertexAttrib2fv, indx, GLCapture::Data(values, 2 * sizeof(GLfloat)));
 }
 
 void GL_APIENTRY
 glVertexAttrib3f(GLuint indx, GLfloat x, GLfloat y, GLfloat z)
 {
-    CONTEXT_EXEC(VertexAttrib3f(indx, x, y, z));
+    CONTEXT_EXEC_ASYNC(VertexAttrib3f(indx, x, y, z));
+    GLOVE_CAPTURE_CALL(glVertexAttrib3f, indx, x, y, z);
 }
 
 void GL_APIENTRY
 glVertexAttrib3fv(GLuint indx, const GLfloat* values)
 {
-    CONTEXT_EXEC(VertexAttrib3fv(indx, values));
+    CONTEXT_EXEC_ASYNC_DATA(const GLfloat *, values, 3 * sizeof(GLfloat), VertexAttrib3fv(indx, values));
+    GLOVE_CAPTURE_CALL(glVertexAttrib3fv, indx, GLCapture::Data(values, 3 * sizeof(GLfloat)));
 }
 
 void GL_APIENTRY
 glVertexAttrib4f(GLuint indx, GLfloat x, GLfloat y, GLfloat z, GLfloat w)
 {
-    CONTEXT_EXEC(VertexAttrib4f(indx, x, y, z, w));
+    CONTEXT_EXEC_ASYNC(VertexAttrib4f(indx, x, y, z, w));
+    GLOVE_CAPTURE_CALL(glVertexAttrib4f, indx, x, y, z, w);
 }
 
 void GL_APIENTRY
 glVertexAttrib4fv(GLuint indx, const GLfloat* values)
 {
-    CONTEXT_EXEC(VertexAttrib4fv(indx, values));
+    CONTEXT_EXEC_ASYNC_DATA(const GLfloat *, values, 4 * sizeof(GLfloat), VertexAttrib4fv(indx, values));
+    GLOVE_CAPTURE_CALL(glVertexAttrib4fv, indx, GLCapture::Data(values, 4 * sizeof(GLfloat)));
 }
 
 void GL_APIENTRY
 glVertexAttribPointer(GLuint indx, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* ptr)
 {
-    CONTEXT_EXEC(VertexAttribPointer(indx, size, type, normalized, stride, ptr));
+    CONTEXT_EXEC_ASYNC(VertexAttribPointer(indx, size, type, normalized, stride, ptr));
+    GLOVE_GLTHREAD_TRACK(VertexAttribPointer(indx));
+    GLOVE_CAPTURE_EXEC(VertexAttribPointer(context, indx, size, type, normalized, stride, ptr));
 }
 
 void GL_APIENTRY
 glViewport(GLint x, GLint y, GLsizei width, GLsizei height)
 {
-    CONTEXT_EXEC(Viewport(x, y, width, height));
+    CONTEXT_EXEC_ASYNC(Viewport(x, y, width, height));
+    GLOVE_CAPTURE_CALL(glViewport, x, y, width, height);
 }
 
 void GL_APIENTRY
@@ -901,18 +1089,21 @@ void GL_APIENTRY
 glInsertEventMarkerEXT(GLsizei length, const GLchar *marker)
 {
     CONTEXT_EXEC(InsertEventMarkerEXT(length, marker));
+    GLOVE_CAPTURE_CALL(glInsertEventMarkerEXT, length, GLCapture::Marker(length, marker));
 }
 
 void GL_APIENTRY
 glPushGroupMarkerEXT(GLsizei length, const GLchar *marker)
 {
     CONTEXT_EXEC(PushGroupMarkerEXT(length, marker));
+    GLOVE_CAPTURE_CALL(glPushGroupMarkerEXT, length, GLCapture::Marker(length, marker));
 }
 
 void GL_APIENTRY
 glPopGroupMarkerEXT(void)
 {
-    CONTEXT_EXEC(PopGroupMarkerEXT());
+    CONTEXT_EXEC_ASYNC(PopGroupMarkerEXT());
+    GLOVE_CAPTURE_CALL(glPopGroupMarkerEXT);
 }
 
 void GL_APIENTRY glGetProgramBinaryOES(GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary)
@@ -923,4 +1114,296 @@ void GL_APIENTRY glGetProgramBinaryOES(GLuint program, GLsizei bufSize, GLsizei
 void GL_APIENTRY glProgramBinaryOES(GLuint program, GLenum binaryFormat, const void *binary, GLint length)
 {
     CONTEXT_EXEC(ProgramBinaryOES(program, binaryFormat, binary, length));
+    GLOVE_CAPTURE_CALL(glProgramBinaryOES, program, binaryFormat, GLCapture::Data(binary, length > 0 ? length : 0), length);
+}
+
+void GL_APIENTRY glBindVertexArrayOES(GLuint array)
+{
+    CONTEXT_EXEC_ASYNC(BindVertexArrayOES(array));
+    GLOVE_GLTHREAD_TRACK(BindVertexArray(array));
+    GLOVE_CAPTURE_EXEC(BindVertexArray(array));
+}
+
+void GL_APIENTRY glDeleteVertexArraysOES(GLsizei n, const GLuint *arrays)
+{
+    CONTEXT_EXEC_ASYNC_DATA(const GLuint *, arrays, n > 0 ? n * sizeof(GLuint) : 0, DeleteVertexArraysOES(n, arrays));
+    GLOVE_GLTHREAD_TRACK(DeleteVertexArrays(n, arrays));
+    GLOVE_CAPTURE_EXEC(DeleteVertexArrays(n, arrays));
+}
+
+void GL_APIENTRY glGenVertexArraysOES(GLsizei n, GLuint *arrays)
+{
+    CONTEXT_EXEC(GenVertexArraysOES(n, arrays));
+    GLOVE_CAPTURE_CALL(glGenVertexArraysOES, n, GLCapture::Output(n > 0 ? n * sizeof(GLuint) : 0));
+}
+
+GLboolean GL_APIENTRY glIsVertexArrayOES(GLuint array)
+{
+    CONTEXT_EXEC_RETURN(IsVertexArrayOES(array));
+}
+
+void GL_APIENTRY glDrawArraysInstancedANGLE(GLenum mode, GLint first, GLsizei count, GLsizei primcount)
+{
+    CONTEXT_EXEC_ASYNC_IF(DrawsFromBuffers(false), DrawArraysInstancedEXT(mode, first, count, primcount));
+    GLOVE_CAPTURE_EXEC(ClientArrays(context, first, count, primcount));
+    GLOVE_CAPTURE_CALL(glDrawArraysInstancedEXT, mode, first, count, primcount);
+}
+
+void GL_APIENTRY glDrawElementsInstancedANGLE(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei primcount)
+{
+    CONTEXT_EXEC_ASYNC_IF(DrawsFromBuffers(true), DrawElementsInstancedEXT(mode, count, type, indices, primcount));
+    GLOVE_CAPTURE_EXEC(ClientArrays(context, count, type, indices, primcount));
+    GLOVE_CAPTURE_CALL(glDrawElementsInstancedEXT, mode, count, type, GLCapture::Indices(context, count, type, indices), primcount);
+}
+
+void GL_APIENTRY glVertexAttribDivisorANGLE(GLuint index, GLuint divisor)
+{
+    CONTEXT_EXEC_ASYNC(VertexAttribDivisorEXT(index, divisor));
+    GLOVE_CAPTURE_EXEC(VertexAttribDivisor(index, divisor));
+}
+
+void GL_APIENTRY glDrawArraysInstancedEXT(GLenum mode, GLint start, GLsizei count, GLsizei primcount)
+{
+    CONTEXT_EXEC_ASYNC_IF(DrawsFromBuffers(false), DrawArraysInstancedEXT(mode, start, count, primcount));
+    GLOVE_CAPTURE_EXEC(ClientArrays(context, start, count, primcount));
+    GLOVE_CAPTURE_CALL(glDrawArraysInstancedEXT, mode, start, count, primcount);
+}
+
+void GL_APIENTRY glDrawElementsInstancedEXT(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei primcount)
+{
+    CONTEXT_EXEC_ASYNC_IF(DrawsFromBuffers(true), DrawElementsInstancedEXT(mode, count, type, indices, primcount));
+    GLOVE_CAPTURE_EXEC(ClientArrays(context, count, type, indices, primcount));
+    GLOVE_CAPTURE_CALL(glDrawElementsInstancedEXT, mode, count, type, GLCapture::Indices(context, count, type, indices), primcount);
+}
+
+void GL_APIENTRY glVertexAttribDivisorEXT(GLuint index, GLuint divisor)
+{
+    CONTEXT_EXEC_ASYNC(VertexAttribDivisorEXT(index, divisor));
+    GLOVE_CAPTURE_EXEC(VertexAttribDivisor(index, divisor));
+}
+
+void * GL_APIENTRY glMapBufferOES(GLenum target, GLenum access)
+{
+    CONTEXT_EXEC_RETURN(MapBufferOES(target, access));
+}
+
+GLboolean GL_APIENTRY glUnmapBufferOES(GLenum target)
+{
+    GLOVE_CAPTURE_BEFORE(Unmap(context, target));
+    CONTEXT_EXEC_RETURN(UnmapBufferOES(target));
+}
+
+void GL_APIENTRY glGetBufferPointervOES(GLenum target, GLenum pname, void **params)
+{
+    CONTEXT_EXEC(GetBufferPointervOES(target, pname, params));
+}
+
+void * GL_APIENTRY glMapBufferRangeEXT(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+    CONTEXT_EXEC_RETURN(MapBufferRangeEXT(target, offset, length, access));
+}
+
+void GL_APIENTRY glFlushMappedBufferRangeEXT(GLenum target, GLintptr offset, GLsizeiptr length)
+{
+    CONTEXT_EXEC(FlushMappedBufferRangeEXT(target, offset, length));
+    GLOVE_CAPTURE_EXEC(FlushMappedRange(context, target, offset, length));
+}
+
+void GL_APIENTRY glTexStorage2DEXT(GLenum target, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height)
+{
+    CONTEXT_EXEC_ASYNC(TexStorage2DEXT(target, levels, internalformat, width, height));
+    GLOVE_CAPTURE_CALL(glTexStorage2DEXT, target, levels, internalformat, width, height);
+}
+
+void GL_APIENTRY glTexImage3DOES(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLenum format, GLenum type, const void *pixels)
+{
+    CONTEXT_EXEC(TexImage3DOES(target, level, internalformat, width, height, depth, border, format, type, pixels));
+    GLOVE_CAPTURE_CALL(glTexImage3DOES, target, level, internalformat, width, height, depth, border, format, type, GLCapture::Pixels(context, width, height * depth, format, type, pixels));
+}
+
+void GL_APIENTRY glTexSubImage3DOES(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void *pixels)
+{
+    CONTEXT_EXEC(TexSubImage3DOES(target, level, xoffset, yoffset, zoffset, width, height, depth, format, type, pixels));
+    GLOVE_CAPTURE_CALL(glTexSubImage3DOES, target, level, xoffset, yoffset, zoffset, width, height, depth, format, type, GLCapture::Pixels(context, width, height * depth, format, type, pixels));
+}
+
+void GL_APIENTRY glCopyTexSubImage3DOES(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    CONTEXT_EXEC_ASYNC(CopyTexSubImage3DOES(target, level, xoffset, yoffset, zoffset, x, y, width, height));
+    GLOVE_CAPTURE_CALL(glCopyTexSubImage3DOES, target, level, xoffset, yoffset, zoffset, x, y, width, height);
+}
+
+void GL_APIENTRY glCompressedTexImage3DOES(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLsizei imageSize, const void *data)
+{
+    CONTEXT_EXEC(CompressedTexImage3DOES(target, level, internalformat, width, height, depth, border, imageSize, data));
+    GLOVE_CAPTURE_CALL(glCompressedTexImage3DOES, target, level, internalformat, width, height, depth, border, imageSize, GLCapture::Data(data, imageSize > 0 ? imageSize : 0));
+}
+
+void GL_APIENTRY glCompressedTexSubImage3DOES(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLsizei imageSize, const void *data)
+{
+    CONTEXT_EXEC(CompressedTexSubImage3DOES(target, level, xoffset, yoffset, zoffset, width, height, depth, format, imageSize, data));
+    GLOVE_CAPTURE_CALL(glCompressedTexSubImage3DOES, target, level, xoffset, yoffset, zoffset, width, height, depth, format, imageSize, GLCapture::Data(data, imageSize > 0 ? imageSize : 0));
+}
+
+void GL_APIENTRY glFramebufferTexture3DOES(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level, GLint zoffset)
+{
+    CONTEXT_EXEC_ASYNC(FramebufferTexture3DOES(target, attachment, textarget, texture, level, zoffset));
+    GLOVE_CAPTURE_CALL(glFramebufferTexture3DOES, target, attachment, textarget, texture, level, zoffset);
+}
+
+void GL_APIENTRY glDiscardFramebufferEXT(GLenum target, GLsizei numAttachments, const GLenum *attachments)
+{
+    CONTEXT_EXEC_ASYNC_DATA(const GLenum *, attachments, numAttachments > 0 ? numAttachments * sizeof(GLenum) : 0, DiscardFramebufferEXT(target, numAttachments, attachments));
+    GLOVE_CAPTURE_CALL(glDiscardFramebufferEXT, target, numAttachments, GLCapture::Data(attachments, numAttachments > 0 ? numAttachments * sizeof(GLenum) : 0));
+}
+
+void GL_APIENTRY glRenderbufferStorageMultisampleEXT(GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height)
+{
+    CONTEXT_EXEC_ASYNC(RenderbufferStorageMultisampleEXT(target, samples, internalformat, width, height));
+    GLOVE_CAPTURE_CALL(glRenderbufferStorageMultisampleEXT, target, samples, internalformat, width, height);
+}
+
+void GL_APIENTRY glFramebufferTexture2DMultisampleEXT(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level, GLsizei samples)
+{
+    CONTEXT_EXEC_ASYNC(FramebufferTexture2DMultisampleEXT(target, attachment, textarget, texture, level, samples));
+    GLOVE_CAPTURE_CALL(glFramebufferTexture2DMultisampleEXT, target, attachment, textarget, texture, level, samples);
+}
+
+void GL_APIENTRY glMaxShaderCompilerThreadsKHR(GLuint count)
+{
+    CONTEXT_EXEC(MaxShaderCompilerThreadsKHR(count));
+    GLOVE_CAPTURE_CALL(glMaxShaderCompilerThreadsKHR, count);
+}
+
+void GL_APIENTRY glGenQueriesEXT(GLsizei n, GLuint *ids)
+{
+    CONTEXT_EXEC(GenQueriesEXT(n, ids));
+    GLOVE_CAPTURE_CALL(glGenQueriesEXT, n, GLCapture::Output(n > 0 ? n * sizeof(GLuint) : 0));
+}
+
+void GL_APIENTRY glDeleteQueriesEXT(GLsizei n, const GLuint *ids)
+{
+    CONTEXT_EXEC(DeleteQueriesEXT(n, ids));
+    GLOVE_CAPTURE_CALL(glDeleteQueriesEXT, n, GLCapture::Data(ids, n > 0 ? n * sizeof(GLuint) : 0));
+}
+
+GLboolean GL_APIENTRY glIsQueryEXT(GLuint id)
+{
+    CONTEXT_EXEC_RETURN(IsQueryEXT(id));
+}
+
+void GL_APIENTRY glBeginQueryEXT(GLenum target, GLuint id)
+{
+    CONTEXT_EXEC_ASYNC(BeginQueryEXT(target, id));
+    GLOVE_CAPTURE_CALL(glBeginQueryEXT, target, id);
+}
+
+void GL_APIENTRY glEndQueryEXT(GLenum target)
+{
+    CONTEXT_EXEC_ASYNC(EndQueryEXT(target));
+    GLOVE_CAPTURE_CALL(glEndQueryEXT, target);
+}
+
+void GL_APIENTRY glQueryCounterEXT(GLuint id, GLenum target)
+{
+    CONTEXT_EXEC_ASYNC(QueryCounterEXT(id, target));
+    GLOVE_CAPTURE_CALL(glQueryCounterEXT, id, target);
+}
+
+void GL_APIENTRY glGetQueryivEXT(GLenum target, GLenum pname, GLint *params)
+{
+    CONTEXT_EXEC(GetQueryivEXT(target, pname, params));
+}
+
+void GL_APIENTRY glGetQueryObjectivEXT(GLuint id, GLenum pname, GLint *params)
+{
+    CONTEXT_EXEC(GetQueryObjectivEXT(id, pname, params));
+}
+
+void GL_APIENTRY glGetQueryObjectuivEXT(GLuint id, GLenum pname, GLuint *params)
+{
+    CONTEXT_EXEC(GetQueryObjectuivEXT(id, pname, params));
+}
+
+void GL_APIENTRY glGetQueryObjecti64vEXT(GLuint id, GLenum pname, GLint64 *params)
+{
+    CONTEXT_EXEC(GetQueryObjecti64vEXT(id, pname, params));
+}
+
+void GL_APIENTRY glGetQueryObjectui64vEXT(GLuint id, GLenum pname, GLuint64 *params)
+{
+    CONTEXT_EXEC(GetQueryObjectui64vEXT(id, pname, params));
+}
+
+// the capture keeps its format by recording every draw of a multi-draw on its own
+void GL_APIENTRY glMultiDrawArraysEXT(GLenum mode, const GLint *first, const GLsizei *count, GLsizei primcount)
+{
+    CONTEXT_EXEC(MultiDrawArraysEXT(mode, first, count, primcount));
+    for(GLsizei i = 0; i < primcount; ++i) {
+        GLOVE_CAPTURE_EXEC(ClientArrays(context, first[i], count[i], 1));
+        GLOVE_CAPTURE_CALL(glDrawArrays, mode, first[i], count[i]);
+    }
+}
+
+void GL_APIENTRY glMultiDrawElementsEXT(GLenum mode, const GLsizei *count, GLenum type, const void *const *indices, GLsizei primcount)
+{
+    CONTEXT_EXEC(MultiDrawElementsEXT(mode, count, type, indices, primcount));
+    for(GLsizei i = 0; i < primcount; ++i) {
+        GLOVE_CAPTURE_EXEC(ClientArrays(context, count[i], type, indices[i], 1));
+        GLOVE_CAPTURE_CALL(glDrawElements, mode, count[i], type, GLCapture::Indices(context, count[i], type, indices[i]));
+    }
+}
+
+void GL_APIENTRY glGetMemoryReportGLOVE(GLboolean resetPeaks, GLsizei bufSize, GLsizei *length, GLchar *report)
+{
+    CONTEXT_EXEC(GetMemoryReportGLOVE(resetPeaks, bufSize, length, report));
+}
+
+void GL_APIENTRY glDrawRangeElements(GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, const void *indices)
+{
+    CONTEXT_EXEC(DrawRangeElements(mode, start, end, count, type, indices));
+    GLOVE_CAPTURE_EXEC(ClientArrays(context, count, type, indices, 1));
+    GLOVE_CAPTURE_CALL(glDrawElements, mode, count, type, GLCapture::Indices(context, count, type, indices));
+}
+
+void GL_APIENTRY glBlitFramebufferANGLE(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter)
+{
+    CONTEXT_EXEC_ASYNC(BlitFramebufferANGLE(srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter));
+    GLOVE_CAPTURE_CALL(glBlitFramebufferNV, srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter);
+}
+
+void GL_APIENTRY glBlitFramebufferNV(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter)
+{
+    CONTEXT_EXEC_ASYNC(BlitFramebufferNV(srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter));
+    GLOVE_CAPTURE_CALL(glBlitFramebufferNV, srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter);
+}
+
+void GL_APIENTRY glGenCommandBundlesGLOVE(GLsizei n, GLuint *bundles)
+{
+    CONTEXT_EXEC(GenCommandBundlesGLOVE(n, bundles));
+    GLOVE_CAPTURE_CALL(glGenCommandBundlesGLOVE, n, GLCapture::Output(n > 0 ? n * sizeof(GLuint) : 0));
+}
+
+void GL_APIENTRY glDeleteCommandBundlesGLOVE(GLsizei n, const GLuint *bundles)
+{
+    CONTEXT_EXEC(DeleteCommandBundlesGLOVE(n, bundles));
+    GLOVE_CAPTURE_CALL(glDeleteCommandBundlesGLOVE, n, GLCapture::Data(bundles, n > 0 ? n * sizeof(GLuint) : 0));
+}
+
+void GL_APIENTRY glBeginCommandBundleGLOVE(GLuint bundle)
+{
+    CONTEXT_EXEC_ASYNC(BeginCommandBundleGLOVE(bundle));
+    GLOVE_CAPTURE_CALL(glBeginCommandBundleGLOVE, bundle);
+}
+
+void GL_APIENTRY glEndCommandBundleGLOVE(void)
+{
+    CONTEXT_EXEC_ASYNC(EndCommandBundleGLOVE());
+    GLOVE_CAPTURE_CALL(glEndCommandBundleGLOVE);
+}
+
+void GL_APIENTRY glCallCommandBundleGLOVE(GLuint bundle)
+{
+    CONTEXT_EXEC_ASYNC(CallCommandBundleGLOVE(bundle));
+    GLOVE_CAPTURE_CALL(glCallCommandBundleGLOVE, bundle);
 }
@@ -0,0 +1,462 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       glCapture.cpp
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Capture of the GL command stream, for CAPTURE_BUILD builds
+ *
+ *  @section
+ *
+ *  The calls are recorded after GLOVE executed them, in the layout of
+ *  glCaptureFormat.h. Client memory is copied into the records: client arrays
+ *  are sized by the draws reading them, from the attribute state the capture
+ *  shadows, and mapped buffer ranges are recorded as glBufferSubData when they
+ *  are flushed or unmapped. A single context is assumed, and object names are
+ *  recorded as they are, since a fresh context replaying the same calls
+ *  generates the same names.
+ *
+ */
+
+#ifdef CAPTURE_BUILD
+
+#include "glCapture.h"
+#include "context/context.h"
+#include "utils/indexUtils.h"
+#include "resources/rect.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <string>
+
+typedef struct CaptureAttrib {
+    GLint                         size;
+    GLenum                        type;
+    GLboolean                     normalized;
+    GLsizei                       stride;
+    const void                   *ptr;
+    bool                          client;
+    bool                          enabled;
+    GLuint                        divisor;
+} CaptureAttrib;
+
+typedef struct CaptureVertexArray {
+    CaptureAttrib                 attribs[GLOVE_MAX_VERTEX_ATTRIBS];
+} CaptureVertexArray;
+
+static std::mutex                 captureMutex;
+static FILE                      *captureFile   = nullptr;
+static bool                       captureFailed = false;
+static thread_local std::vector<uint8_t> captureRecord;
+
+static std::map<GLuint, CaptureVertexArray> captureVertexArrays;
+static GLuint                     captureActiveVertexArray = 0;
+
+static CaptureAttrib *
+ActiveAttribs(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    auto it = captureVertexArrays.find(captureActiveVertexArray);
+    if(it == captureVertexArrays.end()) {
+        CaptureVertexArray vertexArray;
+        for(CaptureAttrib &attrib : vertexArray.attribs) {
+            attrib = { 4, GL_FLOAT, GL_FALSE, 0, nullptr, false, false, 0 };
+        }
+        it = captureVertexArrays.emplace(captureActiveVertexArray, vertexArray).first;
+    }
+    return it->second.attribs;
+}
+
+static size_t
+IndexElementSize(GLenum type)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    return type == GL_UNSIGNED_INT  ? sizeof(GLuint)  :
+           type == GL_UNSIGNED_BYTE ? sizeof(GLubyte) : sizeof(GLushort);
+}
+
+static size_t
+PixelsSize(GLsizei width, GLsizei height, GLenum format, GLenum type, GLint alignment)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(width <= 0 || height <= 0) {
+        return 0;
+    }
+
+    ImageRect rect(0, 0, width, height,
+                   GlInternalFormatTypeToNumElements(GlFormatToGlInternalFormat(format, type), type),
+                   GlTypeToElementSize(type), alignment);
+    return rect.GetRectBufferSize();
+}
+
+std::vector<uint8_t> &
+GLCapture::Begin(uint32_t id)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    captureRecord.clear();
+    gloveCaptureRecord_t header = { id, 0 };
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&header);
+    captureRecord.insert(captureRecord.end(), bytes, bytes + sizeof(header));
+    return captureRecord;
+}
+
+void
+GLCapture::End(std::vector<uint8_t> &record)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    uint32_t size = static_cast<uint32_t>(record.size() - sizeof(gloveCaptureRecord_t));
+    memcpy(record.data() + offsetof(gloveCaptureRecord_t, size), &size, sizeof(size));
+
+    std::lock_guard<std::mutex> lock(captureMutex);
+
+    if(!captureFile && !captureFailed) {
+        const char *path = getenv(GLOVE_CAPTURE_FILE_ENV);
+        path = path && *path ? path : "glove_capture.bin";
+
+        captureFile = fopen(path, "wb");
+        if(!captureFile) {
+            GLOVE_PRINT_ERR("Cannot open the capture file %s\n", path);
+            captureFailed = true;
+            return;
+        }
+
+        gloveCaptureHeader_t header = { GLOVE_CAPTURE_MAGIC, GLOVE_CAPTURE_VERSION };
+        fwrite(&header, sizeof(header), 1, captureFile);
+    }
+
+    if(captureFile) {
+        fwrite(record.data(), 1, record.size(), captureFile);
+    }
+}
+
+void
+GLCapture::Put(std::vector<uint8_t> &record, const Pointer &pointer)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    PutRaw(record, pointer.tag);
+
+    switch(pointer.tag) {
+    case GLOVE_CAPTURE_POINTER_NULL:
+        break;
+    case GLOVE_CAPTURE_POINTER_DATA: {
+        PutRaw(record, pointer.size);
+        const uint8_t *bytes = static_cast<const uint8_t *>(pointer.ptr);
+        record.insert(record.end(), bytes, bytes + pointer.size);
+        record.resize((record.size() + 7) & ~static_cast<size_t>(7), 0);
+        break;
+    }
+    case GLOVE_CAPTURE_POINTER_OFFSET:
+        PutRaw(record, reinterpret_cast<uintptr_t>(pointer.ptr));
+        break;
+    case GLOVE_CAPTURE_POINTER_OUTPUT:
+        PutRaw(record, pointer.size);
+        break;
+    }
+}
+
+GLCapture::Pointer
+GLCapture::Strings(GLsizei count, const GLchar *const *string, const GLint *length)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    static thread_local std::string source;
+
+    source.clear();
+    for(GLsizei i = 0; string && i < count; ++i) {
+        if(!string[i]) {
+            continue;
+        }
+        if(length && length[i] >= 0) {
+            source.append(string[i], length[i]);
+        } else {
+            source.append(string[i]);
+        }
+    }
+
+    return Data(source.c_str(), source.size() + 1);
+}
+
+GLCapture::Pointer
+GLCapture::Pixels(Context *context, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // the pixels are recorded from the first unpacked one, the unpack state is recorded along with its own calls
+    const StatePixelStorage *pixelStorage = context->GetStateManager()->GetPixelStorageState();
+    if(!pixels || width <= 0 || height <= 0) {
+        return Data(pixels, 0);
+    }
+
+    ImageRect rect(0, 0, width, height,
+                   GlInternalFormatTypeToNumElements(GlFormatToGlInternalFormat(format, type), type),
+                   GlTypeToElementSize(type), pixelStorage->GetPixelStoreUnpack());
+    rect.mRowLength = pixelStorage->GetUnpackRowLength();
+    const uint8_t *first = static_cast<const uint8_t *>(pixelStorage->GetUnpackPixels(pixels, width, rect.GetPixelByteOffset()));
+    return Data(pixels, static_cast<size_t>(first - static_cast<const uint8_t *>(pixels)) + rect.GetRectBufferSize());
+}
+
+GLCapture::Pointer
+GLCapture::ReadPixels(Context *context, GLsizei width, GLsizei height, GLenum format, GLenum type)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    GLint alignment = context->GetStateManager()->GetPixelStorageState()->GetPixelStorePack();
+    return Output(PixelsSize(width, height, format, type, alignment));
+}
+
+GLCapture::Pointer
+GLCapture::Indices(Context *context, GLsizei count, GLenum type, const void *indices)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(context->GetResourceManager()->GetActiveVertexArray()->GetElementArrayBuffer()) {
+        return Offset(indices);
+    }
+
+    return Data(indices, count > 0 ? count * IndexElementSize(type) : 0);
+}
+
+void
+GLCapture::VertexAttribPointer(Context *context, GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void *ptr)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(index >= GLOVE_MAX_VERTEX_ATTRIBS) {
+        return;
+    }
+
+    // client arrays are recorded without their memory, the draws reading them record it
+    bool client = !context->GetStateManager()->GetActiveObjectsState()->GetActiveBufferObject(GL_ARRAY_BUFFER);
+
+    CaptureAttrib &attrib = ActiveAttribs()[index];
+    attrib.size       = size;
+    attrib.type       = type;
+    attrib.normalized = normalized;
+    attrib.stride     = stride;
+    attrib.ptr        = ptr;
+    attrib.client     = client;
+
+    Call(GLOVE_CAPTURE_glVertexAttribPointer, index, size, type, normalized, stride, client ? Data(nullptr, 0) : Offset(ptr));
+}
+
+void
+GLCapture::EnableVertexAttribArray(GLuint index, bool enabled)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(index < GLOVE_MAX_VERTEX_ATTRIBS) {
+        ActiveAttribs()[index].enabled = enabled;
+    }
+
+    Call(enabled ? GLOVE_CAPTURE_glEnableVertexAttribArray : GLOVE_CAPTURE_glDisableVertexAttribArray, index);
+}
+
+void
+GLCapture::VertexAttribDivisor(GLuint index, GLuint divisor)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(index < GLOVE_MAX_VERTEX_ATTRIBS) {
+        ActiveAttribs()[index].divisor = divisor;
+    }
+
+    Call(GLOVE_CAPTURE_glVertexAttribDivisorEXT, index, divisor);
+}
+
+void
+GLCapture::BindVertexArray(GLuint array)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    captureActiveVertexArray = array;
+
+    Call(GLOVE_CAPTURE_glBindVertexArrayOES, array);
+}
+
+void
+GLCapture::DeleteVertexArrays(GLsizei n, const GLuint *arrays)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    for(GLsizei i = 0; arrays && i < n; ++i) {
+        if(arrays[i]) {
+            captureVertexArrays.erase(arrays[i]);
+            if(captureActiveVertexArray == arrays[i]) {
+                captureActiveVertexArray = 0;
+            }
+        }
+    }
+
+    Call(GLOVE_CAPTURE_glDeleteVertexArraysOES, n, Data(arrays, arrays && n > 0 ? n * sizeof(GLuint) : 0));
+}
+
+static void
+RecordClientArrays(Context *context, uint32_t vertexCount, GLsizei primcount)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    BufferObject *arrayBuffer = context->GetStateManager()->GetActiveObjectsState()->GetActiveBufferObject(GL_ARRAY_BUFFER);
+    if(arrayBuffer) {
+        GLCapture::Call(GLOVE_CAPTURE_glBindBuffer, GL_ARRAY_BUFFER, 0u);
+    }
+
+    const CaptureAttrib *attribs = ActiveAttribs();
+    for(GLuint index = 0; index < GLOVE_MAX_VERTEX_ATTRIBS; ++index) {
+        const CaptureAttrib &attrib = attribs[index];
+        if(!attrib.enabled || !attrib.client || !attrib.ptr) {
+            continue;
+        }
+
+        size_t elements    = attrib.divisor ? (std::max(primcount, 1) + attrib.divisor - 1) / attrib.divisor : vertexCount;
+        size_t elementSize = GlAttribTypeToVertexSize(attrib.size, attrib.type);
+        size_t stride      = attrib.stride ? attrib.stride : elementSize;
+        size_t size        = elements ? (elements - 1) * stride + elementSize : 0;
+
+        GLCapture::Call(GLOVE_CAPTURE_glVertexAttribPointer, index, attrib.size, attrib.type, attrib.normalized, attrib.stride,
+                        GLCapture::Data(attrib.ptr, size));
+    }
+
+    if(arrayBuffer) {
+        GLCapture::Call(GLOVE_CAPTURE_glBindBuffer, GL_ARRAY_BUFFER, context->GetResourceManager()->GetBufferID(arrayBuffer));
+    }
+}
+
+static bool
+HasClientArrays(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    const CaptureAttrib *attribs = ActiveAttribs();
+    for(GLuint index = 0; index < GLOVE_MAX_VERTEX_ATTRIBS; ++index) {
+        if(attribs[index].enabled && attribs[index].client && attribs[index].ptr) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+GLCapture::ClientArrays(Context *context, GLint first, GLsizei count, GLsizei primcount)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(count <= 0 || !HasClientArrays()) {
+        return;
+    }
+
+    RecordClientArrays(context, static_cast<uint32_t>(first + count), primcount);
+}
+
+void
+GLCapture::ClientArrays(Context *context, GLsizei count, GLenum type, const void *indices, GLsizei primcount)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(count <= 0 || !HasClientArrays()) {
+        return;
+    }
+
+    size_t elementSize = IndexElementSize(type);
+    uint32_t maxIndex  = 0;
+
+    BufferObject *ibo = context->GetResourceManager()->GetActiveVertexArray()->GetElementArrayBuffer();
+    if(ibo) {
+        std::vector<uint8_t> data(count * elementSize);
+        if(!ibo->GetData(data.size(), reinterpret_cast<uintptr_t>(indices), data.data())) {
+            return;
+        }
+        maxIndex = IndexBufferMax(data.data(), count, elementSize);
+    } else if(indices) {
+        maxIndex = IndexBufferMax(indices, count, elementSize);
+    }
+
+    RecordClientArrays(context, maxIndex + 1, primcount);
+}
+
+void
+GLCapture::FlushMappedRange(Context *context, GLenum target, GLintptr offset, GLsizeiptr length)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    BufferObject *bo = context->GetStateManager()->GetActiveObjectsState()->GetActiveBufferObject(target);
+    if(!bo || !bo->GetMappedPointer() || offset < 0 || length <= 0 ||
+       static_cast<size_t>(offset + length) > bo->GetMappedLength()) {
+        return;
+    }
+
+    Call(GLOVE_CAPTURE_glBufferSubData, target, static_cast<GLintptr>(bo->GetMappedOffset() + offset), length,
+         Data(static_cast<const uint8_t *>(bo->GetMappedPointer()) + offset, length));
+}
+
+void
+GLCapture::Unmap(Context *context, GLenum target)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    BufferObject *bo = context->GetStateManager()->GetActiveObjectsState()->GetActiveBufferObject(target);
+    if(!bo || !bo->GetMappedPointer() ||
+       !(bo->GetMappedAccess() & GL_MAP_WRITE_BIT_EXT) || (bo->GetMappedAccess() & GL_MAP_FLUSH_EXPLICIT_BIT_EXT)) {
+        return;
+    }
+
+    Call(GLOVE_CAPTURE_glBufferSubData, target, static_cast<GLintptr>(bo->GetMappedOffset()), static_cast<GLsizeiptr>(bo->GetMappedLength()),
+         Data(bo->GetMappedPointer(), bo->GetMappedLength()));
+}
+
+void
+GLCapture::Surface(uint32_t width, uint32_t height)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    Call(GLOVE_CAPTURE_SURFACE, width, height);
+}
+
+void
+GLCapture::Frame(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    Call(GLOVE_CAPTURE_FRAME);
+
+    std::lock_guard<std::mutex> lock(captureMutex);
+    if(captureFile) {
+        fflush(captureFile);
+    }
+}
+
+void
+GLCapture::Shutdown(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    std::lock_guard<std::mutex> lock(captureMutex);
+    if(captureFile) {
+        fclose(captureFile);
+        captureFile = nullptr;
+    }
+}
+
+#endif // CAPTURE_BUILD
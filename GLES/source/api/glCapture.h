@@ -0,0 +1,123 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       glCapture.h
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Capture of the GL command stream, for CAPTURE_BUILD builds
+ *
+ */
+
+#ifndef __GLCAPTURE_H__
+#define __GLCAPTURE_H__
+
+#include "glCaptureFormat.h"
+#include "GLES2/gl2.h"
+#include "GLES2/gl2ext.h"
+
+#include <string.h>
+#include <type_traits>
+#include <vector>
+
+/// file the capture is written to, glove_capture.bin when unset
+#define GLOVE_CAPTURE_FILE_ENV                          "GLOVE_CAPTURE_FILE"
+
+class Context;
+
+class GLCapture {
+public:
+    /// a pointer argument, see glCaptureFormat.h
+    typedef struct Pointer {
+        gloveCapturePointer_e     tag;
+        const void               *ptr;
+        uint64_t                  size;
+    } Pointer;
+
+    static inline Pointer         Data(const void *ptr, size_t size)           { Pointer p = { ptr ? GLOVE_CAPTURE_POINTER_DATA : GLOVE_CAPTURE_POINTER_NULL, ptr, size }; return p; }
+    static inline Pointer         Offset(const void *ptr)                      { Pointer p = { GLOVE_CAPTURE_POINTER_OFFSET, ptr, 0 }; return p; }
+    static inline Pointer         Output(size_t size)                          { Pointer p = { GLOVE_CAPTURE_POINTER_OUTPUT, nullptr, size }; return p; }
+    static inline Pointer         String(const GLchar *str)                    { return Data(str, str ? strlen(str) + 1 : 0); }
+    /// the sources of glShaderSource, joined into the single string the call is replayed with
+    static Pointer                Strings(GLsizei count, const GLchar *const *string, const GLint *length);
+    /// an event marker, null terminated unless its length is given
+    static inline Pointer         Marker(GLsizei length, const GLchar *marker) { return length ? Data(marker, length) : String(marker); }
+    /// the pixels read by glTex(Sub)Image2D with the unpack alignment of the context
+    static Pointer                Pixels(Context *context, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels);
+    /// the pixels written by glReadPixels with the pack alignment of the context
+    static Pointer                ReadPixels(Context *context, GLsizei width, GLsizei height, GLenum format, GLenum type);
+    /// the client indices of a draw, or their offset into the element array buffer
+    static Pointer                Indices(Context *context, GLsizei count, GLenum type, const void *indices);
+
+    /// the vertex attributes are shadowed, client arrays are only sized by the draws reading them
+    static void                   VertexAttribPointer(Context *context, GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void *ptr);
+    static void                   EnableVertexAttribArray(GLuint index, bool enabled);
+    static void                   VertexAttribDivisor(GLuint index, GLuint divisor);
+    static void                   BindVertexArray(GLuint array);
+    static void                   DeleteVertexArrays(GLsizei n, const GLuint *arrays);
+    /// the client arrays a draw reads, recorded before the draw
+    static void                   ClientArrays(Context *context, GLint first, GLsizei count, GLsizei primcount);
+    static void                   ClientArrays(Context *context, GLsizei count, GLenum type, const void *indices, GLsizei primcount);
+    /// the contents of a mapped range, recorded as glBufferSubData before they are flushed or unmapped
+    static void                   FlushMappedRange(Context *context, GLenum target, GLintptr offset, GLsizeiptr length);
+    static void                   Unmap(Context *context, GLenum target);
+
+    static void                   Surface(uint32_t width, uint32_t height);
+    static void                   Frame(void);
+    static void                   Shutdown(void);
+
+    template<typename... A>
+    static void                   Call(uint32_t id, const A&... args)
+    {
+        std::vector<uint8_t> &record = Begin(id);
+        int expand[] = { 0, (Put(record, args), 0)... };
+        (void)expand;
+        End(record);
+    }
+
+private:
+    static std::vector<uint8_t>  &Begin(uint32_t id);
+    static void                   End(std::vector<uint8_t> &record);
+
+    static inline void            PutRaw(std::vector<uint8_t> &record, uint64_t value)
+    {
+        const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&value);
+        record.insert(record.end(), bytes, bytes + sizeof(value));
+    }
+
+    template<typename T>
+    static inline typename std::enable_if<std::is_floating_point<T>::value>::type
+                                  Put(std::vector<uint8_t> &record, T value)
+    {
+        GLfloat f = static_cast<GLfloat>(value);
+        uint32_t bits;
+        memcpy(&bits, &f, sizeof(bits));
+        PutRaw(record, bits);
+    }
+
+    template<typename T>
+    static inline typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type
+                                  Put(std::vector<uint8_t> &record, T value)
+    {
+        PutRaw(record, std::is_signed<T>::value ? static_cast<uint64_t>(static_cast<int64_t>(value)) : static_cast<uint64_t>(value));
+    }
+
+    static void                   Put(std::vector<uint8_t> &record, const Pointer &pointer);
+    /// raw pointers are wrapped, so that the memory they point to is sized
+    template<typename T>
+    static void                   Put(std::vector<uint8_t> &record, const T *pointer) = delete;
+};
+
+#endif // __GLCAPTURE_H__
@@ -0,0 +1,105 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       glCaptureFormat.h
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Layout of the GL command-stream captures, shared by the capture layer and the replay tool
+ *
+ *  @section
+ *
+ *  A capture is a header followed by records. Each record is its id and the
+ *  size of its payload, which holds the arguments of the call in order:
+ *  every scalar takes 8 bytes, integers sign or zero extended and floats as
+ *  their 32 bits, and every pointer is a tag of 8 bytes followed by
+ *   - nothing, for GLOVE_CAPTURE_POINTER_NULL
+ *   - the size and the bytes of the client memory, padded to 8 bytes, for GLOVE_CAPTURE_POINTER_DATA
+ *   - the offset into the bound buffer, for GLOVE_CAPTURE_POINTER_OFFSET
+ *   - the size of the memory the call writes, for GLOVE_CAPTURE_POINTER_OUTPUT
+ *  Calls returning a value the replay has to map, such as uniform
+ *  locations, append it after their arguments.
+ *
+ */
+
+#ifndef __GLCAPTUREFORMAT_H__
+#define __GLCAPTUREFORMAT_H__
+
+#include <stdint.h>
+
+#define GLOVE_CAPTURE_MAGIC                             0x50414347u  // "GCAP"
+#define GLOVE_CAPTURE_VERSION                           1
+
+/// the captured calls in the order of their ids, new calls are appended so that older captures keep their meaning
+#define GLOVE_CAPTURE_CALLS(X)                                                                                        \
+    X(glActiveTexture) X(glAttachShader) X(glBindAttribLocation) X(glBindBuffer) X(glBindFramebuffer)                 \
+    X(glBindRenderbuffer) X(glBindTexture) X(glBlendColor) X(glBlendEquation) X(glBlendEquationSeparate)              \
+    X(glBlendFunc) X(glBlendFuncSeparate) X(glBufferData) X(glBufferSubData) X(glClear) X(glClearColor)               \
+    X(glClearDepthf) X(glClearStencil) X(glColorMask) X(glCompileShader) X(glCompressedTexImage2D)                    \
+    X(glCompressedTexSubImage2D) X(glCopyTexImage2D) X(glCopyTexSubImage2D) X(glCreateProgram) X(glCreateShader)      \
+    X(glCullFace) X(glDeleteBuffers) X(glDeleteFramebuffers) X(glDeleteProgram) X(glDeleteRenderbuffers)              \
+    X(glDeleteShader) X(glDeleteTextures) X(glDepthFunc) X(glDepthMask) X(glDepthRangef) X(glDetachShader)            \
+    X(glDisable) X(glDisableVertexAttribArray) X(glDrawArrays) X(glDrawElements) X(glEnable)                          \
+    X(glEnableVertexAttribArray) X(glFinish) X(glFlush) X(glFramebufferRenderbuffer) X(glFramebufferTexture2D)        \
+    X(glFrontFace) X(glGenBuffers) X(glGenerateMipmap) X(glGenFramebuffers) X(glGenRenderbuffers) X(glGenTextures)    \
+    X(glGetAttribLocation) X(glGetProgramiv) X(glGetShaderiv) X(glGetUniformLocation) X(glHint) X(glLineWidth)        \
+    X(glLinkProgram) X(glPixelStorei) X(glPolygonOffset) X(glReadPixels) X(glReleaseShaderCompiler)                   \
+    X(glRenderbufferStorage) X(glSampleCoverage) X(glScissor) X(glShaderBinary) X(glShaderSource) X(glStencilFunc)    \
+    X(glStencilFuncSeparate) X(glStencilMask) X(glStencilMaskSeparate) X(glStencilOp) X(glStencilOpSeparate)          \
+    X(glTexImage2D) X(glTexParameterf) X(glTexParameterfv) X(glTexParameteri) X(glTexParameteriv) X(glTexSubImage2D)  \
+    X(glUniform1f) X(glUniform1fv) X(glUniform1i) X(glUniform1iv) X(glUniform2f) X(glUniform2fv) X(glUniform2i)       \
+    X(glUniform2iv) X(glUniform3f) X(glUniform3fv) X(glUniform3i) X(glUniform3iv) X(glUniform4f) X(glUniform4fv)      \
+    X(glUniform4i) X(glUniform4iv) X(glUniformMatrix2fv) X(glUniformMatrix3fv) X(glUniformMatrix4fv) X(glUseProgram)  \
+    X(glValidateProgram) X(glVertexAttrib1f) X(glVertexAttrib1fv) X(glVertexAttrib2f) X(glVertexAttrib2fv)            \
+    X(glVertexAttrib3f) X(glVertexAttrib3fv) X(glVertexAttrib4f) X(glVertexAttrib4fv) X(glVertexAttribPointer)        \
+    X(glViewport) X(glInsertEventMarkerEXT) X(glPushGroupMarkerEXT) X(glPopGroupMarkerEXT) X(glProgramBinaryOES)      \
+    X(glBindVertexArrayOES) X(glDeleteVertexArraysOES) X(glGenVertexArraysOES) X(glDrawArraysInstancedEXT)            \
+    X(glDrawElementsInstancedEXT) X(glVertexAttribDivisorEXT) X(glTexStorage2DEXT) X(glDiscardFramebufferEXT)         \
+    X(glRenderbufferStorageMultisampleEXT) X(glFramebufferTexture2DMultisampleEXT) X(glMaxShaderCompilerThreadsKHR)   \
+    X(glGenQueriesEXT) X(glDeleteQueriesEXT) X(glBeginQueryEXT) X(glEndQueryEXT) X(glQueryCounterEXT)                 \
+    X(glBlitFramebufferNV) X(glGenCommandBundlesGLOVE) X(glDeleteCommandBundlesGLOVE) X(glBeginCommandBundleGLOVE)    \
+    X(glEndCommandBundleGLOVE) X(glCallCommandBundleGLOVE) X(glTexImage3DOES) X(glTexSubImage3DOES)                   \
+    X(glCopyTexSubImage3DOES) X(glCompressedTexImage3DOES) X(glCompressedTexSubImage3DOES)                            \
+    X(glFramebufferTexture3DOES)
+
+typedef enum {
+    /// width and height of the draw surface made current
+    GLOVE_CAPTURE_SURFACE = 0,
+    /// the end of a frame, eglSwapBuffers
+    GLOVE_CAPTURE_FRAME,
+#define GLOVE_CAPTURE_ID(__call__) GLOVE_CAPTURE_##__call__,
+    GLOVE_CAPTURE_CALLS(GLOVE_CAPTURE_ID)
+#undef GLOVE_CAPTURE_ID
+    GLOVE_CAPTURE_ID_COUNT
+} gloveCaptureId_e;
+
+typedef enum {
+    GLOVE_CAPTURE_POINTER_NULL = 0,
+    GLOVE_CAPTURE_POINTER_DATA,
+    GLOVE_CAPTURE_POINTER_OFFSET,
+    GLOVE_CAPTURE_POINTER_OUTPUT
+} gloveCapturePointer_e;
+
+typedef struct gloveCaptureHeader_t {
+    uint32_t                      magic;
+    uint32_t                      version;
+} gloveCaptureHeader_t;
+
+typedef struct gloveCaptureRecord_t {
+    uint32_t                      id;
+    uint32_t                      size;
+} gloveCaptureRecord_t;
+
+#endif // __GLCAPTUREFORMAT_H__
@@ -27,9 +27,18 @@
 
 #include "GLES2/gl2.h"
 #include "GLES2/gl2ext.h"
-#include <string>
-#include <unordered_map>
-static const std::unordered_map<std::string, GLPROC> glFPMap = {
+#include "GLES2/gl2ext_glove.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+typedef struct glFunction_t {
+    const char *name;
+    GLPROC proc;
+} glFunction_t;
+
+static const glFunction_t glFunctions[] = {
 GL_FUNC_PTR(glActiveTexture),
 GL_FUNC_PTR(glAttachShader),
 GL_FUNC_PTR(glBindAttribLocation),
@@ -185,15 +194,106 @@ GL_FUNC_PTR(glPopGroupMarkerEXT)
 ,GL_FUNC_PTR(glGetProgramBinaryOES),
 GL_FUNC_PTR(glProgramBinaryOES)
 #endif /* GL_OES_get_program_binary */
+#ifdef GL_OES_vertex_array_object
+,GL_FUNC_PTR(glBindVertexArrayOES),
+GL_FUNC_PTR(glDeleteVertexArraysOES),
+GL_FUNC_PTR(glGenVertexArraysOES),
+GL_FUNC_PTR(glIsVertexArrayOES)
+#endif /* GL_OES_vertex_array_object */
+#ifdef GL_ANGLE_instanced_arrays
+,GL_FUNC_PTR(glDrawArraysInstancedANGLE),
+GL_FUNC_PTR(glDrawElementsInstancedANGLE),
+GL_FUNC_PTR(glVertexAttribDivisorANGLE)
+#endif /* GL_ANGLE_instanced_arrays */
+#ifdef GL_EXT_instanced_arrays
+,GL_FUNC_PTR(glDrawArraysInstancedEXT),
+GL_FUNC_PTR(glDrawElementsInstancedEXT),
+GL_FUNC_PTR(glVertexAttribDivisorEXT)
+#endif /* GL_EXT_instanced_arrays */
+#ifdef GL_OES_mapbuffer
+,GL_FUNC_PTR(glMapBufferOES),
+GL_FUNC_PTR(glUnmapBufferOES),
+GL_FUNC_PTR(glGetBufferPointervOES)
+#endif /* GL_OES_mapbuffer */
+#ifdef GL_EXT_map_buffer_range
+,GL_FUNC_PTR(glMapBufferRangeEXT),
+GL_FUNC_PTR(glFlushMappedBufferRangeEXT)
+#endif /* GL_EXT_map_buffer_range */
+#ifdef GL_EXT_texture_storage
+,GL_FUNC_PTR(glTexStorage2DEXT)
+#endif /* GL_EXT_texture_storage */
+#ifdef GL_OES_texture_3D
+,GL_FUNC_PTR(glTexImage3DOES),
+GL_FUNC_PTR(glTexSubImage3DOES),
+GL_FUNC_PTR(glCopyTexSubImage3DOES),
+GL_FUNC_PTR(glCompressedTexImage3DOES),
+GL_FUNC_PTR(glCompressedTexSubImage3DOES),
+GL_FUNC_PTR(glFramebufferTexture3DOES)
+#endif /* GL_OES_texture_3D */
+#ifdef GL_EXT_discard_framebuffer
+,GL_FUNC_PTR(glDiscardFramebufferEXT)
+#endif /* GL_EXT_discard_framebuffer */
+#ifdef GL_EXT_multisampled_render_to_texture
+,GL_FUNC_PTR(glRenderbufferStorageMultisampleEXT),
+GL_FUNC_PTR(glFramebufferTexture2DMultisampleEXT)
+#endif /* GL_EXT_multisampled_render_to_texture */
+#ifdef GL_KHR_parallel_shader_compile
+,GL_FUNC_PTR(glMaxShaderCompilerThreadsKHR)
+#endif /* GL_KHR_parallel_shader_compile */
+#ifdef GL_EXT_disjoint_timer_query
+,GL_FUNC_PTR(glGenQueriesEXT),
+GL_FUNC_PTR(glDeleteQueriesEXT),
+GL_FUNC_PTR(glIsQueryEXT),
+GL_FUNC_PTR(glBeginQueryEXT),
+GL_FUNC_PTR(glEndQueryEXT),
+GL_FUNC_PTR(glQueryCounterEXT),
+GL_FUNC_PTR(glGetQueryivEXT),
+GL_FUNC_PTR(glGetQueryObjectivEXT),
+GL_FUNC_PTR(glGetQueryObjectuivEXT),
+GL_FUNC_PTR(glGetQueryObjecti64vEXT),
+GL_FUNC_PTR(glGetQueryObjectui64vEXT)
+#endif /* GL_EXT_disjoint_timer_query */
+#ifdef GL_EXT_multi_draw_arrays
+,GL_FUNC_PTR(glMultiDrawArraysEXT),
+GL_FUNC_PTR(glMultiDrawElementsEXT)
+#endif /* GL_EXT_multi_draw_arrays */
+#ifdef GL_GLOVE_memory_report
+,GL_FUNC_PTR(glGetMemoryReportGLOVE)
+#endif /* GL_GLOVE_memory_report */
+#ifdef GL_GLOVE_draw_range_elements
+,GL_FUNC_PTR(glDrawRangeElements)
+#endif /* GL_GLOVE_draw_range_elements */
+#ifdef GL_ANGLE_framebuffer_blit
+,GL_FUNC_PTR(glBlitFramebufferANGLE)
+#endif /* GL_ANGLE_framebuffer_blit */
+#ifdef GL_NV_framebuffer_blit
+,GL_FUNC_PTR(glBlitFramebufferNV)
+#endif /* GL_NV_framebuffer_blit */
+#ifdef GL_GLOVE_command_bundle
+,GL_FUNC_PTR(glGenCommandBundlesGLOVE),
+GL_FUNC_PTR(glDeleteCommandBundlesGLOVE),
+GL_FUNC_PTR(glBeginCommandBundleGLOVE),
+GL_FUNC_PTR(glEndCommandBundleGLOVE),
+GL_FUNC_PTR(glCallCommandBundleGLOVE)
+#endif /* GL_GLOVE_command_bundle */
 };
 #undef GL_FUNC_PTR
 
 GLPROC GetGLProcAddr(const char *procname)
 {
+    // the entries are sorted by name once, and looked up without allocating from then on
+    static const std::vector<glFunction_t> sortedFunctions = [] {
+        std::vector<glFunction_t> functions(std::begin(glFunctions), std::end(glFunctions));
+        std::sort(functions.begin(), functions.end(),
+                  [](const glFunction_t &a, const glFunction_t &b) { return strcmp(a.name, b.name) < 0; });
+        return functions;
+    }();
+
     if(strncmp(procname, "gl", 2) == 0) {
-        const auto& it = glFPMap.find(procname);
-        if(it != glFPMap.end()) {
-            return it->second;
+        const auto it = std::lower_bound(sortedFunctions.begin(), sortedFunctions.end(), procname,
+                                         [](const glFunction_t &entry, const char *name) { return strcmp(entry.name, name) < 0; });
+        if(it != sortedFunctions.end() && strcmp(it->name, procname) == 0) {
+            return it->proc;
         }
     }
     return nullptr;
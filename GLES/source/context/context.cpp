@@ -24,14 +24,7 @@
 #include "context.h"
 #include "utils/VkToGlConverter.h"
 
-static Context *currentContext = nullptr;
-
-Context *GetCurrentContext()
-{
-    FUN_ENTRY(GL_LOG_TRACE);
-
-    return currentContext;
-}
+thread_local Context *currentContext = nullptr;
 
 void SetCurrentContext(Context *ctx)
 {
@@ -40,21 +33,47 @@ void SetCurrentContext(Context *ctx)
     currentContext = ctx;
 }
 
-Context::Context()
+Context::Context(Context *shareContext, bool noError, vulkanAPI::queuePriority_t priority)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
+    GLOVE_PROFILE_INIT();
+
     mVkContext            = vulkanAPI::GetContext();
-    mCommandBufferManager = new vulkanAPI::CommandBufferManager(mVkContext);
+    mCommandBufferManager = new vulkanAPI::CommandBufferManager(mVkContext, vulkanAPI::GetVkQueue(priority, &mPriority));
+    mUploadWorker         = new UploadWorker();
+    mCommandBufferManager->SetUploadWorker(mUploadWorker);
+    mMaxShaderCompilerThreads = GLOVE_MAX_SHADER_COMPILER_THREADS;
 
-    mResourceManager = new ResourceManager(mVkContext);
-    mShaderCompiler  = new GlslangShaderCompiler();
+    mResourceManager = new ResourceManager(mVkContext, shareContext ? shareContext->mShareGroup : nullptr);
+    mShareGroup      = mResourceManager->GetShareGroup();
     mPipeline        = new vulkanAPI::Pipeline(mVkContext);
     mCacheManager    = new CacheManager(mVkContext);
 
+    // uniform blocks are sub-allocated per frame in flight and bound with dynamic offsets
+    mUniformRing     = new vulkanAPI::RingBuffer(mVkContext, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+    if(!mUniformRing->Create(GLOVE_MAX_FRAMES_IN_FLIGHT, GLOVE_UNIFORM_RING_FRAME_SIZE,
+                             std::max(mVkContext->vkDeviceLimits.minUniformBufferOffsetAlignment, static_cast<VkDeviceSize>(16)))) {
+        delete mUniformRing;
+        mUniformRing = nullptr;
+    }
+
+    // client-side vertex arrays and indices are streamed per frame in flight and bound at their offsets,
+    // the memory is only allocated once something is streamed, as most applications use buffer objects
+    mStreamRing      = new vulkanAPI::RingBuffer(mVkContext, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+    if(!mStreamRing->Create(GLOVE_MAX_FRAMES_IN_FLIGHT, GLOVE_STREAM_RING_FRAME_SIZE, 16, true)) {
+        delete mStreamRing;
+        mStreamRing = nullptr;
+    }
+
+    // descriptor sets are allocated per frame in flight and released with their frame
+    mDescriptorAllocator = new vulkanAPI::DescriptorAllocator(mVkContext);
+    mDescriptorAllocator->Create(GLOVE_MAX_FRAMES_IN_FLIGHT);
+
     mStateManager.InitVkPipelineStates(mPipeline);
 
     InitializeDefaultTextures();
+    mCompressedTextureFormatsProbed = false;
 
     mPipeline->SetCacheManager(mCacheManager);
     mResourceManager->SetCacheManager(mCacheManager);
@@ -62,30 +81,86 @@ Context::Context()
     mWriteSurface = nullptr;
     mReadSurface  = nullptr;
     mWriteFBO     = nullptr;
+    mReadFBO      = nullptr;
+    mReadFBOId    = 0;
     mSystemFBO    = nullptr;
 
+    // a single image never acquired nor presented, without ancillary buffers
+    memset(static_cast<void *>(&mSurfacelessSurface), 0, sizeof(mSurfacelessSurface));
+    mSurfacelessSurface.imageCount         = 1;
+    mSurfacelessSurface.surfaceColorFormat = VK_FORMAT_R8G8B8A8_UNORM;
+    mSurfacelessSurface.type               = EGL_PBUFFER_BIT;
+    mSurfacelessSurface.width              = 1;
+    mSurfacelessSurface.height             = 1;
+
     //If VK_KHR_maintenance1 is supported, then there is no need to invert the Y
     mIsYInverted        = !(vulkanAPI::GetContext()->mIsMaintenanceExtSupported);
     mIsModeLineLoop     = false;
+    mNoError            = noError;
+    mPromotionSubmissionId = 0;
+    mChainedRenderPasses   = 0;
+    mScissorDamaged        = false;
+    UpdateScissorStateId();
+    mActiveQuery           = nullptr;
+    mActiveOcclusionQuery  = nullptr;
+    mMarkerGroupDepth      = 0;
+    mCapturedBundle        = nullptr;
+
+    const char *statisticsInterval = getenv(GLOVE_FRAME_STATISTICS_ENV);
+    mStatisticsInterval = statisticsInterval ? static_cast<uint32_t>(strtoul(statisticsInterval, nullptr, 10)) : 0;
+    mStatisticsFrames   = 0;
+
+    const char *memoryReportInterval = getenv(GLOVE_MEMORY_REPORT_ENV);
+    mMemoryReport         = memoryReportInterval != nullptr;
+    mMemoryReportInterval = memoryReportInterval ? static_cast<uint32_t>(strtoul(memoryReportInterval, nullptr, 10)) : 0;
+    mMemoryReportFrames   = 0;
+
+    mReadbackTexture = nullptr;
+    mUploadTexture   = nullptr;
+    mPbufferTexture  = nullptr;
 
     mScreenSpacePass = new ScreenSpacePass(mVkContext);
     mScreenSpacePass->SetCacheManager(mCacheManager);
     mStateManager.InitVkPipelineStates(mScreenSpacePass->GetPipeline());
+
+    // the capture records the calls along with what they read from the context, so it runs them in place
+#ifndef CAPTURE_BUILD
+    const char *glThread = getenv(GLOVE_GLTHREAD_ENV);
+    mGLThread = glThread && strtoul(glThread, nullptr, 10) ? new GLThread(this) : nullptr;
+#else
+    mGLThread = nullptr;
+#endif // CAPTURE_BUILD
 }
 
 Context::~Context()
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
+    // the recorded calls are run before anything is released
+    delete mGLThread;
+    mGLThread = nullptr;
+
+    // pending jobs write to the shaders and programs released below, when the context is the last of its group
+    WaitCompileJobs();
+
+    if(mMemoryReport) {
+        WriteMemoryReport();
+    }
+
     ReleaseSystemFBO();
 
-    if(mShaderCompiler != nullptr) {
-        delete mShaderCompiler;
-        mShaderCompiler = nullptr;
+    delete mReadbackTexture;
+    delete mUploadTexture;
+
+    for(auto &iter : mLineLoopIndexBuffers) {
+        delete iter.second;
     }
 
     delete mResourceManager;
     delete mCacheManager;
+    delete mUniformRing;
+    delete mStreamRing;
+    delete mDescriptorAllocator;
 
     if(mPipeline != nullptr) {
         delete mPipeline;
@@ -98,6 +173,7 @@ Context::~Context()
     }
 
     delete mCommandBufferManager;
+    delete mUploadWorker;
 }
 
 void
@@ -105,6 +181,16 @@ Context::ReleaseSystemFBO(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    // frames still in flight and batched uploads may be referring to the system textures
+    if(mCommandBufferManager) {
+        mCommandBufferManager->SubmitVkAuxCommandBuffer();
+        mCommandBufferManager->WaitVkAuxCommandBuffer();
+        mCommandBufferManager->WaitLastSubmition();
+    }
+
+    // a texture bound to the pbuffer must not outlive its image
+    ReleasePbufferTexture();
+
     for(uint32_t i = 0; i < mSystemTextures.size(); ++i) {
         if(mSystemTextures[i] != nullptr) {
             delete mSystemTextures[i];
@@ -127,6 +213,35 @@ Context::ReleaseSystemFBO(void)
     mReadSurface = nullptr;
     mWriteSurface = nullptr;
     mWriteFBO = nullptr;
+    mReadFBO = nullptr;
+}
+
+void
+Context::RetireSystemFBO(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the surface images are about to be replaced, e.g., on a swapchain recreation. The frames
+    // in flight may still refer to the system textures and FBOs, so they are handed to the slot
+    // being recorded and released once its submission has completed, without waiting for the device
+    Flush();
+
+    for(auto tex : mSystemTextures) {
+        if(tex != nullptr) {
+            mCacheManager->CacheTexture(tex);
+        }
+    }
+    mSystemTextures.clear();
+
+    for(auto iter : mSystemFBOMap) {
+        mCacheManager->CacheFramebuffer(iter.second);
+    }
+    mSystemFBOMap.clear();
+
+    mReadSurface = nullptr;
+    mWriteSurface = nullptr;
+    mWriteFBO = nullptr;
+    mReadFBO = nullptr;
 }
 
 void
@@ -137,6 +252,7 @@ Context::InitializeDefaultTextures()
     for(int i = 0; i < GLOVE_MAX_COMBINED_TEXTURE_IMAGE_UNITS; ++i) {
         mStateManager.GetActiveObjectsState()->SetActiveTexture(GL_TEXTURE_2D      , i, mResourceManager->GetDefaultTexture(GL_TEXTURE_2D));
         mStateManager.GetActiveObjectsState()->SetActiveTexture(GL_TEXTURE_CUBE_MAP, i, mResourceManager->GetDefaultTexture(GL_TEXTURE_CUBE_MAP));
+        mStateManager.GetActiveObjectsState()->SetActiveTexture(GL_TEXTURE_3D_OES  , i, mResourceManager->GetDefaultTexture(GL_TEXTURE_3D_OES));
     }
 }
 
@@ -145,6 +261,10 @@ Context::CreateFBOFromEGLSurface(EGLSurfaceInterface *eglSurfaceInterface)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    if(eglSurfaceInterface == &mSurfacelessSurface) {
+        return CreateSurfacelessFBO();
+    }
+
     // TODO: Pbuffer/pixmaps are not properly supported
     assert(eglSurfaceInterface->type == EGL_WINDOW_BIT);
 
@@ -164,6 +284,10 @@ Context::InitializeFrameBuffer(EGLSurfaceInterface *eglSurfaceInterface)
     VkImage *vkImages = static_cast<VkImage *>(eglSurfaceInterface->images);
     Framebuffer *fbo = new Framebuffer(mVkContext);
 
+    // the images of a surface pre-rotated by a quarter turn have the width and height of the surface swapped
+    const VkSurfaceTransformFlagBitsKHR preTransform = GetSurfacePreTransform(eglSurfaceInterface);
+    const bool sideways = VkSurfaceTransformIsSideways(preTransform);
+
     // color images
     for(uint32_t i = 0; i < eglSurfaceInterface->imageCount; ++i) {
         Texture *tex = new Texture(mVkContext);
@@ -173,8 +297,8 @@ Context::InitializeFrameBuffer(EGLSurfaceInterface *eglSurfaceInterface)
         GLenum glType = GlInternalFormatToGlType(glformat);
 
         tex->SetTarget(GL_TEXTURE_2D);
-        tex->SetWidth(eglSurfaceInterface->width);
-        tex->SetHeight(eglSurfaceInterface->height);
+        tex->SetWidth (sideways ? eglSurfaceInterface->height : eglSurfaceInterface->width);
+        tex->SetHeight(sideways ? eglSurfaceInterface->width  : eglSurfaceInterface->height);
         tex->SetInternalFormat(glformat);
         tex->SetExplicitInternalFormat(glformat);
         tex->SetFormat(GlInternalFormatToGlFormat(glformat));
@@ -182,7 +306,9 @@ Context::InitializeFrameBuffer(EGLSurfaceInterface *eglSurfaceInterface)
         tex->SetExplicitType(glType);
 
         tex->SetVkFormat(surfaceColorFormat);
-        tex->SetVkImageUsage(static_cast<VkImageUsageFlagBits>(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT));
+        // the usage the swapchain images are created with, which imageless framebuffers have to match
+        tex->SetVkImageUsage(static_cast<VkImageUsageFlagBits>(eglSurfaceInterface->imageUsage ? eglSurfaceInterface->imageUsage :
+                                                               VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT));
         tex->SetVkImageTiling();
         tex->SetVkImageTarget(vulkanAPI::Image::VK_IMAGE_TARGET_2D);
         tex->SetVkImage(vkImages[i]);
@@ -198,11 +324,61 @@ Context::InitializeFrameBuffer(EGLSurfaceInterface *eglSurfaceInterface)
     fbo->SetDepthStencilAttachmentTexture(tex);
     fbo->SetTarget(GL_FRAMEBUFFER);
     fbo->SetIsSystem();
+    // multisampled surfaces are rendered to a transient color image, resolved into the swapchain one
+    VkSampleCountFlagBits samples = FindSupportedSampleCount(&mVkContext->vkDeviceLimits, eglSurfaceInterface->samples);
+    fbo->SetSamples(samples != VK_SAMPLE_COUNT_1_BIT ? static_cast<GLsizei>(samples) : 0);
     fbo->SetEGLSurfaceInterface(eglSurfaceInterface);
+    fbo->SetPreTransform(preTransform);
 
     return fbo;
 }
 
+VkSurfaceTransformFlagBitsKHR
+Context::GetSurfacePreTransform(const EGLSurfaceInterface *eglSurfaceInterface)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // only the rotations are followed, the images of the other transforms are rendered as they are
+    switch(eglSurfaceInterface->preTransform) {
+    case VK_SURFACE_TRANSFORM_ROTATE_90_BIT_KHR:
+    case VK_SURFACE_TRANSFORM_ROTATE_180_BIT_KHR:
+    case VK_SURFACE_TRANSFORM_ROTATE_270_BIT_KHR:
+        return static_cast<VkSurfaceTransformFlagBitsKHR>(eglSurfaceInterface->preTransform);
+    default:
+        return VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+    }
+}
+
+Framebuffer *
+Context::CreateSurfacelessFBO(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // a surfaceless context renders to the application's FBOs, the 1x1 target
+    // only keeps a system FBO bound for the state tracking
+    Texture *tex = new Texture(mVkContext);
+    tex->SetTarget(GL_TEXTURE_2D);
+    tex->SetVkFormat(static_cast<VkFormat>(mSurfacelessSurface.surfaceColorFormat));
+    tex->SetVkImageUsage(static_cast<VkImageUsageFlagBits>(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT));
+    tex->SetVkImageTarget(vulkanAPI::Image::VK_IMAGE_TARGET_2D);
+    tex->SetVkImageTiling();
+    tex->InitState();
+    tex->SetState(mSurfacelessSurface.width, mSurfacelessSurface.height, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                  Texture::GetDefaultInternalAlignment(), nullptr);
+    tex->Allocate();
+    mSystemTextures.push_back(tex);
+
+    Framebuffer *fbo = new Framebuffer(mVkContext);
+    fbo->AddColorAttachment(tex);
+    fbo->SetTarget(GL_FRAMEBUFFER);
+    fbo->SetIsSystem();
+    fbo->SetEGLSurfaceInterface(&mSurfacelessSurface);
+    fbo->CreateVkRenderPass(false, false, false, true, false, false);
+    fbo->Create();
+    fbo->SetSurfaceType(GLOVE_SURFACE_PBUFFER);
+
+    return fbo;
+}
 
 Texture *
 Context::CreateDepthStencil(EGLSurfaceInterface *eglSurfaceInterface)
@@ -218,15 +394,24 @@ Context::CreateDepthStencil(EGLSurfaceInterface *eglSurfaceInterface)
     Texture *tex = new Texture(mVkContext);
     tex->SetTarget(GL_TEXTURE_2D);
     tex->SetVkFormat(depthStencilFormat);
-    tex->SetVkImageUsage(static_cast<VkImageUsageFlagBits>(VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT));
+    tex->SetVkSampleCount(FindSupportedSampleCount(&mVkContext->vkDeviceLimits, eglSurfaceInterface->samples));
+    if(GLOVE_TRANSIENT_SYSTEM_DEPTH_STENCIL) {
+        // lazily allocated memory is never host visible, devices without it fall back to device local memory
+        tex->SetVkImageUsage(static_cast<VkImageUsageFlagBits>(VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT));
+        tex->SetVkMemoryFlags(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT);
+    } else {
+        tex->SetVkImageUsage(static_cast<VkImageUsageFlagBits>(VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT));
+    }
     tex->SetVkImageLayout(VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
     tex->SetVkImageTiling();
     tex->SetVkImageTarget(vulkanAPI::Image::VK_IMAGE_TARGET_2D);
 
     if(!eglSurfaceInterface->depthBuffer) {
         GLenum glformat = VkFormatToGlInternalformat(depthStencilFormat);
+        const bool sideways = VkSurfaceTransformIsSideways(GetSurfacePreTransform(eglSurfaceInterface));
         tex->InitState();
-        tex->SetState(eglSurfaceInterface->width, eglSurfaceInterface->height,
+        tex->SetState(sideways ? eglSurfaceInterface->height : eglSurfaceInterface->width,
+                      sideways ? eglSurfaceInterface->width  : eglSurfaceInterface->height,
                   0, 0,
                   GlInternalFormatToGlFormat(glformat),
                   GlInternalFormatToGlType(glformat),
@@ -270,6 +455,13 @@ Context::SetReadWriteSurfaces(EGLSurfaceInterface *eglReadSurfaceInterface, EGLS
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
+    // EGL_KHR_surfaceless_context, the submissions of the context then leave the swapchain semaphores alone
+    if(eglWriteSurfaceInterface == nullptr) {
+        eglReadSurfaceInterface  = &mSurfacelessSurface;
+        eglWriteSurfaceInterface = &mSurfacelessSurface;
+    }
+    mCommandBufferManager->SetPresentable(eglWriteSurfaceInterface != &mSurfacelessSurface);
+
     // TODO:: TBD as we do not take into account read surface!
     if(mWriteSurface && mWriteSurface == eglWriteSurfaceInterface->surface) {
         return;
@@ -284,8 +476,9 @@ Context::SetReadWriteSurfaces(EGLSurfaceInterface *eglReadSurfaceInterface, EGLS
 
         // if surface has been invalidated, recreate the FBO (e.g., resized on another context)
         bool surfaceUpdated =
-                (eglWriteSurfaceInterface->width != static_cast<uint32_t>(mWriteFBO->GetWidth())) ||
-                (eglWriteSurfaceInterface->height != static_cast<uint32_t>(mWriteFBO->GetHeight()));
+                (eglWriteSurfaceInterface->width != static_cast<uint32_t>(mWriteFBO->GetWindowWidth())) ||
+                (eglWriteSurfaceInterface->height != static_cast<uint32_t>(mWriteFBO->GetWindowHeight())) ||
+                (GetSurfacePreTransform(eglWriteSurfaceInterface) != mWriteFBO->GetPreTransform());
         if(!surfaceUpdated) {
             mWriteFBO = fboIter->second;
         } else {
@@ -310,9 +503,14 @@ Context::SetSystemFramebuffer(Framebuffer *FBO)
     FUN_ENTRY(GL_LOG_TRACE);
 
     mSystemFBO = FBO;
+    // a read binding of the default framebuffer moves along to the FBO of the new surfaces
+    if(mReadFBO && !mReadFBOId) {
+        mReadFBO = FBO;
+    }
 
-    mStateManager.GetViewportTransformationState()->SetViewportRect(mSystemFBO->GetRect());
-    mStateManager.GetFragmentOperationsState()->SetScissorRect(mSystemFBO->GetRect());
+    Rect windowRect(0, 0, mSystemFBO->GetWindowWidth(), mSystemFBO->GetWindowHeight());
+    mStateManager.GetViewportTransformationState()->SetViewportRect(&windowRect);
+    mStateManager.GetFragmentOperationsState()->SetScissorRect(&windowRect);
     mPipeline->SetUpdatePipeline(true);
     mPipeline->SetUpdateViewportState(true);
 }
@@ -322,7 +520,31 @@ Context::EGLImageTargetTexture2DOES(GLenum target, GLeglImageOES image)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    NOT_IMPLEMENTED();
+    if(target != GL_TEXTURE_2D) {
+        RecordError(GL_INVALID_ENUM);
+        return;
+    }
+
+    // only the dma-buf images are handed over by EGL with their description
+    const api_dma_buf_image_t *dmaBuf = static_cast<const api_dma_buf_image_t *>(image);
+    if(dmaBuf == nullptr || dmaBuf->magic != API_DMA_BUF_IMAGE_MAGIC) {
+        RecordError(GL_INVALID_OPERATION);
+        return;
+    }
+
+    Texture *activeTexture = mStateManager.GetActiveObjectsState()->GetActiveTexture(target);
+    if(activeTexture->IsImmutable()) {
+        RecordError(GL_INVALID_OPERATION);
+        return;
+    }
+
+    if(IsDrawPending()) {
+        Finish();
+    }
+
+    if(!activeTexture->ImportDmaBuf(dmaBuf)) {
+        RecordError(GL_INVALID_OPERATION);
+    }
 }
 
 void
@@ -335,14 +557,72 @@ Context::EGLImageTargetRenderBufferStorageOES(GLenum target, GLeglImageOES image
     return;
 }
 
+void
+Context::BindToTexture(GLuint bind)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!bind) {
+        mSystemFBO->SetBindToTexture(false);
+        ReleasePbufferTexture();
+        return;
+    }
+
+    // the implicit glFlush of eglBindTexImage, after which the image moves to be sampled in the
+    // aux commands of the next submission, ahead of any draw sampling it, without waiting for the device
+    Flush();
+    mSystemFBO->SetBindToTexture(true);
+    if(mSystemFBO->GetSurfaceType() != GLOVE_SURFACE_PBUFFER) {
+        return;
+    }
+    mSystemFBO->PrepareVkImage(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    Texture *activeTexture = mStateManager.GetActiveObjectsState()->GetActiveTexture(GL_TEXTURE_2D);
+    if(activeTexture->IsImmutable() || !activeTexture->AliasVkImage(mSystemFBO->GetColorAttachmentTexture())) {
+        return;
+    }
+
+    // kept alive like an FBO attachment until it is released, without VK_KHR_maintenance1 the pbuffer
+    // is rendered flipped like every FBO, so the texture takes the inverted copy of FBO attachments
+    if(activeTexture != mPbufferTexture) {
+        ReleasePbufferTexture();
+        mPbufferTexture = activeTexture;
+        mPbufferTexture->Bind();
+        if(mIsYInverted) {
+            mPbufferTexture->IncreaseColorAttachmentRefCount();
+        }
+    }
+}
+
+void
+Context::ReleasePbufferTexture(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(mPbufferTexture == nullptr) {
+        return;
+    }
+
+    mPbufferTexture->ReleaseVkImageAlias();
+    if(mIsYInverted) {
+        mPbufferTexture->DecreaseColorAttachmentRefCount();
+    }
+    mPbufferTexture->Unbind();
+    mPbufferTexture = nullptr;
+}
+
 void
 Context::InsertEventMarkerEXT(GLsizei length, const GLchar *marker)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    NOT_IMPLEMENTED();
+    if(!marker || GLOVE_RECORD_DRAWS_TO_SECONDARY_CMD_BUFFERS || (mWriteFBO && mWriteFBO->IsVkRenderPassSecondary())) {
+        return;
+    }
 
-    return;
+    // a length of 0 stands for a null terminated marker
+    std::string label = length > 0 ? std::string(marker, length) : std::string(marker);
+    mCommandBufferManager->InsertDebugLabel(label.c_str());
 }
 
 void
@@ -350,9 +630,13 @@ Context::PushGroupMarkerEXT(GLsizei length, const GLchar *marker)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    NOT_IMPLEMENTED();
+    if(GLOVE_RECORD_DRAWS_TO_SECONDARY_CMD_BUFFERS || (mWriteFBO && mWriteFBO->IsVkRenderPassSecondary())) {
+        return;
+    }
 
-    return;
+    std::string label = !marker ? std::string() : length > 0 ? std::string(marker, length) : std::string(marker);
+    mCommandBufferManager->BeginDebugLabel(label.c_str());
+    ++mMarkerGroupDepth;
 }
 
 void
@@ -360,7 +644,11 @@ Context::PopGroupMarkerEXT(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    NOT_IMPLEMENTED();
+    // popping an empty stack has no effect
+    if(!mMarkerGroupDepth) {
+        return;
+    }
 
-    return;
+    mCommandBufferManager->EndDebugLabel();
+    --mMarkerGroupDepth;
 }
@@ -26,7 +26,12 @@
 
 #include "utils/glUtils.h"
 #include "utils/glLogger.h"
+#include "utils/glProfiler.h"
 #include "utils/cacheManager.h"
+#include "utils/linearAllocator.h"
+#include "utils/uploadWorker.h"
+#include "utils/compileWorker.h"
+#include "utils/glThread.h"
 #include "glslang/glslangShaderCompiler.h"
 #include "state/stateManager.h"
 #include "resources/resourceManager.h"
@@ -34,10 +39,58 @@
 #include "vulkan/clearPass.h"
 #include "resources/screenSpacePass.h"
 #include "vulkan/commandBufferManager.h"
+#include "vulkan/drawRecorder.h"
+#include "vulkan/ringBuffer.h"
+#include "vulkan/descriptorAllocator.h"
+#include "vulkan/commandBundle.h"
 #include "rendering_api_interface.h"
+#include "GLES2/gl2ext_glove.h"
+#include <string>
 #include <utility>
 #include <map>
 
+#ifndef GLOVE_MAX_LINE_LOOP_INDEX_BUFFERS
+#define GLOVE_MAX_LINE_LOOP_INDEX_BUFFERS               16
+#endif // GLOVE_MAX_LINE_LOOP_INDEX_BUFFERS
+
+/// submissions between two checks of the device memory usage against its budget
+#ifndef GLOVE_MEMORY_BUDGET_CHECK_INTERVAL
+#define GLOVE_MEMORY_BUDGET_CHECK_INTERVAL              16
+#endif // GLOVE_MEMORY_BUDGET_CHECK_INTERVAL
+
+/// pipelines each program keeps when the caches are trimmed
+#ifndef GLOVE_TRIMMED_PIPELINES_KEPT
+#define GLOVE_TRIMMED_PIPELINES_KEPT                    4
+#endif // GLOVE_TRIMMED_PIPELINES_KEPT
+
+/// render passes of different FBOs recorded back to back in a draw command buffer before it is submitted
+#ifndef GLOVE_MAX_CHAINED_RENDER_PASSES
+#define GLOVE_MAX_CHAINED_RENDER_PASSES                 8
+#endif // GLOVE_MAX_CHAINED_RENDER_PASSES
+
+/// reads into a pixel pack buffer are recorded on the device and complete with a later submission
+#ifndef GLOVE_ASYNC_READPIXELS
+#define GLOVE_ASYNC_READPIXELS                          true
+#endif // GLOVE_ASYNC_READPIXELS
+
+/// uploads and reads between color formats are converted by a blit on the device, instead of on the host
+#ifndef GLOVE_DEVICE_PIXEL_CONVERSION
+#define GLOVE_DEVICE_PIXEL_CONVERSION                   true
+#endif // GLOVE_DEVICE_PIXEL_CONVERSION
+
+/// bytes below which the host converts faster than a blit is recorded and submitted
+#ifndef GLOVE_DEVICE_PIXEL_CONVERSION_MIN_SIZE
+#define GLOVE_DEVICE_PIXEL_CONVERSION_MIN_SIZE          (64 << 10)
+#endif // GLOVE_DEVICE_PIXEL_CONVERSION_MIN_SIZE
+
+/// frames between two prints of the per frame statistics, none when unset
+#define GLOVE_FRAME_STATISTICS_ENV                      "GLOVE_FRAME_STATISTICS"
+
+/// frames between two memory reports, which are also written when the context is destroyed, none when unset
+#define GLOVE_MEMORY_REPORT_ENV                         "GLOVE_MEMORY_REPORT"
+/// file the memory reports are appended to, stderr when unset
+#define GLOVE_MEMORY_REPORT_FILE_ENV                    "GLOVE_MEMORY_REPORT_FILE"
+
 typedef enum {
     GLOVE_HOST_X86_BINARY = 1,
     GLOVE_HOST_ARM_BINARY,
@@ -45,8 +98,39 @@ typedef enum {
     GLOVE_MAX_BINARY_FORMATS
 } glove_program_binary_formats_e;
 
+/// a glGet* value as it is kept in the state, converted to the type the application asks for
+typedef struct stateQueryValue_t {
+    enum {
+        QUERY_BOOLEAN,
+        QUERY_INTEGER,
+        QUERY_FLOAT,
+        /// colors and depth values, mapped to the full range of the integer queries
+        QUERY_NORMALIZED
+    }                                           type;
+    uint32_t                                    count;
+    union {
+        GLint                                   i[4];
+        GLfloat                                 f[4];
+    };
+} stateQueryValue_t;
+
 class Context {
 
+public:
+    /// host side work of the calls issued since the last swap
+    typedef struct Statistics {
+        uint32_t                                stateChanges;
+        uint32_t                                descriptorUpdates;
+        uint32_t                                bufferUploads;
+        uint64_t                                bufferUploadBytes;
+        uint32_t                                textureUploads;
+        uint64_t                                textureUploadBytes;
+        uint32_t                                readbacks;
+        uint64_t                                readbackBytes;
+
+        Statistics()                            { memset(static_cast<void *>(this), 0, sizeof(*this)); }
+    } Statistics;
+
 private:
 // ------------
     const
@@ -56,55 +140,173 @@ private:
     StateManager                                mStateManager;
     ResourceManager                            *mResourceManager;
     CacheManager                               *mCacheManager;
-    ShaderCompiler                             *mShaderCompiler;
+    /// owns the shader compiler and its worker, with the shaders and programs they build
+    ShareGroup                                 *mShareGroup;
     vulkanAPI::Pipeline                        *mPipeline;
     ScreenSpacePass                            *mScreenSpacePass;
     vulkanAPI::CommandBufferManager            *mCommandBufferManager;
+    UploadWorker                               *mUploadWorker;
+    /// runs the calls of the context when GLOVE_GLTHREAD is set, nullptr otherwise
+    GLThread                                   *mGLThread;
+    GLuint                                      mMaxShaderCompilerThreads;
+    vulkanAPI::DrawRecorder                     mDrawRecorder;
+    vulkanAPI::RingBuffer                      *mUniformRing;
+    vulkanAPI::RingBuffer                      *mStreamRing;
+    /// index buffers closing non-indexed line loops, per vertex count
+    std::map<uint32_t, BufferObject *>          mLineLoopIndexBuffers;
+    vulkanAPI::DescriptorAllocator             *mDescriptorAllocator;
+    /// scratch host memory of the calls recorded in a frame
+    LinearAllocator                             mFrameArena;
+    /// blit target converting the pixel pack reads, kept across them
+    Texture                                    *mReadbackTexture;
+    /// image the uploads converted by a blit are staged in, kept across them
+    Texture                                    *mUploadTexture;
+    /// texture sampling the pbuffer image in place, between eglBindTexImage and eglReleaseTexImage
+    Texture                                    *mPbufferTexture;
 // ------------
     bool                                        mIsYInverted;
     bool                                        mIsModeLineLoop;
+    /// GL_KHR_no_error, the draws are issued without validating their parameters
+    bool                                        mNoError;
+    /// EGL_IMG_context_priority, the one granted, which selects the graphics queue the context submits to
+    vulkanAPI::queuePriority_t                  mPriority;
+    /// submission the bound buffers were last considered for device local promotion in
+    uint64_t                                    mPromotionSubmissionId;
+    /// render passes ended in the draw command buffer on FBO switches, since it was last submitted
+    uint32_t                                    mChainedRenderPasses;
+    /// the scissor of the pipeline was narrowed to the damage region of the frame
+    bool                                        mScissorDamaged;
+    /// stands for the scissor state the FBOs keep their clamped scissor rect for, unique across the contexts
+    uint32_t                                    mScissorStateId;
+    /// the GL_TIME_ELAPSED_EXT query begun and not yet ended
+    Query                                      *mActiveQuery;
+    /// the GL_ANY_SAMPLES_PASSED_EXT or GL_ANY_SAMPLES_PASSED_CONSERVATIVE_EXT query begun and not yet ended
+    Query                                      *mActiveOcclusionQuery;
+    /// group markers pushed and not yet popped, each one a label open in the command buffers
+    uint32_t                                    mMarkerGroupDepth;
+    /// the command bundle begun and not yet ended, whose draws are recorded rather than executed
+    vulkanAPI::CommandBundle                   *mCapturedBundle;
+    Statistics                                  mStatistics;
+    /// frames between the statistics printed, none when 0
+    uint32_t                                    mStatisticsInterval;
+    uint32_t                                    mStatisticsFrames;
+    /// GLOVE_MEMORY_REPORT is set, and the frames between two memory reports, only on destruction when 0
+    bool                                        mMemoryReport;
+    uint32_t                                    mMemoryReportInterval;
+    uint32_t                                    mMemoryReportFrames;
 // ------------
     EGLSurfaceInterface                        *mWriteSurface;
     EGLSurfaceInterface                        *mReadSurface;
     BufferObject                               *mExplicitIbo;
     Framebuffer                                *mWriteFBO;
+    /// the FBO bound to GL_READ_FRAMEBUFFER_NV on its own, the reads follow mWriteFBO while there is none
+    Framebuffer                                *mReadFBO;
+    GLuint                                      mReadFBOId;
 
     Framebuffer                                *mSystemFBO;
     vector<Texture *>                           mSystemTextures;
+    /// stands for the surfaces of a context made current without any, e.g., a resource loader on a worker thread
+    EGLSurfaceInterface                         mSurfacelessSurface;
 
     typedef std::pair<EGLSurfaceInterface*, EGLSurfaceInterface*> FRAMEBUFFER_SURFACES_PAIR;
     std::map<FRAMEBUFFER_SURFACES_PAIR, Framebuffer*> mSystemFBOMap;
 
+    /// compressed formats exposed, and whether the device samples them without transcoding, probed on first use
+    std::map<GLenum, bool>                      mCompressedTextureFormats;
+    bool                                        mCompressedTextureFormatsProbed;
+    std::string                                 mExtensions;
+
 // ------------
 
-    Shader        *GetShaderPtr(GLuint shader);
-    ShaderProgram *GetProgramPtr(GLuint program);
+    /// wait for the compile or link job of the object to complete, unless only its completion status is needed
+    Shader        *GetShaderPtr(GLuint shader, bool waitCompile = true);
+    ShaderProgram *GetProgramPtr(GLuint program, bool waitLink = true);
+    void           WaitCompileJobs(void);
+    void           FinishProgramLink(ShaderProgram *progPtr);
 
     Framebuffer   *CreateFBOFromEGLSurface(EGLSurfaceInterface *eglSurfaceInterface);
     Framebuffer   *InitializeFrameBuffer(EGLSurfaceInterface *eglSurfaceInterface);
+    Framebuffer   *CreateSurfacelessFBO(void);
     Texture       *CreateDepthStencil(EGLSurfaceInterface *eglSurfaceInterface);
+    static VkSurfaceTransformFlagBitsKHR GetSurfacePreTransform(const EGLSurfaceInterface *eglSurfaceInterface);
 
     void           PrepareRenderPass(bool clearColorEnabled, bool clearDepthEnabled, bool clearStencilEnabled);
+    void           AcquireSurfaceImage(void);
+    void           BeginDrawCommandBuffer(void);
     void           CreateShaderCompiler(void);
     void           ClearSimple(bool clearColorEnabled, bool clearDepthEnabled, bool clearStencilEnabled);
-    void           ClearWithColorMask(bool clearColorEnabled, bool clearDepthEnabled, bool clearStencilEnabled);
+    void           ClearWithMasks(bool clearColorEnabled, bool clearDepthEnabled, bool clearStencilEnabled);
+    bool           ClearInRenderPass(bool clearColorEnabled, bool clearDepthEnabled, bool clearStencilEnabled);
+    void           GetClearValues(bool clearColorEnabled, bool clearDepthEnabled, bool clearStencilEnabled,
+                                  GLfloat *colorValue, GLfloat *depthValue, uint32_t *stencilValue);
 
     void UpdateViewportState(vulkanAPI::Pipeline* pipeline);
+    VkFrontFace GetVkFrontFace(void);
     void BeginRendering(bool clearColorEnabled, bool clearDepthEnabled, bool clearStencilEnabled);
-    void PushGeometry(uint32_t vertCount, uint32_t firstVertex, bool indexed, GLenum type, const void *indices);
-    void UpdateVertexAttributes(uint32_t vertCount, uint32_t firstVertex);
-    void UpdateIndices(uint32_t* offset, uint32_t* maxIndex, uint32_t indexCount, GLenum type, const void* indices, BufferObject* ibo);
+    void EndRenderPass(void);
+    /// indexRange, the first and last vertex an indexed draw reads, spares scanning its indices when given
+    void PushGeometry(uint32_t vertCount, uint32_t firstVertex, uint32_t instanceCount, bool indexed, GLenum type, const void *indices,
+                      const GLuint *indexRange = nullptr);
+    void PushGeometry(uint32_t drawCount, const uint32_t *vertCounts, const uint32_t *firstVertices, uint32_t instanceCount,
+                      bool indexed, GLenum type, const void *const *indices, const GLuint *indexRange = nullptr);
+    void UpdateVertexAttributes(uint32_t vertCount, uint32_t firstVertex, uint32_t instanceCount);
+    void UpdateIndices(uint32_t* offset, uint32_t* maxIndex, uint32_t indexCount, GLenum type, const void* indices, BufferObject* ibo,
+                       bool indexRangeKnown = false);
     void BindUniformDescriptors(VkCommandBuffer *CmdBuffer);
     void BindVertexBuffers(VkCommandBuffer *CmdBuffer);
-    void BindIndexBuffer(VkCommandBuffer *CmdBuffer, uint32_t offset, VkIndexType type);
-    void DrawGeometry(VkCommandBuffer *CmdBuffer, bool indexed, uint32_t firstVertex, uint32_t vertCount);
+    void BindIndexBuffer(VkCommandBuffer *CmdBuffer, VkBuffer buffer, uint32_t offset, VkIndexType type);
+    BufferObject *GetLineLoopIndexBuffer(uint32_t vertCount);
+    void DrawGeometry(VkCommandBuffer *CmdBuffer, bool indexed, uint32_t firstVertex, uint32_t vertCount, uint32_t instanceCount, uint32_t firstIndex = 0);
+    VkCommandBuffer *BeginDrawCommands(VkCommandBuffer *activeCmdBuffer);
+    void EndDrawCommands(VkCommandBuffer *activeCmdBuffer, VkCommandBuffer *drawCmdBuffer);
     void SetCapability(GLenum cap, GLboolean enable);
+    void *MapBufferObject(BufferObject *bo, GLenum target, size_t offset, size_t length, GLbitfield access);
+    bool IsDeviceBusy(void);
+    bool OrphanBufferStorage(BufferObject *bo, size_t size, const void *data, bool deviceLocal);
+    bool ReallocateBufferStorage(BufferObject *bo, size_t size, const void *data, bool deviceLocal);
+    void PromoteStaticBuffers(void);
+    GLint GetGpuMemoryInfo(GLenum pname);
+    bool  QueryState(GLenum pname, stateQueryValue_t *value);
+    template<typename T>
+    void  GetStateValues(GLenum pname, T *params);
 
     void InitializeDefaultTextures(void);
+    const std::map<GLenum, bool> &GetCompressedTextureFormats(void);
+    bool CopyFramebufferToTexture(Texture *texture, const Rect *rect, GLint xoffset, GLint yoffset, GLint level, GLint layer);
+    bool ReadPixelsToBuffer(Texture *srcTexture, const Rect *srcRect, const ImageRect *dstRect, GLenum format, GLenum type,
+                            BufferObject *bo, size_t offset);
+    /// reads srcRect of the framebuffer, as GL addresses it, into dstData in dstFormat
+    void CopyFramebufferToHost(Texture *fbTexture, ImageRect *srcRect, ImageRect *dstRect, GLenum dstFormat, void *dstData);
+    /// reads the packed formats through a blit into a staging buffer, false when the host converts them
+    bool ReadPixelsConverted(Texture *srcTexture, const Rect *srcRect, const ImageRect *dstRect, GLenum format, GLenum type, void *pixels);
+    Texture *GetReadbackTexture(GLenum format, GLenum type, GLsizei width, GLsizei height);
+    Texture *GetTransferTexture(Texture **cached, GLenum format, GLenum type, GLsizei width, GLsizei height);
+    bool WaitBufferReadback(BufferObject *bo);
+    bool HasPendingReadback(BufferObject *bo);
+    void AttachTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level, GLsizei samples);
+    GLsizei GetSupportedSamples(GLsizei samples);
 
     void SetClearRect(void);
+    vulkanAPI::CommandBundle::Target GetCommandBundleTarget(void);
+    void ApplyDamageRect(void);
+    void UpdateScissorStateId(void);
+    bool DrawCoversFramebuffer(void);
+    bool GetDamageRect(Rect *rect) const;
     bool SetPipelineProgramShaderStages(ShaderProgram *progPtr);
     void SetSystemFramebuffer(Framebuffer *FBO);
+    bool SubmitDrawCommandBuffer(void);
+    void DumpFrameStatistics(void);
+    void DumpMemoryReport(void);
+    void WriteMemoryReport(void);
+    /// resolves the result of the query, waiting for the submission of its timestamps or occlusion queries if asked to
+    GLboolean ResolveQuery(Query *query, bool wait);
+    GLboolean ResolveOcclusionQuery(Query *query, bool wait);
+    bool ReadQueryTimestamp(uint64_t ticket, bool wait, uint64_t *ns);
+    bool ReadQueryOcclusion(uint64_t ticket, bool wait, uint64_t *samples);
+    void ReleaseQueryTickets(Query *query);
+    /// counts the samples of the draws recorded next in cmdBuffer for the active occlusion query
+    void BeginOcclusionQuerySegment(VkCommandBuffer *cmdBuffer);
+    bool GetQueryObjectResult(GLuint id, GLenum pname, GLuint64 *result);
 
 // Get Functions
            uint32_t         GetProgramId(const ShaderProgram *progPtr)           { FUN_ENTRY(GL_LOG_TRACE); return (progPtr)   ? mResourceManager->FindShaderProgramID(progPtr) : 0; }
@@ -112,27 +314,56 @@ private:
 
 // Is/Has Functions
     inline bool             IsDrawModeTriangle(GLenum mode)                const { FUN_ENTRY(GL_LOG_TRACE); return (mode == GL_TRIANGLE_STRIP || mode  == GL_TRIANGLE_FAN || mode == GL_TRIANGLES); }
+    inline bool             IsBufferTarget(GLenum target)                  const { FUN_ENTRY(GL_LOG_TRACE); return (target == GL_ARRAY_BUFFER || target == GL_ELEMENT_ARRAY_BUFFER || target == GL_PIXEL_PACK_BUFFER_NV); }
+    /// draws are recorded and not yet submitted, either to the bound FBO or to the ones bound before it
+    inline bool             IsDrawPending(void)                            const { FUN_ENTRY(GL_LOG_TRACE); return mWriteFBO->IsInDrawState() || mChainedRenderPasses > 0; }
+    inline Framebuffer     *GetReadFBO(void)                               const { FUN_ENTRY(GL_LOG_TRACE); return mReadFBO ? mReadFBO : mWriteFBO; }
 // Other Functions
     inline void             RecordError(GLenum error)                            { FUN_ENTRY(GL_LOG_TRACE); if (mStateManager.GetError() == GL_NO_ERROR) { mStateManager.SetError(error); } }
 
 public:
-    Context();
+    /// shares the textures, buffers, renderbuffers, shaders and programs of shareContext, when given
+    Context(Context *shareContext = nullptr, bool noError = false, vulkanAPI::queuePriority_t priority = vulkanAPI::QUEUE_PRIORITY_MEDIUM);
     ~Context();
 
     static void             DestroyAPISurfaceData(const vulkanAPI::vkContext_t *vkContext, EGLSurfaceInterface *eglSurfaceInterface);
 
+    /// runs the calls recorded for the GL thread, before EGL works on the context
+    inline void             SyncGLThread(void)                                    { FUN_ENTRY(GL_LOG_TRACE); if(mGLThread) { mGLThread->Sync(); } }
     void                    ReleaseSystemFBO(void);
+    void                    RetireSystemFBO(void);
+    void                    ReleasePbufferTexture(void);
+    void                    PrepareSwapBuffers(void);
+    vulkanAPI::Fence       *CreateSync(void);
+    void                    WaitSync(const vulkanAPI::Fence *fence);
+    void                    TrimMemory(void);
+    /// JSON report of the device and host memory held per GL object category
+    std::string             GetMemoryReport(bool resetPeaks);
+    /// image of at least width x height in the format, that uploads are copied to before a blit converts them
+    Texture                *GetUploadTexture(GLenum format, GLenum type, GLsizei width, GLsizei height);
 
 // Get Functions
     inline  vulkanAPI::CommandBufferManager *GetVkCommandBufferManager(void)      { FUN_ENTRY(GL_LOG_TRACE); return mCommandBufferManager; }
+    inline  CacheManager                    *GetCacheManager(void)                { FUN_ENTRY(GL_LOG_TRACE); return mCacheManager; }
+    inline  UploadWorker                    *GetUploadWorker(void)                { FUN_ENTRY(GL_LOG_TRACE); return mUploadWorker; }
+    inline  GLThread                        *GetGLThread(void)                    { FUN_ENTRY(GL_LOG_TRACE); return mGLThread; }
+    /// the draws of a command bundle keep their transient data with the bundle
+    inline  vulkanAPI::RingBuffer           *GetUniformRing(void)                 { FUN_ENTRY(GL_LOG_TRACE); return mCapturedBundle ? mCapturedBundle->GetUniformRing()         : mUniformRing; }
+    inline  vulkanAPI::RingBuffer           *GetStreamRing(void)                  { FUN_ENTRY(GL_LOG_TRACE); return mCapturedBundle ? mCapturedBundle->GetStreamRing()          : mStreamRing; }
+    inline  vulkanAPI::DescriptorAllocator  *GetDescriptorAllocator(void)         { FUN_ENTRY(GL_LOG_TRACE); return mCapturedBundle ? mCapturedBundle->GetDescriptorAllocator() : mDescriptorAllocator; }
+    inline  LinearAllocator                 *GetFrameArena(void)                  { FUN_ENTRY(GL_LOG_TRACE); return &mFrameArena; }
+    inline  const vulkanAPI::DrawRecorder::Statistics *GetDrawStatistics(void) const { FUN_ENTRY(GL_LOG_TRACE); return mDrawRecorder.GetStatistics(); }
+    inline  const vulkanAPI::Pipeline::Statistics *GetPipelineStatistics(void) const { FUN_ENTRY(GL_LOG_TRACE); return mPipeline->GetStatistics(); }
+    inline  Statistics                      *GetStatistics(void)                  { FUN_ENTRY(GL_LOG_TRACE); return &mStatistics; }
     inline  StateManager    *GetStateManager(void)                                { FUN_ENTRY(GL_LOG_TRACE); return &mStateManager; }
     inline  ResourceManager *GetResourceManager(void)                             { FUN_ENTRY(GL_LOG_TRACE); return mResourceManager; }
     inline  bool            IsYInverted(void)                              const  { FUN_ENTRY(GL_LOG_TRACE); return mIsYInverted; }
     inline  bool            IsModeLineLoop(void)                           const  { FUN_ENTRY(GL_LOG_TRACE); return mIsModeLineLoop; }
+    inline  vulkanAPI::queuePriority_t GetPriority(void)                   const  { FUN_ENTRY(GL_LOG_TRACE); return mPriority; }
 
 // Set Functions
             void            SetReadWriteSurfaces(EGLSurfaceInterface *eglReadSurfaceInterface, EGLSurfaceInterface *eglWriteSurfaceInterface);
-    inline  void            BindToTexture(GLuint bind)                            { FUN_ENTRY(GL_LOG_DEBUG); mSystemFBO->SetBindToTexture(bind); }
+            void            BindToTexture(GLuint bind);
 
     inline  bool            HasShaderCompiler(void);
 
@@ -288,10 +519,59 @@ public:
     void            PopGroupMarkerEXT(void);
     void            GetProgramBinaryOES(GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary);
     void            ProgramBinaryOES(GLuint program, GLenum binaryFormat, const void *binary, GLint length);
+    void            BindVertexArrayOES(GLuint array);
+    void            DeleteVertexArraysOES(GLsizei n, const GLuint *arrays);
+    void            GenVertexArraysOES(GLsizei n, GLuint *arrays);
+    GLboolean       IsVertexArrayOES(GLuint array);
+    void            DrawArraysInstancedEXT(GLenum mode, GLint first, GLsizei count, GLsizei primcount);
+    void            DrawElementsInstancedEXT(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei primcount,
+                                             const GLuint *indexRange = nullptr);
+    void            MultiDrawArraysEXT(GLenum mode, const GLint *first, const GLsizei *count, GLsizei primcount);
+    void            MultiDrawElementsEXT(GLenum mode, const GLsizei *count, GLenum type, const void *const *indices, GLsizei primcount);
+    void            VertexAttribDivisorEXT(GLuint index, GLuint divisor);
+    void           *MapBufferOES(GLenum target, GLenum access);
+    GLboolean       UnmapBufferOES(GLenum target);
+    void            GetBufferPointervOES(GLenum target, GLenum pname, void **params);
+    void           *MapBufferRangeEXT(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+    void            FlushMappedBufferRangeEXT(GLenum target, GLintptr offset, GLsizeiptr length);
+    void            TexStorage2DEXT(GLenum target, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height);
+    void            TexImage3DOES(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLenum format, GLenum type, const void *pixels);
+    void            TexSubImage3DOES(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void *pixels);
+    void            CopyTexSubImage3DOES(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLint x, GLint y, GLsizei width, GLsizei height);
+    void            CompressedTexImage3DOES(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLsizei imageSize, const void *data);
+    void            CompressedTexSubImage3DOES(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLsizei imageSize, const void *data);
+    void            FramebufferTexture3DOES(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level, GLint zoffset);
+    void            DiscardFramebufferEXT(GLenum target, GLsizei numAttachments, const GLenum *attachments);
+    void            BlitFramebufferANGLE(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter);
+    void            BlitFramebufferNV(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter);
+    void            RenderbufferStorageMultisampleEXT(GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height);
+    void            FramebufferTexture2DMultisampleEXT(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level, GLsizei samples);
+    void            MaxShaderCompilerThreadsKHR(GLuint count);
+    void            GenQueriesEXT(GLsizei n, GLuint *ids);
+    void            DeleteQueriesEXT(GLsizei n, const GLuint *ids);
+    GLboolean       IsQueryEXT(GLuint id);
+    void            BeginQueryEXT(GLenum target, GLuint id);
+    void            EndQueryEXT(GLenum target);
+    void            QueryCounterEXT(GLuint id, GLenum target);
+    void            GetQueryivEXT(GLenum target, GLenum pname, GLint *params);
+    void            GetQueryObjectivEXT(GLuint id, GLenum pname, GLint *params);
+    void            GetQueryObjectuivEXT(GLuint id, GLenum pname, GLuint *params);
+    void            GetQueryObjecti64vEXT(GLuint id, GLenum pname, GLint64 *params);
+    void            GetQueryObjectui64vEXT(GLuint id, GLenum pname, GLuint64 *params);
+    void            GetMemoryReportGLOVE(GLboolean resetPeaks, GLsizei bufSize, GLsizei *length, GLchar *report);
+    void            GenCommandBundlesGLOVE(GLsizei n, GLuint *bundles);
+    void            DeleteCommandBundlesGLOVE(GLsizei n, const GLuint *bundles);
+    void            BeginCommandBundleGLOVE(GLuint bundle);
+    void            EndCommandBundleGLOVE(void);
+    void            CallCommandBundleGLOVE(GLuint bundle);
+    void            DrawRangeElements(GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, const void *indices);
 
 };
 
-Context    *GetCurrentContext(void);
+/// each thread renders with its own current context
+extern thread_local Context *currentContext;
+
+inline Context *GetCurrentContext(void) { return currentContext; }
 void        SetCurrentContext(Context *ctx);
 
 #endif // __CONTEXT_H__
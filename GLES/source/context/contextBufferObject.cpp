@@ -22,13 +22,15 @@
  */
 
 #include "context.h"
+#include <algorithm>
+#include <vector>
 
 void
 Context::BindBuffer(GLenum target, GLuint buffer)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(target != GL_ARRAY_BUFFER && target != GL_ELEMENT_ARRAY_BUFFER) {
+    if(!IsBufferTarget(target)) {
         RecordError(GL_INVALID_ENUM);
         return;
     }
@@ -36,6 +38,10 @@ Context::BindBuffer(GLenum target, GLuint buffer)
     BufferObject *bo = nullptr;
     if(buffer) {
         bo = mResourceManager->GetBuffer(buffer);
+        // a new target may reallocate the storage the device is still reading back into
+        if(bo->GetTarget() != target) {
+            WaitBufferReadback(bo);
+        }
         bo->SetTarget(target);
         bo->SetVkContext(mVkContext);
         bo->Bind();
@@ -59,7 +65,7 @@ Context::BufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usa
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(target != GL_ARRAY_BUFFER && target != GL_ELEMENT_ARRAY_BUFFER) {
+    if(!IsBufferTarget(target)) {
         RecordError(GL_INVALID_ENUM);
         return;
     }
@@ -80,27 +86,122 @@ Context::BufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usa
         return;
     }
 
-    bo->SetUsage(usage);
-    if((data && bo->HasData()) || (data == nullptr && bo->GetSize() && (size_t)size != bo->GetSize())) {
-        bo->Release();
+    if(bo->IsMapped()) {
+        bo->Unmap();
     }
 
-    if(!bo->Allocate(size, data)) {
+    bo->SetUsage(usage);
+
+    // static contents are placed in device local memory, contents that keep changing stay host visible
+    bool deviceLocal = GLOVE_DEVICE_LOCAL_BUFFERS && usage == GL_STATIC_DRAW && size > 0 && target != GL_PIXEL_PACK_BUFFER_NV;
+    if(!ReallocateBufferStorage(bo, size, data, deviceLocal)) {
         RecordError(GL_OUT_OF_MEMORY);
         return;
     }
 
+    if(data) {
+        ++mStatistics.bufferUploads;
+        mStatistics.bufferUploadBytes += size;
+    }
+
     if(target == GL_ELEMENT_ARRAY_BUFFER || bo->IsIndexBuffer()) {
         mPipeline->SetUpdateIndexBuffer(true);
     }
 }
 
+bool
+Context::IsDeviceBusy(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    return IsDrawPending() ||
+           !mCommandBufferManager->IsSubmissionComplete(mCommandBufferManager->GetLastSubmissionId());
+}
+
+bool
+Context::OrphanBufferStorage(BufferObject *bo, size_t size, const void *data, bool deviceLocal)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    BufferObject *storage = mCacheManager->GetRecycledBuffer(size, bo->GetVkBufferUsage(), deviceLocal);
+    if(storage) {
+        storage->UpdateData(size, 0, data);
+    } else {
+        storage = new BufferObject(mVkContext, bo->GetVkBufferUsage());
+        if(!(deviceLocal ? storage->AllocateDeviceLocal(size, data) : storage->Allocate(size, data))) {
+            delete storage;
+            return false;
+        }
+    }
+
+    bo->SwapStorage(storage);
+    mCacheManager->CacheOrphanedBuffer(storage);
+
+    return true;
+}
+
+bool
+Context::ReallocateBufferStorage(BufferObject *bo, size_t size, const void *data, bool deviceLocal)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // draws in flight may still read the current storage, and readbacks write it,
+    // so it is renamed rather than destroyed and retired until their slot has completed
+    if(bo->HasData() && (IsDeviceBusy() || HasPendingReadback(bo))) {
+        return OrphanBufferStorage(bo, size, data, deviceLocal);
+    }
+
+    if(bo->HasData()) {
+        bo->Release();
+    }
+
+    return deviceLocal ? bo->AllocateDeviceLocal(size, data) : bo->Allocate(size, data);
+}
+
+void
+Context::PromoteStaticBuffers(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the buffers drawn with are considered once per submission, and the ones
+    // whose contents have stopped changing are moved to device local memory
+    uint64_t submissionId = mCommandBufferManager->GetLastSubmissionId();
+    if(!GLOVE_DEVICE_LOCAL_BUFFERS || submissionId == mPromotionSubmissionId) {
+        return;
+    }
+    mPromotionSubmissionId = submissionId;
+
+    BufferObject *bos[GLOVE_MAX_VERTEX_ATTRIBS + 1];
+    uint32_t count = mStateManager.GetActiveShaderProgram()->GetVertexBufferObjects(mResourceManager->GetGenericVertexAttributes(), bos);
+    BufferObject *ibo = mStateManager.GetActiveObjectsState()->GetActiveBufferObject(GL_ELEMENT_ARRAY_BUFFER);
+    if(ibo && std::find(bos, bos + count, ibo) == bos + count) {
+        bos[count++] = ibo;
+    }
+
+    for(uint32_t i = 0; i < count; ++i) {
+        BufferObject *bo = bos[i];
+        if(!bo->IsPromotionCandidate()) {
+            continue;
+        }
+
+        std::vector<uint8_t> contents(bo->GetSize());
+        if(!bo->GetData(contents.size(), 0, contents.data()) ||
+           !ReallocateBufferStorage(bo, contents.size(), contents.data(), true)) {
+            continue;
+        }
+
+        if(bo->IsIndexBuffer()) {
+            mPipeline->SetUpdateIndexBuffer(true);
+        }
+    }
+}
+
 void
 Context::BufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(target != GL_ARRAY_BUFFER && target != GL_ELEMENT_ARRAY_BUFFER) {
+    if(!IsBufferTarget(target)) {
         RecordError(GL_INVALID_ENUM);
         return;
     }
@@ -116,8 +217,17 @@ Context::BufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const vo
         return;
     }
 
+    if(bo->IsMapped()) {
+        RecordError(GL_INVALID_OPERATION);
+        return;
+    }
+
+    WaitBufferReadback(bo);
     bo->UpdateData(size, offset, data);
 
+    ++mStatistics.bufferUploads;
+    mStatistics.bufferUploadBytes += size;
+
     if(target == GL_ELEMENT_ARRAY_BUFFER || bo->IsIndexBuffer()) {
         mPipeline->SetUpdateIndexBuffer(true);
     }
@@ -137,7 +247,7 @@ Context::DeleteBuffers(GLsizei n, const GLuint* buffers)
         return;
     }
 
-    if(mWriteFBO->IsInDrawState()) {
+    if(IsDrawPending()) {
         Finish();
     }
 
@@ -147,6 +257,7 @@ Context::DeleteBuffers(GLsizei n, const GLuint* buffers)
         if(buffer && mResourceManager->BufferExists(buffer)) {
 
             BufferObject *buf = mResourceManager->GetBuffer(buffer);
+            WaitBufferReadback(buf);
 
             if(mStateManager.GetActiveObjectsState()->EqualsActiveBufferObject(buf)) {
                 buf->Unbind();
@@ -164,12 +275,12 @@ Context::GetBufferParameteriv(GLenum target, GLenum pname, GLint* params)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(target != GL_ARRAY_BUFFER && target != GL_ELEMENT_ARRAY_BUFFER) {
+    if(!IsBufferTarget(target)) {
         RecordError(GL_INVALID_ENUM);
         return;
     }
 
-    if(pname != GL_BUFFER_SIZE && pname != GL_BUFFER_USAGE) {
+    if(pname != GL_BUFFER_SIZE && pname != GL_BUFFER_USAGE && pname != GL_BUFFER_ACCESS_OES && pname != GL_BUFFER_MAPPED_OES) {
         RecordError(GL_INVALID_ENUM);
         return;
     }
@@ -183,6 +294,8 @@ Context::GetBufferParameteriv(GLenum target, GLenum pname, GLint* params)
     switch(pname) {
     case GL_BUFFER_SIZE:  *params = static_cast<GLint>(bo->GetSize());  break;
     case GL_BUFFER_USAGE: *params = static_cast<GLint>(bo->GetUsage()); break;
+    case GL_BUFFER_ACCESS_OES: *params = GL_WRITE_ONLY_OES; break;
+    case GL_BUFFER_MAPPED_OES: *params = bo->IsMapped() ? GL_TRUE : GL_FALSE; break;
     }
 }
 
@@ -213,3 +326,190 @@ Context::IsBuffer(GLuint buffer)
 
     return (buffer != 0 && mResourceManager->BufferExists(buffer)) ? GL_TRUE : GL_FALSE;
 }
+
+void *
+Context::MapBufferObject(BufferObject *bo, GLenum target, size_t offset, size_t length, GLbitfield access)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!bo->HasData()) {
+        RecordError(GL_INVALID_OPERATION);
+        return nullptr;
+    }
+
+    if(access & GL_MAP_INVALIDATE_BUFFER_BIT_EXT) {
+        // the previous contents are discarded, fresh storage is mapped instead of waiting for the device to release them
+        if(!ReallocateBufferStorage(bo, bo->GetSize(), nullptr, false)) {
+            RecordError(GL_OUT_OF_MEMORY);
+            return nullptr;
+        }
+    } else if(bo->IsDeviceLocal()) {
+        // device local storage cannot be mapped, the contents move back to host visible memory
+        std::vector<uint8_t> contents(bo->GetSize());
+        if(!bo->GetData(contents.size(), 0, contents.data()) ||
+           !ReallocateBufferStorage(bo, contents.size(), contents.data(), false)) {
+            RecordError(GL_OUT_OF_MEMORY);
+            return nullptr;
+        }
+    } else if(!(access & (GL_MAP_UNSYNCHRONIZED_BIT_EXT | GL_MAP_WRITE_BIT_EXT))) {
+        // only reads back into the buffer write it on the device, the ones before it are waited upon
+        if(!WaitBufferReadback(bo)) {
+            RecordError(GL_OUT_OF_MEMORY);
+            return nullptr;
+        }
+    } else if(!(access & GL_MAP_UNSYNCHRONIZED_BIT_EXT)) {
+        // draws already recorded may still read the range
+        Finish();
+    }
+
+    void *ptr = bo->Map(offset, length, access);
+    if(!ptr) {
+        RecordError(GL_OUT_OF_MEMORY);
+        return nullptr;
+    }
+
+    if(target == GL_ELEMENT_ARRAY_BUFFER || bo->IsIndexBuffer()) {
+        mPipeline->SetUpdateIndexBuffer(true);
+    }
+
+    return ptr;
+}
+
+void *
+Context::MapBufferOES(GLenum target, GLenum access)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!IsBufferTarget(target)) {
+        RecordError(GL_INVALID_ENUM);
+        return nullptr;
+    }
+
+    if(access != GL_WRITE_ONLY_OES) {
+        RecordError(GL_INVALID_ENUM);
+        return nullptr;
+    }
+
+    BufferObject *bo = mStateManager.GetActiveObjectsState()->GetActiveBufferObject(target);
+    if(!bo || bo->IsMapped()) {
+        RecordError(GL_INVALID_OPERATION);
+        return nullptr;
+    }
+
+    return MapBufferObject(bo, target, 0, bo->GetSize(), GL_MAP_WRITE_BIT_EXT);
+}
+
+void *
+Context::MapBufferRangeEXT(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!IsBufferTarget(target)) {
+        RecordError(GL_INVALID_ENUM);
+        return nullptr;
+    }
+
+    const GLbitfield validAccess = GL_MAP_READ_BIT_EXT | GL_MAP_WRITE_BIT_EXT | GL_MAP_INVALIDATE_RANGE_BIT_EXT |
+                                   GL_MAP_INVALIDATE_BUFFER_BIT_EXT | GL_MAP_FLUSH_EXPLICIT_BIT_EXT | GL_MAP_UNSYNCHRONIZED_BIT_EXT;
+    if(offset < 0 || length < 0 || (access & ~validAccess)) {
+        RecordError(GL_INVALID_VALUE);
+        return nullptr;
+    }
+
+    BufferObject *bo = mStateManager.GetActiveObjectsState()->GetActiveBufferObject(target);
+    if(!bo) {
+        RecordError(GL_INVALID_OPERATION);
+        return nullptr;
+    }
+
+    if(static_cast<size_t>(offset) + static_cast<size_t>(length) > bo->GetSize()) {
+        RecordError(GL_INVALID_VALUE);
+        return nullptr;
+    }
+
+    if(bo->IsMapped() || !(access & (GL_MAP_READ_BIT_EXT | GL_MAP_WRITE_BIT_EXT)) ||
+       ((access & GL_MAP_READ_BIT_EXT) && (access & (GL_MAP_INVALIDATE_RANGE_BIT_EXT | GL_MAP_INVALIDATE_BUFFER_BIT_EXT | GL_MAP_UNSYNCHRONIZED_BIT_EXT))) ||
+       ((access & GL_MAP_FLUSH_EXPLICIT_BIT_EXT) && !(access & GL_MAP_WRITE_BIT_EXT))) {
+        RecordError(GL_INVALID_OPERATION);
+        return nullptr;
+    }
+
+    return MapBufferObject(bo, target, offset, length, access);
+}
+
+void
+Context::FlushMappedBufferRangeEXT(GLenum target, GLintptr offset, GLsizeiptr length)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!IsBufferTarget(target)) {
+        RecordError(GL_INVALID_ENUM);
+        return;
+    }
+
+    BufferObject *bo = mStateManager.GetActiveObjectsState()->GetActiveBufferObject(target);
+    if(!bo || !bo->IsMapped() || !(bo->GetMappedAccess() & GL_MAP_FLUSH_EXPLICIT_BIT_EXT)) {
+        RecordError(GL_INVALID_OPERATION);
+        return;
+    }
+
+    if(offset < 0 || length < 0 || static_cast<size_t>(offset) + static_cast<size_t>(length) > bo->GetMappedLength()) {
+        RecordError(GL_INVALID_VALUE);
+        return;
+    }
+
+    bo->FlushMappedRange();
+
+    if(target == GL_ELEMENT_ARRAY_BUFFER || bo->IsIndexBuffer()) {
+        mPipeline->SetUpdateIndexBuffer(true);
+    }
+}
+
+GLboolean
+Context::UnmapBufferOES(GLenum target)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!IsBufferTarget(target)) {
+        RecordError(GL_INVALID_ENUM);
+        return GL_FALSE;
+    }
+
+    BufferObject *bo = mStateManager.GetActiveObjectsState()->GetActiveBufferObject(target);
+    if(!bo || !bo->IsMapped()) {
+        RecordError(GL_INVALID_OPERATION);
+        return GL_FALSE;
+    }
+
+    bo->Unmap();
+
+    if(target == GL_ELEMENT_ARRAY_BUFFER || bo->IsIndexBuffer()) {
+        mPipeline->SetUpdateIndexBuffer(true);
+    }
+
+    return GL_TRUE;
+}
+
+void
+Context::GetBufferPointervOES(GLenum target, GLenum pname, void **params)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!IsBufferTarget(target)) {
+        RecordError(GL_INVALID_ENUM);
+        return;
+    }
+
+    if(pname != GL_BUFFER_MAP_POINTER_OES) {
+        RecordError(GL_INVALID_ENUM);
+        return;
+    }
+
+    BufferObject *bo = mStateManager.GetActiveObjectsState()->GetActiveBufferObject(target);
+    if(!bo) {
+        RecordError(GL_INVALID_OPERATION);
+        return;
+    }
+
+    *params = bo->GetMappedPointer();
+}
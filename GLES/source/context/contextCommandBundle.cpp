@@ -0,0 +1,230 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       contextCommandBundle.cpp
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      OpenGL ES API calls related to GL_GLOVE_command_bundle
+ *
+ *  @section
+ *
+ *  Between glBeginCommandBundleGLOVE and glEndCommandBundleGLOVE the draws
+ *  are recorded into the secondary command buffer of the bundle instead of
+ *  being executed, with the state, the uniforms and the client arrays they
+ *  are issued with. glCallCommandBundleGLOVE executes them in the render
+ *  pass of the bound framebuffer, which has to match the one the bundle was
+ *  begun with. The render passes a bundle is executed in take secondary
+ *  command buffers for their other draws as well, and go back to inline
+ *  draws at the first pass without a bundle. Samples drawn by a bundle are
+ *  not counted by occlusion queries, which report them as passed.
+ */
+
+#include "context.h"
+
+vulkanAPI::CommandBundle::Target
+Context::GetCommandBundleTarget(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    vulkanAPI::CommandBundle::Target target;
+    target.colorFormat        = mWriteFBO->GetColorVkFormat();
+    target.depthStencilFormat = mWriteFBO->GetDepthStencilVkFormat();
+    target.samples            = mWriteFBO->GetVkSampleCount();
+    target.framebufferFetch   = mWriteFBO->IsFramebufferFetchEnabled();
+    target.width              = mWriteFBO->GetWidth();
+    target.height             = mWriteFBO->GetHeight();
+    target.originFlipped      = mWriteFBO->IsOriginFlipped();
+    target.preTransform       = mWriteFBO->GetPreTransform();
+
+    return target;
+}
+
+void
+Context::GenCommandBundlesGLOVE(GLsizei n, GLuint *bundles)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(n < 0) {
+        RecordError(GL_INVALID_VALUE);
+        return;
+    }
+
+    if(bundles == nullptr) {
+        return;
+    }
+
+    while(n != 0) {
+        *bundles = mResourceManager->AllocateCommandBundle();
+        mResourceManager->GetCommandBundle(*bundles);
+        bundles++;
+        n--;
+    }
+}
+
+void
+Context::DeleteCommandBundlesGLOVE(GLsizei n, const GLuint *bundles)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(n < 0) {
+        RecordError(GL_INVALID_VALUE);
+        return;
+    }
+
+    if(bundles == nullptr) {
+        return;
+    }
+
+    while(n-- != 0) {
+        uint32_t id = *bundles++;
+
+        if(id && mResourceManager->CommandBundleExists(id)) {
+            vulkanAPI::CommandBundle *bundle = mResourceManager->GetCommandBundle(id);
+
+            // the submissions in flight may still execute it
+            if(bundle->IsRecorded() && IsDeviceBusy()) {
+                Finish();
+            }
+
+            if(bundle == mCapturedBundle) {
+                mCapturedBundle = nullptr;
+                mDrawRecorder.Reset();
+            }
+
+            mResourceManager->DeallocateCommandBundle(id);
+        }
+    }
+}
+
+void
+Context::BeginCommandBundleGLOVE(GLuint bundle)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(mCapturedBundle) {
+        RecordError(GL_INVALID_OPERATION);
+        return;
+    }
+
+    if(!bundle || !mResourceManager->CommandBundleExists(bundle)) {
+        RecordError(GL_INVALID_VALUE);
+        return;
+    }
+
+    if(mWriteFBO->GetStatus() != GL_FRAMEBUFFER_COMPLETE) {
+        RecordError(GL_INVALID_FRAMEBUFFER_OPERATION);
+        return;
+    }
+
+    vulkanAPI::CommandBundle *commandBundle = mResourceManager->GetCommandBundle(bundle);
+
+    // its rings and command buffer are recorded again, once no submission executes them
+    if(commandBundle->IsRecorded() && IsDeviceBusy()) {
+        Finish();
+    }
+
+    // the draws are recorded against a render pass of the framebuffer, without beginning one
+    if(mWriteFBO->IsInIdleState()) {
+        SetClearRect();
+        PrepareRenderPass(false, false, false);
+    }
+
+    if(!commandBundle->Begin(mVkContext, mCommandBufferManager, GetCommandBundleTarget(), *mWriteFBO->GetVkRenderPass())) {
+        RecordError(GL_OUT_OF_MEMORY);
+        return;
+    }
+
+    mCapturedBundle = commandBundle;
+
+    // nothing is bound in the command buffer of the bundle yet
+    mDrawRecorder.Reset();
+}
+
+void
+Context::EndCommandBundleGLOVE(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!mCapturedBundle) {
+        RecordError(GL_INVALID_OPERATION);
+        return;
+    }
+
+    mCapturedBundle->End();
+    mCapturedBundle = nullptr;
+
+    mDrawRecorder.Reset();
+}
+
+void
+Context::CallCommandBundleGLOVE(GLuint bundle)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(mCapturedBundle || !bundle || !mResourceManager->CommandBundleExists(bundle)) {
+        RecordError(GL_INVALID_OPERATION);
+        return;
+    }
+
+    vulkanAPI::CommandBundle *commandBundle = mResourceManager->GetCommandBundle(bundle);
+
+    // a stale bundle reads objects that no longer back the GL ones, and has to be recorded again
+    if(!commandBundle->IsRecorded() || commandBundle->IsStale()) {
+        RecordError(GL_INVALID_OPERATION);
+        return;
+    }
+
+    if(mWriteFBO->GetStatus() != GL_FRAMEBUFFER_COMPLETE) {
+        RecordError(GL_INVALID_FRAMEBUFFER_OPERATION);
+        return;
+    }
+
+    if(!(GetCommandBundleTarget() == commandBundle->GetTarget())) {
+        RecordError(GL_INVALID_OPERATION);
+        return;
+    }
+
+    SetClearRect();
+
+    // a pass begun with inline draws is ended, and the next one takes secondary command buffers
+    if(mWriteFBO->IsInDrawState() && !mWriteFBO->IsVkRenderPassSecondary()) {
+        EndRenderPass();
+    }
+    mWriteFBO->SetSecondaryContents();
+
+    if(mWriteFBO->IsInClearState()) {
+        mWriteFBO->SetStateClearDraw();
+
+    } else if(mWriteFBO->IsInIdleState()) {
+        mWriteFBO->SetStateDraw();
+        BeginRendering(false,false,false);
+
+    } else if(mWriteFBO->IsInClearDrawState()) {
+        mWriteFBO->SetStateDraw();
+    }
+
+    VkCommandBuffer activeCmdBuffer = mCommandBufferManager->GetActiveCommandBuffer();
+    mVkContext->vkDispatch.vkCmdExecuteCommands(activeCmdBuffer, 1, commandBundle->GetVkCommandBuffer());
+    mWriteFBO->SetBundleExecuted();
+
+    // the state bound by the bundle is not inherited by the draws that follow it
+    mDrawRecorder.Reset();
+
+    // the bundle carries no occlusion query of its own
+    if(mActiveOcclusionQuery) {
+        mActiveOcclusionQuery->SetOcclusionUncounted();
+    }
+}
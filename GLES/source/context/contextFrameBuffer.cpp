@@ -22,13 +22,14 @@
  */
 
 #include "context.h"
+#include <algorithm>
 
 void
 Context::BindFramebuffer(GLenum target, GLuint framebuffer)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(target != GL_FRAMEBUFFER) {
+    if(target != GL_FRAMEBUFFER && target != GL_READ_FRAMEBUFFER_NV && target != GL_DRAW_FRAMEBUFFER_NV) {
         RecordError(GL_INVALID_ENUM);
         return;
     }
@@ -43,12 +44,32 @@ Context::BindFramebuffer(GLenum target, GLuint framebuffer)
         }
     }
 
+    // the reads keep following the draws until the two are bound apart
+    if(target == GL_READ_FRAMEBUFFER_NV) {
+        mReadFBO   = fbo;
+        mReadFBOId = framebuffer;
+        return;
+    } else if(target == GL_DRAW_FRAMEBUFFER_NV) {
+        if(!mReadFBO) {
+            mReadFBO   = mWriteFBO;
+            mReadFBOId = mStateManager.GetActiveObjectsState()->GetActiveFramebufferObjectID();
+        }
+    } else {
+        mReadFBO   = nullptr;
+    }
+
     if(mWriteFBO == fbo) {
         return;
     }
 
+    // the render pass of the next FBO is recorded after this one in the same
+    // draw command buffer, without waiting on a submission in between
     if(mWriteFBO->IsInDrawState()) {
-        Finish();
+        if(mChainedRenderPasses < GLOVE_MAX_CHAINED_RENDER_PASSES && !mWriteFBO->IsInDeleteState()) {
+            EndRenderPass();
+        } else {
+            Finish();
+        }
     }
 
     mWriteFBO = fbo;
@@ -64,14 +85,18 @@ Context::CheckFramebufferStatus(GLenum target)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(target != GL_FRAMEBUFFER) {
+    if(target != GL_FRAMEBUFFER && target != GL_READ_FRAMEBUFFER_NV && target != GL_DRAW_FRAMEBUFFER_NV) {
         RecordError(GL_INVALID_ENUM);
         return 0;
     }
 
+    if(target == GL_READ_FRAMEBUFFER_NV) {
+        return GetReadFBO() == mSystemFBO ? GL_FRAMEBUFFER_COMPLETE : GetReadFBO()->GetStatus();
+    }
+
     return (mStateManager.GetActiveObjectsState()->IsDefaultFramebufferObjectActive()) ?
             GL_FRAMEBUFFER_COMPLETE :
-            mResourceManager->GetFramebuffer(mStateManager.GetActiveObjectsState()->GetActiveFramebufferObjectID())->CheckStatus();
+            mResourceManager->GetFramebuffer(mStateManager.GetActiveObjectsState()->GetActiveFramebufferObjectID())->GetStatus();
 }
 
 void
@@ -99,12 +124,12 @@ Context::DeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
             fbo->UnrefAttachment(GL_DEPTH_ATTACHMENT);
             fbo->UnrefAttachment(GL_STENCIL_ATTACHMENT);
 
-            if(mWriteFBO == fbo) {
-
-                if(mWriteFBO->IsInDrawState()) {
-                    Finish();
-                }
+            // render passes of FBOs bound before may still be recorded or in flight
+            if(IsDeviceBusy()) {
+                Finish();
+            }
 
+            if(mWriteFBO == fbo) {
                 mWriteFBO = mSystemFBO;
                 mWriteFBO->SetStateIdle();
 
@@ -112,6 +137,10 @@ Context::DeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
                 mPipeline->SetUpdatePipeline(true);
                 mPipeline->SetUpdateViewportState(true);
             }
+            if(mReadFBO == fbo) {
+                mReadFBO   = mSystemFBO;
+                mReadFBOId = 0;
+            }
 
             mResourceManager->DeallocateFramebuffer(fboindex);
         }
@@ -145,7 +174,7 @@ Context::FramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum render
         return;
     }
 
-    if(renderbuffer != mWriteFBO->GetAttachmentName(attachment) && mWriteFBO->IsInDrawState()) {
+    if(renderbuffer != mWriteFBO->GetAttachmentName(attachment) && IsDrawPending()) {
         Finish();
     }
 
@@ -180,6 +209,53 @@ Context::FramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    AttachTexture2D(target, attachment, textarget, texture, level, 0);
+}
+
+void
+Context::FramebufferTexture2DMultisampleEXT(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level, GLsizei samples)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(samples < 0 || samples > GetSupportedSamples(VK_SAMPLE_COUNT_64_BIT)) {
+        RecordError(GL_INVALID_VALUE);
+        return;
+    }
+
+    // only the color attachment of a texture can be multisampled in the extension
+    if(target == GL_FRAMEBUFFER && attachment != GL_COLOR_ATTACHMENT0) {
+        RecordError(GL_INVALID_ENUM);
+        return;
+    }
+
+    AttachTexture2D(target, attachment, textarget, texture, level, GetSupportedSamples(samples));
+}
+
+void
+Context::FramebufferTexture3DOES(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level, GLint zoffset)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // detaching is the same for every texture target
+    if(!texture) {
+        AttachTexture2D(target, attachment, GL_TEXTURE_2D, 0, level, 0);
+        return;
+    }
+
+    if(textarget != GL_TEXTURE_3D_OES) {
+        RecordError(GL_INVALID_ENUM);
+        return;
+    }
+
+    // the slices of volume textures are only sampled, they are not rendered to
+    RecordError(GL_INVALID_OPERATION);
+}
+
+void
+Context::AttachTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level, GLsizei samples)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
     if(target != GL_FRAMEBUFFER) {
         RecordError(GL_INVALID_ENUM);
         return;
@@ -207,7 +283,8 @@ Context::FramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget
     }
 
     if((mResourceManager->GetTexture(texture)->GetTarget() == GL_TEXTURE_2D       && textarget != GL_TEXTURE_2D) ||
-       (mResourceManager->GetTexture(texture)->GetTarget() == GL_TEXTURE_CUBE_MAP && textarget == GL_TEXTURE_2D)) {
+       (mResourceManager->GetTexture(texture)->GetTarget() == GL_TEXTURE_CUBE_MAP && textarget == GL_TEXTURE_2D) ||
+        mResourceManager->GetTexture(texture)->GetTarget() == GL_TEXTURE_3D_OES) {
         RecordError(GL_INVALID_OPERATION);
         return;
     }
@@ -217,7 +294,8 @@ Context::FramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget
         return;
     }
 
-    if(texture && texture != mWriteFBO->GetAttachmentName(attachment) && mWriteFBO->IsInDrawState()) {
+    if(texture && (texture != mWriteFBO->GetAttachmentName(attachment) || samples != mWriteFBO->GetAttachmentSamples(attachment)) &&
+       IsDrawPending()) {
         Finish();
     }
 
@@ -235,6 +313,7 @@ Context::FramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget
         mWriteFBO->SetColorAttachmentName(texture);
         mWriteFBO->SetColorAttachmentLayer(texture && mResourceManager->GetTexture(texture)->IsCubeMap() ? textarget : 0);
         mWriteFBO->SetColorAttachmentLevel(0);
+        mWriteFBO->SetColorAttachmentSamples(texture ? samples : 0);
         mPipeline->SetUpdateViewportState(true);
         break; }
     case GL_DEPTH_ATTACHMENT:
@@ -339,7 +418,8 @@ Context::GetFramebufferAttachmentParameteriv(GLenum target, GLenum attachment, G
 
     if(type == GL_TEXTURE &&
       (pname != GL_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE   && pname != GL_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME        &&
-       pname != GL_FRAMEBUFFER_ATTACHMENT_TEXTURE_LEVEL && pname != GL_FRAMEBUFFER_ATTACHMENT_TEXTURE_CUBE_MAP_FACE)
+       pname != GL_FRAMEBUFFER_ATTACHMENT_TEXTURE_LEVEL && pname != GL_FRAMEBUFFER_ATTACHMENT_TEXTURE_CUBE_MAP_FACE &&
+       pname != GL_FRAMEBUFFER_ATTACHMENT_TEXTURE_SAMPLES_EXT)
       ) {
         RecordError(GL_INVALID_ENUM);
         return;
@@ -350,6 +430,7 @@ Context::GetFramebufferAttachmentParameteriv(GLenum target, GLenum attachment, G
     case GL_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME:             *params = static_cast<GLint>(name);   break;
     case GL_FRAMEBUFFER_ATTACHMENT_TEXTURE_LEVEL:           *params = level;                      break;
     case GL_FRAMEBUFFER_ATTACHMENT_TEXTURE_CUBE_MAP_FACE:   *params = static_cast<GLint>(layer);  break;
+    case GL_FRAMEBUFFER_ATTACHMENT_TEXTURE_SAMPLES_EXT:     *params = fbo->GetAttachmentSamples(attachment); break;
     }
 }
 
@@ -360,3 +441,224 @@ Context::IsFramebuffer(GLuint framebuffer)
 
     return (framebuffer != 0 && mResourceManager->FramebufferExists(framebuffer)) ? GL_TRUE : GL_FALSE;
 }
+
+void
+Context::DiscardFramebufferEXT(GLenum target, GLsizei numAttachments, const GLenum *attachments)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(target != GL_FRAMEBUFFER) {
+        RecordError(GL_INVALID_ENUM);
+        return;
+    }
+
+    if(numAttachments < 0) {
+        RecordError(GL_INVALID_VALUE);
+        return;
+    }
+
+    // the default framebuffer names its buffers, FBOs their attachment points
+    bool isDefault = mStateManager.GetActiveObjectsState()->IsDefaultFramebufferObjectActive();
+    bool color     = false;
+    bool depth     = false;
+    bool stencil   = false;
+    for(GLsizei i = 0; i < numAttachments; ++i) {
+        switch(attachments[i]) {
+        case GL_COLOR_EXT:
+        case GL_COLOR_ATTACHMENT0:
+            color   = true;
+            break;
+        case GL_DEPTH_EXT:
+        case GL_DEPTH_ATTACHMENT:
+            depth   = true;
+            break;
+        case GL_STENCIL_EXT:
+        case GL_STENCIL_ATTACHMENT:
+            stencil = true;
+            break;
+        default:
+            RecordError(GL_INVALID_ENUM);
+            return;
+        }
+
+        bool isDefaultAttachment = attachments[i] == GL_COLOR_EXT || attachments[i] == GL_DEPTH_EXT || attachments[i] == GL_STENCIL_EXT;
+        if(isDefaultAttachment != isDefault) {
+            RecordError(GL_INVALID_ENUM);
+            return;
+        }
+    }
+
+    // the discarded contents are undefined from now on, so the next render pass does not load them
+    mWriteFBO->InvalidateAttachments(color, depth, stencil);
+}
+
+/// clips the source range of a blit to the framebuffer, and the destination range in proportion, or the other way round
+static void
+ClipBlitAxis(GLint *src0, GLint *src1, GLint *dst0, GLint *dst1, GLint srcSize, GLint dstSize)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    const double scale = static_cast<double>(*dst1 - *dst0) / static_cast<double>(*src1 - *src0);
+
+    GLint *ends[2][2]  = {{src0, dst0}, {src1, dst1}};
+    for(int i = 0; i < 2; ++i) {
+        GLint *src = ends[i][0];
+        GLint *dst = ends[i][1];
+        if(*src < 0 || *src > srcSize) {
+            GLint clamped = std::min(std::max(*src, 0), srcSize);
+            *dst += static_cast<GLint>((clamped - *src) * scale);
+            *src  = clamped;
+        }
+    }
+    for(int i = 0; i < 2; ++i) {
+        GLint *src = ends[i][0];
+        GLint *dst = ends[i][1];
+        if(*dst < 0 || *dst > dstSize) {
+            GLint clamped = std::min(std::max(*dst, 0), dstSize);
+            *src += static_cast<GLint>((clamped - *dst) / scale);
+            *dst  = clamped;
+        }
+    }
+}
+
+void
+Context::BlitFramebufferANGLE(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the ANGLE extension neither scales nor flips
+    if(srcX1 - srcX0 != dstX1 - dstX0 || srcY1 - srcY0 != dstY1 - dstY0 || srcX1 < srcX0 || srcY1 < srcY0) {
+        RecordError(GL_INVALID_OPERATION);
+        return;
+    }
+
+    BlitFramebufferNV(srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter);
+}
+
+void
+Context::BlitFramebufferNV(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(mask & ~(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT)) {
+        RecordError(GL_INVALID_VALUE);
+        return;
+    }
+
+    if(filter != GL_NEAREST && filter != GL_LINEAR) {
+        RecordError(GL_INVALID_ENUM);
+        return;
+    }
+
+    if(filter == GL_LINEAR && (mask & (GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT))) {
+        RecordError(GL_INVALID_OPERATION);
+        return;
+    }
+
+    Framebuffer *readFBO = GetReadFBO();
+    if((readFBO   != mSystemFBO && readFBO->GetStatus()   != GL_FRAMEBUFFER_COMPLETE) ||
+       (mWriteFBO != mSystemFBO && mWriteFBO->GetStatus() != GL_FRAMEBUFFER_COMPLETE)) {
+        RecordError(GL_INVALID_FRAMEBUFFER_OPERATION);
+        return;
+    }
+
+    if(readFBO == mWriteFBO) {
+        RecordError(GL_INVALID_OPERATION);
+        return;
+    }
+
+    // multisampled attachments are resolved at the end of their render pass, so only their rect has to match
+    if(mWriteFBO->GetSamples() > 1 ||
+      (readFBO->GetSamples() > 1 && (srcX0 != dstX0 || srcY0 != dstY0 || srcX1 != dstX1 || srcY1 != dstY1))) {
+        RecordError(GL_INVALID_OPERATION);
+        return;
+    }
+
+    if(!mask || srcX0 == srcX1 || srcY0 == srcY1 || dstX0 == dstX1 || dstY0 == dstY1) {
+        return;
+    }
+
+    AcquireSurfaceImage();
+
+    if(readFBO->IsPreTransformed() || mWriteFBO->IsPreTransformed()) {
+        GLOVE_PRINT_ERR("framebuffers of pre-rotated surfaces cannot be blitted\n");
+        return;
+    }
+
+    // the blit is recorded after the pending draws and executes ahead of the next ones, no wait is needed
+    if(IsDrawPending()) {
+        Flush();
+        mWriteFBO->SetStateIdle();
+    }
+
+    ClipBlitAxis(&srcX0, &srcX1, &dstX0, &dstX1, readFBO->GetWidth(),  mWriteFBO->GetWidth());
+    ClipBlitAxis(&srcY0, &srcY1, &dstY0, &dstY1, readFBO->GetHeight(), mWriteFBO->GetHeight());
+    if(srcX0 == srcX1 || srcY0 == srcY1 || dstX0 == dstX1 || dstY0 == dstY1) {
+        return;
+    }
+
+    const GLint srcHeight = readFBO->GetHeight();
+    const GLint dstHeight = mWriteFBO->GetHeight();
+    const bool  srcFlip   = readFBO->IsOriginFlipped();
+    const bool  dstFlip   = mWriteFBO->IsOriginFlipped();
+
+    VkImageBlit imageBlit;
+    imageBlit.srcSubresource.mipLevel       = 0;
+    imageBlit.srcSubresource.layerCount     = 1;
+    imageBlit.srcOffsets[0]                 = {srcX0, srcFlip ? srcHeight - srcY0 : srcY0, 0};
+    imageBlit.srcOffsets[1]                 = {srcX1, srcFlip ? srcHeight - srcY1 : srcY1, 1};
+    imageBlit.dstSubresource.mipLevel       = 0;
+    imageBlit.dstSubresource.layerCount     = 1;
+    imageBlit.dstOffsets[0]                 = {dstX0, dstFlip ? dstHeight - dstY0 : dstY0, 0};
+    imageBlit.dstOffsets[1]                 = {dstX1, dstFlip ? dstHeight - dstY1 : dstY1, 1};
+
+    if(mask & GL_COLOR_BUFFER_BIT) {
+        imageBlit.srcSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+        imageBlit.srcSubresource.baseArrayLayer = readFBO->GetColorAttachmentLayer() >= GL_TEXTURE_CUBE_MAP_POSITIVE_X ?
+                                                  readFBO->GetColorAttachmentLayer() - GL_TEXTURE_CUBE_MAP_POSITIVE_X : 0;
+        imageBlit.dstSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+        imageBlit.dstSubresource.baseArrayLayer = mWriteFBO->GetColorAttachmentLayer() >= GL_TEXTURE_CUBE_MAP_POSITIVE_X ?
+                                                  mWriteFBO->GetColorAttachmentLayer() - GL_TEXTURE_CUBE_MAP_POSITIVE_X : 0;
+
+        Texture *srcTexture = readFBO->GetColorAttachmentTexture();
+        Texture *dstTexture = mWriteFBO->GetColorAttachmentTexture();
+        if(!srcTexture || !dstTexture ||
+           !dstTexture->BlitPixelsFromImage(srcTexture, &imageBlit, filter == GL_LINEAR ? VK_FILTER_LINEAR : VK_FILTER_NEAREST)) {
+            GLOVE_PRINT_ERR("color buffer cannot be blitted on the device\n");
+        }
+    }
+
+    if(mask & (GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT)) {
+        Texture *srcTexture = readFBO->GetDepthStencilAttachmentTexture();
+        Texture *dstTexture = mWriteFBO->GetDepthStencilAttachmentTexture();
+        if(!srcTexture || !dstTexture) {
+            return;
+        }
+
+        // vkCmdBlitImage does not convert between depth/stencil formats
+        const VkFormat format = srcTexture->GetVkFormat();
+        if(format != dstTexture->GetVkFormat()) {
+            RecordError(GL_INVALID_OPERATION);
+            return;
+        }
+
+        VkImageAspectFlags aspect = 0;
+        if((mask & GL_DEPTH_BUFFER_BIT) && VkFormatIsDepth(format)) {
+            aspect |= VK_IMAGE_ASPECT_DEPTH_BIT;
+        }
+        if((mask & GL_STENCIL_BUFFER_BIT) && VkFormatIsStencil(format)) {
+            aspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+        }
+        if(!aspect) {
+            return;
+        }
+
+        imageBlit.srcSubresource.aspectMask     = aspect;
+        imageBlit.srcSubresource.baseArrayLayer = 0;
+        imageBlit.dstSubresource.aspectMask     = aspect;
+        imageBlit.dstSubresource.baseArrayLayer = 0;
+        if(!dstTexture->BlitPixelsFromImage(srcTexture, &imageBlit, VK_FILTER_NEAREST)) {
+            GLOVE_PRINT_ERR("depth/stencil buffer cannot be blitted on the device\n");
+        }
+    }
+}
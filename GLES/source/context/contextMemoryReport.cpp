@@ -0,0 +1,183 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       contextMemoryReport.cpp
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Memory footprint of the context per GL object category
+ *
+ *  @section
+ *
+ *  The device memory comes from the accounting of the memory allocator, per
+ *  category of the resources it was handed out to and per heap, with their
+ *  peaks since the last reset. The host memory is what GLOVE itself holds
+ *  for the buffers and programs: the shadow copies of device local buffers,
+ *  the SPIR-V of the shaders, the reflection of the programs and the program
+ *  and pipeline caches. What the driver allocates for pipelines, descriptor
+ *  pools and command buffers is not visible to GLOVE, so those are reported
+ *  as counts. The report is taken with glGetMemoryReportGLOVE, or written
+ *  every GLOVE_MEMORY_REPORT frames and when the context is destroyed.
+ */
+
+#include "context.h"
+#include "utils/programCache.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+static void
+AppendField(std::string &report, const char *name, uint64_t value, bool first = false)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    char field[96];
+    snprintf(field, sizeof(field), "%s\"%s\":%llu", first ? "" : ",", name, static_cast<unsigned long long>(value));
+    report += field;
+}
+
+std::string
+Context::GetMemoryReport(bool resetPeaks)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    vulkanAPI::MemoryAllocator *allocator = mVkContext->vkMemoryAllocator;
+    const VkPhysicalDeviceMemoryProperties &properties = mVkContext->vkDeviceMemoryProperties;
+
+    std::string report = "{\"device\":{\"categories\":{";
+    for(uint32_t i = 0; i < vulkanAPI::MemoryAllocator::CATEGORY_COUNT; ++i) {
+        vulkanAPI::MemoryAllocator::category_t category = static_cast<vulkanAPI::MemoryAllocator::category_t>(i);
+        report += i ? ",\"" : "\"";
+        report += vulkanAPI::MemoryAllocator::GetCategoryName(category);
+        report += "\":{";
+        AppendField(report, "bytes", allocator->GetCategoryUsage(category), true);
+        AppendField(report, "peak",  allocator->GetCategoryPeak(category));
+        report += "}";
+    }
+
+    // the usage of a heap includes the free ranges of its blocks, unlike the categories
+    report += "},\"heaps\":[";
+    for(uint32_t i = 0; i < properties.memoryHeapCount; ++i) {
+        VkDeviceSize usage, peak, budgetUsage, budget;
+        allocator->GetHeapUsage(i, &usage, &peak);
+        allocator->GetHeapBudget(i, &budgetUsage, &budget);
+        report += i ? ",{" : "{";
+        AppendField(report, "device_local", (properties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) ? 1 : 0, true);
+        AppendField(report, "size",   properties.memoryHeaps[i].size);
+        AppendField(report, "budget", budget);
+        AppendField(report, "bytes",  usage);
+        AppendField(report, "peak",   peak);
+        report += "}";
+    }
+    report += "]},";
+
+    uint64_t shadowBytes = 0, spirvBytes = 0, reflectionBytes = 0, pipelines = 0;
+    size_t   textures, buffers, shaders, programs;
+    {
+        std::lock_guard<std::recursive_mutex> lock(mShareGroup->GetMutex());
+        for(BufferObject *bo : mResourceManager->GetBufferArray()->GetObjects()) {
+            shadowBytes += bo->GetShadowSize();
+        }
+        for(Shader *shader : mResourceManager->GetShaderArray()->GetObjects()) {
+            spirvBytes += shader->GetSPV().size() * sizeof(uint32_t);
+        }
+        for(ShaderProgram *program : mResourceManager->GetShaderProgramArray()->GetObjects()) {
+            reflectionBytes += program->GetReflectionSize();
+            pipelines       += program->GetPipelineCache() ? program->GetPipelineCache()->GetPipelineCount() : 0;
+        }
+        textures = mResourceManager->GetTextureArray()->GetObjects().size();
+        buffers  = mResourceManager->GetBufferArray()->GetObjects().size();
+        shaders  = mResourceManager->GetShaderArray()->GetObjects().size();
+        programs = mResourceManager->GetShaderProgramArray()->GetObjects().size();
+    }
+
+    report += "\"host\":{";
+    AppendField(report, "buffer_shadow",      shadowBytes, true);
+    AppendField(report, "program_spirv",      spirvBytes);
+    AppendField(report, "program_reflection", reflectionBytes);
+    AppendField(report, "program_cache",      ProgramCache::GetSize());
+    AppendField(report, "pipeline_cache",     allocator->GetPipelineCacheSize());
+    report += "},\"objects\":{";
+
+    uint32_t descriptorPools = mDescriptorAllocator->GetPoolCount();
+    AppendField(report, "textures",         textures, true);
+    AppendField(report, "buffers",          buffers);
+    AppendField(report, "shaders",          shaders);
+    AppendField(report, "programs",         programs);
+    AppendField(report, "pipelines",        pipelines);
+    AppendField(report, "descriptor_pools", descriptorPools);
+    AppendField(report, "descriptor_sets",  static_cast<uint64_t>(descriptorPools) * GLOVE_DESCRIPTOR_POOL_MAX_SETS);
+    AppendField(report, "command_buffers",  mCommandBufferManager->GetCommandBufferCount());
+    report += "}}";
+
+    if(resetPeaks) {
+        allocator->ResetPeaks();
+    }
+
+    return report;
+}
+
+void
+Context::WriteMemoryReport(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    const char *path = getenv(GLOVE_MEMORY_REPORT_FILE_ENV);
+    FILE *fp = path && path[0] != '\0' ? fopen(path, "a") : stderr;
+    if(!fp) {
+        return;
+    }
+
+    // one report per line, so that a run can be followed over time
+    fprintf(fp, "%s\n", GetMemoryReport(false).c_str());
+
+    if(fp != stderr) {
+        fclose(fp);
+    }
+}
+
+void
+Context::DumpMemoryReport(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(mMemoryReportInterval && ++mMemoryReportFrames >= mMemoryReportInterval) {
+        mMemoryReportFrames = 0;
+        WriteMemoryReport();
+    }
+}
+
+void
+Context::GetMemoryReportGLOVE(GLboolean resetPeaks, GLsizei bufSize, GLsizei *length, GLchar *report)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(bufSize < 0) {
+        RecordError(GL_INVALID_VALUE);
+        return;
+    }
+
+    std::string memoryReport = GetMemoryReport(resetPeaks == GL_TRUE);
+
+    if(length) {
+        *length = static_cast<GLsizei>(memoryReport.size());
+    }
+
+    if(report && bufSize > 0) {
+        size_t size = std::min(memoryReport.size(), static_cast<size_t>(bufSize - 1));
+        memcpy(report, memoryReport.c_str(), size);
+        report[size] = '\0';
+    }
+}
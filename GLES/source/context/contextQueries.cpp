@@ -0,0 +1,455 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       contextQueries.cpp
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      OpenGL ES API calls related to Timer and Occlusion Queries
+ *
+ *  @section
+ *
+ *  GL_EXT_disjoint_timer_query is backed by the timestamps of the command
+ *  buffer manager, written into the draw command buffer when the queries
+ *  begin, end or count. Their results are read back without blocking once
+ *  the submission carrying them completes; GL_QUERY_RESULT_EXT flushes and
+ *  waits for it first. The GPU is never reported disjoint.
+ *
+ *  GL_EXT_occlusion_query_boolean is backed by the occlusion queries of the
+ *  command buffer manager. A Vulkan query begun in a render pass must end in
+ *  it, so a GL query begins one at its first draw in each render pass, or in
+ *  each secondary command buffer, and samples passed when any of them counted
+ *  some. Their results are read in the same way as the timestamps, so that
+ *  culling can consume them a frame later without a glFinish. Clears are not
+ *  counted, as in GL.
+ */
+
+#include "context.h"
+
+static inline bool
+IsOcclusionQueryTarget(GLenum target)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    return target == GL_ANY_SAMPLES_PASSED_EXT || target == GL_ANY_SAMPLES_PASSED_CONSERVATIVE_EXT;
+}
+
+void
+Context::ReleaseQueryTickets(Query *query)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    vulkanAPI::TimestampPool *timestamps = mCommandBufferManager->GetTimestampPool();
+    timestamps->Release(query->GetBeginTicket());
+    timestamps->Release(query->GetEndTicket());
+
+    vulkanAPI::OcclusionPool *occlusion = mCommandBufferManager->GetOcclusionPool();
+    for(uint64_t ticket : query->GetOcclusionTickets()) {
+        occlusion->Release(ticket);
+    }
+}
+
+GLboolean
+Context::ResolveQuery(Query *query, bool wait)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(query->IsResultAvailable()) {
+        return GL_TRUE;
+    }
+
+    if(IsOcclusionQueryTarget(query->GetTarget())) {
+        return ResolveOcclusionQuery(query, wait);
+    }
+
+    uint64_t begin = 0;
+    uint64_t end   = 0;
+    if(!ReadQueryTimestamp(query->GetBeginTicket(), wait, &begin) ||
+       !ReadQueryTimestamp(query->GetEndTicket(),   wait, &end)) {
+        return GL_FALSE;
+    }
+
+    if(query->GetTarget() == GL_TIMESTAMP_EXT) {
+        query->SetResult(end);
+    } else {
+        query->SetResult(end > begin ? end - begin : 0);
+    }
+
+    ReleaseQueryTickets(query);
+
+    return GL_TRUE;
+}
+
+GLboolean
+Context::ResolveOcclusionQuery(Query *query, bool wait)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the result is known as soon as one of the render passes it drew in passed samples
+    bool passed  = query->IsOcclusionUncounted();
+    bool pending = false;
+    for(uint64_t ticket : query->GetOcclusionTickets()) {
+        if(passed) {
+            break;
+        }
+
+        uint64_t samples = 0;
+        if(!ReadQueryOcclusion(ticket, wait, &samples)) {
+            pending = true;
+            continue;
+        }
+        passed = samples != 0;
+    }
+
+    if(!passed && pending) {
+        return GL_FALSE;
+    }
+
+    query->SetResult(passed ? GL_TRUE : GL_FALSE);
+    ReleaseQueryTickets(query);
+
+    return GL_TRUE;
+}
+
+bool
+Context::ReadQueryTimestamp(uint64_t ticket, bool wait, uint64_t *ns)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // a timestamp that did not fit in its slot reads as 0
+    *ns = 0;
+    if(!ticket) {
+        return true;
+    }
+
+    vulkanAPI::TimestampPool *timestamps = mCommandBufferManager->GetTimestampPool();
+    if(timestamps->GetResult(ticket, ns)) {
+        return true;
+    }
+
+    if(!wait) {
+        return false;
+    }
+
+    if(!timestamps->GetSubmissionId(ticket)) {
+        Finish();
+    }
+
+    uint64_t submissionId = timestamps->GetSubmissionId(ticket);
+    if(submissionId && submissionId != UINT64_MAX) {
+        mCommandBufferManager->WaitSubmission(submissionId);
+    }
+
+    if(!timestamps->GetResult(ticket, ns)) {
+        *ns = 0;
+    }
+
+    return true;
+}
+
+bool
+Context::ReadQueryOcclusion(uint64_t ticket, bool wait, uint64_t *samples)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    vulkanAPI::OcclusionPool *occlusion = mCommandBufferManager->GetOcclusionPool();
+    if(occlusion->GetResult(ticket, samples)) {
+        return true;
+    }
+
+    if(!wait) {
+        return false;
+    }
+
+    if(!occlusion->GetSubmissionId(ticket)) {
+        Finish();
+    }
+
+    uint64_t submissionId = occlusion->GetSubmissionId(ticket);
+    if(submissionId && submissionId != UINT64_MAX) {
+        mCommandBufferManager->WaitSubmission(submissionId);
+    }
+
+    // a query that was never executed passed no samples
+    if(!occlusion->GetResult(ticket, samples)) {
+        *samples = 0;
+    }
+
+    return true;
+}
+
+void
+Context::BeginOcclusionQuerySegment(VkCommandBuffer *cmdBuffer)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    uint64_t ticket = 0;
+    if(!mCommandBufferManager->BeginOcclusionQuery(*cmdBuffer, &ticket)) {
+        mActiveOcclusionQuery->SetOcclusionUncounted();
+        return;
+    }
+
+    if(ticket) {
+        mActiveOcclusionQuery->AddOcclusionTicket(ticket);
+    }
+}
+
+void
+Context::GenQueriesEXT(GLsizei n, GLuint *ids)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(n < 0) {
+        RecordError(GL_INVALID_VALUE);
+        return;
+    }
+
+    if(ids == nullptr) {
+        return;
+    }
+
+    while(n != 0) {
+        *ids = mResourceManager->AllocateQuery();
+        mResourceManager->GetQuery(*ids);
+        ids++;
+        n--;
+    }
+}
+
+void
+Context::DeleteQueriesEXT(GLsizei n, const GLuint *ids)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(n < 0) {
+        RecordError(GL_INVALID_VALUE);
+        return;
+    }
+
+    if(ids == nullptr) {
+        return;
+    }
+
+    while(n-- != 0) {
+        uint32_t id = *ids++;
+
+        if(id && mResourceManager->QueryExists(id)) {
+            Query *query = mResourceManager->GetQuery(id);
+
+            if(query == mActiveQuery) {
+                mActiveQuery = nullptr;
+            }
+
+            if(query == mActiveOcclusionQuery) {
+                mCommandBufferManager->EndOcclusionQuery();
+                mActiveOcclusionQuery = nullptr;
+            }
+
+            ReleaseQueryTickets(query);
+            mResourceManager->DeallocateQuery(id);
+        }
+    }
+}
+
+GLboolean
+Context::IsQueryEXT(GLuint id)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    return (id && mResourceManager->QueryExists(id) && mResourceManager->GetQuery(id)->GetTarget()) ? GL_TRUE : GL_FALSE;
+}
+
+void
+Context::BeginQueryEXT(GLenum target, GLuint id)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(target != GL_TIME_ELAPSED_EXT && !IsOcclusionQueryTarget(target)) {
+        RecordError(GL_INVALID_ENUM);
+        return;
+    }
+
+    // the two occlusion targets cannot be active at the same time
+    Query **activeQuery = target == GL_TIME_ELAPSED_EXT ? &mActiveQuery : &mActiveOcclusionQuery;
+    if(!id || !mResourceManager->QueryExists(id) || *activeQuery) {
+        RecordError(GL_INVALID_OPERATION);
+        return;
+    }
+
+    Query *query = mResourceManager->GetQuery(id);
+    if(query->GetTarget() && query->GetTarget() != target) {
+        RecordError(GL_INVALID_OPERATION);
+        return;
+    }
+
+    ReleaseQueryTickets(query);
+
+    // the occlusion queries are begun by the draws, in the render passes they are recorded in
+    query->Begin(target, target == GL_TIME_ELAPSED_EXT ? mCommandBufferManager->WriteTimestamp() : 0);
+    *activeQuery = query;
+}
+
+void
+Context::EndQueryEXT(GLenum target)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(target != GL_TIME_ELAPSED_EXT && !IsOcclusionQueryTarget(target)) {
+        RecordError(GL_INVALID_ENUM);
+        return;
+    }
+
+    if(IsOcclusionQueryTarget(target)) {
+        if(!mActiveOcclusionQuery || mActiveOcclusionQuery->GetTarget() != target) {
+            RecordError(GL_INVALID_OPERATION);
+            return;
+        }
+
+        mCommandBufferManager->EndOcclusionQuery();
+        mActiveOcclusionQuery = nullptr;
+        return;
+    }
+
+    if(!mActiveQuery) {
+        RecordError(GL_INVALID_OPERATION);
+        return;
+    }
+
+    mActiveQuery->SetEndTicket(mCommandBufferManager->WriteTimestamp());
+    mActiveQuery = nullptr;
+}
+
+void
+Context::QueryCounterEXT(GLuint id, GLenum target)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(target != GL_TIMESTAMP_EXT) {
+        RecordError(GL_INVALID_ENUM);
+        return;
+    }
+
+    if(!id || !mResourceManager->QueryExists(id)) {
+        RecordError(GL_INVALID_OPERATION);
+        return;
+    }
+
+    Query *query = mResourceManager->GetQuery(id);
+    if(query == mActiveQuery || query == mActiveOcclusionQuery || (query->GetTarget() && query->GetTarget() != target)) {
+        RecordError(GL_INVALID_OPERATION);
+        return;
+    }
+
+    ReleaseQueryTickets(query);
+
+    query->Begin(target, 0);
+    query->SetEndTicket(mCommandBufferManager->WriteTimestamp());
+}
+
+void
+Context::GetQueryivEXT(GLenum target, GLenum pname, GLint *params)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(target != GL_TIME_ELAPSED_EXT && target != GL_TIMESTAMP_EXT && !IsOcclusionQueryTarget(target)) {
+        RecordError(GL_INVALID_ENUM);
+        return;
+    }
+
+    if(IsOcclusionQueryTarget(target)) {
+        if(pname != GL_CURRENT_QUERY_EXT) {
+            RecordError(GL_INVALID_ENUM);
+            return;
+        }
+        *params = (mActiveOcclusionQuery && mActiveOcclusionQuery->GetTarget() == target) ? static_cast<GLint>(mResourceManager->GetQueryID(mActiveOcclusionQuery)) : 0;
+        return;
+    }
+
+    switch(pname) {
+    case GL_CURRENT_QUERY_EXT:      *params = (target == GL_TIME_ELAPSED_EXT && mActiveQuery) ? static_cast<GLint>(mResourceManager->GetQueryID(mActiveQuery)) : 0; break;
+    case GL_QUERY_COUNTER_BITS_EXT: *params = static_cast<GLint>(mCommandBufferManager->GetTimestampPool()->GetValidBits()); break;
+    default:                        RecordError(GL_INVALID_ENUM); break;
+    }
+}
+
+bool
+Context::GetQueryObjectResult(GLuint id, GLenum pname, GLuint64 *result)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(pname != GL_QUERY_RESULT_EXT && pname != GL_QUERY_RESULT_AVAILABLE_EXT) {
+        RecordError(GL_INVALID_ENUM);
+        return false;
+    }
+
+    if(!IsQueryEXT(id) || mResourceManager->GetQuery(id) == mActiveQuery || mResourceManager->GetQuery(id) == mActiveOcclusionQuery) {
+        RecordError(GL_INVALID_OPERATION);
+        return false;
+    }
+
+    Query *query = mResourceManager->GetQuery(id);
+    if(pname == GL_QUERY_RESULT_AVAILABLE_EXT) {
+        *result = ResolveQuery(query, false);
+    } else {
+        ResolveQuery(query, true);
+        *result = query->GetResult();
+    }
+
+    return true;
+}
+
+void
+Context::GetQueryObjectivEXT(GLuint id, GLenum pname, GLint *params)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    GLuint64 result;
+    if(GetQueryObjectResult(id, pname, &result)) {
+        *params = static_cast<GLint>(std::min<GLuint64>(result, INT32_MAX));
+    }
+}
+
+void
+Context::GetQueryObjectuivEXT(GLuint id, GLenum pname, GLuint *params)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    GLuint64 result;
+    if(GetQueryObjectResult(id, pname, &result)) {
+        *params = static_cast<GLuint>(std::min<GLuint64>(result, UINT32_MAX));
+    }
+}
+
+void
+Context::GetQueryObjecti64vEXT(GLuint id, GLenum pname, GLint64 *params)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    GLuint64 result;
+    if(GetQueryObjectResult(id, pname, &result)) {
+        *params = static_cast<GLint64>(std::min<GLuint64>(result, INT64_MAX));
+    }
+}
+
+void
+Context::GetQueryObjectui64vEXT(GLuint id, GLenum pname, GLuint64 *params)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    GLuint64 result;
+    if(GetQueryObjectResult(id, pname, &result)) {
+        *params = result;
+    }
+}
@@ -79,7 +79,7 @@ Context::DeleteRenderbuffers(GLsizei n, const GLuint *renderbuffers)
                ((index == mWriteFBO->GetColorAttachmentName() && GL_RENDERBUFFER == mWriteFBO->GetColorAttachmentType())    ||
                 (index == mWriteFBO->GetDepthAttachmentName() && GL_RENDERBUFFER == mWriteFBO->GetDepthAttachmentType())    ||
                 (index == mWriteFBO->GetStencilAttachmentName() && GL_RENDERBUFFER == mWriteFBO->GetStencilAttachmentType())) &&
-                mWriteFBO->IsInDrawState()) {
+                IsDrawPending()) {
 
                 if(index == mWriteFBO->GetColorAttachmentName() && GL_RENDERBUFFER == mWriteFBO->GetColorAttachmentType()) {
                     mWriteFBO->SetStateDelete();
@@ -169,6 +169,7 @@ Context::GetRenderbufferParameteriv(GLenum target, GLenum pname, GLint* params)
     case GL_RENDERBUFFER_WIDTH:             *params = activeRenderbuffer->GetWidth(); break;
     case GL_RENDERBUFFER_HEIGHT:            *params = activeRenderbuffer->GetHeight(); break;
     case GL_RENDERBUFFER_INTERNAL_FORMAT:   *params = activeRenderbuffer->GetInternalFormat(); break;
+    case GL_RENDERBUFFER_SAMPLES_EXT:       *params = activeRenderbuffer->GetSamples(); break;
     case GL_RENDERBUFFER_RED_SIZE:          GlFormatToStorageBits(activeRenderbuffer->GetInternalFormat(), params, nullptr, nullptr, nullptr, nullptr, nullptr); break;
     case GL_RENDERBUFFER_GREEN_SIZE:        GlFormatToStorageBits(activeRenderbuffer->GetInternalFormat(), nullptr, params, nullptr, nullptr, nullptr, nullptr); break;
     case GL_RENDERBUFFER_BLUE_SIZE:         GlFormatToStorageBits(activeRenderbuffer->GetInternalFormat(), nullptr, nullptr, params, nullptr, nullptr, nullptr); break;
@@ -192,12 +193,21 @@ Context::RenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    RenderbufferStorageMultisampleEXT(target, 0, internalformat, width, height);
+}
+
+void
+Context::RenderbufferStorageMultisampleEXT(GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
     if(target != GL_RENDERBUFFER) {
         RecordError(GL_INVALID_ENUM);
         return;
     }
 
-    if(width < 0 || width > GLOVE_MAX_RENDERBUFFER_SIZE || height < 0 || height > GLOVE_MAX_RENDERBUFFER_SIZE) {
+    if(width < 0 || width > GLOVE_MAX_RENDERBUFFER_SIZE || height < 0 || height > GLOVE_MAX_RENDERBUFFER_SIZE ||
+       samples < 0 || samples > GetSupportedSamples(VK_SAMPLE_COUNT_64_BIT)) {
         RecordError(GL_INVALID_VALUE);
         return;
     }
@@ -223,12 +233,12 @@ Context::RenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width
     if(((activeRenderbufferId == mWriteFBO->GetColorAttachmentName()   && GL_RENDERBUFFER == mWriteFBO->GetColorAttachmentType())    ||
         (activeRenderbufferId == mWriteFBO->GetDepthAttachmentName()   && GL_RENDERBUFFER == mWriteFBO->GetDepthAttachmentType())    ||
         (activeRenderbufferId == mWriteFBO->GetStencilAttachmentName() && GL_RENDERBUFFER == mWriteFBO->GetStencilAttachmentType())) &&
-        mWriteFBO->IsInDrawState()) {
+        IsDrawPending()) {
         Finish();
     }
 
     Renderbuffer* activeRenderbuffer = mResourceManager->GetRenderbuffer(activeRenderbufferId);
-    if(!activeRenderbuffer->Allocate(width, height, internalformat)) {
+    if(!activeRenderbuffer->Allocate(width, height, internalformat, GetSupportedSamples(samples))) {
         RecordError(GL_OUT_OF_MEMORY);
         return;
     }
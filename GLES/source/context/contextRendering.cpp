@@ -22,41 +22,86 @@
  */
 
 #include "context.h"
+#include "utils/startupProfile.h"
 
 void
-Context::PrepareRenderPass(bool clearColorEnabled, bool clearDepthEnabled, bool clearStencilEnabled)
+Context::GetClearValues(bool clearColorEnabled, bool clearDepthEnabled, bool clearStencilEnabled,
+                        GLfloat *colorValue, GLfloat *depthValue, uint32_t *stencilValue)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
     StateFramebufferOperations *stateFramebufferOperations = mStateManager.GetFramebufferOperationsState();
 
-    GLfloat clearColorValue[4] = {0.0f,0.0f,0.0f,0.0f};
+    colorValue[0] = colorValue[1] = colorValue[2] = colorValue[3] = 0.0f;
     if(clearColorEnabled) {
-        stateFramebufferOperations->GetClearColor(clearColorValue);
+        stateFramebufferOperations->GetClearColor(colorValue);
         if(mWriteFBO->GetColorAttachmentTexture() && mWriteFBO->GetColorAttachmentTexture()->GetFormat() == GL_RGB) {
-            clearColorValue[3] = 1.0f;
+            colorValue[3] = 1.0f;
         }
     }
 
-    GLfloat clearDepthValue    = clearDepthEnabled   ? stateFramebufferOperations->GetClearDepth() : 0.0f;
-    uint32_t clearStencilValue = clearStencilEnabled ? stateFramebufferOperations->GetClearStencilMasked() : 0u;
+    *depthValue   = clearDepthEnabled   ? stateFramebufferOperations->GetClearDepth() : 0.0f;
+    *stencilValue = clearStencilEnabled ? stateFramebufferOperations->GetClearStencilMasked() : 0u;
+}
+
+void
+Context::AcquireSurfaceImage(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // surfaces that acquire lazily get their next image at its first use in the frame,
+    // which may also recreate their images and so replace the system FBO
+    if(mWriteFBO != nullptr && mWriteFBO == mSystemFBO && mWriteSurface != nullptr &&
+       mWriteSurface->acquireImageCb != nullptr && !mWriteSurface->imageAcquired) {
+        mWriteSurface->acquireImageCb(mWriteSurface->acquireImageData, mWriteSurface->surface);
+    }
+}
+
+void
+Context::BeginDrawCommandBuffer(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // the offscreen passes recorded before the first commands on the swapchain image
+    // are submitted ahead of them, overlapping with the acquisition of the image
+    if(mWriteFBO == mSystemFBO) {
+        mCommandBufferManager->SplitVkDrawCommandBuffer();
+    }
+
+    mCommandBufferManager->BeginVkDrawCommandBuffer();
+}
+
+void
+Context::PrepareRenderPass(bool clearColorEnabled, bool clearDepthEnabled, bool clearStencilEnabled)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    AcquireSurfaceImage();
+
+    StateFramebufferOperations *stateFramebufferOperations = mStateManager.GetFramebufferOperationsState();
 
-    // Update stencil buffer with mask
-    if(clearStencilEnabled && stateFramebufferOperations->StencilMaskActive()) {
-        mWriteFBO->UpdateClearDepthStencilTexture(clearStencilValue, stateFramebufferOperations->GetStencilMaskFront(), mClearRect);
-        clearStencilValue = 0;
-        clearStencilEnabled = false;
+    GLfloat  clearColorValue[4];
+    GLfloat  clearDepthValue;
+    uint32_t clearStencilValue;
+    GetClearValues(clearColorEnabled, clearDepthEnabled, clearStencilEnabled,
+                   clearColorValue, &clearDepthValue, &clearStencilValue);
+
+    // the presented image is not the next one, so there is nothing worth loading
+    // when the first draw after a swap overwrites the whole surface, unless the
+    // application has asked for the age of the image to redraw only part of it
+    if(mWriteFBO->IsPresented() && DrawCoversFramebuffer() &&
+       !(mWriteFBO == mSystemFBO && mWriteSurface && mWriteSurface->bufferAge)) {
+        mWriteFBO->InvalidateAttachments(true, false, false);
     }
 
-    // perform a screen-space pass
+    // perform a screen-space pass. The attachments are moved to their layouts by the pass itself,
+    // in-order with the passes chained before it, rather than by barriers on the aux command buffer
     mWriteFBO->CreateRenderPass(clearColorEnabled, clearDepthEnabled, clearStencilEnabled,
                                 stateFramebufferOperations->IsColorWriteEnabled(),
                                 stateFramebufferOperations->IsDepthWriteEnabled(),
                                 stateFramebufferOperations->IsStencilWriteEnabled(),
                                  clearColorValue, clearDepthValue, clearStencilValue,
                                  &mClearRect);
-    mWriteFBO->PrepareVkImage(VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
-    mWriteFBO->PrepareVkImage(VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
 }
 
 void
@@ -65,8 +110,24 @@ Context::BeginRendering(bool clearColorEnabled, bool clearDepthEnabled, bool cle
     FUN_ENTRY(GL_LOG_DEBUG);
 
     PrepareRenderPass(clearColorEnabled, clearDepthEnabled, clearStencilEnabled);
-    mCommandBufferManager->BeginVkDrawCommandBuffer();
+    BeginDrawCommandBuffer();
     mWriteFBO->BeginVkRenderPass();
+    mDrawRecorder.Reset();
+}
+
+void
+Context::EndRenderPass(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the attachments are left in the layouts Finish would move them to by the final layouts of the pass
+    if(!mWriteFBO->EndVkRenderPass()) {
+        return;
+    }
+
+    ++mChainedRenderPasses;
+    mWriteFBO->SetStateIdle();
+    mDrawRecorder.Reset();
 }
 
 void
@@ -85,12 +146,15 @@ Context::Clear(GLbitfield mask)
 
     SetClearRect();
 
-    // color masks are executed implicitly through a screen-space pass (i.e., need an explicit VkPipeline object)
-    bool performCustomClear = (mStateManager.GetFramebufferOperationsState()->ColorMaskActive() && clearColorEnabled);
+    StateFramebufferOperations *stateFramebufferOperations = mStateManager.GetFramebufferOperationsState();
+
+    // color and stencil masks are executed implicitly through a screen-space pass (i.e., need an explicit VkPipeline object)
+    bool performCustomClear = (stateFramebufferOperations->ColorMaskActive()   && clearColorEnabled) ||
+                              (stateFramebufferOperations->StencilMaskActive() && clearStencilEnabled);
     if(!performCustomClear) {
         ClearSimple(clearColorEnabled, clearDepthEnabled, clearStencilEnabled);
     } else {
-        ClearWithColorMask(false, clearDepthEnabled, clearStencilEnabled);
+        ClearWithMasks(clearColorEnabled, clearDepthEnabled, clearStencilEnabled);
     }
 }
 
@@ -100,6 +164,9 @@ Context::ClearSimple(bool clearColorEnabled, bool clearDepthEnabled, bool clearS
     FUN_ENTRY(GL_LOG_DEBUG);
 
     if(mWriteFBO->IsInDrawState()) {
+        if(ClearInRenderPass(clearColorEnabled, clearDepthEnabled, clearStencilEnabled)) {
+            return;
+        }
         Finish();
     }
     mWriteFBO->SetStateClear();
@@ -107,8 +174,46 @@ Context::ClearSimple(bool clearColorEnabled, bool clearDepthEnabled, bool clearS
     BeginRendering(clearColorEnabled, clearDepthEnabled, clearStencilEnabled);
 }
 
+bool
+Context::ClearInRenderPass(bool clearColorEnabled, bool clearDepthEnabled, bool clearStencilEnabled)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    StateFramebufferOperations *stateFramebufferOperations = mStateManager.GetFramebufferOperationsState();
+
+    // the clear area must lie within the render area the active render pass was started with
+    if(!mWriteFBO->IsVkRenderPassClearable(&mClearRect)) {
+        return false;
+    }
+
+    // write-disabled attachments are left untouched, as in the load op path
+    clearColorEnabled   = clearColorEnabled   && stateFramebufferOperations->IsColorWriteEnabled();
+    clearDepthEnabled   = clearDepthEnabled   && stateFramebufferOperations->IsDepthWriteEnabled();
+    clearStencilEnabled = clearStencilEnabled && stateFramebufferOperations->IsStencilWriteEnabled();
+
+    if(!clearColorEnabled && !clearDepthEnabled && !clearStencilEnabled) {
+        return true;
+    }
+
+    GLfloat  clearColorValue[4];
+    GLfloat  clearDepthValue;
+    uint32_t clearStencilValue;
+    GetClearValues(clearColorEnabled, clearDepthEnabled, clearStencilEnabled,
+                   clearColorValue, &clearDepthValue, &clearStencilValue);
+
+    VkCommandBuffer activeCmdBuffer = mCommandBufferManager->GetActiveCommandBuffer();
+    VkCommandBuffer *drawCmdBuffer  = BeginDrawCommands(&activeCmdBuffer);
+
+    mWriteFBO->ClearVkAttachments(drawCmdBuffer, clearColorEnabled, clearDepthEnabled, clearStencilEnabled,
+                                  clearColorValue, clearDepthValue, clearStencilValue, &mClearRect);
+
+    EndDrawCommands(&activeCmdBuffer, drawCmdBuffer);
+
+    return true;
+}
+
 void
-Context::ClearWithColorMask(bool clearColorEnabled, bool clearDepthEnabled, bool clearStencilEnabled)
+Context::ClearWithMasks(bool clearColorEnabled, bool clearDepthEnabled, bool clearStencilEnabled)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
@@ -122,63 +227,94 @@ Context::ClearWithColorMask(bool clearColorEnabled, bool clearDepthEnabled, bool
         return;
     }
 
-    if(mWriteFBO->IsInClearState()) {
-        Finish();
-    }
+    StateFramebufferOperations *stateFramebufferOperations = mStateManager.GetFramebufferOperationsState();
 
-    PrepareRenderPass(clearColorEnabled, clearDepthEnabled, clearStencilEnabled);
+    // the masked attachments are written by the quad, the rest are cleared as usual
+    bool maskedColor   = clearColorEnabled   && stateFramebufferOperations->ColorMaskActive();
+    bool maskedStencil = clearStencilEnabled && stateFramebufferOperations->StencilMaskActive();
 
-    StateFramebufferOperations *stateFramebufferOperations = mStateManager.GetFramebufferOperationsState();
+    // depth/stencil are cleared and the quad is drawn within the active
+    // render pass when possible, otherwise a new render pass is started
+    bool inRenderPass = mWriteFBO->IsInDrawState() &&
+                        ClearInRenderPass(clearColorEnabled && !maskedColor, clearDepthEnabled, clearStencilEnabled && !maskedStencil);
+    if(!inRenderPass) {
+        if(mWriteFBO->IsInDrawState()) {
+            Finish();
+        }
 
-    // clearColor is passed as a uniform and masked through VkPipelineColorBlendAttachmentState
-    GLfloat clearColorValue[4] = {0.0f,0.0f,0.0f,0.0f};
-    stateFramebufferOperations->GetClearColor(clearColorValue);
-    if(mWriteFBO->GetColorAttachmentTexture() && mWriteFBO->GetColorAttachmentTexture()->GetFormat() == GL_RGB) {
-        clearColorValue[3] = 1.0f;
+        // transient attachments keep nothing across render passes,
+        // so they are cleared with the masked value instead
+        if(maskedStencil && mWriteFBO->IsDepthStencilTransient()) {
+            maskedStencil = false;
+            if(!maskedColor) {
+                ClearSimple(clearColorEnabled, clearDepthEnabled, clearStencilEnabled);
+                return;
+            }
+        }
+        PrepareRenderPass(clearColorEnabled && !maskedColor, clearDepthEnabled, clearStencilEnabled && !maskedStencil);
     }
 
-    mStateManager.GetFramebufferOperationsState()->GetClearColor(clearColorValue);
+    VkColorComponentFlags colorWriteMask = 0;
+    if(maskedColor) {
+        // clearColor is passed as a uniform and masked through VkPipelineColorBlendAttachmentState
+        GLfloat clearColorValue[4] = {0.0f,0.0f,0.0f,0.0f};
+        stateFramebufferOperations->GetClearColor(clearColorValue);
+        if(mWriteFBO->GetColorAttachmentTexture() && mWriteFBO->GetColorAttachmentTexture()->GetFormat() == GL_RGB) {
+            clearColorValue[3] = 1.0f;
+        }
 
-    mScreenSpacePass->UpdateUniformBufferColor(clearColorValue[0], clearColorValue[1], clearColorValue[2], clearColorValue[3]);
+        mStateManager.GetFramebufferOperationsState()->GetClearColor(clearColorValue);
 
-    vulkanAPI::Pipeline* pipeline = mScreenSpacePass->GetPipeline();
+        mScreenSpacePass->UpdateUniformBufferColor(clearColorValue[0], clearColorValue[1], clearColorValue[2], clearColorValue[3]);
 
-    if(mWriteFBO->GetColorAttachmentTexture() && mWriteFBO->GetColorAttachmentTexture()->GetFormat() == GL_RGB) {
-        GLboolean colormask[4];
-        mStateManager.GetFramebufferOperationsState()->GetColorMask(colormask);
-        GLubyte colorMaskPackRGB = GlColorMaskPack(colormask[0], colormask[1], colormask[2], GL_FALSE);
-        pipeline->SetColorBlendAttachmentWriteMask(GLColorMaskToVkColorComponentFlags(colorMaskPackRGB));
-    } else {
-        pipeline->SetColorBlendAttachmentWriteMask(GLColorMaskToVkColorComponentFlags(stateFramebufferOperations->GetColorMask()));
+        if(mWriteFBO->GetColorAttachmentTexture() && mWriteFBO->GetColorAttachmentTexture()->GetFormat() == GL_RGB) {
+            GLboolean colormask[4];
+            mStateManager.GetFramebufferOperationsState()->GetColorMask(colormask);
+            GLubyte colorMaskPackRGB = GlColorMaskPack(colormask[0], colormask[1], colormask[2], GL_FALSE);
+            colorWriteMask = GLColorMaskToVkColorComponentFlags(colorMaskPackRGB);
+        } else {
+            colorWriteMask = GLColorMaskToVkColorComponentFlags(stateFramebufferOperations->GetColorMask());
+        }
     }
 
-    pipeline->SetUpdatePipeline(true);
+    // the stencil value is replaced on the bits of the front write mask, as glClear does
+    uint32_t stencilWriteMask = maskedStencil ? stateFramebufferOperations->GetStencilMaskFront() : 0u;
+    uint32_t stencilReference = static_cast<uint32_t>(stateFramebufferOperations->GetClearStencil());
+
+    vulkanAPI::Pipeline* pipeline = mScreenSpacePass->GetPipeline();
+
     pipeline->SetViewport(mClearRect.x, mClearRect.y, mClearRect.width, mClearRect.height);
     pipeline->SetScissor(mClearRect.x, mClearRect.y, mClearRect.width, mClearRect.height);
 
-    if(!pipeline->Create(mWriteFBO->GetVkRenderPass())) {
+    if(!mScreenSpacePass->PreparePipeline(colorWriteMask, stencilWriteMask, stencilReference, mWriteFBO->GetRenderPass())) {
         Finish();
         return;
     }
 
-    mCommandBufferManager->BeginVkDrawCommandBuffer();
-    mWriteFBO->BeginVkRenderPass();
+    if(!inRenderPass) {
+        BeginDrawCommandBuffer();
+        mWriteFBO->BeginVkRenderPass();
+    }
 
-    const VkCommandBuffer *secondaryCmdBuffer = mCommandBufferManager->AllocateVkSecondaryCmdBuffers(1);
-    mCommandBufferManager->BeginVkSecondaryCommandBuffer(secondaryCmdBuffer, *mWriteFBO->GetVkRenderPass(), *mWriteFBO->GetActiveVkFramebuffer());
+    // the quad of the clear is not counted by the active occlusion query
+    mCommandBufferManager->EndOcclusionQuery();
 
-    mScreenSpacePass->BindPipeline(secondaryCmdBuffer);
-    mScreenSpacePass->BindUniformDescriptors(secondaryCmdBuffer);
-    mScreenSpacePass->BindVertexBuffers(secondaryCmdBuffer);
+    VkCommandBuffer activeCmdBuffer = mCommandBufferManager->GetActiveCommandBuffer();
+    VkCommandBuffer *drawCmdBuffer  = BeginDrawCommands(&activeCmdBuffer);
 
-    pipeline->UpdateDynamicState(secondaryCmdBuffer, mStateManager.GetRasterizationState()->GetLineWidth());
+    mScreenSpacePass->BindPipeline(drawCmdBuffer);
+    mScreenSpacePass->BindUniformDescriptors(drawCmdBuffer);
+    mScreenSpacePass->BindVertexBuffers(drawCmdBuffer);
 
-    mScreenSpacePass->Draw(secondaryCmdBuffer);
-    mCommandBufferManager->EndVkSecondaryCommandBuffer(secondaryCmdBuffer);
+    pipeline->UpdateDynamicState(drawCmdBuffer, mStateManager.GetRasterizationState()->GetLineWidth());
 
-    VkCommandBuffer activeCmdBuffer = mCommandBufferManager->GetActiveCommandBuffer();
-    vkCmdExecuteCommands(activeCmdBuffer, 1, secondaryCmdBuffer);
-    Finish();
+    mScreenSpacePass->Draw(drawCmdBuffer);
+
+    EndDrawCommands(&activeCmdBuffer, drawCmdBuffer);
+    mDrawRecorder.Reset();
+
+    // the render pass is kept open so that subsequent draws are recorded in it
+    mWriteFBO->SetStateDraw();
 }
 
 void
@@ -189,122 +325,354 @@ Context::UpdateViewportState(vulkanAPI::Pipeline* pipeline)
     StateFragmentOperations* stateFragmentOperations = mStateManager.GetFragmentOperationsState();
     StateViewportTransformation* stateViewportTransformation = mStateManager.GetViewportTransformationState();
 
+    // the damage region of the frame bounds the scissor, and changes with each frame
+    Rect damageRect;
+    bool damaged = GetDamageRect(&damageRect);
+    if(damaged || mScissorDamaged) {
+        pipeline->SetUpdateViewportState(true);
+    }
+    mScissorDamaged = damaged;
+
     if(pipeline->GetUpdateViewportState()) {
         Rect viewportRect = stateViewportTransformation->GetViewportRect();
 
-        pipeline->ComputeViewport(mWriteFBO->GetWidth(), mWriteFBO->GetHeight(),
+        pipeline->ComputeViewport(mWriteFBO->GetWindowWidth(), mWriteFBO->GetWindowHeight(),
                                   viewportRect.x, viewportRect.y,
                                   viewportRect.width, viewportRect.height,
-                                  stateViewportTransformation->GetMinDepthRange(), stateViewportTransformation->GetMaxDepthRange());
+                                  stateViewportTransformation->GetMinDepthRange(), stateViewportTransformation->GetMaxDepthRange(),
+                                  mWriteFBO->IsOriginFlipped(), mWriteFBO->GetPreTransform());
 
         Rect scissorRect = stateFragmentOperations->GetScissorTestEnabled() ?
                     stateFragmentOperations->GetScissorRect() : viewportRect;
+        if(damaged) {
+            const int x0 = std::max(scissorRect.x, damageRect.x);
+            const int y0 = std::max(scissorRect.y, damageRect.y);
+            const int x1 = std::min(scissorRect.x + scissorRect.width,  damageRect.x + damageRect.width);
+            const int y1 = std::min(scissorRect.y + scissorRect.height, damageRect.y + damageRect.height);
+            scissorRect = Rect(x0, y0, std::max(x1 - x0, 0), std::max(y1 - y0, 0));
+        }
 
-        pipeline->ComputeScissor(mWriteFBO->GetWidth(), mWriteFBO->GetHeight(),
+        pipeline->ComputeScissor(mWriteFBO->GetWindowWidth(), mWriteFBO->GetWindowHeight(),
                                  scissorRect.x, scissorRect.y,
-                                 scissorRect.width, scissorRect.height);
+                                 scissorRect.width, scissorRect.height,
+                                 mWriteFBO->IsOriginFlipped(), mWriteFBO->GetPreTransform());
+
+        // rendering without the flip mirrors the winding of the primitives
+        VkFrontFace frontFace = GetVkFrontFace();
+        if(pipeline->GetRasterizationFrontFace() != frontFace) {
+            pipeline->SetRasterizationFrontFace(frontFace);
+        }
        pipeline->SetUpdateViewportState(false);
     }
 }
 
 void
-Context::PushGeometry(uint32_t vertCount, uint32_t firstVertex, bool indexed, GLenum type, const void *indices)
+Context::PushGeometry(uint32_t vertCount, uint32_t firstVertex, uint32_t instanceCount, bool indexed, GLenum type, const void *indices,
+                      const GLuint *indexRange)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    SetClearRect();
+    PushGeometry(1, &vertCount, &firstVertex, instanceCount, indexed, type, &indices, indexRange);
+}
 
-    if(mWriteFBO->IsInClearState()) {
-        mWriteFBO->SetStateClearDraw();
+/// what is left to record of one of the draws of PushGeometry once its data is in place
+typedef struct geometryDraw_t {
+    uint32_t                                    vertCount;
+    uint32_t                                    firstVertex;
+    VkBuffer                                    indexBuffer;
+    uint32_t                                    indexOffset;
+} geometryDraw_t;
 
-    } else if(mWriteFBO->IsInIdleState()) {
-        mWriteFBO->SetStateDraw();
-        BeginRendering(false,false,false);
+static uint32_t
+VkIndexTypeSize(VkIndexType type)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    switch(type) {
+#ifdef VK_EXT_index_type_uint8
+    case VK_INDEX_TYPE_UINT8_EXT:   return sizeof(GLubyte);
+#endif // VK_EXT_index_type_uint8
+    case VK_INDEX_TYPE_UINT32:      return sizeof(GLuint);
+    default:                        return sizeof(GLushort);
+    }
+}
 
-    } else if(mWriteFBO->IsInClearDrawState()) {
-        mWriteFBO->SetStateDraw();
+void
+Context::PushGeometry(uint32_t drawCount, const uint32_t *vertCounts, const uint32_t *firstVertices, uint32_t instanceCount,
+                      bool indexed, GLenum type, const void *const *indices, const GLuint *indexRange)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+    GLOVE_PROFILE_ZONE("Context::PushGeometry");
+
+    ShaderProgram *program = mStateManager.GetActiveShaderProgram();
+
+    // the first draw that reads the color attachment switches the FBO to the passes with the input attachment
+    if(program->UsesFramebufferFetch() && !mWriteFBO->IsFramebufferFetchEnabled()) {
+        if(!mWriteFBO->IsFramebufferFetchSupported() || mCapturedBundle) {
+            RecordError(GL_INVALID_OPERATION);
+            return;
+        }
+        if(mWriteFBO->IsInDrawState()) {
+            EndRenderPass();
+        }
+        mWriteFBO->SetFramebufferFetch(true);
+        mPipeline->SetUpdatePipeline(true);
     }
 
-    //If the primitives are rendered with GL_LINE_LOOP we have to increment the vertCount.
-    //TODO: In future this functionality may be better to stay hidden.
-    if(mStateManager.GetInputAssemblyState()->GetPrimitiveMode() == GL_LINE_LOOP) {
-        mIsModeLineLoop = true;
-        ++vertCount;
+    // the draws of a command bundle are recorded for the render passes it was begun for, and none is started for them
+    if(mCapturedBundle) {
+        if(!(GetCommandBundleTarget() == mCapturedBundle->GetTarget())) {
+            RecordError(GL_INVALID_OPERATION);
+            return;
+        }
     } else {
-        mIsModeLineLoop = false;
+        SetClearRect();
+
+        if(mWriteFBO->IsInClearState()) {
+            mWriteFBO->SetStateClearDraw();
+
+        } else if(mWriteFBO->IsInIdleState()) {
+            mWriteFBO->SetStateDraw();
+            BeginRendering(false,false,false);
+
+        } else if(mWriteFBO->IsInClearDrawState()) {
+            mWriteFBO->SetStateDraw();
+        }
+    }
+
+    //If the primitives are rendered with GL_LINE_LOOP we have to increment the vertCount of every draw.
+    //TODO: In future this functionality may be better to stay hidden.
+    mIsModeLineLoop = mStateManager.GetInputAssemblyState()->GetPrimitiveMode() == GL_LINE_LOOP;
+
+    LinearAllocatorScope scope(&mFrameArena);
+    geometryDraw_t  singleDraw;
+    geometryDraw_t *draws = drawCount > 1 ? mFrameArena.Allocate<geometryDraw_t>(drawCount) : &singleDraw;
+    if(!draws) {
+        return;
+    }
+
+    // the indices of every draw are in place before the vertex data, which
+    // is then streamed once for the range that all the draws read
+    uint32_t activeDraws = 0;
+    uint32_t maxIndex    = 0;
+    uint32_t firstRead   = UINT32_MAX;
+    uint32_t endRead     = 0;
+    for(uint32_t i = 0; i < drawCount; ++i) {
+        if(!vertCounts[i]) {
+            continue;
+        }
+
+        geometryDraw_t *draw = &draws[activeDraws];
+        draw->vertCount   = mIsModeLineLoop ? vertCounts[i] + 1 : vertCounts[i];
+        draw->firstVertex = indexed ? 0 : firstVertices[i];
+        draw->indexBuffer = VK_NULL_HANDLE;
+        draw->indexOffset = 0;
+
+        if(indexed) {
+            uint32_t drawMaxIndex = 0;
+            UpdateIndices(&draw->indexOffset, &drawMaxIndex, draw->vertCount, type, indices[i],
+                          mStateManager.GetActiveObjectsState()->GetActiveBufferObject(GL_ELEMENT_ARRAY_BUFFER), indexRange != nullptr);
+            draw->indexBuffer = program->GetActiveIndexVkBuffer();
+            maxIndex          = std::max(maxIndex, drawMaxIndex);
+        } else {
+            // the closing vertex of a line loop is not part of the vertex data
+            firstRead = std::min(firstRead, firstVertices[i]);
+            endRead   = std::max(endRead, firstVertices[i] + vertCounts[i]);
+        }
+        ++activeDraws;
     }
 
-    uint32_t indexOffset = 0;
-    uint32_t maxIndex = 0;
-    if(indexed) {
-        UpdateIndices(&indexOffset, &maxIndex, vertCount, type, indices, mStateManager.GetActiveObjectsState()->GetActiveBufferObject(GL_ELEMENT_ARRAY_BUFFER));
+    if(!activeDraws) {
+        return;
     }
 
-    UpdateVertexAttributes(indexed ? maxIndex + 1 : vertCount, firstVertex);
+    // the client arrays of a draw with a known index range are streamed from its first vertex on
+    if(indexed && indexRange) {
+        UpdateVertexAttributes(indexRange[1] - indexRange[0] + 1, indexRange[0], instanceCount);
+    } else if(indexed) {
+        UpdateVertexAttributes(maxIndex + 1, 0, instanceCount);
+    } else {
+        UpdateVertexAttributes(endRead - firstRead, firstRead, instanceCount);
+    }
 
+    // RGB attachments are stored with an alpha channel, which is kept at 1 by leaving it out of the write
+    // mask. The mask of the attachment stays in the pipeline state, so that it is only rewritten, and the
+    // pipeline looked up again, when the kind of attachment or the color mask of the application changes
+    GLubyte colorMask = mStateManager.GetFramebufferOperationsState()->GetColorMask();
     if(mWriteFBO->GetColorAttachmentTexture() && mWriteFBO->GetColorAttachmentTexture()->GetFormat() == GL_RGB) {
         GLboolean colormask[4];
         mStateManager.GetFramebufferOperationsState()->GetColorMask(colormask);
-        GLubyte colorMaskPackRGB = GlColorMaskPack(colormask[0], colormask[1], colormask[2], GL_FALSE);
-        mPipeline->SetColorBlendAttachmentWriteMask(GLColorMaskToVkColorComponentFlags(colorMaskPackRGB));
+        colorMask = GlColorMaskPack(colormask[0], colormask[1], colormask[2], GL_FALSE);
     }
+    mPipeline->SetColorBlendAttachmentWriteMask(GLColorMaskToVkColorComponentFlags(colorMask));
 
-    if(SetPipelineProgramShaderStages(mStateManager.GetActiveShaderProgram())) {
-        if(!mPipeline->Create(mWriteFBO->GetVkRenderPass())) {
+    if(SetPipelineProgramShaderStages(program)) {
+        if(mPipeline->GetUpdatePipelineState()) {
+            ++mStatistics.stateChanges;
+        }
+        if(!mPipeline->Create(mWriteFBO->GetRenderPass())) {
             Finish();
             return;
         }
     }
 
-    if(mWriteFBO->GetColorAttachmentTexture() && mWriteFBO->GetColorAttachmentTexture()->GetFormat() == GL_RGB) {
-        mPipeline->SetColorBlendAttachmentWriteMask(GLColorMaskToVkColorComponentFlags(mStateManager.GetFramebufferOperationsState()->GetColorMask()));
-    }
+    VkCommandBuffer activeCmdBuffer = mCommandBufferManager->GetActiveCommandBuffer();
+    VkCommandBuffer *drawCmdBuffer  = mCapturedBundle ? mCapturedBundle->GetVkCommandBuffer() : BeginDrawCommands(&activeCmdBuffer);
 
-    VkCommandBuffer *secondaryCmdBuffer = mCommandBufferManager->AllocateVkSecondaryCmdBuffers(1);
-    mCommandBufferManager->BeginVkSecondaryCommandBuffer(secondaryCmdBuffer, *mWriteFBO->GetVkRenderPass(), *mWriteFBO->GetActiveVkFramebuffer());
+    if(mActiveOcclusionQuery && !mCapturedBundle) {
+        BeginOcclusionQuerySegment(drawCmdBuffer);
+    }
 
-    mPipeline->Bind(secondaryCmdBuffer);
-    BindUniformDescriptors(secondaryCmdBuffer);
-    BindVertexBuffers(secondaryCmdBuffer);
-    if(indexed) {
-        BindIndexBuffer(secondaryCmdBuffer, indexOffset, GlToVkIndexType(type));
+    // gl_LastFragData sees the fragments of the earlier draws, through the dependency of the subpass on itself
+    if(program->UsesFramebufferFetch()) {
+        VkMemoryBarrier barrier;
+        barrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.pNext         = nullptr;
+        barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+        mVkContext->vkDispatch.vkCmdPipelineBarrier(*drawCmdBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                             VK_DEPENDENCY_BY_REGION_BIT, 1, &barrier, 0, nullptr, 0, nullptr);
     }
+
+    // the state is bound once for all the draws, only the index buffer may change between them
+    mPipeline->Bind(&mDrawRecorder, drawCmdBuffer);
+    BindUniformDescriptors(drawCmdBuffer);
+    BindVertexBuffers(drawCmdBuffer);
     UpdateViewportState(mPipeline);
 
-    mPipeline->UpdateDynamicState(secondaryCmdBuffer, mStateManager.GetRasterizationState()->GetLineWidth());
+    mPipeline->UpdateDynamicState(&mDrawRecorder, drawCmdBuffer, mStateManager.GetRasterizationState()->GetLineWidth());
 
-    DrawGeometry(secondaryCmdBuffer, indexed, firstVertex, vertCount);
-    mCommandBufferManager->EndVkSecondaryCommandBuffer(secondaryCmdBuffer);
+    const VkIndexType indexType = program->GetActiveIndexVkType();
+    const uint32_t    indexSize = VkIndexTypeSize(indexType);
+    VkBuffer          boundIndexBuffer = VK_NULL_HANDLE;
+    uint32_t          boundIndexOffset = 0;
+    for(uint32_t i = 0; i < activeDraws; ++i) {
+        geometryDraw_t *draw = &draws[i];
+        bool drawIndexed = indexed;
+        uint32_t firstIndex = 0;
 
-    VkCommandBuffer activeCmdBuffer = mCommandBufferManager->GetActiveCommandBuffer();
-    vkCmdExecuteCommands(activeCmdBuffer, 1, secondaryCmdBuffer);
+        if(indexed) {
+            if(draw->indexBuffer == VK_NULL_HANDLE) {
+                continue;
+            }
+            // draws further into the buffer that is already bound start at an index of it instead of rebinding it
+            if(draw->indexBuffer == boundIndexBuffer && draw->indexOffset >= boundIndexOffset &&
+               !((draw->indexOffset - boundIndexOffset) % indexSize)) {
+                firstIndex = (draw->indexOffset - boundIndexOffset) / indexSize;
+            } else {
+                BindIndexBuffer(drawCmdBuffer, draw->indexBuffer, draw->indexOffset, indexType);
+                boundIndexBuffer = draw->indexBuffer;
+                boundIndexOffset = draw->indexOffset;
+            }
+        } else if(mIsModeLineLoop) {
+            // the closing segment of a line loop is drawn through a cached
+            // index buffer rather than by appending the first vertex to the data
+            BufferObject *lineLoopIbo = GetLineLoopIndexBuffer(draw->vertCount);
+            if(lineLoopIbo) {
+                BindIndexBuffer(drawCmdBuffer, lineLoopIbo->GetVkBuffer(), 0, VK_INDEX_TYPE_UINT32);
+                drawIndexed = true;
+            } else {
+                --draw->vertCount;
+            }
+        }
+
+        DrawGeometry(drawCmdBuffer, drawIndexed, draw->firstVertex, draw->vertCount, instanceCount, firstIndex);
+    }
+
+    // the bundle is not executed again once any of the objects its draws read is retired
+    if(mCapturedBundle) {
+        mCapturedBundle->Reference(vulkanAPI::CommandBundle::GetHandleKey(mPipeline->GetVkPipeline()));
+        program->ReferenceVkResources(mCapturedBundle);
+        for(uint32_t i = 0; i < program->GetActiveVertexVkBuffersCount(); ++i) {
+            mCapturedBundle->Reference(vulkanAPI::CommandBundle::GetHandleKey(program->GetActiveVertexVkBuffers()[i]));
+        }
+        for(uint32_t i = 0; i < activeDraws; ++i) {
+            mCapturedBundle->Reference(vulkanAPI::CommandBundle::GetHandleKey(draws[i].indexBuffer));
+        }
+        if(mIsModeLineLoop && !indexed) {
+            for(const auto &lineLoopIbo : mLineLoopIndexBuffers) {
+                mCapturedBundle->Reference(vulkanAPI::CommandBundle::GetHandleKey(lineLoopIbo.second->GetVkBuffer()));
+            }
+        }
+        return;
+    }
+
+    // an occlusion query begun in a secondary command buffer must end in it
+    if(mActiveOcclusionQuery && drawCmdBuffer != &activeCmdBuffer) {
+        mCommandBufferManager->EndOcclusionQuery();
+    }
+
+    EndDrawCommands(&activeCmdBuffer, drawCmdBuffer);
+
+    // the draw recorded above keeps reading the storage it was bound with, as a promoted buffer retires it
+    PromoteStaticBuffers();
+}
+
+VkCommandBuffer *
+Context::BeginDrawCommands(VkCommandBuffer *activeCmdBuffer)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // by default draws are recorded inline in the render pass of the primary command buffer,
+    // unless the pass executes command bundles
+    if(!mWriteFBO->IsVkRenderPassSecondary()) {
+        return activeCmdBuffer;
+    }
+
+    VkCommandBuffer *secondaryCmdBuffer = mCommandBufferManager->AllocateVkSecondaryCmdBuffers(1);
+    mCommandBufferManager->BeginVkSecondaryCommandBuffer(secondaryCmdBuffer, *mWriteFBO->GetVkRenderPass(), *mWriteFBO->GetActiveVkFramebuffer());
+
+    // state bound in one secondary command buffer is not inherited by the next one
+    mDrawRecorder.Reset();
+
+    return secondaryCmdBuffer;
 }
 
 void
-Context::UpdateIndices(uint32_t* offset, uint32_t* maxIndex, uint32_t indexCount, GLenum type, const void* indices, BufferObject* ibo)
+Context::EndDrawCommands(VkCommandBuffer *activeCmdBuffer, VkCommandBuffer *drawCmdBuffer)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(mPipeline->GetUpdateIndexBuffer() || indices) {
-        mStateManager.GetActiveShaderProgram()->PrepareIndexBufferObject(offset, maxIndex, indexCount, type, indices, ibo);
-        mPipeline->SetUpdateIndexBuffer(false);
+    if(drawCmdBuffer == activeCmdBuffer) {
+        return;
     }
+
+    mCommandBufferManager->EndVkSecondaryCommandBuffer(drawCmdBuffer);
+    mVkContext->vkDispatch.vkCmdExecuteCommands(*activeCmdBuffer, 1, drawCmdBuffer);
 }
 
 void
-Context::UpdateVertexAttributes(uint32_t vertCount, uint32_t firstVertex)
+Context::UpdateIndices(uint32_t* offset, uint32_t* maxIndex, uint32_t indexCount, GLenum type, const void* indices, BufferObject* ibo,
+                       bool indexRangeKnown)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the maximum index only sizes the uploads of client-side vertex data, so it is not needed
+    // when every attribute is sourced from a buffer object or the application gave the range
+    ShaderProgram *program = mStateManager.GetActiveShaderProgram();
+    bool needsMaxIndex = !indexRangeKnown && program->HasClientVertexAttribs(mResourceManager->GetGenericVertexAttributes());
+
+    // the offset and maximum index are returned for every draw, as the range
+    // of a static index buffer is cached rather than scanned again
+    program->PrepareIndexBufferObject(offset, maxIndex, indexCount, type, indices, ibo, GetStreamRing(), needsMaxIndex);
+    mPipeline->SetUpdateIndexBuffer(false);
+}
+
+void
+Context::UpdateVertexAttributes(uint32_t vertCount, uint32_t firstVertex, uint32_t instanceCount)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
     /// A glVertexAttrib related function has been called. Check to see if mVkPipelineVertexInput needs to be updated.
     /// If this is true then VkPipeline needs to be updated too.
     /// Otherwise only the buffer that will be bound with vkCmdBindVertexBuffers need to be updated
-    if(mStateManager.GetActiveShaderProgram()->PrepareVertexAttribBufferObjects(vertCount, firstVertex,
-                                                                                mResourceManager->GetGenericVertexAttributes(),
+    if(mStateManager.GetActiveShaderProgram()->PrepareVertexAttribBufferObjects(vertCount, firstVertex, instanceCount,
+                                                                                mResourceManager->GetActiveVertexArray(),
+                                                                                GetStreamRing(),
                                                                                 mPipeline->GetUpdateVertexAttribVBOs())) {
         mPipeline->SetUpdatePipeline(true);
-        mPipeline->SetUpdateVertexAttribVBOs(false);
     }
+    mPipeline->SetUpdateVertexAttribVBOs(false);
 }
 
 void
@@ -312,11 +680,28 @@ Context::BindUniformDescriptors(VkCommandBuffer *CmdBuffer)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(*mStateManager.GetActiveShaderProgram()->GetVkDescSet()) {
-        mStateManager.GetActiveShaderProgram()->UpdateBuiltInUniformData(mStateManager.GetViewportTransformationState()->GetMinDepthRange(),
-                                                                         mStateManager.GetViewportTransformationState()->GetMaxDepthRange());
-        mStateManager.GetActiveShaderProgram()->UpdateDescriptorSet();
-        vkCmdBindDescriptorSets(*CmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mStateManager.GetActiveShaderProgram()->GetVkPipelineLayout(), 0, 1, mStateManager.GetActiveShaderProgram()->GetVkDescSet(), 0, nullptr);
+    ShaderProgram *program = mStateManager.GetActiveShaderProgram();
+    if(program->UsesFramebufferFetch()) {
+        program->SetFramebufferFetchView(mWriteFBO->GetColorAttachmentTexture()->GetVkImageView());
+    }
+    if(program->GetVkDescSetBindingCount() || program->GetPushConstantSize()) {
+        program->UpdateBuiltInUniformData(mStateManager.GetViewportTransformationState()->GetMinDepthRange(),
+                                          mStateManager.GetViewportTransformationState()->GetMaxDepthRange(),
+                                          mStateManager.GetViewportTransformationState()->GetDepthRangeGeneration());
+        program->UpdateDescriptorSet();
+
+        if(program->IsVkPushDescriptors()) {
+            mDrawRecorder.PushDescriptorSet(CmdBuffer, mVkContext, program->GetVkPipelineLayout(),
+                                            program->GetVkDescWriteCount(), program->GetVkDescWrites());
+        } else if(*program->GetVkDescSet()) {
+            mDrawRecorder.BindDescriptorSet(CmdBuffer, program->GetVkPipelineLayout(), *program->GetVkDescSet(),
+                                            program->GetVkDynamicOffsetCount(), program->GetVkDynamicOffsets());
+        }
+
+        if(program->GetPushConstantSize()) {
+            mDrawRecorder.PushConstants(CmdBuffer, program->GetVkPipelineLayout(), program->GetVkPushConstantStages(),
+                                        program->GetPushConstantSize(), program->GetPushConstantData());
+        }
     }
 }
 
@@ -325,33 +710,67 @@ Context::BindVertexBuffers(VkCommandBuffer *CmdBuffer)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(mStateManager.GetActiveShaderProgram()->GetActiveVertexVkBuffersCount()) {
-        VkDeviceSize *offsets = new VkDeviceSize[mStateManager.GetActiveShaderProgram()->GetActiveVertexVkBuffersCount()];
-        memset(offsets, 0, sizeof(VkDeviceSize) * mStateManager.GetActiveShaderProgram()->GetActiveVertexVkBuffersCount());
-        vkCmdBindVertexBuffers(*CmdBuffer, 0, mStateManager.GetActiveShaderProgram()->GetActiveVertexVkBuffersCount(), mStateManager.GetActiveShaderProgram()->GetActiveVertexVkBuffers(), offsets);
-        delete[] offsets;
+    ShaderProgram *program = mStateManager.GetActiveShaderProgram();
+    if(program->GetActiveVertexVkBuffersCount()) {
+        mDrawRecorder.BindVertexBuffers(CmdBuffer, program->GetActiveVertexVkBuffersCount(),
+                                        program->GetActiveVertexVkBuffers(), program->GetActiveVertexVkBufferOffsets());
     }
 }
 
 void
-Context::BindIndexBuffer(VkCommandBuffer *CmdBuffer, uint32_t offset, VkIndexType type)
+Context::BindIndexBuffer(VkCommandBuffer *CmdBuffer, VkBuffer buffer, uint32_t offset, VkIndexType type)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(mStateManager.GetActiveShaderProgram()->GetActiveIndexVkBuffer()) {
-        vkCmdBindIndexBuffer(*CmdBuffer, mStateManager.GetActiveShaderProgram()->GetActiveIndexVkBuffer(), offset, type);
+    if(buffer != VK_NULL_HANDLE) {
+        mDrawRecorder.BindIndexBuffer(CmdBuffer, buffer, offset, type);
     }
 }
 
+BufferObject *
+Context::GetLineLoopIndexBuffer(uint32_t vertCount)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    auto it = mLineLoopIndexBuffers.find(vertCount);
+    if(it != mLineLoopIndexBuffers.end()) {
+        return it->second;
+    }
+
+    if(mLineLoopIndexBuffers.size() >= GLOVE_MAX_LINE_LOOP_INDEX_BUFFERS) {
+        for(auto &iter : mLineLoopIndexBuffers) {
+            mCacheManager->CacheVBO(iter.second);
+        }
+        mLineLoopIndexBuffers.clear();
+    }
+
+    // vertCount already includes the closing vertex, which repeats the first one
+    std::vector<uint32_t> indices(vertCount);
+    for(uint32_t i = 0; i < vertCount - 1; ++i) {
+        indices[i] = i;
+    }
+    indices[vertCount - 1] = 0;
+
+    BufferObject *ibo = new IndexBufferObject(mVkContext);
+    ibo->SetTarget(GL_ELEMENT_ARRAY_BUFFER);
+    if(!ibo->Allocate(vertCount * sizeof(uint32_t), indices.data())) {
+        delete ibo;
+        return nullptr;
+    }
+
+    mLineLoopIndexBuffers[vertCount] = ibo;
+    return ibo;
+}
+
 void
-Context::DrawGeometry(VkCommandBuffer *CmdBuffer, bool indexed, uint32_t firstVertex, uint32_t vertCount)
+Context::DrawGeometry(VkCommandBuffer *CmdBuffer, bool indexed, uint32_t firstVertex, uint32_t vertCount, uint32_t instanceCount, uint32_t firstIndex)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
     if(indexed == false) {
-        vkCmdDraw(*CmdBuffer, vertCount, 1, firstVertex, 0);
+        mDrawRecorder.Draw(CmdBuffer, vertCount, firstVertex, instanceCount);
     } else {
-        vkCmdDrawIndexed(*CmdBuffer, vertCount, 1, 0, 0, 0);
+        mDrawRecorder.DrawIndexed(CmdBuffer, vertCount, firstIndex, firstVertex, instanceCount);
     }
 }
 
@@ -360,26 +779,83 @@ Context::DrawArrays(GLenum mode, GLint first, GLsizei count)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(mode > GL_TRIANGLE_FAN) {
-        RecordError(GL_INVALID_ENUM);
-        return;
+    DrawArraysInstancedEXT(mode, first, count, 1);
+}
+
+void
+Context::DrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    DrawElementsInstancedEXT(mode, count, type, indices, 1);
+}
+
+void
+Context::DrawArraysInstancedEXT(GLenum mode, GLint first, GLsizei count, GLsizei primcount)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the behavior of invalid calls is undefined in a no error context
+    if(!mNoError) {
+        if(mode > GL_TRIANGLE_FAN) {
+            RecordError(GL_INVALID_ENUM);
+            return;
+        }
+
+        if(count < 0 || primcount < 0) {
+            RecordError(GL_INVALID_VALUE);
+            return;
+        }
+
+        if(mWriteFBO->GetStatus() != GL_FRAMEBUFFER_COMPLETE) {
+            RecordError(GL_INVALID_FRAMEBUFFER_OPERATION);
+            return;
+        }
     }
-    
-    if(count < 0) {
-        RecordError(GL_INVALID_VALUE);
+
+    if(mStateManager.GetRasterizationState()->GetCullFace() == GL_FRONT_AND_BACK && IsDrawModeTriangle(mode)) {
         return;
     }
 
-    if(CheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-        RecordError(GL_INVALID_FRAMEBUFFER_OPERATION);
+    if(!mStateManager.GetActiveShaderProgram() || !count || !primcount) {
         return;
     }
 
+    if(mStateManager.GetInputAssemblyState()->UpdatePrimitiveMode(mode)) {
+        mPipeline->SetInputAssemblyTopology(GlPrimitiveTopologyToVkPrimitiveTopology(mStateManager.GetInputAssemblyState()->GetPrimitiveMode()));
+    }
+
+    PushGeometry(count, first, primcount, false, GL_INVALID_ENUM, nullptr);
+}
+
+void
+Context::DrawElementsInstancedEXT(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei primcount,
+                                  const GLuint *indexRange)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!mNoError) {
+        if( (mode > GL_TRIANGLE_FAN)  || !(type == GL_UNSIGNED_BYTE || type == GL_UNSIGNED_SHORT || type == GL_UNSIGNED_INT) ) {
+            RecordError(GL_INVALID_ENUM);
+            return;
+        }
+
+        if(count < 0 || primcount < 0) {
+            RecordError(GL_INVALID_VALUE);
+            return;
+        }
+
+        if(mWriteFBO->GetStatus() != GL_FRAMEBUFFER_COMPLETE) {
+            RecordError(GL_INVALID_FRAMEBUFFER_OPERATION);
+            return;
+        }
+    }
+
     if(mStateManager.GetRasterizationState()->GetCullFace() == GL_FRONT_AND_BACK && IsDrawModeTriangle(mode)) {
         return;
     }
 
-    if(!mStateManager.GetActiveShaderProgram() || !count) {
+    if(!mStateManager.GetActiveShaderProgram() || !count || !primcount) {
         return;
     }
 
@@ -387,34 +863,104 @@ Context::DrawArrays(GLenum mode, GLint first, GLsizei count)
         mPipeline->SetInputAssemblyTopology(GlPrimitiveTopologyToVkPrimitiveTopology(mStateManager.GetInputAssemblyState()->GetPrimitiveMode()));
     }
 
-    PushGeometry(count, first, false, GL_INVALID_ENUM, nullptr);
+    PushGeometry(count, 0, primcount, true, type, indices, indexRange);
 }
 
 void
-Context::DrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+Context::DrawRangeElements(GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, const void *indices)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if( (mode > GL_TRIANGLE_FAN)  || !(type == GL_UNSIGNED_BYTE || type == GL_UNSIGNED_SHORT) ) {
-        RecordError(GL_INVALID_ENUM);
+    if(!mNoError && end < start) {
+        RecordError(GL_INVALID_VALUE);
         return;
     }
 
-    if(count < 0) {
-        RecordError(GL_INVALID_VALUE);
+    // the indices are scanned as for glDrawElements when the range spans every index of the type
+    GLuint indexRange[2] = { start, end };
+    DrawElementsInstancedEXT(mode, count, type, indices, 1, end < start || end == UINT32_MAX ? nullptr : indexRange);
+}
+
+void
+Context::MultiDrawArraysEXT(GLenum mode, const GLint *first, const GLsizei *count, GLsizei primcount)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!mNoError) {
+        if(mode > GL_TRIANGLE_FAN) {
+            RecordError(GL_INVALID_ENUM);
+            return;
+        }
+
+        if(primcount < 0) {
+            RecordError(GL_INVALID_VALUE);
+            return;
+        }
+
+        for(GLsizei i = 0; i < primcount; ++i) {
+            if(count[i] < 0) {
+                RecordError(GL_INVALID_VALUE);
+                return;
+            }
+        }
+
+        if(mWriteFBO->GetStatus() != GL_FRAMEBUFFER_COMPLETE) {
+            RecordError(GL_INVALID_FRAMEBUFFER_OPERATION);
+            return;
+        }
+    }
+
+    if(mStateManager.GetRasterizationState()->GetCullFace() == GL_FRONT_AND_BACK && IsDrawModeTriangle(mode)) {
         return;
     }
 
-    if(CheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-        RecordError(GL_INVALID_FRAMEBUFFER_OPERATION);
+    if(!mStateManager.GetActiveShaderProgram() || !primcount) {
         return;
     }
 
+    if(mStateManager.GetInputAssemblyState()->UpdatePrimitiveMode(mode)) {
+        mPipeline->SetInputAssemblyTopology(GlPrimitiveTopologyToVkPrimitiveTopology(mStateManager.GetInputAssemblyState()->GetPrimitiveMode()));
+    }
+
+    // GLint and GLsizei share the layout of uint32_t, and both are known not to be negative here
+    PushGeometry(static_cast<uint32_t>(primcount), reinterpret_cast<const uint32_t *>(count), reinterpret_cast<const uint32_t *>(first),
+                 1, false, GL_INVALID_ENUM, nullptr);
+}
+
+void
+Context::MultiDrawElementsEXT(GLenum mode, const GLsizei *count, GLenum type, const void *const *indices, GLsizei primcount)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!mNoError) {
+        if( (mode > GL_TRIANGLE_FAN)  || !(type == GL_UNSIGNED_BYTE || type == GL_UNSIGNED_SHORT || type == GL_UNSIGNED_INT) ) {
+            RecordError(GL_INVALID_ENUM);
+            return;
+        }
+
+        if(primcount < 0) {
+            RecordError(GL_INVALID_VALUE);
+            return;
+        }
+
+        for(GLsizei i = 0; i < primcount; ++i) {
+            if(count[i] < 0) {
+                RecordError(GL_INVALID_VALUE);
+                return;
+            }
+        }
+
+        if(mWriteFBO->GetStatus() != GL_FRAMEBUFFER_COMPLETE) {
+            RecordError(GL_INVALID_FRAMEBUFFER_OPERATION);
+            return;
+        }
+    }
+
     if(mStateManager.GetRasterizationState()->GetCullFace() == GL_FRONT_AND_BACK && IsDrawModeTriangle(mode)) {
         return;
     }
 
-    if(!mStateManager.GetActiveShaderProgram() || !count) {
+    if(!mStateManager.GetActiveShaderProgram() || !primcount) {
         return;
     }
 
@@ -422,13 +968,14 @@ Context::DrawElements(GLenum mode, GLsizei count, GLenum type, const void* indic
         mPipeline->SetInputAssemblyTopology(GlPrimitiveTopologyToVkPrimitiveTopology(mStateManager.GetInputAssemblyState()->GetPrimitiveMode()));
     }
 
-    PushGeometry(count, 0, true, type, indices);
+    PushGeometry(static_cast<uint32_t>(primcount), reinterpret_cast<const uint32_t *>(count), nullptr, 1, true, type, indices);
 }
 
 void
 Context::Finish(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
+    GLOVE_PROFILE_ZONE("Context::Finish");
 
     if(!Flush()) {
         return;
@@ -438,8 +985,6 @@ Context::Finish(void)
         return;
     }
 
-    mResourceManager->CleanPurgeList();
-
     if(!mWriteFBO->IsInDeleteState()) {
         if(mWriteFBO == mSystemFBO) {
             if(mWriteFBO->GetSurfaceType() == GLOVE_SURFACE_WINDOW) {
@@ -468,9 +1013,251 @@ Context::Flush(void)
         return false;
     }
 
-    if(mWriteFBO->EndVkRenderPass()) {
+    if(mWriteFBO->EndVkRenderPass() || mChainedRenderPasses) {
         mCommandBufferManager->EndVkDrawCommandBuffer();
-        mCommandBufferManager->SubmitVkDrawCommandBuffer();
+    }
+
+    // also flushes the batched aux commands when nothing has been drawn
+    SubmitDrawCommandBuffer();
+
+    return true;
+}
+
+vulkanAPI::Fence *
+Context::CreateSync(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the sync object covers every command issued so far
+    Flush();
+
+    vulkanAPI::Fence *fence = new vulkanAPI::Fence(mVkContext);
+    if(!fence->Create(false) || !mCommandBufferManager->SubmitVkFence(fence)) {
+        delete fence;
+        return nullptr;
+    }
+
+    return fence;
+}
+
+void
+Context::WaitSync(const vulkanAPI::Fence *fence)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(fence->IsSignaled()) {
+        return;
+    }
+
+    // all contexts submit to the same queue and the commands the fence covers were flushed
+    // when it was created, so a barrier ahead of this context's next submission makes the
+    // device wait for them and their writes visible, without blocking the calling thread
+    mCommandBufferManager->BeginVkAuxCommandBuffer();
+    VkCommandBuffer auxCmdBuffer = mCommandBufferManager->GetAuxCommandBuffer();
+
+    VkMemoryBarrier memoryBarrier;
+    memoryBarrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    memoryBarrier.pNext         = nullptr;
+    memoryBarrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+    memoryBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+    mVkContext->vkDispatch.vkCmdPipelineBarrier(auxCmdBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                         0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+}
+
+bool
+Context::SubmitDrawCommandBuffer(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    {
+        GLOVE_STARTUP_PHASE(STARTUP_PHASE_FIRST_SUBMIT);
+        if(!mCommandBufferManager->SubmitVkDrawCommandBuffer()) {
+            return false;
+        }
+    }
+    mChainedRenderPasses = 0;
+
+    // the slot that is about to be recorded has been waited upon, so the
+    // objects deferred while it was in flight can be safely released
+    uint32_t activeSlot = mCommandBufferManager->GetActiveCommandBufferIndex();
+    mCacheManager->CleanUpSlot(activeSlot);
+    mCacheManager->SetActiveSlot(activeSlot);
+    if(mUniformRing) {
+        mUniformRing->SetActiveFrame(activeSlot);
+    }
+    if(mStreamRing) {
+        mStreamRing->SetActiveFrame(activeSlot);
+    }
+    mDescriptorAllocator->SetActiveFrame(activeSlot);
+    mFrameArena.Reset();
+
+    // the budget is revisited every few frames, as querying it may reach the kernel driver
+    if(mCommandBufferManager->GetLastSubmissionId() % GLOVE_MEMORY_BUDGET_CHECK_INTERVAL == 0 &&
+       mVkContext->vkMemoryAllocator->IsOverBudget()) {
+        TrimMemory();
+    }
+
+    // slots still in flight are released as soon as their submission has
+    // completed, rather than when the ring wraps around to them
+    for(uint32_t slot = 0; slot < GLOVE_MAX_FRAMES_IN_FLIGHT; ++slot) {
+        if(slot != activeSlot && mCommandBufferManager->IsSubmissionComplete(mCommandBufferManager->GetSubmissionId(slot))) {
+            mCacheManager->CleanUpSlot(slot);
+        }
+    }
+
+    return true;
+}
+
+void
+Context::PrepareSwapBuffers(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(mWriteFBO == nullptr) {
+        return;
+    }
+
+    AcquireSurfaceImage();
+
+    // the depth/stencil contents are undefined after a swap, and the next
+    // frame renders to another swapchain image
+    if(mSystemFBO && mSystemFBO->GetSurfaceType() == GLOVE_SURFACE_WINDOW) {
+        mSystemFBO->InvalidateAttachments(false, true, true);
+        mSystemFBO->SetPresented();
+    }
+
+    if(mWriteFBO != mSystemFBO || mWriteFBO->IsInDeleteState() ||
+       mWriteFBO->GetSurfaceType() != GLOVE_SURFACE_WINDOW) {
+        Finish();
+        return;
+    }
+
+    mWriteFBO->EndVkRenderPass();
+
+    // move the presentable image to its final layout within the frame's
+    // command buffer rather than through a blocking aux submission
+    Texture *colorTexture = mWriteFBO->GetColorAttachmentTexture();
+    if(colorTexture && colorTexture->GetVkImageLayout() != VK_IMAGE_LAYOUT_PRESENT_SRC_KHR) {
+        BeginDrawCommandBuffer();
+        mWriteFBO->RecordVkImageLayout(VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+    }
+
+    mCommandBufferManager->EndVkDrawCommandBuffer();
+    SubmitDrawCommandBuffer();
+
+    mWriteFBO->SetStateIdle();
+
+    if(GLOVE_DUMP_DRAW_STATISTICS) {
+        const vulkanAPI::DrawRecorder::Statistics *stats = mDrawRecorder.GetStatistics();
+        GLOVE_PRINT(GL_LOG_INFO, "draws: %u pipeline binds: %u descriptor set binds: %u push constant updates: %u vertex buffer binds: %u index buffer binds: %u dynamic state sets: %u redundant commands skipped: %u",
+                    stats->draws, stats->pipelineBinds, stats->descriptorSetBinds, stats->pushConstantUpdates, stats->vertexBufferBinds,
+                    stats->indexBufferBinds, stats->dynamicStateSets, stats->redundantCommands);
+    }
+    mDrawRecorder.ResetStatistics();
+
+    if(GLOVE_DUMP_PIPELINE_STATISTICS) {
+        const vulkanAPI::Pipeline::Statistics *stats = mPipeline->GetStatistics();
+        if(stats->creates) {
+            GLOVE_PRINT(GL_LOG_INFO, "pipeline lookups: %u hits: %u misses: %u creates: %u driver cache hits: %u create time: %llu us (max %llu us) histogram <1ms: %u <4ms: %u <16ms: %u <64ms: %u >=64ms: %u",
+                        stats->lookups, stats->cacheHits, stats->cacheMisses, stats->creates, stats->driverCacheHits,
+                        static_cast<unsigned long long>(stats->createTimeUs), static_cast<unsigned long long>(stats->maxCreateTimeUs),
+                        stats->createTimeHistogram[0], stats->createTimeHistogram[1], stats->createTimeHistogram[2],
+                        stats->createTimeHistogram[3], stats->createTimeHistogram[4]);
+        }
+        mPipeline->ResetStatistics();
+    }
+
+    DumpFrameStatistics();
+    DumpMemoryReport();
+}
+
+void
+Context::DumpFrameStatistics(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(mStatisticsInterval && ++mStatisticsFrames >= mStatisticsInterval) {
+        mStatisticsFrames = 0;
+
+        const vulkanAPI::CommandBufferManager::Statistics *cmdStats = mCommandBufferManager->GetStatistics();
+        GLOVE_PRINT(GL_LOG_INFO, "frame: state changes: %u pipeline binds: %u pipeline creates: %u descriptor updates: %u "
+                                 "buffer uploads: %u (%llu bytes) texture uploads: %u (%llu bytes) readbacks: %u (%llu bytes) "
+                                 "draw submits: %u aux submits: %u waits: %u (%llu us, max %llu us, %u without blocking) secondary command buffers: %u",
+                    mStatistics.stateChanges, mDrawRecorder.GetStatistics()->pipelineBinds, mPipeline->GetStatistics()->creates,
+                    mStatistics.descriptorUpdates,
+                    mStatistics.bufferUploads, static_cast<unsigned long long>(mStatistics.bufferUploadBytes),
+                    mStatistics.textureUploads, static_cast<unsigned long long>(mStatistics.textureUploadBytes),
+                    mStatistics.readbacks, static_cast<unsigned long long>(mStatistics.readbackBytes),
+                    cmdStats->drawSubmits, cmdStats->auxSubmits, cmdStats->waits,
+                    static_cast<unsigned long long>(cmdStats->waitTimeUs), static_cast<unsigned long long>(cmdStats->maxWaitTimeUs),
+                    cmdStats->spinWaits, cmdStats->secondaryCommandBuffers);
+    }
+
+    mStatistics = Statistics();
+    mCommandBufferManager->ResetStatistics();
+    if(!GLOVE_DUMP_PIPELINE_STATISTICS) {
+        mPipeline->ResetStatistics();
+    }
+}
+
+void
+Context::TrimMemory(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // storage released here goes back to the allocator, which then gives
+    // its empty blocks back to the driver
+    mCacheManager->ReleaseRecycledBuffers();
+
+    {
+        std::lock_guard<std::recursive_mutex> lock(mShareGroup->GetMutex());
+        for(ShaderProgram *program : mResourceManager->GetShaderProgramArray()->GetObjects()) {
+            program->GetPipelineCache()->TrimPipelines(mCacheManager, GLOVE_TRIMMED_PIPELINES_KEPT);
+        }
+    }
+
+    // cold textures give up their top levels, they are restored once sampled again
+    uint32_t demoted = mResourceManager->DemoteColdTextures(mCommandBufferManager->GetLastSubmissionId());
+
+    VkDeviceSize freedSize = mVkContext->vkMemoryAllocator->Trim();
+
+    if(GLOVE_DUMP_MEMORY_STATISTICS) {
+        GLOVE_PRINT(GL_LOG_INFO, "memory trimmed: %llu KB textures demoted: %u %s", static_cast<unsigned long long>(freedSize >> 10), demoted,
+                    GetMemoryReport(false).c_str());
+    }
+}
+
+bool
+Context::DrawCoversFramebuffer(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    StateFragmentOperations     *stateFragmentOperations     = mStateManager.GetFragmentOperationsState();
+    StateFramebufferOperations  *stateFramebufferOperations  = mStateManager.GetFramebufferOperationsState();
+    StateViewportTransformation *stateViewportTransformation = mStateManager.GetViewportTransformationState();
+
+    // blending and partial color masks read the previous contents, as does a damage region for the rest of the surface
+    Rect damageRect;
+    if(stateFragmentOperations->GetBlendingEnabled() || stateFramebufferOperations->ColorMaskActive() ||
+       GetDamageRect(&damageRect)) {
+        return false;
+    }
+
+    const Rect viewport = stateViewportTransformation->GetViewportRect();
+    if(viewport.x > 0 || viewport.y > 0 ||
+       viewport.x + viewport.width  < mWriteFBO->GetWindowWidth() ||
+       viewport.y + viewport.height < mWriteFBO->GetWindowHeight()) {
+        return false;
+    }
+
+    if(stateFragmentOperations->GetScissorTestEnabled()) {
+        const Rect scissor = stateFragmentOperations->GetScissorRect();
+        if(scissor.x > 0 || scissor.y > 0 ||
+           scissor.x + scissor.width  < mWriteFBO->GetWindowWidth() ||
+           scissor.y + scissor.height < mWriteFBO->GetWindowHeight()) {
+            return false;
+        }
     }
 
     return true;
@@ -481,25 +1268,34 @@ Context::SetClearRect(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    mWriteFBO->CheckForUpdatedResources();
+    // follows the size of the attachments, unless no texture has changed since the last draw
+    mWriteFBO->GetStatus();
+
+    // the scissor rect clamped to the FBO is kept by it, for as long as its size and the scissor state stay the same
+    if(mWriteFBO->GetScissorRect(mScissorStateId, &mClearRect)) {
+        ApplyDamageRect();
+        mClearRect = mWriteFBO->GetPreTransformedRect(mClearRect);
+        return;
+    }
 
     int x = 0;
     int y = 0;
-    int w = mWriteFBO->GetWidth();
-    int h = mWriteFBO->GetHeight();
+    int w = mWriteFBO->GetWindowWidth();
+    int h = mWriteFBO->GetWindowHeight();
 
     StateFragmentOperations *stateFragmentOperations = mStateManager.GetFragmentOperationsState();
 
     if(stateFragmentOperations->GetScissorTestEnabled()) {
         x = stateFragmentOperations->GetScissorRectX();
-        y = mWriteFBO->GetHeight() - stateFragmentOperations->GetScissorRectY() - stateFragmentOperations->GetScissorRectHeight();
+        y = mWriteFBO->IsOriginFlipped() ? mWriteFBO->GetWindowHeight() - stateFragmentOperations->GetScissorRectY() - stateFragmentOperations->GetScissorRectHeight() :
+                                           stateFragmentOperations->GetScissorRectY();
 
         if(x < mWriteFBO->GetX()) {
             w = stateFragmentOperations->GetScissorRectWidth() + x;
         } else {
             w = stateFragmentOperations->GetScissorRectWidth();
-            if(w > mWriteFBO->GetWidth() - x) {
-                w = mWriteFBO->GetWidth() - x;
+            if(w > mWriteFBO->GetWindowWidth() - x) {
+                w = mWriteFBO->GetWindowWidth() - x;
             }
         }
 
@@ -507,19 +1303,59 @@ Context::SetClearRect(void)
             h = stateFragmentOperations->GetScissorRectHeight() + y;
         } else {
             h = stateFragmentOperations->GetScissorRectHeight();
-            if(h > mWriteFBO->GetHeight() - y) {
-                h = mWriteFBO->GetHeight() - y;
+            if(h > mWriteFBO->GetWindowHeight() - y) {
+                h = mWriteFBO->GetWindowHeight() - y;
             }
         }
     }
 
-    x = x > mWriteFBO->GetWidth()  ? mWriteFBO->GetX() : x;
-    y = y > mWriteFBO->GetHeight() ? mWriteFBO->GetY() : y;
+    x = x > mWriteFBO->GetWindowWidth()  ? mWriteFBO->GetX() : x;
+    y = y > mWriteFBO->GetWindowHeight() ? mWriteFBO->GetY() : y;
     w = w < mWriteFBO->GetX()      ? mWriteFBO->GetX() : w;
     h = h < mWriteFBO->GetY()      ? mWriteFBO->GetY() : h;
 
     mClearRect.x      = std::max(mWriteFBO->GetX()     , x);
     mClearRect.y      = std::max(mWriteFBO->GetY()     , y);
-    mClearRect.width  = std::min(mWriteFBO->GetWidth() , w);
-    mClearRect.height = std::min(mWriteFBO->GetHeight(), h);
+    mClearRect.width  = std::min(mWriteFBO->GetWindowWidth() , w);
+    mClearRect.height = std::min(mWriteFBO->GetWindowHeight(), h);
+    mWriteFBO->SetScissorRect(mScissorStateId, mClearRect);
+
+    ApplyDamageRect();
+
+    // the render area is in the orientation of the images of the surface
+    mClearRect = mWriteFBO->GetPreTransformedRect(mClearRect);
+}
+
+void
+Context::ApplyDamageRect(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // the render area, and so the clears, are narrowed to the damage region of the frame
+    Rect damageRect;
+    if(GetDamageRect(&damageRect)) {
+        const int damageY = mWriteFBO->IsOriginFlipped() ? mWriteFBO->GetWindowHeight() - damageRect.y - damageRect.height : damageRect.y;
+        const int x0 = std::max(mClearRect.x, damageRect.x);
+        const int y0 = std::max(mClearRect.y, damageY);
+        const int x1 = std::min(mClearRect.x + mClearRect.width,  damageRect.x + damageRect.width);
+        const int y1 = std::min(mClearRect.y + mClearRect.height, damageY + damageRect.height);
+        mClearRect.x      = x0;
+        mClearRect.y      = y0;
+        mClearRect.width  = std::max(x1 - x0, 0);
+        mClearRect.height = std::max(y1 - y0, 0);
+    }
+}
+
+bool
+Context::GetDamageRect(Rect *rect) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // set through eglSetDamageRegionKHR on window surfaces, with a bottom-left origin as the GL window coordinates
+    if(mWriteFBO == nullptr || mWriteFBO != mSystemFBO || mWriteSurface == nullptr || !mWriteSurface->hasDamageRegion) {
+        return false;
+    }
+
+    *rect = Rect(mWriteSurface->damageX, mWriteSurface->damageY, mWriteSurface->damageWidth, mWriteSurface->damageHeight);
+    return true;
 }
@@ -39,7 +39,14 @@ Context::CompileShader(GLuint shader)
 
     CreateShaderCompiler();
 
-    shaderPtr->CompileShader();
+    // shaders waiting to be deleted are compiled right away, so that nothing is pending when they are
+    if(mMaxShaderCompilerThreads && !shaderPtr->GetMarkForDeletion()) {
+        shaderPtr->SetCompileTicket(mShareGroup->EnqueueCompileJob([shaderPtr] { shaderPtr->CompileShader(); }));
+        return;
+    }
+
+    WaitCompileJobs();
+    mShareGroup->RunCompileJob([shaderPtr] { shaderPtr->CompileShader(); });
 }
 
 GLuint
@@ -56,9 +63,10 @@ Context::CreateShader(GLenum type)
     Shader *shader = mResourceManager->GetShader(res);
     shader->SetShaderType(type == GL_VERTEX_SHADER ? SHADER_TYPE_VERTEX : SHADER_TYPE_FRAGMENT);
     shader->SetVkContext(mVkContext);
-    shader->SetShaderCompiler(mShaderCompiler);
+    shader->SetShaderCompiler(mShareGroup->GetShaderCompiler());
+    shader->SetShadingId(mResourceManager->PushShadingObject({SHADER_ID, res}));
 
-    return mResourceManager->PushShadingObject({SHADER_ID, res});
+    return shader->GetShadingId();
 }
 
 void
@@ -80,10 +88,9 @@ Context::DeleteShader(GLuint shader)
     if(shaderPtr->FreeForDeletion()) {
         // Flush in case the shader is part of the pipeline
         // Optimization: perform this only when needed or defer deletion
-        if(mWriteFBO->IsInDrawState()) {
+        if(IsDrawPending()) {
             Flush();
         }
-        mResourceManager->EraseShadingObject(shader);
         mResourceManager->DeallocateShader(shaderPtr);
     } else {
         ResourceManager* resourceManager = GetCurrentContext()->GetResourceManager();
@@ -92,7 +99,7 @@ Context::DeleteShader(GLuint shader)
 }
 
 Shader *
-Context::GetShaderPtr(GLuint shader)
+Context::GetShaderPtr(GLuint shader, bool waitCompile)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
@@ -107,7 +114,21 @@ Context::GetShaderPtr(GLuint shader)
         return nullptr;
     }
 
-    return mResourceManager->GetShader(shadId.arrayIndex);
+    Shader *shaderPtr = mResourceManager->GetShader(shadId.arrayIndex);
+    if(waitCompile && shaderPtr->GetCompileTicket()) {
+        mShareGroup->GetCompileWorker()->Wait(shaderPtr->GetCompileTicket());
+        shaderPtr->SetCompileTicket(0);
+    }
+
+    return shaderPtr;
+}
+
+void
+Context::WaitCompileJobs(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    mShareGroup->GetCompileWorker()->Wait();
 }
 
 void
@@ -115,12 +136,13 @@ Context::GetShaderiv(GLuint shader, GLenum pname, GLint *params)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    Shader *shaderPtr = GetShaderPtr(shader);
+    Shader *shaderPtr = GetShaderPtr(shader, pname != GL_COMPLETION_STATUS_KHR);
     if(!shaderPtr) {
         return;
     }
 
     switch(pname) {
+    case GL_COMPLETION_STATUS_KHR:  *params = mShareGroup->GetCompileWorker()->IsDone(shaderPtr->GetCompileTicket()) ? GL_TRUE : GL_FALSE; break;
     case GL_COMPILE_STATUS:         *params = shaderPtr->IsCompiled()           ? GL_TRUE : GL_FALSE; break;
     case GL_DELETE_STATUS:          *params = shaderPtr->GetMarkForDeletion()   ? GL_TRUE : GL_FALSE; break;
     case GL_INFO_LOG_LENGTH:        *params = shaderPtr->GetInfoLogLength();      break;
@@ -328,10 +350,7 @@ Context::ReleaseShaderCompiler(void)
         return;
     }
 
-    if(mShaderCompiler != nullptr) {
-        delete mShaderCompiler;
-        mShaderCompiler = nullptr;
-    }
+    mShareGroup->ReleaseShaderCompiler();
 }
 
 void
@@ -339,19 +358,21 @@ Context::CreateShaderCompiler(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(mShaderCompiler == nullptr) {
-        mShaderCompiler = new GlslangShaderCompiler();
+    mShareGroup->CreateShaderCompiler();
+}
 
-        ObjectArray<Shader> *shaderArray = mResourceManager->GetShaderArray();
-        for(typename map<uint32_t, Shader *>::const_iterator it =
-        shaderArray->GetObjects()->begin(); it != shaderArray->GetObjects()->end(); it++) {
-            it->second->SetShaderCompiler(mShaderCompiler);
-        }
+/// ----------------------------------------------------------- ///
+/// ------------------------ Extensions ----------------------- ///
+/// ----------------------------------------------------------- ///
 
-        ObjectArray<ShaderProgram> *shaderProgramArray = mResourceManager->GetShaderProgramArray();
-        for(typename map<uint32_t, ShaderProgram *>::const_iterator it =
-        shaderProgramArray->GetObjects()->begin(); it != shaderProgramArray->GetObjects()->end(); it++) {
-            it->second->SetShaderCompiler(mShaderCompiler);
-        }
-    }
+// [KHR_parallel_shader_compile]
+
+void
+Context::MaxShaderCompilerThreadsKHR(GLuint count)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the jobs of a context share its compiler and run one at a time on its
+    // worker, so any count enables it and 0 compiles on the calling thread
+    mMaxShaderCompilerThreads = count;
 }
@@ -33,7 +33,8 @@ Context::AttachShader(GLuint program, GLuint shader)
         return;
     }
 
-    Shader *shaderPtr = GetShaderPtr(shader);
+    // attaching does not need the shader compiled, its link job is queued after the compile one
+    Shader *shaderPtr = GetShaderPtr(shader, false);
     if(!shaderPtr) {
         return;
     }
@@ -84,10 +85,11 @@ Context::CreateProgram(void)
     GLuint         res     = mResourceManager->AllocateShaderProgram();
     ShaderProgram *progPtr = mResourceManager->GetShaderProgram(res);
     progPtr->SetVkContext(mVkContext);
-    progPtr->SetShaderCompiler(mShaderCompiler);
+    progPtr->SetShaderCompiler(mShareGroup->GetShaderCompiler());
     progPtr->SetCacheManager(mCacheManager);
+    progPtr->SetShadingId(mResourceManager->PushShadingObject({SHADER_PROGRAM_ID, res}));
 
-    return mResourceManager->PushShadingObject({SHADER_PROGRAM_ID, res});
+    return progPtr->GetShadingId();
 }
 
 void
@@ -107,13 +109,6 @@ Context::DeleteProgram(GLuint program)
     progPtr->SetMarkForDeletion(true);
 
     if(progPtr->FreeForDeletion()) {
-        // Flush in case the shader is part of the pipeline
-        // Optimization: perform this only when needed or defer deletion
-        if(mWriteFBO->IsInDrawState()) {
-            Finish();
-        }
-        progPtr->DetachShaders();
-        mResourceManager->EraseShadingObject(program);
         mResourceManager->DeallocateShaderProgram(progPtr);
     } else {
         ResourceManager* resourceManager = GetCurrentContext()->GetResourceManager();
@@ -146,7 +141,7 @@ Context::DetachShader(GLuint program, GLuint shader)
     if(shaderPtr->GetMarkForDeletion() && shaderPtr->FreeForDeletion()) {
         // Flush in case the shader is part of the pipeline
         // Optimization: perform this only when needed or defer deletion
-        if(mWriteFBO->IsInDrawState()) {
+        if(IsDrawPending()) {
             Flush();
         }
         mResourceManager->CleanPurgeList();
@@ -228,13 +223,13 @@ Context::GetActiveAttrib(GLuint program, GLuint index, GLsizei bufsize, GLsizei*
     }
 
     const ShaderResourceInterface::attribute *attribute = progPtr->GetVertexAttribute(index);
-    GLint len = std::max(std::min((int)attribute->name.length(), bufsize - 1), 0);
+    GLint len = std::max(std::min((int)strlen(attribute->name), bufsize - 1), 0);
     if(length) {
         *length = len;
     }
 
     if(len) {
-        memcpy(static_cast<void *>(name), static_cast<const void *>(attribute->name.c_str()), len);
+        memcpy(static_cast<void *>(name), static_cast<const void *>(attribute->name), len);
         name[len] = '\0';
     }
 
@@ -265,7 +260,7 @@ Context::GetActiveUniform(GLuint program, GLuint index, GLsizei bufsize, GLsizei
 
     const ShaderResourceInterface::uniform *uniform = progPtr->GetUniform((uint32_t)index);
     assert(uniform);
-    GLint len = static_cast<GLint>(std::max(std::min((int)uniform->name.length(), bufsize-1), 0));
+    GLint len = static_cast<GLint>(std::max(std::min((int)strlen(uniform->name), bufsize-1), 0));
 
     string index0Str = "";
     if(uniform->arraySize > 1) {
@@ -274,7 +269,7 @@ Context::GetActiveUniform(GLuint program, GLuint index, GLsizei bufsize, GLsizei
     }
 
     if(len) {
-        memcpy(static_cast<void *>(name), static_cast<const void *>((uniform->name + index0Str).c_str()), len);
+        memcpy(static_cast<void *>(name), static_cast<const void *>((string(uniform->name) + index0Str).c_str()), len);
         name[len] = '\0';
     }
 
@@ -296,22 +291,30 @@ Context::GetProgramBinaryOES(GLuint program, GLsizei bufSize, GLsizei *length, G
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    (void)binaryFormat;
-
     ShaderProgram *progPtr = GetProgramPtr(program);
     if(!progPtr) {
         return;
     }
 
-    progPtr->GetBinaryData(binary, length);
+    // a pending link has to complete before the program is serialized
+    WaitCompileJobs();
 
-    if(bufSize < *length) {
-        *length = 0;
+    GLsizei binaryLength = progPtr->GetBinaryLength();
+    if(!progPtr->IsLinked() || bufSize < binaryLength) {
+        if(length) {
+            *length = 0;
+        }
         RecordError(GL_INVALID_OPERATION);
         return;
     }
 
-    return;
+    progPtr->GetBinaryData(binary, bufSize, &binaryLength);
+    if(length) {
+        *length = binaryLength;
+    }
+    if(binaryFormat) {
+        *binaryFormat = GLOVE_HOST_X86_BINARY;
+    }
 }
 
 void
@@ -352,7 +355,7 @@ Context::GetProgramInfoLog(GLuint program, GLsizei bufsize, GLsizei* length, cha
 }
 
 ShaderProgram *
-Context::GetProgramPtr(GLuint program)
+Context::GetProgramPtr(GLuint program, bool waitLink)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
@@ -367,7 +370,14 @@ Context::GetProgramPtr(GLuint program)
         return nullptr;
     }
 
-    return mResourceManager->GetShaderProgram(progId.arrayIndex);
+    ShaderProgram *progPtr = mResourceManager->GetShaderProgram(progId.arrayIndex);
+    if(waitLink && progPtr->GetLinkTicket()) {
+        mShareGroup->GetCompileWorker()->Wait(progPtr->GetLinkTicket());
+        progPtr->SetLinkTicket(0);
+        FinishProgramLink(progPtr);
+    }
+
+    return progPtr;
 }
 
 void
@@ -378,12 +388,12 @@ Context::GetProgramiv(GLuint program, GLenum pname, GLint* params)
     if(pname != GL_DELETE_STATUS && pname != GL_LINK_STATUS && pname != GL_VALIDATE_STATUS &&
        pname != GL_INFO_LOG_LENGTH && pname != GL_ATTACHED_SHADERS && pname != GL_ACTIVE_ATTRIBUTES &&
        pname != GL_ACTIVE_ATTRIBUTE_MAX_LENGTH && pname != GL_ACTIVE_UNIFORMS &&
-       pname != GL_ACTIVE_UNIFORM_MAX_LENGTH && pname != GL_PROGRAM_BINARY_LENGTH_OES) {
+       pname != GL_ACTIVE_UNIFORM_MAX_LENGTH && pname != GL_PROGRAM_BINARY_LENGTH_OES && pname != GL_COMPLETION_STATUS_KHR) {
         RecordError(GL_INVALID_ENUM);
         return;
     }
 
-    ShaderProgram *progPtr = GetProgramPtr(program);
+    ShaderProgram *progPtr = GetProgramPtr(program, pname != GL_COMPLETION_STATUS_KHR);
     if(!progPtr) {
         RecordError(GL_INVALID_VALUE);
         return;
@@ -395,6 +405,7 @@ Context::GetProgramiv(GLuint program, GLenum pname, GLint* params)
     }
 
     switch(pname) {
+    case GL_COMPLETION_STATUS_KHR:       *params = mShareGroup->GetCompileWorker()->IsDone(progPtr->GetLinkTicket()) ? GL_TRUE : GL_FALSE; break;
     case GL_DELETE_STATUS:               *params = progPtr->GetMarkForDeletion() ? GL_TRUE : GL_FALSE; break;
     case GL_LINK_STATUS:                 *params = progPtr->IsLinked() ? GL_TRUE : GL_FALSE; break;
     case GL_VALIDATE_STATUS:             *params = progPtr->IsValidated() ? GL_TRUE : GL_FALSE; break;
@@ -596,11 +607,27 @@ Context::SetPipelineProgramShaderStages(ShaderProgram *progPtr)
     uint32_t &pipelineShaderStageCount = mPipeline->GetShaderStageCountRef();
     int32_t *pipelineShaderStagesIDs = mPipeline->GetShaderStageIDsRef();
     VkPipelineShaderStageCreateInfo *pipelineShaderStages = mPipeline->GetShaderStages();
+
+    // a specialized uniform has been changed, which selects another pipeline
+    if(progPtr->UpdateSpecializationData()) {
+        mPipeline->SetUpdatePipeline(true);
+    }
+
+    // the program renders onto a surface of another rotation
+    if(progPtr->SetPreTransform(mWriteFBO ? mWriteFBO->GetPreTransform() : VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR)) {
+        mPipeline->SetUpdatePipeline(true);
+    }
+
+    // the samplers of the program have been baked into its layout, or taken out of it again
+    if(progPtr->UpdateImmutableSamplers()) {
+        mPipeline->SetUpdatePipeline(true);
+    }
+
     if(!progPtr->SetPipelineShaderStage(pipelineShaderStageCount, pipelineShaderStagesIDs, pipelineShaderStages)) {
         return false;
     }
 
-    mPipeline->SetCache(progPtr->GetVkPipelineCache());
+    mPipeline->SetCache(progPtr->GetPipelineCache());
     mPipeline->SetLayout(progPtr->GetVkPipelineLayout());
     mPipeline->SetVertexInputState(progPtr->GetVkPipelineVertexInput());
 
@@ -617,17 +644,43 @@ Context::LinkProgram(GLuint program)
         return;
     }
 
-    if(mWriteFBO->IsInDrawState()) {
+    // the program in use, or waiting to be deleted once it is not, is linked right away
+    if(mMaxShaderCompilerThreads && progPtr != mStateManager.GetActiveShaderProgram() && !progPtr->GetMarkForDeletion()) {
+        progPtr->SetLinkTicket(mShareGroup->EnqueueCompileJob([progPtr] { progPtr->LinkShaders(); }));
+        return;
+    }
+
+    WaitCompileJobs();
+    mShareGroup->RunCompileJob([progPtr] { progPtr->LinkShaders(); });
+    FinishProgramLink(progPtr);
+}
+
+void
+Context::FinishProgramLink(ShaderProgram *progPtr)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(IsDrawPending()) {
         Finish();
     }
 
-    progPtr->LinkProgram();
+    progPtr->FinishLink();
     progPtr->SetShaderModules();
 
     mPipeline->SetUpdatePipeline(progPtr->IsLinked());
     if(SetPipelineProgramShaderStages(progPtr)) {
-        progPtr->PrepareVertexAttribBufferObjects(0, 0, mResourceManager->GetGenericVertexAttributes(), true);
-        mPipeline->Create(mSystemFBO->GetVkRenderPass());
+        progPtr->PrepareVertexAttribBufferObjects(0, 0, 1, mResourceManager->GetActiveVertexArray(), mStreamRing, true);
+
+        // build the pipeline for the current state in the background, so
+        // that the first draw with the program is likely to find it ready
+        if(progPtr->HasVertexShader() && progPtr->HasFragmentShader()) {
+            const std::vector<uint32_t> *spirv[2] = { &progPtr->GetVertexShader()->GetSPV(),
+                                                      &progPtr->GetFragmentShader()->GetSPV() };
+            // the first draw of a program with the framebuffer fetch switches the FBO to the passes that read its color
+            mPipeline->Precompile(mWriteFBO->GetColorVkFormat(), mWriteFBO->GetDepthStencilVkFormat(),
+                                  mWriteFBO->IsFramebufferFetchEnabled() || progPtr->UsesFramebufferFetch(),
+                                  spirv, mVkContext->vkPipelineCompiler);
+        }
         // rebuild the pipeline next time
         mPipeline->SetUpdatePipeline(true);
     }
@@ -723,13 +776,13 @@ Context::Uniform1i(GLint location, GLint x)
     const ShaderResourceInterface::uniform *uniform = mStateManager.GetActiveShaderProgram()->GetUniformAtLocation(location);
     if((!uniform) ||
        (uniform->type != GL_INT        && uniform->type != GL_BOOL &&
-        uniform->type != GL_SAMPLER_2D && uniform->type != GL_SAMPLER_CUBE)
+        !IsGlSampler(uniform->type))
       ) {
         RecordError(GL_INVALID_OPERATION);
         return;
     }
 
-    if(uniform->type == GL_SAMPLER_2D || uniform->type == GL_SAMPLER_CUBE) {
+    if(IsGlSampler(uniform->type)) {
         mStateManager.GetActiveShaderProgram()->SetUniformSampler(location, 1, &x);
     } else if(uniform->type == GL_INT) {
         mStateManager.GetActiveShaderProgram()->SetUniformData(location, sizeof(int), &x);
@@ -761,7 +814,7 @@ Context::Uniform1iv(GLint location, GLsizei count, const GLint *v)
     const ShaderResourceInterface::uniform *uniform = mStateManager.GetActiveShaderProgram()->GetUniformAtLocation(location);
     if((!uniform ) ||
        (uniform->type != GL_INT && uniform->type != GL_BOOL &&
-        uniform->type != GL_SAMPLER_2D && uniform->type != GL_SAMPLER_CUBE) ||
+        !IsGlSampler(uniform->type)) ||
        (uniform->arraySize == 1 && count > 1)) {
         RecordError(GL_INVALID_OPERATION);
         return;
@@ -772,7 +825,7 @@ Context::Uniform1iv(GLint location, GLsizei count, const GLint *v)
         count = uniform->arraySize - (location - (GLint)uniform->location);
     }
 
-    if(uniform->type == GL_SAMPLER_2D || uniform->type == GL_SAMPLER_CUBE) {
+    if(IsGlSampler(uniform->type)) {
         mStateManager.GetActiveShaderProgram()->SetUniformSampler(location, count, v);
     } else if(uniform->type == GL_INT) {
         mStateManager.GetActiveShaderProgram()->SetUniformData(location, count * sizeof(int), static_cast<const void *>(v));
@@ -1403,6 +1456,10 @@ Context::UseProgram(GLuint program)
     if(progPtr) {
         progPtr->Bind();
         progPtr->EnableUpdateOfDescriptorSets();
+        // a program of the share group retires its objects with the context drawing with it
+        if(progPtr->GetCacheManager() != mCacheManager) {
+            progPtr->SetCacheManager(mCacheManager);
+        }
     }
 }
 
@@ -1422,7 +1479,8 @@ Context::ValidateProgram(GLuint program)
         }
     }
 
-    progPtr->Validate();
+    WaitCompileJobs();
+    mShareGroup->RunCompileJob([progPtr] { progPtr->Validate(); });
 
     if(!progPtr->IsValidated()){
         //TODO: INFO LOG HERE:
@@ -1452,11 +1510,16 @@ Context::ProgramBinaryOES(GLuint program, GLenum binaryFormat, const void *binar
         return;
     }
 
+    // a pending link of the program would overwrite it
+    WaitCompileJobs();
+
     GLuint vs = CreateShader(GL_VERTEX_SHADER);
     GLuint fs = CreateShader(GL_FRAGMENT_SHADER);
     AttachShader(program, vs);
     AttachShader(program, fs);
 
-    progPtr->UsePrecompiledBinary(binary, length);
-    progPtr->SetShaderModules();
+    // an invalid binary leaves the program unlinked, without an error
+    if(progPtr->UsePrecompiledBinary(binary, length > 0 ? static_cast<size_t>(length) : 0)) {
+        progPtr->SetShaderModules();
+    }
 }
@@ -22,6 +22,9 @@
  */
 
 #include "context.h"
+#include <atomic>
+
+static std::atomic<uint32_t> sScissorStateIds(0);
 
 void
 Context::BlendColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha)
@@ -155,6 +158,17 @@ Context::SampleCoverage(GLclampf value, GLboolean invert)
     }
 }
 
+void
+Context::UpdateScissorStateId(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // 0 stands for no scissor rect kept by the FBOs
+    do {
+        mScissorStateId = ++sScissorStateIds;
+    } while(mScissorStateId == 0);
+}
+
 void
 Context::Scissor(GLint x, GLint y, GLsizei width, GLsizei height)
 {
@@ -167,6 +181,7 @@ Context::Scissor(GLint x, GLint y, GLsizei width, GLsizei height)
 
     if(mStateManager.GetFragmentOperationsState()->UpdateScissorRect(x, y, width, height)) {
         mPipeline->SetUpdateViewportState(true);
+        UpdateScissorStateId();
     }
 }
 
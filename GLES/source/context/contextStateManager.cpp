@@ -48,6 +48,7 @@ Context::SetCapability(GLenum cap, GLboolean enable)
     case GL_SCISSOR_TEST:
         if(mStateManager.GetFragmentOperationsState()->UpdateScissorTestEnabled(enable)) {
             mPipeline->SetUpdateViewportState(true);
+            UpdateScissorStateId();
         }
         break;
     case GL_DEPTH_TEST:
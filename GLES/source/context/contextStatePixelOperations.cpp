@@ -22,26 +22,33 @@
  */
 
 #include "context.h"
+#include <algorithm>
+#include <cstring>
 
 void
 Context::PixelStorei(GLenum pname, GLint param)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(pname != GL_PACK_ALIGNMENT && pname != GL_UNPACK_ALIGNMENT) {
+    if(pname != GL_PACK_ALIGNMENT        && pname != GL_UNPACK_ALIGNMENT      &&
+       pname != GL_UNPACK_ROW_LENGTH_EXT && pname != GL_UNPACK_SKIP_ROWS_EXT  && pname != GL_UNPACK_SKIP_PIXELS_EXT) {
         RecordError(GL_INVALID_ENUM);
         return;
     }
 
-    if(param != 1 && param != 2 && param != 4 && param != 8) {
+    if(((pname == GL_PACK_ALIGNMENT || pname == GL_UNPACK_ALIGNMENT) && param != 1 && param != 2 && param != 4 && param != 8) ||
+       param < 0) {
         RecordError(GL_INVALID_VALUE);
         return;
     }
 
     switch(pname) {
-    case GL_PACK_ALIGNMENT:     mStateManager.GetPixelStorageState()->SetPixelStorePack(param); break;
-    case GL_UNPACK_ALIGNMENT:   mStateManager.GetPixelStorageState()->SetPixelStoreUnpack(param); break;
-    default: NOT_REACHED();     break;
+    case GL_PACK_ALIGNMENT:             mStateManager.GetPixelStorageState()->SetPixelStorePack(param); break;
+    case GL_UNPACK_ALIGNMENT:           mStateManager.GetPixelStorageState()->SetPixelStoreUnpack(param); break;
+    case GL_UNPACK_ROW_LENGTH_EXT:      mStateManager.GetPixelStorageState()->SetUnpackRowLength(param); break;
+    case GL_UNPACK_SKIP_ROWS_EXT:       mStateManager.GetPixelStorageState()->SetUnpackSkipRows(param); break;
+    case GL_UNPACK_SKIP_PIXELS_EXT:     mStateManager.GetPixelStorageState()->SetUnpackSkipPixels(param); break;
+    default: NOT_REACHED();             break;
     }
 }
 
@@ -74,34 +81,68 @@ Context::ReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum form
         return;
     }
 
-    if(mWriteFBO != mSystemFBO && mWriteFBO->CheckStatus() != GL_FRAMEBUFFER_COMPLETE) {
+    if(GetReadFBO() != mSystemFBO && GetReadFBO()->CheckStatus() != GL_FRAMEBUFFER_COMPLETE) {
         RecordError(GL_INVALID_FRAMEBUFFER_OPERATION);
         return;
     }
 
-    if(mWriteFBO->IsInDrawState()) {
-        Finish();
+    GLenum dstInternalFormat = GlFormatToGlInternalFormat(format, type);
+    ImageRect dstRect(0, 0, width, height,
+                      GlInternalFormatTypeToNumElements(dstInternalFormat, type),
+                      GlTypeToElementSize(type),
+                      mStateManager.GetPixelStorageState()->GetPixelStorePack());
+
+    // with a pixel pack buffer bound, pixels is an offset into it
+    BufferObject *pbo = mStateManager.GetActiveObjectsState()->GetActiveBufferObject(GL_PIXEL_PACK_BUFFER_NV);
+    size_t pboOffset  = reinterpret_cast<uintptr_t>(pixels);
+    if(pbo && (!pbo->HasData() || pbo->IsMapped() || pboOffset + dstRect.GetRectBufferSize() > pbo->GetSize())) {
+        RecordError(GL_INVALID_OPERATION);
+        return;
     }
 
-    Texture* activeTexture = mWriteFBO->GetColorAttachmentTexture();
+    AcquireSurfaceImage();
+
+    Texture* activeTexture = GetReadFBO()->GetColorAttachmentTexture();
     if(activeTexture == nullptr) {
         return;
     }
 
+    ++mStatistics.readbacks;
+    mStatistics.readbackBytes += dstRect.GetRectBufferSize();
+
+    Rect readRect(x, y, width, height);
+    if(pbo && GLOVE_ASYNC_READPIXELS && ReadPixelsToBuffer(activeTexture, &readRect, &dstRect, format, type, pbo, pboOffset)) {
+        return;
+    }
+
+    if(!pbo && ReadPixelsConverted(activeTexture, &readRect, &dstRect, format, type, pixels)) {
+        return;
+    }
+
+    if(IsDrawPending()) {
+        Finish();
+    }
+
     GLenum srcInternalFormat = activeTexture->GetExplicitInternalFormat();
-    GLenum dstInternalFormat = GlFormatToGlInternalFormat(format, type);
 
     ImageRect srcRect(x, y, width, height,
                       GlInternalFormatTypeToNumElements(srcInternalFormat, activeTexture->GetExplicitType()),
                       GlTypeToElementSize(activeTexture->GetExplicitType()),
                       Texture::GetDefaultInternalAlignment());
-    ImageRect dstRect(0, 0, width, height,
-                      GlInternalFormatTypeToNumElements(dstInternalFormat, type),
-                      GlTypeToElementSize(type),
-                      mStateManager.GetPixelStorageState()->GetPixelStorePack());
 
-    srcRect.y = activeTexture->GetInvertedYOrigin(&srcRect);
-    activeTexture->CopyPixelsToHost(&srcRect, &dstRect, 0, 0, dstInternalFormat, pixels);
+    LinearAllocatorScope scope(&mFrameArena);
+    void *dstData = pixels;
+    if(pbo) {
+        // the rows are converted on the host and written into the buffer afterwards
+        WaitBufferReadback(pbo);
+        dstData = mFrameArena.Allocate<uint8_t>(dstRect.GetRectBufferSize());
+    }
+
+    CopyFramebufferToHost(activeTexture, &srcRect, &dstRect, dstInternalFormat, dstData);
+
+    if(pbo) {
+        pbo->UpdateData(dstRect.GetRectBufferSize(), pboOffset, dstData);
+    }
 
 #if GLOVE_SAVE_READPIXELS_TO_FILE == true
     static int calls = 0;
@@ -109,8 +150,220 @@ Context::ReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum form
     snprintf(fileName, 64, "screen%d_%dx%d.rgba", calls++, width, height);
     FILE *fp = fopen(fileName, "w");
     if(fp) {
-        fwrite(pixels, dstRect.GetRectBufferSize(), 1, fp);
+        fwrite(dstData, dstRect.GetRectBufferSize(), 1, fp);
         fclose(fp);
     }
 #endif
 }
+
+bool
+Context::ReadPixelsToBuffer(Texture *srcTexture, const Rect *srcRect, const ImageRect *dstRect, GLenum format, GLenum type,
+                            BufferObject *bo, size_t offset)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the copy addresses whole texels at 4 byte aligned offsets, and cannot clip to the framebuffer or follow its rotation
+    const uint32_t texelSize = dstRect->GetPixelByteOffset();
+    if(bo->IsDeviceLocal() || offset % 4 || offset % texelSize || GetReadFBO()->IsPreTransformed() ||
+       srcRect->x < 0 || srcRect->y < 0 || !srcRect->width || !srcRect->height ||
+       srcRect->x + srcRect->width  > srcTexture->GetWidth() ||
+       srcRect->y + srcRect->height > srcTexture->GetHeight()) {
+        return false;
+    }
+
+    // the stored texels have to be the ones GL reads, the host conversion fills in the missing channels otherwise
+    VkFormat srcVkFormat = srcTexture->GetVkFormat();
+    VkFormat dstVkFormat = GlInternalFormatToVkFormat(GlFormatToGlInternalFormat(format, type));
+    if(srcVkFormat != GlInternalFormatToVkFormat(srcTexture->GetExplicitInternalFormat())) {
+        return false;
+    }
+
+    Texture *convertTexture = nullptr;
+    if(GetReadFBO()->IsOriginFlipped() || srcVkFormat != dstVkFormat) {
+        convertTexture = GetReadbackTexture(format, type, srcRect->width, srcRect->height);
+        if(!convertTexture) {
+            return false;
+        }
+    }
+
+    // the copy is recorded after the pending draws and executes ahead of the next ones, no wait is needed
+    if(IsDrawPending()) {
+        Flush();
+        mWriteFBO->SetStateIdle();
+    }
+
+    if(!srcTexture->CopyPixelsToBuffer(srcRect, GetReadFBO()->IsOriginFlipped(), convertTexture,
+                                       bo, offset, dstRect->GetRectAlignedRowInBytes() / texelSize)) {
+        return false;
+    }
+
+    // the aux commands are submitted with whichever submission comes next
+    bo->SetReadbackSubmissionId(mCommandBufferManager->GetLastSubmissionId() + 1);
+
+    return true;
+}
+
+bool
+Context::ReadPixelsConverted(Texture *srcTexture, const Rect *srcRect, const ImageRect *dstRect, GLenum format, GLenum type, void *pixels)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // reads in the format of the framebuffer need no conversion, small ones are converted faster on the host
+    const size_t size = dstRect->GetRectBufferSize();
+    if(!GLOVE_DEVICE_PIXEL_CONVERSION || size < GLOVE_DEVICE_PIXEL_CONVERSION_MIN_SIZE ||
+       srcTexture->GetVkFormat() == GlInternalFormatToVkFormat(GlFormatToGlInternalFormat(format, type))) {
+        return false;
+    }
+
+    BufferObject *tbo = mCacheManager->GetStagingBuffer(size, false);
+    if(!tbo) {
+        return false;
+    }
+
+    const bool converted = ReadPixelsToBuffer(srcTexture, srcRect, dstRect, format, type, tbo, 0) && WaitBufferReadback(tbo);
+    if(converted) {
+        // the rows are laid out as GL packs them already, without the padding of the last one
+        tbo->GetData((dstRect->height - 1) * dstRect->GetRectAlignedRowInBytes() + dstRect->GetDataRowSize(), 0, pixels);
+    }
+
+    mCacheManager->ReleaseStagingBuffer(tbo);
+
+    return converted;
+}
+
+void
+Context::CopyFramebufferToHost(Texture *fbTexture, ImageRect *srcRect, ImageRect *dstRect, GLenum dstFormat, void *dstData)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!GetReadFBO()->IsPreTransformed()) {
+        if(GetReadFBO()->IsOriginFlipped()) {
+            srcRect->y = fbTexture->GetInvertedYOrigin(srcRect);
+        } else {
+            fbTexture->SetDataNoInvertion(true);
+        }
+        fbTexture->CopyPixelsToHost(srcRect, dstRect, 0, 0, dstFormat, dstData);
+        return;
+    }
+
+    // the rect of the window, with the top-left origin of the images, is read from where the rotation has put it
+    const VkSurfaceTransformFlagBitsKHR transform = GetReadFBO()->GetPreTransform();
+    const bool     flipped      = GetReadFBO()->IsOriginFlipped();
+    const uint32_t windowWidth  = static_cast<uint32_t>(GetReadFBO()->GetWindowWidth());
+    const uint32_t windowHeight = static_cast<uint32_t>(GetReadFBO()->GetWindowHeight());
+    const int32_t  windowY      = flipped ? static_cast<int32_t>(windowHeight) - srcRect->y - srcRect->height : srcRect->y;
+    const VkRect2D imageRect    = PreTransformVkRect2D({ {srcRect->x, windowY}, {static_cast<uint32_t>(srcRect->width), static_cast<uint32_t>(srcRect->height)} },
+                                                       windowWidth, windowHeight, transform);
+
+    ImageRect imageSrcRect(imageRect.offset.x, imageRect.offset.y, imageRect.extent.width, imageRect.extent.height,
+                           srcRect->mNumElements, srcRect->mSizeElement, srcRect->mAlignment);
+    ImageRect imageDstRect(0, 0, imageRect.extent.width, imageRect.extent.height,
+                           dstRect->mNumElements, dstRect->mSizeElement, dstRect->mAlignment);
+
+    LinearAllocatorScope scope(&mFrameArena);
+    uint8_t *imageData = mFrameArena.Allocate<uint8_t>(imageDstRect.GetRectBufferSize());
+    fbTexture->SetDataNoInvertion(true);
+    fbTexture->CopyPixelsToHost(&imageSrcRect, &imageDstRect, 0, 0, dstFormat, imageData);
+
+    // each pixel is taken back to the orientation of the window, with the rows in the order GL reads them
+    const uint32_t pixelSize    = dstRect->GetPixelByteOffset();
+    const uint32_t rowSize      = dstRect->GetRectAlignedRowInBytes();
+    const uint32_t imageRowSize = imageDstRect.GetRectAlignedRowInBytes();
+    uint8_t *dst = static_cast<uint8_t *>(dstData);
+    for(int j = 0; j < srcRect->height; ++j) {
+        const int32_t pixelY = flipped ? static_cast<int32_t>(windowHeight) - 1 - (srcRect->y + j) : srcRect->y + j;
+        for(int i = 0; i < srcRect->width; ++i) {
+            const VkRect2D pixel = PreTransformVkRect2D({ {srcRect->x + i, pixelY}, {1, 1} }, windowWidth, windowHeight, transform);
+            memcpy(dst + j * rowSize + i * pixelSize,
+                   imageData + (pixel.offset.y - imageRect.offset.y) * imageRowSize + (pixel.offset.x - imageRect.offset.x) * pixelSize,
+                   pixelSize);
+        }
+    }
+}
+
+Texture *
+Context::GetReadbackTexture(GLenum format, GLenum type, GLsizei width, GLsizei height)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    return GetTransferTexture(&mReadbackTexture, format, type, width, height);
+}
+
+Texture *
+Context::GetUploadTexture(GLenum format, GLenum type, GLsizei width, GLsizei height)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    return GetTransferTexture(&mUploadTexture, format, type, width, height);
+}
+
+Texture *
+Context::GetTransferTexture(Texture **cached, GLenum format, GLenum type, GLsizei width, GLsizei height)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    VkFormat vkFormat = GlInternalFormatToVkFormat(GlFormatToGlInternalFormat(format, type));
+    if(*cached                                 &&
+       (*cached)->GetVkFormat() == vkFormat    &&
+       (*cached)->GetWidth()    >= width       &&
+       (*cached)->GetHeight()   >= height) {
+        return *cached;
+    }
+
+    // copies in flight may still be converting through the previous one
+    if(*cached) {
+        width  = std::max(width,  (*cached)->GetWidth());
+        height = std::max(height, (*cached)->GetHeight());
+        mCacheManager->CacheTexture(*cached);
+        *cached = nullptr;
+    }
+
+    Texture *texture = new Texture(mVkContext);
+    texture->SetTarget(GL_TEXTURE_2D);
+    texture->SetVkFormat(vkFormat);
+    texture->SetVkImageUsage(static_cast<VkImageUsageFlagBits>(VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT));
+    texture->SetVkImageLayout(VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+    texture->SetVkImageTiling();
+    texture->InitState();
+    texture->SetState(width, height, 0, 0, format, type, Texture::GetDefaultInternalAlignment(), nullptr);
+    if(!texture->Allocate()) {
+        delete texture;
+        return nullptr;
+    }
+
+    *cached = texture;
+    return *cached;
+}
+
+bool
+Context::HasPendingReadback(BufferObject *bo)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    uint64_t submissionId = bo->GetReadbackSubmissionId();
+    return submissionId && !mCommandBufferManager->IsSubmissionComplete(submissionId);
+}
+
+bool
+Context::WaitBufferReadback(BufferObject *bo)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!HasPendingReadback(bo)) {
+        bo->SetReadbackSubmissionId(0);
+        return true;
+    }
+
+    // the copies are still batched with the aux commands when nothing has been submitted since
+    uint64_t submissionId = bo->GetReadbackSubmissionId();
+    if(submissionId > mCommandBufferManager->GetLastSubmissionId()) {
+        Flush();
+    }
+
+    if(!mCommandBufferManager->WaitSubmission(submissionId)) {
+        return false;
+    }
+
+    bo->SetReadbackSubmissionId(0);
+    return true;
+}
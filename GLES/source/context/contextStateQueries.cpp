@@ -22,6 +22,17 @@
  */
 
 #include "context.h"
+#include <algorithm>
+#include <cmath>
+
+#ifndef GL_NVX_gpu_memory_info
+#define GL_NVX_gpu_memory_info 1
+#define GL_GPU_MEMORY_INFO_DEDICATED_VIDMEM_NVX             0x9047
+#define GL_GPU_MEMORY_INFO_TOTAL_AVAILABLE_MEMORY_NVX       0x9048
+#define GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX     0x9049
+#define GL_GPU_MEMORY_INFO_EVICTION_COUNT_NVX               0x904A
+#define GL_GPU_MEMORY_INFO_EVICTED_MEMORY_NVX               0x904B
+#endif // GL_NVX_gpu_memory_info
 
 static glove_program_binary_formats_e glove_program_binary_formats[GLOVE_MAX_BINARY_FORMATS] = {
     GLOVE_HOST_X86_BINARY,
@@ -29,211 +40,325 @@ static glove_program_binary_formats_e glove_program_binary_formats[GLOVE_MAX_BIN
     GLOVE_DEV_BINARY
 };
 
-void
-Context::GetBooleanv(GLenum pname, GLboolean* params)
+GLsizei
+Context::GetSupportedSamples(GLsizei samples)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // single sampled storage is reported as 0 samples
+    VkSampleCountFlagBits supported = FindSupportedSampleCount(&mVkContext->vkDeviceLimits, static_cast<uint32_t>(samples));
+    return supported == VK_SAMPLE_COUNT_1_BIT ? 0 : static_cast<GLsizei>(supported);
+}
+
+GLint
+Context::GetGpuMemoryInfo(GLenum pname)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    const vulkanAPI::MemoryAllocator *allocator = mVkContext->vkMemoryAllocator;
+    const VkPhysicalDeviceMemoryProperties &properties = mVkContext->vkDeviceMemoryProperties;
+
+    // sizes are reported in KB, over the device local heaps
+    VkDeviceSize size = 0, budget = 0, available = 0;
+    for(uint32_t i = 0; i < properties.memoryHeapCount; ++i) {
+        if(!(properties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)) {
+            continue;
+        }
+        VkDeviceSize heapUsage, heapBudget;
+        allocator->GetHeapBudget(i, &heapUsage, &heapBudget);
+        size      += properties.memoryHeaps[i].size;
+        budget    += heapBudget;
+        available += heapBudget > heapUsage ? heapBudget - heapUsage : 0;
+    }
+
+    VkDeviceSize value = 0;
+    switch(pname) {
+    case GL_GPU_MEMORY_INFO_DEDICATED_VIDMEM_NVX:           value = size >> 10; break;
+    case GL_GPU_MEMORY_INFO_TOTAL_AVAILABLE_MEMORY_NVX:     value = budget >> 10; break;
+    case GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX:   value = available >> 10; break;
+    case GL_GPU_MEMORY_INFO_EVICTION_COUNT_NVX:             value = allocator->GetEvictionCount(); break;
+    case GL_GPU_MEMORY_INFO_EVICTED_MEMORY_NVX:             value = allocator->GetEvictedSize() >> 10; break;
+    default: break;
+    }
+
+    return static_cast<GLint>(std::min(value, static_cast<VkDeviceSize>(INT32_MAX)));
+}
+
+static inline void
+SetQueryIntegers(stateQueryValue_t *value, uint32_t count, GLint v0, GLint v1 = 0)
+{
+    value->type = stateQueryValue_t::QUERY_INTEGER;
+    value->count = count;
+    value->i[0]  = v0;
+    value->i[1]  = v1;
+}
+
+static inline void
+SetQueryFloats(stateQueryValue_t *value, uint32_t count, GLfloat v0, GLfloat v1 = 0.0f)
+{
+    value->type = stateQueryValue_t::QUERY_FLOAT;
+    value->count = count;
+    value->f[0]  = v0;
+    value->f[1]  = v1;
+}
+
+static inline void
+SetQueryBoolean(stateQueryValue_t *value, bool v)
+{
+    value->type = stateQueryValue_t::QUERY_BOOLEAN;
+    value->count = 1;
+    value->i[0]  = v ? GL_TRUE : GL_FALSE;
+}
+
+static GLint
+GetAttachmentBits(const Texture *texture, GLenum pname)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // an FBO may lack the attachment asked for, which has no bits then
+    if(texture == nullptr) {
+        return 0;
+    }
+
+    GLint r, g, b, a, d, s;
+    GlFormatToStorageBits(texture->GetInternalFormat(), &r, &g, &b, &a, &d, &s);
+
+    switch(pname) {
+    case GL_RED_BITS:                           return r;
+    case GL_GREEN_BITS:                         return g;
+    case GL_BLUE_BITS:                          return b;
+    case GL_ALPHA_BITS:                         return a;
+    case GL_DEPTH_BITS:                         return d;
+    case GL_STENCIL_BITS:                       return s;
+    default:                                    return 0;
+    }
+}
+
+static inline void
+ConvertStateValue(const stateQueryValue_t &value, uint32_t i, GLboolean *param)
+{
+    bool isFloat = value.type == stateQueryValue_t::QUERY_FLOAT || value.type == stateQueryValue_t::QUERY_NORMALIZED;
+    *param = (isFloat ? value.f[i] != 0.0f : value.i[i] != 0) ? GL_TRUE : GL_FALSE;
+}
+
+static inline void
+ConvertStateValue(const stateQueryValue_t &value, uint32_t i, GLint *param)
+{
+    switch(value.type) {
+    case stateQueryValue_t::QUERY_FLOAT:        *param = static_cast<GLint>(std::roundf(value.f[i])); break;
+    case stateQueryValue_t::QUERY_NORMALIZED:   *param = value.f[i] >= 1.0f ? 0x7fffffff : static_cast<GLint>(value.f[i] * 0x7fffffff); break;
+    default:                                    *param = value.i[i]; break;
+    }
+}
+
+static inline void
+ConvertStateValue(const stateQueryValue_t &value, uint32_t i, GLfloat *param)
+{
+    bool isFloat = value.type == stateQueryValue_t::QUERY_FLOAT || value.type == stateQueryValue_t::QUERY_NORMALIZED;
+    *param = isFloat ? value.f[i] : static_cast<GLfloat>(value.i[i]);
+}
+
+/**
+ * Every state a glGet* call can query is read from its shadow copy in the
+ * state manager or in the bound objects, once, in the type it is kept as.
+ * Nothing is flushed, waited for or allocated, as middleware saves and
+ * restores its state with these calls around every draw it issues.
+ */
+bool
+Context::QueryState(GLenum pname, stateQueryValue_t *value)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    StateActiveObjects         *activeObjects = mStateManager.GetActiveObjectsState();
+    StateFragmentOperations    *fragment      = mStateManager.GetFragmentOperationsState();
+    StateFramebufferOperations *framebuffer   = mStateManager.GetFramebufferOperationsState();
+    StateRasterization         *rasterization = mStateManager.GetRasterizationState();
+    StateViewportTransformation *viewport     = mStateManager.GetViewportTransformationState();
+
     switch(pname) {
-    case GL_IMPLEMENTATION_COLOR_READ_FORMAT:   *params = GL_TRUE; break;
-    case GL_IMPLEMENTATION_COLOR_READ_TYPE:     *params = GL_TRUE; break;
-    case GL_TEXTURE_BINDING_2D:                 *params = mResourceManager->GetTextureID(mStateManager.GetActiveObjectsState()->GetActiveTexture(GL_TEXTURE_2D)) == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_TEXTURE_BINDING_CUBE_MAP:           *params = mResourceManager->GetTextureID(mStateManager.GetActiveObjectsState()->GetActiveTexture(GL_TEXTURE_CUBE_MAP)) == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_FRAMEBUFFER_BINDING:                *params = mStateManager.GetActiveObjectsState()->GetActiveFramebufferObjectID() == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_RENDERBUFFER_BINDING:               *params = mStateManager.GetActiveObjectsState()->GetActiveRenderbufferObjectID() == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_ACTIVE_TEXTURE:                     *params = mStateManager.GetActiveObjectsState()->GetActiveTextureUnit() == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_CURRENT_PROGRAM:                    *params = GetProgramId(mStateManager.GetActiveShaderProgram()) == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_ARRAY_BUFFER_BINDING:               *params = mStateManager.GetActiveObjectsState()->GetActiveBufferObject(GL_ARRAY_BUFFER)         ? mResourceManager->GetBufferID(mStateManager.GetActiveObjectsState()->GetActiveBufferObject(GL_ARRAY_BUFFER)        ) == 0 ? GL_FALSE : GL_TRUE : GL_FALSE; break;
-    case GL_ELEMENT_ARRAY_BUFFER_BINDING:       *params = mStateManager.GetActiveObjectsState()->GetActiveBufferObject(GL_ELEMENT_ARRAY_BUFFER) ? mResourceManager->GetBufferID(mStateManager.GetActiveObjectsState()->GetActiveBufferObject(GL_ELEMENT_ARRAY_BUFFER)) == 0 ? GL_FALSE : GL_TRUE : GL_FALSE; break;
-    case GL_NUM_SHADER_BINARY_FORMATS:          *params = GLOVE_NUM_SHADER_BINARY_FORMATS == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_COMPRESSED_TEXTURE_FORMATS:         *params = GL_FALSE; break;
-    case GL_NUM_COMPRESSED_TEXTURE_FORMATS:     *params = GL_FALSE; break;
-    case GL_BLEND_COLOR:                        mStateManager.GetFragmentOperationsState()->GetBlendingColor(params); break;
-    case GL_BLEND_DST_ALPHA:                    *params = mStateManager.GetFragmentOperationsState()->GetBlendingFactorDestinationAlpha() == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_BLEND_DST_RGB:                      *params = mStateManager.GetFragmentOperationsState()->GetBlendingFactorDestinationRGB() == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_BLEND_EQUATION_ALPHA:               *params = mStateManager.GetFragmentOperationsState()->GetBlendingEquationAlpha() == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_BLEND_EQUATION_RGB:                 *params = mStateManager.GetFragmentOperationsState()->GetBlendingEquationRGB() == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_BLEND_SRC_ALPHA:                    *params = mStateManager.GetFragmentOperationsState()->GetBlendingFactorSourceAlpha() == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_BLEND_SRC_RGB:                      *params = mStateManager.GetFragmentOperationsState()->GetBlendingFactorSourceRGB() == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_DEPTH_CLEAR_VALUE:                  *params = mStateManager.GetFramebufferOperationsState()->GetClearDepth() == 0.0f ? GL_FALSE : GL_TRUE; break;
-    case GL_PACK_ALIGNMENT:                     *params = mStateManager.GetPixelStorageState()->GetPixelStorePack() == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_UNPACK_ALIGNMENT:                   *params = mStateManager.GetPixelStorageState()->GetPixelStoreUnpack() == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_STENCIL_WRITEMASK:                  *params = mStateManager.GetFramebufferOperationsState()->GetStencilMaskFront() == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_STENCIL_BACK_WRITEMASK:             *params = mStateManager.GetFramebufferOperationsState()->GetStencilMaskBack()  == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_STENCIL_CLEAR_VALUE:                *params = mStateManager.GetFramebufferOperationsState()->GetClearStencil() == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_STENCIL_FUNC:                       *params = mStateManager.GetFragmentOperationsState()->GetStencilTestFuncCompareFront() == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_STENCIL_VALUE_MASK:                 *params = mStateManager.GetFragmentOperationsState()->GetStencilTestFuncMaskFront() == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_STENCIL_REF:                        *params = mStateManager.GetFragmentOperationsState()->GetStencilTestFuncRefFront() == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_STENCIL_FAIL:                       *params = mStateManager.GetFragmentOperationsState()->GetStencilTestOpFailFront() == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_STENCIL_PASS_DEPTH_FAIL:            *params = mStateManager.GetFragmentOperationsState()->GetStencilTestOpZfailFront() == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_STENCIL_PASS_DEPTH_PASS:            *params = mStateManager.GetFragmentOperationsState()->GetStencilTestOpZpassFront() == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_STENCIL_BACK_FUNC:                  *params = mStateManager.GetFragmentOperationsState()->GetStencilTestFuncCompareBack() == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_STENCIL_BACK_FAIL:                  *params = mStateManager.GetFragmentOperationsState()->GetStencilTestOpFailBack() == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_STENCIL_BACK_PASS_DEPTH_FAIL:       *params = mStateManager.GetFragmentOperationsState()->GetStencilTestOpZfailBack() == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_STENCIL_BACK_PASS_DEPTH_PASS:       *params = mStateManager.GetFragmentOperationsState()->GetStencilTestOpZpassBack() == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_STENCIL_BACK_REF:                   *params = mStateManager.GetFragmentOperationsState()->GetStencilTestFuncRefBack() == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_STENCIL_BACK_VALUE_MASK:            *params = mStateManager.GetFragmentOperationsState()->GetStencilTestFuncMaskBack() == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_BLEND:                              *params = mStateManager.GetFragmentOperationsState()->GetBlendingEnabled(); break;
-    case GL_COLOR_WRITEMASK:                    mStateManager.GetFramebufferOperationsState()->GetColorMask(params); break;
-    case GL_COLOR_CLEAR_VALUE:                  mStateManager.GetFramebufferOperationsState()->GetClearColor(params); break;
-    case GL_CULL_FACE:                          *params = mStateManager.GetRasterizationState()->GetCullEnabled(); break;
-    case GL_CULL_FACE_MODE:                     *params = mStateManager.GetRasterizationState()->GetCullFace() == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_DEPTH_TEST:                         *params = mStateManager.GetFragmentOperationsState()->GetDepthTestEnabled(); break;
-    case GL_DEPTH_FUNC:                         *params = mStateManager.GetFragmentOperationsState()->GetDepthTestFunc() == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_DEPTH_WRITEMASK:                    *params = mStateManager.GetFramebufferOperationsState()->GetDepthMask(); break;
-    case GL_DEPTH_RANGE:                        params[0] = mStateManager.GetViewportTransformationState()->GetMinDepthRange() == 0.0f ? GL_FALSE : GL_TRUE;
-                                                params[1] = mStateManager.GetViewportTransformationState()->GetMaxDepthRange() == 0.0f ? GL_FALSE : GL_TRUE; break;
-    case GL_DITHER:                             *params = mStateManager.GetFragmentOperationsState()->GetDitheringEnabled(); break;
-    case GL_FRONT_FACE:                         *params = mStateManager.GetRasterizationState()->GetFrontFace() == 0.0f ? GL_FALSE : GL_TRUE; break;
-    case GL_LINE_WIDTH:                         *params = mStateManager.GetRasterizationState()->GetLineWidth() == 0.0f ? GL_FALSE : GL_TRUE; break;
-    case GL_POLYGON_OFFSET_FILL:                *params = mStateManager.GetRasterizationState()->GetPolygonOffsetFillEnabled(); break;
-    case GL_POLYGON_OFFSET_FACTOR:              *params = mStateManager.GetRasterizationState()->GetPolygonOffsetFactor() == 0.0f ? GL_FALSE : GL_TRUE; break;
-    case GL_POLYGON_OFFSET_UNITS:               *params = mStateManager.GetRasterizationState()->GetPolygonOffsetUnits() == 0.0f ? GL_FALSE : GL_TRUE; break;
-    case GL_GENERATE_MIPMAP_HINT:               *params = mStateManager.GetHintAspectsState()->GetMode(GL_GENERATE_MIPMAP_HINT) == 0 ? GL_FALSE : GL_TRUE; break;
-
-    case GL_SAMPLE_ALPHA_TO_COVERAGE:           *params = mStateManager.GetFragmentOperationsState()->GetSampleAlphaToCoverageEnabled(); break;
-    case GL_SAMPLE_COVERAGE_INVERT:             *params = mStateManager.GetFragmentOperationsState()->GetSampleCoverageInvert(); break;
-    case GL_SAMPLE_COVERAGE_VALUE:              *params = mStateManager.GetFragmentOperationsState()->GetSampleCoverageValue() == 0.0f ? GL_FALSE : GL_TRUE; break;
-    case GL_SAMPLE_COVERAGE:                    *params = mStateManager.GetFragmentOperationsState()->GetSampleCoverageEnabled(); break;
-    case GL_SCISSOR_TEST:                       *params = mStateManager.GetFragmentOperationsState()->GetScissorTestEnabled(); break;
-    case GL_STENCIL_TEST:                       *params = mStateManager.GetFragmentOperationsState()->GetStencilTestEnabled(); break;
-    case GL_SAMPLES:                            *params = mStateManager.GetFragmentOperationsState()->GetSampleCoverageBits() == 0 ? GL_FALSE : GL_TRUE; break;
-    case GL_SAMPLE_BUFFERS:                     *params = mStateManager.GetFragmentOperationsState()->GetMultiSamplingEnabled(); break;
-    case GL_SCISSOR_BOX:                        mStateManager.GetFragmentOperationsState()->GetScissorRect(params); break;
-    case GL_VIEWPORT:                           mStateManager.GetViewportTransformationState()->GetViewportRect(params); break;
-    case GL_MAX_VIEWPORT_DIMS:                  params[0] = GL_TRUE;
-                                                params[1] = GL_TRUE; break;
-    case GL_ALIASED_LINE_WIDTH_RANGE:           params[0] = GL_TRUE;
-                                                params[1] = GL_TRUE; break;
-    case GL_ALIASED_POINT_SIZE_RANGE:           params[0] = GL_TRUE;
-                                                params[1] = GL_TRUE; break;
-    case GL_RED_BITS:                           GlFormatToStorageBits(mWriteFBO->GetColorAttachmentTexture()->GetInternalFormat(), params, nullptr, nullptr, nullptr, nullptr, nullptr); break;
-    case GL_BLUE_BITS:                          GlFormatToStorageBits(mWriteFBO->GetColorAttachmentTexture()->GetInternalFormat(), nullptr, params, nullptr, nullptr, nullptr, nullptr); break;
-    case GL_GREEN_BITS:                         GlFormatToStorageBits(mWriteFBO->GetColorAttachmentTexture()->GetInternalFormat(), nullptr, nullptr, params, nullptr, nullptr, nullptr); break;
-    case GL_ALPHA_BITS:                         GlFormatToStorageBits(mWriteFBO->GetColorAttachmentTexture()->GetInternalFormat(), nullptr, nullptr, nullptr, params, nullptr, nullptr); break;
-    case GL_DEPTH_BITS:                         GlFormatToStorageBits(mWriteFBO->GetDepthAttachmentTexture()   ? mWriteFBO->GetDepthAttachmentTexture()->GetInternalFormat()   : GL_INVALID_VALUE, nullptr, nullptr, nullptr, nullptr, params, nullptr); break;
-    case GL_STENCIL_BITS:                       GlFormatToStorageBits(mWriteFBO->GetStencilAttachmentTexture() ? mWriteFBO->GetStencilAttachmentTexture()->GetInternalFormat() : GL_INVALID_VALUE, nullptr, nullptr, nullptr, nullptr, nullptr, params); break;
-    case GL_SUBPIXEL_BITS:
-    case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS:
-    case GL_MAX_VERTEX_UNIFORM_VECTORS:
-    case GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS:
-    case GL_MAX_VERTEX_ATTRIBS:
-    case GL_MAX_VARYING_VECTORS:
-    case GL_MAX_TEXTURE_IMAGE_UNITS:
-    case GL_MAX_FRAGMENT_UNIFORM_VECTORS:
-    case GL_MAX_RENDERBUFFER_SIZE:
-    case GL_MAX_TEXTURE_SIZE:
-    case GL_MAX_CUBE_MAP_TEXTURE_SIZE:
-    case GL_SHADER_COMPILER:
-    case GL_TEXTURE_BINDING_EXTERNAL_OES:       *params = GL_TRUE; break;
-    default:                                    RecordError(GL_INVALID_ENUM); break;
+    // implementation limits
+    case GL_MAX_VERTEX_ATTRIBS:                 SetQueryIntegers(value, 1, GLOVE_MAX_VERTEX_ATTRIBS); break;
+    case GL_MAX_VERTEX_UNIFORM_VECTORS:         SetQueryIntegers(value, 1, GLOVE_MAX_VERTEX_UNIFORM_VECTORS); break;
+    case GL_MAX_VARYING_VECTORS:                SetQueryIntegers(value, 1, GLOVE_MAX_VARYING_VECTORS); break;
+    case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS:   SetQueryIntegers(value, 1, GLOVE_MAX_COMBINED_TEXTURE_IMAGE_UNITS); break;
+    case GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS:     SetQueryIntegers(value, 1, GLOVE_MAX_VERTEX_TEXTURE_IMAGE_UNITS); break;
+    case GL_MAX_TEXTURE_IMAGE_UNITS:            SetQueryIntegers(value, 1, GLOVE_MAX_TEXTURE_IMAGE_UNITS); break;
+    case GL_MAX_FRAGMENT_UNIFORM_VECTORS:       SetQueryIntegers(value, 1, GLOVE_MAX_FRAGMENT_UNIFORM_VECTORS); break;
+    case GL_MAX_RENDERBUFFER_SIZE:              SetQueryIntegers(value, 1, GLOVE_MAX_RENDERBUFFER_SIZE); break;
+    case GL_MAX_SAMPLES_EXT:                    SetQueryIntegers(value, 1, GetSupportedSamples(VK_SAMPLE_COUNT_64_BIT)); break;
+    case GL_MAX_TEXTURE_SIZE:                   SetQueryIntegers(value, 1, GLOVE_MAX_TEXTURE_SIZE); break;
+    case GL_MAX_CUBE_MAP_TEXTURE_SIZE:          SetQueryIntegers(value, 1, GLOVE_MAX_CUBE_MAP_TEXTURE_SIZE); break;
+    case GL_MAX_3D_TEXTURE_SIZE_OES:            SetQueryIntegers(value, 1, GLOVE_MAX_3D_TEXTURE_SIZE); break;
+    case GL_MAX_VIEWPORT_DIMS:                  SetQueryIntegers(value, 2, GLOVE_MAX_TEXTURE_SIZE, GLOVE_MAX_TEXTURE_SIZE); break;
+    case GL_MAX_SHADER_COMPILER_THREADS_KHR:    SetQueryIntegers(value, 1, static_cast<GLint>(mMaxShaderCompilerThreads)); break;
+    case GL_ALIASED_LINE_WIDTH_RANGE:           SetQueryFloats  (value, 2, 1.0f, 1.0f); break;
+    case GL_ALIASED_POINT_SIZE_RANGE:           SetQueryFloats  (value, 2, 1.0f, 1.0f); break;
+    case GL_SUBPIXEL_BITS:                      SetQueryIntegers(value, 1, GLOVE_SUBPIXEL_BITS); break;
+    case GL_SHADER_COMPILER:                    SetQueryBoolean (value, true); break;
+    case GL_GPU_DISJOINT_EXT:                   SetQueryBoolean (value, false); break;
+    case GL_FRAGMENT_SHADER_DISCARDS_SAMPLES_EXT: SetQueryBoolean(value, false); break;
+    case GL_IMPLEMENTATION_COLOR_READ_FORMAT:   SetQueryIntegers(value, 1, GL_RGBA); break;
+    case GL_IMPLEMENTATION_COLOR_READ_TYPE:     SetQueryIntegers(value, 1, GL_UNSIGNED_BYTE); break;
+    case GL_NUM_SHADER_BINARY_FORMATS:          SetQueryIntegers(value, 1, GLOVE_NUM_SHADER_BINARY_FORMATS); break;
+    case GL_NUM_PROGRAM_BINARY_FORMATS_OES:     SetQueryIntegers(value, 1, GLOVE_NUM_PROGRAM_BINARY_FORMATS); break;
+    case GL_NUM_COMPRESSED_TEXTURE_FORMATS:     SetQueryIntegers(value, 1, static_cast<GLint>(GetCompressedTextureFormats().size())); break;
+    case GL_GPU_MEMORY_INFO_DEDICATED_VIDMEM_NVX:
+    case GL_GPU_MEMORY_INFO_TOTAL_AVAILABLE_MEMORY_NVX:
+    case GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX:
+    case GL_GPU_MEMORY_INFO_EVICTION_COUNT_NVX:
+    case GL_GPU_MEMORY_INFO_EVICTED_MEMORY_NVX: SetQueryIntegers(value, 1, GetGpuMemoryInfo(pname)); break;
+
+    // bindings
+    case GL_ACTIVE_TEXTURE:                     SetQueryIntegers(value, 1, static_cast<GLint>(activeObjects->GetActiveTextureUnit())); break;
+    case GL_TEXTURE_BINDING_2D:                 SetQueryIntegers(value, 1, static_cast<GLint>(mResourceManager->GetTextureID(activeObjects->GetActiveTexture(GL_TEXTURE_2D)))); break;
+    case GL_TEXTURE_BINDING_CUBE_MAP:           SetQueryIntegers(value, 1, static_cast<GLint>(mResourceManager->GetTextureID(activeObjects->GetActiveTexture(GL_TEXTURE_CUBE_MAP)))); break;
+    case GL_TEXTURE_BINDING_3D_OES:             SetQueryIntegers(value, 1, static_cast<GLint>(mResourceManager->GetTextureID(activeObjects->GetActiveTexture(GL_TEXTURE_3D_OES)))); break;
+    case GL_TEXTURE_BINDING_EXTERNAL_OES:       SetQueryIntegers(value, 1, 0); break;
+    case GL_ARRAY_BUFFER_BINDING:
+    case GL_ELEMENT_ARRAY_BUFFER_BINDING:
+    case GL_PIXEL_PACK_BUFFER_BINDING_NV: {
+        GLenum target = pname == GL_ARRAY_BUFFER_BINDING         ? GL_ARRAY_BUFFER         :
+                        pname == GL_ELEMENT_ARRAY_BUFFER_BINDING ? GL_ELEMENT_ARRAY_BUFFER : GL_PIXEL_PACK_BUFFER_NV;
+        BufferObject *bo = activeObjects->GetActiveBufferObject(target);
+        SetQueryIntegers(value, 1, bo ? static_cast<GLint>(mResourceManager->GetBufferID(bo)) : 0);
+        break;
     }
+    case GL_VERTEX_ARRAY_BINDING_OES:           SetQueryIntegers(value, 1, static_cast<GLint>(mResourceManager->GetVertexArrayID(mResourceManager->GetActiveVertexArray()))); break;
+    case GL_FRAMEBUFFER_BINDING:                SetQueryIntegers(value, 1, static_cast<GLint>(activeObjects->GetActiveFramebufferObjectID())); break;
+    case GL_READ_FRAMEBUFFER_BINDING_NV:        SetQueryIntegers(value, 1, static_cast<GLint>(mReadFBO ? mReadFBOId : activeObjects->GetActiveFramebufferObjectID())); break;
+    case GL_RENDERBUFFER_BINDING:               SetQueryIntegers(value, 1, static_cast<GLint>(activeObjects->GetActiveRenderbufferObjectID())); break;
+    case GL_CURRENT_PROGRAM:                    SetQueryIntegers(value, 1, static_cast<GLint>(GetProgramId(mStateManager.GetActiveShaderProgram()))); break;
+
+    // framebuffer, read from the bound FBO without validating or updating its attachments
+    case GL_RED_BITS:
+    case GL_GREEN_BITS:
+    case GL_BLUE_BITS:
+    case GL_ALPHA_BITS:                         SetQueryIntegers(value, 1, GetAttachmentBits(mWriteFBO->GetColorAttachmentTexture(), pname)); break;
+    case GL_DEPTH_BITS:                         SetQueryIntegers(value, 1, GetAttachmentBits(mWriteFBO->GetDepthAttachmentTexture(), pname)); break;
+    case GL_STENCIL_BITS:                       SetQueryIntegers(value, 1, GetAttachmentBits(mWriteFBO->GetStencilAttachmentTexture(), pname)); break;
+    case GL_SAMPLES:                            SetQueryIntegers(value, 1, mWriteFBO->GetSamples()); break;
+    case GL_SAMPLE_BUFFERS:                     SetQueryIntegers(value, 1, mWriteFBO->GetSamples() > 1 ? 1 : 0); break;
+
+    // capabilities
+    case GL_BLEND:                              SetQueryBoolean(value, fragment->GetBlendingEnabled()); break;
+    case GL_CULL_FACE:                          SetQueryBoolean(value, rasterization->GetCullEnabled()); break;
+    case GL_DEPTH_TEST:                         SetQueryBoolean(value, fragment->GetDepthTestEnabled()); break;
+    case GL_DITHER:                             SetQueryBoolean(value, fragment->GetDitheringEnabled()); break;
+    case GL_POLYGON_OFFSET_FILL:                SetQueryBoolean(value, rasterization->GetPolygonOffsetFillEnabled()); break;
+    case GL_SAMPLE_ALPHA_TO_COVERAGE:           SetQueryBoolean(value, fragment->GetSampleAlphaToCoverageEnabled()); break;
+    case GL_SAMPLE_COVERAGE:                    SetQueryBoolean(value, fragment->GetSampleCoverageEnabled()); break;
+    case GL_SCISSOR_TEST:                       SetQueryBoolean(value, fragment->GetScissorTestEnabled()); break;
+    case GL_STENCIL_TEST:                       SetQueryBoolean(value, fragment->GetStencilTestEnabled()); break;
+
+    // rasterization and viewport
+    case GL_CULL_FACE_MODE:                     SetQueryIntegers(value, 1, static_cast<GLint>(rasterization->GetCullFace())); break;
+    case GL_FRONT_FACE:                         SetQueryIntegers(value, 1, static_cast<GLint>(rasterization->GetFrontFace())); break;
+    case GL_LINE_WIDTH:                         SetQueryFloats  (value, 1, rasterization->GetLineWidth()); break;
+    case GL_POLYGON_OFFSET_FACTOR:              SetQueryFloats  (value, 1, rasterization->GetPolygonOffsetFactor()); break;
+    case GL_POLYGON_OFFSET_UNITS:               SetQueryFloats  (value, 1, rasterization->GetPolygonOffsetUnits()); break;
+    case GL_VIEWPORT:                           value->type = stateQueryValue_t::QUERY_INTEGER; value->count = 4; viewport->GetViewportRect(value->i); break;
+    case GL_DEPTH_RANGE:                        SetQueryFloats  (value, 2, viewport->GetMinDepthRange(), viewport->GetMaxDepthRange());
+                                                value->type = stateQueryValue_t::QUERY_NORMALIZED; break;
+    case GL_GENERATE_MIPMAP_HINT:               SetQueryIntegers(value, 1, static_cast<GLint>(mStateManager.GetHintAspectsState()->GetMode(GL_GENERATE_MIPMAP_HINT))); break;
+    case GL_PACK_ALIGNMENT:                     SetQueryIntegers(value, 1, static_cast<GLint>(mStateManager.GetPixelStorageState()->GetPixelStorePack())); break;
+    case GL_UNPACK_ALIGNMENT:                   SetQueryIntegers(value, 1, static_cast<GLint>(mStateManager.GetPixelStorageState()->GetPixelStoreUnpack())); break;
+    case GL_UNPACK_ROW_LENGTH_EXT:              SetQueryIntegers(value, 1, mStateManager.GetPixelStorageState()->GetUnpackRowLength()); break;
+    case GL_UNPACK_SKIP_ROWS_EXT:               SetQueryIntegers(value, 1, mStateManager.GetPixelStorageState()->GetUnpackSkipRows()); break;
+    case GL_UNPACK_SKIP_PIXELS_EXT:             SetQueryIntegers(value, 1, mStateManager.GetPixelStorageState()->GetUnpackSkipPixels()); break;
+
+    // fragment operations
+    case GL_SCISSOR_BOX:                        value->type = stateQueryValue_t::QUERY_INTEGER; value->count = 4; fragment->GetScissorRect(value->i); break;
+    case GL_SAMPLE_COVERAGE_VALUE:              SetQueryFloats  (value, 1, fragment->GetSampleCoverageValue()); break;
+    case GL_SAMPLE_COVERAGE_INVERT:             SetQueryBoolean (value, fragment->GetSampleCoverageInvert()); break;
+    case GL_DEPTH_FUNC:                         SetQueryIntegers(value, 1, static_cast<GLint>(fragment->GetDepthTestFunc())); break;
+    case GL_BLEND_COLOR:                        value->type = stateQueryValue_t::QUERY_NORMALIZED; value->count = 4; fragment->GetBlendingColor(value->f); break;
+    case GL_BLEND_SRC_RGB:                      SetQueryIntegers(value, 1, static_cast<GLint>(fragment->GetBlendingFactorSourceRGB())); break;
+    case GL_BLEND_SRC_ALPHA:                    SetQueryIntegers(value, 1, static_cast<GLint>(fragment->GetBlendingFactorSourceAlpha())); break;
+    case GL_BLEND_DST_RGB:                      SetQueryIntegers(value, 1, static_cast<GLint>(fragment->GetBlendingFactorDestinationRGB())); break;
+    case GL_BLEND_DST_ALPHA:                    SetQueryIntegers(value, 1, static_cast<GLint>(fragment->GetBlendingFactorDestinationAlpha())); break;
+    case GL_BLEND_EQUATION_RGB:                 SetQueryIntegers(value, 1, static_cast<GLint>(fragment->GetBlendingEquationRGB())); break;
+    case GL_BLEND_EQUATION_ALPHA:               SetQueryIntegers(value, 1, static_cast<GLint>(fragment->GetBlendingEquationAlpha())); break;
+    case GL_STENCIL_FUNC:                       SetQueryIntegers(value, 1, static_cast<GLint>(fragment->GetStencilTestFuncCompareFront())); break;
+    case GL_STENCIL_VALUE_MASK:                 SetQueryIntegers(value, 1, static_cast<GLint>(fragment->GetStencilTestFuncMaskFront())); break;
+    case GL_STENCIL_REF:                        SetQueryIntegers(value, 1, static_cast<GLint>(fragment->GetStencilTestFuncRefFront())); break;
+    case GL_STENCIL_FAIL:                       SetQueryIntegers(value, 1, static_cast<GLint>(fragment->GetStencilTestOpFailFront())); break;
+    case GL_STENCIL_PASS_DEPTH_FAIL:            SetQueryIntegers(value, 1, static_cast<GLint>(fragment->GetStencilTestOpZfailFront())); break;
+    case GL_STENCIL_PASS_DEPTH_PASS:            SetQueryIntegers(value, 1, static_cast<GLint>(fragment->GetStencilTestOpZpassFront())); break;
+    case GL_STENCIL_BACK_FUNC:                  SetQueryIntegers(value, 1, static_cast<GLint>(fragment->GetStencilTestFuncCompareBack())); break;
+    case GL_STENCIL_BACK_VALUE_MASK:            SetQueryIntegers(value, 1, static_cast<GLint>(fragment->GetStencilTestFuncMaskBack())); break;
+    case GL_STENCIL_BACK_REF:                   SetQueryIntegers(value, 1, static_cast<GLint>(fragment->GetStencilTestFuncRefBack())); break;
+    case GL_STENCIL_BACK_FAIL:                  SetQueryIntegers(value, 1, static_cast<GLint>(fragment->GetStencilTestOpFailBack())); break;
+    case GL_STENCIL_BACK_PASS_DEPTH_FAIL:       SetQueryIntegers(value, 1, static_cast<GLint>(fragment->GetStencilTestOpZfailBack())); break;
+    case GL_STENCIL_BACK_PASS_DEPTH_PASS:       SetQueryIntegers(value, 1, static_cast<GLint>(fragment->GetStencilTestOpZpassBack())); break;
+
+    // framebuffer operations
+    case GL_COLOR_WRITEMASK:                    value->type = stateQueryValue_t::QUERY_BOOLEAN; value->count = 4; framebuffer->GetColorMask(value->i); break;
+    case GL_DEPTH_WRITEMASK:                    SetQueryBoolean (value, framebuffer->GetDepthMask()); break;
+    case GL_STENCIL_WRITEMASK:                  SetQueryIntegers(value, 1, static_cast<GLint>(framebuffer->GetStencilMaskFront())); break;
+    case GL_STENCIL_BACK_WRITEMASK:             SetQueryIntegers(value, 1, static_cast<GLint>(framebuffer->GetStencilMaskBack())); break;
+    case GL_COLOR_CLEAR_VALUE:                  value->type = stateQueryValue_t::QUERY_NORMALIZED; value->count = 4; framebuffer->GetClearColor(value->f); break;
+    case GL_DEPTH_CLEAR_VALUE:                  SetQueryFloats  (value, 1, framebuffer->GetClearDepth());
+                                                value->type = stateQueryValue_t::QUERY_NORMALIZED; break;
+    case GL_STENCIL_CLEAR_VALUE:                SetQueryIntegers(value, 1, static_cast<GLint>(framebuffer->GetClearStencil())); break;
+
+    default:                                    return false;
+    }
+
+    return true;
 }
 
+template<typename T>
+void
+Context::GetStateValues(GLenum pname, T *params)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
 
+    stateQueryValue_t value;
+
+    // the lists are the only queries of a variable length
+    switch(pname) {
+    case GL_COMPRESSED_TEXTURE_FORMATS:
+        SetQueryIntegers(&value, 1, 0);
+        for(const auto &format : GetCompressedTextureFormats()) {
+            value.i[0] = static_cast<GLint>(format.first);
+            ConvertStateValue(value, 0, params++);
+        }
+        return;
+    case GL_PROGRAM_BINARY_FORMATS_OES:
+        SetQueryIntegers(&value, 1, 0);
+        for(uint32_t i = 0; i < GLOVE_NUM_PROGRAM_BINARY_FORMATS; ++i) {
+            value.i[0] = static_cast<GLint>(glove_program_binary_formats[i]);
+            ConvertStateValue(value, 0, params++);
+        }
+        return;
+    default:
+        break;
+    }
+
+    if(!QueryState(pname, &value)) {
+        RecordError(GL_INVALID_ENUM);
+        return;
+    }
+
+    for(uint32_t i = 0; i < value.count; ++i) {
+        ConvertStateValue(value, i, &params[i]);
+    }
+}
+
+void
+Context::GetBooleanv(GLenum pname, GLboolean* params)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    GetStateValues(pname, params);
+}
 
 void
 Context::GetIntegerv(GLenum pname, GLint* params)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    switch(pname) {
-    case GL_MAX_VERTEX_ATTRIBS:                 *params = GLOVE_MAX_VERTEX_ATTRIBS; break;
-    case GL_MAX_VERTEX_UNIFORM_VECTORS:         *params = GLOVE_MAX_VERTEX_UNIFORM_VECTORS; break;
-    case GL_MAX_VARYING_VECTORS:                *params = GLOVE_MAX_VARYING_VECTORS; break;
-    case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS:   *params = GLOVE_MAX_COMBINED_TEXTURE_IMAGE_UNITS; break;
-    case GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS:     *params = GLOVE_MAX_VERTEX_TEXTURE_IMAGE_UNITS; break;
-    case GL_MAX_TEXTURE_IMAGE_UNITS:            *params = GLOVE_MAX_TEXTURE_IMAGE_UNITS; break;
-    case GL_MAX_FRAGMENT_UNIFORM_VECTORS:       *params = GLOVE_MAX_FRAGMENT_UNIFORM_VECTORS; break;
-    case GL_MAX_RENDERBUFFER_SIZE:              *params = GLOVE_MAX_RENDERBUFFER_SIZE; break;
-    case GL_MAX_TEXTURE_SIZE:                   *params = GLOVE_MAX_TEXTURE_SIZE; break;
-    case GL_MAX_CUBE_MAP_TEXTURE_SIZE:          *params = GLOVE_MAX_CUBE_MAP_TEXTURE_SIZE; break;
-    case GL_MAX_VIEWPORT_DIMS:                  params[0] = GLOVE_MAX_TEXTURE_SIZE;
-                                                params[1] = GLOVE_MAX_TEXTURE_SIZE; break;
-    case GL_FRAMEBUFFER_BINDING:                *params = mStateManager.GetActiveObjectsState()->GetActiveFramebufferObjectID(); break;
-    case GL_RENDERBUFFER_BINDING:               *params = mStateManager.GetActiveObjectsState()->GetActiveRenderbufferObjectID(); break;
-    case GL_CURRENT_PROGRAM:                    *params = GetProgramId(mStateManager.GetActiveShaderProgram()); break;
-    case GL_IMPLEMENTATION_COLOR_READ_FORMAT:   *params = GL_RGBA; break;
-    case GL_IMPLEMENTATION_COLOR_READ_TYPE:     *params = GL_UNSIGNED_BYTE; break;
-    case GL_ARRAY_BUFFER_BINDING:               *params = mStateManager.GetActiveObjectsState()->GetActiveBufferObject(GL_ARRAY_BUFFER)         ? mResourceManager->GetBufferID(mStateManager.GetActiveObjectsState()->GetActiveBufferObject(GL_ARRAY_BUFFER))   : 0; break;
-    case GL_ELEMENT_ARRAY_BUFFER_BINDING:       *params = mStateManager.GetActiveObjectsState()->GetActiveBufferObject(GL_ELEMENT_ARRAY_BUFFER) ? mResourceManager->GetBufferID(mStateManager.GetActiveObjectsState()->GetActiveBufferObject(GL_ELEMENT_ARRAY_BUFFER)) : 0; break;
-    case GL_RED_BITS:                           GlFormatToStorageBits(mWriteFBO->GetColorAttachmentTexture()->GetInternalFormat(), params, NULL, NULL, NULL, NULL, NULL); break;
-    case GL_BLUE_BITS:                          GlFormatToStorageBits(mWriteFBO->GetColorAttachmentTexture()->GetInternalFormat(), NULL, params, NULL, NULL, NULL, NULL); break;
-    case GL_GREEN_BITS:                         GlFormatToStorageBits(mWriteFBO->GetColorAttachmentTexture()->GetInternalFormat(), NULL, NULL, params, NULL, NULL, NULL); break;
-    case GL_ALPHA_BITS:                         GlFormatToStorageBits(mWriteFBO->GetColorAttachmentTexture()->GetInternalFormat(), NULL, NULL, NULL, params, NULL, NULL); break;
-    case GL_DEPTH_BITS:                         GlFormatToStorageBits(mWriteFBO->GetDepthAttachmentTexture()   ? mWriteFBO->GetDepthAttachmentTexture()->GetInternalFormat()   : GL_INVALID_VALUE, NULL, NULL, NULL, NULL, params, NULL); break;
-    case GL_STENCIL_BITS:                       GlFormatToStorageBits(mWriteFBO->GetStencilAttachmentTexture() ? mWriteFBO->GetStencilAttachmentTexture()->GetInternalFormat() : GL_INVALID_VALUE, NULL, NULL, NULL, NULL, NULL, params); break;
-    case GL_GENERATE_MIPMAP_HINT:               *params = static_cast<GLint>(mStateManager.GetHintAspectsState()->GetMode(GL_GENERATE_MIPMAP_HINT)); break;
-    case GL_BLEND:                              *params = mStateManager.GetFragmentOperationsState()->GetBlendingEnabled(); break;
-    case GL_COLOR_CLEAR_VALUE:                  mStateManager.GetFramebufferOperationsState()->GetClearColor(params); break;
-    case GL_COLOR_WRITEMASK:                    mStateManager.GetFramebufferOperationsState()->GetColorMask(params); break;
-    case GL_CULL_FACE:                          *params = mStateManager.GetRasterizationState()->GetCullEnabled(); break;
-    case GL_CULL_FACE_MODE:                     *params = mStateManager.GetRasterizationState()->GetCullFace(); break;
-    case GL_DEPTH_TEST:                         *params = mStateManager.GetFragmentOperationsState()->GetDepthTestEnabled(); break;
-    case GL_DEPTH_WRITEMASK:                    *params = mStateManager.GetFramebufferOperationsState()->GetDepthMask(); break;
-    case GL_DEPTH_CLEAR_VALUE:                  *params = mStateManager.GetFramebufferOperationsState()->GetClearDepth() == 1.0f ?
-                                                          0x7fffffff :  static_cast<GLint>(mStateManager.GetFramebufferOperationsState()->GetClearDepth() * 0x7fffffff); break;
-    case GL_DEPTH_FUNC:                         *params = mStateManager.GetFragmentOperationsState()->GetDepthTestFunc(); break;
-    case GL_DEPTH_RANGE:                        params[0] = mStateManager.GetViewportTransformationState()->GetMinDepthRange() == 1.0f ?
-                                                          0x7fffffff :  static_cast<GLint>(mStateManager.GetViewportTransformationState()->GetMinDepthRange() * 0x7fffffff);
-                                                params[1] = mStateManager.GetViewportTransformationState()->GetMaxDepthRange() == 1.0f ?
-                                                          0x7fffffff :  static_cast<GLint>(mStateManager.GetViewportTransformationState()->GetMaxDepthRange() * 0x7fffffff); break;
-    case GL_DITHER:                             *params = mStateManager.GetFragmentOperationsState()->GetDitheringEnabled(); break;
-    case GL_FRONT_FACE:                         *params = mStateManager.GetRasterizationState()->GetFrontFace(); break;
-    case GL_LINE_WIDTH:                         *params = static_cast<GLint>(mStateManager.GetRasterizationState()->GetLineWidth()); break;
-    case GL_PACK_ALIGNMENT:                     *params = mStateManager.GetPixelStorageState()->GetPixelStorePack(); break;
-    case GL_POLYGON_OFFSET_FACTOR:              *params = static_cast<GLint>(std::roundf(mStateManager.GetRasterizationState()->GetPolygonOffsetFactor())); break;
-    case GL_POLYGON_OFFSET_UNITS:               *params = static_cast<GLint>(std::roundf(mStateManager.GetRasterizationState()->GetPolygonOffsetUnits())); break;
-    case GL_POLYGON_OFFSET_FILL:                *params = mStateManager.GetRasterizationState()->GetPolygonOffsetFillEnabled(); break;
-    case GL_SCISSOR_BOX:                        mStateManager.GetFragmentOperationsState()->GetScissorRect(params); break;
-    case GL_UNPACK_ALIGNMENT:                   *params = mStateManager.GetPixelStorageState()->GetPixelStoreUnpack(); break;
-    case GL_VIEWPORT:                           mStateManager.GetViewportTransformationState()->GetViewportRect(params); break;
-    case GL_SCISSOR_TEST:                       *params = mStateManager.GetFragmentOperationsState()->GetScissorTestEnabled(); break;
-    case GL_STENCIL_TEST:                       *params = mStateManager.GetFragmentOperationsState()->GetStencilTestEnabled(); break;
-    case GL_ALIASED_LINE_WIDTH_RANGE:           params[0] = 1;
-                                                params[1] = 1; break;
-    case GL_ALIASED_POINT_SIZE_RANGE:           params[0] = 1;
-                                                params[1] = 1; break;
-    case GL_COMPRESSED_TEXTURE_FORMATS:         *params = 0; break;
-    case GL_NUM_COMPRESSED_TEXTURE_FORMATS:     *params = 0; break;
-    case GL_SAMPLES:                            *params = static_cast<GLint>(mStateManager.GetFragmentOperationsState()->GetSampleCoverageBits()); break;
-    case GL_SAMPLE_BUFFERS:                     *params = mStateManager.GetFragmentOperationsState()->GetMultiSamplingEnabled(); break;
-    case GL_SAMPLE_COVERAGE:                    *params = mStateManager.GetFragmentOperationsState()->GetSampleCoverageEnabled(); break;
-    case GL_SAMPLE_COVERAGE_INVERT:             *params = static_cast<GLint>(mStateManager.GetFragmentOperationsState()->GetSampleCoverageInvert()); break;
-    case GL_SAMPLE_COVERAGE_VALUE:              *params = static_cast<GLint>(roundf(mStateManager.GetFragmentOperationsState()->GetSampleCoverageValue())); break;
-    case GL_SAMPLE_ALPHA_TO_COVERAGE:           *params = mStateManager.GetFragmentOperationsState()->GetSampleAlphaToCoverageEnabled(); break;
-    case GL_SHADER_COMPILER:                    *params = 1; break;
-    case GL_SUBPIXEL_BITS:                      *params = static_cast<GLint>(GLOVE_SUBPIXEL_BITS); break;
-    case GL_TEXTURE_BINDING_2D:                 *params = static_cast<GLint>(mResourceManager->GetTextureID(mStateManager.GetActiveObjectsState()->GetActiveTexture(GL_TEXTURE_2D))); break;
-    case GL_TEXTURE_BINDING_CUBE_MAP:           *params = static_cast<GLint>(mResourceManager->GetTextureID(mStateManager.GetActiveObjectsState()->GetActiveTexture(GL_TEXTURE_CUBE_MAP))); break;
-    case GL_ACTIVE_TEXTURE:                     *params = static_cast<GLint>(mStateManager.GetActiveObjectsState()->GetActiveTextureUnit()); break;
-    case GL_STENCIL_WRITEMASK:                  *params = static_cast<GLint>(mStateManager.GetFramebufferOperationsState()->GetStencilMaskFront()); break;
-    case GL_STENCIL_BACK_WRITEMASK:             *params = static_cast<GLint>(mStateManager.GetFramebufferOperationsState()->GetStencilMaskBack());  break;
-    case GL_STENCIL_CLEAR_VALUE:                *params = static_cast<GLint>(mStateManager.GetFramebufferOperationsState()->GetClearStencil()); break;
-    case GL_STENCIL_FUNC:                       *params = static_cast<GLint>(mStateManager.GetFragmentOperationsState()->GetStencilTestFuncCompareFront()); break;
-    case GL_STENCIL_VALUE_MASK:                 *params = static_cast<GLint>(mStateManager.GetFragmentOperationsState()->GetStencilTestFuncMaskFront()); break;
-    case GL_STENCIL_REF:                        *params = static_cast<GLint>(mStateManager.GetFragmentOperationsState()->GetStencilTestFuncRefFront()); break;
-    case GL_STENCIL_FAIL:                       *params = static_cast<GLint>(mStateManager.GetFragmentOperationsState()->GetStencilTestOpFailFront()); break;
-    case GL_STENCIL_PASS_DEPTH_FAIL:            *params = static_cast<GLint>(mStateManager.GetFragmentOperationsState()->GetStencilTestOpZfailFront()); break;
-    case GL_STENCIL_PASS_DEPTH_PASS:            *params = static_cast<GLint>(mStateManager.GetFragmentOperationsState()->GetStencilTestOpZpassFront()); break;
-    case GL_STENCIL_BACK_FUNC:                  *params = static_cast<GLint>(mStateManager.GetFragmentOperationsState()->GetStencilTestFuncCompareBack()); break;
-    case GL_STENCIL_BACK_FAIL:                  *params = static_cast<GLint>(mStateManager.GetFragmentOperationsState()->GetStencilTestOpFailBack()); break;
-    case GL_STENCIL_BACK_PASS_DEPTH_FAIL:       *params = static_cast<GLint>(mStateManager.GetFragmentOperationsState()->GetStencilTestOpZfailBack()); break;
-    case GL_STENCIL_BACK_PASS_DEPTH_PASS:       *params = static_cast<GLint>(mStateManager.GetFragmentOperationsState()->GetStencilTestOpZpassBack()); break;
-    case GL_STENCIL_BACK_REF:                   *params = static_cast<GLint>(mStateManager.GetFragmentOperationsState()->GetStencilTestFuncRefBack()); break;
-    case GL_STENCIL_BACK_VALUE_MASK:            *params = static_cast<GLint>(mStateManager.GetFragmentOperationsState()->GetStencilTestFuncMaskBack()); break;
-    case GL_BLEND_COLOR:                        mStateManager.GetFragmentOperationsState()->GetBlendingColor(params); break;
-    case GL_BLEND_DST_ALPHA:                    *params = static_cast<GLint>(mStateManager.GetFragmentOperationsState()->GetBlendingFactorDestinationAlpha()); break;
-    case GL_BLEND_DST_RGB:                      *params = static_cast<GLint>(mStateManager.GetFragmentOperationsState()->GetBlendingFactorDestinationRGB()); break;
-    case GL_BLEND_EQUATION_ALPHA:               *params = static_cast<GLint>(mStateManager.GetFragmentOperationsState()->GetBlendingEquationAlpha()); break;
-    case GL_BLEND_EQUATION_RGB:                 *params = static_cast<GLint>(mStateManager.GetFragmentOperationsState()->GetBlendingEquationRGB()); break;
-    case GL_BLEND_SRC_ALPHA:                    *params = static_cast<GLint>(mStateManager.GetFragmentOperationsState()->GetBlendingFactorSourceAlpha()); break;
-    case GL_BLEND_SRC_RGB:                      *params = static_cast<GLint>(mStateManager.GetFragmentOperationsState()->GetBlendingFactorSourceRGB()); break;
-    case GL_NUM_SHADER_BINARY_FORMATS:          *params = GLOVE_NUM_SHADER_BINARY_FORMATS; break;
-    case GL_NUM_PROGRAM_BINARY_FORMATS_OES:     *params = GLOVE_NUM_PROGRAM_BINARY_FORMATS; break;
-    case GL_PROGRAM_BINARY_FORMATS_OES:         params = reinterpret_cast<GLint *>(&glove_program_binary_formats); break;
-    default:                                    RecordError(GL_INVALID_ENUM); break;
-    }
+    GetStateValues(pname, params);
 }
 
 void
@@ -241,99 +366,7 @@ Context::GetFloatv(GLenum pname, GLfloat* params)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    switch(pname) {
-    case GL_ARRAY_BUFFER_BINDING:               *params = mStateManager.GetActiveObjectsState()->GetActiveBufferObject(GL_ARRAY_BUFFER) ? static_cast<GLfloat>(mResourceManager->GetBufferID(mStateManager.GetActiveObjectsState()->GetActiveBufferObject(GL_ARRAY_BUFFER))) : 0; break;
-    case GL_BLEND:                              *params = static_cast<GLfloat>(mStateManager.GetFragmentOperationsState()->GetBlendingEnabled()); break;
-    case GL_BLEND_COLOR:                        mStateManager.GetFragmentOperationsState()->GetBlendingColor(params); break;
-    case GL_BLEND_DST_ALPHA:                    *params = static_cast<GLfloat>(mStateManager.GetFragmentOperationsState()->GetBlendingFactorDestinationAlpha()); break;
-    case GL_BLEND_DST_RGB:                      *params = static_cast<GLfloat>(mStateManager.GetFragmentOperationsState()->GetBlendingFactorDestinationRGB()); break;
-    case GL_BLEND_EQUATION_ALPHA:               *params = static_cast<GLfloat>(mStateManager.GetFragmentOperationsState()->GetBlendingEquationAlpha()); break;
-    case GL_BLEND_EQUATION_RGB:                 *params = static_cast<GLfloat>(mStateManager.GetFragmentOperationsState()->GetBlendingEquationRGB()); break;
-    case GL_BLEND_SRC_ALPHA:                    *params = static_cast<GLfloat>(mStateManager.GetFragmentOperationsState()->GetBlendingFactorSourceAlpha()); break;
-    case GL_BLEND_SRC_RGB:                      *params = static_cast<GLfloat>(mStateManager.GetFragmentOperationsState()->GetBlendingFactorSourceRGB()); break;
-    case GL_COLOR_CLEAR_VALUE:                  mStateManager.GetFramebufferOperationsState()->GetClearColor(params); break;
-    case GL_COLOR_WRITEMASK:                    mStateManager.GetFramebufferOperationsState()->GetColorMask(params); break;
-    case GL_CULL_FACE:                          *params = static_cast<GLfloat>(mStateManager.GetRasterizationState()->GetCullEnabled()); break;
-    case GL_CULL_FACE_MODE:                     *params = static_cast<GLfloat>(mStateManager.GetRasterizationState()->GetCullFace()); break;
-    case GL_CURRENT_PROGRAM:                    *params = static_cast<GLfloat>(GetProgramId(mStateManager.GetActiveShaderProgram())); break;
-    case GL_DEPTH_CLEAR_VALUE:                  *params = mStateManager.GetFramebufferOperationsState()->GetClearDepth(); break;
-    case GL_DEPTH_FUNC:                         *params = static_cast<GLfloat>(mStateManager.GetFragmentOperationsState()->GetDepthTestFunc()); break;
-    case GL_DEPTH_TEST:                         *params = static_cast<GLfloat>(mStateManager.GetFragmentOperationsState()->GetDepthTestEnabled()); break;
-    case GL_DEPTH_WRITEMASK:                    *params = static_cast<GLfloat>(mStateManager.GetFramebufferOperationsState()->GetDepthMask()); break;
-    case GL_DITHER:                             *params = static_cast<GLfloat>(mStateManager.GetFragmentOperationsState()->GetDitheringEnabled()); break;
-    case GL_ELEMENT_ARRAY_BUFFER_BINDING:       *params = mStateManager.GetActiveObjectsState()->GetActiveBufferObject(GL_ELEMENT_ARRAY_BUFFER) ? static_cast<GLfloat>(mResourceManager->GetBufferID(mStateManager.GetActiveObjectsState()->GetActiveBufferObject(GL_ELEMENT_ARRAY_BUFFER))) : 0; break;
-    case GL_FRAMEBUFFER_BINDING:                *params = static_cast<GLfloat>(mStateManager.GetActiveObjectsState()->GetActiveFramebufferObjectID()); break;
-    case GL_FRONT_FACE:                         *params = static_cast<GLfloat>(mStateManager.GetRasterizationState()->GetFrontFace()); break;
-    case GL_IMPLEMENTATION_COLOR_READ_FORMAT:   *params = GL_RGBA; break;
-    case GL_IMPLEMENTATION_COLOR_READ_TYPE:     *params = GL_UNSIGNED_BYTE; break;
-    case GL_LINE_WIDTH:                         *params = mStateManager.GetRasterizationState()->GetLineWidth(); break;
-    case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS:   *params = GLOVE_MAX_COMBINED_TEXTURE_IMAGE_UNITS; break;
-    case GL_MAX_CUBE_MAP_TEXTURE_SIZE:          *params = GLOVE_MAX_CUBE_MAP_TEXTURE_SIZE; break;
-    case GL_MAX_FRAGMENT_UNIFORM_VECTORS:       *params = GLOVE_MAX_FRAGMENT_UNIFORM_VECTORS; break;
-    case GL_MAX_RENDERBUFFER_SIZE:              *params = GLOVE_MAX_RENDERBUFFER_SIZE; break;
-    case GL_MAX_TEXTURE_IMAGE_UNITS:            *params = GLOVE_MAX_TEXTURE_IMAGE_UNITS; break;
-    case GL_MAX_TEXTURE_SIZE:                   *params = GLOVE_MAX_TEXTURE_SIZE; break;
-    case GL_MAX_VARYING_VECTORS:                *params = GLOVE_MAX_VARYING_VECTORS; break;
-    case GL_MAX_VERTEX_ATTRIBS:                 *params = GLOVE_MAX_VERTEX_ATTRIBS; break;
-    case GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS:     *params = GLOVE_MAX_VERTEX_TEXTURE_IMAGE_UNITS; break;
-    case GL_MAX_VERTEX_UNIFORM_VECTORS:         *params = GLOVE_MAX_VERTEX_UNIFORM_VECTORS; break;
-    case GL_MAX_VIEWPORT_DIMS:                  params[0] = GLOVE_MAX_TEXTURE_SIZE;
-                                                params[1] = GLOVE_MAX_TEXTURE_SIZE; break;
-    case GL_NUM_SHADER_BINARY_FORMATS:          *params = GLOVE_NUM_SHADER_BINARY_FORMATS; break;
-    case GL_NUM_PROGRAM_BINARY_FORMATS_OES:     *params = GLOVE_NUM_PROGRAM_BINARY_FORMATS; break;
-    case GL_PACK_ALIGNMENT:                     *params = static_cast<GLfloat>(mStateManager.GetPixelStorageState()->GetPixelStorePack()); break;
-    case GL_POLYGON_OFFSET_FACTOR:              *params = mStateManager.GetRasterizationState()->GetPolygonOffsetFactor(); break;
-    case GL_POLYGON_OFFSET_FILL:                *params = static_cast<GLfloat>(mStateManager.GetRasterizationState()->GetPolygonOffsetFillEnabled()); break;
-    case GL_POLYGON_OFFSET_UNITS:               *params = mStateManager.GetRasterizationState()->GetPolygonOffsetUnits(); break;
-    case GL_RENDERBUFFER_BINDING:               *params = static_cast<GLfloat>(mStateManager.GetActiveObjectsState()->GetActiveRenderbufferObjectID()); break;
-    case GL_SAMPLE_ALPHA_TO_COVERAGE:           *params = static_cast<GLfloat>(mStateManager.GetFragmentOperationsState()->GetSampleAlphaToCoverageEnabled()); break;
-    case GL_SAMPLE_COVERAGE:                    *params = static_cast<GLfloat>(mStateManager.GetFragmentOperationsState()->GetSampleCoverageEnabled()); break;
-    case GL_SCISSOR_BOX:                        mStateManager.GetFragmentOperationsState()->GetScissorRect(params); break;
-    case GL_SCISSOR_TEST:                       *params = static_cast<GLfloat>(mStateManager.GetFragmentOperationsState()->GetScissorTestEnabled()); break;
-    case GL_STENCIL_TEST:                       *params = static_cast<GLfloat>(mStateManager.GetFragmentOperationsState()->GetStencilTestEnabled()); break;
-    case GL_UNPACK_ALIGNMENT:                   *params = static_cast<GLfloat>(mStateManager.GetPixelStorageState()->GetPixelStoreUnpack()); break;
-    case GL_VIEWPORT:                           mStateManager.GetViewportTransformationState()->GetViewportRect(params); break;
-    case GL_RED_BITS:                           GlFormatToStorageBits(mWriteFBO->GetColorAttachmentTexture()->GetInternalFormat(), params, NULL, NULL, NULL, NULL, NULL); break;
-    case GL_BLUE_BITS:                          GlFormatToStorageBits(mWriteFBO->GetColorAttachmentTexture()->GetInternalFormat(), NULL, params, NULL, NULL, NULL, NULL); break;
-    case GL_GREEN_BITS:                         GlFormatToStorageBits(mWriteFBO->GetColorAttachmentTexture()->GetInternalFormat(), NULL, NULL, params, NULL, NULL, NULL); break;
-    case GL_ALPHA_BITS:                         GlFormatToStorageBits(mWriteFBO->GetColorAttachmentTexture()->GetInternalFormat(), NULL, NULL, NULL, params, NULL, NULL); break;
-    case GL_DEPTH_BITS:                         GlFormatToStorageBits(mWriteFBO->GetDepthAttachmentTexture()   ? mWriteFBO->GetDepthAttachmentTexture()->GetInternalFormat()   : GL_INVALID_VALUE, NULL, NULL, NULL, NULL, params, NULL); break;
-    case GL_STENCIL_BITS:                       GlFormatToStorageBits(mWriteFBO->GetStencilAttachmentTexture() ? mWriteFBO->GetStencilAttachmentTexture()->GetInternalFormat() : GL_INVALID_VALUE, NULL, NULL, NULL, NULL, NULL, params); break;
-    case GL_ALIASED_LINE_WIDTH_RANGE:           params[0] = 1.0f;
-                                                params[1] = 1.0f; break;
-    case GL_ALIASED_POINT_SIZE_RANGE:           params[0] = 1.0f;
-                                                params[1] = 1.0f; break;
-    case GL_COMPRESSED_TEXTURE_FORMATS:         *params = 0.0f; break;
-    case GL_DEPTH_RANGE:                        params[0] = mStateManager.GetViewportTransformationState()->GetMinDepthRange();
-                                                params[1] = mStateManager.GetViewportTransformationState()->GetMaxDepthRange(); break;
-    case GL_GENERATE_MIPMAP_HINT:               *params = static_cast<GLfloat>(mStateManager.GetHintAspectsState()->GetMode(GL_GENERATE_MIPMAP_HINT)); break;
-    case GL_NUM_COMPRESSED_TEXTURE_FORMATS:     *params = 0.0f; break;
-    case GL_SAMPLES:                            *params = static_cast<GLfloat>(mStateManager.GetFragmentOperationsState()->GetSampleCoverageBits()); break;
-    case GL_SAMPLE_BUFFERS:                     *params = static_cast<GLfloat>(mStateManager.GetFragmentOperationsState()->GetMultiSamplingEnabled()); break;
-    case GL_SAMPLE_COVERAGE_INVERT:             *params = static_cast<GLfloat>(mStateManager.GetFragmentOperationsState()->GetSampleCoverageInvert()); break;
-    case GL_SAMPLE_COVERAGE_VALUE:              *params = mStateManager.GetFragmentOperationsState()->GetSampleCoverageValue(); break;
-    case GL_SHADER_COMPILER:                    *params = 1.0f; break;
-    case GL_SUBPIXEL_BITS:                      *params = static_cast<GLfloat>(GLOVE_SUBPIXEL_BITS);; break;
-    case GL_TEXTURE_BINDING_2D:                 *params = static_cast<GLfloat>(mResourceManager->GetTextureID(mStateManager.GetActiveObjectsState()->GetActiveTexture(GL_TEXTURE_2D))); break;
-    case GL_TEXTURE_BINDING_CUBE_MAP:           *params = static_cast<GLfloat>(mResourceManager->GetTextureID(mStateManager.GetActiveObjectsState()->GetActiveTexture(GL_TEXTURE_CUBE_MAP))); break;
-    case GL_ACTIVE_TEXTURE:                     *params = static_cast<GLfloat>(mStateManager.GetActiveObjectsState()->GetActiveTextureUnit()); break;
-    case GL_STENCIL_WRITEMASK:                  *params = static_cast<GLfloat>(mStateManager.GetFramebufferOperationsState()->GetStencilMaskFront()); break;
-    case GL_STENCIL_BACK_WRITEMASK:             *params = static_cast<GLfloat>(mStateManager.GetFramebufferOperationsState()->GetStencilMaskBack());  break;
-    case GL_STENCIL_CLEAR_VALUE:                *params = static_cast<GLfloat>(mStateManager.GetFramebufferOperationsState()->GetClearStencil()); break;
-    case GL_STENCIL_FUNC:                       *params = static_cast<GLfloat>(mStateManager.GetFragmentOperationsState()->GetStencilTestFuncCompareFront()); break;
-    case GL_STENCIL_VALUE_MASK:                 *params = static_cast<GLfloat>(mStateManager.GetFragmentOperationsState()->GetStencilTestFuncMaskFront()); break;
-    case GL_STENCIL_REF:                        *params = static_cast<GLfloat>(mStateManager.GetFragmentOperationsState()->GetStencilTestFuncRefFront()); break;
-    case GL_STENCIL_FAIL:                       *params = static_cast<GLfloat>(mStateManager.GetFragmentOperationsState()->GetStencilTestOpFailFront()); break;
-    case GL_STENCIL_PASS_DEPTH_FAIL:            *params = static_cast<GLfloat>(mStateManager.GetFragmentOperationsState()->GetStencilTestOpZfailFront()); break;
-    case GL_STENCIL_PASS_DEPTH_PASS:            *params = static_cast<GLfloat>(mStateManager.GetFragmentOperationsState()->GetStencilTestOpZpassFront()); break;
-    case GL_STENCIL_BACK_FUNC:                  *params = static_cast<GLfloat>(mStateManager.GetFragmentOperationsState()->GetStencilTestFuncCompareBack()); break;
-    case GL_STENCIL_BACK_FAIL:                  *params = static_cast<GLfloat>(mStateManager.GetFragmentOperationsState()->GetStencilTestOpFailBack()); break;
-    case GL_STENCIL_BACK_PASS_DEPTH_FAIL:       *params = static_cast<GLfloat>(mStateManager.GetFragmentOperationsState()->GetStencilTestOpZfailBack()); break;
-    case GL_STENCIL_BACK_PASS_DEPTH_PASS:       *params = static_cast<GLfloat>(mStateManager.GetFragmentOperationsState()->GetStencilTestOpZpassBack()); break;
-    case GL_STENCIL_BACK_REF:                   *params = static_cast<GLfloat>(mStateManager.GetFragmentOperationsState()->GetStencilTestFuncRefBack()); break;
-    case GL_STENCIL_BACK_VALUE_MASK:            *params = static_cast<GLfloat>(mStateManager.GetFragmentOperationsState()->GetStencilTestFuncMaskBack()); break;
-    default:                                    RecordError(GL_INVALID_ENUM); break;
-    }
+    GetStateValues(pname, params);
 }
 
 GLboolean
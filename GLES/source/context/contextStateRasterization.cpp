@@ -50,10 +50,23 @@ Context::FrontFace(GLenum mode)
     }
 
     if(mStateManager.GetRasterizationState()->UpdateFrontFace(mode)) {
-        mPipeline->SetRasterizationFrontFace(GlFrontFaceToVkFrontFace(mStateManager.GetRasterizationState()->GetFrontFace()));
+        mPipeline->SetRasterizationFrontFace(GetVkFrontFace());
     }
 }
 
+VkFrontFace
+Context::GetVkFrontFace(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    GLenum frontFace = mStateManager.GetRasterizationState()->GetFrontFace();
+    if(mWriteFBO && !mWriteFBO->IsOriginFlipped()) {
+        frontFace = frontFace == GL_CCW ? GL_CW : GL_CCW;
+    }
+
+    return GlFrontFaceToVkFrontFace(frontFace);
+}
+
 void
 Context::LineWidth(GLfloat width)
 {
@@ -23,6 +23,68 @@
 
 #include "context.h"
 #include "resources/texture.h"
+#include "utils/compressedTextures.h"
+
+/// device copies move every channel, so they are kept to formats with nothing to replicate or fill in
+static bool
+IsTransferCopySupported(GLenum internalformat, VkFormat vkformat)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    switch(internalformat) {
+    case GL_RGBA:   return true;
+    case GL_RGB:    return vkformat == VK_FORMAT_R8G8B8_UNORM || vkformat == VK_FORMAT_R5G6B5_UNORM_PACK16;
+    default:        return false;
+    }
+}
+
+const std::map<GLenum, bool> &
+Context::GetCompressedTextureFormats(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(mCompressedTextureFormatsProbed) {
+        return mCompressedTextureFormats;
+    }
+    mCompressedTextureFormatsProbed = true;
+
+    // formats the device cannot sample are still exposed when their blocks can be decoded on the host
+    size_t count = 0;
+    const CompressedFormat *formats = GetCompressedFormats(&count);
+    for(size_t i = 0; i < count; ++i) {
+        VkFormatProperties props;
+        vkGetPhysicalDeviceFormatProperties(mVkContext->vkGpus[0], formats[i].vkFormat, &props);
+
+        const bool native = (props.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != 0;
+        if(native || formats[i].transcodable) {
+            mCompressedTextureFormats[formats[i].glFormat] = native;
+        }
+    }
+
+    return mCompressedTextureFormats;
+}
+
+bool
+Context::CopyFramebufferToTexture(Texture *texture, const Rect *rect, GLint xoffset, GLint yoffset, GLint level, GLint layer)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    AcquireSurfaceImage();
+
+    // the copy on the device cannot turn the rect back from the rotation of the surface
+    if(GetReadFBO()->IsPreTransformed()) {
+        return false;
+    }
+
+    // the copy is recorded after the pending draws and executes ahead of the next ones, no wait is needed
+    if(IsDrawPending()) {
+        Flush();
+        mWriteFBO->SetStateIdle();
+    }
+
+    return texture->CopyPixelsFromImage(GetReadFBO()->GetColorAttachmentTexture(), rect, GetReadFBO()->IsOriginFlipped(),
+                                        xoffset, yoffset, level, layer);
+}
 
 void
 Context::ActiveTexture(GLenum texture)
@@ -42,7 +104,7 @@ Context::BindTexture(GLenum target, GLuint texture)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(target != GL_TEXTURE_2D && target != GL_TEXTURE_CUBE_MAP) {
+    if(target != GL_TEXTURE_2D && target != GL_TEXTURE_CUBE_MAP && target != GL_TEXTURE_3D_OES) {
         RecordError(GL_INVALID_ENUM);
         return;
     }
@@ -61,8 +123,10 @@ Context::BindTexture(GLenum target, GLuint texture)
         if(tex->GetTarget() == GL_INVALID_VALUE) {
             tex->SetVkContext(mVkContext);
             tex->SetTarget(target);
-            tex->SetVkImageUsage(static_cast<VkImageUsageFlagBits>(VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT));
-            tex->SetVkImageTarget(target == GL_TEXTURE_2D ? vulkanAPI::Image::VK_IMAGE_TARGET_2D : vulkanAPI::Image::VK_IMAGE_TARGET_CUBE);
+            tex->SetVkImageUsage(static_cast<VkImageUsageFlagBits>(VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT |
+                                                                   VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT));
+            tex->SetVkImageTarget(target == GL_TEXTURE_2D     ? vulkanAPI::Image::VK_IMAGE_TARGET_2D :
+                                  target == GL_TEXTURE_3D_OES ? vulkanAPI::Image::VK_IMAGE_TARGET_3D : vulkanAPI::Image::VK_IMAGE_TARGET_CUBE);
             tex->SetVkImageTiling();
 
             tex->InitState();
@@ -103,7 +167,7 @@ Context::DeleteTextures(GLsizei n, const GLuint* textures)
 
         if (texture && mResourceManager->TextureExists(texture)) {
 
-            if(mWriteFBO->IsInDrawState()) {
+            if(IsDrawPending()) {
                 if(texture == mWriteFBO->GetColorAttachmentName() && GL_TEXTURE == mWriteFBO->GetColorAttachmentType()) {
                     mWriteFBO->SetStateDelete();
                 }
@@ -115,6 +179,7 @@ Context::DeleteTextures(GLsizei n, const GLuint* textures)
                 mWriteFBO->SetColorAttachment(-1,-1);
                 mWriteFBO->SetColorAttachmentType(GL_NONE);
                 mWriteFBO->SetColorAttachmentName(0);
+                tex->DecreaseColorAttachmentRefCount();
                 tex->Unbind();
             }
 
@@ -151,14 +216,14 @@ Context::GenerateMipmap(GLenum target)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(target != GL_TEXTURE_2D && target != GL_TEXTURE_CUBE_MAP) {
+    if(target != GL_TEXTURE_2D && target != GL_TEXTURE_CUBE_MAP && target != GL_TEXTURE_3D_OES) {
         RecordError(GL_INVALID_ENUM);
         return;
     }
 
     Texture *activeTexture = mStateManager.GetActiveObjectsState()->GetActiveTexture(target);
 
-    if(!ISPOWEROFTWO(activeTexture->GetWidth()) || !ISPOWEROFTWO(activeTexture->GetHeight())) {
+    if(!ISPOWEROFTWO(activeTexture->GetWidth()) || !ISPOWEROFTWO(activeTexture->GetHeight()) || !ISPOWEROFTWO(activeTexture->GetDepth())) {
         RecordError(GL_INVALID_OPERATION);
         return;
     }
@@ -217,13 +282,14 @@ Context::TexParameteri(GLenum target, GLenum pname, GLint param)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(target != GL_TEXTURE_2D && target != GL_TEXTURE_CUBE_MAP) {
+    if(target != GL_TEXTURE_2D && target != GL_TEXTURE_CUBE_MAP && target != GL_TEXTURE_3D_OES) {
         RecordError(GL_INVALID_ENUM);
         return;
     }
 
     if(pname != GL_TEXTURE_WRAP_S     && pname != GL_TEXTURE_WRAP_T &&
-       pname != GL_TEXTURE_MIN_FILTER && pname != GL_TEXTURE_MAG_FILTER) {
+       pname != GL_TEXTURE_MIN_FILTER && pname != GL_TEXTURE_MAG_FILTER &&
+       (pname != GL_TEXTURE_WRAP_R_OES || target != GL_TEXTURE_3D_OES)) {
         RecordError(GL_INVALID_ENUM);
         return;
     }
@@ -245,6 +311,13 @@ Context::TexParameteri(GLenum target, GLenum pname, GLint param)
         }
         activeTexture->SetWrapT(param);
         break;
+    case GL_TEXTURE_WRAP_R_OES:
+        if(param != GL_CLAMP_TO_EDGE && param != GL_REPEAT && param != GL_MIRRORED_REPEAT) {
+            RecordError(GL_INVALID_ENUM);
+            return;
+        }
+        activeTexture->SetWrapR(param);
+        break;
     case GL_TEXTURE_MIN_FILTER:
         if(param != GL_NEAREST && param != GL_LINEAR && param != GL_NEAREST_MIPMAP_NEAREST &&
            param != GL_NEAREST_MIPMAP_LINEAR && param != GL_LINEAR_MIPMAP_LINEAR && param != GL_LINEAR_MIPMAP_NEAREST) {
@@ -278,13 +351,15 @@ Context::GetTexParameterfv(GLenum target, GLenum pname, GLfloat* params)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(target != GL_TEXTURE_2D && target != GL_TEXTURE_CUBE_MAP) {
+    if(target != GL_TEXTURE_2D && target != GL_TEXTURE_CUBE_MAP && target != GL_TEXTURE_3D_OES) {
         RecordError(GL_INVALID_ENUM);
         return;
     }
 
-    if(pname != GL_TEXTURE_WRAP_S     && pname != GL_TEXTURE_WRAP_T &&
-       pname != GL_TEXTURE_MIN_FILTER && pname != GL_TEXTURE_MAG_FILTER) {
+    if(pname != GL_TEXTURE_WRAP_S     && pname != GL_TEXTURE_WRAP_T     &&
+       pname != GL_TEXTURE_MIN_FILTER && pname != GL_TEXTURE_MAG_FILTER &&
+       pname != GL_TEXTURE_IMMUTABLE_FORMAT_EXT &&
+       (pname != GL_TEXTURE_WRAP_R_OES || target != GL_TEXTURE_3D_OES)) {
         RecordError(GL_INVALID_ENUM);
         return;
     }
@@ -292,8 +367,10 @@ Context::GetTexParameterfv(GLenum target, GLenum pname, GLfloat* params)
     Texture *activeTexture = mStateManager.GetActiveObjectsState()->GetActiveTexture(target);
 
     switch(pname) {
+    case GL_TEXTURE_IMMUTABLE_FORMAT_EXT:       *params = activeTexture->IsImmutable() ? 1.0f : 0.0f;           break;
     case GL_TEXTURE_WRAP_S:                     *params = static_cast<GLfloat>(activeTexture->GetWrapS());      break;
     case GL_TEXTURE_WRAP_T:                     *params = static_cast<GLfloat>(activeTexture->GetWrapT());      break;
+    case GL_TEXTURE_WRAP_R_OES:                 *params = static_cast<GLfloat>(activeTexture->GetWrapR());      break;
     case GL_TEXTURE_MIN_FILTER:                 *params = static_cast<GLfloat>(activeTexture->GetMinFilter());  break;
     case GL_TEXTURE_MAG_FILTER:                 *params = static_cast<GLfloat>(activeTexture->GetMagFilter());  break;
     default:                                    break;
@@ -305,13 +382,15 @@ Context::GetTexParameteriv(GLenum target, GLenum pname, GLint* params)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(target != GL_TEXTURE_2D && target != GL_TEXTURE_CUBE_MAP) {
+    if(target != GL_TEXTURE_2D && target != GL_TEXTURE_CUBE_MAP && target != GL_TEXTURE_3D_OES) {
         RecordError(GL_INVALID_ENUM);
         return;
     }
 
-    if(pname != GL_TEXTURE_WRAP_S     && pname != GL_TEXTURE_WRAP_T &&
-       pname != GL_TEXTURE_MIN_FILTER && pname != GL_TEXTURE_MAG_FILTER) {
+    if(pname != GL_TEXTURE_WRAP_S     && pname != GL_TEXTURE_WRAP_T     &&
+       pname != GL_TEXTURE_MIN_FILTER && pname != GL_TEXTURE_MAG_FILTER &&
+       pname != GL_TEXTURE_IMMUTABLE_FORMAT_EXT &&
+       (pname != GL_TEXTURE_WRAP_R_OES || target != GL_TEXTURE_3D_OES)) {
         RecordError(GL_INVALID_ENUM);
         return;
     }
@@ -319,8 +398,10 @@ Context::GetTexParameteriv(GLenum target, GLenum pname, GLint* params)
     Texture *activeTexture = mStateManager.GetActiveObjectsState()->GetActiveTexture(target);
 
     switch(pname) {
+    case GL_TEXTURE_IMMUTABLE_FORMAT_EXT:       *params = activeTexture->IsImmutable() ? GL_TRUE : GL_FALSE; break;
     case GL_TEXTURE_WRAP_S:                     *params = activeTexture->GetWrapS();      break;
     case GL_TEXTURE_WRAP_T:                     *params = activeTexture->GetWrapT();      break;
+    case GL_TEXTURE_WRAP_R_OES:                 *params = activeTexture->GetWrapR();      break;
     case GL_TEXTURE_MIN_FILTER:                 *params = activeTexture->GetMinFilter();  break;
     case GL_TEXTURE_MAG_FILTER:                 *params = activeTexture->GetMagFilter();  break;
     default:                                    break;
@@ -394,22 +475,43 @@ Context::TexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei w
         return;
      }
 
+    Texture *activeTexture = mStateManager.GetActiveObjectsState()->GetActiveTexture(target);
+    if(activeTexture->IsImmutable()) {
+        RecordError(GL_INVALID_OPERATION);
+        return;
+    }
+
     if(!width || !height) {
         return;
     }
 
-    if(mWriteFBO->IsInDrawState()) {
+    if(IsDrawPending()) {
         Finish();
     }
 
-    // copy the buffer contents to the texture
-    Texture *activeTexture = mStateManager.GetActiveObjectsState()->GetActiveTexture(target);
+    if(pixels) {
+        ++mStatistics.textureUploads;
+        mStatistics.textureUploadBytes += static_cast<uint64_t>(width) * height *
+                                          GlInternalFormatTypeToNumElements(GlFormatToGlInternalFormat(format, type), type) * GlTypeToElementSize(type);
+    }
+
+    // levels that the current image already holds go straight into it, without a host copy
     GLint layer = (target == GL_TEXTURE_2D) ? 0 : target - GL_TEXTURE_CUBE_MAP_POSITIVE_X;
-    activeTexture->SetState(width, height, level, layer, format, type, mStateManager.GetPixelStorageState()->GetPixelStoreUnpack(), pixels);
+    // rows longer than the image and the skipped rows and pixels are stepped over as the pixels are read
+    StatePixelStorage *pixelStorage = mStateManager.GetPixelStorageState();
+    GLint unpackAlignment = pixelStorage->GetPixelStoreUnpack();
+    GLint unpackRowLength = pixelStorage->GetUnpackRowLength();
+    pixels = pixelStorage->GetUnpackPixels(pixels, width, GlInternalFormatTypeToNumElements(GlFormatToGlInternalFormat(format, type), type) * GlTypeToElementSize(type));
+    VkFormat vkformat = activeTexture->FindSupportedVkColorFormat(GlColorFormatToVkColorFormat(format, type));
+    if(activeTexture->UpdateVkLevel(width, height, level, layer, format, type, unpackAlignment, pixels, vkformat, unpackRowLength)) {
+        return;
+    }
+
+    // otherwise the texture keeps a host copy until it is complete
+    activeTexture->SetState(width, height, level, layer, format, type, unpackAlignment, pixels, unpackRowLength);
 
     if(activeTexture->IsCompleted()) {
         // pass contents to the driver
-        VkFormat vkformat = activeTexture->FindSupportedVkColorFormat(GlColorFormatToVkColorFormat(format, type));
         activeTexture->SetVkFormat(vkformat);
         activeTexture->Allocate();
     }
@@ -462,17 +564,22 @@ Context::TexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset,
         return;
     }
 
+    if(activeTexture->GetCompressedFormat() != GL_INVALID_VALUE) {
+        RecordError(GL_INVALID_OPERATION);
+        return;
+    }
+
     // TODO:: We could pass a default subtexture instead
     if(pixels == nullptr) {
         return;
     }
 
-    if(mWriteFBO->IsInDrawState()) {
+    if(IsDrawPending()) {
         Finish();
     }
 
-    if(mWriteFBO != mSystemFBO && GetResourceManager()->IsTextureAttachedToFBO(activeTexture)) {
-        activeTexture->SetFboColorAttached(true);
+    if(mWriteFBO != mSystemFBO && activeTexture->IsColorAttached()) {
+        activeTexture->SetFboColorAttached(mWriteFBO->IsOriginFlipped());
         activeTexture->SetDataNoInvertion(true);
         CopyTexImage2D(target, level, format, 0, 0, activeTexture->GetWidth(), activeTexture->GetHeight(), 0);
     }
@@ -490,12 +597,25 @@ Context::TexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset,
                       GlTypeToElementSize(activeTexture->GetType()),
                       Texture::GetDefaultInternalAlignment());
 
-    // copy the buffer contents to the texture
+    ++mStatistics.textureUploads;
+    mStatistics.textureUploadBytes += srcRect.GetRectBufferSize();
+
+    // a subrectangle of a larger image is read in place, along the rows of the image
+    srcRect.mRowLength = mStateManager.GetPixelStorageState()->GetUnpackRowLength();
+    pixels = mStateManager.GetPixelStorageState()->GetUnpackPixels(pixels, width, srcRect.GetPixelByteOffset());
+
+    // the subimage is uploaded on its own when the current image can take it
+    VkFormat vkformat = activeTexture->FindSupportedVkColorFormat(GlColorFormatToVkColorFormat(format, type));
+    if(!activeTexture->IsColorAttached() &&
+       activeTexture->UpdateVkSubImage(&srcRect, &dstRect, level, layer, srcInternalFormat, pixels, vkformat)) {
+        return;
+    }
+
+    // otherwise into the host copy, which is read back first when the image holds the texture
     activeTexture->SetSubState(&srcRect, &dstRect, level, layer, srcInternalFormat, pixels);
 
     if(activeTexture->IsCompleted()) {
         // pass contents to the driver
-        VkFormat vkformat = activeTexture->FindSupportedVkColorFormat(GlColorFormatToVkColorFormat(format, type));
         activeTexture->SetVkFormat(vkformat);
         activeTexture->Allocate();
     }
@@ -535,21 +655,21 @@ Context::CopyTexImage2D(GLenum target, GLint level, GLenum internalformat, GLint
         return;
     }
 
-    if(mWriteFBO != mSystemFBO && mWriteFBO->CheckStatus() != GL_FRAMEBUFFER_COMPLETE) {
+    if(GetReadFBO() != mSystemFBO && GetReadFBO()->CheckStatus() != GL_FRAMEBUFFER_COMPLETE) {
         RecordError(GL_INVALID_FRAMEBUFFER_OPERATION);
         return;
     }
 
-    if(mWriteFBO->IsInDrawState()) {
-        Finish();
-    }
-
-    Texture *fbTexture = mWriteFBO->GetColorAttachmentTexture();
+    Texture *fbTexture = GetReadFBO()->GetColorAttachmentTexture();
     if(fbTexture == nullptr) {
         return;
     }
 
     Texture *activeTexture = mStateManager.GetActiveObjectsState()->GetActiveTexture(target);
+    if(activeTexture->IsImmutable()) {
+        RecordError(GL_INVALID_OPERATION);
+        return;
+    }
 
     const GLenum fbFormat = fbTexture->GetFormat();
     if((fbFormat == GL_ALPHA  && internalformat != GL_ALPHA) ||
@@ -558,10 +678,36 @@ Context::CopyTexImage2D(GLenum target, GLint level, GLenum internalformat, GLint
        return;
     }
 
-    // transfer the data to the cpu and upload it to a new texture
-    GLenum srcInternalFormat = fbTexture->GetExplicitInternalFormat();
+    const GLint    layer   = (target == GL_TEXTURE_2D) ? 0 : target - GL_TEXTURE_CUBE_MAP_POSITIVE_X;
     GLenum dstInternalFormat = internalformat;
     GLenum dstType           = GlInternalFormatToGlType(dstInternalFormat);
+
+    // copy on the device when the texture image can take the framebuffer contents as they are
+    VkFormat vkformat = activeTexture->FindSupportedVkColorFormat(GlColorFormatToVkColorFormat(dstInternalFormat, dstType));
+    if(fbTexture != activeTexture && IsTransferCopySupported(dstInternalFormat, vkformat)) {
+        if(activeTexture->GetImage()->GetImage() == VK_NULL_HANDLE ||
+           !activeTexture->HasState(level, layer, width, height, dstInternalFormat, dstType)) {
+            activeTexture->SetState(width, height, level, layer, dstInternalFormat, dstType, Texture::GetDefaultInternalAlignment(), nullptr);
+            if(!activeTexture->UpdateVkLevel(level, layer, vkformat) && activeTexture->IsCompleted()) {
+                activeTexture->SetVkFormat(vkformat);
+                activeTexture->Allocate();
+            }
+        }
+
+        Rect rect(x, y, width, height);
+        if(activeTexture->IsCompleted() &&
+           activeTexture->GetImage()->GetMipLevels() > static_cast<uint32_t>(level) &&
+           CopyFramebufferToTexture(activeTexture, &rect, 0, 0, level, layer)) {
+            return;
+        }
+    }
+
+    if(IsDrawPending()) {
+        Finish();
+    }
+
+    // transfer the data to the cpu and upload it to a new texture
+    GLenum srcInternalFormat = fbTexture->GetExplicitInternalFormat();
     ImageRect srcRect(x, y, width, height,
                       GlInternalFormatTypeToNumElements(srcInternalFormat, fbTexture->GetExplicitType()),
                       GlTypeToElementSize(fbTexture->GetExplicitType()),
@@ -571,15 +717,12 @@ Context::CopyTexImage2D(GLenum target, GLint level, GLenum internalformat, GLint
                       GlTypeToElementSize(dstType),
                       Texture::GetDefaultInternalAlignment());
 
-    const GLint    layer   = (target == GL_TEXTURE_2D) ? 0 : target - GL_TEXTURE_CUBE_MAP_POSITIVE_X;
-
     const size_t stageSize = dstRect.GetRectBufferSize();
     uint8_t *stagePixels = new uint8_t[stageSize];
-    srcRect.y = fbTexture->GetInvertedYOrigin(&srcRect);
 
     // copy the framebuffer contents to the temp buffer
     // and convert them to the texture's internal format
-    fbTexture->CopyPixelsToHost(&srcRect, &dstRect, 0, 0, internalformat, static_cast<void *>(stagePixels));
+    CopyFramebufferToHost(fbTexture, &srcRect, &dstRect, internalformat, static_cast<void *>(stagePixels));
 
     // now copy the temp buffer contents to the texture
     activeTexture->SetState(width, height, level, layer, dstInternalFormat, dstType, Texture::GetDefaultInternalAlignment(), stagePixels);
@@ -618,17 +761,18 @@ Context::CopyTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoff
         return;
     }
 
-    if(mWriteFBO != mSystemFBO && mWriteFBO->CheckStatus() != GL_FRAMEBUFFER_COMPLETE) {
+    if(GetReadFBO() != mSystemFBO && GetReadFBO()->CheckStatus() != GL_FRAMEBUFFER_COMPLETE) {
         RecordError(GL_INVALID_FRAMEBUFFER_OPERATION);
         return;
     }
 
-    if(mWriteFBO->IsInDrawState()) {
-        Finish();
+    Texture *fbTexture = GetReadFBO()->GetColorAttachmentTexture();
+    if(fbTexture == nullptr) {
+        return;
     }
 
-    Texture *fbTexture = mWriteFBO->GetColorAttachmentTexture();
-    if(fbTexture == nullptr) {
+    if(activeTexture->GetCompressedFormat() != GL_INVALID_VALUE) {
+        RecordError(GL_INVALID_OPERATION);
         return;
     }
 
@@ -642,6 +786,21 @@ Context::CopyTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoff
 
     GLint layer = (target == GL_TEXTURE_2D) ? 0 : target - GL_TEXTURE_CUBE_MAP_POSITIVE_X;
 
+    // copy on the device straight into the existing texture image
+    if(fbTexture != activeTexture && activeTexture->IsCompleted() &&
+       activeTexture->GetImage()->GetImage() != VK_NULL_HANDLE &&
+       activeTexture->GetImage()->GetMipLevels() > static_cast<uint32_t>(level) &&
+       IsTransferCopySupported(internalformat, activeTexture->GetVkFormat())) {
+        Rect rect(x, y, width, height);
+        if(CopyFramebufferToTexture(activeTexture, &rect, xoffset, yoffset, level, layer)) {
+            return;
+        }
+    }
+
+    if(IsDrawPending()) {
+        Finish();
+    }
+
     GLenum srcInternalFormat = fbTexture->GetExplicitInternalFormat();
     GLenum dstInternalFormat = internalformat;
     ImageRect srcRect(x,       y,       width, height,
@@ -655,11 +814,10 @@ Context::CopyTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoff
 
     const size_t stageSize = dstRect.GetRectBufferSize();
     uint8_t *stagePixels = new uint8_t[stageSize];
-    srcRect.y = fbTexture->GetInvertedYOrigin(&srcRect);
 
     // copy the framebuffer subcontents to the temp buffer
     // and convert them to the texture's internal format
-    fbTexture->CopyPixelsToHost(&srcRect, &dstRect, 0, 0, dstInternalFormat, static_cast<void *>(stagePixels));
+    CopyFramebufferToHost(fbTexture, &srcRect, &dstRect, dstInternalFormat, static_cast<void *>(stagePixels));
 
     srcRect = dstRect;
     srcRect.x = 0; srcRect.y = 0;
@@ -685,12 +843,18 @@ Context::CompressedTexImage2D(GLenum target, GLint level, GLenum internalformat,
         return;
     }
 
-    if(internalformat != GL_ALPHA     && internalformat != GL_RGB && internalformat != GL_RGBA &&
-       internalformat != GL_LUMINANCE && internalformat != GL_LUMINANCE_ALPHA) {
+    const std::map<GLenum, bool> &compressedFormats = GetCompressedTextureFormats();
+    auto supported = compressedFormats.find(internalformat);
+    if(supported == compressedFormats.end()) {
         RecordError(GL_INVALID_ENUM);
         return;
     }
 
+    if((target >= GL_TEXTURE_CUBE_MAP_POSITIVE_X && target <= GL_TEXTURE_CUBE_MAP_NEGATIVE_Z) && (width != height)) {
+        RecordError(GL_INVALID_VALUE);
+        return;
+    }
+
     if(level < 0 || border || (width < 0 || height < 0) ||
        ((width > GLOVE_MAX_TEXTURE_SIZE || height > GLOVE_MAX_TEXTURE_SIZE) && target == GL_TEXTURE_2D) ||
        ((width > GLOVE_MAX_CUBE_MAP_TEXTURE_SIZE || height > GLOVE_MAX_CUBE_MAP_TEXTURE_SIZE) && target != GL_TEXTURE_2D)) {
@@ -704,15 +868,45 @@ Context::CompressedTexImage2D(GLenum target, GLint level, GLenum internalformat,
         return;
      }
 
+    const CompressedFormat *compressed = FindCompressedFormat(internalformat);
+    if(imageSize < 0 || static_cast<size_t>(imageSize) != GetCompressedImageSize(compressed, width, height)) {
+        RecordError(GL_INVALID_VALUE);
+        return;
+    }
+
+    Texture *activeTexture = mStateManager.GetActiveObjectsState()->GetActiveTexture(target);
+    if(activeTexture->IsImmutable()) {
+        RecordError(GL_INVALID_OPERATION);
+        return;
+    }
+
     if(width == 0 || height == 0) {
         return;
     }
 
-    // TODO:
-    //GL_INVALID_VALUE is generated if imageSize is not consistent with the format, dimensions, and contents of the specified compressed image data.
-    //GL_INVALID_OPERATION is generated if parameter combinations are not supported by the specific compressed internal format as specified in the specific texture compression extension.
+    if(IsDrawPending()) {
+        Finish();
+    }
+
+    if(data) {
+        ++mStatistics.textureUploads;
+        mStatistics.textureUploadBytes += imageSize;
+    }
+
+    // the blocks go to the device as they are when it can sample them, otherwise they are decoded to RGBA
+    const bool native = supported->second;
+    GLint layer = (target == GL_TEXTURE_2D) ? 0 : target - GL_TEXTURE_CUBE_MAP_POSITIVE_X;
+    activeTexture->SetCompressedState(width, height, level, layer, internalformat, data, !native);
 
-    NOT_IMPLEMENTED();
+    if(activeTexture->IsCompleted()) {
+        if(native) {
+            activeTexture->SetVkImageTiling(VK_IMAGE_TILING_OPTIMAL);
+            activeTexture->SetVkFormat(compressed->vkFormat);
+        } else {
+            activeTexture->SetVkFormat(activeTexture->FindSupportedVkColorFormat(GlColorFormatToVkColorFormat(GL_RGBA, GL_UNSIGNED_BYTE)));
+        }
+        activeTexture->Allocate();
+    }
 }
 
 void
@@ -725,13 +919,14 @@ Context::CompressedTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLin
         return;
     }
 
-    if(format != GL_ALPHA     && format != GL_RGB && format != GL_RGBA &&
-       format != GL_LUMINANCE && format != GL_LUMINANCE_ALPHA) {
+    const std::map<GLenum, bool> &compressedFormats = GetCompressedTextureFormats();
+    auto supported = compressedFormats.find(format);
+    if(supported == compressedFormats.end()) {
         RecordError(GL_INVALID_ENUM);
         return;
     }
 
-    if(level < 0 || width < 0 || height < 0 ||
+    if(level < 0 || width < 0 || height < 0 || xoffset < 0 || yoffset < 0 ||
        ((width > GLOVE_MAX_TEXTURE_SIZE || height > GLOVE_MAX_TEXTURE_SIZE) && target == GL_TEXTURE_2D) ||
        ((width > GLOVE_MAX_CUBE_MAP_TEXTURE_SIZE || height > GLOVE_MAX_CUBE_MAP_TEXTURE_SIZE) && target != GL_TEXTURE_2D)) {
         RecordError(GL_INVALID_VALUE);
@@ -739,20 +934,403 @@ Context::CompressedTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLin
     }
 
     Texture *tex = mStateManager.GetActiveObjectsState()->GetActiveTexture(target);
-    if(tex->GetWidth()  < (xoffset + width ) ||
-       tex->GetHeight() < (yoffset + height)) {
+    GLint layer = (target == GL_TEXTURE_2D) ? 0 : target - GL_TEXTURE_CUBE_MAP_POSITIVE_X;
+    const GLint levelWidth  = std::max(tex->GetWidth()  >> level, 1);
+    const GLint levelHeight = std::max(tex->GetHeight() >> level, 1);
+    if(levelWidth  < (xoffset + width ) ||
+       levelHeight < (yoffset + height)) {
+        RecordError(GL_INVALID_VALUE);
+        return;
+    }
+
+    // transcoded levels are held as RGBA
+    const GLenum stateFormat = supported->second ? format : GL_RGBA;
+    if(tex->GetCompressedFormat() != format ||
+       !tex->HasState(level, layer, levelWidth, levelHeight, stateFormat, GL_UNSIGNED_BYTE)) {
+        RecordError(GL_INVALID_OPERATION);
+        return;
+    }
+
+    // subimages are made of whole blocks, apart from the ones at the right and bottom edges
+    const CompressedFormat *compressed = FindCompressedFormat(format);
+    if(xoffset % compressed->blockWidth || yoffset % compressed->blockHeight ||
+       (width  % compressed->blockWidth  && xoffset + width  != levelWidth ) ||
+       (height % compressed->blockHeight && yoffset + height != levelHeight)) {
+        RecordError(GL_INVALID_OPERATION);
+        return;
+    }
+
+    if(imageSize < 0 || static_cast<size_t>(imageSize) != GetCompressedImageSize(compressed, width, height)) {
+        RecordError(GL_INVALID_VALUE);
+        return;
+    }
+
+    if(!width || !height || data == nullptr) {
+        return;
+    }
+
+    if(IsDrawPending()) {
+        Finish();
+    }
+
+    ++mStatistics.textureUploads;
+    mStatistics.textureUploadBytes += imageSize;
+
+    tex->SetCompressedSubState(xoffset, yoffset, width, height, level, layer, data);
+
+    if(tex->IsCompleted()) {
+        tex->Allocate();
+    }
+}
+
+void
+Context::TexStorage2DEXT(GLenum target, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(target != GL_TEXTURE_2D && target != GL_TEXTURE_CUBE_MAP) {
+        RecordError(GL_INVALID_ENUM);
+        return;
+    }
+
+    GLenum format;
+    GLenum type = GL_UNSIGNED_BYTE;
+    switch(internalformat) {
+    case GL_RGBA8_OES:                          format = GL_RGBA;                                       break;
+    case GL_RGB8_OES:                           format = GL_RGB;                                        break;
+    case GL_RGBA4:                              format = GL_RGBA;            type = GL_UNSIGNED_SHORT_4_4_4_4; break;
+    case GL_RGB5_A1:                            format = GL_RGBA;            type = GL_UNSIGNED_SHORT_5_5_5_1; break;
+    case GL_RGB565:                             format = GL_RGB;             type = GL_UNSIGNED_SHORT_5_6_5;   break;
+    case GL_ALPHA8_EXT:                         format = GL_ALPHA;                                      break;
+    case GL_LUMINANCE8_EXT:                     format = GL_LUMINANCE;                                  break;
+    case GL_LUMINANCE8_ALPHA8_EXT:              format = GL_LUMINANCE_ALPHA;                            break;
+    default:                                    RecordError(GL_INVALID_ENUM);                           return;
+    }
+
+    if(levels < 1 || width < 1 || height < 1 ||
+       ((width > GLOVE_MAX_TEXTURE_SIZE || height > GLOVE_MAX_TEXTURE_SIZE) && target == GL_TEXTURE_2D) ||
+       ((width > GLOVE_MAX_CUBE_MAP_TEXTURE_SIZE || height > GLOVE_MAX_CUBE_MAP_TEXTURE_SIZE) && target != GL_TEXTURE_2D) ||
+       (target == GL_TEXTURE_CUBE_MAP && width != height)) {
+        RecordError(GL_INVALID_VALUE);
+        return;
+    }
+
+    Texture *activeTexture = mStateManager.GetActiveObjectsState()->GetActiveTexture(target);
+    if(levels > floor(log2(std::max(width, height))) + 1 ||
+       activeTexture == mResourceManager->GetDefaultTexture(target) || activeTexture->IsImmutable()) {
+        RecordError(GL_INVALID_OPERATION);
+        return;
+    }
+
+    if(IsDrawPending()) {
+        Finish();
+    }
+
+    // the image is created once with all of its levels, the subimage uploads go straight into it
+    activeTexture->SetStorage(levels, width, height, format, type);
+    if(activeTexture->IsCompleted()) {
+        activeTexture->SetVkFormat(activeTexture->FindSupportedVkColorFormat(GlColorFormatToVkColorFormat(format, type)));
+        activeTexture->Allocate();
+    }
+}
+
+void
+Context::TexImage3DOES(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLenum format, GLenum type, const void *pixels)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(target != GL_TEXTURE_3D_OES) {
+        RecordError(GL_INVALID_ENUM);
+        return;
+    }
+
+    if(format != GL_ALPHA     && format != GL_RGB && format != GL_RGBA &&
+       format != GL_LUMINANCE && format != GL_LUMINANCE_ALPHA) {
+        RecordError(GL_INVALID_ENUM);
+        return;
+    }
+
+    if(type != GL_UNSIGNED_BYTE          && type != GL_UNSIGNED_SHORT_5_6_5 &&
+       type != GL_UNSIGNED_SHORT_4_4_4_4 && type != GL_UNSIGNED_SHORT_5_5_5_1) {
+        RecordError(GL_INVALID_ENUM);
+        return;
+    }
+
+    if(internalformat != GL_ALPHA     && internalformat != GL_RGB && internalformat != GL_RGBA &&
+       internalformat != GL_LUMINANCE && internalformat != GL_LUMINANCE_ALPHA) {
+        RecordError(GL_INVALID_VALUE);
+        return;
+    }
+
+    if(level < 0 || border || width < 0 || height < 0 || depth < 0 ||
+       width > GLOVE_MAX_3D_TEXTURE_SIZE || height > GLOVE_MAX_3D_TEXTURE_SIZE || depth > GLOVE_MAX_3D_TEXTURE_SIZE ||
+       level > log2(GLOVE_MAX_3D_TEXTURE_SIZE)) {
         RecordError(GL_INVALID_VALUE);
         return;
     }
 
-    if(tex->GetFormat() != format) {
+    if(internalformat != format) {
         RecordError(GL_INVALID_OPERATION);
         return;
     }
 
-    // TODO:
-    //GL_INVALID_VALUE is generated if imageSize is not consistent with the format, dimensions, and contents of the specified compressed image data.
-    //GL_INVALID_OPERATION is generated if parameter combinations are not supported by the specific compressed internal format as specified in the specific texture compression extension.
+    if((type == GL_UNSIGNED_BYTE && format != GL_RGBA && format != GL_RGB &&
+        format != GL_LUMINANCE_ALPHA && format != GL_LUMINANCE && format != GL_ALPHA) ||
+        (type == GL_UNSIGNED_SHORT_5_6_5                                          && format != GL_RGB) ||
+        ((type == GL_UNSIGNED_SHORT_4_4_4_4 || type == GL_UNSIGNED_SHORT_5_5_5_1) && format != GL_RGBA)) {
+        RecordError(GL_INVALID_OPERATION);
+        return;
+    }
+
+    Texture *activeTexture = mStateManager.GetActiveObjectsState()->GetActiveTexture(target);
+    if(activeTexture->IsImmutable()) {
+        RecordError(GL_INVALID_OPERATION);
+        return;
+    }
+
+    if(!width || !height || !depth) {
+        return;
+    }
+
+    if(IsDrawPending()) {
+        Finish();
+    }
+
+    const GLint pixelSize = GlInternalFormatTypeToNumElements(GlFormatToGlInternalFormat(format, type), type) * GlTypeToElementSize(type);
+    if(pixels) {
+        ++mStatistics.textureUploads;
+        mStatistics.textureUploadBytes += static_cast<uint64_t>(width) * height * depth * pixelSize;
+    }
+
+    // the slices of the base level are the layers of the texture, the smaller levels use the first of them
+    if(!level) {
+        activeTexture->SetDepth(depth);
+    }
+    const GLint slices = std::min(depth, std::max(activeTexture->GetDepth() >> level, 1));
+
+    // the slices follow each other, each made of the rows the unpack state steps over
+    StatePixelStorage *pixelStorage = mStateManager.GetPixelStorageState();
+    GLint unpackAlignment = pixelStorage->GetPixelStoreUnpack();
+    GLint unpackRowLength = pixelStorage->GetUnpackRowLength();
+    ImageRect sliceRect(0, 0, width, height, 1, pixelSize, unpackAlignment);
+    sliceRect.mRowLength = unpackRowLength;
+    const size_t sliceStride = sliceRect.GetRectBufferSize();
+    pixels = pixelStorage->GetUnpackPixels(pixels, width, pixelSize);
+
+    // slices go straight into the current image when it has the same depth
+    VkFormat vkformat = activeTexture->FindSupportedVkColorFormat(GlColorFormatToVkColorFormat(format, type));
+    const bool sameDepth = static_cast<GLint>(activeTexture->GetImage()->GetDepth()) == activeTexture->GetDepth();
+    bool onDevice = true;
+    for(GLint z = 0; z < slices; ++z) {
+        const uint8_t *slice = pixels ? static_cast<const uint8_t *>(pixels) + z * sliceStride : nullptr;
+        if(sameDepth && activeTexture->UpdateVkLevel(width, height, level, z, format, type, unpackAlignment, slice, vkformat, unpackRowLength)) {
+            continue;
+        }
+
+        activeTexture->SetState(width, height, level, z, format, type, unpackAlignment, slice, unpackRowLength);
+        onDevice = false;
+    }
+
+    if(!onDevice && activeTexture->IsCompleted()) {
+        // pass contents to the driver
+        activeTexture->SetVkFormat(vkformat);
+        activeTexture->Allocate();
+    }
+}
+
+void
+Context::TexSubImage3DOES(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void *pixels)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(target != GL_TEXTURE_3D_OES) {
+        RecordError(GL_INVALID_ENUM);
+        return;
+    }
+
+    if(level < 0 || width < 0 || height < 0 || depth < 0 || xoffset < 0 || yoffset < 0 || zoffset < 0 ||
+       level > log2(GLOVE_MAX_3D_TEXTURE_SIZE)) {
+        RecordError(GL_INVALID_VALUE);
+        return;
+    }
+
+    if(format != GL_ALPHA && format != GL_RGB && format != GL_RGBA &&
+       format != GL_LUMINANCE && format != GL_LUMINANCE_ALPHA) {
+        RecordError(GL_INVALID_ENUM);
+        return;
+    }
+
+    if(type != GL_UNSIGNED_BYTE && type != GL_UNSIGNED_SHORT_5_6_5 &&
+       type != GL_UNSIGNED_SHORT_4_4_4_4 && type != GL_UNSIGNED_SHORT_5_5_5_1) {
+        RecordError(GL_INVALID_ENUM);
+        return;
+    }
+
+    if((type == GL_UNSIGNED_BYTE && format != GL_RGBA && format != GL_RGB &&
+        format != GL_LUMINANCE_ALPHA && format != GL_LUMINANCE && format != GL_ALPHA) ||
+        (type == GL_UNSIGNED_SHORT_5_6_5                                          && format != GL_RGB) ||
+        ((type == GL_UNSIGNED_SHORT_4_4_4_4 || type == GL_UNSIGNED_SHORT_5_5_5_1) && format != GL_RGBA)) {
+        RecordError(GL_INVALID_OPERATION);
+        return;
+    }
+
+    Texture *activeTexture = mStateManager.GetActiveObjectsState()->GetActiveTexture(target);
+    if(activeTexture->GetWidth()  < (xoffset + width ) ||
+       activeTexture->GetHeight() < (yoffset + height) ||
+       std::max(activeTexture->GetDepth() >> level, 1) < (zoffset + depth)) {
+        RecordError(GL_INVALID_VALUE);
+        return;
+    }
+
+    if(pixels == nullptr || !width || !height || !depth) {
+        return;
+    }
+
+    if(IsDrawPending()) {
+        Finish();
+    }
+
+    GLenum srcInternalFormat = GlFormatToGlInternalFormat(format, type);
+    GLenum dstInternalFormat = activeTexture->GetInternalFormat();
+    ImageRect srcRect(0,       0,       width, height,
+                      GlInternalFormatTypeToNumElements(srcInternalFormat, type),
+                      GlTypeToElementSize(type),
+                      mStateManager.GetPixelStorageState()->GetPixelStoreUnpack());
+    ImageRect dstRect(xoffset, yoffset, width, height,
+                      GlInternalFormatTypeToNumElements(dstInternalFormat, activeTexture->GetType()),
+                      GlTypeToElementSize(activeTexture->GetType()),
+                      Texture::GetDefaultInternalAlignment());
+    srcRect.mRowLength = mStateManager.GetPixelStorageState()->GetUnpackRowLength();
+
+    ++mStatistics.textureUploads;
+    mStatistics.textureUploadBytes += static_cast<uint64_t>(srcRect.GetRectBufferSize()) * depth;
+
+    const size_t sliceStride = srcRect.GetRectBufferSize();
+    pixels = mStateManager.GetPixelStorageState()->GetUnpackPixels(pixels, width, srcRect.GetPixelByteOffset());
+
+    // each slice is uploaded on its own when the current image can take it, otherwise into the host copy
+    VkFormat vkformat = activeTexture->FindSupportedVkColorFormat(GlColorFormatToVkColorFormat(format, type));
+    bool onDevice = true;
+    for(GLint z = 0; z < depth; ++z) {
+        const uint8_t *slice = static_cast<const uint8_t *>(pixels) + z * sliceStride;
+        if(activeTexture->UpdateVkSubImage(&srcRect, &dstRect, level, zoffset + z, srcInternalFormat, slice, vkformat)) {
+            continue;
+        }
+
+        activeTexture->SetSubState(&srcRect, &dstRect, level, zoffset + z, srcInternalFormat, slice);
+        onDevice = false;
+    }
+
+    if(!onDevice && activeTexture->IsCompleted()) {
+        // pass contents to the driver
+        activeTexture->SetVkFormat(vkformat);
+        activeTexture->Allocate();
+    }
+}
+
+void
+Context::CopyTexSubImage3DOES(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(target != GL_TEXTURE_3D_OES) {
+        RecordError(GL_INVALID_ENUM);
+        return;
+    }
+
+    Texture *activeTexture = mStateManager.GetActiveObjectsState()->GetActiveTexture(target);
+    if(level < 0 || width < 0 || height < 0 || xoffset < 0 || yoffset < 0 || zoffset < 0 ||
+       level > log2(GLOVE_MAX_3D_TEXTURE_SIZE) ||
+       activeTexture->GetWidth() < (xoffset + width) || activeTexture->GetHeight() < (yoffset + height) ||
+       std::max(activeTexture->GetDepth() >> level, 1) <= zoffset) {
+        RecordError(GL_INVALID_VALUE);
+        return;
+    }
+
+    if(GetReadFBO() != mSystemFBO && GetReadFBO()->CheckStatus() != GL_FRAMEBUFFER_COMPLETE) {
+        RecordError(GL_INVALID_FRAMEBUFFER_OPERATION);
+        return;
+    }
+
+    Texture *fbTexture = GetReadFBO()->GetColorAttachmentTexture();
+    if(fbTexture == nullptr) {
+        return;
+    }
+
+    const GLenum fbFormat       = fbTexture->GetFormat();
+    const GLenum internalformat = activeTexture->GetInternalFormat();
+    if((fbFormat == GL_ALPHA &&  internalformat != GL_ALPHA) ||
+       (fbFormat == GL_RGB   && (internalformat != GL_LUMINANCE && internalformat != GL_RGB))) {
+       RecordError(GL_INVALID_OPERATION);
+       return;
+    }
+
+    // copy on the device straight into the slice of the existing texture image
+    if(activeTexture->IsCompleted() &&
+       activeTexture->GetImage()->GetImage() != VK_NULL_HANDLE &&
+       activeTexture->GetImage()->GetMipLevels() > static_cast<uint32_t>(level) &&
+       IsTransferCopySupported(internalformat, activeTexture->GetVkFormat())) {
+        Rect rect(x, y, width, height);
+        if(CopyFramebufferToTexture(activeTexture, &rect, xoffset, yoffset, level, zoffset)) {
+            return;
+        }
+    }
+
+    if(IsDrawPending()) {
+        Finish();
+    }
+
+    GLenum srcInternalFormat = fbTexture->GetExplicitInternalFormat();
+    GLenum dstInternalFormat = internalformat;
+    ImageRect srcRect(x,       y,       width, height,
+                      GlInternalFormatTypeToNumElements(srcInternalFormat, fbTexture->GetExplicitType()),
+                      GlTypeToElementSize(fbTexture->GetExplicitType()),
+                      Texture::GetDefaultInternalAlignment());
+    ImageRect dstRect(xoffset, yoffset, width, height,
+                      GlInternalFormatTypeToNumElements(dstInternalFormat, activeTexture->GetType()),
+                      GlTypeToElementSize(activeTexture->GetType()),
+                      Texture::GetDefaultInternalAlignment());
+
+    const size_t stageSize = dstRect.GetRectBufferSize();
+    uint8_t *stagePixels = new uint8_t[stageSize];
+
+    CopyFramebufferToHost(fbTexture, &srcRect, &dstRect, dstInternalFormat, static_cast<void *>(stagePixels));
+
+    srcRect = dstRect;
+    srcRect.x = 0; srcRect.y = 0;
+    activeTexture->SetSubState(&srcRect, &dstRect, level, zoffset, dstInternalFormat, stagePixels);
+    delete[] stagePixels;
+
+    if(activeTexture->IsCompleted()) {
+        VkFormat vkformat = activeTexture->FindSupportedVkColorFormat(GlColorFormatToVkColorFormat(activeTexture->GetFormat(), activeTexture->GetType()));
+        activeTexture->SetVkFormat(vkformat);
+        activeTexture->Allocate();
+    }
+}
+
+void
+Context::CompressedTexImage3DOES(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLsizei imageSize, const void *data)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(target != GL_TEXTURE_3D_OES) {
+        RecordError(GL_INVALID_ENUM);
+        return;
+    }
+
+    // none of the compressed formats is supported for volumes
+    RecordError(GL_INVALID_ENUM);
+}
+
+void
+Context::CompressedTexSubImage3DOES(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLsizei imageSize, const void *data)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(target != GL_TEXTURE_3D_OES) {
+        RecordError(GL_INVALID_ENUM);
+        return;
+    }
 
-    NOT_IMPLEMENTED();
+    RecordError(GL_INVALID_ENUM);
 }
@@ -44,13 +44,35 @@ Context::GetString(GLenum name)
                                   "OpenGL ES 2.0 Over Vulkan\0",
                                   "OpenGL ES 2.0\0",
                                   "OpenGL ES GLSL ES 1.00\0",
-                                  "GL_OES_get_program_binary GL_OES_rgb8_rgba8 GL_OES_depth24 GL_OES_depth32 GL_OES_stencil4 GL_OES_texture_stencil8 GL_OES_required_internalformat GL_OES_packed_depth_stencil GL_APPLE_texture_format_BGRA8888\0"};
+                                  "GL_OES_get_program_binary GL_OES_rgb8_rgba8 GL_OES_depth24 GL_OES_depth32 GL_OES_stencil4 GL_OES_texture_stencil8 GL_OES_required_internalformat GL_OES_packed_depth_stencil GL_OES_vertex_array_object GL_OES_element_index_uint GL_OES_vertex_half_float GL_OES_vertex_type_10_10_10_2 GL_ANGLE_instanced_arrays GL_EXT_instanced_arrays GL_OES_mapbuffer GL_EXT_map_buffer_range GL_EXT_multi_draw_arrays GL_EXT_texture_storage GL_OES_texture_3D GL_EXT_unpack_subimage GL_EXT_discard_framebuffer GL_EXT_multisampled_render_to_texture GL_ANGLE_framebuffer_blit GL_NV_framebuffer_blit GL_EXT_shader_framebuffer_fetch GL_NV_pixel_buffer_object GL_APPLE_texture_format_BGRA8888 GL_NVX_gpu_memory_info GL_KHR_parallel_shader_compile GL_KHR_no_error GL_GLOVE_memory_report GL_GLOVE_draw_range_elements GL_GLOVE_command_bundle\0"};
+    // the compressed texture extensions depend on what the device samples natively, the queries and markers on its extensions
+    if(name == GL_EXTENSIONS && mExtensions.empty()) {
+        mExtensions = strings[4];
+        const std::map<GLenum, bool> &compressedFormats = GetCompressedTextureFormats();
+        if(compressedFormats.count(GL_ETC1_RGB8_OES)) {
+            mExtensions += " GL_OES_compressed_ETC1_RGB8_texture GL_OES_compressed_ETC1_RGB8_sub_texture";
+        }
+        auto astc = compressedFormats.find(GL_COMPRESSED_RGBA_ASTC_4x4_KHR);
+        if(astc != compressedFormats.end() && astc->second) {
+            mExtensions += " GL_KHR_texture_compression_astc_ldr";
+        }
+        if(mCommandBufferManager->GetTimestampPool()->IsSupported()) {
+            mExtensions += " GL_EXT_disjoint_timer_query";
+        }
+        if(mCommandBufferManager->GetOcclusionPool()->IsSupported()) {
+            mExtensions += " GL_EXT_occlusion_query_boolean";
+        }
+        if(mVkContext->mIsDebugUtilsSupported) {
+            mExtensions += " GL_EXT_debug_marker";
+        }
+    }
+
     switch(name) {
     case GL_VENDOR:                     return (const GLubyte *)strings[0];
     case GL_RENDERER:                   return (const GLubyte *)strings[1];
     case GL_VERSION:                    return (const GLubyte *)strings[2];
     case GL_SHADING_LANGUAGE_VERSION:   return (const GLubyte *)strings[3];
-    case GL_EXTENSIONS:                 return (const GLubyte *)strings[4];
+    case GL_EXTENSIONS:                 return (const GLubyte *)mExtensions.c_str();
     default:                            RecordError(GL_INVALID_ENUM); return nullptr; 
     }
 }
@@ -41,6 +41,7 @@ Context::GetVertexAttribfv(GLuint index, GLenum pname, GLfloat* params)
     case GL_VERTEX_ATTRIB_ARRAY_STRIDE:         *params = static_cast<GLfloat>(gVertexAttrib->GetStride());      break;
     case GL_VERTEX_ATTRIB_ARRAY_TYPE:           *params = static_cast<GLfloat>(gVertexAttrib->GetType());        break;
     case GL_VERTEX_ATTRIB_ARRAY_NORMALIZED:     *params = static_cast<GLfloat>(gVertexAttrib->GetNormalized());  break;
+    case GL_VERTEX_ATTRIB_ARRAY_DIVISOR_EXT:    *params = static_cast<GLfloat>(gVertexAttrib->GetDivisor());     break;
     case GL_CURRENT_VERTEX_ATTRIB:              gVertexAttrib->GetGenericValue(params);                          break;
     case GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING: { const BufferObject *vbo = gVertexAttrib->GetExternalVbo();
                                                   *params = vbo ? static_cast<GLfloat>(mResourceManager->GetBufferID(vbo)) : 0.0f;
@@ -68,6 +69,7 @@ Context::GetVertexAttribiv(GLuint index, GLenum pname, GLint* params)
     case GL_VERTEX_ATTRIB_ARRAY_STRIDE:         *params = static_cast<GLint>(gVertexAttrib->GetStride());           break;
     case GL_VERTEX_ATTRIB_ARRAY_TYPE:           *params = static_cast<GLint>(gVertexAttrib->GetType());             break;
     case GL_VERTEX_ATTRIB_ARRAY_NORMALIZED:     *params = static_cast<GLint>(gVertexAttrib->GetNormalized());       break;
+    case GL_VERTEX_ATTRIB_ARRAY_DIVISOR_EXT:    *params = static_cast<GLint>(gVertexAttrib->GetDivisor());          break;
     case GL_CURRENT_VERTEX_ATTRIB:              gVertexAttrib->GetGenericValue(params); break;
     case GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING: { const BufferObject *vbo = gVertexAttrib->GetExternalVbo();
                                                   *params = vbo ? static_cast<GLint>(mResourceManager->GetBufferID(vbo)) : 0;
@@ -255,12 +257,14 @@ Context::VertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean no
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(type != GL_BYTE && type != GL_UNSIGNED_BYTE && type != GL_SHORT && type != GL_UNSIGNED_SHORT && type != GL_FIXED && type != GL_FLOAT) {
+    const bool packed = type == GL_INT_10_10_10_2_OES || type == GL_UNSIGNED_INT_10_10_10_2_OES;
+    if(type != GL_BYTE && type != GL_UNSIGNED_BYTE && type != GL_SHORT && type != GL_UNSIGNED_SHORT && type != GL_FIXED && type != GL_FLOAT &&
+       type != GL_HALF_FLOAT_OES && !packed) {
         RecordError(GL_INVALID_ENUM);
         return;
     }
 
-    if((size < 1 || size > 4) || (stride < 0) || (index >= GLOVE_MAX_VERTEX_ATTRIBS)) {
+    if((size < 1 || size > 4) || (packed && size < 3) || (stride < 0) || (index >= GLOVE_MAX_VERTEX_ATTRIBS)) {
         RecordError(GL_INVALID_VALUE);
         return;
     }
@@ -270,3 +274,128 @@ Context::VertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean no
     mResourceManager->GetGenericVertexAttribute(index)->Set(size, type, normalized, stride, ptr, attachedVBO, requiresInternalVBO);
     mPipeline->SetUpdateVertexAttribVBOs(true);
 }
+
+void
+Context::VertexAttribDivisorEXT(GLuint index, GLuint divisor)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(index >= GLOVE_MAX_VERTEX_ATTRIBS) {
+        RecordError(GL_INVALID_VALUE);
+        return;
+    }
+
+    if(divisor > 1 && !mVkContext->mIsVertexAttributeDivisorSupported) {
+        GLOVE_PRINT_ERR("VK_EXT_vertex_attribute_divisor is not supported, divisor %u of attribute %u is treated as 1\n", divisor, index);
+    }
+
+    GenericVertexAttribute *gVertexAttrib = mResourceManager->GetGenericVertexAttribute(index);
+
+    if(gVertexAttrib->GetDivisor() != divisor) {
+        gVertexAttrib->SetDivisor(divisor);
+        mPipeline->SetUpdateVertexAttribVBOs(true);
+    }
+}
+
+void
+Context::BindVertexArrayOES(GLuint array)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(array && !mResourceManager->VertexArrayExists(array)) {
+        RecordError(GL_INVALID_OPERATION);
+        return;
+    }
+
+    VertexArray *activeVertexArray = mResourceManager->GetActiveVertexArray();
+    VertexArray *vertexArray       = mResourceManager->GetVertexArray(array);
+    vertexArray->SetWasBound();
+    if(vertexArray == activeVertexArray) {
+        return;
+    }
+
+    // pending attribute changes belong to the outgoing vertex array
+    if(mPipeline->GetUpdateVertexAttribVBOs()) {
+        activeVertexArray->InvalidateLayout();
+        mPipeline->SetUpdateVertexAttribVBOs(false);
+    }
+
+    // the element array buffer binding is vertex array state; the outgoing
+    // vertex array keeps the reference that the binding holds on the buffer
+    StateActiveObjects *activeObjects = mStateManager.GetActiveObjectsState();
+    activeVertexArray->SetElementArrayBuffer(activeObjects->GetActiveBufferObject(GL_ELEMENT_ARRAY_BUFFER));
+    activeObjects->SetActiveBufferObject(GL_ELEMENT_ARRAY_BUFFER, vertexArray->GetElementArrayBuffer());
+    vertexArray->SetElementArrayBuffer(nullptr);
+    mPipeline->SetUpdateIndexBuffer(true);
+
+    vertexArray->CopyGenericValues(activeVertexArray);
+    mResourceManager->SetActiveVertexArray(vertexArray);
+}
+
+void
+Context::DeleteVertexArraysOES(GLsizei n, const GLuint *arrays)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(n < 0) {
+        RecordError(GL_INVALID_VALUE);
+        return;
+    }
+
+    if(arrays == nullptr) {
+        return;
+    }
+
+    if(IsDrawPending()) {
+        Finish();
+    }
+
+    while(n-- != 0) {
+        uint32_t array = *arrays++;
+
+        if(array && mResourceManager->VertexArrayExists(array)) {
+            VertexArray *vertexArray = mResourceManager->GetVertexArray(array);
+
+            if(vertexArray == mResourceManager->GetActiveVertexArray()) {
+                BindVertexArrayOES(0);
+            }
+
+            BufferObject *elementArrayBuffer = vertexArray->GetElementArrayBuffer();
+            if(elementArrayBuffer && mResourceManager->GetBufferID(elementArrayBuffer)) {
+                elementArrayBuffer->Unbind();
+            }
+            mResourceManager->DeallocateVertexArray(array);
+        }
+    }
+    mResourceManager->CleanPurgeList();
+}
+
+void
+Context::GenVertexArraysOES(GLsizei n, GLuint *arrays)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(n < 0) {
+        RecordError(GL_INVALID_VALUE);
+        return;
+    }
+
+    if(arrays == nullptr) {
+        return;
+    }
+
+    while(n != 0) {
+        *arrays = mResourceManager->AllocateVertexArray();
+        mResourceManager->GetVertexArray(*arrays);
+        arrays++;
+        n--;
+    }
+}
+
+GLboolean
+Context::IsVertexArrayOES(GLuint array)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    return (array && mResourceManager->VertexArrayExists(array) && mResourceManager->GetVertexArray(array)->WasBound()) ? GL_TRUE : GL_FALSE;
+}
@@ -0,0 +1,286 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       FixPosition.cpp
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Convert gl_Position from the GL to the Vulkan clip space in SPIR-V
+ *
+ *  @section
+ *
+ *  GL clip space has z in [-w, w] and, when VK_KHR_maintenance1 cannot
+ *  flip the viewport, y pointing the other way than Vulkan. Patching the
+ *  generated SPIR-V instead of the ESSL source keeps the converted shaders
+ *  and the cached SPIR-V independent of the surface: the Y flip, and the
+ *  rotation of the pre-rotated window surfaces, are specialization constants
+ *  that are only resolved when a pipeline is created.
+ *
+ */
+
+#include "FixPosition.h"
+#include "SPIRV/spirv.hpp"
+#include "utils/globals.h"
+#include "utils/glLogger.h"
+
+#include <initializer_list>
+#include <stddef.h>
+
+namespace {
+
+const size_t   SpvHeaderWords = 5;
+const uint32_t FloatOne       = 0x3f800000;
+const uint32_t FloatHalf      = 0x3f000000;
+const uint32_t FloatZero      = 0x00000000;
+
+void AddInstruction(std::vector<uint32_t>& spv, spv::Op op, std::initializer_list<uint32_t> operands) {
+    spv.push_back((static_cast<uint32_t>(operands.size() + 1) << spv::WordCountShift) | static_cast<uint32_t>(op));
+    spv.insert(spv.end(), operands);
+}
+
+bool IsTypeDeclaration(uint32_t op) {
+    return (op >= spv::OpTypeVoid      && op <= spv::OpTypeForwardPointer) ||
+           (op >= spv::OpConstantTrue  && op <= spv::OpSpecConstantOp);
+}
+
+} // anon namespace
+
+bool
+FixPosition(std::vector<uint32_t>& spv)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(spv.size() < SpvHeaderWords || spv[0] != spv::MagicNumber) {
+        return false;
+    }
+
+    uint32_t entryPoint     = 0;
+    uint32_t positionVar    = 0;    // gl_Position declared on its own
+    uint32_t positionBlock  = 0;    // or as a member of gl_PerVertex
+    uint32_t positionMember = 0;
+    uint32_t floatType      = 0;
+    uint32_t vec4Type       = 0;
+    uint32_t intType        = 0;
+    uint32_t memberIndex    = 0;
+    uint32_t half           = 0;
+    uint32_t outputVec4Ptr  = 0;
+    size_t   typesBegin     = 0;
+    size_t   functionsBegin = 0;
+    std::vector<std::pair<uint32_t, uint32_t>> outputPointers;    // pointer type, pointee type
+    std::vector<std::pair<uint32_t, uint32_t>> outputVariables;   // variable, pointer type
+    std::vector<size_t> returns;
+    bool     inEntryPoint   = false;
+
+    for(size_t i = SpvHeaderWords; i < spv.size(); ) {
+        const uint32_t  op        = spv[i] & spv::OpCodeMask;
+        const uint32_t  wordCount = spv[i] >> spv::WordCountShift;
+        const uint32_t *ins       = &spv[i];
+        if(wordCount == 0 || i + wordCount > spv.size()) {
+            return false;
+        }
+
+        if(!typesBegin && IsTypeDeclaration(op)) {
+            typesBegin = i;
+        }
+
+        switch(op) {
+        case spv::OpEntryPoint:
+            if(ins[1] == spv::ExecutionModelVertex) {
+                entryPoint = ins[2];
+            }
+            break;
+        case spv::OpDecorate:
+            if(wordCount >= 4 && ins[2] == spv::DecorationBuiltIn && ins[3] == spv::BuiltInPosition) {
+                positionVar = ins[1];
+            }
+            // the module has been patched already
+            if(wordCount >= 4 && ins[2] == spv::DecorationSpecId && ins[3] == GLOVE_SPEC_CONSTANT_Y_SCALE_ID) {
+                return true;
+            }
+            break;
+        case spv::OpMemberDecorate:
+            if(wordCount >= 5 && ins[3] == spv::DecorationBuiltIn && ins[4] == spv::BuiltInPosition) {
+                positionBlock  = ins[1];
+                positionMember = ins[2];
+            }
+            break;
+        case spv::OpTypeFloat:
+            if(ins[2] == 32) {
+                floatType = ins[1];
+            }
+            break;
+        case spv::OpTypeVector:
+            if(floatType && ins[2] == floatType && ins[3] == 4) {
+                vec4Type = ins[1];
+            }
+            break;
+        case spv::OpTypeInt:
+            if(ins[2] == 32 && ins[3] == 1) {
+                intType = ins[1];
+            }
+            break;
+        case spv::OpConstant:
+            if(wordCount == 4 && intType && ins[1] == intType && ins[3] == positionMember && positionBlock) {
+                memberIndex = ins[2];
+            } else if(wordCount == 4 && floatType && ins[1] == floatType && ins[3] == FloatHalf) {
+                half = ins[2];
+            }
+            break;
+        case spv::OpTypePointer:
+            if(ins[2] == spv::StorageClassOutput) {
+                if(vec4Type && ins[3] == vec4Type) {
+                    outputVec4Ptr = ins[1];
+                }
+                outputPointers.push_back(std::make_pair(ins[1], ins[3]));
+            }
+            break;
+        case spv::OpVariable:
+            if(!functionsBegin && ins[3] == spv::StorageClassOutput) {
+                outputVariables.push_back(std::make_pair(ins[2], ins[1]));
+            }
+            break;
+        case spv::OpFunction:
+            if(!functionsBegin) {
+                functionsBegin = i;
+            }
+            inEntryPoint = ins[2] == entryPoint;
+            break;
+        case spv::OpFunctionEnd:
+            inEntryPoint = false;
+            break;
+        case spv::OpReturn:
+            if(inEntryPoint) {
+                returns.push_back(i);
+            }
+            break;
+        default:
+            break;
+        }
+
+        i += wordCount;
+    }
+
+    // nothing to patch in a fragment shader, or in a vertex shader that does not output gl_Position
+    if(!entryPoint || !functionsBegin || !typesBegin || returns.empty() || (!positionVar && !positionBlock)) {
+        return true;
+    }
+    if(!floatType || !vec4Type) {
+        return false;
+    }
+
+    // the gl_PerVertex variable
+    uint32_t perVertexVar = 0;
+    if(!positionVar) {
+        for(const auto &var : outputVariables) {
+            for(const auto &ptr : outputPointers) {
+                if(var.second == ptr.first && ptr.second == positionBlock) {
+                    perVertexVar = var.first;
+                }
+            }
+        }
+        if(!perVertexVar) {
+            return true;
+        }
+    }
+
+    uint32_t bound  = spv[3];
+    uint32_t yScale = bound++;
+    uint32_t cosine = bound++;
+    uint32_t sine   = bound++;
+
+    std::vector<uint32_t> types;
+    if(perVertexVar && !intType) {
+        intType = bound++;
+        AddInstruction(types, spv::OpTypeInt, {intType, 32, 1});
+    }
+    if(perVertexVar && !memberIndex) {
+        memberIndex = bound++;
+        AddInstruction(types, spv::OpConstant, {intType, memberIndex, positionMember});
+    }
+    if(!outputVec4Ptr) {
+        outputVec4Ptr = bound++;
+        AddInstruction(types, spv::OpTypePointer, {outputVec4Ptr, spv::StorageClassOutput, vec4Type});
+    }
+    if(!half) {
+        half = bound++;
+        AddInstruction(types, spv::OpConstant, {floatType, half, FloatHalf});
+    }
+    AddInstruction(types, spv::OpSpecConstant, {floatType, yScale, FloatOne});
+    AddInstruction(types, spv::OpSpecConstant, {floatType, cosine, FloatOne});
+    AddInstruction(types, spv::OpSpecConstant, {floatType, sine  , FloatZero});
+
+    std::vector<uint32_t> out;
+    out.reserve(spv.size() + types.size() + 16 + returns.size() * 64);
+    out.insert(out.end(), spv.begin(), spv.begin() + typesBegin);
+    AddInstruction(out, spv::OpDecorate, {yScale, spv::DecorationSpecId, GLOVE_SPEC_CONSTANT_Y_SCALE_ID});
+    AddInstruction(out, spv::OpDecorate, {cosine, spv::DecorationSpecId, GLOVE_SPEC_CONSTANT_ROTATION_ID});
+    AddInstruction(out, spv::OpDecorate, {sine  , spv::DecorationSpecId, GLOVE_SPEC_CONSTANT_ROTATION_ID + 1});
+    out.insert(out.end(), spv.begin() + typesBegin, spv.begin() + functionsBegin);
+    out.insert(out.end(), types.begin(), types.end());
+
+    size_t copied = functionsBegin;
+    for(size_t ret : returns) {
+        out.insert(out.end(), spv.begin() + copied, spv.begin() + ret);
+        copied = ret;
+
+        uint32_t position = positionVar;
+        if(!position) {
+            position = bound++;
+            AddInstruction(out, spv::OpAccessChain, {outputVec4Ptr, position, perVertexVar, memberIndex});
+        }
+
+        const uint32_t pos     = bound++;
+        const uint32_t x       = bound++;
+        const uint32_t y       = bound++;
+        const uint32_t scaledY = bound++;
+        const uint32_t xCos    = bound++;
+        const uint32_t ySin    = bound++;
+        const uint32_t newX    = bound++;
+        const uint32_t xSin    = bound++;
+        const uint32_t yCos    = bound++;
+        const uint32_t newY    = bound++;
+        const uint32_t z       = bound++;
+        const uint32_t w       = bound++;
+        const uint32_t zw      = bound++;
+        const uint32_t newZ    = bound++;
+        const uint32_t pos0    = bound++;
+        const uint32_t pos1    = bound++;
+        const uint32_t pos2    = bound++;
+        AddInstruction(out, spv::OpLoad            , {vec4Type , pos    , position});
+        AddInstruction(out, spv::OpCompositeExtract, {floatType, x      , pos, 0});
+        AddInstruction(out, spv::OpCompositeExtract, {floatType, y      , pos, 1});
+        AddInstruction(out, spv::OpFMul            , {floatType, scaledY, y, yScale});
+        AddInstruction(out, spv::OpFMul            , {floatType, xCos   , x, cosine});
+        AddInstruction(out, spv::OpFMul            , {floatType, ySin   , scaledY, sine});
+        AddInstruction(out, spv::OpFSub            , {floatType, newX   , xCos, ySin});
+        AddInstruction(out, spv::OpFMul            , {floatType, xSin   , x, sine});
+        AddInstruction(out, spv::OpFMul            , {floatType, yCos   , scaledY, cosine});
+        AddInstruction(out, spv::OpFAdd            , {floatType, newY   , xSin, yCos});
+        AddInstruction(out, spv::OpCompositeExtract, {floatType, z      , pos, 2});
+        AddInstruction(out, spv::OpCompositeExtract, {floatType, w      , pos, 3});
+        AddInstruction(out, spv::OpFAdd            , {floatType, zw     , z, w});
+        AddInstruction(out, spv::OpFMul            , {floatType, newZ   , zw, half});
+        AddInstruction(out, spv::OpCompositeInsert , {vec4Type , pos0   , newX, pos, 0});
+        AddInstruction(out, spv::OpCompositeInsert , {vec4Type , pos1   , newY, pos0, 1});
+        AddInstruction(out, spv::OpCompositeInsert , {vec4Type , pos2   , newZ, pos1, 2});
+        AddInstruction(out, spv::OpStore           , {position , pos2});
+    }
+    out.insert(out.end(), spv.begin() + copied, spv.end());
+
+    out[3] = bound;
+    spv.swap(out);
+
+    return true;
+}
@@ -0,0 +1,42 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       FixPosition.h
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Convert gl_Position from the GL to the Vulkan clip space in SPIR-V
+ *
+ */
+
+#ifndef __FIX_POSITION_H__
+#define __FIX_POSITION_H__
+
+#include <vector>
+#include <stdint.h>
+
+/// Stores before every return of the vertex entry point
+///     x             = gl_Position.x;
+///     y             = gl_Position.y * yScale;
+///     gl_Position.x = x * cosine - y * sine;
+///     gl_Position.y = x * sine   + y * cosine;
+///     gl_Position.z = (gl_Position.z + gl_Position.w) * 0.5;
+/// where yScale is a float specialization constant (GLOVE_SPEC_CONSTANT_Y_SCALE_ID),
+/// 1.0 unless the pipeline sets it to -1.0 for a Y inverted surface, and cosine and
+/// sine (GLOVE_SPEC_CONSTANT_ROTATION_ID and the next one) rotate the position onto
+/// a pre-rotated window surface, 1.0 and 0.0 elsewhere
+bool FixPosition(std::vector<uint32_t>& spv);
+
+#endif // __FIX_POSITION_H__
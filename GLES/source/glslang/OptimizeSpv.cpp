@@ -0,0 +1,89 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       OptimizeSpv.cpp
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Optional SPIR-V optimization of the generated shaders
+ *
+ *  @section
+ *
+ *  glslang emits SPIR-V without any optimization, which leaves all the work
+ *  to the compiler of the driver. The SPIRV-Tools recipes inline, fold and
+ *  remove dead code before the modules are cached, so that the cost is paid
+ *  once per program rather than by every pipeline created from it.
+ *
+ */
+
+#include "OptimizeSpv.h"
+#include "utils/glLogger.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#ifdef GLOVE_SPIRV_OPT
+#include "spirv-tools/optimizer.hpp"
+#endif // GLOVE_SPIRV_OPT
+
+spv_opt_recipe_t
+GetSpvOptRecipe(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+#ifdef GLOVE_SPIRV_OPT
+    static const spv_opt_recipe_t recipe = [] {
+        const char *env = getenv("GLOVE_SPIRV_OPT");
+        if(env == nullptr || !strcmp(env, "performance")) {
+            return SPV_OPT_RECIPE_PERFORMANCE;
+        }
+        return strcmp(env, "size") ? SPV_OPT_RECIPE_NONE : SPV_OPT_RECIPE_SIZE;
+    }();
+
+    return recipe;
+#else
+    return SPV_OPT_RECIPE_NONE;
+#endif // GLOVE_SPIRV_OPT
+}
+
+bool
+OptimizeSpv(std::vector<uint32_t>& spv, spv_opt_recipe_t recipe)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+#ifdef GLOVE_SPIRV_OPT
+    if(recipe == SPV_OPT_RECIPE_NONE) {
+        return true;
+    }
+
+    spvtools::Optimizer optimizer(SPV_ENV_VULKAN_1_0);
+    if(recipe == SPV_OPT_RECIPE_SIZE) {
+        optimizer.RegisterSizePasses();
+    } else {
+        optimizer.RegisterPerformancePasses();
+    }
+
+    std::vector<uint32_t> optimized;
+    if(!optimizer.Run(spv.data(), spv.size(), &optimized)) {
+        return false;
+    }
+    spv.swap(optimized);
+
+    return true;
+#else
+    (void)spv;
+    return recipe == SPV_OPT_RECIPE_NONE;
+#endif // GLOVE_SPIRV_OPT
+}
@@ -0,0 +1,44 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       OptimizeSpv.h
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Optional SPIR-V optimization of the generated shaders
+ *
+ */
+
+#ifndef __OPTIMIZE_SPV_H__
+#define __OPTIMIZE_SPV_H__
+
+#include <vector>
+#include <stdint.h>
+
+typedef enum {
+    SPV_OPT_RECIPE_NONE = 0,
+    SPV_OPT_RECIPE_SIZE,
+    SPV_OPT_RECIPE_PERFORMANCE
+} spv_opt_recipe_t;
+
+/// The recipe is read once from the GLOVE_SPIRV_OPT environment variable
+/// ("none", "size" or "performance", the default). It is always
+/// SPV_OPT_RECIPE_NONE when GLOVE is built without SPIRV_OPT
+spv_opt_recipe_t GetSpvOptRecipe(void);
+
+/// Runs the passes of recipe on spv. On failure spv is left as it was
+bool OptimizeSpv(std::vector<uint32_t>& spv, spv_opt_recipe_t recipe);
+
+#endif // __OPTIMIZE_SPV_H__
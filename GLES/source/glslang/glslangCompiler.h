@@ -56,7 +56,7 @@ public:
     
     /// Get Functions
     glslang::TShader    *GetShader(ESSL_VERSION version);
-    const  char         *GetCompileInfoLog(ESSL_VERSION version)     { FUN_ENTRY(GL_LOG_TRACE); return GetShader(version)->getInfoLog();}
+    const  char         *GetCompileInfoLog(ESSL_VERSION version)     { FUN_ENTRY(GL_LOG_TRACE); return GetShader(version) ? GetShader(version)->getInfoLog() : "";}
 };
 
 #endif // __GLSLANGCOMPILER_H__
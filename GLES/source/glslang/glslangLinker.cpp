@@ -22,6 +22,8 @@
  */
 
 #include "glslangLinker.h"
+#include "FixPosition.h"
+#include "OptimizeSpv.h"
 
 GlslangLinker::GlslangLinker()
 {
@@ -66,6 +68,16 @@ GlslangLinker::GenerateSPV(std::vector<unsigned int>& spv, EShLanguage language,
 
     spv.clear();
     glslang::GlslangToSpv(*mProgramMap[version]->getIntermediate(language), spv);
+
+    /// Vulkan clip space, for the vertex shaders converted to ESSL 400
+    if(language == EShLangVertex && version == ESSL_VERSION_400 && !FixPosition(spv)) {
+        GLOVE_PRINT_ERR("Invalid SPIR-V generated for the vertex shader\n");
+    }
+
+    /// the optimized modules are the ones stored in the program cache
+    if(version == ESSL_VERSION_400 && !OptimizeSpv(spv, GetSpvOptRecipe())) {
+        GLOVE_PRINT_ERR("SPIR-V optimization failed, the shader is used as generated\n");
+    }
 }
 
 bool
@@ -39,11 +39,12 @@ private:
     std::map<ESSL_VERSION, glslang::TProgram *> mProgramMap;
     GlslangIoMapResolver                        mIoMapResolver;
 
-    void                                Release(void);
 public:
     GlslangLinker();
     ~GlslangLinker();
 
+    void                                Release(void);
+
 // Link/Validate Functions
     bool                                LinkProgram    (glslang::TShader* vertShader, glslang::TShader* fragShader, ESSL_VERSION version);
     bool                                ValidateProgram(glslang::TShader* vertShader, glslang::TShader* fragShader, ESSL_VERSION version);
@@ -54,7 +55,7 @@ public:
 // Get Functions
     inline GlslangIoMapResolver        *GetIoMapResolver(void)                       { FUN_ENTRY(GL_LOG_TRACE); return &mIoMapResolver; }
            glslang::TProgram           *GetProgram(ESSL_VERSION version);
-           const char                  *GetLinkInfoLog(ESSL_VERSION version)         { FUN_ENTRY(GL_LOG_TRACE); return GetProgram(version)->getInfoLog(); } 
+           const char                  *GetLinkInfoLog(ESSL_VERSION version)         { FUN_ENTRY(GL_LOG_TRACE); return GetProgram(version) ? GetProgram(version)->getInfoLog() : ""; }
 };
 
 #endif // __GLSLANGLINKER_H__
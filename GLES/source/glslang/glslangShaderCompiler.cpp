@@ -21,6 +21,7 @@
  *
  */
 
+#include <set>
 #include <vector>
 #include <sstream>
 #include "glslang/Include/intermediate.h"
@@ -28,8 +29,12 @@
 #include "glslangShaderCompiler.h"
 #include "FixSampler.h"
 #include "utils/glLogger.h"
+#include "utils/glProfiler.h"
+#include "utils/shaderStats.h"
+#include "utils/startupProfile.h"
 #include "utils/parser_helpers.h"
 
+std::once_flag   GlslangShaderCompiler::mInitFlag;
 bool             GlslangShaderCompiler::mInitialized = false;
 TBuiltInResource GlslangShaderCompiler::mTBuiltInResource;
 
@@ -40,8 +45,11 @@ GlslangShaderCompiler::GlslangShaderCompiler()
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    mShaderCompiler[SHADER_COMPILER_VERTEX]   = nullptr;
-    mShaderCompiler[SHADER_COMPILER_FRAGMENT] = nullptr;
+    /// reused by every shader and program this compiler handles
+    mShaderCompiler[SHADER_COMPILER_VERTEX]   = new GlslangCompiler();
+    mShaderCompiler[SHADER_COMPILER_FRAGMENT] = new GlslangCompiler();
+    mProgramLinker                            = new GlslangLinker();
+    mShaderConverter                          = new ShaderConverter();
 
     mPrintReflection[ESSL_VERSION_100] = false;
     mPrintReflection[ESSL_VERSION_400] = false;
@@ -54,7 +62,6 @@ GlslangShaderCompiler::~GlslangShaderCompiler()
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    TerminateCompiler();
     Release();
 }
 
@@ -66,6 +73,7 @@ GlslangShaderCompiler::Release()
     SafeDelete(mShaderCompiler[SHADER_COMPILER_VERTEX]);
     SafeDelete(mShaderCompiler[SHADER_COMPILER_FRAGMENT]);
     SafeDelete(mProgramLinker);
+    SafeDelete(mShaderConverter);
     SafeDelete(mShaderReflection);
 }
 
@@ -74,12 +82,12 @@ GlslangShaderCompiler::InitCompiler()
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(!mInitialized) {
+    std::call_once(mInitFlag, []() {
         mInitialized = glslang::InitializeProcess();
         assert(mInitialized);
 
         InitCompilerResources();
-    }
+    });
 }
 
 void
@@ -105,17 +113,6 @@ GlslangShaderCompiler::InitReflection()
     mShaderReflection = new ShaderReflection();
 }
 
-void
-GlslangShaderCompiler::TerminateCompiler()
-{
-    FUN_ENTRY(GL_LOG_DEBUG);
-
-    if(mInitialized) {
-        glslang::FinalizeProcess();
-        mInitialized = false;
-    }
-}
-
 bool
 GlslangShaderCompiler::CompileShader(const char* const* source, shader_type_t shaderType, ESSL_VERSION version)
 {
@@ -124,14 +121,14 @@ GlslangShaderCompiler::CompileShader(const char* const* source, shader_type_t sh
     shader_compiler_type_t  type = (shaderType == SHADER_TYPE_VERTEX) ? SHADER_COMPILER_VERTEX : SHADER_COMPILER_FRAGMENT;
     EShLanguage             lang = (shaderType == SHADER_TYPE_VERTEX) ? EShLangVertex          : EShLangFragment;
 
-    SafeDelete(mShaderCompiler[type]);
+    GLOVE_SHADER_STAGE(SHADER_STAGE_COMPILE);
+    GLOVE_STARTUP_PHASE(STARTUP_PHASE_FIRST_COMPILE);
     mSourceMap[version][type] = string(*source);
-    mShaderCompiler[type]     = new GlslangCompiler();
     return mShaderCompiler[type]->CompileShader(source, &mTBuiltInResource, lang, version);
 }
 
 const char*
-GlslangShaderCompiler::ConvertShader(uintptr_t program_ptr, shader_type_t shaderType, ESSL_VERSION version_in, ESSL_VERSION version_out, bool isYInverted)
+GlslangShaderCompiler::ConvertShader(uintptr_t program_ptr, shader_type_t shaderType, ESSL_VERSION version_in, ESSL_VERSION version_out)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
@@ -140,11 +137,13 @@ GlslangShaderCompiler::ConvertShader(uintptr_t program_ptr, shader_type_t shader
         SaveShaderSourceToFile(program_ptr, false, mSourceMap[version_in][type].c_str(), type);
     }
 
-    mShaderConverter = new ShaderConverter();
-    mShaderConverter->Initialize(shaderType, version_in, version_out);
-    mShaderConverter->SetProgram(mProgramLinker->GetProgram(version_in));
-    mShaderConverter->SetIoMapResolver(mProgramLinker->GetIoMapResolver());
-    mShaderConverter->Convert(mSourceMap[version_out][type], mUniformBlocks, mShaderReflection, isYInverted);
+    {
+        GLOVE_SHADER_STAGE(SHADER_STAGE_CONVERT);
+        mShaderConverter->Initialize(shaderType, version_in, version_out);
+        mShaderConverter->SetProgram(mProgramLinker->GetProgram(version_in));
+        mShaderConverter->SetIoMapResolver(mProgramLinker->GetIoMapResolver());
+        mShaderConverter->Convert(mSourceMap[version_out][type], mUniformBlocks, mShaderReflection);
+    }
 
     if(mSaveSourceToFiles) {
         SaveShaderSourceToFile(program_ptr, true, mSourceMap[version_out][type].c_str(), type);
@@ -154,13 +153,11 @@ GlslangShaderCompiler::ConvertShader(uintptr_t program_ptr, shader_type_t shader
         GlslPrintShaderSource(shaderType, version_out, mSourceMap[version_out][type]);
     }
 
-    delete mShaderConverter;
-
     return mSourceMap[version_out][type].c_str();
 }
 
 bool
-GlslangShaderCompiler::PreprocessShader(uintptr_t program_ptr, shader_type_t shaderType, ESSL_VERSION version_in, ESSL_VERSION version_out, bool isYInverted)
+GlslangShaderCompiler::PreprocessShader(uintptr_t program_ptr, shader_type_t shaderType, ESSL_VERSION version_in, ESSL_VERSION version_out)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
@@ -168,29 +165,40 @@ GlslangShaderCompiler::PreprocessShader(uintptr_t program_ptr, shader_type_t sha
     EShLanguage            lang = (shaderType == SHADER_TYPE_VERTEX) ? EShLangVertex          : EShLangFragment;
 
     mSourceMap[version_out][type] = string(mSourceMap[version_in][type]);
-    const char* source = ConvertShader(program_ptr, shaderType, version_in, version_out, isYInverted);
+    const char* source = ConvertShader(program_ptr, shaderType, version_in, version_out);
+    GLOVE_SHADER_STAGE(SHADER_STAGE_REPARSE);
     return mShaderCompiler[type]->CompileShader(&source, &mTBuiltInResource, lang, version_out);
 }
 
 bool
 GlslangShaderCompiler::LinkProgram(uintptr_t program_ptr, ESSL_VERSION version, vector<uint32_t> &vertSpv, vector<uint32_t> &fragSpv)
 {
-    bool result = mProgramLinker->LinkProgram(mShaderCompiler[SHADER_COMPILER_VERTEX]->GetShader(version),
-                                              mShaderCompiler[SHADER_COMPILER_FRAGMENT]->GetShader(version),
-                                              version);
+    bool result;
+    {
+        GLOVE_SHADER_STAGE(SHADER_STAGE_LINK);
+        result = mProgramLinker->LinkProgram(mShaderCompiler[SHADER_COMPILER_VERTEX]->GetShader(version),
+                                             mShaderCompiler[SHADER_COMPILER_FRAGMENT]->GetShader(version),
+                                             version);
+    }
     if(!result) {
         return false;
     }
 
-    UpdateUniformArraySizes(version);
-    SetUniformLocations();
-    SetUniformBlocksSizes(version);
-    SetUniformNestedStructSizes(version);
-    SetUniformOffsets(version);
-    SetUniformsReflection();
+    {
+        GLOVE_SHADER_STAGE(SHADER_STAGE_REFLECTION);
+        UpdateUniformArraySizes(version);
+        SetUniformLocations();
+        SetUniformBlocksSizes(version);
+        SetUniformNestedStructSizes(version);
+        SetUniformOffsets(version);
+        SetUniformsReflection();
+    }
 
-    mProgramLinker->GenerateSPV(vertSpv, EShLangVertex  , version);
-    mProgramLinker->GenerateSPV(fragSpv, EShLangFragment, version);
+    {
+        GLOVE_SHADER_STAGE(SHADER_STAGE_GENERATE_SPV);
+        mProgramLinker->GenerateSPV(vertSpv, EShLangVertex  , version);
+        mProgramLinker->GenerateSPV(fragSpv, EShLangFragment, version);
+    }
 
     if(mSaveBinaryToFiles) {
         SaveBinaryToFiles(program_ptr, SHADER_COMPILER_VERTEX  , version);
@@ -222,10 +230,11 @@ bool
 GlslangShaderCompiler::ValidateProgram(ESSL_VERSION version)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
+    GLOVE_PROFILE_ZONE("GlslangShaderCompiler::LinkProgram");
+    GLOVE_SHADER_STAGE(SHADER_STAGE_VALIDATE);
 
-    SafeDelete(mProgramLinker);
-
-    mProgramLinker = new GlslangLinker();
+    /// the programs of the previous link refer to shaders that may have been compiled again since
+    mProgramLinker->Release();
     bool result = mProgramLinker->ValidateProgram(mShaderCompiler[SHADER_COMPILER_VERTEX]->GetShader(version),
                                                   mShaderCompiler[SHADER_COMPILER_FRAGMENT]->GetShader(version),
                                                   version);
@@ -369,7 +378,7 @@ GlslangShaderCompiler::GetShaderInfoLog(shader_type_t shaderType, ESSL_VERSION v
     FUN_ENTRY(GL_LOG_DEBUG);
 
     shader_compiler_type_t type = (shaderType == SHADER_TYPE_VERTEX) ? SHADER_COMPILER_VERTEX : SHADER_COMPILER_FRAGMENT;
-    return mShaderCompiler[type] ? mShaderCompiler[type]->GetCompileInfoLog(version) : "";
+    return mShaderCompiler[type]->GetCompileInfoLog(version);
 }
 
 const char*
@@ -377,7 +386,16 @@ GlslangShaderCompiler::GetProgramInfoLog(ESSL_VERSION version)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    return mProgramLinker ? mProgramLinker->GetLinkInfoLog(version) : "";
+    return mProgramLinker->GetLinkInfoLog(version);
+}
+
+const char*
+GlslangShaderCompiler::GetShaderSource(shader_type_t shaderType, ESSL_VERSION version)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    shader_compiler_type_t type = (shaderType == SHADER_TYPE_VERTEX) ? SHADER_COMPILER_VERTEX : SHADER_COMPILER_FRAGMENT;
+    return mSourceMap[version][type].c_str();
 }
 
 void
@@ -610,6 +628,7 @@ void
 GlslangShaderCompiler::PrepareReflection(ESSL_VERSION version)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
+    GLOVE_SHADER_STAGE(SHADER_STAGE_REFLECTION);
 
     // Init Shader Reflection from glslang reflection [100]
     mShaderReflection->Reset();
@@ -617,6 +636,7 @@ GlslangShaderCompiler::PrepareReflection(ESSL_VERSION version)
     CreateUniforms(version);
     CreateUniformBlocks();
     LinkUniformsToUniformBlocks();
+    AssignPushConstantBlocks();
 }
 
 void
@@ -645,6 +665,124 @@ GlslangShaderCompiler::LinkUniformsToUniformBlocks(void)
     }
 }
 
+static uint32_t
+PushConstantAlignment(GLenum type)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    /// std140 base alignment of the basic types that can be push constants
+    switch(type) {
+    case GL_BOOL:
+    case GL_INT:
+    case GL_FLOAT:                          return 4;
+
+    case GL_BOOL_VEC2:
+    case GL_INT_VEC2:
+    case GL_FLOAT_VEC2:                     return 8;
+
+    case GL_BOOL_VEC3:
+    case GL_INT_VEC3:
+    case GL_FLOAT_VEC3:
+    case GL_BOOL_VEC4:
+    case GL_INT_VEC4:
+    case GL_FLOAT_VEC4:
+    case GL_FLOAT_MAT2:
+    case GL_FLOAT_MAT3:
+    case GL_FLOAT_MAT4:                     return 16;
+
+    default:                                return 0;
+    }
+}
+
+static void
+GetSpecializedUniforms(const string &source, set<string> &names)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    /// '#pragma glove_specialize(name, ...)' lists the uniforms to specialize
+    const string pragma(GLOVE_SPECIALIZE_PRAGMA);
+    for(size_t pos = source.find('#'); pos != string::npos; pos = source.find('#', pos + 1)) {
+        size_t lineStart = pos;
+        while(lineStart > 0 && (source[lineStart - 1] == ' ' || source[lineStart - 1] == '\t')) {
+            --lineStart;
+        }
+        if(lineStart > 0 && source[lineStart - 1] != '\n') {
+            continue;
+        }
+
+        size_t found = source.find_first_not_of(" \t", pos + 1);
+        if(found == string::npos || GetNextToken(source, found) != "pragma") {
+            continue;
+        }
+        found = source.find_first_not_of(" \t", found + 6);
+        if(found == string::npos || GetNextToken(source, found) != pragma) {
+            continue;
+        }
+
+        const size_t end = source.find_first_of(")\n", found);
+        found = source.find('(', found + pragma.length());
+        if(end == string::npos || found > end) {
+            continue;
+        }
+
+        while(found < end) {
+            found = source.find_first_not_of(" \t,(", found);
+            const string name = (found < end) ? GetNextToken(source, found) : string();
+            if(name.empty()) {
+                break;
+            }
+            names.insert(name);
+            found += name.length();
+        }
+    }
+}
+
+void
+GlslangShaderCompiler::AssignPushConstantBlocks(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // Default block uniforms of basic types are packed into the push constant block,
+    // as long as they fit, so that updating them does not involve any descriptor.
+    // Scalars to be specialized are packed first, since their values are taken from there
+    set<string> specialized;
+    GetSpecializedUniforms(mSourceMap[ESSL_VERSION_100][SHADER_COMPILER_VERTEX]  , specialized);
+    GetSpecializedUniforms(mSourceMap[ESSL_VERSION_100][SHADER_COMPILER_FRAGMENT], specialized);
+
+    uint32_t offset = 0;
+    for(int pass = 0; pass < 2; ++pass) {
+        for(auto &uni : mUniforms) {
+
+            uniformBlock_t *block = uni.pBlock;
+            if(block->isPushConstant || block->isOpaque || block->pAggregate || uni.arraySize != 1 || IsBuildInUniform(uni.name)) {
+                continue;
+            }
+
+            const bool specialize = (uni.type == GL_BOOL || uni.type == GL_INT || uni.type == GL_FLOAT) && specialized.count(uni.name);
+            if(specialize != (pass == 0)) {
+                continue;
+            }
+
+            const uint32_t alignment = PushConstantAlignment(uni.type);
+            if(!alignment) {
+                continue;
+            }
+
+            const uint32_t blockOffset = (offset + alignment - 1) & ~(alignment - 1);
+            const uint32_t size        = static_cast<uint32_t>(GlslTypeToSize(uni.type));
+            if(blockOffset + size > GLOVE_MAX_PUSH_CONSTANTS_SIZE) {
+                continue;
+            }
+
+            block->isPushConstant     = true;
+            block->pushConstantOffset = blockOffset;
+            block->isSpecialization   = specialize;
+            block->memorySize         = size;
+            offset                    = blockOffset + size;
+        }
+    }
+}
+
 aggregatePairList_t
 GlslangShaderCompiler::CreateAggregates(const std::string uniformName)
 {
@@ -728,7 +866,7 @@ GlslangShaderCompiler::CreateUniforms(ESSL_VERSION version)
 
         /// Create Aggregate
         aggregatePairList_t aggregatePairList;
-        if(type == GL_SAMPLER_2D || type == GL_SAMPLER_CUBE) {
+        if(IsGlSampler(type)) {
             aggregatePairList.push_back(make_pair(nullptr, -1));
         } else {
             aggregatePairList = CreateAggregates(name);
@@ -779,6 +917,8 @@ GlslangShaderCompiler::SetUniformsReflection(void)
         mShaderReflection->SetUniformBlockBlockSize(block.second.memorySize, uniformBlockIndex);
         mShaderReflection->SetUniformBlockBlockStage(block.second.stage, uniformBlockIndex);
         mShaderReflection->SetUniformBlockOpaque(block.second.isOpaque, uniformBlockIndex);
+        mShaderReflection->SetUniformBlockPushConstant(block.second.isPushConstant, block.second.pushConstantOffset, uniformBlockIndex);
+        mShaderReflection->SetUniformBlockSpecialization(block.second.isSpecialization, uniformBlockIndex);
         ++uniformBlockIndex;
     }
 
@@ -24,6 +24,7 @@
 #ifndef __GLSLANGSHADERCOMPILER_H__
 #define __GLSLANGSHADERCOMPILER_H__
 
+#include <mutex>
 #include "resources/shaderCompiler.h"
 #include "shaderConverter.h"
 #include "glslangCompiler.h"
@@ -40,6 +41,9 @@ private:
         SHADER_COMPILER_TYPE_MAX
     } shader_compiler_type_t;
 
+    /// glslang is initialized once per process, by the first compiler created, and
+    /// stays initialized so that compilers released and created again do not pay for it
+    static std::once_flag   mInitFlag;
     static bool             mInitialized;
     static TBuiltInResource mTBuiltInResource;
 
@@ -77,17 +81,14 @@ private:
 
 /// Init Functions
     void                    InitCompiler(void);
-    void                    InitCompilerResources(void);
+    static void             InitCompilerResources(void);
     void                    InitReflection(void);
 
-/// Terminate Functions
-    void                    TerminateCompiler(void);
-
 /// Release Functions
     void                    Release(void);
 
 /// Convert Functions
-    const char             *ConvertShader(uintptr_t program_ptr, shader_type_t shaderType, ESSL_VERSION version_in, ESSL_VERSION version_out, bool isYInverted);
+    const char             *ConvertShader(uintptr_t program_ptr, shader_type_t shaderType, ESSL_VERSION version_in, ESSL_VERSION version_out);
 
 /// In/Out File Functions
     void                    PrintReadableSPV(shader_compiler_type_t type, ESSL_VERSION version);
@@ -100,6 +101,7 @@ private:
     void                    CreateUniformBlocks(void);
     aggregatePairList_t     CreateAggregates(const std::string uniformName);
     void                    LinkUniformsToUniformBlocks(void);
+    void                    AssignPushConstantBlocks(void);
     void                    SetAttributesReflection(ESSL_VERSION version);
 
 /// Reflection Functions (OUT)
@@ -134,8 +136,7 @@ public:
     bool                     PreprocessShader(uintptr_t program_ptr,
                                               shader_type_t shaderType,
                                               ESSL_VERSION version_in,
-                                              ESSL_VERSION version_out,
-                                              bool isYInverted)               override;
+                                              ESSL_VERSION version_out)       override;
     bool                     CompileShader(const char* const* source,
                                            shader_type_t shaderType,
                                            ESSL_VERSION version)              override;
@@ -147,6 +148,9 @@ public:
     const char              *GetProgramInfoLog(ESSL_VERSION version)          override;
     const char              *GetShaderInfoLog(shader_type_t shaderType,
                                               ESSL_VERSION  version)          override;
+    /// source of the last shader compiled for the type, which is the one linked
+    const char              *GetShaderSource(shader_type_t shaderType,
+                                             ESSL_VERSION  version)           override;
     inline ShaderReflection *GetShaderReflection(void)                        override { FUN_ENTRY(GL_LOG_TRACE); return mShaderReflection; }
 
 /// Enable Functions
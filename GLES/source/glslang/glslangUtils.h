@@ -54,6 +54,9 @@ struct uniformBlock_t {
     int32_t                         arraySize;      /// Uniform block's Array size 
     shader_type_t                   stage;          /// Uniform block's shader stage
     const aggregate_t *             pAggregate;
+    bool                            isPushConstant; /// true if declared as a member of the push constant block
+    uint32_t                        pushConstantOffset; /// offset of the member in the push constant block
+    bool                            isSpecialization; /// true if the shaders read it through a specialization constant
 
     uniformBlock_t():
         binding(0),
@@ -61,7 +64,10 @@ struct uniformBlock_t {
         memorySize(0),
         arraySize(0),
         stage(SHADER_TYPE_INVALID),
-        pAggregate(nullptr)
+        pAggregate(nullptr),
+        isPushConstant(false),
+        pushConstantOffset(0),
+        isSpecialization(false)
     {
         FUN_ENTRY(GL_LOG_TRACE);
     }
@@ -74,7 +80,10 @@ struct uniformBlock_t {
        memorySize(bs),
        arraySize(ba),
        stage(bStage),
-       pAggregate(pAggr)
+       pAggregate(pAggr),
+       isPushConstant(false),
+       pushConstantOffset(0),
+       isSpecialization(false)
     {
         FUN_ENTRY(GL_LOG_TRACE);
     }
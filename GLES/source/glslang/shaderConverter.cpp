@@ -19,16 +19,41 @@
  *
  *  @brief      ESSL code converter from an ESSL version to another. Currently supports ESSL 100 to ESSL 400.
  *
+ *  @section
+ *
+ *  The conversion is a single pass over the source: comments, preprocessor
+ *  lines and tokens are recognized as they are met, the declarations that
+ *  need a rewrite are parsed on the spot and everything is appended to one
+ *  preallocated output buffer. No line is added or removed outside of the
+ *  header, so the line numbers in the compiler messages stay meaningful.
+ *  gl_Position is converted to the Vulkan clip space on the SPIR-V, see
+ *  FixPosition().
+ *
+ *  ESSL 100 shaders declare their precision inside #ifdef GL_ES, which is
+ *  not defined for GLSL 400. Unless GLOVE_RELAXED_PRECISION is "false",
+ *  those blocks are kept through GLOVE_GL_ES and the ESSL 100 defaults are
+ *  declared, so that glslang decorates the mediump and lowp values with
+ *  RelaxedPrecision and the driver may evaluate them at 16 bits.
+ *
+ *  gl_LastFragData of EXT_shader_framebuffer_fetch is read from the color
+ *  attachment as a subpass input, declared at the binding that follows the
+ *  live uniform blocks, which the program reserves for it.
+ *
  */
 
 #include "shaderConverter.h"
 #include "resources/shaderProgram.h"
 #include "utils/glUtils.h"
 #include "utils/glLogger.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
 const char * const ShaderConverter::shaderVersion    = "#version 400\n";
 const char * const ShaderConverter::shaderExtensions = "#extension GL_ARB_shading_language_420pack : enable\n"
                                                        "#extension GL_ARB_separate_shader_objects : enable\n"
+                                                       "#extension GL_ARB_enhanced_layouts : enable\n"
                                                        "#extension GL_OES_EGL_image_external : enable\n"
                                                        "\n";
 
@@ -37,6 +62,22 @@ const char * const ShaderConverter::shaderPrecision  = "#ifdef GL_ES\n"
                                                        "#endif\n"
                                                        "\n";
 
+/// the default precisions of ESSL 100, a fragment shader declares its own float precision
+const char * const ShaderConverter::shaderPrecisionVertex   = "#define GLOVE_GL_ES 1\n"
+                                                              "precision highp float;\n"
+                                                              "precision highp int;\n"
+                                                              "\n";
+
+const char * const ShaderConverter::shaderPrecisionFragment = "#define GLOVE_GL_ES 1\n"
+                                                              "precision highp float;\n"
+                                                              "precision mediump int;\n"
+                                                              "\n";
+
+/// GL_EXT_shader_framebuffer_fetch is not known to GLSL 400, gl_LastFragData is a subpass input of the color attachment
+const char * const ShaderConverter::shaderFramebufferFetch       = "#define GLOVE_EXT_shader_framebuffer_fetch 1\n";
+const char * const ShaderConverter::shaderFramebufferFetchInput  = "layout(input_attachment_index = 0, set = 0, binding = %u) uniform subpassInput glove_FramebufferFetch;\n";
+const char * const ShaderConverter::shaderLastFragData           = "vec4[1](subpassLoad(glove_FramebufferFetch))";
+
 const char * const ShaderConverter::shaderTexture2d  = "/// GL_KHR_vulkan_glsl removed texture2D(), texture2DProj(), textureLod(), textureProjLod()\n"
                                                        "#define texture2D texture\n"
                                                        "#define texture2DLod textureLod\n"
@@ -50,6 +91,15 @@ const char * const ShaderConverter::shaderTextureCube= "/// GL_KHR_vulkan_glsl r
                                                       "#define textureCubeLod textureLod\n"
                                                       "\n";
 
+/// GL_OES_texture_3D is core in GLSL 400, its macro is renamed like the other GL_ ones
+const char * const ShaderConverter::shaderTexture3d  = "/// GL_KHR_vulkan_glsl removed texture3D(), texture3DLod(), texture3DProj(), texture3DProjLod()\n"
+                                                       "#define GLOVE_OES_texture_3D 1\n"
+                                                       "#define texture3D texture\n"
+                                                       "#define texture3DLod textureLod\n"
+                                                       "#define texture3DProj textureProj\n"
+                                                       "#define texture3DProjLod textureProjLod\n"
+                                                       "\n";
+
 const char * const ShaderConverter::shaderDepthRange = "/// GL_KHR_vulkan_glsl removed gl_DepthRange as well\n"
                                                        "struct gl_DepthRangeParameters {\n"
                                                        "    float near;\n"
@@ -58,11 +108,13 @@ const char * const ShaderConverter::shaderDepthRange = "/// GL_KHR_vulkan_glsl r
                                                        "\n"
                                                        "    ///std140 will force this struct to 16 bytes anyway. Pad it for peace of mind\n"
                                                        "    float pad;\n"
-                                                       "};\n"
-                                                       "uniform gl_DepthRangeParameters " STRINGIFY_MACRO(GLOVE_VULKAN_DEPTH_RANGE) ";\n"
-                                                       "\n"
-                                                       "#define gl_DepthRange " STRINGIFY_MACRO(GLOVE_VULKAN_DEPTH_RANGE) "\n"
-                                                       "\n";
+                                                       "};\n";
+
+/// follows the vulkan_DepthRange uniform block, which is declared like any other uniform
+const char * const ShaderConverter::shaderDepthRangeDefine = "\n"
+                                                             "\n"
+                                                             "#define gl_DepthRange " STRINGIFY_MACRO(GLOVE_VULKAN_DEPTH_RANGE) "\n"
+                                                             "\n";
 
 const char * const ShaderConverter::shaderLimitsBuiltIns = "#define gl_MaxVertexAttribs "              STRINGIFY_MACRO(GLOVE_MAX_VERTEX_ATTRIBS) "\n"
                                                            "#define gl_MaxVertexUniformVectors "       STRINGIFY_MACRO(GLOVE_MAX_VERTEX_UNIFORM_VECTORS) "\n"
@@ -79,7 +131,12 @@ ShaderConverter::ShaderConverter()
   mShaderType(SHADER_TYPE_INVALID),
   mMemLayoutQualifier("std140"),
   mSlangProg(nullptr),
-  mIoMapResolver(nullptr)
+  mIoMapResolver(nullptr),
+  mUniformBlockMap(nullptr),
+  mReflection(nullptr),
+  mUnusedBlockBindings(0),
+  mFramebufferFetch(false),
+  mPushConstantPos(string::npos)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 }
@@ -90,422 +147,464 @@ ShaderConverter::~ShaderConverter()
 }
 
 void
-ShaderConverter::Convert(std::string& source, const uniformBlockMap_t &uniformBlockMap, ShaderReflection* reflection, bool isYInverted)
+ShaderConverter::Convert(std::string& source, const uniformBlockMap_t &uniformBlockMap, ShaderReflection* reflection)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    mUniformBlockMap     = &uniformBlockMap;
+    mReflection          = reflection;
+    /// Start of dead uniform blocks where the active end, after the binding of the framebuffer fetch
+    mUnusedBlockBindings = static_cast<uint32_t>(uniformBlockMap.size()) + 1;
+    mFramebufferFetch    = mShaderType == SHADER_TYPE_FRAGMENT && UsesFramebufferFetch(source);
+    mPushConstantPos     = string::npos;
+    mPushConstantMembers.clear();
+    mRenamedUniforms.clear();
+    mAttributeLocations.clear();
+    mVaryingsLocationMap.clear();
+
     switch(mConversionType) {
-        case SHADER_CONVERSION_100_400 : Convert100To400(source, uniformBlockMap, reflection, isYInverted); break;
+        case SHADER_CONVERSION_100_400 : Convert100To400(source); break;
         case SHADER_CONVERSION_INVALID : NOT_REACHED(); break;
         default: break;
     }
 }
 
-void
-ShaderConverter::Convert100To400(std::string& source, const uniformBlockMap_t &uniformBlockMap, ShaderReflection* reflection, bool isYInverted)
+static inline bool
+IsIdentifierStart(char c)
 {
-    FUN_ENTRY(GL_LOG_DEBUG);
-
-    // Replace each tab with 4 spaces. It makes parsing result easy to use.
-    ReplaceAll(source, "\t", "    ");
-    ProcessMacros(source);
-    ProcessHeader(source, uniformBlockMap);
-    ProcessUniforms(source, uniformBlockMap);
-
-    if(mShaderType == SHADER_TYPE_FRAGMENT) {
-        ProcessInvariantQualifier(source);
-    }
-
-    ProcessVaryings(source);
-    ProcessVertexAttributes(source, reflection);
-
-    if(mShaderType == SHADER_TYPE_VERTEX) {
-        if(isYInverted) {
-            ConvertGLToVulkanCoordSystem(source);
-        }
-        ConvertGLToVulkanDepthRange(source);
-    }
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
 }
 
-void
-ShaderConverter::Initialize(shader_type_t shaderType, ESSL_VERSION version_in, ESSL_VERSION version_out)
+static inline bool
+IsNumberChar(char c)
 {
-    FUN_ENTRY(GL_LOG_DEBUG);
-
-    mConversionType = EsslVersionToShaderConversionType(version_in, version_out);
-    mShaderType     = shaderType;
+    return IsIdentifierStart(c) || (c >= '0' && c <= '9') || c == '.';
 }
 
-void
-ShaderConverter::ProcessHeader(std::string& source, const uniformBlockMap_t &uniformBlockMap)
+static std::string
+GetDirective(const std::string &source, std::string::size_type pos)
 {
-    FUN_ENTRY(GL_LOG_DEBUG);
+    FUN_ENTRY(GL_LOG_TRACE);
 
-    /// Do not add vulkan_DepthRange declaration if gl_DepthRange is not active in the input shader
-    const bool depthRangeActive = uniformBlockMap.find(string("gl_DepthRange")) != uniformBlockMap.cend();
-    const string sourceHeader = string(shaderVersion) +
-                                string(shaderExtensions) +
-                                string(shaderPrecision) +
-                                string(shaderTexture2d) +
-                                string(shaderTextureCube) +
-                                (depthRangeActive ? string(shaderDepthRange) : string("")) +
-                                string(shaderLimitsBuiltIns);
-
-    /// If #version is present
-    size_t found = source.find("#version");
-    if(found != string::npos) {
-        size_t f1 = source.find("\n", found);
-        source.replace(found, f1 - found, sourceHeader);
-    } else {
-        source.insert(0, sourceHeader);
+    // skip '#' and any spaces before the directive name
+    ++pos;
+    while(source[pos] == ' ' || source[pos] == '\t') {
+        ++pos;
     }
-}
-
-void
-ShaderConverter::ProcessInvariantQualifier(std::string& source)
-{
-    FUN_ENTRY(GL_LOG_DEBUG);
-
-    size_t found;
-
-    const string invariantStr("invariant");
-    const string invariantVaryingStr("invariant varying");
-    found = FindToken(invariantVaryingStr, source, 0);
-    while(found != string::npos) {
-
-        size_t f1 = found;
-        found = SkipWhiteSpaces(source, found + invariantStr.length());
-
-        // remove 'invariant' when found before varying (in fragment shaders)
-        source.replace(f1, invariantStr.length(), "");
 
-        found = FindToken(invariantVaryingStr, source, found);
-    }
+    return GetNextToken(source, pos);
 }
 
 void
-ShaderConverter::ProcessMacros(std::string& source)
+ShaderConverter::Convert100To400(std::string& source)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    size_t found;
+    mIoMapResolver->CreateVaryingLocationMap(&mVaryingsLocationMap);
+
+    /// The source is scanned once, token by token, and the converted shader is
+    /// appended to a buffer with enough room for the declarations added to it
+    string out;
+    out.reserve(2 * source.size() + 4096);
+
+    bool   headerDone    = false;
+    size_t headerLines   = 0;
+    bool   inDirective   = false;
+    string directive;
+    bool   lineDirective = false;
+    bool   afterDefined  = false;
+
+    const size_t size = source.size();
+    size_t pos = 0;
+    while(pos < size) {
+        const char c = source[pos];
+
+        /// Comments and white spaces are copied as they are
+        if(c == '/' && (source[pos + 1] == '/' || source[pos + 1] == '*')) {
+            size_t end = (source[pos + 1] == '/') ? source.find('\n', pos) : source.find("*/", pos + 2);
+            end = (end == string::npos) ? size : (source[pos + 1] == '*' ? end + 2 : end);
+            out.append(source, pos, end - pos);
+            pos = end;
+            continue;
+        }
 
-    bool linedirectiveEnabled=false;
-    const string linedirective("#line");
-    found = FindToken(linedirective, source, 0);
-    if(found != string::npos) {
-        linedirectiveEnabled = true;
-    }
+        if(c == '\n') {
+            inDirective = inDirective && pos > 0 && source[pos - 1] == '\\';
+            out += c;
+            ++pos;
+            continue;
+        }
 
-    const string lineStr("__LINE__");
-    found = FindToken(lineStr, source, 0);
-    while(found != string::npos) {
+        if(c == ' ' || c == '\t' || c == '\r') {
+            out += c;
+            ++pos;
+            continue;
+        }
 
-        size_t f1 = found;
-        found = SkipWhiteSpaces(source, found + lineStr.length());
+        /// The header replaces #version, which may only be preceded by comments
+        if(!headerDone) {
+            const size_t headerPos = out.size();
+            ProcessHeader(out);
+            headerLines = static_cast<size_t>(std::count(out.begin() + headerPos, out.end(), '\n'));
+            headerDone  = true;
 
-        int firstNL  = static_cast<int>(source.rfind('\n', f1));
-        int secondNL = static_cast<int>(source.rfind('#' , f1));
+            if(c == '#' && GetDirective(source, pos) == "version") {
+                pos = std::min(source.find('\n', pos), size);
+                continue;
+            }
+        }
 
-        // check if is used in a define function & linedirective is not used
-        if(firstNL >= secondNL && !linedirectiveEnabled) {
-            // we have inserted 29 additional lines
-            source.replace(f1, lineStr.length(), "__LINE__ - 29");
+        if(c == '#' && !inDirective) {
+            directive     = GetDirective(source, pos);
+            /// the extensions of the framebuffer fetch and of the 3D textures are implemented by the header
+            if(directive == "extension") {
+                const size_t end = std::min(source.find('\n', pos), size);
+                if(source.find("GL_EXT_shader_framebuffer_fetch", pos) < end || source.find("GL_OES_texture_3D", pos) < end) {
+                    pos = end;
+                    continue;
+                }
+            }
+            inDirective   = true;
+            /// #line renumbers the lines, so __LINE__ is correct from there on
+            lineDirective = lineDirective || directive == "line";
+            out += c;
+            ++pos;
+            continue;
         }
 
-        found = FindToken(lineStr, source, found);
-    }
+        if(c >= '0' && c <= '9') {
+            size_t end = pos;
+            while(IsNumberChar(source[end])) {
+                ++end;
+            }
+            out.append(source, pos, end - pos);
+            pos = end;
+            continue;
+        }
 
-    const string versionStr("__VERSION__");
-    found = FindToken(versionStr, source, 0);
-    while(found != string::npos) {
+        if(!IsIdentifierStart(c)) {
+            out += c;
+            ++pos;
+            continue;
+        }
 
-        size_t f1 = found;
-        found = SkipWhiteSpaces(source, found + versionStr.length());
+        const string token = GetNextToken(source, pos);
+        pos += token.length();
 
-        // the actual value is 100 = 400/4
-        source.replace(f1, versionStr.length(), "__VERSION__ / 4");
+        if(!inDirective) {
+            if(token == "uniform") {
+                pos = ProcessUniform(source, pos, out);
+                continue;
+            }
 
-        found = FindToken(versionStr, source, found);
-    }
+            if(token == "varying") {
+                pos = ProcessVarying(source, pos, out);
+                continue;
+            }
 
-    const  string glStr("GL_ES");
-    found = FindToken(glStr, source, 0);
-    while(found != string::npos) {
+            if(token == "attribute" && mReflection->GetLiveAttributes()) {
+                pos = ProcessVertexAttribute(source, pos, out);
+                continue;
+            }
 
-        size_t f1 = found;
-        found = SkipWhiteSpaces(source, found + glStr.length());
+            // remove 'invariant' when found before varying (in fragment shaders)
+            if(token == "invariant" && mShaderType == SHADER_TYPE_FRAGMENT &&
+               GetNextToken(source, SkipWhiteSpacesAndComments(source, pos)) == "varying") {
+                continue;
+            }
+        }
 
-        // check if is used in a ifdef function
-        int firstNL  = static_cast<int>(source.rfind('\n', f1));
-        int secondNL = static_cast<int>(source.rfind("#ifdef" , f1));
-        if(firstNL >= secondNL) {
-            // replace with '1' value
-            source.replace(f1, glStr.length(), "1");
+        if(token == "__LINE__" && !inDirective && !lineDirective) {
+            // lines added by the header
+            out += "(__LINE__ - " + to_string(headerLines) + ")";
+        } else if(token == "__VERSION__") {
+            // the actual value is 100 = 400/4
+            out += "(__VERSION__ / 4)";
+        } else if(token == "GL_ES" && !(inDirective && (directive == "ifdef" || directive == "ifndef" || afterDefined))) {
+            out += "1";
+        } else if(token == "GL_ES" && IsRelaxedPrecisionEnabled()) {
+            out += "GLOVE_GL_ES";
+        } else if(token == "GL_EXT_shader_framebuffer_fetch" && mShaderType == SHADER_TYPE_FRAGMENT) {
+            out += (inDirective && (directive == "ifdef" || directive == "ifndef" || afterDefined)) ? "GLOVE_EXT_shader_framebuffer_fetch" : "1";
+        } else if(token == "GL_OES_texture_3D") {
+            out += (inDirective && (directive == "ifdef" || directive == "ifndef" || afterDefined)) ? "GLOVE_OES_texture_3D" : "1";
+        } else if(token == "gl_LastFragData" && mFramebufferFetch) {
+            out += shaderLastFragData;
+        } else if(!mRenamedUniforms.empty() && mRenamedUniforms.count(token)) {
+            out += mRenamedUniforms[token];
+        } else {
+            out += token;
         }
+        afterDefined = token == "defined";
+    }
 
-        found = FindToken(glStr, source, found);
+    if(!headerDone) {
+        ProcessHeader(out);
     }
+    ProcessPushConstants(out);
+
+    source.swap(out);
 }
 
-void
-ShaderConverter::ProcessUniforms(std::string& source, const uniformBlockMap_t &uniformBlockMap)
+bool
+ShaderConverter::IsRelaxedPrecisionEnabled(void)
 {
-    FUN_ENTRY(GL_LOG_DEBUG);
-
-    /// Start of dead uniform blocks where the active end
-    uint32_t unusedBlockBindings = static_cast<uint32_t>(uniformBlockMap.size());
-    uniformBlockMap_t::const_iterator uniBlockIt;
-    string layoutSyntax;
-    string blockSyntax;
-
-    /// Convert uniforms into uniform blocks
-    string token;
-    const string uniformLiteralStr("uniform");
-
-    size_t found = FindToken(uniformLiteralStr, source, 0);
-    while(found != string::npos) {
-        size_t firstNL = source.rfind("\n", found);
-        string commentLine = source.substr(firstNL, found - firstNL);
-        if(commentLine.find("//") != string::npos) {
-            found = FindToken(uniformLiteralStr, source, found + uniformLiteralStr.length());
-            continue;
-        }
-
-        size_t f1 = found;
-        found = SkipWhiteSpaces(source, found + uniformLiteralStr.length());
-
-        /// Either type or precision qualifier
-        token = GetNextToken(source, found);
-        string tokenTypeStr = token;
-        string tokenPrecisionStr = "";
-
-        if(IsPrecisionQualifier(token)) {
-            found = SkipWhiteSpaces(source, found + token.length());
-            token = GetNextToken(source, found);
-            tokenPrecisionStr = token;
-        }
+    FUN_ENTRY(GL_LOG_TRACE);
 
-        /// Definitely type now
-        if(!CanTypeBeInUniformBlock(token)) {
-            /// Sampler type
-            found = SkipWhiteSpaces(source, found + token.length());
-            /// Variable name
-            token = GetNextToken(source, found);
-
-            uniBlockIt = uniformBlockMap.find(token);
-            if(uniBlockIt != uniformBlockMap.cend()) {
-                layoutSyntax = "layout(binding = " + to_string(uniBlockIt->second.binding) + string(") ");
-            } else {
-                layoutSyntax = "layout(binding = " + to_string(unusedBlockBindings) + string(") ");
-                ++unusedBlockBindings;
-            }
-            source.insert(f1, layoutSyntax);
+    static const bool enabled = [] {
+        const char *env = getenv("GLOVE_RELAXED_PRECISION");
+        return env == nullptr || (strcmp(env, "false") && strcmp(env, "0"));
+    }();
 
-            found = FindToken(uniformLiteralStr, source, found + token.length() + layoutSyntax.length());
+    return enabled;
+}
 
-            continue;
-        }
+bool
+ShaderConverter::UsesFramebufferFetch(const std::string& source)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
 
-        found = SkipWhiteSpaces(source, found + token.length());
+    return source.find("gl_LastFragData") != string::npos;
+}
 
-        /// Variable name
-        token = GetNextToken(source, found);
+void
+ShaderConverter::Initialize(shader_type_t shaderType, ESSL_VERSION version_in, ESSL_VERSION version_out)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
 
-        /// Check for multiple inline variable declaration
-        bool   multiple_declaration = false;
-        size_t f2  = source.find (",", found + token.length());
-        size_t fNL = source.find (';', found + token.length());
-        blockSyntax = string(";\n") + uniformLiteralStr + " " + tokenTypeStr + " " + tokenPrecisionStr;
-        while(f2 <= fNL) {
-            /// Move every variable on a new line
-            source.replace(found + token.length(), 1, blockSyntax);
-            found = SkipWhiteSpaces(source, found + token.length() + blockSyntax.length() + 1);
-            token = GetNextToken(source, found);
-            f2    = source.find (",", found + token.length());
-
-            multiple_declaration = true;
-        }
+    mConversionType = EsslVersionToShaderConversionType(version_in, version_out);
+    mShaderType     = shaderType;
+}
 
-        /// if yes, then goto back to the beginning
-        if(multiple_declaration) {
-            found = f1;
-            continue;
-        }
+void
+ShaderConverter::ProcessHeader(std::string& out)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
 
-        // Rename uni* variable cases
-        const string uniStr("uni");
-        const size_t uni_count = (mShaderType == SHADER_TYPE_VERTEX) ? GLOVE_MAX_VERTEX_UNIFORM_VECTORS : GLOVE_MAX_FRAGMENT_UNIFORM_VECTORS;
-        for (size_t i = 0; i < uni_count; i++) {
-            const string uniformStr(uniStr + to_string(i));
-            if(!token.compare(uniformStr)) {
-                size_t f1 = FindToken(uniformStr, source, found);
-                while(f1 != string::npos) {
+    out.append(shaderVersion);
+    out.append(shaderExtensions);
+    if(IsRelaxedPrecisionEnabled()) {
+        out.append(mShaderType == SHADER_TYPE_VERTEX ? shaderPrecisionVertex : shaderPrecisionFragment);
+    } else {
+        out.append(shaderPrecision);
+    }
+    if(mShaderType == SHADER_TYPE_FRAGMENT) {
+        out.append(shaderFramebufferFetch);
+    }
+    if(mFramebufferFetch) {
+        char input[160];
+        snprintf(input, sizeof(input), shaderFramebufferFetchInput, static_cast<uint32_t>(mUniformBlockMap->size()));
+        out.append(input);
+    }
+    out.append(shaderTexture2d);
+    out.append(shaderTextureCube);
+    out.append(shaderTexture3d);
 
-                    size_t f2 = f1;
-                    f1 = SkipWhiteSpaces(source, f1 + uniformStr.length());
+    /// Do not add vulkan_DepthRange declaration if gl_DepthRange is not active in the input shader
+    if(mUniformBlockMap->find(string("gl_DepthRange")) != mUniformBlockMap->cend()) {
+        out.append(shaderDepthRange);
+        EmitUniformDeclaration(string("gl_DepthRangeParameters"), string(STRINGIFY_MACRO(GLOVE_VULKAN_DEPTH_RANGE)), string(""), out);
+        out.append(shaderDepthRangeDefine);
+    }
 
-                    source.replace(f2, uniformStr.length(), uniformStr + "_");
+    out.append(shaderLimitsBuiltIns);
+}
 
-                    f1 = FindToken(uniformStr, source, f1);
-                }
-                break;
-            }
-        }
+size_t
+ShaderConverter::ProcessUniform(const std::string& source, size_t pos, std::string& out)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
 
-        if(!token.compare(STRINGIFY_MACRO(GLOVE_VULKAN_DEPTH_RANGE))) {
-            token = std::string("gl_DepthRange");
-        }
+    /// Either type or precision qualifier
+    size_t found = SkipWhiteSpacesAndComments(source, pos);
+    string type  = GetNextToken(source, found);
+    string precision;
+    if(IsPrecisionQualifier(type)) {
+        precision = type + " ";
+        found = SkipWhiteSpacesAndComments(source, found + type.length());
+        type  = GetNextToken(source, found);
+    }
 
-        /// Construct uniform block
-        uniBlockIt = uniformBlockMap.find(token);
-        if(uniBlockIt != uniformBlockMap.cend()) {
-            const uniformBlock_t &block = uniBlockIt->second;
-            layoutSyntax = "layout(" + mMemLayoutQualifier + ", binding = " + to_string(block.binding) + string(") ");
-            source.insert(f1, layoutSyntax);
-            f1 += layoutSyntax.length();
+    /// A struct defined in the declaration cannot be moved into a block
+    const size_t end = source.find(';', found);
+    if(type.empty() || !type.compare("struct") || end == string::npos) {
+        out += "uniform";
+        return pos;
+    }
 
-            blockSyntax = block.glslName + string(" {");
-            source.insert(f1 + strlen("uniform\0") + 1, blockSyntax);
+    const bool isOpaque = !CanTypeBeInUniformBlock(type);
+    found += type.length();
+    type   = precision + type;
+
+    /// Each variable of a multiple declaration gets its own binding
+    const char *separator = "";
+    while(found < end) {
+        found = SkipWhiteSpacesAndComments(source, found);
+
+        /// Variable name, followed by its array size if any
+        const string name  = GetNextToken(source, found);
+        found += name.length();
+        const size_t next  = std::min(source.find(',', found), end);
+        const string arraySuffix(source, found, next - found);
+        found = next + 1;
+
+        out += separator;
+        separator = " ";
+
+        if(isOpaque) {
+            uniformBlockMap_t::const_iterator uniBlockIt = mUniformBlockMap->find(name);
+            const uint32_t binding = (uniBlockIt != mUniformBlockMap->cend()) ? uniBlockIt->second.binding : mUnusedBlockBindings++;
+            out += "layout(binding = " + to_string(binding) + ") uniform " + type + " " + name + arraySuffix + ";";
         } else {
-            /// inactive uniform
-            layoutSyntax = "layout(" + mMemLayoutQualifier + ", binding = " + to_string(unusedBlockBindings) + string(") ");
-            source.insert(f1, layoutSyntax);
-            f1 += layoutSyntax.length();
-
-            blockSyntax = string("uni") + to_string(unusedBlockBindings) + string(" {");
-            source.insert(f1 + strlen("uniform\0") + 1, blockSyntax);
-            ++unusedBlockBindings;
+            EmitUniformDeclaration(type, name, arraySuffix, out);
         }
-
-        /// Close brackets and add block name
-        found = source.find(";", found);
-        blockSyntax = string("};");
-        source.insert(found + 1, blockSyntax);
-
-        found = FindToken(uniformLiteralStr, source, found);
     }
+
+    return end + 1;
 }
 
 void
-ShaderConverter::ProcessVaryings(std::string& source)
+ShaderConverter::EmitUniformDeclaration(const std::string& type, const std::string& name, const std::string& arraySuffix, std::string& out)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    const string varyingLiteralStr("varying");
+    // Rename uni* variables, as inactive uniforms are moved into uni* blocks
+    string glslName(name);
+    const string uniStr("uni");
+    const size_t uni_count = (mShaderType == SHADER_TYPE_VERTEX) ? GLOVE_MAX_VERTEX_UNIFORM_VECTORS : GLOVE_MAX_FRAGMENT_UNIFORM_VECTORS;
+    if(!name.compare(0, uniStr.length(), uniStr) && name.length() > uniStr.length() && name.length() <= uniStr.length() + 9 &&
+       name.find_first_not_of("0123456789", uniStr.length()) == string::npos) {
+        const size_t index = static_cast<size_t>(stoul(name.substr(uniStr.length())));
+        if(index < uni_count && !name.compare(uniStr + to_string(index))) {
+            glslName += "_";
+            mRenamedUniforms[name] = glslName;
+        }
+    }
 
-    std::map<std::string, std::pair<int,bool>> varyingsLocationMap;
-    mIoMapResolver->CreateVaryingLocationMap(&varyingsLocationMap);
+    const string member = type + " " + glslName + arraySuffix + ";";
+    const string key    = name.compare(STRINGIFY_MACRO(GLOVE_VULKAN_DEPTH_RANGE)) ? name : string("gl_DepthRange");
 
-    size_t found = FindToken(varyingLiteralStr, source, 0);
-    while(found != string::npos) {
-        size_t f1 = found;
-        found = SkipWhiteSpaces(source, found + varyingLiteralStr.length());
+    uniformBlockMap_t::const_iterator uniBlockIt = mUniformBlockMap->find(key);
 
-        /// Either type or precision qualifier
-        string token = GetNextToken(source, found);
-        if(IsPrecisionQualifier(token)) {
-            found = SkipWhiteSpaces(source, found + token.length());
-            token = GetNextToken(source, found);
+    /// Move the declaration into the push constant block
+    if(uniBlockIt != mUniformBlockMap->cend() && uniBlockIt->second.isPushConstant) {
+        const uint32_t offset = uniBlockIt->second.pushConstantOffset;
+        mPushConstantMembers[offset] = "layout(offset = " + to_string(offset) + ") " + member;
+        if(mPushConstantPos == string::npos) {
+            mPushConstantPos = out.size();
         }
-        /// Definitely type now
-        found = SkipWhiteSpaces(source, found + token.length());
 
-        /// Variable name
-        token = GetNextToken(source, found);
-
-        if(varyingsLocationMap.find(token) != varyingsLocationMap.end()) {
-            string layoutSyntax = string("layout(location = ") +
-                                  to_string(varyingsLocationMap[token].first) +
-                                  (mShaderType == SHADER_TYPE_VERTEX ? string(") out") : string(") in"));
-
-            //  Check for varying type mismatch
-            //  replace line with dummy word in order to make compilation fail.
-            //  TODO: This is a process that should be executed in the linking step! Not here.
-            if(mShaderType == SHADER_TYPE_FRAGMENT && !varyingsLocationMap[token].second) {
-                source.replace(f1, varyingLiteralStr.length(), "xxx");
-            } else {
-                source.replace(f1, varyingLiteralStr.length(), layoutSyntax);
-            }
-        } else {
-            source.replace(f1, varyingLiteralStr.length(), "");
+        /// The shader reads a specialized uniform through a constant that has the
+        /// same value, its member is only kept so that the layout does not change
+        if(uniBlockIt->second.isSpecialization) {
+            const string scalar    = type.substr(type.find_last_of(' ') + 1);
+            const string specName  = "glove_spec_" + name;
+            const string specValue = !scalar.compare("bool") ? "false" : (!scalar.compare("int") ? "0" : "0.0");
+            out += "layout(constant_id = " + to_string(GLOVE_SPEC_CONSTANT_UNIFORM_BASE_ID + offset / 4) + ") const " +
+                   type + " " + specName + " = " + specValue + ";";
+            mRenamedUniforms[name] = specName;
         }
+        return;
+    }
 
-        found = FindToken(varyingLiteralStr, source, found);
+    /// Construct uniform block, or an uni* one for an inactive uniform
+    uint32_t binding;
+    string   blockName;
+    if(uniBlockIt != mUniformBlockMap->cend()) {
+        binding   = uniBlockIt->second.binding;
+        blockName = uniBlockIt->second.glslName;
+    } else {
+        binding   = mUnusedBlockBindings++;
+        blockName = uniStr + to_string(binding);
     }
+
+    out += "layout(" + mMemLayoutQualifier + ", binding = " + to_string(binding) + ") uniform " + blockName + " {" + member + "};";
 }
 
 void
-ShaderConverter::ProcessVertexAttributes(std::string& source, ShaderReflection* reflection)
+ShaderConverter::ProcessPushConstants(std::string& out)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    std::vector<int> loc;
-
-    if(!reflection->GetLiveAttributes()) {
+    if(mPushConstantPos == string::npos) {
         return;
     }
 
-    /// Handle vertex attributes
-    const string attributeLiteralStr("attribute");
+    /// Members are declared in offset order, which is the same in all stages.
+    /// The block is kept on one line so that the line numbers do not change.
+    string block("layout(std140, push_constant) uniform glove_PushConstants {");
+    for(const auto &member : mPushConstantMembers) {
+        block += " " + member.second;
+    }
+    block += " };";
 
-    size_t found = FindToken(attributeLiteralStr, source, 0);
-    while(found != string::npos) {
-        size_t f1 = found;
-        found = SkipWhiteSpaces(source, found + attributeLiteralStr.length());
+    out.insert(mPushConstantPos, block);
+}
 
-        /// Either type or precision qualifier
-        string token = GetNextToken(source, found);
-        if(IsPrecisionQualifier(token)) {
-            found = SkipWhiteSpaces(source, found + token.length());
-            token = GetNextToken(source, found);
-        }
+size_t
+ShaderConverter::ProcessVarying(const std::string& source, size_t pos, std::string& out)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
 
-        /// Definitely type now
-        found = SkipWhiteSpaces(source, found + token.length());
-        /// Variable name
+    /// Either type or precision qualifier
+    size_t found = SkipWhiteSpacesAndComments(source, pos);
+    string token = GetNextToken(source, found);
+    if(IsPrecisionQualifier(token)) {
+        found = SkipWhiteSpacesAndComments(source, found + token.length());
         token = GetNextToken(source, found);
-
-        int location = reflection->GetAttributeLocation(token.c_str());
-
-        std::vector<int>::iterator it = std::find (loc.begin(), loc.end(), location);
-        if(location >=0 && it == loc.end()) {
-            string layoutSyntax = string("layout(location = ") + to_string(location) + string(") in");
-            source.replace(f1, attributeLiteralStr.length(), layoutSyntax);
-            for (int j = 0; j < (int)OccupiedLocationsPerGlType(reflection->GetAttributeType(token.c_str())); j++) {
-                loc.push_back(location + j);
-            }
+    }
+    /// Definitely type now
+    found = SkipWhiteSpacesAndComments(source, found + token.length());
+
+    /// Variable name
+    token = GetNextToken(source, found);
+
+    /// Only the qualifier is replaced, the rest of the declaration is copied as it is
+    std::map<std::string, std::pair<int,bool>>::const_iterator it = mVaryingsLocationMap.find(token);
+    if(it != mVaryingsLocationMap.cend()) {
+        //  Check for varying type mismatch
+        //  replace line with dummy word in order to make compilation fail.
+        //  TODO: This is a process that should be executed in the linking step! Not here.
+        if(mShaderType == SHADER_TYPE_FRAGMENT && !it->second.second) {
+            out += "xxx";
         } else {
-            source.erase(f1, attributeLiteralStr.length() + 1);
-            found = f1;
+            out += "layout(location = " + to_string(it->second.first) +
+                   (mShaderType == SHADER_TYPE_VERTEX ? string(") out") : string(") in"));
         }
-        found = FindToken(attributeLiteralStr, source, found);
     }
 
+    return pos;
 }
 
-void
-ShaderConverter::ConvertGLToVulkanCoordSystem(string& source)
+size_t
+ShaderConverter::ProcessVertexAttribute(const std::string& source, size_t pos, std::string& out)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    // Find last "}"
-    size_t pos = source.rfind("}");
-    //If the "VK_KHR_maintenance1" is not supported, so we have to invert the y coordinates here
-    string GlToVkViewportConversion   = string("    gl_Position.y = -gl_Position.y;\n");
-    source.insert(pos, GlToVkViewportConversion);
-}
+    /// Either type or precision qualifier
+    size_t found = SkipWhiteSpacesAndComments(source, pos);
+    string token = GetNextToken(source, found);
+    if(IsPrecisionQualifier(token)) {
+        found = SkipWhiteSpacesAndComments(source, found + token.length());
+        token = GetNextToken(source, found);
+    }
 
-void
-ShaderConverter::ConvertGLToVulkanDepthRange(string& source)
-{
-    FUN_ENTRY(GL_LOG_DEBUG);
+    /// Definitely type now
+    found = SkipWhiteSpacesAndComments(source, found + token.length());
+    /// Variable name
+    token = GetNextToken(source, found);
+
+    int location = mReflection->GetAttributeLocation(token.c_str());
 
-    // Find last "}"
-    size_t pos = source.rfind("}");
+    std::vector<int>::iterator it = std::find(mAttributeLocations.begin(), mAttributeLocations.end(), location);
+    if(location >= 0 && it == mAttributeLocations.end()) {
+        out += "layout(location = " + to_string(location) + ") in";
+        for (int j = 0; j < (int)OccupiedLocationsPerGlType(mReflection->GetAttributeType(token.c_str())); j++) {
+            mAttributeLocations.push_back(location + j);
+        }
+    }
 
-    string GlToVkDepthRangeConversion = string("    gl_Position.z = (gl_Position.z + gl_Position.w) / 2.0;\n");
-    source.insert(pos, GlToVkDepthRangeConversion);
+    return pos;
 }
 
 ShaderConverter::shader_conversion_type_t 
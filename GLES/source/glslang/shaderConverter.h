@@ -29,6 +29,7 @@
 #include "glslangIoMapResolver.h"
 #include "utils/parser_helpers.h"
 #include "glslangUtils.h"
+#include <map>
 
 class ShaderConverter {
 public:
@@ -36,7 +37,12 @@ public:
     ~ShaderConverter();
 
            void Initialize(shader_type_t shaderType, ESSL_VERSION version_in, ESSL_VERSION version_out);
-           void Convert(string& source, const uniformBlockMap_t &uniformBlockMap, ShaderReflection* reflection, bool isYInverted);
+           void Convert(string& source, const uniformBlockMap_t &uniformBlockMap, ShaderReflection* reflection);
+
+/// Whether the ESSL 100 precision qualifiers are kept, read once from GLOVE_RELAXED_PRECISION
+    static bool IsRelaxedPrecisionEnabled(void);
+/// Whether an ESSL 100 fragment shader reads gl_LastFragData of EXT_shader_framebuffer_fetch
+    static bool UsesFramebufferFetch(const string& source);
 
 /// Set Functions
     inline void SetProgram(glslang::TProgram* slangProgram)                { FUN_ENTRY(GL_LOG_TRACE); mSlangProg     = slangProgram;  }
@@ -51,9 +57,16 @@ private:
     static const char * const   shaderVersion;
     static const char * const   shaderExtensions;
     static const char * const   shaderPrecision;
+    static const char * const   shaderPrecisionVertex;
+    static const char * const   shaderPrecisionFragment;
+    static const char * const   shaderFramebufferFetch;
+    static const char * const   shaderFramebufferFetchInput;
+    static const char * const   shaderLastFragData;
     static const char * const   shaderTexture2d;
     static const char * const   shaderTextureCube;
+    static const char * const   shaderTexture3d;
     static const char * const   shaderDepthRange;
+    static const char * const   shaderDepthRangeDefine;
     static const char * const   shaderLimitsBuiltIns;
 
     shader_conversion_type_t    mConversionType;
@@ -62,18 +75,28 @@ private:
     glslang::TProgram*          mSlangProg;
     GlslangIoMapResolver       *mIoMapResolver;
 
+/// Conversion state, reset for every source
+    const uniformBlockMap_t    *mUniformBlockMap;
+    ShaderReflection           *mReflection;
+    uint32_t                    mUnusedBlockBindings;
+    bool                        mFramebufferFetch;
+    size_t                      mPushConstantPos;
+    map<uint32_t, string>       mPushConstantMembers;
+    map<string, string>         mRenamedUniforms;
+    vector<int>                 mAttributeLocations;
+    map<string, pair<int,bool>> mVaryingsLocationMap;
+
 /// Process Functions
-    void ProcessMacros(std::string& source);
-    void ProcessHeader(string& source, const uniformBlockMap_t &uniformBlockMap);
-    void ProcessUniforms(string& source, const uniformBlockMap_t &uniformBlockMap);
-    void ProcessInvariantQualifier(std::string& source);
-    void ProcessVaryings(string& source);
-    void ProcessVertexAttributes(string& source, ShaderReflection* reflection);
+    void ProcessHeader(string& out);
+    size_t ProcessUniform(const string& source, size_t pos, string& out);
+    size_t ProcessVarying(const string& source, size_t pos, string& out);
+    size_t ProcessVertexAttribute(const string& source, size_t pos, string& out);
+    void ProcessPushConstants(string& out);
+
+    void EmitUniformDeclaration(const string& type, const string& name, const string& arraySuffix, string& out);
 
 /// Convert Functions
-    void Convert100To400(string& source, const uniformBlockMap_t &uniformBlockMap, ShaderReflection* reflection, bool isYInverted);
-    void ConvertGLToVulkanCoordSystem(string& source);
-    void ConvertGLToVulkanDepthRange(string& source);
+    void Convert100To400(string& source);
 
     shader_conversion_type_t EsslVersionToShaderConversionType(ESSL_VERSION version_in, ESSL_VERSION version_out);
 };
@@ -28,14 +28,43 @@
  */
 
 #include "bufferObject.h"
+#include "utils/indexUtils.h"
+#include "context/context.h"
+#include <vector>
+#include <atomic>
+#include <utility>
 
-BufferObject::BufferObject(const vulkanAPI::vkContext_t *vkContext, const VkBufferUsageFlags vkBufferUsageFlags, const VkSharingMode vkSharingMode, const VkFlags vkFlags)
-: mVkContext(vkContext), mUsage(GL_STATIC_DRAW), mTarget(GL_INVALID_VALUE), mAllocated(false)
+static std::atomic<uint64_t> sDataVersionCounter(0);
+
+static vulkanAPI::MemoryAllocator::category_t
+GetMemoryCategory(VkBufferUsageFlags usage)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
+    // buffers only ever copied from or into are staging storage
+    if(usage && !(usage & ~(VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT))) {
+        return vulkanAPI::MemoryAllocator::CATEGORY_STAGING;
+    }
+
+    return (usage & VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)  ? vulkanAPI::MemoryAllocator::CATEGORY_VERTEX_BUFFER  :
+           (usage & VK_BUFFER_USAGE_INDEX_BUFFER_BIT)   ? vulkanAPI::MemoryAllocator::CATEGORY_INDEX_BUFFER   :
+           (usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT) ? vulkanAPI::MemoryAllocator::CATEGORY_UNIFORM_BUFFER :
+                                                          vulkanAPI::MemoryAllocator::CATEGORY_BUFFER;
+}
+
+BufferObject::BufferObject(const vulkanAPI::vkContext_t *vkContext, const VkBufferUsageFlags vkBufferUsageFlags, const VkSharingMode vkSharingMode, const VkFlags vkFlags, const VkFlags vkPreferredFlags)
+: mVkContext(vkContext), mUsage(GL_STATIC_DRAW), mTarget(GL_INVALID_VALUE), mAllocated(false),
+  mWidenedIndices(nullptr), mWidenedIndicesValid(false),
+  mMappedPointer(nullptr), mMappedOffset(0), mMappedLength(0), mMappedAccess(0),
+  mDeviceLocal(false), mPromotionVersion(0), mUnchangedFrames(0), mReadbackSubmissionId(0)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    mDataVersion = ++sDataVersionCounter;
+
     mBuffer = new vulkanAPI::Buffer(vkContext, vkBufferUsageFlags, vkSharingMode);
-    mMemory = new vulkanAPI::Memory(vkContext, vkFlags);
+    mMemory = new vulkanAPI::Memory(vkContext, vkFlags, vkPreferredFlags);
+    mMemory->SetCategory(GetMemoryCategory(vkBufferUsageFlags));
 }
 
 BufferObject::~BufferObject()
@@ -44,6 +73,7 @@ BufferObject::~BufferObject()
 
     delete mBuffer;
     delete mMemory;
+    delete mWidenedIndices;
 }
 
 void
@@ -54,6 +84,23 @@ BufferObject::Release()
     mBuffer->Release();
     mMemory->Release();
     mAllocated = false;
+    mMappedPointer = nullptr;
+    mMappedOffset  = 0;
+    mMappedLength  = 0;
+    mMappedAccess  = 0;
+    mDeviceLocal   = false;
+    mShadowData.clear();
+    InvalidateContents();
+}
+
+void
+BufferObject::InvalidateContents(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    mMaxIndices.clear();
+    mWidenedIndicesValid = false;
+    mDataVersion = ++sDataVersionCounter;
 }
 
 bool
@@ -62,6 +109,10 @@ BufferObject::Allocate(size_t size, const void *data)
     FUN_ENTRY(GL_LOG_DEBUG);
 
     mBuffer->SetSize(size);
+    InvalidateContents();
+
+    // the target may have changed the usage since construction
+    mMemory->SetCategory(GetMemoryCategory(mBuffer->GetFlags()));
 
     mAllocated = mBuffer->Create()                                            &&
                  mMemory->GetBufferMemoryRequirements(mBuffer->GetVkBuffer()) &&
@@ -71,11 +122,114 @@ BufferObject::Allocate(size_t size, const void *data)
     return mAllocated;
 }
 
+bool
+BufferObject::AllocateDeviceLocal(size_t size, const void *data)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    mBuffer->SetSize(size);
+    InvalidateContents();
+
+    // the placement only applies to this storage, the flags are restored for later allocations
+    VkBufferUsageFlags usage       = mBuffer->GetFlags();
+    VkFlags            memoryFlags = mMemory->GetFlags();
+    mMemory->SetCategory(GetMemoryCategory(usage));
+    mBuffer->SetFlags(usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    mMemory->SetFlags(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    mAllocated = mBuffer->Create()                                            &&
+                 mMemory->GetBufferMemoryRequirements(mBuffer->GetVkBuffer()) &&
+                 mMemory->Create()                                            &&
+                 mMemory->BindBufferMemory(mBuffer->GetVkBuffer());
+
+    mBuffer->SetFlags(usage);
+    mMemory->SetFlags(memoryFlags);
+
+    if(!mAllocated) {
+        return false;
+    }
+
+    mDeviceLocal = true;
+    if(data) {
+        mShadowData.assign(static_cast<const uint8_t *>(data), static_cast<const uint8_t *>(data) + size);
+    } else {
+        mShadowData.assign(size, 0);
+    }
+
+    return UploadStaged(0, size, mShadowData.data(), true);
+}
+
+bool
+BufferObject::UploadStaged(size_t offset, size_t size, const void *data, bool freshStorage)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    assert(GetCurrentContext());
+    vulkanAPI::CommandBufferManager *commandBufferManager = GetCurrentContext()->GetVkCommandBufferManager();
+    const VkAccessFlags readAccess = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+
+    // small updates travel inside the command buffer, which orders them after the draws recorded
+    // so far and ahead of the next ones, with neither a staging buffer nor a map
+    if(!freshStorage && size <= GLOVE_MAX_INLINE_BUFFER_UPDATE_SIZE && !(offset & 3) && !(size & 3)) {
+        commandBufferManager->BeginVkAuxCommandBuffer();
+        VkCommandBuffer activeCmdBuffer = commandBufferManager->GetAuxCommandBuffer();
+
+        mBuffer->PipelineBarrier(&activeCmdBuffer, readAccess, VK_ACCESS_TRANSFER_WRITE_BIT,
+                                 VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+        mBuffer->UpdateBuffer(&activeCmdBuffer, offset, size, data);
+        mBuffer->PipelineBarrier(&activeCmdBuffer, VK_ACCESS_TRANSFER_WRITE_BIT, readAccess,
+                                 VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT);
+        return true;
+    }
+
+    CacheManager *cacheManager = GetCurrentContext()->GetCacheManager();
+    BufferObject *tbo = cacheManager->GetStagingBuffer(size, true);
+    if(!tbo) {
+        return false;
+    }
+    tbo->UpdateData(size, 0, data);
+
+    // fresh storage is written by the dedicated transfer queue when available, and then
+    // handed over to the graphics queue; it has no earlier owner to release it
+    if(freshStorage && commandBufferManager->BeginVkTransferCommandBuffer()) {
+        VkCommandBuffer transferCmdBuffer = commandBufferManager->GetTransferCommandBuffer();
+        VkCommandBuffer acquireCmdBuffer  = commandBufferManager->GetTransferAcquireCommandBuffer();
+        uint32_t        graphicsFamily    = mVkContext->vkGraphicsQueueNodeIndex;
+        uint32_t        transferFamily    = mVkContext->vkTransferQueueNodeIndex;
+
+        mBuffer->CopyFromBuffer(&transferCmdBuffer, tbo->GetVkBuffer(), offset, size);
+        mBuffer->PipelineBarrier(&transferCmdBuffer, VK_ACCESS_TRANSFER_WRITE_BIT, 0,
+                                 VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, transferFamily, graphicsFamily);
+        mBuffer->PipelineBarrier(&acquireCmdBuffer, 0, readAccess,
+                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, transferFamily, graphicsFamily);
+    } else {
+        commandBufferManager->BeginVkAuxCommandBuffer();
+        VkCommandBuffer activeCmdBuffer = commandBufferManager->GetAuxCommandBuffer();
+
+        // draws of earlier frames may still be reading the range that is overwritten
+        mBuffer->PipelineBarrier(&activeCmdBuffer, readAccess, VK_ACCESS_TRANSFER_WRITE_BIT,
+                                 VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+        mBuffer->CopyFromBuffer(&activeCmdBuffer, tbo->GetVkBuffer(), offset, size);
+        mBuffer->PipelineBarrier(&activeCmdBuffer, VK_ACCESS_TRANSFER_WRITE_BIT, readAccess,
+                                 VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT);
+    }
+
+    // the staging buffer returns to its pool once the batched upload has been executed
+    cacheManager->CacheStagingBuffer(tbo);
+
+    return true;
+}
+
 bool
 BufferObject::GetData(size_t size, size_t offset, void *data) const
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    if(mDeviceLocal) {
+        memcpy(data, mShadowData.data() + offset, size);
+        return true;
+    }
+
     return mMemory->GetData(size, offset, data);
 }
 
@@ -84,7 +238,165 @@ BufferObject::UpdateData(size_t size, size_t offset, const void *data)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    mMemory->UpdateData(size, offset, data);
+    if(mDeviceLocal) {
+        if(data) {
+            memcpy(mShadowData.data() + offset, data, size);
+        } else {
+            memset(mShadowData.data() + offset, 0x0, size);
+        }
+        UploadStaged(offset, size, mShadowData.data() + offset, false);
+    } else {
+        mMemory->UpdateData(size, offset, data);
+    }
+    InvalidateContents();
+}
+
+bool
+BufferObject::IsPromotionCandidate(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(mDeviceLocal || !mAllocated || IsMapped()) {
+        return false;
+    }
+
+    if(mPromotionVersion != mDataVersion) {
+        mPromotionVersion = mDataVersion;
+        mUnchangedFrames  = 0;
+        return false;
+    }
+
+    return ++mUnchangedFrames >= GLOVE_BUFFER_PROMOTION_FRAMES;
+}
+
+void
+BufferObject::SwapStorage(BufferObject *other)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the Vulkan buffer and its memory change hands, the GL object keeps its state
+    std::swap(mBuffer,    other->mBuffer);
+    std::swap(mMemory,    other->mMemory);
+    std::swap(mAllocated, other->mAllocated);
+    std::swap(mDeviceLocal, other->mDeviceLocal);
+    mShadowData.swap(other->mShadowData);
+    std::swap(mReadbackSubmissionId, other->mReadbackSubmissionId);
+    InvalidateContents();
+    other->InvalidateContents();
+}
+
+void
+BufferObject::PipelineBarrier(VkCommandBuffer *activeCmdBuffer,
+                              VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask,
+                              VkPipelineStageFlags srcStages, VkPipelineStageFlags dstStages)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    mBuffer->PipelineBarrier(activeCmdBuffer, srcAccessMask, dstAccessMask, srcStages, dstStages);
+}
+
+void*
+BufferObject::Map(size_t offset, size_t length, GLbitfield access)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // only memory that stays mapped can be handed out to the application
+    if(!mAllocated || mDeviceLocal || !mMemory->IsPersistentlyMapped()) {
+        return nullptr;
+    }
+
+    mMappedPointer = static_cast<uint8_t *>(mMemory->Map()) + offset;
+    mMappedOffset  = offset;
+    mMappedLength  = length;
+    mMappedAccess  = access;
+
+    return mMappedPointer;
+}
+
+void
+BufferObject::FlushMappedRange(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the memory is host coherent, a flushed range is visible to the device as soon as it is written
+    InvalidateContents();
+}
+
+void
+BufferObject::Unmap(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if((mMappedAccess & GL_MAP_WRITE_BIT_EXT) && !(mMappedAccess & GL_MAP_FLUSH_EXPLICIT_BIT_EXT)) {
+        InvalidateContents();
+    }
+
+    mMappedPointer = nullptr;
+    mMappedOffset  = 0;
+    mMappedLength  = 0;
+    mMappedAccess  = 0;
+}
+
+BufferObject*
+BufferObject::GetWidenedIndices(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the contents are converted once per glBuffer(Sub)Data rather than on every draw
+    if(mWidenedIndicesValid) {
+        return mWidenedIndices;
+    }
+
+    size_t size = GetSize();
+    std::vector<uint8_t>  srcData(size);
+    std::vector<uint16_t> dstData(size);
+    if(size && !GetData(size, 0, srcData.data())) {
+        return nullptr;
+    }
+    IndexBufferWidenU8ToU16(srcData.data(), dstData.data(), size);
+
+    if(!mWidenedIndices) {
+        mWidenedIndices = new IndexBufferObject(mVkContext);
+    }
+
+    size_t dstSize = size * sizeof(uint16_t);
+    if(mWidenedIndices->HasData() && mWidenedIndices->GetSize() == dstSize) {
+        mWidenedIndices->UpdateData(dstSize, 0, dstData.data());
+    } else {
+        mWidenedIndices->Release();
+        if(!mWidenedIndices->Allocate(dstSize, dstData.data())) {
+            return nullptr;
+        }
+    }
+
+    mWidenedIndicesValid = true;
+    return mWidenedIndices;
+}
+
+bool
+BufferObject::GetCachedMaxIndex(size_t offset, uint32_t indexCount, size_t elementByteSize, uint32_t *maxIndex) const
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    auto it = mMaxIndices.find(std::make_tuple(offset, indexCount, elementByteSize));
+    if(it == mMaxIndices.end()) {
+        return false;
+    }
+
+    *maxIndex = it->second;
+    return true;
+}
+
+void
+BufferObject::SetCachedMaxIndex(size_t offset, uint32_t indexCount, size_t elementByteSize, uint32_t maxIndex)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(mMaxIndices.size() >= GLOVE_MAX_CACHED_INDEX_RANGES) {
+        mMaxIndices.clear();
+    }
+
+    mMaxIndices[std::make_tuple(offset, indexCount, elementByteSize)] = maxIndex;
 }
 
 void
@@ -92,28 +404,48 @@ BufferObject::SetTarget(GLenum target)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    VkBufferUsageFlags targetUsage = target == GL_ARRAY_BUFFER         ? VK_BUFFER_USAGE_VERTEX_BUFFER_BIT :
+                                     target == GL_ELEMENT_ARRAY_BUFFER ? VK_BUFFER_USAGE_INDEX_BUFFER_BIT  :
+                                                                         VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
     // realloc with combined flags in case GL specifies at a later state that an
     // already allocated, e.g., vertex buffer is also an index buffer and vice-versa
     if(mTarget != target && mTarget != GL_INVALID_VALUE) {
-        VkBufferUsageFlags combinedBuffers =
-                static_cast<VkBufferUsageFlags>(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
-        if(mBuffer->GetFlags() != combinedBuffers && mAllocated == true) {
+        VkBufferUsageFlags combinedBuffers = mBuffer->GetFlags() | targetUsage;
+        if(!mAllocated) {
+            mBuffer->SetFlags(combinedBuffers);
+        } else if(mBuffer->GetFlags() != combinedBuffers) {
             size_t size = mBuffer->GetSize();
+            bool deviceLocal = mDeviceLocal;
             uint8_t *srcData = new uint8_t[size];
             this->GetData(size, 0, srcData);
             this->Release();
             mBuffer->SetFlags(combinedBuffers);
-            this->Allocate(size, srcData);
+            if(deviceLocal) {
+                this->AllocateDeviceLocal(size, srcData);
+            } else {
+                this->Allocate(size, srcData);
+            }
             delete[] srcData;
         }
-    } else if(target == GL_ARRAY_BUFFER) {
-        mBuffer->SetFlags(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
-    } else if(target == GL_ELEMENT_ARRAY_BUFFER) {
-        mBuffer->SetFlags(VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+    } else if(mTarget == GL_INVALID_VALUE) {
+        mBuffer->SetFlags(targetUsage);
     }
     mTarget = target;
 }
 
+void
+BufferObject::SetReadbackSubmissionId(uint64_t submissionId)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // the device writes the contents behind the host's back
+    if(submissionId) {
+        InvalidateContents();
+    }
+    mReadbackSubmissionId = submissionId;
+}
+
 bool
 UniformBufferObject::Allocate(size_t size, const void *data)
 {
@@ -29,6 +29,26 @@
 #include "vulkan/buffer.h"
 #include "vulkan/memory.h"
 #include "refObject.h"
+#include <map>
+#include <tuple>
+#include <vector>
+
+#ifndef GLOVE_MAX_CACHED_INDEX_RANGES
+#define GLOVE_MAX_CACHED_INDEX_RANGES                   64
+#endif // GLOVE_MAX_CACHED_INDEX_RANGES
+
+#ifndef GLOVE_DEVICE_LOCAL_BUFFERS
+#define GLOVE_DEVICE_LOCAL_BUFFERS                      true
+#endif // GLOVE_DEVICE_LOCAL_BUFFERS
+
+/// updates of device local buffers up to this size are recorded inline with vkCmdUpdateBuffer, without a staging buffer
+#ifndef GLOVE_MAX_INLINE_BUFFER_UPDATE_SIZE
+#define GLOVE_MAX_INLINE_BUFFER_UPDATE_SIZE             (64 << 10)
+#endif // GLOVE_MAX_INLINE_BUFFER_UPDATE_SIZE
+
+#ifndef GLOVE_BUFFER_PROMOTION_FRAMES
+#define GLOVE_BUFFER_PROMOTION_FRAMES                   8
+#endif // GLOVE_BUFFER_PROMOTION_FRAMES
 
 class BufferObject : public refObject {
 private:
@@ -38,9 +58,39 @@ private:
     GLenum                  mUsage;
     GLenum                  mTarget;
     bool                    mAllocated;
+    /// unique across buffer objects, renewed whenever the contents change
+    uint64_t                mDataVersion;
 
     vulkanAPI::Memory*      mMemory;
 
+    /// maximum index per (offset, count, index size) the buffer has been drawn with, valid until its data change
+    typedef std::tuple<size_t, uint32_t, size_t> IndexRangeKey;
+    std::map<IndexRangeKey, uint32_t> mMaxIndices;
+
+    /// uint16 copy of the contents, for drawing them as GL_UNSIGNED_BYTE indices without VK_EXT_index_type_uint8
+    BufferObject*           mWidenedIndices;
+    bool                    mWidenedIndicesValid;
+
+    /// range mapped through glMapBufferOES/glMapBufferRangeEXT, with the access it was mapped with
+    uint8_t*                mMappedPointer;
+    size_t                  mMappedOffset;
+    size_t                  mMappedLength;
+    GLbitfield              mMappedAccess;
+
+    /// device local storage is written with staged copies, and read back from a host shadow of its contents
+    bool                    mDeviceLocal;
+    std::vector<uint8_t>    mShadowData;
+
+    /// contents version the buffer was last considered for promotion with, and the frames it has kept it since
+    uint64_t                mPromotionVersion;
+    uint32_t                mUnchangedFrames;
+
+    /// submission the pixel pack copies into the buffer complete with, 0 when none is pending
+    uint64_t                mReadbackSubmissionId;
+
+    void                    InvalidateContents(void);
+    bool                    UploadStaged(size_t offset, size_t size, const void *data, bool freshStorage);
+
 protected:
     vulkanAPI::Buffer*      mBuffer;
 
@@ -48,17 +98,30 @@ public:
     explicit                BufferObject(const vulkanAPI::vkContext_t *vkContext          = nullptr,
                                          const VkBufferUsageFlags      vkBufferUsageFlags = VK_NULL_HANDLE,
                                          const VkSharingMode           vkSharingMode      = VK_SHARING_MODE_EXCLUSIVE,
-                                         const VkFlags                 vkFlags            = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+                                         const VkFlags                 vkFlags            = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                         const VkFlags                 vkPreferredFlags   = 0);
     virtual                ~BufferObject();
 
 // Allocate Functions
     virtual bool            Allocate(size_t size, const void *data);
+    bool                    AllocateDeviceLocal(size_t size, const void *data);
 
 // Release Functions
     void                    Release(void);
 
 // Update Functions
     void                    UpdateData(size_t size, size_t offset, const void *data);
+    void                    SwapStorage(BufferObject *other);
+
+// Map Functions
+    void*                   Map(size_t offset, size_t length, GLbitfield access);
+    void                    FlushMappedRange(void);
+    void                    Unmap(void);
+
+// Command Functions
+    void                    PipelineBarrier(VkCommandBuffer *activeCmdBuffer,
+                                            VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask,
+                                            VkPipelineStageFlags srcStages, VkPipelineStageFlags dstStages);
 
 // Get Functions
     bool                    GetData(size_t size,
@@ -66,16 +129,33 @@ public:
     inline GLenum           GetUsage(void)                              const   { FUN_ENTRY(GL_LOG_TRACE); return mUsage;  }
     inline GLenum           GetTarget(void)                             const   { FUN_ENTRY(GL_LOG_TRACE); return mTarget; }
     inline size_t           GetSize(void)                               const   { FUN_ENTRY(GL_LOG_TRACE); return mBuffer->GetSize(); }
+    inline uint64_t         GetDataVersion(void)                        const   { FUN_ENTRY(GL_LOG_TRACE); return mDataVersion; }
     inline VkBuffer         GetVkBuffer(void)                                   { FUN_ENTRY(GL_LOG_TRACE); return mBuffer->GetVkBuffer(); }
+    inline VkBufferUsageFlags GetVkBufferUsage(void)                    const   { FUN_ENTRY(GL_LOG_TRACE); return mBuffer->GetFlags(); }
+    inline void*            GetMappedPointer(void)                      const   { FUN_ENTRY(GL_LOG_TRACE); return mMappedPointer; }
+    inline size_t           GetMappedOffset(void)                       const   { FUN_ENTRY(GL_LOG_TRACE); return mMappedOffset; }
+    inline size_t           GetMappedLength(void)                       const   { FUN_ENTRY(GL_LOG_TRACE); return mMappedLength; }
+    inline GLbitfield       GetMappedAccess(void)                       const   { FUN_ENTRY(GL_LOG_TRACE); return mMappedAccess; }
+    inline uint64_t         GetReadbackSubmissionId(void)               const   { FUN_ENTRY(GL_LOG_TRACE); return mReadbackSubmissionId; }
+    inline size_t           GetShadowSize(void)                         const   { FUN_ENTRY(GL_LOG_TRACE); return mShadowData.capacity(); }
+    BufferObject*           GetWidenedIndices(void);
+    bool                    GetCachedMaxIndex(size_t offset, uint32_t indexCount,
+                                              size_t elementByteSize, uint32_t *maxIndex) const;
 
 // Set Functions
     void                    SetTarget(GLenum target);
+    void                    SetReadbackSubmissionId(uint64_t submissionId);
+    void                    SetCachedMaxIndex(size_t offset, uint32_t indexCount,
+                                              size_t elementByteSize, uint32_t maxIndex);
     inline void             SetUsage(GLenum usage)                                { FUN_ENTRY(GL_LOG_TRACE); mUsage     = usage; }
     inline void             SetVkContext(const vulkanAPI::vkContext_t *vkContext) { FUN_ENTRY(GL_LOG_TRACE); mVkContext = vkContext;
                                                                                                              mBuffer->SetContext(vkContext);
                                                                                                              mMemory->SetContext(vkContext); }
 // Has/Is Functions
     inline bool             HasData(void)                               const   { FUN_ENTRY(GL_LOG_TRACE); return mBuffer->GetVkBuffer() != VK_NULL_HANDLE; }
+    inline bool             IsMapped(void)                              const   { FUN_ENTRY(GL_LOG_TRACE); return mMappedPointer != nullptr; }
+    inline bool             IsDeviceLocal(void)                         const   { FUN_ENTRY(GL_LOG_TRACE); return mDeviceLocal; }
+    bool                    IsPromotionCandidate(void);
     inline bool             IsIndexBuffer(void)                         const   { FUN_ENTRY(GL_LOG_TRACE); return mBuffer->GetFlags() & VK_BUFFER_USAGE_INDEX_BUFFER_BIT; }
 };
 
@@ -99,7 +179,10 @@ class TransferDstBufferObject : public BufferObject
 {
 
 public:
-    explicit                TransferDstBufferObject(const vulkanAPI::vkContext_t *vkContext)  : BufferObject(vkContext, VK_BUFFER_USAGE_TRANSFER_DST_BIT) { FUN_ENTRY(GL_LOG_TRACE); }
+    /// readbacks are copied out by the host, which is fastest from cached memory
+    explicit                TransferDstBufferObject(const vulkanAPI::vkContext_t *vkContext)  : BufferObject(vkContext, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_SHARING_MODE_EXCLUSIVE,
+                                                                                                             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                                                                                                             VK_MEMORY_PROPERTY_HOST_CACHED_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) { FUN_ENTRY(GL_LOG_TRACE); }
 
 };
 
@@ -26,6 +26,7 @@
  *
  */
 
+#include <algorithm>
 #include "framebuffer.h"
 #include "utils/VkToGlConverter.h"
 #include "utils/glUtils.h"
@@ -34,9 +35,13 @@
 Framebuffer::Framebuffer(const vulkanAPI::vkContext_t *vkContext)
 : mVkContext(vkContext),
 mTarget(GL_INVALID_VALUE), mState(IDLE),
-mUpdated(true), mSizeUpdated(false), mDepthStencilTexture(nullptr),
+mUpdated(true), mSizeUpdated(false),
+mStatus(GL_FRAMEBUFFER_COMPLETE), mStatusValid(false), mStatusGeneration(0), mScissorStateId(0),
+mColorInvalidated(false), mDepthInvalidated(false), mStencilInvalidated(false), mPresented(false), mFramebufferFetch(false),
+mSecondaryContents(false), mBundleExecuted(false), mVkRenderPassSecondary(false),
+mFramebufferUseCount(0), mDepthStencilTexture(nullptr), mMultisampleColorTexture(nullptr), mSamples(0),
 mBindToTexture(false), mSurfaceType(GLOVE_SURFACE_INVALID),
-mIsSystem(false), mEGLSurfaceInterface(nullptr),
+mIsSystem(false), mEGLSurfaceInterface(nullptr), mPreTransform(VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR),
 mCacheColorTexture(nullptr), mCacheDepthTexture(nullptr), mCacheStencilTexture(nullptr),
 mCacheColorRenderbuffer(nullptr), mCacheDepthRenderbuffer(nullptr), mCacheStencilRenderbuffer(nullptr)
 {
@@ -54,6 +59,7 @@ Framebuffer::~Framebuffer()
     delete mRenderPass;
     delete mAttachmentDepth;
     delete mAttachmentStencil;
+    delete mMultisampleColorTexture;
 
     if(!mIsSystem && mDepthStencilTexture != nullptr) {
         if(mDepthStencilTexture->GetDepthStencilTextureRefCount() == 1) {
@@ -80,13 +86,35 @@ Framebuffer::Release(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    for(auto fb : mFramebuffers) {
-        delete fb;
-        fb = nullptr;
+    for(auto &entry : mFramebufferCache) {
+        delete entry.second.framebuffer;
     }
+    mFramebufferCache.clear();
     mFramebuffers.clear();
 }
 
+void
+Framebuffer::TrimFramebufferCache(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the least recently used framebuffers go first, the ones in use are kept
+    while(mFramebufferCache.size() > mFramebuffers.size() + GLOVE_MAX_CACHED_VK_FRAMEBUFFERS) {
+        auto oldest = mFramebufferCache.end();
+        for(auto it = mFramebufferCache.begin(); it != mFramebufferCache.end(); ++it) {
+            if(std::find(mFramebuffers.begin(), mFramebuffers.end(), it->second.framebuffer) == mFramebuffers.end() &&
+              (oldest == mFramebufferCache.end() || it->second.lastUse < oldest->second.lastUse)) {
+                oldest = it;
+            }
+        }
+        if(oldest == mFramebufferCache.end()) {
+            return;
+        }
+        delete oldest->second.framebuffer;
+        mFramebufferCache.erase(oldest);
+    }
+}
+
 size_t
 Framebuffer::GetCurrentBufferIndex() const
 {
@@ -190,6 +218,64 @@ Framebuffer::GetStencilAttachmentTexture(void) const
     return tex;
 }
 
+GLsizei
+Framebuffer::GetAttachmentSamples(GLenum attachment) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    const Attachment *att          = nullptr;
+    Renderbuffer     *renderbuffer = nullptr;
+
+    switch(attachment) {
+    case GL_COLOR_ATTACHMENT0:
+        if(!mAttachmentColors.size()) {
+            return 0;
+        }
+        att          = mAttachmentColors[0];
+        renderbuffer = mCacheColorRenderbuffer;
+        break;
+    case GL_DEPTH_ATTACHMENT:
+        att          = mAttachmentDepth;
+        renderbuffer = mCacheDepthRenderbuffer;
+        break;
+    case GL_STENCIL_ATTACHMENT:
+        att          = mAttachmentStencil;
+        renderbuffer = mCacheStencilRenderbuffer;
+        break;
+    default:
+        return 0;
+    }
+
+    // renderbuffers can be reallocated with other samples after they are attached
+    if(att->GetType() == GL_RENDERBUFFER && att->GetName()) {
+        if(!renderbuffer) {
+            renderbuffer = mRenderbufferArray->GetObject(att->GetName());
+        }
+        return renderbuffer->GetSamples();
+    }
+
+    return att->GetType() == GL_TEXTURE ? att->GetSamples() : 0;
+}
+
+GLsizei
+Framebuffer::GetSamples(void) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(mIsSystem) {
+        return mSamples;
+    }
+
+    // CheckStatus rejects attachments whose samples differ, so any of them decides
+    if(GetColorAttachmentType() != GL_NONE) {
+        return GetAttachmentSamples(GL_COLOR_ATTACHMENT0);
+    }
+    if(GetDepthAttachmentType() != GL_NONE) {
+        return GetAttachmentSamples(GL_DEPTH_ATTACHMENT);
+    }
+    return GetAttachmentSamples(GL_STENCIL_ATTACHMENT);
+}
+
 void
 Framebuffer::AddColorAttachment(Texture *texture)
 {
@@ -201,7 +287,8 @@ Framebuffer::AddColorAttachment(Texture *texture)
     SetWidth(texture->GetWidth());
     SetHeight(texture->GetHeight());
 
-    mUpdated = true;
+    mUpdated     = true;
+    mStatusValid = false;
 }
 
 void
@@ -219,6 +306,7 @@ Framebuffer::SetColorAttachment(int width, int height)
 
 
     mUpdated     = true;
+    mStatusValid = false;
     mSizeUpdated = (mDepthStencilTexture == nullptr) || (mDepthStencilTexture->GetWidth() != GetWidth() || mDepthStencilTexture->GetHeight() != GetHeight());
 }
 
@@ -272,15 +360,42 @@ Framebuffer::CheckStatus(void)
         }
     }
 
+    // all the attachments are rendered with the same samples
+    GLsizei samples = GetSamples();
+    if((GetColorAttachmentType()   != GL_NONE && GetAttachmentSamples(GL_COLOR_ATTACHMENT0)  != samples) ||
+       (GetDepthAttachmentType()   != GL_NONE && GetAttachmentSamples(GL_DEPTH_ATTACHMENT)   != samples) ||
+       (GetStencilAttachmentType() != GL_NONE && GetAttachmentSamples(GL_STENCIL_ATTACHMENT) != samples)) {
+        return GL_FRAMEBUFFER_INCOMPLETE_MULTISAMPLE_EXT;
+    }
+
     return GL_FRAMEBUFFER_COMPLETE;
 }
 
+GLenum
+Framebuffer::GetStatus(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // the size of the attachments is followed as well, which sets up the render pass and the clear rect for them
+    uint32_t generation = Texture::GetStorageGeneration();
+    if(!mStatusValid || mStatusGeneration != generation) {
+        CheckForUpdatedResources();
+        mStatus           = mIsSystem ? GL_FRAMEBUFFER_COMPLETE : CheckStatus();
+        mStatusValid      = true;
+        mStatusGeneration = generation;
+    }
+
+    return mStatus;
+}
+
 bool
 Framebuffer::CreateVkRenderPass(bool clearColorEnabled, bool clearDepthEnabled, bool clearStencilEnabled,
                                 bool writeColorEnabled, bool writeDepthEnabled, bool writeStencilEnabled)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    UpdateMultisampleColorTexture();
+
     mRenderPass->SetColorClearEnabled(clearColorEnabled);
     mRenderPass->SetDepthClearEnabled(clearDepthEnabled);
     mRenderPass->SetStencilClearEnabled(clearStencilEnabled);
@@ -288,11 +403,155 @@ Framebuffer::CreateVkRenderPass(bool clearColorEnabled, bool clearDepthEnabled,
     mRenderPass->SetColorWriteEnabled(writeColorEnabled);
     mRenderPass->SetDepthWriteEnabled(writeDepthEnabled);
     mRenderPass->SetStencilWriteEnabled(writeStencilEnabled);
+    mRenderPass->SetDepthStencilTransient(IsDepthStencilTransient());
+    mRenderPass->SetColorTransient(mMultisampleColorTexture && mMultisampleColorTexture->IsTransient());
+    mRenderPass->SetSampleCount(GetVkSampleCount());
+    mRenderPass->SetColorInvalidated(mColorInvalidated);
+    mRenderPass->SetDepthInvalidated(mDepthInvalidated);
+    mRenderPass->SetStencilInvalidated(mStencilInvalidated);
+    mRenderPass->SetFramebufferFetch(mFramebufferFetch);
+    SetVkRenderPassLayouts();
+
+    return mRenderPass->Create(GetColorVkFormat(), GetDepthStencilVkFormat());
+}
+
+VkImageLayout
+Framebuffer::GetColorFinalLayout(void) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // the layouts Finish would move the color to, swapchain images are presented and FBO textures sampled
+    if(!mIsSystem) {
+        return VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    }
+    if(mSurfaceType == GLOVE_SURFACE_WINDOW) {
+        return VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    }
+    if(mSurfaceType == GLOVE_SURFACE_PBUFFER && mBindToTexture) {
+        return VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    }
+    return VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+}
+
+void
+Framebuffer::SetVkRenderPassLayouts(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // the pass transitions the attachments from the layouts they are left in
+    Texture *colorTexture  = GetColorAttachmentTexture();
+    Texture *renderTexture = (colorTexture && mMultisampleColorTexture) ? mMultisampleColorTexture : colorTexture;
 
-    return mRenderPass->Create(GetColorAttachmentTexture() ?
-                               GetColorAttachmentTexture()->GetVkFormat() : VK_FORMAT_UNDEFINED,
-                               mDepthStencilTexture ?
-                               mDepthStencilTexture->GetVkFormat() : VK_FORMAT_UNDEFINED);
+    mRenderPass->SetInitialLayouts(renderTexture        ? renderTexture->GetVkImageLayout()        : VK_IMAGE_LAYOUT_UNDEFINED,
+                                   mDepthStencilTexture ? mDepthStencilTexture->GetVkImageLayout() : VK_IMAGE_LAYOUT_UNDEFINED,
+                                   renderTexture != colorTexture ? colorTexture->GetVkImageLayout() : VK_IMAGE_LAYOUT_UNDEFINED);
+    mRenderPass->SetColorFinalLayout(GetColorFinalLayout());
+}
+
+bool
+Framebuffer::IsVkRenderPassLayoutUpdated(void) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    Texture *colorTexture  = GetColorAttachmentTexture();
+    Texture *renderTexture = (colorTexture && mMultisampleColorTexture) ? mMultisampleColorTexture : colorTexture;
+
+    return (renderTexture        && renderTexture->GetVkImageLayout()        != mRenderPass->GetColorInitialLayout())        ||
+           (mDepthStencilTexture && mDepthStencilTexture->GetVkImageLayout() != mRenderPass->GetDepthStencilInitialLayout()) ||
+           (renderTexture != colorTexture && colorTexture->GetVkImageLayout() != mRenderPass->GetResolveInitialLayout())      ||
+           GetColorFinalLayout() != mRenderPass->GetColorFinalLayout();
+}
+
+void
+Framebuffer::SetAttachmentLayouts(bool final)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // the transitions are performed by the render pass, only the layouts the images are in are kept
+    Texture *colorTexture  = GetColorAttachmentTexture();
+    Texture *renderTexture = (colorTexture && mMultisampleColorTexture) ? mMultisampleColorTexture : colorTexture;
+    VkImageLayout colorLayout = final ? mRenderPass->GetColorFinalLayout() : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    if(renderTexture) {
+        renderTexture->SetVkImageLayout(renderTexture != colorTexture ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL : colorLayout);
+    }
+    if(renderTexture != colorTexture) {
+        colorTexture->SetVkImageLayout(colorLayout);
+    }
+    if(mDepthStencilTexture) {
+        mDepthStencilTexture->SetVkImageLayout(VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+    }
+}
+
+void
+Framebuffer::InvalidateAttachments(bool color, bool depth, bool stencil)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the contents of the active render pass are still stored, only the next pass skips loading them
+    mColorInvalidated   |= color;
+    mDepthInvalidated   |= depth;
+    mStencilInvalidated |= stencil;
+}
+
+VkFormat
+Framebuffer::GetColorVkFormat(void) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    return GetColorAttachmentTexture() ? GetColorAttachmentTexture()->GetVkFormat() : VK_FORMAT_UNDEFINED;
+}
+
+VkFormat
+Framebuffer::GetDepthStencilVkFormat(void) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    return mDepthStencilTexture ? mDepthStencilTexture->GetVkFormat() : VK_FORMAT_UNDEFINED;
+}
+
+void
+Framebuffer::UpdateMultisampleColorTexture(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    Texture *colorTexture = GetColorAttachmentTexture();
+    VkSampleCountFlagBits samples = GetVkSampleCount();
+
+    if(!colorTexture || samples == VK_SAMPLE_COUNT_1_BIT) {
+        delete mMultisampleColorTexture;
+        mMultisampleColorTexture = nullptr;
+        return;
+    }
+
+    if(mMultisampleColorTexture                                          &&
+       mMultisampleColorTexture->GetVkSampleCount() == samples           &&
+       mMultisampleColorTexture->GetVkFormat()      == colorTexture->GetVkFormat() &&
+       mMultisampleColorTexture->GetWidth()         == GetWidth()        &&
+       mMultisampleColorTexture->GetHeight()        == GetHeight()) {
+        return;
+    }
+
+    delete mMultisampleColorTexture;
+    mMultisampleColorTexture = new Texture(mVkContext);
+    mMultisampleColorTexture->SetTarget(GL_TEXTURE_2D);
+    mMultisampleColorTexture->SetVkFormat(colorTexture->GetVkFormat());
+    mMultisampleColorTexture->SetVkSampleCount(samples);
+    if(GLOVE_TRANSIENT_MULTISAMPLE_ATTACHMENTS) {
+        mMultisampleColorTexture->SetVkImageUsage(static_cast<VkImageUsageFlagBits>(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT));
+        mMultisampleColorTexture->SetVkMemoryFlags(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT);
+        // its contents never outlive the render pass, so it shares memory with the ones of the other FBOs
+        mMultisampleColorTexture->SetVkMemoryAlias(vulkanAPI::MemoryAllocator::ALIAS_COLOR);
+    } else {
+        mMultisampleColorTexture->SetVkImageUsage(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT);
+    }
+    mMultisampleColorTexture->SetVkImageLayout(VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    mMultisampleColorTexture->SetVkImageTiling();
+    GLenum glformat = VkFormatToGlInternalformat(colorTexture->GetVkFormat());
+    mMultisampleColorTexture->InitState();
+    mMultisampleColorTexture->SetState(GetWidth(), GetHeight(), 0, 0, GlInternalFormatToGlFormat(glformat),
+                                       GlInternalFormatToGlType(glformat), Texture::GetDefaultInternalAlignment(), nullptr);
+    mMultisampleColorTexture->Allocate();
 }
 
 void
@@ -301,8 +560,12 @@ Framebuffer::CreateDepthStencilTexture(void)
     FUN_ENTRY(GL_LOG_DEBUG);
 
     if(GetDepthAttachmentTexture() || GetStencilAttachmentTexture()) {
-       
-        if(!mIsSystem && GetDepthAttachmentTexture() && GetDepthAttachmentTexture()->GetDepthStencilTexture()) {
+
+        // multisampled depth/stencil textures are not shared with the FBOs the depth texture is attached to
+        VkSampleCountFlagBits samples = GetVkSampleCount();
+        bool multisampled = samples != VK_SAMPLE_COUNT_1_BIT;
+
+        if(!mIsSystem && !multisampled && GetDepthAttachmentTexture() && GetDepthAttachmentTexture()->GetDepthStencilTexture()) {
            mDepthStencilTexture = GetDepthAttachmentTexture()->GetDepthStencilTexture();
            mDepthStencilTexture->IncreaseDepthStencilTextureRefCount();
            return;
@@ -323,7 +586,15 @@ Framebuffer::CreateDepthStencilTexture(void)
         // convert to supported format
         vkformat = FindSupportedDepthStencilFormat(mVkContext->vkGpus[0], GetVkFormatDepthBits(vkformat), GetVkFormatStencilBits(vkformat));
         mDepthStencilTexture->SetVkFormat(vkformat);
-        mDepthStencilTexture->SetVkImageUsage(static_cast<VkImageUsageFlagBits>(VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT));
+        mDepthStencilTexture->SetVkSampleCount(samples);
+        if(multisampled && GLOVE_TRANSIENT_MULTISAMPLE_ATTACHMENTS) {
+            mDepthStencilTexture->SetVkImageUsage(static_cast<VkImageUsageFlagBits>(VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT));
+            mDepthStencilTexture->SetVkMemoryFlags(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT);
+            mDepthStencilTexture->SetVkMemoryAlias(vulkanAPI::MemoryAllocator::ALIAS_DEPTH_STENCIL);
+        } else {
+            mDepthStencilTexture->SetVkImageUsage(static_cast<VkImageUsageFlagBits>(VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                                                                                    VK_IMAGE_USAGE_TRANSFER_DST_BIT));
+        }
         mDepthStencilTexture->SetVkImageLayout(VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
         mDepthStencilTexture->SetVkImageTiling();
         GLenum glformat = VkFormatToGlInternalformat(mDepthStencilTexture->GetVkFormat());
@@ -332,65 +603,15 @@ Framebuffer::CreateDepthStencilTexture(void)
                                        GlInternalFormatToGlType(glformat), Texture::GetDefaultInternalAlignment(), nullptr);
         mDepthStencilTexture->Allocate();
 
-        if(!mIsSystem && GetDepthAttachmentTexture()) {
+        if(!mIsSystem && multisampled) {
+            mDepthStencilTexture->IncreaseDepthStencilTextureRefCount();
+        } else if(!mIsSystem && GetDepthAttachmentTexture()) {
             GetDepthAttachmentTexture()->SetDepthStencilTexture(mDepthStencilTexture);
             mDepthStencilTexture->IncreaseDepthStencilTextureRefCount();
         }
     }
 }
 
-void
-Framebuffer::UpdateClearDepthStencilTexture(uint32_t clearStencil, uint32_t stencilMaskFront, const Rect& clearRect)
-{
-    GLenum glFormat = VkFormatToGlInternalformat(mDepthStencilTexture->GetVkFormat());
-    size_t numElements = GlInternalFormatTypeToNumElements(glFormat, mDepthStencilTexture->GetExplicitType());
-    ImageRect srcRect(clearRect, numElements, 1, Texture::GetDefaultInternalAlignment());
-
-    ImageRect dstRect = srcRect;
-    dstRect.x = 0;
-    dstRect.y = 0;
-    size_t dstByteSize = dstRect.GetRectBufferSize();
-    uint8_t* dstData = new uint8_t[dstByteSize];
-
-    //retrieve the stored stencil data
-    mDepthStencilTexture->SetDataNoInvertion(true);
-    mDepthStencilTexture->SetImageBufferCopyStencil(true);
-    mDepthStencilTexture->CopyPixelsToHost(&srcRect, &dstRect, 0, 0, glFormat, dstData);
-
-    // size of an entire row in bytes
-    uint32_t dataRowStride = dstRect.GetRectAlignedRowInBytes();
-
-    // rectangle offset in the memory block
-    uint32_t dataCurrentRowIndex = dstRect.GetStartRowIndex(dataRowStride);
-
-    // obtain ptr locations with the byte offset
-    uint8_t* dataPtr = static_cast<uint8_t*>(dstData) + dataCurrentRowIndex;
-
-    GLint depthBits = 0;
-    GLint stencilBits = 0;
-    GlFormatToStorageBits(glFormat, nullptr, nullptr, nullptr, nullptr, &depthBits, &stencilBits);
-    assert(stencilBits > 0);
-
-    // perform the conversion
-    for(int row = 0; row < srcRect.height; ++row) {
-        for(int col = 0; col < srcRect.width; ++col) {
-            uint32_t dataIndex = col * srcRect.GetPixelByteOffset();
-            uint8_t oldStencilValue = dataPtr[dataIndex];
-            uint8_t newStencilValue = (clearStencil & 0xFF) | ((oldStencilValue & 0xFF) & (~(stencilMaskFront & 0xFF)));
-
-            dataPtr[dataIndex] = newStencilValue;
-        }
-        // offset by the number of bytes per row
-        dataPtr = dataPtr + dataRowStride;
-    }
-
-    //update the stencil data
-    mDepthStencilTexture->CopyPixelsFromHost(&dstRect, &srcRect, 0, 0, glFormat, dstData);
-    mDepthStencilTexture->SetImageBufferCopyStencil(false);
-
-    delete[] dstData;
-}
-
 void
 Framebuffer::CheckForUpdatedResources()
 {
@@ -508,11 +729,9 @@ Framebuffer::UnrefAttachment(GLenum attachment)
         if(index) {
             GLenum type  = GetColorAttachmentType();
             if(type == GL_TEXTURE) {
-                if(mCacheColorTexture) {
-                    mCacheColorTexture->Unbind();
-                } else {
-                    mTextureArray->GetObject(index)->Unbind();
-                }
+                Texture *texture = mCacheColorTexture ? mCacheColorTexture : mTextureArray->GetObject(index);
+                texture->DecreaseColorAttachmentRefCount();
+                texture->Unbind();
             } else if(type == GL_RENDERBUFFER) {
                 if(mCacheColorRenderbuffer) {
                     mCacheColorRenderbuffer->Unbind();
@@ -574,7 +793,9 @@ Framebuffer::RefAttachment(GLenum attachment)
         if(index) {
             GLenum type  = GetColorAttachmentType();
             if(type == GL_TEXTURE) {
-                mTextureArray->GetObject(index)->Bind();
+                Texture *texture = mTextureArray->GetObject(index);
+                texture->IncreaseColorAttachmentRefCount();
+                texture->Bind();
             } else if(type == GL_RENDERBUFFER) {
                 mRenderbufferArray->GetObject(index)->Bind();
             }
@@ -623,24 +844,51 @@ Framebuffer::CreateRenderPass(bool clearColorEnabled, bool clearDepthEnabled, bo
     FUN_ENTRY(GL_LOG_DEBUG);
 
     if(mUpdated || mSizeUpdated ||
+       mRenderPass->GetSampleCount()                            != GetVkSampleCount()   ||
+       static_cast<bool>(mRenderPass->GetColorInvalidated())    != mColorInvalidated    ||
+       static_cast<bool>(mRenderPass->GetDepthInvalidated())    != mDepthInvalidated    ||
+       static_cast<bool>(mRenderPass->GetStencilInvalidated())  != mStencilInvalidated  ||
        static_cast<bool>(mRenderPass->GetColorClearEnabled())   != clearColorEnabled    ||
        static_cast<bool>(mRenderPass->GetDepthClearEnabled())   != clearDepthEnabled    ||
        static_cast<bool>(mRenderPass->GetStencilClearEnabled()) != clearStencilEnabled  ||
        static_cast<bool>(mRenderPass->GetColorWriteEnabled())   != writeColorEnabled    ||
        static_cast<bool>(mRenderPass->GetDepthWriteEnabled())   != writeDepthEnabled    ||
-       static_cast<bool>(mRenderPass->GetStencilWriteEnabled()) != writeStencilEnabled) {
-
-        if(!mIsSystem && mSizeUpdated) {
+       static_cast<bool>(mRenderPass->GetStencilWriteEnabled()) != writeStencilEnabled  ||
+       mRenderPass->GetFramebufferFetch()                       != mFramebufferFetch    ||
+       IsVkRenderPassLayoutUpdated()) {
+
+        // render passes differing only in load/store ops are compatible,
+        // so the VkFramebuffers survive clear and write mask changes.
+        // The swapchain images only change along with the system FBO, which is recreated then
+        bool recreateFramebuffers = (!mIsSystem && (mUpdated || mSizeUpdated)) || mFramebuffers.empty() ||
+                                    mRenderPass->GetSampleCount() != GetVkSampleCount();
+
+        if(!mIsSystem && (mSizeUpdated ||
+                          (mDepthStencilTexture && mDepthStencilTexture->GetVkSampleCount() != GetVkSampleCount()))) {
             CreateDepthStencilTexture();
             mSizeUpdated = false;
         }
+
+        // the input attachment of the framebuffer fetch makes the passes incompatible
+        recreateFramebuffers = recreateFramebuffers ||
+                               mRenderPass->GetFramebufferFetch()   != mFramebufferFetch  ||
+                               mRenderPass->GetColorFormat()        != GetColorVkFormat() ||
+                               mRenderPass->GetDepthStencilFormat() != GetDepthStencilVkFormat();
+
         CreateVkRenderPass(clearColorEnabled, clearDepthEnabled, clearStencilEnabled,
                            writeColorEnabled, writeDepthEnabled, writeStencilEnabled);
-        Create();
+        if(recreateFramebuffers) {
+            Create();
+        }
 
         mUpdated = false;
     }
 
+    // the invalidated contents are not loaded by this pass, and defined again after it
+    mColorInvalidated   = false;
+    mDepthInvalidated   = false;
+    mStencilInvalidated = false;
+    mPresented          = false;
 
     const VkRect2D clearRect2D = { {clearRect->x, clearRect->y},
                                    {(uint32_t)clearRect->width, (uint32_t)clearRect->height}};
@@ -659,7 +907,24 @@ Framebuffer::BeginVkRenderPass()
     vulkanAPI::CommandBufferManager *commandBufferManager = GetCurrentContext()->GetVkCommandBufferManager();
     VkCommandBuffer activeCmdBuffer = commandBufferManager->GetActiveCommandBuffer();
     size_t bufferIndex = GetCurrentBufferIndex();
-    mRenderPass->Begin(&activeCmdBuffer, mFramebuffers[bufferIndex]->GetFramebuffer(), true);
+
+    SetAttachmentLayouts(false);
+    commandBufferManager->WriteTraceScope("render pass", false);
+
+    mVkRenderPassSecondary = GLOVE_RECORD_DRAWS_TO_SECONDARY_CMD_BUFFERS || mSecondaryContents;
+
+    if(!IsImageless()) {
+        mRenderPass->Begin(&activeCmdBuffer, mFramebuffers[bufferIndex]->GetFramebuffer(), mVkRenderPassSecondary);
+        return;
+    }
+
+    vector<Texture *>   textures;
+    vector<VkImageView> imageViews;
+    GetAttachmentTextures(static_cast<uint32_t>(bufferIndex), &textures);
+    for(auto texture : textures) {
+        imageViews.push_back(texture->GetVkImageView());
+    }
+    mRenderPass->Begin(&activeCmdBuffer, mFramebuffers[bufferIndex]->GetFramebuffer(), mVkRenderPassSecondary, &imageViews);
 }
 
 bool
@@ -670,7 +935,72 @@ Framebuffer::EndVkRenderPass(void)
     assert(GetCurrentContext());
     vulkanAPI::CommandBufferManager *commandBufferManager = GetCurrentContext()->GetVkCommandBufferManager();
     VkCommandBuffer activeCmdBuffer = commandBufferManager->GetActiveCommandBuffer();
-    return mRenderPass->End(&activeCmdBuffer);
+
+    // an occlusion query begun in the render pass ends with it, the next draw begins another one
+    commandBufferManager->EndOcclusionQuery();
+    if(!mRenderPass->End(&activeCmdBuffer)) {
+        return false;
+    }
+    commandBufferManager->WriteTraceScope("render pass", true);
+
+    // passes go back to inline draws once one of them executes no bundle
+    mSecondaryContents     = mBundleExecuted;
+    mBundleExecuted        = false;
+    mVkRenderPassSecondary = false;
+
+    SetAttachmentLayouts(true);
+    return true;
+}
+
+void
+Framebuffer::ClearVkAttachments(const VkCommandBuffer *activeCmdBuffer,
+                                bool clearColorEnabled, bool clearDepthEnabled, bool clearStencilEnabled,
+                                const float *colorValue, float depthValue, uint32_t stencilValue, const Rect *clearRect)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    const VkRect2D clearRect2D = { {clearRect->x, clearRect->y},
+                                   {(uint32_t)clearRect->width, (uint32_t)clearRect->height}};
+
+    mRenderPass->ClearAttachments(activeCmdBuffer, clearColorEnabled, clearDepthEnabled, clearStencilEnabled,
+                                  colorValue, depthValue, stencilValue, &clearRect2D);
+}
+
+bool
+Framebuffer::IsFramebufferFetchSupported(void) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // the multisampled color would have to be read per sample, and is resolved into another image
+    Texture *colorTexture = GetColorAttachmentTexture();
+    return colorTexture && GetVkSampleCount() == VK_SAMPLE_COUNT_1_BIT &&
+           (colorTexture->GetVkImageUsage() & VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT);
+}
+
+Rect
+Framebuffer::GetPreTransformedRect(const Rect &rect) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(!IsPreTransformed()) {
+        return rect;
+    }
+
+    const VkRect2D rect2D = PreTransformVkRect2D({ {rect.x, rect.y}, {(uint32_t)rect.width, (uint32_t)rect.height} },
+                                                 (uint32_t)GetWindowWidth(), (uint32_t)GetWindowHeight(), mPreTransform);
+
+    return Rect(rect2D.offset.x, rect2D.offset.y, (int)rect2D.extent.width, (int)rect2D.extent.height);
+}
+
+bool
+Framebuffer::IsVkRenderPassClearable(const Rect *clearRect) const
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    const VkRect2D clearRect2D = { {clearRect->x, clearRect->y},
+                                   {(uint32_t)clearRect->width, (uint32_t)clearRect->height}};
+
+    return mRenderPass->IsStarted() && mRenderPass->IsInRenderArea(&clearRect2D);
 }
 
 void
@@ -678,6 +1008,10 @@ Framebuffer::PrepareVkImage(VkImageLayout newImageLayout)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    if(mMultisampleColorTexture && newImageLayout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL) {
+        mMultisampleColorTexture->PrepareVkImageLayout(newImageLayout);
+    }
+
     if(GetColorAttachmentTexture() && newImageLayout != VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL) {
         GetColorAttachmentTexture()->PrepareVkImageLayout(newImageLayout);
     } else if(GetDepthStencilAttachmentTexture() && newImageLayout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL) {
@@ -685,31 +1019,122 @@ Framebuffer::PrepareVkImage(VkImageLayout newImageLayout)
     }
 }
 
+void
+Framebuffer::RecordVkImageLayout(VkImageLayout newImageLayout)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    assert(GetCurrentContext());
+    vulkanAPI::CommandBufferManager *commandBufferManager = GetCurrentContext()->GetVkCommandBufferManager();
+    VkCommandBuffer activeCmdBuffer = commandBufferManager->GetActiveCommandBuffer();
+
+    // the multisampled color is only ever rendered to, the resolved one moves on to be sampled or presented
+    if(mMultisampleColorTexture && newImageLayout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL) {
+        mMultisampleColorTexture->RecordVkImageLayout(&activeCmdBuffer, newImageLayout);
+    }
+
+    if(GetColorAttachmentTexture() && newImageLayout != VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL) {
+        GetColorAttachmentTexture()->RecordVkImageLayout(&activeCmdBuffer, newImageLayout);
+    } else if(GetDepthStencilAttachmentTexture() && newImageLayout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL) {
+        GetDepthStencilAttachmentTexture()->RecordVkImageLayout(&activeCmdBuffer, newImageLayout);
+    }
+}
+
+void
+Framebuffer::GetAttachmentTextures(uint32_t i, vector<Texture *> *textures) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // multisampled passes render to the multisampled color and resolve into the color attachment after the depth/stencil
+    Texture *colorTexture  = GetColorAttachmentTexture(i);
+    Texture *renderTexture = (colorTexture && mMultisampleColorTexture) ? mMultisampleColorTexture : colorTexture;
+    if(renderTexture) {
+        textures->push_back(renderTexture);
+    }
+    if(mDepthStencilTexture) {
+        textures->push_back(mDepthStencilTexture);
+    }
+    if(renderTexture != colorTexture) {
+        textures->push_back(colorTexture);
+    }
+}
+
+bool
+Framebuffer::IsImageless(void) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // the swapchain images only differ in their views, so a single imageless framebuffer serves all of them
+    if(!mIsSystem || !mVkContext->mIsImagelessFramebufferSupported) {
+        return false;
+    }
+
+    vector<Texture *> textures;
+    GetAttachmentTextures(0, &textures);
+    for(auto texture : textures) {
+        if(texture->GetVkImageUsage() == VK_IMAGE_USAGE_FLAG_BITS_MAX_ENUM) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 bool
 Framebuffer::Create(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    Release();
+    mFramebuffers.clear();
 
+    // all the render passes of the FBO are compatible, so a framebuffer is reused
+    // for as long as its image views and size match, whichever pass built it.
+    // Imageless framebuffers are matched on the formats and usage of the images instead
+    bool imageless = IsImageless();
     for(uint32_t i = 0; i < mAttachmentColors.size(); ++i) {
-        vulkanAPI::Framebuffer *frameBuffer = new vulkanAPI::Framebuffer(mVkContext);
-
-        vector<VkImageView> imageViews;
-        if(GetColorAttachmentTexture(i)) {
-            imageViews.push_back(GetColorAttachmentTexture(i)->GetVkImageView());
-        }
-        if(mDepthStencilTexture) {
-            imageViews.push_back(mDepthStencilTexture->GetVkImageView());
+        vector<Texture *>           textures;
+        vector<VkImageView>         imageViews;
+        vector<VkFormat>            formats;
+        vector<VkImageUsageFlags>   usages;
+        vector<uint64_t>            key;
+
+        GetAttachmentTextures(i, &textures);
+        key.push_back(imageless);
+        key.push_back(mFramebufferFetch);
+        for(auto texture : textures) {
+            if(imageless) {
+                formats.push_back(texture->GetVkFormat());
+                usages.push_back(texture->GetVkImageUsage());
+                key.push_back(static_cast<uint64_t>(texture->GetVkFormat()));
+                key.push_back(static_cast<uint64_t>(texture->GetVkImageUsage()));
+            } else {
+                imageViews.push_back(texture->GetVkImageView());
+                key.push_back(texture->GetVkImageViewId());
+            }
         }
-
-        if(!frameBuffer->Create(&imageViews, GetVkRenderPass(), GetWidth(), GetHeight())) {
-            delete frameBuffer;
-            return false;
+        key.push_back(static_cast<uint64_t>(GetWidth()));
+        key.push_back(static_cast<uint64_t>(GetHeight()));
+
+        std::string keyString(reinterpret_cast<const char *>(key.data()), key.size() * sizeof(uint64_t));
+
+        auto it = mFramebufferCache.find(keyString);
+        if(it == mFramebufferCache.end()) {
+            vulkanAPI::Framebuffer *frameBuffer = new vulkanAPI::Framebuffer(mVkContext);
+            bool created = imageless ? frameBuffer->CreateImageless(&formats, &usages, GetVkRenderPass(), GetWidth(), GetHeight()) :
+                                       frameBuffer->Create(&imageViews, GetVkRenderPass(), GetWidth(), GetHeight());
+            if(!created) {
+                delete frameBuffer;
+                mFramebuffers.clear();
+                return false;
+            }
+            it = mFramebufferCache.insert(std::make_pair(keyString, cachedFramebuffer_t{frameBuffer, 0})).first;
         }
+        it->second.lastUse = ++mFramebufferUseCount;
 
-        mFramebuffers.push_back(frameBuffer);
+        mFramebuffers.push_back(it->second.framebuffer);
     }
 
+    TrimFramebufferCache();
+
     return true;
 }
@@ -28,7 +28,25 @@
 #include "renderbuffer.h"
 #include "vulkan/renderPass.h"
 #include "vulkan/framebuffer.h"
+#include "vulkan/utils.h"
 #include "utils/arrays.hpp"
+#include <map>
+#include <string>
+
+/// the system depth/stencil buffer is only used within render passes, so on tilers it never needs backing memory
+#ifndef GLOVE_TRANSIENT_SYSTEM_DEPTH_STENCIL
+#define GLOVE_TRANSIENT_SYSTEM_DEPTH_STENCIL            true
+#endif // GLOVE_TRANSIENT_SYSTEM_DEPTH_STENCIL
+
+/// multisampled attachments are only used within render passes and resolved at their end, so on tilers the samples never leave the tile memory
+#ifndef GLOVE_TRANSIENT_MULTISAMPLE_ATTACHMENTS
+#define GLOVE_TRANSIENT_MULTISAMPLE_ATTACHMENTS         true
+#endif // GLOVE_TRANSIENT_MULTISAMPLE_ATTACHMENTS
+
+/// VkFramebuffers kept per FBO for attachment sets it has rendered to, beyond the ones in use
+#ifndef GLOVE_MAX_CACHED_VK_FRAMEBUFFERS
+#define GLOVE_MAX_CACHED_VK_FRAMEBUFFERS                8
+#endif // GLOVE_MAX_CACHED_VK_FRAMEBUFFERS
 
 typedef enum {
     GLOVE_SURFACE_INVALID,
@@ -57,18 +75,55 @@ private:
     bool                            mUpdated;
     bool                            mSizeUpdated;
 
+    /// completeness of the attachments, valid while they and the storage generation of the textures stay the same
+    GLenum                          mStatus;
+    bool                            mStatusValid;
+    uint32_t                        mStatusGeneration;
+    /// scissor rect clamped to the size, derived for the scissor state mScissorStateId stands for, 0 when invalid
+    Rect                            mScissorRect;
+    uint32_t                        mScissorStateId;
+
+    /// attachments whose contents are undefined, so the next render pass does not load them
+    bool                            mColorInvalidated;
+    bool                            mDepthInvalidated;
+    bool                            mStencilInvalidated;
+    /// presented since its last render pass began
+    bool                            mPresented;
+    /// a program with the framebuffer fetch drew to it, so its passes read the color attachment from then on
+    bool                            mFramebufferFetch;
+    /// command bundles are executed in its passes, which take secondary command buffers for every draw then
+    bool                            mSecondaryContents;
+    bool                            mBundleExecuted;
+    /// the active render pass takes secondary command buffers
+    bool                            mVkRenderPassSecondary;
+
     vulkanAPI::RenderPass*          mRenderPass;
     vector<vulkanAPI::Framebuffer*> mFramebuffers;
 
+    typedef struct cachedFramebuffer_t {
+        vulkanAPI::Framebuffer     *framebuffer;
+        uint64_t                    lastUse;
+    } cachedFramebuffer_t;
+
+    /// framebuffers keyed on their image view ids and size, mFramebuffers points into it
+    std::map<std::string, cachedFramebuffer_t> mFramebufferCache;
+    uint64_t                        mFramebufferUseCount;
+
     vector<Attachment*>             mAttachmentColors;
     Attachment*                     mAttachmentDepth;
     Attachment*                     mAttachmentStencil;
     Texture*                        mDepthStencilTexture;
+    /// rendered to instead of the color attachment when multisampled, which receives the resolved samples
+    Texture*                        mMultisampleColorTexture;
+    /// samples of the EGL surface, user FBOs take theirs from the attachments
+    GLsizei                         mSamples;
     bool                            mBindToTexture;
     GLenum                          mSurfaceType;
 
     bool                            mIsSystem;
     const EGLSurfaceInterface      *mEGLSurfaceInterface;
+    /// the images of window surfaces are rendered in the orientation of the display, so that the compositor presents them as they are
+    VkSurfaceTransformFlagBitsKHR   mPreTransform;
 
     //Cache for possible deleted textures and renderbuffers
     Texture*                        mCacheColorTexture;
@@ -79,7 +134,15 @@ private:
     Renderbuffer*                   mCacheStencilRenderbuffer;
 
     void                            Release(void);
+    void                            TrimFramebufferCache(void);
+    void                            UpdateMultisampleColorTexture(void);
     size_t                          GetCurrentBufferIndex(void) const;
+    void                            GetAttachmentTextures(uint32_t i, vector<Texture *> *textures) const;
+    bool                            IsImageless(void) const;
+    VkImageLayout                   GetColorFinalLayout(void) const;
+    void                            SetVkRenderPassLayouts(void);
+    bool                            IsVkRenderPassLayoutUpdated(void) const;
+    void                            SetAttachmentLayouts(bool final);
 
 public:
     Framebuffer(const vulkanAPI::vkContext_t *vkContext = nullptr);
@@ -88,9 +151,9 @@ public:
 // Create Functions
     bool                    Create(void);
     void                    CreateDepthStencilTexture(void);
-    void                    UpdateClearDepthStencilTexture(uint32_t clearStencil, uint32_t stencilMaskFront, const Rect& clearRect);
 
 // RenderPass Functions
+    void                    InvalidateAttachments(bool color, bool depth, bool stencil);
     bool                    CreateVkRenderPass(bool clearColorEnabled, bool clearDepthEnabled, bool clearStencilEnabled,
                                                bool writeColorEnabled, bool writeDepthEnabled, bool writeStencilEnabled);
     void                    CreateRenderPass (bool clearColorEnabled, bool clearDepthEnabled, bool clearStencilEnabled,
@@ -98,13 +161,19 @@ public:
                                                const float *colorValue, float depthValue, uint32_t stencilValue, const Rect *clearRect);
     void                    BeginVkRenderPass(void);
     bool                    EndVkRenderPass(void);
+    void                    ClearVkAttachments(const VkCommandBuffer *activeCmdBuffer,
+                                               bool clearColorEnabled, bool clearDepthEnabled, bool clearStencilEnabled,
+                                               const float *colorValue, float depthValue, uint32_t stencilValue, const Rect *clearRect);
     void                    PrepareVkImage(VkImageLayout newImageLayout);
+    void                    RecordVkImageLayout(VkImageLayout newImageLayout);
 
 // Add Functions
     void                    AddColorAttachment(Texture *texture);
 
 // Check Functions
     GLenum                  CheckStatus(void);
+    /// the status of CheckStatus, checked again only once the attachments or the textures have changed
+    GLenum                  GetStatus(void);
 
 // Update Functions
     void                    CheckForUpdatedResources(void);
@@ -127,6 +196,8 @@ public:
     inline GLenum           GetTarget(void)                             const   { FUN_ENTRY(GL_LOG_TRACE); return mTarget; }
     inline vulkanAPI::RenderPass *     GetRenderPass(void)              const   { FUN_ENTRY(GL_LOG_TRACE); return mRenderPass; }
     inline VkRenderPass *   GetVkRenderPass(void)                       const   { FUN_ENTRY(GL_LOG_TRACE); return mRenderPass->GetRenderPass(); }
+           VkFormat         GetColorVkFormat(void)                      const;
+           VkFormat         GetDepthStencilVkFormat(void)               const;
 
     inline uint32_t         GetAttachmentName(GLenum type)              const   { FUN_ENTRY(GL_LOG_TRACE); switch(type) {
                                                                                                            case GL_COLOR_ATTACHMENT0:   return GetColorAttachmentName();
@@ -142,6 +213,10 @@ public:
                                                                                                                               GetColorAttachmentTexture(); }
            Texture *        GetColorAttachmentTexture(void)             const;
            Texture *        GetDepthStencilAttachmentTexture(void)      const   { FUN_ENTRY(GL_LOG_TRACE); return mDepthStencilTexture;            }
+           GLsizei          GetAttachmentSamples(GLenum attachment)     const;
+           GLsizei          GetSamples(void)                            const;
+    inline VkSampleCountFlagBits GetVkSampleCount(void)                 const   { FUN_ENTRY(GL_LOG_TRACE); return GetSamples() > 1 ? static_cast<VkSampleCountFlagBits>(GetSamples()) :
+                                                                                                                                  VK_SAMPLE_COUNT_1_BIT; }
     inline GLenum           GetDepthAttachmentType(void)                const   { FUN_ENTRY(GL_LOG_TRACE); return mAttachmentDepth->GetType();     }
     inline uint32_t         GetDepthAttachmentName(void)                const   { FUN_ENTRY(GL_LOG_TRACE); return mAttachmentDepth->GetName();     }
     inline GLint            GetDepthAttachmentLevel(void)               const   { FUN_ENTRY(GL_LOG_TRACE); return mAttachmentDepth->GetLevel();    }
@@ -155,6 +230,12 @@ public:
            Texture *        GetStencilAttachmentTexture(void)           const;
     inline GLint            GetBindToTexture(void)                      const   { FUN_ENTRY(GL_LOG_TRACE); return mBindToTexture;                  }
     inline GLint            GetSurfaceType(void)                        const   { FUN_ENTRY(GL_LOG_TRACE); return mSurfaceType;                    }
+    inline VkSurfaceTransformFlagBitsKHR GetPreTransform(void)          const   { FUN_ENTRY(GL_LOG_TRACE); return mPreTransform;                   }
+    /// the size in window coordinates, which the images of a surface pre-rotated by a quarter turn have swapped
+    inline int              GetWindowWidth(void)                        const   { FUN_ENTRY(GL_LOG_TRACE); return VkSurfaceTransformIsSideways(mPreTransform) ? mDims.height : mDims.width;  }
+    inline int              GetWindowHeight(void)                       const   { FUN_ENTRY(GL_LOG_TRACE); return VkSurfaceTransformIsSideways(mPreTransform) ? mDims.width  : mDims.height; }
+    /// a rect of the window coordinates with a top-left origin, as it lies in the images
+           Rect             GetPreTransformedRect(const Rect &rect)     const;
 
 // Set Functions
     inline void             SetEGLSurfaceInterface(const EGLSurfaceInterface_t* eglSurfaceInterface) { FUN_ENTRY(GL_LOG_TRACE); mEGLSurfaceInterface = eglSurfaceInterface; }
@@ -164,36 +245,50 @@ public:
                             ObjectArray<Texture>            *texArray,
                             ObjectArray<Renderbuffer>       *rbArray)           { FUN_ENTRY(GL_LOG_TRACE); mTextureArray = texArray; mRenderbufferArray = rbArray; }
 
-    inline void             SetUpdated(void)                                    { FUN_ENTRY(GL_LOG_TRACE); mUpdated     = true;   }
+    inline void             SetUpdated(void)                                    { FUN_ENTRY(GL_LOG_TRACE); mUpdated     = true;   mStatusValid = false; }
+    inline void             SetPresented(void)                                  { FUN_ENTRY(GL_LOG_TRACE); mPresented   = true;   }
     inline void             SetIsSystem(void)                                   { FUN_ENTRY(GL_LOG_TRACE); mIsSystem    = true;   }
+    inline void             SetSamples(GLsizei samples)                         { FUN_ENTRY(GL_LOG_TRACE); mSamples     = samples; mUpdated = true; mStatusValid = false; }
     inline void             SetStateIdle(void)                                  { FUN_ENTRY(GL_LOG_TRACE); mState       = IDLE;   }
     inline void             SetStateClear(void)                                 { FUN_ENTRY(GL_LOG_TRACE); mState       = CLEAR;  }
     inline void             SetStateClearDraw(void)                             { FUN_ENTRY(GL_LOG_TRACE); mState       = CLEAR_DRAW;  }
     inline void             SetStateDraw(void)                                  { FUN_ENTRY(GL_LOG_TRACE); mState       = DRAW;   }
     inline void             SetStateDelete(void)                                { FUN_ENTRY(GL_LOG_TRACE); mState       = IN_DELETE; }
     inline void             SetTarget(GLenum target)                            { FUN_ENTRY(GL_LOG_TRACE); mTarget      = target; }
-    inline void             SetWidth(int32_t width)                             { FUN_ENTRY(GL_LOG_TRACE); mDims.width  = width;  }
-    inline void             SetHeight(int32_t height)                           { FUN_ENTRY(GL_LOG_TRACE); mDims.height = height; }
+    inline void             SetWidth(int32_t width)                             { FUN_ENTRY(GL_LOG_TRACE); mDims.width  = width;  mScissorStateId = 0; }
+    inline void             SetHeight(int32_t height)                           { FUN_ENTRY(GL_LOG_TRACE); mDims.height = height; mScissorStateId = 0; }
+    inline bool             GetScissorRect(uint32_t scissorStateId, Rect *rect) const { FUN_ENTRY(GL_LOG_TRACE); if(scissorStateId != mScissorStateId) { return false; }
+                                                                                                                 *rect = mScissorRect; return true; }
+    inline void             SetScissorRect(uint32_t scissorStateId, const Rect &rect) { FUN_ENTRY(GL_LOG_TRACE); mScissorStateId = scissorStateId; mScissorRect = rect; }
+    inline void             InvalidateStatus(void)                              { FUN_ENTRY(GL_LOG_TRACE); mStatusValid = false; }
 
            void             SetColorAttachment(int width, int height);
-    inline void             SetColorAttachmentType(GLenum type)                 { FUN_ENTRY(GL_LOG_TRACE); mAttachmentColors[0]->SetType(type);   }
-    inline void             SetColorAttachmentName(uint32_t name)               { FUN_ENTRY(GL_LOG_TRACE); mAttachmentColors[0]->SetName(name);   }
-    inline void             SetColorAttachmentLevel(GLint level)                { FUN_ENTRY(GL_LOG_TRACE); mAttachmentColors[0]->SetLevel(level); }
-    inline void             SetColorAttachmentLayer(GLenum layer)               { FUN_ENTRY(GL_LOG_TRACE); mAttachmentColors[0]->SetLayer(layer); }
-
-    inline void             SetDepthAttachmentName(uint32_t name)               { FUN_ENTRY(GL_LOG_TRACE); mAttachmentDepth->SetName(name);   mUpdated = true;}
-    inline void             SetDepthAttachmentType(GLenum type)                 { FUN_ENTRY(GL_LOG_TRACE); mAttachmentDepth->SetType(type);   }
-    inline void             SetDepthAttachmentLevel(GLint level)                { FUN_ENTRY(GL_LOG_TRACE); mAttachmentDepth->SetLevel(level); }
-    inline void             SetDepthAttachmentLayer(GLenum layer)               { FUN_ENTRY(GL_LOG_TRACE); mAttachmentDepth->SetLayer(layer); }
-
-    inline void             SetStencilAttachmentName(uint32_t name)             { FUN_ENTRY(GL_LOG_TRACE); mAttachmentStencil->SetName(name); mUpdated = true;}
-    inline void             SetStencilAttachmentType(GLenum type)               { FUN_ENTRY(GL_LOG_TRACE); mAttachmentStencil->SetType(type);   }
-    inline void             SetStencilAttachmentLevel(GLint level)              { FUN_ENTRY(GL_LOG_TRACE); mAttachmentStencil->SetLevel(level); }
-    inline void             SetStencilAttachmentLayer(GLenum layer)             { FUN_ENTRY(GL_LOG_TRACE); mAttachmentStencil->SetLayer(layer); }
+    inline void             SetColorAttachmentType(GLenum type)                 { FUN_ENTRY(GL_LOG_TRACE); mAttachmentColors[0]->SetType(type); mStatusValid = false; }
+    inline void             SetColorAttachmentName(uint32_t name)               { FUN_ENTRY(GL_LOG_TRACE); mAttachmentColors[0]->SetName(name); mStatusValid = false; }
+    inline void             SetColorAttachmentLevel(GLint level)                { FUN_ENTRY(GL_LOG_TRACE); mAttachmentColors[0]->SetLevel(level); mStatusValid = false; }
+    inline void             SetColorAttachmentLayer(GLenum layer)               { FUN_ENTRY(GL_LOG_TRACE); mAttachmentColors[0]->SetLayer(layer); mStatusValid = false; }
+    inline void             SetColorAttachmentSamples(GLsizei samples)          { FUN_ENTRY(GL_LOG_TRACE); mAttachmentColors[0]->SetSamples(samples); mUpdated = true; mStatusValid = false; }
+
+    inline void             SetDepthAttachmentName(uint32_t name)               { FUN_ENTRY(GL_LOG_TRACE); mAttachmentDepth->SetName(name);   mUpdated = true; mStatusValid = false; }
+    inline void             SetDepthAttachmentType(GLenum type)                 { FUN_ENTRY(GL_LOG_TRACE); mAttachmentDepth->SetType(type); mStatusValid = false; }
+    inline void             SetDepthAttachmentLevel(GLint level)                { FUN_ENTRY(GL_LOG_TRACE); mAttachmentDepth->SetLevel(level); mStatusValid = false; }
+    inline void             SetDepthAttachmentLayer(GLenum layer)               { FUN_ENTRY(GL_LOG_TRACE); mAttachmentDepth->SetLayer(layer); mStatusValid = false; }
+    inline void             SetDepthAttachmentSamples(GLsizei samples)          { FUN_ENTRY(GL_LOG_TRACE); mAttachmentDepth->SetSamples(samples); mUpdated = true; mStatusValid = false; }
+
+    inline void             SetStencilAttachmentName(uint32_t name)             { FUN_ENTRY(GL_LOG_TRACE); mAttachmentStencil->SetName(name); mUpdated = true; mStatusValid = false; }
+    inline void             SetStencilAttachmentType(GLenum type)               { FUN_ENTRY(GL_LOG_TRACE); mAttachmentStencil->SetType(type); mStatusValid = false; }
+    inline void             SetStencilAttachmentLevel(GLint level)              { FUN_ENTRY(GL_LOG_TRACE); mAttachmentStencil->SetLevel(level); mStatusValid = false; }
+    inline void             SetStencilAttachmentLayer(GLenum layer)             { FUN_ENTRY(GL_LOG_TRACE); mAttachmentStencil->SetLayer(layer); mStatusValid = false; }
+    inline void             SetStencilAttachmentSamples(GLsizei samples)        { FUN_ENTRY(GL_LOG_TRACE); mAttachmentStencil->SetSamples(samples); mUpdated = true; mStatusValid = false; }
 
     inline void             SetDepthStencilAttachmentTexture(Texture *texture)  { FUN_ENTRY(GL_LOG_TRACE); mDepthStencilTexture = texture; }
     inline void             SetBindToTexture(GLint bindToTexture)               { FUN_ENTRY(GL_LOG_TRACE); mBindToTexture = bindToTexture;      }
-    inline void             SetSurfaceType(GLint surfacetype)                   { FUN_ENTRY(GL_LOG_TRACE); mSurfaceType = surfacetype;          }
+    inline void             SetSurfaceType(GLint surfacetype)                   { FUN_ENTRY(GL_LOG_TRACE); mSurfaceType = surfacetype;          mScissorStateId = 0; }
+    inline void             SetFramebufferFetch(bool enable)                    { FUN_ENTRY(GL_LOG_TRACE); mFramebufferFetch = enable;          }
+    /// the passes begun from now on take secondary command buffers, for as long as each of them executes a bundle
+    inline void             SetSecondaryContents(void)                          { FUN_ENTRY(GL_LOG_TRACE); mSecondaryContents = true;           }
+    inline void             SetBundleExecuted(void)                             { FUN_ENTRY(GL_LOG_TRACE); mBundleExecuted    = true;           }
+    inline void             SetPreTransform(VkSurfaceTransformFlagBitsKHR transform) { FUN_ENTRY(GL_LOG_TRACE); mPreTransform = transform;      mScissorStateId = 0; }
 
     inline bool             IsSizeUpdated(void)                           const { FUN_ENTRY(GL_LOG_TRACE); return mSizeUpdated; }
 
@@ -203,6 +298,17 @@ public:
     inline bool             IsInClearDrawState(void)                            { FUN_ENTRY(GL_LOG_TRACE); return (mState == CLEAR_DRAW); }
     inline bool             IsInDeleteState(void)                               { FUN_ENTRY(GL_LOG_TRACE); return (mState == IN_DELETE); }
     inline bool             IsInDrawState(void)                                 { FUN_ENTRY(GL_LOG_TRACE); return !IsInIdleState(); }
+    inline bool             IsDepthStencilTransient(void)                 const { FUN_ENTRY(GL_LOG_TRACE); return mDepthStencilTexture && mDepthStencilTexture->IsTransient(); }
+    inline bool             IsPresented(void)                             const { FUN_ENTRY(GL_LOG_TRACE); return mPresented; }
+    inline bool             IsFramebufferFetchEnabled(void)               const { FUN_ENTRY(GL_LOG_TRACE); return mFramebufferFetch; }
+    inline bool             IsVkRenderPassSecondary(void)                 const { FUN_ENTRY(GL_LOG_TRACE); return mVkRenderPassSecondary; }
+    inline bool             IsPreTransformed(void)                        const { FUN_ENTRY(GL_LOG_TRACE); return mPreTransform != VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR; }
+           bool             IsFramebufferFetchSupported(void)             const;
+    /// surfaces are stored top row first, user FBOs keep the bottom-up rows of GL textures whenever the viewport can flip
+    /// pbuffers are rendered with the rows of GL textures, so that they can be sampled in place once bound
+    inline bool             IsOriginFlipped(void)                         const { FUN_ENTRY(GL_LOG_TRACE); return (mIsSystem && mSurfaceType != GLOVE_SURFACE_PBUFFER) ||
+                                                                                                                !mVkContext->mIsMaintenanceExtSupported; }
+           bool             IsVkRenderPassClearable(const Rect *clearRect) const;
 };
 
 #endif // __FRAMEBUFFER_H__
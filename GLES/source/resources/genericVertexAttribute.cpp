@@ -27,12 +27,19 @@
 
 #include "genericVertexAttribute.h"
 #include "utils/glUtils.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
 
 GenericVertexAttribute::GenericVertexAttribute()
-: mElements(4), mType(GL_FLOAT), mNormalized(false), mStride(0), mEnabled(false),
+: mElements(4), mType(GL_FLOAT), mNormalized(false), mStride(0), mEnabled(false), mDivisor(0),
   mOffset(0), mPtr(0),
   mInternalVbo(nullptr), mExternalVbo(nullptr),
-  mInternalVBOStatus(true), mCacheManager(nullptr)
+  mStreamVkBuffer(VK_NULL_HANDLE), mStreamOffset(0), mGenericValueEpoch(0),
+  mInternalVBOStatus(true), mCacheManager(nullptr),
+  mConversion(VERTEX_CONVERSION_NONE), mConvertedFormat(VK_FORMAT_UNDEFINED), mConvertedStride(0),
+  mConvertedVbo(nullptr), mConvertedSourceVersion(0), mConvertedSourceOffset(0), mConvertedSourceStride(0), mConvertedSourceElements(0),
+  mConvertedSourceType(GL_FLOAT), mConvertedSourceNormalized(GL_FALSE)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
@@ -50,7 +57,7 @@ GenericVertexAttribute::~GenericVertexAttribute()
 }
 
 BufferObject*
-GenericVertexAttribute::UpdateVertexAttribute(uint32_t numVertices, bool& updatedVBO)
+GenericVertexAttribute::UpdateVertexAttribute(uint32_t firstVertex, uint32_t numVertices, vulkanAPI::RingBuffer *streamRing, bool& updatedVBO)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
@@ -60,26 +67,88 @@ GenericVertexAttribute::UpdateVertexAttribute(uint32_t numVertices, bool& update
     // Otherwise, generate the appropriate vertex data
     if(IsEnabled()) {
         // Calculate stride if not given from user based on the actual data type
-        GLsizei stride = GetStride() > 0 ? GetStride() : GetNumElements() * GlAttribTypeToElementSize(GetType());
+        GLsizei stride = GetStride() > 0 ? GetStride() : GlAttribTypeToVertexSize(GetNumElements(), GetType());
         SetStride(stride);
 
         // Create a vbo located on client-space (e.g, glVertexAttribPointer) or
         // attach a vbo lotated on server-space (e.g., glBindBuffer)
-        return IsInternalVBO() ? GenerateUserSpaceVBO(numVertices, updatedVBO) : AttachDeviceSpaceVBO(numVertices, updatedVBO);
+        return IsInternalVBO() ? GenerateUserSpaceVBO(firstVertex, numVertices, streamRing, updatedVBO) : AttachDeviceSpaceVBO(updatedVBO);
      } else {
-        return UpdateGenericValueVBO(updatedVBO);
+        return UpdateGenericValueVBO(streamRing, updatedVBO);
     }
 }
 
 BufferObject*
-GenericVertexAttribute::GenerateUserSpaceVBO(uint32_t numVertices, bool& updatedVBO)
+GenericVertexAttribute::GenerateUserSpaceVBO(uint32_t firstVertex, uint32_t numVertices, vulkanAPI::RingBuffer *streamRing, bool& updatedVBO)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    BufferObject *vbo = new VertexBufferObject(mVkContext);
     void *srcData = reinterpret_cast<void*>(GetPointer());
     size_t byteSize = numVertices * GetStride();
 
+    // only the vertices from firstVertex on are streamed, with the binding moved back by the ones
+    // skipped so that the draw still addresses them by their index. When the ring has no room
+    // ahead of the upload for that, the array is streamed again from its first vertex
+
+    // client arrays are converted as they are streamed, the data may change with every draw
+    if(mConversion > VERTEX_CONVERSION_FIXED) {
+        uint32_t streamOffset;
+        size_t   skippedSize = firstVertex * mConvertedStride;
+        uint8_t *dstData     = streamRing ? streamRing->Allocate(numVertices * mConvertedStride, &streamOffset) : nullptr;
+        if(dstData && streamOffset < skippedSize) {
+            skippedSize = 0;
+            dstData     = streamRing->Allocate((firstVertex + numVertices) * mConvertedStride, &streamOffset);
+        }
+        if(dstData) {
+            size_t skippedVertices = skippedSize ? firstVertex : 0;
+            ConvertVertices(static_cast<const uint8_t *>(srcData) + skippedVertices * GetStride(), GetStride(), firstVertex + numVertices - skippedVertices, dstData);
+            SetOffset(0);
+            SetInternalVBOStatus(true);
+            SetCurrentVbo(nullptr);
+            mStreamVkBuffer = streamRing->GetVkBuffer();
+            mStreamOffset   = streamOffset - skippedSize;
+            updatedVBO = true;
+            return nullptr;
+        }
+
+        size_t convertedSize = (firstVertex + numVertices) * mConvertedStride;
+        std::vector<uint8_t> convertedData(convertedSize);
+        ConvertVertices(static_cast<const uint8_t *>(srcData), GetStride(), firstVertex + numVertices, convertedData.data());
+        BufferObject *vbo = new VertexBufferObject(mVkContext);
+        vbo->Allocate(convertedSize, convertedData.data());
+        SetOffset(0);
+        SetInternalVBOStatus(true);
+        SetCurrentVbo(vbo);
+        updatedVBO = true;
+        return vbo;
+    }
+
+    // client arrays are copied into the streaming ring and bound at their offset in it
+    if(streamRing && GetType() != GL_FIXED) {
+        uint32_t streamOffset;
+        size_t   skippedSize = firstVertex * GetStride();
+        bool     uploaded    = streamRing->Upload(static_cast<const uint8_t *>(srcData) + skippedSize, byteSize, &streamOffset);
+        if(uploaded && streamOffset < skippedSize) {
+            uploaded    = streamRing->Upload(srcData, skippedSize + byteSize, &streamOffset);
+            skippedSize = 0;
+        }
+        if(uploaded) {
+            SetOffset(0);
+            SetInternalVBOStatus(true);
+            SetCurrentVbo(nullptr);
+            mStreamVkBuffer = streamRing->GetVkBuffer();
+            mStreamOffset   = streamOffset - skippedSize;
+            updatedVBO = true;
+            return nullptr;
+        }
+    }
+
+    // a buffer of its own holds the data from the first vertex of the array
+    byteSize    += firstVertex * GetStride();
+    numVertices += firstVertex;
+
+    BufferObject *vbo = new VertexBufferObject(mVkContext);
+
     // explicitly convert GL_FIXED to GL_FLOAT
     if(GetType() != GL_FIXED) {
         vbo->Allocate(byteSize, srcData);
@@ -96,43 +165,134 @@ GenericVertexAttribute::GenerateUserSpaceVBO(uint32_t numVertices, bool& updated
 }
 
 BufferObject*
-GenericVertexAttribute::AttachDeviceSpaceVBO(uint32_t numVertices, bool& updatedVBO)
+GenericVertexAttribute::AttachDeviceSpaceVBO(bool& updatedVBO)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
     BufferObject *vbo = mExternalVbo;
     updatedVBO = false;
+    if(mConversion > VERTEX_CONVERSION_FIXED) {
+        return ConvertDeviceSpaceVBO(vbo, updatedVBO);
+    }
+
     // explicitly convert GL_FIXED to GL_FLOAT from a buffer object
-    // NOTE: this is an inefficient operation and, thus, not a recommended good practice
+    // NOTE: the whole buffer is converted once and reused until its contents change
     if(GetType() == GL_FIXED) {
-        size_t byteSize = vbo->GetSize();
+        if(mConvertedVbo                                      &&
+           mConvertedSourceVersion  == vbo->GetDataVersion()  &&
+           mConvertedSourceOffset   == GetOffset()            &&
+           mConvertedSourceStride   == GetStride()            &&
+           mConvertedSourceElements == GetNumElements()       &&
+           mConvertedSourceType     == GL_FIXED) {
+            return mConvertedVbo;
+        }
+
+        size_t byteSize     = vbo->GetSize();
+        size_t vertexSize   = GetNumElements() * sizeof(GLfixed);
+        size_t stride       = GetStride() ? GetStride() : vertexSize;
+        size_t convertCount = byteSize >= GetOffset() + vertexSize ? (byteSize - GetOffset() - vertexSize) / stride + 1 : 0;
+
         uint8_t *srcData = new uint8_t[byteSize];
         vbo->GetData(byteSize, 0, srcData);
-        vbo = new VertexBufferObject(mVkContext);
-        ConvertFixedBufferToFloat(vbo, byteSize, srcData, numVertices);
+
+        if(mConvertedVbo) {
+            mCacheManager->CacheVBO(mConvertedVbo);
+        }
+        mConvertedVbo = new VertexBufferObject(mVkContext);
+        ConvertFixedBufferToFloat(mConvertedVbo, byteSize, srcData, convertCount);
         delete[] srcData;
-        mCacheManager->CacheVBO(vbo);
+
+        mConvertedSourceVersion    = vbo->GetDataVersion();
+        mConvertedSourceOffset     = GetOffset();
+        mConvertedSourceStride     = GetStride();
+        mConvertedSourceElements   = GetNumElements();
+        mConvertedSourceType       = GL_FIXED;
+        mConvertedSourceNormalized = GetNormalized();
+
         updatedVBO = true;
+        return mConvertedVbo;
     }
     return vbo;
 }
 
 BufferObject*
-GenericVertexAttribute::UpdateGenericValueVBO(bool& updatedVBO)
+GenericVertexAttribute::ConvertDeviceSpaceVBO(BufferObject *vbo, bool& updatedVBO)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the vertices from the offset to the end of the buffer are converted once and reused until its contents change
+    if(mConvertedVbo                                          &&
+       mConvertedSourceVersion    == vbo->GetDataVersion()    &&
+       mConvertedSourceOffset     == GetOffset()              &&
+       mConvertedSourceStride     == GetStride()              &&
+       mConvertedSourceElements   == GetNumElements()         &&
+       mConvertedSourceType       == GetType()                &&
+       mConvertedSourceNormalized == GetNormalized()) {
+        return mConvertedVbo;
+    }
+
+    size_t byteSize     = vbo->GetSize();
+    size_t vertexSize   = GlAttribTypeToVertexSize(GetNumElements(), GetType());
+    size_t stride       = GetStride() ? GetStride() : vertexSize;
+    size_t convertCount = byteSize >= GetOffset() + vertexSize ? (byteSize - GetOffset() - vertexSize) / stride + 1 : 0;
+
+    std::vector<uint8_t> srcData(byteSize);
+    vbo->GetData(byteSize, 0, srcData.data());
+
+    // an empty range still gets a buffer to bind
+    std::vector<uint8_t> convertedData(std::max<size_t>(convertCount, 1) * mConvertedStride, 0);
+    ConvertVertices(srcData.data() + GetOffset(), stride, convertCount, convertedData.data());
+
+    if(mConvertedVbo) {
+        mCacheManager->CacheVBO(mConvertedVbo);
+    }
+    mConvertedVbo = new VertexBufferObject(mVkContext);
+    mConvertedVbo->Allocate(convertedData.size(), convertedData.data());
+
+    mConvertedSourceVersion    = vbo->GetDataVersion();
+    mConvertedSourceOffset     = GetOffset();
+    mConvertedSourceStride     = GetStride();
+    mConvertedSourceElements   = GetNumElements();
+    mConvertedSourceType       = GetType();
+    mConvertedSourceNormalized = GetNormalized();
+
+    updatedVBO = true;
+    return mConvertedVbo;
+}
+
+BufferObject*
+GenericVertexAttribute::UpdateGenericValueVBO(vulkanAPI::RingBuffer *streamRing, bool& updatedVBO)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    // TODO: do not recreate the VBO
-    BufferObject *vbo = new VertexBufferObject(mVkContext);
     GLfloat genericValue[4];
     GetGenericValue(genericValue);
-    vbo->Allocate(4 * sizeof(float), static_cast<const void *>(genericValue));
     SetNumElements(4);
     SetType(GL_FLOAT);
+    mConversion = VERTEX_CONVERSION_NONE;
     SetStride(0);
     SetInternalVBOStatus(true);
-    SetCurrentVbo(vbo);
+
+    // the value stays in the ring for the rest of the frame, so a disabled
+    // attribute is only uploaded again when its value or the frame changes
+    if(streamRing && mGenericValueEpoch == streamRing->GetEpoch()) {
+        updatedVBO = false;
+        return nullptr;
+    }
     updatedVBO = true;
+
+    uint32_t streamOffset;
+    if(streamRing && streamRing->Upload(genericValue, sizeof(genericValue), &streamOffset)) {
+        SetCurrentVbo(nullptr);
+        mStreamVkBuffer     = streamRing->GetVkBuffer();
+        mStreamOffset       = streamOffset;
+        mGenericValueEpoch  = streamRing->GetEpoch();
+        return nullptr;
+    }
+
+    BufferObject *vbo = new VertexBufferObject(mVkContext);
+    vbo->Allocate(4 * sizeof(float), static_cast<const void *>(genericValue));
+    SetCurrentVbo(vbo);
     return vbo;
 }
 
@@ -181,6 +341,11 @@ GenericVertexAttribute::Release(void)
        delete mInternalVbo;
        mInternalVbo        = nullptr;
     }
+
+    if(mConvertedVbo != nullptr) {
+        delete mConvertedVbo;
+        mConvertedVbo = nullptr;
+    }
 }
 
 void
@@ -194,6 +359,9 @@ GenericVertexAttribute::SetCurrentVbo(BufferObject *vbo)
 
     mInternalVbo = mInternalVBOStatus ? vbo : nullptr;
     mExternalVbo = mInternalVBOStatus ? nullptr : vbo;
+    mStreamVkBuffer = VK_NULL_HANDLE;
+    mStreamOffset   = 0;
+    mGenericValueEpoch = 0;
 }
 
 void
@@ -207,8 +375,95 @@ GenericVertexAttribute::Set(GLint nElements, GLenum type, GLboolean normalized,
     SetStride(stride);
     SetNumElements(nElements);
     SetNormalized(normalized);
+    SelectConversion();
     SetPointer(internalVBO ? reinterpret_cast<uintptr_t>(ptr) : 0);
     SetOffset(internalVBO ? 0 : reinterpret_cast<uintptr_t>(ptr));
     SetInternalVBOStatus(internalVBO);
     SetCurrentVbo(vbo);
 }
+
+void
+GenericVertexAttribute::SelectConversion(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    mConversion = GetType() == GL_FIXED ? VERTEX_CONVERSION_FIXED : VERTEX_CONVERSION_NONE;
+    if(GetType() != GL_HALF_FLOAT_OES && GetType() != GL_INT_10_10_10_2_OES && GetType() != GL_UNSIGNED_INT_10_10_10_2_OES) {
+        return;
+    }
+
+    // the formats are fetched as they are where the device can, which it must for all but
+    // three half floats; the 10_10_10_2 layout has no Vulkan format and is always reordered
+    VkFormat format = GlAttribPointerToVkFormat(GetNumElements(), GetType(), GetNormalized());
+    VkFormatProperties props;
+    vkGetPhysicalDeviceFormatProperties(mVkContext->vkGpus[0], format, &props);
+    bool supported = (props.bufferFeatures & VK_FORMAT_FEATURE_VERTEX_BUFFER_BIT) != 0;
+
+    if(GetType() == GL_HALF_FLOAT_OES) {
+        if(!supported) {
+            mConversion      = VERTEX_CONVERSION_HALF_WIDEN;
+            mConvertedFormat = VK_FORMAT_R16G16B16A16_SFLOAT;
+            mConvertedStride = 4 * sizeof(uint16_t);
+        }
+    } else if(supported) {
+        mConversion      = VERTEX_CONVERSION_PACKED_REORDER;
+        mConvertedFormat = format;
+        mConvertedStride = sizeof(GLuint);
+    } else {
+        mConversion      = VERTEX_CONVERSION_PACKED_FLOAT;
+        mConvertedFormat = VK_FORMAT_R32G32B32A32_SFLOAT;
+        mConvertedStride = 4 * sizeof(GLfloat);
+    }
+}
+
+void
+GenericVertexAttribute::ConvertVertices(const uint8_t *srcData, size_t srcStride, size_t numVertices, uint8_t *dstData) const
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    const uint32_t elements = static_cast<uint32_t>(GetNumElements());
+    const bool     isSigned = GetType() == GL_INT_10_10_10_2_OES;
+
+    for(size_t ver = 0; ver < numVertices; ++ver, srcData += srcStride, dstData += mConvertedStride) {
+        if(mConversion == VERTEX_CONVERSION_HALF_WIDEN) {
+            // the missing components read as (0, 0, 0, 1), 0x3C00 being 1.0 in half float
+            uint16_t half[4] = { 0, 0, 0, 0x3C00 };
+            memcpy(half, srcData, elements * sizeof(uint16_t));
+            memcpy(dstData, half, sizeof(half));
+            continue;
+        }
+
+        // x is in the most significant bits of a 10_10_10_2 value and w in the least
+        GLuint packed;
+        memcpy(&packed, srcData, sizeof(packed));
+        GLuint x = (packed >> 22) & 0x3FF;
+        GLuint y = (packed >> 12) & 0x3FF;
+        GLuint z = (packed >>  2) & 0x3FF;
+        GLuint w =  packed        & 0x3;
+
+        // a 3 component attribute has a w of 1, whichever way it is read
+        if(elements == 3) {
+            w = !isSigned && GetNormalized() ? 0x3 : 0x1;
+        }
+
+        if(mConversion == VERTEX_CONVERSION_PACKED_REORDER) {
+            GLuint reordered = x | (y << 10) | (z << 20) | (w << 30);
+            memcpy(dstData, &reordered, sizeof(reordered));
+            continue;
+        }
+
+        GLfloat value[4];
+        const GLuint components[4] = { x, y, z, w };
+        for(uint32_t i = 0; i < 4; ++i) {
+            const uint32_t bits = i < 3 ? 10 : 2;
+            if(isSigned) {
+                int32_t signedValue = static_cast<int32_t>(components[i] << (32 - bits)) >> (32 - bits);
+                int32_t maxValue    = (1 << (bits - 1)) - 1;
+                value[i] = GetNormalized() ? std::max(static_cast<GLfloat>(signedValue) / maxValue, -1.0f) : static_cast<GLfloat>(signedValue);
+            } else {
+                value[i] = GetNormalized() ? static_cast<GLfloat>(components[i]) / ((1u << bits) - 1) : static_cast<GLfloat>(components[i]);
+            }
+        }
+        memcpy(dstData, value, sizeof(value));
+    }
+}
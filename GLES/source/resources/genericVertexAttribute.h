@@ -27,6 +27,20 @@
 #include "bufferObject.h"
 #include "utils/GlToVkConverter.h"
 #include "utils/cacheManager.h"
+#include "vulkan/ringBuffer.h"
+
+/// how the data of an attribute reach the vertex input, when the device cannot fetch them as they are
+typedef enum {
+    VERTEX_CONVERSION_NONE = 0,
+    /// GL_FIXED is converted to float in place
+    VERTEX_CONVERSION_FIXED,
+    /// half floats without a 16-bit format of their size are widened to four of them
+    VERTEX_CONVERSION_HALF_WIDEN,
+    /// the 10_10_10_2 components are reordered into the A2B10G10R10 layout of Vulkan
+    VERTEX_CONVERSION_PACKED_REORDER,
+    /// or converted to floats, where the device cannot fetch that layout either
+    VERTEX_CONVERSION_PACKED_FLOAT
+} vertexConversion_t;
 
 class GenericVertexAttribute {
 private:
@@ -37,23 +51,47 @@ private:
     GLsizei                             mStride;
     GLfloat                             mGenericValue[4];
     bool                                mEnabled;
+    /// instances that share an element of the array, or 0 for an array read per vertex
+    GLuint                              mDivisor;
 
     uintptr_t                           mOffset;
     uintptr_t                           mPtr;
     BufferObject                       *mInternalVbo;
     BufferObject                       *mExternalVbo;
+    /// client data streamed into the ring for the current draw, when there is no internal vbo
+    VkBuffer                            mStreamVkBuffer;
+    VkDeviceSize                        mStreamOffset;
+    /// ring epoch the generic value was streamed in, or 0 when the stream holds other data
+    uint64_t                            mGenericValueEpoch;
     bool                                mInternalVBOStatus;
     CacheManager                       *mCacheManager;
 
+    vertexConversion_t                  mConversion;
+    /// format and stride the converted data are fetched with, other than for GL_FIXED which keeps its layout
+    VkFormat                            mConvertedFormat;
+    uint32_t                            mConvertedStride;
+    /// converted copy of a server-side vbo, kept until the source contents or the layout change
+    BufferObject                       *mConvertedVbo;
+    uint64_t                            mConvertedSourceVersion;
+    uintptr_t                           mConvertedSourceOffset;
+    GLsizei                             mConvertedSourceStride;
+    GLint                               mConvertedSourceElements;
+    GLenum                              mConvertedSourceType;
+    GLboolean                           mConvertedSourceNormalized;
+
+    void                                SelectConversion(void);
+    void                                ConvertVertices(const uint8_t *srcData, size_t srcStride, size_t numVertices, uint8_t *dstData) const;
+
 public:
     GenericVertexAttribute();
     ~GenericVertexAttribute();
 
     void                                ConvertFixedBufferToFloat(BufferObject* vbo, size_t byteSize, void *srcData, size_t numVertices);
-    BufferObject                       *UpdateVertexAttribute(uint32_t numVertices, bool &updatedVBO);
-    BufferObject                       *UpdateGenericValueVBO(bool &updatedVBO);
-    BufferObject                       *GenerateUserSpaceVBO(uint32_t numVertices, bool &updatedVBO);
-    BufferObject                       *AttachDeviceSpaceVBO(uint32_t numVertices, bool &updatedVBO);
+    BufferObject                       *ConvertDeviceSpaceVBO(BufferObject *vbo, bool &updatedVBO);
+    BufferObject                       *UpdateVertexAttribute(uint32_t firstVertex, uint32_t numVertices, vulkanAPI::RingBuffer *streamRing, bool &updatedVBO);
+    BufferObject                       *UpdateGenericValueVBO(vulkanAPI::RingBuffer *streamRing, bool &updatedVBO);
+    BufferObject                       *GenerateUserSpaceVBO(uint32_t firstVertex, uint32_t numVertices, vulkanAPI::RingBuffer *streamRing, bool &updatedVBO);
+    BufferObject                       *AttachDeviceSpaceVBO(bool &updatedVBO);
 
     // Release Functions
     void                                Release(void);
@@ -64,12 +102,23 @@ public:
     inline GLenum                       GetType(void)                     const { FUN_ENTRY(GL_LOG_TRACE); return mType;       }
     inline GLboolean                    GetNormalized(void)               const { FUN_ENTRY(GL_LOG_TRACE); return mNormalized; }
     inline GLsizei                      GetStride(void)                   const { FUN_ENTRY(GL_LOG_TRACE); return mStride;     }
+    inline GLuint                       GetDivisor(void)                  const { FUN_ENTRY(GL_LOG_TRACE); return mDivisor;    }
     inline uint32_t                     GetOffset(void)                   const { FUN_ENTRY(GL_LOG_TRACE); return
                                                                                                 static_cast<uint32_t>(mOffset);}
     inline uintptr_t                    GetPointer(void)                  const { FUN_ENTRY(GL_LOG_TRACE); return mPtr;        }
     inline const BufferObject *         GetExternalVbo(void)              const { FUN_ENTRY(GL_LOG_TRACE); return mExternalVbo;}
+    inline BufferObject *               GetExternalVbo(void)                    { FUN_ENTRY(GL_LOG_TRACE); return mExternalVbo;}
+    inline VkBuffer                     GetStreamVkBuffer(void)           const { FUN_ENTRY(GL_LOG_TRACE); return mStreamVkBuffer; }
+    inline VkDeviceSize                 GetStreamOffset(void)             const { FUN_ENTRY(GL_LOG_TRACE); return mStreamOffset;   }
 
-    inline VkFormat                     GetVkFormat(void)                 const { FUN_ENTRY(GL_LOG_TRACE); return GlAttribPointerToVkFormat(mElements, mType, mNormalized); }
+    inline VkFormat                     GetVkFormat(void)                 const { FUN_ENTRY(GL_LOG_TRACE); return mConversion > VERTEX_CONVERSION_FIXED ? mConvertedFormat :
+                                                                                                GlAttribPointerToVkFormat(mElements, mType, mNormalized); }
+    /// stride and offset of the data in the buffer bound for the attribute, which a conversion packs from the start
+    inline uint32_t                     GetBindingStride(void)            const { FUN_ENTRY(GL_LOG_TRACE); return mConversion > VERTEX_CONVERSION_FIXED ? mConvertedStride :
+                                                                                                static_cast<uint32_t>(mStride); }
+    inline uint32_t                     GetBindingOffset(void)            const { FUN_ENTRY(GL_LOG_TRACE); return mConversion > VERTEX_CONVERSION_FIXED ? 0 :
+                                                                                                static_cast<uint32_t>(mOffset); }
+    inline bool                         IsConverted(void)                 const { FUN_ENTRY(GL_LOG_TRACE); return mConversion != VERTEX_CONVERSION_NONE; }
     inline bool                         IsInternalVBO(void)        const { FUN_ENTRY(GL_LOG_TRACE); return mInternalVBOStatus;}
     inline void                         GetGenericValue(GLint *ptr)       const { FUN_ENTRY(GL_LOG_TRACE); ptr[0] = static_cast<GLint>(mGenericValue[0]);
                                                                                                            ptr[1] = static_cast<GLint>(mGenericValue[1]);
@@ -89,6 +138,7 @@ public:
     inline void                         SetType(GLenum type)                        { FUN_ENTRY(GL_LOG_TRACE); mType            = type;        }
     inline void                         SetNormalized(GLboolean normalized)         { FUN_ENTRY(GL_LOG_TRACE); mNormalized      = normalized;  }
     inline void                         SetStride(GLsizei stride)                   { FUN_ENTRY(GL_LOG_TRACE); mStride          = stride;      }
+    inline void                         SetDivisor(GLuint divisor)                  { FUN_ENTRY(GL_LOG_TRACE); mDivisor         = divisor;     }
     inline void                         SetOffset(uintptr_t offset)                 { FUN_ENTRY(GL_LOG_TRACE); mOffset          = offset;      }
     inline void                         SetPointer(uintptr_t ptr)                   { FUN_ENTRY(GL_LOG_TRACE); mPtr             = ptr;         }
     inline void                         SetInternalVBOStatus(bool internalVBO)      { FUN_ENTRY(GL_LOG_TRACE); mInternalVBOStatus     = internalVBO; }
@@ -96,7 +146,8 @@ public:
     inline void                         SetGenericValue(const GLfloat *ptr)         { FUN_ENTRY(GL_LOG_TRACE); mGenericValue[0] = ptr[0];
                                                                                                                mGenericValue[1] = ptr[1];
                                                                                                                mGenericValue[2] = ptr[2];
-                                                                                                               mGenericValue[3] = ptr[3]; }
+                                                                                                               mGenericValue[3] = ptr[3];
+                                                                                                               mGenericValueEpoch = 0; }
 };
 
 #endif // __GENERICVERTEXATTRIBUTE_H__
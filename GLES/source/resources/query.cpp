@@ -0,0 +1,61 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       query.cpp
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Timer and Occlusion Query Object Functionality in GLOVE
+ *
+ *  A query object of GL_EXT_disjoint_timer_query keeps the tickets of the
+ *  GPU timestamps written for it, and its result once they are resolved.
+ *  A GL_TIMESTAMP_EXT query has an end ticket only.
+ */
+
+#include "query.h"
+
+Query::Query()
+: mTarget(0), mBeginTicket(0), mEndTicket(0), mOcclusionUncounted(false), mResult(0), mResultAvailable(false)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+}
+
+Query::~Query()
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+}
+
+void
+Query::Begin(GLenum target, uint64_t beginTicket)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    mTarget          = target;
+    mBeginTicket     = beginTicket;
+    mEndTicket       = 0;
+    mOcclusionTickets.clear();
+    mOcclusionUncounted = false;
+    mResult          = 0;
+    mResultAvailable = false;
+}
+
+void
+Query::SetResult(GLuint64 result)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    mResult          = result;
+    mResultAvailable = true;
+}
@@ -0,0 +1,68 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       query.h
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Timer and Occlusion Query Object Functionality in GLOVE
+ *
+ */
+
+#ifndef __QUERY_H__
+#define __QUERY_H__
+
+#include "GLES2/gl2.h"
+#include "GLES2/gl2ext.h"
+#include "utils/glLogger.h"
+#include <vector>
+
+class Query {
+private:
+    /// GL_TIME_ELAPSED_EXT, GL_TIMESTAMP_EXT or one of the occlusion targets, 0 until the query is first begun or counted
+    GLenum                                      mTarget;
+    /// tickets of the timestamps in the pool of the command buffers, 0 for none
+    uint64_t                                    mBeginTicket;
+    uint64_t                                    mEndTicket;
+    /// tickets of the occlusion queries in the pool of the command buffers, one per render pass the query drew in
+    std::vector<uint64_t>                       mOcclusionTickets;
+    /// draws were not counted for lack of occlusion queries, so samples are assumed to have passed
+    bool                                        mOcclusionUncounted;
+    GLuint64                                    mResult;
+    bool                                        mResultAvailable;
+
+public:
+    Query();
+    ~Query();
+
+// Get Functions
+    inline GLenum                               GetTarget(void)                     const { FUN_ENTRY(GL_LOG_TRACE); return mTarget; }
+    inline uint64_t                             GetBeginTicket(void)                const { FUN_ENTRY(GL_LOG_TRACE); return mBeginTicket; }
+    inline uint64_t                             GetEndTicket(void)                  const { FUN_ENTRY(GL_LOG_TRACE); return mEndTicket; }
+    inline const std::vector<uint64_t>         &GetOcclusionTickets(void)           const { FUN_ENTRY(GL_LOG_TRACE); return mOcclusionTickets; }
+    inline bool                                 IsOcclusionUncounted(void)          const { FUN_ENTRY(GL_LOG_TRACE); return mOcclusionUncounted; }
+    inline GLuint64                             GetResult(void)                     const { FUN_ENTRY(GL_LOG_TRACE); return mResult; }
+    inline bool                                 IsResultAvailable(void)             const { FUN_ENTRY(GL_LOG_TRACE); return mResultAvailable; }
+
+// Set Functions
+    /// starts a new result, the tickets of the previous one are released by the caller
+           void                                 Begin(GLenum target, uint64_t beginTicket);
+    inline void                                 SetEndTicket(uint64_t ticket)             { FUN_ENTRY(GL_LOG_TRACE); mEndTicket = ticket; }
+    inline void                                 AddOcclusionTicket(uint64_t ticket)       { FUN_ENTRY(GL_LOG_TRACE); mOcclusionTickets.push_back(ticket); }
+    inline void                                 SetOcclusionUncounted(void)               { FUN_ENTRY(GL_LOG_TRACE); mOcclusionUncounted = true; }
+           void                                 SetResult(GLuint64 result);
+};
+
+#endif // __QUERY_H__
@@ -29,6 +29,7 @@
 
 #include "rect.h"
 #include "utils/glLogger.h"
+#include "utils/pixelUtils.h"
 
 Rect::Rect(int _x, int _y, int _width, int _height)
 : x(_x), y(_y), width(_width), height(_height)
@@ -42,19 +43,19 @@ Rect::~Rect()
 }
 
 ImageRect::ImageRect()
-: Rect(0, 0, 0, 0), mNumElements(1), mSizeElement(1), mAlignment(1)
+: Rect(0, 0, 0, 0), mNumElements(1), mSizeElement(1), mAlignment(1), mRowLength(0)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 }
 
 ImageRect::ImageRect(const Rect& rect, int numElements, int sizeElement, int alignment)
-: Rect(rect.x, rect.y, rect.width, rect.height), mNumElements(numElements), mSizeElement(sizeElement), mAlignment(alignment)
+: Rect(rect.x, rect.y, rect.width, rect.height), mNumElements(numElements), mSizeElement(sizeElement), mAlignment(alignment), mRowLength(0)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 }
 
 ImageRect::ImageRect(int _x, int _y, int _width, int _height, int numElements, int sizeElement, int alignment)
-: Rect(_x, _y, _width, _height), mNumElements(numElements), mSizeElement(sizeElement), mAlignment(alignment)
+: Rect(_x, _y, _width, _height), mNumElements(numElements), mSizeElement(sizeElement), mAlignment(alignment), mRowLength(0)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 }
@@ -126,7 +127,8 @@ CopyPixelsConvert(
             const ImageRect* dstRect,
             void* dstData,
             Color (*SrcColorFunPtr)(const uint8_t*),
-            void (*DstColorFunPtr)(Color&, uint8_t*))
+            void (*DstColorFunPtr)(Color&, uint8_t*),
+            bool invertY)
 {
 
     // size of an entire row in bytes
@@ -141,6 +143,12 @@ CopyPixelsConvert(
     const uint8_t* srcPtr = static_cast<const uint8_t*>(srcData) + srcCurrentRowIndex;
     uint8_t* dstPtr = static_cast<uint8_t*>(dstData) + dstCurrentRowIndex;
 
+    // inverted rows are written from the last one up
+    const ptrdiff_t dstRowStep = invertY ? -static_cast<ptrdiff_t>(dstRowStride) : static_cast<ptrdiff_t>(dstRowStride);
+    if(invertY) {
+        dstPtr += (srcRect->height - 1) * dstRowStride;
+    }
+
     // perform the conversion
     for(int row = 0; row < srcRect->height; ++row) {
         for(int col = 0; col < srcRect->width; ++col) {
@@ -150,7 +158,40 @@ CopyPixelsConvert(
             DstColorFunPtr(color, &dstPtr[dstIndex]);
         }
         // offset by the number of bytes per row
-        dstPtr = dstPtr + dstRowStride;
+        dstPtr = dstPtr + dstRowStep;
+        srcPtr = srcPtr + srcRowStride;
+    }
+}
+
+// converts and copies pixels between two buffers a row at a time
+// with a converter dedicated to the pair of formats
+static void
+CopyPixelsConvertRows(
+            const ImageRect* srcRect,
+            const void* srcData,
+            const ImageRect* dstRect,
+            void* dstData,
+            PixelRowConvertFunc ConvertRowFunPtr,
+            bool invertY)
+{
+    // size of an entire row in bytes
+    const uint32_t srcRowStride = srcRect->GetRectAlignedRowInBytes();
+    const uint32_t dstRowStride = dstRect->GetRectAlignedRowInBytes();
+
+    // obtain ptr locations with the byte offset
+    const uint8_t* srcPtr = static_cast<const uint8_t*>(srcData) + srcRect->GetStartRowIndex(srcRowStride);
+    uint8_t* dstPtr = static_cast<uint8_t*>(dstData) + dstRect->GetStartRowIndex(dstRowStride);
+
+    // inverted rows are written from the last one up
+    const ptrdiff_t dstRowStep = invertY ? -static_cast<ptrdiff_t>(dstRowStride) : static_cast<ptrdiff_t>(dstRowStride);
+    if(invertY) {
+        dstPtr += (srcRect->height - 1) * dstRowStride;
+    }
+
+    for(int row = 0; row < srcRect->height; ++row) {
+        ConvertRowFunPtr(srcPtr, dstPtr, srcRect->width);
+        // offset by the number of bytes per row
+        dstPtr = dstPtr + dstRowStep;
         srcPtr = srcPtr + srcRowStride;
     }
 }
@@ -162,7 +203,8 @@ CopyPixelsNoConversion(
             const ImageRect* srcRect,
             const void* srcData,
             const ImageRect* dstRect,
-            void* dstData)
+            void* dstData,
+            bool invertY)
 {
     assert(srcRect->mNumElements == dstRect->mNumElements);
 
@@ -182,12 +224,18 @@ CopyPixelsNoConversion(
     // (i.e., without any padding applied)
     const uint32_t dataRowSize = srcRect->GetDataRowSize();
 
+    // inverted rows are written from the last one up
+    const ptrdiff_t dstRowStep = invertY ? -static_cast<ptrdiff_t>(dstRowStride) : static_cast<ptrdiff_t>(dstRowStride);
+    if(invertY) {
+        dstPtr += (srcRect->height - 1) * dstRowStride;
+    }
+
     // copy each row separately
     for(int row = 0; row < srcRect->height; ++row) {
         memcpy(static_cast<void*>(dstPtr), static_cast<const void*>(srcPtr), dataRowSize);
         // offset by the number of bytes per row
         srcPtr += srcRowStride;
-        dstPtr += dstRowStride;
+        dstPtr += dstRowStep;
     }
 }
 
@@ -197,34 +245,43 @@ ConvertPixels(GLenum srcFormat, GLenum dstFormat,
               ImageRect* srcRect,
               const void* srcData,
               ImageRect* dstRect,
-              void* dstData)
+              void* dstData,
+              bool invertY)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    // the common pairs have dedicated converters, the rest go through Color one pixel at a time
+    const PixelRowConverter *converter = FindPixelRowConverter(srcFormat, dstFormat);
+    if(converter && converter->srcPixelSize == srcRect->GetPixelByteOffset() &&
+                    converter->dstPixelSize == dstRect->GetPixelByteOffset()) {
+        CopyPixelsConvertRows(srcRect, srcData, dstRect, dstData, converter->convert, invertY);
+        return;
+    }
+
     switch(srcFormat) {
     case GL_BGRA8_EXT:
     case GL_BGRA_EXT:
         switch(dstFormat) {
         case GL_BGRA8_EXT:
         case GL_BGRA_EXT:
-            CopyPixelsNoConversion(srcRect, srcData, dstRect, dstData);
+            CopyPixelsNoConversion(srcRect, srcData, dstRect, dstData, invertY);
             break;
         case GL_RGBA:
         case GL_RGBA8_OES:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromBGRA, &Color::ConvertToRGBA);
+            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromBGRA, &Color::ConvertToRGBA, invertY);
             break;
         case GL_LUMINANCE_ALPHA:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromBGRA, &Color::ConvertToLuminanceAlpha);
+            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromBGRA, &Color::ConvertToLuminanceAlpha, invertY);
             break;
         case GL_LUMINANCE:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromBGRA, &Color::ConvertToLuminance);
+            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromBGRA, &Color::ConvertToLuminance, invertY);
             break;
         case GL_ALPHA:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromBGRA, &Color::ConvertToAlpha);
+            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromBGRA, &Color::ConvertToAlpha, invertY);
             break;
         case GL_RGB:
         case GL_RGB8_OES:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromBGRA, &Color::ConvertToRGB);
+            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromBGRA, &Color::ConvertToRGB, invertY);
             break;
 
         default: NOT_FOUND_ENUM(dstFormat); break;
@@ -235,14 +292,14 @@ ConvertPixels(GLenum srcFormat, GLenum dstFormat,
         switch(dstFormat) {
         case GL_RGBA:
         case GL_RGBA8_OES:
-            CopyPixelsNoConversion(srcRect, srcData, dstRect, dstData);
+            CopyPixelsNoConversion(srcRect, srcData, dstRect, dstData, invertY);
             break;
         case GL_RGB:
         case GL_RGB8_OES:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromRGBA, &Color::ConvertToRGB);
+            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromRGBA, &Color::ConvertToRGB, invertY);
             break;
         case GL_ALPHA:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromRGBA, &Color::ConvertToAlpha);
+            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromRGBA, &Color::ConvertToAlpha, invertY);
             break;
 
         default: NOT_FOUND_ENUM(dstFormat); break;
@@ -254,10 +311,10 @@ ConvertPixels(GLenum srcFormat, GLenum dstFormat,
         switch(dstFormat) {
         case GL_RGB:
         case GL_RGB8_OES:
-            CopyPixelsNoConversion(srcRect, srcData, dstRect, dstData);
+            CopyPixelsNoConversion(srcRect, srcData, dstRect, dstData, invertY);
             break;
         case GL_RGBA8_OES:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromRGB, &Color::ConvertToRGBA);
+            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromRGB, &Color::ConvertToRGBA, invertY);
             break;
         default: NOT_FOUND_ENUM(dstFormat); break;
         }
@@ -266,14 +323,14 @@ ConvertPixels(GLenum srcFormat, GLenum dstFormat,
     case GL_LUMINANCE_ALPHA: {
         switch(dstFormat) {
         case GL_LUMINANCE_ALPHA:
-            CopyPixelsNoConversion(srcRect, srcData, dstRect, dstData);
+            CopyPixelsNoConversion(srcRect, srcData, dstRect, dstData, invertY);
             break;
         case GL_LUMINANCE:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromLuminanceAlpha, &Color::ConvertToLuminance);
+            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromLuminanceAlpha, &Color::ConvertToLuminance, invertY);
             break;
         case GL_RGBA:
         case GL_RGBA8_OES:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromLuminanceAlpha, &Color::ConvertToRGBA);
+            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromLuminanceAlpha, &Color::ConvertToRGBA, invertY);
             break;
         default: NOT_FOUND_ENUM(dstFormat); break;
         }
@@ -282,14 +339,14 @@ ConvertPixels(GLenum srcFormat, GLenum dstFormat,
     case GL_LUMINANCE: {
         switch(dstFormat) {
         case GL_LUMINANCE:
-            CopyPixelsNoConversion(srcRect, srcData, dstRect, dstData);
+            CopyPixelsNoConversion(srcRect, srcData, dstRect, dstData, invertY);
             break;
         case GL_LUMINANCE_ALPHA:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromLuminance, &Color::ConvertToLuminanceAlpha);
+            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromLuminance, &Color::ConvertToLuminanceAlpha, invertY);
             break;
         case GL_RGBA:
         case GL_RGBA8_OES:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromLuminance, &Color::ConvertToRGBA);
+            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromLuminance, &Color::ConvertToRGBA, invertY);
             break;
         default: NOT_FOUND_ENUM(dstFormat); break;
         }
@@ -298,11 +355,11 @@ ConvertPixels(GLenum srcFormat, GLenum dstFormat,
     case GL_ALPHA: {
         switch(dstFormat) {
         case GL_ALPHA:
-            CopyPixelsNoConversion(srcRect, srcData, dstRect, dstData);
+            CopyPixelsNoConversion(srcRect, srcData, dstRect, dstData, invertY);
             break;
         case GL_RGBA:
         case GL_RGBA8_OES:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromAlpha, &Color::ConvertToRGBA);
+            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromAlpha, &Color::ConvertToRGBA, invertY);
             break;
         default: NOT_FOUND_ENUM(dstFormat); break;
         }
@@ -311,11 +368,11 @@ ConvertPixels(GLenum srcFormat, GLenum dstFormat,
     case GL_RGBA4:
         switch(dstFormat) {
         case GL_RGBA4:
-            CopyPixelsNoConversion(srcRect, srcData, dstRect, dstData);
+            CopyPixelsNoConversion(srcRect, srcData, dstRect, dstData, invertY);
             break;
         case GL_RGBA:
         case GL_RGBA8_OES:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::From4444, &Color::ConvertToRGBA);
+            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::From4444, &Color::ConvertToRGBA, invertY);
             break;
         default: NOT_FOUND_ENUM(dstFormat); break;
         }
@@ -324,11 +381,11 @@ ConvertPixels(GLenum srcFormat, GLenum dstFormat,
     case GL_RGB5_A1:
         switch(dstFormat) {
         case GL_RGB5_A1:
-            CopyPixelsNoConversion(srcRect, srcData, dstRect, dstData);
+            CopyPixelsNoConversion(srcRect, srcData, dstRect, dstData, invertY);
             break;
         case GL_RGBA:
         case GL_RGBA8_OES:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::From5551, &Color::ConvertToRGBA);
+            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::From5551, &Color::ConvertToRGBA, invertY);
             break;
         default: NOT_FOUND_ENUM(dstFormat); break;
         }
@@ -337,15 +394,15 @@ ConvertPixels(GLenum srcFormat, GLenum dstFormat,
     case GL_RGB565:
         switch(dstFormat) {
         case GL_RGB565:
-            CopyPixelsNoConversion(srcRect, srcData, dstRect, dstData);
+            CopyPixelsNoConversion(srcRect, srcData, dstRect, dstData, invertY);
             break;
         case GL_RGBA:
         case GL_RGB8_OES:
         case GL_RGBA8_OES:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::From565, &Color::ConvertToRGBA);
+            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::From565, &Color::ConvertToRGBA, invertY);
             break;
         case GL_LUMINANCE:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::From565, &Color::ConvertToLuminance);
+            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::From565, &Color::ConvertToLuminance, invertY);
             break;
         default: NOT_FOUND_ENUM(dstFormat); break;
         }
@@ -356,7 +413,7 @@ ConvertPixels(GLenum srcFormat, GLenum dstFormat,
         switch(dstFormat) {
         case GL_UNSIGNED_INT_24_8_OES:
         case GL_DEPTH24_STENCIL8_OES:
-            CopyPixelsNoConversion(srcRect, srcData, dstRect, dstData);
+            CopyPixelsNoConversion(srcRect, srcData, dstRect, dstData, invertY);
             break;
         default: NOT_FOUND_ENUM(dstFormat); break;
         }
@@ -365,7 +422,7 @@ ConvertPixels(GLenum srcFormat, GLenum dstFormat,
     case GL_STENCIL_INDEX8_OES:
        switch(dstFormat) {
        case GL_STENCIL_INDEX8_OES:
-           CopyPixelsNoConversion(srcRect, srcData, dstRect, dstData);
+           CopyPixelsNoConversion(srcRect, srcData, dstRect, dstData, invertY);
            break;
        default: NOT_FOUND_ENUM(dstFormat); break;
        }
@@ -56,6 +56,8 @@ public:
     int   mNumElements;
     int   mSizeElement;
     int   mAlignment;
+    /// pixels per row of the buffer, when these are more than the width of the rectangle
+    int   mRowLength;
 
     ImageRect();
     ImageRect(const Rect& rect, int numElements, int sizeElement, int alignment);
@@ -64,7 +66,7 @@ public:
 
 // Get Functions
     inline unsigned int GetRectBufferSize(void)                           const { return GetRectAlignedRowInBytes() * height;}
-    inline unsigned int GetRectAlignedRowInBytes(void)                    const { return GetRowInBytes(width); }
+    inline unsigned int GetRectAlignedRowInBytes(void)                    const { return GetRowInBytes(mRowLength ? mRowLength : width); }
     inline unsigned int GetDataRowSize(void)                              const { return width * mNumElements * mSizeElement; }
     inline unsigned int GetStartRowIndex(unsigned int rowStride)          const { return (x * mNumElements * mSizeElement) + (y * rowStride); }
     inline unsigned int GetPixelByteOffset(void)                          const { return mNumElements * mSizeElement; }
@@ -77,18 +79,21 @@ void                    CopyPixelsNoConversion(
                         const ImageRect* srcRect,
                         const void* srcData,
                         const ImageRect* dstRect,
-                        void* dstData);
+                        void* dstData,
+                        bool invertY = false);
 void                    CopyPixelsConvert(
                         const ImageRect* srcRect,
                         const void* srcData,
                         const ImageRect* dstRect,
                         void* dstData,
                         Color (*SrcColorFunPtr)(const uint8_t*),
-                                          void (*DstColorFunPtr)(struct Color&, uint8_t*));
+                                          void (*DstColorFunPtr)(struct Color&, uint8_t*),
+                        bool invertY = false);
 void                    ConvertPixels(GLenum srcFormat , GLenum dstFormat,
                         ImageRect* srcRect,
                         const void* srcData,
                         ImageRect* dstRect,
-                        void* dstData);
+                        void* dstData,
+                        bool invertY = false);
 
 #endif // __RECT_H__
@@ -25,8 +25,10 @@
 #define __REFOBJECT_H_
 
 #include "utils/glLogger.h"
+#include "utils/objectPool.h"
 
-class refObject {
+/// GL objects and the buffer objects made for draws are created and deleted often, they come from the object pool
+class refObject : public PooledObject {
 private:
     int   refCount;
     int   markForDeletion;
@@ -32,7 +32,7 @@
 
 Renderbuffer::Renderbuffer(const vulkanAPI::vkContext_t *vkContext)
 : mVkContext(vkContext),
-mInternalFormat(GL_RGBA4), mTarget(GL_INVALID_VALUE), mTexture(nullptr)
+mInternalFormat(GL_RGBA4), mTarget(GL_INVALID_VALUE), mSamples(0), mTexture(nullptr)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 }
@@ -66,13 +66,16 @@ Renderbuffer::InitTexture(void)
 }
 
 bool
-Renderbuffer::Allocate(GLint width, GLint height, GLenum internalformat)
+Renderbuffer::Allocate(GLint width, GLint height, GLenum internalformat, GLsizei samples)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
     mDims.width     = width;
     mDims.height    = height;
     mInternalFormat = internalformat;
+    mSamples        = samples;
+    // the samples take part in the completeness of the FBOs it is attached to
+    Texture::UpdateStorageGeneration();
 
     mTexture->SetTarget(GL_TEXTURE_2D);
 
@@ -80,12 +83,13 @@ Renderbuffer::Allocate(GLint width, GLint height, GLenum internalformat)
 
     if(GlFormatIsColorRenderable(mInternalFormat)) {
         mTexture->SetVkFormat(vkformat);
-        mTexture->SetVkImageUsage(static_cast<VkImageUsageFlagBits>(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT));
+        mTexture->SetVkImageUsage(static_cast<VkImageUsageFlagBits>(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT |
+                                                                    VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT));
     } else {
         // convert to supported format
         vkformat = FindSupportedDepthStencilFormat(mVkContext->vkGpus[0], GetVkFormatDepthBits(vkformat), GetVkFormatStencilBits(vkformat));
         mTexture->SetVkFormat(vkformat);
-        mTexture->SetVkImageUsage(static_cast<VkImageUsageFlagBits>(VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT));
+        mTexture->SetVkImageUsage(static_cast<VkImageUsageFlagBits>(VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT));
     }
     mTexture->SetVkImageTarget(vulkanAPI::Image::VK_IMAGE_TARGET_2D);
     mTexture->SetVkImageTiling();
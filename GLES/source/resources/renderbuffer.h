@@ -35,6 +35,8 @@ private:
     Rect                             mDims;
     GLenum                           mInternalFormat;
     GLenum                           mTarget;
+    /// samples rendered per pixel, 0 when single sampled. The texture holds the resolved contents
+    GLsizei                          mSamples;
     Texture *                        mTexture;
 
 public:
@@ -42,7 +44,7 @@ public:
     ~Renderbuffer();
 
 // Allocate Functions
-           bool        Allocate(GLint width, GLint height, GLenum internalformat);
+           bool        Allocate(GLint width, GLint height, GLenum internalformat, GLsizei samples = 0);
 
 // Release Functions
            void        Release(void);
@@ -52,6 +54,7 @@ public:
     inline int32_t     GetHeight(void)                                    const { FUN_ENTRY(GL_LOG_TRACE); return mDims.height;    }
     inline GLenum      GetTarget(void)                                    const { FUN_ENTRY(GL_LOG_TRACE); return mTarget;         }
     inline GLenum      GetInternalFormat(void)                            const { FUN_ENTRY(GL_LOG_TRACE); return mInternalFormat; }
+    inline GLsizei     GetSamples(void)                                   const { FUN_ENTRY(GL_LOG_TRACE); return mSamples;        }
     inline Texture *   GetTexture(void)                                   const { FUN_ENTRY(GL_LOG_TRACE); return mTexture;        }
 
 // Set Functions
@@ -23,23 +23,39 @@
  *
  *  OpenGL ES allows developers to allocate, edit and delete a variety of
  *  resources. These include Generic Vertex Attributes, Buffers, Renderbuffers,
- *  Framebuffers, Textures, Shaders, and Shader Programs.
+ *  Framebuffers, Textures, Shaders, and Shader Programs. All but the
+ *  framebuffers and vertex arrays belong to the share group of the context.
  */
 
 #include "resourceManager.h"
+#include <algorithm>
 
-ResourceManager::ResourceManager(const vulkanAPI::vkContext_t *vkContext):
+ResourceManager::ResourceManager(const vulkanAPI::vkContext_t *vkContext, ShareGroup *shareGroup):
     mVkContext(vkContext),
-    mShadingObjectCount(1),
-    mGenericVertexAttributes(GLOVE_MAX_VERTEX_ATTRIBS)
+    mShareGroup(shareGroup ? shareGroup : new ShareGroup()),
+    mBuffers(mShareGroup->mBuffers),
+    mRenderbuffers(mShareGroup->mRenderbuffers),
+    mTextures(mShareGroup->mTextures),
+    mShadingObjectCount(mShareGroup->mShadingObjectCount),
+    mShadingObjectPool(mShareGroup->mShadingObjectPool),
+    mShaders(mShareGroup->mShaders),
+    mShaderPrograms(mShareGroup->mShaderPrograms),
+    mCacheManager(nullptr),
+    mPurgeListBufferObject(mShareGroup->mPurgeListBufferObject),
+    mPurgeListTexture(mShareGroup->mPurgeListTexture),
+    mPurgeListShaders(mShareGroup->mPurgeListShaders),
+    mPurgeListShaderPrograms(mShareGroup->mPurgeListShaderPrograms),
+    mPurgeListRenderbuffers(mShareGroup->mPurgeListRenderbuffers)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
+    mShareGroup->Attach();
+
     CreateDefaultTextures();
 
-    for(auto& gva : mGenericVertexAttributes) {
-        gva.SetVkContext(vkContext);
-    }
+    mDefaultVertexArray = new VertexArray();
+    mDefaultVertexArray->SetVkContext(vkContext);
+    mActiveVertexArray  = mDefaultVertexArray;
 }
 
 ResourceManager::~ResourceManager()
@@ -48,19 +64,39 @@ ResourceManager::~ResourceManager()
 
     delete mDefaultTexture2D;
     delete mDefaultTextureCubeMap;
+    delete mDefaultTexture3D;
+    delete mDefaultVertexArray;
 
-    for(auto& gva : mGenericVertexAttributes) {
-        gva.Release();
+    if(mShareGroup->Detach(mCacheManager)) {
+        delete mShareGroup;
     }
-    mGenericVertexAttributes.clear();
 }
 
 void
 ResourceManager::SetCacheManager(CacheManager *cacheManager)
 {
-    for(auto& gva : mGenericVertexAttributes) {
-        gva.SetCacheManager(cacheManager);
+    mCacheManager = cacheManager;
+    mDefaultVertexArray->SetCacheManager(cacheManager);
+    mShareGroup->AddCacheManager(cacheManager);
+}
+
+VertexArray *
+ResourceManager::GetVertexArray(GLuint index)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(!index) {
+        return mDefaultVertexArray;
     }
+
+    bool exists = mVertexArrays.ObjectExists(index);
+    VertexArray *vao = mVertexArrays.GetObject(index);
+    if(!exists) {
+        vao->SetVkContext(mVkContext);
+        vao->SetCacheManager(mCacheManager);
+    }
+
+    return vao;
 }
 
 void
@@ -83,6 +119,14 @@ ResourceManager::CreateDefaultTextures()
     mDefaultTextureCubeMap->SetVkImageTarget(vulkanAPI::Image::VK_IMAGE_TARGET_CUBE);
     mDefaultTextureCubeMap->SetVkImageTiling();
     mDefaultTextureCubeMap->InitState();
+
+    mDefaultTexture3D = new Texture(mVkContext);
+    mDefaultTexture3D->SetTarget(GL_TEXTURE_3D_OES);
+    mDefaultTexture3D->SetVkFormat(VK_FORMAT_R8G8B8A8_UNORM);
+    mDefaultTexture3D->SetVkImageUsage(static_cast<VkImageUsageFlagBits>(VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT));
+    mDefaultTexture3D->SetVkImageTarget(vulkanAPI::Image::VK_IMAGE_TARGET_3D);
+    mDefaultTexture3D->SetVkImageTiling();
+    mDefaultTexture3D->InitState();
 }
 
 
@@ -90,6 +134,7 @@ uint32_t
 ResourceManager::PushShadingObject(const ShadingNamespace_t& obj)
 {
     FUN_ENTRY(GL_LOG_TRACE);
+    SHARE_GROUP_LOCK();
     mShadingObjectPool[mShadingObjectCount] = obj;
     return mShadingObjectCount++;
 }
@@ -98,6 +143,7 @@ void
 ResourceManager::EraseShadingObject(uint32_t id)
 {
     FUN_ENTRY(GL_LOG_TRACE);
+    SHARE_GROUP_LOCK();
     mShadingObjectPool.erase(id);
 }
 
@@ -106,6 +152,8 @@ ResourceManager::IsShadingObject(GLuint index, shadingNamespaceType_t type) cons
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    SHARE_GROUP_LOCK();
+
     if(!index || index >= mShadingObjectCount || !ShadingObjectExists(index)) {
         return GL_FALSE;
     }
@@ -114,30 +162,38 @@ ResourceManager::IsShadingObject(GLuint index, shadingNamespaceType_t type) cons
     return (shadId.arrayIndex && shadId.type == type) ? GL_TRUE : GL_FALSE;
 }
 
-uint32_t
-ResourceManager::FindShaderID(const Shader *shader)
+void
+ResourceManager::DeallocateShader(Shader *shader)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    for(shadingPoolIDs_t::iterator it = mShadingObjectPool.begin(); it != mShadingObjectPool.end(); ++it) {
-        if(it->second.type == SHADER_ID && GetShaderID(shader) == it->second.arrayIndex) {
-            return it->first;
-        }
-    }
-    return 0;
+    SHARE_GROUP_LOCK();
+
+    uint32_t id = shader->GetShadingId();
+    mShaders.Deallocate(mShadingObjectPool[id].arrayIndex);
+    EraseShadingObject(id);
 }
 
-uint32_t
-ResourceManager::FindShaderProgramID(const ShaderProgram *program)
+void
+ResourceManager::DeallocateShaderProgram(ShaderProgram *program)
 {
-   FUN_ENTRY(GL_LOG_DEBUG);
+    FUN_ENTRY(GL_LOG_DEBUG);
 
-   for(shadingPoolIDs_t::iterator it = mShadingObjectPool.begin(); it != mShadingObjectPool.end(); ++it) {
-        if(it->second.type == SHADER_PROGRAM_ID && GetShaderProgramID(program) == it->second.arrayIndex) {
-            return it->first;
-        }
+    SHARE_GROUP_LOCK();
+
+    program->DetachShaders();
+
+    uint32_t id = program->GetShadingId();
+    mShaderPrograms.RemoveFromList(mShadingObjectPool[id].arrayIndex);
+    EraseShadingObject(id);
+
+    // draws recorded with the program may still be pending or in flight, so
+    // it is released once the submission of the active slot has completed
+    if(mCacheManager != nullptr) {
+        mCacheManager->CacheShaderProgram(program);
+    } else {
+        delete program;
     }
-    return 0;
 }
 
 
@@ -146,10 +202,7 @@ ResourceManager::UpdateFramebufferObjects(GLuint index, GLenum target)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    for(typename map<uint32_t, Framebuffer *>::const_iterator it =
-        mFramebuffers.GetObjects()->begin(); it != mFramebuffers.GetObjects()->end(); it++) {
-
-        Framebuffer *fb = it->second;
+    for(Framebuffer *fb : mFramebuffers.GetObjects()) {
         if((fb->GetColorAttachmentType()   == target && index == fb->GetColorAttachmentName()) ||
            (fb->GetDepthAttachmentType()   == target && index == fb->GetDepthAttachmentName()) ||
            (fb->GetStencilAttachmentType() == target && index == fb->GetStencilAttachmentName())) {
@@ -158,79 +211,77 @@ ResourceManager::UpdateFramebufferObjects(GLuint index, GLenum target)
     }
 }
 
-bool
-ResourceManager::IsTextureAttachedToFBO(const Texture *texture)
+uint32_t
+ResourceManager::DemoteColdTextures(uint64_t submissionId)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    for(typename map<uint32_t, Framebuffer *>::const_iterator it =
-        mFramebuffers.GetObjects()->begin(); it != mFramebuffers.GetObjects()->end(); it++) {
-
-        if(it->second->GetColorAttachmentType() == GL_TEXTURE && texture == it->second->GetColorAttachmentTexture()) {
-            return true;
-        }
+    if(!GLOVE_TEXTURE_RESIDENCY) {
+        return 0;
     }
 
-    return false;
-}
+    SHARE_GROUP_LOCK();
 
-void
-ResourceManager::CleanPurgeList()
-{
-    FUN_ENTRY(GL_LOG_DEBUG);
-
-    //Buffers
-    for (auto it = mPurgeListBufferObject.begin(); it != mPurgeListBufferObject.end(); ) {
-        if ((*it)->GetRefCount() == 0) {
-            delete *it;
-            it = mPurgeListBufferObject.erase(it);
-        } else {
-            ++it;
+    // textures sampled by a recorded bundle would leave it stale, they are kept as they are
+    std::vector<Texture *> coldTextures;
+    for(Texture *texture : mTextures.GetObjects()) {
+        if(submissionId >= texture->GetLastUsedSubmissionId() + GLOVE_TEXTURE_COLD_SUBMISSIONS && texture->IsDemotable() &&
+           !vulkanAPI::CommandBundle::IsReferenced(vulkanAPI::CommandBundle::GetHandleKey(texture->GetVkImageView()))) {
+            coldTextures.push_back(texture);
         }
     }
-    //Textures
-    for (auto it = mPurgeListTexture.begin(); it != mPurgeListTexture.end(); ) {
-        if ((*it)->GetRefCount() == 0) {
-            delete *it;
-            it = mPurgeListTexture.erase(it);
-        } else {
-            ++it;
+
+    std::sort(coldTextures.begin(), coldTextures.end(), [](const Texture *a, const Texture *b) {
+        return a->GetLastUsedSubmissionId() < b->GetLastUsedSubmissionId();
+    });
+
+    uint32_t demoted = 0;
+    for(Texture *texture : coldTextures) {
+        if(demoted == GLOVE_TEXTURE_DEMOTIONS_PER_TRIM) {
+            break;
         }
-    }
-    //Shader Programs
-    for (auto it = mPurgeListShaderPrograms.begin(); it != mPurgeListShaderPrograms.end();) {
-        ShaderProgram* shaderProgramPtr = *it;
-        if (shaderProgramPtr->FreeForDeletion()) {
-            shaderProgramPtr->DetachShaders();
-            uint32_t id = FindShaderProgramID(shaderProgramPtr);
-            EraseShadingObject(id);
-            DeallocateShaderProgram(shaderProgramPtr);
-            it = mPurgeListShaderPrograms.erase(it);
-        } else {
-            ++it;
+        if(texture->Demote(GLOVE_TEXTURE_DEMOTED_LEVELS)) {
+            ++demoted;
         }
     }
-    //Shaders
-    for (auto it = mPurgeListShaders.begin(); it != mPurgeListShaders.end();) {
-        Shader* shaderPtr = *it;
-        if (shaderPtr->FreeForDeletion()) {
-            uint32_t id = FindShaderID(shaderPtr);
-            EraseShadingObject(id);
-            DeallocateShader(shaderPtr);
-            it = mPurgeListShaders.erase(it);
+
+    return demoted;
+}
+
+/// releases the objects of a purge list that are no longer referenced, in a single pass
+template<typename OBJECT, typename RELEASE>
+static void
+SweepPurgeList(std::vector<OBJECT *> &purgeList, RELEASE release)
+{
+    size_t kept = 0;
+    for(size_t i = 0; i < purgeList.size(); ++i) {
+        if(purgeList[i]->FreeForDeletion()) {
+            release(purgeList[i]);
         } else {
-            ++it;
+            purgeList[kept++] = purgeList[i];
         }
     }
-    //Renderbuffer
-    for (auto it = mPurgeListRenderbuffers.begin(); it != mPurgeListRenderbuffers.end(); ) {
-        if ((*it)->GetRefCount() == 0) {
-            delete *it;
-            it = mPurgeListRenderbuffers.erase(it);
-        } else {
-            ++it;
-        }
+    purgeList.resize(kept);
+}
+
+void
+ResourceManager::CleanPurgeList()
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    SHARE_GROUP_LOCK();
+
+    if(mPurgeListBufferObject.empty() && mPurgeListTexture.empty() && mPurgeListShaderPrograms.empty() &&
+       mPurgeListShaders.empty() && mPurgeListRenderbuffers.empty()) {
+        return;
     }
+
+    SweepPurgeList(mPurgeListBufferObject,   [](BufferObject *object) { delete object; });
+    SweepPurgeList(mPurgeListTexture,        [](Texture *object)      { delete object; });
+    // programs go first, as they detach the shaders they hold
+    SweepPurgeList(mPurgeListShaderPrograms, [this](ShaderProgram *program) { DeallocateShaderProgram(program); });
+    SweepPurgeList(mPurgeListShaders,        [this](Shader *shader)         { DeallocateShader(shader); });
+    SweepPurgeList(mPurgeListRenderbuffers,  [](Renderbuffer *object) { delete object; });
 }
 
 void
@@ -238,10 +289,8 @@ ResourceManager::FramebufferCacheAttachement(Texture *texture, GLuint index)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    for(typename map<uint32_t, Framebuffer *>::const_iterator it =
-        mFramebuffers.GetObjects()->begin(); it != mFramebuffers.GetObjects()->end(); it++) {
-
-        it->second->CacheAttachement(texture, index);
+    for(Framebuffer *fb : mFramebuffers.GetObjects()) {
+        fb->CacheAttachement(texture, index);
     }
 }
 
@@ -250,9 +299,7 @@ ResourceManager::FramebufferCacheAttachement(Renderbuffer *renderbuffer, GLuint
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    for(typename map<uint32_t, Framebuffer *>::const_iterator it =
-        mFramebuffers.GetObjects()->begin(); it != mFramebuffers.GetObjects()->end(); it++) {
-
-        it->second->CacheAttachement(renderbuffer, index);
+    for(Framebuffer *fb : mFramebuffers.GetObjects()) {
+        fb->CacheAttachement(renderbuffer, index);
     }
 }
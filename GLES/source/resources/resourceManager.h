@@ -27,124 +27,176 @@
 #include "resources/bufferObject.h"
 #include "resources/framebuffer.h"
 #include "resources/shaderProgram.h"
+#include "resources/query.h"
 #include "resources/renderbuffer.h"
 #include "resources/shader.h"
+#include "resources/shareGroup.h"
 #include "resources/texture.h"
+#include "resources/vertexArray.h"
 #include "utils/cacheManager.h"
+#include "vulkan/commandBundle.h"
 
-typedef enum {
-    NO_ID,
-    SHADER_ID,
-    SHADER_PROGRAM_ID
-} shadingNamespaceType_t;
+/// takes the lock of the share group for the rest of the scope
+#define SHARE_GROUP_LOCK()  std::lock_guard<std::recursive_mutex> shareGroupLock(mShareGroup->GetMutex())
 
-typedef struct {
-    shadingNamespaceType_t                 type;
-    uint32_t                               arrayIndex;
-} ShadingNamespace_t;
+/// under memory pressure the textures left unsampled for a while give up their top levels
+#ifndef GLOVE_TEXTURE_RESIDENCY
+#define GLOVE_TEXTURE_RESIDENCY                         true
+#endif // GLOVE_TEXTURE_RESIDENCY
+
+/// submissions a texture has not been sampled for before it may be demoted
+#ifndef GLOVE_TEXTURE_COLD_SUBMISSIONS
+#define GLOVE_TEXTURE_COLD_SUBMISSIONS                  120
+#endif // GLOVE_TEXTURE_COLD_SUBMISSIONS
+
+/// levels dropped from a demoted texture, each one is three quarters of its memory
+#ifndef GLOVE_TEXTURE_DEMOTED_LEVELS
+#define GLOVE_TEXTURE_DEMOTED_LEVELS                    1
+#endif // GLOVE_TEXTURE_DEMOTED_LEVELS
+
+/// textures demoted at once, the coldest ones, so that a trim does not stall the frame for long
+#ifndef GLOVE_TEXTURE_DEMOTIONS_PER_TRIM
+#define GLOVE_TEXTURE_DEMOTIONS_PER_TRIM                16
+#endif // GLOVE_TEXTURE_DEMOTIONS_PER_TRIM
 
 class ResourceManager {
 private:
 
     const vulkanAPI::vkContext_t              *mVkContext;
-    typedef ObjectArray<Texture>               TextureArray;
-    typedef ObjectArray<BufferObject>          BufferArray;
-    typedef ObjectArray<Shader>                ShaderArray;
-    typedef ObjectArray<ShaderProgram>         ShaderProgramArray;
-    typedef ObjectArray<Renderbuffer>          RenderbufferArray;
+    typedef ShareGroup::TextureArray           TextureArray;
+    typedef ShareGroup::BufferArray            BufferArray;
+    typedef ShareGroup::ShaderArray            ShaderArray;
+    typedef ShareGroup::ShaderProgramArray     ShaderProgramArray;
+    typedef ShareGroup::RenderbufferArray      RenderbufferArray;
     typedef ObjectArray<Framebuffer>           FramebufferArray;
-    typedef map<uint32_t, ShadingNamespace_t>  shadingPoolIDs_t;
-
-    BufferArray                                mBuffers;
-    RenderbufferArray                          mRenderbuffers;
+    typedef ObjectArray<VertexArray>           VertexArrayArray;
+    typedef ObjectArray<Query>                 QueryArray;
+    typedef ObjectArray<vulkanAPI::CommandBundle> CommandBundleArray;
+    typedef ShareGroup::shadingPoolIDs_t       shadingPoolIDs_t;
+
+    /// textures, buffers, renderbuffers, shaders and programs, shared with the contexts of the group
+    ShareGroup                                *mShareGroup;
+    BufferArray                               &mBuffers;
+    RenderbufferArray                         &mRenderbuffers;
+    TextureArray                              &mTextures;
+
+    uint32_t                                  &mShadingObjectCount;
+    shadingPoolIDs_t                          &mShadingObjectPool;
+    ShaderArray                               &mShaders;
+    ShaderProgramArray                        &mShaderPrograms;
+
+    /// container objects are not shared
     FramebufferArray                           mFramebuffers;
-    TextureArray                               mTextures;
-
-    uint32_t                                   mShadingObjectCount;
-    shadingPoolIDs_t                           mShadingObjectPool;
-    ShaderArray                                mShaders;
-    ShaderProgramArray                         mShaderPrograms;
+    VertexArrayArray                           mVertexArrays;
+    QueryArray                                 mQueries;
+    CommandBundleArray                         mCommandBundles;
 
     Texture                                   *mDefaultTexture2D;
     Texture                                   *mDefaultTextureCubeMap;
-    std::vector<GenericVertexAttribute>        mGenericVertexAttributes;
-    std::vector<BufferObject*>                 mPurgeListBufferObject;
-    std::vector<Texture*>                      mPurgeListTexture;
-    std::vector<Shader*>                       mPurgeListShaders;
-    std::vector<ShaderProgram*>                mPurgeListShaderPrograms;
-    std::vector<Renderbuffer*>                 mPurgeListRenderbuffers;
+    Texture                                   *mDefaultTexture3D;
+    /// vertex array 0 holds the attributes while no vertex array object is bound
+    VertexArray                               *mDefaultVertexArray;
+    VertexArray                               *mActiveVertexArray;
+    CacheManager                              *mCacheManager;
+    std::vector<BufferObject*>                &mPurgeListBufferObject;
+    std::vector<Texture*>                     &mPurgeListTexture;
+    std::vector<Shader*>                      &mPurgeListShaders;
+    std::vector<ShaderProgram*>               &mPurgeListShaderPrograms;
+    std::vector<Renderbuffer*>                &mPurgeListRenderbuffers;
 
 public:
-    ResourceManager(const vulkanAPI::vkContext_t *vkContext);
+    /// joins the share group of a share_context, or starts a new one when shareGroup is null
+    ResourceManager(const vulkanAPI::vkContext_t *vkContext, ShareGroup *shareGroup);
     ~ResourceManager();
 
 // Allocate/Deallocate Functions
-    inline GLuint              AllocateTexture(void)                            { FUN_ENTRY(GL_LOG_TRACE); return mTextures.Allocate(); }
-    inline GLuint              AllocateBuffer(void)                             { FUN_ENTRY(GL_LOG_TRACE); return mBuffers.Allocate(); }
-    inline GLuint              AllocateRenderbuffer(void)                       { FUN_ENTRY(GL_LOG_TRACE); return mRenderbuffers.Allocate(); }
+    inline GLuint              AllocateTexture(void)                            { FUN_ENTRY(GL_LOG_TRACE); SHARE_GROUP_LOCK(); return mTextures.Allocate(); }
+    inline GLuint              AllocateBuffer(void)                             { FUN_ENTRY(GL_LOG_TRACE); SHARE_GROUP_LOCK(); return mBuffers.Allocate(); }
+    inline GLuint              AllocateRenderbuffer(void)                       { FUN_ENTRY(GL_LOG_TRACE); SHARE_GROUP_LOCK(); return mRenderbuffers.Allocate(); }
     inline GLuint              AllocateFramebuffer(void)                        { FUN_ENTRY(GL_LOG_TRACE); return mFramebuffers.Allocate(); }
-    inline GLuint              AllocateShader(void)                             { FUN_ENTRY(GL_LOG_TRACE); return mShaders.Allocate(); }
-    inline GLuint              AllocateShaderProgram(void)                      { FUN_ENTRY(GL_LOG_TRACE); return mShaderPrograms.Allocate(); }
-    inline void                DeallocateTexture(uint32_t index)                { FUN_ENTRY(GL_LOG_TRACE); mTextures.Deallocate(index); }
-    inline void                DeallocateBuffer(uint32_t index)                 { FUN_ENTRY(GL_LOG_TRACE); mBuffers.Deallocate(index); }
-    inline void                DeallocateRenderbuffer(uint32_t index)           { FUN_ENTRY(GL_LOG_TRACE); mRenderbuffers.Deallocate(index); }
+    inline GLuint              AllocateShader(void)                             { FUN_ENTRY(GL_LOG_TRACE); SHARE_GROUP_LOCK(); return mShaders.Allocate(); }
+    inline GLuint              AllocateShaderProgram(void)                      { FUN_ENTRY(GL_LOG_TRACE); SHARE_GROUP_LOCK(); return mShaderPrograms.Allocate(); }
+    inline GLuint              AllocateVertexArray(void)                        { FUN_ENTRY(GL_LOG_TRACE); return mVertexArrays.Allocate(); }
+    inline GLuint              AllocateQuery(void)                              { FUN_ENTRY(GL_LOG_TRACE); return mQueries.Allocate(); }
+    inline GLuint              AllocateCommandBundle(void)                      { FUN_ENTRY(GL_LOG_TRACE); return mCommandBundles.Allocate(); }
+    inline void                DeallocateTexture(uint32_t index)                { FUN_ENTRY(GL_LOG_TRACE); SHARE_GROUP_LOCK(); mTextures.Deallocate(index); }
+    inline void                DeallocateBuffer(uint32_t index)                 { FUN_ENTRY(GL_LOG_TRACE); SHARE_GROUP_LOCK(); mBuffers.Deallocate(index); }
+    inline void                DeallocateRenderbuffer(uint32_t index)           { FUN_ENTRY(GL_LOG_TRACE); SHARE_GROUP_LOCK(); mRenderbuffers.Deallocate(index); }
     inline void                DeallocateFramebuffer(uint32_t index)            { FUN_ENTRY(GL_LOG_TRACE); mFramebuffers.Deallocate(index); }
-    inline void                DeallocateShader(Shader *shader)                 { FUN_ENTRY(GL_LOG_TRACE); mShaders.Deallocate(mShaders.GetObjectId(shader)); }
-    inline void                DeallocateShaderProgram(ShaderProgram *program)  { FUN_ENTRY(GL_LOG_TRACE); mShaderPrograms.Deallocate(mShaderPrograms.GetObjectId(program)); }
-    inline void                RemoveFromListTexture(uint32_t index)            { FUN_ENTRY(GL_LOG_TRACE); mTextures.RemoveFromList(index); }
-    inline void                RemoveFromListBuffer(uint32_t index)             { FUN_ENTRY(GL_LOG_TRACE); mBuffers.RemoveFromList(index); }
-    inline void                RemoveFromListRenderbuffer(uint32_t index)       { FUN_ENTRY(GL_LOG_TRACE); mRenderbuffers.RemoveFromList(index); }
+           void                DeallocateShader(Shader *shader);
+           void                DeallocateShaderProgram(ShaderProgram *program);
+    inline void                DeallocateVertexArray(uint32_t index)            { FUN_ENTRY(GL_LOG_TRACE); mVertexArrays.Deallocate(index); }
+    inline void                DeallocateQuery(uint32_t index)                  { FUN_ENTRY(GL_LOG_TRACE); mQueries.Deallocate(index); }
+    inline void                DeallocateCommandBundle(uint32_t index)          { FUN_ENTRY(GL_LOG_TRACE); mCommandBundles.Deallocate(index); }
+    inline void                RemoveFromListTexture(uint32_t index)            { FUN_ENTRY(GL_LOG_TRACE); SHARE_GROUP_LOCK(); mTextures.RemoveFromList(index); }
+    inline void                RemoveFromListBuffer(uint32_t index)             { FUN_ENTRY(GL_LOG_TRACE); SHARE_GROUP_LOCK(); mBuffers.RemoveFromList(index); }
+    inline void                RemoveFromListRenderbuffer(uint32_t index)       { FUN_ENTRY(GL_LOG_TRACE); SHARE_GROUP_LOCK(); mRenderbuffers.RemoveFromList(index); }
 
 // Get Functions
-    inline std::vector<GenericVertexAttribute>& GetGenericVertexAttributes(void) { FUN_ENTRY(GL_LOG_TRACE); return mGenericVertexAttributes; }
-    inline GenericVertexAttribute* GetGenericVertexAttribute(size_t index)      { FUN_ENTRY(GL_LOG_TRACE); return &mGenericVertexAttributes[index]; }
+    inline std::vector<GenericVertexAttribute>& GetGenericVertexAttributes(void) { FUN_ENTRY(GL_LOG_TRACE); return mActiveVertexArray->GetGenericVertexAttributes(); }
+    inline GenericVertexAttribute* GetGenericVertexAttribute(size_t index)      { FUN_ENTRY(GL_LOG_TRACE); return mActiveVertexArray->GetGenericVertexAttribute(index); }
+    inline VertexArray *       GetActiveVertexArray(void)                       { FUN_ENTRY(GL_LOG_TRACE); return mActiveVertexArray; }
+    inline VertexArray *       GetDefaultVertexArray(void)                      { FUN_ENTRY(GL_LOG_TRACE); return mDefaultVertexArray; }
+           VertexArray *       GetVertexArray(GLuint index);
+    inline uint32_t            GetVertexArrayID(const VertexArray *vao)         { FUN_ENTRY(GL_LOG_TRACE); return vao == mDefaultVertexArray ? 0 : mVertexArrays.GetObjectId(vao); }
+    inline VertexArrayArray   *GetVertexArrayArray(void)                        { FUN_ENTRY(GL_LOG_TRACE); return &mVertexArrays; }
 
     inline TextureArray       *GetTextureArray(void)                            { FUN_ENTRY(GL_LOG_TRACE); return &mTextures; }
+    inline BufferArray        *GetBufferArray(void)                             { FUN_ENTRY(GL_LOG_TRACE); return &mBuffers;  }
     inline ShaderArray        *GetShaderArray(void)                             { FUN_ENTRY(GL_LOG_TRACE); return &mShaders;  }
     inline ShaderProgramArray *GetShaderProgramArray(void)                      { FUN_ENTRY(GL_LOG_TRACE); return &mShaderPrograms; }
     inline RenderbufferArray  *GetRenderbufferArray(void)                       { FUN_ENTRY(GL_LOG_TRACE); return &mRenderbuffers; }
+    inline ShareGroup         *GetShareGroup(void)                              { FUN_ENTRY(GL_LOG_TRACE); return mShareGroup; }
 
-    inline Texture *           GetTexture(GLuint index)                         { FUN_ENTRY(GL_LOG_TRACE); return mTextures.GetObject(index); }
-    inline Texture *           GetDefaultTexture(GLenum target)                 { FUN_ENTRY(GL_LOG_TRACE); return target == GL_TEXTURE_2D ? mDefaultTexture2D : mDefaultTextureCubeMap; }
+    inline Texture *           GetTexture(GLuint index)                         { FUN_ENTRY(GL_LOG_TRACE); SHARE_GROUP_LOCK(); return mTextures.GetObject(index); }
+    inline Texture *           GetDefaultTexture(GLenum target)                 { FUN_ENTRY(GL_LOG_TRACE); return target == GL_TEXTURE_2D ? mDefaultTexture2D : target == GL_TEXTURE_3D_OES ? mDefaultTexture3D : mDefaultTextureCubeMap; }
     inline Framebuffer *       GetFramebuffer(GLuint index)                     { FUN_ENTRY(GL_LOG_TRACE); return mFramebuffers.GetObject(index); }
-    inline Renderbuffer *      GetRenderbuffer(GLuint index)                    { FUN_ENTRY(GL_LOG_TRACE); return mRenderbuffers.GetObject(index); }
-    inline BufferObject *      GetBuffer(GLuint index)                          { FUN_ENTRY(GL_LOG_TRACE); return mBuffers.GetObject(index); }
-    inline uint32_t            GetTextureID(const Texture *texture)             { FUN_ENTRY(GL_LOG_TRACE); return (texture == mDefaultTexture2D) || (texture == mDefaultTextureCubeMap) ? 0 : mTextures.GetObjectId(texture); }
-    inline uint32_t            GetBufferID(const BufferObject *bo)              { FUN_ENTRY(GL_LOG_TRACE); return mBuffers.GetObjectId(bo); }
-    inline Shader *            GetShader(GLuint index)                          { FUN_ENTRY(GL_LOG_TRACE); return mShaders.GetObject(index); }
-    inline ShaderProgram *     GetShaderProgram(GLuint index)                   { FUN_ENTRY(GL_LOG_TRACE); return mShaderPrograms.GetObject(index); }
-    inline uint32_t            GetShaderID(const Shader *shader)                { FUN_ENTRY(GL_LOG_TRACE); return mShaders.GetObjectId(shader); }
-    inline uint32_t            GetShaderProgramID(const ShaderProgram *program) { FUN_ENTRY(GL_LOG_TRACE); return mShaderPrograms.GetObjectId(program); }
-    inline uint32_t            GetShadingObjectCount(void)                const { FUN_ENTRY(GL_LOG_TRACE); return mShadingObjectCount; }
-    inline ShadingNamespace_t  GetShadingObject(GLuint index)                   { FUN_ENTRY(GL_LOG_TRACE); return mShadingObjectPool[index]; }
+    inline Query *             GetQuery(GLuint index)                           { FUN_ENTRY(GL_LOG_TRACE); return mQueries.GetObject(index); }
+    inline uint32_t            GetQueryID(const Query *query)                   { FUN_ENTRY(GL_LOG_TRACE); return mQueries.GetObjectId(query); }
+    inline vulkanAPI::CommandBundle *GetCommandBundle(GLuint index)             { FUN_ENTRY(GL_LOG_TRACE); return mCommandBundles.GetObject(index); }
+    inline Renderbuffer *      GetRenderbuffer(GLuint index)                    { FUN_ENTRY(GL_LOG_TRACE); SHARE_GROUP_LOCK(); return mRenderbuffers.GetObject(index); }
+    inline BufferObject *      GetBuffer(GLuint index)                          { FUN_ENTRY(GL_LOG_TRACE); SHARE_GROUP_LOCK(); return mBuffers.GetObject(index); }
+    inline uint32_t            GetTextureID(const Texture *texture)             { FUN_ENTRY(GL_LOG_TRACE); SHARE_GROUP_LOCK(); return (texture == mDefaultTexture2D) || (texture == mDefaultTextureCubeMap) || (texture == mDefaultTexture3D) ? 0 : mTextures.GetObjectId(texture); }
+    inline uint32_t            GetBufferID(const BufferObject *bo)              { FUN_ENTRY(GL_LOG_TRACE); SHARE_GROUP_LOCK(); return mBuffers.GetObjectId(bo); }
+    inline Shader *            GetShader(GLuint index)                          { FUN_ENTRY(GL_LOG_TRACE); SHARE_GROUP_LOCK(); return mShaders.GetObject(index); }
+    inline ShaderProgram *     GetShaderProgram(GLuint index)                   { FUN_ENTRY(GL_LOG_TRACE); SHARE_GROUP_LOCK(); return mShaderPrograms.GetObject(index); }
+    inline uint32_t            GetShaderID(const Shader *shader)                { FUN_ENTRY(GL_LOG_TRACE); SHARE_GROUP_LOCK(); return mShaders.GetObjectId(shader); }
+    inline uint32_t            GetShaderProgramID(const ShaderProgram *program) { FUN_ENTRY(GL_LOG_TRACE); SHARE_GROUP_LOCK(); return mShaderPrograms.GetObjectId(program); }
+    inline uint32_t            GetShadingObjectCount(void)                const { FUN_ENTRY(GL_LOG_TRACE); SHARE_GROUP_LOCK(); return mShadingObjectCount; }
+    inline ShadingNamespace_t  GetShadingObject(GLuint index)                   { FUN_ENTRY(GL_LOG_TRACE); SHARE_GROUP_LOCK(); return mShadingObjectPool[index]; }
     
 // Set Functions
     void                       SetCacheManager(CacheManager *cacheManager);
+    inline void                SetActiveVertexArray(VertexArray *vao)           { FUN_ENTRY(GL_LOG_TRACE); mActiveVertexArray = vao ? vao : mDefaultVertexArray; }
 
 // Map Functions
            uint32_t            PushShadingObject(const ShadingNamespace_t& obj);
            void                EraseShadingObject(GLuint index);
 
-    inline bool                TextureExists(GLuint index)                const { FUN_ENTRY(GL_LOG_TRACE); return mTextures.ObjectExists(index); }
-    inline bool                BufferExists(GLuint index)                 const { FUN_ENTRY(GL_LOG_TRACE); return mBuffers.ObjectExists(index); }
-    inline bool                RenderbufferExists(GLuint index)           const { FUN_ENTRY(GL_LOG_TRACE); return mRenderbuffers.ObjectExists(index); }
+    inline bool                TextureExists(GLuint index)                const { FUN_ENTRY(GL_LOG_TRACE); SHARE_GROUP_LOCK(); return mTextures.ObjectExists(index); }
+    inline bool                BufferExists(GLuint index)                 const { FUN_ENTRY(GL_LOG_TRACE); SHARE_GROUP_LOCK(); return mBuffers.ObjectExists(index); }
+    inline bool                RenderbufferExists(GLuint index)           const { FUN_ENTRY(GL_LOG_TRACE); SHARE_GROUP_LOCK(); return mRenderbuffers.ObjectExists(index); }
     inline bool                FramebufferExists(GLuint index)            const { FUN_ENTRY(GL_LOG_TRACE); return mFramebuffers.ObjectExists(index); }
-    inline bool                ShadingObjectExists(GLuint index)          const { FUN_ENTRY(GL_LOG_TRACE); return mShadingObjectPool.find(index) != mShadingObjectPool.end(); }
+    inline bool                VertexArrayExists(GLuint index)            const { FUN_ENTRY(GL_LOG_TRACE); return mVertexArrays.ObjectExists(index); }
+    inline bool                QueryExists(GLuint index)                  const { FUN_ENTRY(GL_LOG_TRACE); return mQueries.ObjectExists(index); }
+    inline bool                CommandBundleExists(GLuint index)          const { FUN_ENTRY(GL_LOG_TRACE); return mCommandBundles.ObjectExists(index); }
+    inline bool                ShadingObjectExists(GLuint index)          const { FUN_ENTRY(GL_LOG_TRACE); SHARE_GROUP_LOCK(); return mShadingObjectPool.find(index) != mShadingObjectPool.end(); }
 
            GLboolean           IsShadingObject(GLuint index, shadingNamespaceType_t type) const;
-    bool                       IsTextureAttachedToFBO(const Texture *texture);
-    uint32_t                   FindShaderID(const Shader *shader);
-    uint32_t                   FindShaderProgramID(const ShaderProgram *program);
+    inline uint32_t            FindShaderID(const Shader *shader)         const { FUN_ENTRY(GL_LOG_TRACE); return shader->GetShadingId(); }
+    inline uint32_t            FindShaderProgramID(const ShaderProgram *program) const { FUN_ENTRY(GL_LOG_TRACE); return program->GetShadingId(); }
 
     void                       UpdateFramebufferObjects(GLuint index, GLenum target);
+    /// demotes the coldest textures of the share group as of submissionId, returns how many were demoted
+    uint32_t                   DemoteColdTextures(uint64_t submissionId);
     void                       CreateDefaultTextures(void);
 
 //PurgeList Functions
-    void                       AddToPurgeList(BufferObject *object)             { FUN_ENTRY(GL_LOG_TRACE); mPurgeListBufferObject.push_back(object); }
-    void                       AddToPurgeList(Texture *object)                  { FUN_ENTRY(GL_LOG_TRACE); mPurgeListTexture.push_back(object); }
-    void                       AddToPurgeList(Shader *object)                   { FUN_ENTRY(GL_LOG_TRACE); mPurgeListShaders.push_back(object); }
-    void                       AddToPurgeList(ShaderProgram *object)            { FUN_ENTRY(GL_LOG_TRACE); mPurgeListShaderPrograms.push_back(object); }
-    void                       AddToPurgeList(Renderbuffer *object)             { FUN_ENTRY(GL_LOG_TRACE); mPurgeListRenderbuffers.push_back(object); }
+    void                       AddToPurgeList(BufferObject *object)             { FUN_ENTRY(GL_LOG_TRACE); SHARE_GROUP_LOCK(); mPurgeListBufferObject.push_back(object); }
+    void                       AddToPurgeList(Texture *object)                  { FUN_ENTRY(GL_LOG_TRACE); SHARE_GROUP_LOCK(); mPurgeListTexture.push_back(object); }
+    void                       AddToPurgeList(Shader *object)                   { FUN_ENTRY(GL_LOG_TRACE); SHARE_GROUP_LOCK(); mPurgeListShaders.push_back(object); }
+    void                       AddToPurgeList(ShaderProgram *object)            { FUN_ENTRY(GL_LOG_TRACE); SHARE_GROUP_LOCK(); mPurgeListShaderPrograms.push_back(object); }
+    void                       AddToPurgeList(Renderbuffer *object)             { FUN_ENTRY(GL_LOG_TRACE); SHARE_GROUP_LOCK(); mPurgeListRenderbuffers.push_back(object); }
     void                       CleanPurgeList();
     void                       FramebufferCacheAttachement(Texture *texture, GLuint index);
     void                       FramebufferCacheAttachement(Renderbuffer *renderbuffer, GLuint index);
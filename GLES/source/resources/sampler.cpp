@@ -29,7 +29,7 @@
 #include "sampler.h"
 
 Sampler::Sampler()
-: mMinFilter(GL_NEAREST_MIPMAP_LINEAR), mMagFilter(GL_LINEAR), mWrapS(GL_REPEAT), mWrapT(GL_REPEAT)
+: mMinFilter(GL_NEAREST_MIPMAP_LINEAR), mMagFilter(GL_LINEAR), mWrapS(GL_REPEAT), mWrapT(GL_REPEAT), mWrapR(GL_REPEAT)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 }
@@ -33,6 +33,7 @@ private:
     GLenum                  mMagFilter;
     GLenum                  mWrapS;
     GLenum                  mWrapT;
+    GLenum                  mWrapR;
 
 public:
     Sampler();
@@ -43,6 +44,7 @@ public:
     inline GLenum           GetMagFilter(void)                          const   { FUN_ENTRY(GL_LOG_TRACE); return mMagFilter; }
     inline GLenum           GetWrapS(void)                              const   { FUN_ENTRY(GL_LOG_TRACE); return mWrapS; }
     inline GLenum           GetWrapT(void)                              const   { FUN_ENTRY(GL_LOG_TRACE); return mWrapT; }
+    inline GLenum           GetWrapR(void)                              const   { FUN_ENTRY(GL_LOG_TRACE); return mWrapR; }
 
 // Update Functions
     inline bool             UpdateMinFilter(GLenum mode)                        { FUN_ENTRY(GL_LOG_TRACE); bool res = mMinFilter != mode;
@@ -57,6 +59,9 @@ public:
     inline bool             UpdateWrapT(GLenum mode)                            { FUN_ENTRY(GL_LOG_TRACE); bool res = mWrapT != mode;
                                                                                                            mWrapT = mode;
                                                                                                            return res; }
+    inline bool             UpdateWrapR(GLenum mode)                            { FUN_ENTRY(GL_LOG_TRACE); bool res = mWrapR != mode;
+                                                                                                           mWrapR = mode;
+                                                                                                           return res; }
 };
 
 #endif // __SAMPLER_H__
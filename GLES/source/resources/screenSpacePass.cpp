@@ -17,7 +17,7 @@
  *  @date       26/10/2018
  *  @version    1.0
  *
- *  @brief      Screen Space Vulkan Pass used for various operations (e.g., clear with ColorMask)
+ *  @brief      Screen Space Vulkan Pass used for various operations (e.g., clear with ColorMask or StencilMask)
  *
  */
 
@@ -42,10 +42,13 @@ ScreenSpacePass::ScreenSpacePass(const vulkanAPI::vkContext_t *vkContext):
     mVertexVkBuffer(VK_NULL_HANDLE), mVertexVkBufferOffset(0),
     mVertexInputInfo(), mPipelineCache(new vulkanAPI::PipelineCache(mVkContext)),
     mPipeline(new vulkanAPI::Pipeline(vkContext)),
+    mColorWriteMask(VK_COLOR_COMPONENT_FLAG_BITS_MAX_ENUM), mStencilTestEnable(VK_FALSE), mColorFormat(VK_FORMAT_UNDEFINED), mDepthStencilFormat(VK_FORMAT_UNDEFINED),
+    mClearColorValid(false),
     mInitialized(false), mValid(false)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
+    memset(static_cast<void *>(mClearColor), 0, sizeof(mClearColor));
 }
 
 ScreenSpacePass::~ScreenSpacePass()
@@ -226,7 +229,7 @@ void main() {\n\
     if(!mShaderData.shaderProgram->SetPipelineShaderStage(mPipeline->GetShaderStageCountRef(), mPipeline->GetShaderStageIDsRef(), mPipeline->GetShaderStages())) {
         return false;
     }
-    mPipeline->SetCache(mShaderData.shaderProgram->GetVkPipelineCache());
+    mPipeline->SetCache(mShaderData.shaderProgram->GetPipelineCache());
     mPipeline->SetLayout(mShaderData.shaderProgram->GetVkPipelineLayout());
 
     return true;
@@ -284,11 +287,29 @@ ScreenSpacePass::CreateDefaultPipelineStates()
 
     mPipeline->SetVertexInputState(&mVertexInputInfo);
 
+    // the stencil masks and reference of a clear do not select another pipeline
     std::vector<VkDynamicState> states = {VK_DYNAMIC_STATE_VIEWPORT,
-                                          VK_DYNAMIC_STATE_SCISSOR};
+                                          VK_DYNAMIC_STATE_SCISSOR,
+                                          VK_DYNAMIC_STATE_STENCIL_COMPARE_MASK,
+                                          VK_DYNAMIC_STATE_STENCIL_WRITE_MASK,
+                                          VK_DYNAMIC_STATE_STENCIL_REFERENCE};
     mPipeline->CreateDynamicState(states);
 
     mPipeline->SetDepthTestEnable(false);
+    mPipeline->SetDepthWriteEnable(false);
+
+    // stencil clears replace the reference value on the bits of the write mask
+    mPipeline->SetStencilTestEnable(mStencilTestEnable);
+    mPipeline->SetStencilFrontCompareOp(VK_COMPARE_OP_ALWAYS);
+    mPipeline->SetStencilFrontPassOp(VK_STENCIL_OP_REPLACE);
+    mPipeline->SetStencilFrontFailOp(VK_STENCIL_OP_KEEP);
+    mPipeline->SetStencilFrontZFailOp(VK_STENCIL_OP_KEEP);
+    mPipeline->SetStencilFrontCompareMask(0xFFFFFFFFu);
+    mPipeline->SetStencilBackCompareOp(VK_COMPARE_OP_ALWAYS);
+    mPipeline->SetStencilBackPassOp(VK_STENCIL_OP_REPLACE);
+    mPipeline->SetStencilBackFailOp(VK_STENCIL_OP_KEEP);
+    mPipeline->SetStencilBackZFailOp(VK_STENCIL_OP_KEEP);
+    mPipeline->SetStencilBackCompareMask(0xFFFFFFFFu);
 
     return true;
 }
@@ -317,6 +338,14 @@ ScreenSpacePass::UpdateUniformBufferColor(float r, float g, float b, float a)
     FUN_ENTRY(GL_LOG_DEBUG);
 
     UniformBufferObject_ScreenSpace ubo = { r,g,b,a };
+
+    // an unchanged color would only cost another uniform buffer upload
+    if(mClearColorValid && !memcmp(mClearColor, ubo.color, sizeof(mClearColor))) {
+        return true;
+    }
+    memcpy(mClearColor, ubo.color, sizeof(mClearColor));
+    mClearColorValid = true;
+
     GLint loc = mShaderData.shaderProgram->GetUniformLocation("clearColor");
     if(loc >= 0) {
         mShaderData.shaderProgram->SetUniformData(static_cast<uint32_t>(loc),
@@ -327,6 +356,44 @@ ScreenSpacePass::UpdateUniformBufferColor(float r, float g, float b, float a)
     return true;
 }
 
+bool
+ScreenSpacePass::PreparePipeline(VkColorComponentFlags colorWriteMask, uint32_t stencilWriteMask, uint32_t stencilReference,
+                                 vulkanAPI::RenderPass *renderPass)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    VkBool32 stencilTestEnable = stencilWriteMask ? VK_TRUE : VK_FALSE;
+
+    // the variants per color mask, stencil test and attachment formats are kept
+    // in the program's pipeline cache, so switching between them is only a lookup
+    if(mColorWriteMask     != colorWriteMask               ||
+       mStencilTestEnable  != stencilTestEnable            ||
+       mColorFormat        != renderPass->GetColorFormat() ||
+       mDepthStencilFormat != renderPass->GetDepthStencilFormat()) {
+        mPipeline->SetColorBlendAttachmentWriteMask(colorWriteMask);
+        mPipeline->SetStencilTestEnable(stencilTestEnable);
+        mPipeline->SetUpdatePipeline(true);
+
+        mColorWriteMask     = colorWriteMask;
+        mStencilTestEnable  = stencilTestEnable;
+        mColorFormat        = renderPass->GetColorFormat();
+        mDepthStencilFormat = renderPass->GetDepthStencilFormat();
+    }
+
+    // recorded through UpdateDynamicState
+    mPipeline->SetStencilFrontWriteMask(stencilWriteMask);
+    mPipeline->SetStencilBackWriteMask(stencilWriteMask);
+    mPipeline->SetStencilFrontReference(stencilReference);
+    mPipeline->SetStencilBackReference(stencilReference);
+
+    if(!mPipeline->Create(renderPass)) {
+        mColorWriteMask = VK_COLOR_COMPONENT_FLAG_BITS_MAX_ENUM;
+        return false;
+    }
+
+    return true;
+}
+
 void
 ScreenSpacePass::BindPipeline(const VkCommandBuffer *cmdBuffer) const
 {
@@ -341,7 +408,7 @@ ScreenSpacePass::BindVertexBuffers(const VkCommandBuffer *cmdBuffer) const
     FUN_ENTRY(GL_LOG_DEBUG);
 
     // bind vertex buffers
-    vkCmdBindVertexBuffers(*cmdBuffer, 0, 1, &mVertexVkBuffer, &mVertexVkBufferOffset);
+    mVkContext->vkDispatch.vkCmdBindVertexBuffers(*cmdBuffer, 0, 1, &mVertexVkBuffer, &mVertexVkBufferOffset);
 }
 
 void
@@ -350,9 +417,23 @@ ScreenSpacePass::BindUniformDescriptors(const VkCommandBuffer *cmdBuffer) const
     FUN_ENTRY(GL_LOG_DEBUG);
 
     mShaderData.shaderProgram->UpdateDescriptorSet();
-    mShaderData.shaderProgram->UpdateBuiltInUniformData(0.0f, 1.0f);
-    vkCmdBindDescriptorSets(*cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mShaderData.shaderProgram->GetVkPipelineLayout(), 0, 1,
-                            mShaderData.shaderProgram->GetVkDescSet(), 0, nullptr);
+    // the depth range of the pass never changes
+    mShaderData.shaderProgram->UpdateBuiltInUniformData(0.0f, 1.0f, 1);
+    if(mShaderData.shaderProgram->IsVkPushDescriptors()) {
+#ifdef VK_KHR_push_descriptor
+        mVkContext->fpCmdPushDescriptorSet(*cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mShaderData.shaderProgram->GetVkPipelineLayout(), 0,
+                                           mShaderData.shaderProgram->GetVkDescWriteCount(), mShaderData.shaderProgram->GetVkDescWrites());
+#endif // VK_KHR_push_descriptor
+    } else if(*mShaderData.shaderProgram->GetVkDescSet()) {
+        mVkContext->vkDispatch.vkCmdBindDescriptorSets(*cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mShaderData.shaderProgram->GetVkPipelineLayout(), 0, 1,
+                                mShaderData.shaderProgram->GetVkDescSet(),
+                                mShaderData.shaderProgram->GetVkDynamicOffsetCount(), mShaderData.shaderProgram->GetVkDynamicOffsets());
+    }
+
+    if(mShaderData.shaderProgram->GetPushConstantSize()) {
+        mVkContext->vkDispatch.vkCmdPushConstants(*cmdBuffer, mShaderData.shaderProgram->GetVkPipelineLayout(), mShaderData.shaderProgram->GetVkPushConstantStages(),
+                           0, mShaderData.shaderProgram->GetPushConstantSize(), mShaderData.shaderProgram->GetPushConstantData());
+    }
 }
 
 void
@@ -361,7 +442,7 @@ ScreenSpacePass::Draw(const VkCommandBuffer *cmdBuffer) const
     FUN_ENTRY(GL_LOG_DEBUG);
 
 
-    vkCmdDraw(*cmdBuffer, mNumElements, 1, 0, 0);
+    mVkContext->vkDispatch.vkCmdDraw(*cmdBuffer, mNumElements, 1, 0, 0);
 }
 
 void
@@ -17,7 +17,7 @@
  *  @date       26/10/2018
  *  @version    1.0
  *
- *  @brief      Screen Space Vulkan Pass used for various operations (e.g., clear with ColorMask)
+ *  @brief      Screen Space Vulkan Pass used for various operations (e.g., clear with ColorMask or StencilMask)
  *
  */
 
@@ -80,8 +80,14 @@ struct ShaderData {
     VkPipelineVertexInputStateCreateInfo        mVertexInputInfo;
     vulkanAPI::PipelineCache                   *mPipelineCache;
     vulkanAPI::Pipeline*                        mPipeline;
+    VkColorComponentFlags                       mColorWriteMask;
+    VkBool32                                    mStencilTestEnable;
+    VkFormat                                    mColorFormat;
+    VkFormat                                    mDepthStencilFormat;
 
     // buffers
+    float                                       mClearColor[4];
+    bool                                        mClearColorValid;
 
     bool                                        mInitialized;
     bool                                        mValid;
@@ -119,6 +125,8 @@ public:
     void                                        BindPipeline(const VkCommandBuffer *cmdBuffer) const;
     void                                        Draw(const VkCommandBuffer *cmdBuffer) const;
     bool                                        UpdateUniformBufferColor(float r, float g, float b, float a);
+    bool                                        PreparePipeline(VkColorComponentFlags colorWriteMask, uint32_t stencilWriteMask, uint32_t stencilReference,
+                                                                vulkanAPI::RenderPass *renderPass);
 
 // Get Functions
     inline bool                                 Valid()                           {  FUN_ENTRY(GL_LOG_TRACE); return mValid; }
@@ -30,8 +30,8 @@
 #include "shader.h"
 
 Shader::Shader(const vulkanAPI::vkContext_t *vkContext)
-: mVkContext(vkContext), mVkShaderModule(VK_NULL_HANDLE), mShaderCompiler(nullptr), mSource(nullptr),
-  mSourceLength(0), mShaderType(SHADER_TYPE_INVALID), mShaderVersion(ESSL_VERSION_100), mCompiled(false)
+: mVkContext(vkContext), mShaderCompiler(nullptr), mSource(nullptr),
+  mCompileTicket(0), mSourceLength(0), mShadingId(0), mShaderType(SHADER_TYPE_INVALID), mShaderVersion(ESSL_VERSION_100), mCompiled(false)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 }
@@ -41,7 +41,6 @@ Shader::~Shader()
     FUN_ENTRY(GL_LOG_TRACE);
 
     FreeSources();
-    DestroyVkShader();
 }
 
 int
@@ -49,7 +48,7 @@ Shader::GetInfoLogLength(void) const
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    return mShaderCompiler->GetShaderInfoLog(mShaderType, mShaderVersion) ? (int)strlen(mShaderCompiler->GetShaderInfoLog(mShaderType, mShaderVersion)) : 0;
+    return static_cast<int>(mInfoLog.size());
 }
 
 void
@@ -155,19 +154,8 @@ Shader::GetInfoLog(void) const
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    char *log = nullptr;
-
-    if(mShaderCompiler) {
-        uint32_t len = strlen(mShaderCompiler->GetShaderInfoLog(mShaderType, mShaderVersion)) + 1;
-        log = new char[len];
-
-        memcpy(log, mShaderCompiler->GetShaderInfoLog(mShaderType, mShaderVersion), len);
-
-        /// NULL terminate it
-        if(log[len - 1] != '\0') {
-            log[len] = '\0';
-        }
-    }
+    char *log = new char[mInfoLog.size() + 1];
+    memcpy(log, mInfoLog.c_str(), mInfoLog.size() + 1);
 
     return log;
 }
@@ -179,43 +167,8 @@ Shader::CompileShader(void)
 
     mCompiled = mShaderCompiler->CompileShader(&mSource, mShaderType, mShaderVersion);
 
-    return mCompiled;
-}
-
-void
-Shader::DestroyVkShader(void)
-{
-    FUN_ENTRY(GL_LOG_DEBUG);
-
-     if(mVkShaderModule != VK_NULL_HANDLE) {
-         vkDestroyShaderModule(mVkContext->vkDevice, mVkShaderModule, nullptr);
-         mVkShaderModule = VK_NULL_HANDLE;
-     }
-}
-
-VkShaderModule
-Shader::CreateVkShaderModule(void)
-{
-    FUN_ENTRY(GL_LOG_DEBUG);
-
-    assert(mShaderType == SHADER_TYPE_VERTEX || mShaderType == SHADER_TYPE_FRAGMENT);
-
-    DestroyVkShader();
+    const char *log = mShaderCompiler->GetShaderInfoLog(mShaderType, mShaderVersion);
+    mInfoLog = log ? log : "";
 
-    if(!mSpv.size()) {
-        return VK_NULL_HANDLE;
-    }
-
-    VkShaderModuleCreateInfo moduleCreateInfo;
-    moduleCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-    moduleCreateInfo.pNext = nullptr;
-    moduleCreateInfo.flags = 0;
-    moduleCreateInfo.codeSize = mSpv.size() * sizeof(uint32_t);
-    moduleCreateInfo.pCode = mSpv.data();
-
-    if(vkCreateShaderModule(mVkContext->vkDevice, &moduleCreateInfo, nullptr, &mVkShaderModule)) {
-        return VK_NULL_HANDLE;
-    }
-
-    return mVkShaderModule;
+    return mCompiled;
 }
@@ -30,26 +30,29 @@
 class Shader : public refObject {
 private:
     const vulkanAPI::vkContext_t *      mVkContext;
-    VkShaderModule                      mVkShaderModule;
     ShaderCompiler *                    mShaderCompiler;
 
     char *                              mSource;
     vector<uint32_t>                    mSpv;
+    /// the compiler is shared by all shaders, so the log of each compilation is kept with its shader
+    std::string                         mInfoLog;
+    /// compile job queued on the context's compile worker, 0 when there is none
+    uint64_t                            mCompileTicket;
 
     uint32_t                            mSourceLength;
+    /// name of the shader in the shading namespace of the share group
+    uint32_t                            mShadingId;
     shader_type_t                       mShaderType;
     ESSL_VERSION                        mShaderVersion;
     bool                                mCompiled;
 
     void                                FreeSources(void);
-    void                                DestroyVkShader(void);
 
 public:
     Shader(const vulkanAPI::vkContext_t *vkContext = nullptr);
     ~Shader();
 
     bool                                CompileShader(void);
-    VkShaderModule                      CreateVkShaderModule(void);
 
 // Get Functions
     char *                              GetInfoLog(void)                        const;
@@ -57,6 +60,8 @@ public:
     char *                              GetShaderSource(void)                   const;
     int                                 GetShaderSourceLength(void)             const;
     shader_type_t                       GetShaderType(void)                     const   { FUN_ENTRY(GL_LOG_TRACE); return mShaderType; }
+    uint64_t                            GetCompileTicket(void)                  const   { FUN_ENTRY(GL_LOG_TRACE); return mCompileTicket; }
+    uint32_t                            GetShadingId(void)                      const   { FUN_ENTRY(GL_LOG_TRACE); return mShadingId; }
     vector<uint32_t> &                  GetSPV(void)                                    { FUN_ENTRY(GL_LOG_TRACE); return mSpv; }
 
 // Set Functions
@@ -64,6 +69,8 @@ public:
     void                                SetVkContext(const vulkanAPI::vkContext_t *vkContext)  { FUN_ENTRY(GL_LOG_TRACE); mVkContext       = vkContext; }
     void                                SetShaderCompiler(ShaderCompiler* compiler)     { FUN_ENTRY(GL_LOG_TRACE); mShaderCompiler  = compiler; }
     void                                SetShaderType(shader_type_t type)               { FUN_ENTRY(GL_LOG_TRACE); mShaderType      = type; }
+    void                                SetCompileTicket(uint64_t ticket)               { FUN_ENTRY(GL_LOG_TRACE); mCompileTicket   = ticket; }
+    void                                SetShadingId(uint32_t id)                       { FUN_ENTRY(GL_LOG_TRACE); mShadingId       = id; }
 
 // Is/Has Functions
     bool                                IsCompiled(void)                        const   { FUN_ENTRY(GL_LOG_TRACE); return mCompiled; }
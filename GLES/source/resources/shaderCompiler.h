@@ -33,7 +33,7 @@ public:
     virtual ~ShaderCompiler() {}
 
 /// Shader Functions
-    virtual bool                PreprocessShader(uintptr_t program_ptr, shader_type_t shaderType, ESSL_VERSION version_in, ESSL_VERSION version_out, bool isYInverted) = 0;
+    virtual bool                PreprocessShader(uintptr_t program_ptr, shader_type_t shaderType, ESSL_VERSION version_in, ESSL_VERSION version_out) = 0;
     virtual bool                CompileShader(const char* const* source, shader_type_t shaderType, ESSL_VERSION version) = 0;
 
 /// Shader Program Functions
@@ -50,6 +50,7 @@ public:
     virtual ShaderReflection*   GetShaderReflection(void) = 0;
     virtual const char*         GetProgramInfoLog(ESSL_VERSION version) = 0;
     virtual const char*         GetShaderInfoLog(shader_type_t shaderType, ESSL_VERSION version) = 0;
+    virtual const char*         GetShaderSource(shader_type_t shaderType, ESSL_VERSION version) = 0;
 
 /// Enable Functions
     virtual void                EnablePrintReflection(ESSL_VERSION version) = 0;
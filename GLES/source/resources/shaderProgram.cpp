@@ -28,6 +28,26 @@
 
 #include "shaderProgram.h"
 #include "context/context.h"
+#include "utils/indexUtils.h"
+#include "utils/programCache.h"
+#include "utils/shaderStats.h"
+#include "utils/startupProfile.h"
+#include "vulkan/commandBundle.h"
+#include "vulkan/samplerCache.h"
+#include "vulkan/shaderModuleCache.h"
+#include "glslang/OptimizeSpv.h"
+#include "glslang/shaderConverter.h"
+#include <algorithm>
+
+typedef struct programBinaryHeader_t {
+    uint32_t                            magic;
+    uint32_t                            version;
+    uint32_t                            reflectionSize;
+    uint32_t                            spirvSize;
+    uint64_t                            pipelineCacheSize;
+} programBinaryHeader_t;
+
+std::atomic<uint64_t> ShaderProgram::sVertexInputIdCounter(0);
 
 ShaderProgram::ShaderProgram(const vulkanAPI::vkContext_t *vkContext)
 : refObject()
@@ -42,17 +62,32 @@ ShaderProgram::ShaderProgram(const vulkanAPI::vkContext_t *vkContext)
     mStagesIDs[0] = -1;
     mStagesIDs[1] = -1;
 
-    mMinDepthRange = 1.f;
-    mMaxDepthRange = 0.f;
+    mDepthRangeLocations[0] = -1;
+    mDepthRangeLocations[1] = -1;
+    mDepthRangeLocations[2] = -1;
+    mDepthRangeGeneration = 0;
 
     mVkShaderModules[0] = VK_NULL_HANDLE;
     mVkShaderModules[1] = VK_NULL_HANDLE;
 
     mVkDescSetLayout = VK_NULL_HANDLE;
     mVkDescSetLayoutBind = nullptr;
-    mVkDescPool = VK_NULL_HANDLE;
+    mVkDescSetBindingCount = 0;
     mVkDescSet = VK_NULL_HANDLE;
+    mVkDescAllocator = nullptr;
+    mVkDescSetEpoch = 0;
+    mResidencyGeneration = 0;
     mVkPipelineLayout = VK_NULL_HANDLE;
+    mVkImmutableSamplersBaked = false;
+    mVkImmutableSamplersRejected = false;
+    mStableSamplerDraws = 0;
+    mVkDynamicUniformBuffers = false;
+    mVkPushDescriptors = false;
+    mVkDescWriteCount = 0;
+    mFramebufferFetch = false;
+    mVkDescInputInfo.sampler     = VK_NULL_HANDLE;
+    mVkDescInputInfo.imageView   = VK_NULL_HANDLE;
+    mVkDescInputInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
 
     mPipelineCache = new vulkanAPI::PipelineCache(mVkContext);
 
@@ -64,10 +99,19 @@ ShaderProgram::ShaderProgram(const vulkanAPI::vkContext_t *vkContext)
     mIsPrecompiled = false;
     mValidated = false;
     mActiveVertexVkBuffersCount = 0;
+    mVertexInputId = ++sVertexInputIdCounter;
+    mVertexInputSource = nullptr;
+    mVertexInputSourceGeneration = 0;
     mActiveIndexVkBuffer = VK_NULL_HANDLE;
+    mActiveIndexVkType = VK_INDEX_TYPE_UINT16;
     mExplicitIbo = nullptr;
+    mLinkTicket = 0;
+    mLinkKey = 0;
+    mLinkCached = false;
+    mShadingId = 0;
 
     SetPipelineVertexInputStateInfo();
+    InitSpecializationInfo();
 }
 
 ShaderProgram::~ShaderProgram()
@@ -102,7 +146,7 @@ ShaderProgram::SetPipelineShaderStage(uint32_t &pipelineShaderStageCount, int *p
         pipelineShaderStages[0].stage  = GetShaderStage();
         pipelineShaderStages[0].module = GetShaderModule();
         pipelineShaderStages[0].pName  = "main\0";
-        pipelineShaderStages[0].pSpecializationInfo = nullptr;
+        pipelineShaderStages[0].pSpecializationInfo = mVkSpecializationEntries.empty() ? nullptr : &mVkSpecializationInfo;
         pipelineShaderStagesIDs[0]     = GetStagesIDs(0);
 
         if(GetShaderModule() == VK_NULL_HANDLE) {
@@ -115,7 +159,7 @@ ShaderProgram::SetPipelineShaderStage(uint32_t &pipelineShaderStageCount, int *p
         pipelineShaderStages[0].stage  = VK_SHADER_STAGE_VERTEX_BIT;
         pipelineShaderStages[0].module = GetVertexShaderModule();
         pipelineShaderStages[0].pName  = "main\0";
-        pipelineShaderStages[0].pSpecializationInfo = nullptr;
+        pipelineShaderStages[0].pSpecializationInfo = mVkSpecializationEntries.empty() ? nullptr : &mVkSpecializationInfo;
         pipelineShaderStagesIDs[0]     = GetStagesIDs(0);
 
         if(GetVertexShaderModule() == VK_NULL_HANDLE) {
@@ -128,7 +172,7 @@ ShaderProgram::SetPipelineShaderStage(uint32_t &pipelineShaderStageCount, int *p
         pipelineShaderStages[1].stage  = VK_SHADER_STAGE_FRAGMENT_BIT;
         pipelineShaderStages[1].module = GetFragmentShaderModule();
         pipelineShaderStages[1].pName  = "main\0";
-        pipelineShaderStages[1].pSpecializationInfo = nullptr;
+        pipelineShaderStages[1].pSpecializationInfo = mVkSpecializationEntries.empty() ? nullptr : &mVkSpecializationInfo;
         pipelineShaderStagesIDs[1]     = GetStagesIDs(1);
 
         if(GetFragmentShaderModule() == VK_NULL_HANDLE) {
@@ -153,6 +197,13 @@ ShaderProgram::SetPipelineVertexInputStateInfo(void)
     mVkPipelineVertexInput.pVertexBindingDescriptions       = mVkVertexInputBinding;
     mVkPipelineVertexInput.vertexAttributeDescriptionCount  = 0;
     mVkPipelineVertexInput.pVertexAttributeDescriptions     = mVkVertexInputAttribute;
+
+#ifdef VK_EXT_vertex_attribute_divisor
+    mVkPipelineVertexInputDivisor.sType                     = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_DIVISOR_STATE_CREATE_INFO_EXT;
+    mVkPipelineVertexInputDivisor.pNext                     = nullptr;
+    mVkPipelineVertexInputDivisor.vertexBindingDivisorCount = 0;
+    mVkPipelineVertexInputDivisor.pVertexBindingDivisors    = mVkVertexInputBindingDivisor;
+#endif // VK_EXT_vertex_attribute_divisor
 }
 
 int
@@ -160,7 +211,7 @@ ShaderProgram::GetInfoLogLength(void) const
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    return mShaderCompiler->GetProgramInfoLog(ESSL_VERSION_100) ? (int)strlen(mShaderCompiler->GetProgramInfoLog(ESSL_VERSION_100)) + 1 : 0;
+    return static_cast<int>(mInfoLog.size()) + 1;
 }
 
 Shader *
@@ -246,6 +297,25 @@ ShaderProgram::SerializeShadersSpirv(void *binary)
     return 2 * sizeof(uint32_t) + vsSpirvSize + fsSpirvSize;
 }
 
+/// whether the SPIR-V declares the InputAttachment capability, which only the framebuffer fetch needs
+static bool
+SpirvUsesInputAttachment(const std::vector<uint32_t> &spirv)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    const uint32_t opCapability              = (2 << 16) | 17;
+    const uint32_t capabilityInputAttachment = 40;
+
+    // the capabilities are the first instructions after the 5 words of the header
+    for(size_t i = 5; i + 1 < spirv.size() && (spirv[i] & 0xFFFF) == 17; i += 2) {
+        if(spirv[i] == opCapability && spirv[i + 1] == capabilityInputAttachment) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 uint32_t
 ShaderProgram::DeserializeShadersSpirv(const void *binary)
 {
@@ -272,6 +342,8 @@ ShaderProgram::DeserializeShadersSpirv(const void *binary)
     std::copy(u32DataPtr, u32DataPtr + fsSpirvSize /4, back_inserter(fsSpirvData));
     rawDataPtr += fsSpirvSize;
 
+    mFramebufferFetch = SpirvUsesInputAttachment(fsSpirvData);
+
     return 2 * sizeof(uint32_t) + vsSpirvSize + fsSpirvSize;
 }
 
@@ -319,7 +391,15 @@ ShaderProgram::GetVkPipelineCache(void)
     return mPipelineCache->GetPipelineCache();
 }
 
-const std::string&
+vulkanAPI::PipelineCache *
+ShaderProgram::GetPipelineCache(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    return mPipelineCache;
+}
+
+const char *
 ShaderProgram::GetAttributeName(int index) const
 {
     FUN_ENTRY(GL_LOG_DEBUG);
@@ -362,12 +442,29 @@ ShaderProgram::ValidateProgram(void)
 }
 
 bool
-ShaderProgram::LinkProgram()
+ShaderProgram::LinkProgram(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(!(mLinked = ValidateProgram())) {
-        return false;
+    LinkShaders();
+    return FinishLink();
+}
+
+void
+ShaderProgram::LinkShaders(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    GLOVE_STARTUP_PHASE(STARTUP_PHASE_FIRST_LINK);
+
+    mLinkBinary.clear();
+    mLinkCached = false;
+    mLinkKey    = 0;
+
+    mLinked  = ValidateProgram();
+    mInfoLog = mShaderCompiler->GetProgramInfoLog(ESSL_VERSION_100);
+    if(!mLinked) {
+        return;
     }
 
     if(GLOVE_SAVE_SHADER_SOURCES_TO_FILES) {
@@ -394,23 +491,87 @@ ShaderProgram::LinkProgram()
         mShaderCompiler->EnablePrintSpv();
     }
 
-    ResetVulkanVertexInput();
+    // the dump options need the intermediate glslang output, so they bypass the cache
+    const bool useProgramCache = GLOVE_PROGRAM_CACHE &&
+                                 !GLOVE_SAVE_SHADER_SOURCES_TO_FILES && !GLOVE_SAVE_SPIRV_BINARY_TO_FILES && !GLOVE_SAVE_SPIRV_TEXT_TO_FILE &&
+                                 !GLOVE_DUMP_PROCESSED_SHADER_SOURCE && !GLOVE_DUMP_VULKAN_SHADER_REFLECTION && !GLOVE_DUMP_SPIRV_SHADER_SOURCE;
+    if(useProgramCache) {
+        {
+            GLOVE_SHADER_STAGE(SHADER_STAGE_CACHE_LOOKUP);
+            mLinkKey = ProgramCache::Hash(mShaderCompiler->GetShaderSource(SHADER_TYPE_VERTEX  , ESSL_VERSION_100),
+                                          mShaderCompiler->GetShaderSource(SHADER_TYPE_FRAGMENT, ESSL_VERSION_100),
+                                          mShaderResourceInterface.GetCustomAttribsLayout(),
+                                          static_cast<uint32_t>(GetSpvOptRecipe()),
+                                          ShaderConverter::IsRelaxedPrecisionEnabled());
+            mLinkCached = ProgramCache::Find(mLinkKey, mLinkBinary);
+        }
+        ShaderStats::CacheLookup(mLinkCached);
+        if(mLinkCached) {
+            return;
+        }
+    }
 
     mShaderCompiler->PrepareReflection(ESSL_VERSION_100);
-    UpdateAttributeInterface();
+    UpdateAttributeInterface(mShaderCompiler->GetShaderReflection());
 
-    Context *context = GetCurrentContext();
-    assert(context);
-    mLinked = mShaderCompiler->PreprocessShader((uintptr_t)this, SHADER_TYPE_VERTEX  , ESSL_VERSION_100, ESSL_VERSION_400, context->IsYInverted()) &&
-              mShaderCompiler->PreprocessShader((uintptr_t)this, SHADER_TYPE_FRAGMENT, ESSL_VERSION_100, ESSL_VERSION_400, context->IsYInverted());
+    std::vector<uint32_t> vsSpirv;
+    std::vector<uint32_t> fsSpirv;
+    mLinked = mShaderCompiler->PreprocessShader((uintptr_t)this, SHADER_TYPE_VERTEX  , ESSL_VERSION_100, ESSL_VERSION_400) &&
+              mShaderCompiler->PreprocessShader((uintptr_t)this, SHADER_TYPE_FRAGMENT, ESSL_VERSION_100, ESSL_VERSION_400) &&
+              mShaderCompiler->LinkProgram((uintptr_t)this, ESSL_VERSION_400, vsSpirv, fsSpirv);
     if(!mLinked) {
-        return false;
+        return;
     }
-    mLinked = mShaderCompiler->LinkProgram((uintptr_t)this, ESSL_VERSION_400, GetVertexShader()->GetSPV(), GetFragmentShader()->GetSPV());
+
+    if(GLOVE_DUMP_VULKAN_SHADER_REFLECTION) {
+        printf("-------- SHADER PROGRAM REFLECTION GLOVE --------\n\n");
+        mShaderCompiler->PrintUniformReflection();
+        printf("-------------------------------------------------\n\n");
+    }
+
+    // same layout as the reflection and SPIR-V part of the program binary
+    const uint32_t vsSpirvSize = static_cast<uint32_t>(4 * vsSpirv.size());
+    const uint32_t fsSpirvSize = static_cast<uint32_t>(4 * fsSpirv.size());
+
+    mLinkBinary.resize(mShaderResourceInterface.GetReflectionSize() + 2 * sizeof(uint32_t) + vsSpirvSize + fsSpirvSize);
+    uint8_t *rawDataPtr = mLinkBinary.data() + mShaderCompiler->SerializeReflection(mLinkBinary.data());
+
+    memcpy(rawDataPtr, &vsSpirvSize, sizeof(uint32_t));
+    rawDataPtr += sizeof(uint32_t);
+    memcpy(rawDataPtr, vsSpirv.data(), vsSpirvSize);
+    rawDataPtr += vsSpirvSize;
+
+    memcpy(rawDataPtr, &fsSpirvSize, sizeof(uint32_t));
+    rawDataPtr += sizeof(uint32_t);
+    memcpy(rawDataPtr, fsSpirv.data(), fsSpirvSize);
+}
+
+bool
+ShaderProgram::FinishLink(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
     if(!mLinked) {
         return false;
     }
-    BuildShaderResourceInterface();
+
+    ResetVulkanVertexInput();
+
+    GetVertexShader()->GetSPV().clear();
+    GetFragmentShader()->GetSPV().clear();
+
+    {
+        GLOVE_SHADER_STAGE(SHADER_STAGE_RESTORE);
+
+        // restored into a reflection of its own, as the shared compiler may already be linking another program.
+        // It already holds the attribute locations, updating them again only sets its size
+        ShaderReflection *reflection = new ShaderReflection();
+        uint32_t reflectionOffset = reflection->Deserialize(mLinkBinary.data());
+        DeserializeShadersSpirv(mLinkBinary.data() + reflectionOffset);
+        UpdateAttributeInterface(reflection);
+        BuildShaderResourceInterface(reflection);
+        delete reflection;
+    }
 
     /// A program object will fail to link if the number of active vertex attributes exceeds GL_MAX_VERTEX_ATTRIBS
     /// A link error will be generated if an attempt is made to utilize more than the space available for fragment shader uniform variables.
@@ -418,15 +579,11 @@ ShaderProgram::LinkProgram()
        GetNumberOfActiveUniforms() > GLOVE_MAX_FRAGMENT_UNIFORM_VECTORS ||
        GetNumberOfActiveAttributes() > GLOVE_MAX_VERTEX_ATTRIBS) {
         mLinked = false;
-        return false;
-    }
-
-    if(GLOVE_DUMP_VULKAN_SHADER_REFLECTION) {
-        printf("-------- SHADER PROGRAM REFLECTION GLOVE --------\n\n");
-        mShaderCompiler->PrintUniformReflection();
-        printf("-------------------------------------------------\n\n");
+    } else if(mLinkKey && !mLinkCached) {
+        ProgramCache::Insert(mLinkKey, mLinkBinary);
     }
 
+    mLinkBinary.clear();
     return mLinked;
 }
 
@@ -448,137 +605,239 @@ ShaderProgram::AllocateExplicitIndexBuffer(const void* data, size_t size, Buffer
 }
 
 bool
-ShaderProgram::ConvertIndexBufferToUint16(const void* srcData, size_t elementCount, BufferObject** ibo)
+ShaderProgram::ConvertIndexBufferToUint16(const void* srcData, size_t elementCount, void* dstData)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    uint16_t* convertedIndicesU16 = new uint16_t[elementCount];
-    size_t actualSize = elementCount * sizeof(uint16_t);
-
-    bool validatedBuffer = ConvertBuffer<uint8_t, uint16_t>(srcData, convertedIndicesU16, elementCount);
-    if(validatedBuffer) {
-        validatedBuffer = AllocateExplicitIndexBuffer(convertedIndicesU16, actualSize, ibo);
+    if(srcData == nullptr) {
+        return false;
     }
-    delete[] convertedIndicesU16;
 
-    return validatedBuffer;
-}
-
-void
-ShaderProgram::LineLoopConversion(void* data, uint32_t indexCount, size_t elementByteSize)
-{
-    FUN_ENTRY(GL_LOG_TRACE);
-
-    memcpy(static_cast<uint8_t*>(data) + (indexCount - 1) * elementByteSize, data, elementByteSize);
+    IndexBufferWidenU8ToU16(srcData, dstData, elementCount);
+    return true;
 }
 
 uint32_t
-ShaderProgram::GetMaxIndex(BufferObject* ibo, uint32_t indexCount, size_t actualSize, VkDeviceSize offset)
+ShaderProgram::GetMaxIndex(BufferObject* ibo, uint32_t indexCount, size_t elementByteSize, VkDeviceSize offset)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    uint16_t* srcData = new uint16_t[actualSize];
+    // the contents of a buffer object only change through glBuffer(Sub)Data,
+    // so the range of a static index buffer is read back and scanned once
+    uint32_t maxIndex;
+    if(ibo->GetCachedMaxIndex(offset, indexCount, elementByteSize, &maxIndex)) {
+        return maxIndex;
+    }
+
+    LinearAllocator *arena = GetCurrentContext()->GetFrameArena();
+    LinearAllocatorScope scope(arena);
+
+    size_t actualSize = indexCount * elementByteSize;
+    uint8_t* srcData = arena->Allocate<uint8_t>(actualSize);
     ibo->GetData(actualSize, offset, srcData);
 
-    uint16_t maxIndex = srcData[0];
-    for(uint32_t i = indexCount - 1; i > 0; --i) {
-        uint16_t index = srcData[i];
-        if(maxIndex < index) {
-            maxIndex = index;
-        }
-    }
-    delete[] srcData;
+    maxIndex = IndexBufferMax(srcData, indexCount, elementByteSize);
+
+    ibo->SetCachedMaxIndex(offset, indexCount, elementByteSize, maxIndex);
 
     return maxIndex;
 }
 
 void
-ShaderProgram::PrepareIndexBufferObject(uint32_t* firstIndex, uint32_t* maxIndex, uint32_t indexCount, GLenum type, const void* indices, BufferObject* ibo)
+ShaderProgram::PrepareIndexBufferObject(uint32_t* firstIndex, uint32_t* maxIndex, uint32_t indexCount, GLenum type, const void* indices,
+                                        BufferObject* ibo, vulkanAPI::RingBuffer *streamRing, bool needsMaxIndex)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
     mActiveIndexVkBuffer = VK_NULL_HANDLE;
-    size_t actualSize = indexCount * (type == GL_UNSIGNED_INT ? sizeof(GLuint) : sizeof(GLushort));
-    VkDeviceSize offset = 0;
-    bool validatedBuffer = true;
 
-    // Index buffer requires special handling for passing data and handling unsigned bytes:
-    // - If there is a index buffer bound, use the indices parameter as offset.
-    // - Otherwise, indices contains the index buffer data. Therefore create a temporary object and store the data there.
-    // If the data format is GL_UNSIGNED_BYTE (not supported by Vulkan), convert the data to uint16 and pass this instead.
-    if(ibo) {
-        offset = reinterpret_cast<VkDeviceSize>(indices);
-
-        if(type == GL_UNSIGNED_BYTE) {
-            assert(indexCount <= ibo->GetSize());
-            uint8_t* srcData = new uint8_t[indexCount];
-            ibo->GetData(indexCount, offset, srcData);
-            offset = 0;
-            validatedBuffer = ConvertIndexBufferToUint16(srcData, indexCount, &ibo);
-            delete[] srcData;
-        }
-    } else {
-        if(type == GL_UNSIGNED_BYTE) {
-            validatedBuffer = ConvertIndexBufferToUint16(indices, indexCount, &ibo);
-        } else {
-            validatedBuffer = AllocateExplicitIndexBuffer(indices, actualSize, &ibo);
+    // GL_UNSIGNED_BYTE indices are consumed as they are with VK_EXT_index_type_uint8
+    // and converted to uint16 otherwise
+    const bool   widen          = type == GL_UNSIGNED_BYTE && !mVkContext->mIsIndexTypeUint8Supported;
+    const size_t srcElementSize = type == GL_UNSIGNED_INT  ? sizeof(GLuint)   :
+                                  type == GL_UNSIGNED_BYTE ? sizeof(GLubyte)  : sizeof(GLushort);
+    const size_t sizeOne        = widen ? sizeof(GLushort) : srcElementSize;
+    const size_t actualSize     = indexCount * sizeOne;
+    mActiveIndexVkType          = IndexElementSizeToVkIndexType(sizeOne);
+
+    assert(GetCurrentContext());
+    const bool lineLoop = GetCurrentContext()->IsModeLineLoop();
+
+    // If there is a index buffer bound, the indices parameter is an offset in it and the
+    // buffer is bound directly, or its uint16 copy that is kept until its contents change.
+    if(ibo && !lineLoop) {
+        VkDeviceSize offset = reinterpret_cast<VkDeviceSize>(indices);
+        if(widen) {
+            ibo     = ibo->GetWidenedIndices();
+            offset *= sizeof(GLushort);
+            if(!ibo) {
+                return;
+            }
         }
+        *firstIndex          = static_cast<uint32_t>(offset);
+        *maxIndex            = needsMaxIndex ? GetMaxIndex(ibo, indexCount, sizeOne, offset) : 0;
+        mActiveIndexVkBuffer = ibo->GetVkBuffer();
+        return;
     }
 
-    assert(GetCurrentContext());
-    if(GetCurrentContext()->IsModeLineLoop()) {
-        size_t sizeOne = type == GL_UNSIGNED_INT ? sizeof(GLuint) : sizeof(GLushort);
-        uint8_t* srcData = new uint8_t[indexCount * sizeOne];
+    // Otherwise the indices are streamed into the ring, either from client memory or read
+    // back from the bound buffer, and, for GL_LINE_LOOP, the first index is appended at the end.
+    const uint32_t srcCount = lineLoop ? indexCount - 1 : indexCount;
 
-        ibo->GetData(actualSize - sizeOne, offset, srcData);
-        LineLoopConversion(srcData, indexCount, sizeOne);
+    LinearAllocator *arena = GetCurrentContext()->GetFrameArena();
+    LinearAllocatorScope scope(arena);
 
-        validatedBuffer = AllocateExplicitIndexBuffer(srcData, actualSize, &ibo);
-        delete[] srcData;
+    const void *srcData = indices;
+    if(ibo) {
+        uint8_t *readBackData = arena->Allocate<uint8_t>(srcCount * srcElementSize);
+        ibo->GetData(srcCount * srcElementSize, reinterpret_cast<VkDeviceSize>(indices), readBackData);
+        srcData = readBackData;
+    }
+
+    uint32_t ringOffset = 0;
+    bool fallback = false;
+    uint8_t *dstData = streamRing ? streamRing->Allocate(actualSize, &ringOffset) : nullptr;
+    if(!dstData) {
+        fallback = true;
+        dstData  = arena->Allocate<uint8_t>(actualSize);
+    }
+
+    bool validatedBuffer = true;
+    if(widen) {
+        validatedBuffer = ConvertIndexBufferToUint16(srcData, srcCount, dstData);
+    } else {
+        memcpy(dstData, srcData, srcCount * sizeOne);
+    }
+    if(lineLoop) {
+        IndexBufferCloseLineLoop(dstData, indexCount, sizeOne);
+    }
+
+    if(fallback) {
+        ringOffset = 0;
+        validatedBuffer = validatedBuffer && AllocateExplicitIndexBuffer(dstData, actualSize, &ibo);
     }
 
     if(validatedBuffer) {
-        *firstIndex = offset;
-        *maxIndex = GetMaxIndex(ibo, indexCount, actualSize, offset);
-        mActiveIndexVkBuffer = ibo->GetVkBuffer();
+        // the indices are scanned on the host copy rather than in the mapped ring memory
+        *firstIndex          = ringOffset;
+        *maxIndex            = needsMaxIndex ? IndexBufferMax(srcData, srcCount, srcElementSize) : 0;
+        mActiveIndexVkBuffer = fallback ? ibo->GetVkBuffer() : streamRing->GetVkBuffer();
+    }
+}
+
+VkIndexType
+ShaderProgram::IndexElementSizeToVkIndexType(size_t elementByteSize)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    switch(elementByteSize) {
+#ifdef VK_EXT_index_type_uint8
+    case sizeof(GLubyte):   return VK_INDEX_TYPE_UINT8_EXT;
+#endif // VK_EXT_index_type_uint8
+    case sizeof(GLuint):    return VK_INDEX_TYPE_UINT32;
+    default:                return VK_INDEX_TYPE_UINT16;
     }
 }
 
 bool
-ShaderProgram::PrepareVertexAttribBufferObjects(size_t vertCount, uint32_t firstVertex,
-                                                std::vector<GenericVertexAttribute>& genericVertAttribs,
-                                                bool updatedVertexAttrib)
+ShaderProgram::HasClientVertexAttribs(const std::vector<GenericVertexAttribute>& genericVertAttribs)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    // store the location-binding associations for faster lookup
-    std::map<uint32_t, uint32_t> vboLocationBindings;
+    // client arrays and converted attributes are the only vertex uploads sized by the vertex count
+    for(uint32_t i = 0; i < mShaderResourceInterface.GetLiveAttributes(); ++i) {
+        const uint32_t attributelocation  = mShaderResourceInterface.GetAttributeLocation(i);
+        const uint32_t occupiedLocations = OccupiedLocationsPerGlType(mShaderResourceInterface.GetAttributeType(i));
 
-    if(UpdateVertexAttribProperties(vertCount, firstVertex, genericVertAttribs, vboLocationBindings, updatedVertexAttrib)) {
-        GenerateVertexInputProperties(genericVertAttribs, vboLocationBindings);
-        return true;
+        for(uint32_t j = 0; j < occupiedLocations; ++j) {
+            const GenericVertexAttribute& gva = genericVertAttribs[attributelocation + j];
+            if(gva.IsEnabled() && (gva.IsInternalVBO() || gva.IsConverted())) {
+                return true;
+            }
+        }
     }
+
     return false;
 }
 
+uint32_t
+ShaderProgram::GetVertexBufferObjects(std::vector<GenericVertexAttribute>& genericVertAttribs, BufferObject **vbos)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the buffer objects the live attributes read from, each listed once
+    uint32_t count = 0;
+    for(uint32_t i = 0; i < mShaderResourceInterface.GetLiveAttributes(); ++i) {
+        const uint32_t attributelocation  = mShaderResourceInterface.GetAttributeLocation(i);
+        const uint32_t occupiedLocations = OccupiedLocationsPerGlType(mShaderResourceInterface.GetAttributeType(i));
+
+        for(uint32_t j = 0; j < occupiedLocations; ++j) {
+            GenericVertexAttribute& gva = genericVertAttribs[attributelocation + j];
+            BufferObject *vbo = gva.GetExternalVbo();
+            if(!gva.IsEnabled() || gva.IsInternalVBO() || !vbo || std::find(vbos, vbos + count, vbo) != vbos + count) {
+                continue;
+            }
+            vbos[count++] = vbo;
+        }
+    }
+
+    return count;
+}
+
 bool
-ShaderProgram::UpdateVertexAttribProperties(size_t vertCount, uint32_t firstVertex,
-                                              std::vector<GenericVertexAttribute>& genericVertAttribs,
-                                              std::map<uint32_t, uint32_t>& vboLocationBindings, bool updatedVertexAttrib)
+ShaderProgram::PrepareVertexAttribBufferObjects(size_t vertCount, uint32_t firstVertex, uint32_t instanceCount, VertexArray *vertexArray,
+                                                vulkanAPI::RingBuffer *streamRing, bool updatedVertexAttrib)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    assert(GetCurrentContext());
-    if(GetCurrentContext()->IsModeLineLoop()) {
-        --vertCount;
+    if(updatedVertexAttrib) {
+        vertexArray->InvalidateLayout();
     }
 
-    // store attribute locations containing the same VkBuffer and stride
-    // as they are directly associated with vertex input bindings
-    typedef std::pair<VkBuffer, int32_t> BUFFER_STRIDE_PAIR;
-    std::map<BUFFER_STRIDE_PAIR, std::vector<uint32_t>> unique_buffer_stride_map;
+    // a vertex array reading only from buffer objects keeps the layout gathered for this program,
+    // so that rebinding it restores the buffers and descriptions without visiting its attributes
+    const vertexInputLayout *bakedLayout = vertexArray->GetBakedLayout(mVertexInputId);
+    if(bakedLayout) {
+        if(mVertexInputSource == vertexArray && mVertexInputSourceGeneration == vertexArray->GetLayoutGeneration()) {
+            return false;
+        }
+        mVertexInputSource           = vertexArray;
+        mVertexInputSourceGeneration = vertexArray->GetLayoutGeneration();
+        SetActiveVertexBuffers(bakedLayout);
+        return GenerateVertexInputProperties(bakedLayout);
+    }
+
+    // streamed client arrays move within the ring on every draw, which only changes
+    // the bound buffer offsets; the pipeline depends on the vertex input layout alone
+    vertexInputLayout *layout = vertexArray->GetLayout();
+    bool bakeable = false;
+    bool updated  = UpdateVertexAttribProperties(vertCount, firstVertex, instanceCount, vertexArray->GetGenericVertexAttributes(), streamRing,
+                                                 updatedVertexAttrib || mVertexInputSource != vertexArray ||
+                                                 mVertexInputSourceGeneration != vertexArray->GetLayoutGeneration(),
+                                                 layout, &bakeable);
+    if(bakeable) {
+        vertexArray->BakeLayout(mVertexInputId);
+    }
+    mVertexInputSource           = vertexArray;
+    mVertexInputSourceGeneration = vertexArray->GetLayoutGeneration();
+
+    return updated ? GenerateVertexInputProperties(layout) : false;
+}
+
+bool
+ShaderProgram::UpdateVertexAttribProperties(size_t vertCount, uint32_t firstVertex, uint32_t instanceCount,
+                                              std::vector<GenericVertexAttribute>& genericVertAttribs,
+                                              vulkanAPI::RingBuffer *streamRing, bool updatedVertexAttrib,
+                                              vertexInputLayout *layout, bool *bakeable)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    layout->bindingCount   = 0;
+    layout->attributeCount = 0;
+    *bakeable              = true;
 
-    std::vector<uint32_t> locationUsed;
+    // attribute locations reading the same VkBuffer, offset and stride share a vertex input binding
+    uint32_t locationUsed = 0;
     for(uint32_t i = 0; i < mShaderResourceInterface.GetLiveAttributes(); ++i) {
         const uint32_t attributelocation  = mShaderResourceInterface.GetAttributeLocation(i);
         const uint32_t occupiedLocations = OccupiedLocationsPerGlType(mShaderResourceInterface.GetAttributeType(i));
@@ -587,147 +846,231 @@ ShaderProgram::UpdateVertexAttribProperties(size_t vertCount, uint32_t firstVert
             const uint32_t location = attributelocation + j;
 
             // if location is currently used then ommit it
-            if (std::find(locationUsed.begin(), locationUsed.end(), location) != locationUsed.end()) {
+            if(location >= GLOVE_MAX_VERTEX_ATTRIBS || (locationUsed & (1u << location))) {
                 continue;
             }
+            locationUsed |= 1u << location;
 
             GenericVertexAttribute& gva = genericVertAttribs[location];
+
+            // an instanced array holds one element per divisor instances, regardless of the vertices drawn
+            uint32_t divisor      = gva.IsEnabled() ? gva.GetDivisor() : 0;
+            uint32_t firstElement = divisor ? 0 : firstVertex;
+            uint32_t elementCount = divisor ? (instanceCount + divisor - 1) / divisor : static_cast<uint32_t>(vertCount);
+            if(divisor > 1 && !mVkContext->mIsVertexAttributeDivisorSupported) {
+                divisor = 1;
+            }
+
             bool updatedVBO   = false;
-            BufferObject *vbo = gva.UpdateVertexAttribute(static_cast<uint32_t>(firstVertex + vertCount), updatedVBO);
+            BufferObject *vbo = gva.UpdateVertexAttribute(firstElement, elementCount, streamRing, updatedVBO);
             if(updatedVBO) {
                 updatedVertexAttrib = true;
             }
-            VkBuffer bo       = vbo->GetVkBuffer();
 
-            // If the primitives are rendered with GL_LINE_LOOP, which is not
-            // supported in Vulkan, we have to modify the vbo and add the first vertex at the end.
-            if(GetCurrentContext()->IsModeLineLoop() && !mActiveIndexVkBuffer) {
-                BufferObject* vboLineLoopUpdated = new VertexBufferObject(mVkContext);
-
-                size_t sizeOld = vbo->GetSize();
-                size_t sizeOne = gva.GetStride();
-                size_t sizeNew = sizeOld + sizeOne;
-
-                uint8_t *dataNew = new uint8_t[sizeNew];
+            // only a buffer object of the application stays valid across draws as it is
+            if(!gva.IsEnabled() || gva.IsInternalVBO() || gva.IsConverted()) {
+                *bakeable = false;
+            }
 
-                vbo->GetData(sizeOld, 0, dataNew);
-                memcpy(dataNew + sizeOld, dataNew, sizeOne);
-                vboLineLoopUpdated->Allocate(sizeNew, dataNew);
+            // a null vbo means that the client data have been streamed into the ring
+            VkBuffer bo           = vbo ? vbo->GetVkBuffer() : gva.GetStreamVkBuffer();
+            VkDeviceSize boOffset = vbo ? 0 : gva.GetStreamOffset();
+            uint32_t stride       = gva.GetBindingStride();
+            uint32_t offset       = gva.GetBindingOffset();
+
+            // the offset of an attribute in a buffer object of the application is bound with the buffer, and only
+            // the offsets of the attributes interleaved with it are left to the vertex input state, so that moving
+            // between the meshes packed in one buffer changes the bound offsets rather than the pipeline
+            if(gva.IsEnabled() && !gva.IsInternalVBO() && !gva.IsConverted() && vbo && offset < vbo->GetSize()) {
+                boOffset = offset;
+                offset   = 0;
+            }
 
-                delete[] dataNew;
-                bo          = vboLineLoopUpdated->GetVkBuffer();
-                mCacheManager->CacheVBO(vboLineLoopUpdated);
-                updatedVertexAttrib = true;
+            uint32_t binding = 0;
+            while(binding < layout->bindingCount &&
+                  (layout->buffers[binding] != bo || boOffset < layout->offsets[binding] ||
+                   (boOffset != layout->offsets[binding] && boOffset - layout->offsets[binding] + offset >= stride) ||
+                   layout->bindings[binding].stride != stride || layout->divisors[binding] != divisor)) {
+                ++binding;
+            }
+            if(binding == layout->bindingCount) {
+                layout->buffers[binding]            = bo;
+                layout->offsets[binding]            = boOffset;
+                layout->vbos[binding]               = vbo;
+                layout->divisors[binding]           = divisor;
+                layout->bindings[binding].binding   = binding;
+                layout->bindings[binding].stride    = stride;
+                layout->bindings[binding].inputRate = divisor ? VK_VERTEX_INPUT_RATE_INSTANCE : VK_VERTEX_INPUT_RATE_VERTEX;
+                ++layout->bindingCount;
             }
 
-            // store each location
-            int32_t stride      = gva.GetStride();
-            BUFFER_STRIDE_PAIR p = {bo, stride};
-            unique_buffer_stride_map[p].push_back(location);
-            locationUsed.push_back(location);
+            VkVertexInputAttributeDescription &attribute = layout->attributes[layout->attributeCount++];
+            attribute.location = location;
+            attribute.binding  = binding;
+            attribute.format   = gva.GetVkFormat();
+            attribute.offset   = static_cast<uint32_t>(boOffset - layout->offsets[binding]) + offset;
         }
     }
 
-    if(!updatedVertexAttrib) {
+    // glBufferData may also have replaced the storage behind an unchanged attribute
+    if(!updatedVertexAttrib &&
+       mActiveVertexVkBuffersCount == layout->bindingCount &&
+       !memcmp(mActiveVertexVkBuffers, layout->buffers, sizeof(VkBuffer) * layout->bindingCount) &&
+       !memcmp(mActiveVertexVkBufferOffsets, layout->offsets, sizeof(VkDeviceSize) * layout->bindingCount)) {
         return false;
     }
 
-    memset(mActiveVertexVkBuffers, VK_NULL_HANDLE, sizeof(VkBuffer) * mActiveVertexVkBuffersCount);
-    mActiveVertexVkBuffersCount = 0;
-
-    // generate unique bindings for each VKbuffer/stride pair
-    uint32_t current_binding = 0;
-    for(const auto& iter : unique_buffer_stride_map) {
-        VkBuffer bo = iter.first.first;
-        for(const auto& loc_str_iter : iter.second) {
-            vboLocationBindings[loc_str_iter] = current_binding;
-        }
-        mActiveVertexVkBuffers[current_binding] = bo;
-        ++current_binding;
-    }
-    mActiveVertexVkBuffersCount = current_binding;
+    SetActiveVertexBuffers(layout);
     return true;
 }
 
 void
-ShaderProgram::GenerateVertexInputProperties(std::vector<GenericVertexAttribute>& genericVertAttribs, const std::map<uint32_t, uint32_t>& vboLocationBindings)
+ShaderProgram::SetActiveVertexBuffers(const vertexInputLayout *layout)
 {
-    // create vertex input bindings and attributes
-    uint32_t count = 0;
-    std::vector<uint32_t> locationUsed;
-
-    for(uint32_t i = 0; i < mShaderResourceInterface.GetLiveAttributes(); ++i) {
-        const uint32_t attributelocation  = mShaderResourceInterface.GetAttributeLocation(i);
-        const uint32_t occupiedLocations = OccupiedLocationsPerGlType(mShaderResourceInterface.GetAttributeType(i));
-
-        for(uint32_t j = 0; j < occupiedLocations; ++j) {
-            const uint32_t location = attributelocation + j;
-            const uint32_t binding  = vboLocationBindings.at(location);
-
-            // if location is currently used then ommit it
-            if (std::find(locationUsed.begin(), locationUsed.end(), location) != locationUsed.end()) {
-                continue;
-            }
+    FUN_ENTRY(GL_LOG_TRACE);
 
-            GenericVertexAttribute& gva = genericVertAttribs[location];
-            mVkVertexInputBinding[binding].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-            mVkVertexInputBinding[binding].binding   = binding;
-            mVkVertexInputBinding[binding].stride    = static_cast<uint32_t>(gva.GetStride());
+    memset(mActiveVertexVkBuffers, VK_NULL_HANDLE, sizeof(VkBuffer) * mActiveVertexVkBuffersCount);
+    memset(mActiveVertexVkBufferOffsets, 0, sizeof(VkDeviceSize) * mActiveVertexVkBuffersCount);
+    memcpy(mActiveVertexVkBuffers, layout->buffers, sizeof(VkBuffer) * layout->bindingCount);
+    memcpy(mActiveVertexVkBufferOffsets, layout->offsets, sizeof(VkDeviceSize) * layout->bindingCount);
+    mActiveVertexVkBuffersCount = layout->bindingCount;
+}
 
-            mVkVertexInputAttribute[count].binding  = binding;
-            mVkVertexInputAttribute[count].location = location;
-            mVkVertexInputAttribute[count].format   = gva.GetVkFormat();
-            mVkVertexInputAttribute[count].offset   = gva.GetOffset();
+bool
+ShaderProgram::GenerateVertexInputProperties(const vertexInputLayout *layout)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
 
-            ++count;
+    // the packed descriptions are the layout key: an identical layout
+    // keeps the current vertex input state and the pipeline built for it
+    if(mVkPipelineVertexInput.vertexBindingDescriptionCount   == layout->bindingCount   &&
+       mVkPipelineVertexInput.vertexAttributeDescriptionCount == layout->attributeCount &&
+       !memcmp(mVkVertexInputBinding,   layout->bindings,   sizeof(VkVertexInputBindingDescription)   * layout->bindingCount) &&
+       !memcmp(mVkVertexInputAttribute, layout->attributes, sizeof(VkVertexInputAttributeDescription) * layout->attributeCount) &&
+       !memcmp(mVertexInputDivisors,    layout->divisors,   sizeof(uint32_t)                          * layout->bindingCount)) {
+        return false;
+    }
 
-            locationUsed.push_back(location);
+    memcpy(mVkVertexInputBinding,   layout->bindings,   sizeof(VkVertexInputBindingDescription)   * layout->bindingCount);
+    memcpy(mVkVertexInputAttribute, layout->attributes, sizeof(VkVertexInputAttributeDescription) * layout->attributeCount);
+    memcpy(mVertexInputDivisors,    layout->divisors,   sizeof(uint32_t)                          * layout->bindingCount);
+    mVkPipelineVertexInput.vertexBindingDescriptionCount   = layout->bindingCount;
+    mVkPipelineVertexInput.vertexAttributeDescriptionCount = layout->attributeCount;
+
+#ifdef VK_EXT_vertex_attribute_divisor
+    // a divisor of 1 is implied by VK_VERTEX_INPUT_RATE_INSTANCE
+    uint32_t divisorCount = 0;
+    for(uint32_t i = 0; i < layout->bindingCount; ++i) {
+        if(layout->divisors[i] > 1) {
+            mVkVertexInputBindingDivisor[divisorCount].binding = i;
+            mVkVertexInputBindingDivisor[divisorCount].divisor = layout->divisors[i];
+            ++divisorCount;
         }
     }
+    mVkPipelineVertexInputDivisor.vertexBindingDivisorCount = divisorCount;
+    mVkPipelineVertexInput.pNext = divisorCount ? &mVkPipelineVertexInputDivisor : nullptr;
+#endif // VK_EXT_vertex_attribute_divisor
 
-    mVkPipelineVertexInput.vertexBindingDescriptionCount   = mActiveVertexVkBuffersCount;
-    mVkPipelineVertexInput.vertexAttributeDescriptionCount = count;
+    return true;
 }
 
-void
+bool
 ShaderProgram::UsePrecompiledBinary(const void *binary, size_t binarySize)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    mLinked = true;
+    ShaderReflection *reflection = new ShaderReflection();
+    const uint8_t    *rawDataPtr = reinterpret_cast<const uint8_t *>(binary);
+
+    // a binary of another GLOVE version, or a truncated one, fails to link
+    programBinaryHeader_t header;
+    memset(static_cast<void *>(&header), 0, sizeof(header));
+    if(binarySize >= sizeof(header)) {
+        memcpy(&header, rawDataPtr, sizeof(header));
+    }
+    mLinked = header.magic          == GLOVE_PROGRAM_BINARY_MAGIC   &&
+              header.version        == GLOVE_PROGRAM_BINARY_VERSION &&
+              header.reflectionSize == reflection->GetReflectionSize() &&
+              binarySize == sizeof(header) + header.reflectionSize + header.spirvSize + header.pipelineCacheSize;
+    if(!mLinked) {
+        delete reflection;
+        return false;
+    }
+    rawDataPtr += sizeof(header);
+
+    // the sizes of both stages have to add up to the SPIR-V part of the header
+    uint32_t vsSpirvSize = 0;
+    uint32_t fsSpirvSize = 0;
+    if(header.spirvSize >= 2 * sizeof(uint32_t)) {
+        memcpy(&vsSpirvSize, rawDataPtr + header.reflectionSize, sizeof(uint32_t));
+        if(vsSpirvSize <= header.spirvSize - 2 * sizeof(uint32_t)) {
+            memcpy(&fsSpirvSize, rawDataPtr + header.reflectionSize + sizeof(uint32_t) + vsSpirvSize, sizeof(uint32_t));
+        }
+    }
+    mLinked = header.spirvSize == 2 * sizeof(uint32_t) + static_cast<uint64_t>(vsSpirvSize) + fsSpirvSize;
+    if(!mLinked) {
+        delete reflection;
+        return false;
+    }
 
     ResetVulkanVertexInput();
 
-    uint32_t reflectionOffset = mShaderCompiler->DeserializeReflection(binary);
-    uint32_t spirvOffset = DeserializeShadersSpirv(reinterpret_cast<const uint8_t *>(binary) + reflectionOffset);
-    const uint8_t *vulkanDataPtr = reinterpret_cast<const uint8_t *>(binary) + reflectionOffset + spirvOffset;
+    GetVertexShader()->GetSPV().clear();
+    GetFragmentShader()->GetSPV().clear();
 
-    BuildShaderResourceInterface();
+    // restored into a reflection of its own, the shared compiler is not involved
+    rawDataPtr += reflection->Deserialize(rawDataPtr);
+    rawDataPtr += DeserializeShadersSpirv(rawDataPtr);
+    UpdateAttributeInterface(reflection);
+    BuildShaderResourceInterface(reflection);
+    delete reflection;
 
-    mPipelineCache->Create(vulkanDataPtr, binarySize - reflectionOffset);
+    if(header.pipelineCacheSize) {
+        mPipelineCache->Create(rawDataPtr, static_cast<size_t>(header.pipelineCacheSize));
+    }
 
     mIsPrecompiled = true;
+
+    return true;
 }
 
 void
-ShaderProgram::GetBinaryData(void *binary, GLsizei *binarySize)
+ShaderProgram::GetBinaryData(void *binary, GLsizei bufSize, GLsizei *binarySize)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    uint32_t reflectionOffset = mShaderCompiler->SerializeReflection(binary);
+    programBinaryHeader_t header;
+    memset(static_cast<void *>(&header), 0, sizeof(header));
+    header.magic   = GLOVE_PROGRAM_BINARY_MAGIC;
+    header.version = GLOVE_PROGRAM_BINARY_VERSION;
 
-    uint8_t *spirvDataPtr = reinterpret_cast<uint8_t *>(binary) + reflectionOffset;
-    uint32_t spirvOffset = SerializeShadersSpirv(spirvDataPtr);
+    uint8_t *rawDataPtr = reinterpret_cast<uint8_t *>(binary) + sizeof(header);
 
-    uint8_t *vulkanDataPtr = reinterpret_cast<uint8_t *>(binary) + reflectionOffset + spirvOffset;
-    size_t vulkanDataSize = *binarySize;
-
-    if(mPipelineCache->GetPipelineCache() != VK_NULL_HANDLE) {
-        mPipelineCache->GetData(reinterpret_cast<void *>(vulkanDataPtr), &vulkanDataSize);
-        *binarySize = vulkanDataSize + reflectionOffset + spirvOffset;
-    } else {
-        *binarySize = 0;
-    }
+    // rebuilt from the resource interface, as the shared compiler may have linked other programs since
+    ShaderReflection *reflection = new ShaderReflection();
+    mShaderResourceInterface.SetReflection(reflection);
+    mShaderResourceInterface.CreateReflection();
+    mShaderResourceInterface.SetReflection(nullptr);
+    memset(rawDataPtr, 0, reflection->GetReflectionSize());
+    header.reflectionSize = reflection->Serialize(rawDataPtr);
+    delete reflection;
+    rawDataPtr += header.reflectionSize;
+
+    header.spirvSize = SerializeShadersSpirv(rawDataPtr);
+    rawDataPtr += header.spirvSize;
+
+    // the pipeline cache is optional, a binary without it only spares the compilation to SPIR-V.
+    // It is left out when it has grown past bufSize since the length was queried
+    const size_t available = static_cast<size_t>(bufSize) - sizeof(header) - header.reflectionSize - header.spirvSize;
+    size_t pipelineCacheSize = 0;
+    if(mPipelineCache->GetPipelineCache() != VK_NULL_HANDLE &&
+       mPipelineCache->GetData(nullptr, &pipelineCacheSize) && pipelineCacheSize <= available &&
+       mPipelineCache->GetData(reinterpret_cast<void *>(rawDataPtr), &pipelineCacheSize)) {
+        header.pipelineCacheSize = pipelineCacheSize;
+    }
+
+    memcpy(binary, &header, sizeof(header));
+    *binarySize = static_cast<GLsizei>(sizeof(header) + header.reflectionSize + header.spirvSize + header.pipelineCacheSize);
 }
 
 GLsizei
@@ -735,6 +1078,10 @@ ShaderProgram::GetBinaryLength(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    if(!mLinked) {
+        return 0;
+    }
+
     size_t vkPipelineCacheDataLength = 0;
     uint32_t spirvSize = 2 * sizeof(uint32_t) + 4 * (mShaderSPVsize[0] + mShaderSPVsize[1]);
 
@@ -742,7 +1089,7 @@ ShaderProgram::GetBinaryLength(void)
         mPipelineCache->GetData(nullptr, &vkPipelineCacheDataLength);
     }
 
-    return vkPipelineCacheDataLength + mShaderResourceInterface.GetReflectionSize() + spirvSize;
+    return static_cast<GLsizei>(sizeof(programBinaryHeader_t) + mShaderResourceInterface.GetReflectionSize() + spirvSize + vkPipelineCacheDataLength);
 }
 
 char *
@@ -750,15 +1097,8 @@ ShaderProgram::GetInfoLog(void) const
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    char *log = nullptr;
-
-    if(mShaderCompiler) {
-        uint32_t len = strlen(mShaderCompiler->GetProgramInfoLog(ESSL_VERSION_100)) + 1;
-        log = new char[len];
-
-        memcpy(log, mShaderCompiler->GetProgramInfoLog(ESSL_VERSION_100), len);
-        log[len - 1] = '\0';
-    }
+    char *log = new char[mInfoLog.size() + 1];
+    memcpy(log, mInfoLog.c_str(), mInfoLog.size() + 1);
 
     return log;
 }
@@ -778,6 +1118,7 @@ ShaderProgram::SetUniformData(uint32_t location, size_t size, const void *ptr)
 
     mShaderResourceInterface.SetUniformClientData(location, size, ptr);
     mUpdateDescriptorData = true;
+    mUpdateSpecializationData = !mSpecializationLocations.empty();
 }
 
 void
@@ -803,7 +1144,11 @@ ShaderProgram::ReleaseVkObjects(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    // pending background builds still use the pipeline layout
+    mPipelineCache->Release();
+
     if(mVkPipelineLayout != VK_NULL_HANDLE) {
+        vulkanAPI::CommandBundle::Retire(vulkanAPI::CommandBundle::GetHandleKey(mVkPipelineLayout));
         vkDestroyPipelineLayout(mVkContext->vkDevice, mVkPipelineLayout, nullptr);
         mVkPipelineLayout = VK_NULL_HANDLE;
     }
@@ -812,25 +1157,23 @@ ShaderProgram::ReleaseVkObjects(void)
         vkDestroyDescriptorSetLayout(mVkContext->vkDevice, mVkDescSetLayout, nullptr);
         mVkDescSetLayout = VK_NULL_HANDLE;
     }
+    ReleaseImmutableSamplers();
 
-    if(mVkDescSet != VK_NULL_HANDLE) {
-        vkFreeDescriptorSets(mVkContext->vkDevice, mVkDescPool, 1, &mVkDescSet);
-        mVkDescSet = VK_NULL_HANDLE;
-    }
-
-    if(mVkDescPool != VK_NULL_HANDLE) {
-        vkDestroyDescriptorPool(mVkContext->vkDevice, mVkDescPool, nullptr);
-        mVkDescPool = VK_NULL_HANDLE;
-    }
+    // the set is released along with its frame's descriptor pools
+    mVkDescSetBindingCount = 0;
+    mVkDescSet             = VK_NULL_HANDLE;
+    mVkDescAllocator       = nullptr;
+    mVkDescSetCache.clear();
 
     for(int32_t i = 0; i < MAX_SHADERS; ++i) {
+        if(mVkShaderModules[i] != VK_NULL_HANDLE) {
+            mVkContext->vkShaderModuleCache->Release(mVkShaderModules[i]);
+        }
         mShaderSPVsize[i] = 0;
         mShaderSPVdata[i] = nullptr;
         mVkShaderModules[i] = VK_NULL_HANDLE;
         mVkShaderStages[i] = VK_SHADER_STAGE_ALL;
     }
-
-    mPipelineCache->Release();
 }
 
 void
@@ -841,31 +1184,61 @@ ShaderProgram::SetShaderModules(void)
     mStageCount = HasVertexShader() + HasFragmentShader();
     assert(mStageCount == 0 || mStageCount == 1 || mStageCount == 2);
 
+    // programs with a stage of the same SPIR-V share its module, which the driver then translates once
+    vulkanAPI::ShaderModuleCache *moduleCache = mVkContext->vkShaderModuleCache;
+    for(int32_t i = 0; i < MAX_SHADERS; ++i) {
+        if(mVkShaderModules[i] != VK_NULL_HANDLE) {
+            moduleCache->Release(mVkShaderModules[i]);
+            mVkShaderModules[i] = VK_NULL_HANDLE;
+        }
+    }
+
     if(mStageCount == 1) {
 
         Shader* shader = HasVertexShader() ? GetVertexShader() : GetFragmentShader();
 
-        mVkShaderModules[0] = shader->CreateVkShaderModule();
+        mVkShaderModules[0] = moduleCache->Acquire(shader->GetSPV().data(), shader->GetSPV().size());
         mVkShaderStages[0]  = HasVertexShader() ? VK_SHADER_STAGE_VERTEX_BIT : VK_SHADER_STAGE_FRAGMENT_BIT;
 
     } else if(mStageCount == 2) {
 
         Shader* shader = GetVertexShader();
 
-        mVkShaderModules[0] = shader->CreateVkShaderModule();
+        mVkShaderModules[0] = moduleCache->Acquire(shader->GetSPV().data(), shader->GetSPV().size());
         mShaderSPVsize[0]  = shader->GetSPV().size();
         mShaderSPVdata[0]  = shader->GetSPV().data();
         mVkShaderStages[0] = VK_SHADER_STAGE_VERTEX_BIT;
 
         shader = GetFragmentShader();
 
-        mVkShaderModules[1] = shader->CreateVkShaderModule();
+        mVkShaderModules[1] = moduleCache->Acquire(shader->GetSPV().data(), shader->GetSPV().size());
         mShaderSPVsize[1]  = shader->GetSPV().size();
         mShaderSPVdata[1]  = shader->GetSPV().data();
         mVkShaderStages[1] = VK_SHADER_STAGE_FRAGMENT_BIT;
     }
 }
 
+VkShaderStageFlags
+ShaderProgram::ShaderTypeToVkShaderStage(shader_type_t type)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    return type == (SHADER_TYPE_VERTEX | SHADER_TYPE_FRAGMENT) ? VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT :
+           type ==  SHADER_TYPE_VERTEX ? VK_SHADER_STAGE_VERTEX_BIT : VK_SHADER_STAGE_FRAGMENT_BIT;
+}
+
+VkDescriptorType
+ShaderProgram::GetUniformBlockDescriptorType(uint32_t index) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(mShaderResourceInterface.IsUniformBlockOpaque(index)) {
+        return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    }
+
+    return mVkDynamicUniformBuffers ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+}
+
 bool
 ShaderProgram::CreateDescriptorSetLayout(uint32_t nLiveUniformBlocks)
 {
@@ -875,13 +1248,27 @@ ShaderProgram::CreateDescriptorSetLayout(uint32_t nLiveUniformBlocks)
         mVkDescSetLayoutBind = new VkDescriptorSetLayoutBinding[nLiveUniformBlocks];
         assert(mVkDescSetLayoutBind);
 
+        uint32_t binding = 0;
         for(uint32_t i = 0; i < mShaderResourceInterface.GetLiveUniformBlocks(); ++i) {
-            mVkDescSetLayoutBind[i].binding = mShaderResourceInterface.GetUniformBlockBinding(i);
-            mVkDescSetLayoutBind[i].descriptorType = mShaderResourceInterface.IsUniformBlockOpaque(i) ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-            mVkDescSetLayoutBind[i].descriptorCount = 1;
-            mVkDescSetLayoutBind[i].stageFlags = mShaderResourceInterface.GetUniformBlockStage(i) == (SHADER_TYPE_VERTEX | SHADER_TYPE_FRAGMENT) ? VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT :
-                                                 mShaderResourceInterface.GetUniformBlockStage(i) ==  SHADER_TYPE_VERTEX ? VK_SHADER_STAGE_VERTEX_BIT : VK_SHADER_STAGE_FRAGMENT_BIT;
-            mVkDescSetLayoutBind[i].pImmutableSamplers = nullptr;
+            if(mShaderResourceInterface.IsUniformBlockPushConstant(i)) {
+                continue;
+            }
+
+            mVkDescSetLayoutBind[binding].binding = mShaderResourceInterface.GetUniformBlockBinding(i);
+            mVkDescSetLayoutBind[binding].descriptorType = GetUniformBlockDescriptorType(i);
+            mVkDescSetLayoutBind[binding].descriptorCount = 1;
+            mVkDescSetLayoutBind[binding].stageFlags = ShaderTypeToVkShaderStage(mShaderResourceInterface.GetUniformBlockStage(i));
+            mVkDescSetLayoutBind[binding].pImmutableSamplers = mVkImmutableSamplersBaked && mShaderResourceInterface.IsUniformBlockOpaque(i) ?
+                                                               &mVkImmutableSamplers[i] : nullptr;
+            ++binding;
+        }
+
+        if(mFramebufferFetch) {
+            mVkDescSetLayoutBind[binding].binding = mShaderResourceInterface.GetLiveUniformBlocks();
+            mVkDescSetLayoutBind[binding].descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+            mVkDescSetLayoutBind[binding].descriptorCount = 1;
+            mVkDescSetLayoutBind[binding].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+            mVkDescSetLayoutBind[binding].pImmutableSamplers = nullptr;
         }
     }
 
@@ -890,6 +1277,11 @@ ShaderProgram::CreateDescriptorSetLayout(uint32_t nLiveUniformBlocks)
     descLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
     descLayoutInfo.pNext = nullptr;
     descLayoutInfo.flags = 0;
+#ifdef VK_KHR_push_descriptor
+    if(mVkPushDescriptors) {
+        descLayoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR;
+    }
+#endif // VK_KHR_push_descriptor
     descLayoutInfo.bindingCount = nLiveUniformBlocks;
     descLayoutInfo.pBindings = mVkDescSetLayoutBind;
 
@@ -909,6 +1301,16 @@ ShaderProgram::CreateDescriptorSetLayout(uint32_t nLiveUniformBlocks)
     pipelineLayoutCreateInfo.pushConstantRangeCount = 0;
     pipelineLayoutCreateInfo.pPushConstantRanges    = nullptr;
 
+    VkPushConstantRange pushConstantRange;
+    if(mShaderResourceInterface.GetPushConstantSize()) {
+        pushConstantRange.stageFlags = GetVkPushConstantStages();
+        pushConstantRange.offset     = 0;
+        pushConstantRange.size       = mShaderResourceInterface.GetPushConstantSize();
+
+        pipelineLayoutCreateInfo.pushConstantRangeCount = 1;
+        pipelineLayoutCreateInfo.pPushConstantRanges    = &pushConstantRange;
+    }
+
     if(vkCreatePipelineLayout(mVkContext->vkDevice, &pipelineLayoutCreateInfo, 0, &mVkPipelineLayout) != VK_SUCCESS) {
         assert(0);
         return false;
@@ -923,57 +1325,152 @@ ShaderProgram::CreateDescriptorSetLayout(uint32_t nLiveUniformBlocks)
 }
 
 bool
-ShaderProgram::CreateDescriptorPool(uint32_t nLiveUniformBlocks)
+ShaderProgram::RecreateDescriptorSetLayout(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    VkDescriptorPoolSize *descTypeCounts = new VkDescriptorPoolSize[nLiveUniformBlocks];
-    assert(descTypeCounts);
-    memset(static_cast<void *>(descTypeCounts), 0, nLiveUniformBlocks * sizeof(*descTypeCounts));
+    assert(mCacheManager);
 
-    for(uint32_t i = 0; i < mShaderResourceInterface.GetLiveUniformBlocks(); ++i) {
-        descTypeCounts[i].descriptorCount = 1;
-        descTypeCounts[i].type = mShaderResourceInterface.IsUniformBlockOpaque(i) ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    // the pipelines and the sets of the old layouts go, and the layouts are destroyed once the frames using them complete
+    mPipelineCache->ReleasePipelines(mCacheManager);
+    mCacheManager->CacheVkPipelineLayout(mVkPipelineLayout, mVkDescSetLayout);
+    mVkPipelineLayout = VK_NULL_HANDLE;
+    mVkDescSetLayout  = VK_NULL_HANDLE;
+
+    mVkDescSet             = VK_NULL_HANDLE;
+    mVkDescAllocator       = nullptr;
+    mVkDescSetCache.clear();
+    mUpdateDescriptorSets  = true;
+
+    return CreateDescriptorSetLayout(mVkDescSetBindingCount);
+}
+
+void
+ShaderProgram::ReleaseImmutableSamplers(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    for(VkSampler sampler : mVkImmutableSamplers) {
+        if(sampler != VK_NULL_HANDLE) {
+            mVkContext->vkSamplerCache->Release(sampler);
+        }
     }
+    mVkImmutableSamplers.clear();
+    mVkImmutableSamplersBaked    = false;
+    mVkImmutableSamplersRejected = false;
+    mStableSamplerDraws          = 0;
+}
 
-    VkDescriptorPoolCreateInfo descriptorPoolInfo;
-    memset(static_cast<void *>(&descriptorPoolInfo), 0, sizeof(descriptorPoolInfo));
-    descriptorPoolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    descriptorPoolInfo.pNext = nullptr;
-    descriptorPoolInfo.poolSizeCount = nLiveUniformBlocks;
-    descriptorPoolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-    descriptorPoolInfo.maxSets = 1;
-    descriptorPoolInfo.pPoolSizes = descTypeCounts;
+bool
+ShaderProgram::GetBoundSamplers(std::vector<VkSampler> *samplers)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(vkCreateDescriptorPool(mVkContext->vkDevice, &descriptorPoolInfo, 0, &mVkDescPool) != VK_SUCCESS) {
-        assert(0);
+    Context *context = GetCurrentContext();
+    assert(context);
+
+    samplers->assign(mShaderResourceInterface.GetLiveUniformBlocks(), VK_NULL_HANDLE);
+    for(uint32_t i = 0; i < mShaderResourceInterface.GetLiveUniforms(); ++i) {
+        const GLenum type = mShaderResourceInterface.GetUniformType(i);
+        if(!IsGlSampler(type)) {
+            continue;
+        }
+
+        // arrays of samplers and the textures that are replaced when sampled keep taking their samplers from the writes
+        if(mShaderResourceInterface.GetUniformArraySize(i) > 1) {
+            return false;
+        }
+
+        const glsl_sampler_t textureUnit = *(glsl_sampler_t *)mShaderResourceInterface.GetUniformClientData(i);
+        Texture *activeTexture = context->GetStateManager()->GetActiveObjectsState()->GetActiveTexture(
+                                 GlSamplerToGlTextureTarget(type), textureUnit);
+        if(!activeTexture->IsCompleted() || !activeTexture->IsNPOTAccessCompleted() || activeTexture->IsColorAttached()) {
+            return false;
+        }
+
+        activeTexture->CreateVkSampler();
+        (*samplers)[mShaderResourceInterface.GetUniformBlockIndex(i)] = activeTexture->GetVkSampler();
+    }
+
+    return true;
+}
+
+bool
+ShaderProgram::UpdateImmutableSamplers(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    static const bool enabled = [] {
+        const char *env = getenv(GLOVE_IMMUTABLE_SAMPLERS_ENV);
+        return env != nullptr && strcmp(env, "false") && strcmp(env, "0");
+    }();
+
+    if(!enabled || mVkImmutableSamplersRejected || !mVkDescSetBindingCount || mVkDescSetLayout == VK_NULL_HANDLE) {
         return false;
     }
-    assert(mVkDescPool != VK_NULL_HANDLE);
 
-    delete[] descTypeCounts;
+    // the samplers only change along with the descriptors, which is when they are looked at again
+    if(!mUpdateDescriptorSets) {
+        if(mVkImmutableSamplersBaked || ++mStableSamplerDraws < GLOVE_IMMUTABLE_SAMPLERS_STABLE_DRAWS) {
+            return false;
+        }
+    }
 
-    return true;
+    std::vector<VkSampler> samplers;
+    bool bound = GetBoundSamplers(&samplers);
+    if(bound && std::count(samplers.begin(), samplers.end(), VK_NULL_HANDLE) == static_cast<ptrdiff_t>(samplers.size())) {
+        mVkImmutableSamplersRejected = true;
+        return false;
+    }
+
+    if(mVkImmutableSamplersBaked) {
+        if(bound && samplers == mVkImmutableSamplers) {
+            return false;
+        }
+
+        // the baked samplers stay held, as the retired layouts refer to them
+        mVkImmutableSamplersBaked    = false;
+        mVkImmutableSamplersRejected = true;
+        return RecreateDescriptorSetLayout();
+    }
+
+    if(!bound || samplers != mVkImmutableSamplers) {
+        ReleaseImmutableSamplers();
+        if(bound) {
+            for(VkSampler sampler : samplers) {
+                if(sampler != VK_NULL_HANDLE && !mVkContext->vkSamplerCache->Retain(sampler)) {
+                    mVkImmutableSamplersRejected = true;
+                    return false;
+                }
+                mVkImmutableSamplers.push_back(sampler);
+            }
+        }
+        return false;
+    }
+
+    if(mStableSamplerDraws < GLOVE_IMMUTABLE_SAMPLERS_STABLE_DRAWS) {
+        ++mStableSamplerDraws;
+        return false;
+    }
+
+    mVkImmutableSamplersBaked = true;
+    return RecreateDescriptorSetLayout();
 }
 
 bool
-ShaderProgram::CreateDescriptorSet(void)
+ShaderProgram::CreateDescriptorSet(vulkanAPI::DescriptorAllocator *descAllocator)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    VkDescriptorSetAllocateInfo descAllocInfo;
-    memset(static_cast<void *>(&descAllocInfo), 0, sizeof(descAllocInfo));
-    descAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    descAllocInfo.pNext = nullptr;
-    descAllocInfo.descriptorPool = mVkDescPool;
-    descAllocInfo.descriptorSetCount = 1;
-    descAllocInfo.pSetLayouts = &mVkDescSetLayout;
-
-    if(vkAllocateDescriptorSets(mVkContext->vkDevice, &descAllocInfo, &mVkDescSet) != VK_SUCCESS) {
-        assert(0);
+    // a new set is written rather than updating one that earlier draws may still reference
+    mVkDescSet = descAllocator ? descAllocator->Allocate(mVkDescSetLayout) : VK_NULL_HANDLE;
+    if(mVkDescSet == VK_NULL_HANDLE) {
+        mVkDescAllocator = nullptr;
         return false;
     }
-    assert(mVkDescSet != VK_NULL_HANDLE);
+
+    mVkDescAllocator = descAllocator;
+    mVkDescSetEpoch  = descAllocator->GetEpoch();
 
     return true;
 }
@@ -983,56 +1480,79 @@ ShaderProgram::AllocateVkDescriptoSet(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    const uint32_t nLiveUniformBlocks = mShaderResourceInterface.GetLiveUniformBlocks();
-
     ReleaseVkObjects();
 
-    if(!CreateDescriptorSetLayout(nLiveUniformBlocks)) {
-        assert(0);
-        return false;
-    }
+    /// blocks declared in the push constant block do not need a descriptor
+    uint32_t nLiveUniformBlocks = 0;
+    uint32_t nDescriptors = 0;
+    mVkDynamicBlocks.clear();
+    for(uint32_t i = 0; i < mShaderResourceInterface.GetLiveUniformBlocks(); ++i) {
+        if(mShaderResourceInterface.IsUniformBlockPushConstant(i)) {
+            continue;
+        }
 
-    if(!nLiveUniformBlocks) {
-        return true;
+        ++nLiveUniformBlocks;
+        if(!mShaderResourceInterface.IsUniformBlockOpaque(i)) {
+            mVkDynamicBlocks.push_back(i);
+            ++nDescriptors;
+        } else {
+            nDescriptors += mShaderResourceInterface.GetUniformArraySize(i);
+        }
     }
+    std::sort(mVkDynamicBlocks.begin(), mVkDynamicBlocks.end(), [this](uint32_t a, uint32_t b) {
+        return mShaderResourceInterface.GetUniformBlockBinding(a) < mShaderResourceInterface.GetUniformBlockBinding(b);
+    });
 
-    if(!CreateDescriptorPool(nLiveUniformBlocks)) {
-        assert(0);
-        return false;
+    /// the color attachment of the framebuffer fetch takes one more binding
+    if(mFramebufferFetch) {
+        ++nLiveUniformBlocks;
+        ++nDescriptors;
     }
 
-    if(!CreateDescriptorSet()) {
+    /// descriptors are recorded straight into the command buffer, with the ring offsets in their buffer infos
+    mVkPushDescriptors = mVkContext->mIsPushDescriptorSupported && nLiveUniformBlocks &&
+                         nDescriptors <= GLOVE_MAX_PUSH_DESCRIPTORS;
+    mVkDescBufferInfos.assign(mShaderResourceInterface.GetLiveUniformBlocks(), VkDescriptorBufferInfo());
+    mVkDescWriteCount = 0;
+
+    /// otherwise uniform blocks are sourced from the context's uniform ring through dynamic offsets
+    mVkDynamicUniformBuffers = !mVkPushDescriptors && !mVkDynamicBlocks.empty() &&
+                               mVkDynamicBlocks.size() <= mVkContext->vkDeviceLimits.maxDescriptorSetUniformBuffersDynamic;
+    mVkDynamicOffsets.assign(mVkDynamicUniformBuffers ? mVkDynamicBlocks.size() : 0, 0);
+
+    if(!CreateDescriptorSetLayout(nLiveUniformBlocks)) {
         assert(0);
         return false;
     }
 
+    /// the set itself is allocated on its first update
+    mVkDescSetBindingCount = nLiveUniformBlocks;
+    mUpdateDescriptorSets  = true;
+
     return true;
 }
 
 void
-ShaderProgram::UpdateBuiltInUniformData(float minDepthRange, float maxDepthRange)
+ShaderProgram::UpdateBuiltInUniformData(float minDepthRange, float maxDepthRange, uint32_t depthRangeGeneration)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(mMinDepthRange == minDepthRange && mMaxDepthRange == maxDepthRange) {
+    if(mDepthRangeGeneration == depthRangeGeneration) {
         return;
     }
+    mDepthRangeGeneration = depthRangeGeneration;
 
-    mMinDepthRange = minDepthRange;
-    mMaxDepthRange = maxDepthRange;
-
-    int location;
-    if((location = GetUniformLocation("gl_DepthRange.near")) != -1) {
-        SetUniformData(location, sizeof(float), &mMinDepthRange);
+    if(mDepthRangeLocations[0] != -1) {
+        SetUniformData(mDepthRangeLocations[0], sizeof(float), &minDepthRange);
     }
 
-    if((location = GetUniformLocation("gl_DepthRange.far")) != -1) {
-        SetUniformData(location, sizeof(float), &mMaxDepthRange);
+    if(mDepthRangeLocations[1] != -1) {
+        SetUniformData(mDepthRangeLocations[1], sizeof(float), &maxDepthRange);
     }
 
-    if((location = GetUniformLocation("gl_DepthRange.diff")) != -1) {
-        float diffDepthRange = mMaxDepthRange - mMinDepthRange;
-        SetUniformData(location, sizeof(float), &diffDepthRange);
+    if(mDepthRangeLocations[2] != -1) {
+        float diffDepthRange = maxDepthRange - minDepthRange;
+        SetUniformData(mDepthRangeLocations[2], sizeof(float), &diffDepthRange);
     }
 }
 
@@ -1040,37 +1560,64 @@ void
 ShaderProgram::UpdateDescriptorSet(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
+    GLOVE_PROFILE_ZONE("ShaderProgram::UpdateDescriptorSet");
 
     Context *context = GetCurrentContext();
     assert(context);
-    assert(mVkDescSet);
     assert(mVkContext);
 
-    if(mShaderResourceInterface.GetLiveUniformBlocks() == 0) {
+    if(mShaderResourceInterface.GetLiveUniformBlocks() == 0 && !mFramebufferFetch) {
         return;
     }
 
-    /// Transfer any new local uniform data into the buffer objects
-    if(mUpdateDescriptorData) {
+    /// Transfer any new local uniform data into the uniform ring or the buffer objects.
+    /// Data in the ring is valid for a single frame, so it is revisited for every draw
+    vulkanAPI::RingBuffer *uniformRing = mVkDynamicUniformBuffers || mVkPushDescriptors ? context->GetUniformRing() : nullptr;
+    if(mUpdateDescriptorData || uniformRing) {
         bool allocatedNewBufferObject = false;
-        mShaderResourceInterface.UpdateUniformBufferData(mVkContext, &allocatedNewBufferObject);
+        mShaderResourceInterface.UpdateUniformBufferData(mVkContext, uniformRing, &allocatedNewBufferObject);
         if(allocatedNewBufferObject) {
             mUpdateDescriptorSets = true;
         }
 
+        for(uint32_t i = 0; i < mVkDynamicOffsets.size(); ++i) {
+            mVkDynamicOffsets[i] = mShaderResourceInterface.GetUniformBlockDynamicOffset(mVkDynamicBlocks[i]);
+        }
+
+        if(mVkPushDescriptors) {
+            for(uint32_t block : mVkDynamicBlocks) {
+                mVkDescBufferInfos[block]         = *mShaderResourceInterface.GetUniformBufferDescInfo(block);
+                mVkDescBufferInfos[block].offset += mShaderResourceInterface.GetUniformBlockDynamicOffset(block);
+            }
+        }
+
         mUpdateDescriptorData = false;
     }
 
+    /// Only push constants are used by this program
+    if(!mVkDescSetBindingCount) {
+        return;
+    }
+
     // Check if any texture is attached to a user-based FBO
+    const uint64_t submissionId = context->GetVkCommandBufferManager()->GetLastSubmissionId();
     for(uint32_t i = 0; i < mShaderResourceInterface.GetLiveUniforms(); ++i) {
-        if(mShaderResourceInterface.GetUniformType(i) == GL_SAMPLER_2D || mShaderResourceInterface.GetUniformType(i) == GL_SAMPLER_CUBE) {
+        if(IsGlSampler(mShaderResourceInterface.GetUniformType(i))) {
             for(int32_t j = 0; j < mShaderResourceInterface.GetUniformArraySize(i); ++j) {
                 const glsl_sampler_t textureUnit = *(glsl_sampler_t *)mShaderResourceInterface.GetUniformClientData(i);
 
                 /// Sampler might need an update
                 Texture *activeTexture = context->GetStateManager()->GetActiveObjectsState()->GetActiveTexture(
-                mShaderResourceInterface.GetUniformType(i) == GL_SAMPLER_2D ? GL_TEXTURE_2D : GL_TEXTURE_CUBE_MAP, textureUnit); // TODO remove mGlContext
-                if(context->GetResourceManager()->IsTextureAttachedToFBO(activeTexture)) {
+                GlSamplerToGlTextureTarget(mShaderResourceInterface.GetUniformType(i)), textureUnit); // TODO remove mGlContext
+
+                // the levels a demoted texture gave up under memory pressure are restored as it is sampled again
+                activeTexture->SetLastUsedSubmissionId(submissionId);
+                if(activeTexture->IsDemoted()) {
+                    activeTexture->Promote();
+                    mUpdateDescriptorSets = true;
+                }
+
+                if(activeTexture->IsColorAttached()) {
                     mUpdateDescriptorSets = true;
                     break;
                 }
@@ -1078,22 +1625,61 @@ ShaderProgram::UpdateDescriptorSet(void)
         }
     }
 
+    // textures demoted or restored since the sets were written have another view now
+    if(mResidencyGeneration != Texture::GetResidencyGeneration()) {
+        mResidencyGeneration  = Texture::GetResidencyGeneration();
+        mUpdateDescriptorSets = true;
+    }
+
     /// This can be true only in three occasions:
     /// 1. This is a freshly linked shader. So the descriptor sets need to be created
     /// 2. There has been an update in a sampler via the glUniform1i()
     /// 3. glBindTexture has been called
     /// 4. Texture is attached to a user-based FBO
-    if(!mUpdateDescriptorSets) {
+    /// Besides, the set has to be allocated again once its frame has been recycled
+    if(mVkPushDescriptors) {
+        if(mUpdateDescriptorSets) {
+            UpdateSamplerDescriptors(nullptr);
+        }
         return;
     }
 
-    UpdateSamplerDescriptors();
+    vulkanAPI::DescriptorAllocator *descAllocator = context->GetDescriptorAllocator();
+    if(!mUpdateDescriptorSets && mVkDescSet != VK_NULL_HANDLE &&
+       mVkDescAllocator == descAllocator && mVkDescSetEpoch == descAllocator->GetEpoch()) {
+        return;
+    }
+
+    UpdateSamplerDescriptors(descAllocator);
 
     mUpdateDescriptorSets = false;
 }
 
 void
-ShaderProgram::UpdateSamplerDescriptors(void)
+ShaderProgram::ReferenceVkResources(vulkanAPI::CommandBundle *bundle)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    bundle->Reference(vulkanAPI::CommandBundle::GetHandleKey(mVkPipelineLayout));
+
+    for(const VkDescriptorImageInfo &imageInfo : mVkDescImageInfos) {
+        bundle->Reference(vulkanAPI::CommandBundle::GetHandleKey(imageInfo.imageView));
+        bundle->Reference(vulkanAPI::CommandBundle::GetHandleKey(imageInfo.sampler));
+    }
+
+    for(uint32_t i = 0; i < mShaderResourceInterface.GetLiveUniformBlocks(); ++i) {
+        if(!mShaderResourceInterface.IsUniformBlockOpaque(i) && !mShaderResourceInterface.IsUniformBlockPushConstant(i)) {
+            bundle->Reference(vulkanAPI::CommandBundle::GetHandleKey(mShaderResourceInterface.GetUniformBufferDescInfo(i)->buffer));
+        }
+    }
+
+    if(mFramebufferFetch) {
+        bundle->Reference(vulkanAPI::CommandBundle::GetHandleKey(mVkDescInputInfo.imageView));
+    }
+}
+
+void
+ShaderProgram::UpdateSamplerDescriptors(vulkanAPI::DescriptorAllocator *descAllocator)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
@@ -1109,25 +1695,30 @@ ShaderProgram::UpdateSamplerDescriptors(void)
     }
 
     /// Get texture units from samplers
+    LinearAllocator *arena = context->GetFrameArena();
+    LinearAllocatorScope scope(arena);
+
     uint32_t samp = 0;
-    std::map<uint32_t, uint32_t> map_block_texDescriptor;
-    VkDescriptorImageInfo *textureDescriptors = nullptr;
+    uint32_t *blockTexDescriptors = arena->Allocate<uint32_t>(nLiveUniformBlocks);
+    memset(blockTexDescriptors, 0, nLiveUniformBlocks * sizeof(uint32_t));
+    mVkDescImageInfos.assign(nSamplers, VkDescriptorImageInfo());
     if(nSamplers) {
-        textureDescriptors = new VkDescriptorImageInfo[nSamplers];
-        memset(static_cast<void *>(textureDescriptors), 0, nSamplers * sizeof(*textureDescriptors));
+        VkDescriptorImageInfo *textureDescriptors = mVkDescImageInfos.data();
 
         for(uint32_t i = 0; i < mShaderResourceInterface.GetLiveUniforms(); ++i) {
-            if(mShaderResourceInterface.GetUniformType(i) == GL_SAMPLER_2D || mShaderResourceInterface.GetUniformType(i) == GL_SAMPLER_CUBE) {
+            if(IsGlSampler(mShaderResourceInterface.GetUniformType(i))) {
                 for(int32_t j = 0; j < mShaderResourceInterface.GetUniformArraySize(i); ++j) {
                     const glsl_sampler_t textureUnit = *(glsl_sampler_t *)mShaderResourceInterface.GetUniformClientData(i);
 
                     /// Sampler might need an update
                     Texture *activeTexture = context->GetStateManager()->GetActiveObjectsState()->GetActiveTexture(
-                    mShaderResourceInterface.GetUniformType(i) == GL_SAMPLER_2D ? GL_TEXTURE_2D : GL_TEXTURE_CUBE_MAP, textureUnit); // TODO remove mGlContext
+                    GlSamplerToGlTextureTarget(mShaderResourceInterface.GetUniformType(i)), textureUnit); // TODO remove mGlContext
                     // Calling a sampler from a fragment shader must return (0, 0, 0, 1) 
                     // when the sampler’s associated texture object is not complete.
                     if( !activeTexture->IsCompleted() || !activeTexture->IsNPOTAccessCompleted()) {
                         uint8_t pixels[4] = {0,0,0,255};
+                        // an incomplete volume is sampled as a single slice
+                        activeTexture->SetDepth(1);
                         for(GLint layer = 0; layer < activeTexture->GetLayersCount(); ++layer) {
                             for(GLint level = 0; level < activeTexture->GetMipLevelsCount(); ++level) {
                                 activeTexture->SetState(1, 1, level, layer, GL_RGBA, GL_UNSIGNED_BYTE, Texture::GetDefaultInternalAlignment(), pixels);
@@ -1140,9 +1731,15 @@ ShaderProgram::UpdateSamplerDescriptors(void)
                             activeTexture->PrepareVkImageLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
                         }
                     }
-                    else if(context->GetResourceManager()->IsTextureAttachedToFBO(activeTexture)) {
+                    else if(activeTexture->IsColorAttached() && !context->IsYInverted()) {
 
-                        // Get Inverted Data from FBO's Color Attachment Texture
+                        // FBOs are rendered with the rows of GL textures, so the attachment is sampled as is
+                        activeTexture->PrepareVkImageLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+                    }
+                    else if(activeTexture->IsColorAttached()) {
+
+                        // Without VK_KHR_maintenance1 the flip is done in the vertex shader for every FBO,
+                        // so get Inverted Data from FBO's Color Attachment Texture
                         GLenum dstInternalFormat = activeTexture->GetExplicitInternalFormat();
                         ImageRect srcRect(0, 0, activeTexture->GetWidth(), activeTexture->GetHeight(),
                             GlInternalFormatTypeToNumElements(dstInternalFormat, activeTexture->GetExplicitType()),
@@ -1191,7 +1788,7 @@ ShaderProgram::UpdateSamplerDescriptors(void)
                     textureDescriptors[samp].imageView   = activeTexture->GetVkImageView();
 
                     if(j == 0) {
-                        map_block_texDescriptor[mShaderResourceInterface.GetUniformBlockIndex(i)] = samp;
+                        blockTexDescriptors[mShaderResourceInterface.GetUniformBlockIndex(i)] = samp;
                     }
                     ++samp;
                 }
@@ -1200,33 +1797,102 @@ ShaderProgram::UpdateSamplerDescriptors(void)
     }
     assert(samp == nSamplers);
 
-    VkWriteDescriptorSet *writes = new VkWriteDescriptorSet[nLiveUniformBlocks];
-    memset(static_cast<void*>(writes), 0, nLiveUniformBlocks * sizeof(*writes));
+    if(mVkPushDescriptors) {
+        BuildDescriptorWrites(blockTexDescriptors);
+        ++GetCurrentContext()->GetStatistics()->descriptorUpdates;
+        mUpdateDescriptorSets = false;
+        return;
+    }
+
+    /// Sets already written in this frame are reused when the same textures and buffers recur
+    if(mVkDescAllocator != descAllocator || mVkDescSetEpoch != descAllocator->GetEpoch() ||
+       mVkDescSetCache.size() >= GLOVE_MAX_CACHED_DESCRIPTOR_SETS) {
+        mVkDescSetCache.clear();
+    }
+
+    std::string key;
     for(uint32_t i = 0; i < nLiveUniformBlocks; ++i) {
-        writes[i].sType      = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        writes[i].pNext      = nullptr;
-        writes[i].dstSet     = mVkDescSet;
-        writes[i].dstBinding = mShaderResourceInterface.GetUniformBlockBinding(i);
+        if(mShaderResourceInterface.IsUniformBlockPushConstant(i)) {
+            continue;
+        }
 
         if(mShaderResourceInterface.IsUniformBlockOpaque(i)) {
-            writes[i].pImageInfo      = &textureDescriptors[map_block_texDescriptor[i]];
-            writes[i].descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-            writes[i].descriptorCount = mShaderResourceInterface.GetUniformArraySize(i);
+            key.append(reinterpret_cast<const char *>(&mVkDescImageInfos[blockTexDescriptors[i]]),
+                       mShaderResourceInterface.GetUniformArraySize(i) * sizeof(VkDescriptorImageInfo));
         } else {
-            writes[i].descriptorCount = 1;
-            writes[i].descriptorType  = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-            writes[i].pBufferInfo     = mShaderResourceInterface.GetUniformBufferObject(i)->GetBufferDescInfo();
+            key.append(reinterpret_cast<const char *>(mShaderResourceInterface.GetUniformBufferDescInfo(i)), sizeof(VkDescriptorBufferInfo));
         }
     }
+    if(mFramebufferFetch) {
+        key.append(reinterpret_cast<const char *>(&mVkDescInputInfo), sizeof(VkDescriptorImageInfo));
+    }
 
-    vkUpdateDescriptorSets(mVkContext->vkDevice, nLiveUniformBlocks, writes, 0, nullptr);
+    auto cachedSet = mVkDescSetCache.find(key);
+    if(cachedSet != mVkDescSetCache.end()) {
+        mVkDescSet = cachedSet->second;
+        mUpdateDescriptorSets = false;
+        return;
+    }
 
-    delete[] writes;
-    delete[] textureDescriptors;
+    if(!CreateDescriptorSet(descAllocator)) {
+        assert(0);
+        return;
+    }
+    mVkDescSetCache[key] = mVkDescSet;
+
+    BuildDescriptorWrites(blockTexDescriptors);
+    mVkContext->vkDispatch.vkUpdateDescriptorSets(mVkContext->vkDevice, mVkDescWriteCount, mVkDescWrites.data(), 0, nullptr);
+    ++GetCurrentContext()->GetStatistics()->descriptorUpdates;
 
     mUpdateDescriptorSets = false;
 }
 
+void
+ShaderProgram::BuildDescriptorWrites(const uint32_t *blockTexDescriptors)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    const uint32_t nLiveUniformBlocks = mShaderResourceInterface.GetLiveUniformBlocks();
+
+    mVkDescWrites.assign(nLiveUniformBlocks + 1, VkWriteDescriptorSet());
+    VkWriteDescriptorSet *writes = mVkDescWrites.data();
+    uint32_t nWrites = 0;
+    for(uint32_t i = 0; i < nLiveUniformBlocks; ++i) {
+        if(mShaderResourceInterface.IsUniformBlockPushConstant(i)) {
+            continue;
+        }
+
+        VkWriteDescriptorSet &write = writes[nWrites++];
+        write.sType      = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.pNext      = nullptr;
+        write.dstSet     = mVkDescSet;
+        write.dstBinding = mShaderResourceInterface.GetUniformBlockBinding(i);
+
+        if(mShaderResourceInterface.IsUniformBlockOpaque(i)) {
+            write.pImageInfo      = &mVkDescImageInfos[blockTexDescriptors[i]];
+            write.descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            write.descriptorCount = mShaderResourceInterface.GetUniformArraySize(i);
+        } else {
+            write.descriptorCount = 1;
+            write.descriptorType  = GetUniformBlockDescriptorType(i);
+            write.pBufferInfo     = mVkPushDescriptors ? &mVkDescBufferInfos[i] : mShaderResourceInterface.GetUniformBufferDescInfo(i);
+        }
+    }
+
+    if(mFramebufferFetch) {
+        VkWriteDescriptorSet &write = writes[nWrites++];
+        write.sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.pNext           = nullptr;
+        write.dstSet          = mVkDescSet;
+        write.dstBinding      = nLiveUniformBlocks;
+        write.pImageInfo      = &mVkDescInputInfo;
+        write.descriptorType  = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+        write.descriptorCount = 1;
+    }
+
+    mVkDescWriteCount = nWrites;
+}
+
 void
 ShaderProgram::ResetVulkanVertexInput(void)
 {
@@ -1234,27 +1900,31 @@ ShaderProgram::ResetVulkanVertexInput(void)
 
     mVkPipelineVertexInput.vertexAttributeDescriptionCount = 0;
     mVkPipelineVertexInput.vertexBindingDescriptionCount = 0;
+    mVkPipelineVertexInput.pNext = nullptr;
     mActiveVertexVkBuffersCount = 0;
+    mVertexInputId = ++sVertexInputIdCounter;
+    mVertexInputSource = nullptr;
     memset(static_cast<void *>(mActiveVertexVkBuffers), 0, sizeof(mActiveVertexVkBuffers));
+    memset(static_cast<void *>(mActiveVertexVkBufferOffsets), 0, sizeof(mActiveVertexVkBufferOffsets));
 }
 
 void
-ShaderProgram::UpdateAttributeInterface(void)
+ShaderProgram::UpdateAttributeInterface(ShaderReflection *reflection)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    mShaderResourceInterface.SetReflection(mShaderCompiler->GetShaderReflection());
+    mShaderResourceInterface.SetReflection(reflection);
     mShaderResourceInterface.UpdateAttributeInterface();
     mShaderResourceInterface.SetReflectionSize();
     mShaderResourceInterface.SetReflection(nullptr);
 }
 
 void
-ShaderProgram::BuildShaderResourceInterface(void)
+ShaderProgram::BuildShaderResourceInterface(ShaderReflection *reflection)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    mShaderResourceInterface.SetReflection(mShaderCompiler->GetShaderReflection());
+    mShaderResourceInterface.SetReflection(reflection);
     mShaderResourceInterface.CreateInterface();
     mShaderResourceInterface.SetReflection(nullptr);
     mShaderResourceInterface.AllocateUniformClientData();
@@ -1263,7 +1933,113 @@ ShaderProgram::BuildShaderResourceInterface(void)
     mShaderResourceInterface.SetActiveUniformMaxLength();
     mShaderResourceInterface.SetActiveAttributeMaxLength();
 
+    /// the client data has been reset, so the depth range is written again on the next draw
+    mDepthRangeLocations[0] = GetUniformLocation("gl_DepthRange.near");
+    mDepthRangeLocations[1] = GetUniformLocation("gl_DepthRange.far");
+    mDepthRangeLocations[2] = GetUniformLocation("gl_DepthRange.diff");
+    mDepthRangeGeneration   = 0;
+
     AllocateVkDescriptoSet();
     mUpdateDescriptorSets = true;
     mUpdateDescriptorData = true;
+
+    InitSpecializationInfo();
+}
+
+void
+ShaderProgram::InitSpecializationInfo(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    mVkSpecializationEntries.clear();
+    mSpecializationData.clear();
+    mSpecializationLocations.clear();
+
+    /// gl_Position.y is flipped in the vertex shader when the viewport cannot be
+    if(mVkContext && !mVkContext->mIsMaintenanceExtSupported) {
+        const float yScale = -1.0f;
+        const VkSpecializationMapEntry entry = { GLOVE_SPEC_CONSTANT_Y_SCALE_ID, 0, sizeof(yScale) };
+        mVkSpecializationEntries.push_back(entry);
+        mSpecializationData.resize(sizeof(yScale));
+        memcpy(mSpecializationData.data(), &yScale, sizeof(yScale));
+    }
+
+    /// the rotation of gl_Position onto pre-rotated surfaces, none until SetPreTransform() is called
+    const float rotation[2] = { 1.0f, 0.0f };
+    mPreTransformDataOffset = static_cast<uint32_t>(mSpecializationData.size());
+    for(uint32_t i = 0; i < 2; ++i) {
+        const VkSpecializationMapEntry entry = { GLOVE_SPEC_CONSTANT_ROTATION_ID + i, mPreTransformDataOffset + i * static_cast<uint32_t>(sizeof(float)), sizeof(float) };
+        mVkSpecializationEntries.push_back(entry);
+    }
+    mSpecializationData.resize(mPreTransformDataOffset + sizeof(rotation));
+    memcpy(mSpecializationData.data() + mPreTransformDataOffset, rotation, sizeof(rotation));
+    mPreTransform = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+
+    /// the specialized uniforms are scalars, whose constant ids follow their push constant offsets
+    for(uint32_t i = 0; i < mShaderResourceInterface.GetLiveUniforms(); ++i) {
+        const uint32_t block = static_cast<uint32_t>(mShaderResourceInterface.GetUniformBlockIndex(i));
+        if(!mShaderResourceInterface.IsUniformBlockSpecialization(block)) {
+            continue;
+        }
+
+        const VkSpecializationMapEntry entry = { GLOVE_SPEC_CONSTANT_UNIFORM_BASE_ID + mShaderResourceInterface.GetUniformBlockPushConstantOffset(block) / 4,
+                                                 static_cast<uint32_t>(mSpecializationData.size()), sizeof(uint32_t) };
+        mVkSpecializationEntries.push_back(entry);
+        mSpecializationLocations.push_back(mShaderResourceInterface.GetUniform(i)->location);
+        mSpecializationData.resize(mSpecializationData.size() + sizeof(uint32_t), 0);
+    }
+
+    mVkSpecializationInfo.mapEntryCount = static_cast<uint32_t>(mVkSpecializationEntries.size());
+    mVkSpecializationInfo.pMapEntries   = mVkSpecializationEntries.data();
+    mVkSpecializationInfo.dataSize      = mSpecializationData.size();
+    mVkSpecializationInfo.pData         = mSpecializationData.data();
+    mUpdateSpecializationData           = !mSpecializationLocations.empty();
+}
+
+bool
+ShaderProgram::UpdateSpecializationData(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!mUpdateSpecializationData) {
+        return false;
+    }
+    mUpdateSpecializationData = false;
+
+    /// the uniform entries are the last ones
+    const size_t firstEntry = mVkSpecializationEntries.size() - mSpecializationLocations.size();
+    bool updated = false;
+    for(size_t i = 0; i < mSpecializationLocations.size(); ++i) {
+        uint32_t value;
+        mShaderResourceInterface.GetUniformClientData(mSpecializationLocations[i], sizeof(value), &value);
+
+        uint8_t *data = mSpecializationData.data() + mVkSpecializationEntries[firstEntry + i].offset;
+        if(memcmp(data, &value, sizeof(value))) {
+            memcpy(data, &value, sizeof(value));
+            updated = true;
+        }
+    }
+
+    return updated;
+}
+
+bool
+ShaderProgram::SetPreTransform(VkSurfaceTransformFlagBitsKHR preTransform)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(mPreTransform == preTransform) {
+        return false;
+    }
+    mPreTransform = preTransform;
+
+    /// the viewport flips Y after the shader has rotated, which turns the rotation the other way
+    float rotation[2];
+    GetVkSurfaceTransformRotation(preTransform, &rotation[0], &rotation[1]);
+    if(mVkContext && mVkContext->mIsMaintenanceExtSupported) {
+        rotation[1] = -rotation[1];
+    }
+    memcpy(mSpecializationData.data() + mPreTransformDataOffset, rotation, sizeof(rotation));
+
+    return true;
 }
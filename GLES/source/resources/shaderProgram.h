@@ -27,34 +27,101 @@
 #include "shader.h"
 #include "shaderResourceInterface.h"
 #include "utils/cacheManager.h"
-#include "genericVertexAttribute.h"
+#include "vertexArray.h"
 #include "vulkan/pipelineCache.h"
+#include "vulkan/descriptorAllocator.h"
 #include "refObject.h"
+#include <unordered_map>
+
+#ifndef GLOVE_MAX_CACHED_DESCRIPTOR_SETS
+#define GLOVE_MAX_CACHED_DESCRIPTOR_SETS                64
+#endif // GLOVE_MAX_CACHED_DESCRIPTOR_SETS
+
+/// draws for which the textures of a program must keep their samplers before these are baked
+/// into its set layout, when GLOVE_IMMUTABLE_SAMPLERS is set
+#ifndef GLOVE_IMMUTABLE_SAMPLERS_STABLE_DRAWS
+#define GLOVE_IMMUTABLE_SAMPLERS_STABLE_DRAWS           64
+#endif // GLOVE_IMMUTABLE_SAMPLERS_STABLE_DRAWS
+#define GLOVE_IMMUTABLE_SAMPLERS_ENV                    "GLOVE_IMMUTABLE_SAMPLERS"
+
+/// OES_get_program_binary container: a header, the serialized reflection, the SPIR-V
+/// of both stages and, when the program has created pipelines, its VkPipelineCache data
+#define GLOVE_PROGRAM_BINARY_MAGIC                      0x42504c47 // "GLPB"
+/// bumped whenever the layout of the binary or of the reflection changes
+#define GLOVE_PROGRAM_BINARY_VERSION                    1
 
 class Context;
 
+namespace vulkanAPI {
+class CommandBundle;
+}
+
 class ShaderProgram : public refObject {
 private:
+    typedef VertexArray::vertexInputLayout              vertexInputLayout;
+
     const vulkanAPI::vkContext_t                       *mVkContext;
 
     VkDescriptorSetLayout                               mVkDescSetLayout;
     VkDescriptorSetLayoutBinding                       *mVkDescSetLayoutBind;
-    VkDescriptorPool                                    mVkDescPool;
+    uint32_t                                            mVkDescSetBindingCount;
+    /// the set is allocated from the context's per-frame allocator and valid while its epoch is current
     VkDescriptorSet                                     mVkDescSet;
+    vulkanAPI::DescriptorAllocator                     *mVkDescAllocator;
+    uint64_t                                            mVkDescSetEpoch;
+    /// residency generation of the textures the descriptors were last written with
+    uint32_t                                            mResidencyGeneration;
+    /// sets written in the current epoch, keyed on the image and buffer infos they hold
+    std::unordered_map<std::string, VkDescriptorSet>   mVkDescSetCache;
+    std::vector<VkDescriptorImageInfo>                  mVkDescImageInfos;
+    /// the color attachment read by gl_LastFragData, at the binding that follows the uniform blocks
+    bool                                                mFramebufferFetch;
+    VkDescriptorImageInfo                               mVkDescInputInfo;
+    std::vector<VkWriteDescriptorSet>                   mVkDescWrites;
+    uint32_t                                            mVkDescWriteCount;
+    /// with VK_KHR_push_descriptor the writes are pushed for every draw instead of a set being bound
+    bool                                                mVkPushDescriptors;
+    std::vector<VkDescriptorBufferInfo>                 mVkDescBufferInfos;
     VkPipelineLayout                                    mVkPipelineLayout;
+    /// samplers per uniform block, baked into the set layout while mVkImmutableSamplersBaked, and
+    /// held until the layouts are released. A program whose samplers change after all never bakes them again
+    std::vector<VkSampler>                              mVkImmutableSamplers;
+    bool                                                mVkImmutableSamplersBaked;
+    bool                                                mVkImmutableSamplersRejected;
+    uint32_t                                            mStableSamplerDraws;
+    bool                                                mVkDynamicUniformBuffers;
+    /// non opaque uniform blocks in binding order, as expected for their dynamic offsets
+    std::vector<uint32_t>                               mVkDynamicBlocks;
+    std::vector<uint32_t>                               mVkDynamicOffsets;
 
     vulkanAPI::PipelineCache                           *mPipelineCache;
     CacheManager                                       *mCacheManager;
+    /// name of the program in the shading namespace of the share group
+    uint32_t                                            mShadingId;
 
     VkPipelineVertexInputStateCreateInfo                mVkPipelineVertexInput;
     VkVertexInputBindingDescription                     mVkVertexInputBinding[GLOVE_MAX_VERTEX_ATTRIBS];
     VkVertexInputAttributeDescription                   mVkVertexInputAttribute[GLOVE_MAX_VERTEX_ATTRIBS];
+    /// instance divisor per binding; the ones other than 0 and 1 are chained to the vertex input state
+    uint32_t                                            mVertexInputDivisors[GLOVE_MAX_VERTEX_ATTRIBS];
+#ifdef VK_EXT_vertex_attribute_divisor
+    VkPipelineVertexInputDivisorStateCreateInfoEXT      mVkPipelineVertexInputDivisor;
+    VkVertexInputBindingDivisorDescriptionEXT           mVkVertexInputBindingDivisor[GLOVE_MAX_VERTEX_ATTRIBS];
+#endif // VK_EXT_vertex_attribute_divisor
 
     uint32_t                                            mActiveVertexVkBuffersCount;
     VkBuffer                                            mActiveVertexVkBuffers[GLOVE_MAX_VERTEX_ATTRIBS];
+    VkDeviceSize                                        mActiveVertexVkBufferOffsets[GLOVE_MAX_VERTEX_ATTRIBS];
+    /// id of the attribute locations of the current link, vertex arrays bake their layout against it
+    uint64_t                                            mVertexInputId;
+    /// vertex array, and its layout generation, the active vertex buffers were gathered from
+    const VertexArray                                  *mVertexInputSource;
+    uint64_t                                            mVertexInputSourceGeneration;
+    static std::atomic<uint64_t>                        sVertexInputIdCounter;
 
     BufferObject                                       *mExplicitIbo;
     VkBuffer                                            mActiveIndexVkBuffer;
+    VkIndexType                                         mActiveIndexVkType;
 
     bool                                                mUpdateDescriptorSets;
     bool                                                mUpdateDescriptorData;
@@ -62,8 +129,20 @@ private:
     bool                                                mIsPrecompiled;
     bool                                                mValidated;
 
-    float                                               mMinDepthRange;
-    float                                               mMaxDepthRange;
+    /// gl_DepthRange locations, resolved at link time, and the generation of the depth range they hold
+    int                                                 mDepthRangeLocations[3];
+    uint32_t                                            mDepthRangeGeneration;
+
+    /// specialization of both stages: the Y scale of gl_Position (see FixPosition()) and
+    /// the uniforms named in '#pragma glove_specialize', whose values are read from their client data
+    VkSpecializationInfo                                mVkSpecializationInfo;
+    std::vector<VkSpecializationMapEntry>               mVkSpecializationEntries;
+    std::vector<uint8_t>                                mSpecializationData;
+    std::vector<uint32_t>                               mSpecializationLocations;
+    bool                                                mUpdateSpecializationData;
+    /// the rotation of gl_Position onto the surface, at this offset of the specialization data
+    VkSurfaceTransformFlagBitsKHR                       mPreTransform;
+    uint32_t                                            mPreTransformDataOffset;
 
     uint32_t                                            mStageCount;
 #define MAX_SHADERS 2
@@ -77,27 +156,43 @@ private:
     ShaderCompiler                                     *mShaderCompiler;
     ShaderResourceInterface                             mShaderResourceInterface;
 
+    /// link job queued on the context's compile worker, 0 when there is none
+    uint64_t                                            mLinkTicket;
+    /// reflection and SPIR-V produced by the glslang part of the link, consumed when it is finished
+    std::vector<uint8_t>                                mLinkBinary;
+    /// program cache key, 0 when the cache is bypassed
+    uint64_t                                            mLinkKey;
+    bool                                                mLinkCached;
+    std::string                                         mInfoLog;
+
     bool                                                ValidateProgram(void);
     void                                                ReleaseVkObjects(void);
     bool                                                AllocateVkDescriptoSet(void);
     bool                                                CreateDescriptorSetLayout(uint32_t nLiveUniformBlocks);
-    bool                                                CreateDescriptorPool(uint32_t nLiveUniformBlocks);
-    bool                                                CreateDescriptorSet(void);
-    void                                                UpdateSamplerDescriptors(void);
+    bool                                                RecreateDescriptorSetLayout(void);
+    bool                                                GetBoundSamplers(std::vector<VkSampler> *samplers);
+    void                                                ReleaseImmutableSamplers(void);
+    bool                                                CreateDescriptorSet(vulkanAPI::DescriptorAllocator *descAllocator);
+    VkDescriptorType                                    GetUniformBlockDescriptorType(uint32_t index) const;
+    static VkShaderStageFlags                           ShaderTypeToVkShaderStage(shader_type_t type);
+    void                                                UpdateSamplerDescriptors(vulkanAPI::DescriptorAllocator *descAllocator);
+    void                                                BuildDescriptorWrites(const uint32_t *blockTexDescriptors);
 
     uint32_t                                            SerializeShadersSpirv(void *binary);
     uint32_t                                            DeserializeShadersSpirv(const void *binary);
 
     void                                                ResetVulkanVertexInput(void);
-    void                                                UpdateAttributeInterface(void);
-    void                                                BuildShaderResourceInterface(void);
-    bool                                                UpdateVertexAttribProperties(size_t vertCount, uint32_t firstVertex, std::vector<GenericVertexAttribute>& genericVertAttribs, std::map<uint32_t, uint32_t>& vboLocationBindings, bool updatedVertexAttrib);
-    void                                                GenerateVertexInputProperties(std::vector<GenericVertexAttribute>& genericVertAttribs, const std::map<uint32_t, uint32_t>& vboLocationBindings);
+    void                                                UpdateAttributeInterface(ShaderReflection *reflection);
+    void                                                BuildShaderResourceInterface(ShaderReflection *reflection);
+    void                                                InitSpecializationInfo(void);
+    bool                                                UpdateVertexAttribProperties(size_t vertCount, uint32_t firstVertex, uint32_t instanceCount, std::vector<GenericVertexAttribute>& genericVertAttribs,
+                                                                                 vulkanAPI::RingBuffer *streamRing, bool updatedVertexAttrib, vertexInputLayout *layout, bool *bakeable);
+    void                                                SetActiveVertexBuffers(const vertexInputLayout *layout);
+    bool                                                GenerateVertexInputProperties(const vertexInputLayout *layout);
 
-    void                                                LineLoopConversion(void* data, uint32_t indexCount, size_t elementByteSize);
-    bool                                                ConvertIndexBufferToUint16(const void* srcData, size_t elementCount, BufferObject** ibo);
+    bool                                                ConvertIndexBufferToUint16(const void* srcData, size_t elementCount, void* dstData);
     bool                                                AllocateExplicitIndexBuffer(const void* data, size_t size, BufferObject** ibo);
-    uint32_t                                            GetMaxIndex(BufferObject* ibo, uint32_t indexCount, size_t actualSize, VkDeviceSize offset);
+    uint32_t                                            GetMaxIndex(BufferObject* ibo, uint32_t indexCount, size_t elementByteSize, VkDeviceSize offset);
 
 public:
     ShaderProgram(const vulkanAPI::vkContext_t *vkContext = nullptr);
@@ -105,23 +200,37 @@ public:
 
     void                                                SetPipelineVertexInputStateInfo(void);
     bool                                                SetPipelineShaderStage(uint32_t &pipelineShaderStageCount, int *pipelineStagesIDs, VkPipelineShaderStageCreateInfo *pipelineShaderStages);
-    void                                                PrepareIndexBufferObject(uint32_t* firstIndex, uint32_t* maxIndex, uint32_t indexCount, GLenum type, const void* indices, BufferObject* ibo);
-    bool                                                PrepareVertexAttribBufferObjects(size_t vertCount, uint32_t firstVertex, std::vector<GenericVertexAttribute>& genericVertAttribs, bool updatedVertexAttrib);
+    bool                                                UpdateSpecializationData(void);
+    bool                                                SetPreTransform(VkSurfaceTransformFlagBitsKHR preTransform);
+    bool                                                UpdateImmutableSamplers(void);
+    void                                                PrepareIndexBufferObject(uint32_t* firstIndex, uint32_t* maxIndex, uint32_t indexCount, GLenum type, const void* indices, BufferObject* ibo, vulkanAPI::RingBuffer *streamRing, bool needsMaxIndex);
+    static VkIndexType                                  IndexElementSizeToVkIndexType(size_t elementByteSize);
+    bool                                                HasClientVertexAttribs(const std::vector<GenericVertexAttribute>& genericVertAttribs);
+    uint32_t                                            GetVertexBufferObjects(std::vector<GenericVertexAttribute>& genericVertAttribs,
+                                                                               BufferObject **vbos);
+    bool                                                PrepareVertexAttribBufferObjects(size_t vertCount, uint32_t firstVertex, uint32_t instanceCount, VertexArray *vertexArray, vulkanAPI::RingBuffer *streamRing, bool updatedVertexAttrib);
     Shader                                             *IsShaderAttached(Shader *shader) const;
     void                                                AttachShader(Shader *shader);
     void                                                DetachShader(Shader *shader);
     int                                                 GetInfoLogLength(void) const;
     char                                               *GetInfoLog(void) const;
-    bool                                                LinkProgram();
+    bool                                                LinkProgram(void);
+    /// the glslang part of the link, which only touches the compiler and may run on the compile worker
+    void                                                LinkShaders(void);
+    /// builds the resource interface of a link, on the thread the context is current on
+    bool                                                FinishLink(void);
 
     void                                                DetachShaders(void);
 
     void                                                Validate(void);
     bool                                                ValidateSamplers(void);
     void                                                EnableUpdateOfDescriptorSets(void)                  { FUN_ENTRY(GL_LOG_TRACE); mUpdateDescriptorSets = true; }
+    void                                                SetFramebufferFetchView(VkImageView view)           { FUN_ENTRY(GL_LOG_TRACE); if(mVkDescInputInfo.imageView != view) {
+                                                                                                                                       mVkDescInputInfo.imageView = view;
+                                                                                                                                       mUpdateDescriptorSets = true; } }
 
-    void                                                UsePrecompiledBinary(const void *binary, size_t binarySize);
-    void                                                GetBinaryData(void *binary, GLsizei *binarySize);
+    bool                                                UsePrecompiledBinary(const void *binary, size_t binarySize);
+    void                                                GetBinaryData(void *binary, GLsizei bufSize, GLsizei *binarySize);
     GLsizei                                             GetBinaryLength(void);
 
     uint32_t                                            GetNumberOfActiveUniforms(void)             const   { FUN_ENTRY(GL_LOG_TRACE); return mShaderResourceInterface.GetLiveUniforms(); }
@@ -141,30 +250,51 @@ public:
     VkPipelineVertexInputStateCreateInfo               *GetVkPipelineVertexInput(void)                      { FUN_ENTRY(GL_LOG_TRACE); return &mVkPipelineVertexInput; }
     VkPipelineLayout                                    GetVkPipelineLayout(void)                   const   { FUN_ENTRY(GL_LOG_TRACE); return mVkPipelineLayout; }
     int                                                 GetStagesIDs(uint32_t index)                const   { FUN_ENTRY(GL_LOG_TRACE); return mStagesIDs[index]; }
+    uint64_t                                            GetLinkTicket(void)                         const   { FUN_ENTRY(GL_LOG_TRACE); return mLinkTicket; }
+    CacheManager                                       *GetCacheManager(void)                       const   { FUN_ENTRY(GL_LOG_TRACE); return mCacheManager; }
+    uint32_t                                            GetShadingId(void)                          const   { FUN_ENTRY(GL_LOG_TRACE); return mShadingId; }
     const VkDescriptorSet                              *GetVkDescSet(void)                          const   { FUN_ENTRY(GL_LOG_TRACE); return &mVkDescSet; }
+    uint32_t                                            GetVkDescSetBindingCount(void)              const   { FUN_ENTRY(GL_LOG_TRACE); return mVkDescSetBindingCount; }
+    bool                                                UsesFramebufferFetch(void)                  const   { FUN_ENTRY(GL_LOG_TRACE); return mFramebufferFetch; }
+    bool                                                IsVkPushDescriptors(void)                   const   { FUN_ENTRY(GL_LOG_TRACE); return mVkPushDescriptors; }
+    uint32_t                                            GetVkDescWriteCount(void)                   const   { FUN_ENTRY(GL_LOG_TRACE); return mVkDescWriteCount; }
+    const VkWriteDescriptorSet                         *GetVkDescWrites(void)                       const   { FUN_ENTRY(GL_LOG_TRACE); return mVkDescWrites.data(); }
+    uint32_t                                            GetVkDynamicOffsetCount(void)               const   { FUN_ENTRY(GL_LOG_TRACE); return static_cast<uint32_t>(mVkDynamicOffsets.size()); }
+    const uint32_t                                     *GetVkDynamicOffsets(void)                   const   { FUN_ENTRY(GL_LOG_TRACE); return mVkDynamicOffsets.data(); }
+    uint32_t                                            GetPushConstantSize(void)                   const   { FUN_ENTRY(GL_LOG_TRACE); return mShaderResourceInterface.GetPushConstantSize(); }
+    const uint8_t                                      *GetPushConstantData(void)                   const   { FUN_ENTRY(GL_LOG_TRACE); return mShaderResourceInterface.GetPushConstantData(); }
+    VkShaderStageFlags                                  GetVkPushConstantStages(void)               const   { FUN_ENTRY(GL_LOG_TRACE); return ShaderTypeToVkShaderStage(mShaderResourceInterface.GetPushConstantStages()); }
+    uint32_t                                            GetReflectionSize(void)                     const   { FUN_ENTRY(GL_LOG_TRACE); return mShaderResourceInterface.GetReflectionSize(); }
     uint32_t                                            GetActiveVertexVkBuffersCount(void)         const   { FUN_ENTRY(GL_LOG_TRACE); return mActiveVertexVkBuffersCount; }
     const VkBuffer                                     *GetActiveVertexVkBuffers(void)              const   { FUN_ENTRY(GL_LOG_TRACE); return mActiveVertexVkBuffers; }
+    const VkDeviceSize                                 *GetActiveVertexVkBufferOffsets(void)        const   { FUN_ENTRY(GL_LOG_TRACE); return mActiveVertexVkBufferOffsets; }
     VkBuffer                                            GetActiveIndexVkBuffer(void)                const   { FUN_ENTRY(GL_LOG_TRACE); return mActiveIndexVkBuffer; }
+    VkIndexType                                         GetActiveIndexVkType(void)                  const   { FUN_ENTRY(GL_LOG_TRACE); return mActiveIndexVkType; }
 
     void                                                SetVkContext(const vulkanAPI::vkContext_t *vkContext) { FUN_ENTRY(GL_LOG_TRACE); mVkContext = vkContext; mPipelineCache->SetContext(mVkContext);}
     void                                                SetShaderCompiler(ShaderCompiler* shaderCompiler)   { FUN_ENTRY(GL_LOG_TRACE); assert(shaderCompiler != nullptr); mShaderCompiler = shaderCompiler; }
     void                                                SetStagesIDs(uint32_t index, uint32_t id)           { FUN_ENTRY(GL_LOG_TRACE); mStagesIDs[index] = id; }
+    void                                                SetLinkTicket(uint64_t ticket)                      { FUN_ENTRY(GL_LOG_TRACE); mLinkTicket = ticket; }
 
     void                                                SetCustomAttribsLayout(const char *name, int index) { FUN_ENTRY(GL_LOG_TRACE); mShaderResourceInterface.SetCustomAttribsLayout(name, index); }
     void                                                SetUniformData(uint32_t location, size_t size, const void *ptr);
     void                                                GetUniformData(uint32_t location, size_t size, void *ptr) const;
     void                                                SetUniformSampler(uint32_t location, int count, const int *textureUnit);
     void                                                SetCacheManager(CacheManager *cacheManager);
+    void                                                SetShadingId(uint32_t id)                           { FUN_ENTRY(GL_LOG_TRACE); mShadingId = id; }
     void                                                UpdateDescriptorSet(void);
-    void                                                UpdateBuiltInUniformData(float minDepthRange, float maxDepthRange);
+    /// notes in bundle the textures and buffers that the descriptors of the last update refer to
+    void                                                ReferenceVkResources(vulkanAPI::CommandBundle *bundle);
+    void                                                UpdateBuiltInUniformData(float minDepthRange, float maxDepthRange, uint32_t depthRangeGeneration);
 
     uint32_t                                            GetNumberOfActiveAttributes(void) const;
     const
     ShaderResourceInterface::attribute                 *GetVertexAttribute(int index) const;
-    const string &                                      GetAttributeName(int index) const;
+    const char                                         *GetAttributeName(int index) const;
     int                                                 GetAttributeType(int index) const;
     int                                                 GetAttributeLocation(const char *name) const;
     VkPipelineCache                                     GetVkPipelineCache(void);
+    vulkanAPI::PipelineCache                           *GetPipelineCache(void);
     void                                                SetShaderModules(void);
 
     bool                                                HasVertexShader(void)                       const   { FUN_ENTRY(GL_LOG_TRACE); return (bool)mShaders[0]; }
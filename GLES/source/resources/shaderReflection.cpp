@@ -110,6 +110,13 @@ ShaderReflection::Serialize(void *binary) const
         rawDataPtr += sizeof(uint32_t);
         *rawDataPtr = mReflectionData.mUniformBlockReflection[i].isOpaque;
         rawDataPtr += sizeof(bool);
+        *rawDataPtr = mReflectionData.mUniformBlockReflection[i].isPushConstant;
+        rawDataPtr += sizeof(bool);
+        u32DataPtr = reinterpret_cast<uint32_t *>(rawDataPtr);
+        *u32DataPtr = mReflectionData.mUniformBlockReflection[i].pushConstantOffset;
+        rawDataPtr += sizeof(uint32_t);
+        *rawDataPtr = mReflectionData.mUniformBlockReflection[i].isSpecialization;
+        rawDataPtr += sizeof(bool);
     }
 
     return sizeof(reflectionData);
@@ -184,6 +191,13 @@ ShaderReflection::Deserialize(const void *binary)
         rawDataPtr += sizeof(uint32_t);
         mReflectionData.mUniformBlockReflection[i].isOpaque = *rawDataPtr;
         rawDataPtr += sizeof(bool);
+        mReflectionData.mUniformBlockReflection[i].isPushConstant = *rawDataPtr;
+        rawDataPtr += sizeof(bool);
+        u32DataPtr = reinterpret_cast<const uint32_t *>(rawDataPtr);
+        mReflectionData.mUniformBlockReflection[i].pushConstantOffset = *u32DataPtr;
+        rawDataPtr += sizeof(uint32_t);
+        mReflectionData.mUniformBlockReflection[i].isSpecialization = *rawDataPtr;
+        rawDataPtr += sizeof(bool);
     }
 
     return sizeof(reflectionData);
@@ -205,6 +219,8 @@ ShaderReflection::Print() const
         printf("%s , blockSize: %zu)\n", mReflectionData.mUniformBlockReflection[i].glslBlockName, mReflectionData.mUniformBlockReflection[i].blockSize);
         printf("blockStage: %u\n", mReflectionData.mUniformBlockReflection[i].blockStage);
         printf("binding: %u, isOpaque: %u\n", mReflectionData.mUniformBlockReflection[i].binding, mReflectionData.mUniformBlockReflection[i].isOpaque);
+        printf("isPushConstant: %u, pushConstantOffset: %u\n", mReflectionData.mUniformBlockReflection[i].isPushConstant, mReflectionData.mUniformBlockReflection[i].pushConstantOffset);
+        printf("isSpecialization: %u\n", mReflectionData.mUniformBlockReflection[i].isSpecialization);
     }
 
     printf("\nGL_ACTIVE_UNIFORMS: %d\n", mReflectionData.mLiveUniforms);
@@ -60,6 +60,9 @@ private:
         size_t        blockSize;
         shader_type_t blockStage;
         bool          isOpaque;
+        bool          isPushConstant;
+        uint32_t      pushConstantOffset;
+        bool          isSpecialization;
     } uniformBlock;
 
     typedef struct {
@@ -106,6 +109,9 @@ public:
     inline size_t        GetUniformBlockBlockSize(uint32_t index)                      const { FUN_ENTRY(GL_LOG_TRACE); return mReflectionData.mUniformBlockReflection[index].blockSize; }
     inline shader_type_t GetUniformBlockBlockStage(uint32_t index)                     const { FUN_ENTRY(GL_LOG_TRACE); return mReflectionData.mUniformBlockReflection[index].blockStage; }
     inline bool          GetUniformBlockOpaque(uint32_t index)                         const { FUN_ENTRY(GL_LOG_TRACE); return mReflectionData.mUniformBlockReflection[index].isOpaque; }
+    inline bool          GetUniformBlockPushConstant(uint32_t index)                   const { FUN_ENTRY(GL_LOG_TRACE); return mReflectionData.mUniformBlockReflection[index].isPushConstant; }
+    inline uint32_t      GetUniformBlockPushConstantOffset(uint32_t index)             const { FUN_ENTRY(GL_LOG_TRACE); return mReflectionData.mUniformBlockReflection[index].pushConstantOffset; }
+    inline bool          GetUniformBlockSpecialization(uint32_t index)                 const { FUN_ENTRY(GL_LOG_TRACE); return mReflectionData.mUniformBlockReflection[index].isSpecialization; }
 
 /// Set Functions 
     inline void          SetLiveAttributes(uint32_t LiveAttributes)                          { FUN_ENTRY(GL_LOG_TRACE); mReflectionData.mLiveAttributes = LiveAttributes; }
@@ -128,6 +134,10 @@ public:
     inline void          SetUniformBlockBlockSize(size_t blockSize, uint32_t index)          { FUN_ENTRY(GL_LOG_TRACE); mReflectionData.mUniformBlockReflection[index].blockSize = blockSize; }
     inline void          SetUniformBlockBlockStage(shader_type_t blockStage, uint32_t index) { FUN_ENTRY(GL_LOG_TRACE); mReflectionData.mUniformBlockReflection[index].blockStage = blockStage; }
     inline void          SetUniformBlockOpaque(bool opaque, uint32_t index)                  { FUN_ENTRY(GL_LOG_TRACE); mReflectionData.mUniformBlockReflection[index].isOpaque = opaque; }
+    inline void          SetUniformBlockPushConstant(bool pushConstant, uint32_t offset, uint32_t index)
+                                                                                             { FUN_ENTRY(GL_LOG_TRACE); mReflectionData.mUniformBlockReflection[index].isPushConstant     = pushConstant;
+                                                                                                                        mReflectionData.mUniformBlockReflection[index].pushConstantOffset = offset; }
+    inline void          SetUniformBlockSpecialization(bool specialization, uint32_t index)  { FUN_ENTRY(GL_LOG_TRACE); mReflectionData.mUniformBlockReflection[index].isSpecialization = specialization; }
 };
 
 #endif //__SHADERREFLECTION_H__
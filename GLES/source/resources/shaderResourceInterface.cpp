@@ -32,9 +32,55 @@
 #include "utils/glLogger.h"
 #include <algorithm>
 
+/// A fixed element size lets the compiler turn every copy into a few vector moves
+template<size_t ELEMENT_SIZE>
+static inline void
+CopyElements(uint8_t *dst, size_t dstStride, const uint8_t *src, size_t count)
+{
+    for(size_t i = 0; i < count; ++i, dst += dstStride, src += ELEMENT_SIZE) {
+        memcpy(dst, src, ELEMENT_SIZE);
+    }
+}
+
+/// FNV-1a hash of a uniform name
+static inline uint32_t
+HashName(const char *name, size_t length)
+{
+    uint32_t hash = 2166136261u;
+    for(size_t i = 0; i < length; ++i) {
+        hash = (hash ^ static_cast<uint8_t>(name[i])) * 16777619u;
+    }
+    return hash;
+}
+
+/// Copies tightly packed client data into its std140 layout
+static void
+CopyUniformToStd140(uint8_t *dst, size_t dstStride, const uint8_t *src, size_t elementSize, size_t count)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    /// vec4 and matrix arrays keep their layout, so they are copied at once
+    if(dstStride == elementSize) {
+        memcpy(dst, src, count * elementSize);
+        return;
+    }
+
+    switch(elementSize) {
+    case 4:  CopyElements<4> (dst, dstStride, src, count); break;
+    case 8:  CopyElements<8> (dst, dstStride, src, count); break;
+    case 12: CopyElements<12>(dst, dstStride, src, count); break;
+    default:
+        for(size_t i = 0; i < count; ++i) {
+            memcpy(dst + i * dstStride, src + i * elementSize, elementSize);
+        }
+        break;
+    }
+}
+
 ShaderResourceInterface::ShaderResourceInterface()
 : mLiveAttributes(0), mLiveUniforms(0), mLiveUniformBlocks(0),
-  mActiveAttributeMaxLength(0), mActiveUniformMaxLength(0), mReflectionSize(0), mCacheManager(nullptr)
+  mActiveAttributeMaxLength(0), mActiveUniformMaxLength(0), mReflectionSize(0),
+  mPushConstantStages(SHADER_TYPE_INVALID), mCacheManager(nullptr)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 }
@@ -44,6 +90,7 @@ ShaderResourceInterface::~ShaderResourceInterface()
     FUN_ENTRY(GL_LOG_TRACE);
 
     Reset();
+    ReleaseUniformBufferObjects(nullptr);
 }
 
 void
@@ -58,6 +105,35 @@ ShaderResourceInterface::Reset(void)
     mAttributeInterface.clear();
     mUniformInterface.clear();
     mUniformBlockInterface.clear();
+
+    mUniformDataInterface.clear();
+    mUniformClientData.clear();
+    mUniformLocations.clear();
+    mLocationNames.clear();
+    mLocationValues.clear();
+    mLocationTable.clear();
+
+    mPushConstantData.clear();
+    mPushConstantStages = SHADER_TYPE_INVALID;
+}
+
+void
+ShaderResourceInterface::ReleaseUniformBufferObjects(CacheManager *cacheManager)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // buffers of a relinked program may still be read by command buffers in flight
+    for(auto &blockData : mUniformBlockDataInterface) {
+        if(blockData.pBufferObject) {
+            if(cacheManager) {
+                cacheManager->CacheUBO(blockData.pBufferObject);
+            } else {
+                delete blockData.pBufferObject;
+            }
+            blockData.pBufferObject = nullptr;
+        }
+    }
+    mUniformBlockDataInterface.clear();
 }
 
 void
@@ -95,7 +171,47 @@ ShaderResourceInterface::CreateInterface(void)
                                             mShaderReflection->GetUniformBlockBinding(i),
                                             mShaderReflection->GetUniformBlockBlockSize(i),
                                             mShaderReflection->GetUniformBlockBlockStage(i),
-                                            mShaderReflection->GetUniformBlockOpaque(i));
+                                            mShaderReflection->GetUniformBlockOpaque(i),
+                                            mShaderReflection->GetUniformBlockPushConstant(i),
+                                            mShaderReflection->GetUniformBlockPushConstantOffset(i),
+                                            mShaderReflection->GetUniformBlockSpecialization(i));
+    }
+}
+
+void
+ShaderResourceInterface::CreateReflection(void) const
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    mShaderReflection->Reset();
+    mShaderReflection->SetLiveAttributes(mLiveAttributes);
+    mShaderReflection->SetLiveUniforms(mLiveUniforms);
+    mShaderReflection->SetLiveUniformBlocks(static_cast<uint32_t>(mUniformBlockInterface.size()));
+
+    for(uint32_t i = 0; i < mLiveAttributes; ++i) {
+        mShaderReflection->SetAttributeName(mAttributeInterface[i].name, i);
+        mShaderReflection->SetAttributeType(mAttributeInterface[i].type, i);
+        mShaderReflection->SetAttributeLocation(mAttributeInterface[i].location, i);
+    }
+
+    for(uint32_t i = 0; i < mLiveUniforms; ++i) {
+        mShaderReflection->SetUniformReflectionName(mUniformInterface[i].name, i);
+        mShaderReflection->SetUniformLocation(mUniformInterface[i].location, i);
+        mShaderReflection->SetUniformBlockIndex(mUniformInterface[i].index, i);
+        mShaderReflection->SetUniformArraySize(mUniformInterface[i].arraySize, i);
+        mShaderReflection->SetUniformType(mUniformInterface[i].type, i);
+        mShaderReflection->SetUniformOffset(mUniformInterface[i].offset, i);
+    }
+
+    for(uint32_t i = 0; i < mUniformBlockInterface.size(); ++i) {
+        const uniformBlock &block = mUniformBlockInterface[i];
+        mShaderReflection->SetUniformBlockGlslBlockName(block.name, i);
+        mShaderReflection->SetUniformBlockBinding(block.binding, i);
+        mShaderReflection->SetUniformBlockBlockSize(block.memorySize, i);
+        mShaderReflection->SetUniformBlockBlockStage(block.stage, i);
+        mShaderReflection->SetUniformBlockOpaque(block.isOpaque, i);
+        mShaderReflection->SetUniformBlockPushConstant(block.isPushConstant, block.pushConstantOffset, i);
+        mShaderReflection->SetUniformBlockSpecialization(block.isSpecialization, i);
     }
 }
 
@@ -104,14 +220,67 @@ ShaderResourceInterface::AllocateUniformClientData(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    for(auto& uni : mUniformInterface) {
-        size_t   size = uni.arraySize * GlslTypeToSize(uni.type);
-        uint8_t* data = new uint8_t[size];
-        memset(static_cast<void *>(data), 0, size);
+    mUniformDataInterface.assign(mUniformInterface.size(), uniformData());
+
+    size_t   clientDataSize = 0;
+    uint32_t locationCount  = 0;
+    for(uint32_t i = 0; i < mUniformInterface.size(); ++i) {
+        const uniform &uni = mUniformInterface[i];
+
+        mUniformDataInterface[i].clientDataOffset = clientDataSize;
+        mUniformDataInterface[i].elementSize      = static_cast<uint32_t>(GlslTypeToSize(uni.type));
+        mUniformDataInterface[i].elementStride    = static_cast<uint32_t>(GlslTypeToAllignment(uni.type));
+        mUniformDataInterface[i].isBuiltIn        = IsBuildInUniform(uni.name);
 
-        mUniformDataInterface.insert(make_pair(uni.name, uniformData()));
-        map<std::string, uniformData>::iterator it = mUniformDataInterface.find(uni.name);
-        it->second.pClientData = data;
+        /// every uniform starts at an offset aligned for the widest glsl type
+        clientDataSize += (uni.arraySize * GlslTypeToSize(uni.type) + 15) & ~static_cast<size_t>(15);
+        locationCount   = std::max(locationCount, uni.location + uni.arraySize);
+    }
+    mUniformClientData.assign(clientDataSize, 0);
+
+    mUniformLocations.assign(locationCount, GLOVE_INVALID_OFFSET);
+    for(uint32_t i = 0; i < mUniformInterface.size(); ++i) {
+        const uniform &uni = mUniformInterface[i];
+
+        for(int32_t j = 0; j < uni.arraySize; ++j) {
+            mUniformLocations[uni.location + j] = i;
+        }
+    }
+
+    BuildLocationTable();
+}
+
+void
+ShaderResourceInterface::BuildLocationTable(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    mLocationNames.clear();
+    mLocationValues.clear();
+    for(const auto &uni : mUniformInterface) {
+        mLocationNames.push_back(uni.name);
+        mLocationValues.push_back(static_cast<int32_t>(uni.location));
+
+        for(int32_t j = 0; j < uni.arraySize; ++j) {
+            mLocationNames.push_back(NameTable::Intern(string(uni.name) + "[" + to_string(j) + "]"));
+            mLocationValues.push_back(static_cast<int32_t>(uni.location + j));
+        }
+    }
+
+    /// keep the table at most half full, so that probing sequences stay short
+    size_t tableSize = 1;
+    while(tableSize < 2 * mLocationNames.size()) {
+        tableSize <<= 1;
+    }
+    mLocationTable.assign(tableSize, GLOVE_INVALID_OFFSET);
+
+    const uint32_t mask = static_cast<uint32_t>(tableSize - 1);
+    for(uint32_t i = 0; i < mLocationNames.size(); ++i) {
+        uint32_t slot = HashName(mLocationNames[i], strlen(mLocationNames[i])) & mask;
+        while(mLocationTable[slot] != GLOVE_INVALID_OFFSET) {
+            slot = (slot + 1) & mask;
+        }
+        mLocationTable[slot] = i;
     }
 }
 
@@ -120,14 +289,31 @@ ShaderResourceInterface::AllocateUniformBufferObjects(const vulkanAPI::vkContext
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    for(auto &uniBlock : mUniformBlockInterface) {
-        if(!uniBlock.isOpaque) {
+    ReleaseUniformBufferObjects(mCacheManager);
+    mUniformBlockDataInterface.resize(mUniformBlockInterface.size());
 
-            mUniformBlockDataInterface.insert(make_pair(uniBlock.name, uniformBlockData()));
-            map<std::string, uniformBlockData>::iterator it = mUniformBlockDataInterface.find(uniBlock.name);
+    size_t pushConstantSize = 0;
+    mPushConstantStages     = SHADER_TYPE_INVALID;
+    for(uint32_t i = 0; i < mUniformBlockInterface.size(); ++i) {
+        const uniformBlock &uniBlock = mUniformBlockInterface[i];
+        if(uniBlock.isPushConstant) {
+            pushConstantSize    = std::max(pushConstantSize, uniBlock.pushConstantOffset + uniBlock.memorySize);
+            mPushConstantStages = static_cast<shader_type_t>(mPushConstantStages | uniBlock.stage);
+        }
+    }
+    mPushConstantData.assign(pushConstantSize, 0);
 
-            it->second.pBufferObject = new UniformBufferObject(vkContext);
-            it->second.pBufferObject->Allocate(uniBlock.memorySize, nullptr);
+    for(uint32_t i = 0; i < mUniformBlockInterface.size(); ++i) {
+        if(!mUniformBlockInterface[i].isOpaque && !mUniformBlockInterface[i].isPushConstant) {
+            mUniformBlockDataInterface[i].pBufferObject = new UniformBufferObject(vkContext);
+            mUniformBlockDataInterface[i].pBufferObject->Allocate(mUniformBlockInterface[i].memorySize, nullptr);
+            mUniformBlockDataInterface[i].shadowData.assign(mUniformBlockInterface[i].memorySize, 0);
+        }
+    }
+
+    for(uint32_t i = 0; i < mUniformInterface.size(); ++i) {
+        if(mUniformInterface[i].index < mUniformBlockDataInterface.size()) {
+            mUniformBlockDataInterface[mUniformInterface[i].index].uniforms.push_back(i);
         }
     }
 
@@ -139,8 +325,16 @@ ShaderResourceInterface::GetUniformBufferObject(uint32_t index) const
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    map<std::string, uniformBlockData>::const_iterator itBlock = mUniformBlockDataInterface.find(mUniformBlockInterface[index].name);
-    return itBlock->second.pBufferObject;
+    return mUniformBlockDataInterface[index].pBufferObject;
+}
+
+const VkDescriptorBufferInfo *
+ShaderResourceInterface::GetUniformBufferDescInfo(uint32_t index)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    uniformBlockData &blockData = mUniformBlockDataInterface[index];
+    return blockData.inRing ? &blockData.ringBufferInfo : blockData.pBufferObject->GetBufferDescInfo();
 }
 
 const ShaderResourceInterface::uniform *
@@ -148,13 +342,11 @@ ShaderResourceInterface::GetUniformAtLocation(uint32_t loc) const
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    for(const auto &uniform : mUniformInterface) {
-        if(loc >= (uint32_t)uniform.location && loc < (uint32_t)(uniform.location + uniform.arraySize)) {
-            return &uniform;
-        }
+    if(loc >= mUniformLocations.size() || mUniformLocations[loc] == GLOVE_INVALID_OFFSET) {
+        return nullptr;
     }
 
-    return nullptr;
+    return &mUniformInterface[mUniformLocations[loc]];
 }
 
 int
@@ -162,27 +354,15 @@ ShaderResourceInterface::GetUniformLocation(const char *name) const
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(name[strlen(name) - 1] != ']') {
-        for(auto &uniIt : mUniformInterface) {
-            if(!strcmp(uniIt.name.c_str(), name)) {
-                return uniIt.location;
-            }
-        }
-    } else {
-        /// Adjust location according to the specific array index requested
-        string requestedName = string(name);
-        size_t leftBracketPos = requestedName.find_last_of("[");
-        int index = std::stoi(requestedName.substr(leftBracketPos + 1));
-
-        string ptrName = requestedName.substr(0, leftBracketPos);
-        for(auto &uniIt : mUniformInterface) {
-            if(!ptrName.compare(uniIt.name)) {
-                if(index >= uniIt.arraySize) {
-                    return -1;
-                } else {
-                    return uniIt.location + index;
-                }
-            }
+    if(mLocationTable.empty()) {
+        return -1;
+    }
+
+    const size_t   length = strlen(name);
+    const uint32_t mask   = static_cast<uint32_t>(mLocationTable.size() - 1);
+    for(uint32_t slot = HashName(name, length) & mask; mLocationTable[slot] != GLOVE_INVALID_OFFSET; slot = (slot + 1) & mask) {
+        if(!strcmp(mLocationNames[mLocationTable[slot]], name)) {
+            return mLocationValues[mLocationTable[slot]];
         }
     }
 
@@ -194,12 +374,12 @@ ShaderResourceInterface::GetUniformClientData(uint32_t location, size_t size, vo
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    const ShaderResourceInterface::uniform *uniform = GetUniformAtLocation(location);
+    const uint32_t index = mUniformLocations[location];
+    const ShaderResourceInterface::uniform *uniform = &mUniformInterface[index];
 
     size_t arrayOffset = (location - uniform->location) * GlslTypeToSize(uniform->type);
 
-    map<std::string, uniformData>::const_iterator it = mUniformDataInterface.find(uniform->name);
-    memcpy(ptr, static_cast<const void *>(it->second.pClientData + arrayOffset), size);
+    memcpy(ptr, static_cast<const void *>(GetClientData(index) + arrayOffset), size);
 }
 
 const uint8_t*
@@ -207,8 +387,7 @@ ShaderResourceInterface::GetUniformClientData(uint32_t index) const
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    map<std::string, uniformData>::const_iterator it = mUniformDataInterface.find(mUniformInterface[index].name);
-    return it->second.pClientData;
+    return GetClientData(index);
 }
 
 int
@@ -217,7 +396,7 @@ ShaderResourceInterface::GetAttributeLocation(const char *name) const
     FUN_ENTRY(GL_LOG_DEBUG);
 
     for(auto &it : mAttributeInterface) {
-        if(!strcmp(it.name.c_str(), name)) {
+        if(!strcmp(it.name, name)) {
             return it.location;
         }
     }
@@ -232,7 +411,7 @@ ShaderResourceInterface::SetActiveAttributeMaxLength(void)
 
     mActiveAttributeMaxLength = 0;
     for(const auto &attribute : mAttributeInterface) {
-        size_t len = attribute.name.length() + 1;
+        size_t len = strlen(attribute.name) + 1;
         if(len > mActiveAttributeMaxLength) {
             mActiveAttributeMaxLength = len;
         }
@@ -246,7 +425,7 @@ ShaderResourceInterface::SetActiveUniformMaxLength(void)
 
     mActiveUniformMaxLength = 0;
     for(const auto &uniform : mUniformInterface) {
-        size_t len = uniform.name.length() + 1;
+        size_t len = strlen(uniform.name) + 1;
         if(len > mActiveUniformMaxLength) {
             mActiveUniformMaxLength = len;
         }
@@ -258,20 +437,17 @@ ShaderResourceInterface::SetUniformClientData(uint32_t location, size_t size, co
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    ShaderResourceInterface::uniform *uniform = nullptr;
-    for(auto &uni: mUniformInterface) {
-        if(location >= (uint32_t)uni.location && location < (uint32_t)(uni.location + uni.arraySize)) {
-            uniform = &uni;
-            break;
-        }
-    }
+    const uint32_t index = mUniformLocations[location];
+    const ShaderResourceInterface::uniform *uniform = &mUniformInterface[index];
 
     size_t arrayOffset = (location - uniform->location) * GlslTypeToSize(uniform->type);
 
-    map<std::string, uniformData>::iterator it = mUniformDataInterface.find(uniform->name);
-    memcpy(static_cast<void *>(it->second.pClientData + arrayOffset), ptr, size);
+    memcpy(static_cast<void *>(GetClientData(index) + arrayOffset), ptr, size);
 
-    it->second.clientDataDirty = true;
+    mUniformDataInterface[index].clientDataDirty = true;
+    if(uniform->index < mUniformBlockDataInterface.size()) {
+        mUniformBlockDataInterface[uniform->index].dirty = true;
+    }
 }
 
 void
@@ -281,16 +457,17 @@ ShaderResourceInterface::SetUniformSampler(uint32_t location, int count, const i
 
     while(count--) {
 
-        const ShaderResourceInterface::uniform *uniformSampler = GetUniformAtLocation(location);
-        map<std::string, uniformData>::iterator it = mUniformDataInterface.find(uniformSampler->name);
+        const uint32_t index = mUniformLocations[location];
+        const ShaderResourceInterface::uniform *uniformSampler = &mUniformInterface[index];
 
         size_t arrayOffset = (location - uniformSampler->location) * GlslTypeToSize(uniformSampler->type);
+        glsl_sampler_t *sampler = reinterpret_cast<glsl_sampler_t *>(GetClientData(index) + arrayOffset);
 
         /// Make sure textureUnit is inside [0, GLOVE_MAX_COMBINED_TEXTURE_IMAGE_UNITS)
         if(*textureUnit >= GL_TEXTURE0 && *textureUnit < GL_TEXTURE0 + GLOVE_MAX_COMBINED_TEXTURE_IMAGE_UNITS) {
-            *((glsl_sampler_t *)(it->second.pClientData + arrayOffset)) = (glsl_sampler_t)(*textureUnit - GL_TEXTURE0);
+            *sampler = (glsl_sampler_t)(*textureUnit - GL_TEXTURE0);
         } else {
-            *((glsl_sampler_t *)(it->second.pClientData + arrayOffset)) = (glsl_sampler_t)(*textureUnit);
+            *sampler = (glsl_sampler_t)(*textureUnit);
         }
 
         ++textureUnit;
@@ -348,85 +525,108 @@ ShaderResourceInterface::UpdateAttributeInterface(void)
 }
 
 bool
-ShaderResourceInterface::UpdateUniformBufferData(const vulkanAPI::vkContext_t *vkContext, bool *allocatedNewBufferObject)
+ShaderResourceInterface::UpdateUniformBufferData(const vulkanAPI::vkContext_t *vkContext, vulkanAPI::RingBuffer *uniformRing, bool *allocatedNewBufferObject)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    uint32_t blockIndex=0;
-    bool     blockDataDirty;
+    for(uint32_t blockIndex = 0; blockIndex < mUniformBlockDataInterface.size(); ++blockIndex) {
 
-    struct uniformDirty {
-        size_t       offset;
-        size_t       size;
-        const void * data;
-    };
-
-    for(auto &uniBlock : mUniformBlockInterface) {
+        uniformBlockData &blockData = mUniformBlockDataInterface[blockIndex];
+        if(mUniformBlockInterface[blockIndex].isOpaque) {
+            blockData.dirty = false;
+            continue;
+        }
 
-        map<std::string, uniformBlockData>::iterator itBlock = mUniformBlockDataInterface.find(uniBlock.name);
+        /// push constants are recorded with the draw, so they are just written as they are
+        if(mUniformBlockInterface[blockIndex].isPushConstant) {
+            if(blockData.dirty) {
+                blockData.dirty = false;
 
-        blockDataDirty = false;
-        std::vector<struct uniformDirty> uniformInterfaceDirty;
-        for(auto &uniform : mUniformInterface) {
+                for(uint32_t uniformIndex : blockData.uniforms) {
+                    const uniform &uni = mUniformInterface[uniformIndex];
 
-            // if does not belong to Block
-            if(uniform.index != blockIndex) {
-                continue;
+                    mUniformDataInterface[uniformIndex].clientDataDirty = false;
+                    memcpy(mPushConstantData.data() + mUniformBlockInterface[blockIndex].pushConstantOffset + uni.offset,
+                           GetClientData(uniformIndex), mUniformDataInterface[uniformIndex].elementSize);
+                }
             }
+            continue;
+        }
 
-            map<std::string, uniformData>::iterator itUniform = mUniformDataInterface.find(uniform.name);
+        /// gather the uniforms written since the last update into the block's layout
+        bool dataUpdated    = blockData.dirty;
+        bool blockDataDirty = false;
+        if(blockData.dirty) {
+            blockData.dirty = false;
 
-            // check if is updated
-            if(!itUniform->second.clientDataDirty) {
-               continue;
-            }
-            itUniform->second.clientDataDirty = false;
+            for(uint32_t uniformIndex : blockData.uniforms) {
 
-            blockDataDirty = true;
-            if(IsBuildInUniform(uniform.name)) {
-                blockDataDirty = false;
-            }
+                const uniform &uni     = mUniformInterface[uniformIndex];
+                uniformData   &uniData = mUniformDataInterface[uniformIndex];
+
+                // check if is updated
+                if(!uniData.clientDataDirty) {
+                   continue;
+                }
+                uniData.clientDataDirty = false;
 
-            // compute uniform size
-            for (size_t i = 0; i < (size_t)uniform.arraySize; i++) {
-                struct uniformDirty newUniformDirty;
-                newUniformDirty.size   = GlslTypeToSize(uniform.type);
-                newUniformDirty.offset = uniform.offset + i*GlslTypeToAllignment(uniform.type);
-                newUniformDirty.data   = static_cast<const void *>(itUniform->second.pClientData + i*newUniformDirty.size);
-                uniformInterfaceDirty.push_back(newUniformDirty);
+                // built-in uniforms are updated in place
+                blockDataDirty = blockDataDirty || !uniData.isBuiltIn;
+
+                CopyUniformToStd140(blockData.shadowData.data() + uni.offset, uniData.elementStride,
+                                    GetClientData(uniformIndex), uniData.elementSize, static_cast<size_t>(uni.arraySize));
             }
         }
 
-        if(blockDataDirty) {
-
-            size_t   srcSize = 0;
-            uint8_t *srcData = nullptr;
+        const size_t blockSize = blockData.shadowData.size();
 
-            if(itBlock->second.pBufferObject && itBlock->second.pBufferObject->GetSize() > 0) {
-                mCacheManager->CacheUBO(itBlock->second.pBufferObject);
+        /// the block's data is copied into the ring once per frame and whenever it changes
+        if(uniformRing) {
+            if(!dataUpdated && blockData.inRing && blockData.ringEpoch == uniformRing->GetEpoch() &&
+               blockData.ringBufferInfo.buffer == uniformRing->GetVkBuffer()) {
+                continue;
+            }
 
-                // memcopy data
-                srcSize = itBlock->second.pBufferObject->GetSize();
-                srcData = new uint8_t[srcSize];
-                itBlock->second.pBufferObject->GetData(srcSize, 0, srcData);
+            uint32_t offset;
+            if(uniformRing->Upload(blockData.shadowData.data(), blockSize, &offset)) {
+                if(!blockData.inRing || blockData.ringBufferInfo.buffer != uniformRing->GetVkBuffer()) {
+                    blockData.ringBufferInfo.buffer = uniformRing->GetVkBuffer();
+                    blockData.ringBufferInfo.offset = 0;
+                    blockData.ringBufferInfo.range  = blockSize;
+                    *allocatedNewBufferObject = true;
+                }
 
-                *allocatedNewBufferObject = true;
+                blockData.inRing        = true;
+                blockData.dynamicOffset = offset;
+                blockData.ringEpoch     = uniformRing->GetEpoch();
+                continue;
             }
+        }
 
-            itBlock->second.pBufferObject = new UniformBufferObject(vkContext);
-            itBlock->second.pBufferObject->Allocate(uniBlock.memorySize, srcData);
+        /// fall back to the block's own buffer object when there is no room left in the ring
+        if(!dataUpdated && !blockData.inRing) {
+            continue;
+        }
+
+        if(blockData.inRing || blockDataDirty) {
 
-            if(srcSize) {
-                delete[] srcData;
+            // the previous buffer might still be in use by a command buffer in flight
+            if(blockData.pBufferObject && blockData.pBufferObject->GetSize() > 0) {
+                mCacheManager->CacheUBO(blockData.pBufferObject);
             }
-        }
 
-        for (auto &u : uniformInterfaceDirty) {
-            itBlock->second.pBufferObject->UpdateData(u.size, u.offset, u.data);
+            blockData.pBufferObject = new UniformBufferObject(vkContext);
+            blockData.pBufferObject->Allocate(blockSize, blockData.shadowData.data());
+
+            *allocatedNewBufferObject = true;
+        } else {
+            blockData.pBufferObject->UpdateData(blockSize, 0, blockData.shadowData.data());
         }
 
-        ++blockIndex;
+        blockData.inRing        = false;
+        blockData.dynamicOffset = 0;
+        blockData.ringEpoch     = 0;
     }
 
     return true;
-}
\ No newline at end of file
+}
@@ -27,17 +27,19 @@
 #include "shaderReflection.h"
 #include "bufferObject.h"
 #include "utils/cacheManager.h"
+#include "utils/nameTable.h"
+#include "vulkan/ringBuffer.h"
 #include <vector>
 
 class ShaderResourceInterface {
 public:
     struct attribute {
-        string                      name;
+        const char                 *name;
         GLenum                      type;
         uint32_t                    location;
 
-        attribute(string n, GLenum t, uint32_t l)
-         : name(n),
+        attribute(const char *n, GLenum t, uint32_t l)
+         : name(NameTable::Intern(n)),
            type(t),
            location(l)
         {
@@ -48,15 +50,15 @@ public:
     typedef vector<attribute>               attributeInterface;
 
     struct uniform{
-        string                      name;
+        const char                 *name;
         uint32_t                    location;
         uint32_t                    index;
         int32_t                     arraySize;
         GLenum                      type;
         size_t                      offset;
 
-        uniform(string n, uint32_t l, uint32_t i, int32_t a, GLenum t, size_t o)
-         : name(n),
+        uniform(const char *n, uint32_t l, uint32_t i, int32_t a, GLenum t, size_t o)
+         : name(NameTable::Intern(n)),
            location(l),
            index(i),
            arraySize(a),
@@ -69,43 +71,47 @@ public:
     typedef struct uniform uniform;
     typedef vector<uniform>                 uniformInterface;
 
+    /// client data of a uniform, stored at clientDataOffset of the program's client data.
+    /// Elements are tightly packed there and elementStride apart in the std140 block
     struct uniformData {
-        uint8_t                    *pClientData;
+        size_t                      clientDataOffset;
+        uint32_t                    elementSize;
+        uint32_t                    elementStride;
         bool                        clientDataDirty;
+        bool                        isBuiltIn;
 
         uniformData()
-         : pClientData(nullptr),
-           clientDataDirty(false)
+         : clientDataOffset(0),
+           elementSize(0),
+           elementStride(0),
+           clientDataDirty(false),
+           isBuiltIn(false)
         {
             FUN_ENTRY(GL_LOG_TRACE);
         }
-
-        ~uniformData()
-        {
-            FUN_ENTRY(GL_LOG_TRACE);
-
-            if(pClientData) {
-                delete[] pClientData;
-                pClientData = nullptr;
-            }
-        }
     };
     typedef struct uniformData              uniformData;
-    typedef map<string, uniformData>        uniformDataInterface;
+    typedef vector<uniformData>             uniformDataInterface;
 
     struct uniformBlock {
-        string                      name;
+        const char                 *name;
         uint32_t                    binding;
         size_t                      memorySize;
         shader_type_t               stage;
         bool                        isOpaque;
+        bool                        isPushConstant;
+        uint32_t                    pushConstantOffset;
+        bool                        isSpecialization;
 
-        uniformBlock(string n, uint32_t b, size_t m, shader_type_t s, bool o)
-         : name(n),
+        uniformBlock(const char *n, uint32_t b, size_t m, shader_type_t s, bool o, bool p, uint32_t po, bool sp)
+         : name(NameTable::Intern(n)),
            binding(b),
            memorySize(m),
            stage(s),
-           isOpaque(o)
+           isOpaque(o),
+           isPushConstant(p),
+           pushConstantOffset(po),
+           isSpecialization(sp)
         {
             FUN_ENTRY(GL_LOG_TRACE);
         }
@@ -113,27 +119,31 @@ public:
     typedef struct uniformBlock             uniformBlock;
     typedef vector<uniformBlock>            uniformBlockInterface;
 
+    /// a block is read either from its own buffer object or, with offset
+    /// dynamicOffset, from the uniform ring of the frame it was written in
     struct uniformBlockData {
         UniformBufferObject *       pBufferObject;
+        vector<uint32_t>            uniforms;
+        vector<uint8_t>             shadowData;
+        VkDescriptorBufferInfo      ringBufferInfo;
+        uint32_t                    dynamicOffset;
+        uint64_t                    ringEpoch;
+        bool                        inRing;
+        bool                        dirty;
 
         uniformBlockData()
-         : pBufferObject(nullptr)
-        {
-            FUN_ENTRY(GL_LOG_TRACE);
-        }
-
-        ~uniformBlockData()
+         : pBufferObject(nullptr),
+           dynamicOffset(0),
+           ringEpoch(0),
+           inRing(false),
+           dirty(false)
         {
             FUN_ENTRY(GL_LOG_TRACE);
-
-            if(pBufferObject) {
-                delete pBufferObject;
-                pBufferObject = nullptr;
-            }
+            memset(static_cast<void *>(&ringBufferInfo), 0, sizeof(ringBufferInfo));
         }
     };
     typedef struct uniformBlockData         uniformBlockData;
-    typedef map<string, uniformBlockData>   uniformBlockDataInterface;
+    typedef vector<uniformBlockData>        uniformBlockDataInterface;
 
     typedef map<string, uint32_t>           attribsLayout_t;
 
@@ -152,14 +162,30 @@ private:
 
     uniformInterface                        mUniformInterface;
     uniformDataInterface                    mUniformDataInterface;
+    vector<uint8_t>                         mUniformClientData;
+    /// uniform index per location, indexed like mUniformInterface
+    vector<uint32_t>                        mUniformLocations;
+    /// location per name, with every element of an array expanded as name[i],
+    /// looked up through an open addressing table of indices into the names
+    vector<const char *>                    mLocationNames;
+    vector<int32_t>                         mLocationValues;
+    vector<uint32_t>                        mLocationTable;
 
     uniformBlockInterface                   mUniformBlockInterface;
     uniformBlockDataInterface               mUniformBlockDataInterface;
 
+    /// data of the blocks declared as members of the push constant block
+    vector<uint8_t>                         mPushConstantData;
+    shader_type_t                           mPushConstantStages;
+
     attribsLayout_t                         mCustomAttributesLayout;
     CacheManager*                           mCacheManager;
 
     void                                    Reset(void);
+    void                                    ReleaseUniformBufferObjects(CacheManager *cacheManager);
+    void                                    BuildLocationTable(void);
+    inline uint8_t                         *GetClientData(uint32_t index)                { FUN_ENTRY(GL_LOG_TRACE); return mUniformClientData.data() + mUniformDataInterface[index].clientDataOffset; }
+    inline const uint8_t                   *GetClientData(uint32_t index)          const { FUN_ENTRY(GL_LOG_TRACE); return mUniformClientData.data() + mUniformDataInterface[index].clientDataOffset; }
 
 public:
     ShaderResourceInterface();
@@ -175,8 +201,9 @@ public:
 
 
     inline uint32_t                         GetReflectionSize(void)                const { FUN_ENTRY(GL_LOG_TRACE); return mReflectionSize; }
+    inline const attribsLayout_t &          GetCustomAttribsLayout(void)           const { FUN_ENTRY(GL_LOG_TRACE); return mCustomAttributesLayout; }
 
-    const  string&                          GetAttributeName(int index)            const { FUN_ENTRY(GL_LOG_TRACE); return mAttributeInterface[index].name; }
+    const  char                            *GetAttributeName(int index)            const { FUN_ENTRY(GL_LOG_TRACE); return mAttributeInterface[index].name; }
     int                                     GetAttributeType(int index)            const { FUN_ENTRY(GL_LOG_TRACE); return mAttributeInterface[index].type; }
     int                                     GetAttributeLocation(const char *name) const;
     inline uint32_t                         GetAttributeLocation(uint32_t index)   const { FUN_ENTRY(GL_LOG_TRACE); return mAttributeInterface[index].location; }
@@ -192,11 +219,20 @@ public:
                                                                  void *ptr)        const;
 	const  uint8_t                         *GetUniformClientData(uint32_t index)   const;
 	UniformBufferObject                    *GetUniformBufferObject(uint32_t index) const;
+    const VkDescriptorBufferInfo           *GetUniformBufferDescInfo(uint32_t index);
+    inline uint32_t                         GetUniformBlockDynamicOffset(uint32_t index) const { FUN_ENTRY(GL_LOG_TRACE); return mUniformBlockDataInterface[index].dynamicOffset; }
 
 
     inline uint32_t                         GetUniformBlockBinding(uint32_t index) const { FUN_ENTRY(GL_LOG_TRACE); return mUniformBlockInterface[index].binding; }
     inline shader_type_t                    GetUniformBlockStage(uint32_t index)   const { FUN_ENTRY(GL_LOG_TRACE); return mUniformBlockInterface[index].stage; }
     inline bool                             IsUniformBlockOpaque(uint32_t index)   const { FUN_ENTRY(GL_LOG_TRACE); return mUniformBlockInterface[index].isOpaque; }
+    inline bool                             IsUniformBlockPushConstant(uint32_t index) const { FUN_ENTRY(GL_LOG_TRACE); return mUniformBlockInterface[index].isPushConstant; }
+    inline uint32_t                         GetUniformBlockPushConstantOffset(uint32_t index) const { FUN_ENTRY(GL_LOG_TRACE); return mUniformBlockInterface[index].pushConstantOffset; }
+    inline bool                             IsUniformBlockSpecialization(uint32_t index) const { FUN_ENTRY(GL_LOG_TRACE); return mUniformBlockInterface[index].isSpecialization; }
+
+    inline uint32_t                         GetPushConstantSize(void)              const { FUN_ENTRY(GL_LOG_TRACE); return static_cast<uint32_t>(mPushConstantData.size()); }
+    inline const uint8_t                   *GetPushConstantData(void)              const { FUN_ENTRY(GL_LOG_TRACE); return mPushConstantData.data(); }
+    inline shader_type_t                    GetPushConstantStages(void)            const { FUN_ENTRY(GL_LOG_TRACE); return mPushConstantStages; }
 
     const uniform                          *GetUniformAtLocation(uint32_t loc)     const;
     const uniform                          *GetUniform(uint32_t index)             const { FUN_ENTRY(GL_LOG_TRACE); return index < mUniformInterface.size() ? mUniformInterface.data() + index : nullptr; }
@@ -220,11 +256,14 @@ public:
 
 /// Allocate Functions
     void                                    CreateInterface(void);
+    /// the reverse of CreateInterface, so that a linked program can be serialized without its compiler
+    void                                    CreateReflection(void)                         const;
     void                                    AllocateUniformClientData(void);
 	bool                                    AllocateUniformBufferObjects(const vulkanAPI::vkContext_t *vkContext);
 
 /// Update Functions    
     bool                                    UpdateUniformBufferData(const vulkanAPI::vkContext_t *vkContext,
+                                                                    vulkanAPI::RingBuffer *uniformRing,
                                                                     bool *allocatedNewBufferObject);
     void                                    UpdateAttributeInterface(void);
 
@@ -0,0 +1,159 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       shareGroup.cpp
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Objects shared by the contexts created with a share_context
+ *
+ *  @section
+ *
+ *  Textures, buffers, renderbuffers, shaders and programs live in the share
+ *  group of a context, so that a context created with a share_context sees
+ *  the objects of that context under the same names. Framebuffers, vertex
+ *  arrays and the default textures are container or per-context objects and
+ *  stay with each context.
+ *
+ *  The namespaces are guarded by a recursive mutex, taken by the resource
+ *  manager of each context. Shaders and programs keep a pointer to the
+ *  compiler that builds them, so the compiler and its worker belong to the
+ *  group too: compile jobs and compilations on the calling threads take the
+ *  compiler mutex, so that the compiler is never used by two threads.
+ *
+ */
+
+#include "shareGroup.h"
+#include "glslang/glslangShaderCompiler.h"
+#include <algorithm>
+
+ShareGroup::ShareGroup()
+: mContextCount(0), mShadingObjectCount(1)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    mCompileWorker  = new CompileWorker();
+    mShaderCompiler = new GlslangShaderCompiler();
+}
+
+ShareGroup::~ShareGroup()
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // pending jobs write to the shaders and programs released with the group
+    delete mCompileWorker;
+
+    if(mShaderCompiler != nullptr) {
+        delete mShaderCompiler;
+        mShaderCompiler = nullptr;
+    }
+}
+
+void
+ShareGroup::Attach(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    std::lock_guard<std::recursive_mutex> lock(mMutex);
+
+    ++mContextCount;
+}
+
+void
+ShareGroup::AddCacheManager(CacheManager *cacheManager)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    std::lock_guard<std::recursive_mutex> lock(mMutex);
+
+    mCacheManagers.push_back(cacheManager);
+}
+
+bool
+ShareGroup::Detach(CacheManager *cacheManager)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    std::lock_guard<std::recursive_mutex> lock(mMutex);
+
+    mCacheManagers.erase(std::remove(mCacheManagers.begin(), mCacheManagers.end(), cacheManager), mCacheManagers.end());
+
+    // the programs last used by the leaving context retire their objects with one that remains
+    if(cacheManager != nullptr && !mCacheManagers.empty()) {
+        for(ShaderProgram *program : mShaderPrograms.GetObjects()) {
+            if(program->GetCacheManager() == cacheManager) {
+                program->SetCacheManager(mCacheManagers.front());
+            }
+        }
+    }
+
+    return --mContextCount == 0;
+}
+
+uint64_t
+ShareGroup::EnqueueCompileJob(const CompileWorker::job_t &job)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    std::mutex *compilerMutex = &mCompilerMutex;
+    return mCompileWorker->Enqueue([compilerMutex, job] {
+        std::lock_guard<std::mutex> lock(*compilerMutex);
+        job();
+    });
+}
+
+void
+ShareGroup::RunCompileJob(const CompileWorker::job_t &job)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    std::lock_guard<std::mutex> lock(mCompilerMutex);
+    job();
+}
+
+void
+ShareGroup::CreateShaderCompiler(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    std::lock_guard<std::recursive_mutex> lock(mMutex);
+
+    if(mShaderCompiler == nullptr) {
+        mShaderCompiler = new GlslangShaderCompiler();
+
+        for(Shader *shader : mShaders.GetObjects()) {
+            shader->SetShaderCompiler(mShaderCompiler);
+        }
+
+        for(ShaderProgram *program : mShaderPrograms.GetObjects()) {
+            program->SetShaderCompiler(mShaderCompiler);
+        }
+    }
+}
+
+void
+ShareGroup::ReleaseShaderCompiler(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    std::lock_guard<std::recursive_mutex> lock(mMutex);
+
+    // the other contexts of the group may be compiling with it
+    if(mShaderCompiler != nullptr && mContextCount == 1) {
+        mCompileWorker->Wait();
+        delete mShaderCompiler;
+        mShaderCompiler = nullptr;
+    }
+}
@@ -0,0 +1,109 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       shareGroup.h
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Objects shared by the contexts created with a share_context
+ *
+ */
+
+#ifndef __SHAREGROUP_H__
+#define __SHAREGROUP_H__
+
+#include <mutex>
+#include <vector>
+#include "resources/bufferObject.h"
+#include "resources/shaderProgram.h"
+#include "resources/renderbuffer.h"
+#include "resources/shader.h"
+#include "resources/texture.h"
+#include "utils/compileWorker.h"
+#include "utils/cacheManager.h"
+
+typedef enum {
+    NO_ID,
+    SHADER_ID,
+    SHADER_PROGRAM_ID
+} shadingNamespaceType_t;
+
+typedef struct {
+    shadingNamespaceType_t                 type;
+    uint32_t                               arrayIndex;
+} ShadingNamespace_t;
+
+class ShareGroup {
+public:
+    typedef ObjectArray<Texture>               TextureArray;
+    typedef ObjectArray<BufferObject>          BufferArray;
+    typedef ObjectArray<Shader>                ShaderArray;
+    typedef ObjectArray<ShaderProgram>         ShaderProgramArray;
+    typedef ObjectArray<Renderbuffer>          RenderbufferArray;
+    typedef map<uint32_t, ShadingNamespace_t>  shadingPoolIDs_t;
+
+private:
+    /// guards the namespaces, which are accessed from the threads of all contexts of the group
+    std::recursive_mutex                       mMutex;
+    /// serializes the use of the shader compiler by the worker and by the calling threads
+    std::mutex                                 mCompilerMutex;
+    uint32_t                                   mContextCount;
+    /// cache managers of the contexts, retiring the objects of the programs they draw with
+    std::vector<CacheManager *>                mCacheManagers;
+
+    CompileWorker                             *mCompileWorker;
+    ShaderCompiler                            *mShaderCompiler;
+
+    /// the namespaces are reached through the resource manager of each context
+    friend class ResourceManager;
+
+    BufferArray                                mBuffers;
+    RenderbufferArray                          mRenderbuffers;
+    TextureArray                               mTextures;
+
+    uint32_t                                   mShadingObjectCount;
+    shadingPoolIDs_t                           mShadingObjectPool;
+    ShaderArray                                mShaders;
+    ShaderProgramArray                         mShaderPrograms;
+
+    std::vector<BufferObject*>                 mPurgeListBufferObject;
+    std::vector<Texture*>                      mPurgeListTexture;
+    std::vector<Shader*>                       mPurgeListShaders;
+    std::vector<ShaderProgram*>                mPurgeListShaderPrograms;
+    std::vector<Renderbuffer*>                 mPurgeListRenderbuffers;
+
+public:
+    ShareGroup();
+    ~ShareGroup();
+
+// Member Functions
+    void                       Attach(void);
+    /// returns true once the last context has left, the group is then deleted by the caller
+    bool                       Detach(CacheManager *cacheManager);
+    void                       AddCacheManager(CacheManager *cacheManager);
+
+// Lock Functions
+    inline std::recursive_mutex &GetMutex(void)                                 { FUN_ENTRY(GL_LOG_TRACE); return mMutex; }
+
+// Compiler Functions
+    inline CompileWorker      *GetCompileWorker(void)                           { FUN_ENTRY(GL_LOG_TRACE); return mCompileWorker; }
+    inline ShaderCompiler     *GetShaderCompiler(void)                          { FUN_ENTRY(GL_LOG_TRACE); return mShaderCompiler; }
+    uint64_t                   EnqueueCompileJob(const CompileWorker::job_t &job);
+    void                       RunCompileJob(const CompileWorker::job_t &job);
+    void                       CreateShaderCompiler(void);
+    void                       ReleaseShaderCompiler(void);
+};
+
+#endif // __SHAREGROUP_H__
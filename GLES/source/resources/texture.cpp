@@ -30,19 +30,24 @@
 #include "texture.h"
 #include "utils/VkToGlConverter.h"
 #include "utils/glUtils.h"
+#include "utils/compressedTextures.h"
 #include "context/context.h"
+#include "vulkan/utils.h"
 
 #define NUMBER_OF_MIP_LEVELS(w, h)                      (std::floor(std::log2(std::max((w),(h)))) + 1)
 
 // TODO:: this needs to be further discussed
 int Texture::mDefaultInternalAlignment = 1;
+std::atomic<uint32_t> Texture::mStorageGeneration(1);
+std::atomic<uint32_t> Texture::mResidencyGeneration(1);
 
 Texture::Texture(const vulkanAPI::vkContext_t *vkContext, const VkFlags vkFlags)
 : mVkContext(vkContext),
 mFormat(GL_INVALID_VALUE), mTarget(GL_INVALID_VALUE), mType(GL_INVALID_VALUE), mInternalFormat(GL_INVALID_VALUE),
-mExplicitType(GL_INVALID_VALUE), mExplicitInternalFormat(GL_INVALID_VALUE),
-mMipLevelsCount(1), mLayersCount(1), mState(nullptr), mDataUpdated(false), mDataNoInvertion(false), mFboColorAttached(false),
-mDepthStencilTexture(nullptr), mDepthStencilTextureRefCount(0u)
+mExplicitType(GL_INVALID_VALUE), mExplicitInternalFormat(GL_INVALID_VALUE), mCompressedFormat(GL_INVALID_VALUE),
+mMipLevelsCount(1), mLayersCount(1), mImmutableLevels(0), mState(nullptr), mDataUpdated(false), mDataNoInvertion(false), mFboColorAttached(false), mHostStateStale(false),
+mMipmapHint(false), mDemotedLevels(0), mLastUsedSubmissionId(0),
+mDepthStencilTexture(nullptr), mDepthStencilTextureRefCount(0u), mColorAttachmentRefCount(0u)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
@@ -56,6 +61,8 @@ Texture::~Texture()
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
+    WaitPendingUploads();
+
     delete mSampler;
     delete mImageView;
     delete mImage;
@@ -77,7 +84,7 @@ Texture::IsNPOT(void)
         return false;
     }
 
-    return (!ISPOWEROFTWO(state->width) || !ISPOWEROFTWO(state->height));
+    return (!ISPOWEROFTWO(state->width) || !ISPOWEROFTWO(state->height) || !ISPOWEROFTWO(GetDepth()));
 }
 
 bool
@@ -103,6 +110,8 @@ Texture::IsCompleted(void)
     // 1) The level zero arrays of each of the six texture images making up the cube map have identical, positive, and square dimensions.
     // 2) The level zero arrays were each specified with the same format, internal format, and type.
 
+    // The slices of a three-dimensional texture are its layers, which are halved along with the width and height of its levels.
+
     if(mState == nullptr) {
         return false;
     }
@@ -116,13 +125,21 @@ Texture::IsCompleted(void)
     GLenum type   = state->type;
     GLint  width  = state->width;
     GLint  height = state->height;
-    GLint  levels = NUMBER_OF_MIP_LEVELS(state->width, state->height);
+    GLint  depth  = GetDepth();
+    GLint  levels = mImmutableLevels ? mImmutableLevels : NUMBER_OF_MIP_LEVELS(state->width, std::max(state->height, depth));
 
-    GLint count = 0;
+    GLint count     = 0;
+    GLint baseCount = 0;
     for(GLint layer = 0; layer < mLayersCount; ++layer) {
         count = 0;
 
-        for(GLint level = 0; level < levels; ++level) {
+        // deeper slices are left out of the smaller levels
+        GLint layerLevels = levels;
+        while(IsVolume() && layerLevels > 1 && layer >= std::max(depth >> (layerLevels - 1), 1)) {
+            --layerLevels;
+        }
+
+        for(GLint level = 0; level < layerLevels; ++level) {
 
             state = &mState[layer][level];
 
@@ -137,11 +154,18 @@ Texture::IsCompleted(void)
             }
         }
 
-        if(count && count != levels-1)
+        if(count && count != layerLevels-1)
+            return false;
+
+        // all slices are either mipmapped or not, as the first one is
+        if(!layer) {
+            baseCount = count;
+        } else if(IsVolume() && layerLevels > 1 && !count != !baseCount) {
             return false;
+        }
     }
 
-    mMipLevelsCount = !count ? levels : 1;
+    mMipLevelsCount = !(IsVolume() ? baseCount : count) ? levels : 1;
 
     return true;
 }
@@ -151,6 +175,15 @@ Texture::ReleaseVkResources(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    // batched uploads and in-flight frames may still be referring to the image
+    Context *context = GetCurrentContext();
+    if(context && mImage->GetImage() != VK_NULL_HANDLE) {
+        vulkanAPI::CommandBufferManager *commandBufferManager = context->GetVkCommandBufferManager();
+        commandBufferManager->SubmitVkAuxCommandBuffer();
+        commandBufferManager->WaitVkAuxCommandBuffer();
+        commandBufferManager->WaitLastSubmition();
+    }
+
     mSampler->Release();
     mImageView->Release();
     mImage->Release();
@@ -162,13 +195,97 @@ Texture::CreateVkImage(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    mImage->SetWidth(GetWidth());
-    mImage->SetHeight(GetHeight());
-    mImage->SetMipLevels(mMipLevelsCount);
+    // a demoted image starts at the first level kept on the device
+    mImage->SetWidth(std::max(GetWidth()  >> mDemotedLevels, 1));
+    mImage->SetHeight(std::max(GetHeight() >> mDemotedLevels, 1));
+    mImage->SetDepth(GetDepth());
+    mImage->SetMipLevels(GetVkMipLevels() - mDemotedLevels);
     mImage->SetImageLayout(VK_IMAGE_LAYOUT_UNDEFINED);
 
     mSampler->SetMaxLod((mParameters.GetMinFilter() == GL_NEAREST || mParameters.GetMinFilter() == GL_LINEAR) ? 0.25f : static_cast<float>(mMipLevelsCount-1));
-    return mImage->Create();
+
+    // block compressed images can only be sampled and copied
+    if(FindCompressedFormat(mFormat) == nullptr) {
+        return mImage->Create();
+    }
+
+    VkImageUsageFlagBits usage = mImage->GetImageUsage();
+    mImage->SetImageUsage(static_cast<VkImageUsageFlagBits>(usage & (VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT)));
+    bool created = mImage->Create();
+    mImage->SetImageUsage(usage);
+
+    return created;
+}
+
+VkComponentMapping
+Texture::GetVkComponentMapping(void) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // images stored with fewer channels than the GL format exposes are expanded on sampling
+    VkComponentMapping mapping = { VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G, VK_COMPONENT_SWIZZLE_B, VK_COMPONENT_SWIZZLE_A };
+    switch(mExplicitInternalFormat) {
+    case GL_LUMINANCE:
+        mapping.g = VK_COMPONENT_SWIZZLE_R;
+        mapping.b = VK_COMPONENT_SWIZZLE_R;
+        mapping.a = VK_COMPONENT_SWIZZLE_ONE;
+        break;
+    case GL_LUMINANCE_ALPHA:
+        mapping.g = VK_COMPONENT_SWIZZLE_R;
+        mapping.b = VK_COMPONENT_SWIZZLE_R;
+        mapping.a = VK_COMPONENT_SWIZZLE_G;
+        break;
+    case GL_ALPHA:
+        mapping.r = VK_COMPONENT_SWIZZLE_ZERO;
+        mapping.g = VK_COMPONENT_SWIZZLE_ZERO;
+        mapping.b = VK_COMPONENT_SWIZZLE_ZERO;
+        mapping.a = VK_COMPONENT_SWIZZLE_R;
+        break;
+    default:
+        break;
+    }
+
+    return mapping;
+}
+
+GLint
+Texture::GetVkMipLevels(void) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(mImmutableLevels) {
+        return mImmutableLevels;
+    }
+
+    // the rest of the chain is expected to follow, so the levels are uploaded into this
+    // image as they arrive instead of having it recreated once the chain is complete
+    if(mMipmapHint && mCompressedFormat == GL_INVALID_VALUE) {
+        return std::max(mMipLevelsCount, GetMaxMipLevels());
+    }
+
+    return mMipLevelsCount;
+}
+
+GLint
+Texture::GetMaxMipLevels(void) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    return static_cast<GLint>(NUMBER_OF_MIP_LEVELS(GetWidth(), std::max(GetHeight(), GetDepth())));
+}
+
+bool
+Texture::FitsVkImage(GLint level, GLint layer, VkFormat vkFormat) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    return mImage->GetImage() != VK_NULL_HANDLE && !IsTransient()           &&
+           !mMemory->IsImported() && !mDemotedLevels                         &&
+           mImage->GetFormat() == vkFormat                                   &&
+           level < static_cast<GLint>(mImage->GetMipLevels())                &&
+           (!IsVolume() || layer < std::max(static_cast<GLint>(mImage->GetDepth()) >> level, 1)) &&
+           HasState(level, layer, std::max(GetWidth()  >> level, 1),
+                                  std::max(GetHeight() >> level, 1), mFormat, mType);
 }
 
 bool
@@ -177,8 +294,25 @@ Texture::AllocateVkMemory(void)
     FUN_ENTRY(GL_LOG_DEBUG);
 
     mMemory->GetImageMemoryRequirements(mImage->GetImage());
+    // ordinary textures keep the catch-all default usage, only explicit attachments count as render targets
+    VkImageUsageFlagBits usage = mImage->GetImageUsage();
+    mMemory->SetCategory(usage != VK_IMAGE_USAGE_FLAG_BITS_MAX_ENUM &&
+                         (usage & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT)) ?
+                         vulkanAPI::MemoryAllocator::CATEGORY_RENDER_TARGET : vulkanAPI::MemoryAllocator::CATEGORY_TEXTURE);
+
+    // once the device is out of memory, the cold textures give up their top levels and the allocation is tried again
+    if(!mMemory->Create()) {
+        Context *context = GetCurrentContext();
+        if(!context || !context->GetResourceManager()->DemoteColdTextures(context->GetVkCommandBufferManager()->GetLastSubmissionId())) {
+            return false;
+        }
+        mVkContext->vkMemoryAllocator->Trim();
+        if(!mMemory->Create()) {
+            return false;
+        }
+    }
 
-    return mMemory->Create() && mMemory->BindImageMemory(mImage->GetImage());
+    return mMemory->BindImageMemory(mImage->GetImage());
 }
 
 bool
@@ -197,6 +331,7 @@ Texture::CreateVkTexture(void)
         return false;
     }
 
+    mImageView->SetComponentMapping(GetVkComponentMapping());
     if(!CreateVkImageView()) {
         mImage->Release();
         mMemory->Release();
@@ -215,13 +350,48 @@ Texture::Allocate(void)
 
     State_t *state = &mState[0][0];
 
+    // a demoted texture is specified again as a whole
+    if(mDemotedLevels) {
+        mDemotedLevels = 0;
+        ++mResidencyGeneration;
+    }
+
     SetWidth (state->width);
     SetHeight(state->height);
     SetFormat(state->format);
     SetType  (state->type);
+
+    // compressed blocks are kept and uploaded as they are
+    if(FindCompressedFormat(state->format)) {
+        SetInternalFormat(state->format);
+        mExplicitInternalFormat = state->format;
+        mExplicitType           = state->type;
+
+        if(!CreateVkTexture()) {
+            return false;
+        }
+
+        for(GLint layer = 0; layer < mLayersCount; ++layer) {
+            for(GLint level = 0; level < mMipLevelsCount; ++level) {
+                if(mState[layer][level].data) {
+                    CopyCompressedPixelsFromHost(level, layer, mState[layer][level].data);
+                }
+            }
+        }
+
+        return true;
+    }
+
     SetInternalFormat(GlFormatToGlInternalFormat(state->format, state->type));
 
+    // the image is about to be recreated, so any device side copies have to reach the host first
+    SyncHostState(-1, -1);
+
+    // single channel images hold alpha textures as well as luminance ones
     mExplicitInternalFormat = VkFormatToGlInternalformat(mImage->GetFormat());
+    if(mExplicitInternalFormat == GL_LUMINANCE && mInternalFormat == GL_ALPHA) {
+        mExplicitInternalFormat = GL_ALPHA;
+    }
     mExplicitType           = GlInternalFormatToGlType(mExplicitInternalFormat);
 
     if(!CreateVkTexture()) {
@@ -233,8 +403,16 @@ Texture::Allocate(void)
     GLenum srcInternalFormat = mInternalFormat;
     GLenum dstInternalFormat = mExplicitInternalFormat;
     GLenum dstType = mExplicitType;
+    // transcoded levels keep their host copies, compressed subimages are decoded into them
+    const bool releaseHostState = mCompressedFormat == GL_INVALID_VALUE;
     for(GLint layer = 0; layer < mLayersCount; ++layer) {
-        for(GLint level = 0; level < mMipLevelsCount; ++level) {
+        for(GLint level = 0; level < static_cast<GLint>(mImage->GetMipLevels()); ++level) {
+            // levels past the complete ones belong to a chain that is still being specified
+            if(level >= mMipLevelsCount && !HasState(level, layer, std::max(GetWidth()  >> level, 1),
+                                                                   std::max(GetHeight() >> level, 1), mFormat, mType)) {
+                continue;
+            }
+
             state = &mState[layer][level];
             if(state->data) {
                 ImageRect srcRect(0, 0, state->width, state->height,
@@ -245,19 +423,321 @@ Texture::Allocate(void)
                                   GlInternalFormatTypeToNumElements(dstInternalFormat, dstType),
                                   GlTypeToElementSize(dstType),
                                   Texture::GetDefaultInternalAlignment());
-                CopyPixelsFromHost(&srcRect, &dstRect, level, layer, srcInternalFormat, static_cast<void *>(state->data));
+                CopyPixelsFromHost(&srcRect, &dstRect, level, layer, srcInternalFormat, static_cast<void *>(state->data), true, releaseHostState);
+                if(releaseHostState) {
+                    state->data = nullptr;
+                }
             }
         }
     }
 
+    // the image holds every level now, they are read back should the host need them again
+    mHostStateStale = releaseHostState;
+
+    return true;
+}
+
+bool
+Texture::ImportDmaBuf(const api_dma_buf_image_t *dmaBuf)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!mVkContext->mIsDmaBufImportSupported || mTarget != GL_TEXTURE_2D) {
+        return false;
+    }
+
+    // the formats without alpha are sampled as opaque
+    VkFormat vkFormat;
+    GLenum format;
+    VkComponentMapping mapping = { VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G, VK_COMPONENT_SWIZZLE_B, VK_COMPONENT_SWIZZLE_A };
+    switch(dmaBuf->fourcc) {
+    case API_DMA_BUF_FORMAT_ABGR8888: vkFormat = VK_FORMAT_R8G8B8A8_UNORM;      format = GL_RGBA; break;
+    case API_DMA_BUF_FORMAT_XBGR8888: vkFormat = VK_FORMAT_R8G8B8A8_UNORM;      format = GL_RGB;  mapping.a = VK_COMPONENT_SWIZZLE_ONE; break;
+    case API_DMA_BUF_FORMAT_ARGB8888: vkFormat = VK_FORMAT_B8G8R8A8_UNORM;      format = GL_RGBA; break;
+    case API_DMA_BUF_FORMAT_XRGB8888: vkFormat = VK_FORMAT_B8G8R8A8_UNORM;      format = GL_RGB;  mapping.a = VK_COMPONENT_SWIZZLE_ONE; break;
+    case API_DMA_BUF_FORMAT_RGB565:   vkFormat = VK_FORMAT_R5G6B5_UNORM_PACK16; format = GL_RGB;  break;
+    default:                          return false;
+    }
+
+    WaitPendingUploads();
+    ReleaseVkResources();
+    mDemotedLevels = 0;
+
+    // the previous levels are orphaned, the content now lives in the dma-buf only
+    mState[0].clear();
+    State_t *state = &mState[0][0];
+    state->width  = dmaBuf->width;
+    state->height = dmaBuf->height;
+    state->format = format;
+    state->type   = GL_UNSIGNED_BYTE;
+
+    SetWidth (dmaBuf->width);
+    SetHeight(dmaBuf->height);
+    SetFormat(format);
+    SetType  (GL_UNSIGNED_BYTE);
+    SetInternalFormat(format);
+    mExplicitInternalFormat = VkFormatToGlInternalformat(vkFormat);
+    mExplicitType           = GlInternalFormatToGlType(mExplicitInternalFormat);
+    mCompressedFormat       = GL_INVALID_VALUE;
+    mImmutableLevels        = 0;
+    mMipLevelsCount         = 1;
+    mHostStateStale         = true;
+
+    mImage->SetFormat(vkFormat);
+    mImage->SetWidth(dmaBuf->width);
+    mImage->SetHeight(dmaBuf->height);
+    if(!mImage->CreateDmaBuf(dmaBuf->modifier, dmaBuf->offset, dmaBuf->pitch)) {
+        return false;
+    }
+
+    if(!mMemory->ImportDmaBuf(dmaBuf->fd, mImage->GetImage())) {
+        mImage->Release();
+        mMemory->Release();
+        return false;
+    }
+
+    mImageView->SetComponentMapping(mapping);
+    if(!CreateVkImageView()) {
+        mImage->Release();
+        mMemory->Release();
+        return false;
+    }
+
+    mSampler->SetMaxLod((mParameters.GetMinFilter() == GL_NEAREST || mParameters.GetMinFilter() == GL_LINEAR) ? 0.25f : 0.0f);
+    SetDataUpdated(true);
+
+    return true;
+}
+
+bool
+Texture::AliasVkImage(Texture *source)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    VkImageUsageFlagBits usage = source->GetVkImageUsage();
+    if(mTarget != GL_TEXTURE_2D || usage == VK_IMAGE_USAGE_FLAG_BITS_MAX_ENUM || !(usage & VK_IMAGE_USAGE_SAMPLED_BIT)) {
+        return false;
+    }
+
+    // a pbuffer bound to the same texture every frame reuses the view created the first time
+    VkImage vkImage = source->GetImage()->GetImage();
+    if(mImage->GetImage() != vkImage) {
+        WaitPendingUploads();
+        ReleaseVkResources();
+        mDemotedLevels = 0;
+
+        mImage->SetImage(vkImage);
+        mImage->SetFormat(source->GetVkFormat());
+        mImage->SetImageUsage(usage);
+        mImage->SetImageTarget(vulkanAPI::Image::VK_IMAGE_TARGET_2D);
+        mImage->SetWidth(source->GetWidth());
+        mImage->SetHeight(source->GetHeight());
+        mImage->SetMipLevels(1);
+        mImage->CreateImageSubresourceRange();
+
+        mImageView->SetComponentMapping(source->GetVkComponentMapping());
+        if(!CreateVkImageView()) {
+            mImage->Release();
+            return false;
+        }
+    }
+
+    // the previous levels are orphaned, the content now lives in the image of source only
+    mState[0].clear();
+    State_t *state = &mState[0][0];
+    state->width  = source->GetWidth();
+    state->height = source->GetHeight();
+    state->format = source->GetFormat();
+    state->type   = source->GetType();
+
+    SetWidth (source->GetWidth());
+    SetHeight(source->GetHeight());
+    SetFormat(source->GetFormat());
+    SetType  (source->GetType());
+    SetInternalFormat(source->GetInternalFormat());
+    mExplicitInternalFormat = source->GetExplicitInternalFormat();
+    mExplicitType           = source->GetExplicitType();
+    mCompressedFormat       = GL_INVALID_VALUE;
+    mImmutableLevels        = 0;
+    mMipLevelsCount         = 1;
+    mHostStateStale         = true;
+
+    // the layout is tracked by source, which has just moved the image to be sampled
+    mImage->SetImageLayout(source->GetVkImageLayout());
+    mSampler->SetMaxLod((mParameters.GetMinFilter() == GL_NEAREST || mParameters.GetMinFilter() == GL_LINEAR) ? 0.25f : 0.0f);
+    SetDataUpdated(true);
+
     return true;
 }
 
 void
-Texture::SetState(GLsizei width, GLsizei height, GLint level, GLint layer, GLenum format, GLenum type, GLint unpackAlignment, const void *pixels)
+Texture::ReleaseVkImageAlias(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    mState[0].clear();
+    mHostStateStale = false;
+    SetDataUpdated(true);
+}
+
+bool
+Texture::IsDemotable(void) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // only the levels the host copies can bring back are dropped, so neither render targets
+    // nor imported or aliased images qualify, and a single level image has none to drop.
+    // The view is created last, a texture without one is still being created
+    return GetVkImageView() != VK_NULL_HANDLE && !mDemotedLevels && !IsTransient() && !IsVolume() &&
+           !mMemory->IsImported() && !IsColorAttached() && !mFboColorAttached && !mDepthStencilTextureRefCount &&
+           mImage->GetMipLevels() > 1;
+}
+
+bool
+Texture::Demote(GLint levels)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(levels <= 0 || !IsDemotable()) {
+        return false;
+    }
+    levels = std::min(levels, static_cast<GLint>(mImage->GetMipLevels()) - 1);
+
+    // the levels written on the device are read back, the host copies then hold the whole texture
+    WaitPendingUploads();
+    SyncHostState(-1, -1);
+
+    mDemotedLevels = levels;
+    ++mResidencyGeneration;
+    if(!CreateVkTexture()) {
+        Allocate();
+        return false;
+    }
+
+    // the host copies are kept for the texture to be restored, in the format they were given with
+    const bool compressed = FindCompressedFormat(mFormat) != nullptr;
+    for(GLint layer = 0; layer < mLayersCount; ++layer) {
+        for(GLint level = levels; level < levels + static_cast<GLint>(mImage->GetMipLevels()); ++level) {
+            State_t *state = &mState[layer][level];
+            if(!state->data) {
+                continue;
+            }
+
+            if(compressed) {
+                CopyCompressedPixelsFromHost(level, layer, state->data);
+                continue;
+            }
+
+            ImageRect srcRect(0, 0, state->width, state->height,
+                              GlInternalFormatTypeToNumElements(mInternalFormat, state->type),
+                              GlTypeToElementSize(state->type),
+                              Texture::GetDefaultInternalAlignment());
+            ImageRect dstRect(0, 0, state->width, state->height,
+                              GlInternalFormatTypeToNumElements(mExplicitInternalFormat, mExplicitType),
+                              GlTypeToElementSize(mExplicitType),
+                              Texture::GetDefaultInternalAlignment());
+            CopyPixelsFromHost(&srcRect, &dstRect, level, layer, mInternalFormat, state->data, true);
+        }
+    }
+    mHostStateStale = false;
+
+    return true;
+}
+
+bool
+Texture::Promote(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(!mDemotedLevels) {
+        return true;
+    }
+
+    // the conversions of the levels run on the upload worker, as for any other specification
+    return Allocate();
+}
+
+void
+Texture::WaitPendingUploads(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // conversions still running on the upload worker read the host copies
+    Context *context = GetCurrentContext();
+    if(context) {
+        context->GetUploadWorker()->Wait(this);
+    }
+}
+
+void
+Texture::SyncHostState(GLint skipLevel, GLint skipLayer)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!mHostStateStale || mImage->GetImage() == VK_NULL_HANDLE) {
+        return;
+    }
+    mHostStateStale = false;
+
+    // read back the levels written on the device, apart from the one about to be replaced
+    for(GLint layer = 0; layer < mLayersCount; ++layer) {
+        for(GLint level = 0; level < static_cast<GLint>(mImage->GetMipLevels()); ++level) {
+            if(level == skipLevel && layer == skipLayer) {
+                continue;
+            }
+
+            State_t *state = &mState[layer][level];
+            if(state->width  != std::max(GetWidth()  >> level, 1) ||
+               state->height != std::max(GetHeight() >> level, 1)) {
+                continue;
+            }
+
+            GLenum internalFormat = GlFormatToGlInternalFormat(state->format, state->type);
+            ImageRect srcRect(0, 0, state->width, state->height,
+                              GlInternalFormatTypeToNumElements(mExplicitInternalFormat, mExplicitType),
+                              GlTypeToElementSize(mExplicitType),
+                              Texture::GetDefaultInternalAlignment());
+            ImageRect dstRect(0, 0, state->width, state->height,
+                              GlInternalFormatTypeToNumElements(internalFormat, state->type),
+                              GlTypeToElementSize(state->type),
+                              Texture::GetDefaultInternalAlignment());
+            if(!state->data) {
+                state->data = new uint8_t[dstRect.GetRectBufferSize()];
+            }
+
+            // both the image and the host copies keep the first GL row first
+            mDataNoInvertion = true;
+            CopyPixelsToHost(&srcRect, &dstRect, level, layer, internalFormat, state->data);
+        }
+    }
+}
+
+bool
+Texture::HasState(GLint level, GLint layer, GLsizei width, GLsizei height, GLenum format, GLenum type) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    auto it = mState[layer].find(level);
+    return it != mState[layer].end()   &&
+           it->second.width  == width  && it->second.height == height &&
+           it->second.format == format && it->second.type   == type;
+}
+
+void
+Texture::SetState(GLsizei width, GLsizei height, GLint level, GLint layer, GLenum format, GLenum type, GLint unpackAlignment, const void *pixels, GLint unpackRowLength)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    WaitPendingUploads();
+    SyncHostState(level, layer);
+
+    mCompressedFormat = GL_INVALID_VALUE;
+
+    // levels past the base one mean the application builds the chain on its own
+    if(level > 0) {
+        mMipmapHint = true;
+    }
+
     mState[layer][level].width  = width;
     mState[layer][level].height = height;
     mState[layer][level].format = format;
@@ -277,6 +757,7 @@ Texture::SetState(GLsizei width, GLsizei height, GLint level, GLint layer, GLenu
                           GlInternalFormatTypeToNumElements(srcInternalFormat, type),
                           GlTypeToElementSize(type),
                           unpackAlignment);
+        srcRect.mRowLength = unpackRowLength;
         ImageRect dstRect(0, 0, width, height,
                           GlInternalFormatTypeToNumElements(srcInternalFormat, type),
                           GlTypeToElementSize(type),
@@ -295,6 +776,9 @@ Texture::SetSubState(ImageRect *srcRect, ImageRect *dstRect, GLint level, GLint
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    WaitPendingUploads();
+    SyncHostState(-1, -1);
+
     if(mState[layer][level].data == nullptr) {
         ImageRect srcRect(0, 0, mState[layer][level].width, mState[layer][level].height,
                           GlInternalFormatTypeToNumElements(GetInternalFormat(), GetType()),
@@ -307,42 +791,262 @@ Texture::SetSubState(ImageRect *srcRect, ImageRect *dstRect, GLint level, GLint
     if(srcData) {
         const GLenum dstFormat = mInternalFormat;
 
-        // create a buffer at the size of the requested subrectangle
-        const size_t dstSize = dstRect->GetRectBufferSize();
-        uint8_t *dstData = new uint8_t[dstSize];
-
-        // convert the source buffer to the internal format and alignment
-        // both buffers here are in the subtexture dimensions but may differ
-        // in format and alignment
+        // convert the source buffer to the internal format and alignment straight into
+        // the subrectangle of the texture level, inverting the rows in the same pass
         ImageRect tmp_srcRect = *srcRect;
         ImageRect tmp_dstRect = *dstRect;
         tmp_srcRect.x = 0; tmp_srcRect.y = 0;
-        tmp_dstRect.x = 0; tmp_dstRect.y = 0;
+        tmp_dstRect.width = mState[layer][level].width;
+        tmp_dstRect.height = mState[layer][level].height;
         ConvertPixels(srcFormat, dstFormat,
                       &tmp_srcRect, srcData,
-                      &tmp_dstRect, dstData);
+                      &tmp_dstRect, mState[layer][level].data, mFboColorAttached);
+        mFboColorAttached = false;
+    }
+
+    SetDataUpdated(true);
+}
 
-        if(mFboColorAttached) {
-            InvertImageYAxis(static_cast<uint8_t *>(dstData), &tmp_dstRect);
+void
+Texture::SetCompressedState(GLsizei width, GLsizei height, GLint level, GLint layer, GLenum format, const void *data, bool transcode)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    const CompressedFormat *compressed = FindCompressedFormat(format);
+    assert(compressed);
+
+    WaitPendingUploads();
+    mCompressedFormat = format;
+
+    // transcoded levels are decoded straight into the host copy and handled like any RGBA texture
+    State_t *state = &mState[layer][level];
+    state->width  = width;
+    state->height = height;
+    state->format = transcode ? GL_RGBA : format;
+    state->type   = GL_UNSIGNED_BYTE;
+
+    if(state->data) {
+        delete [] (uint8_t *)state->data;
+        state->data = nullptr;
+    }
+
+    if(data) {
+        if(transcode) {
+            ImageRect rect(0, 0, width, height, 4, 1, Texture::GetDefaultInternalAlignment());
+            state->data = new uint8_t[rect.GetRectBufferSize()];
+            TranscodeCompressedImage(compressed, width, height, data, static_cast<uint8_t *>(state->data), rect.GetRectAlignedRowInBytes());
+        } else {
+            const size_t size = GetCompressedImageSize(compressed, width, height);
+            state->data = new uint8_t[size];
+            memcpy(state->data, data, size);
         }
-        mFboColorAttached = false;
+    }
+}
 
-        // copy the converted buffer (containing the subtexture) to the target texture
-        // both buffers are now in the same format and alignment
-        tmp_srcRect = *srcRect;
-        tmp_dstRect = *dstRect;
-        tmp_srcRect.mAlignment = Texture::GetDefaultInternalAlignment();
-        tmp_dstRect.width = mState[layer][level].width;
-        tmp_dstRect.height = mState[layer][level].height;
+void
+Texture::SetCompressedSubState(GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLint level, GLint layer, const void *data)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
 
-        CopyPixelsNoConversion(&tmp_srcRect, dstData,
-                              &tmp_dstRect, mState[layer][level].data);
-        delete[] dstData;
+    const CompressedFormat *compressed = FindCompressedFormat(mCompressedFormat);
+    assert(compressed);
+
+    WaitPendingUploads();
+    State_t *state = &mState[layer][level];
+    const bool transcoded = state->format != mCompressedFormat;
+    ImageRect levelRect(0, 0, state->width, state->height, 4, 1, Texture::GetDefaultInternalAlignment());
+    if(state->data == nullptr) {
+        state->data = new uint8_t[transcoded ? levelRect.GetRectBufferSize() : GetCompressedImageSize(compressed, state->width, state->height)];
+    }
+
+    if(transcoded) {
+        const size_t stride = levelRect.GetRectAlignedRowInBytes();
+        uint8_t *dst = static_cast<uint8_t *>(state->data) + yoffset * stride + xoffset * 4;
+        TranscodeCompressedImage(compressed, width, height, data, dst, stride);
+    } else {
+        // the offsets are block aligned, so the block rows of the subimage are copied into place
+        const size_t levelBlockRow = GetCompressedImageSize(compressed, state->width, 1);
+        const size_t subBlockRow   = GetCompressedImageSize(compressed, width, 1);
+        const size_t blockRows     = (height + compressed->blockHeight - 1) / compressed->blockHeight;
+        const uint8_t *src = static_cast<const uint8_t *>(data);
+        uint8_t *dst = static_cast<uint8_t *>(state->data) + (yoffset / compressed->blockHeight) * levelBlockRow +
+                                                             (xoffset / compressed->blockWidth)  * compressed->blockSize;
+        for(size_t row = 0; row < blockRows; ++row) {
+            memcpy(dst + row * levelBlockRow, src + row * subBlockRow, subBlockRow);
+        }
     }
 
     SetDataUpdated(true);
 }
 
+void
+Texture::SetDepth(GLsizei depth)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!IsVolume() || depth < 1 || depth == mLayersCount) {
+        return;
+    }
+
+    WaitPendingUploads();
+
+    // the slices that are kept take their host copies along
+    StateMap_t *state = new StateMap_t[depth];
+    for(GLint layer = 0; layer < std::min(depth, mLayersCount); ++layer) {
+        state[layer].swap(mState[layer]);
+    }
+    delete [] mState;
+
+    mState       = state;
+    mLayersCount = depth;
+    UpdateStorageGeneration();
+}
+
+void
+Texture::SetStorage(GLsizei levels, GLsizei width, GLsizei height, GLenum format, GLenum type)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    WaitPendingUploads();
+
+    // every level is specified at once, nothing of the current image is kept
+    mHostStateStale   = false;
+    mCompressedFormat = GL_INVALID_VALUE;
+    mImmutableLevels  = levels;
+
+    for(GLint layer = 0; layer < mLayersCount; ++layer) {
+        mState[layer].clear();
+        for(GLint level = 0; level < levels; ++level) {
+            State_t *state = &mState[layer][level];
+            state->width  = std::max(width  >> level, 1);
+            state->height = std::max(height >> level, 1);
+            state->format = format;
+            state->type   = type;
+        }
+    }
+}
+
+bool
+Texture::UpdateVkLevel(GLint level, GLint layer, VkFormat vkFormat)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!FitsVkImage(level, layer, vkFormat)) {
+        return false;
+    }
+
+    State_t *state = &mState[layer][level];
+    if(state->data) {
+        ImageRect srcRect(0, 0, state->width, state->height,
+                          GlInternalFormatTypeToNumElements(mInternalFormat, state->type),
+                          GlTypeToElementSize(state->type),
+                          Texture::GetDefaultInternalAlignment());
+        ImageRect dstRect(0, 0, state->width, state->height,
+                          GlInternalFormatTypeToNumElements(mExplicitInternalFormat, mExplicitType),
+                          GlTypeToElementSize(mExplicitType),
+                          Texture::GetDefaultInternalAlignment());
+        CopyPixelsFromHost(&srcRect, &dstRect, level, layer, mInternalFormat, state->data, true, true);
+        state->data = nullptr;
+        mHostStateStale = true;
+    }
+
+    UpdateVkMaxLod();
+
+    return true;
+}
+
+bool
+Texture::UpdateVkLevel(GLsizei width, GLsizei height, GLint level, GLint layer, GLenum format, GLenum type, GLint unpackAlignment, const void *pixels, VkFormat vkFormat, GLint unpackRowLength)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // only a level that takes its place in the current image goes there without a host copy
+    if(mImage->GetImage() == VK_NULL_HANDLE || mCompressedFormat != GL_INVALID_VALUE ||
+       format != mFormat || type != mType ||
+       width  != std::max(GetWidth()  >> level, 1) ||
+       height != std::max(GetHeight() >> level, 1)) {
+        return false;
+    }
+
+    // the other levels stay on the device, nothing is read back for them
+    WaitPendingUploads();
+    State_t *state = &mState[layer][level];
+    state->width  = width;
+    state->height = height;
+    state->format = format;
+    state->type   = type;
+    if(!FitsVkImage(level, layer, vkFormat)) {
+        return false;
+    }
+
+    if(state->data) {
+        delete [] (uint8_t *)state->data;
+        state->data = nullptr;
+    }
+    if(level > 0) {
+        mMipmapHint = true;
+    }
+    mHostStateStale = true;
+
+    if(pixels) {
+        ImageRect srcRect(0, 0, width, height,
+                          GlInternalFormatTypeToNumElements(mInternalFormat, type),
+                          GlTypeToElementSize(type),
+                          unpackAlignment);
+        srcRect.mRowLength = unpackRowLength;
+        ImageRect dstRect(0, 0, width, height,
+                          GlInternalFormatTypeToNumElements(mExplicitInternalFormat, mExplicitType),
+                          GlTypeToElementSize(mExplicitType),
+                          Texture::GetDefaultInternalAlignment());
+        CopyPixelsFromHost(&srcRect, &dstRect, level, layer, mInternalFormat, pixels);
+    }
+
+    UpdateVkMaxLod();
+
+    return true;
+}
+
+void
+Texture::UpdateVkMaxLod(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // a chain uploaded level by level is sampled as a whole once its last level is in
+    const GLint mipLevelsCount = mMipLevelsCount;
+    if(IsCompleted() && mipLevelsCount != mMipLevelsCount) {
+        mSampler->SetMaxLod((mParameters.GetMinFilter() == GL_NEAREST || mParameters.GetMinFilter() == GL_LINEAR) ? 0.25f : static_cast<float>(mMipLevelsCount-1));
+    }
+}
+
+bool
+Texture::UpdateVkSubImage(ImageRect *srcRect, ImageRect *dstRect, GLint level, GLint layer, GLenum srcFormat, const void *srcData, VkFormat vkFormat)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the pixels are converted as they come, so only the pairs uploads already go through are taken
+    if(srcFormat != mInternalFormat || !FitsVkImage(level, layer, vkFormat)) {
+        return false;
+    }
+
+    ImageRect vkRect(dstRect->x, dstRect->y, srcRect->width, srcRect->height,
+                     GlInternalFormatTypeToNumElements(mExplicitInternalFormat, mExplicitType),
+                     GlTypeToElementSize(mExplicitType),
+                     Texture::GetDefaultInternalAlignment());
+    CopyPixelsFromHost(srcRect, &vkRect, level, layer, srcFormat, srcData);
+
+    // a host copy left of the level is out of date now
+    State_t *state = &mState[layer][level];
+    if(state->data) {
+        WaitPendingUploads();
+        delete [] (uint8_t *)state->data;
+        state->data = nullptr;
+    }
+    mHostStateStale = true;
+    SetDataUpdated(true);
+
+    return true;
+}
+
 void Texture::CopyPixelsToHost(ImageRect *srcRect, ImageRect *dstRect, GLint miplevel, GLint layer, GLenum dstFormat, void *dstData)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
@@ -351,14 +1055,20 @@ void Texture::CopyPixelsToHost(ImageRect *srcRect, ImageRect *dstRect, GLint mip
 
     // create a buffer at the size of the requested subrectangle
     const size_t srcSize   = srcRect->GetRectBufferSize();
-    BufferObject *tbo = new TransferDstBufferObject(mVkContext);
-    tbo->Allocate(srcSize, nullptr);
+    assert(GetCurrentContext());
+    CacheManager *cacheManager = GetCurrentContext()->GetCacheManager();
+    BufferObject *tbo = cacheManager->GetStagingBuffer(srcSize, false);
+    if(!tbo) {
+        return;
+    }
 
     // use the global rect offsets for transfering the subpixels from Vulkan
     SubmitCopyPixels(srcRect, tbo, miplevel, layer, dstFormat, false);
 
     // convert the destination buffer (both are similar dimensions) to the internal format
-    uint8_t *srcData = new uint8_t[srcSize];
+    LinearAllocator *arena = GetCurrentContext()->GetFrameArena();
+    LinearAllocatorScope scope(arena);
+    uint8_t *srcData = arena->Allocate<uint8_t>(srcSize);
     tbo->GetData(srcSize, 0, srcData);
 
     ImageRect tmp_srcRect = *srcRect;
@@ -374,37 +1084,92 @@ void Texture::CopyPixelsToHost(ImageRect *srcRect, ImageRect *dstRect, GLint mip
     }
     mDataNoInvertion = false;
 
-    delete    tbo;
-    delete[]  srcData;
+    // the readback has been waited upon, so the buffer is idle already
+    cacheManager->ReleaseStagingBuffer(tbo);
 }
 
-void Texture::CopyPixelsFromHost(ImageRect *srcRect, ImageRect *dstRect, GLint miplevel, GLint layer, GLenum srcFormat, const void *srcData)
+void Texture::CopyPixelsFromHost(ImageRect *srcRect, ImageRect *dstRect, GLint miplevel, GLint layer, GLenum srcFormat, const void *srcData, bool deferred, bool releaseSrcData)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
     const GLenum dstFormat = mExplicitInternalFormat;
 
-    // create a buffer at the size of the requested subrectangle
-    const size_t dstSize   = dstRect->GetRectBufferSize();
-    uint8_t *dstData = new uint8_t[dstSize];
+    if(ConvertPixelsOnDevice(srcRect, dstRect, miplevel, layer, srcFormat, srcData)) {
+        if(releaseSrcData) {
+            delete [] static_cast<const uint8_t *>(srcData);
+        }
+        return;
+    }
 
-    // convert the destination buffer (both are similar dimensions) to the internal format
+    // rows that need no conversion are staged as the source lays them out, in a single copy, and the copy to
+    // the image steps over what lies between them with the row length of the buffer. Rows padded to more than
+    // twice their data are repacked instead, so that the padding is not staged along
+    const uint32_t pixelSize  = srcRect->GetPixelByteOffset();
+    const uint32_t srcStride  = srcRect->GetRectAlignedRowInBytes();
+    const bool     directCopy = !deferred && srcFormat == dstFormat && srcRect->height > 1 &&
+                                pixelSize == dstRect->GetPixelByteOffset() && !(srcStride % pixelSize) &&
+                                srcStride <= 2 * srcRect->GetDataRowSize();
+
+    const size_t dstSize   = directCopy ? (srcRect->height - 1) * srcStride + srcRect->GetDataRowSize() : dstRect->GetRectBufferSize();
+    CacheManager *cacheManager = GetCurrentContext()->GetCacheManager();
+    BufferObject *tbo = cacheManager->GetStagingBuffer(dstSize, true);
+    if(!tbo) {
+        if(releaseSrcData) {
+            delete [] static_cast<const uint8_t *>(srcData);
+        }
+        return;
+    }
+
+    // convert the source buffer (both are similar dimensions) to the internal format,
+    // straight into the staging memory when it is mapped
     ImageRect tmp_srcRect = *srcRect;
     ImageRect tmp_dstRect = *dstRect;
     tmp_srcRect.x = 0; tmp_srcRect.y = 0;
     tmp_dstRect.x = 0; tmp_dstRect.y = 0;
-    ConvertPixels(srcFormat, dstFormat,
-                  &tmp_srcRect, srcData,
-                  &tmp_dstRect, dstData);
+    void *mappedData = tbo->Map(0, dstSize, GL_MAP_WRITE_BIT_EXT);
+    if(directCopy) {
+        const uint8_t *srcRows = static_cast<const uint8_t *>(srcData) + srcRect->GetStartRowIndex(srcStride);
+        if(mappedData) {
+            memcpy(mappedData, srcRows, dstSize);
+            tbo->Unmap();
+        } else {
+            tbo->UpdateData(dstSize, 0, srcRows);
+        }
+
+        if(releaseSrcData) {
+            delete [] static_cast<const uint8_t *>(srcData);
+        }
+    } else if(mappedData && deferred && dstSize >= GLOVE_ASYNC_UPLOAD_MIN_SIZE) {
+        // large uploads are converted off the GL thread, the memory is coherent and stays mapped
+        UploadWorker::job_t job = { this, srcFormat, dstFormat, tmp_srcRect, tmp_dstRect, srcData, mappedData, releaseSrcData };
+        GetCurrentContext()->GetUploadWorker()->Enqueue(job);
+        tbo->Unmap();
+    } else {
+        if(mappedData) {
+            ConvertPixels(srcFormat, dstFormat,
+                          &tmp_srcRect, srcData,
+                          &tmp_dstRect, mappedData);
+            tbo->Unmap();
+        } else {
+            LinearAllocator *arena = GetCurrentContext()->GetFrameArena();
+            LinearAllocatorScope scope(arena);
+            uint8_t *dstData = arena->Allocate<uint8_t>(dstSize);
+            ConvertPixels(srcFormat, dstFormat,
+                          &tmp_srcRect, srcData,
+                          &tmp_dstRect, dstData);
+            tbo->UpdateData(dstSize, 0, dstData);
+        }
 
-    BufferObject *tbo = new TransferSrcBufferObject(mVkContext);
-    tbo->Allocate(dstSize, dstData);
+        if(releaseSrcData) {
+            delete [] static_cast<const uint8_t *>(srcData);
+        }
+    }
 
     // use the global rect offsets for transfering the subpixels to Vulkan
-    SubmitCopyPixels(dstRect, tbo, miplevel, layer, dstFormat, true);
+    SubmitCopyPixels(dstRect, tbo, miplevel, layer, dstFormat, true, directCopy ? srcStride / pixelSize : 0);
 
-    delete    tbo;
-    delete[]  dstData;
+    // the staging buffer returns to its pool once the batched upload has been executed
+    cacheManager->CacheStagingBuffer(tbo);
 
 #if GLOVE_SAVE_TEXTURES_TO_FILE == true
     // TODO:: adjust for lod levels
@@ -427,11 +1192,161 @@ void Texture::CopyPixelsFromHost(ImageRect *srcRect, ImageRect *dstRect, GLint m
  #endif
 }
 
-void Texture::SubmitCopyPixels(const Rect *rect, BufferObject *tbo, GLint miplevel, GLint layer, GLenum srcFormat, bool copyToImage)
+/// color formats a blit converts between the way GL does, unlike the single channel ones that are swizzled
+static bool
+IsBlitConvertible(GLenum internalFormat)
+{
+    switch(internalFormat) {
+    case GL_RGB565:
+    case GL_RGBA4:
+    case GL_RGB5_A1:
+    case GL_RGB8_OES:
+    case GL_RGBA:
+    case GL_RGBA8_OES:
+    case GL_BGRA_EXT:
+    case GL_BGRA8_EXT:  return true;
+    default:            return false;
+    }
+}
+
+bool
+Texture::ConvertPixelsOnDevice(ImageRect *srcRect, ImageRect *dstRect, GLint miplevel, GLint layer, GLenum srcFormat, const void *srcData)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // small images are converted faster on the host than the blit is recorded and submitted
+    const GLenum dstFormat = mExplicitInternalFormat;
+    if(!GLOVE_DEVICE_PIXEL_CONVERSION || srcFormat == dstFormat || IsVolume() ||
+       dstRect->GetRectBufferSize() < GLOVE_DEVICE_PIXEL_CONVERSION_MIN_SIZE ||
+       !IsBlitConvertible(srcFormat) || !IsBlitConvertible(dstFormat)) {
+        return false;
+    }
+
+    // the rows are staged as the source lays them out, so that the copy steps over their padding
+    const uint32_t pixelSize = srcRect->GetPixelByteOffset();
+    const uint32_t srcStride = srcRect->GetRectAlignedRowInBytes();
+    if(srcStride % pixelSize) {
+        return false;
+    }
+
+    // the source format has to be sampled and blitted from, even where the texture is not stored in it
+    const VkFormat srcVkFormat = GlInternalFormatToVkFormat(srcFormat);
+    if(mImage->GetImage() == VK_NULL_HANDLE || !(GetVkImageUsage() & VK_IMAGE_USAGE_TRANSFER_DST_BIT) ||
+       !mImage->IsFormatFeatureSupported(VK_FORMAT_FEATURE_BLIT_DST_BIT) ||
+       FindSupportedFormat(mVkContext->vkGpus[0], {srcVkFormat}, VK_IMAGE_TILING_OPTIMAL,
+                           VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) == VK_FORMAT_UNDEFINED) {
+        return false;
+    }
+
+    assert(GetCurrentContext());
+    Context *context = GetCurrentContext();
+    Texture *uploadTexture = context->GetUploadTexture(GlInternalFormatToGlFormat(srcFormat), GlInternalFormatToGlType(srcFormat),
+                                                       srcRect->width, srcRect->height);
+    if(!uploadTexture) {
+        return false;
+    }
+
+    const size_t size = (srcRect->height - 1) * srcStride + srcRect->GetDataRowSize();
+    CacheManager *cacheManager = context->GetCacheManager();
+    BufferObject *tbo = cacheManager->GetStagingBuffer(size, true);
+    if(!tbo) {
+        return false;
+    }
+
+    const uint8_t *srcRows = static_cast<const uint8_t *>(srcData) + srcRect->GetStartRowIndex(srcStride);
+    void *mappedData = tbo->Map(0, size, GL_MAP_WRITE_BIT_EXT);
+    if(mappedData) {
+        memcpy(mappedData, srcRows, size);
+        tbo->Unmap();
+    } else {
+        tbo->UpdateData(size, 0, srcRows);
+    }
+
+    // the levels of a demoted image are the ones of the texture past the dropped ones
+    miplevel -= mDemotedLevels;
+
+    vulkanAPI::CommandBufferManager *commandBufferManager = context->GetVkCommandBufferManager();
+    commandBufferManager->BeginVkAuxCommandBuffer();
+    VkCommandBuffer activeCmdBuffer = commandBufferManager->GetAuxCommandBuffer();
+    {
+        vulkanAPI::Image *uploadImage = uploadTexture->GetImage();
+        uploadImage->ModifyImageSubresourceRange(0, 1, 0, 1);
+        uploadImage->ModifyImageLayout(&activeCmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        uploadImage->CreateBufferImageCopy(0, 0, srcRect->width, srcRect->height, 0, 0, 1, srcStride / pixelSize);
+        uploadImage->CopyBufferToImage(&activeCmdBuffer, tbo->GetVkBuffer());
+        uploadImage->ModifyImageLayout(&activeCmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+
+        VkImageLayout dstOldLayout = mImage->GetImageLayout();
+        dstOldLayout = (dstOldLayout != VK_IMAGE_LAYOUT_UNDEFINED &&
+                        dstOldLayout != VK_IMAGE_LAYOUT_PREINITIALIZED) ? dstOldLayout : VK_IMAGE_LAYOUT_GENERAL;
+        mImage->ModifyImageSubresourceRange(miplevel, 1, layer, 1);
+        mImage->ModifyImageLayout(&activeCmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+        VkImageBlit imageBlit;
+        memset(static_cast<void *>(&imageBlit), 0, sizeof(imageBlit));
+        imageBlit.srcSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+        imageBlit.srcSubresource.layerCount     = 1;
+        imageBlit.srcOffsets[1].x               = srcRect->width;
+        imageBlit.srcOffsets[1].y               = srcRect->height;
+        imageBlit.srcOffsets[1].z               = 1;
+        imageBlit.dstSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+        imageBlit.dstSubresource.mipLevel       = miplevel;
+        imageBlit.dstSubresource.baseArrayLayer = layer;
+        imageBlit.dstSubresource.layerCount     = 1;
+        imageBlit.dstOffsets[0].x               = dstRect->x;
+        imageBlit.dstOffsets[0].y               = dstRect->y;
+        imageBlit.dstOffsets[1].x               = dstRect->x + srcRect->width;
+        imageBlit.dstOffsets[1].y               = dstRect->y + srcRect->height;
+        imageBlit.dstOffsets[1].z               = 1;
+
+        uploadImage->BlitImage(&activeCmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                               mImage->GetImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               &imageBlit, VK_FILTER_NEAREST);
+
+        mImage->ModifyImageLayout(&activeCmdBuffer, dstOldLayout);
+    }
+
+    // uploads are batched with the next draw submission, as the ones converted on the host
+    cacheManager->CacheStagingBuffer(tbo);
+
+    return true;
+}
+
+void Texture::CopyCompressedPixelsFromHost(GLint miplevel, GLint layer, const void *srcData)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    const State_t *state = &mState[layer][miplevel];
+    const size_t size = GetCompressedImageSize(FindCompressedFormat(state->format), state->width, state->height);
+    CacheManager *cacheManager = GetCurrentContext()->GetCacheManager();
+    BufferObject *tbo = cacheManager->GetStagingBuffer(size, true);
+    if(!tbo) {
+        return;
+    }
+
+    // the blocks need no conversion, they are copied as they are to the staging memory
+    void *mappedData = tbo->Map(0, size, GL_MAP_WRITE_BIT_EXT);
+    if(mappedData) {
+        memcpy(mappedData, srcData, size);
+        tbo->Unmap();
+    } else {
+        tbo->UpdateData(size, 0, srcData);
+    }
+
+    Rect rect(0, 0, state->width, state->height);
+    SubmitCopyPixels(&rect, tbo, miplevel, layer, state->format, true);
+
+    cacheManager->CacheStagingBuffer(tbo);
+}
+
+void Texture::SubmitCopyPixels(const Rect *rect, BufferObject *tbo, GLint miplevel, GLint layer, GLenum srcFormat, bool copyToImage, uint32_t bufferRowLength)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
+    GLOVE_PROFILE_ZONE("Texture::SubmitCopyPixels");
 
-    mImage->CreateBufferImageCopy(rect->x, rect->y, rect->width, rect->height, miplevel, layer, 1);
+    // the levels of a demoted image are the ones of the texture past the dropped ones
+    miplevel -= mDemotedLevels;
+    mImage->CreateBufferImageCopy(rect->x, rect->y, rect->width, rect->height, miplevel, layer, 1, bufferRowLength);
     mImage->ModifyImageSubresourceRange(miplevel, 1, layer, 1);
 
     VkImageLayout oldImageLayout = mImage->GetImageLayout();
@@ -441,6 +1356,27 @@ void Texture::SubmitCopyPixels(const Rect *rect, BufferObject *tbo, GLint miplev
 
     assert(GetCurrentContext());
     vulkanAPI::CommandBufferManager *commandBufferManager = GetCurrentContext()->GetVkCommandBufferManager();
+
+    // uploads are performed by the dedicated transfer queue when available, the image
+    // is handed over to it and back to the graphics queue around the copy
+    if(copyToImage && commandBufferManager->BeginVkTransferCommandBuffer()) {
+        VkCommandBuffer releaseCmdBuffer  = commandBufferManager->GetTransferReleaseCommandBuffer();
+        VkCommandBuffer transferCmdBuffer = commandBufferManager->GetTransferCommandBuffer();
+        VkCommandBuffer acquireCmdBuffer  = commandBufferManager->GetTransferAcquireCommandBuffer();
+        uint32_t        graphicsFamily    = mVkContext->vkGraphicsQueueNodeIndex;
+        uint32_t        transferFamily    = mVkContext->vkTransferQueueNodeIndex;
+        VkImageLayout   currentLayout     = mImage->GetImageLayout();
+
+        mImage->TransferImageOwnership(&releaseCmdBuffer , currentLayout , newImageLayout, graphicsFamily, transferFamily, true);
+        mImage->TransferImageOwnership(&transferCmdBuffer, currentLayout , newImageLayout, graphicsFamily, transferFamily, false);
+        mImage->SetImageLayout(newImageLayout);
+        mImage->CopyBufferToImage(&transferCmdBuffer, tbo->GetVkBuffer());
+        mImage->TransferImageOwnership(&transferCmdBuffer, newImageLayout, oldImageLayout, transferFamily, graphicsFamily, true);
+        mImage->TransferImageOwnership(&acquireCmdBuffer , newImageLayout, oldImageLayout, transferFamily, graphicsFamily, false);
+        mImage->SetImageLayout(oldImageLayout);
+        return;
+    }
+
     commandBufferManager->BeginVkAuxCommandBuffer();
     VkCommandBuffer activeCmdBuffer = commandBufferManager->GetAuxCommandBuffer();
     {
@@ -452,9 +1388,255 @@ void Texture::SubmitCopyPixels(const Rect *rect, BufferObject *tbo, GLint miplev
         }
         mImage->ModifyImageLayout(&activeCmdBuffer, oldImageLayout);
     }
-    commandBufferManager->EndVkAuxCommandBuffer();
-    commandBufferManager->SubmitVkAuxCommandBuffer();
-    commandBufferManager->WaitVkAuxCommandBuffer();
+
+    // uploads are batched with the next draw submission, only reads need to wait
+    if(!copyToImage) {
+        commandBufferManager->SubmitVkAuxCommandBuffer();
+        commandBufferManager->WaitVkAuxCommandBuffer();
+    }
+}
+
+bool
+Texture::CopyPixelsFromImage(Texture *srcTexture, const Rect *srcRect, bool srcOriginFlipped, GLint dstX, GLint dstY, GLint miplevel, GLint layer)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(srcTexture == this || !Promote() || !srcTexture->Promote()) {
+        return false;
+    }
+
+    vulkanAPI::Image *srcImage = srcTexture->GetImage();
+    if(srcImage->GetImage() == VK_NULL_HANDLE || mImage->GetImage() == VK_NULL_HANDLE) {
+        return false;
+    }
+
+    if(srcRect->x < 0 || srcRect->y < 0 ||
+       srcRect->x + srcRect->width  > srcTexture->GetWidth() ||
+       srcRect->y + srcRect->height > srcTexture->GetHeight()) {
+        return false;
+    }
+
+    // a flipped source or a format conversion needs a blit, a plain copy is used otherwise
+    bool blit = srcOriginFlipped || srcImage->GetFormat() != mImage->GetFormat();
+    // the slice of a 3D image is addressed by its depth instead
+    const bool    volume = mImage->GetImageTarget() == vulkanAPI::Image::VK_IMAGE_TARGET_3D;
+    const int32_t dstZ   = volume ? layer : 0;
+    if(blit && (!srcImage->IsFormatFeatureSupported(VK_FORMAT_FEATURE_BLIT_SRC_BIT) ||
+                !mImage->IsFormatFeatureSupported(VK_FORMAT_FEATURE_BLIT_DST_BIT))) {
+        return false;
+    }
+
+    assert(GetCurrentContext());
+    vulkanAPI::CommandBufferManager *commandBufferManager = GetCurrentContext()->GetVkCommandBufferManager();
+    commandBufferManager->BeginVkAuxCommandBuffer();
+    VkCommandBuffer activeCmdBuffer = commandBufferManager->GetAuxCommandBuffer();
+    {
+        VkImageLayout srcOldLayout = srcImage->GetImageLayout();
+        srcOldLayout = (srcOldLayout != VK_IMAGE_LAYOUT_UNDEFINED &&
+                        srcOldLayout != VK_IMAGE_LAYOUT_PREINITIALIZED) ? srcOldLayout : VK_IMAGE_LAYOUT_GENERAL;
+        VkImageLayout dstOldLayout = mImage->GetImageLayout();
+        dstOldLayout = (dstOldLayout != VK_IMAGE_LAYOUT_UNDEFINED &&
+                        dstOldLayout != VK_IMAGE_LAYOUT_PREINITIALIZED) ? dstOldLayout : VK_IMAGE_LAYOUT_GENERAL;
+
+        srcImage->ModifyImageSubresourceRange(0, 1, 0, 1);
+        srcImage->ModifyImageLayout(&activeCmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+        mImage->ModifyImageSubresourceRange(miplevel, 1, layer, 1);
+        mImage->ModifyImageLayout(&activeCmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+        if(blit) {
+            // flipped sources are stored top-down, inverting the source offsets brings the rows to GL order
+            VkImageBlit imageBlit;
+            memset(static_cast<void *>(&imageBlit), 0, sizeof(imageBlit));
+            imageBlit.srcSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+            imageBlit.srcSubresource.layerCount     = 1;
+            imageBlit.srcOffsets[0].x               = srcRect->x;
+            imageBlit.srcOffsets[0].y               = srcOriginFlipped ? srcTexture->GetHeight() - srcRect->y : srcRect->y;
+            imageBlit.srcOffsets[1].x               = srcRect->x + srcRect->width;
+            imageBlit.srcOffsets[1].y               = srcOriginFlipped ? imageBlit.srcOffsets[0].y - srcRect->height : srcRect->y + srcRect->height;
+            imageBlit.srcOffsets[1].z               = 1;
+
+            imageBlit.dstSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+            imageBlit.dstSubresource.mipLevel       = miplevel;
+            imageBlit.dstSubresource.baseArrayLayer = volume ? 0 : layer;
+            imageBlit.dstSubresource.layerCount     = 1;
+            imageBlit.dstOffsets[0].x               = dstX;
+            imageBlit.dstOffsets[0].y               = dstY;
+            imageBlit.dstOffsets[0].z               = dstZ;
+            imageBlit.dstOffsets[1].x               = dstX + srcRect->width;
+            imageBlit.dstOffsets[1].y               = dstY + srcRect->height;
+            imageBlit.dstOffsets[1].z               = dstZ + 1;
+
+            srcImage->BlitImage(&activeCmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                mImage->GetImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                &imageBlit, VK_FILTER_NEAREST);
+        } else {
+            VkImageCopy imageCopy;
+            memset(static_cast<void *>(&imageCopy), 0, sizeof(imageCopy));
+            imageCopy.srcSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+            imageCopy.srcSubresource.layerCount     = 1;
+            imageCopy.srcOffset.x                   = srcRect->x;
+            imageCopy.srcOffset.y                   = srcRect->y;
+            imageCopy.dstSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+            imageCopy.dstSubresource.mipLevel       = miplevel;
+            imageCopy.dstSubresource.baseArrayLayer = volume ? 0 : layer;
+            imageCopy.dstSubresource.layerCount     = 1;
+            imageCopy.dstOffset.x                   = dstX;
+            imageCopy.dstOffset.y                   = dstY;
+            imageCopy.dstOffset.z                   = dstZ;
+            imageCopy.extent.width                  = srcRect->width;
+            imageCopy.extent.height                 = srcRect->height;
+            imageCopy.extent.depth                  = 1;
+
+            srcImage->CopyImage(&activeCmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                mImage->GetImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                &imageCopy);
+        }
+
+        srcImage->ModifyImageLayout(&activeCmdBuffer, srcOldLayout);
+        mImage->ModifyImageLayout(&activeCmdBuffer, dstOldLayout);
+    }
+
+    // the host copies are only refreshed when they are needed again
+    mHostStateStale = true;
+
+    return true;
+}
+
+bool
+Texture::BlitPixelsFromImage(Texture *srcTexture, const VkImageBlit *imageBlit, VkFilter filter)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(srcTexture == this || !Promote() || !srcTexture->Promote()) {
+        return false;
+    }
+
+    vulkanAPI::Image *srcImage = srcTexture->GetImage();
+    if(srcImage->GetImage() == VK_NULL_HANDLE || mImage->GetImage() == VK_NULL_HANDLE) {
+        return false;
+    }
+
+    if(!(srcTexture->GetVkImageUsage() & VK_IMAGE_USAGE_TRANSFER_SRC_BIT) || !(GetVkImageUsage() & VK_IMAGE_USAGE_TRANSFER_DST_BIT) ||
+       !srcImage->IsFormatFeatureSupported(VK_FORMAT_FEATURE_BLIT_SRC_BIT) || !mImage->IsFormatFeatureSupported(VK_FORMAT_FEATURE_BLIT_DST_BIT)) {
+        return false;
+    }
+
+    // formats that cannot be filtered are scaled with the nearest texels instead
+    if(filter == VK_FILTER_LINEAR && !srcImage->IsFormatFeatureSupported(VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)) {
+        filter = VK_FILTER_NEAREST;
+    }
+
+    assert(GetCurrentContext());
+    vulkanAPI::CommandBufferManager *commandBufferManager = GetCurrentContext()->GetVkCommandBufferManager();
+    commandBufferManager->BeginVkAuxCommandBuffer();
+    VkCommandBuffer activeCmdBuffer = commandBufferManager->GetAuxCommandBuffer();
+    {
+        VkImageLayout srcOldLayout = srcImage->GetImageLayout();
+        srcOldLayout = (srcOldLayout != VK_IMAGE_LAYOUT_UNDEFINED &&
+                        srcOldLayout != VK_IMAGE_LAYOUT_PREINITIALIZED) ? srcOldLayout : VK_IMAGE_LAYOUT_GENERAL;
+        VkImageLayout dstOldLayout = mImage->GetImageLayout();
+        dstOldLayout = (dstOldLayout != VK_IMAGE_LAYOUT_UNDEFINED &&
+                        dstOldLayout != VK_IMAGE_LAYOUT_PREINITIALIZED) ? dstOldLayout : VK_IMAGE_LAYOUT_GENERAL;
+
+        srcImage->ModifyImageSubresourceRange(imageBlit->srcSubresource.mipLevel, 1, imageBlit->srcSubresource.baseArrayLayer, 1);
+        srcImage->ModifyImageLayout(&activeCmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+        mImage->ModifyImageSubresourceRange(imageBlit->dstSubresource.mipLevel, 1, imageBlit->dstSubresource.baseArrayLayer, 1);
+        mImage->ModifyImageLayout(&activeCmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+        srcImage->BlitImage(&activeCmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                            mImage->GetImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                            imageBlit, filter);
+
+        srcImage->ModifyImageLayout(&activeCmdBuffer, srcOldLayout);
+        mImage->ModifyImageLayout(&activeCmdBuffer, dstOldLayout);
+    }
+
+    mHostStateStale = true;
+
+    return true;
+}
+
+bool
+Texture::CopyPixelsToBuffer(const Rect *srcRect, bool srcOriginFlipped, Texture *convertTexture,
+                            BufferObject *dstBuffer, size_t dstOffset, uint32_t dstRowLength)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!Promote()) {
+        return false;
+    }
+
+    vulkanAPI::Image *copyImage = convertTexture ? convertTexture->GetImage() : mImage;
+    if(mImage->GetImage() == VK_NULL_HANDLE || copyImage->GetImage() == VK_NULL_HANDLE) {
+        return false;
+    }
+
+    if(convertTexture && (!mImage->IsFormatFeatureSupported(VK_FORMAT_FEATURE_BLIT_SRC_BIT) ||
+                          !copyImage->IsFormatFeatureSupported(VK_FORMAT_FEATURE_BLIT_DST_BIT))) {
+        return false;
+    }
+
+    assert(GetCurrentContext());
+    vulkanAPI::CommandBufferManager *commandBufferManager = GetCurrentContext()->GetVkCommandBufferManager();
+    commandBufferManager->BeginVkAuxCommandBuffer();
+    VkCommandBuffer activeCmdBuffer = commandBufferManager->GetAuxCommandBuffer();
+    {
+        VkImageLayout srcOldLayout = mImage->GetImageLayout();
+        srcOldLayout = (srcOldLayout != VK_IMAGE_LAYOUT_UNDEFINED &&
+                        srcOldLayout != VK_IMAGE_LAYOUT_PREINITIALIZED) ? srcOldLayout : VK_IMAGE_LAYOUT_GENERAL;
+
+        mImage->ModifyImageSubresourceRange(0, 1, 0, 1);
+        mImage->ModifyImageLayout(&activeCmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+
+        Rect copyRect = *srcRect;
+        if(convertTexture) {
+            // the blit converts to the packed format and brings flipped rows to GL order
+            copyImage->ModifyImageSubresourceRange(0, 1, 0, 1);
+            copyImage->ModifyImageLayout(&activeCmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+            VkImageBlit imageBlit;
+            memset(static_cast<void *>(&imageBlit), 0, sizeof(imageBlit));
+            imageBlit.srcSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+            imageBlit.srcSubresource.layerCount     = 1;
+            imageBlit.srcOffsets[0].x               = srcRect->x;
+            imageBlit.srcOffsets[0].y               = srcOriginFlipped ? GetHeight() - srcRect->y : srcRect->y;
+            imageBlit.srcOffsets[1].x               = srcRect->x + srcRect->width;
+            imageBlit.srcOffsets[1].y               = srcOriginFlipped ? imageBlit.srcOffsets[0].y - srcRect->height : srcRect->y + srcRect->height;
+            imageBlit.srcOffsets[1].z               = 1;
+            imageBlit.dstSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+            imageBlit.dstSubresource.layerCount     = 1;
+            imageBlit.dstOffsets[1].x               = srcRect->width;
+            imageBlit.dstOffsets[1].y               = srcRect->height;
+            imageBlit.dstOffsets[1].z               = 1;
+
+            mImage->BlitImage(&activeCmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                              copyImage->GetImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                              &imageBlit, VK_FILTER_NEAREST);
+
+            mImage->ModifyImageLayout(&activeCmdBuffer, srcOldLayout);
+            copyImage->ModifyImageLayout(&activeCmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+            copyRect = Rect(0, 0, srcRect->width, srcRect->height);
+        }
+
+        // earlier readbacks into the buffer are ordered before this one
+        dstBuffer->PipelineBarrier(&activeCmdBuffer, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                                   VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+        copyImage->CreateBufferImageCopy(copyRect.x, copyRect.y, copyRect.width, copyRect.height, 0, 0, 1);
+        copyImage->GetBufferImageCopy()->bufferOffset    = dstOffset;
+        copyImage->GetBufferImageCopy()->bufferRowLength = dstRowLength;
+        copyImage->CopyImageToBuffer(&activeCmdBuffer, dstBuffer->GetVkBuffer());
+
+        if(!convertTexture) {
+            mImage->ModifyImageLayout(&activeCmdBuffer, srcOldLayout);
+        }
+
+        // the host reads the rows once the submission has completed
+        dstBuffer->PipelineBarrier(&activeCmdBuffer, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_HOST_READ_BIT,
+                                   VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT);
+    }
+
+    return true;
 }
 
 void
@@ -462,17 +1644,30 @@ Texture::PrepareVkImageLayout(VkImageLayout newImageLayout)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    if(GetVkImageLayout() == newImageLayout) {
+        return;
+    }
+
     assert(GetCurrentContext());
     vulkanAPI::CommandBufferManager *commandBufferManager = GetCurrentContext()->GetVkCommandBufferManager();
     commandBufferManager->BeginVkAuxCommandBuffer();
     VkCommandBuffer cmdBuffer = commandBufferManager->GetAuxCommandBuffer();
 
-    mImage->ModifyImageSubresourceRange(0, mMipLevelsCount, 0, mLayersCount);
+    mImage->ModifyImageSubresourceRange(0, mImage->GetMipLevels(), 0, mLayersCount);
     mImage->ModifyImageLayout(&cmdBuffer, newImageLayout);
+}
+
+void
+Texture::RecordVkImageLayout(VkCommandBuffer *cmdBuffer, VkImageLayout newImageLayout)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
 
-    commandBufferManager->EndVkAuxCommandBuffer();
-    commandBufferManager->SubmitVkAuxCommandBuffer();
-    commandBufferManager->WaitVkAuxCommandBuffer();
+    if(GetVkImageLayout() == newImageLayout) {
+        return;
+    }
+
+    mImage->ModifyImageSubresourceRange(0, mImage->GetMipLevels(), 0, mLayersCount);
+    mImage->ModifyImageLayout(cmdBuffer, newImageLayout);
 }
 
 void
@@ -503,52 +1698,84 @@ Texture::GenerateMipmaps(GLenum hintMipmapMode)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    int numElements = GlInternalFormatTypeToNumElements(GetExplicitInternalFormat(), GetExplicitType());
-    int sizeElement = GlTypeToElementSize(GetExplicitType());
-    int alignment   = Texture::GetDefaultInternalAlignment();
-    ImageRect srcRect(0, 0, GetWidth(), GetHeight(), numElements, sizeElement, alignment);
-    ImageRect dstRect(0, 0, GetWidth(), GetHeight(), numElements, sizeElement, alignment);
+    assert(GetCurrentContext());
+    vulkanAPI::CommandBufferManager *commandBufferManager = GetCurrentContext()->GetVkCommandBufferManager();
 
-    const size_t     baseLevel  = 0;
-    const size_t     baseSize   = dstRect.GetRectBufferSize();
-    std::vector<uint8_t*> basePixels(mLayersCount);
-    for(GLint layer = 0; layer < mLayersCount; ++layer) {
-        basePixels[layer] = new uint8_t[baseSize];
-        CopyPixelsToHost(&srcRect, &dstRect, baseLevel, layer, GetExplicitInternalFormat(), basePixels[layer]);
+    if(mImage->GetImage() == VK_NULL_HANDLE || !Promote()) {
+        return;
     }
 
-    // create Mipmapped Texture
-    mMipLevelsCount = NUMBER_OF_MIP_LEVELS(GetWidth(), GetHeight());
-    CreateVkTexture();
+    // recreate the image with the whole chain only when it lacks it, the base level is
+    // carried over from the current image on the device
+    mMipmapHint     = true;
+    mMipLevelsCount = mImmutableLevels ? mImmutableLevels : GetMaxMipLevels();
+    if(mImage->GetMipLevels() != static_cast<uint32_t>(mMipLevelsCount)) {
+        vulkanAPI::Image  *baseImage  = mImage;
+        vulkanAPI::Memory *baseMemory = mMemory;
+        mImage  = new vulkanAPI::Image(*baseImage);
+        mImage->SetImage(VK_NULL_HANDLE);
+        mMemory = new vulkanAPI::Memory(mVkContext, baseMemory->GetFlags(), baseMemory->GetPreferredFlags());
+
+        if(!CreateVkTexture()) {
+            delete mImage;
+            delete mMemory;
+            mImage          = baseImage;
+            mMemory         = baseMemory;
+            mMipLevelsCount = mImage->GetMipLevels();
+            CreateVkImageView();
+            return;
+        }
 
-    // set back base mipLevel for all layers
-    for(GLint layer = 0; layer < mLayersCount; ++layer) {
-        InvertImageYAxis(static_cast<uint8_t *>(basePixels[layer]), &srcRect);
-        CopyPixelsFromHost(&srcRect, &dstRect, baseLevel, layer, GetExplicitInternalFormat(), basePixels[layer]);
-        delete[] basePixels[layer];
+        VkImageCopy imageCopy;
+        memset(static_cast<void *>(&imageCopy), 0, sizeof(imageCopy));
+        imageCopy.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        imageCopy.srcSubresource.layerCount = baseImage->GetLayers();
+        imageCopy.dstSubresource            = imageCopy.srcSubresource;
+        imageCopy.extent.width              = GetWidth();
+        imageCopy.extent.height             = GetHeight();
+        imageCopy.extent.depth              = baseImage->GetDepth();
+
+        commandBufferManager->BeginVkAuxCommandBuffer();
+        VkCommandBuffer copyCmdBuffer = commandBufferManager->GetAuxCommandBuffer();
+        {
+            VkImageLayout oldImageLayout = mImage->GetImageLayout();
+
+            baseImage->ModifyImageSubresourceRange(0, 1, 0, mLayersCount);
+            baseImage->ModifyImageLayout(&copyCmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+            mImage->ModifyImageSubresourceRange(0, 1, 0, mLayersCount);
+            mImage->ModifyImageLayout(&copyCmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+            baseImage->CopyImage(&copyCmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                 mImage->GetImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                 &imageCopy);
+            mImage->ModifyImageLayout(&copyCmdBuffer, oldImageLayout);
+        }
+
+        // the previous image has to outlive the copy, which is a transfer on the device only
+        commandBufferManager->SubmitVkAuxCommandBuffer();
+        commandBufferManager->WaitVkAuxCommandBuffer();
+        delete baseImage;
+        delete baseMemory;
     }
 
-    // Blit LoD Level '0' to rest layers
+    // Blit LoD Level '0' to rest layers, the slices of a 3D image are filtered along with the rows
     VkImageBlit imageBlit;
     memset(static_cast<void *>(&imageBlit), 0, sizeof(imageBlit));
     imageBlit.srcSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
     imageBlit.srcSubresource.mipLevel       = 0;
     imageBlit.srcSubresource.baseArrayLayer = 0;
-    imageBlit.srcSubresource.layerCount     = mLayersCount;
+    imageBlit.srcSubresource.layerCount     = mImage->GetLayers();
     imageBlit.srcOffsets[1].x               = GetWidth();
     imageBlit.srcOffsets[1].y               = GetHeight();
-    imageBlit.srcOffsets[1].z               = 1;
+    imageBlit.srcOffsets[1].z               = mImage->GetDepth();
 
     imageBlit.dstSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
     imageBlit.dstSubresource.mipLevel       = 1;
     imageBlit.dstSubresource.baseArrayLayer = 0;
-    imageBlit.dstSubresource.layerCount     = mLayersCount;
+    imageBlit.dstSubresource.layerCount     = mImage->GetLayers();
     imageBlit.dstOffsets[1].x               = static_cast<int32_t>(std::max(std::floor(imageBlit.srcOffsets[1].x >> 1), 1.0));
     imageBlit.dstOffsets[1].y               = static_cast<int32_t>(std::max(std::floor(imageBlit.srcOffsets[1].y >> 1), 1.0));
-    imageBlit.dstOffsets[1].z               = 1;
+    imageBlit.dstOffsets[1].z               = static_cast<int32_t>(std::max(std::floor(imageBlit.srcOffsets[1].z >> 1), 1.0));
 
-    assert(GetCurrentContext());
-    vulkanAPI::CommandBufferManager *commandBufferManager = GetCurrentContext()->GetVkCommandBufferManager();
     commandBufferManager->BeginVkAuxCommandBuffer();
     VkCommandBuffer activeCmdBuffer = commandBufferManager->GetAuxCommandBuffer();
     {
@@ -569,17 +1796,16 @@ Texture::GenerateMipmaps(GLenum hintMipmapMode)
             imageBlit.srcSubresource.mipLevel = imageBlit.dstSubresource.mipLevel;
             imageBlit.srcOffsets[1].x         = imageBlit.dstOffsets[1].x;
             imageBlit.srcOffsets[1].y         = imageBlit.dstOffsets[1].y;
+            imageBlit.srcOffsets[1].z         = imageBlit.dstOffsets[1].z;
 
             imageBlit.dstSubresource.mipLevel++;
             imageBlit.dstOffsets[1].x = static_cast<int32_t>(std::max(std::floor(imageBlit.srcOffsets[1].x >> 1), 1.0));
             imageBlit.dstOffsets[1].y = static_cast<int32_t>(std::max(std::floor(imageBlit.srcOffsets[1].y >> 1), 1.0));
+            imageBlit.dstOffsets[1].z = static_cast<int32_t>(std::max(std::floor(imageBlit.srcOffsets[1].z >> 1), 1.0));
         }
         mImage->ModifyImageSubresourceRange(0, mMipLevelsCount, 0, mLayersCount);
         mImage->ModifyImageLayout(&activeCmdBuffer, oldImageLayout);
     }
-    commandBufferManager->EndVkAuxCommandBuffer();
-    commandBufferManager->SubmitVkAuxCommandBuffer();
-    commandBufferManager->WaitVkAuxCommandBuffer();
 
     // TODO: Fill the 'State_t' with the rest mipLevels
 }
@@ -31,6 +31,7 @@
 #include "vulkan/sampler.h"
 #include "vulkan/imageView.h"
 #include "utils/GlToVkConverter.h"
+#include <atomic>
 
 #define ISPOWEROFTWO(x)           ((x != 0) && !(x & (x - 1)))
 
@@ -61,9 +62,14 @@ private:
     // NOTE: Formats are forced into GL_RGBA8_OES. Keep here the original format requested by the user
     GLenum                      mExplicitType;
     GLenum                      mExplicitInternalFormat;
+    /// compressed format the texture was specified with, also when its blocks are decoded on the host
+    GLenum                      mCompressedFormat;
 
     GLint                       mMipLevelsCount;
+    /// faces of a cube map, or slices of level 0 of a 3D texture
     GLint                       mLayersCount;
+    /// levels given with glTexStorage2DEXT, 0 while the texture is mutable
+    GLint                       mImmutableLevels;
 
     Rect                        mDims;
     Sampler                     mParameters;
@@ -71,9 +77,19 @@ private:
     bool                        mDataUpdated;
     bool                        mDataNoInvertion;
     bool                        mFboColorAttached;
+    /// the image holds content copied on the device that the host copies in mState lack
+    bool                        mHostStateStale;
+    /// the application has asked for mipmaps, so the whole chain is allocated up front
+    bool                        mMipmapHint;
+    /// top levels left out of the image under memory pressure, restored from the host copies once it is sampled again
+    GLint                       mDemotedLevels;
+    /// submission the texture was last sampled for, the residency manager demotes the coldest ones first
+    uint64_t                    mLastUsedSubmissionId;
 
     Texture                    *mDepthStencilTexture;
     uint32_t                    mDepthStencilTextureRefCount;
+    /// framebuffers having the texture as their color attachment
+    uint32_t                    mColorAttachmentRefCount;
 
     vulkanAPI::Image*           mImage;
     vulkanAPI::Memory*          mMemory;
@@ -81,29 +97,60 @@ private:
     vulkanAPI::ImageView*       mImageView;
 
     static int                  mDefaultInternalAlignment;
+    /// advanced whenever the size, format or contents of any texture change, for the FBOs to revalidate their attachments
+    static std::atomic<uint32_t> mStorageGeneration;
+    /// advanced whenever a texture is demoted or restored, for the programs to write its new view to their descriptors
+    static std::atomic<uint32_t> mResidencyGeneration;
 
     bool                        AllocateVkMemory(void);
     void                        ReleaseVkResources(void);
+    void                        SyncHostState(GLint skipLevel, GLint skipLayer);
+    void                        WaitPendingUploads(void);
+    GLint                       GetVkMipLevels(void) const;
+    GLint                       GetMaxMipLevels(void) const;
+    bool                        FitsVkImage(GLint level, GLint layer, VkFormat vkFormat) const;
+    void                        UpdateVkMaxLod(void);
+    VkComponentMapping          GetVkComponentMapping(void) const;
 
 public:
     Texture(const vulkanAPI::vkContext_t  *vkContext = nullptr,
-            const VkFlags       vkFlags   = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+            const VkFlags       vkFlags   = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
     ~Texture();
 
 // Generate Functions
     bool                    Allocate();
-    void                    SetState(GLsizei width, GLsizei height, GLint level, GLint layer, GLenum format, GLenum type, GLint unpackAlignment, const void *pixels);
+    void                    SetState(GLsizei width, GLsizei height, GLint level, GLint layer, GLenum format, GLenum type, GLint unpackAlignment, const void *pixels, GLint unpackRowLength = 0);
     void                    SetSubState(ImageRect *srcRect, ImageRect *dstRect, GLint miplevel, GLint layer, GLenum srcFormat, const void *srcData);
+    void                    SetCompressedState(GLsizei width, GLsizei height, GLint level, GLint layer, GLenum format, const void *data, bool transcode);
+    void                    SetCompressedSubState(GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLint level, GLint layer, const void *data);
+    void                    SetStorage(GLsizei levels, GLsizei width, GLsizei height, GLenum format, GLenum type);
     void                    GenerateMipmaps(GLenum hintMipmapMode);
+    /// the dma-buf becomes level 0 of the texture without a copy, false when it cannot be imported
+    bool                    ImportDmaBuf(const api_dma_buf_image_t *dmaBuf);
+    /// the color image of source becomes level 0 of the texture without a copy, false when it cannot be sampled
+    bool                    AliasVkImage(Texture *source);
+    /// the texture is left without an image, its view of the aliased one is kept for the next binding
+    void                    ReleaseVkImageAlias(void);
+
+// Residency Functions
+    /// recreates the image without its top levels, which are kept in the host copies, false when it cannot be demoted
+    bool                    Demote(GLint levels);
+    /// recreates the image with all its levels, converted from the host copies on the upload worker
+    bool                    Promote(void);
+    bool                    IsDemotable(void) const;
 
 // Init Functions
-    inline void             InitState(void)                                     { FUN_ENTRY(GL_LOG_TRACE); mLayersCount  = mTarget == GL_TEXTURE_2D ? TEXTURE_2D_LAYERS : TEXTURE_CUBE_MAP_LAYERS;
+    inline void             InitState(void)                                     { FUN_ENTRY(GL_LOG_TRACE); mLayersCount  = mTarget == GL_TEXTURE_CUBE_MAP ? TEXTURE_CUBE_MAP_LAYERS : TEXTURE_2D_LAYERS;
                                                                                                            mState        = new StateMap_t[mLayersCount]; }
 
 // Helper Functions
     static int              GetDefaultInternalAlignment()                       { FUN_ENTRY(GL_LOG_TRACE); return mDefaultInternalAlignment; }
+    static uint32_t         GetStorageGeneration(void)                          { FUN_ENTRY(GL_LOG_TRACE); return mStorageGeneration.load(std::memory_order_relaxed); }
+    static uint32_t         GetResidencyGeneration(void)                        { FUN_ENTRY(GL_LOG_TRACE); return mResidencyGeneration.load(std::memory_order_relaxed); }
+    static void             UpdateStorageGeneration(void)                       { FUN_ENTRY(GL_LOG_TRACE); mStorageGeneration.fetch_add(1, std::memory_order_relaxed); }
     inline int              GetInvertedYOrigin(const Rect* rect)                { FUN_ENTRY(GL_LOG_TRACE); return mDims.height - rect->height - rect->y; }
     void                    PrepareVkImageLayout(VkImageLayout newImageLayout);
+    void                    RecordVkImageLayout(VkCommandBuffer *cmdBuffer, VkImageLayout newImageLayout);
 
 // Create Functions
     bool                    CreateVkTexture(void);
@@ -112,28 +159,49 @@ public:
     bool                    CreateVkSampler(void)                               { FUN_ENTRY(GL_LOG_TRACE); return mSampler->Create(); }
     void                    CreateVkImageSubResourceRange(void)                 { FUN_ENTRY(GL_LOG_TRACE); return mImage->CreateImageSubresourceRange(); }
 
+// Update Functions
+    /// upload into the current image without recreating it, false when the image cannot hold the level as it is
+    bool                    UpdateVkLevel(GLint level, GLint layer, VkFormat vkFormat);
+    bool                    UpdateVkLevel(GLsizei width, GLsizei height, GLint level, GLint layer, GLenum format, GLenum type, GLint unpackAlignment, const void *pixels, VkFormat vkFormat, GLint unpackRowLength = 0);
+    bool                    UpdateVkSubImage(ImageRect *srcRect, ImageRect *dstRect, GLint level, GLint layer, GLenum srcFormat, const void *srcData, VkFormat vkFormat);
+
 // Copy Functions
-     void                   CopyPixelsFromHost (ImageRect *srcRect, ImageRect *dstRect, GLint miplevel, GLint layer, GLenum srcFormat, const void *srcData);
+     /// with deferred set, srcData is a host copy of the texture and the conversion may run on the upload worker
+     void                   CopyPixelsFromHost (ImageRect *srcRect, ImageRect *dstRect, GLint miplevel, GLint layer, GLenum srcFormat, const void *srcData, bool deferred = false, bool releaseSrcData = false);
+     /// stages srcData as it is and converts it with a blit into the image, false when the host has to convert it
+     bool                   ConvertPixelsOnDevice(ImageRect *srcRect, ImageRect *dstRect, GLint miplevel, GLint layer, GLenum srcFormat, const void *srcData);
+     void                   CopyCompressedPixelsFromHost(GLint miplevel, GLint layer, const void *srcData);
      void                   CopyPixelsToHost   (ImageRect *srcRect, ImageRect *dstRect, GLint miplevel, GLint layer, GLenum dstFormat, void *dstData);
-     void                   SubmitCopyPixels   (const Rect *rect, BufferObject *tbo, GLint miplevel, GLint layer, GLenum dstFormat, bool copyToImage);
+     void                   SubmitCopyPixels   (const Rect *rect, BufferObject *tbo, GLint miplevel, GLint layer, GLenum dstFormat, bool copyToImage, uint32_t bufferRowLength = 0);
      void                   InvertPixels       (void);
+     bool                   CopyPixelsFromImage(Texture *srcTexture, const Rect *srcRect, bool srcOriginFlipped, GLint dstX, GLint dstY, GLint miplevel, GLint layer);
+     /// records the blit of imageBlit from the image of srcTexture, which scales and flips the region as its offsets ask
+     bool                   BlitPixelsFromImage(Texture *srcTexture, const VkImageBlit *imageBlit, VkFilter filter);
+     /// records the copy of the rect into dstBuffer, through a blit into convertTexture when it is given
+     bool                   CopyPixelsToBuffer (const Rect *srcRect, bool srcOriginFlipped, Texture *convertTexture,
+                                                BufferObject *dstBuffer, size_t dstOffset, uint32_t dstRowLength);
 
 // Get Functions
     inline GLenum           GetWrapS(void)                              const   { FUN_ENTRY(GL_LOG_TRACE); return mParameters.GetWrapS(); }
     inline GLenum           GetWrapT(void)                              const   { FUN_ENTRY(GL_LOG_TRACE); return mParameters.GetWrapT(); }
+    inline GLenum           GetWrapR(void)                              const   { FUN_ENTRY(GL_LOG_TRACE); return mParameters.GetWrapR(); }
     inline GLenum           GetMinFilter(void)                          const   { FUN_ENTRY(GL_LOG_TRACE); return mParameters.GetMinFilter(); }
     inline GLenum           GetMagFilter(void)                          const   { FUN_ENTRY(GL_LOG_TRACE); return mParameters.GetMagFilter(); }
     inline int              GetWidth(void)                              const   { FUN_ENTRY(GL_LOG_TRACE); return mDims.width; }
     inline int              GetHeight(void)                             const   { FUN_ENTRY(GL_LOG_TRACE); return mDims.height; }
+    inline int              GetDepth(void)                              const   { FUN_ENTRY(GL_LOG_TRACE); return IsVolume() ? mLayersCount : 1; }
     inline GLenum           GetType(void)                               const   { FUN_ENTRY(GL_LOG_TRACE); return mType; }
     inline GLenum           GetExplicitType(void)                       const   { FUN_ENTRY(GL_LOG_TRACE); return mExplicitType; }
     inline GLenum           GetFormat(void)                             const   { FUN_ENTRY(GL_LOG_TRACE); return mFormat; }
     inline GLenum           GetTarget(void)                             const   { FUN_ENTRY(GL_LOG_TRACE); return mTarget; }
     inline GLenum           GetInternalFormat(void)                     const   { FUN_ENTRY(GL_LOG_TRACE); return mInternalFormat; }
     inline GLenum           GetExplicitInternalFormat(void)             const   { FUN_ENTRY(GL_LOG_TRACE); return mExplicitInternalFormat; }
+    inline GLenum           GetCompressedFormat(void)                   const   { FUN_ENTRY(GL_LOG_TRACE); return mCompressedFormat; }
     inline GLint            GetLayersCount(void)                        const   { FUN_ENTRY(GL_LOG_TRACE); return mLayersCount; }
     inline GLint            GetMipLevelsCount(void)                     const   { FUN_ENTRY(GL_LOG_TRACE); return mMipLevelsCount; }
+    inline GLint            GetImmutableLevels(void)                    const   { FUN_ENTRY(GL_LOG_TRACE); return mImmutableLevels; }
     inline bool             GetDataUpdated(void)                        const   { FUN_ENTRY(GL_LOG_TRACE); return mDataUpdated; }
+    inline uint64_t         GetLastUsedSubmissionId(void)               const   { FUN_ENTRY(GL_LOG_TRACE); return mLastUsedSubmissionId; }
     
     inline Texture         *GetDepthStencilTexture(void)                const   { FUN_ENTRY(GL_LOG_TRACE); return mDepthStencilTexture;}
     inline uint32_t         GetDepthStencilTextureRefCount(void)        const   { FUN_ENTRY(GL_LOG_TRACE); return mDepthStencilTextureRefCount; }
@@ -143,7 +211,10 @@ public:
     inline VkSampler        GetVkSampler(void)                          const   { FUN_ENTRY(GL_LOG_TRACE); return mSampler->GetSampler(); }
     inline VkFormat         GetVkFormat(void)                           const   { FUN_ENTRY(GL_LOG_TRACE); return mImage->GetFormat(); }
     inline VkImageLayout    GetVkImageLayout(void)                      const   { FUN_ENTRY(GL_LOG_TRACE); return mImage->GetImageLayout(); }
+    inline VkImageUsageFlagBits GetVkImageUsage(void)                   const   { FUN_ENTRY(GL_LOG_TRACE); return mImage->GetImageUsage(); }
     inline VkImageView      GetVkImageView(void)                        const   { FUN_ENTRY(GL_LOG_TRACE); return mImageView->GetImageView(); }
+    inline uint64_t         GetVkImageViewId(void)                      const   { FUN_ENTRY(GL_LOG_TRACE); return mImageView->GetId(); }
+    inline VkSampleCountFlagBits GetVkSampleCount(void)                 const   { FUN_ENTRY(GL_LOG_TRACE); return mImage->GetSampleCount(); }
     VkFormat                FindSupportedVkColorFormat(VkFormat format)         { FUN_ENTRY(GL_LOG_TRACE); return mImage->FindSupportedVkColorFormat(format); }
 
 // Set Functions
@@ -156,47 +227,69 @@ public:
                                                                                                            mSampler->SetAddressModeU(GlTexAddressToVkTexAddress(mode));}}
     inline void             SetWrapT(GLenum mode)                               { FUN_ENTRY(GL_LOG_TRACE); if(mParameters.UpdateWrapT(mode)) { \
                                                                                                            mSampler->SetAddressModeV(GlTexAddressToVkTexAddress(mode));}}
+    inline void             SetWrapR(GLenum mode)                               { FUN_ENTRY(GL_LOG_TRACE); if(mParameters.UpdateWrapR(mode)) { \
+                                                                                                           mSampler->SetAddressModeW(GlTexAddressToVkTexAddress(mode));}}
     inline void             SetMinFilter(GLenum mode)                           { FUN_ENTRY(GL_LOG_TRACE); if(mParameters.UpdateMinFilter(mode)){ \
                                                                                                            mSampler->SetMinFilter(GlTexFilterToVkTexFilter(mode)); \
                                                                                                            mSampler->SetMipmapMode(GlTexMipMapModeToVkMipMapMode(mode));
+                                                                                                           mMipmapHint |= (mode != GL_NEAREST && mode != GL_LINEAR);
                                                                                                            mSampler->SetMaxLod((mode == GL_NEAREST || mode == GL_LINEAR) ? 0.25f : static_cast<float>(mMipLevelsCount-1));}}
     inline void             SetMagFilter(GLenum mode)                           { FUN_ENTRY(GL_LOG_TRACE); if(mParameters.UpdateMagFilter(mode)) { \
                                                                                                            mSampler->SetMagFilter(GlTexFilterToVkTexFilter(mode));} }
-    inline void             SetWidth(int width)                                 { FUN_ENTRY(GL_LOG_TRACE); mDims.width  = width;  }
-    inline void             SetHeight(int height)                               { FUN_ENTRY(GL_LOG_TRACE); mDims.height = height; }
+    inline void             SetWidth(int width)                                 { FUN_ENTRY(GL_LOG_TRACE); if(mDims.width  != width)  { mDims.width  = width;  UpdateStorageGeneration(); } }
+    inline void             SetHeight(int height)                               { FUN_ENTRY(GL_LOG_TRACE); if(mDims.height != height) { mDims.height = height; UpdateStorageGeneration(); } }
+    /// the slices of level 0 of a 3D texture, whose host copies are kept as its layers
+           void             SetDepth(GLsizei depth);
     inline void             SetTarget(GLenum target)                            { FUN_ENTRY(GL_LOG_TRACE); mTarget      = target; }
     inline void             SetFormat(GLenum format)                            { FUN_ENTRY(GL_LOG_TRACE); mFormat      = format; }
     inline void             SetType(GLenum type)                                { FUN_ENTRY(GL_LOG_TRACE); mType        = type;   }
     inline void             SetExplicitType(GLenum type)                        { FUN_ENTRY(GL_LOG_TRACE); mExplicitType = type;  }
-    inline void             SetInternalFormat(GLenum format)                    { FUN_ENTRY(GL_LOG_TRACE); mInternalFormat         = format;  }
+    inline void             SetInternalFormat(GLenum format)                    { FUN_ENTRY(GL_LOG_TRACE); if(mInternalFormat != format) { mInternalFormat = format; UpdateStorageGeneration(); } }
     inline void             SetExplicitInternalFormat(GLenum format)            { FUN_ENTRY(GL_LOG_TRACE); mExplicitInternalFormat = format;  }
-    inline void             SetDataUpdated(bool updated)                        { FUN_ENTRY(GL_LOG_TRACE); mDataUpdated = updated; }
+    inline void             SetDataUpdated(bool updated)                        { FUN_ENTRY(GL_LOG_TRACE); mDataUpdated = updated; if(updated) { UpdateStorageGeneration(); } }
     inline void             SetDataNoInvertion(bool updated)                    { FUN_ENTRY(GL_LOG_TRACE); mDataNoInvertion = updated; }
     inline void             SetFboColorAttached(bool updated)                   { FUN_ENTRY(GL_LOG_TRACE); mFboColorAttached = updated; }
     inline void             SetDepthStencilTexture(Texture *tex)                { FUN_ENTRY(GL_LOG_TRACE); mDepthStencilTexture = tex;}
+    inline void             SetLastUsedSubmissionId(uint64_t submissionId)      { FUN_ENTRY(GL_LOG_TRACE); mLastUsedSubmissionId = submissionId; }
 
     inline void             SetImageBufferCopyStencil(bool copy)                { FUN_ENTRY(GL_LOG_TRACE); mImage->SetCopyStencil(copy);   }
     inline void             SetVkFormat(VkFormat format)                        { FUN_ENTRY(GL_LOG_TRACE); mImage->SetFormat(format);      }
     inline void             SetVkImage(VkImage image)                           { FUN_ENTRY(GL_LOG_TRACE); mImage->SetImage(image);        }
     inline void             SetVkImageUsage(VkImageUsageFlagBits usage)         { FUN_ENTRY(GL_LOG_TRACE); mImage->SetImageUsage(usage);   }
     inline void             SetVkImageLayout(VkImageLayout layout)              { FUN_ENTRY(GL_LOG_TRACE); mImage->SetImageLayout(layout); }
+    inline void             SetVkSampleCount(VkSampleCountFlagBits samples)     { FUN_ENTRY(GL_LOG_TRACE); mImage->SetSampleCount(samples); }
+    /// VK_IMAGE_TILING_LINEAR is an opt-in for images the host maps, along with host visible memory flags
     inline void             SetVkImageTiling(VkImageTiling tiling)              { FUN_ENTRY(GL_LOG_TRACE); mImage->SetImageTiling(tiling); }
     inline void             SetVkImageTiling(void)                              { FUN_ENTRY(GL_LOG_TRACE); mImage->SetImageTiling();       }
     inline void             SetVkImageTarget(vulkanAPI::Image::VkImageTarget
                                                                      target)    { FUN_ENTRY(GL_LOG_TRACE); mImage->SetImageTarget(target); }
+    inline void             SetVkMemoryFlags(VkFlags flags, VkFlags preferred)  { FUN_ENTRY(GL_LOG_TRACE); mMemory->SetFlags(flags);
+                                                                                                           mMemory->SetPreferredFlags(preferred); }
+    inline void             SetVkMemoryAlias(vulkanAPI::MemoryAllocator::alias_t
+                                                                     alias)     { FUN_ENTRY(GL_LOG_TRACE); mMemory->SetAlias(alias); }
 
 // Increase/Decrease Functions
     inline void             IncreaseDepthStencilTextureRefCount(void)                              { FUN_ENTRY(GL_LOG_TRACE); ++mDepthStencilTextureRefCount; }
     inline void             DecreaseDepthStencilTextureRefCount(void)                              { FUN_ENTRY(GL_LOG_TRACE); --mDepthStencilTextureRefCount; }
+    inline void             IncreaseColorAttachmentRefCount(void)                                  { FUN_ENTRY(GL_LOG_TRACE); Promote(); ++mColorAttachmentRefCount; }
+    inline void             DecreaseColorAttachmentRefCount(void)                                  { FUN_ENTRY(GL_LOG_TRACE); --mColorAttachmentRefCount; }
 
 // Is Functions
+    inline bool             IsColorAttached(void)                       const   { FUN_ENTRY(GL_LOG_TRACE); return mColorAttachmentRefCount > 0; }
     inline bool             IsCubeMap(void)                             const   { FUN_ENTRY(GL_LOG_TRACE); return mTarget  == GL_TEXTURE_CUBE_MAP; }
-    inline bool             IsCompressed(void)                          const   { FUN_ENTRY(GL_LOG_TRACE); return (mFormat != GL_ALPHA           &&
+    inline bool             IsVolume(void)                              const   { FUN_ENTRY(GL_LOG_TRACE); return mTarget  == GL_TEXTURE_3D_OES; }
+    inline bool             IsImmutable(void)                           const   { FUN_ENTRY(GL_LOG_TRACE); return mImmutableLevels > 0; }
+    inline bool             IsDemoted(void)                             const   { FUN_ENTRY(GL_LOG_TRACE); return mDemotedLevels > 0; }
+           bool             HasState(GLint level, GLint layer, GLsizei width, GLsizei height, GLenum format, GLenum type) const;
+    inline bool             IsTransient(void)                           const   { FUN_ENTRY(GL_LOG_TRACE); return mImage->GetImageUsage() != VK_IMAGE_USAGE_FLAG_BITS_MAX_ENUM &&
+                                                                                                                  (mImage->GetImageUsage() & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT); }
+    inline bool             IsCompressed(void)                          const   { FUN_ENTRY(GL_LOG_TRACE); return mCompressedFormat != GL_INVALID_VALUE ||
+                                                                                                                  (mFormat != GL_ALPHA           &&
                                                                                                                    mFormat != GL_RGB             &&
                                                                                                                    mFormat != GL_RGBA            &&
                                                                                                                    mFormat != GL_LUMINANCE       &&
                                                                                                                    mFormat != GL_LUMINANCE_ALPHA &&
-                                                                                                                   mFormat != GL_BGRA8_EXT); }
+                                                                                                                   mFormat != GL_BGRA8_EXT)); }
            bool             IsNPOT(void);
            bool             IsNPOTAccessCompleted(void);
            bool             IsCompleted(void);
@@ -0,0 +1,132 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       vertexArray.cpp
+ *  @author     Think Silicon
+ *  @date       14/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Vertex Array Object Functionality in GLOVE
+ *
+ *  A vertex array object holds the generic vertex attribute arrays and the
+ *  element array buffer binding. The vertex input layout gathered for it is
+ *  kept, so that as long as its attributes read from buffer objects only,
+ *  a draw binds the prebaked buffers and descriptions as they are.
+ */
+
+#include "vertexArray.h"
+
+std::atomic<uint64_t> VertexArray::sLayoutGenerationCounter(0);
+
+VertexArray::VertexArray()
+: mGenericVertexAttributes(GLOVE_MAX_VERTEX_ATTRIBS),
+  mElementArrayBuffer(nullptr), mWasBound(false),
+  mLayoutProgramId(0), mLayoutGeneration(++sLayoutGenerationCounter)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    memset(static_cast<void *>(&mLayout), 0, sizeof(mLayout));
+}
+
+VertexArray::~VertexArray()
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    Release();
+}
+
+void
+VertexArray::Release(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    for(auto& gva : mGenericVertexAttributes) {
+        gva.Release();
+    }
+    InvalidateLayout();
+}
+
+void
+VertexArray::SetVkContext(const vulkanAPI::vkContext_t *vkContext)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    for(auto& gva : mGenericVertexAttributes) {
+        gva.SetVkContext(vkContext);
+    }
+}
+
+void
+VertexArray::SetCacheManager(CacheManager *cacheManager)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    for(auto& gva : mGenericVertexAttributes) {
+        gva.SetCacheManager(cacheManager);
+    }
+}
+
+void
+VertexArray::CopyGenericValues(const VertexArray *src)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the current generic values are context state, they follow the bound vertex array
+    GLfloat srcValue[4], dstValue[4];
+    for(size_t i = 0; i < mGenericVertexAttributes.size(); ++i) {
+        src->mGenericVertexAttributes[i].GetGenericValue(srcValue);
+        mGenericVertexAttributes[i].GetGenericValue(dstValue);
+        if(memcmp(srcValue, dstValue, sizeof(srcValue))) {
+            mGenericVertexAttributes[i].SetGenericValue(srcValue);
+            InvalidateLayout();
+        }
+    }
+}
+
+const VertexArray::vertexInputLayout *
+VertexArray::GetBakedLayout(uint64_t programId) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(!mLayoutProgramId || mLayoutProgramId != programId) {
+        return nullptr;
+    }
+
+    // glBufferData may have replaced the storage of a buffer object since the layout was baked
+    for(uint32_t i = 0; i < mLayout.bindingCount; ++i) {
+        if(mLayout.vbos[i]->GetVkBuffer() != mLayout.buffers[i]) {
+            return nullptr;
+        }
+    }
+
+    return &mLayout;
+}
+
+void
+VertexArray::BakeLayout(uint64_t programId)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    mLayoutProgramId  = programId;
+    mLayoutGeneration = ++sLayoutGenerationCounter;
+}
+
+void
+VertexArray::InvalidateLayout(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    mLayoutProgramId  = 0;
+    mLayoutGeneration = ++sLayoutGenerationCounter;
+}
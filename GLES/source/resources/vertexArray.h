@@ -0,0 +1,86 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       vertexArray.h
+ *  @author     Think Silicon
+ *  @date       14/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Vertex Array Object Functionality in GLOVE
+ *
+ */
+
+#ifndef __VERTEXARRAY_H__
+#define __VERTEXARRAY_H__
+
+#include "genericVertexAttribute.h"
+#include <atomic>
+
+class VertexArray {
+public:
+    /// vertex input description gathered for a draw, before it is compared with the one of the program
+    struct vertexInputLayout {
+        uint32_t                                bindingCount;
+        uint32_t                                attributeCount;
+        VkVertexInputBindingDescription         bindings[GLOVE_MAX_VERTEX_ATTRIBS];
+        VkVertexInputAttributeDescription       attributes[GLOVE_MAX_VERTEX_ATTRIBS];
+        VkBuffer                                buffers[GLOVE_MAX_VERTEX_ATTRIBS];
+        VkDeviceSize                            offsets[GLOVE_MAX_VERTEX_ATTRIBS];
+        /// instance divisor of each binding, 0 for a binding read per vertex
+        uint32_t                                divisors[GLOVE_MAX_VERTEX_ATTRIBS];
+        /// buffer object read by each binding, or nullptr for data streamed into the ring
+        BufferObject                           *vbos[GLOVE_MAX_VERTEX_ATTRIBS];
+    };
+    typedef struct vertexInputLayout            vertexInputLayout;
+
+private:
+    std::vector<GenericVertexAttribute>         mGenericVertexAttributes;
+    BufferObject                               *mElementArrayBuffer;
+    bool                                        mWasBound;
+
+    /// the layout last gathered from the attributes; it is prebaked, and reused
+    /// as is, while mLayoutProgramId names the program it was gathered for
+    vertexInputLayout                           mLayout;
+    uint64_t                                    mLayoutProgramId;
+    uint64_t                                    mLayoutGeneration;
+
+    static std::atomic<uint64_t>                sLayoutGenerationCounter;
+
+public:
+    VertexArray();
+    ~VertexArray();
+
+// Release Functions
+    void                                        Release(void);
+
+// Get Functions
+    inline std::vector<GenericVertexAttribute>& GetGenericVertexAttributes(void)          { FUN_ENTRY(GL_LOG_TRACE); return mGenericVertexAttributes; }
+    inline GenericVertexAttribute              *GetGenericVertexAttribute(size_t index)   { FUN_ENTRY(GL_LOG_TRACE); return &mGenericVertexAttributes[index]; }
+    inline BufferObject                        *GetElementArrayBuffer(void)         const { FUN_ENTRY(GL_LOG_TRACE); return mElementArrayBuffer; }
+    inline bool                                 WasBound(void)                      const { FUN_ENTRY(GL_LOG_TRACE); return mWasBound; }
+    inline vertexInputLayout                   *GetLayout(void)                           { FUN_ENTRY(GL_LOG_TRACE); return &mLayout; }
+    inline uint64_t                             GetLayoutGeneration(void)           const { FUN_ENTRY(GL_LOG_TRACE); return mLayoutGeneration; }
+           const vertexInputLayout             *GetBakedLayout(uint64_t programId)  const;
+
+// Set Functions
+           void                                 SetVkContext(const vulkanAPI::vkContext_t *vkContext);
+           void                                 SetCacheManager(CacheManager *cacheManager);
+    inline void                                 SetElementArrayBuffer(BufferObject *bo)   { FUN_ENTRY(GL_LOG_TRACE); mElementArrayBuffer = bo; }
+    inline void                                 SetWasBound(void)                         { FUN_ENTRY(GL_LOG_TRACE); mWasBound = true; }
+           void                                 CopyGenericValues(const VertexArray *src);
+           void                                 BakeLayout(uint64_t programId);
+           void                                 InvalidateLayout(void);
+};
+
+#endif // __VERTEXARRAY_H__
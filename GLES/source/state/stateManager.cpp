@@ -139,7 +139,11 @@ StateManager::InitVkPipelineStates(vulkanAPI::Pipeline *pipeline)
     pipeline->CreateMultisampleState(alphaToOneEnable, alphaToCoverageEnable, rasterizationSamples, sampleShadingEnable, minSampleShading);
     std::vector<VkDynamicState> states = {VK_DYNAMIC_STATE_VIEWPORT,
                                           VK_DYNAMIC_STATE_SCISSOR,
-                                          VK_DYNAMIC_STATE_LINE_WIDTH};
+                                          VK_DYNAMIC_STATE_LINE_WIDTH,
+                                          VK_DYNAMIC_STATE_BLEND_CONSTANTS,
+                                          VK_DYNAMIC_STATE_STENCIL_COMPARE_MASK,
+                                          VK_DYNAMIC_STATE_STENCIL_WRITE_MASK,
+                                          VK_DYNAMIC_STATE_STENCIL_REFERENCE};
     pipeline->CreateDynamicState(states);
     pipeline->CreateInfo();
 }
@@ -24,7 +24,7 @@
 #include "statePixelStorage.h"
 
 StatePixelStorage::StatePixelStorage()
-: mPixelStorePack(4), mPixelStoreUnpack(4)
+: mPixelStorePack(4), mPixelStoreUnpack(4), mUnpackRowLength(0), mUnpackSkipRows(0), mUnpackSkipPixels(0)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 }
@@ -33,3 +33,18 @@ StatePixelStorage::~StatePixelStorage()
 {
     FUN_ENTRY(GL_LOG_TRACE);
 }
+
+const void *
+StatePixelStorage::GetUnpackPixels(const void *pixels, GLsizei width, size_t pixelSize) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(!pixels) {
+        return nullptr;
+    }
+
+    // the rows are as long as the row length and aligned to the unpack alignment, as with ImageRect
+    const size_t rowSize = static_cast<size_t>(mUnpackRowLength ? mUnpackRowLength : width) * pixelSize;
+    const size_t stride  = (rowSize + mPixelStoreUnpack - 1) / mPixelStoreUnpack * mPixelStoreUnpack;
+    return static_cast<const uint8_t *>(pixels) + mUnpackSkipRows * stride + mUnpackSkipPixels * pixelSize;
+}
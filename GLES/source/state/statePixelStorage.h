@@ -26,12 +26,18 @@
 
 #include "GLES2/gl2.h"
 #include "utils/glLogger.h"
+#include <cstddef>
+#include <stdint.h>
 
 class StatePixelStorage {
 
 private:
       GLint                   mPixelStorePack;
       GLint                   mPixelStoreUnpack;
+      /// GL_EXT_unpack_subimage, a row length of 0 stands for the width of the image
+      GLint                   mUnpackRowLength;
+      GLint                   mUnpackSkipRows;
+      GLint                   mUnpackSkipPixels;
 
 public:
       StatePixelStorage();
@@ -40,10 +46,18 @@ public:
 // Get Functions
       inline GLint            GetPixelStorePack(void)                    const  { FUN_ENTRY(GL_LOG_TRACE); return mPixelStorePack; }
       inline GLint            GetPixelStoreUnpack(void)                  const  { FUN_ENTRY(GL_LOG_TRACE); return mPixelStoreUnpack; }
+      inline GLint            GetUnpackRowLength(void)                   const  { FUN_ENTRY(GL_LOG_TRACE); return mUnpackRowLength; }
+      inline GLint            GetUnpackSkipRows(void)                    const  { FUN_ENTRY(GL_LOG_TRACE); return mUnpackSkipRows; }
+      inline GLint            GetUnpackSkipPixels(void)                  const  { FUN_ENTRY(GL_LOG_TRACE); return mUnpackSkipPixels; }
+      /// the first pixel that is unpacked, past the skipped rows and pixels
+      const void             *GetUnpackPixels(const void *pixels, GLsizei width, size_t pixelSize) const;
 
 // Set Functions
       inline void             SetPixelStorePack(GLint pixelStorePack)           { FUN_ENTRY(GL_LOG_TRACE); mPixelStorePack   = pixelStorePack;}
       inline void             SetPixelStoreUnpack(GLint pixelStoreUnpack)       { FUN_ENTRY(GL_LOG_TRACE); mPixelStoreUnpack = pixelStoreUnpack;}
+      inline void             SetUnpackRowLength(GLint rowLength)               { FUN_ENTRY(GL_LOG_TRACE); mUnpackRowLength  = rowLength;}
+      inline void             SetUnpackSkipRows(GLint skipRows)                 { FUN_ENTRY(GL_LOG_TRACE); mUnpackSkipRows   = skipRows;}
+      inline void             SetUnpackSkipPixels(GLint skipPixels)             { FUN_ENTRY(GL_LOG_TRACE); mUnpackSkipPixels = skipPixels;}
 };
 
 #endif //__STATEPIXELSTORAGE_H__
@@ -24,7 +24,7 @@
 #include "stateViewportTransformation.h"
 
 StateViewportTransformation::StateViewportTransformation()
-: mMinDepthRange(0.0f), mMaxDepthRange(1.0f), mViewportCount(1), mScissorCount(1)
+: mMinDepthRange(0.0f), mMaxDepthRange(1.0f), mDepthRangeGeneration(1), mViewportCount(1), mScissorCount(1)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 }
@@ -34,6 +34,8 @@ class StateViewportTransformation {
 private:
       GLfloat                 mMinDepthRange;
       GLfloat                 mMaxDepthRange;
+      /// incremented whenever the depth range changes
+      uint32_t                mDepthRangeGeneration;
       Rect                    mViewportRectangle;
 
       const
@@ -66,6 +68,7 @@ public:
       inline GLfloat          GetMinDepthRange(void)                     const   { FUN_ENTRY(GL_LOG_TRACE); return mMinDepthRange; }
       inline GLfloat          GetMaxDepthRange(void)                     const   { FUN_ENTRY(GL_LOG_TRACE); return mMaxDepthRange; }
       inline GLfloat          GetDiffDepthRange(void)                    const   { FUN_ENTRY(GL_LOG_TRACE); return mMaxDepthRange - mMinDepthRange; }
+      inline uint32_t         GetDepthRangeGeneration(void)              const   { FUN_ENTRY(GL_LOG_TRACE); return mDepthRangeGeneration; }
       inline uint32_t         GetViewportCount(void)                     const   { FUN_ENTRY(GL_LOG_TRACE); return mViewportCount; }
       inline uint32_t         GetScissorCount(void)                      const   { FUN_ENTRY(GL_LOG_TRACE); return mScissorCount; }
 
@@ -78,8 +81,8 @@ public:
       inline void             SetViewportRectY(GLint y)                          { FUN_ENTRY(GL_LOG_TRACE); mViewportRectangle.y = y; }
       inline void             SetViewportRectWidth(GLint width)                  { FUN_ENTRY(GL_LOG_TRACE); mViewportRectangle.width = width; }
       inline void             SetViewportRectHeight(GLint height)                { FUN_ENTRY(GL_LOG_TRACE); mViewportRectangle.height = height; }
-      inline void             SetMinDepthRange(GLfloat min_depth)                { FUN_ENTRY(GL_LOG_TRACE); mMinDepthRange = CLAMPF_01(min_depth); }
-      inline void             SetMaxDepthRange(GLfloat max_depth)                { FUN_ENTRY(GL_LOG_TRACE); mMaxDepthRange = CLAMPF_01(max_depth); }
+      inline void             SetMinDepthRange(GLfloat min_depth)                { FUN_ENTRY(GL_LOG_TRACE); mMinDepthRange = CLAMPF_01(min_depth); ++mDepthRangeGeneration; }
+      inline void             SetMaxDepthRange(GLfloat max_depth)                { FUN_ENTRY(GL_LOG_TRACE); mMaxDepthRange = CLAMPF_01(max_depth); ++mDepthRangeGeneration; }
 
 // Update Functions
       inline bool             UpdateDepthRange(GLfloat min_depth,
@@ -88,6 +91,7 @@ public:
                                                                                                         bool res = (mMinDepthRange != min_depth_f) || (mMaxDepthRange != max_depth_f);
                                                                                                         mMinDepthRange = min_depth_f;
                                                                                                         mMaxDepthRange = max_depth_f;
+                                                                                                        mDepthRangeGeneration += res ? 1 : 0;
                                                                                                         return res; }
 
       inline bool             UpdateViewportRect(GLint x,
@@ -344,9 +344,10 @@ VkFormat GlColorFormatToVkColorFormat(GLenum format, GLenum type)
         case GL_UNSIGNED_BYTE: {
             switch(format) {
                 case GL_RGB:                        return VK_FORMAT_R8G8B8_UNORM;
+                // luminance and alpha are expanded by the swizzle of the image view
                 case GL_LUMINANCE:
-                case GL_ALPHA:
-                case GL_LUMINANCE_ALPHA:
+                case GL_ALPHA:                      return VK_FORMAT_R8_UNORM;
+                case GL_LUMINANCE_ALPHA:            return VK_FORMAT_R8G8_UNORM;
                 case GL_RGBA:                       return VK_FORMAT_R8G8B8A8_UNORM;
                 default: { NOT_REACHED();           return VK_FORMAT_UNDEFINED; }
             }
@@ -385,6 +386,19 @@ GlAttribPointerToVkFormat(GLint nElements, GLenum type, GLboolean normalized)
         default: { NOT_REACHED();           return VK_FORMAT_UNDEFINED; }
         }
 
+    case GL_HALF_FLOAT_OES:
+        switch(nElements) {
+        case 1:                             return VK_FORMAT_R16_SFLOAT;
+        case 2:                             return VK_FORMAT_R16G16_SFLOAT;
+        case 3:                             return VK_FORMAT_R16G16B16_SFLOAT;
+        case 4:                             return VK_FORMAT_R16G16B16A16_SFLOAT;
+        default: { NOT_REACHED();           return VK_FORMAT_UNDEFINED; }
+        }
+
+    // the layout the 10_10_10_2 components are reordered into, see GenericVertexAttribute
+    case GL_INT_10_10_10_2_OES:             return normalized ? VK_FORMAT_A2B10G10R10_SNORM_PACK32 : VK_FORMAT_A2B10G10R10_SSCALED_PACK32;
+    case GL_UNSIGNED_INT_10_10_10_2_OES:    return normalized ? VK_FORMAT_A2B10G10R10_UNORM_PACK32 : VK_FORMAT_A2B10G10R10_USCALED_PACK32;
+
     case GL_INT:
         switch(nElements) {
         case 1:                             return VK_FORMAT_R32_SINT;
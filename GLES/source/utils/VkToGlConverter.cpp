@@ -34,6 +34,8 @@ VkFormatToGlInternalformat(VkFormat format)
     case VK_FORMAT_R4G4B4A4_UNORM_PACK16:   return GL_RGBA4;
     case VK_FORMAT_R5G5B5A1_UNORM_PACK16:   return GL_RGB5_A1;
     case VK_FORMAT_R8G8B8_UNORM:            return GL_RGB8_OES;
+    case VK_FORMAT_R8_UNORM:                return GL_LUMINANCE;
+    case VK_FORMAT_R8G8_UNORM:              return GL_LUMINANCE_ALPHA;
 
     case VK_FORMAT_R8G8B8A8_UINT:
     case VK_FORMAT_R8G8B8A8_USCALED:
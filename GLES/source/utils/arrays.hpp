@@ -18,34 +18,102 @@
  *  @version    1.0
  *
  *  @brief      A simple interface is provided for handling all the accesses to
- *              the arrays of classes needed in GLOVE using the map container.
+ *              the arrays of classes needed in GLOVE using a dense handle table.
  *
  */
 
 #ifndef __ARRAYS_HPP__
 #define __ARRAYS_HPP__
 
-#include <map>
+#include <unordered_map>
+#include <vector>
+
+/// GL handles below this limit are looked up in a vector indexed by the handle,
+/// larger ones chosen by the application fall back to a hash map
+#ifndef GLOVE_DENSE_HANDLE_LIMIT
+#define GLOVE_DENSE_HANDLE_LIMIT                        (1 << 16)
+#endif // GLOVE_DENSE_HANDLE_LIMIT
 
 /**
  * @brief A templated class for handling the memory allocation, indexing and
  * searching of all the different arrays of classes.
  *
- * A separate map container is created for every class that the GLOVE supports.
- * This map is used later for the creation of the various new objects,
- * their indexing and searching. The key value of the map is used as the GL
- * handle, therefore the 0 value is not permitted. The mapped value is the
- * generated object.
+ * A separate handle table is created for every class that the GLOVE supports.
+ * The objects are packed contiguously, and every GL handle maps to the slot
+ * of its object in the packed array, so that a lookup is a constant time
+ * index into a vector instead of a tree walk. The 0 handle is not permitted.
+ * Handles released by Deallocate are recycled by later allocations, which
+ * keeps the table dense.
  */
 template <class ELEMENT>
 class ObjectArray {
 private:
-    uint32_t mCounter;                 /**< The id (key-value of the map)
-                                          reserved during the creation of a new
-                                          object. */
-    std::map<uint32_t, ELEMENT *> mObjects; /**< The templated map container (one
-                                          for each different class that maps
-                                          id to a specific object). */
+    enum : uint32_t { NO_SLOT = ~0u };
+
+    uint32_t mCounter;                 /**< The largest GL handle reserved or
+                                          used so far. */
+    std::vector<ELEMENT *> mObjects;   /**< The objects, packed contiguously. */
+    std::vector<uint32_t> mNames;      /**< The GL handle of each packed object. */
+    std::vector<uint32_t> mSlots;      /**< The packed slot of each GL handle
+                                          below GLOVE_DENSE_HANDLE_LIMIT. */
+    std::unordered_map<uint32_t, uint32_t> mSparseSlots; /**< The packed slot of
+                                          each larger GL handle. */
+    std::vector<uint32_t> mFreeNames;  /**< The released GL handles to be
+                                          recycled. */
+    std::unordered_map<const ELEMENT *, uint32_t> mElementNames; /**< The GL
+                                          handle of each object, for the
+                                          reverse lookups of the queries. */
+
+    uint32_t FindSlot(uint32_t index) const
+    {
+        if(index < GLOVE_DENSE_HANDLE_LIMIT) {
+            return index < mSlots.size() ? mSlots[index] : NO_SLOT;
+        }
+
+        typename std::unordered_map<uint32_t, uint32_t>::const_iterator it = mSparseSlots.find(index);
+        return it != mSparseSlots.end() ? it->second : NO_SLOT;
+    }
+
+    void SetSlot(uint32_t index, uint32_t slot)
+    {
+        if(index < GLOVE_DENSE_HANDLE_LIMIT) {
+            if(index >= mSlots.size()) {
+                mSlots.resize(index + 1, NO_SLOT);
+            }
+            mSlots[index] = slot;
+        } else if(slot == NO_SLOT) {
+            mSparseSlots.erase(index);
+        } else {
+            mSparseSlots[index] = slot;
+        }
+    }
+
+    /**
+    * @brief Removes the object from the packed array by moving the last object
+    * to its slot.
+    */
+    ELEMENT *Remove(uint32_t index)
+    {
+        uint32_t slot = FindSlot(index);
+        if(slot == NO_SLOT) {
+            return nullptr;
+        }
+
+        ELEMENT *element = mObjects[slot];
+        uint32_t last    = static_cast<uint32_t>(mObjects.size()) - 1;
+        if(slot != last) {
+            mObjects[slot] = mObjects[last];
+            mNames[slot]   = mNames[last];
+            SetSlot(mNames[slot], slot);
+        }
+        mObjects.pop_back();
+        mNames.pop_back();
+        SetSlot(index, NO_SLOT);
+        mElementNames.erase(element);
+
+        return element;
+    }
+
 public:
 
     /**
@@ -58,14 +126,13 @@ public:
     }
 
     /**
-    * @brief The destructor removes all elements from the map container (which
-    * are destroyed), leaving the container with a size of 0.
+    * @brief The destructor destroys all elements of the container, leaving
+    * it with a size of 0.
     */
     ~ObjectArray()
     {
-        typename std::map<uint32_t, ELEMENT *>::iterator it;
-        for(it = mObjects.begin(); it != mObjects.end(); it++) {
-            delete it->second;
+        for(ELEMENT *element : mObjects) {
+            delete element;
         }
         mObjects.clear();
     }
@@ -73,23 +140,34 @@ public:
     /**
     * @brief Returns the GL handle and reserves this as the new key value.
     * @return The GL handle.
+    *
+    * A released handle is returned, unless the application has used it again
+    * in the meantime.
     */
     uint32_t Allocate()
     {
+        while(!mFreeNames.empty()) {
+            uint32_t index = mFreeNames.back();
+            mFreeNames.pop_back();
+            if(FindSlot(index) == NO_SLOT) {
+                return index;
+            }
+        }
+
         return ++mCounter;
     }
 
     /**
-    * @brief Removes from the map container a single element with the given
+    * @brief Removes from the container a single element with the given
     * key value (element is  destroyed).
     * @param index: The GL handle of the element to be destroyed.
     */
     bool Deallocate(uint32_t index)
     {
-        typename std::map<uint32_t, ELEMENT *>::iterator it = mObjects.find(index);
-        if(it != mObjects.end()) {
-            delete it->second;
-            mObjects.erase(it);
+        ELEMENT *element = Remove(index);
+        if(element != nullptr) {
+            delete element;
+            mFreeNames.push_back(index);
 
             return true;
         }
@@ -98,40 +176,44 @@ public:
     }
 
     /**
-    * @brief Removes from the map container a single element with the given
+    * @brief Removes from the container a single element with the given
     * key value (element is NOT destroyed).
+    *
+    * The handle is not recycled, as the element is still referenced.
     */
     bool RemoveFromList(uint32_t index)
     {
-        typename std::map<uint32_t, ELEMENT *>::iterator it = mObjects.find(index);
-        if(it != mObjects.end()) {
-            mObjects.erase(it);
-            return true;
-        }
-        return false;
+        return Remove(index) != nullptr;
     }
 
     /**
      * @brief Searches the container for an element with a key equivalent to
      * index and returns it.
      * @param index: The GL handle of the element to be found or to be created.
-     * @return A pointer to the element in the map.
+     * @return A pointer to the element in the container.
      *
      * In case the key value is not found (thus, the element does not exist)
      * a new object is created. Consequently this method is the only way to
-     * insert a new element in the map.
+     * insert a new element in the container.
      */
     ELEMENT *GetObject(uint32_t index)
     {
+        uint32_t slot = FindSlot(index);
+        if(slot != NO_SLOT) {
+            return mObjects[slot];
+        }
+
         if(mCounter < index) {
             mCounter = index;
         }
-        typename std::map<uint32_t, ELEMENT *>::iterator it = mObjects.find(index);
-        if(it != mObjects.end()) {
-            return it->second;
-        } else {
-            return mObjects[index] = new ELEMENT();
-        }
+
+        ELEMENT *element = new ELEMENT();
+        SetSlot(index, static_cast<uint32_t>(mObjects.size()));
+        mObjects.push_back(element);
+        mNames.push_back(index);
+        mElementNames[element] = index;
+
+        return element;
     }
 
     /**
@@ -142,8 +224,7 @@ public:
      */
     bool ObjectExists(uint32_t index) const
     {
-        typename std::map<uint32_t, ELEMENT *>::const_iterator it = mObjects.find(index);
-        return it == mObjects.end() ? false : true;
+        return FindSlot(index) != NO_SLOT;
     }
 
     /**
@@ -151,29 +232,22 @@ public:
      * @param *element: The element to be searched in the container.
      * @return The GL handle of the element.
      *
-     * The container is traversed using the mapped value as the search value.
      * The GL handle is returned in case the wanted element exists, else the
-     * returned value is 0.
+     * returned value is ~0.
      */
     uint32_t GetObjectId(const ELEMENT * element) const
     {
-        typename std::map<uint32_t, ELEMENT *>::const_iterator it;
-        for(it = mObjects.begin(); it != mObjects.end(); it++) {
-            if(it->second == element) {
-                return it->first;
-            }
-        }
-
-        return ~0;
+        typename std::unordered_map<const ELEMENT *, uint32_t>::const_iterator it = mElementNames.find(element);
+        return it != mElementNames.end() ? it->second : ~0u;
     }
 
     /**
-     * @brief Returns the map container for a specific class.
-     * @return The map container.
+     * @brief Returns the packed elements of a specific class.
+     * @return The packed elements, in no particular order.
      */
-    std::map<uint32_t, ELEMENT *> *GetObjects(void)
+    const std::vector<ELEMENT *> &GetObjects(void) const
     {
-        return &mObjects;
+        return mObjects;
     }
 };
 
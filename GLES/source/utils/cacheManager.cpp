@@ -22,73 +22,245 @@
  */
 
 #include "cacheManager.h"
+#include "resources/shaderProgram.h"
+#include "vulkan/commandBundle.h"
+
+CacheManager::~CacheManager()
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    ReleaseRecycledBuffers();
+}
+
+void
+CacheManager::ReleaseRecycledBuffers(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the pools only hold storage of completed slots, so it is not in use by the device
+    for(auto storage : mRecycledBuffers) {
+        delete storage;
+    }
+    mRecycledBuffers.clear();
+
+    for(auto &direction : mStagingBuffers) {
+        for(auto &sizeClass : direction) {
+            for(auto staging : sizeClass) {
+                delete staging;
+            }
+            sizeClass.clear();
+        }
+    }
+}
+
+bool
+CacheManager::GetStagingSizeClass(size_t size, uint32_t *sizeClass, size_t *classSize)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    *sizeClass = 0;
+    *classSize = GLOVE_STAGING_BUFFER_MIN_SIZE;
+    while(*classSize < size) {
+        *classSize <<= 1;
+        ++(*sizeClass);
+    }
+
+    return *classSize <= GLOVE_STAGING_BUFFER_MAX_SIZE && *sizeClass < GLOVE_STAGING_BUFFER_SIZE_CLASSES;
+}
+
+BufferObject *
+CacheManager::GetStagingBuffer(size_t size, bool upload)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    uint32_t sizeClass;
+    size_t   classSize;
+    if(!GetStagingSizeClass(size, &sizeClass, &classSize)) {
+        classSize = size;
+    } else {
+        std::vector<BufferObject *> &pool = mStagingBuffers[upload ? 0 : 1][sizeClass];
+        if(!pool.empty()) {
+            BufferObject *staging = pool.back();
+            pool.pop_back();
+            return staging;
+        }
+    }
+
+    BufferObject *staging = upload ? static_cast<BufferObject *>(new TransferSrcBufferObject(mVkContext)) :
+                                     static_cast<BufferObject *>(new TransferDstBufferObject(mVkContext));
+    if(!staging->Allocate(classSize, nullptr)) {
+        delete staging;
+        return nullptr;
+    }
+
+    return staging;
+}
 
 void
-CacheManager::CleanUpUBOCache(void)
+CacheManager::CacheStagingBuffer(BufferObject *staging)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    if(!mUBOCache.empty()) {
-        for(uint32_t i = 0; i < mUBOCache.size(); ++i) {
-            if(mUBOCache[i] != nullptr) {
-                delete mUBOCache[i];
-                mUBOCache[i] = nullptr;
+    mSlotCaches[mActiveSlot].stagingBufferCache.push_back(staging);
+}
+
+void
+CacheManager::ReleaseStagingBuffer(BufferObject *staging)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // only buffers of a size class are kept, and only a few of each
+    uint32_t sizeClass;
+    size_t   classSize;
+    const bool upload = staging->GetVkBufferUsage() & VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    if(GetStagingSizeClass(staging->GetSize(), &sizeClass, &classSize) && classSize == staging->GetSize()) {
+        std::vector<BufferObject *> &pool = mStagingBuffers[upload ? 0 : 1][sizeClass];
+        if(pool.size() < GLOVE_MAX_POOLED_STAGING_BUFFERS) {
+            pool.push_back(staging);
+            return;
+        }
+    }
+
+    delete staging;
+}
+
+void
+CacheManager::CleanUpStagingBufferCache(SlotCache *slotCache)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    for(auto staging : slotCache->stagingBufferCache) {
+        ReleaseStagingBuffer(staging);
+    }
+    slotCache->stagingBufferCache.clear();
+}
+
+void
+CacheManager::CleanUpUBOCache(SlotCache *slotCache)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    std::vector<UniformBufferObject *> &UBOCache = slotCache->UBOCache;
+    if(!UBOCache.empty()) {
+        for(uint32_t i = 0; i < UBOCache.size(); ++i) {
+            if(UBOCache[i] != nullptr) {
+                delete UBOCache[i];
+                UBOCache[i] = nullptr;
             }
         }
 
-        mUBOCache.clear();
+        UBOCache.clear();
     }
 }
 
 void
-CacheManager::CleanUpVBOCache()
+CacheManager::CleanUpVBOCache(SlotCache *slotCache)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    if(!mVBOCache.empty()) {
-        for(uint32_t i = 0; i < mVBOCache.size(); ++i) {
-            if(mVBOCache[i] != nullptr) {
-                delete mVBOCache[i];
-                mVBOCache[i] = nullptr;
+    std::vector<BufferObject *> &VBOCache = slotCache->VBOCache;
+    if(!VBOCache.empty()) {
+        for(uint32_t i = 0; i < VBOCache.size(); ++i) {
+            if(VBOCache[i] != nullptr) {
+                delete VBOCache[i];
+                VBOCache[i] = nullptr;
             }
         }
 
-        mVBOCache.clear();
+        VBOCache.clear();
+    }
+}
+
+void
+CacheManager::CleanUpOrphanedBufferCache(SlotCache *slotCache)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    std::vector<BufferObject *> &orphanedBufferCache = slotCache->orphanedBufferCache;
+    for(auto storage : orphanedBufferCache) {
+        if(mRecycledBuffers.size() < GLOVE_MAX_RECYCLED_BUFFER_STORAGES) {
+            mRecycledBuffers.push_back(storage);
+        } else {
+            delete storage;
+        }
     }
+
+    orphanedBufferCache.clear();
 }
 
 void
-CacheManager::CleanUpTextureCache()
+CacheManager::CleanUpTextureCache(SlotCache *slotCache)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    if(!mTextureCache.empty()) {
-        for(uint32_t i = 0; i < mTextureCache.size(); ++i) {
-            if(mTextureCache[i] != nullptr) {
-                delete mTextureCache[i];
-                mTextureCache[i] = nullptr;
+    std::vector<Texture *> &textureCache = slotCache->textureCache;
+    if(!textureCache.empty()) {
+        for(uint32_t i = 0; i < textureCache.size(); ++i) {
+            if(textureCache[i] != nullptr) {
+                delete textureCache[i];
+                textureCache[i] = nullptr;
             }
         }
 
-        mTextureCache.clear();
+        textureCache.clear();
+    }
+}
+
+void
+CacheManager::CleanUpFramebufferCache(SlotCache *slotCache)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    for(auto fbo : slotCache->framebufferCache) {
+        delete fbo;
     }
+    slotCache->framebufferCache.clear();
 }
 
 void
-CacheManager::CleanUpVkPipelineObjectCache()
+CacheManager::CleanUpVkPipelineObjectCache(SlotCache *slotCache)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    if(!mVkPipelineObjectCache.empty()) {
-        for(uint32_t i = 0; i < mVkPipelineObjectCache.size(); ++i) {
-            if(mVkPipelineObjectCache[i] != VK_NULL_HANDLE){
-                vkDestroyPipeline(mVkContext->vkDevice, mVkPipelineObjectCache[i], nullptr);
-                mVkPipelineObjectCache[i] = VK_NULL_HANDLE;
+    std::vector<VkPipeline> &vkPipelineObjectCache = slotCache->vkPipelineObjectCache;
+    if(!vkPipelineObjectCache.empty()) {
+        for(uint32_t i = 0; i < vkPipelineObjectCache.size(); ++i) {
+            if(vkPipelineObjectCache[i] != VK_NULL_HANDLE){
+                vkDestroyPipeline(mVkContext->vkDevice, vkPipelineObjectCache[i], nullptr);
+                vkPipelineObjectCache[i] = VK_NULL_HANDLE;
             }
         }
 
-        mVkPipelineObjectCache.clear();
+        vkPipelineObjectCache.clear();
+    }
+}
+
+void
+CacheManager::CleanUpVkPipelineLayoutCache(SlotCache *slotCache)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    for(VkPipelineLayout layout : slotCache->vkPipelineLayoutCache) {
+        vkDestroyPipelineLayout(mVkContext->vkDevice, layout, nullptr);
+    }
+    slotCache->vkPipelineLayoutCache.clear();
+
+    for(VkDescriptorSetLayout setLayout : slotCache->vkDescriptorSetLayoutCache) {
+        vkDestroyDescriptorSetLayout(mVkContext->vkDevice, setLayout, nullptr);
+    }
+    slotCache->vkDescriptorSetLayoutCache.clear();
+}
+
+void
+CacheManager::CleanUpShaderProgramCache(SlotCache *slotCache)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    std::vector<ShaderProgram *> &shaderProgramCache = slotCache->shaderProgramCache;
+    for(ShaderProgram *program : shaderProgramCache) {
+        delete program;
     }
+    shaderProgramCache.clear();
 }
 
 void
@@ -96,7 +268,8 @@ CacheManager::CacheUBO(UniformBufferObject *uniformBufferObject)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    mUBOCache.push_back(uniformBufferObject);
+    vulkanAPI::CommandBundle::Retire(vulkanAPI::CommandBundle::GetHandleKey(uniformBufferObject->GetVkBuffer()));
+    mSlotCaches[mActiveSlot].UBOCache.push_back(uniformBufferObject);
 }
 
 void
@@ -104,7 +277,33 @@ CacheManager::CacheVBO(BufferObject *vbo)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    mVBOCache.push_back(vbo);
+    vulkanAPI::CommandBundle::Retire(vulkanAPI::CommandBundle::GetHandleKey(vbo->GetVkBuffer()));
+    mSlotCaches[mActiveSlot].VBOCache.push_back(vbo);
+}
+
+void
+CacheManager::CacheOrphanedBuffer(BufferObject *storage)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    vulkanAPI::CommandBundle::Retire(vulkanAPI::CommandBundle::GetHandleKey(storage->GetVkBuffer()));
+    mSlotCaches[mActiveSlot].orphanedBufferCache.push_back(storage);
+}
+
+BufferObject *
+CacheManager::GetRecycledBuffer(size_t size, VkBufferUsageFlags usage, bool deviceLocal)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    for(auto it = mRecycledBuffers.begin(); it != mRecycledBuffers.end(); ++it) {
+        if((*it)->GetSize() == size && (*it)->GetVkBufferUsage() == usage && (*it)->IsDeviceLocal() == deviceLocal) {
+            BufferObject *storage = *it;
+            mRecycledBuffers.erase(it);
+            return storage;
+        }
+    }
+
+    return nullptr;
 }
 
 void
@@ -112,7 +311,16 @@ CacheManager::CacheTexture(Texture *tex)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    mTextureCache.push_back(tex);
+    vulkanAPI::CommandBundle::Retire(vulkanAPI::CommandBundle::GetHandleKey(tex->GetVkImageView()));
+    mSlotCaches[mActiveSlot].textureCache.push_back(tex);
+}
+
+void
+CacheManager::CacheFramebuffer(Framebuffer *fbo)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    mSlotCaches[mActiveSlot].framebufferCache.push_back(fbo);
 }
 
 void
@@ -120,7 +328,60 @@ CacheManager::CacheVkPipelineObject(VkPipeline pipeline)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    mVkPipelineObjectCache.push_back(pipeline);
+    vulkanAPI::CommandBundle::Retire(vulkanAPI::CommandBundle::GetHandleKey(pipeline));
+    mSlotCaches[mActiveSlot].vkPipelineObjectCache.push_back(pipeline);
+}
+
+void
+CacheManager::CacheVkPipelineLayout(VkPipelineLayout layout, VkDescriptorSetLayout setLayout)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(layout != VK_NULL_HANDLE) {
+        vulkanAPI::CommandBundle::Retire(vulkanAPI::CommandBundle::GetHandleKey(layout));
+        mSlotCaches[mActiveSlot].vkPipelineLayoutCache.push_back(layout);
+    }
+    if(setLayout != VK_NULL_HANDLE) {
+        mSlotCaches[mActiveSlot].vkDescriptorSetLayoutCache.push_back(setLayout);
+    }
+}
+
+void
+CacheManager::CacheShaderProgram(ShaderProgram *program)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    vulkanAPI::CommandBundle::Retire(vulkanAPI::CommandBundle::GetHandleKey(program->GetVkPipelineLayout()));
+    mSlotCaches[mActiveSlot].shaderProgramCache.push_back(program);
+}
+
+void
+CacheManager::SetActiveSlot(uint32_t slot)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    assert(slot < GLOVE_MAX_FRAMES_IN_FLIGHT);
+
+    mActiveSlot = slot;
+}
+
+void
+CacheManager::CleanUpSlot(uint32_t slot)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    assert(slot < GLOVE_MAX_FRAMES_IN_FLIGHT);
+
+    CleanUpUBOCache(&mSlotCaches[slot]);
+    CleanUpVBOCache(&mSlotCaches[slot]);
+    CleanUpOrphanedBufferCache(&mSlotCaches[slot]);
+    CleanUpStagingBufferCache(&mSlotCaches[slot]);
+    // framebuffers go first, as they refer to the attachment textures
+    CleanUpFramebufferCache(&mSlotCaches[slot]);
+    CleanUpTextureCache(&mSlotCaches[slot]);
+    CleanUpVkPipelineObjectCache(&mSlotCaches[slot]);
+    CleanUpVkPipelineLayoutCache(&mSlotCaches[slot]);
+    CleanUpShaderProgramCache(&mSlotCaches[slot]);
 }
 
 void
@@ -128,8 +389,7 @@ CacheManager::CleanUpCaches()
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    CleanUpUBOCache();
-    CleanUpVBOCache();
-    CleanUpTextureCache();
-    CleanUpVkPipelineObjectCache();
+    for(uint32_t i = 0; i < GLOVE_MAX_FRAMES_IN_FLIGHT; ++i) {
+        CleanUpSlot(i);
+    }
 }
@@ -18,6 +18,7 @@
  *  @version    1.0
  *
  *  @brief      Vulkan objects cache manager. These caches are needed to keep in memory Vulkan objects referred to by secondary command buffers.
+ *              Objects are kept per command buffer slot and released once that slot has been waited upon.
  *
  */
 #ifndef __CACHEMANAGER_H__
@@ -25,34 +26,94 @@
 
 #include <vector>
 #include "vulkan/vulkan.h"
+#include "vulkan/commandBufferManager.h"
 #include "utils/glLogger.h"
 #include "resources/bufferObject.h"
 #include "resources/texture.h"
+#include "resources/framebuffer.h"
+
+#ifndef GLOVE_MAX_RECYCLED_BUFFER_STORAGES
+#define GLOVE_MAX_RECYCLED_BUFFER_STORAGES              16
+#endif // GLOVE_MAX_RECYCLED_BUFFER_STORAGES
+
+/// staging buffers are pooled in power of two size classes within these bounds,
+/// larger transfers get a buffer of their own
+#ifndef GLOVE_STAGING_BUFFER_MIN_SIZE
+#define GLOVE_STAGING_BUFFER_MIN_SIZE                   (64 << 10)
+#endif // GLOVE_STAGING_BUFFER_MIN_SIZE
+
+#ifndef GLOVE_STAGING_BUFFER_MAX_SIZE
+#define GLOVE_STAGING_BUFFER_MAX_SIZE                   (16 << 20)
+#endif // GLOVE_STAGING_BUFFER_MAX_SIZE
+
+#ifndef GLOVE_MAX_POOLED_STAGING_BUFFERS
+#define GLOVE_MAX_POOLED_STAGING_BUFFERS                4
+#endif // GLOVE_MAX_POOLED_STAGING_BUFFERS
+
+#define GLOVE_STAGING_BUFFER_SIZE_CLASSES               16
+
+class ShaderProgram;
 
 class CacheManager {
 private:
+    typedef struct SlotCache {
+        std::vector<UniformBufferObject *>  UBOCache;
+        std::vector<BufferObject *>         VBOCache;
+        std::vector<BufferObject *>         orphanedBufferCache;
+        std::vector<BufferObject *>         stagingBufferCache;
+        std::vector<Texture *>              textureCache;
+        std::vector<Framebuffer *>          framebufferCache;
+        std::vector<VkPipeline>             vkPipelineObjectCache;
+        std::vector<VkPipelineLayout>       vkPipelineLayoutCache;
+        std::vector<VkDescriptorSetLayout>  vkDescriptorSetLayoutCache;
+        std::vector<ShaderProgram *>        shaderProgramCache;
+    } SlotCache;
+
     const
     vulkanAPI::vkContext_t *            mVkContext;
 
-    std::vector<UniformBufferObject *>  mUBOCache;
-    std::vector<BufferObject *>         mVBOCache;
-    std::vector<Texture *>              mTextureCache;
-    std::vector<VkPipeline>             mVkPipelineObjectCache;
+    SlotCache                           mSlotCaches[GLOVE_MAX_FRAMES_IN_FLIGHT];
+    uint32_t                            mActiveSlot;
+
+    /// storage orphaned by glBufferData, free to back a buffer object again once its slot has completed
+    std::vector<BufferObject *>         mRecycledBuffers;
 
-    void                                CleanUpUBOCache();
-    void                                CleanUpVBOCache();
-    void                                CleanUpTextureCache();
-    void                                CleanUpVkPipelineObjectCache();
+    /// idle staging buffers per direction, uploads first, and per size class
+    std::vector<BufferObject *>         mStagingBuffers[2][GLOVE_STAGING_BUFFER_SIZE_CLASSES];
+
+    void                                CleanUpUBOCache(SlotCache *slotCache);
+    void                                CleanUpVBOCache(SlotCache *slotCache);
+    void                                CleanUpOrphanedBufferCache(SlotCache *slotCache);
+    void                                CleanUpStagingBufferCache(SlotCache *slotCache);
+    static bool                         GetStagingSizeClass(size_t size, uint32_t *sizeClass, size_t *classSize);
+    void                                CleanUpTextureCache(SlotCache *slotCache);
+    void                                CleanUpFramebufferCache(SlotCache *slotCache);
+    void                                CleanUpVkPipelineObjectCache(SlotCache *slotCache);
+    void                                CleanUpVkPipelineLayoutCache(SlotCache *slotCache);
+    void                                CleanUpShaderProgramCache(SlotCache *slotCache);
 
 public:
-     CacheManager(const vulkanAPI::vkContext_t *vkContext) : mVkContext(vkContext) { }
-    ~CacheManager() { }
+     CacheManager(const vulkanAPI::vkContext_t *vkContext) : mVkContext(vkContext), mActiveSlot(0) { }
+    ~CacheManager();
 
     void                                CacheUBO(UniformBufferObject *uniformBufferObject);
     void                                CacheVBO(BufferObject *vbo);
+    void                                CacheOrphanedBuffer(BufferObject *storage);
+    BufferObject                       *GetRecycledBuffer(size_t size, VkBufferUsageFlags usage, bool deviceLocal);
+    void                                ReleaseRecycledBuffers(void);
+    BufferObject                       *GetStagingBuffer(size_t size, bool upload);
+    void                                CacheStagingBuffer(BufferObject *staging);
+    void                                ReleaseStagingBuffer(BufferObject *staging);
     void                                CacheTexture(Texture *tex);
+    void                                CacheFramebuffer(Framebuffer *fbo);
     void                                CacheVkPipelineObject(VkPipeline pipeline);
+    void                                CacheVkPipelineLayout(VkPipelineLayout layout, VkDescriptorSetLayout setLayout);
+    void                                CacheShaderProgram(ShaderProgram *program);
+    void                                CleanUpSlot(uint32_t slot);
     void                                CleanUpCaches();
+
+// Set Functions
+    void                                SetActiveSlot(uint32_t slot);
 };
 
 #endif //__CACHEMANAGER_H__
@@ -0,0 +1,122 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       compileWorker.cpp
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Background shader compilation and program linking (KHR_parallel_shader_compile)
+ *
+ *  @section
+ *
+ *  glCompileShader and the glslang part of glLinkProgram are queued for
+ *  the job system and return immediately. A context has a
+ *  single shader compiler whose state carries over from the compilation of
+ *  a shader to the link of the program it is attached to, so the jobs of a
+ *  context run one after the other, in the order they were queued. Any
+ *  call that needs the outcome of a job waits for it, while the
+ *  GL_COMPLETION_STATUS_KHR queries only check whether it has run.
+ *
+ */
+
+#include "compileWorker.h"
+#include "jobSystem.h"
+
+CompileWorker::CompileWorker()
+: mSubmitted(0), mCompleted(0), mScheduled(false)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+}
+
+CompileWorker::~CompileWorker()
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // pending jobs are completed, they write to shaders and programs that are still alive
+    std::unique_lock<std::mutex> lock(mMutex);
+    mJobDone.wait(lock, [this] { return !mScheduled; });
+}
+
+uint64_t
+CompileWorker::Enqueue(const job_t &job)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    uint64_t ticket;
+    bool     schedule;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mJobs.push_back(job);
+        ticket     = ++mSubmitted;
+        schedule   = !mScheduled;
+        mScheduled = true;
+    }
+
+    if(schedule) {
+        JobSystem::GetInstance()->Submit([this] { Run(); });
+    }
+
+    return ticket;
+}
+
+bool
+CompileWorker::IsDone(uint64_t ticket)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mCompleted >= ticket;
+}
+
+void
+CompileWorker::Wait(uint64_t ticket)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    if(ticket == 0) {
+        ticket = mSubmitted;
+    }
+    mJobDone.wait(lock, [this, ticket] { return mCompleted >= ticket; });
+}
+
+void
+CompileWorker::Run(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    for(;;) {
+        job_t job;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if(mJobs.empty()) {
+                // notified under the lock, as the worker may be destroyed right after
+                mScheduled = false;
+                mJobDone.notify_all();
+                return;
+            }
+            job = mJobs.front();
+            mJobs.pop_front();
+        }
+
+        job();
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            ++mCompleted;
+        }
+        mJobDone.notify_all();
+    }
+}
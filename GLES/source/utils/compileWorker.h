@@ -0,0 +1,73 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       compileWorker.h
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Background shader compilation and program linking (KHR_parallel_shader_compile)
+ *
+ */
+
+#ifndef __COMPILEWORKER_H__
+#define __COMPILEWORKER_H__
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stdint.h>
+#include "utils/glLogger.h"
+
+/// initial value of GL_MAX_SHADER_COMPILER_THREADS_KHR, 0 compiles and links on the calling thread
+#ifndef GLOVE_MAX_SHADER_COMPILER_THREADS
+#define GLOVE_MAX_SHADER_COMPILER_THREADS               1
+#endif // GLOVE_MAX_SHADER_COMPILER_THREADS
+
+class CompileWorker {
+
+public:
+    typedef std::function<void(void)>   job_t;
+
+private:
+    std::mutex                        mMutex;
+    std::condition_variable           mJobDone;
+    std::deque<job_t>                 mJobs;
+    /// jobs run in submission order, so a ticket is complete once it is not above the completed count
+    uint64_t                          mSubmitted;
+    uint64_t                          mCompleted;
+    /// a job of the pool drains the queue while this is set
+    bool                              mScheduled;
+
+    void                              Run(void);
+
+public:
+// Constructor
+    CompileWorker();
+
+// Destructor
+    ~CompileWorker();
+
+// Enqueue Functions
+    /// returns the ticket of the job, which is never 0
+    uint64_t                          Enqueue(const job_t &job);
+
+// Wait Functions
+    bool                              IsDone(uint64_t ticket);
+    /// blocks until the job of ticket, or all of them when ticket is 0, has run
+    void                              Wait(uint64_t ticket = 0);
+};
+
+#endif // __COMPILEWORKER_H__
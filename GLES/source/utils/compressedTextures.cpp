@@ -0,0 +1,357 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       compressedTextures.cpp
+ *  @author     Think Silicon
+ *  @date       14/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Block Compressed Texture Formats and Host Transcoding
+ *
+ *  @section
+ *
+ *  Compressed images are uploaded as they are when the device can sample
+ *  their Vulkan block format. ETC1 and ETC2/EAC blocks can also be decoded
+ *  on the host to RGBA8 for the devices that lack them, which covers most
+ *  desktop GPUs. The blocks are independent of each other, so large images
+ *  are decoded by a few threads, each taking a band of block rows. ASTC has
+ *  no host decoder and is only exposed when the device supports it.
+ *
+ */
+
+#include "compressedTextures.h"
+#include "glLogger.h"
+#include "jobSystem.h"
+#include <algorithm>
+#include <cstring>
+
+static const CompressedFormat compressedFormats[] = {
+    { GL_ETC1_RGB8_OES,                            VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK,     4,  4,  8, true  },
+    { GL_COMPRESSED_RGB8_ETC2,                     VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK,     4,  4,  8, true  },
+    { GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2, VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK,   4,  4,  8, true  },
+    { GL_COMPRESSED_RGBA8_ETC2_EAC,                VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK,   4,  4, 16, true  },
+    { GL_COMPRESSED_RGBA_ASTC_4x4_KHR,             VK_FORMAT_ASTC_4x4_UNORM_BLOCK,        4,  4, 16, false },
+    { GL_COMPRESSED_RGBA_ASTC_5x4_KHR,             VK_FORMAT_ASTC_5x4_UNORM_BLOCK,        5,  4, 16, false },
+    { GL_COMPRESSED_RGBA_ASTC_5x5_KHR,             VK_FORMAT_ASTC_5x5_UNORM_BLOCK,        5,  5, 16, false },
+    { GL_COMPRESSED_RGBA_ASTC_6x5_KHR,             VK_FORMAT_ASTC_6x5_UNORM_BLOCK,        6,  5, 16, false },
+    { GL_COMPRESSED_RGBA_ASTC_6x6_KHR,             VK_FORMAT_ASTC_6x6_UNORM_BLOCK,        6,  6, 16, false },
+    { GL_COMPRESSED_RGBA_ASTC_8x5_KHR,             VK_FORMAT_ASTC_8x5_UNORM_BLOCK,        8,  5, 16, false },
+    { GL_COMPRESSED_RGBA_ASTC_8x6_KHR,             VK_FORMAT_ASTC_8x6_UNORM_BLOCK,        8,  6, 16, false },
+    { GL_COMPRESSED_RGBA_ASTC_8x8_KHR,             VK_FORMAT_ASTC_8x8_UNORM_BLOCK,        8,  8, 16, false },
+    { GL_COMPRESSED_RGBA_ASTC_10x5_KHR,            VK_FORMAT_ASTC_10x5_UNORM_BLOCK,      10,  5, 16, false },
+    { GL_COMPRESSED_RGBA_ASTC_10x6_KHR,            VK_FORMAT_ASTC_10x6_UNORM_BLOCK,      10,  6, 16, false },
+    { GL_COMPRESSED_RGBA_ASTC_10x8_KHR,            VK_FORMAT_ASTC_10x8_UNORM_BLOCK,      10,  8, 16, false },
+    { GL_COMPRESSED_RGBA_ASTC_10x10_KHR,           VK_FORMAT_ASTC_10x10_UNORM_BLOCK,     10, 10, 16, false },
+    { GL_COMPRESSED_RGBA_ASTC_12x10_KHR,           VK_FORMAT_ASTC_12x10_UNORM_BLOCK,     12, 10, 16, false },
+    { GL_COMPRESSED_RGBA_ASTC_12x12_KHR,           VK_FORMAT_ASTC_12x12_UNORM_BLOCK,     12, 12, 16, false }
+};
+
+// intensity modifiers of the individual and differential modes, per pixel index
+static const int etcModifierTable[8][4] = {
+    {  2,   8,  -2,   -8 },
+    {  5,  17,  -5,  -17 },
+    {  9,  29,  -9,  -29 },
+    { 13,  42, -13,  -42 },
+    { 18,  60, -18,  -60 },
+    { 24,  80, -24,  -80 },
+    { 33, 106, -33, -106 },
+    { 47, 183, -47, -183 }
+};
+
+// distances of the T and H modes
+static const int etcDistanceTable[8] = { 3, 6, 11, 16, 23, 32, 41, 64 };
+
+static const int eacModifierTable[16][8] = {
+    { -3, -6,  -9, -15, 2, 5, 8, 14 },
+    { -3, -7, -10, -13, 2, 6, 9, 12 },
+    { -2, -5,  -8, -13, 1, 4, 7, 12 },
+    { -2, -4,  -6, -13, 1, 3, 5, 12 },
+    { -3, -6,  -8, -12, 2, 5, 7, 11 },
+    { -3, -7,  -9, -11, 2, 6, 8, 10 },
+    { -4, -7,  -8, -11, 3, 6, 7, 10 },
+    { -3, -5,  -8, -11, 2, 4, 7, 10 },
+    { -2, -6,  -8, -10, 1, 5, 7,  9 },
+    { -2, -5,  -8, -10, 1, 4, 7,  9 },
+    { -2, -4,  -8, -10, 1, 3, 7,  9 },
+    { -2, -5,  -7, -10, 1, 4, 6,  9 },
+    { -3, -4,  -7, -10, 2, 3, 6,  9 },
+    { -1, -2,  -3, -10, 0, 1, 2,  9 },
+    { -4, -6,  -8,  -9, 3, 5, 7,  8 },
+    { -3, -5,  -7,  -9, 2, 4, 6,  8 }
+};
+
+static inline uint8_t Clamp255(int value) { return static_cast<uint8_t>(value < 0 ? 0 : (value > 255 ? 255 : value)); }
+static inline int     Extend4(int value)  { return (value << 4) | value;        }
+static inline int     Extend5(int value)  { return (value << 3) | (value >> 2); }
+static inline int     Extend6(int value)  { return (value << 2) | (value >> 4); }
+static inline int     Extend7(int value)  { return (value << 1) | (value >> 6); }
+
+static inline void
+SetTexel(uint8_t *texel, int r, int g, int b, uint8_t a)
+{
+    texel[0] = Clamp255(r);
+    texel[1] = Clamp255(g);
+    texel[2] = Clamp255(b);
+    texel[3] = a;
+}
+
+// the 2-bit index of a pixel, pixels are ordered column after column
+static inline uint32_t
+GetEtcPixelIndex(uint32_t lo, uint32_t x, uint32_t y)
+{
+    const uint32_t i = x * 4 + y;
+    return (((lo >> (i + 16)) & 1) << 1) | ((lo >> i) & 1);
+}
+
+/// decodes a 4x4 ETC1/ETC2 color block into RGBA8 texels, row after row
+static void
+DecodeEtc2ColorBlock(const uint8_t *block, uint8_t *texels, bool punchthrough)
+{
+    const uint32_t hi = (static_cast<uint32_t>(block[0]) << 24) | (static_cast<uint32_t>(block[1]) << 16) |
+                        (static_cast<uint32_t>(block[2]) <<  8) |  static_cast<uint32_t>(block[3]);
+    const uint32_t lo = (static_cast<uint32_t>(block[4]) << 24) | (static_cast<uint32_t>(block[5]) << 16) |
+                        (static_cast<uint32_t>(block[6]) <<  8) |  static_cast<uint32_t>(block[7]);
+
+    // with punch-through alpha the differential bit tells whether the block is opaque
+    const bool diff   = punchthrough || (hi & 2);
+    const bool opaque = !punchthrough || (hi & 2);
+
+    int base[2][3];
+    if(!diff) {
+        base[0][0] = Extend4((hi >> 28) & 0xF); base[1][0] = Extend4((hi >> 24) & 0xF);
+        base[0][1] = Extend4((hi >> 20) & 0xF); base[1][1] = Extend4((hi >> 16) & 0xF);
+        base[0][2] = Extend4((hi >> 12) & 0xF); base[1][2] = Extend4((hi >>  8) & 0xF);
+    } else {
+        const int r  = (hi >> 27) & 0x1F, dr = static_cast<int>(((hi >> 24) & 7) ^ 4) - 4;
+        const int g  = (hi >> 19) & 0x1F, dg = static_cast<int>(((hi >> 16) & 7) ^ 4) - 4;
+        const int b  = (hi >> 11) & 0x1F, db = static_cast<int>(((hi >>  8) & 7) ^ 4) - 4;
+
+        if(r + dr < 0 || r + dr > 31 || g + dg < 0 || g + dg > 31) {
+            // T and H modes, four paint colors around two base colors
+            int c[2][3], paint[4][3];
+            if(r + dr < 0 || r + dr > 31) {
+                c[0][0] = Extend4((((hi >> 27) & 3) << 2) | ((hi >> 24) & 3));
+                c[0][1] = Extend4((hi >> 20) & 0xF);
+                c[0][2] = Extend4((hi >> 16) & 0xF);
+                c[1][0] = Extend4((hi >> 12) & 0xF);
+                c[1][1] = Extend4((hi >>  8) & 0xF);
+                c[1][2] = Extend4((hi >>  4) & 0xF);
+                const int d = etcDistanceTable[(((hi >> 2) & 3) << 1) | (hi & 1)];
+                for(int ch = 0; ch < 3; ++ch) {
+                    paint[0][ch] = c[0][ch];
+                    paint[1][ch] = c[1][ch] + d;
+                    paint[2][ch] = c[1][ch];
+                    paint[3][ch] = c[1][ch] - d;
+                }
+            } else {
+                const int r1 = (hi >> 27) & 0xF;
+                const int g1 = (((hi >> 24) & 7) << 1) | ((hi >> 20) & 1);
+                const int b1 = (((hi >> 19) & 1) << 3) | ((hi >> 15) & 7);
+                const int r2 = (hi >> 11) & 0xF;
+                const int g2 = (hi >>  7) & 0xF;
+                const int b2 = (hi >>  3) & 0xF;
+                const int order = ((r1 << 8) | (g1 << 4) | b1) >= ((r2 << 8) | (g2 << 4) | b2) ? 1 : 0;
+                const int d = etcDistanceTable[(((hi >> 2) & 1) << 2) | ((hi & 1) << 1) | order];
+                c[0][0] = Extend4(r1); c[0][1] = Extend4(g1); c[0][2] = Extend4(b1);
+                c[1][0] = Extend4(r2); c[1][1] = Extend4(g2); c[1][2] = Extend4(b2);
+                for(int ch = 0; ch < 3; ++ch) {
+                    paint[0][ch] = c[0][ch] + d;
+                    paint[1][ch] = c[0][ch] - d;
+                    paint[2][ch] = c[1][ch] + d;
+                    paint[3][ch] = c[1][ch] - d;
+                }
+            }
+
+            for(uint32_t y = 0; y < 4; ++y) {
+                for(uint32_t x = 0; x < 4; ++x) {
+                    uint8_t *texel = &texels[(y * 4 + x) * 4];
+                    const uint32_t index = GetEtcPixelIndex(lo, x, y);
+                    if(!opaque && index == 2) {
+                        SetTexel(texel, 0, 0, 0, 0);
+                    } else {
+                        SetTexel(texel, paint[index][0], paint[index][1], paint[index][2], 255);
+                    }
+                }
+            }
+            return;
+        }
+
+        if(b + db < 0 || b + db > 31) {
+            // planar mode, colors interpolated from the origin, horizontal and vertical values
+            const int ro = Extend6((hi >> 25) & 0x3F);
+            const int go = Extend7((((hi >> 24) & 1) << 6) | ((hi >> 17) & 0x3F));
+            const int bo = Extend6((((hi >> 16) & 1) << 5) | (((hi >> 11) & 3) << 3) | ((hi >> 7) & 7));
+            const int rh = Extend6((((hi >> 2) & 0x1F) << 1) | (hi & 1));
+            const int gh = Extend7((lo >> 25) & 0x7F);
+            const int bh = Extend6((lo >> 19) & 0x3F);
+            const int rv = Extend6((lo >> 13) & 0x3F);
+            const int gv = Extend7((lo >>  6) & 0x7F);
+            const int bv = Extend6( lo        & 0x3F);
+
+            for(int y = 0; y < 4; ++y) {
+                for(int x = 0; x < 4; ++x) {
+                    SetTexel(&texels[(y * 4 + x) * 4],
+                             (x * (rh - ro) + y * (rv - ro) + 4 * ro + 2) >> 2,
+                             (x * (gh - go) + y * (gv - go) + 4 * go + 2) >> 2,
+                             (x * (bh - bo) + y * (bv - bo) + 4 * bo + 2) >> 2,
+                             255);
+                }
+            }
+            return;
+        }
+
+        base[0][0] = Extend5(r); base[1][0] = Extend5(r + dr);
+        base[0][1] = Extend5(g); base[1][1] = Extend5(g + dg);
+        base[0][2] = Extend5(b); base[1][2] = Extend5(b + db);
+    }
+
+    // individual and differential modes, two sub-blocks side by side or on top of each other
+    const uint32_t table[2] = { (hi >> 5) & 7, (hi >> 2) & 7 };
+    const bool     flip     = hi & 1;
+    for(uint32_t y = 0; y < 4; ++y) {
+        for(uint32_t x = 0; x < 4; ++x) {
+            uint8_t *texel = &texels[(y * 4 + x) * 4];
+            const uint32_t sub   = flip ? (y >= 2) : (x >= 2);
+            const uint32_t index = GetEtcPixelIndex(lo, x, y);
+            if(!opaque && index == 2) {
+                SetTexel(texel, 0, 0, 0, 0);
+                continue;
+            }
+
+            const int modifier = (!opaque && index == 0) ? 0 : etcModifierTable[table[sub]][index];
+            SetTexel(texel, base[sub][0] + modifier, base[sub][1] + modifier, base[sub][2] + modifier, 255);
+        }
+    }
+}
+
+/// decodes a 4x4 EAC block into the alpha channel of RGBA8 texels
+static void
+DecodeEacAlphaBlock(const uint8_t *block, uint8_t *texels)
+{
+    const int base       = block[0];
+    const int multiplier = block[1] >> 4;
+    const int *modifiers = eacModifierTable[block[1] & 0xF];
+
+    uint64_t indices = 0;
+    for(int i = 2; i < 8; ++i) {
+        indices = (indices << 8) | block[i];
+    }
+
+    for(uint32_t x = 0; x < 4; ++x) {
+        for(uint32_t y = 0; y < 4; ++y) {
+            const uint32_t i = x * 4 + y;
+            const int index = static_cast<int>((indices >> (45 - 3 * i)) & 7);
+            texels[(y * 4 + x) * 4 + 3] = Clamp255(base + modifiers[index] * multiplier);
+        }
+    }
+}
+
+static void
+TranscodeBlockRows(const CompressedFormat *format, GLsizei width, GLsizei height,
+                   const uint8_t *src, uint8_t *dst, size_t dstStride, uint32_t firstRow, uint32_t lastRow)
+{
+    const uint32_t blocksX = (width + 3) / 4;
+    uint8_t texels[4 * 4 * 4];
+
+    for(uint32_t by = firstRow; by < lastRow; ++by) {
+        const uint8_t *block = src + static_cast<size_t>(by) * blocksX * format->blockSize;
+        for(uint32_t bx = 0; bx < blocksX; ++bx, block += format->blockSize) {
+            switch(format->glFormat) {
+            case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+                DecodeEtc2ColorBlock(block, texels, true);
+                break;
+            case GL_COMPRESSED_RGBA8_ETC2_EAC:
+                DecodeEtc2ColorBlock(block + 8, texels, false);
+                DecodeEacAlphaBlock(block, texels);
+                break;
+            default:
+                DecodeEtc2ColorBlock(block, texels, false);
+                break;
+            }
+
+            // blocks at the right and bottom edges may hang over the image
+            const uint32_t columns = std::min(4u, static_cast<uint32_t>(width)  - bx * 4);
+            const uint32_t rows    = std::min(4u, static_cast<uint32_t>(height) - by * 4);
+            for(uint32_t y = 0; y < rows; ++y) {
+                memcpy(dst + (by * 4 + y) * dstStride + bx * 4 * 4, &texels[y * 4 * 4], columns * 4);
+            }
+        }
+    }
+}
+
+const CompressedFormat *
+GetCompressedFormats(size_t *count)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    *count = sizeof(compressedFormats) / sizeof(compressedFormats[0]);
+    return compressedFormats;
+}
+
+const CompressedFormat *
+FindCompressedFormat(GLenum format)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    for(const CompressedFormat &compressed : compressedFormats) {
+        if(compressed.glFormat == format) {
+            return &compressed;
+        }
+    }
+
+    return nullptr;
+}
+
+size_t
+GetCompressedImageSize(const CompressedFormat *format, GLsizei width, GLsizei height)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    const size_t blocksX = (width  + format->blockWidth  - 1) / format->blockWidth;
+    const size_t blocksY = (height + format->blockHeight - 1) / format->blockHeight;
+    return blocksX * blocksY * format->blockSize;
+}
+
+void
+TranscodeCompressedImage(const CompressedFormat *format, GLsizei width, GLsizei height,
+                         const void *src, uint8_t *dst, size_t dstStride)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!format->transcodable || width <= 0 || height <= 0) {
+        return;
+    }
+
+    const uint8_t *blocks  = static_cast<const uint8_t *>(src);
+    const uint32_t blocksX = (width  + 3) / 4;
+    const uint32_t blocksY = (height + 3) / 4;
+
+    uint32_t threads = 1;
+    if(blocksX * blocksY >= GLOVE_TRANSCODE_THREAD_MIN_BLOCKS) {
+        threads = std::min(JobSystem::GetInstance()->GetWorkerCount() + 1, static_cast<uint32_t>(GLOVE_TRANSCODE_MAX_THREADS));
+        threads = std::min(threads, blocksY);
+    }
+
+    if(threads == 1) {
+        TranscodeBlockRows(format, width, height, blocks, dst, dstStride, 0, blocksY);
+        return;
+    }
+
+    // each job of the pool takes a band of block rows, the calling thread decodes one of them as well
+    const uint32_t rowsPerThread = (blocksY + threads - 1) / threads;
+    const uint32_t bands         = (blocksY + rowsPerThread - 1) / rowsPerThread;
+    JobSystem::GetInstance()->ParallelFor(bands, [=](uint32_t band) {
+        TranscodeBlockRows(format, width, height, blocks, dst, dstStride, band * rowsPerThread, std::min((band + 1) * rowsPerThread, blocksY));
+    });
+}
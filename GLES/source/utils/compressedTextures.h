@@ -0,0 +1,71 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       compressedTextures.h
+ *  @author     Think Silicon
+ *  @date       14/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Block Compressed Texture Formats and Host Transcoding
+ *
+ */
+
+#ifndef __COMPRESSEDTEXTURES_H__
+#define __COMPRESSEDTEXTURES_H__
+
+#include "GLES2/gl2.h"
+#include "GLES2/gl2ext.h"
+#include "vulkan/vulkan.h"
+#include <cstddef>
+#include <stdint.h>
+
+// ETC2/EAC formats are core in OpenGL ES 3.0, they are accepted here with their ES 3.0 enums
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2                         0x9274
+#endif // GL_COMPRESSED_RGB8_ETC2
+#ifndef GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2
+#define GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2     0x9276
+#endif // GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2
+#ifndef GL_COMPRESSED_RGBA8_ETC2_EAC
+#define GL_COMPRESSED_RGBA8_ETC2_EAC                    0x9278
+#endif // GL_COMPRESSED_RGBA8_ETC2_EAC
+
+/// blocks an image needs before its transcoding is split across the workers of the job system
+#ifndef GLOVE_TRANSCODE_THREAD_MIN_BLOCKS
+#define GLOVE_TRANSCODE_THREAD_MIN_BLOCKS               4096
+#endif // GLOVE_TRANSCODE_THREAD_MIN_BLOCKS
+
+#ifndef GLOVE_TRANSCODE_MAX_THREADS
+#define GLOVE_TRANSCODE_MAX_THREADS                     8
+#endif // GLOVE_TRANSCODE_MAX_THREADS
+
+typedef struct CompressedFormat {
+    GLenum                      glFormat;
+    VkFormat                    vkFormat;
+    uint32_t                    blockWidth;
+    uint32_t                    blockHeight;
+    uint32_t                    blockSize;
+    /// the blocks can be decoded on the host when the device cannot sample them
+    bool                        transcodable;
+} CompressedFormat;
+
+const CompressedFormat *GetCompressedFormats(size_t *count);
+const CompressedFormat *FindCompressedFormat(GLenum format);
+size_t                  GetCompressedImageSize(const CompressedFormat *format, GLsizei width, GLsizei height);
+
+/// decodes the blocks of a width x height image into RGBA8 texels, rows dstStride bytes apart
+void                    TranscodeCompressedImage(const CompressedFormat *format, GLsizei width, GLsizei height,
+                                                 const void *src, uint8_t *dst, size_t dstStride);
+
+#endif // __COMPRESSEDTEXTURES_H__
@@ -121,11 +121,16 @@ GLLogger::Log(glLogLevel_e level, const char *format, ... )
     va_start(args, format);
     vsnprintf(log, 200, format, args);
     va_end(args);
+    // the function entries of binary traces do not go through the logger
+    GLLogger::GetInstance();
     mLoggerImpl->WriteLog(level, log);
 }
 
 void
 GLLogger::Shutdown()
 {
+#ifdef TRACE_BINARY
+    GLTracer::Shutdown();
+#endif // TRACE_BINARY
     GLLogger::DestroyInstance();
 }
@@ -51,7 +51,17 @@ extern "C" {
 }
 #endif
 
-#ifdef TRACE_BUILD
+#if defined(TRACE_BINARY)
+#   include "glTracer.h"
+#   define STR_HELPER(x)                                #x
+#   define STR(x)                                       STR_HELPER(x)
+#   define PROJECT_LENGTH                               strlen(STR(PROJECT_PATH)) -1
+#   define GL_SOURCE_FILE_NAME                          &__FILE__[ PROJECT_LENGTH ]
+#   define FUN_ENTRY(__lvl__)                           static const uint32_t gloveTraceSite = GLTracer::RegisterSite(__lvl__, GL_SOURCE_FILE_NAME, __func__, __LINE__); \
+                                                        GLTracer::Scope gloveTraceScope(gloveTraceSite)
+#   define GLOVE_PRINT(__lvl__, ...)                    GLLogger::Log(__lvl__, __VA_ARGS__)
+#   define GLOVE_PRINT_ERR(...)                         fprintf(stderr, __VA_ARGS__);
+#elif defined(TRACE_BUILD)
 #   define STR_HELPER(x)                                #x
 #   define STR(x)                                       STR_HELPER(x)
 #   define PROJECT_LENGTH                               strlen(STR(PROJECT_PATH)) -1
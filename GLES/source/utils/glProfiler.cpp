@@ -0,0 +1,50 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       glProfiler.cpp
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Profiler zones of the hot paths, shared by EGL and GLESv2
+ *
+ *  @section
+ *
+ *  The zones name the GL and EGL calls that dominate the host time of a
+ *  frame, so that they line up with the rest of the application in Tracy or
+ *  Perfetto. Tracy needs no setup. The Perfetto track events of each library
+ *  are registered with the tracing service of the system, and are recorded
+ *  while a trace enables the "glove" category.
+ *
+ */
+
+#include "glProfiler.h"
+
+#if defined(GLOVE_PROFILER_PERFETTO)
+#include <mutex>
+
+PERFETTO_TRACK_EVENT_STATIC_STORAGE();
+
+void
+GLProfilerInitialize(void)
+{
+    static std::once_flag initialized;
+    std::call_once(initialized, [] {
+        perfetto::TracingInitArgs args;
+        args.backends = perfetto::kSystemBackend;
+        perfetto::Tracing::Initialize(args);
+        perfetto::TrackEvent::Register();
+    });
+}
+#endif // GLOVE_PROFILER_PERFETTO
@@ -0,0 +1,47 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       glProfiler.h
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Profiler zones of the hot paths, shared by EGL and GLESv2
+ *
+ */
+
+#ifndef __GLPROFILER_H__
+#define __GLPROFILER_H__
+
+// the backend is selected with the PROFILER option of CMake, no zone is compiled in otherwise
+#if defined(GLOVE_PROFILER_TRACY)
+#   include <tracy/Tracy.hpp>
+#   define GLOVE_PROFILE_INIT()
+#   define GLOVE_PROFILE_ZONE(__name__)                 ZoneScopedN(__name__)
+#   define GLOVE_PROFILE_FRAME()                        FrameMark
+#elif defined(GLOVE_PROFILER_PERFETTO)
+#   include <perfetto.h>
+PERFETTO_DEFINE_CATEGORIES(perfetto::Category("glove").SetDescription("GLOVE hot paths"));
+/// connects to the tracing service of the system, once per library
+void GLProfilerInitialize(void);
+#   define GLOVE_PROFILE_INIT()                         GLProfilerInitialize()
+#   define GLOVE_PROFILE_ZONE(__name__)                 TRACE_EVENT("glove", __name__)
+#   define GLOVE_PROFILE_FRAME()                        TRACE_EVENT_INSTANT("glove", "frame")
+#else
+#   define GLOVE_PROFILE_INIT()
+#   define GLOVE_PROFILE_ZONE(__name__)
+#   define GLOVE_PROFILE_FRAME()
+#endif
+
+#endif // __GLPROFILER_H__
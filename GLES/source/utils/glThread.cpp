@@ -0,0 +1,277 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       glThread.cpp
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Execution of the GL calls of a context on a worker thread
+ *
+ *  @section
+ *
+ *  With GLOVE_GLTHREAD set, the entry points record the calls that return
+ *  nothing, together with a copy of the little client memory they read, into
+ *  batches that a worker thread of the context runs against it, so that the
+ *  validation, the state tracking and the recording of the draws leave the
+ *  thread of the application. Recording a call takes neither a lock nor an
+ *  atomic operation, the batches are handed over through the counters of
+ *  the submitted and executed ones, which only take the mutex to wake the
+ *  side that sleeps. The calls that return something or write to client
+ *  memory, and those whose client memory is too large to copy, wait for the
+ *  worker to run what was recorded and then run on the calling thread, as
+ *  do the draws that read client arrays or indices. The thread of the
+ *  application follows the buffer and vertex array bindings to tell those
+ *  draws apart.
+ *
+ */
+
+#include "glThread.h"
+#include "context/context.h"
+
+GLThread::GLThread(Context *context)
+: mContext(context), mSubmitted(0), mExecuted(0), mTerminate(false), mArrayBuffer(0)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    for(batch_t &batch : mBatches) {
+        batch.data = new uint8_t[GLOVE_GLTHREAD_BATCH_SIZE];
+        batch.used = 0;
+    }
+
+    mVertexArray = &mVertexArrays[0];
+    memset(static_cast<void *>(mVertexArray), 0, sizeof(vertexArrayState_t));
+
+    mWorker = std::thread(&GLThread::Run, this);
+}
+
+GLThread::~GLThread()
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // the recorded calls still belong to the context
+    Sync();
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mTerminate = true;
+    }
+    mBatchSubmitted.notify_one();
+    mWorker.join();
+
+    for(batch_t &batch : mBatches) {
+        delete [] batch.data;
+    }
+}
+
+uint8_t *
+GLThread::Allocate(size_t size)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    assert(size <= GLOVE_GLTHREAD_BATCH_SIZE);
+
+    batch_t *batch = &mBatches[mSubmitted.load(std::memory_order_relaxed) % GLOVE_GLTHREAD_BATCH_COUNT];
+    if(batch->used + size > GLOVE_GLTHREAD_BATCH_SIZE) {
+        Submit();
+        batch = &mBatches[mSubmitted.load(std::memory_order_relaxed) % GLOVE_GLTHREAD_BATCH_COUNT];
+    }
+
+    uint8_t *command = batch->data + batch->used;
+    batch->used += size;
+    return command;
+}
+
+void
+GLThread::Submit(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    uint32_t submitted = mSubmitted.load(std::memory_order_relaxed);
+    if(!mBatches[submitted % GLOVE_GLTHREAD_BATCH_COUNT].used) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mSubmitted.store(++submitted, std::memory_order_release);
+    }
+    mBatchSubmitted.notify_one();
+
+    // the next batch is recorded once the worker is done with it
+    if(submitted - mExecuted.load(std::memory_order_acquire) >= GLOVE_GLTHREAD_BATCH_COUNT) {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mBatchExecuted.wait(lock, [this, submitted] { return submitted - mExecuted.load(std::memory_order_acquire) < GLOVE_GLTHREAD_BATCH_COUNT; });
+    }
+    mBatches[submitted % GLOVE_GLTHREAD_BATCH_COUNT].used = 0;
+}
+
+void
+GLThread::Sync(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    Submit();
+
+    const uint32_t submitted = mSubmitted.load(std::memory_order_relaxed);
+    if(mExecuted.load(std::memory_order_acquire) == submitted) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mBatchExecuted.wait(lock, [this, submitted] { return mExecuted.load(std::memory_order_acquire) == submitted; });
+}
+
+void
+GLThread::Run(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the calls find their context as current, as on the thread of the application
+    SetCurrentContext(mContext);
+
+    for(;;) {
+        const uint32_t executed = mExecuted.load(std::memory_order_relaxed);
+        if(mSubmitted.load(std::memory_order_acquire) == executed) {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mBatchSubmitted.wait(lock, [this, executed] { return mTerminate || mSubmitted.load(std::memory_order_acquire) != executed; });
+            if(mSubmitted.load(std::memory_order_acquire) == executed) {
+                return;
+            }
+        }
+
+        batch_t *batch = &mBatches[executed % GLOVE_GLTHREAD_BATCH_COUNT];
+        for(size_t offset = 0; offset < batch->used;) {
+            command_t *command = reinterpret_cast<command_t *>(batch->data + offset);
+            offset += command->size;
+            command->execute(mContext, command);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mExecuted.store(executed + 1, std::memory_order_release);
+        }
+        mBatchExecuted.notify_all();
+    }
+}
+
+void
+GLThread::BindBuffer(GLenum target, GLuint buffer)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(target == GL_ARRAY_BUFFER) {
+        mArrayBuffer = buffer;
+    } else if(target == GL_ELEMENT_ARRAY_BUFFER) {
+        mVertexArray->elementArrayBuffer = buffer;
+    }
+}
+
+void
+GLThread::DeleteBuffers(GLsizei n, const GLuint *buffers)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(n <= 0 || !buffers) {
+        return;
+    }
+
+    // arrays left without their buffer are taken for client ones, so that their draws stay on this thread
+    for(GLsizei i = 0; i < n; ++i) {
+        if(!buffers[i]) {
+            continue;
+        }
+        if(mArrayBuffer == buffers[i]) {
+            mArrayBuffer = 0;
+        }
+        if(mVertexArray->elementArrayBuffer == buffers[i]) {
+            mVertexArray->elementArrayBuffer = 0;
+        }
+        for(GLuint index = 0; index < GLOVE_MAX_VERTEX_ATTRIBS; ++index) {
+            if(mVertexArray->buffers[index] == buffers[i]) {
+                mVertexArray->buffers[index] = 0;
+                mVertexArray->clientArrays  |= 1u << index;
+            }
+        }
+    }
+}
+
+void
+GLThread::EnableVertexAttribArray(GLuint index, bool enable)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(index >= GLOVE_MAX_VERTEX_ATTRIBS) {
+        return;
+    }
+
+    if(enable) {
+        mVertexArray->enabledArrays |=  (1u << index);
+    } else {
+        mVertexArray->enabledArrays &= ~(1u << index);
+    }
+}
+
+void
+GLThread::VertexAttribPointer(GLuint index)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(index >= GLOVE_MAX_VERTEX_ATTRIBS) {
+        return;
+    }
+
+    mVertexArray->buffers[index] = mArrayBuffer;
+    if(mArrayBuffer) {
+        mVertexArray->clientArrays &= ~(1u << index);
+    } else {
+        mVertexArray->clientArrays |=  (1u << index);
+    }
+}
+
+void
+GLThread::BindVertexArray(GLuint array)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    auto it = mVertexArrays.find(array);
+    if(it == mVertexArrays.end()) {
+        it = mVertexArrays.insert(std::make_pair(array, vertexArrayState_t())).first;
+        memset(static_cast<void *>(&it->second), 0, sizeof(vertexArrayState_t));
+    }
+    mVertexArray = &it->second;
+}
+
+void
+GLThread::DeleteVertexArrays(GLsizei n, const GLuint *arrays)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(n <= 0 || !arrays) {
+        return;
+    }
+
+    for(GLsizei i = 0; i < n; ++i) {
+        auto it = mVertexArrays.find(arrays[i]);
+        if(!arrays[i] || it == mVertexArrays.end()) {
+            continue;
+        }
+
+        // deleting the bound vertex array binds the default one
+        if(mVertexArray == &it->second) {
+            mVertexArray = &mVertexArrays[0];
+        }
+        mVertexArrays.erase(it);
+    }
+}
@@ -0,0 +1,163 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       glThread.h
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Execution of the GL calls of a context on a worker thread
+ *
+ */
+
+#ifndef __GLTHREAD_H__
+#define __GLTHREAD_H__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <new>
+#include <thread>
+#include "GLES2/gl2.h"
+#include "utils/globals.h"
+
+/// runs the GL calls of each context on a worker thread of its own when set to a non-zero value
+#define GLOVE_GLTHREAD_ENV                              "GLOVE_GLTHREAD"
+
+/// the calls are handed to the worker in batches of this size, once full or when the application waits for it
+#ifndef GLOVE_GLTHREAD_BATCH_SIZE
+#define GLOVE_GLTHREAD_BATCH_SIZE                       (16 << 10)
+#endif // GLOVE_GLTHREAD_BATCH_SIZE
+
+/// batches recorded ahead of the worker, before the application waits for it
+#ifndef GLOVE_GLTHREAD_BATCH_COUNT
+#define GLOVE_GLTHREAD_BATCH_COUNT                      16
+#endif // GLOVE_GLTHREAD_BATCH_COUNT
+
+/// client memory larger than this is not copied, the call waits for the worker and runs on the calling thread instead
+#ifndef GLOVE_GLTHREAD_MAX_PAYLOAD
+#define GLOVE_GLTHREAD_MAX_PAYLOAD                      (4 << 10)
+#endif // GLOVE_GLTHREAD_MAX_PAYLOAD
+
+class Context;
+
+class GLThread {
+private:
+    typedef void (*execute_t)(Context *context, void *command);
+
+    /// followed by the recorded call and the copy of its client memory
+    typedef struct command_t {
+        execute_t                       execute;
+        uint32_t                        size;
+        bool                            payload;
+    } command_t;
+
+    typedef struct batch_t {
+        uint8_t                        *data;
+        size_t                          used;
+    } batch_t;
+
+    /// what the draws read from, as far as it tells the ones that read client memory apart
+    typedef struct vertexArrayState_t {
+        GLuint                          elementArrayBuffer;
+        uint32_t                        enabledArrays;
+        uint32_t                        clientArrays;
+        GLuint                          buffers[GLOVE_MAX_VERTEX_ATTRIBS];
+    } vertexArrayState_t;
+
+    static const size_t                 ALIGNMENT = alignof(std::max_align_t);
+
+    Context                            *mContext;
+    batch_t                             mBatches[GLOVE_GLTHREAD_BATCH_COUNT];
+    /// batches handed to the worker and batches it has run, the one after the submitted is recorded
+    std::atomic<uint32_t>               mSubmitted;
+    std::atomic<uint32_t>               mExecuted;
+
+    std::thread                         mWorker;
+    std::mutex                          mMutex;
+    std::condition_variable             mBatchSubmitted;
+    std::condition_variable             mBatchExecuted;
+    bool                                mTerminate;
+
+    GLuint                              mArrayBuffer;
+    std::map<GLuint, vertexArrayState_t> mVertexArrays;
+    vertexArrayState_t                 *mVertexArray;
+
+    static inline size_t                Align(size_t size)  { return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1); }
+
+    template<typename F>
+    static void                         Execute(Context *context, void *command)
+    {
+        command_t *header   = static_cast<command_t *>(command);
+        F         *function = reinterpret_cast<F *>(static_cast<uint8_t *>(command) + Align(sizeof(command_t)));
+        (*function)(context, header->payload ? reinterpret_cast<const uint8_t *>(function) + Align(sizeof(F)) : nullptr);
+        function->~F();
+    }
+
+    void                                Run(void);
+    void                                Submit(void);
+    uint8_t                            *Allocate(size_t size);
+
+public:
+// Constructor
+    explicit GLThread(Context *context);
+
+// Destructor
+    ~GLThread();
+
+// Enqueue Functions
+    /// records function, called with the context and the copy of payload once the worker reaches it
+    template<typename F>
+    void                                Enqueue(F function, const void *payload = nullptr, size_t payloadSize = 0)
+    {
+        static_assert(alignof(F) <= ALIGNMENT, "recorded calls are aligned to the fundamental alignment");
+
+        const size_t size    = Align(sizeof(command_t)) + Align(sizeof(F)) + Align(payloadSize);
+        uint8_t     *command = Allocate(size);
+
+        command_t *header = reinterpret_cast<command_t *>(command);
+        header->execute   = &Execute<F>;
+        header->size      = static_cast<uint32_t>(size);
+        header->payload   = payload != nullptr;
+
+        new (command + Align(sizeof(command_t))) F(function);
+        if(payloadSize) {
+            memcpy(command + Align(sizeof(command_t)) + Align(sizeof(F)), payload, payloadSize);
+        }
+    }
+
+    static inline bool                  FitsPayload(size_t size)  { return size <= GLOVE_GLTHREAD_MAX_PAYLOAD; }
+
+// Sync Functions
+    /// hands the recorded calls over and blocks until the worker has run them
+    void                                Sync(void);
+
+// State Functions
+    /// the state the draws read from, followed on the calling thread
+    void                                BindBuffer(GLenum target, GLuint buffer);
+    void                                DeleteBuffers(GLsizei n, const GLuint *buffers);
+    void                                EnableVertexAttribArray(GLuint index, bool enable);
+    void                                VertexAttribPointer(GLuint index);
+    void                                BindVertexArray(GLuint array);
+    void                                DeleteVertexArrays(GLsizei n, const GLuint *arrays);
+
+    /// draws that read client arrays or indices copy them at the call, so they run on the calling thread
+    inline bool                         DrawsFromBuffers(bool indexed) const  { return !(mVertexArray->enabledArrays & mVertexArray->clientArrays) &&
+                                                                                       (!indexed || mVertexArray->elementArrayBuffer); }
+};
+
+#endif // __GLTHREAD_H__
@@ -0,0 +1,288 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       glTracer.cpp
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Binary function traces, written in the Chrome trace format
+ *
+ *  @section
+ *
+ *  In TRACE_BINARY builds FUN_ENTRY registers its call site once and
+ *  records the start and duration of each call into a ring of the calling
+ *  thread, without formatting anything. Each ring has a single writer, its
+ *  thread, and a single reader, the flush thread, which periodically turns
+ *  the entries into complete events of a JSON array that chrome://tracing
+ *  and Perfetto load. Entries are dropped, rather than waited for, when a
+ *  ring is full.
+ *
+ *  The GPU scopes resolved from the timestamp queries are few and come from
+ *  the GL thread, so they are queued under the lock and go to a track of
+ *  their own.
+ *
+ */
+
+#include "glLogger.h"
+#include "glTracer.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+typedef struct Site {
+    glLogLevel_e                  level;
+    const char                   *file;
+    const char                   *func;
+    int                           line;
+} Site;
+
+typedef struct GpuEvent {
+    const char                   *name;
+    uint64_t                      start;
+    uint64_t                      end;
+} GpuEvent;
+
+typedef struct Ring {
+    GLTracer::Entry               entries[GLOVE_TRACE_RING_SIZE];
+    /// advanced by the thread of the ring
+    std::atomic<uint32_t>         head;
+    /// advanced by the flush thread
+    std::atomic<uint32_t>         tail;
+    std::atomic<uint32_t>         dropped;
+    uint32_t                      tid;
+} Ring;
+
+class TraceWriter {
+public:
+    std::mutex                    mMutex;
+    std::condition_variable       mCondition;
+    std::vector<Site>             mSites;
+    std::vector<Ring *>           mRings;
+    std::vector<GpuEvent>         mGpuEvents;
+    std::thread                   mThread;
+    glLogLevel_e                  mLevel;
+    FILE                         *mFile;
+    uint64_t                      mStart;
+    bool                          mStop;
+
+    TraceWriter();
+    ~TraceWriter();
+
+    void                          Flush(void);
+    void                          Run(void);
+};
+
+std::once_flag                    gWriterOnce;
+std::atomic<TraceWriter *>        gWriter(nullptr);
+std::atomic<bool>                 gShutdown(false);
+
+const char *
+GetLevelName(glLogLevel_e level)
+{
+    switch(level) {
+    case GL_LOG_TRACE:            return "trace";
+    case GL_LOG_DEBUG:            return "debug";
+    case GL_LOG_INFO:             return "info";
+    case GL_LOG_WARN:             return "warn";
+    case GL_LOG_ERROR:            return "error";
+    default:                      return "critical";
+    }
+}
+
+TraceWriter::TraceWriter()
+: mStart(GLTracer::Now()), mStop(false)
+{
+    const char *level = getenv(GLOVE_TRACE_LEVEL_ENV);
+    mLevel = level ? static_cast<glLogLevel_e>(atoi(level)) : GL_LOG_DEBUG;
+
+    const char *path = getenv(GLOVE_TRACE_FILE_ENV);
+    mFile = fopen(path ? path : "glove_trace.json", "w");
+    if(mFile) {
+        fprintf(mFile, "[\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,\"args\":{\"name\":\"GPU\"}},\n", static_cast<int>(getpid()));
+        mThread = std::thread(&TraceWriter::Run, this);
+    }
+}
+
+TraceWriter::~TraceWriter()
+{
+    if(mThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStop = true;
+        }
+        mCondition.notify_one();
+        mThread.join();
+    }
+
+    if(mFile) {
+        Flush();
+        fprintf(mFile, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"GLOVE\"}}\n]\n", static_cast<int>(getpid()));
+        fclose(mFile);
+    }
+
+    for(Ring *ring : mRings) {
+        delete ring;
+    }
+}
+
+void
+TraceWriter::Flush(void)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    const int pid = static_cast<int>(getpid());
+    for(const GpuEvent &event : mGpuEvents) {
+        fprintf(mFile, "{\"name\":\"%s\",\"cat\":\"gpu\",\"ph\":\"X\",\"pid\":%d,\"tid\":0,\"ts\":%.3f,\"dur\":%.3f},\n",
+                event.name, pid, static_cast<int64_t>(event.start - mStart) / 1000.0, (event.end - event.start) / 1000.0);
+    }
+    mGpuEvents.clear();
+
+    for(Ring *ring : mRings) {
+        uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+        uint32_t head = ring->head.load(std::memory_order_acquire);
+
+        for(; tail != head; ++tail) {
+            const GLTracer::Entry &entry = ring->entries[tail & (GLOVE_TRACE_RING_SIZE - 1)];
+            const Site &site = mSites[entry.site];
+            fprintf(mFile, "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"file\":\"%s\",\"line\":%d}},\n",
+                    site.func, GetLevelName(site.level), pid, ring->tid,
+                    (entry.start - mStart) / 1000.0, entry.duration / 1000.0, site.file, site.line);
+        }
+        ring->tail.store(tail, std::memory_order_release);
+
+        uint32_t dropped = ring->dropped.exchange(0, std::memory_order_relaxed);
+        if(dropped) {
+            fprintf(mFile, "{\"name\":\"dropped %u\",\"ph\":\"i\",\"s\":\"t\",\"pid\":%d,\"tid\":%u,\"ts\":%.3f},\n",
+                    dropped, pid, ring->tid, (GLTracer::Now() - mStart) / 1000.0);
+        }
+    }
+}
+
+void
+TraceWriter::Run(void)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    while(!mStop) {
+        mCondition.wait_for(lock, std::chrono::milliseconds(GLOVE_TRACE_FLUSH_INTERVAL_MS));
+
+        lock.unlock();
+        Flush();
+        fflush(mFile);
+        lock.lock();
+    }
+}
+
+TraceWriter *
+GetWriter(void)
+{
+    std::call_once(gWriterOnce, [] { gWriter.store(new TraceWriter(), std::memory_order_release); });
+    return gWriter.load(std::memory_order_acquire);
+}
+
+Ring *
+AddRing(void)
+{
+    TraceWriter *writer = GetWriter();
+    if(!writer) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(writer->mMutex);
+
+    Ring *ring = new Ring();
+    ring->head.store(0, std::memory_order_relaxed);
+    ring->tail.store(0, std::memory_order_relaxed);
+    ring->dropped.store(0, std::memory_order_relaxed);
+    ring->tid  = static_cast<uint32_t>(writer->mRings.size()) + 1;
+    writer->mRings.push_back(ring);
+
+    return ring;
+}
+
+}
+
+uint32_t
+GLTracer::RegisterSite(glLogLevel_e level, const char *file, const char *func, int line)
+{
+    TraceWriter *writer = GetWriter();
+    if(!writer || level < writer->mLevel || !writer->mFile) {
+        return NO_SITE;
+    }
+
+    std::lock_guard<std::mutex> lock(writer->mMutex);
+
+    Site site = { level, file, func, line };
+    writer->mSites.push_back(site);
+
+    return static_cast<uint32_t>(writer->mSites.size() - 1);
+}
+
+void
+GLTracer::Record(uint32_t site, uint64_t start, uint64_t end)
+{
+    if(gShutdown.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    static thread_local Ring *ring = nullptr;
+    if(!ring && !(ring = AddRing())) {
+        return;
+    }
+
+    uint32_t head = ring->head.load(std::memory_order_relaxed);
+    if(head - ring->tail.load(std::memory_order_acquire) >= GLOVE_TRACE_RING_SIZE) {
+        ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Entry &entry   = ring->entries[head & (GLOVE_TRACE_RING_SIZE - 1)];
+    entry.start    = start;
+    entry.duration = static_cast<uint32_t>(std::min<uint64_t>(end - start, UINT32_MAX));
+    entry.site     = site;
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+void
+GLTracer::RecordGpu(const char *name, uint64_t start, uint64_t end)
+{
+    TraceWriter *writer = gShutdown.load(std::memory_order_relaxed) ? nullptr : GetWriter();
+    if(!writer || !writer->mFile) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(writer->mMutex);
+
+    GpuEvent event = { name, start, end };
+    writer->mGpuEvents.push_back(event);
+}
+
+void
+GLTracer::Shutdown(void)
+{
+    // the rings are released with the writer, and are not recorded to afterwards
+    if(gShutdown.exchange(true)) {
+        return;
+    }
+
+    delete gWriter.exchange(nullptr);
+}
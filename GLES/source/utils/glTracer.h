@@ -0,0 +1,79 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       glTracer.h
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Binary function traces, written in the Chrome trace format
+ *
+ */
+
+#ifndef __GLTRACER_H__
+#define __GLTRACER_H__
+
+#include "glLoggerImpl.h"
+
+#include <stdint.h>
+#include <chrono>
+
+/// entries of the ring of each thread, a power of two
+#ifndef GLOVE_TRACE_RING_SIZE
+#define GLOVE_TRACE_RING_SIZE                           (1 << 16)
+#endif // GLOVE_TRACE_RING_SIZE
+
+/// period of the thread writing the rings out
+#ifndef GLOVE_TRACE_FLUSH_INTERVAL_MS
+#define GLOVE_TRACE_FLUSH_INTERVAL_MS                   50
+#endif // GLOVE_TRACE_FLUSH_INTERVAL_MS
+
+/// file the traces are written to, glove_trace.json when unset
+#define GLOVE_TRACE_FILE_ENV                            "GLOVE_TRACE_FILE"
+/// lowest level of the call sites traced, GL_LOG_DEBUG when unset
+#define GLOVE_TRACE_LEVEL_ENV                           "GLOVE_TRACE_LEVEL"
+
+class GLTracer {
+public:
+    enum { NO_SITE = UINT32_MAX };
+
+    /// a traced call, its times in ns
+    typedef struct Entry {
+        uint64_t                  start;
+        uint32_t                  duration;
+        uint32_t                  site;
+    } Entry;
+
+    /// records the call of its scope when it leaves it
+    class Scope {
+    private:
+        uint32_t                  mSite;
+        uint64_t                  mStart;
+
+    public:
+        explicit Scope(uint32_t site) : mSite(site), mStart(site != NO_SITE ? Now() : 0) { }
+        ~Scope()                  { if(mSite != NO_SITE) { Record(mSite, mStart, Now()); } }
+    };
+
+    /// call sites below the trace level get NO_SITE and are not recorded
+    static uint32_t               RegisterSite(glLogLevel_e level, const char *file, const char *func, int line);
+    static void                   Record(uint32_t site, uint64_t start, uint64_t end);
+    /// a scope executed by the GPU, placed on a track of its own
+    static void                   RecordGpu(const char *name, uint64_t start, uint64_t end);
+    static void                   Shutdown(void);
+
+    static inline uint64_t        Now(void)                                     { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+};
+
+#endif // __GLTRACER_H__
@@ -260,10 +260,26 @@ GlAttribTypeToElementSize(GLenum type)
         case GL_UNSIGNED_SHORT:                 return sizeof(GLushort);
         case GL_FIXED:                          return sizeof(GLfixed);
         case GL_FLOAT:                          return sizeof(GLfloat);
+        case GL_HALF_FLOAT_OES:                 return sizeof(uint16_t);
+        case GL_INT_10_10_10_2_OES:
+        case GL_UNSIGNED_INT_10_10_10_2_OES:    return sizeof(GLuint);
         default: { NOT_FOUND_ENUM(type);        return sizeof(GLubyte); }
     }
 }
 
+int32_t
+GlAttribTypeToVertexSize(GLint nElements, GLenum type)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the components of the packed types share a single value
+    if(type == GL_INT_10_10_10_2_OES || type == GL_UNSIGNED_INT_10_10_10_2_OES) {
+        return sizeof(GLuint);
+    }
+
+    return nElements * GlAttribTypeToElementSize(type);
+}
+
 int
 GlTypeToElementSize(GLenum type)
 {
@@ -718,5 +734,15 @@ OccupiedLocationsPerGlType(GLenum type)
 bool
 IsGlSampler(GLenum type)
 {
-    return (type == GL_SAMPLER_2D) || (type == GL_SAMPLER_CUBE);
+    return (type == GL_SAMPLER_2D) || (type == GL_SAMPLER_CUBE) || (type == GL_SAMPLER_3D_OES);
+}
+
+GLenum
+GlSamplerToGlTextureTarget(GLenum type)
+{
+    switch(type) {
+    case GL_SAMPLER_CUBE:               return GL_TEXTURE_CUBE_MAP;
+    case GL_SAMPLER_3D_OES:             return GL_TEXTURE_3D_OES;
+    default:                            return GL_TEXTURE_2D;
+    }
 }
@@ -44,6 +44,7 @@ GLenum                  GlInternalFormatToGlType(GLenum internalFormat);
 GLenum                  GlInternalFormatToGlFormat(GLenum internalFormat);
 int                     GlInternalFormatTypeToNumElements(GLenum format, GLenum type);
 int32_t                 GlAttribTypeToElementSize(GLenum type);
+int32_t                 GlAttribTypeToVertexSize(GLint nElements, GLenum type);
 int                     GlTypeToElementSize(GLenum type);
 void                    GlFormatToStorageBits(GLenum format, GLint     *r_, GLint     *g_, GLint     *b_, GLint     *a_, GLint     *d_, GLint     *s_);
 void                    GlFormatToStorageBits(GLenum format, GLfloat   *r_, GLfloat   *g_, GLfloat   *b_, GLfloat   *a_, GLfloat   *d_, GLfloat   *s_);
@@ -53,4 +54,5 @@ bool                    GlFormatIsStencilRenderable(GLenum format);
 bool                    GlFormatIsColorRenderable(GLenum format);
 uint32_t                OccupiedLocationsPerGlType(GLenum type);
 bool                    IsGlSampler(GLenum type);
+GLenum                  GlSamplerToGlTextureTarget(GLenum type);
 #endif // __GLUTILS_H__
@@ -68,6 +68,7 @@
 
 #define GLOVE_MAX_TEXTURE_SIZE                          4096
 #define GLOVE_MAX_CUBE_MAP_TEXTURE_SIZE                 4096
+#define GLOVE_MAX_3D_TEXTURE_SIZE                       256   // MIN VALUE of maxImageDimension3D
 #define GLOVE_MAX_RENDERBUFFER_SIZE                     4096
 
 #define GLOVE_NUM_SHADER_BINARY_FORMATS                 0
@@ -87,9 +88,32 @@
 #define GLOVE_DUMP_ORIGINAL_SHADER_SOURCE               false
 #define GLOVE_DUMP_PROCESSED_SHADER_SOURCE              false
 #define GLOVE_DUMP_SPIRV_SHADER_SOURCE                  false
+#define GLOVE_DUMP_DRAW_STATISTICS                      false
+#define GLOVE_DUMP_PIPELINE_STATISTICS                  false
+#define GLOVE_DUMP_MEMORY_STATISTICS                    false
+
+#define GLOVE_RECORD_DRAWS_TO_SECONDARY_CMD_BUFFERS     false
 
 #define GLOVE_INVALID_OFFSET                            UINT32_MAX
 
+/// Budget of default block uniforms that are passed as push constants (the minimum maxPushConstantsSize in Vulkan)
+#define GLOVE_MAX_PUSH_CONSTANTS_SIZE                   128
+
+/// Descriptors that may be pushed in a set with VK_KHR_push_descriptor (the minimum maxPushDescriptors)
+#define GLOVE_MAX_PUSH_DESCRIPTORS                      32
+
 #define GLOVE_VULKAN_DEPTH_RANGE                        vulkan_DepthRange
 
+/// Specialization constant that scales gl_Position.y in the vertex shaders, -1.0 on Y inverted surfaces
+#define GLOVE_SPEC_CONSTANT_Y_SCALE_ID                  0
+
+/// Uniforms named in '#pragma glove_specialize(...)' are specialization constants with ids
+/// from here on, one per word of the push constant block that also holds them
+#define GLOVE_SPEC_CONSTANT_UNIFORM_BASE_ID             1
+#define GLOVE_SPECIALIZE_PRAGMA                         "glove_specialize"
+
+/// Specialization constants with the cosine and the sine of the rotation of gl_Position onto pre-rotated
+/// window surfaces, after the ids the specialized uniforms can take
+#define GLOVE_SPEC_CONSTANT_ROTATION_ID                 (GLOVE_SPEC_CONSTANT_UNIFORM_BASE_ID + GLOVE_MAX_PUSH_CONSTANTS_SIZE / 4)
+
 #endif // __GLOBALS_H__
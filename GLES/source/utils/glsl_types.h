@@ -99,7 +99,8 @@ inline size_t GlslTypeToAllignment(GLenum type)
     case GL_FLOAT_MAT4:                     return 64;
 
     case GL_SAMPLER_2D:
-    case GL_SAMPLER_CUBE:                   return 16;
+    case GL_SAMPLER_CUBE:
+    case GL_SAMPLER_3D_OES:                 return 16;
     default:                                return 0;
     }
 }
@@ -130,7 +131,8 @@ inline size_t GlslTypeToSize(GLenum type)
     case GL_FLOAT_MAT4:                     return sizeof(glsl_mat4_t);
 
     case GL_SAMPLER_2D:
-    case GL_SAMPLER_CUBE:                   return sizeof(glsl_sampler_t);
+    case GL_SAMPLER_CUBE:
+    case GL_SAMPLER_3D_OES:                 return sizeof(glsl_sampler_t);
     default:                                return 0;
     }
 }
@@ -0,0 +1,212 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       indexUtils.cpp
+ *  @author     Think Silicon
+ *  @date       14/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Index Buffer Scanning and Conversion Functions
+ *
+ *  @section
+ *
+ *  Index data that have to be inspected or converted on the host, such as
+ *  client-side indices, are processed 16 bytes at a time with SSE2 or NEON,
+ *  whichever the target supports, with a scalar loop for the remainder and
+ *  for the targets with neither.
+ *
+ */
+
+#include "indexUtils.h"
+#include "glLogger.h"
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#   define GLOVE_INDEX_SSE2
+#   include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#   define GLOVE_INDEX_NEON
+#   include <arm_neon.h>
+#endif
+
+template<typename T>
+static T
+ScalarMax(const T *indices, size_t indexCount, T maxIndex)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    for(size_t i = 0; i < indexCount; ++i) {
+        if(maxIndex < indices[i]) {
+            maxIndex = indices[i];
+        }
+    }
+
+    return maxIndex;
+}
+
+static uint32_t
+IndexBufferMaxU8(const uint8_t *indices, size_t indexCount)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    size_t i = 0;
+    uint8_t maxIndex = 0;
+
+#if defined(GLOVE_INDEX_SSE2)
+    if(indexCount >= 16) {
+        __m128i vmax = _mm_setzero_si128();
+        for(; i + 16 <= indexCount; i += 16) {
+            vmax = _mm_max_epu8(vmax, _mm_loadu_si128(reinterpret_cast<const __m128i *>(indices + i)));
+        }
+        uint8_t lanes[16];
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), vmax);
+        maxIndex = ScalarMax<uint8_t>(lanes, 16, maxIndex);
+    }
+#elif defined(GLOVE_INDEX_NEON)
+    if(indexCount >= 16) {
+        uint8x16_t vmax = vdupq_n_u8(0);
+        for(; i + 16 <= indexCount; i += 16) {
+            vmax = vmaxq_u8(vmax, vld1q_u8(indices + i));
+        }
+        uint8_t lanes[16];
+        vst1q_u8(lanes, vmax);
+        maxIndex = ScalarMax<uint8_t>(lanes, 16, maxIndex);
+    }
+#endif
+
+    return ScalarMax<uint8_t>(indices + i, indexCount - i, maxIndex);
+}
+
+static uint32_t
+IndexBufferMaxU16(const uint16_t *indices, size_t indexCount)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    size_t i = 0;
+    uint16_t maxIndex = 0;
+
+#if defined(GLOVE_INDEX_SSE2)
+    // SSE2 only has a signed 16-bit max, so the values are biased into the signed range
+    if(indexCount >= 8) {
+        const __m128i bias = _mm_set1_epi16(static_cast<int16_t>(0x8000));
+        __m128i vmax = _mm_set1_epi16(static_cast<int16_t>(0x8000));
+        for(; i + 8 <= indexCount; i += 8) {
+            __m128i v = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(indices + i)), bias);
+            vmax = _mm_max_epi16(vmax, v);
+        }
+        uint16_t lanes[8];
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), _mm_xor_si128(vmax, bias));
+        maxIndex = ScalarMax<uint16_t>(lanes, 8, maxIndex);
+    }
+#elif defined(GLOVE_INDEX_NEON)
+    if(indexCount >= 8) {
+        uint16x8_t vmax = vdupq_n_u16(0);
+        for(; i + 8 <= indexCount; i += 8) {
+            vmax = vmaxq_u16(vmax, vld1q_u16(indices + i));
+        }
+        uint16_t lanes[8];
+        vst1q_u16(lanes, vmax);
+        maxIndex = ScalarMax<uint16_t>(lanes, 8, maxIndex);
+    }
+#endif
+
+    return ScalarMax<uint16_t>(indices + i, indexCount - i, maxIndex);
+}
+
+static uint32_t
+IndexBufferMaxU32(const uint32_t *indices, size_t indexCount)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    size_t i = 0;
+    uint32_t maxIndex = 0;
+
+#if defined(GLOVE_INDEX_SSE2)
+    // SSE2 has neither an unsigned compare nor a 32-bit max, so biased values are compared and selected
+    if(indexCount >= 4) {
+        const __m128i bias = _mm_set1_epi32(static_cast<int32_t>(0x80000000));
+        __m128i vmax = bias;
+        for(; i + 4 <= indexCount; i += 4) {
+            __m128i v    = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(indices + i)), bias);
+            __m128i gt   = _mm_cmpgt_epi32(v, vmax);
+            vmax = _mm_or_si128(_mm_and_si128(gt, v), _mm_andnot_si128(gt, vmax));
+        }
+        uint32_t lanes[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), _mm_xor_si128(vmax, bias));
+        maxIndex = ScalarMax<uint32_t>(lanes, 4, maxIndex);
+    }
+#elif defined(GLOVE_INDEX_NEON)
+    if(indexCount >= 4) {
+        uint32x4_t vmax = vdupq_n_u32(0);
+        for(; i + 4 <= indexCount; i += 4) {
+            vmax = vmaxq_u32(vmax, vld1q_u32(indices + i));
+        }
+        uint32_t lanes[4];
+        vst1q_u32(lanes, vmax);
+        maxIndex = ScalarMax<uint32_t>(lanes, 4, maxIndex);
+    }
+#endif
+
+    return ScalarMax<uint32_t>(indices + i, indexCount - i, maxIndex);
+}
+
+uint32_t
+IndexBufferMax(const void *indices, size_t indexCount, size_t elementByteSize)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    switch(elementByteSize) {
+    case sizeof(uint8_t):  return IndexBufferMaxU8 (static_cast<const uint8_t  *>(indices), indexCount);
+    case sizeof(uint16_t): return IndexBufferMaxU16(static_cast<const uint16_t *>(indices), indexCount);
+    default:               return IndexBufferMaxU32(static_cast<const uint32_t *>(indices), indexCount);
+    }
+}
+
+void
+IndexBufferWidenU8ToU16(const void *srcIndices, void *dstIndices, size_t indexCount)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    const uint8_t *src = static_cast<const uint8_t *>(srcIndices);
+    uint16_t      *dst = static_cast<uint16_t *>(dstIndices);
+    size_t i = 0;
+
+#if defined(GLOVE_INDEX_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for(; i + 16 <= indexCount; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),     _mm_unpacklo_epi8(v, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i + 8), _mm_unpackhi_epi8(v, zero));
+    }
+#elif defined(GLOVE_INDEX_NEON)
+    for(; i + 16 <= indexCount; i += 16) {
+        uint8x16_t v = vld1q_u8(src + i);
+        vst1q_u16(dst + i,     vmovl_u8(vget_low_u8(v)));
+        vst1q_u16(dst + i + 8, vmovl_u8(vget_high_u8(v)));
+    }
+#endif
+
+    for(; i < indexCount; ++i) {
+        dst[i] = static_cast<uint16_t>(src[i]);
+    }
+}
+
+void
+IndexBufferCloseLineLoop(void *indices, size_t indexCount, size_t elementByteSize)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the last index repeats the first one, closing the loop with a line strip
+    memcpy(static_cast<uint8_t *>(indices) + (indexCount - 1) * elementByteSize, indices, elementByteSize);
+}
@@ -0,0 +1,34 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       indexUtils.h
+ *  @author     Think Silicon
+ *  @date       14/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Index Buffer Scanning and Conversion Functions
+ *
+ */
+
+#ifndef __INDEXUTILS_H__
+#define __INDEXUTILS_H__
+
+#include <cstddef>
+#include <stdint.h>
+
+uint32_t                IndexBufferMax(const void *indices, size_t indexCount, size_t elementByteSize);
+void                    IndexBufferWidenU8ToU16(const void *srcIndices, void *dstIndices, size_t indexCount);
+void                    IndexBufferCloseLineLoop(void *indices, size_t indexCount, size_t elementByteSize);
+
+#endif // __INDEXUTILS_H__
@@ -0,0 +1,266 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       jobSystem.cpp
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Work-stealing pool of the background jobs of GLOVE
+ *
+ *  @section
+ *
+ *  The shader compiler, the pipeline compiler, the upload worker and the
+ *  transcoding of compressed textures run their jobs on one pool, instead
+ *  of threads of their own. Each worker takes the newest job of its own
+ *  queue, and steals the oldest job of the others once its queue is empty.
+ *  Jobs from outside the pool are spread over the queues in turn. Workers
+ *  without jobs sleep until one is submitted. The subsystems whose jobs
+ *  have to run in order keep their own queue and have a single job of the
+ *  pool drain it, so that they take a worker only while they have work.
+ *  A job never waits for another one, apart from ParallelFor, which runs
+ *  queued jobs while it waits, so that a small pool cannot deadlock.
+ *
+ */
+
+#include "jobSystem.h"
+#include <algorithm>
+#include <cstdlib>
+#if defined(__linux__)
+#include <sched.h>
+#endif // __linux__
+
+std::mutex  JobSystem::mInstanceMutex;
+JobSystem  *JobSystem::mInstance = nullptr;
+
+static thread_local int32_t workerIndex = -1;
+
+JobSystem::JobSystem()
+: mPending(0), mNextWorker(0), mTerminate(false)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    uint32_t workers = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    const char *workersEnv = getenv(GLOVE_JOB_WORKERS_ENV);
+    if(workersEnv && strtoul(workersEnv, nullptr, 10)) {
+        workers = static_cast<uint32_t>(strtoul(workersEnv, nullptr, 10));
+    }
+    workers = std::min(workers, static_cast<uint32_t>(GLOVE_JOB_MAX_WORKERS));
+
+    // e.g. "4-7" or "0,2,4-5"
+    const char *affinity = getenv(GLOVE_JOB_AFFINITY_ENV);
+    while(affinity && *affinity) {
+        char *end;
+        uint32_t first = static_cast<uint32_t>(strtoul(affinity, &end, 10));
+        uint32_t last  = first;
+        if(end == affinity) {
+            break;
+        }
+        if(*end == '-') {
+            affinity = end + 1;
+            last     = static_cast<uint32_t>(strtoul(affinity, &end, 10));
+        }
+        for(uint32_t core = first; core <= last && core < 1024; ++core) {
+            mAffinity.push_back(core);
+        }
+        affinity = *end == ',' ? end + 1 : end;
+    }
+
+    mWorkers.resize(workers);
+    for(uint32_t i = 0; i < workers; ++i) {
+        mWorkers[i] = new worker_t;
+    }
+    for(uint32_t i = 0; i < workers; ++i) {
+        mWorkers[i]->thread = std::thread(&JobSystem::Run, this, i);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    {
+        std::lock_guard<std::mutex> lock(mSleepMutex);
+        mTerminate = true;
+    }
+    mJobAvailable.notify_all();
+
+    // the workers leave once the queues are empty
+    for(worker_t *worker : mWorkers) {
+        worker->thread.join();
+    }
+    for(worker_t *worker : mWorkers) {
+        delete worker;
+    }
+}
+
+JobSystem *
+JobSystem::GetInstance(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    std::lock_guard<std::mutex> lock(mInstanceMutex);
+    if(!mInstance) {
+        mInstance = new JobSystem();
+    }
+    return mInstance;
+}
+
+void
+JobSystem::Terminate(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    std::lock_guard<std::mutex> lock(mInstanceMutex);
+    delete mInstance;
+    mInstance = nullptr;
+}
+
+void
+JobSystem::SetAffinity(void) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+#if defined(__linux__)
+    if(mAffinity.empty()) {
+        return;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for(uint32_t core : mAffinity) {
+        if(core < CPU_SETSIZE) {
+            CPU_SET(core, &set);
+        }
+    }
+
+    // sched_setaffinity applies to the calling thread and is available to bionic as well
+    if(sched_setaffinity(0, sizeof(set), &set)) {
+        GLOVE_PRINT_ERR("GLOVE_JOB_AFFINITY names no core of this system\n");
+    }
+#endif // __linux__
+}
+
+void
+JobSystem::Submit(const job_t &job)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // without workers the job runs right away
+    if(mWorkers.empty()) {
+        job();
+        return;
+    }
+
+    const uint32_t index = workerIndex >= 0 ? static_cast<uint32_t>(workerIndex) : mNextWorker++ % GetWorkerCount();
+    {
+        std::lock_guard<std::mutex> lock(mWorkers[index]->mutex);
+        mWorkers[index]->jobs.push_back(job);
+    }
+    ++mPending;
+
+    {
+        std::lock_guard<std::mutex> lock(mSleepMutex);
+    }
+    mJobAvailable.notify_one();
+}
+
+bool
+JobSystem::Pop(int32_t index, job_t &job)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(!mPending.load()) {
+        return false;
+    }
+
+    if(index >= 0) {
+        worker_t *worker = mWorkers[index];
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        if(!worker->jobs.empty()) {
+            job = std::move(worker->jobs.back());
+            worker->jobs.pop_back();
+            --mPending;
+            return true;
+        }
+    }
+
+    // the others, or all of them from outside the pool, are stolen from
+    const uint32_t count = GetWorkerCount();
+    const uint32_t first = index >= 0 ? static_cast<uint32_t>(index) + 1 : 0;
+    for(uint32_t i = 0; i < count; ++i) {
+        worker_t *victim = mWorkers[(first + i) % count];
+        std::lock_guard<std::mutex> lock(victim->mutex);
+        if(!victim->jobs.empty()) {
+            job = std::move(victim->jobs.front());
+            victim->jobs.pop_front();
+            --mPending;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void
+JobSystem::Run(uint32_t index)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    workerIndex = static_cast<int32_t>(index);
+    SetAffinity();
+
+    for(;;) {
+        job_t job;
+        if(Pop(workerIndex, job)) {
+            job();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mSleepMutex);
+        mJobAvailable.wait(lock, [this] { return mTerminate || mPending.load(); });
+        if(mTerminate && !mPending.load()) {
+            return;
+        }
+    }
+}
+
+void
+JobSystem::ParallelFor(uint32_t count, const std::function<void(uint32_t)> &function)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!count) {
+        return;
+    }
+
+    std::atomic<uint32_t> remaining(count - 1);
+    for(uint32_t i = 0; i + 1 < count; ++i) {
+        Submit([&function, &remaining, i] {
+            function(i);
+            --remaining;
+        });
+    }
+    function(count - 1);
+
+    // the calling thread helps with whatever is queued rather than sleeping on the workers
+    while(remaining.load()) {
+        job_t job;
+        if(Pop(workerIndex, job)) {
+            job();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
@@ -0,0 +1,93 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       jobSystem.h
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Work-stealing pool of the background jobs of GLOVE
+ *
+ */
+
+#ifndef __JOBSYSTEM_H__
+#define __JOBSYSTEM_H__
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <stdint.h>
+#include "utils/glLogger.h"
+
+/// number of workers, by default one less than the cores, so that the GL thread keeps one
+#define GLOVE_JOB_WORKERS_ENV                           "GLOVE_JOB_WORKERS"
+
+/// cores the workers are pinned to, as a list of cores and ranges, e.g. "4-7" for the big cores of a big.LITTLE SoC
+#define GLOVE_JOB_AFFINITY_ENV                          "GLOVE_JOB_AFFINITY"
+
+#ifndef GLOVE_JOB_MAX_WORKERS
+#define GLOVE_JOB_MAX_WORKERS                           8
+#endif // GLOVE_JOB_MAX_WORKERS
+
+class JobSystem {
+
+public:
+    typedef std::function<void(void)>   job_t;
+
+private:
+    typedef struct worker_t {
+        std::thread                     thread;
+        std::mutex                      mutex;
+        std::deque<job_t>               jobs;
+    } worker_t;
+
+    std::vector<worker_t *>             mWorkers;
+    /// jobs queued and not yet taken by any worker
+    std::atomic<uint32_t>               mPending;
+    /// queue that the next job from outside the pool goes to
+    std::atomic<uint32_t>               mNextWorker;
+    std::mutex                          mSleepMutex;
+    std::condition_variable             mJobAvailable;
+    bool                                mTerminate;
+    std::vector<uint32_t>               mAffinity;
+
+    static std::mutex                   mInstanceMutex;
+    static JobSystem                   *mInstance;
+
+    void                                Run(uint32_t index);
+    bool                                Pop(int32_t index, job_t &job);
+    void                                SetAffinity(void) const;
+
+    JobSystem();
+    ~JobSystem();
+
+public:
+    /// the pool of the process, started with its first job
+    static JobSystem                   *GetInstance(void);
+    /// runs the queued jobs and stops the workers, a later job starts them again
+    static void                         Terminate(void);
+
+    inline uint32_t                     GetWorkerCount(void) const              { FUN_ENTRY(GL_LOG_TRACE); return static_cast<uint32_t>(mWorkers.size()); }
+
+// Submit Functions
+    void                                Submit(const job_t &job);
+    /// runs function for each index below count across the workers and the calling thread, returns once all have run
+    void                                ParallelFor(uint32_t count, const std::function<void(uint32_t)> &function);
+};
+
+#endif // __JOBSYSTEM_H__
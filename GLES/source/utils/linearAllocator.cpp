@@ -0,0 +1,148 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       linearAllocator.cpp
+ *  @author     Think Silicon
+ *  @date       14/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Bump allocator for transient host memory, owned by a context and trimmed per frame
+ *
+ *  @section
+ *
+ *  Scratch copies made while recording a draw or an upload live only until the
+ *  call returns, so they are carved out of chunks owned by the context instead
+ *  of the heap. Callers open a LinearAllocatorScope, which gives the memory
+ *  back when it closes. At a frame boundary the allocator is reset: if the
+ *  frame spilled over more than one chunk, they are replaced by a single chunk
+ *  large enough for the peak of the frame, so steady state frames never reach
+ *  malloc. Each context owns its allocator, so no locking is needed.
+ *
+ */
+
+#include "linearAllocator.h"
+#include "glLogger.h"
+#include <algorithm>
+#include <new>
+
+LinearAllocator::LinearAllocator()
+: mChunk(0), mOffset(0), mPeakSize(0), mUsedSize(0)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+}
+
+LinearAllocator::~LinearAllocator()
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    for(auto &chunk : mChunks) {
+        delete[] chunk.data;
+    }
+    mChunks.clear();
+}
+
+bool
+LinearAllocator::AddChunk(size_t size)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    chunk_t chunk;
+    chunk.size = std::max(size, static_cast<size_t>(GLOVE_FRAME_ARENA_CHUNK_SIZE));
+    chunk.data = new (std::nothrow) uint8_t[chunk.size];
+    if(!chunk.data) {
+        return false;
+    }
+
+    mChunks.push_back(chunk);
+    return true;
+}
+
+void *
+LinearAllocator::Allocate(size_t size, size_t alignment)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(!size) {
+        size = 1;
+    }
+
+    // the chunks after the current one are only reused when they are large enough,
+    // otherwise the request goes into a new chunk appended at the end
+    while(true) {
+        if(mChunk < mChunks.size()) {
+            uint8_t  *base    = mChunks[mChunk].data;
+            uintptr_t address = reinterpret_cast<uintptr_t>(base + mOffset);
+            size_t    padding = static_cast<size_t>((alignment - address % alignment) % alignment);
+            if(mOffset + padding + size <= mChunks[mChunk].size) {
+                uint8_t *data = base + mOffset + padding;
+                mOffset      += padding + size;
+                mUsedSize    += padding + size;
+                mPeakSize     = std::max(mPeakSize, mUsedSize);
+                return data;
+            }
+
+            if(mChunk + 1 < mChunks.size()) {
+                mChunk  += 1;
+                mOffset  = 0;
+                continue;
+            }
+        }
+
+        if(!AddChunk(size + alignment)) {
+            return nullptr;
+        }
+        mChunk  = mChunks.size() - 1;
+        mOffset = 0;
+    }
+}
+
+void
+LinearAllocator::Rewind(const marker_t &marker)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // bytes skipped at the end of the chunks left behind are not tracked,
+    // so the used size is recounted from the chunks before the marker
+    size_t usedSize = marker.offset;
+    for(size_t i = 0; i < marker.chunk && i < mChunks.size(); ++i) {
+        usedSize += mChunks[i].size;
+    }
+
+    mChunk    = marker.chunk;
+    mOffset   = marker.offset;
+    mUsedSize = std::min(usedSize, mUsedSize);
+}
+
+void
+LinearAllocator::Reset(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // a scope may still be open when a frame ends in the middle of a call
+    if(!IsEmpty()) {
+        return;
+    }
+
+    if(mChunks.size() > 1) {
+        size_t peakSize = mPeakSize;
+        for(auto &chunk : mChunks) {
+            delete[] chunk.data;
+        }
+        mChunks.clear();
+        AddChunk(peakSize + peakSize / 4);
+    }
+
+    mPeakSize = 0;
+    mUsedSize = 0;
+}
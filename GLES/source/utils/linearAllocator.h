@@ -0,0 +1,88 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       linearAllocator.h
+ *  @author     Think Silicon
+ *  @date       14/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Bump allocator for transient host memory, owned by a context and trimmed per frame
+ *
+ */
+
+#ifndef __LINEARALLOCATOR_H__
+#define __LINEARALLOCATOR_H__
+
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+#include "glLogger.h"
+
+#ifndef GLOVE_FRAME_ARENA_CHUNK_SIZE
+#define GLOVE_FRAME_ARENA_CHUNK_SIZE                    (256 << 10)
+#endif // GLOVE_FRAME_ARENA_CHUNK_SIZE
+
+class LinearAllocator {
+public:
+    /// position of the allocator, allocations made after it are released by Rewind
+    typedef struct marker_t {
+        size_t                          chunk;
+        size_t                          offset;
+    } marker_t;
+
+private:
+    typedef struct chunk_t {
+        uint8_t                        *data;
+        size_t                          size;
+    } chunk_t;
+
+    std::vector<chunk_t>                mChunks;
+    size_t                              mChunk;
+    size_t                              mOffset;
+    /// highest number of bytes held at once since the last reset
+    size_t                              mPeakSize;
+    size_t                              mUsedSize;
+
+    bool                                AddChunk(size_t size);
+
+public:
+    LinearAllocator();
+    ~LinearAllocator();
+
+// Allocate Functions
+    void                               *Allocate(size_t size, size_t alignment = 16);
+    template<typename T>
+    inline T                           *Allocate(size_t count)             { FUN_ENTRY(GL_LOG_TRACE); return static_cast<T *>(Allocate(count * sizeof(T), alignof(T) > 16 ? alignof(T) : 16)); }
+
+// Release Functions
+    void                                Rewind(const marker_t &marker);
+    void                                Reset(void);
+
+// Get Functions
+    inline marker_t                     GetMarker(void)              const { FUN_ENTRY(GL_LOG_TRACE); marker_t marker = { mChunk, mOffset }; return marker; }
+    inline bool                         IsEmpty(void)                const { FUN_ENTRY(GL_LOG_TRACE); return mChunk == 0 && mOffset == 0; }
+};
+
+/// rewinds the allocator to where it stood when the scope was opened
+class LinearAllocatorScope {
+private:
+    LinearAllocator                    *mAllocator;
+    LinearAllocator::marker_t           mMarker;
+
+public:
+    explicit LinearAllocatorScope(LinearAllocator *allocator) : mAllocator(allocator), mMarker(allocator->GetMarker()) { }
+    ~LinearAllocatorScope()                                                { mAllocator->Rewind(mMarker); }
+};
+
+#endif // __LINEARALLOCATOR_H__
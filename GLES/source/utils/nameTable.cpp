@@ -0,0 +1,48 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       nameTable.cpp
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Process wide table of interned attribute, uniform and block names
+ *
+ *  @section
+ *
+ *  Applications link hundreds of programs out of a handful of shaders, so
+ *  the same names show up in the resource interface of most of them, once
+ *  more for every element of a uniform array. Programs keep pointers into
+ *  this table instead of strings of their own, which keeps their interface
+ *  plain arrays of PODs. GLOVE has no share groups, so the table is shared
+ *  by all contexts, and names live as long as the process, much like the
+ *  program cache.
+ *
+ */
+
+#include "nameTable.h"
+
+std::mutex                      NameTable::mMutex;
+std::unordered_set<std::string> NameTable::mNames;
+
+const char *
+NameTable::Intern(const std::string &name)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    // the elements of an unordered_set are never moved, so their strings stay valid
+    return mNames.insert(name).first->c_str();
+}
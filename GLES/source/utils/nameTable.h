@@ -0,0 +1,42 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       nameTable.h
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Process wide table of interned attribute, uniform and block names
+ *
+ */
+
+#ifndef __NAMETABLE_H__
+#define __NAMETABLE_H__
+
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include "utils/glLogger.h"
+
+class NameTable {
+private:
+    static std::mutex                       mMutex;
+    static std::unordered_set<std::string>  mNames;
+
+public:
+    /// the returned string is shared by every program using the name and is never released
+    static const char                      *Intern(const std::string &name);
+};
+
+#endif // __NAMETABLE_H__
@@ -0,0 +1,216 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       objectPool.cpp
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Slab allocator with thread local free lists for the GL and Vulkan resource objects
+ *
+ *  @section
+ *
+ *  Textures, buffer objects and the Vulkan objects behind them are created and
+ *  destroyed all the time, e.g., for the client arrays of draws that do not fit
+ *  in the streaming ring. They are taken from size classes of slabs instead of
+ *  the heap, so the churn neither fragments it nor contends on malloc when
+ *  several contexts run in the process. Each thread keeps free lists of its
+ *  own and only reaches the shared depot, under a lock, when a size class runs
+ *  out or holds more than its share. The lists of a thread that exits go to
+ *  the depot as well. Slabs are never given back, since their objects may be
+ *  released by any thread.
+ *
+ */
+
+#include "objectPool.h"
+#include "glLogger.h"
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+#define OBJECT_POOL_CLASSES             (GLOVE_OBJECT_POOL_MAX_SIZE / GLOVE_OBJECT_POOL_GRANULARITY)
+
+namespace {
+
+/// a free object holds the link to the next one
+typedef struct block_t {
+    block_t                            *next;
+} block_t;
+
+typedef struct freeList_t {
+    block_t                            *head;
+    uint32_t                            count;
+} freeList_t;
+
+/// trivially destructible, so that it is still usable while the thread exits
+typedef struct threadCache_t {
+    freeList_t                          lists[OBJECT_POOL_CLASSES];
+    bool                                registered;
+    bool                                exited;
+} threadCache_t;
+
+std::mutex                              depotMutex;
+freeList_t                              depot[OBJECT_POOL_CLASSES];
+
+thread_local threadCache_t              threadCache;
+
+inline void
+PushList(freeList_t *list, block_t *block)
+{
+    block->next = list->head;
+    list->head  = block;
+    ++list->count;
+}
+
+inline block_t *
+PopList(freeList_t *list)
+{
+    block_t *block = list->head;
+    list->head     = block->next;
+    --list->count;
+    return block;
+}
+
+/// moves count objects from one list to the other
+void
+MoveList(freeList_t *dst, freeList_t *src, uint32_t count)
+{
+    while(count-- && src->head) {
+        PushList(dst, PopList(src));
+    }
+}
+
+/// hands the free objects of the thread to the depot as it exits
+class ThreadCacheFlusher {
+public:
+    ~ThreadCacheFlusher()
+    {
+        std::lock_guard<std::mutex> lock(depotMutex);
+        for(uint32_t i = 0; i < OBJECT_POOL_CLASSES; ++i) {
+            MoveList(&depot[i], &threadCache.lists[i], threadCache.lists[i].count);
+        }
+        threadCache.exited = true;
+    }
+};
+
+thread_local ThreadCacheFlusher         threadCacheFlusher;
+
+inline uint32_t
+SizeClass(size_t size)
+{
+    return static_cast<uint32_t>((size + GLOVE_OBJECT_POOL_GRANULARITY - 1) / GLOVE_OBJECT_POOL_GRANULARITY) - 1;
+}
+
+/// fills an empty list from the depot, or else from a new slab
+bool
+Refill(freeList_t *list, uint32_t sizeClass)
+{
+    {
+        std::lock_guard<std::mutex> lock(depotMutex);
+        MoveList(list, &depot[sizeClass], GLOVE_OBJECT_POOL_SLAB_OBJECTS);
+    }
+    if(list->head) {
+        return true;
+    }
+
+    const size_t blockSize = (sizeClass + 1) * GLOVE_OBJECT_POOL_GRANULARITY;
+    uint8_t *slab = static_cast<uint8_t *>(malloc(blockSize * GLOVE_OBJECT_POOL_SLAB_OBJECTS));
+    if(!slab) {
+        return false;
+    }
+
+    for(uint32_t i = GLOVE_OBJECT_POOL_SLAB_OBJECTS; i-- > 0;) {
+        PushList(list, reinterpret_cast<block_t *>(slab + i * blockSize));
+    }
+    return true;
+}
+
+}
+
+void *
+ObjectPool::Allocate(size_t size)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(!GLOVE_OBJECT_POOL || !size || size > GLOVE_OBJECT_POOL_MAX_SIZE) {
+        return ::operator new(size);
+    }
+
+    threadCache_t *cache = &threadCache;
+    if(!cache->registered) {
+        // constructs the flusher of the thread, which is then destroyed as it exits
+        (void)&threadCacheFlusher;
+        cache->registered = true;
+    }
+
+    const uint32_t sizeClass = SizeClass(size);
+    freeList_t *list = &cache->lists[sizeClass];
+
+    // an exiting thread has no list of its own anymore, its objects are taken from the depot
+    freeList_t exitList = { nullptr, 0 };
+    if(cache->exited) {
+        list = &exitList;
+    }
+
+    if(!list->head && !Refill(list, sizeClass)) {
+        throw std::bad_alloc();
+    }
+
+    void *ptr = PopList(list);
+
+    if(cache->exited && exitList.head) {
+        std::lock_guard<std::mutex> lock(depotMutex);
+        MoveList(&depot[sizeClass], &exitList, exitList.count);
+    }
+
+    return ptr;
+}
+
+void
+ObjectPool::Release(void *ptr, size_t size)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(!ptr) {
+        return;
+    }
+
+    if(!GLOVE_OBJECT_POOL || !size || size > GLOVE_OBJECT_POOL_MAX_SIZE) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    threadCache_t *cache = &threadCache;
+    const uint32_t sizeClass = SizeClass(size);
+
+    if(cache->exited) {
+        std::lock_guard<std::mutex> lock(depotMutex);
+        PushList(&depot[sizeClass], static_cast<block_t *>(ptr));
+        return;
+    }
+
+    if(!cache->registered) {
+        (void)&threadCacheFlusher;
+        cache->registered = true;
+    }
+
+    freeList_t *list = &cache->lists[sizeClass];
+    PushList(list, static_cast<block_t *>(ptr));
+
+    // objects created by one thread and released by another would otherwise pile up in the latter
+    if(list->count > GLOVE_OBJECT_POOL_THREAD_CACHE) {
+        std::lock_guard<std::mutex> lock(depotMutex);
+        MoveList(&depot[sizeClass], list, GLOVE_OBJECT_POOL_THREAD_CACHE / 2);
+    }
+}
@@ -0,0 +1,66 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       objectPool.h
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Slab allocator with thread local free lists for the GL and Vulkan resource objects
+ *
+ */
+
+#ifndef __OBJECTPOOL_H__
+#define __OBJECTPOOL_H__
+
+#include <cstddef>
+#include <stdint.h>
+
+#ifndef GLOVE_OBJECT_POOL
+#define GLOVE_OBJECT_POOL                               true
+#endif // GLOVE_OBJECT_POOL
+
+/// objects are pooled in size classes of this granularity, larger ones come from the heap
+#ifndef GLOVE_OBJECT_POOL_GRANULARITY
+#define GLOVE_OBJECT_POOL_GRANULARITY                   16
+#endif // GLOVE_OBJECT_POOL_GRANULARITY
+
+#ifndef GLOVE_OBJECT_POOL_MAX_SIZE
+#define GLOVE_OBJECT_POOL_MAX_SIZE                      2048
+#endif // GLOVE_OBJECT_POOL_MAX_SIZE
+
+/// objects carved out of a slab at once, when a size class runs out of free ones
+#ifndef GLOVE_OBJECT_POOL_SLAB_OBJECTS
+#define GLOVE_OBJECT_POOL_SLAB_OBJECTS                  32
+#endif // GLOVE_OBJECT_POOL_SLAB_OBJECTS
+
+/// free objects a thread keeps per size class, half of them go to the shared depot above that
+#ifndef GLOVE_OBJECT_POOL_THREAD_CACHE
+#define GLOVE_OBJECT_POOL_THREAD_CACHE                  256
+#endif // GLOVE_OBJECT_POOL_THREAD_CACHE
+
+class ObjectPool {
+public:
+    static void                        *Allocate(size_t size);
+    static void                         Release(void *ptr, size_t size);
+};
+
+/// classes derived from it are allocated from the object pool, including their subclasses
+class PooledObject {
+public:
+    static inline void                 *operator new(size_t size)              { return ObjectPool::Allocate(size); }
+    static inline void                  operator delete(void *ptr, size_t size) { ObjectPool::Release(ptr, size); }
+};
+
+#endif // __OBJECTPOOL_H__
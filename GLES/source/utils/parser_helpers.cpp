@@ -72,6 +72,25 @@ SkipWhiteSpaces(const std::string &source, std::string::size_type pos)
     return pos - 1;
 }
 
+string::size_type
+SkipWhiteSpacesAndComments(const std::string &source, std::string::size_type pos)
+{
+    while(pos < source.size()) {
+        if(IsWhiteSpace(source[pos]) || source[pos] == '\r') {
+            ++pos;
+        } else if(!source.compare(pos, 2, "//")) {
+            pos = source.find('\n', pos);
+        } else if(!source.compare(pos, 2, "/*")) {
+            pos = source.find("*/", pos + 2);
+            pos = pos == std::string::npos ? pos : pos + 2;
+        } else {
+            break;
+        }
+    }
+
+    return pos < source.size() ? pos : source.size();
+}
+
 string::size_type
 FindToken(const std::string &token, const std::string &source, std::string::size_type pos)
 {
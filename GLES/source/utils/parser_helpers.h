@@ -37,6 +37,7 @@ bool                    IsChar(char c);
 bool                    IsWhiteSpace(char c);
 bool                    IsBuildInUniform(const string &source);
 string::size_type       SkipWhiteSpaces(const string &source, string::size_type pos);
+string::size_type       SkipWhiteSpacesAndComments(const string &source, string::size_type pos);
 string::size_type       FindToken(const string &token, const string &source, string::size_type pos);
 std::string             GetNextToken(const string &source, string::size_type start);
 int32_t                 RemoveBrackets(std::string &source);
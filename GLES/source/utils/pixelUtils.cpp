@@ -0,0 +1,498 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       pixelUtils.cpp
+ *  @author     Think Silicon
+ *  @date       14/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Row Converters for the Common Pixel Format Pairs
+ *
+ *  @section
+ *
+ *  The format pairs met on every upload and readback are converted a row at a
+ *  time by dedicated kernels instead of going through Color one pixel at a
+ *  time. Each kernel is a template instantiated with the per pixel conversion,
+ *  and the pairs that vectorize well process 4 to 16 pixels at a time with
+ *  SSE2 or NEON, whichever the target supports, with the scalar template for
+ *  the remainder. The results match the Color conversions bit for bit. Pairs
+ *  without a kernel are left to the generic path.
+ *
+ */
+
+#include "pixelUtils.h"
+#include "glLogger.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#   define GLOVE_PIXEL_SSE2
+#   include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#   define GLOVE_PIXEL_NEON
+#   include <arm_neon.h>
+#endif
+
+// per pixel conversions, packed formats are read as little endian 16-bit words as in Color
+struct PixelSwapRB {
+    enum { SrcSize = 4, DstSize = 4 };
+    static inline void Convert(const uint8_t *src, uint8_t *dst) { dst[0] = src[2]; dst[1] = src[1]; dst[2] = src[0]; dst[3] = src[3]; }
+};
+
+struct PixelRGBToRGBA {
+    enum { SrcSize = 3, DstSize = 4 };
+    static inline void Convert(const uint8_t *src, uint8_t *dst) { dst[0] = src[0]; dst[1] = src[1]; dst[2] = src[2]; dst[3] = 0xff; }
+};
+
+struct PixelRGBAToRGB {
+    enum { SrcSize = 4, DstSize = 3 };
+    static inline void Convert(const uint8_t *src, uint8_t *dst) { dst[0] = src[0]; dst[1] = src[1]; dst[2] = src[2]; }
+};
+
+struct PixelLToRGBA {
+    enum { SrcSize = 1, DstSize = 4 };
+    static inline void Convert(const uint8_t *src, uint8_t *dst) { dst[0] = src[0]; dst[1] = src[0]; dst[2] = src[0]; dst[3] = 0xff; }
+};
+
+struct PixelLAToRGBA {
+    enum { SrcSize = 2, DstSize = 4 };
+    static inline void Convert(const uint8_t *src, uint8_t *dst) { dst[0] = src[0]; dst[1] = src[0]; dst[2] = src[0]; dst[3] = src[1]; }
+};
+
+struct PixelAToRGBA {
+    enum { SrcSize = 1, DstSize = 4 };
+    static inline void Convert(const uint8_t *src, uint8_t *dst) { dst[0] = 0; dst[1] = 0; dst[2] = 0; dst[3] = src[0]; }
+};
+
+struct Pixel565ToRGBA {
+    enum { SrcSize = 2, DstSize = 4 };
+    static inline void Convert(const uint8_t *src, uint8_t *dst)
+    {
+        uint32_t v = src[1] << 8 | src[0];
+        uint32_t r = v >> 11, g = (v >> 5) & 0x3f, b = v & 0x1f;
+        dst[0] = static_cast<uint8_t>(r << 3 | r >> 2);
+        dst[1] = static_cast<uint8_t>(g << 2 | g >> 4);
+        dst[2] = static_cast<uint8_t>(b << 3 | b >> 2);
+        dst[3] = 0xff;
+    }
+};
+
+struct Pixel4444ToRGBA {
+    enum { SrcSize = 2, DstSize = 4 };
+    static inline void Convert(const uint8_t *src, uint8_t *dst)
+    {
+        dst[0] = static_cast<uint8_t>((src[1] >> 4)   * 0x11);
+        dst[1] = static_cast<uint8_t>((src[1] & 0x0f) * 0x11);
+        dst[2] = static_cast<uint8_t>((src[0] >> 4)   * 0x11);
+        dst[3] = static_cast<uint8_t>((src[0] & 0x0f) * 0x11);
+    }
+};
+
+struct Pixel5551ToRGBA {
+    enum { SrcSize = 2, DstSize = 4 };
+    static inline void Convert(const uint8_t *src, uint8_t *dst)
+    {
+        uint32_t v = src[1] << 8 | src[0];
+        uint32_t r = v >> 11, g = (v >> 6) & 0x1f, b = (v >> 1) & 0x1f;
+        dst[0] = static_cast<uint8_t>(r << 3 | r >> 2);
+        dst[1] = static_cast<uint8_t>(g << 3 | g >> 2);
+        dst[2] = static_cast<uint8_t>(b << 3 | b >> 2);
+        dst[3] = (v & 0x1) ? 0xff : 0x00;
+    }
+};
+
+template<typename Pixel>
+static void
+ConvertRowScalar(const uint8_t *src, uint8_t *dst, size_t pixelCount)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    for(size_t i = 0; i < pixelCount; ++i) {
+        Pixel::Convert(src + i * Pixel::SrcSize, dst + i * Pixel::DstSize);
+    }
+}
+
+// the vectorized part of a row, returns the number of pixels converted
+template<typename Pixel>
+static inline size_t
+ConvertRowVector(const uint8_t *, uint8_t *, size_t)
+{
+    return 0;
+}
+
+#if defined(GLOVE_PIXEL_SSE2)
+// interleaves 8 pixels held as 16-bit channels into RGBA8
+static inline void
+StoreRGBA8x8(__m128i r, __m128i g, __m128i b, __m128i a, uint8_t *dst)
+{
+    __m128i rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+    __m128i ba = _mm_or_si128(b, _mm_slli_epi16(a, 8));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),      _mm_unpacklo_epi16(rg, ba));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 16), _mm_unpackhi_epi16(rg, ba));
+}
+
+template<>
+inline size_t
+ConvertRowVector<PixelSwapRB>(const uint8_t *src, uint8_t *dst, size_t pixelCount)
+{
+    const __m128i maskGA = _mm_set1_epi32(static_cast<int32_t>(0xff00ff00));
+    const __m128i maskRB = _mm_set1_epi32(0x00ff00ff);
+    size_t i = 0;
+    for(; i + 4 <= pixelCount; i += 4) {
+        __m128i v  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 4));
+        __m128i rb = _mm_and_si128(v, maskRB);
+        v = _mm_or_si128(_mm_and_si128(v, maskGA), _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4), v);
+    }
+    return i;
+}
+
+template<>
+inline size_t
+ConvertRowVector<PixelLToRGBA>(const uint8_t *src, uint8_t *dst, size_t pixelCount)
+{
+    const __m128i opaque = _mm_set1_epi8(static_cast<char>(0xff));
+    size_t i = 0;
+    for(; i + 16 <= pixelCount; i += 16) {
+        __m128i l    = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        __m128i llLo = _mm_unpacklo_epi8(l, l);
+        __m128i llHi = _mm_unpackhi_epi8(l, l);
+        __m128i laLo = _mm_unpacklo_epi8(l, opaque);
+        __m128i laHi = _mm_unpackhi_epi8(l, opaque);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4),      _mm_unpacklo_epi16(llLo, laLo));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4 + 16), _mm_unpackhi_epi16(llLo, laLo));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4 + 32), _mm_unpacklo_epi16(llHi, laHi));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4 + 48), _mm_unpackhi_epi16(llHi, laHi));
+    }
+    return i;
+}
+
+template<>
+inline size_t
+ConvertRowVector<PixelLAToRGBA>(const uint8_t *src, uint8_t *dst, size_t pixelCount)
+{
+    const __m128i maskL = _mm_set1_epi16(0x00ff);
+    size_t i = 0;
+    for(; i + 8 <= pixelCount; i += 8) {
+        __m128i la = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 2));
+        __m128i l  = _mm_and_si128(la, maskL);
+        __m128i ll = _mm_or_si128(l, _mm_slli_epi16(l, 8));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4),      _mm_unpacklo_epi16(ll, la));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4 + 16), _mm_unpackhi_epi16(ll, la));
+    }
+    return i;
+}
+
+template<>
+inline size_t
+ConvertRowVector<PixelAToRGBA>(const uint8_t *src, uint8_t *dst, size_t pixelCount)
+{
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for(; i + 16 <= pixelCount; i += 16) {
+        __m128i a    = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        __m128i zaLo = _mm_unpacklo_epi8(zero, a);
+        __m128i zaHi = _mm_unpackhi_epi8(zero, a);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4),      _mm_unpacklo_epi16(zero, zaLo));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4 + 16), _mm_unpackhi_epi16(zero, zaLo));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4 + 32), _mm_unpacklo_epi16(zero, zaHi));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4 + 48), _mm_unpackhi_epi16(zero, zaHi));
+    }
+    return i;
+}
+
+template<>
+inline size_t
+ConvertRowVector<Pixel565ToRGBA>(const uint8_t *src, uint8_t *dst, size_t pixelCount)
+{
+    const __m128i mask5  = _mm_set1_epi16(0x1f);
+    const __m128i mask6  = _mm_set1_epi16(0x3f);
+    const __m128i opaque = _mm_set1_epi16(0xff);
+    size_t i = 0;
+    for(; i + 8 <= pixelCount; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 2));
+        __m128i r = _mm_srli_epi16(v, 11);
+        __m128i g = _mm_and_si128(_mm_srli_epi16(v, 5), mask6);
+        __m128i b = _mm_and_si128(v, mask5);
+        r = _mm_or_si128(_mm_slli_epi16(r, 3), _mm_srli_epi16(r, 2));
+        g = _mm_or_si128(_mm_slli_epi16(g, 2), _mm_srli_epi16(g, 4));
+        b = _mm_or_si128(_mm_slli_epi16(b, 3), _mm_srli_epi16(b, 2));
+        StoreRGBA8x8(r, g, b, opaque, dst + i * 4);
+    }
+    return i;
+}
+
+template<>
+inline size_t
+ConvertRowVector<Pixel4444ToRGBA>(const uint8_t *src, uint8_t *dst, size_t pixelCount)
+{
+    const __m128i mask4 = _mm_set1_epi16(0x0f);
+    size_t i = 0;
+    for(; i + 8 <= pixelCount; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 2));
+        __m128i r = _mm_srli_epi16(v, 12);
+        __m128i g = _mm_and_si128(_mm_srli_epi16(v, 8), mask4);
+        __m128i b = _mm_and_si128(_mm_srli_epi16(v, 4), mask4);
+        __m128i a = _mm_and_si128(v, mask4);
+        StoreRGBA8x8(_mm_or_si128(r, _mm_slli_epi16(r, 4)), _mm_or_si128(g, _mm_slli_epi16(g, 4)),
+                     _mm_or_si128(b, _mm_slli_epi16(b, 4)), _mm_or_si128(a, _mm_slli_epi16(a, 4)), dst + i * 4);
+    }
+    return i;
+}
+
+template<>
+inline size_t
+ConvertRowVector<Pixel5551ToRGBA>(const uint8_t *src, uint8_t *dst, size_t pixelCount)
+{
+    const __m128i zero   = _mm_setzero_si128();
+    const __m128i mask1  = _mm_set1_epi16(0x01);
+    const __m128i mask5  = _mm_set1_epi16(0x1f);
+    const __m128i mask8  = _mm_set1_epi16(0xff);
+    size_t i = 0;
+    for(; i + 8 <= pixelCount; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 2));
+        __m128i r = _mm_srli_epi16(v, 11);
+        __m128i g = _mm_and_si128(_mm_srli_epi16(v, 6), mask5);
+        __m128i b = _mm_and_si128(_mm_srli_epi16(v, 1), mask5);
+        __m128i a = _mm_and_si128(_mm_sub_epi16(zero, _mm_and_si128(v, mask1)), mask8);
+        r = _mm_or_si128(_mm_slli_epi16(r, 3), _mm_srli_epi16(r, 2));
+        g = _mm_or_si128(_mm_slli_epi16(g, 3), _mm_srli_epi16(g, 2));
+        b = _mm_or_si128(_mm_slli_epi16(b, 3), _mm_srli_epi16(b, 2));
+        StoreRGBA8x8(r, g, b, a, dst + i * 4);
+    }
+    return i;
+}
+#elif defined(GLOVE_PIXEL_NEON)
+// interleaves 8 pixels held as 16-bit channels into RGBA8
+static inline void
+StoreRGBA8x8(uint16x8_t r, uint16x8_t g, uint16x8_t b, uint16x8_t a, uint8_t *dst)
+{
+    uint8x8x4_t rgba;
+    rgba.val[0] = vmovn_u16(r);
+    rgba.val[1] = vmovn_u16(g);
+    rgba.val[2] = vmovn_u16(b);
+    rgba.val[3] = vmovn_u16(a);
+    vst4_u8(dst, rgba);
+}
+
+template<>
+inline size_t
+ConvertRowVector<PixelSwapRB>(const uint8_t *src, uint8_t *dst, size_t pixelCount)
+{
+    size_t i = 0;
+    for(; i + 16 <= pixelCount; i += 16) {
+        uint8x16x4_t v = vld4q_u8(src + i * 4);
+        uint8x16_t   r = v.val[0];
+        v.val[0] = v.val[2];
+        v.val[2] = r;
+        vst4q_u8(dst + i * 4, v);
+    }
+    return i;
+}
+
+template<>
+inline size_t
+ConvertRowVector<PixelRGBToRGBA>(const uint8_t *src, uint8_t *dst, size_t pixelCount)
+{
+    size_t i = 0;
+    for(; i + 16 <= pixelCount; i += 16) {
+        uint8x16x3_t rgb = vld3q_u8(src + i * 3);
+        uint8x16x4_t rgba;
+        rgba.val[0] = rgb.val[0];
+        rgba.val[1] = rgb.val[1];
+        rgba.val[2] = rgb.val[2];
+        rgba.val[3] = vdupq_n_u8(0xff);
+        vst4q_u8(dst + i * 4, rgba);
+    }
+    return i;
+}
+
+template<>
+inline size_t
+ConvertRowVector<PixelRGBAToRGB>(const uint8_t *src, uint8_t *dst, size_t pixelCount)
+{
+    size_t i = 0;
+    for(; i + 16 <= pixelCount; i += 16) {
+        uint8x16x4_t rgba = vld4q_u8(src + i * 4);
+        uint8x16x3_t rgb;
+        rgb.val[0] = rgba.val[0];
+        rgb.val[1] = rgba.val[1];
+        rgb.val[2] = rgba.val[2];
+        vst3q_u8(dst + i * 3, rgb);
+    }
+    return i;
+}
+
+template<>
+inline size_t
+ConvertRowVector<PixelLToRGBA>(const uint8_t *src, uint8_t *dst, size_t pixelCount)
+{
+    size_t i = 0;
+    for(; i + 16 <= pixelCount; i += 16) {
+        uint8x16_t   l = vld1q_u8(src + i);
+        uint8x16x4_t rgba;
+        rgba.val[0] = l;
+        rgba.val[1] = l;
+        rgba.val[2] = l;
+        rgba.val[3] = vdupq_n_u8(0xff);
+        vst4q_u8(dst + i * 4, rgba);
+    }
+    return i;
+}
+
+template<>
+inline size_t
+ConvertRowVector<PixelLAToRGBA>(const uint8_t *src, uint8_t *dst, size_t pixelCount)
+{
+    size_t i = 0;
+    for(; i + 16 <= pixelCount; i += 16) {
+        uint8x16x2_t la = vld2q_u8(src + i * 2);
+        uint8x16x4_t rgba;
+        rgba.val[0] = la.val[0];
+        rgba.val[1] = la.val[0];
+        rgba.val[2] = la.val[0];
+        rgba.val[3] = la.val[1];
+        vst4q_u8(dst + i * 4, rgba);
+    }
+    return i;
+}
+
+template<>
+inline size_t
+ConvertRowVector<PixelAToRGBA>(const uint8_t *src, uint8_t *dst, size_t pixelCount)
+{
+    size_t i = 0;
+    for(; i + 16 <= pixelCount; i += 16) {
+        uint8x16x4_t rgba;
+        rgba.val[0] = vdupq_n_u8(0);
+        rgba.val[1] = rgba.val[0];
+        rgba.val[2] = rgba.val[0];
+        rgba.val[3] = vld1q_u8(src + i);
+        vst4q_u8(dst + i * 4, rgba);
+    }
+    return i;
+}
+
+template<>
+inline size_t
+ConvertRowVector<Pixel565ToRGBA>(const uint8_t *src, uint8_t *dst, size_t pixelCount)
+{
+    size_t i = 0;
+    for(; i + 8 <= pixelCount; i += 8) {
+        uint16x8_t v = vld1q_u16(reinterpret_cast<const uint16_t *>(src + i * 2));
+        uint16x8_t r = vshrq_n_u16(v, 11);
+        uint16x8_t g = vandq_u16(vshrq_n_u16(v, 5), vdupq_n_u16(0x3f));
+        uint16x8_t b = vandq_u16(v, vdupq_n_u16(0x1f));
+        r = vorrq_u16(vshlq_n_u16(r, 3), vshrq_n_u16(r, 2));
+        g = vorrq_u16(vshlq_n_u16(g, 2), vshrq_n_u16(g, 4));
+        b = vorrq_u16(vshlq_n_u16(b, 3), vshrq_n_u16(b, 2));
+        StoreRGBA8x8(r, g, b, vdupq_n_u16(0xff), dst + i * 4);
+    }
+    return i;
+}
+
+template<>
+inline size_t
+ConvertRowVector<Pixel4444ToRGBA>(const uint8_t *src, uint8_t *dst, size_t pixelCount)
+{
+    const uint16x8_t mask4 = vdupq_n_u16(0x0f);
+    size_t i = 0;
+    for(; i + 8 <= pixelCount; i += 8) {
+        uint16x8_t v = vld1q_u16(reinterpret_cast<const uint16_t *>(src + i * 2));
+        uint16x8_t r = vshrq_n_u16(v, 12);
+        uint16x8_t g = vandq_u16(vshrq_n_u16(v, 8), mask4);
+        uint16x8_t b = vandq_u16(vshrq_n_u16(v, 4), mask4);
+        uint16x8_t a = vandq_u16(v, mask4);
+        StoreRGBA8x8(vorrq_u16(r, vshlq_n_u16(r, 4)), vorrq_u16(g, vshlq_n_u16(g, 4)),
+                     vorrq_u16(b, vshlq_n_u16(b, 4)), vorrq_u16(a, vshlq_n_u16(a, 4)), dst + i * 4);
+    }
+    return i;
+}
+
+template<>
+inline size_t
+ConvertRowVector<Pixel5551ToRGBA>(const uint8_t *src, uint8_t *dst, size_t pixelCount)
+{
+    const uint16x8_t mask5 = vdupq_n_u16(0x1f);
+    size_t i = 0;
+    for(; i + 8 <= pixelCount; i += 8) {
+        uint16x8_t v = vld1q_u16(reinterpret_cast<const uint16_t *>(src + i * 2));
+        uint16x8_t r = vshrq_n_u16(v, 11);
+        uint16x8_t g = vandq_u16(vshrq_n_u16(v, 6), mask5);
+        uint16x8_t b = vandq_u16(vshrq_n_u16(v, 1), mask5);
+        uint16x8_t a = vandq_u16(vsubq_u16(vdupq_n_u16(0), vandq_u16(v, vdupq_n_u16(0x1))), vdupq_n_u16(0xff));
+        r = vorrq_u16(vshlq_n_u16(r, 3), vshrq_n_u16(r, 2));
+        g = vorrq_u16(vshlq_n_u16(g, 3), vshrq_n_u16(g, 2));
+        b = vorrq_u16(vshlq_n_u16(b, 3), vshrq_n_u16(b, 2));
+        StoreRGBA8x8(r, g, b, a, dst + i * 4);
+    }
+    return i;
+}
+#endif
+
+template<typename Pixel>
+static void
+ConvertRow(const uint8_t *src, uint8_t *dst, size_t pixelCount)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    size_t i = ConvertRowVector<Pixel>(src, dst, pixelCount);
+    ConvertRowScalar<Pixel>(src + i * Pixel::SrcSize, dst + i * Pixel::DstSize, pixelCount - i);
+}
+
+#define PIXEL_ROW_CONVERTER(srcFormat, dstFormat, Pixel) \
+    { srcFormat, dstFormat, Pixel::SrcSize, Pixel::DstSize, &ConvertRow<Pixel> }
+
+// formats are listed in their unsized form, see CanonicalFormat
+static const PixelRowConverter sPixelRowConverters[] = {
+    PIXEL_ROW_CONVERTER(GL_BGRA_EXT       , GL_RGBA    , PixelSwapRB),
+    PIXEL_ROW_CONVERTER(GL_RGBA           , GL_BGRA_EXT, PixelSwapRB),
+    PIXEL_ROW_CONVERTER(GL_RGB            , GL_RGBA    , PixelRGBToRGBA),
+    PIXEL_ROW_CONVERTER(GL_RGBA           , GL_RGB     , PixelRGBAToRGB),
+    PIXEL_ROW_CONVERTER(GL_LUMINANCE      , GL_RGBA    , PixelLToRGBA),
+    PIXEL_ROW_CONVERTER(GL_LUMINANCE_ALPHA, GL_RGBA    , PixelLAToRGBA),
+    PIXEL_ROW_CONVERTER(GL_ALPHA          , GL_RGBA    , PixelAToRGBA),
+    PIXEL_ROW_CONVERTER(GL_RGB565         , GL_RGBA    , Pixel565ToRGBA),
+    PIXEL_ROW_CONVERTER(GL_RGBA4          , GL_RGBA    , Pixel4444ToRGBA),
+    PIXEL_ROW_CONVERTER(GL_RGB5_A1        , GL_RGBA    , Pixel5551ToRGBA),
+};
+
+#undef PIXEL_ROW_CONVERTER
+
+static GLenum
+CanonicalFormat(GLenum format)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    switch(format) {
+    case GL_BGRA8_EXT:  return GL_BGRA_EXT;
+    case GL_RGBA8_OES:  return GL_RGBA;
+    case GL_RGB8_OES:   return GL_RGB;
+    default:            return format;
+    }
+}
+
+const PixelRowConverter *
+FindPixelRowConverter(GLenum srcFormat, GLenum dstFormat)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    srcFormat = CanonicalFormat(srcFormat);
+    dstFormat = CanonicalFormat(dstFormat);
+    for(const PixelRowConverter &converter : sPixelRowConverters) {
+        if(converter.srcFormat == srcFormat && converter.dstFormat == dstFormat) {
+            return &converter;
+        }
+    }
+
+    return nullptr;
+}
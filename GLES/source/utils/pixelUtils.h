@@ -0,0 +1,45 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       pixelUtils.h
+ *  @author     Think Silicon
+ *  @date       14/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Row Converters for the Common Pixel Format Pairs
+ *
+ */
+
+#ifndef __PIXELUTILS_H__
+#define __PIXELUTILS_H__
+
+#include "GLES2/gl2.h"
+#include "GLES2/gl2ext.h"
+#include <cstddef>
+#include <stdint.h>
+
+/// converts pixelCount tightly packed pixels from src to dst
+typedef void (*PixelRowConvertFunc)(const uint8_t *src, uint8_t *dst, size_t pixelCount);
+
+typedef struct PixelRowConverter {
+    GLenum                      srcFormat;
+    GLenum                      dstFormat;
+    size_t                      srcPixelSize;
+    size_t                      dstPixelSize;
+    PixelRowConvertFunc         convert;
+} PixelRowConverter;
+
+const PixelRowConverter *FindPixelRowConverter(GLenum srcFormat, GLenum dstFormat);
+
+#endif // __PIXELUTILS_H__
@@ -0,0 +1,245 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       programCache.cpp
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Process wide cache of linked programs, keyed on their sources
+ *
+ *  @section
+ *
+ *  Linking a program converts both ESSL 100 shaders to ESSL 400, compiles
+ *  them again and generates SPIR-V, which is by far the most expensive part
+ *  of glLinkProgram. The outcome only depends on the two sources, on the
+ *  attribute locations bound by the application and on the SPIR-V optimizer
+ *  recipe, so it is stored under a hash of those as the serialized
+ *  reflection followed by the SPIR-V of both stages, the same layout that
+ *  OES_get_program_binary uses. The entries are shared by all contexts and
+ *  written to disk, so a second run of an application links from them.
+ *
+ */
+
+#include "programCache.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+typedef struct programCacheFileHeader_t {
+    uint32_t                            magic;
+    uint32_t                            version;
+    uint32_t                            entryCount;
+    uint32_t                            reserved;
+    uint64_t                            dataSize;
+} programCacheFileHeader_t;
+
+std::mutex              ProgramCache::mMutex;
+ProgramCache::entries_t ProgramCache::mEntries;
+size_t                  ProgramCache::mSize   = 0;
+bool                    ProgramCache::mLoaded = false;
+bool                    ProgramCache::mDirty  = false;
+
+static inline uint64_t
+HashBytes(uint64_t hash, const void *data, size_t size)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // FNV-1a
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    for(size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+uint64_t
+ProgramCache::Hash(const char *vsSource, const char *fsSource,
+                   const std::map<std::string, uint32_t> &attribsLayout, uint32_t spvOptRecipe,
+                   bool relaxedPrecision)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    const uint32_t version = GLOVE_PROGRAM_CACHE_VERSION;
+
+    // the terminators are hashed too, so that the fields cannot run into each other
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    hash = HashBytes(hash, &version , sizeof(version));
+    hash = HashBytes(hash, &spvOptRecipe, sizeof(spvOptRecipe));
+    hash = HashBytes(hash, &relaxedPrecision, sizeof(relaxedPrecision));
+    hash = HashBytes(hash, vsSource , strlen(vsSource) + 1);
+    hash = HashBytes(hash, fsSource , strlen(fsSource) + 1);
+    for(const auto &attrib : attribsLayout) {
+        hash = HashBytes(hash, attrib.first.c_str(), attrib.first.size() + 1);
+        hash = HashBytes(hash, &attrib.second      , sizeof(attrib.second));
+    }
+
+    return hash;
+}
+
+const char *
+ProgramCache::GetPath(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    const char *path = getenv("GLOVE_PROGRAM_CACHE_PATH");
+    if(path == nullptr) {
+        path = GLOVE_PROGRAM_CACHE_FILE;
+    }
+
+    return path[0] != '\0' ? path : nullptr;
+}
+
+void
+ProgramCache::Load(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    mLoaded = true;
+
+    const char *path = GetPath();
+    FILE *fp = path ? fopen(path, "rb") : nullptr;
+    if(!fp) {
+        return;
+    }
+
+    // a file written by a different version is ignored and replaced on the next save
+    programCacheFileHeader_t header;
+    memset(static_cast<void *>(&header), 0, sizeof(header));
+    std::vector<uint8_t> data;
+    if(fread(&header, sizeof(header), 1, fp) == 1 &&
+       header.magic   == GLOVE_PROGRAM_CACHE_MAGIC   &&
+       header.version == GLOVE_PROGRAM_CACHE_VERSION &&
+       header.dataSize > 0 && header.dataSize <= GLOVE_PROGRAM_CACHE_MAX_SIZE) {
+        data.resize(static_cast<size_t>(header.dataSize));
+        if(fread(data.data(), data.size(), 1, fp) != 1) {
+            data.clear();
+        }
+    }
+    fclose(fp);
+
+    size_t offset = 0;
+    for(uint32_t i = 0; i < header.entryCount && !data.empty(); ++i) {
+        uint64_t key;
+        uint32_t size;
+        if(offset + sizeof(key) + sizeof(size) > data.size()) {
+            break;
+        }
+        memcpy(&key , &data[offset], sizeof(key));
+        offset += sizeof(key);
+        memcpy(&size, &data[offset], sizeof(size));
+        offset += sizeof(size);
+        if(offset + size > data.size()) {
+            break;
+        }
+
+        mEntries[key].assign(data.begin() + offset, data.begin() + offset + size);
+        mSize  += sizeof(key) + sizeof(size) + size;
+        offset += size;
+    }
+}
+
+bool
+ProgramCache::Find(uint64_t key, std::vector<uint8_t> &data)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    if(!mLoaded) {
+        Load();
+    }
+
+    entries_t::const_iterator it = mEntries.find(key);
+    if(it == mEntries.end()) {
+        return false;
+    }
+
+    data = it->second;
+    return true;
+}
+
+void
+ProgramCache::Insert(uint64_t key, std::vector<uint8_t> &data)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    if(!mLoaded) {
+        Load();
+    }
+
+    // once full, programs are linked as usual without being stored
+    const size_t size = sizeof(key) + sizeof(uint32_t) + data.size();
+    if(mEntries.count(key) || mSize + size > GLOVE_PROGRAM_CACHE_MAX_SIZE) {
+        return;
+    }
+
+    mSize += size;
+    mEntries[key].swap(data);
+    mDirty = true;
+}
+
+size_t
+ProgramCache::GetSize(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mSize;
+}
+
+void
+ProgramCache::Save(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    if(!mDirty) {
+        return;
+    }
+    mDirty = false;
+
+    const char *path = GetPath();
+    FILE *fp = path ? fopen(path, "wb") : nullptr;
+    if(!fp) {
+        return;
+    }
+
+    programCacheFileHeader_t header;
+    memset(static_cast<void *>(&header), 0, sizeof(header));
+    header.magic      = GLOVE_PROGRAM_CACHE_MAGIC;
+    header.version    = GLOVE_PROGRAM_CACHE_VERSION;
+    header.entryCount = static_cast<uint32_t>(mEntries.size());
+    header.dataSize   = mSize;
+
+    bool written = fwrite(&header, sizeof(header), 1, fp) == 1;
+    for(const auto &entry : mEntries) {
+        const uint32_t size = static_cast<uint32_t>(entry.second.size());
+        written = written &&
+                  fwrite(&entry.first, sizeof(entry.first), 1, fp) == 1 &&
+                  fwrite(&size       , sizeof(size)       , 1, fp) == 1 &&
+                  fwrite(entry.second.data(), size, 1, fp) == 1;
+    }
+    fclose(fp);
+
+    // do not leave a truncated file behind
+    if(!written) {
+        remove(path);
+    }
+}
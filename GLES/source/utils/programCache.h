@@ -0,0 +1,79 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       programCache.h
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Process wide cache of linked programs, keyed on their sources
+ *
+ */
+
+#ifndef __PROGRAMCACHE_H__
+#define __PROGRAMCACHE_H__
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <stdint.h>
+#include "utils/glLogger.h"
+
+#ifndef GLOVE_PROGRAM_CACHE
+#define GLOVE_PROGRAM_CACHE                             true
+#endif // GLOVE_PROGRAM_CACHE
+
+/// on-disk program cache; the location can be overridden through the
+/// GLOVE_PROGRAM_CACHE_PATH environment variable (an empty value disables it)
+#define GLOVE_PROGRAM_CACHE_FILE                        "glove_program_cache.bin"
+#define GLOVE_PROGRAM_CACHE_MAX_SIZE                    (16 * 1024 * 1024)
+#define GLOVE_PROGRAM_CACHE_MAGIC                       0x43534c47 // "GLSC"
+/// bumped whenever the ESSL conversion or the reflection layout changes, which invalidates every entry
+#define GLOVE_PROGRAM_CACHE_VERSION                     5
+
+class ProgramCache {
+private:
+    typedef std::unordered_map<uint64_t, std::vector<uint8_t>>  entries_t;
+
+    static std::mutex                   mMutex;
+    static entries_t                    mEntries;
+    /// size of the entries as laid out in the file
+    static size_t                       mSize;
+    static bool                         mLoaded;
+    static bool                         mDirty;
+
+    static const char                  *GetPath(void);
+    static void                         Load(void);
+
+public:
+    /// spvOptRecipe is the SPIR-V optimization the program is linked with, relaxedPrecision
+    /// whether its precision qualifiers are kept
+    static uint64_t                     Hash(const char *vsSource, const char *fsSource,
+                                             const std::map<std::string, uint32_t> &attribsLayout, uint32_t spvOptRecipe,
+                                             bool relaxedPrecision);
+
+    /// copies the reflection and SPIR-V stored for key into data
+    static bool                         Find(uint64_t key, std::vector<uint8_t> &data);
+    static void                         Insert(uint64_t key, std::vector<uint8_t> &data);
+
+    /// writes the entries to disk, when new ones were added since the last save
+    static void                         Save(void);
+
+    /// bytes of the entries held in memory
+    static size_t                       GetSize(void);
+};
+
+#endif // __PROGRAMCACHE_H__
@@ -0,0 +1,104 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       shaderStats.cpp
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Time spent in each stage of the shader compile and link path
+ *
+ *  @section
+ *
+ *  glLinkProgram dominates the startup of most applications, and its cost
+ *  is spread over glslang, the ESSL converter and the SPIR-V generation.
+ *  When GLOVE_SHADER_STATS names a file, every stage accumulates its calls
+ *  and time, which are written there on eglTerminate together with the hits
+ *  and misses of the program cache, so that a run with an empty cache can
+ *  be compared to one with a filled cache. The stages are timed from the
+ *  compile workers as well, so their sum may exceed the wall time.
+ *
+ */
+
+#include "shaderStats.h"
+#include "glLogger.h"
+#include <cstdio>
+#include <cstdlib>
+
+static const char *shaderStageNames[SHADER_STAGE_COUNT] = {
+    "compile",
+    "validate",
+    "cache_lookup",
+    "convert",
+    "reparse",
+    "link",
+    "reflection",
+    "generate_spv",
+    "restore",
+    "create_module"
+};
+
+std::atomic<uint64_t> ShaderStats::mNanoseconds[SHADER_STAGE_COUNT];
+std::atomic<uint32_t> ShaderStats::mCalls[SHADER_STAGE_COUNT];
+std::atomic<uint32_t> ShaderStats::mCacheHits(0);
+std::atomic<uint32_t> ShaderStats::mCacheMisses(0);
+
+bool
+ShaderStats::IsEnabled(void)
+{
+    static const bool enabled = getenv(GLOVE_SHADER_STATS_ENV) != nullptr;
+    return enabled;
+}
+
+void
+ShaderStats::Add(shader_stage_t stage, uint64_t nanoseconds)
+{
+    mNanoseconds[stage] += nanoseconds;
+    ++mCalls[stage];
+}
+
+void
+ShaderStats::CacheLookup(bool hit)
+{
+    if(IsEnabled()) {
+        ++(hit ? mCacheHits : mCacheMisses);
+    }
+}
+
+void
+ShaderStats::Save(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!IsEnabled()) {
+        return;
+    }
+
+    const char *path = getenv(GLOVE_SHADER_STATS_ENV);
+    FILE *fp = path[0] != '\0' ? fopen(path, "w") : stdout;
+    if(!fp) {
+        return;
+    }
+
+    fprintf(fp, "{\n  \"stages\": {\n");
+    for(uint32_t i = 0; i < SHADER_STAGE_COUNT; ++i) {
+        fprintf(fp, "    \"%s\": { \"calls\": %u, \"total_ms\": %.3f }%s\n", shaderStageNames[i],
+                mCalls[i].exchange(0), mNanoseconds[i].exchange(0) * 1e-6, i + 1 < SHADER_STAGE_COUNT ? "," : "");
+    }
+    fprintf(fp, "  },\n  \"program_cache\": { \"hits\": %u, \"misses\": %u }\n}\n", mCacheHits.exchange(0), mCacheMisses.exchange(0));
+
+    if(fp != stdout) {
+        fclose(fp);
+    }
+}
@@ -0,0 +1,100 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       shaderStats.h
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Time spent in each stage of the shader compile and link path
+ *
+ */
+
+#ifndef __SHADERSTATS_H__
+#define __SHADERSTATS_H__
+
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
+
+/// file the stage times are written to as JSON on eglTerminate, nothing is timed when unset
+#define GLOVE_SHADER_STATS_ENV                          "GLOVE_SHADER_STATS"
+
+typedef enum {
+    /// glCompileShader, parsing the ESSL 100 source
+    SHADER_STAGE_COMPILE = 0,
+    /// linking the ESSL 100 shaders, for the link status and the reflection of the application
+    SHADER_STAGE_VALIDATE,
+    /// looking the program up in the program cache, loading its file the first time
+    SHADER_STAGE_CACHE_LOOKUP,
+    /// rewriting the ESSL 100 sources to ESSL 400
+    SHADER_STAGE_CONVERT,
+    /// parsing the ESSL 400 sources
+    SHADER_STAGE_REPARSE,
+    /// linking the ESSL 400 shaders
+    SHADER_STAGE_LINK,
+    /// building the reflection of the attributes, uniforms and uniform blocks
+    SHADER_STAGE_REFLECTION,
+    /// generating and optimizing the SPIR-V of both stages
+    SHADER_STAGE_GENERATE_SPV,
+    /// restoring the reflection and SPIR-V of a link, or of a cached program, into the program
+    SHADER_STAGE_RESTORE,
+    /// vkCreateShaderModule
+    SHADER_STAGE_CREATE_MODULE,
+    SHADER_STAGE_COUNT
+} shader_stage_t;
+
+class ShaderStats {
+private:
+    static std::atomic<uint64_t>        mNanoseconds[SHADER_STAGE_COUNT];
+    static std::atomic<uint32_t>        mCalls[SHADER_STAGE_COUNT];
+    static std::atomic<uint32_t>        mCacheHits;
+    static std::atomic<uint32_t>        mCacheMisses;
+
+public:
+    static bool                         IsEnabled(void);
+    static void                         Add(shader_stage_t stage, uint64_t nanoseconds);
+    static void                         CacheLookup(bool hit);
+
+    /// writes the times to the file of GLOVE_SHADER_STATS and resets them
+    static void                         Save(void);
+
+    class Scope {
+    private:
+        shader_stage_t                                      mStage;
+        bool                                                mEnabled;
+        std::chrono::steady_clock::time_point               mStart;
+
+    public:
+        explicit Scope(shader_stage_t stage)
+        : mStage(stage), mEnabled(ShaderStats::IsEnabled())
+        {
+            if(mEnabled) {
+                mStart = std::chrono::steady_clock::now();
+            }
+        }
+
+        ~Scope()
+        {
+            if(mEnabled) {
+                ShaderStats::Add(mStage, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - mStart).count());
+            }
+        }
+    };
+};
+
+/// times the rest of the enclosing block as __stage__
+#define GLOVE_SHADER_STAGE(__stage__)                   ShaderStats::Scope shaderStageScope(__stage__)
+
+#endif // __SHADERSTATS_H__
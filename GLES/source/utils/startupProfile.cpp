@@ -0,0 +1,120 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       startupProfile.cpp
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Time to the first frame, phase by phase
+ *
+ *  @section
+ *
+ *  Short-lived render jobs spend most of their run before their first frame.
+ *  When GLOVE_STARTUP_PROFILE names a file, the first occurrence of each
+ *  startup phase is timed on the steady clock, which EGL shares for the phase
+ *  of eglInitialize, and the phases are written there once the first image
+ *  is presented, or on eglTerminate for jobs that never present. The start of
+ *  each phase is relative to the earliest one, so that phases nested in
+ *  others, e.g. the Vulkan initialization in eglInitialize, can be told apart.
+ *
+ */
+
+#include "startupProfile.h"
+#include "glLogger.h"
+#include <cstdio>
+#include <cstdlib>
+
+static const char *startupPhaseNames[STARTUP_PHASE_COUNT] = {
+    "egl_init",
+    "vulkan_init",
+    "context_create",
+    "first_compile",
+    "first_link",
+    "first_pipeline",
+    "first_submit",
+    "first_present"
+};
+
+std::atomic<uint64_t> StartupProfile::mBegin[STARTUP_PHASE_COUNT];
+std::atomic<uint64_t> StartupProfile::mEnd[STARTUP_PHASE_COUNT];
+std::atomic<bool>     StartupProfile::mSaved(false);
+
+bool
+StartupProfile::IsEnabled(void)
+{
+    static const bool enabled = getenv(GLOVE_STARTUP_PROFILE_ENV) != nullptr;
+    return enabled;
+}
+
+void
+StartupProfile::Record(startup_phase_t phase, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end)
+{
+    if(!IsEnabled()) {
+        return;
+    }
+
+    // the compile and pipeline workers may race the GL thread for the first occurrence
+    uint64_t unset   = 0;
+    uint64_t beginNs = std::chrono::duration_cast<std::chrono::nanoseconds>(begin.time_since_epoch()).count();
+    if(mBegin[phase].compare_exchange_strong(unset, beginNs)) {
+        mEnd[phase] = std::chrono::duration_cast<std::chrono::nanoseconds>(end.time_since_epoch()).count();
+    }
+}
+
+void
+StartupProfile::Save(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!IsEnabled() || mSaved.exchange(true)) {
+        return;
+    }
+
+    const char *path = getenv(GLOVE_STARTUP_PROFILE_ENV);
+    FILE *fp = path[0] != '\0' ? fopen(path, "w") : stdout;
+    if(!fp) {
+        return;
+    }
+
+    uint64_t origin = UINT64_MAX;
+    for(uint32_t i = 0; i < STARTUP_PHASE_COUNT; ++i) {
+        if(mBegin[i] && mBegin[i] < origin) {
+            origin = mBegin[i];
+        }
+    }
+
+    fprintf(fp, "{\n  \"phases\": {\n");
+    for(uint32_t i = 0; i < STARTUP_PHASE_COUNT; ++i) {
+        const char *separator = i + 1 < STARTUP_PHASE_COUNT ? "," : "";
+        if(!mBegin[i] || !mEnd[i]) {
+            fprintf(fp, "    \"%s\": null%s\n", startupPhaseNames[i], separator);
+            continue;
+        }
+        fprintf(fp, "    \"%s\": { \"start_ms\": %.3f, \"duration_ms\": %.3f }%s\n", startupPhaseNames[i],
+                (mBegin[i] - origin) * 1e-6, (mEnd[i] - mBegin[i]) * 1e-6, separator);
+    }
+
+    // a headless job has its first frame once it is submitted
+    uint64_t firstFrame = mEnd[STARTUP_PHASE_FIRST_PRESENT] ? mEnd[STARTUP_PHASE_FIRST_PRESENT] : mEnd[STARTUP_PHASE_FIRST_SUBMIT];
+    if(firstFrame && origin != UINT64_MAX) {
+        fprintf(fp, "  },\n  \"time_to_first_frame_ms\": %.3f\n}\n", (firstFrame - origin) * 1e-6);
+    } else {
+        fprintf(fp, "  },\n  \"time_to_first_frame_ms\": null\n}\n");
+    }
+
+    if(fp != stdout) {
+        fclose(fp);
+    }
+}
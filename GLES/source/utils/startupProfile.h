@@ -0,0 +1,99 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       startupProfile.h
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Time to the first frame, phase by phase
+ *
+ */
+
+#ifndef __STARTUPPROFILE_H__
+#define __STARTUPPROFILE_H__
+
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
+
+/// file the startup phases are written to as JSON at the first present, or on eglTerminate without one
+#define GLOVE_STARTUP_PROFILE_ENV                       "GLOVE_STARTUP_PROFILE"
+
+typedef enum {
+    /// eglInitialize, as reported by EGL, which includes the Vulkan initialization
+    STARTUP_PHASE_EGL_INIT = 0,
+    /// creating the Vulkan instance and device
+    STARTUP_PHASE_VULKAN_INIT,
+    /// eglCreateContext
+    STARTUP_PHASE_CONTEXT_CREATE,
+    /// the first shader compiled
+    STARTUP_PHASE_FIRST_COMPILE,
+    /// the first program linked
+    STARTUP_PHASE_FIRST_LINK,
+    /// the first vkCreateGraphicsPipelines, on the GL thread or in the background
+    STARTUP_PHASE_FIRST_PIPELINE,
+    /// the first draw command buffer submitted, the first frame of a headless job
+    STARTUP_PHASE_FIRST_SUBMIT,
+    /// the first image presented
+    STARTUP_PHASE_FIRST_PRESENT,
+    STARTUP_PHASE_COUNT
+} startup_phase_t;
+
+class StartupProfile {
+private:
+    /// steady clock nanoseconds of the first time each phase began and ended, 0 until then
+    static std::atomic<uint64_t>        mBegin[STARTUP_PHASE_COUNT];
+    static std::atomic<uint64_t>        mEnd[STARTUP_PHASE_COUNT];
+    static std::atomic<bool>            mSaved;
+
+public:
+    static bool                         IsEnabled(void);
+    static inline bool                  IsRecorded(startup_phase_t phase) { return mBegin[phase] != 0; }
+
+    /// keeps the first occurrence of phase only
+    static void                         Record(startup_phase_t phase, std::chrono::steady_clock::time_point begin,
+                                                                      std::chrono::steady_clock::time_point end);
+
+    /// writes the phases to the file of GLOVE_STARTUP_PROFILE, once
+    static void                         Save(void);
+
+    class Scope {
+    private:
+        startup_phase_t                                     mPhase;
+        bool                                                mEnabled;
+        std::chrono::steady_clock::time_point               mBegin;
+
+    public:
+        explicit Scope(startup_phase_t phase)
+        : mPhase(phase), mEnabled(StartupProfile::IsEnabled() && !StartupProfile::IsRecorded(phase))
+        {
+            if(mEnabled) {
+                mBegin = std::chrono::steady_clock::now();
+            }
+        }
+
+        ~Scope()
+        {
+            if(mEnabled) {
+                StartupProfile::Record(mPhase, mBegin, std::chrono::steady_clock::now());
+            }
+        }
+    };
+};
+
+/// times the rest of the enclosing block as __phase__, the first time it runs
+#define GLOVE_STARTUP_PHASE(__phase__)                  StartupProfile::Scope startupPhaseScope(__phase__)
+
+#endif // __STARTUPPROFILE_H__
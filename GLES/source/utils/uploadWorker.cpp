@@ -0,0 +1,136 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       uploadWorker.cpp
+ *  @author     Think Silicon
+ *  @date       14/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Background conversion of texture uploads into staging memory
+ *
+ *  @section
+ *
+ *  Large texture uploads are converted to the image format on a worker
+ *  thread, straight into the persistently mapped staging buffer, while the
+ *  GL thread records the copy and returns to the application. The device
+ *  cannot read the staging memory before the batched uploads are submitted,
+ *  so the command buffer manager waits for the worker right before that.
+ *  A texture also waits for its own jobs before its host copies are changed
+ *  or released, since the jobs read from them.
+ *
+ */
+
+#include "uploadWorker.h"
+#include "jobSystem.h"
+
+UploadWorker::UploadWorker()
+: mActiveOwner(nullptr), mActive(false), mScheduled(false)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+}
+
+UploadWorker::~UploadWorker()
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // pending jobs are completed, their staging buffers may already be recorded for upload
+    std::unique_lock<std::mutex> lock(mMutex);
+    mJobDone.wait(lock, [this] { return !mScheduled; });
+}
+
+void
+UploadWorker::Enqueue(const job_t &job)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    bool schedule;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mJobs.push_back(job);
+        schedule   = !mScheduled;
+        mScheduled = true;
+    }
+
+    if(schedule) {
+        JobSystem::GetInstance()->Submit([this] { Run(); });
+    }
+}
+
+bool
+UploadWorker::IsPending(const void *owner) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(owner == nullptr) {
+        return mActive || !mJobs.empty();
+    }
+
+    if(mActive && mActiveOwner == owner) {
+        return true;
+    }
+
+    for(const job_t &job : mJobs) {
+        if(job.owner == owner) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void
+UploadWorker::Wait(const void *owner)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mJobDone.wait(lock, [this, owner] { return !IsPending(owner); });
+}
+
+void
+UploadWorker::Run(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    for(;;) {
+        job_t job;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if(mJobs.empty()) {
+                // notified under the lock, as the worker may be destroyed right after
+                mScheduled = false;
+                mJobDone.notify_all();
+                return;
+            }
+            job = mJobs.front();
+            mJobs.pop_front();
+            mActive      = true;
+            mActiveOwner = job.owner;
+        }
+
+        ConvertPixels(job.srcFormat, job.dstFormat,
+                      &job.srcRect, job.srcData,
+                      &job.dstRect, job.dstData);
+        if(job.releaseSrcData) {
+            delete [] static_cast<const uint8_t *>(job.srcData);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mActive      = false;
+            mActiveOwner = nullptr;
+        }
+        mJobDone.notify_all();
+    }
+}
@@ -0,0 +1,82 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       uploadWorker.h
+ *  @author     Think Silicon
+ *  @date       14/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Background conversion of texture uploads into staging memory
+ *
+ */
+
+#ifndef __UPLOADWORKER_H__
+#define __UPLOADWORKER_H__
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include "resources/rect.h"
+#include "utils/glLogger.h"
+
+/// uploads smaller than this are converted on the GL thread, where the hand-off would cost more
+#ifndef GLOVE_ASYNC_UPLOAD_MIN_SIZE
+#define GLOVE_ASYNC_UPLOAD_MIN_SIZE                     (64 << 10)
+#endif // GLOVE_ASYNC_UPLOAD_MIN_SIZE
+
+class UploadWorker {
+
+public:
+    /// conversion of a host copy into mapped staging memory, both outlive the job
+    /// unless releaseSrcData hands the host copy over to the worker, which frees it once converted
+    typedef struct job_t {
+        const void                     *owner;
+        GLenum                          srcFormat;
+        GLenum                          dstFormat;
+        ImageRect                       srcRect;
+        ImageRect                       dstRect;
+        const void                     *srcData;
+        void                           *dstData;
+        bool                            releaseSrcData;
+    } job_t;
+
+private:
+    std::mutex                        mMutex;
+    std::condition_variable           mJobDone;
+    std::deque<job_t>                 mJobs;
+    /// owner of the job being converted, nullptr when idle
+    const void                       *mActiveOwner;
+    bool                              mActive;
+    /// a job of the pool drains the queue while this is set
+    bool                              mScheduled;
+
+    void                              Run(void);
+    bool                              IsPending(const void *owner) const;
+
+public:
+// Constructor
+    UploadWorker();
+
+// Destructor
+    ~UploadWorker();
+
+// Enqueue Functions
+    void                              Enqueue(const job_t &job);
+
+// Wait Functions
+    /// blocks until the jobs of owner, or all of them when owner is nullptr, are converted
+    void                              Wait(const void *owner = nullptr);
+};
+
+#endif // __UPLOADWORKER_H__
@@ -30,6 +30,7 @@
  */
 
 #include "buffer.h"
+#include "commandBundle.h"
 
 namespace vulkanAPI {
 
@@ -55,6 +56,7 @@ Buffer::Release(void)
 
     mVkSize = 0;
     if(mVkBuffer != VK_NULL_HANDLE) {
+        CommandBundle::Retire(CommandBundle::GetHandleKey(mVkBuffer));
         vkDestroyBuffer(mVkContext->vkDevice, mVkBuffer, nullptr);
         mVkBuffer = VK_NULL_HANDLE;
     }
@@ -91,4 +93,49 @@ Buffer::CreateVkDescriptorBufferInfo(void)
     mVkDescriptorBufferInfo.offset = mVkOffset;
 }
 
+void
+Buffer::CopyFromBuffer(VkCommandBuffer *activeCmdBuffer, VkBuffer srcBuffer, VkDeviceSize dstOffset, VkDeviceSize size)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    VkBufferCopy region;
+    region.srcOffset = 0;
+    region.dstOffset = dstOffset;
+    region.size      = size;
+
+    mVkContext->vkDispatch.vkCmdCopyBuffer(*activeCmdBuffer, srcBuffer, mVkBuffer, 1, &region);
+}
+
+void
+Buffer::UpdateBuffer(VkCommandBuffer *activeCmdBuffer, VkDeviceSize dstOffset, VkDeviceSize size, const void *data)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    assert(size <= 65536 && !(dstOffset & 3) && !(size & 3));
+
+    mVkContext->vkDispatch.vkCmdUpdateBuffer(*activeCmdBuffer, mVkBuffer, dstOffset, size, data);
+}
+
+void
+Buffer::PipelineBarrier(VkCommandBuffer *activeCmdBuffer,
+                        VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask,
+                        VkPipelineStageFlags srcStages, VkPipelineStageFlags dstStages,
+                        uint32_t srcQueueFamilyIndex, uint32_t dstQueueFamilyIndex)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    VkBufferMemoryBarrier bufferMemoryBarrier;
+    bufferMemoryBarrier.sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    bufferMemoryBarrier.pNext               = nullptr;
+    bufferMemoryBarrier.srcAccessMask       = srcAccessMask;
+    bufferMemoryBarrier.dstAccessMask       = dstAccessMask;
+    bufferMemoryBarrier.srcQueueFamilyIndex = srcQueueFamilyIndex;
+    bufferMemoryBarrier.dstQueueFamilyIndex = dstQueueFamilyIndex;
+    bufferMemoryBarrier.buffer              = mVkBuffer;
+    bufferMemoryBarrier.offset              = 0;
+    bufferMemoryBarrier.size                = VK_WHOLE_SIZE;
+
+    mVkContext->vkDispatch.vkCmdPipelineBarrier(*activeCmdBuffer, srcStages, dstStages, 0, 0, nullptr, 1, &bufferMemoryBarrier, 0, nullptr);
+}
+
 }
@@ -25,10 +25,11 @@
 #define __VKBUFFER_H__
 
 #include "context.h"
+#include "utils/objectPool.h"
 
 namespace vulkanAPI {
 
-class Buffer {
+class Buffer : public PooledObject {
 
 private:
     const
@@ -55,6 +56,16 @@ public:
 // Release Functions
     void                              Release(void);
 
+// Command Functions
+    void                              CopyFromBuffer(VkCommandBuffer *activeCmdBuffer, VkBuffer srcBuffer, VkDeviceSize dstOffset, VkDeviceSize size);
+    /// the data is copied into the command buffer, up to 64 KiB, with dstOffset and size multiples of 4
+    void                              UpdateBuffer(VkCommandBuffer *activeCmdBuffer, VkDeviceSize dstOffset, VkDeviceSize size, const void *data);
+    void                              PipelineBarrier(VkCommandBuffer *activeCmdBuffer,
+                                                      VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask,
+                                                      VkPipelineStageFlags srcStages, VkPipelineStageFlags dstStages,
+                                                      uint32_t srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                                                      uint32_t dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED);
+
 // Get Functions
     inline VkBuffer &                 GetVkBuffer(void)                         { FUN_ENTRY(GL_LOG_TRACE); return mVkBuffer;                }
     inline VkDescriptorBufferInfo*    GetVkDescriptorBufferInfo(void)           { FUN_ENTRY(GL_LOG_TRACE); return &mVkDescriptorBufferInfo; }
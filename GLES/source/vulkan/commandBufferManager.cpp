@@ -29,27 +29,76 @@
  *  buffers, and which are not directly submitted to queues.
  *  Command buffers are represented by VkCommandBuffer.
  *
+ *  Draw command buffers are organized in a ring of GLOVE_MAX_FRAMES_IN_FLIGHT
+ *  slots, each one owning its own fence and secondary command buffers. A slot
+ *  is only waited upon when the ring wraps around to it, so the CPU can
+ *  record up to GLOVE_MAX_FRAMES_IN_FLIGHT - 1 frames ahead of the GPU.
+ *
+ *  Every slot also owns an auxiliary command buffer that batches the
+ *  uploads and layout transitions requested outside of the render pass.
+ *  It is submitted in the same batch as, and ahead of, the slot's draw
+ *  command buffer, so ordering relies on the recorded pipeline barriers.
+ *  The host only waits for it when it needs the results back (e.g. when
+ *  reading pixels) through SubmitVkAuxCommandBuffer/WaitVkAuxCommandBuffer.
+ *
+ *  When the device exposes a dedicated transfer queue, uploads are recorded
+ *  in a per-slot transfer command buffer instead. The queue family ownership
+ *  of the uploaded images is released at the end of the aux command buffer,
+ *  acquired by the transfer queue and handed back to a post-transfer command
+ *  buffer that runs ahead of the draws, with semaphores ordering the three
+ *  submissions. Aux commands recorded once uploads are pending go to the
+ *  post-transfer command buffer so that their recording order is respected.
+ *
+ *  Every slot allocates its command buffers from its own transient command
+ *  pools. Once the slot's fence signals, the pools are reset wholesale with
+ *  vkResetCommandPool and the buffers handed out again by the slot's
+ *  CommandBufferPools, instead of resetting each buffer on its next begin.
+ *  Aux and transfer command buffers are therefore never re-begun within a
+ *  frame; a fresh one is grabbed from the slot every time recording starts.
+ *
+ *  Every submission that is waited upon gets a monotonically increasing
+ *  submission ID. When VK_KHR_timeline_semaphore is available, the ID is
+ *  signalled on a single timeline semaphore, which replaces the per-slot
+ *  fences and lets callers tell which submissions have completed without
+ *  waiting. Otherwise the fences are kept and the completed ID only advances
+ *  as they are found signaled.
+ *
  */
 
 #include "commandBufferManager.h"
+#include "utils/uploadWorker.h"
+#include <algorithm>
+#include <utility>
 
 namespace vulkanAPI {
 
 #define GLOVE_NO_BUFFER_TO_WAIT                         0x7FFFFFFF
-#define GLOVE_NUM_COMMAND_BUFFERS                       2
 #define GLOVE_FENCE_WAIT_TIMEOUT                        UINT64_MAX
 
-CommandBufferManager::CommandBufferManager(const vkContext_t *context)
-: mVkContext(context)
+CommandBufferManager::CommandBufferManager(const vkContext_t *context, VkQueue queue)
+: mVkContext(context), mVkQueue(queue != VK_NULL_HANDLE || !context ? queue : context->vkQueue), mTimestamps(context), mOcclusionQueries(context)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
     mActiveCmdBuffer    = 0;
     mLastSubmittedBuffer= GLOVE_NO_BUFFER_TO_WAIT;
 
-    mVkCmdPool          = VK_NULL_HANDLE;
-    mVkAuxCommandBuffer = VK_NULL_HANDLE;
-    mVkAuxFence         = VK_NULL_HANDLE;
+    mAuxFenceSubmitted  = false;
+    mAuxSubmissionId    = 0;
+    mPostTransferAuxCommands = false;
+    mPresentable        = true;
+    mUploadWorker       = nullptr;
+    mUseTimeline        = false;
+    mLastSubmissionId   = 0;
+    mCompletedSubmissionId = 0;
+    mOcclusionTicket    = 0;
+    mOcclusionCmdBuffer = VK_NULL_HANDLE;
+    mVkBundleCmdPool    = VK_NULL_HANDLE;
+#ifdef TRACE_BINARY
+    mTraceTimestamps    = getenv(GLOVE_GPU_TIMESTAMPS_ENV) != nullptr;
+#else
+    mTraceTimestamps    = false;
+#endif // TRACE_BINARY
 
     if(!AllocateVkCmdPool()) {
         assert(false);
@@ -75,9 +124,27 @@ CommandBufferManager::~CommandBufferManager()
 
         DestroyVkCmdBuffers();
 
-        if(mVkCmdPool != VK_NULL_HANDLE) {
-            vkDestroyCommandPool(mVkContext->vkDevice, mVkCmdPool, nullptr);
-            mVkCmdPool = VK_NULL_HANDLE;
+        for(uint32_t i = 0; i < mVkCmdPools.size(); ++i) {
+            if(mVkCmdPools[i] != VK_NULL_HANDLE) {
+                vkDestroyCommandPool(mVkContext->vkDevice, mVkCmdPools[i], nullptr);
+            }
+        }
+        mVkCmdPools.clear();
+
+        for(uint32_t i = 0; i < mVkTransferCmdPools.size(); ++i) {
+            if(mVkTransferCmdPools[i] != VK_NULL_HANDLE) {
+                vkDestroyCommandPool(mVkContext->vkDevice, mVkTransferCmdPools[i], nullptr);
+            }
+        }
+        mVkTransferCmdPools.clear();
+
+        // the command buffers of the bundles still alive are freed along with their pool
+        for(uint32_t i = mBundleCmdBufferPool.GetSize(); i > 0; --i) {
+            delete mBundleCmdBufferPool.RemoveBuffer();
+        }
+        if(mVkBundleCmdPool != VK_NULL_HANDLE) {
+            vkDestroyCommandPool(mVkContext->vkDevice, mVkBundleCmdPool, nullptr);
+            mVkBundleCmdPool = VK_NULL_HANDLE;
         }
     }
 }
@@ -87,30 +154,61 @@ CommandBufferManager::DestroyVkCmdBuffers(void)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
+    // pending uploads may still refer to resources about to be released
+    SubmitVkAuxCommandBuffer();
+    WaitVkAuxCommandBuffer();
+    WaitLastSubmition();
+
     for(uint32_t i = 0; i < mVkCommandBuffers.fence.size(); ++i) {
         mVkCommandBuffers.fence[i].Release();
     }
 
-    vkFreeCommandBuffers(mVkContext->vkDevice, mVkCmdPool, mVkCommandBuffers.commandBuffer.size(), mVkCommandBuffers.commandBuffer.data());
+    for(uint32_t i = 0; i < mVkCommandBuffers.commandBuffer.size(); ++i) {
+        vkFreeCommandBuffers(mVkContext->vkDevice, mVkCmdPools[i], 1, &mVkCommandBuffers.commandBuffer[i]);
+        vkFreeCommandBuffers(mVkContext->vkDevice, mVkCmdPools[i], 1, &mVkCommandBuffers.offscreenCommandBuffer[i]);
+    }
     mVkCommandBuffers.commandBuffer.clear();
     mVkCommandBuffers.commandBufferState.clear();
+    mVkCommandBuffers.offscreenCommandBuffer.clear();
+    mVkCommandBuffers.offscreenSplit.clear();
+    mVkCommandBuffers.swapchainCommands.clear();
     mVkCommandBuffers.fence.clear();
     memset(static_cast<void *>(&mVkCommandBuffers), 0, mVkCommandBuffers.commandBuffer.size()*sizeof(State));
 
-    if(mVkAuxCommandBuffer != VK_NULL_HANDLE) {
-        vkFreeCommandBuffers(mVkContext->vkDevice, mVkCmdPool, 1, &mVkAuxCommandBuffer);
-        mVkAuxCommandBuffer = VK_NULL_HANDLE;
-    }
+    mAuxFence.Release();
+    mTimeline.Release();
+    mTimestamps.Release();
+    mOcclusionQueries.Release();
+    mOcclusionTicket = 0;
+    mVkCommandBuffers.submissionId.clear();
+
+    FreeVkCmdBuffers(&mVkCommandBuffers.auxCmdBufferPool, mVkCmdPools);
+    mVkCommandBuffers.auxCommandBuffer.clear();
+    mVkCommandBuffers.auxCommandBufferState.clear();
+
+    DestroyVkTransferCmdBuffers();
 
-    uint32_t secondaryBuffersPoolSize = mSecondaryCmdBufferPool.GetSize();
+    FreeVkCmdBuffers(&mVkCommandBuffers.secondaryCmdBufferPool, mVkCmdPools);
+}
+
+void
+CommandBufferManager::FreeVkCmdBuffers(std::vector<CommandBufferPool> *cmdBufferPools, const std::vector<VkCommandPool> &vkCmdPools)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    for(uint32_t i = 0; i < cmdBufferPools->size(); ++i) {
+        CommandBufferPool *cmdBufferPool = &(*cmdBufferPools)[i];
+        uint32_t cmdBufferPoolSize = cmdBufferPool->GetSize();
 
-    for(uint32_t i = 0; i < secondaryBuffersPoolSize; ++i) {
-        VkCommandBuffer *removingSecondaryBuffer = mSecondaryCmdBufferPool.RemoveBuffer();
-        if(removingSecondaryBuffer) {
-            vkFreeCommandBuffers(mVkContext->vkDevice, mVkCmdPool, 1, removingSecondaryBuffer);
-            delete removingSecondaryBuffer;
+        for(uint32_t j = 0; j < cmdBufferPoolSize; ++j) {
+            VkCommandBuffer *removingBuffer = cmdBufferPool->RemoveBuffer();
+            if(removingBuffer) {
+                vkFreeCommandBuffers(mVkContext->vkDevice, vkCmdPools[i], 1, removingBuffer);
+                delete removingBuffer;
+            }
         }
     }
+    cmdBufferPools->clear();
 }
 
 void
@@ -124,38 +222,106 @@ CommandBufferManager::AllocateVkSecondaryCmdBuffers(uint32_t numOfBuffers)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    VkCommandBuffer *reusedCommandBuffer = mSecondaryCmdBufferPool.BindNextAvailableBuffer();
+    assert(numOfBuffers == 1);
+
+    ++mStatistics.secondaryCommandBuffers;
+
+    return AllocateVkCmdBuffer(&mVkCommandBuffers.secondaryCmdBufferPool[mActiveCmdBuffer], mVkCmdPools[mActiveCmdBuffer], VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+}
+
+VkCommandBuffer *
+CommandBufferManager::AllocateVkBundleCmdBuffer(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the pool is never unbound, so every bundle gets a command buffer of its own
+    return AllocateVkCmdBuffer(&mBundleCmdBufferPool, mVkBundleCmdPool, VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+}
+
+void
+CommandBufferManager::FreeVkBundleCmdBuffer(VkCommandBuffer *cmdBuffer)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!cmdBuffer || !mBundleCmdBufferPool.RemoveBuffer(cmdBuffer)) {
+        return;
+    }
+
+    vkFreeCommandBuffers(mVkContext->vkDevice, mVkBundleCmdPool, 1, cmdBuffer);
+    delete cmdBuffer;
+}
+
+VkCommandBuffer *
+CommandBufferManager::AllocateVkCmdBuffer(CommandBufferPool *cmdBufferPool, VkCommandPool vkCmdPool, VkCommandBufferLevel level)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    VkCommandBuffer *reusedCommandBuffer = cmdBufferPool->BindNextAvailableBuffer();
 
     if(nullptr != reusedCommandBuffer) {
         return reusedCommandBuffer;
     }
 
     VkResult err;
-    VkCommandBuffer *commandBuffers = new VkCommandBuffer;
+    VkCommandBuffer *commandBuffer = new VkCommandBuffer;
 
     VkCommandBufferAllocateInfo cmdAllocInfo;
     cmdAllocInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
     cmdAllocInfo.pNext              = nullptr;
-    cmdAllocInfo.commandPool        = mVkCmdPool;
-    cmdAllocInfo.level              = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
-    cmdAllocInfo.commandBufferCount = numOfBuffers;
+    cmdAllocInfo.commandPool        = vkCmdPool;
+    cmdAllocInfo.level              = level;
+    cmdAllocInfo.commandBufferCount = 1;
 
-    err = vkAllocateCommandBuffers(mVkContext->vkDevice, &cmdAllocInfo, commandBuffers);
+    err = vkAllocateCommandBuffers(mVkContext->vkDevice, &cmdAllocInfo, commandBuffer);
     assert(!err);
 
     if(err != VK_SUCCESS) {
+        delete commandBuffer;
         return nullptr;
     }
 
-    mSecondaryCmdBufferPool.AddBuffer(commandBuffers);
+    cmdBufferPool->AddBuffer(commandBuffer);
+
+    return commandBuffer;
+}
+
+bool
+CommandBufferManager::ResetVkCmdPools(uint32_t index)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // all the command buffers of the slot return to the initial state at once
+    VkResult err = mVkContext->vkDispatch.vkResetCommandPool(mVkContext->vkDevice, mVkCmdPools[index], 0);
+    assert(!err);
+
+    if(err != VK_SUCCESS) {
+        return false;
+    }
+
+    if(mVkContext->mIsTransferQueueSupported) {
+        err = mVkContext->vkDispatch.vkResetCommandPool(mVkContext->vkDevice, mVkTransferCmdPools[index], 0);
+        assert(!err);
+
+        if(err != VK_SUCCESS) {
+            return false;
+        }
+
+        mVkCommandBuffers.transferCmdBufferPool[index].UnbindAllBuffers();
+        mVkCommandBuffers.postTransferCmdBufferPool[index].UnbindAllBuffers();
+    }
+
+    mVkCommandBuffers.secondaryCmdBufferPool[index].UnbindAllBuffers();
+    mVkCommandBuffers.auxCmdBufferPool[index].UnbindAllBuffers();
 
-    return commandBuffers;
+    return true;
 }
 
 void
 CommandBufferManager::FreeResources(void)
 {
-    mSecondaryCmdBufferPool.UnbindAllBuffers();
+    for(uint32_t i = 0; i < mVkCommandBuffers.secondaryCmdBufferPool.size(); ++i) {
+        mVkCommandBuffers.secondaryCmdBufferPool[i].UnbindAllBuffers();
+    }
 }
 
 bool
@@ -163,21 +329,45 @@ CommandBufferManager::AllocateVkCmdPool(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    mVkCmdPools.assign(GLOVE_MAX_FRAMES_IN_FLIGHT, VK_NULL_HANDLE);
+    mVkTransferCmdPools.assign(GLOVE_MAX_FRAMES_IN_FLIGHT, VK_NULL_HANDLE);
+
     VkCommandPoolCreateInfo cmdPoolInfo;
     memset(static_cast<void *>(&cmdPoolInfo), 0 ,sizeof(cmdPoolInfo));
     cmdPoolInfo.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
     cmdPoolInfo.pNext            = nullptr;
+    cmdPoolInfo.flags            = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+    for(uint32_t i = 0; i < GLOVE_MAX_FRAMES_IN_FLIGHT; ++i) {
+        cmdPoolInfo.queueFamilyIndex = mVkContext->vkGraphicsQueueNodeIndex;
+
+        VkResult err = vkCreateCommandPool(mVkContext->vkDevice, &cmdPoolInfo, nullptr, &mVkCmdPools[i]);
+        assert(!err);
+
+        if(err != VK_SUCCESS) {
+            return false;
+        }
+
+        if(mVkContext->mIsTransferQueueSupported) {
+            cmdPoolInfo.queueFamilyIndex = mVkContext->vkTransferQueueNodeIndex;
+
+            err = vkCreateCommandPool(mVkContext->vkDevice, &cmdPoolInfo, nullptr, &mVkTransferCmdPools[i]);
+            assert(!err);
+
+            if(err != VK_SUCCESS) {
+                return false;
+            }
+        }
+    }
+
+    // bundles are recorded again in place, rather than their pool being reset
     cmdPoolInfo.flags            = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
     cmdPoolInfo.queueFamilyIndex = mVkContext->vkGraphicsQueueNodeIndex;
 
-    VkResult err = vkCreateCommandPool(mVkContext->vkDevice, &cmdPoolInfo, nullptr, &mVkCmdPool);
+    VkResult err = vkCreateCommandPool(mVkContext->vkDevice, &cmdPoolInfo, nullptr, &mVkBundleCmdPool);
     assert(!err);
 
-    if(err != VK_SUCCESS) {
-        return false;
-    }
-
-    return true;
+    return err == VK_SUCCESS;
 }
 
 bool
@@ -185,34 +375,61 @@ CommandBufferManager::AllocateVkCmdBuffers(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    mVkCommandBuffers.commandBuffer.resize(GLOVE_NUM_COMMAND_BUFFERS);
-    mVkCommandBuffers.commandBufferState.resize(GLOVE_NUM_COMMAND_BUFFERS);
-    mVkCommandBuffers.fence.resize(GLOVE_NUM_COMMAND_BUFFERS);
+    mVkCommandBuffers.commandBuffer.resize(GLOVE_MAX_FRAMES_IN_FLIGHT);
+    mVkCommandBuffers.commandBufferState.resize(GLOVE_MAX_FRAMES_IN_FLIGHT);
+    mVkCommandBuffers.offscreenCommandBuffer.resize(GLOVE_MAX_FRAMES_IN_FLIGHT);
+    mVkCommandBuffers.offscreenSplit.assign(GLOVE_MAX_FRAMES_IN_FLIGHT, false);
+    mVkCommandBuffers.swapchainCommands.assign(GLOVE_MAX_FRAMES_IN_FLIGHT, false);
+    mVkCommandBuffers.fence.resize(GLOVE_MAX_FRAMES_IN_FLIGHT);
+    mVkCommandBuffers.secondaryCmdBufferPool.resize(GLOVE_MAX_FRAMES_IN_FLIGHT);
+    mVkCommandBuffers.auxCmdBufferPool.resize(GLOVE_MAX_FRAMES_IN_FLIGHT);
+    mVkCommandBuffers.auxCommandBuffer.assign(GLOVE_MAX_FRAMES_IN_FLIGHT, VK_NULL_HANDLE);
+    mVkCommandBuffers.auxCommandBufferState.resize(GLOVE_MAX_FRAMES_IN_FLIGHT);
 
     VkCommandBufferAllocateInfo cmdAllocInfo;
     cmdAllocInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
     cmdAllocInfo.pNext              = nullptr;
-    cmdAllocInfo.commandPool        = mVkCmdPool;
     cmdAllocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    cmdAllocInfo.commandBufferCount = GLOVE_NUM_COMMAND_BUFFERS;
+    cmdAllocInfo.commandBufferCount = 1;
 
-    VkResult err = vkAllocateCommandBuffers(mVkContext->vkDevice, &cmdAllocInfo, mVkCommandBuffers.commandBuffer.data());
-    assert(!err);
+    for(uint32_t i = 0; i < GLOVE_MAX_FRAMES_IN_FLIGHT; ++i) {
+        cmdAllocInfo.commandPool    = mVkCmdPools[i];
 
-    if(err != VK_SUCCESS) {
-        return false;
-    }
+        VkResult err = vkAllocateCommandBuffers(mVkContext->vkDevice, &cmdAllocInfo, &mVkCommandBuffers.commandBuffer[i]);
+        assert(!err);
 
-    cmdAllocInfo.commandBufferCount = 1;
-    err = vkAllocateCommandBuffers(mVkContext->vkDevice, &cmdAllocInfo, &mVkAuxCommandBuffer);
-    assert(!err);
+        if(err != VK_SUCCESS) {
+            return false;
+        }
 
-    if(err != VK_SUCCESS) {
-        return false;
+        err = vkAllocateCommandBuffers(mVkContext->vkDevice, &cmdAllocInfo, &mVkCommandBuffers.offscreenCommandBuffer[i]);
+        assert(!err);
+
+        if(err != VK_SUCCESS) {
+            return false;
+        }
     }
 
-    for(uint32_t i = 0; i < GLOVE_NUM_COMMAND_BUFFERS; ++i) {
-        mVkCommandBuffers.commandBufferState[i] = CMD_BUFFER_INITIAL_STATE;
+    mAuxFence.SetContext(mVkContext);
+    if(!mAuxFence.Create(false)) {
+        return false;
+    }
+    mAuxFenceSubmitted = false;
+    mAuxSubmissionId   = 0;
+
+    // a new timeline starts counting from zero
+    mTimeline.SetContext(mVkContext);
+    mUseTimeline           = mTimeline.Create();
+    mTimestamps.Create(2 * GLOVE_MAX_FRAMES_IN_FLIGHT);
+    mOcclusionQueries.Create(GLOVE_MAX_FRAMES_IN_FLIGHT);
+    mOcclusionTicket       = 0;
+    mLastSubmissionId      = 0;
+    mCompletedSubmissionId = 0;
+    mVkCommandBuffers.submissionId.assign(GLOVE_MAX_FRAMES_IN_FLIGHT, 0);
+
+    for(uint32_t i = 0; i < GLOVE_MAX_FRAMES_IN_FLIGHT; ++i) {
+        mVkCommandBuffers.commandBufferState[i]    = CMD_BUFFER_INITIAL_STATE;
+        mVkCommandBuffers.auxCommandBufferState[i] = CMD_BUFFER_INITIAL_STATE;
 
         mVkCommandBuffers.fence[i].SetContext(mVkContext);
         if(!mVkCommandBuffers.fence[i].Create(false)) {
@@ -220,9 +437,79 @@ CommandBufferManager::AllocateVkCmdBuffers(void)
         }
     }
 
+    return AllocateVkTransferCmdBuffers();
+}
+
+bool
+CommandBufferManager::AllocateVkTransferCmdBuffers(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    mVkCommandBuffers.transferCmdBufferPool.resize(GLOVE_MAX_FRAMES_IN_FLIGHT);
+    mVkCommandBuffers.postTransferCmdBufferPool.resize(GLOVE_MAX_FRAMES_IN_FLIGHT);
+    mVkCommandBuffers.transferCommandBuffer.assign(GLOVE_MAX_FRAMES_IN_FLIGHT, VK_NULL_HANDLE);
+    mVkCommandBuffers.postTransferCommandBuffer.assign(GLOVE_MAX_FRAMES_IN_FLIGHT, VK_NULL_HANDLE);
+    mVkCommandBuffers.transferCommandBufferState.assign(GLOVE_MAX_FRAMES_IN_FLIGHT, CMD_BUFFER_INITIAL_STATE);
+    mVkCommandBuffers.preTransferSemaphore.assign(GLOVE_MAX_FRAMES_IN_FLIGHT, VK_NULL_HANDLE);
+    mVkCommandBuffers.postTransferSemaphore.assign(GLOVE_MAX_FRAMES_IN_FLIGHT, VK_NULL_HANDLE);
+    mPostTransferAuxCommands = false;
+
+    if(!mVkContext->mIsTransferQueueSupported) {
+        return true;
+    }
+
+    VkSemaphoreCreateInfo semaphoreCreateInfo;
+    semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreCreateInfo.pNext = nullptr;
+    semaphoreCreateInfo.flags = 0;
+
+    for(uint32_t i = 0; i < GLOVE_MAX_FRAMES_IN_FLIGHT; ++i) {
+        VkResult err = vkCreateSemaphore(mVkContext->vkDevice, &semaphoreCreateInfo, nullptr, &mVkCommandBuffers.preTransferSemaphore[i]);
+        assert(!err);
+
+        if(err != VK_SUCCESS) {
+            return false;
+        }
+
+        err = vkCreateSemaphore(mVkContext->vkDevice, &semaphoreCreateInfo, nullptr, &mVkCommandBuffers.postTransferSemaphore[i]);
+        assert(!err);
+
+        if(err != VK_SUCCESS) {
+            return false;
+        }
+    }
+
     return true;
 }
 
+void
+CommandBufferManager::DestroyVkTransferCmdBuffers(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(mVkContext->mIsTransferQueueSupported) {
+        for(uint32_t i = 0; i < mVkCommandBuffers.preTransferSemaphore.size(); ++i) {
+            if(mVkCommandBuffers.preTransferSemaphore[i] != VK_NULL_HANDLE) {
+                vkDestroySemaphore(mVkContext->vkDevice, mVkCommandBuffers.preTransferSemaphore[i], nullptr);
+            }
+            if(mVkCommandBuffers.postTransferSemaphore[i] != VK_NULL_HANDLE) {
+                vkDestroySemaphore(mVkContext->vkDevice, mVkCommandBuffers.postTransferSemaphore[i], nullptr);
+            }
+        }
+
+        FreeVkCmdBuffers(&mVkCommandBuffers.transferCmdBufferPool, mVkTransferCmdPools);
+        FreeVkCmdBuffers(&mVkCommandBuffers.postTransferCmdBufferPool, mVkCmdPools);
+    }
+    mVkCommandBuffers.transferCmdBufferPool.clear();
+    mVkCommandBuffers.postTransferCmdBufferPool.clear();
+
+    mVkCommandBuffers.transferCommandBuffer.clear();
+    mVkCommandBuffers.postTransferCommandBuffer.clear();
+    mVkCommandBuffers.transferCommandBufferState.clear();
+    mVkCommandBuffers.preTransferSemaphore.clear();
+    mVkCommandBuffers.postTransferSemaphore.clear();
+}
+
 bool
 CommandBufferManager::BeginVkDrawCommandBuffer(void)
 {
@@ -238,7 +525,7 @@ CommandBufferManager::BeginVkDrawCommandBuffer(void)
     info.flags            = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
     info.pInheritanceInfo = nullptr;
 
-    VkResult err = vkBeginCommandBuffer(mVkCommandBuffers.commandBuffer[mActiveCmdBuffer], &info);
+    VkResult err = mVkContext->vkDispatch.vkBeginCommandBuffer(mVkCommandBuffers.commandBuffer[mActiveCmdBuffer], &info);
     assert(!err);
 
     if(err != VK_SUCCESS) {
@@ -247,11 +534,17 @@ CommandBufferManager::BeginVkDrawCommandBuffer(void)
 
     mVkCommandBuffers.commandBufferState[mActiveCmdBuffer] = CMD_BUFFER_RECORDING_STATE;
 
+    // the queries of the slot were reset ahead of the offscreen passes
+    if(!mVkCommandBuffers.offscreenSplit[mActiveCmdBuffer]) {
+        mTimestamps.Reset(mVkCommandBuffers.commandBuffer[mActiveCmdBuffer], mActiveCmdBuffer);
+        mOcclusionQueries.Reset(mVkCommandBuffers.commandBuffer[mActiveCmdBuffer], mActiveCmdBuffer);
+    }
+
     return true;
 }
 
 bool
-CommandBufferManager::BeginVkSecondaryCommandBuffer(const VkCommandBuffer *cmdBuffer, VkRenderPass renderPass, VkFramebuffer framebuffer)
+CommandBufferManager::BeginVkSecondaryCommandBuffer(const VkCommandBuffer *cmdBuffer, VkRenderPass renderPass, VkFramebuffer framebuffer, bool simultaneousUse)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
@@ -268,10 +561,11 @@ CommandBufferManager::BeginVkSecondaryCommandBuffer(const VkCommandBuffer *cmdBu
     VkCommandBufferBeginInfo cmdBeginInfo;
     cmdBeginInfo.sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
     cmdBeginInfo.pNext            = nullptr;
-    cmdBeginInfo.flags            = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    cmdBeginInfo.flags            = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT |
+                                    (simultaneousUse ? VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT : 0);
     cmdBeginInfo.pInheritanceInfo = &inheritanceInfo;
 
-    VkResult err = vkBeginCommandBuffer(*cmdBuffer, &cmdBeginInfo);
+    VkResult err = mVkContext->vkDispatch.vkBeginCommandBuffer(*cmdBuffer, &cmdBeginInfo);
 
     if(err != VK_SUCCESS) {
         return false;
@@ -291,7 +585,7 @@ CommandBufferManager::EndVkDrawCommandBuffer(void)
         return;
     }
 
-    vkEndCommandBuffer(mVkCommandBuffers.commandBuffer[mActiveCmdBuffer]);
+    mVkContext->vkDispatch.vkEndCommandBuffer(mVkCommandBuffers.commandBuffer[mActiveCmdBuffer]);
 
     mVkCommandBuffers.commandBufferState[mActiveCmdBuffer] = CMD_BUFFER_EXECUTABLE_STATE;
 }
@@ -301,61 +595,177 @@ CommandBufferManager::EndVkSecondaryCommandBuffer(const VkCommandBuffer *cmdBuff
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    vkEndCommandBuffer(*cmdBuffer);
+    mVkContext->vkDispatch.vkEndCommandBuffer(*cmdBuffer);
 }
 
 bool
-CommandBufferManager::SubmitVkDrawCommandBuffer(void)
+CommandBufferManager::SplitVkDrawCommandBuffer(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(mVkCommandBuffers.commandBufferState[mActiveCmdBuffer] == CMD_BUFFER_INITIAL_STATE) {
+    if(!mPresentable || mVkCommandBuffers.swapchainCommands[mActiveCmdBuffer]) {
+        return true;
+    }
+    mVkCommandBuffers.swapchainCommands[mActiveCmdBuffer] = true;
+
+    // only worth a batch of its own when there are offscreen passes and an acquisition to overlap them with
+    if(mVkCommandBuffers.commandBufferState[mActiveCmdBuffer] != CMD_BUFFER_RECORDING_STATE ||
+       !mVkContext->vkSyncItems->acquireSemaphoreFlag) {
         return true;
     }
 
+    EndOcclusionQuery();
+
+    VkResult err = mVkContext->vkDispatch.vkEndCommandBuffer(mVkCommandBuffers.commandBuffer[mActiveCmdBuffer]);
+    assert(!err);
+
+    if(err != VK_SUCCESS) {
+        return false;
+    }
+
+    // both come from the pool of the slot, which resets them together
+    std::swap(mVkCommandBuffers.commandBuffer[mActiveCmdBuffer], mVkCommandBuffers.offscreenCommandBuffer[mActiveCmdBuffer]);
+    mVkCommandBuffers.offscreenSplit[mActiveCmdBuffer]     = true;
+    mVkCommandBuffers.commandBufferState[mActiveCmdBuffer] = CMD_BUFFER_INITIAL_STATE;
+
+    return BeginVkDrawCommandBuffer();
+}
+
+bool
+CommandBufferManager::SubmitVkDrawCommandBuffer(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!WaitVkAuxCommandBuffer()) {
+        return false;
+    }
+
+    // a draw command buffer still being recorded is submitted along with
+    // any pending aux commands once it is ended
+    bool submitDraw = mVkCommandBuffers.commandBufferState[mActiveCmdBuffer] == CMD_BUFFER_EXECUTABLE_STATE;
+    if(mVkCommandBuffers.commandBufferState[mActiveCmdBuffer] == CMD_BUFFER_RECORDING_STATE || (!submitDraw && !HasPendingAuxCommands())) {
+        return false;
+    }
+
+    vector<VkCommandBuffer> cmdBuffers;
     vector<VkSemaphore> pSems;
     vector<VkPipelineStageFlags> pFlags;
-    if(mVkContext->vkSyncItems->acquireSemaphoreFlag) {
+    if(!SubmitVkPendingAuxCommandBuffers(&cmdBuffers, &pSems, &pFlags)) {
+        return false;
+    }
+
+    // the aux commands and the offscreen passes recorded ahead of the swapchain image
+    // go in a batch of their own, which does not wait for the image to be acquired
+    size_t offscreenCmdBuffers = 0;
+    size_t offscreenSems       = 0;
+    if(mVkCommandBuffers.offscreenSplit[mActiveCmdBuffer]) {
+        cmdBuffers.push_back(mVkCommandBuffers.offscreenCommandBuffer[mActiveCmdBuffer]);
+        offscreenCmdBuffers = cmdBuffers.size();
+        offscreenSems       = pSems.size();
+    }
+    if(submitDraw) {
+        cmdBuffers.push_back(mVkCommandBuffers.commandBuffer[mActiveCmdBuffer]);
+    }
+
+    // the acquire and draw semaphores chain the submissions to the swapchain images
+    // and are only taken by the contexts that render to them. Only the writes to the
+    // image wait for them, so that the vertex work may start before it is available
+    const VkPipelineStageFlags swapchainStages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+    if(mPresentable && mVkContext->vkSyncItems->acquireSemaphoreFlag) {
         pSems.push_back(mVkContext->vkSyncItems->vkAcquireSemaphore);
-        pFlags.push_back(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+        pFlags.push_back(swapchainStages);
     }
-    if(mVkContext->vkSyncItems->drawSemaphoreFlag) {
+    if(mPresentable && mVkContext->vkSyncItems->drawSemaphoreFlag) {
         pSems.push_back(mVkContext->vkSyncItems->vkDrawSemaphore);
-        pFlags.push_back(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+        pFlags.push_back(swapchainStages);
     }
 
-    VkSubmitInfo submitInfo;
+    VkSubmitInfo submitInfos[2];
+    uint32_t submitCount = 0;
+    if(offscreenCmdBuffers) {
+        VkSubmitInfo &offscreenInfo = submitInfos[submitCount++];
+        offscreenInfo.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        offscreenInfo.pNext                = nullptr;
+        offscreenInfo.commandBufferCount   = static_cast<uint32_t>(offscreenCmdBuffers);
+        offscreenInfo.pCommandBuffers      = cmdBuffers.data();
+        offscreenInfo.waitSemaphoreCount   = static_cast<uint32_t>(offscreenSems);
+        offscreenInfo.pWaitSemaphores      = pSems.data();
+        offscreenInfo.pWaitDstStageMask    = pFlags.data();
+        offscreenInfo.signalSemaphoreCount = 0;
+        offscreenInfo.pSignalSemaphores    = nullptr;
+    }
+
+    VkSubmitInfo &submitInfo = submitInfos[submitCount++];
     submitInfo.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
     submitInfo.pNext                = nullptr;
-    submitInfo.commandBufferCount   = 1;
-    submitInfo.pCommandBuffers      = &mVkCommandBuffers.commandBuffer[mActiveCmdBuffer];
-    submitInfo.waitSemaphoreCount   = static_cast<uint32_t>(pSems.size());
-    submitInfo.pWaitSemaphores      = pSems.data();
-    submitInfo.pWaitDstStageMask    = pFlags.data();
-    submitInfo.signalSemaphoreCount = 1;
-    submitInfo.pSignalSemaphores    = &mVkContext->vkSyncItems->vkDrawSemaphore;
-
-    mVkContext->vkSyncItems->drawSemaphoreFlag    = true;
-    mVkContext->vkSyncItems->acquireSemaphoreFlag = false;
-
-    VkResult err = vkQueueSubmit(mVkContext->vkQueue, 1, &submitInfo, mVkCommandBuffers.fence[mActiveCmdBuffer].GetFence());
+    submitInfo.commandBufferCount   = static_cast<uint32_t>(cmdBuffers.size() - offscreenCmdBuffers);
+    submitInfo.pCommandBuffers      = cmdBuffers.data() + offscreenCmdBuffers;
+    submitInfo.waitSemaphoreCount   = static_cast<uint32_t>(pSems.size() - offscreenSems);
+    submitInfo.pWaitSemaphores      = pSems.data() + offscreenSems;
+    submitInfo.pWaitDstStageMask    = pFlags.data() + offscreenSems;
+    submitInfo.signalSemaphoreCount = mPresentable ? 1 : 0;
+    submitInfo.pSignalSemaphores    = mPresentable ? &mVkContext->vkSyncItems->vkDrawSemaphore : nullptr;
+
+    if(mPresentable) {
+        mVkContext->vkSyncItems->drawSemaphoreFlag    = true;
+        mVkContext->vkSyncItems->acquireSemaphoreFlag = false;
+    }
+
+    VkResult err = SubmitVkGraphicsQueue(submitCount, submitInfos, &mVkCommandBuffers.fence[mActiveCmdBuffer], &mVkCommandBuffers.submissionId[mActiveCmdBuffer]);
     assert(!err);
 
     if(err != VK_SUCCESS) {
         return false;
     }
 
+    mVkCommandBuffers.offscreenSplit[mActiveCmdBuffer]    = false;
+    mVkCommandBuffers.swapchainCommands[mActiveCmdBuffer] = false;
     mVkCommandBuffers.commandBufferState[mActiveCmdBuffer] = CMD_BUFFER_SUBMITED_STATE;
+    ++mStatistics.drawSubmits;
+
+    mTimestamps.SetSubmitted(mActiveCmdBuffer, mVkCommandBuffers.submissionId[mActiveCmdBuffer]);
+    mTimestamps.SetSubmitted(GLOVE_MAX_FRAMES_IN_FLIGHT + mActiveCmdBuffer, mVkCommandBuffers.submissionId[mActiveCmdBuffer]);
+    mOcclusionQueries.SetSubmitted(mActiveCmdBuffer, mVkCommandBuffers.submissionId[mActiveCmdBuffer]);
 
     mLastSubmittedBuffer = mActiveCmdBuffer;
 
-    mActiveCmdBuffer = (mActiveCmdBuffer + 1) % GLOVE_NUM_COMMAND_BUFFERS;
+    mActiveCmdBuffer = (mActiveCmdBuffer + 1) % GLOVE_MAX_FRAMES_IN_FLIGHT;
+
+    // The next slot can be recorded only after the GPU has consumed it,
+    // i.e. this waits on the oldest frame in flight.
+    if(!WaitVkDrawCommandBuffer(mActiveCmdBuffer)) {
+        return false;
+    }
 
     mVkCommandBuffers.commandBufferState[mActiveCmdBuffer] = CMD_BUFFER_INITIAL_STATE;
 
     return true;
 }
 
+bool
+CommandBufferManager::WaitVkDrawCommandBuffer(uint32_t index)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(mVkCommandBuffers.commandBufferState[index] != CMD_BUFFER_SUBMITED_STATE) {
+        return true;
+    }
+
+    if(!WaitVkSubmission(&mVkCommandBuffers.fence[index], mVkCommandBuffers.submissionId[index])) {
+        return false;
+    }
+
+    if(!ResetVkCmdPools(index)) {
+        return false;
+    }
+
+    mVkCommandBuffers.commandBufferState[index]         = CMD_BUFFER_INITIAL_STATE;
+    mVkCommandBuffers.auxCommandBufferState[index]      = CMD_BUFFER_INITIAL_STATE;
+    mVkCommandBuffers.transferCommandBufferState[index] = CMD_BUFFER_INITIAL_STATE;
+
+    return true;
+}
+
 bool
 CommandBufferManager::WaitLastSubmition(void)
 {
@@ -363,14 +773,16 @@ CommandBufferManager::WaitLastSubmition(void)
 
     if(mLastSubmittedBuffer != GLOVE_NO_BUFFER_TO_WAIT) {
 
-        if(!mVkCommandBuffers.fence[mLastSubmittedBuffer].Wait(VK_TRUE, GLOVE_FENCE_WAIT_TIMEOUT))
-            return false;
-
-        if(!mVkCommandBuffers.fence[mLastSubmittedBuffer].Reset()) {
+        // the latest value covers every earlier submission at once
+        if(mUseTimeline && !WaitVkSubmission(nullptr, mLastSubmissionId)) {
             return false;
         }
 
-        FreeResources();
+        for(uint32_t i = 0; i < mVkCommandBuffers.commandBufferState.size(); ++i) {
+            if(!WaitVkDrawCommandBuffer(i)) {
+                return false;
+            }
+        }
 
         mLastSubmittedBuffer = GLOVE_NO_BUFFER_TO_WAIT;
         return true;
@@ -384,16 +796,103 @@ CommandBufferManager::BeginVkAuxCommandBuffer(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    // the aux commands recorded from now on must execute after the pending uploads
+    if(HasPendingTransferCommands()) {
+        mPostTransferAuxCommands = true;
+        return true;
+    }
+
+    if(mVkCommandBuffers.auxCommandBufferState[mActiveCmdBuffer] == CMD_BUFFER_RECORDING_STATE) {
+        return true;
+    }
+
+    if(!WaitVkAuxCommandBuffer()) {
+        return false;
+    }
+
+    // the slot's pool is only reset once its fence signals, so a buffer
+    // already submitted in this frame cannot be begun again
+    VkCommandBuffer *auxCmdBuffer = AllocateVkCmdBuffer(&mVkCommandBuffers.auxCmdBufferPool[mActiveCmdBuffer], mVkCmdPools[mActiveCmdBuffer], VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+    if(auxCmdBuffer == nullptr) {
+        return false;
+    }
+    mVkCommandBuffers.auxCommandBuffer[mActiveCmdBuffer] = *auxCmdBuffer;
+
     VkCommandBufferBeginInfo info;
     info.sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
     info.pNext            = nullptr;
-    info.flags            = 0;
+    info.flags            = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
     info.pInheritanceInfo = nullptr;
 
-    VkResult err = vkBeginCommandBuffer(mVkAuxCommandBuffer, &info);
+    VkResult err = mVkContext->vkDispatch.vkBeginCommandBuffer(mVkCommandBuffers.auxCommandBuffer[mActiveCmdBuffer], &info);
     assert(!err);
 
-    return (err != VK_ERROR_OUT_OF_HOST_MEMORY && err != VK_ERROR_OUT_OF_DEVICE_MEMORY);
+    if(err != VK_SUCCESS) {
+        return false;
+    }
+
+    mVkCommandBuffers.auxCommandBufferState[mActiveCmdBuffer] = CMD_BUFFER_RECORDING_STATE;
+
+    mTimestamps.Reset(mVkCommandBuffers.auxCommandBuffer[mActiveCmdBuffer], GLOVE_MAX_FRAMES_IN_FLIGHT + mActiveCmdBuffer);
+    if(mTraceTimestamps) {
+        mTimestamps.WriteScope(mVkCommandBuffers.auxCommandBuffer[mActiveCmdBuffer], GLOVE_MAX_FRAMES_IN_FLIGHT + mActiveCmdBuffer,
+                               VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, "aux batch", false);
+    }
+
+    return true;
+}
+
+bool
+CommandBufferManager::BeginVkTransferCommandBuffer(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // once aux commands depend on the pending uploads, the following uploads
+    // have to stay on the graphics queue to preserve the recording order
+    if(!mVkContext->mIsTransferQueueSupported || mPostTransferAuxCommands) {
+        return false;
+    }
+
+    if(HasPendingTransferCommands()) {
+        return true;
+    }
+
+    // ownership releases are recorded after the pending aux commands
+    if(!BeginVkAuxCommandBuffer()) {
+        return false;
+    }
+
+    VkCommandBuffer *transferCmdBuffer = AllocateVkCmdBuffer(&mVkCommandBuffers.transferCmdBufferPool[mActiveCmdBuffer], mVkTransferCmdPools[mActiveCmdBuffer], VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+    VkCommandBuffer *postTransferCmdBuffer = AllocateVkCmdBuffer(&mVkCommandBuffers.postTransferCmdBufferPool[mActiveCmdBuffer], mVkCmdPools[mActiveCmdBuffer], VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+    if(transferCmdBuffer == nullptr || postTransferCmdBuffer == nullptr) {
+        return false;
+    }
+    mVkCommandBuffers.transferCommandBuffer[mActiveCmdBuffer]     = *transferCmdBuffer;
+    mVkCommandBuffers.postTransferCommandBuffer[mActiveCmdBuffer] = *postTransferCmdBuffer;
+
+    VkCommandBufferBeginInfo info;
+    info.sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    info.pNext            = nullptr;
+    info.flags            = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    info.pInheritanceInfo = nullptr;
+
+    VkResult err = mVkContext->vkDispatch.vkBeginCommandBuffer(mVkCommandBuffers.transferCommandBuffer[mActiveCmdBuffer], &info);
+    assert(!err);
+
+    if(err != VK_SUCCESS) {
+        return false;
+    }
+
+    err = mVkContext->vkDispatch.vkBeginCommandBuffer(mVkCommandBuffers.postTransferCommandBuffer[mActiveCmdBuffer], &info);
+    assert(!err);
+
+    if(err != VK_SUCCESS) {
+        return false;
+    }
+
+    mVkCommandBuffers.transferCommandBufferState[mActiveCmdBuffer] = CMD_BUFFER_RECORDING_STATE;
+
+    return true;
 }
 
 bool
@@ -401,38 +900,436 @@ CommandBufferManager::EndVkAuxCommandBuffer(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    VkResult err = vkEndCommandBuffer(mVkAuxCommandBuffer);
+    if(mVkCommandBuffers.auxCommandBufferState[mActiveCmdBuffer] != CMD_BUFFER_RECORDING_STATE) {
+        return true;
+    }
+
+    if(mTraceTimestamps) {
+        mTimestamps.WriteScope(mVkCommandBuffers.auxCommandBuffer[mActiveCmdBuffer], GLOVE_MAX_FRAMES_IN_FLIGHT + mActiveCmdBuffer,
+                               VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, "aux batch", true);
+    }
+
+    VkResult err = mVkContext->vkDispatch.vkEndCommandBuffer(mVkCommandBuffers.auxCommandBuffer[mActiveCmdBuffer]);
     assert(!err);
 
+    mVkCommandBuffers.auxCommandBufferState[mActiveCmdBuffer] = CMD_BUFFER_EXECUTABLE_STATE;
+
     return (err != VK_ERROR_OUT_OF_HOST_MEMORY && err != VK_ERROR_OUT_OF_DEVICE_MEMORY);
 }
 
 bool
-CommandBufferManager::SubmitVkAuxCommandBuffer(void)
+CommandBufferManager::SubmitVkPendingAuxCommandBuffers(vector<VkCommandBuffer> *cmdBuffers, vector<VkSemaphore> *waitSemaphores, vector<VkPipelineStageFlags> *waitStages)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    // the batched copies read staging memory that may still be written by the upload worker
+    if(mUploadWorker) {
+        mUploadWorker->Wait();
+    }
+
+    if(!HasPendingTransferCommands()) {
+        if(mVkCommandBuffers.auxCommandBufferState[mActiveCmdBuffer] == CMD_BUFFER_RECORDING_STATE) {
+            if(!EndVkAuxCommandBuffer()) {
+                return false;
+            }
+            cmdBuffers->push_back(mVkCommandBuffers.auxCommandBuffer[mActiveCmdBuffer]);
+            mVkCommandBuffers.auxCommandBufferState[mActiveCmdBuffer] = CMD_BUFFER_SUBMITED_STATE;
+        }
+        return true;
+    }
+
+    // aux (ownership releases) -> transfer queue -> post-transfer (ownership acquires) -> caller's batch
+    if(!EndVkAuxCommandBuffer()) {
+        return false;
+    }
+
+    VkResult err = mVkContext->vkDispatch.vkEndCommandBuffer(mVkCommandBuffers.transferCommandBuffer[mActiveCmdBuffer]);
+    assert(!err);
+
+    if(err != VK_SUCCESS) {
+        return false;
+    }
+
+    err = mVkContext->vkDispatch.vkEndCommandBuffer(mVkCommandBuffers.postTransferCommandBuffer[mActiveCmdBuffer]);
+    assert(!err);
+
+    if(err != VK_SUCCESS) {
+        return false;
+    }
+
+    VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
     VkSubmitInfo info = {};
     info.sType                  = VK_STRUCTURE_TYPE_SUBMIT_INFO;
     info.pNext                  = nullptr;
     info.commandBufferCount     = 1;
-    info.pCommandBuffers        = &mVkAuxCommandBuffer;
+    info.pCommandBuffers        = &mVkCommandBuffers.auxCommandBuffer[mActiveCmdBuffer];
+    info.signalSemaphoreCount   = 1;
+    info.pSignalSemaphores      = &mVkCommandBuffers.preTransferSemaphore[mActiveCmdBuffer];
 
-    VkResult err = vkQueueSubmit(mVkContext->vkQueue, 1, &info, mVkAuxFence);
+    err = mVkContext->vkSubmissionQueue->Submit(mVkQueue, 1, &info, VK_NULL_HANDLE);
     assert(!err);
 
-    return (err != VK_ERROR_OUT_OF_HOST_MEMORY && err != VK_ERROR_OUT_OF_DEVICE_MEMORY && err != VK_ERROR_DEVICE_LOST);
+    if(err != VK_SUCCESS) {
+        return false;
+    }
+
+    info.pCommandBuffers        = &mVkCommandBuffers.transferCommandBuffer[mActiveCmdBuffer];
+    info.waitSemaphoreCount     = 1;
+    info.pWaitSemaphores        = &mVkCommandBuffers.preTransferSemaphore[mActiveCmdBuffer];
+    info.pWaitDstStageMask      = &waitStage;
+    info.pSignalSemaphores      = &mVkCommandBuffers.postTransferSemaphore[mActiveCmdBuffer];
+
+    err = mVkContext->vkSubmissionQueue->Submit(mVkContext->vkTransferQueue, 1, &info, VK_NULL_HANDLE);
+    assert(!err);
+
+    if(err != VK_SUCCESS) {
+        return false;
+    }
+
+    mVkCommandBuffers.auxCommandBufferState[mActiveCmdBuffer]      = CMD_BUFFER_SUBMITED_STATE;
+    mVkCommandBuffers.transferCommandBufferState[mActiveCmdBuffer] = CMD_BUFFER_SUBMITED_STATE;
+    mPostTransferAuxCommands = false;
+
+    cmdBuffers->push_back(mVkCommandBuffers.postTransferCommandBuffer[mActiveCmdBuffer]);
+    waitSemaphores->push_back(mVkCommandBuffers.postTransferSemaphore[mActiveCmdBuffer]);
+    waitStages->push_back(waitStage);
+
+    return true;
 }
 
 bool
-CommandBufferManager::WaitVkAuxCommandBuffer(void)
+CommandBufferManager::SubmitVkAuxCommandBuffer(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    VkResult err = vkQueueWaitIdle(mVkContext->vkQueue);
+    if(mVkCommandBuffers.auxCommandBufferState.empty() || !HasPendingAuxCommands()) {
+        return true;
+    }
+
+    vector<VkCommandBuffer> cmdBuffers;
+    vector<VkSemaphore> pSems;
+    vector<VkPipelineStageFlags> pFlags;
+    if(!SubmitVkPendingAuxCommandBuffers(&cmdBuffers, &pSems, &pFlags)) {
+        return false;
+    }
+
+    VkSubmitInfo info = {};
+    info.sType                  = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    info.pNext                  = nullptr;
+    info.commandBufferCount     = static_cast<uint32_t>(cmdBuffers.size());
+    info.pCommandBuffers        = cmdBuffers.data();
+    info.waitSemaphoreCount     = static_cast<uint32_t>(pSems.size());
+    info.pWaitSemaphores        = pSems.data();
+    info.pWaitDstStageMask      = pFlags.data();
+
+    VkResult err = SubmitVkGraphicsQueue(1, &info, &mAuxFence, &mAuxSubmissionId);
     assert(!err);
 
-    return (err != VK_ERROR_OUT_OF_HOST_MEMORY && err != VK_ERROR_OUT_OF_DEVICE_MEMORY && err != VK_ERROR_DEVICE_LOST);
+    if(err != VK_SUCCESS) {
+        return false;
+    }
+
+    mAuxFenceSubmitted = true;
+    ++mStatistics.auxSubmits;
+
+    mTimestamps.SetSubmitted(GLOVE_MAX_FRAMES_IN_FLIGHT + mActiveCmdBuffer, mAuxSubmissionId);
+
+    return true;
+}
+
+uint64_t
+CommandBufferManager::WriteTimestamp(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!BeginVkDrawCommandBuffer()) {
+        return 0;
+    }
+
+    return mTimestamps.Write(mVkCommandBuffers.commandBuffer[mActiveCmdBuffer], mActiveCmdBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+}
+
+void
+CommandBufferManager::WriteTraceScope(const char *label, bool end)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(mTraceTimestamps) {
+        mTimestamps.WriteScope(mVkCommandBuffers.commandBuffer[mActiveCmdBuffer], mActiveCmdBuffer,
+                               end ? VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, label, end);
+    }
+}
+
+bool
+CommandBufferManager::BeginOcclusionQuery(VkCommandBuffer cmdBuffer, uint64_t *ticket)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    *ticket = 0;
+    if(mOcclusionTicket && mOcclusionCmdBuffer == cmdBuffer) {
+        return true;
+    }
+    EndOcclusionQuery();
+
+    // secondary command buffers execute within the slot of the draw command buffer
+    mOcclusionTicket    = mOcclusionQueries.Begin(cmdBuffer, mActiveCmdBuffer);
+    mOcclusionCmdBuffer = cmdBuffer;
+    *ticket             = mOcclusionTicket;
+
+    return mOcclusionTicket != 0;
+}
+
+void
+CommandBufferManager::EndOcclusionQuery(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(mOcclusionTicket) {
+        mOcclusionQueries.End(mOcclusionCmdBuffer, mOcclusionTicket);
+        mOcclusionTicket = 0;
+    }
+}
+
+void
+CommandBufferManager::BeginDebugLabel(const char *label)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+#ifdef VK_EXT_debug_utils
+    if(!mVkContext->mIsDebugUtilsSupported || !BeginVkDrawCommandBuffer()) {
+        return;
+    }
+
+    VkDebugUtilsLabelEXT info;
+    memset(static_cast<void *>(&info), 0, sizeof(info));
+    info.sType      = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
+    info.pLabelName = label;
+
+    mVkContext->fpCmdBeginDebugUtilsLabel(mVkCommandBuffers.commandBuffer[mActiveCmdBuffer], &info);
+#endif // VK_EXT_debug_utils
+}
+
+void
+CommandBufferManager::EndDebugLabel(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+#ifdef VK_EXT_debug_utils
+    if(!mVkContext->mIsDebugUtilsSupported || !BeginVkDrawCommandBuffer()) {
+        return;
+    }
+
+    mVkContext->fpCmdEndDebugUtilsLabel(mVkCommandBuffers.commandBuffer[mActiveCmdBuffer]);
+#endif // VK_EXT_debug_utils
+}
+
+void
+CommandBufferManager::InsertDebugLabel(const char *label)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+#ifdef VK_EXT_debug_utils
+    if(!mVkContext->mIsDebugUtilsSupported || !BeginVkDrawCommandBuffer()) {
+        return;
+    }
+
+    VkDebugUtilsLabelEXT info;
+    memset(static_cast<void *>(&info), 0, sizeof(info));
+    info.sType      = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
+    info.pLabelName = label;
+
+    mVkContext->fpCmdInsertDebugUtilsLabel(mVkCommandBuffers.commandBuffer[mActiveCmdBuffer], &info);
+#endif // VK_EXT_debug_utils
+}
+
+bool
+CommandBufferManager::WaitSubmission(uint64_t submissionId)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(IsSubmissionComplete(submissionId)) {
+        return true;
+    }
+
+    if(submissionId > mLastSubmissionId) {
+        return false;
+    }
+
+    if(mUseTimeline) {
+        return WaitVkSubmission(nullptr, submissionId);
+    }
+
+    // the earliest fence at or after the submission covers it, without waiting for the later ones
+    if(mAuxFenceSubmitted && mAuxSubmissionId == submissionId) {
+        return WaitVkAuxCommandBuffer();
+    }
+
+    int32_t index = -1;
+    for(uint32_t i = 0; i < mVkCommandBuffers.commandBufferState.size(); ++i) {
+        if(mVkCommandBuffers.commandBufferState[i] == CMD_BUFFER_SUBMITED_STATE &&
+           mVkCommandBuffers.submissionId[i] >= submissionId &&
+           (index < 0 || mVkCommandBuffers.submissionId[i] < mVkCommandBuffers.submissionId[index])) {
+            index = static_cast<int32_t>(i);
+        }
+    }
+
+    if(index < 0) {
+        return WaitVkAuxCommandBuffer();
+    }
+
+    return WaitVkDrawCommandBuffer(static_cast<uint32_t>(index));
+}
+
+bool
+CommandBufferManager::SubmitVkFence(const Fence *fence)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // an empty batch signals the fence once all the prior submissions complete
+    VkResult err = mVkContext->vkSubmissionQueue->Submit(mVkQueue, 0, nullptr, fence->GetFence());
+    assert(!err);
+
+    return (err == VK_SUCCESS);
+}
+
+bool
+CommandBufferManager::WaitVkAuxCommandBuffer(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!mAuxFenceSubmitted) {
+        return true;
+    }
+
+    if(!WaitVkSubmission(&mAuxFence, mAuxSubmissionId)) {
+        return false;
+    }
+
+    mAuxFenceSubmitted = false;
+    mVkCommandBuffers.auxCommandBufferState[mActiveCmdBuffer]      = CMD_BUFFER_INITIAL_STATE;
+    mVkCommandBuffers.transferCommandBufferState[mActiveCmdBuffer] = CMD_BUFFER_INITIAL_STATE;
+
+    return true;
+}
+
+VkResult
+CommandBufferManager::SubmitVkGraphicsQueue(uint32_t submitCount, VkSubmitInfo *submitInfos, const Fence *fence, uint64_t *submissionId)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    *submissionId = ++mLastSubmissionId;
+
+    if(!mUseTimeline) {
+        return mVkContext->vkSubmissionQueue->Submit(mVkQueue, submitCount, submitInfos, fence->GetFence());
+    }
+
+#ifdef VK_KHR_timeline_semaphore
+    // the batches complete in order, so the last one signals the value. Binary semaphores ignore their signal value
+    VkSubmitInfo *submitInfo = &submitInfos[submitCount - 1];
+    vector<VkSemaphore> signalSemaphores(submitInfo->pSignalSemaphores, submitInfo->pSignalSemaphores + submitInfo->signalSemaphoreCount);
+    vector<uint64_t> signalValues(submitInfo->signalSemaphoreCount, 0);
+    signalSemaphores.push_back(mTimeline.GetSemaphore());
+    signalValues.push_back(*submissionId);
+
+    VkTimelineSemaphoreSubmitInfoKHR timelineInfo;
+    timelineInfo.sType                     = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+    timelineInfo.pNext                     = submitInfo->pNext;
+    timelineInfo.waitSemaphoreValueCount   = 0;
+    timelineInfo.pWaitSemaphoreValues      = nullptr;
+    timelineInfo.signalSemaphoreValueCount = static_cast<uint32_t>(signalValues.size());
+    timelineInfo.pSignalSemaphoreValues    = signalValues.data();
+
+    submitInfo->pNext                = &timelineInfo;
+    submitInfo->signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size());
+    submitInfo->pSignalSemaphores    = signalSemaphores.data();
+
+    return mVkContext->vkSubmissionQueue->Submit(mVkQueue, submitCount, submitInfos, VK_NULL_HANDLE);
+#else
+    NOT_REACHED();
+    return VK_ERROR_FEATURE_NOT_PRESENT;
+#endif // VK_KHR_timeline_semaphore
+}
+
+bool
+CommandBufferManager::WaitVkSubmission(Fence *fence, uint64_t submissionId)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    fenceWaitPolicy_t policy(GLOVE_FENCE_WAIT_TIMEOUT);
+    fenceWaitInfo_t   info;
+
+    if(mUseTimeline) {
+        if(mTimeline.Wait(submissionId, policy, &info) != VK_SUCCESS) {
+            return false;
+        }
+    } else {
+        if(fence->Wait(policy, &info) != VK_SUCCESS) {
+            return false;
+        }
+
+        if(!fence->Reset()) {
+            return false;
+        }
+    }
+
+    ++mStatistics.waits;
+    mStatistics.spinWaits     += info.blocked ? 0 : 1;
+    mStatistics.waitTimeUs    += info.timeUs;
+    mStatistics.maxWaitTimeUs  = std::max(mStatistics.maxWaitTimeUs, info.timeUs);
+
+    // a signaled fence implies that all earlier submissions have completed too
+    if(submissionId > mCompletedSubmissionId) {
+        mCompletedSubmissionId = submissionId;
+    }
+
+    return true;
+}
+
+bool
+CommandBufferManager::IsSubmissionComplete(uint64_t submissionId)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(submissionId <= mCompletedSubmissionId) {
+        return true;
+    }
+
+    if(mUseTimeline) {
+        mCompletedSubmissionId = mTimeline.GetCompletedValue();
+        return submissionId <= mCompletedSubmissionId;
+    }
+
+    for(uint32_t i = 0; i < mVkCommandBuffers.fence.size(); ++i) {
+        if(mVkCommandBuffers.commandBufferState[i] == CMD_BUFFER_SUBMITED_STATE &&
+           mVkCommandBuffers.submissionId[i] > mCompletedSubmissionId &&
+           mVkCommandBuffers.fence[i].IsSignaled()) {
+            mCompletedSubmissionId = mVkCommandBuffers.submissionId[i];
+        }
+    }
+
+    return submissionId <= mCompletedSubmissionId;
+}
+
+uint32_t
+CommandBufferManager::GetCommandBufferCount(void) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    uint32_t count = static_cast<uint32_t>(mVkCommandBuffers.commandBuffer.size()          +
+                                           mVkCommandBuffers.offscreenCommandBuffer.size() +
+                                           mVkCommandBuffers.auxCommandBuffer.size()      +
+                                           mVkCommandBuffers.transferCommandBuffer.size() +
+                                           mVkCommandBuffers.postTransferCommandBuffer.size());
+
+    for(const std::vector<CommandBufferPool> *pools : { &mVkCommandBuffers.secondaryCmdBufferPool, &mVkCommandBuffers.auxCmdBufferPool,
+                                                        &mVkCommandBuffers.transferCmdBufferPool,  &mVkCommandBuffers.postTransferCmdBufferPool }) {
+        for(const CommandBufferPool &pool : *pools) {
+            count += pool.GetSize();
+        }
+    }
+
+    return count;
 }
 
 }
@@ -25,10 +25,23 @@
 #define __VKCBMANAGER_H__
 
 #include <vector>
+#include <cstring>
 #include "context.h"
 #include "fence.h"
+#include "timeline.h"
+#include "timestampPool.h"
+#include "occlusionPool.h"
 #include "commandBufferPool.h"
 
+class UploadWorker;
+
+/// GPU time of the render passes and aux batches goes to the binary traces, when set
+#define GLOVE_GPU_TIMESTAMPS_ENV                        "GLOVE_GPU_TIMESTAMPS"
+
+#ifndef GLOVE_MAX_FRAMES_IN_FLIGHT
+#define GLOVE_MAX_FRAMES_IN_FLIGHT                      3
+#endif // GLOVE_MAX_FRAMES_IN_FLIGHT
+
 namespace vulkanAPI {
 
 typedef enum {
@@ -39,40 +52,105 @@ typedef enum {
 } cmdBufferState_t;
 
 class CommandBufferManager final {
+public:
+    typedef struct Statistics {
+        uint32_t                   drawSubmits;
+        uint32_t                   auxSubmits;
+        uint32_t                   secondaryCommandBuffers;
+        /// waits of the host on submissions, those that completed while polling, and the time spent in them
+        uint32_t                   waits;
+        uint32_t                   spinWaits;
+        uint64_t                   waitTimeUs;
+        uint64_t                   maxWaitTimeUs;
+
+        Statistics()               { memset(static_cast<void *>(this), 0, sizeof(*this)); }
+    } Statistics;
+
 private:
 
     typedef struct State {
         std::vector<VkCommandBuffer>         commandBuffer;
         std::vector<cmdBufferState_t>        commandBufferState;
+        /// the offscreen passes ended ahead of the first commands on the swapchain image, when split
+        std::vector<VkCommandBuffer>         offscreenCommandBuffer;
+        std::vector<bool>                    offscreenSplit;
+        std::vector<bool>                    swapchainCommands;
         std::vector<Fence>                   fence;
+        std::vector<uint64_t>                submissionId;
+        std::vector<CommandBufferPool>       secondaryCmdBufferPool;
+        std::vector<CommandBufferPool>       auxCmdBufferPool;
+        std::vector<CommandBufferPool>       transferCmdBufferPool;
+        std::vector<CommandBufferPool>       postTransferCmdBufferPool;
+        std::vector<VkCommandBuffer>         auxCommandBuffer;
+        std::vector<cmdBufferState_t>        auxCommandBufferState;
+        std::vector<VkCommandBuffer>         transferCommandBuffer;
+        std::vector<VkCommandBuffer>         postTransferCommandBuffer;
+        std::vector<cmdBufferState_t>        transferCommandBufferState;
+        std::vector<VkSemaphore>             preTransferSemaphore;
+        std::vector<VkSemaphore>             postTransferSemaphore;
 
         State()  { FUN_ENTRY(GL_LOG_TRACE); }
         ~State() { FUN_ENTRY(GL_LOG_TRACE); }
     } State;
 
-    VkCommandPool                   mVkCmdPool;
+    std::vector<VkCommandPool>      mVkCmdPools;
+    std::vector<VkCommandPool>      mVkTransferCmdPools;
+    /// the secondary command buffers of the command bundles outlive the frames, so their pool is never reset
+    VkCommandPool                   mVkBundleCmdPool;
+    CommandBufferPool               mBundleCmdBufferPool;
     const vkContext_t              *mVkContext;
+    /// graphics queue of the priority of the GL context
+    VkQueue                         mVkQueue;
 
     uint32_t                        mActiveCmdBuffer;
     int32_t                         mLastSubmittedBuffer;
 
     State                           mVkCommandBuffers;
 
-    VkCommandBuffer                 mVkAuxCommandBuffer;
-    VkFence                         mVkAuxFence;
-    CommandBufferPool               mSecondaryCmdBufferPool;
+    Fence                           mAuxFence;
+    bool                            mAuxFenceSubmitted;
+    uint64_t                        mAuxSubmissionId;
+
+    Timeline                        mTimeline;
+    bool                            mUseTimeline;
+    /// the draw command buffers write to the first slots, the aux ones to the slots after them
+    TimestampPool                   mTimestamps;
+    bool                            mTraceTimestamps;
+    /// the draw command buffers begin the occlusion queries of their slots
+    OcclusionPool                   mOcclusionQueries;
+    /// the occlusion query open in mOcclusionCmdBuffer, 0 for none
+    uint64_t                        mOcclusionTicket;
+    VkCommandBuffer                 mOcclusionCmdBuffer;
+    uint64_t                        mLastSubmissionId;
+    uint64_t                        mCompletedSubmissionId;
+    bool                            mPostTransferAuxCommands;
+    /// renders to swapchain images, so submissions are chained with the acquire and draw semaphores
+    bool                            mPresentable;
+    /// converts uploads into the staging memory the batched copies read from
+    UploadWorker                   *mUploadWorker;
+    Statistics                      mStatistics;
 
     void FreeResources(void);
+    VkCommandBuffer *AllocateVkCmdBuffer(CommandBufferPool *cmdBufferPool, VkCommandPool vkCmdPool, VkCommandBufferLevel level);
+    void FreeVkCmdBuffers(std::vector<CommandBufferPool> *cmdBufferPools, const std::vector<VkCommandPool> &vkCmdPools);
+    bool ResetVkCmdPools(uint32_t index);
+    bool AllocateVkTransferCmdBuffers(void);
+    void DestroyVkTransferCmdBuffers(void);
+    bool WaitVkDrawCommandBuffer(uint32_t index);
+    VkResult SubmitVkGraphicsQueue(uint32_t submitCount, VkSubmitInfo *submitInfos, const Fence *fence, uint64_t *submissionId);
+    bool WaitVkSubmission(Fence *fence, uint64_t submissionId);
+    bool SubmitVkPendingAuxCommandBuffers(vector<VkCommandBuffer> *cmdBuffers, vector<VkSemaphore> *waitSemaphores, vector<VkPipelineStageFlags> *waitStages);
 
 public:
 // Constructor
-    CommandBufferManager(const vkContext_t *context = nullptr);
+    CommandBufferManager(const vkContext_t *context = nullptr, VkQueue queue = VK_NULL_HANDLE);
 
 // Destructor
     ~CommandBufferManager();
 
 // Release Functions
     void Release(void);
+    inline void ResetStatistics(void)                                           { FUN_ENTRY(GL_LOG_TRACE); mStatistics = Statistics(); }
 
 // Allocate Functions
     bool AllocateVkCmdPool(void);
@@ -81,28 +159,78 @@ public:
 // Destroy Functions
     void DestroyVkCmdBuffers(void);
     VkCommandBuffer *AllocateVkSecondaryCmdBuffers(uint32_t numOfBuffers);
+    VkCommandBuffer *AllocateVkBundleCmdBuffer(void);
+    void FreeVkBundleCmdBuffer(VkCommandBuffer *cmdBuffer);
 
 // Begin Functions
     bool BeginVkAuxCommandBuffer(void);
+    bool BeginVkTransferCommandBuffer(void);
     bool BeginVkDrawCommandBuffer(void);
-    bool BeginVkSecondaryCommandBuffer(const VkCommandBuffer *cmdBuffer, VkRenderPass renderPass, VkFramebuffer framebuffer);
+    /// simultaneousUse lets the secondary command buffer be executed by several primary ones that are pending, as bundles are
+    bool BeginVkSecondaryCommandBuffer(const VkCommandBuffer *cmdBuffer, VkRenderPass renderPass, VkFramebuffer framebuffer, bool simultaneousUse = false);
 
 // End Functions
     bool EndVkAuxCommandBuffer(void);
     void EndVkDrawCommandBuffer(void);
     void EndVkSecondaryCommandBuffer(const VkCommandBuffer *cmdBuffer);
 
+// Split Functions
+    /// called ahead of the commands on the swapchain image, so that the offscreen passes before them do not wait for its acquisition
+    bool SplitVkDrawCommandBuffer(void);
+
 // Submit Functions
     bool SubmitVkDrawCommandBuffer(void);
     bool SubmitVkAuxCommandBuffer(void);
+    bool SubmitVkFence(const Fence *fence);
+
+// Timestamp Functions
+    /// written to the draw command buffer once its previous commands complete
+    uint64_t WriteTimestamp(void);
+    void WriteTraceScope(const char *label, bool end);
+
+// Occlusion Query Functions
+    /// keeps the occlusion query open in cmdBuffer or begins one, returned in ticket, false when the draws that follow cannot be counted
+    bool BeginOcclusionQuery(VkCommandBuffer cmdBuffer, uint64_t *ticket);
+    /// ends the open occlusion query, before the render pass or the secondary command buffer it was begun in ends
+    void EndOcclusionQuery(void);
+
+// Label Functions
+    /// VK_EXT_debug_utils labels of the draw command buffer, ignored without the extension
+    void BeginDebugLabel(const char *label);
+    void EndDebugLabel(void);
+    void InsertDebugLabel(const char *label);
 
 // Wait Functions
     bool WaitLastSubmition(void);
     bool WaitVkAuxCommandBuffer(void);
+    bool WaitSubmission(uint64_t submissionId);
 
 // Get Functions
     inline VkCommandBuffer GetActiveCommandBuffer(void)                   const { FUN_ENTRY(GL_LOG_TRACE); return mVkCommandBuffers.commandBuffer[mActiveCmdBuffer]; }
-    inline VkCommandBuffer GetAuxCommandBuffer(void)                      const { FUN_ENTRY(GL_LOG_TRACE); return mVkAuxCommandBuffer; }
+    inline VkQueue         GetVkQueue(void)                               const { FUN_ENTRY(GL_LOG_TRACE); return mVkQueue; }
+    inline uint32_t        GetActiveCommandBufferIndex(void)              const { FUN_ENTRY(GL_LOG_TRACE); return mActiveCmdBuffer; }
+    inline uint64_t        GetSubmissionId(uint32_t index)                const { FUN_ENTRY(GL_LOG_TRACE); return mVkCommandBuffers.submissionId[index]; }
+    inline uint64_t        GetLastSubmissionId(void)                      const { FUN_ENTRY(GL_LOG_TRACE); return mLastSubmissionId; }
+    inline const Statistics *GetStatistics(void)                          const { FUN_ENTRY(GL_LOG_TRACE); return &mStatistics; }
+    uint32_t               GetCommandBufferCount(void)                    const;
+    inline TimestampPool  *GetTimestampPool(void)                               { FUN_ENTRY(GL_LOG_TRACE); return &mTimestamps; }
+    inline OcclusionPool  *GetOcclusionPool(void)                               { FUN_ENTRY(GL_LOG_TRACE); return &mOcclusionQueries; }
+    inline VkCommandBuffer GetAuxCommandBuffer(void)                      const { FUN_ENTRY(GL_LOG_TRACE); return HasPendingTransferCommands() ? mVkCommandBuffers.postTransferCommandBuffer[mActiveCmdBuffer] :
+                                                                                                                                 mVkCommandBuffers.auxCommandBuffer[mActiveCmdBuffer]; }
+    inline VkCommandBuffer GetTransferCommandBuffer(void)                 const { FUN_ENTRY(GL_LOG_TRACE); return mVkCommandBuffers.transferCommandBuffer[mActiveCmdBuffer]; }
+    inline VkCommandBuffer GetTransferReleaseCommandBuffer(void)          const { FUN_ENTRY(GL_LOG_TRACE); return mVkCommandBuffers.auxCommandBuffer[mActiveCmdBuffer]; }
+    inline VkCommandBuffer GetTransferAcquireCommandBuffer(void)          const { FUN_ENTRY(GL_LOG_TRACE); return mVkCommandBuffers.postTransferCommandBuffer[mActiveCmdBuffer]; }
+
+// Set Functions
+    inline void            SetUploadWorker(UploadWorker *worker)                { FUN_ENTRY(GL_LOG_TRACE); mUploadWorker = worker; }
+    inline void            SetPresentable(bool presentable)                     { FUN_ENTRY(GL_LOG_TRACE); mPresentable = presentable; }
+
+// Is Functions
+    bool                   IsSubmissionComplete(uint64_t submissionId);
+
+// Has Functions
+    inline bool            HasPendingTransferCommands(void)               const { FUN_ENTRY(GL_LOG_TRACE); return mVkCommandBuffers.transferCommandBufferState[mActiveCmdBuffer] == CMD_BUFFER_RECORDING_STATE; }
+    inline bool            HasPendingAuxCommands(void)                    const { FUN_ENTRY(GL_LOG_TRACE); return mVkCommandBuffers.auxCommandBufferState[mActiveCmdBuffer] == CMD_BUFFER_RECORDING_STATE || HasPendingTransferCommands(); }
 };
 
 }
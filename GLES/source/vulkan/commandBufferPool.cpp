@@ -60,6 +60,22 @@ CommandBufferPool::RemoveBuffer(void)
     return removedBuffer;
 }
 
+bool
+CommandBufferPool::RemoveBuffer(VkCommandBuffer *commandBuffer)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    for(auto it = mPool.begin(); it != mPool.end(); ++it) {
+        if(*it == commandBuffer) {
+            mPool.erase(it);
+            mSize--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
 VkCommandBuffer *
 CommandBufferPool::BindNextAvailableBuffer(void)
 {
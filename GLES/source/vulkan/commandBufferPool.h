@@ -46,6 +46,7 @@ public:
 
     void                             AddBuffer(VkCommandBuffer *commandBuffer);
     VkCommandBuffer *                RemoveBuffer(void);
+    bool                             RemoveBuffer(VkCommandBuffer *commandBuffer);
     VkCommandBuffer *                BindNextAvailableBuffer(void);
     void                             UnbindAllBuffers(void);
 
@@ -0,0 +1,213 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       commandBundle.cpp
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Reusable secondary command buffer of recorded draws
+ *
+ *  @section
+ *
+ *  A bundle records draws once into a secondary command buffer that is kept
+ *  across frames and executed by the render passes it is compatible with.
+ *  What the draws would otherwise place in the per-frame rings, such as the
+ *  uniforms, the client arrays and the descriptor sets, goes to rings and a
+ *  descriptor allocator of the bundle, which are rewound only when it is
+ *  recorded again. The pipelines, buffers, image views and samplers the draws
+ *  refer to are noted, and a bundle is stale once any of them is retired,
+ *  e.g., by glBufferData, a texture specification or a relink, so that it is
+ *  never executed with objects that no longer back the GL ones.
+ *
+ */
+
+#include "commandBundle.h"
+#include <algorithm>
+
+namespace vulkanAPI {
+
+std::mutex                   CommandBundle::mRegistryMutex;
+std::vector<CommandBundle *> CommandBundle::mRegistry;
+std::atomic<uint32_t>        CommandBundle::mRegistrySize(0);
+
+CommandBundle::CommandBundle()
+: mVkContext(nullptr), mCommandBufferManager(nullptr), mVkCommandBuffer(nullptr),
+  mUniformRing(nullptr), mStreamRing(nullptr), mDescriptorAllocator(nullptr),
+  mRecorded(false), mStale(false)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    std::lock_guard<std::mutex> lock(mRegistryMutex);
+    mRegistry.push_back(this);
+    ++mRegistrySize;
+}
+
+CommandBundle::~CommandBundle()
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    {
+        std::lock_guard<std::mutex> lock(mRegistryMutex);
+        mRegistry.erase(std::find(mRegistry.begin(), mRegistry.end(), this));
+        --mRegistrySize;
+    }
+
+    Release();
+}
+
+void
+CommandBundle::Release(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(mCommandBufferManager) {
+        mCommandBufferManager->FreeVkBundleCmdBuffer(mVkCommandBuffer);
+    }
+    mVkCommandBuffer = nullptr;
+
+    delete mUniformRing;
+    delete mStreamRing;
+    delete mDescriptorAllocator;
+    mUniformRing         = nullptr;
+    mStreamRing          = nullptr;
+    mDescriptorAllocator = nullptr;
+
+    mRecorded = false;
+}
+
+bool
+CommandBundle::CreateResources(const vkContext_t *vkContext, CommandBufferManager *commandBufferManager)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    mVkContext            = vkContext;
+    mCommandBufferManager = commandBufferManager;
+
+    mVkCommandBuffer = mCommandBufferManager->AllocateVkBundleCmdBuffer();
+    if(!mVkCommandBuffer) {
+        return false;
+    }
+
+    // a single frame that is never rewound while the bundle may be executed
+    mUniformRing = new RingBuffer(mVkContext, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+    mUniformRing->Create(1, GLOVE_COMMAND_BUNDLE_UNIFORM_RING_SIZE,
+                         std::max(mVkContext->vkDeviceLimits.minUniformBufferOffsetAlignment, static_cast<VkDeviceSize>(16)), true);
+
+    mStreamRing = new RingBuffer(mVkContext, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+    mStreamRing->Create(1, GLOVE_COMMAND_BUNDLE_STREAM_RING_SIZE, 16, true);
+
+    mDescriptorAllocator = new DescriptorAllocator(mVkContext);
+    return mDescriptorAllocator->Create(1);
+}
+
+bool
+CommandBundle::Begin(const vkContext_t *vkContext, CommandBufferManager *commandBufferManager,
+                     const Target &target, VkRenderPass renderPass)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!mVkCommandBuffer) {
+        if(!CreateResources(vkContext, commandBufferManager)) {
+            Release();
+            return false;
+        }
+    } else {
+        // the caller has waited for the frames that executed the bundle
+        mUniformRing->SetActiveFrame(0);
+        mStreamRing->SetActiveFrame(0);
+        mDescriptorAllocator->SetActiveFrame(0);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mRegistryMutex);
+        mReferences.clear();
+        mStale = false;
+    }
+    mTarget   = target;
+    mRecorded = false;
+
+    // executed in the framebuffers of any frame, and by as many primary command buffers as are pending
+    return mCommandBufferManager->BeginVkSecondaryCommandBuffer(mVkCommandBuffer, renderPass, VK_NULL_HANDLE, true);
+}
+
+void
+CommandBundle::End(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    mCommandBufferManager->EndVkSecondaryCommandBuffer(mVkCommandBuffer);
+    mRecorded = true;
+}
+
+void
+CommandBundle::Reference(uint64_t handle)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(!handle) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mRegistryMutex);
+    mReferences.insert(handle);
+}
+
+bool
+CommandBundle::IsStale(void) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    std::lock_guard<std::mutex> lock(mRegistryMutex);
+    return mStale;
+}
+
+void
+CommandBundle::Retire(uint64_t handle)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // objects are retired far more often than bundles exist
+    if(!handle || !mRegistrySize.load()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mRegistryMutex);
+    for(CommandBundle *bundle : mRegistry) {
+        if(!bundle->mStale && bundle->mReferences.count(handle)) {
+            bundle->mStale = true;
+        }
+    }
+}
+
+bool
+CommandBundle::IsReferenced(uint64_t handle)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(!handle || !mRegistrySize.load()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mRegistryMutex);
+    for(CommandBundle *bundle : mRegistry) {
+        if(!bundle->mStale && bundle->mReferences.count(handle)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+}
@@ -0,0 +1,132 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       commandBundle.h
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Reusable secondary command buffer of recorded draws
+ *
+ */
+
+#ifndef __VKCOMMANDBUNDLE_H__
+#define __VKCOMMANDBUNDLE_H__
+
+#include <atomic>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+#include "commandBufferManager.h"
+#include "descriptorAllocator.h"
+#include "ringBuffer.h"
+
+/// the uniforms and client arrays of the draws of a bundle are kept in rings of its own, allocated on their first use
+#ifndef GLOVE_COMMAND_BUNDLE_UNIFORM_RING_SIZE
+#define GLOVE_COMMAND_BUNDLE_UNIFORM_RING_SIZE          (64 << 10)
+#endif // GLOVE_COMMAND_BUNDLE_UNIFORM_RING_SIZE
+
+#ifndef GLOVE_COMMAND_BUNDLE_STREAM_RING_SIZE
+#define GLOVE_COMMAND_BUNDLE_STREAM_RING_SIZE           (256 << 10)
+#endif // GLOVE_COMMAND_BUNDLE_STREAM_RING_SIZE
+
+namespace vulkanAPI {
+
+class CommandBundle {
+
+public:
+    /// what the render passes the bundle is executed in have to match, along with the viewport baked in its draws
+    typedef struct Target {
+        VkFormat                      colorFormat;
+        VkFormat                      depthStencilFormat;
+        VkSampleCountFlagBits         samples;
+        bool                          framebufferFetch;
+        int32_t                       width;
+        int32_t                       height;
+        bool                          originFlipped;
+        VkSurfaceTransformFlagBitsKHR preTransform;
+
+        Target() : colorFormat(VK_FORMAT_UNDEFINED), depthStencilFormat(VK_FORMAT_UNDEFINED), samples(VK_SAMPLE_COUNT_1_BIT),
+                   framebufferFetch(false), width(0), height(0), originFlipped(false), preTransform(VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR) { }
+
+        inline bool operator==(const Target &other) const { return colorFormat      == other.colorFormat      && depthStencilFormat == other.depthStencilFormat &&
+                                                                   samples          == other.samples          && framebufferFetch   == other.framebufferFetch   &&
+                                                                   width            == other.width            && height             == other.height             &&
+                                                                   originFlipped    == other.originFlipped    && preTransform       == other.preTransform; }
+    } Target;
+
+private:
+    const
+    vkContext_t *                     mVkContext;
+    CommandBufferManager *            mCommandBufferManager;
+    VkCommandBuffer *                 mVkCommandBuffer;
+
+    RingBuffer *                      mUniformRing;
+    RingBuffer *                      mStreamRing;
+    DescriptorAllocator *             mDescriptorAllocator;
+
+    Target                            mTarget;
+    bool                              mRecorded;
+    /// set once one of the objects the draws refer to is retired, guarded by mRegistryMutex along with mReferences
+    bool                              mStale;
+    std::unordered_set<uint64_t>      mReferences;
+
+    /// the live bundles, told of every object retired by any of the contexts
+    static std::mutex                 mRegistryMutex;
+    static std::vector<CommandBundle *> mRegistry;
+    static std::atomic<uint32_t>      mRegistrySize;
+
+    bool                              CreateResources(const vkContext_t *vkContext, CommandBufferManager *commandBufferManager);
+
+public:
+// Constructor
+    CommandBundle();
+
+// Destructor
+    ~CommandBundle();
+
+// Release Functions
+    void                              Release(void);
+
+// Record Functions
+    /// starts the bundle over, for draws in the render passes of target, which renderPass is compatible with
+    bool                              Begin(const vkContext_t *vkContext, CommandBufferManager *commandBufferManager,
+                                            const Target &target, VkRenderPass renderPass);
+    void                              End(void);
+    /// the draws recorded refer to handle, which retires the bundle along with it
+    void                              Reference(uint64_t handle);
+
+// Retire Functions
+    /// called as an object leaves the GL object that held it, or is destroyed, so that the bundles that refer to it are not executed again
+    static void                       Retire(uint64_t handle);
+    /// a bundle that may still be executed refers to handle
+    static bool                       IsReferenced(uint64_t handle);
+    template<typename T>
+    static inline uint64_t            GetHandleKey(T handle)                    { return (uint64_t)(handle); }
+
+// Get Functions
+    inline VkCommandBuffer *          GetVkCommandBuffer(void)                  { FUN_ENTRY(GL_LOG_TRACE); return mVkCommandBuffer;     }
+    inline RingBuffer *               GetUniformRing(void)                      { FUN_ENTRY(GL_LOG_TRACE); return mUniformRing;         }
+    inline RingBuffer *               GetStreamRing(void)                       { FUN_ENTRY(GL_LOG_TRACE); return mStreamRing;          }
+    inline DescriptorAllocator *      GetDescriptorAllocator(void)              { FUN_ENTRY(GL_LOG_TRACE); return mDescriptorAllocator; }
+    inline const Target &             GetTarget(void)                   const   { FUN_ENTRY(GL_LOG_TRACE); return mTarget;              }
+
+// Is Functions
+    inline bool                       IsRecorded(void)                  const   { FUN_ENTRY(GL_LOG_TRACE); return mRecorded;            }
+           bool                       IsStale(void)                     const;
+};
+
+}
+
+#endif // __VKCOMMANDBUNDLE_H__
@@ -28,10 +28,60 @@
  */
 
 #include "context.h"
+#include "pipelineCompiler.h"
+#include "memoryAllocator.h"
+#include "samplerCache.h"
+#include "shaderModuleCache.h"
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <utility>
 
 namespace vulkanAPI {
 
 #define GLOVE_VK_VALIDATION_LAYERS                      false
+#define GLOVE_VK_DEDICATED_TRANSFER_QUEUE               true
+#define GLOVE_VK_TIMELINE_SEMAPHORE                     true
+#define GLOVE_VK_EXTENDED_DYNAMIC_STATE                 true
+#define GLOVE_VK_PIPELINE_CREATION_FEEDBACK             true
+#define GLOVE_VK_PUSH_DESCRIPTOR                        true
+#define GLOVE_VK_INDEX_TYPE_UINT8                       true
+#define GLOVE_VK_VERTEX_ATTRIBUTE_DIVISOR               true
+#define GLOVE_VK_MEMORY_BUDGET                          true
+#define GLOVE_VK_IMAGELESS_FRAMEBUFFER                  true
+#define GLOVE_VK_PRESENT_WAIT                           true
+#define GLOVE_VK_DMA_BUF_IMPORT_EXT                     true
+#define GLOVE_VK_DIRECT_DISPLAY                         true
+#define GLOVE_VK_INCREMENTAL_PRESENT                    true
+#define GLOVE_VK_PRIORITY_QUEUES                        true
+
+/// the graphics queues are created with this system-wide priority of VK_EXT_global_priority,
+/// one of low, medium, high or realtime; the default one is kept if the process is not permitted it
+#define GLOVE_VK_GLOBAL_PRIORITY_ENV                    "GLOVE_GLOBAL_PRIORITY"
+
+/// color attachments and swapchain images are compressed at a fixed rate through VK_EXT_image_compression_control,
+/// which is lossy, so it is left to GLOVE_FIXED_RATE_COMPRESSION to ask for it; otherwise the driver keeps
+/// its default, lossless compression
+#define GLOVE_VK_FIXED_RATE_COMPRESSION                 false
+#define GLOVE_VK_FIXED_RATE_COMPRESSION_ENV             "GLOVE_FIXED_RATE_COMPRESSION"
+
+/// on-disk pipeline cache; the location can be overridden through the
+/// GLOVE_PIPELINE_CACHE_PATH environment variable (an empty value disables it)
+#define GLOVE_VK_PIPELINE_CACHE_FILE                    "glove_pipeline_cache.bin"
+#define GLOVE_VK_PIPELINE_CACHE_MAX_SIZE                (32 * 1024 * 1024)
+#define GLOVE_VK_PIPELINE_CACHE_MAGIC                   0x43504c47 // "GLPC"
+#define GLOVE_VK_PIPELINE_CACHE_VERSION                 1
+
+/// the WSI extensions are left out when the GLOVE_HEADLESS environment variable
+/// is set or the loader lacks them, rendering then goes to surfaceless contexts
+#define GLOVE_VK_HEADLESS_ENV                           "GLOVE_HEADLESS"
+
+/// index of the physical device to render on, in the order of vkEnumeratePhysicalDevices
+#define GLOVE_VK_DEVICE_INDEX_ENV                       "GLOVE_DEVICE_INDEX"
+
+/// the instance and device, along with the pipeline cache and the memory blocks, outlive eglTerminate,
+/// so that a process initializing EGL once per job creates them only once; 0 destroys them with the display
+#define GLOVE_VK_PERSISTENT_DEVICE_ENV                  "GLOVE_PERSISTENT_DEVICE"
 
 #ifdef VK_USE_PLATFORM_XCB_KHR
 static const std::vector<const char*> requiredInstanceExtensions = {VK_KHR_SURFACE_EXTENSION_NAME,
@@ -57,10 +107,60 @@ static const std::vector<const char*> requiredDeviceExtensions   = {VK_KHR_SWAPC
 
 static const std::vector<const char*> usefulDeviceExtensions     = {"VK_KHR_maintenance1"};
 
+#ifdef GLOVE_VK_DMA_BUF_IMPORT
+/// the dma-buf import extensions along with the ones they depend on in a Vulkan 1.0 device
+static const std::vector<const char*> dmaBufImportDeviceExtensions = {VK_KHR_EXTERNAL_MEMORY_EXTENSION_NAME,
+                                                                      VK_KHR_EXTERNAL_MEMORY_FD_EXTENSION_NAME,
+                                                                      VK_EXT_EXTERNAL_MEMORY_DMA_BUF_EXTENSION_NAME,
+                                                                      VK_EXT_IMAGE_DRM_FORMAT_MODIFIER_EXTENSION_NAME,
+                                                                      VK_KHR_DEDICATED_ALLOCATION_EXTENSION_NAME,
+                                                                      VK_KHR_GET_MEMORY_REQUIREMENTS_2_EXTENSION_NAME,
+                                                                      VK_KHR_BIND_MEMORY_2_EXTENSION_NAME,
+                                                                      VK_KHR_IMAGE_FORMAT_LIST_EXTENSION_NAME,
+                                                                      VK_KHR_SAMPLER_YCBCR_CONVERSION_EXTENSION_NAME,
+                                                                      VK_KHR_MAINTENANCE1_EXTENSION_NAME};
+#endif // GLOVE_VK_DMA_BUF_IMPORT
+
 static       char **enabledInstanceLayers           = nullptr;
 
+#ifdef VK_EXT_global_priority
+static VkQueueGlobalPriorityEXT globalPriority      = VK_QUEUE_GLOBAL_PRIORITY_MEDIUM_EXT;
+
+static bool
+ParseGlobalPriority(const char *name)
+{
+    static const std::pair<const char *, VkQueueGlobalPriorityEXT> priorities[] = {
+        { "low",      VK_QUEUE_GLOBAL_PRIORITY_LOW_EXT      },
+        { "medium",   VK_QUEUE_GLOBAL_PRIORITY_MEDIUM_EXT   },
+        { "high",     VK_QUEUE_GLOBAL_PRIORITY_HIGH_EXT     },
+        { "realtime", VK_QUEUE_GLOBAL_PRIORITY_REALTIME_EXT }
+    };
+
+    for(const auto &priority : priorities) {
+        if(name && !strcmp(name, priority.first)) {
+            globalPriority = priority.second;
+            return true;
+        }
+    }
+
+    return false;
+}
+#endif // VK_EXT_global_priority
+
 vkContext_t GloveVkContext;
 
+/// the context was terminated while kept alive, and is destroyed when the library is unloaded
+static bool persistentContextIdle = false;
+
+static bool
+IsPersistentContext(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    const char *persistent = getenv(GLOVE_VK_PERSISTENT_DEVICE_ENV);
+    return persistent == nullptr || strcmp(persistent, "0") != 0;
+}
+
 bool InitVkLayers(uint32_t* nLayers);
 bool CheckVkInstanceExtensions(void);
 bool CheckVkDeviceExtensions(void);
@@ -71,6 +171,17 @@ bool CreateVkDevice(void);
 bool CreateVkCommandPool(void);
 bool CreateVkSemaphores(void);
 void InitVkQueue(void);
+void LoadVkPipelineCache(void);
+
+typedef struct pipelineCacheFileHeader_t {
+    uint32_t                                            magic;
+    uint32_t                                            version;
+    uint32_t                                            vendorID;
+    uint32_t                                            deviceID;
+    uint32_t                                            driverVersion;
+    uint8_t                                             pipelineCacheUUID[VK_UUID_SIZE];
+    uint64_t                                            dataSize;
+} pipelineCacheFileHeader_t;
 
 bool
 InitVkLayers(uint32_t* nLayers)
@@ -148,16 +259,63 @@ CheckVkInstanceExtensions(void)
         }
     }
 
+    GetContext()->mIsPhysicalDeviceProperties2Supported = false;
+#ifdef VK_KHR_get_physical_device_properties2
+    for(uint32_t i = 0; i < extensionCount; ++i) {
+        if(!strcmp(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME, vkExtensionProperties[i].extensionName)) {
+            GetContext()->mIsPhysicalDeviceProperties2Supported = true;
+            break;
+        }
+    }
+#endif // VK_KHR_get_physical_device_properties2
+
+    // refined by the device extensions, the instance only provides the external memory capabilities
+    GetContext()->mIsDmaBufImportSupported = false;
+#ifdef GLOVE_VK_DMA_BUF_IMPORT
+    for(uint32_t i = 0; GLOVE_VK_DMA_BUF_IMPORT_EXT && GetContext()->mIsPhysicalDeviceProperties2Supported && i < extensionCount; ++i) {
+        if(!strcmp(VK_KHR_EXTERNAL_MEMORY_CAPABILITIES_EXTENSION_NAME, vkExtensionProperties[i].extensionName)) {
+            GetContext()->mIsDmaBufImportSupported = true;
+            break;
+        }
+    }
+#endif // GLOVE_VK_DMA_BUF_IMPORT
+
+    // windowing builds may still present straight to a display, bypassing the compositor
+    GetContext()->mIsDirectDisplaySupported = false;
+    if(GLOVE_VK_DIRECT_DISPLAY && std::find_if(requiredInstanceExtensions.begin(), requiredInstanceExtensions.end(),
+       [](const char *name) { return !strcmp(name, VK_KHR_DISPLAY_EXTENSION_NAME); }) == requiredInstanceExtensions.end()) {
+        for(uint32_t i = 0; i < extensionCount; ++i) {
+            if(!strcmp(VK_KHR_DISPLAY_EXTENSION_NAME, vkExtensionProperties[i].extensionName)) {
+                GetContext()->mIsDirectDisplaySupported = true;
+                break;
+            }
+        }
+    }
+
+    // exposed by the loader when a capture tool or the validation layers are present
+    GetContext()->mIsDebugUtilsSupported = false;
+#ifdef VK_EXT_debug_utils
+    for(uint32_t i = 0; i < extensionCount; ++i) {
+        if(!strcmp(VK_EXT_DEBUG_UTILS_EXTENSION_NAME, vkExtensionProperties[i].extensionName)) {
+            GetContext()->mIsDebugUtilsSupported = true;
+            break;
+        }
+    }
+#endif // VK_EXT_debug_utils
+
     if(vkExtensionProperties) {
         free(vkExtensionProperties);
         vkExtensionProperties = nullptr;
     }
 
+    GetContext()->mIsHeadless = getenv(GLOVE_VK_HEADLESS_ENV) != nullptr;
     for(uint32_t j = 0; j < requiredInstanceExtensions.size(); ++j) {
         if(!requiredExtensionsAvailable[j]) {
-            return false;
+            GetContext()->mIsHeadless = true;
+            break;
         }
     }
+    GetContext()->mIsDirectDisplaySupported = GetContext()->mIsDirectDisplaySupported && !GetContext()->mIsHeadless;
 
     return true;
 }
@@ -206,12 +364,206 @@ CheckVkDeviceExtensions(void)
         }
     }
 
+    GetContext()->mIsTimelineSemaphoreSupported = false;
+#ifdef VK_KHR_timeline_semaphore
+    for(uint32_t i = 0; GLOVE_VK_TIMELINE_SEMAPHORE && i < extensionCount; ++i) {
+        if(!strcmp(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME, vkExtensionProperties[i].extensionName)) {
+            GetContext()->mIsTimelineSemaphoreSupported = true;
+            break;
+        }
+    }
+#endif // VK_KHR_timeline_semaphore
+
+    GetContext()->mIsExtendedDynamicStateSupported = false;
+#ifdef VK_EXT_extended_dynamic_state
+    for(uint32_t i = 0; GLOVE_VK_EXTENDED_DYNAMIC_STATE && i < extensionCount; ++i) {
+        if(!strcmp(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME, vkExtensionProperties[i].extensionName)) {
+            GetContext()->mIsExtendedDynamicStateSupported = true;
+            break;
+        }
+    }
+#endif // VK_EXT_extended_dynamic_state
+
+    GetContext()->mIsPipelineCreationFeedbackSupported = false;
+#ifdef VK_EXT_pipeline_creation_feedback
+    for(uint32_t i = 0; GLOVE_VK_PIPELINE_CREATION_FEEDBACK && i < extensionCount; ++i) {
+        if(!strcmp(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME, vkExtensionProperties[i].extensionName)) {
+            GetContext()->mIsPipelineCreationFeedbackSupported = true;
+            break;
+        }
+    }
+#endif // VK_EXT_pipeline_creation_feedback
+
+    GetContext()->mIsPushDescriptorSupported = false;
+#ifdef VK_KHR_push_descriptor
+    for(uint32_t i = 0; GLOVE_VK_PUSH_DESCRIPTOR && i < extensionCount; ++i) {
+        if(!strcmp(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME, vkExtensionProperties[i].extensionName)) {
+            GetContext()->mIsPushDescriptorSupported = true;
+            break;
+        }
+    }
+#endif // VK_KHR_push_descriptor
+
+    GetContext()->mIsIndexTypeUint8Supported = false;
+#ifdef VK_EXT_index_type_uint8
+    for(uint32_t i = 0; GLOVE_VK_INDEX_TYPE_UINT8 && i < extensionCount; ++i) {
+        if(!strcmp(VK_EXT_INDEX_TYPE_UINT8_EXTENSION_NAME, vkExtensionProperties[i].extensionName)) {
+            GetContext()->mIsIndexTypeUint8Supported = true;
+            break;
+        }
+    }
+#endif // VK_EXT_index_type_uint8
+
+    GetContext()->mIsVertexAttributeDivisorSupported = false;
+#ifdef VK_EXT_vertex_attribute_divisor
+    for(uint32_t i = 0; GLOVE_VK_VERTEX_ATTRIBUTE_DIVISOR && i < extensionCount; ++i) {
+        if(!strcmp(VK_EXT_VERTEX_ATTRIBUTE_DIVISOR_EXTENSION_NAME, vkExtensionProperties[i].extensionName)) {
+            GetContext()->mIsVertexAttributeDivisorSupported = true;
+            break;
+        }
+    }
+#endif // VK_EXT_vertex_attribute_divisor
+
+    GetContext()->mIsMemoryBudgetSupported = false;
+#ifdef VK_EXT_memory_budget
+    // the budget is queried through vkGetPhysicalDeviceMemoryProperties2KHR of the instance
+    for(uint32_t i = 0; GLOVE_VK_MEMORY_BUDGET && GetContext()->mIsPhysicalDeviceProperties2Supported && i < extensionCount; ++i) {
+        if(!strcmp(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME, vkExtensionProperties[i].extensionName)) {
+            GetContext()->fpGetPhysicalDeviceMemoryProperties2 = reinterpret_cast<PFN_vkGetPhysicalDeviceMemoryProperties2KHR>(
+                                                                 vkGetInstanceProcAddr(GloveVkContext.vkInstance, "vkGetPhysicalDeviceMemoryProperties2KHR"));
+            GetContext()->mIsMemoryBudgetSupported = GetContext()->fpGetPhysicalDeviceMemoryProperties2 != nullptr;
+            break;
+        }
+    }
+#endif // VK_EXT_memory_budget
+
+    GetContext()->mIsImagelessFramebufferSupported = false;
+#ifdef VK_KHR_imageless_framebuffer
+    // the extension depends on VK_KHR_maintenance2 and VK_KHR_image_format_list, which are enabled along with it
+    uint32_t imagelessFramebufferExtensions = 0;
+    for(uint32_t i = 0; GLOVE_VK_IMAGELESS_FRAMEBUFFER && GetContext()->mIsPhysicalDeviceProperties2Supported && i < extensionCount; ++i) {
+        if(!strcmp(VK_KHR_IMAGELESS_FRAMEBUFFER_EXTENSION_NAME, vkExtensionProperties[i].extensionName) ||
+           !strcmp(VK_KHR_MAINTENANCE2_EXTENSION_NAME,          vkExtensionProperties[i].extensionName) ||
+           !strcmp(VK_KHR_IMAGE_FORMAT_LIST_EXTENSION_NAME,     vkExtensionProperties[i].extensionName)) {
+            ++imagelessFramebufferExtensions;
+        }
+    }
+    GetContext()->mIsImagelessFramebufferSupported = imagelessFramebufferExtensions == 3;
+#endif // VK_KHR_imageless_framebuffer
+
+    GetContext()->mIsPresentWaitSupported = false;
+#if defined(VK_KHR_present_id) && defined(VK_KHR_present_wait)
+    // the features are optional, so they are queried through vkGetPhysicalDeviceFeatures2KHR of the instance
+    uint32_t presentWaitExtensions = 0;
+    for(uint32_t i = 0; GLOVE_VK_PRESENT_WAIT && !GetContext()->mIsHeadless && GetContext()->mIsPhysicalDeviceProperties2Supported && i < extensionCount; ++i) {
+        if(!strcmp(VK_KHR_PRESENT_ID_EXTENSION_NAME,   vkExtensionProperties[i].extensionName) ||
+           !strcmp(VK_KHR_PRESENT_WAIT_EXTENSION_NAME, vkExtensionProperties[i].extensionName)) {
+            ++presentWaitExtensions;
+        }
+    }
+
+    PFN_vkGetPhysicalDeviceFeatures2KHR fpGetPhysicalDeviceFeatures2 = presentWaitExtensions != 2 ? nullptr :
+                                        reinterpret_cast<PFN_vkGetPhysicalDeviceFeatures2KHR>(vkGetInstanceProcAddr(GloveVkContext.vkInstance, "vkGetPhysicalDeviceFeatures2KHR"));
+    if(fpGetPhysicalDeviceFeatures2) {
+        VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures;
+        memset(static_cast<void *>(&presentWaitFeatures), 0, sizeof(presentWaitFeatures));
+        presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+
+        VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures;
+        memset(static_cast<void *>(&presentIdFeatures), 0, sizeof(presentIdFeatures));
+        presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+        presentIdFeatures.pNext = &presentWaitFeatures;
+
+        VkPhysicalDeviceFeatures2KHR features;
+        memset(static_cast<void *>(&features), 0, sizeof(features));
+        features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+        features.pNext = &presentIdFeatures;
+
+        fpGetPhysicalDeviceFeatures2(GloveVkContext.vkGpus[0], &features);
+        GetContext()->mIsPresentWaitSupported = presentIdFeatures.presentId && presentWaitFeatures.presentWait;
+    }
+#endif // VK_KHR_present_id && VK_KHR_present_wait
+
+    GetContext()->mIsIncrementalPresentSupported = false;
+#ifdef VK_KHR_incremental_present
+    for(uint32_t i = 0; GLOVE_VK_INCREMENTAL_PRESENT && !GetContext()->mIsHeadless && i < extensionCount; ++i) {
+        if(!strcmp(VK_KHR_INCREMENTAL_PRESENT_EXTENSION_NAME, vkExtensionProperties[i].extensionName)) {
+            GetContext()->mIsIncrementalPresentSupported = true;
+            break;
+        }
+    }
+#endif // VK_KHR_incremental_present
+
+    GetContext()->mIsGlobalPriorityEnabled = false;
+#ifdef VK_EXT_global_priority
+    const bool isGlobalPriorityAsked = ParseGlobalPriority(getenv(GLOVE_VK_GLOBAL_PRIORITY_ENV));
+    for(uint32_t i = 0; isGlobalPriorityAsked && i < extensionCount; ++i) {
+        if(!strcmp(VK_EXT_GLOBAL_PRIORITY_EXTENSION_NAME, vkExtensionProperties[i].extensionName)) {
+            GetContext()->mIsGlobalPriorityEnabled = true;
+            break;
+        }
+    }
+#endif // VK_EXT_global_priority
+
+    GetContext()->mIsImageCompressionControlSupported          = false;
+    GetContext()->mIsImageCompressionControlSwapchainSupported = false;
+#if defined(VK_EXT_image_compression_control) && defined(VK_EXT_image_compression_control_swapchain)
+    // the features are optional, so they are queried through vkGetPhysicalDeviceFeatures2KHR of the instance
+    const char *fixedRateCompression = getenv(GLOVE_VK_FIXED_RATE_COMPRESSION_ENV);
+    bool imageCompressionControl          = false;
+    bool imageCompressionControlSwapchain = false;
+    for(uint32_t i = 0; (fixedRateCompression ? atoi(fixedRateCompression) != 0 : GLOVE_VK_FIXED_RATE_COMPRESSION) &&
+                        GetContext()->mIsPhysicalDeviceProperties2Supported && i < extensionCount; ++i) {
+        if(!strcmp(VK_EXT_IMAGE_COMPRESSION_CONTROL_EXTENSION_NAME, vkExtensionProperties[i].extensionName)) {
+            imageCompressionControl = true;
+        } else if(!strcmp(VK_EXT_IMAGE_COMPRESSION_CONTROL_SWAPCHAIN_EXTENSION_NAME, vkExtensionProperties[i].extensionName)) {
+            imageCompressionControlSwapchain = !GetContext()->mIsHeadless;
+        }
+    }
+
+    PFN_vkGetPhysicalDeviceFeatures2KHR fpGetPhysicalDeviceFeatures2KHR = !imageCompressionControl ? nullptr :
+                                        reinterpret_cast<PFN_vkGetPhysicalDeviceFeatures2KHR>(vkGetInstanceProcAddr(GloveVkContext.vkInstance, "vkGetPhysicalDeviceFeatures2KHR"));
+    if(fpGetPhysicalDeviceFeatures2KHR) {
+        VkPhysicalDeviceImageCompressionControlSwapchainFeaturesEXT compressionControlSwapchainFeatures;
+        memset(static_cast<void *>(&compressionControlSwapchainFeatures), 0, sizeof(compressionControlSwapchainFeatures));
+        compressionControlSwapchainFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_IMAGE_COMPRESSION_CONTROL_SWAPCHAIN_FEATURES_EXT;
+
+        VkPhysicalDeviceImageCompressionControlFeaturesEXT compressionControlFeatures;
+        memset(static_cast<void *>(&compressionControlFeatures), 0, sizeof(compressionControlFeatures));
+        compressionControlFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_IMAGE_COMPRESSION_CONTROL_FEATURES_EXT;
+        compressionControlFeatures.pNext = imageCompressionControlSwapchain ? &compressionControlSwapchainFeatures : nullptr;
+
+        VkPhysicalDeviceFeatures2KHR features;
+        memset(static_cast<void *>(&features), 0, sizeof(features));
+        features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+        features.pNext = &compressionControlFeatures;
+
+        fpGetPhysicalDeviceFeatures2KHR(GloveVkContext.vkGpus[0], &features);
+        GetContext()->mIsImageCompressionControlSupported          = compressionControlFeatures.imageCompressionControl;
+        GetContext()->mIsImageCompressionControlSwapchainSupported = compressionControlFeatures.imageCompressionControl &&
+                                                                     compressionControlSwapchainFeatures.imageCompressionControlSwapchain;
+    }
+#endif // VK_EXT_image_compression_control && VK_EXT_image_compression_control_swapchain
+
+#ifdef GLOVE_VK_DMA_BUF_IMPORT
+    uint32_t dmaBufImportExtensions = 0;
+    for(uint32_t i = 0; GetContext()->mIsDmaBufImportSupported && i < extensionCount; ++i) {
+        for(uint32_t j = 0; j < dmaBufImportDeviceExtensions.size(); ++j) {
+            if(!strcmp(dmaBufImportDeviceExtensions[j], vkExtensionProperties[i].extensionName)) {
+                ++dmaBufImportExtensions;
+                break;
+            }
+        }
+    }
+    GetContext()->mIsDmaBufImportSupported = dmaBufImportExtensions == dmaBufImportDeviceExtensions.size();
+#endif // GLOVE_VK_DMA_BUF_IMPORT
+
     if(vkExtensionProperties) {
         free(vkExtensionProperties);
         vkExtensionProperties = nullptr;
     }
 
-    for(uint32_t j = 0; j < requiredDeviceExtensions.size(); ++j) {
+    for(uint32_t j = 0; !GetContext()->mIsHeadless && j < requiredDeviceExtensions.size(); ++j) {
         if(!requiredExtensionsAvailable[j]) {
             printf("\n%s extension is mandatory for GLOVE\n", requiredDeviceExtensions[j]);
             printf("Please link GLOVE to a Vulkan driver which supports the latter\n");
@@ -251,12 +603,48 @@ CreateVkInstance(void)
     instanceInfo.pApplicationInfo         = &applicationInfo;
     instanceInfo.enabledLayerCount        = enabledLayerCount;
     instanceInfo.ppEnabledLayerNames      = enabledInstanceLayers;
-    instanceInfo.enabledExtensionCount    = static_cast<uint32_t>(requiredInstanceExtensions.size());
-    instanceInfo.ppEnabledExtensionNames  = requiredInstanceExtensions.data();
+    std::vector<const char*> enabledExtensions;
+    if(!GloveVkContext.mIsHeadless) {
+        enabledExtensions = requiredInstanceExtensions;
+    }
+    if(GloveVkContext.mIsDirectDisplaySupported) {
+        enabledExtensions.push_back(VK_KHR_DISPLAY_EXTENSION_NAME);
+    }
+#ifdef VK_KHR_get_physical_device_properties2
+    if(GloveVkContext.mIsPhysicalDeviceProperties2Supported) {
+        enabledExtensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+    }
+#endif // VK_KHR_get_physical_device_properties2
+#ifdef GLOVE_VK_DMA_BUF_IMPORT
+    if(GloveVkContext.mIsDmaBufImportSupported) {
+        enabledExtensions.push_back(VK_KHR_EXTERNAL_MEMORY_CAPABILITIES_EXTENSION_NAME);
+    }
+#endif // GLOVE_VK_DMA_BUF_IMPORT
+#ifdef VK_EXT_debug_utils
+    if(GloveVkContext.mIsDebugUtilsSupported) {
+        enabledExtensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+    }
+#endif // VK_EXT_debug_utils
+
+    instanceInfo.enabledExtensionCount    = static_cast<uint32_t>(enabledExtensions.size());
+    instanceInfo.ppEnabledExtensionNames  = enabledExtensions.data();
 
     VkResult err = vkCreateInstance(&instanceInfo, nullptr, &GloveVkContext.vkInstance);
     assert(!err);
 
+#ifdef VK_EXT_debug_utils
+    if(err == VK_SUCCESS && GloveVkContext.mIsDebugUtilsSupported) {
+        GloveVkContext.fpCmdBeginDebugUtilsLabel  = reinterpret_cast<PFN_vkCmdBeginDebugUtilsLabelEXT>(
+                                                    vkGetInstanceProcAddr(GloveVkContext.vkInstance, "vkCmdBeginDebugUtilsLabelEXT"));
+        GloveVkContext.fpCmdEndDebugUtilsLabel    = reinterpret_cast<PFN_vkCmdEndDebugUtilsLabelEXT>(
+                                                    vkGetInstanceProcAddr(GloveVkContext.vkInstance, "vkCmdEndDebugUtilsLabelEXT"));
+        GloveVkContext.fpCmdInsertDebugUtilsLabel = reinterpret_cast<PFN_vkCmdInsertDebugUtilsLabelEXT>(
+                                                    vkGetInstanceProcAddr(GloveVkContext.vkInstance, "vkCmdInsertDebugUtilsLabelEXT"));
+        GloveVkContext.mIsDebugUtilsSupported     = GloveVkContext.fpCmdBeginDebugUtilsLabel && GloveVkContext.fpCmdEndDebugUtilsLabel &&
+                                                    GloveVkContext.fpCmdInsertDebugUtilsLabel;
+    }
+#endif // VK_EXT_debug_utils
+
     for(uint32_t i = 0; i < enabledLayerCount; ++i) {
        free(enabledInstanceLayers[i]);
     }
@@ -289,8 +677,23 @@ EnumerateVkGpus(void)
         return false;
     }
 
+    // the chosen device is moved to the front, where the rest of the API looks for it
+    const char *deviceIndex = getenv(GLOVE_VK_DEVICE_INDEX_ENV);
+    if(deviceIndex != nullptr) {
+        uint32_t index = static_cast<uint32_t>(strtoul(deviceIndex, nullptr, 10));
+        if(index < gpuCount) {
+            std::swap(GloveVkContext.vkGpus[0], GloveVkContext.vkGpus[index]);
+        } else {
+            printf("\n%s=%u is out of range, %u devices are available\n", GLOVE_VK_DEVICE_INDEX_ENV, index, gpuCount);
+        }
+    }
+
     vkGetPhysicalDeviceMemoryProperties(GloveVkContext.vkGpus[0], &GloveVkContext.vkDeviceMemoryProperties);
 
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(GloveVkContext.vkGpus[0], &properties);
+    GloveVkContext.vkDeviceLimits = properties.limits;
+
     return true;
 }
 
@@ -313,6 +716,27 @@ InitVkQueueFamilyIndex(void)
     for(i = 0; i < queueFamilyCount; ++i) {
         if(queueProperties[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) {
             GloveVkContext.vkGraphicsQueueNodeIndex = i;
+            GloveVkContext.vkTimestampValidBits     = queueProperties[i].timestampValidBits;
+            GloveVkContext.vkGraphicsQueueCount     = GLOVE_VK_PRIORITY_QUEUES ?
+                                                      std::min(queueProperties[i].queueCount, static_cast<uint32_t>(QUEUE_PRIORITY_COUNT)) : 1;
+            break;
+        }
+    }
+
+    // a transfer-only family is usually backed by a DMA engine that can run uploads
+    // concurrently with rendering. Texture uploads are arbitrary subrectangles, so
+    // only families without an image transfer granularity restriction are accepted
+    GloveVkContext.mIsTransferQueueSupported = false;
+    for(uint32_t j = 0; GLOVE_VK_DEDICATED_TRANSFER_QUEUE && j < queueFamilyCount; ++j) {
+        const VkQueueFamilyProperties &properties = queueProperties[j];
+        if((properties.queueFlags & VK_QUEUE_TRANSFER_BIT) &&
+          !(properties.queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)) &&
+           properties.queueCount > 0 &&
+           properties.minImageTransferGranularity.width  == 1 &&
+           properties.minImageTransferGranularity.height == 1 &&
+           properties.minImageTransferGranularity.depth  == 1) {
+            GloveVkContext.vkTransferQueueNodeIndex = j;
+            GloveVkContext.mIsTransferQueueSupported = true;
             break;
         }
     }
@@ -326,34 +750,207 @@ CreateVkDevice(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    float queue_priorities[1] = {0.0};
-    VkDeviceQueueCreateInfo queueInfo;
-    queueInfo.sType            = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-    queueInfo.pNext            = nullptr;
-    queueInfo.flags            = 0;
-    queueInfo.queueCount       = 1;
-    queueInfo.pQueuePriorities = queue_priorities;
-    queueInfo.queueFamilyIndex = GloveVkContext.vkGraphicsQueueNodeIndex;
-
-    std::vector<const char*> enabledExtensions(requiredDeviceExtensions);
+    // the default graphics queue comes first, then the high and low priority ones the family has room for
+    float graphics_priorities[QUEUE_PRIORITY_COUNT] = {0.5, 1.0, 0.0};
+    float transfer_priorities[1] = {0.0};
+    VkDeviceQueueCreateInfo queueInfo[2];
+    queueInfo[0].sType            = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+    queueInfo[0].pNext            = nullptr;
+    queueInfo[0].flags            = 0;
+    queueInfo[0].queueCount       = GloveVkContext.vkGraphicsQueueCount;
+    queueInfo[0].pQueuePriorities = graphics_priorities;
+    queueInfo[0].queueFamilyIndex = GloveVkContext.vkGraphicsQueueNodeIndex;
+
+    queueInfo[1]                  = queueInfo[0];
+    queueInfo[1].queueCount       = 1;
+    queueInfo[1].pQueuePriorities = transfer_priorities;
+    queueInfo[1].queueFamilyIndex = GloveVkContext.vkTransferQueueNodeIndex;
+
+    std::vector<const char*> enabledExtensions;
+    if(!GloveVkContext.mIsHeadless) {
+        enabledExtensions = requiredDeviceExtensions;
+    }
 
     if(true == GetContext()->mIsMaintenanceExtSupported) {
         enabledExtensions.insert(enabledExtensions.end(), usefulDeviceExtensions.begin(), usefulDeviceExtensions.end());
     }
 
+    void *deviceInfoNext = nullptr;
+#ifdef VK_KHR_timeline_semaphore
+    // the feature is mandatory for devices exposing the extension
+    VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineFeatures;
+    timelineFeatures.sType             = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+    timelineFeatures.pNext             = nullptr;
+    timelineFeatures.timelineSemaphore = VK_TRUE;
+
+    if(GloveVkContext.mIsTimelineSemaphoreSupported) {
+        enabledExtensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+        deviceInfoNext = &timelineFeatures;
+    }
+#endif // VK_KHR_timeline_semaphore
+#ifdef VK_EXT_extended_dynamic_state
+    // the feature is mandatory for devices exposing the extension
+    VkPhysicalDeviceExtendedDynamicStateFeaturesEXT extendedDynamicStateFeatures;
+    extendedDynamicStateFeatures.sType                = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT;
+    extendedDynamicStateFeatures.pNext                = deviceInfoNext;
+    extendedDynamicStateFeatures.extendedDynamicState = VK_TRUE;
+
+    if(GloveVkContext.mIsExtendedDynamicStateSupported) {
+        enabledExtensions.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME);
+        deviceInfoNext = &extendedDynamicStateFeatures;
+    }
+#endif // VK_EXT_extended_dynamic_state
+#ifdef VK_EXT_pipeline_creation_feedback
+    if(GloveVkContext.mIsPipelineCreationFeedbackSupported) {
+        enabledExtensions.push_back(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
+    }
+#endif // VK_EXT_pipeline_creation_feedback
+#ifdef VK_KHR_push_descriptor
+    if(GloveVkContext.mIsPushDescriptorSupported) {
+        enabledExtensions.push_back(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+    }
+#endif // VK_KHR_push_descriptor
+#ifdef VK_EXT_index_type_uint8
+    // the feature is mandatory for devices exposing the extension
+    VkPhysicalDeviceIndexTypeUint8FeaturesEXT indexTypeUint8Features;
+    indexTypeUint8Features.sType          = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_INDEX_TYPE_UINT8_FEATURES_EXT;
+    indexTypeUint8Features.pNext          = deviceInfoNext;
+    indexTypeUint8Features.indexTypeUint8 = VK_TRUE;
+
+    if(GloveVkContext.mIsIndexTypeUint8Supported) {
+        enabledExtensions.push_back(VK_EXT_INDEX_TYPE_UINT8_EXTENSION_NAME);
+        deviceInfoNext = &indexTypeUint8Features;
+    }
+#endif // VK_EXT_index_type_uint8
+#ifdef VK_EXT_vertex_attribute_divisor
+    // instance rate divisors other than one are required by glVertexAttribDivisor;
+    // a divisor of zero is never used, as GL maps it to a per vertex binding
+    VkPhysicalDeviceVertexAttributeDivisorFeaturesEXT vertexAttributeDivisorFeatures;
+    vertexAttributeDivisorFeatures.sType                                  = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VERTEX_ATTRIBUTE_DIVISOR_FEATURES_EXT;
+    vertexAttributeDivisorFeatures.pNext                                  = deviceInfoNext;
+    vertexAttributeDivisorFeatures.vertexAttributeInstanceRateDivisor     = VK_TRUE;
+    vertexAttributeDivisorFeatures.vertexAttributeInstanceRateZeroDivisor = VK_FALSE;
+
+    if(GloveVkContext.mIsVertexAttributeDivisorSupported) {
+        enabledExtensions.push_back(VK_EXT_VERTEX_ATTRIBUTE_DIVISOR_EXTENSION_NAME);
+        deviceInfoNext = &vertexAttributeDivisorFeatures;
+    }
+#endif // VK_EXT_vertex_attribute_divisor
+#ifdef VK_EXT_memory_budget
+    if(GloveVkContext.mIsMemoryBudgetSupported) {
+        enabledExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    }
+#endif // VK_EXT_memory_budget
+#ifdef VK_KHR_imageless_framebuffer
+    // the feature is mandatory for devices exposing the extension
+    VkPhysicalDeviceImagelessFramebufferFeaturesKHR imagelessFramebufferFeatures;
+    imagelessFramebufferFeatures.sType                = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_IMAGELESS_FRAMEBUFFER_FEATURES_KHR;
+    imagelessFramebufferFeatures.pNext                = deviceInfoNext;
+    imagelessFramebufferFeatures.imagelessFramebuffer = VK_TRUE;
+
+    if(GloveVkContext.mIsImagelessFramebufferSupported) {
+        enabledExtensions.push_back(VK_KHR_MAINTENANCE2_EXTENSION_NAME);
+        enabledExtensions.push_back(VK_KHR_IMAGE_FORMAT_LIST_EXTENSION_NAME);
+        enabledExtensions.push_back(VK_KHR_IMAGELESS_FRAMEBUFFER_EXTENSION_NAME);
+        deviceInfoNext = &imagelessFramebufferFeatures;
+    }
+#endif // VK_KHR_imageless_framebuffer
+#if defined(VK_KHR_present_id) && defined(VK_KHR_present_wait)
+    // the features have been found supported, and are used by EGL to pace eglSwapBuffers
+    VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures;
+    presentIdFeatures.sType         = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+    presentIdFeatures.pNext         = deviceInfoNext;
+    presentIdFeatures.presentId     = VK_TRUE;
+
+    VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures;
+    presentWaitFeatures.sType       = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+    presentWaitFeatures.pNext       = &presentIdFeatures;
+    presentWaitFeatures.presentWait = VK_TRUE;
+
+    if(GloveVkContext.mIsPresentWaitSupported) {
+        enabledExtensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+        enabledExtensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+        deviceInfoNext = &presentWaitFeatures;
+    }
+#endif // VK_KHR_present_id && VK_KHR_present_wait
+#ifdef VK_KHR_incremental_present
+    if(GloveVkContext.mIsIncrementalPresentSupported) {
+        enabledExtensions.push_back(VK_KHR_INCREMENTAL_PRESENT_EXTENSION_NAME);
+    }
+#endif // VK_KHR_incremental_present
+#if defined(VK_EXT_image_compression_control) && defined(VK_EXT_image_compression_control_swapchain)
+    // the features have been found supported, and are used for the color attachments and by EGL for the swapchains
+    VkPhysicalDeviceImageCompressionControlFeaturesEXT compressionControlFeatures;
+    compressionControlFeatures.sType                   = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_IMAGE_COMPRESSION_CONTROL_FEATURES_EXT;
+    compressionControlFeatures.pNext                   = deviceInfoNext;
+    compressionControlFeatures.imageCompressionControl = VK_TRUE;
+
+    VkPhysicalDeviceImageCompressionControlSwapchainFeaturesEXT compressionControlSwapchainFeatures;
+    compressionControlSwapchainFeatures.sType                            = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_IMAGE_COMPRESSION_CONTROL_SWAPCHAIN_FEATURES_EXT;
+    compressionControlSwapchainFeatures.pNext                            = &compressionControlFeatures;
+    compressionControlSwapchainFeatures.imageCompressionControlSwapchain = VK_TRUE;
+
+    if(GloveVkContext.mIsImageCompressionControlSupported) {
+        enabledExtensions.push_back(VK_EXT_IMAGE_COMPRESSION_CONTROL_EXTENSION_NAME);
+        deviceInfoNext = &compressionControlFeatures;
+    }
+    if(GloveVkContext.mIsImageCompressionControlSwapchainSupported) {
+        enabledExtensions.push_back(VK_EXT_IMAGE_COMPRESSION_CONTROL_SWAPCHAIN_EXTENSION_NAME);
+        deviceInfoNext = &compressionControlSwapchainFeatures;
+    }
+#endif // VK_EXT_image_compression_control && VK_EXT_image_compression_control_swapchain
+#ifdef GLOVE_VK_DMA_BUF_IMPORT
+    // some of the dependencies may have been enabled already for other extensions
+    for(uint32_t i = 0; GloveVkContext.mIsDmaBufImportSupported && i < dmaBufImportDeviceExtensions.size(); ++i) {
+        if(std::find_if(enabledExtensions.begin(), enabledExtensions.end(),
+                        [i](const char *name) { return !strcmp(name, dmaBufImportDeviceExtensions[i]); }) == enabledExtensions.end()) {
+            enabledExtensions.push_back(dmaBufImportDeviceExtensions[i]);
+        }
+    }
+#endif // GLOVE_VK_DMA_BUF_IMPORT
+#ifdef VK_EXT_global_priority
+    // the priority is global to the family, so it applies to the queues of all the GL contexts
+    VkDeviceQueueGlobalPriorityCreateInfoEXT globalPriorityInfo;
+    globalPriorityInfo.sType          = VK_STRUCTURE_TYPE_DEVICE_QUEUE_GLOBAL_PRIORITY_CREATE_INFO_EXT;
+    globalPriorityInfo.pNext          = nullptr;
+    globalPriorityInfo.globalPriority = globalPriority;
+
+    if(GloveVkContext.mIsGlobalPriorityEnabled) {
+        enabledExtensions.push_back(VK_EXT_GLOBAL_PRIORITY_EXTENSION_NAME);
+        queueInfo[0].pNext = &globalPriorityInfo;
+    }
+#endif // VK_EXT_global_priority
+
+    // the 32-bit indices of GL_OES_element_index_uint reach past maxDrawIndexedIndexValue with this feature only
+    VkPhysicalDeviceFeatures supportedFeatures;
+    vkGetPhysicalDeviceFeatures(GloveVkContext.vkGpus[0], &supportedFeatures);
+
+    VkPhysicalDeviceFeatures enabledFeatures;
+    memset(static_cast<void *>(&enabledFeatures), 0, sizeof(enabledFeatures));
+    enabledFeatures.fullDrawIndexUint32 = supportedFeatures.fullDrawIndexUint32;
+
     VkDeviceCreateInfo deviceInfo;
     deviceInfo.sType                   = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-    deviceInfo.pNext                   = nullptr;
+    deviceInfo.pNext                   = deviceInfoNext;
     deviceInfo.flags                   = 0;
-    deviceInfo.queueCreateInfoCount    = 1;
-    deviceInfo.pQueueCreateInfos       = &queueInfo;
+    deviceInfo.queueCreateInfoCount    = GloveVkContext.mIsTransferQueueSupported ? 2 : 1;
+    deviceInfo.pQueueCreateInfos       = queueInfo;
     deviceInfo.enabledLayerCount       = 0;
     deviceInfo.ppEnabledLayerNames     = nullptr;
     deviceInfo.enabledExtensionCount   = enabledExtensions.size();
     deviceInfo.ppEnabledExtensionNames = enabledExtensions.data();
-    deviceInfo.pEnabledFeatures        = nullptr;
+    deviceInfo.pEnabledFeatures        = &enabledFeatures;
 
     VkResult err = vkCreateDevice(GloveVkContext.vkGpus[0], &deviceInfo, nullptr, &GloveVkContext.vkDevice);
+#ifdef VK_EXT_global_priority
+    // priorities above medium may require privileges the process lacks
+    if(err == VK_ERROR_NOT_PERMITTED_EXT && GloveVkContext.mIsGlobalPriorityEnabled) {
+        GLOVE_PRINT_ERR("global queue priority not permitted, the default one is kept\n");
+        GloveVkContext.mIsGlobalPriorityEnabled = false;
+        queueInfo[0].pNext = nullptr;
+        err = vkCreateDevice(GloveVkContext.vkGpus[0], &deviceInfo, nullptr, &GloveVkContext.vkDevice);
+    }
+#endif // VK_EXT_global_priority
     assert(!err);
 
     return (err == VK_SUCCESS);
@@ -398,10 +995,201 @@ InitVkQueue(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    // an entry point the device does not hand out is called through the loader, as before
+#define GLOVE_VK_DISPATCH_RESOLVE(__function__)                                                                       \
+    GloveVkContext.vkDispatch.__function__ = reinterpret_cast<PFN_##__function__>(vkGetDeviceProcAddr(GloveVkContext.vkDevice, #__function__)); \
+    if(!GloveVkContext.vkDispatch.__function__) {                                                                     \
+        GloveVkContext.vkDispatch.__function__ = __function__;                                                        \
+    }
+    GLOVE_VK_DEVICE_DISPATCH(GLOVE_VK_DISPATCH_RESOLVE)
+#undef GLOVE_VK_DISPATCH_RESOLVE
+
     vkGetDeviceQueue(GloveVkContext.vkDevice,
                      GloveVkContext.vkGraphicsQueueNodeIndex,
                      0,
                      &GloveVkContext.vkQueue);
+
+    // the priorities the family has no queue for are left null and fall back to the default queue
+    const queuePriority_t queuePriorities[QUEUE_PRIORITY_COUNT] = {QUEUE_PRIORITY_MEDIUM, QUEUE_PRIORITY_HIGH, QUEUE_PRIORITY_LOW};
+    for(uint32_t i = 0; i < QUEUE_PRIORITY_COUNT; ++i) {
+        GloveVkContext.vkPriorityQueues[queuePriorities[i]] = VK_NULL_HANDLE;
+    }
+    for(uint32_t i = 0; i < GloveVkContext.vkGraphicsQueueCount; ++i) {
+        vkGetDeviceQueue(GloveVkContext.vkDevice,
+                         GloveVkContext.vkGraphicsQueueNodeIndex,
+                         i,
+                         &GloveVkContext.vkPriorityQueues[queuePriorities[i]]);
+    }
+
+    if(GloveVkContext.mIsTransferQueueSupported) {
+        vkGetDeviceQueue(GloveVkContext.vkDevice,
+                         GloveVkContext.vkTransferQueueNodeIndex,
+                         0,
+                         &GloveVkContext.vkTransferQueue);
+    }
+
+    GloveVkContext.vkSubmissionQueue = new SubmissionQueue(&GloveVkContext.vkDispatch);
+
+#ifdef VK_KHR_timeline_semaphore
+    if(GloveVkContext.mIsTimelineSemaphoreSupported) {
+        GloveVkContext.fpGetSemaphoreCounterValue = reinterpret_cast<PFN_vkGetSemaphoreCounterValueKHR>(vkGetDeviceProcAddr(GloveVkContext.vkDevice, "vkGetSemaphoreCounterValueKHR"));
+        GloveVkContext.fpWaitSemaphores           = reinterpret_cast<PFN_vkWaitSemaphoresKHR>(vkGetDeviceProcAddr(GloveVkContext.vkDevice, "vkWaitSemaphoresKHR"));
+
+        GloveVkContext.mIsTimelineSemaphoreSupported = GloveVkContext.fpGetSemaphoreCounterValue != nullptr &&
+                                                       GloveVkContext.fpWaitSemaphores           != nullptr;
+    }
+#endif // VK_KHR_timeline_semaphore
+
+#ifdef VK_EXT_extended_dynamic_state
+    if(GloveVkContext.mIsExtendedDynamicStateSupported) {
+        GloveVkContext.fpCmdSetCullMode          = reinterpret_cast<PFN_vkCmdSetCullModeEXT>(vkGetDeviceProcAddr(GloveVkContext.vkDevice, "vkCmdSetCullModeEXT"));
+        GloveVkContext.fpCmdSetFrontFace         = reinterpret_cast<PFN_vkCmdSetFrontFaceEXT>(vkGetDeviceProcAddr(GloveVkContext.vkDevice, "vkCmdSetFrontFaceEXT"));
+        GloveVkContext.fpCmdSetDepthTestEnable   = reinterpret_cast<PFN_vkCmdSetDepthTestEnableEXT>(vkGetDeviceProcAddr(GloveVkContext.vkDevice, "vkCmdSetDepthTestEnableEXT"));
+        GloveVkContext.fpCmdSetDepthWriteEnable  = reinterpret_cast<PFN_vkCmdSetDepthWriteEnableEXT>(vkGetDeviceProcAddr(GloveVkContext.vkDevice, "vkCmdSetDepthWriteEnableEXT"));
+        GloveVkContext.fpCmdSetDepthCompareOp    = reinterpret_cast<PFN_vkCmdSetDepthCompareOpEXT>(vkGetDeviceProcAddr(GloveVkContext.vkDevice, "vkCmdSetDepthCompareOpEXT"));
+        GloveVkContext.fpCmdSetStencilTestEnable = reinterpret_cast<PFN_vkCmdSetStencilTestEnableEXT>(vkGetDeviceProcAddr(GloveVkContext.vkDevice, "vkCmdSetStencilTestEnableEXT"));
+        GloveVkContext.fpCmdSetStencilOp         = reinterpret_cast<PFN_vkCmdSetStencilOpEXT>(vkGetDeviceProcAddr(GloveVkContext.vkDevice, "vkCmdSetStencilOpEXT"));
+
+        GloveVkContext.mIsExtendedDynamicStateSupported = GloveVkContext.fpCmdSetCullMode          != nullptr &&
+                                                          GloveVkContext.fpCmdSetFrontFace         != nullptr &&
+                                                          GloveVkContext.fpCmdSetDepthTestEnable   != nullptr &&
+                                                          GloveVkContext.fpCmdSetDepthWriteEnable  != nullptr &&
+                                                          GloveVkContext.fpCmdSetDepthCompareOp    != nullptr &&
+                                                          GloveVkContext.fpCmdSetStencilTestEnable != nullptr &&
+                                                          GloveVkContext.fpCmdSetStencilOp         != nullptr;
+    }
+#endif // VK_EXT_extended_dynamic_state
+
+#ifdef VK_KHR_push_descriptor
+    if(GloveVkContext.mIsPushDescriptorSupported) {
+        GloveVkContext.fpCmdPushDescriptorSet    = reinterpret_cast<PFN_vkCmdPushDescriptorSetKHR>(vkGetDeviceProcAddr(GloveVkContext.vkDevice, "vkCmdPushDescriptorSetKHR"));
+
+        GloveVkContext.mIsPushDescriptorSupported = GloveVkContext.fpCmdPushDescriptorSet != nullptr;
+    }
+#endif // VK_KHR_push_descriptor
+
+#ifdef GLOVE_VK_DMA_BUF_IMPORT
+    if(GloveVkContext.mIsDmaBufImportSupported) {
+        GloveVkContext.fpGetMemoryFdProperties   = reinterpret_cast<PFN_vkGetMemoryFdPropertiesKHR>(vkGetDeviceProcAddr(GloveVkContext.vkDevice, "vkGetMemoryFdPropertiesKHR"));
+
+        GloveVkContext.mIsDmaBufImportSupported  = GloveVkContext.fpGetMemoryFdProperties != nullptr;
+    }
+#endif // GLOVE_VK_DMA_BUF_IMPORT
+}
+
+static const char *
+GetVkPipelineCachePath(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    const char *path = getenv("GLOVE_PIPELINE_CACHE_PATH");
+    if(path == nullptr) {
+        path = GLOVE_VK_PIPELINE_CACHE_FILE;
+    }
+
+    return path[0] != '\0' ? path : nullptr;
+}
+
+static void
+FillVkPipelineCacheFileHeader(pipelineCacheFileHeader_t *header, uint64_t dataSize)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(GloveVkContext.vkGpus[0], &properties);
+
+    memset(static_cast<void *>(header), 0, sizeof(*header));
+    header->magic         = GLOVE_VK_PIPELINE_CACHE_MAGIC;
+    header->version       = GLOVE_VK_PIPELINE_CACHE_VERSION;
+    header->vendorID      = properties.vendorID;
+    header->deviceID      = properties.deviceID;
+    header->driverVersion = properties.driverVersion;
+    header->dataSize      = dataSize;
+    memcpy(header->pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+}
+
+void
+LoadVkPipelineCache(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    void  *data     = nullptr;
+    size_t dataSize = 0;
+
+    // data written by a different device or driver is discarded and the cache starts empty
+    const char *path = GetVkPipelineCachePath();
+    FILE *fp = path ? fopen(path, "rb") : nullptr;
+    if(fp) {
+        pipelineCacheFileHeader_t header, expected;
+        if(fread(&header, sizeof(header), 1, fp) == 1) {
+            FillVkPipelineCacheFileHeader(&expected, header.dataSize);
+            if(!memcmp(&header, &expected, sizeof(header)) &&
+               header.dataSize > 0 && header.dataSize <= GLOVE_VK_PIPELINE_CACHE_MAX_SIZE) {
+                dataSize = static_cast<size_t>(header.dataSize);
+                data     = malloc(dataSize);
+                if(fread(data, dataSize, 1, fp) != 1) {
+                    free(data);
+                    data     = nullptr;
+                    dataSize = 0;
+                }
+            }
+        }
+        fclose(fp);
+    }
+
+    VkPipelineCacheCreateInfo info;
+    info.sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    info.pNext           = nullptr;
+    info.flags           = 0;
+    info.pInitialData    = data;
+    info.initialDataSize = dataSize;
+
+    VkResult err = vkCreatePipelineCache(GloveVkContext.vkDevice, &info, nullptr, &GloveVkContext.vkPipelineCache);
+    if(err != VK_SUCCESS && data) {
+        info.pInitialData    = nullptr;
+        info.initialDataSize = 0;
+        err = vkCreatePipelineCache(GloveVkContext.vkDevice, &info, nullptr, &GloveVkContext.vkPipelineCache);
+    }
+    assert(!err);
+
+    if(err != VK_SUCCESS) {
+        GloveVkContext.vkPipelineCache = VK_NULL_HANDLE;
+    }
+
+    free(data);
+}
+
+void
+SaveVkPipelineCache(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    const char *path = GetVkPipelineCachePath();
+    if(path == nullptr || GloveVkContext.vkPipelineCache == VK_NULL_HANDLE) {
+        return;
+    }
+
+    size_t dataSize = 0;
+    VkResult err = vkGetPipelineCacheData(GloveVkContext.vkDevice, GloveVkContext.vkPipelineCache, &dataSize, nullptr);
+    if(err != VK_SUCCESS || dataSize == 0 || dataSize > GLOVE_VK_PIPELINE_CACHE_MAX_SIZE) {
+        return;
+    }
+
+    void *data = malloc(dataSize);
+    err = vkGetPipelineCacheData(GloveVkContext.vkDevice, GloveVkContext.vkPipelineCache, &dataSize, data);
+
+    FILE *fp = err == VK_SUCCESS ? fopen(path, "wb") : nullptr;
+    if(fp) {
+        pipelineCacheFileHeader_t header;
+        FillVkPipelineCacheFileHeader(&header, dataSize);
+        if(fwrite(&header, sizeof(header), 1, fp) != 1 ||
+           fwrite(data, dataSize, 1, fp) != 1) {
+            GLOVE_PRINT_ERR("failed to write the pipeline cache to %s\n", path);
+        }
+        fclose(fp);
+    }
+
+    free(data);
 }
 
 vkContext_t *
@@ -412,6 +1200,22 @@ GetContext()
     return &GloveVkContext;
 }
 
+VkQueue
+GetVkQueue(queuePriority_t priority, queuePriority_t *granted)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(priority >= QUEUE_PRIORITY_COUNT || GloveVkContext.vkPriorityQueues[priority] == VK_NULL_HANDLE) {
+        priority = QUEUE_PRIORITY_MEDIUM;
+    }
+
+    if(granted) {
+        *granted = priority;
+    }
+
+    return GloveVkContext.vkPriorityQueues[priority];
+}
+
 void
 ResetContextResources()
 {
@@ -419,12 +1223,56 @@ ResetContextResources()
     GloveVkContext.vkGpus.clear();
     GloveVkContext.vkQueue                      = VK_NULL_HANDLE;
     GloveVkContext.vkGraphicsQueueNodeIndex     = 0;
+    GloveVkContext.vkGraphicsQueueCount         = 0;
+    memset(static_cast<void*>(GloveVkContext.vkPriorityQueues), 0, sizeof(GloveVkContext.vkPriorityQueues));
+    GloveVkContext.vkTransferQueue              = VK_NULL_HANDLE;
+    GloveVkContext.vkTransferQueueNodeIndex     = 0;
+    GloveVkContext.vkTimestampValidBits         = 0;
     GloveVkContext.vkDevice                     = VK_NULL_HANDLE;
     GloveVkContext.vkSyncItems                  = nullptr;
+    GloveVkContext.vkSubmissionQueue            = nullptr;
+    GloveVkContext.vkPipelineCache              = VK_NULL_HANDLE;
+    GloveVkContext.vkPipelineCompiler           = nullptr;
+    GloveVkContext.vkMemoryAllocator            = nullptr;
+    GloveVkContext.vkSamplerCache               = nullptr;
+    GloveVkContext.vkShaderModuleCache          = nullptr;
+    memset(static_cast<void*>(&GloveVkContext.vkDispatch), 0, sizeof(GloveVkContext.vkDispatch));
     GloveVkContext.mIsMaintenanceExtSupported   = false;
+    GloveVkContext.mIsTransferQueueSupported    = false;
+    GloveVkContext.mIsTimelineSemaphoreSupported = false;
+    GloveVkContext.mIsExtendedDynamicStateSupported = false;
+    GloveVkContext.mIsPipelineCreationFeedbackSupported = false;
+    GloveVkContext.mIsPushDescriptorSupported   = false;
+    GloveVkContext.mIsIndexTypeUint8Supported   = false;
+    GloveVkContext.mIsVertexAttributeDivisorSupported = false;
+    GloveVkContext.mIsPhysicalDeviceProperties2Supported = false;
+    GloveVkContext.mIsMemoryBudgetSupported     = false;
+    GloveVkContext.mIsImagelessFramebufferSupported = false;
+    GloveVkContext.mIsPresentWaitSupported      = false;
+    GloveVkContext.mIsHeadless                  = false;
+    GloveVkContext.mIsDmaBufImportSupported     = false;
+    GloveVkContext.mIsDirectDisplaySupported    = false;
+    GloveVkContext.mIsIncrementalPresentSupported = false;
+    GloveVkContext.mIsImageCompressionControlSupported          = false;
+    GloveVkContext.mIsImageCompressionControlSwapchainSupported = false;
+    GloveVkContext.mIsDebugUtilsSupported       = false;
+    GloveVkContext.mIsGlobalPriorityEnabled     = false;
+#ifdef VK_EXT_debug_utils
+    GloveVkContext.fpCmdBeginDebugUtilsLabel    = nullptr;
+    GloveVkContext.fpCmdEndDebugUtilsLabel      = nullptr;
+    GloveVkContext.fpCmdInsertDebugUtilsLabel   = nullptr;
+#endif // VK_EXT_debug_utils
+#ifdef GLOVE_VK_DMA_BUF_IMPORT
+    GloveVkContext.fpGetMemoryFdProperties      = nullptr;
+#endif // GLOVE_VK_DMA_BUF_IMPORT
+#ifdef VK_EXT_memory_budget
+    GloveVkContext.fpGetPhysicalDeviceMemoryProperties2 = nullptr;
+#endif // VK_EXT_memory_budget
     GloveVkContext.mInitialized                 = false;
     memset(static_cast<void*>(&GloveVkContext.vkDeviceMemoryProperties), 0,
            sizeof(VkPhysicalDeviceMemoryProperties));
+    memset(static_cast<void*>(&GloveVkContext.vkDeviceLimits), 0,
+           sizeof(VkPhysicalDeviceLimits));
 }
 
 bool
@@ -432,8 +1280,10 @@ InitContext()
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    // a persistent context only needs the semaphores of the presentation again
     if (GloveVkContext.mInitialized == true) {
-        return true;
+        persistentContextIdle = false;
+        return GloveVkContext.vkSyncItems != nullptr || CreateVkSemaphores();
     }
 
     ResetContextResources();
@@ -450,18 +1300,23 @@ InitContext()
         return false;
     }
     InitVkQueue();
+    GloveVkContext.vkMemoryAllocator  = new MemoryAllocator(&GloveVkContext);
+    GloveVkContext.vkSamplerCache     = new SamplerCache(&GloveVkContext);
+    GloveVkContext.vkShaderModuleCache = new ShaderModuleCache(&GloveVkContext);
+    LoadVkPipelineCache();
+    GloveVkContext.vkPipelineCompiler = new PipelineCompiler(&GloveVkContext);
 
     GloveVkContext.mInitialized = true;
 
     return GloveVkContext.mInitialized;
 }
 
-void
-TerminateContext()
+static void
+DestroyVkSemaphores(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(!GloveVkContext.mInitialized) {
+    if(!GloveVkContext.vkSyncItems) {
         return;
     }
 
@@ -475,15 +1330,72 @@ TerminateContext()
         GloveVkContext.vkSyncItems->vkDrawSemaphore = VK_NULL_HANDLE;
     }
 
+    SafeDelete(GloveVkContext.vkSyncItems);
+}
+
+static void
+DestroyContext(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!GloveVkContext.mInitialized) {
+        return;
+    }
+
+    DestroyVkSemaphores();
+
+    SafeDelete(GloveVkContext.vkPipelineCompiler);
+
     if(GloveVkContext.vkDevice != VK_NULL_HANDLE ) {
         vkDeviceWaitIdle(GloveVkContext.vkDevice);
+
+        SaveVkPipelineCache();
+        if(GloveVkContext.vkPipelineCache != VK_NULL_HANDLE) {
+            vkDestroyPipelineCache(GloveVkContext.vkDevice, GloveVkContext.vkPipelineCache, nullptr);
+        }
+
+        SafeDelete(GloveVkContext.vkShaderModuleCache);
+        SafeDelete(GloveVkContext.vkSamplerCache);
+        SafeDelete(GloveVkContext.vkMemoryAllocator);
         vkDestroyDevice(GloveVkContext.vkDevice, nullptr);
         vkDestroyInstance(GloveVkContext.vkInstance, nullptr);
     }
 
-    SafeDelete(GloveVkContext.vkSyncItems);
+    SafeDelete(GloveVkContext.vkSubmissionQueue);
 
     ResetContextResources();
+    persistentContextIdle = false;
 }
 
+void
+TerminateContext()
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!GloveVkContext.mInitialized) {
+        return;
+    }
+
+    if(!IsPersistentContext()) {
+        DestroyContext();
+        return;
+    }
+
+    // the semaphores may be left signaled by an image that was never presented, so they are created again
+    vkDeviceWaitIdle(GloveVkContext.vkDevice);
+    DestroyVkSemaphores();
+    SaveVkPipelineCache();
+    persistentContextIdle = true;
+}
+
+/// a context left alive by eglTerminate is destroyed at process exit, while Vulkan is still loaded
+static struct PersistentContextReleaser {
+    ~PersistentContextReleaser()
+    {
+        if(persistentContextIdle) {
+            DestroyContext();
+        }
+    }
+} persistentContextReleaser;
+
 };
@@ -29,33 +29,181 @@
 #include "utils/glLogger.h"
 #include "vulkan/vulkan.h"
 #include "rendering_api_interface.h"
+#include "submissionQueue.h"
+#include "dispatch.h"
 
 using namespace std;
 
+/// EGLImages of Linux dma-bufs are imported through an explicit DRM format modifier
+#if defined(__linux__) && defined(VK_EXT_external_memory_dma_buf) && defined(VK_EXT_image_drm_format_modifier)
+#   define GLOVE_VK_DMA_BUF_IMPORT
+#endif // __linux__ && VK_EXT_external_memory_dma_buf && VK_EXT_image_drm_format_modifier
+
 namespace vulkanAPI {
 
+    class PipelineCompiler;
+    class MemoryAllocator;
+    class SamplerCache;
+    class ShaderModuleCache;
+
+    /// priority of the graphics queue a GL context submits to (EGL_IMG_context_priority)
+    typedef enum {
+        QUEUE_PRIORITY_LOW = 0,
+        QUEUE_PRIORITY_MEDIUM,
+        QUEUE_PRIORITY_HIGH,
+        QUEUE_PRIORITY_COUNT
+    } queuePriority_t;
+
     typedef struct vkContext_t {
         vkContext_t() {
             vkInstance            = VK_NULL_HANDLE;
             vkQueue               = VK_NULL_HANDLE;
             mInitialized          = false;
             vkGraphicsQueueNodeIndex = 0;
+            vkGraphicsQueueCount  = 0;
+            vkTransferQueue       = VK_NULL_HANDLE;
+            vkTransferQueueNodeIndex = 0;
+            vkTimestampValidBits  = 0;
             vkDevice = VK_NULL_HANDLE;
             vkSyncItems             = nullptr;
+            vkSubmissionQueue       = nullptr;
+            vkPipelineCache         = VK_NULL_HANDLE;
+            vkPipelineCompiler      = nullptr;
+            vkMemoryAllocator       = nullptr;
+            vkSamplerCache          = nullptr;
+            vkShaderModuleCache     = nullptr;
             mIsMaintenanceExtSupported = false;
+            mIsTransferQueueSupported  = false;
+            mIsTimelineSemaphoreSupported = false;
+#ifdef VK_KHR_timeline_semaphore
+            fpGetSemaphoreCounterValue = nullptr;
+            fpWaitSemaphores        = nullptr;
+#endif // VK_KHR_timeline_semaphore
+            mIsExtendedDynamicStateSupported = false;
+            mIsPipelineCreationFeedbackSupported = false;
+            mIsPushDescriptorSupported = false;
+            mIsIndexTypeUint8Supported = false;
+            mIsVertexAttributeDivisorSupported = false;
+            mIsPhysicalDeviceProperties2Supported = false;
+            mIsMemoryBudgetSupported = false;
+            mIsImagelessFramebufferSupported = false;
+            mIsPresentWaitSupported = false;
+            mIsHeadless             = false;
+            mIsDmaBufImportSupported = false;
+            mIsDirectDisplaySupported = false;
+            mIsIncrementalPresentSupported = false;
+            mIsImageCompressionControlSupported          = false;
+            mIsImageCompressionControlSwapchainSupported = false;
+            mIsDebugUtilsSupported  = false;
+            mIsGlobalPriorityEnabled = false;
+#ifdef VK_EXT_debug_utils
+            fpCmdBeginDebugUtilsLabel  = nullptr;
+            fpCmdEndDebugUtilsLabel    = nullptr;
+            fpCmdInsertDebugUtilsLabel = nullptr;
+#endif // VK_EXT_debug_utils
+#ifdef GLOVE_VK_DMA_BUF_IMPORT
+            fpGetMemoryFdProperties = nullptr;
+#endif // GLOVE_VK_DMA_BUF_IMPORT
+#ifdef VK_EXT_memory_budget
+            fpGetPhysicalDeviceMemoryProperties2 = nullptr;
+#endif // VK_EXT_memory_budget
+#ifdef VK_KHR_push_descriptor
+            fpCmdPushDescriptorSet    = nullptr;
+#endif // VK_KHR_push_descriptor
+#ifdef VK_EXT_extended_dynamic_state
+            fpCmdSetCullMode          = nullptr;
+            fpCmdSetFrontFace         = nullptr;
+            fpCmdSetDepthTestEnable   = nullptr;
+            fpCmdSetDepthWriteEnable  = nullptr;
+            fpCmdSetDepthCompareOp    = nullptr;
+            fpCmdSetStencilTestEnable = nullptr;
+            fpCmdSetStencilOp         = nullptr;
+#endif // VK_EXT_extended_dynamic_state
             mInitialized            = false;
             memset(static_cast<void*>(&vkDeviceMemoryProperties), 0,
                    sizeof(VkPhysicalDeviceMemoryProperties));
+            memset(static_cast<void*>(&vkDeviceLimits), 0,
+                   sizeof(VkPhysicalDeviceLimits));
+            memset(static_cast<void*>(&vkDispatch), 0,
+                   sizeof(vkDeviceDispatch_t));
+            memset(static_cast<void*>(vkPriorityQueues), 0,
+                   sizeof(vkPriorityQueues));
         }
 
         VkInstance                                          vkInstance;
         vector<VkPhysicalDevice>                            vkGpus;
         VkQueue                                             vkQueue;
         uint32_t                                            vkGraphicsQueueNodeIndex;
+        /// queues created from the graphics family, the first one being vkQueue
+        uint32_t                                            vkGraphicsQueueCount;
+        /// graphics queues per priority, null for the ones the family has no room for
+        VkQueue                                             vkPriorityQueues[QUEUE_PRIORITY_COUNT];
+        VkQueue                                             vkTransferQueue;
+        uint32_t                                            vkTransferQueueNodeIndex;
+        /// bits of the timestamps written on the graphics queue, 0 when it cannot write them
+        uint32_t                                            vkTimestampValidBits;
         VkDevice                                            vkDevice;
         VkPhysicalDeviceMemoryProperties                    vkDeviceMemoryProperties;
+        VkPhysicalDeviceLimits                              vkDeviceLimits;
         vkSyncItems_t                                       *vkSyncItems;
+        SubmissionQueue                                     *vkSubmissionQueue;
+        VkPipelineCache                                     vkPipelineCache;
+        PipelineCompiler                                    *vkPipelineCompiler;
+        MemoryAllocator                                     *vkMemoryAllocator;
+        SamplerCache                                        *vkSamplerCache;
+        ShaderModuleCache                                   *vkShaderModuleCache;
+        vkDeviceDispatch_t                                  vkDispatch;
         bool                                                mIsMaintenanceExtSupported;
+        bool                                                mIsTransferQueueSupported;
+        bool                                                mIsTimelineSemaphoreSupported;
+#ifdef VK_KHR_timeline_semaphore
+        PFN_vkGetSemaphoreCounterValueKHR                  fpGetSemaphoreCounterValue;
+        PFN_vkWaitSemaphoresKHR                            fpWaitSemaphores;
+#endif // VK_KHR_timeline_semaphore
+        bool                                                mIsExtendedDynamicStateSupported;
+        bool                                                mIsPipelineCreationFeedbackSupported;
+        bool                                                mIsPushDescriptorSupported;
+        bool                                                mIsIndexTypeUint8Supported;
+        bool                                                mIsVertexAttributeDivisorSupported;
+        bool                                                mIsPhysicalDeviceProperties2Supported;
+        bool                                                mIsMemoryBudgetSupported;
+        bool                                                mIsImagelessFramebufferSupported;
+        bool                                                mIsPresentWaitSupported;
+        /// no surface and swapchain extensions, only surfaceless contexts can render
+        bool                                                mIsHeadless;
+        bool                                                mIsDmaBufImportSupported;
+        bool                                                mIsDirectDisplaySupported;
+        bool                                                mIsIncrementalPresentSupported;
+        /// fixed-rate compression has been asked for, of the color attachments and of the swapchain images respectively
+        bool                                                mIsImageCompressionControlSupported;
+        bool                                                mIsImageCompressionControlSwapchainSupported;
+        /// command buffer labels, shown by RenderDoc and the vendor profilers
+        bool                                                mIsDebugUtilsSupported;
+        /// the graphics queues have been created with the system-wide priority of GLOVE_GLOBAL_PRIORITY
+        bool                                                mIsGlobalPriorityEnabled;
+#ifdef VK_EXT_debug_utils
+        PFN_vkCmdBeginDebugUtilsLabelEXT                   fpCmdBeginDebugUtilsLabel;
+        PFN_vkCmdEndDebugUtilsLabelEXT                     fpCmdEndDebugUtilsLabel;
+        PFN_vkCmdInsertDebugUtilsLabelEXT                  fpCmdInsertDebugUtilsLabel;
+#endif // VK_EXT_debug_utils
+#ifdef GLOVE_VK_DMA_BUF_IMPORT
+        PFN_vkGetMemoryFdPropertiesKHR                     fpGetMemoryFdProperties;
+#endif // GLOVE_VK_DMA_BUF_IMPORT
+#ifdef VK_EXT_memory_budget
+        PFN_vkGetPhysicalDeviceMemoryProperties2KHR        fpGetPhysicalDeviceMemoryProperties2;
+#endif // VK_EXT_memory_budget
+#ifdef VK_KHR_push_descriptor
+        PFN_vkCmdPushDescriptorSetKHR                      fpCmdPushDescriptorSet;
+#endif // VK_KHR_push_descriptor
+#ifdef VK_EXT_extended_dynamic_state
+        PFN_vkCmdSetCullModeEXT                            fpCmdSetCullMode;
+        PFN_vkCmdSetFrontFaceEXT                           fpCmdSetFrontFace;
+        PFN_vkCmdSetDepthTestEnableEXT                     fpCmdSetDepthTestEnable;
+        PFN_vkCmdSetDepthWriteEnableEXT                    fpCmdSetDepthWriteEnable;
+        PFN_vkCmdSetDepthCompareOpEXT                      fpCmdSetDepthCompareOp;
+        PFN_vkCmdSetStencilTestEnableEXT                   fpCmdSetStencilTestEnable;
+        PFN_vkCmdSetStencilOpEXT                           fpCmdSetStencilOp;
+#endif // VK_EXT_extended_dynamic_state
         bool                                                mInitialized;
     } vkContext_t;
 
@@ -63,6 +211,8 @@ namespace vulkanAPI {
     bool                              InitContext();
     void                              TerminateContext();
     void                              ClearContextResources();
+    void                              SaveVkPipelineCache();
+    VkQueue                           GetVkQueue(queuePriority_t priority, queuePriority_t *granted);
 
     template<typename T>  inline void SafeDelete(T*& ptr)                       { FUN_ENTRY(GL_LOG_TRACE); delete ptr; ptr = nullptr; }
 };
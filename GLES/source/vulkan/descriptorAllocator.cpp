@@ -0,0 +1,186 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+
+/**
+ *  @file       descriptorAllocator.cpp
+ *  @author     Think Silicon
+ *  @date       14/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Per-frame paged allocator of Vulkan Descriptor Sets
+ *
+ *  @section
+ *
+ *  Every frame in flight owns a list of descriptor pools. Sets are allocated
+ *  from the frame currently being recorded, moving on to a new pool page when
+ *  the active one is exhausted, and are never freed individually. When the
+ *  frame's command buffer is waited upon, all of its pools are reset at once.
+ *  A set is therefore never rewritten while the GPU may still read it. The
+ *  epoch changes on every reset and lets callers tell whether an earlier set
+ *  is still valid.
+ *
+ */
+
+#include "descriptorAllocator.h"
+
+namespace vulkanAPI {
+
+std::atomic<uint64_t> DescriptorAllocator::mEpochCounter(1);
+
+DescriptorAllocator::DescriptorAllocator(const vkContext_t *vkContext)
+: mVkContext(vkContext), mActiveFrame(0), mEpoch(1)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+}
+
+DescriptorAllocator::~DescriptorAllocator()
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    Release();
+}
+
+uint32_t
+DescriptorAllocator::GetPoolCount(void) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    uint32_t count = 0;
+    for(const frame_t &frame : mFrames) {
+        count += static_cast<uint32_t>(frame.pools.size());
+    }
+
+    return count;
+}
+
+void
+DescriptorAllocator::Release(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    for(auto &frame : mFrames) {
+        for(auto pool : frame.pools) {
+            vkDestroyDescriptorPool(mVkContext->vkDevice, pool, nullptr);
+        }
+    }
+
+    mFrames.clear();
+    mActiveFrame = 0;
+}
+
+bool
+DescriptorAllocator::Create(uint32_t frameCount)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    Release();
+
+    mFrames.resize(frameCount);
+    SetActiveFrame(0);
+
+    return frameCount > 0;
+}
+
+VkDescriptorPool
+DescriptorAllocator::CreatePool(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    VkDescriptorPoolSize poolSizes[4];
+    poolSizes[0].type            = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSizes[0].descriptorCount = 4 * GLOVE_DESCRIPTOR_POOL_MAX_SETS;
+    poolSizes[1].type            = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    poolSizes[1].descriptorCount = 8 * GLOVE_DESCRIPTOR_POOL_MAX_SETS;
+    poolSizes[2].type            = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    poolSizes[2].descriptorCount = 8 * GLOVE_DESCRIPTOR_POOL_MAX_SETS;
+    poolSizes[3].type            = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+    poolSizes[3].descriptorCount = GLOVE_DESCRIPTOR_POOL_MAX_SETS;
+
+    VkDescriptorPoolCreateInfo descriptorPoolInfo;
+    memset(static_cast<void *>(&descriptorPoolInfo), 0, sizeof(descriptorPoolInfo));
+    descriptorPoolInfo.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    descriptorPoolInfo.pNext         = nullptr;
+    descriptorPoolInfo.flags         = 0;
+    descriptorPoolInfo.maxSets       = GLOVE_DESCRIPTOR_POOL_MAX_SETS;
+    descriptorPoolInfo.poolSizeCount = 4;
+    descriptorPoolInfo.pPoolSizes    = poolSizes;
+
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    if(vkCreateDescriptorPool(mVkContext->vkDevice, &descriptorPoolInfo, nullptr, &pool) != VK_SUCCESS) {
+        return VK_NULL_HANDLE;
+    }
+
+    return pool;
+}
+
+VkDescriptorSet
+DescriptorAllocator::Allocate(VkDescriptorSetLayout layout)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(mFrames.empty()) {
+        return VK_NULL_HANDLE;
+    }
+
+    VkDescriptorSetAllocateInfo descAllocInfo;
+    memset(static_cast<void *>(&descAllocInfo), 0, sizeof(descAllocInfo));
+    descAllocInfo.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    descAllocInfo.pNext              = nullptr;
+    descAllocInfo.descriptorSetCount = 1;
+    descAllocInfo.pSetLayouts        = &layout;
+
+    frame_t &frame = mFrames[mActiveFrame];
+    while(true) {
+        bool freshPool = false;
+        if(frame.activePool == frame.pools.size()) {
+            VkDescriptorPool pool = CreatePool();
+            if(pool == VK_NULL_HANDLE) {
+                return VK_NULL_HANDLE;
+            }
+            frame.pools.push_back(pool);
+            freshPool = true;
+        }
+
+        VkDescriptorSet descSet = VK_NULL_HANDLE;
+        descAllocInfo.descriptorPool = frame.pools[frame.activePool];
+        if(mVkContext->vkDispatch.vkAllocateDescriptorSets(mVkContext->vkDevice, &descAllocInfo, &descSet) == VK_SUCCESS) {
+            return descSet;
+        }
+
+        // a set that does not fit in an empty page will not fit in any other
+        if(freshPool) {
+            return VK_NULL_HANDLE;
+        }
+
+        // the page is exhausted (or fragmented), move on to the next one
+        ++frame.activePool;
+    }
+}
+
+void
+DescriptorAllocator::SetActiveFrame(uint32_t frame)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    assert(frame < mFrames.size());
+
+    mActiveFrame = frame;
+    for(auto pool : mFrames[mActiveFrame].pools) {
+        mVkContext->vkDispatch.vkResetDescriptorPool(mVkContext->vkDevice, pool, 0);
+    }
+    mFrames[mActiveFrame].activePool = 0;
+    mEpoch = ++mEpochCounter;
+}
+
+}
@@ -0,0 +1,86 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+
+/**
+ *  @file       descriptorAllocator.h
+ *  @author     Think Silicon
+ *  @date       14/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Per-frame paged allocator of Vulkan Descriptor Sets
+ *
+ */
+
+#ifndef __VKDESCRIPTORALLOCATOR_H__
+#define __VKDESCRIPTORALLOCATOR_H__
+
+#include "context.h"
+#include <atomic>
+#include <vector>
+
+#ifndef GLOVE_DESCRIPTOR_POOL_MAX_SETS
+#define GLOVE_DESCRIPTOR_POOL_MAX_SETS                  256
+#endif // GLOVE_DESCRIPTOR_POOL_MAX_SETS
+
+namespace vulkanAPI {
+
+class DescriptorAllocator {
+
+private:
+    typedef struct frame_t {
+        std::vector<VkDescriptorPool> pools;
+        uint32_t                      activePool;
+
+        frame_t() : activePool(0) { }
+    } frame_t;
+
+    const
+    vkContext_t *                     mVkContext;
+
+    std::vector<frame_t>              mFrames;
+    uint32_t                          mActiveFrame;
+    uint64_t                          mEpoch;
+
+    /// epochs are unique across the allocators, so that one of them is never taken for another at the same address
+    static std::atomic<uint64_t>      mEpochCounter;
+
+    VkDescriptorPool                  CreatePool(void);
+
+public:
+// Constructor
+    DescriptorAllocator(const vkContext_t *vkContext);
+
+// Destructor
+    ~DescriptorAllocator();
+
+// Create Functions
+    bool                              Create(uint32_t frameCount);
+
+// Release Functions
+    void                              Release(void);
+
+// Allocate Functions
+    VkDescriptorSet                   Allocate(VkDescriptorSetLayout layout);
+
+// Get Functions
+    inline uint64_t                   GetEpoch(void)                    const   { FUN_ENTRY(GL_LOG_TRACE); return mEpoch; }
+           uint32_t                   GetPoolCount(void)                const;
+
+// Set Functions
+    void                              SetActiveFrame(uint32_t frame);
+};
+
+}
+
+#endif // __VKDESCRIPTORALLOCATOR_H__
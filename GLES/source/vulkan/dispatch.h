@@ -0,0 +1,52 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       dispatch.h
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Device-level entry points of the recording and submission paths
+ *
+ */
+
+#ifndef __VKDISPATCH_H__
+#define __VKDISPATCH_H__
+
+#include "vulkan/vulkan.h"
+
+/// the entry points called for every draw, upload and submission. The exported ones go through the
+/// trampolines of the loader, which look the dispatch table of the device up on every call, so these
+/// are resolved with vkGetDeviceProcAddr once the device is created and called through vkDispatch
+#define GLOVE_VK_DEVICE_DISPATCH(X)                                                                                   \
+    X(vkCmdBeginQuery) X(vkCmdBeginRenderPass) X(vkCmdBindDescriptorSets) X(vkCmdBindIndexBuffer)                     \
+    X(vkCmdBindPipeline) X(vkCmdBindVertexBuffers) X(vkCmdBlitImage) X(vkCmdClearAttachments) X(vkCmdCopyBuffer)      \
+    X(vkCmdCopyBufferToImage) X(vkCmdCopyImage) X(vkCmdCopyImageToBuffer) X(vkCmdDraw) X(vkCmdDrawIndexed)            \
+    X(vkCmdEndQuery) X(vkCmdEndRenderPass) X(vkCmdExecuteCommands) X(vkCmdPipelineBarrier) X(vkCmdPushConstants)      \
+    X(vkCmdResetQueryPool) X(vkCmdSetBlendConstants) X(vkCmdSetLineWidth) X(vkCmdSetScissor)                          \
+    X(vkCmdSetStencilCompareMask) X(vkCmdSetViewport) X(vkCmdUpdateBuffer) X(vkCmdWriteTimestamp)                     \
+    X(vkBeginCommandBuffer) X(vkEndCommandBuffer) X(vkResetCommandPool) X(vkQueueSubmit) X(vkResetFences)             \
+    X(vkWaitForFences) X(vkGetFenceStatus) X(vkAllocateDescriptorSets) X(vkResetDescriptorPool)                       \
+    X(vkUpdateDescriptorSets)
+
+namespace vulkanAPI {
+
+    typedef struct vkDeviceDispatch_t {
+#define GLOVE_VK_DISPATCH_ENTRY(__function__) PFN_##__function__ __function__;
+        GLOVE_VK_DEVICE_DISPATCH(GLOVE_VK_DISPATCH_ENTRY)
+#undef GLOVE_VK_DISPATCH_ENTRY
+    } vkDeviceDispatch_t;
+};
+
+#endif // __VKDISPATCH_H__
@@ -0,0 +1,345 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       drawRecorder.cpp
+ *  @author     Think Silicon
+ *  @date       14/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Draw command recording with redundant state elimination in Vulkan
+ *
+ *  @section
+ *
+ *  Bound pipelines, descriptor sets, vertex/index buffers and dynamic state
+ *  persist within a command buffer until they are replaced. DrawRecorder
+ *  keeps a shadow copy of the last values recorded and emits vkCmdBind* and
+ *  vkCmdSet* commands only when they differ, so consecutive draws sharing
+ *  the same state cost a single vkCmdDraw*. The shadow state must be reset
+ *  whenever recording moves to another command buffer or render pass, or
+ *  when commands have been recorded behind its back.
+ *
+ */
+
+#include "drawRecorder.h"
+#include "context.h"
+
+namespace vulkanAPI {
+
+DrawRecorder::DrawRecorder()
+: mVkDispatch(&GetContext()->vkDispatch)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    Reset();
+}
+
+DrawRecorder::~DrawRecorder()
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+}
+
+void
+DrawRecorder::Reset(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    mVkPipeline          = VK_NULL_HANDLE;
+    mVkPipelineLayout    = VK_NULL_HANDLE;
+    mVkDescSet           = VK_NULL_HANDLE;
+    mVkPushConstantLayout = VK_NULL_HANDLE;
+    mVkIndexBuffer       = VK_NULL_HANDLE;
+    mVkIndexBufferOffset = 0;
+    mVkIndexType         = VK_INDEX_TYPE_MAX_ENUM;
+    mLineWidth           = 0.0f;
+
+    mVkDynamicOffsets.clear();
+    mPushConstantData.clear();
+    mVkVertexBuffers.clear();
+    mVkVertexBufferOffsets.clear();
+
+    memset(static_cast<void *>(&mVkViewport)   , 0, sizeof(mVkViewport));
+    memset(static_cast<void *>(&mVkScissorRect), 0, sizeof(mVkScissorRect));
+    memset(static_cast<void *>(mBlendConstants), 0, sizeof(mBlendConstants));
+    memset(static_cast<void *>(&mStencilFront) , 0, sizeof(mStencilFront));
+    memset(static_cast<void *>(&mStencilBack)  , 0, sizeof(mStencilBack));
+    mExtendedState       = ExtendedDynamicState();
+
+    mViewportValid       = false;
+    mScissorValid        = false;
+    mLineWidthValid      = false;
+    mBlendConstantsValid = false;
+    mStencilValid        = false;
+    mExtendedStateValid  = false;
+}
+
+void
+DrawRecorder::BindPipeline(const VkCommandBuffer *cmdBuffer, VkPipeline pipeline)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(mVkPipeline == pipeline) {
+        ++mStatistics.redundantCommands;
+        return;
+    }
+
+    mVkDispatch->vkCmdBindPipeline(*cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+    mVkPipeline = pipeline;
+    ++mStatistics.pipelineBinds;
+}
+
+void
+DrawRecorder::BindDescriptorSet(const VkCommandBuffer *cmdBuffer, VkPipelineLayout pipelineLayout, VkDescriptorSet descSet,
+                                uint32_t dynamicOffsetCount, const uint32_t *dynamicOffsets)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // a set with dynamic uniform buffers has to be rebound whenever one of its offsets moves
+    bool updated = (mVkPipelineLayout != pipelineLayout) || (mVkDescSet != descSet) || (mVkDynamicOffsets.size() != dynamicOffsetCount);
+    for(uint32_t i = 0; !updated && i < dynamicOffsetCount; ++i) {
+        updated = (mVkDynamicOffsets[i] != dynamicOffsets[i]);
+    }
+
+    if(!updated) {
+        ++mStatistics.redundantCommands;
+        return;
+    }
+
+    mVkDispatch->vkCmdBindDescriptorSets(*cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descSet, dynamicOffsetCount, dynamicOffsets);
+    mVkPipelineLayout = pipelineLayout;
+    mVkDescSet        = descSet;
+    mVkDynamicOffsets.assign(dynamicOffsets, dynamicOffsets + dynamicOffsetCount);
+    ++mStatistics.descriptorSetBinds;
+}
+
+void
+DrawRecorder::PushDescriptorSet(const VkCommandBuffer *cmdBuffer, const vkContext_t *vkContext, VkPipelineLayout pipelineLayout,
+                                uint32_t writeCount, const VkWriteDescriptorSet *writes)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+#ifdef VK_KHR_push_descriptor
+    vkContext->fpCmdPushDescriptorSet(*cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, writeCount, writes);
+#endif // VK_KHR_push_descriptor
+
+    // pushed descriptors replace whatever set was bound before
+    mVkPipelineLayout = VK_NULL_HANDLE;
+    mVkDescSet        = VK_NULL_HANDLE;
+    mVkDynamicOffsets.clear();
+    ++mStatistics.descriptorSetBinds;
+}
+
+void
+DrawRecorder::PushConstants(const VkCommandBuffer *cmdBuffer, VkPipelineLayout pipelineLayout, VkShaderStageFlags stageFlags,
+                            uint32_t size, const uint8_t *data)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(mVkPushConstantLayout == pipelineLayout && mPushConstantData.size() == size &&
+       !memcmp(mPushConstantData.data(), data, size)) {
+        ++mStatistics.redundantCommands;
+        return;
+    }
+
+    mVkDispatch->vkCmdPushConstants(*cmdBuffer, pipelineLayout, stageFlags, 0, size, data);
+    mVkPushConstantLayout = pipelineLayout;
+    mPushConstantData.assign(data, data + size);
+    ++mStatistics.pushConstantUpdates;
+}
+
+void
+DrawRecorder::BindVertexBuffers(const VkCommandBuffer *cmdBuffer, uint32_t bufferCount, const VkBuffer *buffers, const VkDeviceSize *offsets)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    bool updated = (mVkVertexBuffers.size() != bufferCount);
+    for(uint32_t i = 0; !updated && i < bufferCount; ++i) {
+        updated = (mVkVertexBuffers[i] != buffers[i]) || (mVkVertexBufferOffsets[i] != (offsets ? offsets[i] : 0));
+    }
+
+    if(!updated) {
+        ++mStatistics.redundantCommands;
+        return;
+    }
+
+    mVkVertexBuffers.assign(buffers, buffers + bufferCount);
+    if(offsets) {
+        mVkVertexBufferOffsets.assign(offsets, offsets + bufferCount);
+    } else {
+        mVkVertexBufferOffsets.assign(bufferCount, 0);
+    }
+
+    mVkDispatch->vkCmdBindVertexBuffers(*cmdBuffer, 0, bufferCount, mVkVertexBuffers.data(), mVkVertexBufferOffsets.data());
+    ++mStatistics.vertexBufferBinds;
+}
+
+void
+DrawRecorder::BindIndexBuffer(const VkCommandBuffer *cmdBuffer, VkBuffer buffer, VkDeviceSize offset, VkIndexType type)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(mVkIndexBuffer == buffer && mVkIndexBufferOffset == offset && mVkIndexType == type) {
+        ++mStatistics.redundantCommands;
+        return;
+    }
+
+    mVkDispatch->vkCmdBindIndexBuffer(*cmdBuffer, buffer, offset, type);
+    mVkIndexBuffer       = buffer;
+    mVkIndexBufferOffset = offset;
+    mVkIndexType         = type;
+    ++mStatistics.indexBufferBinds;
+}
+
+void
+DrawRecorder::SetViewport(const VkCommandBuffer *cmdBuffer, const VkViewport *viewport)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(mViewportValid && !memcmp(&mVkViewport, viewport, sizeof(mVkViewport))) {
+        ++mStatistics.redundantCommands;
+        return;
+    }
+
+    mVkDispatch->vkCmdSetViewport(*cmdBuffer, 0, 1, viewport);
+    mVkViewport    = *viewport;
+    mViewportValid = true;
+    ++mStatistics.dynamicStateSets;
+}
+
+void
+DrawRecorder::SetScissor(const VkCommandBuffer *cmdBuffer, const VkRect2D *scissorRect)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(mScissorValid && !memcmp(&mVkScissorRect, scissorRect, sizeof(mVkScissorRect))) {
+        ++mStatistics.redundantCommands;
+        return;
+    }
+
+    mVkDispatch->vkCmdSetScissor(*cmdBuffer, 0, 1, scissorRect);
+    mVkScissorRect = *scissorRect;
+    mScissorValid  = true;
+    ++mStatistics.dynamicStateSets;
+}
+
+void
+DrawRecorder::SetLineWidth(const VkCommandBuffer *cmdBuffer, float lineWidth)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(mLineWidthValid && mLineWidth == lineWidth) {
+        ++mStatistics.redundantCommands;
+        return;
+    }
+
+    mVkDispatch->vkCmdSetLineWidth(*cmdBuffer, lineWidth);
+    mLineWidth      = lineWidth;
+    mLineWidthValid = true;
+    ++mStatistics.dynamicStateSets;
+}
+
+void
+DrawRecorder::SetBlendConstants(const VkCommandBuffer *cmdBuffer, const float *blendConstants)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(mBlendConstantsValid && !memcmp(mBlendConstants, blendConstants, sizeof(mBlendConstants))) {
+        ++mStatistics.redundantCommands;
+        return;
+    }
+
+    mVkDispatch->vkCmdSetBlendConstants(*cmdBuffer, blendConstants);
+    memcpy(mBlendConstants, blendConstants, sizeof(mBlendConstants));
+    mBlendConstantsValid = true;
+    ++mStatistics.dynamicStateSets;
+}
+
+void
+DrawRecorder::SetStencilState(const VkCommandBuffer *cmdBuffer, const VkStencilOpState *front, const VkStencilOpState *back)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(mStencilValid &&
+       mStencilFront.compareMask == front->compareMask && mStencilFront.writeMask == front->writeMask && mStencilFront.reference == front->reference &&
+       mStencilBack.compareMask  == back->compareMask  && mStencilBack.writeMask  == back->writeMask  && mStencilBack.reference  == back->reference) {
+        ++mStatistics.redundantCommands;
+        return;
+    }
+
+    // GL sets both faces at once in the common case
+    if(front->compareMask == back->compareMask && front->writeMask == back->writeMask && front->reference == back->reference) {
+        mVkDispatch->vkCmdSetStencilCompareMask(*cmdBuffer, VK_STENCIL_FACE_FRONT_AND_BACK, front->compareMask);
+        vkCmdSetStencilWriteMask  (*cmdBuffer, VK_STENCIL_FACE_FRONT_AND_BACK, front->writeMask);
+        vkCmdSetStencilReference  (*cmdBuffer, VK_STENCIL_FACE_FRONT_AND_BACK, front->reference);
+    } else {
+        mVkDispatch->vkCmdSetStencilCompareMask(*cmdBuffer, VK_STENCIL_FACE_FRONT_BIT, front->compareMask);
+        vkCmdSetStencilWriteMask  (*cmdBuffer, VK_STENCIL_FACE_FRONT_BIT, front->writeMask);
+        vkCmdSetStencilReference  (*cmdBuffer, VK_STENCIL_FACE_FRONT_BIT, front->reference);
+        mVkDispatch->vkCmdSetStencilCompareMask(*cmdBuffer, VK_STENCIL_FACE_BACK_BIT , back->compareMask);
+        vkCmdSetStencilWriteMask  (*cmdBuffer, VK_STENCIL_FACE_BACK_BIT , back->writeMask);
+        vkCmdSetStencilReference  (*cmdBuffer, VK_STENCIL_FACE_BACK_BIT , back->reference);
+    }
+    mStencilFront = *front;
+    mStencilBack  = *back;
+    mStencilValid = true;
+    ++mStatistics.dynamicStateSets;
+}
+
+void
+DrawRecorder::SetExtendedState(const VkCommandBuffer *cmdBuffer, const vkContext_t *vkContext, const ExtendedDynamicState *state)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(mExtendedStateValid && !memcmp(&mExtendedState, state, sizeof(mExtendedState))) {
+        ++mStatistics.redundantCommands;
+        return;
+    }
+
+#ifdef VK_EXT_extended_dynamic_state
+    vkContext->fpCmdSetCullMode         (*cmdBuffer, state->cullMode);
+    vkContext->fpCmdSetFrontFace        (*cmdBuffer, state->frontFace);
+    vkContext->fpCmdSetDepthTestEnable  (*cmdBuffer, state->depthTestEnable);
+    vkContext->fpCmdSetDepthWriteEnable (*cmdBuffer, state->depthWriteEnable);
+    vkContext->fpCmdSetDepthCompareOp   (*cmdBuffer, state->depthCompareOp);
+    vkContext->fpCmdSetStencilTestEnable(*cmdBuffer, state->stencilTestEnable);
+    vkContext->fpCmdSetStencilOp        (*cmdBuffer, VK_STENCIL_FACE_FRONT_BIT,
+                                         state->frontFailOp, state->frontPassOp, state->frontDepthFailOp, state->frontCompareOp);
+    vkContext->fpCmdSetStencilOp        (*cmdBuffer, VK_STENCIL_FACE_BACK_BIT,
+                                         state->backFailOp , state->backPassOp , state->backDepthFailOp , state->backCompareOp);
+#else
+    (void)vkContext;
+#endif // VK_EXT_extended_dynamic_state
+    mExtendedState      = *state;
+    mExtendedStateValid = true;
+    ++mStatistics.dynamicStateSets;
+}
+
+void
+DrawRecorder::Draw(const VkCommandBuffer *cmdBuffer, uint32_t vertexCount, uint32_t firstVertex, uint32_t instanceCount)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    mVkDispatch->vkCmdDraw(*cmdBuffer, vertexCount, instanceCount, firstVertex, 0);
+    ++mStatistics.draws;
+}
+
+void
+DrawRecorder::DrawIndexed(const VkCommandBuffer *cmdBuffer, uint32_t indexCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t instanceCount)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    mVkDispatch->vkCmdDrawIndexed(*cmdBuffer, indexCount, instanceCount, firstIndex, vertexOffset, 0);
+    ++mStatistics.draws;
+}
+
+}
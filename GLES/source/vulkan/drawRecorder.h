@@ -0,0 +1,151 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       drawRecorder.h
+ *  @author     Think Silicon
+ *  @date       14/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Draw command recording with redundant state elimination in Vulkan
+ *
+ */
+
+#ifndef __VKDRAWRECORDER_H__
+#define __VKDRAWRECORDER_H__
+
+#include <vector>
+#include <cstring>
+#include "vulkan/vulkan.h"
+#include "utils/glLogger.h"
+#include "dispatch.h"
+
+namespace vulkanAPI {
+
+struct vkContext_t;
+
+class DrawRecorder {
+
+public:
+    typedef struct Statistics {
+        uint32_t                  draws;
+        uint32_t                  pipelineBinds;
+        uint32_t                  descriptorSetBinds;
+        uint32_t                  pushConstantUpdates;
+        uint32_t                  vertexBufferBinds;
+        uint32_t                  indexBufferBinds;
+        uint32_t                  dynamicStateSets;
+        uint32_t                  redundantCommands;
+
+        Statistics()              { memset(static_cast<void *>(this), 0, sizeof(*this)); }
+    } Statistics;
+
+    /// state made dynamic by VK_EXT_extended_dynamic_state
+    typedef struct ExtendedDynamicState {
+        VkCullModeFlags           cullMode;
+        VkFrontFace               frontFace;
+        VkBool32                  depthTestEnable;
+        VkBool32                  depthWriteEnable;
+        VkCompareOp               depthCompareOp;
+        VkBool32                  stencilTestEnable;
+        VkStencilOp               frontFailOp;
+        VkStencilOp               frontPassOp;
+        VkStencilOp               frontDepthFailOp;
+        VkCompareOp               frontCompareOp;
+        VkStencilOp               backFailOp;
+        VkStencilOp               backPassOp;
+        VkStencilOp               backDepthFailOp;
+        VkCompareOp               backCompareOp;
+
+        ExtendedDynamicState()    { memset(static_cast<void *>(this), 0, sizeof(*this)); }
+    } ExtendedDynamicState;
+
+private:
+    const vkDeviceDispatch_t *    mVkDispatch;
+    VkPipeline                    mVkPipeline;
+    VkPipelineLayout              mVkPipelineLayout;
+    VkDescriptorSet               mVkDescSet;
+    std::vector<uint32_t>         mVkDynamicOffsets;
+    VkPipelineLayout              mVkPushConstantLayout;
+    std::vector<uint8_t>          mPushConstantData;
+    std::vector<VkBuffer>         mVkVertexBuffers;
+    std::vector<VkDeviceSize>     mVkVertexBufferOffsets;
+    VkBuffer                      mVkIndexBuffer;
+    VkDeviceSize                  mVkIndexBufferOffset;
+    VkIndexType                   mVkIndexType;
+    VkViewport                    mVkViewport;
+    VkRect2D                      mVkScissorRect;
+    float                         mLineWidth;
+    float                         mBlendConstants[4];
+    VkStencilOpState              mStencilFront;
+    VkStencilOpState              mStencilBack;
+    ExtendedDynamicState          mExtendedState;
+
+    bool                          mViewportValid;
+    bool                          mScissorValid;
+    bool                          mLineWidthValid;
+    bool                          mBlendConstantsValid;
+    bool                          mStencilValid;
+    bool                          mExtendedStateValid;
+
+    Statistics                    mStatistics;
+
+public:
+// Constructor
+    DrawRecorder();
+
+// Destructor
+    ~DrawRecorder();
+
+// Reset Functions
+    void                          Reset(void);
+    inline void                   ResetStatistics(void)                           { FUN_ENTRY(GL_LOG_TRACE); mStatistics = Statistics(); }
+
+// Bind Functions
+    void                          BindPipeline(const VkCommandBuffer *cmdBuffer, VkPipeline pipeline);
+    void                          BindDescriptorSet(const VkCommandBuffer *cmdBuffer, VkPipelineLayout pipelineLayout, VkDescriptorSet descSet,
+                                                    uint32_t dynamicOffsetCount = 0, const uint32_t *dynamicOffsets = nullptr);
+    void                          PushDescriptorSet(const VkCommandBuffer *cmdBuffer, const vkContext_t *vkContext, VkPipelineLayout pipelineLayout,
+                                                    uint32_t writeCount, const VkWriteDescriptorSet *writes);
+    void                          BindVertexBuffers(const VkCommandBuffer *cmdBuffer, uint32_t bufferCount, const VkBuffer *buffers, const VkDeviceSize *offsets);
+    void                          BindIndexBuffer(const VkCommandBuffer *cmdBuffer, VkBuffer buffer, VkDeviceSize offset, VkIndexType type);
+
+// Set Functions
+    void                          SetViewport(const VkCommandBuffer *cmdBuffer, const VkViewport *viewport);
+    void                          SetScissor(const VkCommandBuffer *cmdBuffer, const VkRect2D *scissorRect);
+    void                          SetLineWidth(const VkCommandBuffer *cmdBuffer, float lineWidth);
+    void                          SetBlendConstants(const VkCommandBuffer *cmdBuffer, const float *blendConstants);
+    void                          SetStencilState(const VkCommandBuffer *cmdBuffer, const VkStencilOpState *front, const VkStencilOpState *back);
+    void                          SetExtendedState(const VkCommandBuffer *cmdBuffer, const vkContext_t *vkContext, const ExtendedDynamicState *state);
+    void                          PushConstants(const VkCommandBuffer *cmdBuffer, VkPipelineLayout pipelineLayout, VkShaderStageFlags stageFlags,
+                                                uint32_t size, const uint8_t *data);
+
+// Invalidate Functions
+    inline void                   InvalidateViewport(void)                        { FUN_ENTRY(GL_LOG_TRACE); mViewportValid  = false; }
+    inline void                   InvalidateScissor(void)                         { FUN_ENTRY(GL_LOG_TRACE); mScissorValid   = false; }
+    inline void                   InvalidateLineWidth(void)                       { FUN_ENTRY(GL_LOG_TRACE); mLineWidthValid = false; }
+    inline void                   InvalidateBlendConstants(void)                  { FUN_ENTRY(GL_LOG_TRACE); mBlendConstantsValid = false; }
+    inline void                   InvalidateStencilState(void)                    { FUN_ENTRY(GL_LOG_TRACE); mStencilValid   = false; }
+    inline void                   InvalidateExtendedState(void)                   { FUN_ENTRY(GL_LOG_TRACE); mExtendedStateValid = false; }
+
+// Draw Functions
+    void                          Draw(const VkCommandBuffer *cmdBuffer, uint32_t vertexCount, uint32_t firstVertex, uint32_t instanceCount);
+    void                          DrawIndexed(const VkCommandBuffer *cmdBuffer, uint32_t indexCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t instanceCount);
+
+// Get Functions
+    inline const Statistics      *GetStatistics(void)                       const { FUN_ENTRY(GL_LOG_TRACE); return &mStatistics; }
+};
+
+}
+
+#endif // __VKDRAWRECORDER_H__
@@ -19,13 +19,36 @@
  *
  *  @brief      Determine completion of execution of queue operations via Fences in Vulkan
  *
+ *  @section
+ *
+ *  A blocking vkWaitForFences puts the thread to sleep and the wake-up
+ *  costs more than a small upload or readback takes on the device, so a
+ *  wait first polls the fence for GLOVE_FENCE_SPIN_US microseconds and
+ *  only then blocks, for what is left of its timeout.
  *
  */
 
 #include "fence.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
 
 namespace vulkanAPI {
 
+fenceWaitPolicy_t::fenceWaitPolicy_t(uint64_t timeout)
+: timeoutNs(timeout)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    static const uint64_t spinTimeNs = []() {
+        const char *spin = getenv(GLOVE_VK_FENCE_SPIN_US_ENV);
+        return static_cast<uint64_t>(spin ? strtoull(spin, nullptr, 10) : GLOVE_VK_FENCE_SPIN_US) * 1000;
+    }();
+
+    spinNs = std::min(spinTimeNs, timeout);
+}
+
 Fence::Fence(const vkContext_t *vkContext)
 : mVkContext(vkContext), mVkFence(VK_NULL_HANDLE)
 {
@@ -55,30 +78,54 @@ Fence::Reset(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    VkResult err = vkResetFences(mVkContext->vkDevice, 1, &mVkFence);
+    VkResult err = mVkContext->vkDispatch.vkResetFences(mVkContext->vkDevice, 1, &mVkFence);
     assert(!err);
 
     return (err != VK_ERROR_OUT_OF_HOST_MEMORY && err != VK_ERROR_OUT_OF_DEVICE_MEMORY);
 }
 
-bool
-Fence::Wait(VkBool32 waitAll, uint64_t timeout)
+VkResult
+Fence::Wait(const fenceWaitPolicy_t &policy, fenceWaitInfo_t *info) const
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    VkResult err = VK_TIMEOUT;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point now   = start;
 
-    do {
+    VkResult err = mVkContext->vkDispatch.vkGetFenceStatus(mVkContext->vkDevice, mVkFence);
+    while(err == VK_NOT_READY && now - start < std::chrono::nanoseconds(policy.spinNs)) {
+        std::this_thread::yield();
+        err = mVkContext->vkDispatch.vkGetFenceStatus(mVkContext->vkDevice, mVkFence);
+        now = std::chrono::steady_clock::now();
+    }
+
+    uint64_t spentNs = std::chrono::duration_cast<std::chrono::nanoseconds>(now - start).count();
+    bool     blocked = err == VK_NOT_READY && policy.timeoutNs > spentNs;
+    if(blocked && policy.timeoutNs == UINT64_MAX) {
+        do {
+            err = mVkContext->vkDispatch.vkWaitForFences(mVkContext->vkDevice, 1, &mVkFence, VK_TRUE, UINT64_MAX);
+        } while(err == VK_TIMEOUT);
+    } else if(blocked) {
+        err = mVkContext->vkDispatch.vkWaitForFences(mVkContext->vkDevice, 1, &mVkFence, VK_TRUE, policy.timeoutNs - spentNs);
+    } else if(err == VK_NOT_READY) {
+        err = VK_TIMEOUT;
+    }
+    assert(err == VK_SUCCESS || err == VK_TIMEOUT);
 
-      err = vkWaitForFences(mVkContext->vkDevice, 1, &mVkFence, waitAll, timeout);
-      assert(!err);
+    if(info) {
+        info->blocked = blocked;
+        info->timeUs  = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    }
 
-      if(err == VK_ERROR_OUT_OF_HOST_MEMORY || err == VK_ERROR_OUT_OF_DEVICE_MEMORY || err == VK_ERROR_DEVICE_LOST)
-          return false;
+    return err;
+}
 
-    } while (err == VK_TIMEOUT);
+bool
+Fence::IsSignaled(void) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
 
-    return true;
+    return mVkContext->vkDispatch.vkGetFenceStatus(mVkContext->vkDevice, mVkFence) == VK_SUCCESS;
 }
 
 bool
@@ -26,8 +26,30 @@
 
 #include "context.h"
 
+/// how long a wait polls for completion before it blocks in the driver, which short uploads finish within
+#ifndef GLOVE_VK_FENCE_SPIN_US
+#define GLOVE_VK_FENCE_SPIN_US                          50
+#endif // GLOVE_VK_FENCE_SPIN_US
+#define GLOVE_VK_FENCE_SPIN_US_ENV                      "GLOVE_FENCE_SPIN_US"
+
 namespace vulkanAPI {
 
+typedef struct fenceWaitPolicy_t {
+    /// polls the status this long first, 0 blocks at once
+    uint64_t                          spinNs;
+    /// UINT64_MAX waits until completion, any other value returns VK_TIMEOUT once it expires
+    uint64_t                          timeoutNs;
+
+    /// the spin time of GLOVE_FENCE_SPIN_US, never longer than the timeout
+    explicit fenceWaitPolicy_t(uint64_t timeout);
+} fenceWaitPolicy_t;
+
+/// what a wait took, for the statistics
+typedef struct fenceWaitInfo_t {
+    bool                              blocked;
+    uint64_t                          timeUs;
+} fenceWaitInfo_t;
+
 class Fence {
 
 private:
@@ -54,7 +76,11 @@ public:
     bool                              Reset(void);
 
 // Wait Functions
-    bool                              Wait(VkBool32  waitAll, uint64_t timeout);
+    VkResult                          Wait(const fenceWaitPolicy_t &policy, fenceWaitInfo_t *info = nullptr) const;
+    inline VkResult                   WaitFor(uint64_t timeout)           const { FUN_ENTRY(GL_LOG_DEBUG); return Wait(fenceWaitPolicy_t(timeout)); }
+
+// Is Functions
+    bool                              IsSignaled(void)                    const;
 
 // Get Functions
     inline VkFence                    GetFence(void)                      const { FUN_ENTRY(GL_LOG_TRACE); return mVkFence; }
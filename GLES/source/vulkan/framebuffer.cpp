@@ -79,4 +79,55 @@ Framebuffer::Create(vector<VkImageView> *imageViews, VkRenderPass *renderpass, u
     return (err != VK_ERROR_OUT_OF_HOST_MEMORY && err != VK_ERROR_OUT_OF_DEVICE_MEMORY);
 }
 
+bool
+Framebuffer::CreateImageless(const vector<VkFormat> *formats, const vector<VkImageUsageFlags> *usages,
+                             VkRenderPass *renderpass, uint32_t width, uint32_t height)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    Release();
+
+#ifdef VK_KHR_imageless_framebuffer
+    assert(mVkContext->mIsImagelessFramebufferSupported);
+    assert(formats->size() == usages->size());
+
+    vector<VkFramebufferAttachmentImageInfoKHR> imageInfos(formats->size());
+    for(uint32_t i = 0; i < imageInfos.size(); ++i) {
+        imageInfos[i].sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_ATTACHMENT_IMAGE_INFO_KHR;
+        imageInfos[i].pNext           = nullptr;
+        imageInfos[i].flags           = 0;
+        imageInfos[i].usage           = (*usages)[i];
+        imageInfos[i].width           = width;
+        imageInfos[i].height          = height;
+        imageInfos[i].layerCount      = 1;
+        imageInfos[i].viewFormatCount = 1;
+        imageInfos[i].pViewFormats    = &(*formats)[i];
+    }
+
+    VkFramebufferAttachmentsCreateInfoKHR attachmentsInfo;
+    attachmentsInfo.sType                    = VK_STRUCTURE_TYPE_FRAMEBUFFER_ATTACHMENTS_CREATE_INFO_KHR;
+    attachmentsInfo.pNext                    = nullptr;
+    attachmentsInfo.attachmentImageInfoCount = static_cast<uint32_t>(imageInfos.size());
+    attachmentsInfo.pAttachmentImageInfos    = imageInfos.data();
+
+    VkFramebufferCreateInfo info;
+    info.sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    info.pNext           = &attachmentsInfo;
+    info.flags           = VK_FRAMEBUFFER_CREATE_IMAGELESS_BIT_KHR;
+    info.renderPass      = *renderpass;
+    info.width           = width;
+    info.height          = height;
+    info.layers          = 1;
+    info.attachmentCount = static_cast<uint32_t>(imageInfos.size());
+    info.pAttachments    = nullptr;
+
+    VkResult err = vkCreateFramebuffer(mVkContext->vkDevice, &info, nullptr, &mVkFramebuffer);
+    assert(!err);
+
+    return (err != VK_ERROR_OUT_OF_HOST_MEMORY && err != VK_ERROR_OUT_OF_DEVICE_MEMORY);
+#else
+    return false;
+#endif // VK_KHR_imageless_framebuffer
+}
+
 }
@@ -46,6 +46,9 @@ public:
 
 // Create Functions
     bool                    Create  (vector<VkImageView> *imageViews, VkRenderPass *renderpass, uint32_t width, uint32_t height);
+    /// the image views are given when the render pass begins, any images with the same formats and usage can be attached
+    bool                    CreateImageless(const vector<VkFormat> *formats, const vector<VkImageUsageFlags> *usages,
+                                            VkRenderPass *renderpass, uint32_t width, uint32_t height);
 
 // Release Functions
     void                    Release (void);
@@ -36,9 +36,9 @@ namespace vulkanAPI {
 Image::Image(const vkContext_t *vkContext)
 : mVkContext(vkContext), mVkImage(VK_NULL_HANDLE), mVkFormat(VK_FORMAT_UNDEFINED), mVkImageType(VK_IMAGE_TYPE_2D),
 mVkImageUsage(VK_IMAGE_USAGE_FLAG_BITS_MAX_ENUM), mVkImageLayout(VK_IMAGE_LAYOUT_UNDEFINED),
-mVkImageTiling(VK_IMAGE_TILING_LINEAR), mVkImageTarget(VK_IMAGE_TARGET_2D),
+mVkImageTiling(VK_IMAGE_TILING_OPTIMAL), mVkImageTarget(VK_IMAGE_TARGET_2D),
 mVkSampleCount(VK_SAMPLE_COUNT_1_BIT), mVkSharingMode(VK_SHARING_MODE_EXCLUSIVE),
-mWidth(0), mHeight(0), mMipLevels(1), mLayers(1), mDelete(true),
+mWidth(0), mHeight(0), mDepth(1), mMipLevels(1), mLayers(1), mDelete(true),
 mCopyStencil(false)
 {
     FUN_ENTRY(GL_LOG_TRACE);
@@ -58,13 +58,15 @@ Image::Release(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(mVkImage != VK_NULL_HANDLE) {
+    // an image that was set rather than created belongs to someone else, e.g., the swapchain or a pbuffer
+    if(mVkImage != VK_NULL_HANDLE && mDelete) {
         vkDestroyImage(mVkContext->vkDevice, mVkImage, nullptr);
-        mVkImage = VK_NULL_HANDLE;
     }
+    mVkImage = VK_NULL_HANDLE;
 
     mWidth      = 0;
     mHeight     = 0;
+    mDepth      = 1;
     mMipLevels  = 1;
     mLayers     = 1;
     mDelete     = true;
@@ -73,30 +75,13 @@ Image::Release(void)
 void
 Image::SetImageTiling(void)
 {
-    VkFormatProperties props;
-    vkGetPhysicalDeviceFormatProperties(mVkContext->vkGpus[0], mVkFormat, &props);
-
-    VkFormatFeatureFlagBits flagbits = static_cast<VkFormatFeatureFlagBits>(0);
-    if(mVkImageUsage & VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT) {
-        flagbits = VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT;
-    }
-    else if (mVkImageUsage & VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT) {
-        flagbits = VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT;
-    }
+    FUN_ENTRY(GL_LOG_TRACE);
 
-    if      (props.linearTilingFeatures  & flagbits) {
-        mVkImageTiling = VK_IMAGE_TILING_LINEAR;
-    }
-    else if (props.optimalTilingFeatures & flagbits) {
-        mVkImageTiling = VK_IMAGE_TILING_OPTIMAL;
-    }
-    else {
-        // Format not supported
-        mVkImageTiling = VK_IMAGE_TILING_OPTIMAL;
-    }
+    // images live on the device, tiled for sampling, rendering and framebuffer compression, and the
+    // host reaches them through staging buffers only. A linear image has to be asked for explicitly
+    mVkImageTiling = VK_IMAGE_TILING_OPTIMAL;
 }
 
-
 bool
 Image::Create(void)
 {
@@ -105,13 +90,13 @@ Image::Create(void)
     VkImageCreateInfo info;
     info.sType          = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
     info.pNext          = nullptr;
-    info.flags          = mVkImageTarget == VK_IMAGE_TARGET_2D ? 0 : VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
-    info.imageType      = mVkImageType;
+    info.flags          = mVkImageTarget == VK_IMAGE_TARGET_CUBE ? VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT : 0;
+    info.imageType      = mVkImageTarget == VK_IMAGE_TARGET_3D   ? VK_IMAGE_TYPE_3D : mVkImageType;
     info.format         = mVkFormat;
     info.extent.width   = mWidth;
     info.extent.height  = mHeight;
-    info.extent.depth   = 1;
-    info.arrayLayers    = mVkImageTarget == VK_IMAGE_TARGET_2D ? TEXTURE_2D_LAYERS : TEXTURE_CUBE_MAP_LAYERS;
+    info.extent.depth   = mVkImageTarget == VK_IMAGE_TARGET_3D   ? mDepth : 1;
+    info.arrayLayers    = mVkImageTarget == VK_IMAGE_TARGET_CUBE ? TEXTURE_CUBE_MAP_LAYERS : TEXTURE_2D_LAYERS;
     info.mipLevels      = mMipLevels;
     info.samples        = mVkSampleCount;
     info.tiling         = mVkImageTiling;
@@ -122,6 +107,20 @@ Image::Create(void)
     info.queueFamilyIndexCount = 0;
     info.pQueueFamilyIndices   = nullptr;
 
+#ifdef VK_EXT_image_compression_control
+    // color attachments are compressed at a rate of the driver's choice, which it falls back from where the format has none
+    VkImageCompressionControlEXT compressionControl;
+    compressionControl.sType                        = VK_STRUCTURE_TYPE_IMAGE_COMPRESSION_CONTROL_EXT;
+    compressionControl.pNext                        = nullptr;
+    compressionControl.flags                        = VK_IMAGE_COMPRESSION_FIXED_RATE_DEFAULT_EXT;
+    compressionControl.compressionControlPlaneCount = 0;
+    compressionControl.pFixedRateFlags              = nullptr;
+
+    if(mVkContext->mIsImageCompressionControlSupported && (mVkImageUsage & VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT)) {
+        info.pNext = &compressionControl;
+    }
+#endif // VK_EXT_image_compression_control
+
     VkResult err = vkCreateImage(mVkContext->vkDevice, &info, nullptr, &mVkImage);
     assert(!err);
 
@@ -133,8 +132,80 @@ Image::Create(void)
     return (err != VK_ERROR_OUT_OF_HOST_MEMORY && err != VK_ERROR_OUT_OF_DEVICE_MEMORY);
 }
 
+bool
+Image::CreateDmaBuf(uint64_t modifier, VkDeviceSize offset, VkDeviceSize pitch)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+#ifdef GLOVE_VK_DMA_BUF_IMPORT
+    VkSubresourceLayout planeLayout;
+    planeLayout.offset     = offset;
+    planeLayout.size       = 0;
+    planeLayout.rowPitch   = pitch;
+    planeLayout.arrayPitch = 0;
+    planeLayout.depthPitch = 0;
+
+    VkImageDrmFormatModifierExplicitCreateInfoEXT modifierInfo;
+    modifierInfo.sType                       = VK_STRUCTURE_TYPE_IMAGE_DRM_FORMAT_MODIFIER_EXPLICIT_CREATE_INFO_EXT;
+    modifierInfo.pNext                       = nullptr;
+    modifierInfo.drmFormatModifier           = modifier;
+    modifierInfo.drmFormatModifierPlaneCount = 1;
+    modifierInfo.pPlaneLayouts               = &planeLayout;
+
+    VkExternalMemoryImageCreateInfoKHR externalInfo;
+    externalInfo.sType       = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_IMAGE_CREATE_INFO_KHR;
+    externalInfo.pNext       = &modifierInfo;
+    externalInfo.handleTypes = VK_EXTERNAL_MEMORY_HANDLE_TYPE_DMA_BUF_BIT_EXT;
+
+    // the usage of the texture is kept for the image it gets once respecified
+    VkImageCreateInfo info;
+    info.sType          = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    info.pNext          = &externalInfo;
+    info.flags          = 0;
+    info.imageType      = VK_IMAGE_TYPE_2D;
+    info.format         = mVkFormat;
+    info.extent.width   = mWidth;
+    info.extent.height  = mHeight;
+    info.extent.depth   = 1;
+    info.arrayLayers    = TEXTURE_2D_LAYERS;
+    info.mipLevels      = 1;
+    info.samples        = VK_SAMPLE_COUNT_1_BIT;
+    info.tiling         = VK_IMAGE_TILING_DRM_FORMAT_MODIFIER_EXT;
+    info.usage          = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    info.sharingMode    = VK_SHARING_MODE_EXCLUSIVE;
+    info.initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    info.queueFamilyIndexCount = 0;
+    info.pQueueFamilyIndices   = nullptr;
+
+    VkResult err = vkCreateImage(mVkContext->vkDevice, &info, nullptr, &mVkImage);
+    if(err != VK_SUCCESS) {
+        mVkImage = VK_NULL_HANDLE;
+        return false;
+    }
+
+    // the content written by the producer is laid out as the modifier describes, which the
+    // general layout keeps, while a transition out of the undefined one could discard it
+    mDelete        = VK_TRUE;
+    mLayers        = info.arrayLayers;
+    mMipLevels     = info.mipLevels;
+    mVkImageTarget = VK_IMAGE_TARGET_2D;
+    mVkImageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+    CreateImageSubresourceRange();
+
+    return true;
+#else
+    (void)modifier;
+    (void)offset;
+    (void)pitch;
+
+    return false;
+#endif // GLOVE_VK_DMA_BUF_IMPORT
+}
+
 void
-Image::CreateBufferImageCopy(int32_t offsetX, int32_t offsetY, uint32_t extentWidth, uint32_t extentHeight, uint32_t miplevel, uint32_t layer, uint32_t layerCount)
+Image::CreateBufferImageCopy(int32_t offsetX, int32_t offsetY, uint32_t extentWidth, uint32_t extentHeight, uint32_t miplevel, uint32_t layer, uint32_t layerCount, uint32_t bufferRowLength)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
@@ -150,18 +221,21 @@ Image::CreateBufferImageCopy(int32_t offsetX, int32_t offsetY, uint32_t extentWi
         }
     }
 
+    // the layers of a 3D image are its slices
+    const bool volume = mVkImageTarget == VK_IMAGE_TARGET_3D;
+
     mVkBufferImageCopy.imageSubresource.aspectMask     = aspectMask;
     mVkBufferImageCopy.imageSubresource.mipLevel       = miplevel;
-    mVkBufferImageCopy.imageSubresource.baseArrayLayer = layer;
-    mVkBufferImageCopy.imageSubresource.layerCount     = layerCount;
+    mVkBufferImageCopy.imageSubresource.baseArrayLayer = volume ? 0 : layer;
+    mVkBufferImageCopy.imageSubresource.layerCount     = volume ? 1 : layerCount;
     mVkBufferImageCopy.imageOffset.x                   = offsetX;
     mVkBufferImageCopy.imageOffset.y                   = offsetY;
-    mVkBufferImageCopy.imageOffset.z                   = 0;
+    mVkBufferImageCopy.imageOffset.z                   = volume ? static_cast<int32_t>(layer) : 0;
     mVkBufferImageCopy.imageExtent.width               = extentWidth;
     mVkBufferImageCopy.imageExtent.height              = extentHeight;
-    mVkBufferImageCopy.imageExtent.depth               = 1;
+    mVkBufferImageCopy.imageExtent.depth               = volume ? layerCount : 1;
     mVkBufferImageCopy.bufferOffset                    = 0;
-    mVkBufferImageCopy.bufferRowLength                 = 0;
+    mVkBufferImageCopy.bufferRowLength                 = bufferRowLength;
     mVkBufferImageCopy.bufferImageHeight               = 0;
 }
 
@@ -170,7 +244,7 @@ Image::CopyBufferToImage(VkCommandBuffer *activeCmdBuffer, VkBuffer srcBuffer)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    vkCmdCopyBufferToImage(*activeCmdBuffer, srcBuffer, mVkImage, mVkImageLayout, 1, &mVkBufferImageCopy);
+    mVkContext->vkDispatch.vkCmdCopyBufferToImage(*activeCmdBuffer, srcBuffer, mVkImage, mVkImageLayout, 1, &mVkBufferImageCopy);
 }
 
 void
@@ -178,7 +252,27 @@ Image::CopyImageToBuffer(VkCommandBuffer *activeCmdBuffer, VkBuffer srcBuffer)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    vkCmdCopyImageToBuffer(*activeCmdBuffer, mVkImage, mVkImageLayout, srcBuffer, 1, &mVkBufferImageCopy);
+    mVkContext->vkDispatch.vkCmdCopyImageToBuffer(*activeCmdBuffer, mVkImage, mVkImageLayout, srcBuffer, 1, &mVkBufferImageCopy);
+}
+
+void
+Image::CopyImage(VkCommandBuffer *activeCmdBuffer, VkImageLayout srcImageLayout, VkImage dstImage, VkImageLayout dstImageLayout, const VkImageCopy* imageCopy)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    mVkContext->vkDispatch.vkCmdCopyImage(*activeCmdBuffer, GetImage(), srcImageLayout, dstImage, dstImageLayout, 1, imageCopy);
+}
+
+bool
+Image::IsFormatFeatureSupported(VkFormatFeatureFlags features) const
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    VkFormatProperties props;
+    vkGetPhysicalDeviceFormatProperties(mVkContext->vkGpus[0], mVkFormat, &props);
+
+    VkFormatFeatureFlags supported = mVkImageTiling == VK_IMAGE_TILING_LINEAR ? props.linearTilingFeatures : props.optimalTilingFeatures;
+    return (supported & features) == features;
 }
 
 void
@@ -186,7 +280,7 @@ Image::BlitImage(VkCommandBuffer *activeCmdBuffer, VkImageLayout srcImageLayout,
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    vkCmdBlitImage(*activeCmdBuffer, GetImage(), srcImageLayout, dstImage, dstImageLayout, 1, imageBlit, imageFilter);
+    mVkContext->vkDispatch.vkCmdBlitImage(*activeCmdBuffer, GetImage(), srcImageLayout, dstImage, dstImageLayout, 1, imageBlit, imageFilter);
 }
 
 void
@@ -218,10 +312,13 @@ Image::ModifyImageSubresourceRange(uint32_t baseMipLevel, uint32_t levelCount, u
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    // barriers cover every slice of a 3D image, which has a single layer
+    const bool volume = mVkImageTarget == VK_IMAGE_TARGET_3D;
+
     mVkImageSubresourceRange.baseMipLevel    = baseMipLevel;
     mVkImageSubresourceRange.levelCount      = levelCount;
-    mVkImageSubresourceRange.baseArrayLayer  = baseArrayLayer;
-    mVkImageSubresourceRange.layerCount      = layerCount;
+    mVkImageSubresourceRange.baseArrayLayer  = volume ? 0 : baseArrayLayer;
+    mVkImageSubresourceRange.layerCount      = volume ? 1 : layerCount;
 }
 
 void
@@ -359,11 +456,39 @@ Image::ModifyImageLayout(VkCommandBuffer *activeCmdBuffer, VkImageLayout newImag
         break;
     }
 
-    vkCmdPipelineBarrier(*activeCmdBuffer, srcStages, destStages, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
+    mVkContext->vkDispatch.vkCmdPipelineBarrier(*activeCmdBuffer, srcStages, destStages, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
 
     mVkImageLayout = newImageLayout;
 }
 
+void
+Image::TransferImageOwnership(VkCommandBuffer *activeCmdBuffer, VkImageLayout oldImageLayout, VkImageLayout newImageLayout,
+                              uint32_t srcQueueFamilyIndex, uint32_t dstQueueFamilyIndex, bool release)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // A queue family ownership transfer is a pair of identical barriers, a release
+    // recorded on the source queue and an acquire recorded on the destination queue.
+    // Only the access mask of the half that executes on its own queue is meaningful,
+    // while the ordering between the two queues is provided by a semaphore.
+    VkImageMemoryBarrier imageMemoryBarrier;
+    imageMemoryBarrier.sType                = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    imageMemoryBarrier.pNext                = nullptr;
+    imageMemoryBarrier.srcAccessMask        = release ? VK_ACCESS_MEMORY_WRITE_BIT : 0;
+    imageMemoryBarrier.dstAccessMask        = release ? 0 : VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+    imageMemoryBarrier.oldLayout            = oldImageLayout;
+    imageMemoryBarrier.newLayout            = newImageLayout;
+    imageMemoryBarrier.srcQueueFamilyIndex  = srcQueueFamilyIndex;
+    imageMemoryBarrier.dstQueueFamilyIndex  = dstQueueFamilyIndex;
+    imageMemoryBarrier.image                = mVkImage;
+    imageMemoryBarrier.subresourceRange     = mVkImageSubresourceRange;
+
+    VkPipelineStageFlags srcStages  = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    VkPipelineStageFlags destStages = release ? VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT : VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+    mVkContext->vkDispatch.vkCmdPipelineBarrier(*activeCmdBuffer, srcStages, destStages, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
+}
+
 VkFormat
 Image::FindSupportedVkColorFormat(VkFormat format)
 {
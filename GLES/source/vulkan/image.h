@@ -26,19 +26,21 @@
 
 #include "utils.h"
 #include "context.h"
+#include "utils/objectPool.h"
 
 #define TEXTURE_2D_LAYERS         1
 #define TEXTURE_CUBE_MAP_LAYERS   6
 
 namespace vulkanAPI {
 
-class Image {
+class Image : public PooledObject {
 public:
 
     typedef enum VkImageTarget {
         VK_IMAGE_TARGET_2D   = 0,
         VK_IMAGE_TARGET_CUBE = 1,
-        VK_IMAGE_TARGET_MAX  = 2
+        VK_IMAGE_TARGET_3D   = 2,
+        VK_IMAGE_TARGET_MAX  = 3
     } VkImageTarget;
 
 private:
@@ -60,6 +62,8 @@ private:
 
     uint32_t                          mWidth;
     uint32_t                          mHeight;
+    /// slices of a 3D image, which the layers of the copies and barriers address instead of array layers
+    uint32_t                          mDepth;
     uint32_t                          mMipLevels;
     uint32_t                          mLayers;
     VkBool32                          mDelete;
@@ -80,17 +84,28 @@ public:
 
 // Create Functions
     bool                              Create(void);
+    /// a single level 2D image over the plane of a dma-buf, to be bound to the memory imported from it
+    bool                              CreateDmaBuf(uint64_t modifier, VkDeviceSize offset, VkDeviceSize pitch);
     void                              CreateImageSubresourceRange(void);
-    void                              CreateBufferImageCopy(int32_t offsetX, int32_t offsetY, uint32_t extentWidth, uint32_t extentHeight, uint32_t miplevel, uint32_t layer, uint32_t layerCount);
+    void                              CreateBufferImageCopy(int32_t offsetX, int32_t offsetY, uint32_t extentWidth, uint32_t extentHeight, uint32_t miplevel, uint32_t layer, uint32_t layerCount, uint32_t bufferRowLength = 0);
 
 // Copy Functions
     void                              CopyBufferToImage(VkCommandBuffer *activeCmdBuffer, VkBuffer srcBuffer);
     void                              CopyImageToBuffer(VkCommandBuffer *activeCmdBuffer, VkBuffer srcBuffer);
+    void                              CopyImage(        VkCommandBuffer *activeCmdBuffer, VkImageLayout srcImageLayout,
+                                                        VkImage          dstImage,        VkImageLayout dstImageLayout,
+                                                  const VkImageCopy*     imageCopy);
+// Is Functions
+    bool                              IsFormatFeatureSupported(VkFormatFeatureFlags features) const;
 
 // Modify Functions
     void                              ModifyImageSubresourceRange(uint32_t baseMipLevel, uint32_t levelCount, uint32_t baseArrayLayer, uint32_t layerCount);
     void                              ModifyImageLayout(VkCommandBuffer *activeCmdBuffer, VkImageLayout newImageLayout);
 
+// Transfer Functions
+    void                              TransferImageOwnership(VkCommandBuffer *activeCmdBuffer, VkImageLayout oldImageLayout, VkImageLayout newImageLayout,
+                                                             uint32_t srcQueueFamilyIndex, uint32_t dstQueueFamilyIndex, bool release);
+
 // Release Functions
     void                              Release(void);
 
@@ -99,10 +114,13 @@ public:
     inline VkFormat                   GetFormat(void)                     const { FUN_ENTRY(GL_LOG_TRACE); return mVkFormat;         }
     inline VkImageTarget              GetImageTarget(void)                const { FUN_ENTRY(GL_LOG_TRACE); return mVkImageTarget;    }
     inline VkImageLayout              GetImageLayout(void)                const { FUN_ENTRY(GL_LOG_TRACE); return mVkImageLayout;    }
+    inline VkImageUsageFlagBits       GetImageUsage(void)                 const { FUN_ENTRY(GL_LOG_TRACE); return mVkImageUsage;     }
     inline VkBufferImageCopy *        GetBufferImageCopy(void)                  { FUN_ENTRY(GL_LOG_TRACE); return &mVkBufferImageCopy;      }
     inline VkImageSubresourceRange    GetImageSubresourceRange(void)      const { FUN_ENTRY(GL_LOG_TRACE); return mVkImageSubresourceRange; }
     inline uint32_t                   GetMipLevels(void)                  const { FUN_ENTRY(GL_LOG_TRACE); return mMipLevels;        }
     inline uint32_t                   GetLayers(void)                     const { FUN_ENTRY(GL_LOG_TRACE); return mLayers;           }
+    inline uint32_t                   GetDepth(void)                      const { FUN_ENTRY(GL_LOG_TRACE); return mDepth;            }
+    inline VkSampleCountFlagBits      GetSampleCount(void)                const { FUN_ENTRY(GL_LOG_TRACE); return mVkSampleCount;    }
 
 // Set Functions
     inline void                       SetContext(const vkContext_t *vkContext)  { FUN_ENTRY(GL_LOG_TRACE); mVkContext     = vkContext; }
@@ -117,7 +135,9 @@ public:
     inline void                       SetImageLayout(VkImageLayout layout)      { FUN_ENTRY(GL_LOG_TRACE); mVkImageLayout = layout;    }
     inline void                       SetWidth(uint32_t width)                  { FUN_ENTRY(GL_LOG_TRACE); mWidth         = width;     }
     inline void                       SetHeight(uint32_t height)                { FUN_ENTRY(GL_LOG_TRACE); mHeight        = height;    }
+    inline void                       SetDepth(uint32_t depth)                  { FUN_ENTRY(GL_LOG_TRACE); mDepth         = depth;     }
     inline void                       SetMipLevels(uint32_t levels)             { FUN_ENTRY(GL_LOG_TRACE); mMipLevels     = levels;    }
+    inline void                       SetSampleCount(VkSampleCountFlagBits samples) { FUN_ENTRY(GL_LOG_TRACE); mVkSampleCount = samples; }
 
 // Find Functions
     VkFormat                          FindSupportedVkColorFormat(VkFormat format);
@@ -31,13 +31,22 @@
  */
 
 #include "imageView.h"
+#include "commandBundle.h"
+#include <atomic>
 
 namespace vulkanAPI {
 
+static std::atomic<uint64_t> sImageViewCount(0);
+
 ImageView::ImageView(const vkContext_t *vkContext)
-: mVkContext(vkContext), mVkImageView(VK_NULL_HANDLE)
+: mVkContext(vkContext), mVkImageView(VK_NULL_HANDLE), mId(0)
 {
     FUN_ENTRY(GL_LOG_TRACE);
+
+    mVkComponentMapping.r = VK_COMPONENT_SWIZZLE_R;
+    mVkComponentMapping.g = VK_COMPONENT_SWIZZLE_G;
+    mVkComponentMapping.b = VK_COMPONENT_SWIZZLE_B;
+    mVkComponentMapping.a = VK_COMPONENT_SWIZZLE_A;
 }
 
 ImageView::~ImageView()
@@ -53,6 +62,7 @@ ImageView::Release(void)
     FUN_ENTRY(GL_LOG_DEBUG);
 
     if(mVkImageView != VK_NULL_HANDLE) {
+        CommandBundle::Retire(CommandBundle::GetHandleKey(mVkImageView));
         vkDestroyImageView(mVkContext->vkDevice, mVkImageView, nullptr);
         mVkImageView = VK_NULL_HANDLE;
     }
@@ -67,17 +77,16 @@ ImageView::Create(vulkanAPI::Image *image)
     info.sType            = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
     info.pNext            = nullptr;
     info.flags            = 0;
-    info.viewType         = (image->GetImageTarget() == Image::VK_IMAGE_TARGET_2D) ? VK_IMAGE_VIEW_TYPE_2D : VK_IMAGE_VIEW_TYPE_CUBE;
+    info.viewType         = (image->GetImageTarget() == Image::VK_IMAGE_TARGET_2D)   ? VK_IMAGE_VIEW_TYPE_2D   :
+                            (image->GetImageTarget() == Image::VK_IMAGE_TARGET_CUBE) ? VK_IMAGE_VIEW_TYPE_CUBE : VK_IMAGE_VIEW_TYPE_3D;
     info.image            = image->GetImage();
     info.format           = image->GetFormat();
-    info.components.r     = VK_COMPONENT_SWIZZLE_R;
-    info.components.g     = VK_COMPONENT_SWIZZLE_G;
-    info.components.b     = VK_COMPONENT_SWIZZLE_B;
-    info.components.a     = VK_COMPONENT_SWIZZLE_A;
+    info.components       = mVkComponentMapping;
     info.subresourceRange = image->GetImageSubresourceRange();
 
     VkResult err = vkCreateImageView(mVkContext->vkDevice, &info, nullptr, &mVkImageView);
     assert(!err);
+    mId = ++sImageViewCount;
 
     return (err != VK_ERROR_OUT_OF_HOST_MEMORY && err != VK_ERROR_OUT_OF_DEVICE_MEMORY);
 }
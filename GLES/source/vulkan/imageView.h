@@ -28,7 +28,7 @@
 
 namespace vulkanAPI {
 
-class ImageView {
+class ImageView : public PooledObject {
 
 private:
 
@@ -36,6 +36,9 @@ private:
     vkContext_t *                     mVkContext;
 
     VkImageView                       mVkImageView;
+    /// unique per created view, unlike the handle that may be reused once destroyed
+    uint64_t                          mId;
+    VkComponentMapping                mVkComponentMapping;
 
 public:
 // Constructor
@@ -52,9 +55,11 @@ public:
 
 // Get Functions
     inline VkImageView                GetImageView(void)                  const { FUN_ENTRY(GL_LOG_TRACE); return mVkImageView; }
+    inline uint64_t                   GetId(void)                         const { FUN_ENTRY(GL_LOG_TRACE); return mId; }
 
 // Set Functions
     inline void                       SetContext(const vkContext_t *vkContext)  { FUN_ENTRY(GL_LOG_TRACE); mVkContext = vkContext; }
+    inline void                       SetComponentMapping(const VkComponentMapping &mapping) { FUN_ENTRY(GL_LOG_TRACE); mVkComponentMapping = mapping; }
 };
 
 }
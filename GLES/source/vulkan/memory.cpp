@@ -29,13 +29,20 @@
  */
 
 #include "memory.h"
+#include <algorithm>
+#ifdef GLOVE_VK_DMA_BUF_IMPORT
+#include <unistd.h>
+#endif // GLOVE_VK_DMA_BUF_IMPORT
 
 namespace vulkanAPI {
 
-Memory::Memory(const vkContext_t *vkContext, VkFlags flags)
-: mVkContext(vkContext), mVkMemory (VK_NULL_HANDLE), mVkMemoryFlags(0), mVkFlags(flags)
+Memory::Memory(const vkContext_t *vkContext, VkFlags flags, VkFlags preferredFlags)
+: mVkContext(vkContext), mVkMemory (VK_NULL_HANDLE), mVkMemoryFlags(0), mVkFlags(flags), mVkPreferredFlags(preferredFlags),
+  mVkPropertyFlags(0), mCategory(MemoryAllocator::CATEGORY_BUFFER), mIsImage(false), mAlias(MemoryAllocator::ALIAS_NONE), mMappedData(nullptr), mImported(false)
 {
     FUN_ENTRY(GL_LOG_TRACE);
+
+    memset(static_cast<void *>(&mAllocation), 0, sizeof(mAllocation));
 }
 
 Memory::~Memory()
@@ -50,9 +57,18 @@ Memory::Release(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(mVkMemory != VK_NULL_HANDLE) {
+    if(mImported) {
         vkFreeMemory(mVkContext->vkDevice, mVkMemory, nullptr);
+        memset(static_cast<void *>(&mAllocation), 0, sizeof(mAllocation));
         mVkMemory = VK_NULL_HANDLE;
+        mImported = false;
+        return;
+    }
+
+    if(mVkMemory != VK_NULL_HANDLE && mVkContext->vkMemoryAllocator) {
+        mVkContext->vkMemoryAllocator->Free(&mAllocation);
+        mVkMemory   = VK_NULL_HANDLE;
+        mMappedData = nullptr;
     }
 }
 
@@ -61,8 +77,14 @@ Memory::GetData(VkDeviceSize size, VkDeviceSize offset, void *data) const
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    if(mMappedData) {
+        InvalidateMappedRange(size, offset);
+        memcpy(data, static_cast<const uint8_t *>(mMappedData) + offset, size);
+        return true;
+    }
+
     void *pData;
-    VkResult err = vkMapMemory(mVkContext->vkDevice, mVkMemory, offset, size, mVkMemoryFlags, &pData);
+    VkResult err = vkMapMemory(mVkContext->vkDevice, mVkMemory, mAllocation.offset + offset, size, mVkMemoryFlags, &pData);
     assert(!err);
 
     if(err != VK_ERROR_OUT_OF_HOST_MEMORY && err != VK_ERROR_OUT_OF_DEVICE_MEMORY && err != VK_ERROR_MEMORY_MAP_FAILED)
@@ -75,6 +97,83 @@ Memory::GetData(VkDeviceSize size, VkDeviceSize offset, void *data) const
     return false;
 }
 
+void *
+Memory::Map(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(mMappedData) {
+        return mMappedData;
+    }
+
+    void *pData = nullptr;
+    VkResult err = vkMapMemory(mVkContext->vkDevice, mVkMemory, mAllocation.offset, mAllocation.size, mVkMemoryFlags, &pData);
+    assert(!err);
+
+    return err == VK_SUCCESS ? pData : nullptr;
+}
+
+void
+Memory::Unmap(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // a persistent mapping is only dropped when the memory is released
+    if(mMappedData) {
+        return;
+    }
+
+    vkUnmapMemory(mVkContext->vkDevice, mVkMemory);
+}
+
+void
+Memory::InvalidateMappedRange(VkDeviceSize size, VkDeviceSize offset) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(IsHostCoherent()) {
+        return;
+    }
+
+    // device writes to non-coherent memory only become visible to the host once invalidated,
+    // over the range widened to nonCoherentAtomSize within the block
+    VkDeviceSize atomSize = std::max(mVkContext->vkDeviceLimits.nonCoherentAtomSize, static_cast<VkDeviceSize>(1));
+    VkDeviceSize begin    = (mAllocation.offset + offset) / atomSize * atomSize;
+    VkDeviceSize end      = std::min((mAllocation.offset + offset + size + atomSize - 1) / atomSize * atomSize, mAllocation.memorySize);
+
+    VkMappedMemoryRange range;
+    range.sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+    range.pNext  = nullptr;
+    range.memory = mVkMemory;
+    range.offset = begin;
+    range.size   = end - begin;
+
+    vkInvalidateMappedMemoryRanges(mVkContext->vkDevice, 1, &range);
+}
+
+void
+Memory::FlushMappedRange(VkDeviceSize size, VkDeviceSize offset) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(IsHostCoherent()) {
+        return;
+    }
+
+    VkDeviceSize atomSize = std::max(mVkContext->vkDeviceLimits.nonCoherentAtomSize, static_cast<VkDeviceSize>(1));
+    VkDeviceSize begin    = (mAllocation.offset + offset) / atomSize * atomSize;
+    VkDeviceSize end      = std::min((mAllocation.offset + offset + size + atomSize - 1) / atomSize * atomSize, mAllocation.memorySize);
+
+    VkMappedMemoryRange range;
+    range.sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+    range.pNext  = nullptr;
+    range.memory = mVkMemory;
+    range.offset = begin;
+    range.size   = end - begin;
+
+    vkFlushMappedMemoryRanges(mVkContext->vkDevice, 1, &range);
+}
+
 void
 Memory::UpdateData(VkDeviceSize size, VkDeviceSize offset, const void *data)
 {
@@ -88,6 +187,17 @@ Memory::SetData(VkDeviceSize size, VkDeviceSize offset, const void *data)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    if(mMappedData) {
+        uint8_t *pData = static_cast<uint8_t *>(mMappedData) + offset;
+        if(data) {
+            memcpy(pData, data, size);
+        } else {
+            memset(pData, 0x0, size);
+        }
+        FlushMappedRange(size, offset);
+        return true;
+    }
+
     void *pData = nullptr;
 
     VkResult err = vkMapMemory(mVkContext->vkDevice, mVkMemory, offset, size ? size : mVkRequirements.size, mVkMemoryFlags, &pData);
@@ -109,6 +219,7 @@ Memory::GetBufferMemoryRequirements(VkBuffer &buffer)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    mIsImage = false;
     memset(static_cast<void *>(&mVkRequirements), 0, sizeof(mVkRequirements));
     vkGetBufferMemoryRequirements(mVkContext->vkDevice, buffer, &mVkRequirements);
 
@@ -120,12 +231,13 @@ Memory::GetImageMemoryRequirements(VkImage &image)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    mIsImage = true;
     memset(static_cast<void *>(&mVkRequirements), 0, sizeof(mVkRequirements));
     vkGetImageMemoryRequirements(mVkContext->vkDevice, image, &mVkRequirements);
 }
 
 VkResult
-Memory::GetMemoryTypeIndexFromProperties(uint32_t *typeIndex)
+Memory::GetMemoryTypeIndexFromProperties(VkFlags flags, uint32_t *typeIndex) const
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
@@ -135,7 +247,7 @@ Memory::GetMemoryTypeIndexFromProperties(uint32_t *typeIndex)
     for(uint32_t i = 0; i < mVkContext->vkDeviceMemoryProperties.memoryTypeCount; i++) {
         if((typeBitsShift & 1) == 1) {
             // Type is available, does it match user properties?
-            if ((mVkContext->vkDeviceMemoryProperties.memoryTypes[i].propertyFlags & mVkFlags) == mVkFlags) {
+            if ((mVkContext->vkDeviceMemoryProperties.memoryTypes[i].propertyFlags & flags) == flags) {
                 *typeIndex = i;
                 return VK_SUCCESS;
             }
@@ -143,22 +255,31 @@ Memory::GetMemoryTypeIndexFromProperties(uint32_t *typeIndex)
         typeBitsShift >>= 1;
     }
 
-    typeBitsShift = mVkRequirements.memoryTypeBits;
+    return VK_ERROR_FORMAT_NOT_SUPPORTED;
+}
+
+VkResult
+Memory::GetMemoryTypeIndexFromProperties(uint32_t *typeIndex)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
 
-    // Retry with properties = 0x0
-    for(uint32_t i = 0; i < mVkContext->vkDeviceMemoryProperties.memoryTypeCount; i++) {
-        if((typeBitsShift & 1) == 1) {
-            // Type is available, does it match user properties?
-            if ((mVkContext->vkDeviceMemoryProperties.memoryTypes[i].propertyFlags & 0) == 0) {
-                *typeIndex = i;
-                return VK_SUCCESS;
-            }
+    // the preferred properties are dropped one step at a time, coherency
+    // first, before settling for the required ones and finally for any type
+    if(mVkPreferredFlags) {
+        if(GetMemoryTypeIndexFromProperties(mVkFlags | mVkPreferredFlags, typeIndex) == VK_SUCCESS) {
+            return VK_SUCCESS;
         }
-        typeBitsShift >>= 1;
+        if(GetMemoryTypeIndexFromProperties(mVkFlags | (mVkPreferredFlags & ~VK_MEMORY_PROPERTY_HOST_COHERENT_BIT), typeIndex) == VK_SUCCESS) {
+            return VK_SUCCESS;
+        }
+    }
+
+    if(GetMemoryTypeIndexFromProperties(mVkFlags, typeIndex) == VK_SUCCESS) {
+        return VK_SUCCESS;
     }
 
-     // No memory types matched, return failure
-     return VK_ERROR_FORMAT_NOT_SUPPORTED;
+    // Retry with properties = 0x0
+    return GetMemoryTypeIndexFromProperties(0, typeIndex);
 }
 
 bool
@@ -166,7 +287,7 @@ Memory::BindBufferMemory(VkBuffer &buffer)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    VkResult err = vkBindBufferMemory(mVkContext->vkDevice, buffer, mVkMemory, 0);
+    VkResult err = vkBindBufferMemory(mVkContext->vkDevice, buffer, mVkMemory, mAllocation.offset);
     assert(!err);
 
     return (err != VK_ERROR_OUT_OF_HOST_MEMORY && err != VK_ERROR_OUT_OF_DEVICE_MEMORY);
@@ -177,7 +298,7 @@ Memory::BindImageMemory(VkImage &image)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    VkResult err = vkBindImageMemory(mVkContext->vkDevice, image, mVkMemory, 0);
+    VkResult err = vkBindImageMemory(mVkContext->vkDevice, image, mVkMemory, mAllocation.offset);
     assert(!err);
 
     return (err != VK_ERROR_OUT_OF_HOST_MEMORY && err != VK_ERROR_OUT_OF_DEVICE_MEMORY);
@@ -188,19 +309,103 @@ Memory::Create()
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    uint32_t memoryTypeIndex = 0;
+    if(GetMemoryTypeIndexFromProperties(&memoryTypeIndex) != VK_SUCCESS) {
+        mVkMemory = VK_NULL_HANDLE;
+        return false;
+    }
+
+    // the resource is placed in a block shared with others of its memory type,
+    // transient attachments in the memory of the ones of other render passes
+    bool allocated = mIsImage && mAlias != MemoryAllocator::ALIAS_NONE ?
+                     mVkContext->vkMemoryAllocator->AllocateAliased(&mVkRequirements, memoryTypeIndex, mAlias, mCategory, &mAllocation) :
+                     mVkContext->vkMemoryAllocator->Allocate(&mVkRequirements, memoryTypeIndex, mIsImage, mCategory, &mAllocation);
+    if(!allocated) {
+        mVkMemory = VK_NULL_HANDLE;
+        return false;
+    }
+
+    mVkMemory        = mAllocation.memory;
+    mVkPropertyFlags = mVkContext->vkDeviceMemoryProperties.memoryTypes[memoryTypeIndex].propertyFlags;
+
+    // host visible blocks stay mapped for as long as they live, so that reads and
+    // writes of the contents do not map and unmap the memory every time
+    mMappedData      = mAllocation.mappedData;
+
+    return true;
+}
+
+bool
+Memory::ImportDmaBuf(int fd, VkImage &image)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+#ifdef GLOVE_VK_DMA_BUF_IMPORT
+    VkMemoryFdPropertiesKHR fdProperties;
+    fdProperties.sType = VK_STRUCTURE_TYPE_MEMORY_FD_PROPERTIES_KHR;
+    fdProperties.pNext = nullptr;
+    if(mVkContext->fpGetMemoryFdProperties(mVkContext->vkDevice, VK_EXTERNAL_MEMORY_HANDLE_TYPE_DMA_BUF_BIT_EXT, fd, &fdProperties) != VK_SUCCESS) {
+        return false;
+    }
+
+    vkGetImageMemoryRequirements(mVkContext->vkDevice, image, &mVkRequirements);
+
+    const uint32_t memoryTypeBits = mVkRequirements.memoryTypeBits & fdProperties.memoryTypeBits;
+    if(!memoryTypeBits) {
+        return false;
+    }
+
+    uint32_t memoryTypeIndex = 0;
+    while(!(memoryTypeBits & (1u << memoryTypeIndex))) {
+        ++memoryTypeIndex;
+    }
+
+    // a successful import takes over the descriptor, so the caller's one is duplicated
+    int importFd = dup(fd);
+    if(importFd < 0) {
+        return false;
+    }
+
+    VkMemoryDedicatedAllocateInfoKHR dedicatedInfo;
+    dedicatedInfo.sType  = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO_KHR;
+    dedicatedInfo.pNext  = nullptr;
+    dedicatedInfo.image  = image;
+    dedicatedInfo.buffer = VK_NULL_HANDLE;
+
+    VkImportMemoryFdInfoKHR importInfo;
+    importInfo.sType      = VK_STRUCTURE_TYPE_IMPORT_MEMORY_FD_INFO_KHR;
+    importInfo.pNext      = &dedicatedInfo;
+    importInfo.handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_DMA_BUF_BIT_EXT;
+    importInfo.fd         = importFd;
+
     VkMemoryAllocateInfo allocInfo;
     allocInfo.sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.pNext           = nullptr;
-    allocInfo.memoryTypeIndex = 0;
+    allocInfo.pNext           = &importInfo;
     allocInfo.allocationSize  = mVkRequirements.size;
+    allocInfo.memoryTypeIndex = memoryTypeIndex;
 
-    VkResult err;
-    err = GetMemoryTypeIndexFromProperties(&allocInfo.memoryTypeIndex);
-    assert(!err);
-    err = vkAllocateMemory(mVkContext->vkDevice, &allocInfo, nullptr, &mVkMemory);
-    assert(!err);
+    if(vkAllocateMemory(mVkContext->vkDevice, &allocInfo, nullptr, &mVkMemory) != VK_SUCCESS) {
+        close(importFd);
+        mVkMemory = VK_NULL_HANDLE;
+        return false;
+    }
 
-    return (err != VK_ERROR_OUT_OF_HOST_MEMORY && err != VK_ERROR_OUT_OF_DEVICE_MEMORY);
+    mImported                   = true;
+    mIsImage                    = true;
+    mVkPropertyFlags            = mVkContext->vkDeviceMemoryProperties.memoryTypes[memoryTypeIndex].propertyFlags;
+    mAllocation.memory          = mVkMemory;
+    mAllocation.offset          = 0;
+    mAllocation.size            = mVkRequirements.size;
+    mAllocation.memorySize      = mVkRequirements.size;
+    mAllocation.memoryTypeIndex = memoryTypeIndex;
+
+    return BindImageMemory(image);
+#else
+    (void)fd;
+    (void)image;
+
+    return false;
+#endif // GLOVE_VK_DMA_BUF_IMPORT
 }
 
 }
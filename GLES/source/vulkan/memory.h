@@ -27,10 +27,12 @@
 #include <cmath>
 #include "utils.h"
 #include "context.h"
+#include "memoryAllocator.h"
+#include "utils/objectPool.h"
 
 namespace vulkanAPI {
 
-class Memory {
+class Memory : public PooledObject {
 
 private:
 
@@ -41,17 +43,31 @@ private:
     const
     VkMemoryMapFlags                  mVkMemoryFlags;
     VkFlags                           mVkFlags;
+    /// properties chosen over the required ones when a memory type has them, e.g. host cached for readbacks
+    VkFlags                           mVkPreferredFlags;
+    VkMemoryPropertyFlags             mVkPropertyFlags;
     VkMemoryRequirements              mVkRequirements;
+    /// range of a device memory block the resource is bound to
+    MemoryAllocator::allocation_t     mAllocation;
+    MemoryAllocator::category_t       mCategory;
+    bool                              mIsImage;
+    MemoryAllocator::alias_t          mAlias;
+    /// host visible memory is mapped once, when allocated, and stays mapped until released
+    void *                            mMappedData;
+    /// dedicated memory imported from outside, freed on its own rather than through the allocator
+    bool                              mImported;
 
 public:
 // Constructor
-    Memory(const vkContext_t *vkContext = nullptr, VkFlags flags = 0);
+    Memory(const vkContext_t *vkContext = nullptr, VkFlags flags = 0, VkFlags preferredFlags = 0);
 
 // Destructor
     ~Memory();
 
 // Allocate Functions
     bool                              Create(void);
+    /// imports the dma-buf behind fd for image, the descriptor stays owned by the caller
+    bool                              ImportDmaBuf(int fd, VkImage &image);
 
 // Release Functions
     void                              Release(void);
@@ -65,12 +81,30 @@ public:
     bool                              GetBufferMemoryRequirements(VkBuffer &buffer);
     bool                              GetData(VkDeviceSize size, VkDeviceSize offset, void *data) const;
     VkResult                          GetMemoryTypeIndexFromProperties(uint32_t *typeIndex);
+    VkResult                          GetMemoryTypeIndexFromProperties(VkFlags flags, uint32_t *typeIndex) const;
+
+// Map Functions
+    void *                            Map(void);
+    void                              Unmap(void);
+    void                              InvalidateMappedRange(VkDeviceSize size, VkDeviceSize offset) const;
+    void                              FlushMappedRange(VkDeviceSize size, VkDeviceSize offset)      const;
 
 // Set/Update Functions
     bool                              SetData(VkDeviceSize size, VkDeviceSize offset, const void *data);
     void                              UpdateData(VkDeviceSize size, VkDeviceSize offset, const void *data);
 
     inline void                       SetContext(const vkContext_t *vkContext)  { FUN_ENTRY(GL_LOG_TRACE); mVkContext = vkContext; }
+    inline void                       SetFlags(VkFlags flags)                   { FUN_ENTRY(GL_LOG_TRACE); mVkFlags   = flags; }
+    inline VkFlags                    GetFlags(void)                      const { FUN_ENTRY(GL_LOG_TRACE); return mVkFlags; }
+    inline void                       SetPreferredFlags(VkFlags flags)          { FUN_ENTRY(GL_LOG_TRACE); mVkPreferredFlags = flags; }
+    inline VkFlags                    GetPreferredFlags(void)             const { FUN_ENTRY(GL_LOG_TRACE); return mVkPreferredFlags; }
+    inline void                       SetCategory(MemoryAllocator::category_t category) { FUN_ENTRY(GL_LOG_TRACE); mCategory = category; }
+    inline void                       SetAlias(MemoryAllocator::alias_t alias)  { FUN_ENTRY(GL_LOG_TRACE); mAlias = alias; }
+
+// Is Functions
+    inline bool                       IsPersistentlyMapped(void)          const { FUN_ENTRY(GL_LOG_TRACE); return mMappedData != nullptr; }
+    inline bool                       IsImported(void)                    const { FUN_ENTRY(GL_LOG_TRACE); return mImported; }
+    inline bool                       IsHostCoherent(void)                const { FUN_ENTRY(GL_LOG_TRACE); return mVkPropertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT; }
 };
 
 }
@@ -0,0 +1,589 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       memoryAllocator.cpp
+ *  @author     Think Silicon
+ *  @date       14/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Sub-allocation of Vulkan device memory blocks
+ *
+ *  @section
+ *
+ *  Drivers limit the number of live device memory allocations and each
+ *  vkAllocateMemory call is expensive, so buffers and images are placed in
+ *  large blocks allocated per memory type. A block keeps its free ranges
+ *  ordered by offset; a request takes the smallest range it fits in at its
+ *  alignment, and a freed range is merged with its free neighbours. Host
+ *  visible blocks are mapped once, for as long as they live. Images are kept
+ *  apart from buffers and rounded up to bufferImageGranularity, so that linear
+ *  and optimal resources never alias the same page. Requests larger than
+ *  half a block get a dedicated allocation.
+ *
+ *  The multisampled attachments of the FBOs are transient, they are neither
+ *  loaded nor stored by the render passes that use them, so their contents
+ *  live for a single pass. Since the passes are ordered by their external
+ *  subpass dependencies on the attachment writes, the transient attachments
+ *  of one kind are bound at the start of a shared memory instead of holding
+ *  memory each, and a chain of multisampled FBOs costs the largest of them.
+ *
+ *  The bytes handed out are accounted per category and the bytes of device
+ *  memory held per heap, together with their peaks since the last reset. The budget of a heap comes from VK_EXT_memory_budget
+ *  where supported, and is its size otherwise; once the usage gets close to
+ *  it, the context trims its caches and the empty blocks still kept around.
+ *
+ */
+
+#include "memoryAllocator.h"
+#include <algorithm>
+#include <iterator>
+#include <cstring>
+
+namespace vulkanAPI {
+
+MemoryAllocator::MemoryAllocator(const vkContext_t *vkContext)
+: mVkContext(vkContext), mEvictionCount(0), mEvictedSize(0)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    memset(static_cast<void *>(mCategoryUsage), 0, sizeof(mCategoryUsage));
+    memset(static_cast<void *>(mCategoryPeak),  0, sizeof(mCategoryPeak));
+    memset(static_cast<void *>(mHeapUsage), 0, sizeof(mHeapUsage));
+    memset(static_cast<void *>(mHeapPeak),  0, sizeof(mHeapPeak));
+}
+
+MemoryAllocator::~MemoryAllocator()
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    for(auto &pool : mPools) {
+        for(auto block : pool) {
+            FreeVkMemory(block->memory, block->mappedData);
+            delete block;
+        }
+        pool.clear();
+    }
+
+    for(auto block : mAliasBlocks) {
+        FreeVkMemory(block->memory, nullptr);
+        delete block;
+    }
+    mAliasBlocks.clear();
+}
+
+bool
+MemoryAllocator::AllocateVkMemory(uint32_t memoryTypeIndex, VkDeviceSize size, VkDeviceMemory *memory, void **mappedData)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    VkMemoryAllocateInfo allocInfo;
+    allocInfo.sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.pNext           = nullptr;
+    allocInfo.memoryTypeIndex = memoryTypeIndex;
+    allocInfo.allocationSize  = size;
+
+    VkResult err = vkAllocateMemory(mVkContext->vkDevice, &allocInfo, nullptr, memory);
+    if(err != VK_SUCCESS) {
+        *memory = VK_NULL_HANDLE;
+        return false;
+    }
+
+    *mappedData = nullptr;
+    if(mVkContext->vkDeviceMemoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        if(vkMapMemory(mVkContext->vkDevice, *memory, 0, VK_WHOLE_SIZE, 0, mappedData) != VK_SUCCESS) {
+            *mappedData = nullptr;
+        }
+    }
+
+    return true;
+}
+
+void
+MemoryAllocator::FreeVkMemory(VkDeviceMemory memory, void *mappedData)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(mappedData) {
+        vkUnmapMemory(mVkContext->vkDevice, memory);
+    }
+    vkFreeMemory(mVkContext->vkDevice, memory, nullptr);
+}
+
+VkDeviceSize
+MemoryAllocator::GetBlockSize(uint32_t memoryTypeIndex) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // small heaps, e.g. host visible device local windows, are not claimed by a few blocks
+    VkDeviceSize size = GLOVE_VK_MEMORY_BLOCK_SIZE;
+    const VkMemoryHeap &heap = mVkContext->vkDeviceMemoryProperties.memoryHeaps[mVkContext->vkDeviceMemoryProperties.memoryTypes[memoryTypeIndex].heapIndex];
+    if(heap.size && heap.size / 8 < size) {
+        size = heap.size / 8;
+    }
+
+    return size;
+}
+
+MemoryAllocator::block_t *
+MemoryAllocator::CreateBlock(uint32_t memoryTypeIndex, uint32_t pool)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    VkDeviceSize size = GetBlockSize(memoryTypeIndex);
+
+    block_t *block = new block_t;
+    if(!AllocateVkMemory(memoryTypeIndex, size, &block->memory, &block->mappedData)) {
+        delete block;
+        return nullptr;
+    }
+
+    block->size     = size;
+    block->usedSize = 0;
+    block->pool     = pool;
+    block->freeRanges[0] = size;
+
+    AddHeapUsage(memoryTypeIndex, size);
+
+    mPools[pool].push_back(block);
+
+    return block;
+}
+
+void
+MemoryAllocator::AddCategoryUsage(category_t category, VkDeviceSize size)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    mCategoryUsage[category] += size;
+    mCategoryPeak[category]   = std::max(mCategoryPeak[category], mCategoryUsage[category]);
+}
+
+void
+MemoryAllocator::AddHeapUsage(uint32_t memoryTypeIndex, VkDeviceSize size)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    uint32_t heapIndex = mVkContext->vkDeviceMemoryProperties.memoryTypes[memoryTypeIndex].heapIndex;
+    mHeapUsage[heapIndex] += size;
+    mHeapPeak[heapIndex]   = std::max(mHeapPeak[heapIndex], mHeapUsage[heapIndex]);
+}
+
+bool
+MemoryAllocator::SubAllocate(block_t *block, VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize *offset)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    auto best = block->freeRanges.end();
+    VkDeviceSize bestAligned = 0;
+    for(auto it = block->freeRanges.begin(); it != block->freeRanges.end(); ++it) {
+        VkDeviceSize aligned = (it->first + alignment - 1) / alignment * alignment;
+        if(aligned + size > it->first + it->second) {
+            continue;
+        }
+        if(best == block->freeRanges.end() || it->second < best->second) {
+            best        = it;
+            bestAligned = aligned;
+        }
+    }
+
+    if(best == block->freeRanges.end()) {
+        return false;
+    }
+
+    // the padding in front of the aligned offset and the tail stay free
+    VkDeviceSize rangeOffset = best->first;
+    VkDeviceSize rangeEnd    = best->first + best->second;
+    block->freeRanges.erase(best);
+    if(bestAligned > rangeOffset) {
+        block->freeRanges[rangeOffset] = bestAligned - rangeOffset;
+    }
+    if(bestAligned + size < rangeEnd) {
+        block->freeRanges[bestAligned + size] = rangeEnd - (bestAligned + size);
+    }
+
+    block->usedSize += size;
+    *offset = bestAligned;
+
+    return true;
+}
+
+bool
+MemoryAllocator::Allocate(const VkMemoryRequirements *requirements, uint32_t memoryTypeIndex, bool isImage, category_t category, allocation_t *allocation)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    VkDeviceSize size      = std::max(requirements->size, static_cast<VkDeviceSize>(1));
+    VkDeviceSize alignment = std::max(requirements->alignment, static_cast<VkDeviceSize>(1));
+    if(isImage) {
+        VkDeviceSize granularity = std::max(mVkContext->vkDeviceLimits.bufferImageGranularity, static_cast<VkDeviceSize>(1));
+        alignment = std::max(alignment, granularity);
+        size      = (size + granularity - 1) / granularity * granularity;
+    }
+
+    // lazily allocated memory is only committed by the device per attachment,
+    // so a shared block would defeat it
+    bool isLazy = mVkContext->vkDeviceMemoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+    if(isLazy || size > GetBlockSize(memoryTypeIndex) / 2) {
+        if(!AllocateVkMemory(memoryTypeIndex, requirements->size, &allocation->memory, &allocation->mappedData)) {
+            return false;
+        }
+        allocation->offset          = 0;
+        allocation->size            = requirements->size;
+        allocation->memorySize      = requirements->size;
+        allocation->block           = nullptr;
+        allocation->memoryTypeIndex = memoryTypeIndex;
+        allocation->category        = category;
+        allocation->aliased         = false;
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        AddCategoryUsage(category, allocation->size);
+        AddHeapUsage(memoryTypeIndex, allocation->size);
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    uint32_t pool = memoryTypeIndex * POOL_COUNT + (isImage ? POOL_IMAGE : POOL_LINEAR);
+
+    block_t *block = nullptr;
+    VkDeviceSize offset = 0;
+    for(auto candidate : mPools[pool]) {
+        if(candidate->size - candidate->usedSize >= size && SubAllocate(candidate, size, alignment, &offset)) {
+            block = candidate;
+            break;
+        }
+    }
+
+    if(!block) {
+        block = CreateBlock(memoryTypeIndex, pool);
+        if(!block || !SubAllocate(block, size, alignment, &offset)) {
+            return false;
+        }
+    }
+
+    allocation->memory          = block->memory;
+    allocation->offset          = offset;
+    allocation->size            = size;
+    allocation->memorySize      = block->size;
+    allocation->mappedData      = block->mappedData ? static_cast<uint8_t *>(block->mappedData) + offset : nullptr;
+    allocation->block           = block;
+    allocation->memoryTypeIndex = memoryTypeIndex;
+    allocation->category        = category;
+    allocation->aliased         = false;
+
+    AddCategoryUsage(category, size);
+
+    return true;
+}
+
+bool
+MemoryAllocator::AllocateAliased(const VkMemoryRequirements *requirements, uint32_t memoryTypeIndex, alias_t alias, category_t category, allocation_t *allocation)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // lazily allocated memory is never committed for transient attachments anyway
+    bool isLazy = mVkContext->vkDeviceMemoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+    if(alias == ALIAS_NONE || isLazy) {
+        return Allocate(requirements, memoryTypeIndex, true, category, allocation);
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    // the largest memory the attachment fits in, so that the smaller ones are given back first
+    aliasBlock_t *block = nullptr;
+    for(auto candidate : mAliasBlocks) {
+        if(candidate->alias == alias && candidate->memoryTypeIndex == memoryTypeIndex && candidate->size >= requirements->size &&
+           (!block || candidate->size > block->size)) {
+            block = candidate;
+        }
+    }
+
+    if(!block) {
+        // images are bound at offset 0, which meets any alignment
+        void *mappedData = nullptr;
+        VkDeviceMemory memory;
+        if(!AllocateVkMemory(memoryTypeIndex, requirements->size, &memory, &mappedData)) {
+            return false;
+        }
+        if(mappedData) {
+            vkUnmapMemory(mVkContext->vkDevice, memory);
+        }
+
+        block = new aliasBlock_t;
+        block->memory          = memory;
+        block->size            = requirements->size;
+        block->memoryTypeIndex = memoryTypeIndex;
+        block->alias           = alias;
+        block->category        = category;
+        block->refCount        = 0;
+        mAliasBlocks.push_back(block);
+
+        AddCategoryUsage(category, block->size);
+        AddHeapUsage(memoryTypeIndex, block->size);
+    }
+    ++block->refCount;
+
+    allocation->memory          = block->memory;
+    allocation->offset          = 0;
+    allocation->size            = requirements->size;
+    allocation->memorySize      = block->size;
+    allocation->mappedData      = nullptr;
+    allocation->block           = block;
+    allocation->memoryTypeIndex = memoryTypeIndex;
+    allocation->category        = category;
+    allocation->aliased         = true;
+
+    return true;
+}
+
+void
+MemoryAllocator::FreeAliased(allocation_t *allocation)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    aliasBlock_t *block = static_cast<aliasBlock_t *>(allocation->block);
+    allocation->memory = VK_NULL_HANDLE;
+    allocation->block  = nullptr;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    // the memory is given back once no attachment is bound to it
+    if(--block->refCount) {
+        return;
+    }
+
+    const uint32_t heapIndex = mVkContext->vkDeviceMemoryProperties.memoryTypes[block->memoryTypeIndex].heapIndex;
+    mCategoryUsage[block->category] -= block->size;
+    mHeapUsage[heapIndex]           -= block->size;
+
+    mAliasBlocks.erase(std::find(mAliasBlocks.begin(), mAliasBlocks.end(), block));
+    FreeVkMemory(block->memory, nullptr);
+    delete block;
+}
+
+void
+MemoryAllocator::Free(allocation_t *allocation)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(allocation->memory == VK_NULL_HANDLE) {
+        return;
+    }
+
+    if(allocation->aliased) {
+        FreeAliased(allocation);
+        return;
+    }
+
+    const uint32_t heapIndex = mVkContext->vkDeviceMemoryProperties.memoryTypes[allocation->memoryTypeIndex].heapIndex;
+
+    if(!allocation->block) {
+        FreeVkMemory(allocation->memory, allocation->mappedData);
+        allocation->memory = VK_NULL_HANDLE;
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        mCategoryUsage[allocation->category] -= allocation->size;
+        mHeapUsage[heapIndex]                -= allocation->size;
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    mCategoryUsage[allocation->category] -= allocation->size;
+
+    block_t *block = static_cast<block_t *>(allocation->block);
+    VkDeviceSize offset = allocation->offset;
+    VkDeviceSize size   = allocation->size;
+
+    // merge the range with the free ranges right before and after it
+    auto next = block->freeRanges.lower_bound(offset);
+    if(next != block->freeRanges.begin()) {
+        auto prev = std::prev(next);
+        if(prev->first + prev->second == offset) {
+            offset  = prev->first;
+            size   += prev->second;
+            block->freeRanges.erase(prev);
+        }
+    }
+    if(next != block->freeRanges.end() && next->first == allocation->offset + allocation->size) {
+        size += next->second;
+        block->freeRanges.erase(next);
+    }
+    block->freeRanges[offset] = size;
+    block->usedSize -= allocation->size;
+
+    // an empty block is given back to the driver, unless it is the last one of its pool
+    std::vector<block_t *> &pool = mPools[block->pool];
+    if(!block->usedSize && pool.size() > 1) {
+        pool.erase(std::find(pool.begin(), pool.end(), block));
+        mHeapUsage[heapIndex] -= block->size;
+        FreeVkMemory(block->memory, block->mappedData);
+        delete block;
+    }
+
+    allocation->memory = VK_NULL_HANDLE;
+    allocation->block  = nullptr;
+}
+
+VkDeviceSize
+MemoryAllocator::Trim(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    // the empty block kept for the next allocation of each pool is given back as well
+    VkDeviceSize freedSize = 0;
+    for(uint32_t i = 0; i < VK_MAX_MEMORY_TYPES * POOL_COUNT; ++i) {
+        std::vector<block_t *> &pool = mPools[i];
+        const uint32_t heapIndex = mVkContext->vkDeviceMemoryProperties.memoryTypes[i / POOL_COUNT].heapIndex;
+        for(auto it = pool.begin(); it != pool.end();) {
+            block_t *block = *it;
+            if(block->usedSize) {
+                ++it;
+                continue;
+            }
+            freedSize             += block->size;
+            mHeapUsage[heapIndex] -= block->size;
+            FreeVkMemory(block->memory, block->mappedData);
+            delete block;
+            it = pool.erase(it);
+        }
+    }
+
+    ++mEvictionCount;
+    mEvictedSize += freedSize;
+
+    return freedSize;
+}
+
+VkDeviceSize
+MemoryAllocator::GetCategoryUsage(category_t category) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mCategoryUsage[category];
+}
+
+VkDeviceSize
+MemoryAllocator::GetCategoryPeak(category_t category) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mCategoryPeak[category];
+}
+
+void
+MemoryAllocator::GetHeapUsage(uint32_t heapIndex, VkDeviceSize *usage, VkDeviceSize *peak) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    *usage = mHeapUsage[heapIndex];
+    *peak  = mHeapPeak[heapIndex];
+}
+
+void
+MemoryAllocator::ResetPeaks(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the peaks start over from what is held at the moment
+    std::lock_guard<std::mutex> lock(mMutex);
+    memcpy(static_cast<void *>(mCategoryPeak), mCategoryUsage, sizeof(mCategoryPeak));
+    memcpy(static_cast<void *>(mHeapPeak),     mHeapUsage,     sizeof(mHeapPeak));
+}
+
+const char *
+MemoryAllocator::GetCategoryName(category_t category)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    static const char *categoryNames[CATEGORY_COUNT] = {
+        "buffer_other",
+        "buffer_vertex",
+        "buffer_index",
+        "buffer_uniform",
+        "buffer_stream",
+        "texture",
+        "render_target",
+        "staging"
+    };
+
+    return categoryNames[category];
+}
+
+VkDeviceSize
+MemoryAllocator::GetPipelineCacheSize(void) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // the device-wide pipeline cache lives in host memory owned by the driver
+    size_t size = 0;
+    if(mVkContext->vkPipelineCache == VK_NULL_HANDLE ||
+       vkGetPipelineCacheData(mVkContext->vkDevice, mVkContext->vkPipelineCache, &size, nullptr) != VK_SUCCESS) {
+        return 0;
+    }
+
+    return static_cast<VkDeviceSize>(size);
+}
+
+void
+MemoryAllocator::GetHeapBudget(uint32_t heapIndex, VkDeviceSize *usage, VkDeviceSize *budget) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+#ifdef VK_EXT_memory_budget
+    // the budget extension also reports what other processes use of the heap
+    if(mVkContext->mIsMemoryBudgetSupported) {
+        VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties;
+        memset(static_cast<void *>(&budgetProperties), 0, sizeof(budgetProperties));
+        budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+        VkPhysicalDeviceMemoryProperties2KHR memoryProperties;
+        memoryProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2_KHR;
+        memoryProperties.pNext = &budgetProperties;
+
+        mVkContext->fpGetPhysicalDeviceMemoryProperties2(mVkContext->vkGpus[0], &memoryProperties);
+
+        *usage  = budgetProperties.heapUsage[heapIndex];
+        *budget = budgetProperties.heapBudget[heapIndex];
+        return;
+    }
+#endif // VK_EXT_memory_budget
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    *usage  = mHeapUsage[heapIndex];
+    *budget = mVkContext->vkDeviceMemoryProperties.memoryHeaps[heapIndex].size;
+}
+
+bool
+MemoryAllocator::IsOverBudget(void) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    for(uint32_t i = 0; i < mVkContext->vkDeviceMemoryProperties.memoryHeapCount; ++i) {
+        VkDeviceSize usage, budget;
+        GetHeapBudget(i, &usage, &budget);
+        if(budget && usage * 100 >= budget * GLOVE_VK_MEMORY_BUDGET_TRIM_PERCENT) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+}
@@ -0,0 +1,169 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       memoryAllocator.h
+ *  @author     Think Silicon
+ *  @date       14/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Sub-allocation of Vulkan device memory blocks
+ *
+ */
+
+#ifndef __VKMEMORYALLOCATOR_H__
+#define __VKMEMORYALLOCATOR_H__
+
+#include <map>
+#include <mutex>
+#include <vector>
+#include "context.h"
+
+#ifndef GLOVE_VK_MEMORY_BLOCK_SIZE
+#define GLOVE_VK_MEMORY_BLOCK_SIZE                      (64 << 20)
+#endif // GLOVE_VK_MEMORY_BLOCK_SIZE
+
+/// share of a heap's budget past which the caches are trimmed
+#ifndef GLOVE_VK_MEMORY_BUDGET_TRIM_PERCENT
+#define GLOVE_VK_MEMORY_BUDGET_TRIM_PERCENT             90
+#endif // GLOVE_VK_MEMORY_BUDGET_TRIM_PERCENT
+
+namespace vulkanAPI {
+
+class MemoryAllocator {
+
+public:
+    /// what the memory is used for, as reported in the usage statistics
+    typedef enum {
+        /// buffers of any other target, e.g. the transfer destinations of glBufferData
+        CATEGORY_BUFFER = 0,
+        CATEGORY_VERTEX_BUFFER,
+        CATEGORY_INDEX_BUFFER,
+        CATEGORY_UNIFORM_BUFFER,
+        /// ring buffers of the per-frame uniform and client-side vertex data
+        CATEGORY_STREAM,
+        CATEGORY_TEXTURE,
+        CATEGORY_RENDER_TARGET,
+        CATEGORY_STAGING,
+        CATEGORY_COUNT
+    } category_t;
+
+    /// attachments that only live within a render pass, which share their memory with the ones of the same kind of any other pass
+    typedef enum {
+        ALIAS_NONE = 0,
+        ALIAS_COLOR,
+        ALIAS_DEPTH_STENCIL
+    } alias_t;
+
+    /// range of device memory handed out for a single buffer or image
+    typedef struct allocation_t {
+        VkDeviceMemory                  memory;
+        VkDeviceSize                    offset;
+        VkDeviceSize                    size;
+        /// size of the whole VkDeviceMemory the range lies in
+        VkDeviceSize                    memorySize;
+        /// host address of the range when its memory type is host visible
+        void                           *mappedData;
+        /// block the range was sub-allocated from, or nullptr for a dedicated allocation
+        void                           *block;
+        uint32_t                        memoryTypeIndex;
+        category_t                      category;
+        /// the range is aliased by the transient attachments of other render passes, block is their aliasBlock_t
+        bool                            aliased;
+    } allocation_t;
+
+private:
+    typedef struct block_t {
+        VkDeviceMemory                  memory;
+        VkDeviceSize                    size;
+        VkDeviceSize                    usedSize;
+        void                           *mappedData;
+        uint32_t                        pool;
+        /// free ranges of the block, size per offset, adjacent ranges are always merged
+        std::map<VkDeviceSize, VkDeviceSize> freeRanges;
+    } block_t;
+
+    /// memory of the transient attachments of one kind, bound at its start by all of them
+    typedef struct aliasBlock_t {
+        VkDeviceMemory                  memory;
+        VkDeviceSize                    size;
+        uint32_t                        memoryTypeIndex;
+        alias_t                         alias;
+        category_t                      category;
+        uint32_t                        refCount;
+    } aliasBlock_t;
+
+    /// buffers and optimal images never share a block, so that they never share a bufferImageGranularity page
+    enum {
+        POOL_LINEAR = 0,
+        POOL_IMAGE,
+        POOL_COUNT
+    };
+
+    const
+    vkContext_t *                     mVkContext;
+
+    mutable std::mutex                mMutex;
+    std::vector<block_t *>            mPools[VK_MAX_MEMORY_TYPES * POOL_COUNT];
+    std::vector<aliasBlock_t *>       mAliasBlocks;
+
+    /// bytes handed out per category, and bytes of VkDeviceMemory held per heap, with their peaks since the last reset
+    VkDeviceSize                      mCategoryUsage[CATEGORY_COUNT];
+    VkDeviceSize                      mCategoryPeak[CATEGORY_COUNT];
+    VkDeviceSize                      mHeapUsage[VK_MAX_MEMORY_HEAPS];
+    VkDeviceSize                      mHeapPeak[VK_MAX_MEMORY_HEAPS];
+    uint32_t                          mEvictionCount;
+    VkDeviceSize                      mEvictedSize;
+
+    VkDeviceSize                      GetBlockSize(uint32_t memoryTypeIndex) const;
+    bool                              AllocateVkMemory(uint32_t memoryTypeIndex, VkDeviceSize size, VkDeviceMemory *memory, void **mappedData);
+    void                              FreeVkMemory(VkDeviceMemory memory, void *mappedData);
+    block_t *                         CreateBlock(uint32_t memoryTypeIndex, uint32_t pool);
+    bool                              SubAllocate(block_t *block, VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize *offset);
+    void                              FreeAliased(allocation_t *allocation);
+    void                              AddCategoryUsage(category_t category, VkDeviceSize size);
+    void                              AddHeapUsage(uint32_t memoryTypeIndex, VkDeviceSize size);
+
+public:
+// Constructor
+    explicit MemoryAllocator(const vkContext_t *vkContext);
+
+// Destructor
+    ~MemoryAllocator();
+
+// Allocate Functions
+    bool                              Allocate(const VkMemoryRequirements *requirements, uint32_t memoryTypeIndex,
+                                               bool isImage, category_t category, allocation_t *allocation);
+    bool                              AllocateAliased(const VkMemoryRequirements *requirements, uint32_t memoryTypeIndex,
+                                                      alias_t alias, category_t category, allocation_t *allocation);
+
+// Release Functions
+    void                              Free(allocation_t *allocation);
+    VkDeviceSize                      Trim(void);
+    void                              ResetPeaks(void);
+
+// Get Functions
+    VkDeviceSize                      GetCategoryUsage(category_t category) const;
+    VkDeviceSize                      GetCategoryPeak(category_t category)  const;
+    void                              GetHeapUsage(uint32_t heapIndex, VkDeviceSize *usage, VkDeviceSize *peak) const;
+    static const char *               GetCategoryName(category_t category);
+    VkDeviceSize                      GetPipelineCacheSize(void)            const;
+    void                              GetHeapBudget(uint32_t heapIndex, VkDeviceSize *usage, VkDeviceSize *budget) const;
+    bool                              IsOverBudget(void)                    const;
+    inline uint32_t                   GetEvictionCount(void)                const { FUN_ENTRY(GL_LOG_TRACE); return mEvictionCount; }
+    inline VkDeviceSize               GetEvictedSize(void)                  const { FUN_ENTRY(GL_LOG_TRACE); return mEvictedSize; }
+};
+
+}
+
+#endif // __VKMEMORYALLOCATOR_H__
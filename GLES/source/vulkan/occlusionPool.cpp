@@ -0,0 +1,243 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       occlusionPool.cpp
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Occlusion queries recorded by the draw command buffers of each frame in flight
+ *
+ *  @section
+ *
+ *  As with the timestamps, each draw command buffer slot begins its
+ *  occlusion queries in a query pool of its own, which is reset when the
+ *  slot begins recording again. The submission of the slot has completed by
+ *  then, so the sample counts of its queries are kept until the GL queries
+ *  release them. Before that, they are read without blocking, with their
+ *  availability, once the submission carrying them completes.
+ *
+ */
+
+#include "occlusionPool.h"
+
+namespace vulkanAPI {
+
+OcclusionPool::OcclusionPool(const vkContext_t *vkContext)
+: mVkContext(vkContext), mNextTicket(0)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+}
+
+OcclusionPool::~OcclusionPool()
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    Release();
+}
+
+void
+OcclusionPool::Release(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    for(Slot &slot : mSlots) {
+        if(slot.pool != VK_NULL_HANDLE) {
+            vkDestroyQueryPool(mVkContext->vkDevice, slot.pool, nullptr);
+        }
+    }
+    mSlots.clear();
+    mPending.clear();
+    mResults.clear();
+}
+
+void
+OcclusionPool::Release(uint64_t ticket)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    mPending.erase(ticket);
+    mResults.erase(ticket);
+}
+
+bool
+OcclusionPool::Create(uint32_t slots)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    VkQueryPoolCreateInfo info;
+    info.sType              = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    info.pNext              = nullptr;
+    info.flags              = 0;
+    info.queryType          = VK_QUERY_TYPE_OCCLUSION;
+    info.queryCount         = GLOVE_MAX_OCCLUSION_QUERIES_PER_SLOT;
+    info.pipelineStatistics = 0;
+
+    mSlots.resize(slots);
+    for(Slot &slot : mSlots) {
+        slot.pool         = VK_NULL_HANDLE;
+        slot.used         = 0;
+        slot.generation   = 0;
+        slot.submissionId = 0;
+    }
+
+    for(Slot &slot : mSlots) {
+        VkResult err = vkCreateQueryPool(mVkContext->vkDevice, &info, nullptr, &slot.pool);
+        if(err != VK_SUCCESS) {
+            Release();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool
+OcclusionPool::ReadQueries(const Slot &slot, uint32_t first, uint32_t count, uint64_t *values)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // each sample count is followed by its availability
+    VkResult err = vkGetQueryPoolResults(mVkContext->vkDevice, slot.pool, first, count, count * 2 * sizeof(uint64_t), values,
+                                         2 * sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+    return err == VK_SUCCESS || err == VK_NOT_READY;
+}
+
+void
+OcclusionPool::ResolveSlot(uint32_t index)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    Slot &slot = mSlots[index];
+
+    std::vector<uint64_t> values(2 * slot.used, 0);
+    if(slot.submissionId == 0 || !slot.used || !ReadQueries(slot, 0, slot.used, values.data())) {
+        values.assign(2 * slot.used, 0);
+    }
+
+    // a GL query whose draws were never executed passed no samples
+    for(auto it = mPending.begin(); it != mPending.end();) {
+        if(it->second.slot == index && it->second.generation == slot.generation) {
+            mResults[it->first] = values[2 * it->second.query];
+            it = mPending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void
+OcclusionPool::Reset(VkCommandBuffer cmdBuffer, uint32_t index)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(index >= mSlots.size()) {
+        return;
+    }
+
+    ResolveSlot(index);
+
+    Slot &slot = mSlots[index];
+    mVkContext->vkDispatch.vkCmdResetQueryPool(cmdBuffer, slot.pool, 0, GLOVE_MAX_OCCLUSION_QUERIES_PER_SLOT);
+    slot.used         = 0;
+    slot.submissionId = 0;
+    ++slot.generation;
+}
+
+uint64_t
+OcclusionPool::Begin(VkCommandBuffer cmdBuffer, uint32_t index)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(index >= mSlots.size() || mSlots[index].used >= GLOVE_MAX_OCCLUSION_QUERIES_PER_SLOT) {
+        return 0;
+    }
+
+    // the GL queries only tell whether any sample passed, which the imprecise queries are enough for
+    Slot &slot = mSlots[index];
+    mVkContext->vkDispatch.vkCmdBeginQuery(cmdBuffer, slot.pool, slot.used, 0);
+
+    Location location = { index, slot.used++, slot.generation };
+    mPending[++mNextTicket] = location;
+
+    return mNextTicket;
+}
+
+void
+OcclusionPool::End(VkCommandBuffer cmdBuffer, uint64_t ticket)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    auto pending = mPending.find(ticket);
+    if(pending == mPending.end()) {
+        return;
+    }
+
+    mVkContext->vkDispatch.vkCmdEndQuery(cmdBuffer, mSlots[pending->second.slot].pool, pending->second.query);
+}
+
+void
+OcclusionPool::SetSubmitted(uint32_t index, uint64_t submissionId)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(index < mSlots.size() && mSlots[index].used && !mSlots[index].submissionId) {
+        mSlots[index].submissionId = submissionId;
+    }
+}
+
+bool
+OcclusionPool::GetResult(uint64_t ticket, uint64_t *samples)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    auto result = mResults.find(ticket);
+    if(result != mResults.end()) {
+        *samples = result->second;
+        return true;
+    }
+
+    auto pending = mPending.find(ticket);
+    if(pending == mPending.end()) {
+        return false;
+    }
+
+    const Slot &slot = mSlots[pending->second.slot];
+    uint64_t value[2] = { 0, 0 };
+    if(slot.generation != pending->second.generation || !slot.submissionId ||
+       !ReadQueries(slot, pending->second.query, 1, value) || !value[1]) {
+        return false;
+    }
+
+    mResults[ticket] = value[0];
+    mPending.erase(pending);
+    *samples = value[0];
+
+    return true;
+}
+
+uint64_t
+OcclusionPool::GetSubmissionId(uint64_t ticket) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    auto pending = mPending.find(ticket);
+    if(pending == mPending.end()) {
+        return UINT64_MAX;
+    }
+
+    return mSlots[pending->second.slot].submissionId;
+}
+
+}
@@ -0,0 +1,102 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       occlusionPool.h
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Occlusion queries recorded by the draw command buffers of each frame in flight
+ *
+ */
+
+#ifndef __VKOCCLUSIONPOOL_H__
+#define __VKOCCLUSIONPOOL_H__
+
+#include "context.h"
+#include <map>
+#include <vector>
+
+/// occlusion queries each command buffer slot can begin before it is reset
+#ifndef GLOVE_MAX_OCCLUSION_QUERIES_PER_SLOT
+#define GLOVE_MAX_OCCLUSION_QUERIES_PER_SLOT            256
+#endif // GLOVE_MAX_OCCLUSION_QUERIES_PER_SLOT
+
+namespace vulkanAPI {
+
+class OcclusionPool {
+
+private:
+    typedef struct Slot {
+        VkQueryPool                   pool;
+        /// queries begun since the slot was last reset
+        uint32_t                      used;
+        uint32_t                      generation;
+        /// the submission carrying the queries, 0 until it is submitted
+        uint64_t                      submissionId;
+    } Slot;
+
+    typedef struct Location {
+        uint32_t                      slot;
+        uint32_t                      query;
+        uint32_t                      generation;
+    } Location;
+
+    const
+    vkContext_t *                     mVkContext;
+
+    std::vector<Slot>                 mSlots;
+    uint64_t                          mNextTicket;
+    /// queries kept for the GL queries, until they are resolved
+    std::map<uint64_t, Location>      mPending;
+    /// resolved sample counts of the GL queries, until they are released
+    std::map<uint64_t, uint64_t>      mResults;
+
+    bool                              ReadQueries(const Slot &slot, uint32_t first, uint32_t count, uint64_t *values);
+    void                              ResolveSlot(uint32_t slot);
+
+public:
+// Constructor
+    OcclusionPool(const vkContext_t *vkContext = nullptr);
+
+// Destructor
+    ~OcclusionPool();
+
+// Create Functions
+    bool                              Create(uint32_t slots);
+
+// Release Functions
+    void                              Release(void);
+    void                              Release(uint64_t ticket);
+
+// Record Functions
+    /// resolves the queries the slot last completed and records their reset, outside of a render pass
+    void                              Reset(VkCommandBuffer cmdBuffer, uint32_t slot);
+    /// returns the ticket of the query, kept until it is released, or 0 when the slot is full
+    uint64_t                          Begin(VkCommandBuffer cmdBuffer, uint32_t slot);
+    void                              End(VkCommandBuffer cmdBuffer, uint64_t ticket);
+
+// Submit Functions
+    void                              SetSubmitted(uint32_t slot, uint64_t submissionId);
+
+// Get Functions
+    bool                              GetResult(uint64_t ticket, uint64_t *samples);
+    /// the submission carrying the ticket, 0 while it is recorded and UINT64_MAX once it is resolved
+    uint64_t                          GetSubmissionId(uint64_t ticket)     const;
+    inline bool                       IsSupported(void)                   const { FUN_ENTRY(GL_LOG_TRACE); return !mSlots.empty(); }
+};
+
+}
+
+#endif // __VKOCCLUSIONPOOL_H__
@@ -27,13 +27,17 @@
  */
 
 #include "pipeline.h"
+#include "utils.h"
+#include "utils/glProfiler.h"
+#include "utils/startupProfile.h"
+#include <chrono>
 
 namespace vulkanAPI {
 
 Pipeline::Pipeline(const vkContext_t *vkContext)
 : mVkContext(vkContext), mVkPipeline(VK_NULL_HANDLE), mVkPipelineLayout(VK_NULL_HANDLE),
-  mVkPipelineCache(VK_NULL_HANDLE), mVkPipelineVertexInputState(VK_NULL_HANDLE),
-  mVkPipelineShaderStageCount(0), mCacheManager(nullptr)
+  mPipelineCache(nullptr), mVkPipelineVertexInputState(VK_NULL_HANDLE),
+  mExtendedDynamicState(false), mVkPipelineShaderStageCount(0), mCacheManager(nullptr)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
@@ -46,13 +50,19 @@ Pipeline::Pipeline(const vkContext_t *vkContext)
     mUpdateState.Pipeline         = true;
 
     mEnabledDynamicStatesList.resize(VK_DYNAMIC_STATE_RANGE_SIZE);
+
+    memset(static_cast<void *>(&mVkPipelineInputAssemblyState)       , 0, sizeof(mVkPipelineInputAssemblyState));
+    memset(static_cast<void *>(&mVkPipelineRasterizationState)       , 0, sizeof(mVkPipelineRasterizationState));
+    memset(static_cast<void *>(&mVkPipelineColorBlendState)          , 0, sizeof(mVkPipelineColorBlendState));
+    memset(static_cast<void *>(&mVkPipelineColorBlendAttachmentState), 0, sizeof(mVkPipelineColorBlendAttachmentState));
+    memset(static_cast<void *>(&mVkPipelineDepthStencilState)        , 0, sizeof(mVkPipelineDepthStencilState));
+    memset(static_cast<void *>(&mVkPipelineMultisampleState)         , 0, sizeof(mVkPipelineMultisampleState));
+    PackStateKey();
 }
 
 Pipeline::~Pipeline()
 {
     FUN_ENTRY(GL_LOG_TRACE);
-
-    Release();
 }
 
 void
@@ -74,36 +84,31 @@ Pipeline::SetScissor(int32_t x, int32_t y, int32_t width, int32_t height)
 }
 
 void
-Pipeline::MoveToCache()
+Pipeline::ComputeViewport(int fboWidth, int fboHeight, int viewportX, int viewportY, int viewportW, int viewportH, float minDepth, float maxDepth, bool originFlipped,
+                          VkSurfaceTransformFlagBitsKHR preTransform)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(mVkPipeline != VK_NULL_HANDLE) {
-        mCacheManager->CacheVkPipelineObject(mVkPipeline);
-        mVkPipeline = VK_NULL_HANDLE;
-    }
-}
-
-void
-Pipeline::Release()
-{
-    FUN_ENTRY(GL_LOG_DEBUG);
+    viewportW = std::min(viewportW, fboWidth);
+    viewportH = std::min(viewportH, fboHeight);
 
-    if(mVkPipeline != VK_NULL_HANDLE) {
-        vkDestroyPipeline(mVkContext->vkDevice, mVkPipeline, nullptr);
-        mVkPipeline = VK_NULL_HANDLE;
+    const bool flipped = mVkContext->mIsMaintenanceExtSupported && originFlipped;
+    if(flipped) {
+        viewportY = fboHeight - viewportY - viewportH;
     }
-}
 
-void
-Pipeline::ComputeViewport(int fboWidth, int fboHeight, int viewportX, int viewportY, int viewportW, int viewportH, float minDepth, float maxDepth)
-{
-    FUN_ENTRY(GL_LOG_DEBUG);
+    // the vertex shader rotates the clip space along, so that the viewport of a pre-rotated surface is rotated as a rect
+    if(preTransform != VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR) {
+        VkRect2D rect = PreTransformVkRect2D({ { viewportX, viewportY }, { static_cast<uint32_t>(viewportW), static_cast<uint32_t>(viewportH) } },
+                                             static_cast<uint32_t>(fboWidth), static_cast<uint32_t>(fboHeight), preTransform);
+        viewportX = rect.offset.x;
+        viewportY = rect.offset.y;
+        viewportW = static_cast<int>(rect.extent.width);
+        viewportH = static_cast<int>(rect.extent.height);
+    }
 
-    viewportW = std::min(viewportW, fboWidth);
-    viewportH = std::min(viewportH, fboHeight);
-    if(mVkContext->mIsMaintenanceExtSupported) {
-        viewportY = fboHeight - viewportY;
+    if(flipped) {
+        viewportY = viewportY + viewportH;
         viewportH = -viewportH;
     }
 
@@ -116,19 +121,23 @@ Pipeline::ComputeViewport(int fboWidth, int fboHeight, int viewportX, int viewpo
 }
 
 void
-Pipeline::ComputeScissor(int fboWidth, int fboHeight, int scissorX, int scissorY, int scissorW, int scissorH)
+Pipeline::ComputeScissor(int fboWidth, int fboHeight, int scissorX, int scissorY, int scissorW, int scissorH, bool originFlipped,
+                         VkSurfaceTransformFlagBitsKHR preTransform)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
     scissorW = std::min(scissorW, fboWidth);
     scissorH = std::min(scissorH, fboHeight);
 
-    int scissorYinv = fboHeight - scissorY - scissorH;
+    int scissorYinv = originFlipped ? fboHeight - scissorY - scissorH : scissorY;
 
     mVkScissorRect  = {
                         { scissorX, scissorYinv },
                         { static_cast<uint32_t>(scissorW), static_cast<uint32_t>(scissorH) }
                       };
+    if(preTransform != VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR) {
+        mVkScissorRect = PreTransformVkRect2D(mVkScissorRect, static_cast<uint32_t>(fboWidth), static_cast<uint32_t>(fboHeight), preTransform);
+    }
 }
 
 void
@@ -161,6 +170,8 @@ Pipeline::CreateInputAssemblyState(VkBool32 primitiveRestartEnable, VkPrimitiveT
     mVkPipelineInputAssemblyState.primitiveRestartEnable = primitiveRestartEnable;
 
     SetInputAssemblyTopology(topology);
+
+    PackStateKey();
 }
 
 void
@@ -186,6 +197,8 @@ Pipeline::CreateRasterizationState(VkPolygonMode polygonMode, VkCullModeFlagBits
     SetRasterizationDepthBiasEnable(depthBiasEnable);
     SetRasterizationDepthBiasConstantFactor(depthBiasConstantFactor);
     SetRasterizationDepthBiasSlopeFactor(depthBiasSlopeFactor);
+
+    PackStateKey();
 }
 
 void
@@ -219,6 +232,8 @@ Pipeline::CreateColorBlendState(VkBool32 blendEnable, VkColorComponentFlags colo
     mVkPipelineColorBlendState.pAttachments     = &mVkPipelineColorBlendAttachmentState;
 
     SetColorBlendConstants(blendConstants);
+
+    PackStateKey();
 }
 
 void
@@ -258,6 +273,8 @@ Pipeline::CreateDepthStencilState(VkBool32 depthTestEnable, VkBool32 depthWriteE
     SetStencilFrontCompareOp  (frontcompareOp);
     SetStencilFrontCompareMask(frontcompareMask);
     SetStencilFrontReference  (frontreference);
+
+    PackStateKey();
 }
 
 void
@@ -289,6 +306,8 @@ Pipeline::CreateMultisampleState(VkBool32 alphaToOneEnable, VkBool32 alphaToCove
     mVkPipelineMultisampleState.pSampleMask           = nullptr; // TODO: GetSampleCoverageValue()
 
     SetMultisampleAlphaToCoverage(alphaToCoverageEnable);
+
+    PackStateKey();
 }
 
 void
@@ -299,19 +318,57 @@ Pipeline::CreateDynamicState(const std::vector<VkDynamicState>& states)
     for(size_t index = 0; index < mEnabledDynamicStatesList.size(); ++index) {
         mEnabledDynamicStatesList[index] = false;
     }
-    memset(mVkPipelineDynamicStateEnables, 0, sizeof(mVkPipelineDynamicStateEnables));
 
+    mVkPipelineDynamicStateEnables = states;
     for(size_t stateIndex = 0; stateIndex < states.size(); ++stateIndex) {
-        VkDynamicState state = states[stateIndex];
-        mVkPipelineDynamicStateEnables[stateIndex] = state;
-        mEnabledDynamicStatesList[state] = true;
+        mEnabledDynamicStatesList[states[stateIndex]] = true;
     }
 
+    /// cull mode, front face and depth/stencil tests are folded out of the
+    /// pipeline permutations when the device can set them per draw
+    mExtendedDynamicState = mVkContext->mIsExtendedDynamicStateSupported;
+#ifdef VK_EXT_extended_dynamic_state
+    if(mExtendedDynamicState) {
+        mVkPipelineDynamicStateEnables.push_back(VK_DYNAMIC_STATE_CULL_MODE_EXT);
+        mVkPipelineDynamicStateEnables.push_back(VK_DYNAMIC_STATE_FRONT_FACE_EXT);
+        mVkPipelineDynamicStateEnables.push_back(VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT);
+        mVkPipelineDynamicStateEnables.push_back(VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT);
+        mVkPipelineDynamicStateEnables.push_back(VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT);
+        mVkPipelineDynamicStateEnables.push_back(VK_DYNAMIC_STATE_STENCIL_TEST_ENABLE_EXT);
+        mVkPipelineDynamicStateEnables.push_back(VK_DYNAMIC_STATE_STENCIL_OP_EXT);
+    }
+#endif // VK_EXT_extended_dynamic_state
+
     memset(static_cast<void *>(&mVkPipelineDynamicState), 0, sizeof(mVkPipelineDynamicState));
     mVkPipelineDynamicState.sType             = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
     mVkPipelineDynamicState.pNext             = nullptr;
-    mVkPipelineDynamicState.dynamicStateCount = static_cast<uint32_t>(states.size());
-    mVkPipelineDynamicState.pDynamicStates    = mVkPipelineDynamicStateEnables;
+    mVkPipelineDynamicState.dynamicStateCount = static_cast<uint32_t>(mVkPipelineDynamicStateEnables.size());
+    mVkPipelineDynamicState.pDynamicStates    = mVkPipelineDynamicStateEnables.data();
+
+    /// the state that became dynamic leaves the key
+    PackStateKey();
+    mUpdateState.Pipeline = true;
+}
+
+void
+Pipeline::GetExtendedDynamicState(DrawRecorder::ExtendedDynamicState *state) const
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    state->cullMode          = mVkPipelineRasterizationState.cullMode;
+    state->frontFace         = mVkPipelineRasterizationState.frontFace;
+    state->depthTestEnable   = mVkPipelineDepthStencilState.depthTestEnable;
+    state->depthWriteEnable  = mVkPipelineDepthStencilState.depthWriteEnable;
+    state->depthCompareOp    = mVkPipelineDepthStencilState.depthCompareOp;
+    state->stencilTestEnable = mVkPipelineDepthStencilState.stencilTestEnable;
+    state->frontFailOp       = mVkPipelineDepthStencilState.front.failOp;
+    state->frontPassOp       = mVkPipelineDepthStencilState.front.passOp;
+    state->frontDepthFailOp  = mVkPipelineDepthStencilState.front.depthFailOp;
+    state->frontCompareOp    = mVkPipelineDepthStencilState.front.compareOp;
+    state->backFailOp        = mVkPipelineDepthStencilState.back.failOp;
+    state->backPassOp        = mVkPipelineDepthStencilState.back.passOp;
+    state->backDepthFailOp   = mVkPipelineDepthStencilState.back.depthFailOp;
+    state->backCompareOp     = mVkPipelineDepthStencilState.back.compareOp;
 }
 
 void
@@ -328,14 +385,60 @@ Pipeline::UpdateDynamicState(const VkCommandBuffer *CmdBuffer, float lineWidth)
     if(mEnabledDynamicStatesList[VK_DYNAMIC_STATE_LINE_WIDTH]) {
         vkCmdSetLineWidth (*CmdBuffer, lineWidth);
     }
-    /*
-    TODO:: fill the remaining dynamic states
-    VK_DYNAMIC_STATE_BLEND_CONSTANTS
-    VK_DYNAMIC_STATE_DEPTH_BOUNDS
-    VK_DYNAMIC_STATE_STENCIL_COMPARE_MASK
-    VK_DYNAMIC_STATE_STENCIL_WRITE_MASK
-    VK_DYNAMIC_STATE_STENCIL_REFERENCE
-    */
+
+    // a fresh recorder has nothing tracked, so every remaining state is recorded
+    DrawRecorder recorder;
+    if(mEnabledDynamicStatesList[VK_DYNAMIC_STATE_BLEND_CONSTANTS]) {
+        recorder.SetBlendConstants(CmdBuffer, mVkPipelineColorBlendState.blendConstants);
+    }
+    if(mEnabledDynamicStatesList[VK_DYNAMIC_STATE_STENCIL_REFERENCE]) {
+        recorder.SetStencilState(CmdBuffer, &mVkPipelineDepthStencilState.front, &mVkPipelineDepthStencilState.back);
+    }
+    if(mExtendedDynamicState) {
+        DrawRecorder::ExtendedDynamicState state;
+        GetExtendedDynamicState(&state);
+        recorder.SetExtendedState(CmdBuffer, mVkContext, &state);
+    }
+}
+
+void
+Pipeline::UpdateDynamicState(DrawRecorder *recorder, const VkCommandBuffer *CmdBuffer, float lineWidth) const
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // static state baked in mVkPipeline overrides whatever the recorder has tracked so far
+    if(mEnabledDynamicStatesList[VK_DYNAMIC_STATE_VIEWPORT]) {
+        recorder->SetViewport(CmdBuffer, &mVkViewport);
+    } else {
+        recorder->InvalidateViewport();
+    }
+    if(mEnabledDynamicStatesList[VK_DYNAMIC_STATE_SCISSOR]) {
+        recorder->SetScissor(CmdBuffer, &mVkScissorRect);
+    } else {
+        recorder->InvalidateScissor();
+    }
+    if(mEnabledDynamicStatesList[VK_DYNAMIC_STATE_LINE_WIDTH]) {
+        recorder->SetLineWidth(CmdBuffer, lineWidth);
+    } else {
+        recorder->InvalidateLineWidth();
+    }
+    if(mEnabledDynamicStatesList[VK_DYNAMIC_STATE_BLEND_CONSTANTS]) {
+        recorder->SetBlendConstants(CmdBuffer, mVkPipelineColorBlendState.blendConstants);
+    } else {
+        recorder->InvalidateBlendConstants();
+    }
+    if(mEnabledDynamicStatesList[VK_DYNAMIC_STATE_STENCIL_REFERENCE]) {
+        recorder->SetStencilState(CmdBuffer, &mVkPipelineDepthStencilState.front, &mVkPipelineDepthStencilState.back);
+    } else {
+        recorder->InvalidateStencilState();
+    }
+    if(mExtendedDynamicState) {
+        DrawRecorder::ExtendedDynamicState state;
+        GetExtendedDynamicState(&state);
+        recorder->SetExtendedState(CmdBuffer, mVkContext, &state);
+    } else {
+        recorder->InvalidateExtendedState();
+    }
 }
 
 void
@@ -355,35 +458,334 @@ Pipeline::Bind(const VkCommandBuffer *CmdBuffer) const
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    vkCmdBindPipeline(*CmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mVkPipeline);
+    mVkContext->vkDispatch.vkCmdBindPipeline(*CmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mVkPipeline);
+}
+
+void
+Pipeline::Bind(DrawRecorder *recorder, const VkCommandBuffer *CmdBuffer) const
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    recorder->BindPipeline(CmdBuffer, mVkPipeline);
 }
 
 bool
-Pipeline::Create(const VkRenderPass *renderpass)
+Pipeline::Create(RenderPass *renderPass)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    // rasterization has to match the samples of the attachments rendered to
+    if(mVkPipelineMultisampleState.rasterizationSamples != renderPass->GetSampleCount()) {
+        mVkPipelineMultisampleState.rasterizationSamples = renderPass->GetSampleCount();
+        mStateKey.rasterizationSamples                   = static_cast<uint8_t>(renderPass->GetSampleCount());
+        mUpdateState.Pipeline = true;
+    }
+
     if(mUpdateState.Pipeline) {
-        SetInfo(renderpass);
-        return CreateGraphicsPipeline();
+        SetInfo(renderPass->GetRenderPass());
+        return CreateGraphicsPipeline(renderPass);
     }
 
     return true;
 }
 
-bool
-Pipeline::CreateGraphicsPipeline(void)
+void
+Pipeline::PackStateKey(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    const VkPipelineRasterizationStateCreateInfo &rasterization = mVkPipelineRasterizationState;
+    const VkPipelineColorBlendAttachmentState    &attachment    = mVkPipelineColorBlendAttachmentState;
+    const VkPipelineDepthStencilStateCreateInfo  &depthStencil  = mVkPipelineDepthStencilState;
+    const VkPipelineMultisampleStateCreateInfo   &multisample   = mVkPipelineMultisampleState;
+
+    /// the whole key is cleared first, so that the fields of dynamic state
+    /// and the padding compare equal; the setters keep it up to date after this
+    memset(static_cast<void *>(&mStateKey), 0, sizeof(mStateKey));
+
+    mStateKey.topology                = static_cast<uint8_t>(mVkPipelineInputAssemblyState.topology);
+    mStateKey.primitiveRestartEnable  = static_cast<uint8_t>(mVkPipelineInputAssemblyState.primitiveRestartEnable);
+
+    mStateKey.polygonMode             = static_cast<uint8_t>(rasterization.polygonMode);
+    mStateKey.depthBiasEnable         = static_cast<uint8_t>(rasterization.depthBiasEnable);
+    mStateKey.depthClampEnable        = static_cast<uint8_t>(rasterization.depthClampEnable);
+    mStateKey.rasterizerDiscardEnable = static_cast<uint8_t>(rasterization.rasterizerDiscardEnable);
+    mStateKey.depthBiasConstantFactor = rasterization.depthBiasConstantFactor;
+    mStateKey.depthBiasSlopeFactor    = rasterization.depthBiasSlopeFactor;
+    mStateKey.depthBiasClamp          = rasterization.depthBiasClamp;
+    if(!mEnabledDynamicStatesList[VK_DYNAMIC_STATE_LINE_WIDTH]) {
+        mStateKey.lineWidth           = rasterization.lineWidth;
+    }
+
+    mStateKey.rasterizationSamples    = static_cast<uint8_t>(multisample.rasterizationSamples);
+    mStateKey.alphaToCoverageEnable   = static_cast<uint8_t>(multisample.alphaToCoverageEnable);
+    mStateKey.alphaToOneEnable        = static_cast<uint8_t>(multisample.alphaToOneEnable);
+    mStateKey.sampleShadingEnable     = static_cast<uint8_t>(multisample.sampleShadingEnable);
+    mStateKey.minSampleShading        = multisample.minSampleShading;
+
+    mStateKey.logicOpEnable           = static_cast<uint8_t>(mVkPipelineColorBlendState.logicOpEnable);
+    mStateKey.logicOp                 = static_cast<uint8_t>(mVkPipelineColorBlendState.logicOp);
+    mStateKey.attachmentCount         = static_cast<uint8_t>(mVkPipelineColorBlendState.attachmentCount);
+    mStateKey.blendEnable             = static_cast<uint8_t>(attachment.blendEnable);
+    mStateKey.colorWriteMask          = static_cast<uint8_t>(attachment.colorWriteMask);
+    mStateKey.srcColorBlendFactor     = static_cast<uint8_t>(attachment.srcColorBlendFactor);
+    mStateKey.dstColorBlendFactor     = static_cast<uint8_t>(attachment.dstColorBlendFactor);
+    mStateKey.srcAlphaBlendFactor     = static_cast<uint8_t>(attachment.srcAlphaBlendFactor);
+    mStateKey.dstAlphaBlendFactor     = static_cast<uint8_t>(attachment.dstAlphaBlendFactor);
+    mStateKey.colorBlendOp            = static_cast<uint8_t>(attachment.colorBlendOp);
+    mStateKey.alphaBlendOp            = static_cast<uint8_t>(attachment.alphaBlendOp);
+    if(!mEnabledDynamicStatesList[VK_DYNAMIC_STATE_BLEND_CONSTANTS]) {
+        memcpy(mStateKey.blendConstants, mVkPipelineColorBlendState.blendConstants, sizeof(mStateKey.blendConstants));
+    }
+
+    mStateKey.depthBoundsTestEnable   = static_cast<uint8_t>(depthStencil.depthBoundsTestEnable);
+    mStateKey.minDepthBounds          = depthStencil.minDepthBounds;
+    mStateKey.maxDepthBounds          = depthStencil.maxDepthBounds;
+
+    stencilKey_t                   *stencilKeys[2] = { &mStateKey.front, &mStateKey.back };
+    const VkStencilOpState         *stencilOps[2]  = { &depthStencil.front, &depthStencil.back };
+    for(uint32_t i = 0; i < 2; ++i) {
+        if(!mEnabledDynamicStatesList[VK_DYNAMIC_STATE_STENCIL_COMPARE_MASK]) {
+            stencilKeys[i]->compareMask = stencilOps[i]->compareMask;
+        }
+        if(!mEnabledDynamicStatesList[VK_DYNAMIC_STATE_STENCIL_WRITE_MASK]) {
+            stencilKeys[i]->writeMask   = stencilOps[i]->writeMask;
+        }
+        if(!mEnabledDynamicStatesList[VK_DYNAMIC_STATE_STENCIL_REFERENCE]) {
+            stencilKeys[i]->reference   = stencilOps[i]->reference;
+        }
+        if(!mExtendedDynamicState) {
+            stencilKeys[i]->failOp      = static_cast<uint8_t>(stencilOps[i]->failOp);
+            stencilKeys[i]->passOp      = static_cast<uint8_t>(stencilOps[i]->passOp);
+            stencilKeys[i]->depthFailOp = static_cast<uint8_t>(stencilOps[i]->depthFailOp);
+            stencilKeys[i]->compareOp   = static_cast<uint8_t>(stencilOps[i]->compareOp);
+        }
+    }
+
+    if(!mExtendedDynamicState) {
+        mStateKey.cullMode            = static_cast<uint8_t>(rasterization.cullMode);
+        mStateKey.frontFace           = static_cast<uint8_t>(rasterization.frontFace);
+        mStateKey.depthTestEnable     = static_cast<uint8_t>(depthStencil.depthTestEnable);
+        mStateKey.depthWriteEnable    = static_cast<uint8_t>(depthStencil.depthWriteEnable);
+        mStateKey.depthCompareOp      = static_cast<uint8_t>(depthStencil.depthCompareOp);
+        mStateKey.stencilTestEnable   = static_cast<uint8_t>(depthStencil.stencilTestEnable);
+    }
+}
+
+template<typename T>
+static inline void
+AppendStateKey(std::string *key, const T &state)
+{
+    key->append(reinterpret_cast<const char *>(&state), sizeof(T));
+}
+
+std::string
+Pipeline::GetStateKey(VkFormat colorFormat, VkFormat depthStencilFormat, bool framebufferFetch) const
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    MoveToCache();
+    std::string key;
+    key.reserve(256);
+
+    /// the pipeline only has to be compatible with the render pass, which
+    /// for a single subpass depends on the attachment formats and the input attachment of the framebuffer fetch
+    AppendStateKey(&key, colorFormat);
+    AppendStateKey(&key, depthStencilFormat);
+    AppendStateKey(&key, framebufferFetch);
+    AppendStateKey(&key, mVkPipelineLayout);
+
+    for(uint32_t i = 0; i < mVkPipelineShaderStageCount; ++i) {
+        AppendStateKey(&key, mVkPipelineShaderStages[i].stage);
+        AppendStateKey(&key, mVkPipelineShaderStages[i].module);
+
+        /// the constants of a specialized module select one of its variants
+        const VkSpecializationInfo *specializationInfo = mVkPipelineShaderStages[i].pSpecializationInfo;
+        if(specializationInfo) {
+            for(uint32_t j = 0; j < specializationInfo->mapEntryCount; ++j) {
+                AppendStateKey(&key, specializationInfo->pMapEntries[j].constantID);
+                key.append(static_cast<const char *>(specializationInfo->pData) + specializationInfo->pMapEntries[j].offset,
+                           specializationInfo->pMapEntries[j].size);
+            }
+        }
+    }
+
+    if(mVkPipelineVertexInputState) {
+        AppendStateKey(&key, mVkPipelineVertexInputState->vertexBindingDescriptionCount);
+        for(uint32_t i = 0; i < mVkPipelineVertexInputState->vertexBindingDescriptionCount; ++i) {
+            AppendStateKey(&key, mVkPipelineVertexInputState->pVertexBindingDescriptions[i]);
+        }
+        AppendStateKey(&key, mVkPipelineVertexInputState->vertexAttributeDescriptionCount);
+        for(uint32_t i = 0; i < mVkPipelineVertexInputState->vertexAttributeDescriptionCount; ++i) {
+            AppendStateKey(&key, mVkPipelineVertexInputState->pVertexAttributeDescriptions[i]);
+        }
+#ifdef VK_EXT_vertex_attribute_divisor
+        /// the only structure chained to the vertex input state holds the instance divisors
+        if(mVkPipelineVertexInputState->pNext) {
+            const VkPipelineVertexInputDivisorStateCreateInfoEXT *divisorState =
+                static_cast<const VkPipelineVertexInputDivisorStateCreateInfoEXT *>(mVkPipelineVertexInputState->pNext);
+            AppendStateKey(&key, divisorState->vertexBindingDivisorCount);
+            for(uint32_t i = 0; i < divisorState->vertexBindingDivisorCount; ++i) {
+                AppendStateKey(&key, divisorState->pVertexBindingDivisors[i]);
+            }
+        }
+#endif // VK_EXT_vertex_attribute_divisor
+    }
+
+    AppendStateKey(&key, mStateKey);
+
+    AppendStateKey(&key, mVkPipelineViewportState.viewportCount);
+    AppendStateKey(&key, mVkPipelineViewportState.scissorCount);
+
+    AppendStateKey(&key, mVkPipelineDynamicState.dynamicStateCount);
+    for(uint32_t i = 0; i < mVkPipelineDynamicState.dynamicStateCount; ++i) {
+        AppendStateKey(&key, mVkPipelineDynamicStateEnables[i]);
+    }
+
+    return key;
+}
 
-    VkResult err = vkCreateGraphicsPipelines(mVkContext->vkDevice, mVkPipelineCache, 1, &mVkPipelineInfo, nullptr, &mVkPipeline);
-    assert(!err);
-    
+bool
+Pipeline::CreateGraphicsPipeline(const RenderPass *renderPass)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+    GLOVE_PROFILE_ZONE("Pipeline::CreateGraphicsPipeline");
+
+    assert(mPipelineCache);
+
+    /// state flip-flops reuse the objects that have already been built
+    std::string key = GetStateKey(renderPass->GetColorFormat(), renderPass->GetDepthStencilFormat(), renderPass->GetFramebufferFetch());
+    VkPipeline pipeline = mPipelineCache->FindPipeline(key);
+
+    ++mStatistics.lookups;
+    if(pipeline != VK_NULL_HANDLE) {
+        ++mStatistics.cacheHits;
+    } else {
+        ++mStatistics.cacheMisses;
+
+        /// a new permutation derives from the program's first pipeline,
+        /// which lets the driver reuse the work done for the shared shaders
+        VkPipeline basePipeline            = mPipelineCache->GetBasePipeline();
+        mVkPipelineInfo.flags              = VK_PIPELINE_CREATE_ALLOW_DERIVATIVES_BIT;
+        mVkPipelineInfo.basePipelineHandle = basePipeline;
+        mVkPipelineInfo.basePipelineIndex  = -1;
+        if(basePipeline != VK_NULL_HANDLE) {
+            mVkPipelineInfo.flags         |= VK_PIPELINE_CREATE_DERIVATIVE_BIT;
+        }
+
+#ifdef VK_EXT_pipeline_creation_feedback
+        VkPipelineCreationFeedbackEXT           feedback = {};
+        VkPipelineCreationFeedbackCreateInfoEXT feedbackInfo;
+        feedbackInfo.sType                              = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT;
+        feedbackInfo.pNext                              = nullptr;
+        feedbackInfo.pPipelineCreationFeedback          = &feedback;
+        feedbackInfo.pipelineStageCreationFeedbackCount = 0;
+        feedbackInfo.pPipelineStageCreationFeedbacks    = nullptr;
+        mVkPipelineInfo.pNext = mVkContext->mIsPipelineCreationFeedbackSupported ? &feedbackInfo : nullptr;
+#endif // VK_EXT_pipeline_creation_feedback
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        VkResult err = vkCreateGraphicsPipelines(mVkContext->vkDevice, mPipelineCache->GetCompileCache(), 1, &mVkPipelineInfo, nullptr, &pipeline);
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        uint64_t createTimeUs = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        StartupProfile::Record(STARTUP_PHASE_FIRST_PIPELINE, start, end);
+        mVkPipelineInfo.pNext = nullptr;
+        assert(!err);
+
+        if(err != VK_SUCCESS) {
+            return false;
+        }
+
+        ++mStatistics.creates;
+        mStatistics.createTimeUs    += createTimeUs;
+        mStatistics.maxCreateTimeUs  = std::max(mStatistics.maxCreateTimeUs, createTimeUs);
+
+        uint32_t bucket = 0;
+        for(uint64_t limitUs = 1000; bucket < GLOVE_PIPELINE_CREATE_TIME_BUCKETS - 1 && createTimeUs >= limitUs; limitUs *= 4) {
+            ++bucket;
+        }
+        ++mStatistics.createTimeHistogram[bucket];
+
+#ifdef VK_EXT_pipeline_creation_feedback
+        if((feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT) &&
+           (feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT)) {
+            ++mStatistics.driverCacheHits;
+        }
+#endif // VK_EXT_pipeline_creation_feedback
+
+        mPipelineCache->AddPipeline(key, pipeline, mCacheManager);
+    }
+
+    mVkPipeline           = pipeline;
     mUpdateState.Pipeline = false;
 
-    return (err == VK_SUCCESS);
+    return true;
+}
+
+void
+Pipeline::Precompile(VkFormat colorFormat, VkFormat depthStencilFormat, bool framebufferFetch,
+                     const std::vector<uint32_t> *const *spirv, PipelineCompiler *compiler)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(compiler == nullptr || mPipelineCache == nullptr || mVkPipelineVertexInputState == nullptr || mVkPipelineShaderStageCount == 0) {
+        return;
+    }
+
+    std::string key = GetStateKey(colorFormat, depthStencilFormat, framebufferFetch);
+    if(!mPipelineCache->BeginCompile(key)) {
+        return;
+    }
+
+    PipelineCompiler::job_t *job = new PipelineCompiler::job_t;
+    job->cache                     = mPipelineCache;
+    job->key                       = key;
+    job->vkPipelineCache           = mPipelineCache->GetCompileCache();
+    job->colorFormat               = colorFormat;
+    job->depthStencilFormat        = depthStencilFormat;
+    job->framebufferFetch          = framebufferFetch;
+    job->layout                    = mVkPipelineLayout;
+
+    job->stageCount                = mVkPipelineShaderStageCount;
+    for(uint32_t i = 0; i < mVkPipelineShaderStageCount; ++i) {
+        job->stages[i]             = mVkPipelineShaderStages[i].stage;
+        job->spirv[i]              = *spirv[i];
+
+        /// the stages of a program share their specialization
+        const VkSpecializationInfo *specializationInfo = mVkPipelineShaderStages[i].pSpecializationInfo;
+        job->specialized[i]        = specializationInfo != nullptr;
+        if(specializationInfo) {
+            job->specializationEntries.assign(specializationInfo->pMapEntries, specializationInfo->pMapEntries + specializationInfo->mapEntryCount);
+            job->specializationData.assign(static_cast<const uint8_t *>(specializationInfo->pData),
+                                           static_cast<const uint8_t *>(specializationInfo->pData) + specializationInfo->dataSize);
+        }
+    }
+
+    job->vertexInputState          = *mVkPipelineVertexInputState;
+    job->vertexBindings.assign(mVkPipelineVertexInputState->pVertexBindingDescriptions,
+                               mVkPipelineVertexInputState->pVertexBindingDescriptions + mVkPipelineVertexInputState->vertexBindingDescriptionCount);
+    job->vertexAttributes.assign(mVkPipelineVertexInputState->pVertexAttributeDescriptions,
+                                 mVkPipelineVertexInputState->pVertexAttributeDescriptions + mVkPipelineVertexInputState->vertexAttributeDescriptionCount);
+#ifdef VK_EXT_vertex_attribute_divisor
+    if(mVkPipelineVertexInputState->pNext) {
+        const VkPipelineVertexInputDivisorStateCreateInfoEXT *divisorState =
+            static_cast<const VkPipelineVertexInputDivisorStateCreateInfoEXT *>(mVkPipelineVertexInputState->pNext);
+        job->vertexInputDivisorState = *divisorState;
+        job->vertexBindingDivisors.assign(divisorState->pVertexBindingDivisors,
+                                          divisorState->pVertexBindingDivisors + divisorState->vertexBindingDivisorCount);
+    }
+#endif // VK_EXT_vertex_attribute_divisor
+
+    job->inputAssemblyState        = mVkPipelineInputAssemblyState;
+    job->rasterizationState        = mVkPipelineRasterizationState;
+    job->colorBlendState           = mVkPipelineColorBlendState;
+    job->colorBlendAttachmentState = mVkPipelineColorBlendAttachmentState;
+    job->viewportState             = mVkPipelineViewportState;
+    job->depthStencilState         = mVkPipelineDepthStencilState;
+    job->multisampleState          = mVkPipelineMultisampleState;
+    job->dynamicState              = mVkPipelineDynamicState;
+    job->dynamicStates             = mVkPipelineDynamicStateEnables;
+
+    compiler->Enqueue(job);
 }
 
 }
@@ -25,11 +25,32 @@
 #define __VKPIPELINE_H__
 
 #include "context.h"
+#include "drawRecorder.h"
+#include "pipelineCache.h"
+#include "pipelineCompiler.h"
+#include "renderPass.h"
 #include "utils/cacheManager.h"
 
+#define GLOVE_PIPELINE_CREATE_TIME_BUCKETS              5
+
 namespace vulkanAPI {
 
 class Pipeline {
+public:
+    typedef struct Statistics {
+        uint32_t                  lookups;
+        uint32_t                  cacheHits;
+        uint32_t                  cacheMisses;
+        uint32_t                  creates;
+        uint32_t                  driverCacheHits;
+        uint64_t                  createTimeUs;
+        uint64_t                  maxCreateTimeUs;
+        /// creation times below 1, 4, 16 and 64 ms, and above
+        uint32_t                  createTimeHistogram[GLOVE_PIPELINE_CREATE_TIME_BUCKETS];
+
+        Statistics()              { memset(static_cast<void *>(this), 0, sizeof(*this)); }
+    } Statistics;
+
 private:
 
     const
@@ -39,7 +60,7 @@ private:
     VkRect2D                                    mVkScissorRect;
     VkPipeline                                  mVkPipeline;
     VkPipelineLayout                            mVkPipelineLayout;
-    VkPipelineCache                             mVkPipelineCache;
+    PipelineCache                              *mPipelineCache;
 
     VkGraphicsPipelineCreateInfo                mVkPipelineInfo;
     VkPipelineInputAssemblyStateCreateInfo      mVkPipelineInputAssemblyState;
@@ -53,8 +74,9 @@ private:
     VkPipelineMultisampleStateCreateInfo        mVkPipelineMultisampleState;
 
     std::vector<bool>                           mEnabledDynamicStatesList;
-    VkDynamicState                              mVkPipelineDynamicStateEnables[VK_DYNAMIC_STATE_RANGE_SIZE];
+    std::vector<VkDynamicState>                 mVkPipelineDynamicStateEnables;
     VkPipelineDynamicStateCreateInfo            mVkPipelineDynamicState;
+    bool                                        mExtendedDynamicState;
 
     int                                         mVkPipelineShaderStageIDs[2];
     uint32_t                                    mVkPipelineShaderStageCount;
@@ -69,10 +91,84 @@ private:
 
     CacheManager                               *mCacheManager;
 
-    bool                                        CreateGraphicsPipeline(void);
-    void                                        MoveToCache(void);
-    void                                        Release(void);
+    Statistics                                  mStatistics;
+
+    typedef struct stencilKey_t {
+        uint8_t                                 failOp;
+        uint8_t                                 passOp;
+        uint8_t                                 depthFailOp;
+        uint8_t                                 compareOp;
+        uint32_t                                compareMask;
+        uint32_t                                writeMask;
+        uint32_t                                reference;
+    } stencilKey_t;
+
+    /// fixed-function state the pipelines are keyed on, packed into about 100 bytes
+    /// and kept up to date by the setters; the fields of dynamic state stay zero
+    typedef struct stateKey_t {
+        uint8_t                                 topology;
+        uint8_t                                 primitiveRestartEnable;
+        uint8_t                                 polygonMode;
+        uint8_t                                 cullMode;
+        uint8_t                                 frontFace;
+        uint8_t                                 depthBiasEnable;
+        uint8_t                                 depthClampEnable;
+        uint8_t                                 rasterizerDiscardEnable;
+
+        uint8_t                                 rasterizationSamples;
+        uint8_t                                 alphaToCoverageEnable;
+        uint8_t                                 alphaToOneEnable;
+        uint8_t                                 sampleShadingEnable;
+        uint8_t                                 logicOpEnable;
+        uint8_t                                 logicOp;
+        uint8_t                                 attachmentCount;
+        uint8_t                                 blendEnable;
+
+        uint8_t                                 colorWriteMask;
+        uint8_t                                 srcColorBlendFactor;
+        uint8_t                                 dstColorBlendFactor;
+        uint8_t                                 srcAlphaBlendFactor;
+        uint8_t                                 dstAlphaBlendFactor;
+        uint8_t                                 colorBlendOp;
+        uint8_t                                 alphaBlendOp;
+        uint8_t                                 depthTestEnable;
+
+        uint8_t                                 depthWriteEnable;
+        uint8_t                                 depthCompareOp;
+        uint8_t                                 depthBoundsTestEnable;
+        uint8_t                                 stencilTestEnable;
+        stencilKey_t                            front;
+        stencilKey_t                            back;
+
+        float                                   lineWidth;
+        float                                   depthBiasConstantFactor;
+        float                                   depthBiasSlopeFactor;
+        float                                   depthBiasClamp;
+        float                                   minDepthBounds;
+        float                                   maxDepthBounds;
+        float                                   minSampleShading;
+        float                                   blendConstants[4];
+    } stateKey_t;
+
+    stateKey_t                                  mStateKey;
+
+    bool                                        CreateGraphicsPipeline(const RenderPass *renderPass);
+    std::string                                 GetStateKey(VkFormat colorFormat, VkFormat depthStencilFormat, bool framebufferFetch) const;
     void                                        SetInfo(const VkRenderPass *renderpass);
+    void                                        GetExtendedDynamicState(DrawRecorder::ExtendedDynamicState *state) const;
+    void                                        PackStateKey(void);
+
+    /// state recorded with vkCmdSet* does not require a new pipeline
+    inline void SetStateChanged(bool dynamic)                                   { FUN_ENTRY(GL_LOG_TRACE); if(!dynamic) { mUpdateState.Pipeline = true; } }
+    inline bool IsDynamicState(VkDynamicState state)                      const { FUN_ENTRY(GL_LOG_TRACE); return mEnabledDynamicStatesList[state]; }
+
+    /// redundant sets, as with glEnable of a capability already enabled, leave the pipeline as it is,
+    /// the others write the new value to its field of the packed state key as well
+    template<typename STATE, typename VALUE, typename KEY>
+    inline void UpdateState(STATE &state, VALUE value, KEY &key, bool dynamic)  { FUN_ENTRY(GL_LOG_TRACE); if(state != static_cast<STATE>(value)) {
+                                                                                                               state = static_cast<STATE>(value);
+                                                                                                               if(!dynamic) { key = static_cast<KEY>(state); mUpdateState.Pipeline = true; }
+                                                                                                           } }
 
 public:
 // Constructor
@@ -85,11 +181,17 @@ public:
     inline int      * GetShaderStageIDsRef(void)                                { FUN_ENTRY(GL_LOG_TRACE); return mVkPipelineShaderStageIDs; }
     inline uint32_t & GetShaderStageCountRef(void)                              { FUN_ENTRY(GL_LOG_TRACE); return mVkPipelineShaderStageCount; }
     inline VkPipelineShaderStageCreateInfo * GetShaderStages(void)              { FUN_ENTRY(GL_LOG_TRACE); return mVkPipelineShaderStages; }
+    inline VkPipeline GetVkPipeline(void)                                 const { FUN_ENTRY(GL_LOG_TRACE); return mVkPipeline; }
 
     inline bool GetUpdatePipelineState(void)                              const { FUN_ENTRY(GL_LOG_TRACE); return mUpdateState.Pipeline; }
     inline bool GetUpdateViewportState(void)                              const { FUN_ENTRY(GL_LOG_TRACE); return mUpdateState.Viewport; }
     inline bool GetUpdateVertexAttribVBOs(void)                           const { FUN_ENTRY(GL_LOG_TRACE); return mUpdateState.VertexAttribVBOs; }
     inline bool GetUpdateIndexBuffer(void)                                const { FUN_ENTRY(GL_LOG_TRACE); return mUpdateState.IndexBuffer; }
+    inline VkFrontFace GetRasterizationFrontFace(void)                    const { FUN_ENTRY(GL_LOG_TRACE); return mVkPipelineRasterizationState.frontFace; }
+    inline const Statistics * GetStatistics(void)                         const { FUN_ENTRY(GL_LOG_TRACE); return &mStatistics; }
+
+// Reset Functions
+    inline void ResetStatistics(void)                                           { FUN_ENTRY(GL_LOG_TRACE); mStatistics = Statistics(); }
 
 // Set Functions
     inline void SetUpdateIndexBuffer(VkBool32 enable)                           { FUN_ENTRY(GL_LOG_TRACE); mUpdateState.IndexBuffer      = enable; }
@@ -97,60 +199,59 @@ public:
     inline void SetUpdateViewportState(VkBool32 enable)                         { FUN_ENTRY(GL_LOG_TRACE); mUpdateState.Viewport         = enable; }
     inline void SetUpdatePipeline(VkBool32 enable)                              { FUN_ENTRY(GL_LOG_TRACE); mUpdateState.Pipeline         = enable; }
 
-    inline void SetInputAssemblyTopology(VkPrimitiveTopology topology)          { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineInputAssemblyState.topology            = topology; mUpdateState.Pipeline = true;}
-    inline void SetMultisampleAlphaToCoverage(VkBool32 enable)                  { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineMultisampleState.alphaToCoverageEnable = enable;   mUpdateState.Pipeline = true; }
+    inline void SetInputAssemblyTopology(VkPrimitiveTopology topology)          { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineInputAssemblyState.topology, topology, mStateKey.topology, false); }
+    inline void SetMultisampleAlphaToCoverage(VkBool32 enable)                  { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineMultisampleState.alphaToCoverageEnable, enable, mStateKey.alphaToCoverageEnable, false); }
 
-    inline void SetRasterizationPolygonMode(VkPolygonMode mode)                 { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineRasterizationState.polygonMode = mode; mUpdateState.Pipeline = true;}
+    inline void SetRasterizationPolygonMode(VkPolygonMode mode)                 { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineRasterizationState.polygonMode, mode, mStateKey.polygonMode, false); }
     inline void SetRasterizationCullMode(VkBool32 enable,
-                                         VkCullModeFlagBits mode)               { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineRasterizationState.cullMode  = enable ? mode : VK_CULL_MODE_NONE; mUpdateState.Pipeline = true;}
-    inline void SetRasterizationFrontFace(VkFrontFace face)                     { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineRasterizationState.frontFace = face; mUpdateState.Pipeline = true;}
-
-    inline void SetRasterizationDepthBiasEnable(VkBool32 enable)                { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineRasterizationState.depthBiasEnable         = enable; mUpdateState.Pipeline = true;}
-    inline void SetRasterizationDepthBiasConstantFactor(float factor)           { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineRasterizationState.depthBiasConstantFactor = factor; mUpdateState.Pipeline = true;}
-    inline void SetRasterizationDepthBiasSlopeFactor(float factor)              { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineRasterizationState.depthBiasSlopeFactor    = factor; mUpdateState.Pipeline = true;}
-    inline void SetRasterizationLineWidth(float lineWidth)                      { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineRasterizationState.lineWidth = lineWidth; mUpdateState.Pipeline = true;}
-
-    inline void SetColorBlendAttachmentEnable(VkBool32 enable)                  { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineColorBlendAttachmentState.blendEnable = enable; mUpdateState.Pipeline = true; }
-    inline void SetColorBlendConstants(float *color)                            { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineColorBlendState.blendConstants[0] = color[0];
-                                                                                                           mVkPipelineColorBlendState.blendConstants[1] = color[1];
-                                                                                                           mVkPipelineColorBlendState.blendConstants[2] = color[2];
-                                                                                                           mVkPipelineColorBlendState.blendConstants[3] = color[3];    mUpdateState.Pipeline = true;}
-    inline void SetColorBlendAttachmentWriteMask(VkColorComponentFlags mask)    { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineColorBlendAttachmentState.colorWriteMask = mask; mUpdateState.Pipeline = true;}
-
-    inline void SetColorBlendAttachmentSrcColorFactor(VkBlendFactor factor)     { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineColorBlendAttachmentState.srcColorBlendFactor = factor; mUpdateState.Pipeline = true;}
-    inline void SetColorBlendAttachmentDstColorFactor(VkBlendFactor factor)     { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineColorBlendAttachmentState.dstColorBlendFactor = factor; mUpdateState.Pipeline = true;}
-    inline void SetColorBlendAttachmentSrcAlphaFactor(VkBlendFactor factor)     { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineColorBlendAttachmentState.srcAlphaBlendFactor = factor; mUpdateState.Pipeline = true;}
-    inline void SetColorBlendAttachmentDstAlphaFactor(VkBlendFactor factor)     { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineColorBlendAttachmentState.dstAlphaBlendFactor = factor; mUpdateState.Pipeline = true;}
-
-    inline void SetColorBlendAttachmentColorOp(VkBlendOp op)                    { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineColorBlendAttachmentState.colorBlendOp = op; mUpdateState.Pipeline = true;}
-    inline void SetColorBlendAttachmentAlphaOp(VkBlendOp op)                    { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineColorBlendAttachmentState.alphaBlendOp = op; mUpdateState.Pipeline = true;}
-
-    inline void SetDepthTestEnable(VkBool32 enable)                             { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineDepthStencilState.depthTestEnable        = enable; mUpdateState.Pipeline = true;}
-    inline void SetDepthWriteEnable(VkBool32 enable)                            { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineDepthStencilState.depthWriteEnable       = enable; mUpdateState.Pipeline = true;}
-    inline void SetDepthCompareOp(VkCompareOp op)                               { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineDepthStencilState.depthCompareOp         = op;     mUpdateState.Pipeline = true;}
-    inline void SetDepthBoundsTestEnable(VkBool32 enable)                       { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineDepthStencilState.depthBoundsTestEnable  = enable; mUpdateState.Pipeline = true;}
-    inline void SetMinDepthBounds(float depth)                                  { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineDepthStencilState.minDepthBounds         = depth;  mUpdateState.Pipeline = true;}
-    inline void SetMaxDepthBounds(float depth)                                  { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineDepthStencilState.maxDepthBounds         = depth;  mUpdateState.Pipeline = true;}
-
-    inline void SetStencilTestEnable(VkBool32 enable)                           { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineDepthStencilState.stencilTestEnable      = enable; mUpdateState.Pipeline = true;}
-
-    inline void SetStencilBackFailOp(VkStencilOp op)                            { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineDepthStencilState.back.failOp      = op;     mUpdateState.Pipeline = true;}
-    inline void SetStencilBackPassOp(VkStencilOp op)                            { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineDepthStencilState.back.passOp      = op;     mUpdateState.Pipeline = true;}
-    inline void SetStencilBackZFailOp(VkStencilOp op)                           { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineDepthStencilState.back.depthFailOp = op;     mUpdateState.Pipeline = true;}
-    inline void SetStencilBackWriteMask(uint32_t mask)                          { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineDepthStencilState.back.writeMask   = mask;   mUpdateState.Pipeline = true;}
-    inline void SetStencilBackCompareOp(VkCompareOp op)                         { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineDepthStencilState.back.compareOp   = op;     mUpdateState.Pipeline = true;}
-    inline void SetStencilBackCompareMask(uint32_t mask)                        { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineDepthStencilState.back.compareMask = mask;   mUpdateState.Pipeline = true;}
-    inline void SetStencilBackReference(uint32_t ref)                           { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineDepthStencilState.back.reference   = ref;    mUpdateState.Pipeline = true;}
-
-    inline void SetStencilFrontFailOp(VkStencilOp op)                           { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineDepthStencilState.front.failOp      = op;    mUpdateState.Pipeline = true;}
-    inline void SetStencilFrontPassOp(VkStencilOp op)                           { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineDepthStencilState.front.passOp      = op;    mUpdateState.Pipeline = true;}
-    inline void SetStencilFrontZFailOp(VkStencilOp op)                          { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineDepthStencilState.front.depthFailOp = op;    mUpdateState.Pipeline = true;}
-    inline void SetStencilFrontWriteMask(uint32_t mask)                         { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineDepthStencilState.front.writeMask   = mask;  mUpdateState.Pipeline = true;}
-    inline void SetStencilFrontCompareOp(VkCompareOp op)                        { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineDepthStencilState.front.compareOp   = op;    mUpdateState.Pipeline = true;}
-    inline void SetStencilFrontCompareMask(uint32_t mask)                       { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineDepthStencilState.front.compareMask = mask;  mUpdateState.Pipeline = true;}
-    inline void SetStencilFrontReference(uint32_t ref)                          { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineDepthStencilState.front.reference   = ref;   mUpdateState.Pipeline = true;}
-
-    inline void SetCache(VkPipelineCache cache)                                 { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineCache            = cache; }
+                                         VkCullModeFlagBits mode)               { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineRasterizationState.cullMode, enable ? mode : VK_CULL_MODE_NONE, mStateKey.cullMode, mExtendedDynamicState); }
+    inline void SetRasterizationFrontFace(VkFrontFace face)                     { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineRasterizationState.frontFace, face, mStateKey.frontFace, mExtendedDynamicState); }
+
+    inline void SetRasterizationDepthBiasEnable(VkBool32 enable)                { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineRasterizationState.depthBiasEnable, enable, mStateKey.depthBiasEnable, false); }
+    inline void SetRasterizationDepthBiasConstantFactor(float factor)           { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineRasterizationState.depthBiasConstantFactor, factor, mStateKey.depthBiasConstantFactor, false); }
+    inline void SetRasterizationDepthBiasSlopeFactor(float factor)              { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineRasterizationState.depthBiasSlopeFactor, factor, mStateKey.depthBiasSlopeFactor, false); }
+    inline void SetRasterizationLineWidth(float lineWidth)                      { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineRasterizationState.lineWidth, lineWidth, mStateKey.lineWidth, IsDynamicState(VK_DYNAMIC_STATE_LINE_WIDTH)); }
+
+    inline void SetColorBlendAttachmentEnable(VkBool32 enable)                  { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineColorBlendAttachmentState.blendEnable, enable, mStateKey.blendEnable, false); }
+    inline void SetColorBlendConstants(float *color)                            { FUN_ENTRY(GL_LOG_TRACE); for(int i = 0; i < 4; ++i) {
+                                                                                                               UpdateState(mVkPipelineColorBlendState.blendConstants[i], color[i], mStateKey.blendConstants[i], IsDynamicState(VK_DYNAMIC_STATE_BLEND_CONSTANTS));
+                                                                                                           } }
+    inline void SetColorBlendAttachmentWriteMask(VkColorComponentFlags mask)    { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineColorBlendAttachmentState.colorWriteMask, mask, mStateKey.colorWriteMask, false); }
+
+    inline void SetColorBlendAttachmentSrcColorFactor(VkBlendFactor factor)     { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineColorBlendAttachmentState.srcColorBlendFactor, factor, mStateKey.srcColorBlendFactor, false); }
+    inline void SetColorBlendAttachmentDstColorFactor(VkBlendFactor factor)     { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineColorBlendAttachmentState.dstColorBlendFactor, factor, mStateKey.dstColorBlendFactor, false); }
+    inline void SetColorBlendAttachmentSrcAlphaFactor(VkBlendFactor factor)     { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineColorBlendAttachmentState.srcAlphaBlendFactor, factor, mStateKey.srcAlphaBlendFactor, false); }
+    inline void SetColorBlendAttachmentDstAlphaFactor(VkBlendFactor factor)     { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineColorBlendAttachmentState.dstAlphaBlendFactor, factor, mStateKey.dstAlphaBlendFactor, false); }
+
+    inline void SetColorBlendAttachmentColorOp(VkBlendOp op)                    { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineColorBlendAttachmentState.colorBlendOp, op, mStateKey.colorBlendOp, false); }
+    inline void SetColorBlendAttachmentAlphaOp(VkBlendOp op)                    { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineColorBlendAttachmentState.alphaBlendOp, op, mStateKey.alphaBlendOp, false); }
+
+    inline void SetDepthTestEnable(VkBool32 enable)                             { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineDepthStencilState.depthTestEnable, enable, mStateKey.depthTestEnable, mExtendedDynamicState); }
+    inline void SetDepthWriteEnable(VkBool32 enable)                            { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineDepthStencilState.depthWriteEnable, enable, mStateKey.depthWriteEnable, mExtendedDynamicState); }
+    inline void SetDepthCompareOp(VkCompareOp op)                               { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineDepthStencilState.depthCompareOp, op, mStateKey.depthCompareOp, mExtendedDynamicState); }
+    inline void SetDepthBoundsTestEnable(VkBool32 enable)                       { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineDepthStencilState.depthBoundsTestEnable, enable, mStateKey.depthBoundsTestEnable, false); }
+    inline void SetMinDepthBounds(float depth)                                  { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineDepthStencilState.minDepthBounds, depth, mStateKey.minDepthBounds, false); }
+    inline void SetMaxDepthBounds(float depth)                                  { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineDepthStencilState.maxDepthBounds, depth, mStateKey.maxDepthBounds, false); }
+
+    inline void SetStencilTestEnable(VkBool32 enable)                           { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineDepthStencilState.stencilTestEnable, enable, mStateKey.stencilTestEnable, mExtendedDynamicState); }
+
+    inline void SetStencilBackFailOp(VkStencilOp op)                            { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineDepthStencilState.back.failOp, op, mStateKey.back.failOp, mExtendedDynamicState); }
+    inline void SetStencilBackPassOp(VkStencilOp op)                            { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineDepthStencilState.back.passOp, op, mStateKey.back.passOp, mExtendedDynamicState); }
+    inline void SetStencilBackZFailOp(VkStencilOp op)                           { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineDepthStencilState.back.depthFailOp, op, mStateKey.back.depthFailOp, mExtendedDynamicState); }
+    inline void SetStencilBackWriteMask(uint32_t mask)                          { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineDepthStencilState.back.writeMask, mask, mStateKey.back.writeMask, IsDynamicState(VK_DYNAMIC_STATE_STENCIL_WRITE_MASK)); }
+    inline void SetStencilBackCompareOp(VkCompareOp op)                         { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineDepthStencilState.back.compareOp, op, mStateKey.back.compareOp, mExtendedDynamicState); }
+    inline void SetStencilBackCompareMask(uint32_t mask)                        { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineDepthStencilState.back.compareMask, mask, mStateKey.back.compareMask, IsDynamicState(VK_DYNAMIC_STATE_STENCIL_COMPARE_MASK)); }
+    inline void SetStencilBackReference(uint32_t ref)                           { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineDepthStencilState.back.reference, ref, mStateKey.back.reference, IsDynamicState(VK_DYNAMIC_STATE_STENCIL_REFERENCE)); }
+
+    inline void SetStencilFrontFailOp(VkStencilOp op)                           { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineDepthStencilState.front.failOp, op, mStateKey.front.failOp, mExtendedDynamicState); }
+    inline void SetStencilFrontPassOp(VkStencilOp op)                           { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineDepthStencilState.front.passOp, op, mStateKey.front.passOp, mExtendedDynamicState); }
+    inline void SetStencilFrontZFailOp(VkStencilOp op)                          { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineDepthStencilState.front.depthFailOp, op, mStateKey.front.depthFailOp, mExtendedDynamicState); }
+    inline void SetStencilFrontWriteMask(uint32_t mask)                         { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineDepthStencilState.front.writeMask, mask, mStateKey.front.writeMask, IsDynamicState(VK_DYNAMIC_STATE_STENCIL_WRITE_MASK)); }
+    inline void SetStencilFrontCompareOp(VkCompareOp op)                        { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineDepthStencilState.front.compareOp, op, mStateKey.front.compareOp, mExtendedDynamicState); }
+    inline void SetStencilFrontCompareMask(uint32_t mask)                       { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineDepthStencilState.front.compareMask, mask, mStateKey.front.compareMask, IsDynamicState(VK_DYNAMIC_STATE_STENCIL_COMPARE_MASK)); }
+    inline void SetStencilFrontReference(uint32_t ref)                          { FUN_ENTRY(GL_LOG_TRACE); UpdateState(mVkPipelineDepthStencilState.front.reference, ref, mStateKey.front.reference, IsDynamicState(VK_DYNAMIC_STATE_STENCIL_REFERENCE)); }
+
+    inline void SetCache(PipelineCache *cache)                                  { FUN_ENTRY(GL_LOG_TRACE); mPipelineCache             = cache; }
     inline void SetLayout(VkPipelineLayout layout)                              { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineLayout           = layout; }
     inline void SetVertexInputState(
                             VkPipelineVertexInputStateCreateInfo *vertexInput)  { FUN_ENTRY(GL_LOG_TRACE); mVkPipelineVertexInputState = vertexInput; }
@@ -177,16 +278,23 @@ public:
           void CreateMultisampleState(VkBool32 alphaToOneEnable, VkBool32 alphaToCoverageEnable, VkSampleCountFlagBits rasterizationSamples, VkBool32 sampleShadingEnable, float minSampleShading);
 
 // Compute Functions
-          void ComputeViewport(int fboWidth, int fboHeight, int viewportX, int viewportY, int viewportW, int viewportH, float minDepth, float maxDepth);
-          void ComputeScissor(int fboWidth, int fboHeight, int scissorX, int scissorY, int scissorW, int scissorH);
+          /// fboWidth and fboHeight are in window coordinates, which preTransform maps onto the images of pre-rotated surfaces
+          void ComputeViewport(int fboWidth, int fboHeight, int viewportX, int viewportY, int viewportW, int viewportH, float minDepth, float maxDepth, bool originFlipped,
+                               VkSurfaceTransformFlagBitsKHR preTransform = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR);
+          void ComputeScissor(int fboWidth, int fboHeight, int scissorX, int scissorY, int scissorW, int scissorH, bool originFlipped,
+                              VkSurfaceTransformFlagBitsKHR preTransform = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR);
 
 // Bind Functions
           void Bind(const VkCommandBuffer *CmdBuffer) const;
+          void Bind(DrawRecorder *recorder, const VkCommandBuffer *CmdBuffer) const;
 
 // Create Functions
-          bool Create(const VkRenderPass *renderpass);
+          bool Create(RenderPass *renderPass);
+          void Precompile(VkFormat colorFormat, VkFormat depthStencilFormat, bool framebufferFetch,
+                          const std::vector<uint32_t> *const *spirv, PipelineCompiler *compiler);
 // Update Functions
           void UpdateDynamicState(const VkCommandBuffer *CmdBuffer, float lineWidth) const;
+          void UpdateDynamicState(DrawRecorder *recorder, const VkCommandBuffer *CmdBuffer, float lineWidth) const;
 };
 
 }
@@ -23,11 +23,13 @@
  */
 
 #include "pipelineCache.h"
+#include "commandBundle.h"
+#include "utils/cacheManager.h"
 
 namespace vulkanAPI {
 
 PipelineCache::PipelineCache(const vkContext_t *vkContext)
-: mVkContext(vkContext), mVkPipelineCache(VK_NULL_HANDLE)
+: mVkContext(vkContext), mVkPipelineCache(VK_NULL_HANDLE), mVkBasePipeline(VK_NULL_HANDLE), mUseCounter(0)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 }
@@ -44,12 +46,184 @@ PipelineCache::Release(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    {
+        // background builds might still be referencing the program's objects
+        std::unique_lock<std::mutex> lock(mMutex);
+        mPendingCompiled.wait(lock, [this] { return mPendingKeys.empty(); });
+        ReleasePipelinesLocked(nullptr);
+    }
+
     if(mVkPipelineCache != VK_NULL_HANDLE) {
         vkDestroyPipelineCache(mVkContext->vkDevice, mVkPipelineCache, nullptr);
         mVkPipelineCache = VK_NULL_HANDLE;
     }
 }
 
+void
+PipelineCache::ReleasePipelines(CacheManager *cacheManager)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mPendingCompiled.wait(lock, [this] { return mPendingKeys.empty(); });
+    ReleasePipelinesLocked(cacheManager);
+}
+
+void
+PipelineCache::TrimPipelines(CacheManager *cacheManager, size_t maxPipelines)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    while(mVkPipelines.size() > maxPipelines) {
+        EvictPipelineLocked(cacheManager);
+    }
+}
+
+void
+PipelineCache::ReleasePipelinesLocked(CacheManager *cacheManager)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    for(auto &entry : mVkPipelines) {
+        if(cacheManager) {
+            cacheManager->CacheVkPipelineObject(entry.second.pipeline);
+        } else {
+            CommandBundle::Retire(CommandBundle::GetHandleKey(entry.second.pipeline));
+            vkDestroyPipeline(mVkContext->vkDevice, entry.second.pipeline, nullptr);
+        }
+    }
+    mVkPipelines.clear();
+    mVkBasePipeline = VK_NULL_HANDLE;
+}
+
+void
+PipelineCache::InsertPipelineLocked(const std::string &key, VkPipeline pipeline)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    pipelineEntry_t &entry = mVkPipelines[key];
+    entry.pipeline = pipeline;
+    entry.lastUse  = ++mUseCounter;
+
+    if(mVkBasePipeline == VK_NULL_HANDLE) {
+        mVkBasePipeline = pipeline;
+    }
+}
+
+void
+PipelineCache::EvictPipelineLocked(CacheManager *cacheManager)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    auto lru = mVkPipelines.begin();
+    for(auto it = mVkPipelines.begin(); it != mVkPipelines.end(); ++it) {
+        if(it->second.lastUse < lru->second.lastUse) {
+            lru = it;
+        }
+    }
+
+    if(lru == mVkPipelines.end()) {
+        return;
+    }
+
+    // the pipeline may still be referenced by command buffers in flight,
+    // so it is retired along with the submission slot that is recording
+    if(cacheManager) {
+        cacheManager->CacheVkPipelineObject(lru->second.pipeline);
+    } else {
+        CommandBundle::Retire(CommandBundle::GetHandleKey(lru->second.pipeline));
+        vkDestroyPipeline(mVkContext->vkDevice, lru->second.pipeline, nullptr);
+    }
+
+    if(mVkBasePipeline == lru->second.pipeline) {
+        mVkBasePipeline = VK_NULL_HANDLE;
+    }
+    mVkPipelines.erase(lru);
+}
+
+VkPipeline
+PipelineCache::GetBasePipeline(void) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mVkBasePipeline;
+}
+
+size_t
+PipelineCache::GetPipelineCount(void) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mVkPipelines.size();
+}
+
+VkPipeline
+PipelineCache::FindPipeline(const std::string &key)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // waiting for a build in flight is still cheaper than starting another one
+    std::unique_lock<std::mutex> lock(mMutex);
+    mPendingCompiled.wait(lock, [this, &key] { return mPendingKeys.find(key) == mPendingKeys.end(); });
+
+    auto it = mVkPipelines.find(key);
+    if(it == mVkPipelines.end()) {
+        return VK_NULL_HANDLE;
+    }
+
+    it->second.lastUse = ++mUseCounter;
+    return it->second.pipeline;
+}
+
+void
+PipelineCache::AddPipeline(const std::string &key, VkPipeline pipeline, CacheManager *cacheManager)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    // bound the number of live objects by dropping the least recently used
+    while(!mVkPipelines.empty() && mVkPipelines.size() >= GLOVE_MAX_CACHED_PIPELINES) {
+        EvictPipelineLocked(cacheManager);
+    }
+
+    InsertPipelineLocked(key, pipeline);
+}
+
+bool
+PipelineCache::BeginCompile(const std::string &key)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    if(mVkPipelines.find(key) != mVkPipelines.end() ||
+       mVkPipelines.size() + mPendingKeys.size() >= GLOVE_MAX_CACHED_PIPELINES) {
+        return false;
+    }
+
+    return mPendingKeys.insert(key).second;
+}
+
+void
+PipelineCache::EndCompile(const std::string &key, VkPipeline pipeline)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mPendingKeys.erase(key);
+        if(pipeline != VK_NULL_HANDLE) {
+            InsertPipelineLocked(key, pipeline);
+        }
+    }
+    mPendingCompiled.notify_all();
+}
+
 bool
 PipelineCache::GetData(void* data, size_t* size) const
 {
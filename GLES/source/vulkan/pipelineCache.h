@@ -25,8 +25,20 @@
 #ifndef __VKPIPELINECACHE_H__
 #define __VKPIPELINECACHE_H__
 
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include "context.h"
 
+/// budget of live VkPipeline objects per program, lower it on memory constrained devices
+#ifndef GLOVE_MAX_CACHED_PIPELINES
+#define GLOVE_MAX_CACHED_PIPELINES                      64
+#endif // GLOVE_MAX_CACHED_PIPELINES
+
+class CacheManager;
+
 namespace vulkanAPI {
 
 class PipelineCache {
@@ -38,6 +50,27 @@ private:
 
     VkPipelineCache                   mVkPipelineCache;
 
+    typedef struct pipelineEntry_t {
+        VkPipeline                    pipeline;
+        uint64_t                      lastUse;
+    } pipelineEntry_t;
+
+    /// VkPipeline objects built so far, keyed on the state they were created with
+    std::unordered_map<std::string, pipelineEntry_t> mVkPipelines;
+    uint64_t                          mUseCounter;
+
+    /// first pipeline of the program, the parent of the permutations built after it
+    VkPipeline                        mVkBasePipeline;
+
+    /// keys being built in the background by the PipelineCompiler
+    std::unordered_set<std::string>   mPendingKeys;
+    mutable std::mutex                mMutex;
+    mutable std::condition_variable   mPendingCompiled;
+
+    void                              ReleasePipelinesLocked(CacheManager *cacheManager);
+    void                              InsertPipelineLocked(const std::string &key, VkPipeline pipeline);
+    void                              EvictPipelineLocked(CacheManager *cacheManager);
+
 public:
 // Constructor
     PipelineCache(const vkContext_t *vkContext = nullptr);
@@ -50,12 +83,24 @@ public:
 
 // Release Functions
     void                              Release(void);
+    void                              ReleasePipelines(CacheManager *cacheManager);
+    void                              TrimPipelines(CacheManager *cacheManager, size_t maxPipelines);
 
-// Release Functions
+// Find/Add Functions
+           VkPipeline                 FindPipeline(const std::string &key);
+           void                       AddPipeline(const std::string &key, VkPipeline pipeline, CacheManager *cacheManager);
+
+// Begin/End Functions
+           bool                       BeginCompile(const std::string &key);
+           void                       EndCompile(const std::string &key, VkPipeline pipeline);
 
 // Get Functions
            bool                       GetData(void* data, size_t* size)   const;
+           VkPipeline                 GetBasePipeline(void)               const;
+           size_t                     GetPipelineCount(void)              const;
     inline VkPipelineCache            GetPipelineCache(void)              const { FUN_ENTRY(GL_LOG_TRACE); return mVkPipelineCache; }
+    /// the device-wide cache is used unless the program has one of its own for program binaries
+    inline VkPipelineCache            GetCompileCache(void)               const { FUN_ENTRY(GL_LOG_TRACE); return mVkPipelineCache != VK_NULL_HANDLE ? mVkPipelineCache : mVkContext->vkPipelineCache; }
 
 // Set Functions
     inline void                       SetContext(const vkContext_t *vkContext)  { FUN_ENTRY(GL_LOG_TRACE); mVkContext = vkContext; }
@@ -0,0 +1,184 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       pipelineCompiler.cpp
+ *  @author     Think Silicon
+ *  @date       14/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Background compilation of graphics pipelines in Vulkan
+ *
+ *  @section
+ *
+ *  Pipelines are speculatively built by the job system as soon as a program
+ *  is linked, so that the first draw with it finds a ready object in the
+ *  program's PipelineCache instead of stalling in vkCreateGraphicsPipelines.
+ *  Each job owns its shader modules and a compatible render pass, since the
+ *  ones of the GL thread may be destroyed while the job is still pending.
+ *
+ */
+
+#include "pipelineCompiler.h"
+#include "renderPass.h"
+#include "shaderModuleCache.h"
+#include "utils/startupProfile.h"
+#include "utils/jobSystem.h"
+
+namespace vulkanAPI {
+
+PipelineCompiler::PipelineCompiler(const vkContext_t *vkContext)
+: mVkContext(vkContext), mScheduled(false)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+}
+
+PipelineCompiler::~PipelineCompiler()
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // pending jobs are completed, their caches are waiting for them
+    std::unique_lock<std::mutex> lock(mMutex);
+    mIdle.wait(lock, [this] { return !mScheduled; });
+}
+
+void
+PipelineCompiler::Enqueue(job_t *job)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    bool schedule;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mJobs.push_back(job);
+        schedule   = !mScheduled;
+        mScheduled = true;
+    }
+
+    if(schedule) {
+        JobSystem::GetInstance()->Submit([this] { Run(); });
+    }
+}
+
+void
+PipelineCompiler::Run(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    for(;;) {
+        job_t *job = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if(mJobs.empty()) {
+                // notified under the lock, as the compiler may be destroyed right after
+                mScheduled = false;
+                mIdle.notify_all();
+                return;
+            }
+            job = mJobs.front();
+            mJobs.pop_front();
+        }
+
+        job->cache->EndCompile(job->key, Compile(job));
+        delete job;
+    }
+}
+
+VkPipeline
+PipelineCompiler::Compile(job_t *job) const
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+
+    RenderPass renderPass(mVkContext);
+    renderPass.SetFramebufferFetch(job->framebufferFetch);
+    if(!renderPass.Create(job->colorFormat, job->depthStencilFormat)) {
+        return VK_NULL_HANDLE;
+    }
+
+    job->specializationInfo.mapEntryCount = static_cast<uint32_t>(job->specializationEntries.size());
+    job->specializationInfo.pMapEntries   = job->specializationEntries.data();
+    job->specializationInfo.dataSize      = job->specializationData.size();
+    job->specializationInfo.pData         = job->specializationData.data();
+
+    VkShaderModule                  modules[2] = {VK_NULL_HANDLE, VK_NULL_HANDLE};
+    VkPipelineShaderStageCreateInfo stages[2];
+    bool                            modulesCreated = true;
+
+    // the modules of the program are usually still held by it, and are shared rather than created again
+    for(uint32_t i = 0; i < job->stageCount; ++i) {
+        modules[i] = mVkContext->vkShaderModuleCache->Acquire(job->spirv[i].data(), job->spirv[i].size());
+        if(modules[i] == VK_NULL_HANDLE) {
+            modulesCreated = false;
+            break;
+        }
+
+        stages[i].sType               = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stages[i].pNext               = nullptr;
+        stages[i].flags               = 0;
+        stages[i].stage               = job->stages[i];
+        stages[i].module              = modules[i];
+        stages[i].pName               = "main";
+        stages[i].pSpecializationInfo = job->specialized[i] ? &job->specializationInfo : nullptr;
+    }
+
+    if(modulesCreated) {
+        job->vertexInputState.pVertexBindingDescriptions   = job->vertexBindings.data();
+        job->vertexInputState.pVertexAttributeDescriptions = job->vertexAttributes.data();
+#ifdef VK_EXT_vertex_attribute_divisor
+        job->vertexInputDivisorState.pVertexBindingDivisors = job->vertexBindingDivisors.data();
+        job->vertexInputState.pNext = job->vertexBindingDivisors.empty() ? nullptr : &job->vertexInputDivisorState;
+#endif // VK_EXT_vertex_attribute_divisor
+        job->colorBlendState.pAttachments                  = &job->colorBlendAttachmentState;
+        job->dynamicState.pDynamicStates                   = job->dynamicStates.data();
+
+        VkGraphicsPipelineCreateInfo info;
+        memset(static_cast<void *>(&info), 0, sizeof(info));
+        info.sType               = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        info.stageCount          = job->stageCount;
+        info.pStages             = stages;
+        info.pVertexInputState   = &job->vertexInputState;
+        info.pInputAssemblyState = &job->inputAssemblyState;
+        info.pViewportState      = &job->viewportState;
+        info.pRasterizationState = &job->rasterizationState;
+        info.pMultisampleState   = &job->multisampleState;
+        info.pDepthStencilState  = &job->depthStencilState;
+        info.pColorBlendState    = &job->colorBlendState;
+        info.pDynamicState       = &job->dynamicState;
+        info.layout              = job->layout;
+        info.renderPass          = *renderPass.GetRenderPass();
+        info.subpass             = 0;
+        info.flags               = VK_PIPELINE_CREATE_ALLOW_DERIVATIVES_BIT;
+        info.basePipelineHandle  = job->cache->GetBasePipeline();
+        info.basePipelineIndex   = -1;
+        if(info.basePipelineHandle != VK_NULL_HANDLE) {
+            info.flags          |= VK_PIPELINE_CREATE_DERIVATIVE_BIT;
+        }
+
+        GLOVE_STARTUP_PHASE(STARTUP_PHASE_FIRST_PIPELINE);
+        if(vkCreateGraphicsPipelines(mVkContext->vkDevice, job->vkPipelineCache, 1, &info, nullptr, &pipeline) != VK_SUCCESS) {
+            pipeline = VK_NULL_HANDLE;
+        }
+    }
+
+    for(uint32_t i = 0; i < job->stageCount; ++i) {
+        if(modules[i] != VK_NULL_HANDLE) {
+            mVkContext->vkShaderModuleCache->Release(modules[i]);
+        }
+    }
+
+    return pipeline;
+}
+
+}
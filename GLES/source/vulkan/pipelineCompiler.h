@@ -0,0 +1,104 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       pipelineCompiler.h
+ *  @author     Think Silicon
+ *  @date       14/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Background compilation of graphics pipelines in Vulkan
+ *
+ */
+
+#ifndef __VKPIPELINECOMPILER_H__
+#define __VKPIPELINECOMPILER_H__
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include "context.h"
+#include "pipelineCache.h"
+
+namespace vulkanAPI {
+
+class PipelineCompiler {
+
+public:
+    /// self-contained copy of the state a pipeline is built with, so that it
+    /// stays valid while the GL thread keeps changing its own
+    typedef struct job_t {
+        PipelineCache                          *cache;
+        std::string                             key;
+        VkPipelineCache                         vkPipelineCache;
+
+        VkFormat                                colorFormat;
+        VkFormat                                depthStencilFormat;
+        bool                                    framebufferFetch;
+        VkPipelineLayout                        layout;
+
+        uint32_t                                stageCount;
+        VkShaderStageFlagBits                   stages[2];
+        std::vector<uint32_t>                   spirv[2];
+        bool                                    specialized[2];
+        VkSpecializationInfo                    specializationInfo;
+        std::vector<VkSpecializationMapEntry>   specializationEntries;
+        std::vector<uint8_t>                    specializationData;
+
+        VkPipelineVertexInputStateCreateInfo    vertexInputState;
+        std::vector<VkVertexInputBindingDescription>   vertexBindings;
+        std::vector<VkVertexInputAttributeDescription> vertexAttributes;
+#ifdef VK_EXT_vertex_attribute_divisor
+        VkPipelineVertexInputDivisorStateCreateInfoEXT vertexInputDivisorState;
+        std::vector<VkVertexInputBindingDivisorDescriptionEXT> vertexBindingDivisors;
+#endif // VK_EXT_vertex_attribute_divisor
+
+        VkPipelineInputAssemblyStateCreateInfo  inputAssemblyState;
+        VkPipelineRasterizationStateCreateInfo  rasterizationState;
+        VkPipelineColorBlendStateCreateInfo     colorBlendState;
+        VkPipelineColorBlendAttachmentState     colorBlendAttachmentState;
+        VkPipelineViewportStateCreateInfo       viewportState;
+        VkPipelineDepthStencilStateCreateInfo   depthStencilState;
+        VkPipelineMultisampleStateCreateInfo    multisampleState;
+        VkPipelineDynamicStateCreateInfo        dynamicState;
+        std::vector<VkDynamicState>             dynamicStates;
+    } job_t;
+
+private:
+
+    const
+    vkContext_t *                     mVkContext;
+
+    std::mutex                        mMutex;
+    std::condition_variable           mIdle;
+    std::deque<job_t *>               mJobs;
+    /// a job of the pool drains the queue while this is set
+    bool                              mScheduled;
+
+    void                              Run(void);
+    VkPipeline                        Compile(job_t *job) const;
+
+public:
+// Constructor
+    PipelineCompiler(const vkContext_t *vkContext);
+
+// Destructor
+    ~PipelineCompiler();
+
+// Enqueue Functions
+    void                              Enqueue(job_t *job);
+};
+
+}
+
+#endif // __VKPIPELINECOMPILER_H__
@@ -33,13 +33,28 @@
 
 namespace vulkanAPI {
 
+/// the layouts used by GLOVE are the core ones up to VK_IMAGE_LAYOUT_PREINITIALIZED and the present one, so they fit in 4 bits
+static inline uint32_t
+PackImageLayout(VkImageLayout layout)
+{
+    assert(layout <= VK_IMAGE_LAYOUT_PREINITIALIZED || layout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+    return layout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR ? VK_IMAGE_LAYOUT_PREINITIALIZED + 1 : static_cast<uint32_t>(layout);
+}
+
 RenderPass::RenderPass(const vkContext_t *vkContext)
 : mVkContext(vkContext),
   mVkPipelineBindPoint(VK_PIPELINE_BIND_POINT_GRAPHICS),
   mVkRenderPass(VK_NULL_HANDLE),
   mColorClearEnabled(false), mDepthClearEnabled(false), mStencilClearEnabled(false),
   mColorWriteEnabled(true), mDepthWriteEnabled(true), mStencilWriteEnabled(false),
-  mStarted(false)
+  mDepthStencilTransient(false), mColorTransient(false),
+  mColorInvalidated(false), mDepthInvalidated(false), mStencilInvalidated(false),
+  mStarted(false),
+  mColorFormat(VK_FORMAT_UNDEFINED), mDepthStencilFormat(VK_FORMAT_UNDEFINED), mSampleCount(VK_SAMPLE_COUNT_1_BIT),
+  mHasColorAttachment(false), mHasDepthAttachment(false), mHasStencilAttachment(false),
+  mColorInitialLayout(VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL), mDepthStencilInitialLayout(VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL),
+  mResolveInitialLayout(VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL), mColorFinalLayout(VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL),
+  mFramebufferFetch(false)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
@@ -58,10 +73,11 @@ RenderPass::Release(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(mVkRenderPass != VK_NULL_HANDLE) {
-        vkDestroyRenderPass(mVkContext->vkDevice, mVkRenderPass, nullptr);
-        mVkRenderPass = VK_NULL_HANDLE;
+    for(auto &entry : mVkRenderPasses) {
+        vkDestroyRenderPass(mVkContext->vkDevice, entry.second, nullptr);
     }
+    mVkRenderPasses.clear();
+    mVkRenderPass = VK_NULL_HANDLE;
 }
 
 bool
@@ -69,30 +85,44 @@ RenderPass::Create(VkFormat colorFormat, VkFormat depthstencilFormat)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    Release();
-
     VkAttachmentReference           color;
     VkAttachmentReference           depthstencil;
+    VkAttachmentReference           resolve;
+    VkAttachmentReference           input;
     vector<VkAttachmentDescription> attachments;
 
+    mColorFormat          = colorFormat;
+    mDepthStencilFormat   = depthstencilFormat;
+    mHasColorAttachment   = (colorFormat        != VK_FORMAT_UNDEFINED);
+    mHasDepthAttachment   = (depthstencilFormat != VK_FORMAT_UNDEFINED) && VkFormatIsDepth(depthstencilFormat);
+    mHasStencilAttachment = (depthstencilFormat != VK_FORMAT_UNDEFINED) && VkFormatIsStencil(depthstencilFormat);
+
     if(colorFormat != VK_FORMAT_UNDEFINED) {
 
         /// Color attachment
         VkAttachmentDescription attachmentColor;
         attachmentColor.flags           = 0;
         attachmentColor.format          = colorFormat;
-        attachmentColor.samples         = VK_SAMPLE_COUNT_1_BIT;
-        attachmentColor.loadOp          = (mColorClearEnabled && mColorWriteEnabled) ? VK_ATTACHMENT_LOAD_OP_CLEAR  : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-        attachmentColor.storeOp         = mColorWriteEnabled ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        attachmentColor.samples         = mSampleCount;
+        attachmentColor.loadOp          = (mColorClearEnabled && mColorWriteEnabled) ? VK_ATTACHMENT_LOAD_OP_CLEAR     :
+                                          (mColorInvalidated || mColorTransient)     ? VK_ATTACHMENT_LOAD_OP_DONT_CARE : VK_ATTACHMENT_LOAD_OP_LOAD;
+        attachmentColor.storeOp         = (mColorWriteEnabled && !mColorTransient)   ? VK_ATTACHMENT_STORE_OP_STORE    : VK_ATTACHMENT_STORE_OP_DONT_CARE;
         attachmentColor.stencilLoadOp   = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         attachmentColor.stencilStoreOp  = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        attachmentColor.initialLayout   = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-        attachmentColor.finalLayout     = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        // contents that are not loaded nor cleared are undefined, so their layout does not matter either
+        attachmentColor.initialLayout   = attachmentColor.loadOp == VK_ATTACHMENT_LOAD_OP_DONT_CARE ? VK_IMAGE_LAYOUT_UNDEFINED : mColorInitialLayout;
+        attachmentColor.finalLayout     = mSampleCount != VK_SAMPLE_COUNT_1_BIT ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL : mColorFinalLayout;
 
         attachments.push_back(attachmentColor);
 
         color.attachment           = attachments.size() - 1;
         color.layout               = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        /// the framebuffer fetch reads the color attachment it writes, which takes the general layout
+        if(mFramebufferFetch) {
+            color.layout           = VK_IMAGE_LAYOUT_GENERAL;
+            input                  = color;
+        }
     }
 
     /// Depth/Stencil attachment
@@ -104,12 +134,16 @@ RenderPass::Create(VkFormat colorFormat, VkFormat depthstencilFormat)
         VkAttachmentDescription attachmentDepthStencil;
         attachmentDepthStencil.flags          = 0;
         attachmentDepthStencil.format         = depthstencilFormat;
-        attachmentDepthStencil.samples        = VK_SAMPLE_COUNT_1_BIT;
-        attachmentDepthStencil.loadOp         = (isDepth   && mDepthClearEnabled && mDepthWriteEnabled)     ? VK_ATTACHMENT_LOAD_OP_CLEAR  : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-        attachmentDepthStencil.storeOp        = (isDepth   && mDepthWriteEnabled)                           ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        attachmentDepthStencil.stencilLoadOp  = (isStencil && mStencilClearEnabled && mStencilWriteEnabled) ? VK_ATTACHMENT_LOAD_OP_CLEAR  : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-        attachmentDepthStencil.stencilStoreOp = (isStencil && mStencilWriteEnabled)                         ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        attachmentDepthStencil.initialLayout  = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        attachmentDepthStencil.samples        = mSampleCount;
+        // transient contents never survive the previous pass, so there is nothing to load
+        attachmentDepthStencil.loadOp         = (isDepth   && mDepthClearEnabled   && mDepthWriteEnabled)      ? VK_ATTACHMENT_LOAD_OP_CLEAR     :
+                                                (isDepth   && !mDepthInvalidated   && !mDepthStencilTransient) ? VK_ATTACHMENT_LOAD_OP_LOAD      : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        attachmentDepthStencil.storeOp        = (isDepth   && mDepthWriteEnabled   && !mDepthStencilTransient) ? VK_ATTACHMENT_STORE_OP_STORE    : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        attachmentDepthStencil.stencilLoadOp  = (isStencil && mStencilClearEnabled && mStencilWriteEnabled)    ? VK_ATTACHMENT_LOAD_OP_CLEAR     :
+                                                (isStencil && !mStencilInvalidated && !mDepthStencilTransient) ? VK_ATTACHMENT_LOAD_OP_LOAD      : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        attachmentDepthStencil.stencilStoreOp = (isStencil && mStencilWriteEnabled && !mDepthStencilTransient) ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        attachmentDepthStencil.initialLayout  = (attachmentDepthStencil.loadOp        == VK_ATTACHMENT_LOAD_OP_DONT_CARE &&
+                                                 attachmentDepthStencil.stencilLoadOp == VK_ATTACHMENT_LOAD_OP_DONT_CARE) ? VK_IMAGE_LAYOUT_UNDEFINED : mDepthStencilInitialLayout;
         attachmentDepthStencil.finalLayout    = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
         attachments.push_back(attachmentDepthStencil);
@@ -118,18 +152,98 @@ RenderPass::Create(VkFormat colorFormat, VkFormat depthstencilFormat)
         depthstencil.layout       = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
     }
 
+    /// Resolve attachment, the samples are averaged into it at the end of the subpass, so its contents are never loaded
+    bool hasResolve = (colorFormat != VK_FORMAT_UNDEFINED) && (mSampleCount != VK_SAMPLE_COUNT_1_BIT);
+    if(hasResolve) {
+
+        VkAttachmentDescription attachmentResolve;
+        attachmentResolve.flags          = 0;
+        attachmentResolve.format         = colorFormat;
+        attachmentResolve.samples        = VK_SAMPLE_COUNT_1_BIT;
+        attachmentResolve.loadOp         = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        attachmentResolve.storeOp        = VK_ATTACHMENT_STORE_OP_STORE;
+        attachmentResolve.stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        attachmentResolve.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        // the render area may not cover the whole image, so the rest is kept unless it is undefined anyway
+        attachmentResolve.initialLayout  = mColorInvalidated ? VK_IMAGE_LAYOUT_UNDEFINED : mResolveInitialLayout;
+        attachmentResolve.finalLayout    = mColorFinalLayout;
+
+        attachments.push_back(attachmentResolve);
+
+        resolve.attachment        = attachments.size() - 1;
+        resolve.layout            = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    }
+
+    /// each of the (at most three) attachments' load/store ops are packed in a byte, the top one holds the sample count
+    uint32_t ops = static_cast<uint32_t>(mSampleCount) << 24;
+    for(uint32_t i = 0; i < attachments.size(); ++i) {
+        ops |= ((attachments[i].loadOp        << 6) | (attachments[i].storeOp        << 4) |
+                (attachments[i].stencilLoadOp << 2) |  attachments[i].stencilStoreOp) << (8 * i);
+    }
+    /// and their initial layouts take a nibble each, followed by the final color layout and the framebuffer fetch
+    const bool hasInput = mFramebufferFetch && colorFormat != VK_FORMAT_UNDEFINED;
+    uint32_t layouts = (static_cast<uint32_t>(hasInput) << 16) | (PackImageLayout(mColorFinalLayout) << 12);
+    for(uint32_t i = 0; i < attachments.size(); ++i) {
+        layouts |= PackImageLayout(attachments[i].initialLayout) << (4 * i);
+    }
+    std::tuple<VkFormat, VkFormat, uint32_t, uint32_t> key(colorFormat, depthstencilFormat, ops, layouts);
+
+    auto it = mVkRenderPasses.find(key);
+    if(it != mVkRenderPasses.end()) {
+        mVkRenderPass = it->second;
+        return true;
+    }
+
     VkSubpassDescription subpass;
     subpass.pipelineBindPoint       = mVkPipelineBindPoint;
     subpass.flags                   = 0;
     subpass.colorAttachmentCount    = colorFormat        != VK_FORMAT_UNDEFINED ? 1             : 0;
     subpass.pColorAttachments       = colorFormat        != VK_FORMAT_UNDEFINED ? &color        : nullptr;
     subpass.pDepthStencilAttachment = depthstencilFormat != VK_FORMAT_UNDEFINED ? &depthstencil : nullptr;
-    subpass.pResolveAttachments     = nullptr;
-    subpass.inputAttachmentCount    = 0;
-    subpass.pInputAttachments       = nullptr;
+    subpass.pResolveAttachments     = hasResolve                                ? &resolve      : nullptr;
+    subpass.inputAttachmentCount    = hasInput                                  ? 1             : 0;
+    subpass.pInputAttachments       = hasInput                                  ? &input        : nullptr;
     subpass.preserveAttachmentCount = 0;
     subpass.pPreserveAttachments    = nullptr;
 
+    /// the layout transitions of the pass wait for the earlier writes, transfers and samplings of
+    /// the attachments, and the ones after it wait for its writes. The dependencies are the same
+    /// for all the passes, which keeps them compatible. The passes with the framebuffer fetch add
+    /// the dependency of the subpass on itself, for the barriers between the draws that read their color
+    VkSubpassDependency dependencies[3];
+    dependencies[0].srcSubpass      = VK_SUBPASS_EXTERNAL;
+    dependencies[0].dstSubpass      = 0;
+    dependencies[0].srcStageMask    = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                                      VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT     | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT        |
+                                      VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT         | VK_PIPELINE_STAGE_TRANSFER_BIT;
+    dependencies[0].dstStageMask    = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                                      VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[0].srcAccessMask   = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+    dependencies[0].dstAccessMask   = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                                      VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[0].dependencyFlags = 0;
+
+    dependencies[1].srcSubpass      = 0;
+    dependencies[1].dstSubpass      = VK_SUBPASS_EXTERNAL;
+    dependencies[1].srcStageMask    = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                                      VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[1].dstStageMask    = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                                      VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT     | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT        |
+                                      VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT         | VK_PIPELINE_STAGE_TRANSFER_BIT;
+    dependencies[1].srcAccessMask   = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[1].dstAccessMask   = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                                      VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+                                      VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+    dependencies[1].dependencyFlags = 0;
+
+    dependencies[2].srcSubpass      = 0;
+    dependencies[2].dstSubpass      = 0;
+    dependencies[2].srcStageMask    = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[2].dstStageMask    = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    dependencies[2].srcAccessMask   = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[2].dstAccessMask   = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+    dependencies[2].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
     VkRenderPassCreateInfo info;
     info.sType            = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
     info.pNext            = nullptr;
@@ -138,24 +252,43 @@ RenderPass::Create(VkFormat colorFormat, VkFormat depthstencilFormat)
     info.pAttachments     = attachments.data();
     info.subpassCount     = 1;
     info.pSubpasses       = &subpass;
-    info.dependencyCount  = 0;
-    info.pDependencies    = nullptr;
+    info.dependencyCount  = hasInput ? 3 : 2;
+    info.pDependencies    = dependencies;
 
     VkResult err = vkCreateRenderPass(mVkContext->vkDevice, &info, nullptr, &mVkRenderPass);
     assert(!err);
 
-    return (err != VK_ERROR_OUT_OF_HOST_MEMORY && err != VK_ERROR_OUT_OF_DEVICE_MEMORY);
+    if(err != VK_SUCCESS) {
+        mVkRenderPass = VK_NULL_HANDLE;
+        return false;
+    }
+
+    mVkRenderPasses[key] = mVkRenderPass;
+
+    return true;
 }
 
 
 void
-RenderPass::Begin(VkCommandBuffer *activeCmdBuffer, VkFramebuffer *framebuffer, bool hasSecondary)
+RenderPass::Begin(VkCommandBuffer *activeCmdBuffer, VkFramebuffer *framebuffer, bool hasSecondary,
+                  const vector<VkImageView> *imageViews)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
     VkRenderPassBeginInfo info;
     info.sType                     = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
     info.pNext                     = nullptr;
+#ifdef VK_KHR_imageless_framebuffer
+    // imageless framebuffers are given the image views of this instance of the pass
+    VkRenderPassAttachmentBeginInfoKHR attachmentInfo;
+    if(imageViews) {
+        attachmentInfo.sType           = VK_STRUCTURE_TYPE_RENDER_PASS_ATTACHMENT_BEGIN_INFO_KHR;
+        attachmentInfo.pNext           = nullptr;
+        attachmentInfo.attachmentCount = static_cast<uint32_t>(imageViews->size());
+        attachmentInfo.pAttachments    = imageViews->data();
+        info.pNext                     = &attachmentInfo;
+    }
+#endif // VK_KHR_imageless_framebuffer
     info.framebuffer               = *framebuffer;
     info.renderPass                = mVkRenderPass;
     info.renderArea                = mVkRenderArea;
@@ -164,7 +297,7 @@ RenderPass::Begin(VkCommandBuffer *activeCmdBuffer, VkFramebuffer *framebuffer,
 
     const VkSubpassContents subpassContents = hasSecondary ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE;
 
-    vkCmdBeginRenderPass(*activeCmdBuffer, &info, subpassContents);
+    mVkContext->vkDispatch.vkCmdBeginRenderPass(*activeCmdBuffer, &info, subpassContents);
 
     mStarted = true;
 }
@@ -176,13 +309,75 @@ RenderPass::End(VkCommandBuffer *activeCmdBuffer)
 
     if (mStarted) {
         mStarted = false;
-        vkCmdEndRenderPass(*activeCmdBuffer);
+        mVkContext->vkDispatch.vkCmdEndRenderPass(*activeCmdBuffer);
         return true;
     } else {
         return false;
     }
 }
 
+void
+RenderPass::ClearAttachments(const VkCommandBuffer *activeCmdBuffer,
+                             bool clearColorEnabled, bool clearDepthEnabled, bool clearStencilEnabled,
+                             const float *colorValue, float depthValue, uint32_t stencilValue,
+                             const VkRect2D *rect)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    assert(mStarted);
+
+    uint32_t          attachmentCount = 0;
+    VkClearAttachment attachments[2];
+
+    if(clearColorEnabled && mHasColorAttachment) {
+        attachments[attachmentCount].aspectMask                   = VK_IMAGE_ASPECT_COLOR_BIT;
+        attachments[attachmentCount].colorAttachment              = 0;
+        attachments[attachmentCount].clearValue.color.float32[0]  = colorValue[0];
+        attachments[attachmentCount].clearValue.color.float32[1]  = colorValue[1];
+        attachments[attachmentCount].clearValue.color.float32[2]  = colorValue[2];
+        attachments[attachmentCount].clearValue.color.float32[3]  = colorValue[3];
+        ++attachmentCount;
+    }
+
+    VkImageAspectFlags depthStencilAspect = 0;
+    if(clearDepthEnabled && mHasDepthAttachment) {
+        depthStencilAspect |= VK_IMAGE_ASPECT_DEPTH_BIT;
+    }
+    if(clearStencilEnabled && mHasStencilAttachment) {
+        depthStencilAspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+    }
+
+    if(depthStencilAspect) {
+        attachments[attachmentCount].aspectMask                      = depthStencilAspect;
+        attachments[attachmentCount].colorAttachment                 = 0;
+        attachments[attachmentCount].clearValue.depthStencil.depth   = depthValue;
+        attachments[attachmentCount].clearValue.depthStencil.stencil = stencilValue;
+        ++attachmentCount;
+    }
+
+    if(!attachmentCount) {
+        return;
+    }
+
+    VkClearRect clearRect;
+    clearRect.rect           = *rect;
+    clearRect.baseArrayLayer = 0;
+    clearRect.layerCount     = 1;
+
+    mVkContext->vkDispatch.vkCmdClearAttachments(*activeCmdBuffer, attachmentCount, attachments, 1, &clearRect);
+}
+
+bool
+RenderPass::IsInRenderArea(const VkRect2D *rect) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    return rect->offset.x >= mVkRenderArea.offset.x &&
+           rect->offset.y >= mVkRenderArea.offset.y &&
+           rect->offset.x + static_cast<int64_t>(rect->extent.width)  <= mVkRenderArea.offset.x + static_cast<int64_t>(mVkRenderArea.extent.width) &&
+           rect->offset.y + static_cast<int64_t>(rect->extent.height) <= mVkRenderArea.offset.y + static_cast<int64_t>(mVkRenderArea.extent.height);
+}
+
 void
 RenderPass::SetClearArea(const VkRect2D *rect)
 {
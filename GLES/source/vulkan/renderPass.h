@@ -24,6 +24,8 @@
 #ifndef __VKRENDERPASS_H__
 #define __VKRENDERPASS_H__
 
+#include <map>
+#include <tuple>
 #include "context.h"
 
 namespace vulkanAPI {
@@ -38,6 +40,11 @@ private:
     const
     VkPipelineBindPoint     mVkPipelineBindPoint;
     VkRenderPass            mVkRenderPass;
+
+    /// render passes built so far, keyed on their formats, sample count and load/store ops.
+    /// All of them share a compatibility class per format pair and sample count, so
+    /// the framebuffers and pipelines created against one work with the others
+    std::map<std::tuple<VkFormat, VkFormat, uint32_t, uint32_t>, VkRenderPass> mVkRenderPasses;
     VkClearValue            mVkClearValues[2];
     VkRect2D                mVkRenderArea;
 
@@ -48,9 +55,37 @@ private:
     VkBool32                mColorWriteEnabled;
     VkBool32                mDepthWriteEnabled;
     VkBool32                mStencilWriteEnabled;
+    /// depth/stencil contents are dropped at the end of the pass
+    VkBool32                mDepthStencilTransient;
+    /// multisampled color contents are dropped at the end of the pass, after they are resolved
+    VkBool32                mColorTransient;
+
+    /// contents that are undefined when the pass begins, so they are not loaded
+    VkBool32                mColorInvalidated;
+    VkBool32                mDepthInvalidated;
+    VkBool32                mStencilInvalidated;
 
     VkBool32                mStarted;
 
+    VkFormat                mColorFormat;
+    VkFormat                mDepthStencilFormat;
+    /// multisampled passes resolve their color attachment into the single sampled one that follows the depth/stencil
+    VkSampleCountFlagBits   mSampleCount;
+
+    VkBool32                mHasColorAttachment;
+    VkBool32                mHasDepthAttachment;
+    VkBool32                mHasStencilAttachment;
+
+    /// layouts the attachments are in when the pass begins, and the one the color is left in,
+    /// so that the pass performs the transitions instead of separate barriers
+    VkImageLayout           mColorInitialLayout;
+    VkImageLayout           mDepthStencilInitialLayout;
+    VkImageLayout           mResolveInitialLayout;
+    VkImageLayout           mColorFinalLayout;
+
+    /// the color attachment is also the input attachment of the framebuffer fetch, which makes the pass incompatible with the others
+    bool                    mFramebufferFetch;
+
 public:
 
 // Constructor
@@ -60,10 +95,17 @@ public:
     ~RenderPass();
 
 // Begin/End functions
-    void                    Begin   (VkCommandBuffer *activeCmdBuffer, VkFramebuffer *framebuffer, bool hasSecondary);
+    void                    Begin   (VkCommandBuffer *activeCmdBuffer, VkFramebuffer *framebuffer, bool hasSecondary,
+                                     const vector<VkImageView> *imageViews = nullptr);
 
     bool                    End     (VkCommandBuffer *activeCmdBuffer);
 
+// Clear functions
+    void                    ClearAttachments(const VkCommandBuffer *activeCmdBuffer,
+                                             bool clearColorEnabled, bool clearDepthEnabled, bool clearStencilEnabled,
+                                             const float *colorValue, float depthValue, uint32_t stencilValue,
+                                             const VkRect2D *rect);
+
 // Create functions
     bool                    Create  (VkFormat colorFormat, VkFormat depthstencilFormat);
 
@@ -77,7 +119,22 @@ public:
     inline VkBool32         GetColorWriteEnabled(void)                    const { FUN_ENTRY(GL_LOG_TRACE); return mColorWriteEnabled;   }
     inline VkBool32         GetDepthWriteEnabled(void)                    const { FUN_ENTRY(GL_LOG_TRACE); return mDepthWriteEnabled;   }
     inline VkBool32         GetStencilWriteEnabled(void)                  const { FUN_ENTRY(GL_LOG_TRACE); return mStencilWriteEnabled; }
+    inline VkBool32         GetColorInvalidated(void)                     const { FUN_ENTRY(GL_LOG_TRACE); return mColorInvalidated;    }
+    inline VkBool32         GetDepthInvalidated(void)                     const { FUN_ENTRY(GL_LOG_TRACE); return mDepthInvalidated;    }
+    inline VkBool32         GetStencilInvalidated(void)                   const { FUN_ENTRY(GL_LOG_TRACE); return mStencilInvalidated;  }
     inline VkRenderPass*    GetRenderPass(void)                                 { FUN_ENTRY(GL_LOG_TRACE); return &mVkRenderPass; }
+    inline VkFormat         GetColorFormat(void)                          const { FUN_ENTRY(GL_LOG_TRACE); return mColorFormat; }
+    inline VkFormat         GetDepthStencilFormat(void)                   const { FUN_ENTRY(GL_LOG_TRACE); return mDepthStencilFormat; }
+    inline VkSampleCountFlagBits GetSampleCount(void)                     const { FUN_ENTRY(GL_LOG_TRACE); return mSampleCount; }
+    inline VkImageLayout    GetColorInitialLayout(void)                   const { FUN_ENTRY(GL_LOG_TRACE); return mColorInitialLayout; }
+    inline VkImageLayout    GetDepthStencilInitialLayout(void)            const { FUN_ENTRY(GL_LOG_TRACE); return mDepthStencilInitialLayout; }
+    inline VkImageLayout    GetResolveInitialLayout(void)                 const { FUN_ENTRY(GL_LOG_TRACE); return mResolveInitialLayout; }
+    inline VkImageLayout    GetColorFinalLayout(void)                     const { FUN_ENTRY(GL_LOG_TRACE); return mColorFinalLayout; }
+    inline bool             GetFramebufferFetch(void)                     const { FUN_ENTRY(GL_LOG_TRACE); return mFramebufferFetch; }
+
+// Is Functions
+    inline bool             IsStarted(void)                               const { FUN_ENTRY(GL_LOG_TRACE); return mStarted; }
+           bool             IsInRenderArea(const VkRect2D *rect)          const;
 
 // Set Functions
     inline void             SetVkContext(const vkContext_t *vkContext)          { FUN_ENTRY(GL_LOG_TRACE); mVkContext           = vkContext; }
@@ -87,6 +144,18 @@ public:
     inline void             SetColorWriteEnabled(VkBool32 enable)               { FUN_ENTRY(GL_LOG_TRACE); mColorWriteEnabled   = enable;    }
     inline void             SetDepthWriteEnabled(VkBool32 enable)               { FUN_ENTRY(GL_LOG_TRACE); mDepthWriteEnabled   = enable;    }
     inline void             SetStencilWriteEnabled(VkBool32 enable)             { FUN_ENTRY(GL_LOG_TRACE); mStencilWriteEnabled = enable;    }
+    inline void             SetDepthStencilTransient(VkBool32 transient)        { FUN_ENTRY(GL_LOG_TRACE); mDepthStencilTransient = transient; }
+    inline void             SetColorTransient(VkBool32 transient)               { FUN_ENTRY(GL_LOG_TRACE); mColorTransient     = transient;   }
+    inline void             SetSampleCount(VkSampleCountFlagBits samples)       { FUN_ENTRY(GL_LOG_TRACE); mSampleCount        = samples;     }
+    inline void             SetColorInvalidated(VkBool32 invalidated)           { FUN_ENTRY(GL_LOG_TRACE); mColorInvalidated   = invalidated; }
+    inline void             SetDepthInvalidated(VkBool32 invalidated)           { FUN_ENTRY(GL_LOG_TRACE); mDepthInvalidated   = invalidated; }
+    inline void             SetStencilInvalidated(VkBool32 invalidated)         { FUN_ENTRY(GL_LOG_TRACE); mStencilInvalidated = invalidated; }
+    inline void             SetInitialLayouts(VkImageLayout color, VkImageLayout depthStencil,
+                                              VkImageLayout resolve)            { FUN_ENTRY(GL_LOG_TRACE); mColorInitialLayout = color;
+                                                                                                           mDepthStencilInitialLayout = depthStencil;
+                                                                                                           mResolveInitialLayout = resolve; }
+    inline void             SetColorFinalLayout(VkImageLayout layout)           { FUN_ENTRY(GL_LOG_TRACE); mColorFinalLayout   = layout;      }
+    inline void             SetFramebufferFetch(bool enable)                    { FUN_ENTRY(GL_LOG_TRACE); mFramebufferFetch   = enable;      }
 
            void             SetClearArea(const VkRect2D *rect);
            void             SetClearColorValue(const float *value);
@@ -0,0 +1,187 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       ringBuffer.cpp
+ *  @author     Think Silicon
+ *  @date       14/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Persistently mapped per-frame linear sub-allocator of a Vulkan Buffer
+ *
+ *  @section
+ *
+ *  A single host visible buffer is split into one region per frame in flight.
+ *  Allocations bump a head pointer inside the region of the frame currently
+ *  being recorded and are returned as a pointer into the persistent mapping
+ *  along with their offset in the buffer. When the frame's command buffer is
+ *  waited upon, its region is rewound and reused, so the data never has to be
+ *  freed individually. The epoch changes on every rewind and lets callers tell
+ *  whether an earlier allocation is still valid. Small uploads are also keyed
+ *  on their contents, so identical data is written only once per frame.
+ *
+ */
+
+#include "ringBuffer.h"
+
+namespace vulkanAPI {
+
+std::atomic<uint64_t> RingBuffer::mEpochCounter(1);
+
+RingBuffer::RingBuffer(const vkContext_t *vkContext, VkBufferUsageFlags vkBufferUsageFlags)
+: mVkContext(vkContext),
+  mBuffer(vkContext, vkBufferUsageFlags, VK_SHARING_MODE_EXCLUSIVE),
+  mMemory(vkContext, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT),
+  mMappedData(nullptr), mFrameCount(0), mFrameSize(0), mAlignment(1), mHead(0), mFrameEnd(0), mEpoch(1), mDeferred(false)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    mMemory.SetCategory(MemoryAllocator::CATEGORY_STREAM);
+}
+
+RingBuffer::~RingBuffer()
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    Release();
+}
+
+void
+RingBuffer::Release(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(mMappedData) {
+        mMemory.Unmap();
+        mMappedData = nullptr;
+    }
+
+    mBuffer.Release();
+    mMemory.Release();
+
+    mFrameCount = 0;
+    mFrameSize  = 0;
+    mHead       = 0;
+    mFrameEnd   = 0;
+    mDeferred   = false;
+    mSharedUploads.clear();
+}
+
+bool
+RingBuffer::Create(uint32_t frameCount, VkDeviceSize frameSize, VkDeviceSize alignment, bool deferred)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    Release();
+
+    mFrameCount = frameCount;
+    mAlignment  = alignment ? alignment : 1;
+    mFrameSize  = (frameSize + mAlignment - 1) / mAlignment * mAlignment;
+    mDeferred   = deferred;
+
+    SetActiveFrame(0);
+
+    return mDeferred || CreateMemory();
+}
+
+bool
+RingBuffer::CreateMemory(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    mDeferred = false;
+    mBuffer.SetSize(mFrameSize * mFrameCount);
+
+    if(!mBuffer.Create()                                           ||
+       !mMemory.GetBufferMemoryRequirements(mBuffer.GetVkBuffer()) ||
+       !mMemory.Create()                                           ||
+       !mMemory.BindBufferMemory(mBuffer.GetVkBuffer())) {
+        mBuffer.Release();
+        mMemory.Release();
+        return false;
+    }
+
+    mMappedData = static_cast<uint8_t *>(mMemory.Map());
+    if(!mMappedData) {
+        mBuffer.Release();
+        mMemory.Release();
+        return false;
+    }
+
+    return true;
+}
+
+uint8_t *
+RingBuffer::Allocate(VkDeviceSize size, uint32_t *offset)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(mDeferred && !CreateMemory()) {
+        return nullptr;
+    }
+
+    VkDeviceSize head = (mHead + mAlignment - 1) / mAlignment * mAlignment;
+    if(!mMappedData || head + size > mFrameEnd) {
+        return nullptr;
+    }
+
+    mHead   = head + size;
+    *offset = static_cast<uint32_t>(head);
+
+    return mMappedData + head;
+}
+
+bool
+RingBuffer::Upload(const void *data, VkDeviceSize size, uint32_t *offset)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    /// identical small blocks, such as the same camera data used by several
+    /// programs, share a single copy within the frame
+    std::string key;
+    if(size <= GLOVE_UNIFORM_RING_SHARE_MAX_SIZE) {
+        key.assign(static_cast<const char *>(data), static_cast<size_t>(size));
+
+        auto it = mSharedUploads.find(key);
+        if(it != mSharedUploads.end()) {
+            *offset = it->second;
+            return true;
+        }
+    }
+
+    uint8_t *dst = Allocate(size, offset);
+    if(!dst) {
+        return false;
+    }
+    memcpy(dst, data, static_cast<size_t>(size));
+
+    if(!key.empty()) {
+        mSharedUploads[key] = *offset;
+    }
+
+    return true;
+}
+
+void
+RingBuffer::SetActiveFrame(uint32_t frame)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    mSharedUploads.clear();
+
+    mHead     = mFrameSize * frame;
+    mFrameEnd = mHead + mFrameSize;
+    mEpoch    = ++mEpochCounter;
+}
+
+}
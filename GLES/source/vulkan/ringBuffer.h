@@ -0,0 +1,103 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       ringBuffer.h
+ *  @author     Think Silicon
+ *  @date       14/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Persistently mapped per-frame linear sub-allocator of a Vulkan Buffer
+ *
+ */
+
+#ifndef __VKRINGBUFFER_H__
+#define __VKRINGBUFFER_H__
+
+#include "buffer.h"
+#include "memory.h"
+#include <atomic>
+#include <string>
+#include <unordered_map>
+
+#ifndef GLOVE_UNIFORM_RING_FRAME_SIZE
+#define GLOVE_UNIFORM_RING_FRAME_SIZE                   (1 << 20)
+#endif // GLOVE_UNIFORM_RING_FRAME_SIZE
+
+#ifndef GLOVE_STREAM_RING_FRAME_SIZE
+#define GLOVE_STREAM_RING_FRAME_SIZE                    (4 << 20)
+#endif // GLOVE_STREAM_RING_FRAME_SIZE
+
+#ifndef GLOVE_UNIFORM_RING_SHARE_MAX_SIZE
+#define GLOVE_UNIFORM_RING_SHARE_MAX_SIZE               256
+#endif // GLOVE_UNIFORM_RING_SHARE_MAX_SIZE
+
+namespace vulkanAPI {
+
+class RingBuffer {
+
+private:
+
+    const
+    vkContext_t *                     mVkContext;
+
+    Buffer                            mBuffer;
+    Memory                            mMemory;
+    uint8_t *                         mMappedData;
+
+    uint32_t                          mFrameCount;
+    VkDeviceSize                      mFrameSize;
+    VkDeviceSize                      mAlignment;
+    VkDeviceSize                      mHead;
+    VkDeviceSize                      mFrameEnd;
+    uint64_t                          mEpoch;
+    /// epochs are unique across the rings, so that an allocation is never taken for one of another ring
+    static std::atomic<uint64_t>      mEpochCounter;
+    /// the memory of a deferred ring is allocated on its first allocation, and tried only once
+    bool                              mDeferred;
+
+    /// offsets of the small uploads of the active frame, keyed on their contents
+    std::unordered_map<std::string, uint32_t> mSharedUploads;
+
+public:
+// Constructor
+    RingBuffer(const vkContext_t *vkContext, VkBufferUsageFlags vkBufferUsageFlags);
+
+// Destructor
+    ~RingBuffer();
+
+// Create Functions
+    bool                              Create(uint32_t frameCount, VkDeviceSize frameSize, VkDeviceSize alignment, bool deferred = false);
+
+private:
+    bool                              CreateMemory(void);
+
+public:
+// Release Functions
+    void                              Release(void);
+
+// Allocate Functions
+    uint8_t *                         Allocate(VkDeviceSize size, uint32_t *offset);
+    bool                              Upload(const void *data, VkDeviceSize size, uint32_t *offset);
+
+// Get Functions
+    inline VkBuffer                   GetVkBuffer(void)                         { FUN_ENTRY(GL_LOG_TRACE); return mBuffer.GetVkBuffer(); }
+    inline uint64_t                   GetEpoch(void)                    const   { FUN_ENTRY(GL_LOG_TRACE); return mEpoch;                }
+
+// Set Functions
+    void                              SetActiveFrame(uint32_t frame);
+};
+
+}
+
+#endif // __VKRINGBUFFER_H__
@@ -28,6 +28,8 @@
  */
 
 #include "sampler.h"
+#include "samplerCache.h"
+#include "commandBundle.h"
 
 namespace vulkanAPI {
 
@@ -62,7 +64,9 @@ Sampler::Release(void)
     FUN_ENTRY(GL_LOG_DEBUG);
 
     if(mVkSampler != VK_NULL_HANDLE) {
-        vkDestroySampler(mVkContext->vkDevice, mVkSampler, nullptr);
+        // the sampler may be shared, but the texture no longer samples with it
+        CommandBundle::Retire(CommandBundle::GetHandleKey(mVkSampler));
+        mVkContext->vkSamplerCache->Release(mVkSampler);
         mVkSampler = VK_NULL_HANDLE;
     }
 
@@ -78,8 +82,6 @@ Sampler::Create()
         return true;
     }
 
-    Release();
-
     VkSamplerCreateInfo samplerInfo;
     samplerInfo.sType                   = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
     samplerInfo.pNext                   = nullptr;
@@ -102,12 +104,20 @@ Sampler::Create()
     samplerInfo.borderColor             = mVkBorderColor;
     samplerInfo.unnormalizedCoordinates = mUnnormalizedCoordinates;
 
-    VkResult err = vkCreateSampler(mVkContext->vkDevice, &samplerInfo, nullptr, &mVkSampler);
-    assert(!err);
+    // samplers with the same state are shared across the device, the previous one is dropped after
+    // the new one is acquired so that a sampler used by this texture alone is not rebuilt in between
+    VkSampler sampler = mVkContext->vkSamplerCache->Acquire(&samplerInfo);
+    if(sampler == mVkSampler) {
+        // the state is as before, so the draws that sample with it are still current
+        mVkContext->vkSamplerCache->Release(sampler);
+    } else {
+        Release();
+    }
+    mVkSampler = sampler;
 
     mUpdated = false;
 
-    return (err != VK_ERROR_OUT_OF_HOST_MEMORY && err != VK_ERROR_OUT_OF_DEVICE_MEMORY && err != VK_ERROR_TOO_MANY_OBJECTS);
+    return mVkSampler != VK_NULL_HANDLE;
 }
 
 }
@@ -25,10 +25,11 @@
 #define __VKSAMPLER_H__
 
 #include "context.h"
+#include "utils/objectPool.h"
 
 namespace vulkanAPI {
 
-class Sampler {
+class Sampler : public PooledObject {
 
 private:
 
@@ -0,0 +1,151 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       samplerCache.cpp
+ *  @author     Think Silicon
+ *  @date       14/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Device-wide sharing of Vulkan samplers with the same state
+ *
+ *  @section
+ *
+ *  Every texture carries its own sampler state, yet applications use only a
+ *  handful of filter and wrap combinations, while a device may allow as few
+ *  as maxSamplerAllocationCount (4000) live samplers. Textures with the same
+ *  state therefore share one VkSampler, counted by the number of them that
+ *  refer to it. A sampler no longer referred to is kept, so that toggling a
+ *  texture parameter back and forth does not create new ones, until more than
+ *  GLOVE_VK_MAX_UNUSED_SAMPLERS of them pile up.
+ *
+ */
+
+#include "samplerCache.h"
+#include <cstddef>
+
+namespace vulkanAPI {
+
+SamplerCache::SamplerCache(const vkContext_t *vkContext)
+: mVkContext(vkContext), mUnusedCount(0)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+}
+
+SamplerCache::~SamplerCache()
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    for(auto &entry : mVkSamplers) {
+        vkDestroySampler(mVkContext->vkDevice, entry.second.sampler, nullptr);
+    }
+    mVkSamplers.clear();
+    mKeys.clear();
+}
+
+void
+SamplerCache::TrimLocked(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    for(auto it = mVkSamplers.begin(); it != mVkSamplers.end();) {
+        if(it->second.refCount) {
+            ++it;
+            continue;
+        }
+
+        vkDestroySampler(mVkContext->vkDevice, it->second.sampler, nullptr);
+        mKeys.erase(it->second.sampler);
+        it = mVkSamplers.erase(it);
+    }
+    mUnusedCount = 0;
+}
+
+VkSampler
+SamplerCache::Acquire(const VkSamplerCreateInfo *info)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the state runs from flags to unnormalizedCoordinates, leaving out pNext and the trailing padding
+    const size_t begin = offsetof(VkSamplerCreateInfo, flags);
+    const size_t end   = offsetof(VkSamplerCreateInfo, unnormalizedCoordinates) + sizeof(info->unnormalizedCoordinates);
+    const std::string key(reinterpret_cast<const char *>(info) + begin, end - begin);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    auto it = mVkSamplers.find(key);
+    if(it != mVkSamplers.end()) {
+        if(!it->second.refCount++) {
+            --mUnusedCount;
+        }
+        return it->second.sampler;
+    }
+
+    VkSampler sampler = VK_NULL_HANDLE;
+    VkResult err = vkCreateSampler(mVkContext->vkDevice, info, nullptr, &sampler);
+    if(err == VK_ERROR_TOO_MANY_OBJECTS && mUnusedCount) {
+        TrimLocked();
+        err = vkCreateSampler(mVkContext->vkDevice, info, nullptr, &sampler);
+    }
+    assert(!err);
+
+    if(err != VK_SUCCESS) {
+        return VK_NULL_HANDLE;
+    }
+
+    samplerEntry_t &entry = mVkSamplers[key];
+    entry.sampler  = sampler;
+    entry.refCount = 1;
+    mKeys[sampler] = key;
+
+    return sampler;
+}
+
+bool
+SamplerCache::Retain(VkSampler sampler)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    auto key = mKeys.find(sampler);
+    if(key == mKeys.end()) {
+        return false;
+    }
+
+    if(!mVkSamplers[key->second].refCount++) {
+        --mUnusedCount;
+    }
+
+    return true;
+}
+
+void
+SamplerCache::Release(VkSampler sampler)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    auto key = mKeys.find(sampler);
+    if(key == mKeys.end()) {
+        return;
+    }
+
+    samplerEntry_t &entry = mVkSamplers[key->second];
+    if(--entry.refCount == 0 && ++mUnusedCount > GLOVE_VK_MAX_UNUSED_SAMPLERS) {
+        TrimLocked();
+    }
+}
+
+}
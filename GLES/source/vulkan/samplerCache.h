@@ -0,0 +1,77 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       samplerCache.h
+ *  @author     Think Silicon
+ *  @date       14/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Device-wide sharing of Vulkan samplers with the same state
+ *
+ */
+
+#ifndef __VKSAMPLERCACHE_H__
+#define __VKSAMPLERCACHE_H__
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "context.h"
+
+/// samplers no texture refers to any more, kept for the state to be asked for again
+#ifndef GLOVE_VK_MAX_UNUSED_SAMPLERS
+#define GLOVE_VK_MAX_UNUSED_SAMPLERS                    64
+#endif // GLOVE_VK_MAX_UNUSED_SAMPLERS
+
+namespace vulkanAPI {
+
+class SamplerCache {
+
+private:
+    typedef struct samplerEntry_t {
+        VkSampler                     sampler;
+        uint32_t                      refCount;
+    } samplerEntry_t;
+
+    const
+    vkContext_t *                     mVkContext;
+
+    std::mutex                        mMutex;
+    /// VkSampler objects keyed on the create info they were built with
+    std::unordered_map<std::string, samplerEntry_t> mVkSamplers;
+    std::unordered_map<VkSampler, std::string>      mKeys;
+    uint32_t                          mUnusedCount;
+
+    void                              TrimLocked(void);
+
+public:
+// Constructor
+    explicit SamplerCache(const vkContext_t *vkContext);
+
+// Destructor
+    ~SamplerCache();
+
+// Acquire Functions
+    VkSampler                         Acquire(const VkSamplerCreateInfo *info);
+
+    /// one more reference to a sampler of the cache, false when it did not come from it
+    bool                              Retain(VkSampler sampler);
+
+// Release Functions
+    void                              Release(VkSampler sampler);
+};
+
+}
+
+#endif // __VKSAMPLERCACHE_H__
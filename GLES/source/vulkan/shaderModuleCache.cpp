@@ -0,0 +1,136 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       shaderModuleCache.cpp
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Device-wide sharing of Vulkan shader modules with the same SPIR-V
+ *
+ *  @section
+ *
+ *  Applications often build hundreds of programs out of a few shaders, e.g.
+ *  one vertex shader for every material, and the SPIR-V a stage links to is
+ *  then the same for many of them. Programs therefore share one
+ *  VkShaderModule per SPIR-V, counted by the number of program stages that
+ *  refer to it, so that the driver translates it once. A module no longer
+ *  referred to is kept, so that relinking a program does not create it again,
+ *  until more than GLOVE_VK_MAX_UNUSED_SHADER_MODULES of them pile up.
+ *
+ */
+
+#include "shaderModuleCache.h"
+#include "utils/shaderStats.h"
+
+namespace vulkanAPI {
+
+ShaderModuleCache::ShaderModuleCache(const vkContext_t *vkContext)
+: mVkContext(vkContext), mUnusedCount(0)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+}
+
+ShaderModuleCache::~ShaderModuleCache()
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    for(auto &entry : mVkShaderModules) {
+        vkDestroyShaderModule(mVkContext->vkDevice, entry.second.module, nullptr);
+    }
+    mVkShaderModules.clear();
+    mKeys.clear();
+}
+
+void
+ShaderModuleCache::TrimLocked(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    for(auto it = mVkShaderModules.begin(); it != mVkShaderModules.end();) {
+        if(it->second.refCount) {
+            ++it;
+            continue;
+        }
+
+        vkDestroyShaderModule(mVkContext->vkDevice, it->second.module, nullptr);
+        mKeys.erase(it->second.module);
+        it = mVkShaderModules.erase(it);
+    }
+    mUnusedCount = 0;
+}
+
+VkShaderModule
+ShaderModuleCache::Acquire(const uint32_t *spirv, size_t spirvSize)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!spirvSize) {
+        return VK_NULL_HANDLE;
+    }
+
+    const std::string key(reinterpret_cast<const char *>(spirv), spirvSize * sizeof(uint32_t));
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    auto it = mVkShaderModules.find(key);
+    if(it != mVkShaderModules.end()) {
+        if(!it->second.refCount++) {
+            --mUnusedCount;
+        }
+        return it->second.module;
+    }
+
+    VkShaderModuleCreateInfo moduleCreateInfo;
+    moduleCreateInfo.sType    = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    moduleCreateInfo.pNext    = nullptr;
+    moduleCreateInfo.flags    = 0;
+    moduleCreateInfo.codeSize = spirvSize * sizeof(uint32_t);
+    moduleCreateInfo.pCode    = spirv;
+
+    VkShaderModule module = VK_NULL_HANDLE;
+    {
+        GLOVE_SHADER_STAGE(SHADER_STAGE_CREATE_MODULE);
+        if(vkCreateShaderModule(mVkContext->vkDevice, &moduleCreateInfo, nullptr, &module) != VK_SUCCESS) {
+            return VK_NULL_HANDLE;
+        }
+    }
+
+    moduleEntry_t &entry = mVkShaderModules[key];
+    entry.module   = module;
+    entry.refCount = 1;
+    mKeys[module]  = key;
+
+    return module;
+}
+
+void
+ShaderModuleCache::Release(VkShaderModule module)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    auto key = mKeys.find(module);
+    if(key == mKeys.end()) {
+        return;
+    }
+
+    moduleEntry_t &entry = mVkShaderModules[key->second];
+    if(--entry.refCount == 0 && ++mUnusedCount > GLOVE_VK_MAX_UNUSED_SHADER_MODULES) {
+        TrimLocked();
+    }
+}
+
+}
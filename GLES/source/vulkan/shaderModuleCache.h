@@ -0,0 +1,74 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       shaderModuleCache.h
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Device-wide sharing of Vulkan shader modules with the same SPIR-V
+ *
+ */
+
+#ifndef __VKSHADERMODULECACHE_H__
+#define __VKSHADERMODULECACHE_H__
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "context.h"
+
+/// modules no program refers to any more, kept for the same stage to be linked again
+#ifndef GLOVE_VK_MAX_UNUSED_SHADER_MODULES
+#define GLOVE_VK_MAX_UNUSED_SHADER_MODULES              32
+#endif // GLOVE_VK_MAX_UNUSED_SHADER_MODULES
+
+namespace vulkanAPI {
+
+class ShaderModuleCache {
+
+private:
+    typedef struct moduleEntry_t {
+        VkShaderModule                module;
+        uint32_t                      refCount;
+    } moduleEntry_t;
+
+    const
+    vkContext_t *                     mVkContext;
+
+    std::mutex                        mMutex;
+    /// VkShaderModule objects keyed on the SPIR-V they were built from
+    std::unordered_map<std::string, moduleEntry_t>  mVkShaderModules;
+    std::unordered_map<VkShaderModule, std::string> mKeys;
+    uint32_t                          mUnusedCount;
+
+    void                              TrimLocked(void);
+
+public:
+// Constructor
+    explicit ShaderModuleCache(const vkContext_t *vkContext);
+
+// Destructor
+    ~ShaderModuleCache();
+
+// Acquire Functions
+    VkShaderModule                    Acquire(const uint32_t *spirv, size_t spirvSize);
+
+// Release Functions
+    void                              Release(VkShaderModule module);
+};
+
+}
+
+#endif // __VKSHADERMODULECACHE_H__
@@ -0,0 +1,179 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       submissionQueue.cpp
+ *  @author     Think Silicon
+ *  @date       14/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Lock-free serialization of queue submissions from multiple threads in Vulkan
+ *
+ *  @section
+ *
+ *  Access to a VkQueue must be externally synchronized, while contexts that
+ *  are current on different threads share the device queues. Each context
+ *  records in its own command pools, so only the submission itself needs to
+ *  be serialized.
+ *
+ *  Submitting threads push their request on a lock-free list. The thread
+ *  that finds no submission in progress becomes the combiner: it takes the
+ *  whole list and submits every request in arrival order on behalf of its
+ *  owners, which merely wait for their request to be marked as done. No
+ *  thread ever sleeps on a lock, and a thread's submissions keep their
+ *  recording order as each one returns only after it reached the queue.
+ *
+ *  Presentation from EGL goes through the same list, since the window
+ *  system may present on the queue from any thread as well.
+ *
+ *  A run of consecutive submissions to the same queue, of which only the
+ *  last one signals a fence, is merged into a single vkQueueSubmit with all
+ *  their VkSubmitInfos, as the ioctl behind each call is costly on some
+ *  mobile kernels. The batches keep their order within the call, so the
+ *  semaphores signalled by a batch may still be waited upon by the later
+ *  ones, and the fence, signalled once every batch of the call completed,
+ *  still covers the work of its own request. Presentation ends a run.
+ *
+ */
+
+#include "submissionQueue.h"
+#include <thread>
+
+namespace vulkanAPI {
+
+SubmissionQueue::SubmissionQueue(const vkDeviceDispatch_t *vkDispatch)
+: mVkDispatch(vkDispatch), mPendingRequests(nullptr)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    mCombining.clear();
+}
+
+SubmissionQueue::~SubmissionQueue()
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    assert(mPendingRequests.load() == nullptr);
+}
+
+VkResult
+SubmissionQueue::Submit(VkQueue queue, uint32_t submitCount, const VkSubmitInfo *submits, VkFence fence)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    request_t request;
+    request.queue        = queue;
+    request.submitCount  = submitCount;
+    request.submits      = submits;
+    request.fence        = fence;
+    request.presentInfo  = nullptr;
+    request.queuePresent = nullptr;
+
+    return Enqueue(&request);
+}
+
+VkResult
+SubmissionQueue::Present(VkQueue queue, const VkPresentInfoKHR *presentInfo, PFN_vkQueuePresentKHR queuePresent)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    request_t request;
+    request.queue        = queue;
+    request.submitCount  = 0;
+    request.submits      = nullptr;
+    request.fence        = VK_NULL_HANDLE;
+    request.presentInfo  = presentInfo;
+    request.queuePresent = queuePresent;
+
+    return Enqueue(&request);
+}
+
+VkResult
+SubmissionQueue::Enqueue(request_t *request)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    request->result = VK_SUCCESS;
+    request->done.store(false, std::memory_order_relaxed);
+    request->next   = mPendingRequests.load(std::memory_order_relaxed);
+
+    while(!mPendingRequests.compare_exchange_weak(request->next, request,
+                                                  std::memory_order_release,
+                                                  std::memory_order_relaxed)) {
+    }
+
+    while(!request->done.load(std::memory_order_acquire)) {
+        if(!mCombining.test_and_set(std::memory_order_acquire)) {
+            Combine();
+            mCombining.clear(std::memory_order_release);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    return request->result;
+}
+
+void
+SubmissionQueue::Combine(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    request_t *pending = mPendingRequests.exchange(nullptr, std::memory_order_acquire);
+
+    // the list is pushed at its head, restore the arrival order
+    request_t *ordered = nullptr;
+    while(pending) {
+        request_t *next = pending->next;
+        pending->next   = ordered;
+        ordered         = pending;
+        pending         = next;
+    }
+
+    while(ordered) {
+        if(ordered->presentInfo) {
+            // the owner may return as soon as its request is done
+            request_t *next = ordered->next;
+            ordered->result = ordered->queuePresent(ordered->queue, ordered->presentInfo);
+            ordered->done.store(true, std::memory_order_release);
+            ordered = next;
+            continue;
+        }
+
+        request_t *last = ordered;
+        while(last->fence == VK_NULL_HANDLE && last->next && !last->next->presentInfo && last->next->queue == ordered->queue) {
+            last = last->next;
+        }
+        request_t *end = last->next;
+
+        VkResult result;
+        if(last == ordered) {
+            result = mVkDispatch->vkQueueSubmit(ordered->queue, ordered->submitCount, ordered->submits, ordered->fence);
+        } else {
+            mBatch.clear();
+            for(request_t *request = ordered; request != end; request = request->next) {
+                mBatch.insert(mBatch.end(), request->submits, request->submits + request->submitCount);
+            }
+            result = mVkDispatch->vkQueueSubmit(ordered->queue, static_cast<uint32_t>(mBatch.size()), mBatch.data(), last->fence);
+        }
+
+        while(ordered != end) {
+            request_t *next = ordered->next;
+            ordered->result = result;
+            ordered->done.store(true, std::memory_order_release);
+            ordered = next;
+        }
+    }
+}
+
+}
@@ -0,0 +1,75 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       submissionQueue.h
+ *  @author     Think Silicon
+ *  @date       14/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Lock-free serialization of queue submissions from multiple threads in Vulkan
+ *
+ */
+
+#ifndef __VKSUBMISSIONQUEUE_H__
+#define __VKSUBMISSIONQUEUE_H__
+
+#include <atomic>
+#include <vector>
+#include "utils/glLogger.h"
+#include "vulkan/vulkan.h"
+#include "dispatch.h"
+
+namespace vulkanAPI {
+
+class SubmissionQueue {
+
+private:
+
+    typedef struct request_t {
+        VkQueue                       queue;
+        uint32_t                      submitCount;
+        const VkSubmitInfo           *submits;
+        VkFence                       fence;
+        /// set for a presentation request, which is serialized with the submissions
+        const VkPresentInfoKHR       *presentInfo;
+        PFN_vkQueuePresentKHR         queuePresent;
+        VkResult                      result;
+        std::atomic<bool>             done;
+        request_t                    *next;
+    } request_t;
+
+    const vkDeviceDispatch_t *        mVkDispatch;
+    std::atomic<request_t *>          mPendingRequests;
+    std::atomic_flag                  mCombining;
+    /// the VkSubmitInfos of a merged run, only touched by the combiner
+    std::vector<VkSubmitInfo>         mBatch;
+
+    VkResult                          Enqueue(request_t *request);
+    void                              Combine(void);
+
+public:
+// Constructor
+    explicit SubmissionQueue(const vkDeviceDispatch_t *vkDispatch);
+
+// Destructor
+    ~SubmissionQueue();
+
+// Submit Functions
+    VkResult                          Submit(VkQueue queue, uint32_t submitCount, const VkSubmitInfo *submits, VkFence fence);
+    VkResult                          Present(VkQueue queue, const VkPresentInfoKHR *presentInfo, PFN_vkQueuePresentKHR queuePresent);
+};
+
+}
+
+#endif // __VKSUBMISSIONQUEUE_H__
@@ -0,0 +1,159 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       timeline.cpp
+ *  @author     Think Silicon
+ *  @date       14/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Track completion of queue submissions via a Timeline Semaphore in Vulkan
+ *
+ *  @section
+ *
+ *  A timeline semaphore holds a monotonically increasing 64-bit counter.
+ *  Every submission signals the next value, so a single semaphore tells
+ *  which submissions have completed, and waiting for one of them does not
+ *  require a fence per command buffer. It is only available when the device
+ *  exposes VK_KHR_timeline_semaphore; otherwise Create fails and the caller
+ *  falls back to Fences.
+ *
+ */
+
+#include "timeline.h"
+#include <chrono>
+#include <thread>
+
+namespace vulkanAPI {
+
+Timeline::Timeline(const vkContext_t *vkContext)
+: mVkContext(vkContext), mVkSemaphore(VK_NULL_HANDLE)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+}
+
+Timeline::~Timeline()
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    Release();
+}
+
+void
+Timeline::Release(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(mVkSemaphore != VK_NULL_HANDLE) {
+        vkDestroySemaphore(mVkContext->vkDevice, mVkSemaphore, nullptr);
+        mVkSemaphore = VK_NULL_HANDLE;
+    }
+}
+
+bool
+Timeline::Create(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!mVkContext->mIsTimelineSemaphoreSupported) {
+        return false;
+    }
+
+#ifdef VK_KHR_timeline_semaphore
+    VkSemaphoreTypeCreateInfoKHR typeInfo;
+    typeInfo.sType         = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+    typeInfo.pNext         = nullptr;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+    typeInfo.initialValue  = 0;
+
+    VkSemaphoreCreateInfo info;
+    info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    info.pNext = &typeInfo;
+    info.flags = 0;
+
+    VkResult err = vkCreateSemaphore(mVkContext->vkDevice, &info, nullptr, &mVkSemaphore);
+    assert(!err);
+
+    return (err == VK_SUCCESS);
+#else
+    return false;
+#endif // VK_KHR_timeline_semaphore
+}
+
+VkResult
+Timeline::Wait(uint64_t value, const fenceWaitPolicy_t &policy, fenceWaitInfo_t *info) const
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+#ifdef VK_KHR_timeline_semaphore
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point now   = start;
+
+    // polled like a Fence, see fence.cpp
+    bool reached = GetCompletedValue() >= value;
+    while(!reached && now - start < std::chrono::nanoseconds(policy.spinNs)) {
+        std::this_thread::yield();
+        reached = GetCompletedValue() >= value;
+        now     = std::chrono::steady_clock::now();
+    }
+
+    VkSemaphoreWaitInfoKHR waitInfo;
+    waitInfo.sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+    waitInfo.pNext          = nullptr;
+    waitInfo.flags          = 0;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores    = &mVkSemaphore;
+    waitInfo.pValues        = &value;
+
+    VkResult err     = reached ? VK_SUCCESS : VK_TIMEOUT;
+    uint64_t spentNs = std::chrono::duration_cast<std::chrono::nanoseconds>(now - start).count();
+    bool     blocked = !reached && policy.timeoutNs > spentNs;
+    if(blocked && policy.timeoutNs == UINT64_MAX) {
+        do {
+            err = mVkContext->fpWaitSemaphores(mVkContext->vkDevice, &waitInfo, UINT64_MAX);
+        } while(err == VK_TIMEOUT);
+    } else if(blocked) {
+        err = mVkContext->fpWaitSemaphores(mVkContext->vkDevice, &waitInfo, policy.timeoutNs - spentNs);
+    }
+    assert(err == VK_SUCCESS || err == VK_TIMEOUT);
+
+    if(info) {
+        info->blocked = blocked;
+        info->timeUs  = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    return err;
+#else
+    NOT_REACHED();
+    return VK_ERROR_FEATURE_NOT_PRESENT;
+#endif // VK_KHR_timeline_semaphore
+}
+
+uint64_t
+Timeline::GetCompletedValue(void) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    uint64_t value = 0;
+
+#ifdef VK_KHR_timeline_semaphore
+    VkResult err = mVkContext->fpGetSemaphoreCounterValue(mVkContext->vkDevice, mVkSemaphore, &value);
+    assert(!err);
+#else
+    NOT_REACHED();
+#endif // VK_KHR_timeline_semaphore
+
+    return value;
+}
+
+}
@@ -0,0 +1,66 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       timeline.h
+ *  @author     Think Silicon
+ *  @date       14/10/2026
+ *  @version    1.0
+ *
+ *  @brief      Track completion of queue submissions via a Timeline Semaphore in Vulkan
+ *
+ */
+
+#ifndef __VKTIMELINE_H__
+#define __VKTIMELINE_H__
+
+#include "fence.h"
+
+namespace vulkanAPI {
+
+class Timeline {
+
+private:
+
+    const
+    vkContext_t *                     mVkContext;
+
+    VkSemaphore                       mVkSemaphore;
+
+public:
+// Constructor
+    Timeline(const vkContext_t *vkContext = nullptr);
+
+// Destructor
+    ~Timeline();
+
+// Create Functions
+    bool                              Create(void);
+
+// Release Functions
+    void                              Release(void);
+
+// Wait Functions
+    VkResult                          Wait(uint64_t value, const fenceWaitPolicy_t &policy, fenceWaitInfo_t *info = nullptr) const;
+
+// Get Functions
+    uint64_t                          GetCompletedValue(void)             const;
+    inline VkSemaphore                GetSemaphore(void)                  const { FUN_ENTRY(GL_LOG_TRACE); return mVkSemaphore; }
+
+// Set Functions
+    inline void                       SetContext(const vkContext_t *vkContext)  { FUN_ENTRY(GL_LOG_TRACE); mVkContext = vkContext; }
+};
+
+}
+
+#endif // __VKTIMELINE_H__
@@ -0,0 +1,292 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       timestampPool.cpp
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      GPU timestamps written by the command buffers of each frame in flight
+ *
+ *  @section
+ *
+ *  Each command buffer slot writes its timestamps into a query pool of its
+ *  own, which is reset when the slot begins recording again. By then the
+ *  submission of the slot has completed, so its queries are resolved first:
+ *  the timestamps of the GL queries are kept until they are released, and
+ *  the scopes of the traces are handed to the tracer. The GPU clock is not
+ *  calibrated against the host one, so the scopes of a submission are placed
+ *  from the host time it was submitted at; their durations are exact.
+ *
+ */
+
+#include "timestampPool.h"
+#include "utils/glTracer.h"
+
+namespace vulkanAPI {
+
+TimestampPool::TimestampPool(const vkContext_t *vkContext)
+: mVkContext(vkContext), mNextTicket(0), mPeriod(1.0), mMask(UINT64_MAX)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+}
+
+TimestampPool::~TimestampPool()
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    Release();
+}
+
+void
+TimestampPool::Release(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    for(Slot &slot : mSlots) {
+        if(slot.pool != VK_NULL_HANDLE) {
+            vkDestroyQueryPool(mVkContext->vkDevice, slot.pool, nullptr);
+        }
+    }
+    mSlots.clear();
+    mPending.clear();
+    mResults.clear();
+}
+
+void
+TimestampPool::Release(uint64_t ticket)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    mPending.erase(ticket);
+    mResults.erase(ticket);
+}
+
+bool
+TimestampPool::Create(uint32_t slots)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!mVkContext->vkTimestampValidBits) {
+        return false;
+    }
+
+    mPeriod = mVkContext->vkDeviceLimits.timestampPeriod;
+    mMask   = mVkContext->vkTimestampValidBits >= 64 ? UINT64_MAX : (1ull << mVkContext->vkTimestampValidBits) - 1;
+
+    VkQueryPoolCreateInfo info;
+    info.sType              = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    info.pNext              = nullptr;
+    info.flags              = 0;
+    info.queryType          = VK_QUERY_TYPE_TIMESTAMP;
+    info.queryCount         = GLOVE_MAX_TIMESTAMPS_PER_SLOT;
+    info.pipelineStatistics = 0;
+
+    mSlots.resize(slots);
+    for(Slot &slot : mSlots) {
+        slot.pool         = VK_NULL_HANDLE;
+        slot.used         = 0;
+        slot.generation   = 0;
+        slot.submissionId = 0;
+        slot.submitTime   = 0;
+    }
+
+    for(Slot &slot : mSlots) {
+        VkResult err = vkCreateQueryPool(mVkContext->vkDevice, &info, nullptr, &slot.pool);
+        if(err != VK_SUCCESS) {
+            Release();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool
+TimestampPool::ReadQueries(const Slot &slot, uint32_t first, uint32_t count, uint64_t *values)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // each value is followed by its availability
+    VkResult err = vkGetQueryPoolResults(mVkContext->vkDevice, slot.pool, first, count, count * 2 * sizeof(uint64_t), values,
+                                         2 * sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+    if(err != VK_SUCCESS && err != VK_NOT_READY) {
+        return false;
+    }
+
+    for(uint32_t i = 0; i < count; ++i) {
+        values[2 * i] = static_cast<uint64_t>((values[2 * i] & mMask) * mPeriod);
+    }
+
+    return true;
+}
+
+void
+TimestampPool::ResolveSlot(uint32_t index)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    Slot &slot = mSlots[index];
+
+    std::vector<uint64_t> values(2 * slot.used, 0);
+    if(slot.submissionId == 0 || !slot.used || !ReadQueries(slot, 0, slot.used, values.data())) {
+        values.assign(2 * slot.used, 0);
+    }
+
+    // a GL query whose timestamp was never executed reads as 0
+    for(auto it = mPending.begin(); it != mPending.end();) {
+        if(it->second.slot == index && it->second.generation == slot.generation) {
+            mResults[it->first] = values[2 * it->second.query];
+            it = mPending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+#ifdef TRACE_BINARY
+    if(slot.marks.empty() || !values[2 * slot.marks.front().query + 1]) {
+        return;
+    }
+
+    const uint64_t base = values[2 * slot.marks.front().query];
+    std::vector<const Mark *> open;
+    for(const Mark &mark : slot.marks) {
+        if(!mark.end) {
+            open.push_back(&mark);
+            continue;
+        }
+
+        if(open.empty() || open.back()->label != mark.label) {
+            continue;
+        }
+
+        const Mark *begin = open.back();
+        open.pop_back();
+        if(values[2 * begin->query + 1] && values[2 * mark.query + 1] && values[2 * mark.query] >= values[2 * begin->query]) {
+            GLTracer::RecordGpu(mark.label, slot.submitTime + (values[2 * begin->query] - base),
+                                            slot.submitTime + (values[2 * mark.query]   - base));
+        }
+    }
+#endif // TRACE_BINARY
+}
+
+void
+TimestampPool::Reset(VkCommandBuffer cmdBuffer, uint32_t index)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(index >= mSlots.size()) {
+        return;
+    }
+
+    ResolveSlot(index);
+
+    Slot &slot = mSlots[index];
+    mVkContext->vkDispatch.vkCmdResetQueryPool(cmdBuffer, slot.pool, 0, GLOVE_MAX_TIMESTAMPS_PER_SLOT);
+    slot.used         = 0;
+    slot.submissionId = 0;
+    slot.marks.clear();
+    ++slot.generation;
+}
+
+uint64_t
+TimestampPool::Write(VkCommandBuffer cmdBuffer, uint32_t index, VkPipelineStageFlagBits stage)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(index >= mSlots.size() || mSlots[index].used >= GLOVE_MAX_TIMESTAMPS_PER_SLOT) {
+        return 0;
+    }
+
+    Slot &slot = mSlots[index];
+    mVkContext->vkDispatch.vkCmdWriteTimestamp(cmdBuffer, stage, slot.pool, slot.used);
+
+    Location location = { index, slot.used++, slot.generation };
+    mPending[++mNextTicket] = location;
+
+    return mNextTicket;
+}
+
+void
+TimestampPool::WriteScope(VkCommandBuffer cmdBuffer, uint32_t index, VkPipelineStageFlagBits stage, const char *label, bool end)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // a scope that cannot be closed is not opened
+    if(index >= mSlots.size() || mSlots[index].used + (end ? 0 : 1) >= GLOVE_MAX_TIMESTAMPS_PER_SLOT) {
+        return;
+    }
+
+    Slot &slot = mSlots[index];
+    mVkContext->vkDispatch.vkCmdWriteTimestamp(cmdBuffer, stage, slot.pool, slot.used);
+
+    Mark mark = { label, slot.used++, end };
+    slot.marks.push_back(mark);
+}
+
+void
+TimestampPool::SetSubmitted(uint32_t index, uint64_t submissionId)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(index < mSlots.size() && mSlots[index].used && !mSlots[index].submissionId) {
+        mSlots[index].submissionId = submissionId;
+        mSlots[index].submitTime   = GLTracer::Now();
+    }
+}
+
+bool
+TimestampPool::GetResult(uint64_t ticket, uint64_t *ns)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    auto result = mResults.find(ticket);
+    if(result != mResults.end()) {
+        *ns = result->second;
+        return true;
+    }
+
+    auto pending = mPending.find(ticket);
+    if(pending == mPending.end()) {
+        return false;
+    }
+
+    const Slot &slot = mSlots[pending->second.slot];
+    uint64_t value[2] = { 0, 0 };
+    if(slot.generation != pending->second.generation || !slot.submissionId ||
+       !ReadQueries(slot, pending->second.query, 1, value) || !value[1]) {
+        return false;
+    }
+
+    mResults[ticket] = value[0];
+    mPending.erase(pending);
+    *ns = value[0];
+
+    return true;
+}
+
+uint64_t
+TimestampPool::GetSubmissionId(uint64_t ticket) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    auto pending = mPending.find(ticket);
+    if(pending == mPending.end()) {
+        return UINT64_MAX;
+    }
+
+    return mSlots[pending->second.slot].submissionId;
+}
+
+}
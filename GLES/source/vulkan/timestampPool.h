@@ -0,0 +1,116 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       timestampPool.h
+ *  @author     Think Silicon
+ *  @date       15/10/2026
+ *  @version    1.0
+ *
+ *  @brief      GPU timestamps written by the command buffers of each frame in flight
+ *
+ */
+
+#ifndef __VKTIMESTAMPPOOL_H__
+#define __VKTIMESTAMPPOOL_H__
+
+#include "context.h"
+#include <map>
+#include <vector>
+
+/// timestamps each command buffer slot can write before it is reset
+#ifndef GLOVE_MAX_TIMESTAMPS_PER_SLOT
+#define GLOVE_MAX_TIMESTAMPS_PER_SLOT                   256
+#endif // GLOVE_MAX_TIMESTAMPS_PER_SLOT
+
+namespace vulkanAPI {
+
+class TimestampPool {
+
+private:
+    /// a query written for the traces, opening or closing the scope of its label
+    typedef struct Mark {
+        const char                   *label;
+        uint32_t                      query;
+        bool                          end;
+    } Mark;
+
+    typedef struct Slot {
+        VkQueryPool                   pool;
+        /// queries written since the slot was last reset
+        uint32_t                      used;
+        uint32_t                      generation;
+        /// the submission carrying the queries, 0 until it is submitted
+        uint64_t                      submissionId;
+        /// host time of the submission, the GPU times of the traces start there
+        uint64_t                      submitTime;
+        std::vector<Mark>             marks;
+    } Slot;
+
+    typedef struct Location {
+        uint32_t                      slot;
+        uint32_t                      query;
+        uint32_t                      generation;
+    } Location;
+
+    const
+    vkContext_t *                     mVkContext;
+
+    std::vector<Slot>                 mSlots;
+    uint64_t                          mNextTicket;
+    /// timestamps kept for the GL queries, until they are resolved
+    std::map<uint64_t, Location>      mPending;
+    /// resolved timestamps of the GL queries in ns, until they are released
+    std::map<uint64_t, uint64_t>      mResults;
+    double                            mPeriod;
+    uint64_t                          mMask;
+
+    bool                              ReadQueries(const Slot &slot, uint32_t first, uint32_t count, uint64_t *values);
+    void                              ResolveSlot(uint32_t slot);
+
+public:
+// Constructor
+    TimestampPool(const vkContext_t *vkContext = nullptr);
+
+// Destructor
+    ~TimestampPool();
+
+// Create Functions
+    bool                              Create(uint32_t slots);
+
+// Release Functions
+    void                              Release(void);
+    void                              Release(uint64_t ticket);
+
+// Record Functions
+    /// resolves the queries the slot last completed and records their reset, outside of a render pass
+    void                              Reset(VkCommandBuffer cmdBuffer, uint32_t slot);
+    /// returns the ticket of the timestamp, kept until it is released, or 0 when the slot is full
+    uint64_t                          Write(VkCommandBuffer cmdBuffer, uint32_t slot, VkPipelineStageFlagBits stage);
+    /// opens or closes a scope of the traces, reported once the slot is resolved
+    void                              WriteScope(VkCommandBuffer cmdBuffer, uint32_t slot, VkPipelineStageFlagBits stage, const char *label, bool end);
+
+// Submit Functions
+    void                              SetSubmitted(uint32_t slot, uint64_t submissionId);
+
+// Get Functions
+    bool                              GetResult(uint64_t ticket, uint64_t *ns);
+    /// the submission carrying the ticket, 0 while it is recorded and UINT64_MAX once it is resolved
+    uint64_t                          GetSubmissionId(uint64_t ticket)     const;
+    inline bool                       IsSupported(void)                   const { FUN_ENTRY(GL_LOG_TRACE); return !mSlots.empty(); }
+    inline uint32_t                   GetValidBits(void)                  const { FUN_ENTRY(GL_LOG_TRACE); return mVkContext->vkTimestampValidBits; }
+};
+
+}
+
+#endif // __VKTIMESTAMPPOOL_H__
@@ -80,34 +80,27 @@ FindSupportedFormat(VkPhysicalDevice vkPhysicalDevice, const std::vector<VkForma
 VkFormat
 FindSupportedDepthStencilFormat(VkPhysicalDevice dev, uint32_t depthSize, uint32_t stencilSize)
 {
-    std::vector<VkFormat> acceptableFormats;
-    switch(depthSize) {
-    case 0:
-    {
-        stencilSize ?
-                    acceptableFormats = {VK_FORMAT_S8_UINT,
-                     VK_FORMAT_D16_UNORM_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT, VK_FORMAT_D32_SFLOAT_S8_UINT} :
-                    acceptableFormats = { }; break;
-    }
-    case 16:
-    {
-        stencilSize ?
-                    acceptableFormats = {VK_FORMAT_D16_UNORM_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT, VK_FORMAT_D32_SFLOAT_S8_UINT} :
-                    acceptableFormats = {VK_FORMAT_D16_UNORM, VK_FORMAT_X8_D24_UNORM_PACK32, VK_FORMAT_D32_SFLOAT}; break;
-    }
-    case 24:
-    {
-        stencilSize ?
-                    acceptableFormats = {VK_FORMAT_D24_UNORM_S8_UINT, VK_FORMAT_D32_SFLOAT_S8_UINT} :
-                    acceptableFormats = {VK_FORMAT_X8_D24_UNORM_PACK32, VK_FORMAT_D32_SFLOAT}; break;
+    if(!depthSize && !stencilSize) {
+        return VK_FORMAT_UNDEFINED;
     }
-    case 32:
-    {
-        stencilSize ?
-                    acceptableFormats = {VK_FORMAT_D32_SFLOAT_S8_UINT} :
-                    acceptableFormats = {VK_FORMAT_D32_SFLOAT}; break;
-    }
-    default: NOT_REACHED(); break;
+
+    // ordered by their size per texel, so the smallest format that holds the requested bits and is supported wins.
+    // Formats without stencil precede the combined ones of the same size, which is then left to the requests with stencil
+    static const VkFormat depthStencilFormats[] = {
+        VK_FORMAT_S8_UINT,
+        VK_FORMAT_D16_UNORM,
+        VK_FORMAT_D16_UNORM_S8_UINT,
+        VK_FORMAT_X8_D24_UNORM_PACK32,
+        VK_FORMAT_D32_SFLOAT,
+        VK_FORMAT_D24_UNORM_S8_UINT,
+        VK_FORMAT_D32_SFLOAT_S8_UINT
+    };
+
+    std::vector<VkFormat> acceptableFormats;
+    for(VkFormat format : depthStencilFormats) {
+        if(GetVkFormatDepthBits(format) >= depthSize && GetVkFormatStencilBits(format) >= stencilSize) {
+            acceptableFormats.push_back(format);
+        }
     }
 
     return FindSupportedFormat(
@@ -118,6 +111,29 @@ FindSupportedDepthStencilFormat(VkPhysicalDevice dev, uint32_t depthSize, uint32
     );
 }
 
+VkSampleCountFlagBits
+FindSupportedSampleCount(const VkPhysicalDeviceLimits *limits, uint32_t samples)
+{
+    if(samples <= 1) {
+        return VK_SAMPLE_COUNT_1_BIT;
+    }
+
+    // a render pass mixes color and depth/stencil attachments, so only the counts all of them support are considered.
+    // The smallest count that is not less than the requested one is picked, otherwise the largest one
+    VkSampleCountFlags supported = limits->framebufferColorSampleCounts &
+                                   limits->framebufferDepthSampleCounts &
+                                   limits->framebufferStencilSampleCounts;
+
+    uint32_t found = VK_SAMPLE_COUNT_1_BIT;
+    for(uint32_t count = VK_SAMPLE_COUNT_64_BIT; count > VK_SAMPLE_COUNT_1_BIT; count >>= 1) {
+        if((supported & count) && (count >= samples || found == VK_SAMPLE_COUNT_1_BIT)) {
+            found = count;
+        }
+    }
+
+    return static_cast<VkSampleCountFlagBits>(found);
+}
+
 bool
 VkFormatIsDepthStencil(VkFormat format)
 {
@@ -179,6 +195,45 @@ VkFormatIsColor(VkFormat format)
     return (format != VK_FORMAT_UNDEFINED) && !VkFormatIsDepthStencil(format);
 }
 
+bool
+VkSurfaceTransformIsSideways(VkSurfaceTransformFlagBitsKHR transform)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    return transform == VK_SURFACE_TRANSFORM_ROTATE_90_BIT_KHR || transform == VK_SURFACE_TRANSFORM_ROTATE_270_BIT_KHR;
+}
+
+VkRect2D
+PreTransformVkRect2D(const VkRect2D &rect, uint32_t width, uint32_t height, VkSurfaceTransformFlagBitsKHR transform)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    const int32_t  x = rect.offset.x;
+    const int32_t  y = rect.offset.y;
+    const uint32_t w = rect.extent.width;
+    const uint32_t h = rect.extent.height;
+
+    switch(transform) {
+    case VK_SURFACE_TRANSFORM_ROTATE_90_BIT_KHR:  return { { static_cast<int32_t>(height - h) - y, x }, { h, w } };
+    case VK_SURFACE_TRANSFORM_ROTATE_180_BIT_KHR: return { { static_cast<int32_t>(width  - w) - x, static_cast<int32_t>(height - h) - y }, { w, h } };
+    case VK_SURFACE_TRANSFORM_ROTATE_270_BIT_KHR: return { { y, static_cast<int32_t>(width - w) - x }, { h, w } };
+    default:                                      return rect;
+    }
+}
+
+void
+GetVkSurfaceTransformRotation(VkSurfaceTransformFlagBitsKHR transform, float *cosine, float *sine)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    switch(transform) {
+    case VK_SURFACE_TRANSFORM_ROTATE_90_BIT_KHR:  *cosine =  0.0f; *sine =  1.0f; break;
+    case VK_SURFACE_TRANSFORM_ROTATE_180_BIT_KHR: *cosine = -1.0f; *sine =  0.0f; break;
+    case VK_SURFACE_TRANSFORM_ROTATE_270_BIT_KHR: *cosine =  0.0f; *sine = -1.0f; break;
+    default:                                      *cosine =  1.0f; *sine =  0.0f; break;
+    }
+}
+
 #define CASE_STR(c)                     case VK_ ##c: return "VK_" STRINGIFY(c);
 
 const char *
@@ -31,11 +31,18 @@
 uint32_t                GetVkFormatStencilBits(VkFormat format);
 uint32_t                GetVkFormatDepthBits(VkFormat format);
 VkFormat                FindSupportedDepthStencilFormat(VkPhysicalDevice dev, uint32_t depthSize, uint32_t stencilSize);
+VkSampleCountFlagBits   FindSupportedSampleCount(const VkPhysicalDeviceLimits *limits, uint32_t samples);
 VkFormat                FindSupportedFormat(VkPhysicalDevice vkPhysicalDevice, const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features);
 bool                    VkFormatIsDepthStencil(VkFormat format);
 bool                    VkFormatIsDepth(VkFormat format);
 bool                    VkFormatIsStencil(VkFormat format);
 bool                    VkFormatIsColor(VkFormat format);
 const char *            VkResultToString(VkResult res);
+/// the images of surfaces pre-rotated by a quarter turn have their width and height swapped
+bool                    VkSurfaceTransformIsSideways(VkSurfaceTransformFlagBitsKHR transform);
+/// maps a rect with a top-left origin within width x height onto the images the transform has been applied to
+VkRect2D                PreTransformVkRect2D(const VkRect2D &rect, uint32_t width, uint32_t height, VkSurfaceTransformFlagBitsKHR transform);
+/// the clockwise rotation of the clip space that renders onto the images the transform has been applied to
+void                    GetVkSurfaceTransformRotation(VkSurfaceTransformFlagBitsKHR transform, float *cosine, float *sine);
 
 #endif // __VKUTILS_H__
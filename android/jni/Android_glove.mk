@@ -36,6 +36,7 @@ include $(CLEAR_VARS)
 LOCAL_MODULE := libGLESv2_GLOVE
 LOCAL_SRC_FILES :=  $(SRC_PATH)/GLES/source/api/gl.cpp \
                     $(SRC_PATH)/GLES/source/api/eglInterface.cpp \
+                    $(SRC_PATH)/GLES/source/api/glCapture.cpp \
                     $(SRC_PATH)/GLES/source/context/context.cpp \
                     $(SRC_PATH)/GLES/source/context/contextBufferObject.cpp \
                     $(SRC_PATH)/GLES/source/context/contextFrameBuffer.cpp \
@@ -48,6 +49,9 @@ LOCAL_SRC_FILES :=  $(SRC_PATH)/GLES/source/api/gl.cpp \
                     $(SRC_PATH)/GLES/source/context/contextStateFramebufferOperations.cpp \
                     $(SRC_PATH)/GLES/source/context/contextStateManager.cpp \
                     $(SRC_PATH)/GLES/source/context/contextStatePixelOperations.cpp \
+                    $(SRC_PATH)/GLES/source/context/contextQueries.cpp \
+                    $(SRC_PATH)/GLES/source/context/contextMemoryReport.cpp \
+                    $(SRC_PATH)/GLES/source/context/contextCommandBundle.cpp \
                     $(SRC_PATH)/GLES/source/context/contextStateQueries.cpp \
                     $(SRC_PATH)/GLES/source/context/contextStateRasterization.cpp \
                     $(SRC_PATH)/GLES/source/context/contextStateViewportTransformation.cpp \
@@ -59,11 +63,14 @@ LOCAL_SRC_FILES :=  $(SRC_PATH)/GLES/source/api/gl.cpp \
                     $(SRC_PATH)/GLES/source/glslang/glslangIoMapResolver.cpp \
                     $(SRC_PATH)/GLES/source/glslang/glslangShaderCompiler.cpp \
                     $(SRC_PATH)/GLES/source/glslang/shaderConverter.cpp \
+                    $(SRC_PATH)/GLES/source/glslang/FixPosition.cpp \
+                    $(SRC_PATH)/GLES/source/glslang/OptimizeSpv.cpp \
                     $(SRC_PATH)/GLES/source/resources/attachment.cpp \
                     $(SRC_PATH)/GLES/source/resources/bufferObject.cpp \
                     $(SRC_PATH)/GLES/source/resources/framebuffer.cpp \
                     $(SRC_PATH)/GLES/source/resources/genericVertexAttribute.cpp \
                     $(SRC_PATH)/GLES/source/resources/resourceManager.cpp \
+                    $(SRC_PATH)/GLES/source/resources/shareGroup.cpp \
                     $(SRC_PATH)/GLES/source/resources/renderbuffer.cpp \
                     $(SRC_PATH)/GLES/source/resources/shader.cpp \
                     $(SRC_PATH)/GLES/source/resources/shaderProgram.cpp \
@@ -72,6 +79,8 @@ LOCAL_SRC_FILES :=  $(SRC_PATH)/GLES/source/api/gl.cpp \
                     $(SRC_PATH)/GLES/source/resources/texture.cpp \
                     $(SRC_PATH)/GLES/source/resources/rect.cpp \
                     $(SRC_PATH)/GLES/source/resources/sampler.cpp \
+                    $(SRC_PATH)/GLES/source/resources/vertexArray.cpp \
+                    $(SRC_PATH)/GLES/source/resources/query.cpp \
                     $(SRC_PATH)/GLES/source/state/stateManager.cpp \
                     $(SRC_PATH)/GLES/source/state/stateActiveObjects.cpp \
                     $(SRC_PATH)/GLES/source/state/stateInputAssembly.cpp \
@@ -85,11 +94,27 @@ LOCAL_SRC_FILES :=  $(SRC_PATH)/GLES/source/api/gl.cpp \
                     $(SRC_PATH)/GLES/source/utils/parser_helpers.cpp \
                     $(SRC_PATH)/GLES/source/utils/VkToGlConverter.cpp \
                     $(SRC_PATH)/GLES/source/utils/glLogger.cpp \
+                    $(SRC_PATH)/GLES/source/utils/glTracer.cpp \
+                    $(SRC_PATH)/GLES/source/utils/glProfiler.cpp \
                     $(SRC_PATH)/GLES/source/utils/glUtils.cpp \
                     $(SRC_PATH)/GLES/source/utils/cacheManager.cpp \
+                    $(SRC_PATH)/GLES/source/utils/indexUtils.cpp \
+                    $(SRC_PATH)/GLES/source/utils/pixelUtils.cpp \
+                    $(SRC_PATH)/GLES/source/utils/compressedTextures.cpp \
+                    $(SRC_PATH)/GLES/source/utils/uploadWorker.cpp \
+                    $(SRC_PATH)/GLES/source/utils/jobSystem.cpp \
+                    $(SRC_PATH)/GLES/source/utils/glThread.cpp \
+                    $(SRC_PATH)/GLES/source/utils/linearAllocator.cpp \
+                    $(SRC_PATH)/GLES/source/utils/objectPool.cpp \
+                    $(SRC_PATH)/GLES/source/utils/programCache.cpp \
+                    $(SRC_PATH)/GLES/source/utils/shaderStats.cpp \
+                    $(SRC_PATH)/GLES/source/utils/startupProfile.cpp \
+                    $(SRC_PATH)/GLES/source/utils/compileWorker.cpp \
+                    $(SRC_PATH)/GLES/source/utils/nameTable.cpp \
                     $(SRC_PATH)/GLES/source/vulkan/cbManager.cpp \
                     $(SRC_PATH)/GLES/source/vulkan/clearPass.cpp \
                     $(SRC_PATH)/GLES/source/vulkan/commandBufferPool.cpp \
+                    $(SRC_PATH)/GLES/source/vulkan/drawRecorder.cpp \
                     $(SRC_PATH)/GLES/source/vulkan/renderPass.cpp \
                     $(SRC_PATH)/GLES/source/vulkan/buffer.cpp \
                     $(SRC_PATH)/GLES/source/vulkan/memory.cpp \
@@ -101,7 +126,18 @@ LOCAL_SRC_FILES :=  $(SRC_PATH)/GLES/source/api/gl.cpp \
                     $(SRC_PATH)/GLES/source/vulkan/framebuffer.cpp \
                     $(SRC_PATH)/GLES/source/vulkan/context.cpp \
                     $(SRC_PATH)/GLES/source/vulkan/utils.cpp \
-                    $(SRC_PATH)/GLES/source/vulkan/fence.cpp
+                    $(SRC_PATH)/GLES/source/vulkan/fence.cpp \
+                    $(SRC_PATH)/GLES/source/vulkan/timeline.cpp \
+                    $(SRC_PATH)/GLES/source/vulkan/occlusionPool.cpp \
+                    $(SRC_PATH)/GLES/source/vulkan/timestampPool.cpp \
+                    $(SRC_PATH)/GLES/source/vulkan/submissionQueue.cpp \
+                    $(SRC_PATH)/GLES/source/vulkan/pipelineCompiler.cpp \
+                    $(SRC_PATH)/GLES/source/vulkan/memoryAllocator.cpp \
+                    $(SRC_PATH)/GLES/source/vulkan/samplerCache.cpp \
+                    $(SRC_PATH)/GLES/source/vulkan/shaderModuleCache.cpp \
+                    $(SRC_PATH)/GLES/source/vulkan/ringBuffer.cpp \
+                    $(SRC_PATH)/GLES/source/vulkan/descriptorAllocator.cpp \
+                    $(SRC_PATH)/GLES/source/vulkan/commandBundle.cpp
 
 LOCAL_C_INCLUDES := $(SRC_PATH)/GLES/source \
                     $(SRC_PATH)/GLES/include \
@@ -152,16 +188,19 @@ LOCAL_SRC_FILES := $(SRC_PATH)/EGL/source/api/eglContext.cpp \
                    $(SRC_PATH)/EGL/source/platform/vulkan/WSIPlaneDisplay.cpp \
                    $(SRC_PATH)/EGL/source/platform/vulkan/WSIAndroid.cpp \
                    $(SRC_PATH)/EGL/source/platform/vulkan/vulkanWindowInterface.cpp \
+                   $(SRC_PATH)/EGL/source/platform/vulkan/vulkanPresentThread.cpp \
                    $(SRC_PATH)/EGL/source/platform/vulkan/vulkanWSI.cpp \
                    $(SRC_PATH)/EGL/source/platform/vulkan/vulkanAPI.cpp \
                    $(SRC_PATH)/EGL/source/platform/vulkan/vulkanResources.cpp \
                    $(SRC_PATH)/EGL/source/rendering_api/rendering_api.c \
                    $(SRC_PATH)/EGL/source/utils/eglLogger.cpp \
-                   $(SRC_PATH)/EGL/source/utils/eglUtils.cpp
+                   $(SRC_PATH)/EGL/source/utils/eglUtils.cpp \
+                   $(SRC_PATH)/GLES/source/utils/glProfiler.cpp
 
 LOCAL_C_INCLUDES := $(SRC_PATH)/EGL/source \
                     $(SRC_PATH)/EGL/include \
                     $(SRC_PATH)/GLES/include \
+                    $(SRC_PATH)/GLES/source/utils \
                     /usr/include/android
 
 LOCAL_SHARED_LIBRARIES :=  libGLESv2_GLOVE
@@ -7,6 +7,10 @@ BUILD_TYPE=Release
 VULKAN_LIBRARY=""
 VULKAN_INCLUDE_PATH=""
 TRACE_BUILD=OFF
+TRACE_BINARY=OFF
+CAPTURE_BUILD=OFF
+SPIRV_OPT=OFF
+PROFILER=NONE
 TOOLCHAIN_FILE=""
 SYSROOT=""
 C_FLAGS=""
@@ -30,6 +34,10 @@ function buildGlove() {
           -DUSE_SURFACE=$USE_SURFACE \
           -DVULKAN_INCLUDE_PATH=$VULKAN_INCLUDE_PATH \
           -DTRACE_BUILD=$TRACE_BUILD \
+          -DTRACE_BINARY=$TRACE_BINARY \
+          -DCAPTURE_BUILD=$CAPTURE_BUILD \
+          -DSPIRV_OPT=$SPIRV_OPT \
+          -DPROFILER=$PROFILER \
           -DCMAKE_TOOLCHAIN_FILE=$TOOLCHAIN_FILE \
           -DCMAKE_SYSROOT=$SYSROOT \
           -DCMAKE_INSTALL_PREFIX=$INSTALL_PREFIX \
@@ -49,6 +57,16 @@ else
         option="$1"
 
         case $option in
+            # option to record binary function traces
+            -b|--trace-binary)
+                TRACE_BINARY=ON
+                echo "Activating binary function traces"
+                ;;
+            # option to record the GL command stream for glove_replay
+            -c|--capture)
+                CAPTURE_BUILD=ON
+                echo "Activating GL command-stream capture"
+                ;;
             # option to cross compile
             -a|--arm-compile)
                 CROSS_COMPILATION_ARM=true
@@ -78,6 +96,21 @@ else
                 fi
                 echo "Setting installation prefix to $INSTALL_PREFIX"
                 ;;
+            # option to optimize the generated SPIR-V
+            -o|--spirv-opt)
+                SPIRV_OPT=ON
+                echo "Optimizing SPIR-V with SPIRV-Tools"
+                ;;
+            # option to mark the hot paths as profiler zones
+            -p|--profiler)
+                shift
+                if [ $1 == "NONE" ] || [ $1 == "TRACY" ] || [ $1 == "PERFETTO" ]; then
+                    PROFILER=$1
+                    echo "Setting profiler to $PROFILER"
+                else
+                    echo "Wrong profiler argument $1 provided (Options are: NONE, TRACY and PERFETTO). Using $PROFILER."
+                fi
+                ;;
             # option to set sysroot
             -s|--sysroot)
                 shift
@@ -115,10 +148,14 @@ else
                 echo "Unrecognized option: $option"
                 echo "Try the following:"
                 echo " -a | --arm-compile                   # cross build for ARM platform (default OFF)"
+                echo " -b | --trace-binary                  # record function traces in the Chrome trace format (default OFF)"
+                echo " -c | --capture                       # record the GL command stream for glove_replay (default OFF)"
                 echo " -d | --debug                         # build in Debug mode (default Release)"
                 echo " -e | --werror                        # handle warnings as errors (default OFF)"
                 echo " -f | --use-surface                   # set windowing system (Options: XCB, ANDROID, NATIVE, WINDOWS, MACOS) (default XCB)"
                 echo " -i | --install-prefix      (dir)     # set custom installation prefix path"
+                echo " -o | --spirv-opt                     # optimize the generated SPIR-V, needs glslang built with it (default OFF)"
+                echo " -p | --profiler            (name)    # mark the hot paths as profiler zones (Options: NONE, TRACY, PERFETTO) (default NONE)"
                 echo " -s | --sysroot             (dir)     # set sysroot for cross compilation"
                 echo " -t | --trace-build                   # activate logs (default OFF)"
                 echo " -u | --vulkan-include-path (dir)     # set custom Vulkan include path"
@@ -9,6 +9,7 @@ BUILD_FOLDER=build
 INSTALL_PATH=""
 TOOLCHAIN_FILE=""
 SYSROOT=""
+SPIRV_OPT=false
 
 GLSLANG_REPOSITORY="https://github.com/KhronosGroup/glslang.git"
 GOOGLETEST_REPOSITORY="https://github.com/google/googletest.git"
@@ -50,6 +51,11 @@ function build() {
 
     if [ $PROJECT == "glslang" ]; then
         PROJECT_FLAGS=$GLSLANG_FLAGS
+        # the optimizer is built from the SPIRV-Tools revision glslang is known to work with
+        if [ $SPIRV_OPT == true ]; then
+            cd $EXT_DIR/$PROJECT
+            ./update_glslang_sources.py
+        fi
     fi
 
     echo "PROJECT_FLAGS:" $PROJECT_FLAGS
@@ -76,6 +82,11 @@ do
             shift
             INSTALL_PATH=$1
             ;;
+        # option to build glslang with the SPIR-V optimizer
+        -o|--spirv-opt)
+            SPIRV_OPT=true
+            GLSLANG_FLAGS=${GLSLANG_FLAGS/-DENABLE_OPT=OFF/-DENABLE_OPT=ON}
+            ;;
         # option to set sysroot
         -s|--sysroot)
             shift
@@ -87,6 +98,7 @@ do
             echo "Unrecognized option: $option"
             echo "Try the following:"
             echo " -i | --install-path (dir)    # set custom installation path"
+            echo " -o | --spirv-opt             # build the SPIR-V optimizer (SPIRV-Tools) with glslang"
             echo " -s | --sysroot      (dir)    # set sysroot for cross compilation"
             exit 1
             ;;